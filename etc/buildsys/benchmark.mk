@@ -0,0 +1,40 @@
+#*****************************************************************************
+#                Makefile Build System for Fawkes: benchmarks
+#                            -------------------
+#   Created on Thu Oct 15 07:45:06 2026
+#   Copyright (C) 2026 by agent
+#
+#*****************************************************************************
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+#*****************************************************************************
+
+ifndef __buildsys_config_mk_
+$(error config.mk must be included before benchmark.mk)
+endif
+
+ifndef __buildsys_benchmark_mk_
+__buildsys_benchmark_mk_ := 1
+
+ifneq ($(PKGCONFIG),)
+  HAVE_BENCHMARK = $(if $(shell $(PKGCONFIG) --exists 'benchmark'; echo $${?/1/}),1,0)
+endif
+
+ifeq ($(HAVE_BENCHMARK),1)
+  CFLAGS_BENCHMARK  = $(shell $(PKGCONFIG) --cflags 'benchmark')
+  LDFLAGS_BENCHMARK = $(shell $(PKGCONFIG) --libs 'benchmark') -pthread
+
+  # benchmark binaries don't need a man page
+  WARN_MISSING_MANPAGE = 0
+endif
+
+# Results are written as JSON to this directory, one file per binary.
+# Pass additional arguments, e.g. a filter or the number of repetitions,
+# with BENCHMARK_ARGS="--benchmark_filter=... --benchmark_repetitions=5"
+BENCHMARKDIR ?= $(abspath $(TOP_BASEDIR)/benchmark-results)
+
+endif # __buildsys_benchmark_mk_
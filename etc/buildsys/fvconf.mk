@@ -121,6 +121,10 @@ ifeq ($(HAVE_OPENCV),1)
 		       $(shell $(PKGCONFIG) --cflags 'opencv$(OPENCV_VERSION_SUFFIX)') \
 		       $(CFLAG_W_NO_UNUSED_LOCAL_TYPEDEFS)
   LDFLAGS_OPENCV     = $(shell $(PKGCONFIG) --libs 'opencv$(OPENCV_VERSION_SUFFIX)')
+  # UMat and OpenCL offloading are available since OpenCV 3
+  ifeq ($(call gte,$(VERSION_MAJOR_OPENCV),3),$(true))
+    HAVE_OPENCV_TAPI = 1
+  endif
 endif
 
 ifeq ($(HAVE_LIBUSB),1)
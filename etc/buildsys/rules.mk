@@ -67,6 +67,11 @@ ifeq ($(MAKECMDGOALS),clean)
       SUBDIRS += tests
     endif
   endif
+  ifneq ($(wildcard $(SRCDIR)/benchmarks),)
+    ifneq ($(findstring benchmarks,$(SUBDIRS)),benchmarks)
+      SUBDIRS += benchmarks
+    endif
+  endif
 endif
 
 ifeq ($(findstring test,$(MAKECMDGOALS)),test)
@@ -77,6 +82,14 @@ ifeq ($(findstring test,$(MAKECMDGOALS)),test)
   endif
 endif
 
+ifeq ($(findstring benchmark,$(MAKECMDGOALS)),benchmark)
+  ifneq ($(wildcard $(SRCDIR)/benchmarks),)
+    ifneq ($(findstring benchmarks,$(SUBDIRS)),benchmarks)
+      SUBDIRS += benchmarks
+    endif
+  endif
+endif
+
 # If SOVER for lib was not set (SOVER_libname empty), set it to DEFAULT_SOVER
 $(foreach L,$(LIBS_all:$(LIBDIR)/%.so=%),$(if $(SOVER_$(subst /,_,$L)),,$(eval SOVER_$(subst /,_,$L) = $(DEFAULT_SOVER))))
 
@@ -89,7 +102,7 @@ endif
 -include $(DEPDIR)/*.d
 
 # One to build 'em all
-.PHONY: all gui test
+.PHONY: all gui test benchmark
 ifeq ($(MAKELEVEL),1)
   EXTRA_ALL = $(LIBS_gui) $(PLUGINS_gui) $(BINS_gui) $(TARGETS_gui) $(MANPAGES_gui)
 endif
@@ -104,12 +117,13 @@ BINS_test = $(BINS_gtest) $(BINS_catch2test)
 all: $(if $(UNLISTED_all),error_unlisted,presubdirs $(PLUGINS_build:%.so=%.$(SOEXT)) $(LIBS_build:%.so=%.$(SOEXT)) $(BINS_build) $(MANPAGES_all) $(TARGETS_all) $(EXTRA_ALL) stats subdirs | silent-nothing-to-do-all)
 gui: $(if $(UNLISTED_all),error_unlisted,presubdirs $(LIBS_gui:%.so=%.$(SOEXT)) $(PLUGINS_gui:%.so=%.$(SOEXT)) $(BINS_gui) $(MANPAGES_gui) $(TARGETS_gui) stats-gui subdirs | silent-nothing-to-do-gui)
 test: $(if $(UNLISTED_all),error_unlisted,presubdirs $(LIBS_test:%.so=%.$(SOEXT)) $(PLUGINS_test:%.so=%.$(SOEXT)) $(BINS_test) $(TARGETS_test) exec_test stats-test subdirs | silent-nothing-to-do-test)
+benchmark: $(if $(UNLISTED_all),error_unlisted,presubdirs $(BINS_benchmark) exec_benchmark subdirs | silent-nothing-to-do-benchmark)
 uncolored-all: all
 uncolored-gui: gui
 uncolored-test: test
 
 BUILT_PARTS=
-.PHONY: silent-nothing-to-do-gui silent-nothing-to-do-all silent-nothing-to-do-test
+.PHONY: silent-nothing-to-do-gui silent-nothing-to-do-all silent-nothing-to-do-test silent-nothing-to-do-benchmark
 silent-nothing-to-do-all:
 	$(SILENTSYMB)if [ -z "$(BUILT_PARTS)" ]; then echo -e "$(INDENT_PRINT)--- Nothing to do in $(TBOLDGRAY)$(PARENTDIR)$(TNORMAL) for target$(if $(subst 1,,$(words $(MAKECMDGOALS))),s) $(TBOLDGRAY)$(MAKECMDGOALS)$(TNORMAL)"; fi
 	$(eval BUILT_PARTS += $@)
@@ -122,6 +136,10 @@ silent-nothing-to-do-test:
 	$(SILENTSYMB)if [ -z "$(BUILT_PARTS)" ]; then echo -e "$(INDENT_PRINT)--- Nothing to do in $(TBOLDGRAY)$(PARENTDIR)$(TNORMAL) for target$(if $(subst 1,,$(words $(MAKECMDGOALS))),s) $(TBOLDGRAY)$(MAKECMDGOALS)$(TNORMAL)"; fi
 	$(eval BUILT_PARTS += $@)
 
+silent-nothing-to-do-benchmark:
+	$(SILENTSYMB)if [ -z "$(BUILT_PARTS)" ]; then echo -e "$(INDENT_PRINT)--- Nothing to do in $(TBOLDGRAY)$(PARENTDIR)$(TNORMAL) for target$(if $(subst 1,,$(words $(MAKECMDGOALS))),s) $(TBOLDGRAY)$(MAKECMDGOALS)$(TNORMAL)"; fi
+	$(eval BUILT_PARTS += $@)
+
 .PHONY: error_unlisted
 error_unlisted:
 ifneq ($(UNLISTED_bins),)
@@ -155,6 +173,7 @@ clean: presubdirs subdirs
 	$(SILENT)$(foreach P,$(PLUGINS_test:%.so=%.$(SOEXT)),rm -f $(P);)
 	$(SILENT)$(foreach M,$(MANPAGES_test),rm -f $(M);)
 	$(SILENT)$(foreach T,$(TARGETS_test),rm -rf $(T);)
+	$(SILENT)$(foreach B,$(BINS_benchmark),rm -f $(B);)
 	$(SILENT)$(foreach E,$(CLEAN_FILES),rm -rf $(E);)
 
 .PHONY: presubdirs $(PRESUBDIRS) subdirs $(SUBDIRS)
@@ -293,6 +312,18 @@ exec_catch2test_%: $(BINDIR)/%
 	$(SILENT)exec $(BINDIR)/$* --use-colour $(if $(COLORED),yes,no) | sed 's/^/$(INDENT_PRINT)[TEST] /'; \
 		test $${PIPESTATUS[0]} -eq 0
 
+# execute every benchmark
+exec_benchmark: $(patsubst $(BINDIR)/%,exec_benchmark_%,$(BINS_benchmark))
+
+# execute a single benchmark, results are written to $(BENCHMARKDIR)/<binary>.json
+exec_benchmark_%: $(BINDIR)/%
+	$(eval BUILT_PARTS += $@)
+	$(SILENT)mkdir -p $(BENCHMARKDIR)
+	$(SILENT)echo -e "$(INDENT_PRINT)[BENCH] Running benchmark $(BINDIR)/$*"
+	$(SILENT)exec $(BINDIR)/$* --benchmark_out=$(BENCHMARKDIR)/$*.json --benchmark_out_format=json \
+		--benchmark_color=$(if $(COLORED),true,false) $(BENCHMARK_ARGS) | sed 's/^/$(INDENT_PRINT)[BENCH] /'; \
+		test $${PIPESTATUS[0]} -eq 0
+
 .SECONDEXPANSION:
 $(BINDIR)/%: $$(OBJS_$$(call nametr,$$*))
 	$(eval BUILT_PARTS += $@)
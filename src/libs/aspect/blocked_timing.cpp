@@ -22,13 +22,63 @@
  */
 
 #include <aspect/blocked_timing.h>
+#include <aspect/blocked_timing/loop_statistics.h>
+#include <aspect/blocked_timing/overrun_policy.h>
 #include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <core/threading/thread.h>
+#include <utils/time/latency_histogram.h>
+#include <utils/time/latency_trace.h>
+#include <utils/time/trace_recorder.h>
 
+#include <algorithm>
+#include <map>
 #include <stdexcept>
+#include <vector>
 
 namespace fawkes {
 
+namespace {
+
+Mutex &
+loop_phase_mutex()
+{
+	static Mutex mutex;
+	return mutex;
+}
+
+/** Number of threads per loop phase for each loop divisor. */
+std::map<unsigned int, std::vector<unsigned int>> &
+loop_phase_load()
+{
+	static std::map<unsigned int, std::vector<unsigned int>> load;
+	return load;
+}
+
+unsigned int
+acquire_loop_phase(unsigned int divisor)
+{
+	MutexLocker                lock(&loop_phase_mutex());
+	std::vector<unsigned int> &load = loop_phase_load()[divisor];
+	load.resize(divisor, 0);
+	unsigned int phase = std::min_element(load.begin(), load.end()) - load.begin();
+	load[phase] += 1;
+	return phase;
+}
+
+void
+release_loop_phase(unsigned int divisor, unsigned int phase)
+{
+	MutexLocker                lock(&loop_phase_mutex());
+	std::vector<unsigned int> &load = loop_phase_load()[divisor];
+	if (phase < load.size() && load[phase] > 0) {
+		load[phase] -= 1;
+	}
+}
+
+} // end anonymous namespace
+
 /** @class BlockedTimingAspect <aspect/blocked_timing.h>
  * Thread aspect to use blocked timing.
  * The Fawkes main application provides basic means to synchronize all
@@ -38,6 +88,42 @@ namespace fawkes {
  * Your thread must run in Thread::OPMODE_WAITFORWAKEUP mode, otherwise it
  * is not started. This is a requirement for having the BlockedTimingAspect.
  *
+ * If the main application runs blocked timing threads on a thread pool,
+ * the loop of the thread is executed by one of the pool workers instead of
+ * the thread itself, which merely waits until it is stopped. Threads which
+ * rely on running in their own thread, for example because they keep
+ * thread-local state or use cancellation points in loop(), must opt out by
+ * calling set_blocked_timing_dedicated_thread() in their constructor.
+ *
+ * By default, all threads of a hook start when the hook starts. A thread
+ * can instead declare the syncpoint it depends on. It then starts as soon
+ * as all emitters of that syncpoint have emitted it, even if that is
+ * before its own hook has started, e.g. while other threads of an earlier
+ * hook are still running. To allow others to depend on it, a thread can
+ * name its output, it then emits a syncpoint below the end syncpoint of
+ * its hook, see blocked_timing_output_syncpoint(). The hook still ends
+ * only once all of its threads are done. Dependencies must be emitted in
+ * the same or an earlier hook, otherwise the hook times out. Threads with
+ * a dependency are never executed on a thread pool.
+ *
+ * The time from the start of each loop, i.e. after the thread has been
+ * woken up, to the end of loop() is recorded in a latency histogram, which
+ * is registered with BlockedTimingLoopStatistics while the aspect is
+ * initialized.
+ *
+ * Threads which are not essential for the control loop, e.g. for
+ * visualization or logging, should declare low criticality by calling
+ * set_blocked_timing_criticality() in their constructor. After the main
+ * loop overran, their loop() may then be skipped for a number of loops as
+ * configured in BlockedTimingOverrunPolicy. A skipped thread still waits
+ * for and emits its syncpoints, hence dependent threads are not blocked.
+ *
+ * Threads which do not need to run at the full main loop rate can set a
+ * loop divisor, either in code or through the thread policy configuration.
+ * A thread with divisor n only runs loop() every n-th main loop iteration.
+ * Threads with the same divisor are spread evenly across the n possible
+ * loops to balance the load.
+ *
  * @see Thread::OpMode
  * @ingroup Aspects
  * @author Tim Niemueller
@@ -56,25 +142,81 @@ BlockedTimingAspect::BlockedTimingAspect(WakeupHook wakeup_hook)
                   blocked_timing_hook_to_end_syncpoint(wakeup_hook))
 {
 	add_aspect("BlockedTimingAspect");
-	wakeup_hook_   = wakeup_hook;
-	loop_listener_ = new BlockedTimingLoopListener();
+	wakeup_hook_      = wakeup_hook;
+	loop_listener_    = new BlockedTimingLoopListener();
+	dedicated_thread_ = false;
+	pooled_           = false;
+	has_dependency_   = false;
+	criticality_      = CRITICALITY_NORMAL;
+	loop_divisor_     = 1;
+	loop_phase_       = 0;
+	loop_skipped_     = false;
+	loop_time_        = std::make_shared<LatencyHistogram>();
+	loop_start_       = {0, 0};
+	trace_event_      = 0;
+}
+
+/** Constructor with named output and optional dependency.
+ * @param wakeup_hook hook this thread belongs to, the hook does not end
+ * before the thread has run
+ * @param output_name name of the output syncpoint, the thread emits
+ * blocked_timing_output_syncpoint(wakeup_hook, output_name) after each
+ * loop. If empty, the end syncpoint of the hook is emitted.
+ * @param depends_on identifier of the syncpoint the thread waits for
+ * instead of the start of its hook, e.g. the output syncpoint of a thread
+ * that produces the data this thread consumes. If empty, the thread
+ * starts with its hook.
+ */
+BlockedTimingAspect::BlockedTimingAspect(WakeupHook         wakeup_hook,
+                                         const std::string &output_name,
+                                         const std::string &depends_on)
+: SyncPointAspect(SyncPoint::WAIT_FOR_ALL,
+                  depends_on.empty() ? blocked_timing_hook_to_start_syncpoint(wakeup_hook)
+                                     : depends_on,
+                  output_name.empty() ? blocked_timing_hook_to_end_syncpoint(wakeup_hook)
+                                      : blocked_timing_output_syncpoint(wakeup_hook, output_name))
+{
+	add_aspect("BlockedTimingAspect");
+	wakeup_hook_      = wakeup_hook;
+	loop_listener_    = new BlockedTimingLoopListener();
+	dedicated_thread_ = false;
+	pooled_           = false;
+	has_dependency_   = !depends_on.empty();
+	criticality_      = CRITICALITY_NORMAL;
+	loop_divisor_     = 1;
+	loop_phase_       = 0;
+	loop_skipped_     = false;
+	loop_time_        = std::make_shared<LatencyHistogram>();
+	loop_start_       = {0, 0};
+	trace_event_      = 0;
 }
 
-/** Virtual empty destructor. */
+/** Virtual destructor. */
 BlockedTimingAspect::~BlockedTimingAspect()
 {
+	set_blocked_timing_loop_divisor(1);
 	delete loop_listener_;
 }
 
 /** Init BlockedTiming aspect.
  * This intializes the aspect and adds the loop listener to the thread.
+ * If the thread is pooled, it is neither woken up nor is the loop listener
+ * added, the loop is driven by the executor via Thread::execute_loop().
  * @param thread thread which uses this aspect
+ * @param pooled true if the executor runs blocked timing threads on a
+ * thread pool, ignored if the thread requested a dedicated thread
  */
 void
-BlockedTimingAspect::init_BlockedTimingAspect(Thread *thread)
+BlockedTimingAspect::init_BlockedTimingAspect(Thread *thread, bool pooled)
 {
-	thread->add_loop_listener(loop_listener_);
-	thread->wakeup();
+	pooled_ = pooled && !dedicated_thread_ && !has_dependency_;
+	loop_time_->reset();
+	BlockedTimingLoopStatistics::register_thread(thread->name(), wakeup_hook_, loop_time_);
+	trace_event_ = TraceRecorder::event("thread", thread->name());
+	if (!pooled_) {
+		thread->add_loop_listener(loop_listener_);
+		thread->wakeup();
+	}
 }
 
 /** Finalize BlockedTiming aspect.
@@ -84,7 +226,167 @@ BlockedTimingAspect::init_BlockedTimingAspect(Thread *thread)
 void
 BlockedTimingAspect::finalize_BlockedTimingAspect(Thread *thread)
 {
-	thread->remove_loop_listener(loop_listener_);
+	if (!pooled_) {
+		thread->remove_loop_listener(loop_listener_);
+	}
+	BlockedTimingLoopStatistics::unregister_thread(loop_time_);
+}
+
+/** Request a dedicated thread.
+ * Call this in the constructor if the loop of the thread must always be
+ * executed in the thread itself and never on a thread pool.
+ * @param dedicated true to require a dedicated thread
+ */
+void
+BlockedTimingAspect::set_blocked_timing_dedicated_thread(bool dedicated)
+{
+	dedicated_thread_ = dedicated;
+}
+
+/** Set criticality of the thread.
+ * Call this in the constructor to declare how essential the thread is for
+ * the main loop.
+ * @param criticality criticality of the thread
+ */
+void
+BlockedTimingAspect::set_blocked_timing_criticality(Criticality criticality)
+{
+	criticality_ = criticality;
+}
+
+/** Get criticality of the thread.
+ * @return criticality of the thread
+ */
+BlockedTimingAspect::Criticality
+BlockedTimingAspect::blocked_timing_criticality() const
+{
+	return criticality_;
+}
+
+/** Set loop divisor.
+ * The thread then runs loop() only every divisor-th main loop iteration.
+ * In the other iterations it still waits for and emits its syncpoints.
+ * @param divisor loop divisor, 0 or 1 to run in every loop
+ */
+void
+BlockedTimingAspect::set_blocked_timing_loop_divisor(unsigned int divisor)
+{
+	if (divisor == 0)
+		divisor = 1;
+	if (divisor == loop_divisor_)
+		return;
+	if (loop_divisor_ > 1) {
+		release_loop_phase(loop_divisor_, loop_phase_);
+	}
+	loop_phase_   = (divisor > 1) ? acquire_loop_phase(divisor) : 0;
+	loop_divisor_ = divisor;
+}
+
+/** Get loop divisor.
+ * @return loop divisor, 1 if the thread runs in every loop
+ */
+unsigned int
+BlockedTimingAspect::blocked_timing_loop_divisor() const
+{
+	return loop_divisor_;
+}
+
+/** Check if a dedicated thread was requested.
+ * @return true if the thread must not be executed on a thread pool
+ */
+bool
+BlockedTimingAspect::blocked_timing_dedicated_thread() const
+{
+	return dedicated_thread_;
+}
+
+/** Check if the thread is executed on a thread pool.
+ * @return true if the loop is executed by a pool worker
+ */
+bool
+BlockedTimingAspect::blocked_timing_pooled() const
+{
+	return pooled_;
+}
+
+/** Check if the thread depends on a syncpoint other than its hook start.
+ * @return true if the thread starts as soon as its dependency is emitted
+ */
+bool
+BlockedTimingAspect::blocked_timing_has_dependency() const
+{
+	return has_dependency_;
+}
+
+/** Wait for the start syncpoint before loop().
+ * Pooled threads are dispatched by the executor after the start syncpoint
+ * has been emitted and therefore do not wait. As long as the dependency of
+ * a thread has no emitter, the thread waits for anyone to emit it instead
+ * of returning immediately. The loop time is measured from the return of
+ * this method. The latency trace of the calling thread is cleared, such
+ * that only data read in this loop is propagated, see LatencyTrace.
+ * @param thread thread that is about to run loop()
+ */
+void
+BlockedTimingAspect::pre_loop(Thread *thread)
+{
+	if (!pooled_) {
+		RefPtr<SyncPoint> sp = has_dependency_ ? input_syncpoint() : RefPtr<SyncPoint>();
+		if (sp && sp->get_emitters().empty()) {
+			sp->wait(thread->name(), SyncPoint::WAIT_FOR_ONE);
+		} else {
+			SyncPointAspect::pre_loop(thread);
+		}
+	}
+	LatencyTrace::clear();
+	clock_gettime(CLOCK_MONOTONIC, &loop_start_);
+}
+
+/** Record loop time and emit the output syncpoint after loop().
+ * Skipped loops are not recorded.
+ * @param thread thread that has just run loop()
+ */
+void
+BlockedTimingAspect::post_loop(Thread *thread)
+{
+	if (!loop_skipped_) {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		loop_time_->record((now.tv_sec - loop_start_.tv_sec) * 1000000
+		                   + (now.tv_nsec - loop_start_.tv_nsec) / 1000);
+		if (TraceRecorder::enabled()) {
+			TraceRecorder::complete(trace_event_,
+			                        loop_start_.tv_sec * 1000000000ull + loop_start_.tv_nsec,
+			                        now.tv_sec * 1000000000ull + now.tv_nsec);
+		}
+	}
+	SyncPointAspect::post_loop(thread);
+}
+
+/** Check if loop() is skipped in this iteration.
+ * @param thread thread that is about to run loop()
+ * @return true if this is not the thread's turn according to its loop
+ * divisor, or if the main loop is degraded and the thread has low
+ * criticality, see BlockedTimingOverrunPolicy::skip()
+ */
+bool
+BlockedTimingAspect::skip_loop(Thread *thread)
+{
+	loop_skipped_ =
+	  ((loop_divisor_ > 1)
+	   && ((BlockedTimingOverrunPolicy::loop_count() + loop_phase_) % loop_divisor_ != 0))
+	  || BlockedTimingOverrunPolicy::skip(criticality_);
+	return loop_skipped_;
+}
+
+/** Get loop time histogram.
+ * @return histogram of the time from wakeup to the end of loop() in
+ * microseconds
+ */
+std::shared_ptr<const LatencyHistogram>
+BlockedTimingAspect::blocked_timing_loop_time() const
+{
+	return loop_time_;
 }
 
 /** Get the wakeup hook.
@@ -147,6 +449,19 @@ BlockedTimingAspect::blocked_timing_hook_to_end_syncpoint(WakeupHook hook)
 	}
 }
 
+/** Get the identifier of a named output syncpoint of a wakeup hook.
+ * The syncpoint is a successor of the end syncpoint of the hook, hence
+ * emitting it also counts towards the end of the hook.
+ * @param hook wakeup hook the emitting thread belongs to
+ * @param name name of the output, must be a valid syncpoint path component
+ * @return the identifier of the output syncpoint
+ */
+std::string
+BlockedTimingAspect::blocked_timing_output_syncpoint(WakeupHook hook, const std::string &name)
+{
+	return blocked_timing_hook_to_end_syncpoint(hook) + "/" + name;
+}
+
 /** Get the syncpoint identifier corresponding to the start of a wakeup hook.
  * This is the syncpoint waited for at the start of a hook.
  * @param hook wakeup hook to get the syncpoint identifier for
@@ -28,11 +28,15 @@
 #include <aspect/syncpoint.h>
 #include <core/threading/thread_loop_listener.h>
 
+#include <ctime>
 #include <map>
+#include <memory>
 #include <string>
 
 namespace fawkes {
 
+class LatencyHistogram;
+
 /** @class BlockedTimingLoopListener
  * Loop Listener of the BlockedTimingAspect.
  * This loop listener immediately wakes up the thread after loop returned.
@@ -70,27 +74,70 @@ public:
 		WAKEUP_HOOK_POST_LOOP       /**< run after loop */
 	} WakeupHook;
 
+	/** Criticality of a thread for the main loop.
+   * Threads of low criticality may be skipped or run at a reduced rate for
+   * some loops after the main loop overran its desired loop time.
+   * @see BlockedTimingOverrunPolicy
+   */
+	typedef enum {
+		CRITICALITY_HIGH,   /**< thread must always run, e.g. sensor acquisition or actuation */
+		CRITICALITY_NORMAL, /**< thread always runs, default */
+		CRITICALITY_LOW     /**< thread may be degraded after overruns, e.g. visualization */
+	} Criticality;
+
 	BlockedTimingAspect(WakeupHook wakeup_hook);
+	BlockedTimingAspect(WakeupHook         wakeup_hook,
+	                    const std::string &output_name,
+	                    const std::string &depends_on = "");
 	virtual ~BlockedTimingAspect();
 
 	static const char *blocked_timing_hook_to_string(WakeupHook hook);
 
 	static std::string blocked_timing_hook_to_start_syncpoint(WakeupHook hook);
 	static std::string blocked_timing_hook_to_end_syncpoint(WakeupHook hook);
+	static std::string blocked_timing_output_syncpoint(WakeupHook hook, const std::string &name);
 
-	void init_BlockedTimingAspect(Thread *thread);
+	void init_BlockedTimingAspect(Thread *thread, bool pooled = false);
 	void finalize_BlockedTimingAspect(Thread *thread);
 
-	WakeupHook blockedTimingAspectHook() const;
+	WakeupHook   blockedTimingAspectHook() const;
+	bool         blocked_timing_dedicated_thread() const;
+	bool         blocked_timing_pooled() const;
+	bool         blocked_timing_has_dependency() const;
+	Criticality  blocked_timing_criticality() const;
+	unsigned int blocked_timing_loop_divisor() const;
+
+	void set_blocked_timing_loop_divisor(unsigned int divisor);
+
+	virtual void pre_loop(Thread *thread);
+	virtual void post_loop(Thread *thread);
+	virtual bool skip_loop(Thread *thread);
+
+	std::shared_ptr<const LatencyHistogram> blocked_timing_loop_time() const;
 
 	/** Translation from WakeupHooks to SyncPoints. Each WakeupHook corresponds to
    *  exactly one SyncPoint, e.g., WAKEUP_HOOK_PRE_LOOP becomes /preloop.
    */
 	static const std::map<const WakeupHook, const std::string> hook_to_syncpoint;
 
+protected:
+	void set_blocked_timing_dedicated_thread(bool dedicated = true);
+	void set_blocked_timing_criticality(Criticality criticality);
+
 private:
 	WakeupHook                 wakeup_hook_;
 	BlockedTimingLoopListener *loop_listener_;
+	bool                       dedicated_thread_;
+	bool                       pooled_;
+	bool                       has_dependency_;
+	Criticality                criticality_;
+	unsigned int               loop_divisor_;
+	unsigned int               loop_phase_;
+	bool                       loop_skipped_;
+
+	std::shared_ptr<LatencyHistogram> loop_time_;
+	struct timespec                   loop_start_;
+	unsigned int                      trace_event_;
 };
 
 } // end namespace fawkes
@@ -77,6 +77,18 @@ namespace fawkes {
  *
  */
 
+/** Check if threads are executed on a thread pool.
+ * If true, the loops of blocked timing threads are executed by the workers
+ * of a thread pool via Thread::execute_loop(), unless a thread requested a
+ * dedicated thread. The default implementation returns false.
+ * @return true if threads are executed on a thread pool
+ */
+bool
+BlockedTimingExecutor::pooled_execution()
+{
+	return false;
+}
+
 /** Virtual empty destructor. */
 BlockedTimingExecutor::~BlockedTimingExecutor()
 {
@@ -47,6 +47,8 @@ public:
 	virtual bool timed_threads_exist()         = 0;
 	virtual void wait_for_timed_threads()      = 0;
 	virtual void interrupt_timed_thread_wait() = 0;
+
+	virtual bool pooled_execution();
 };
 
 } // end namespace fawkes
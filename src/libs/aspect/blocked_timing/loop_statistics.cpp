@@ -0,0 +1,125 @@
+
+/***************************************************************************
+ *  loop_statistics.cpp - Loop time statistics of blocked timing threads
+ *
+ *  Created: Wed Oct 14 19:35:58 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/blocked_timing/loop_statistics.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+
+#include <map>
+
+namespace fawkes {
+
+/** @class BlockedTimingLoopStatistics <aspect/blocked_timing/loop_statistics.h>
+ * Loop time statistics of blocked timing threads.
+ * This registry holds one latency histogram per wakeup hook, which the main
+ * loop fills with the time from the start to the end of the hook, and one
+ * per blocked timing thread, which the BlockedTimingAspect fills with the
+ * time from waking up to the end of loop(). Recording is lock-free, only
+ * registering threads and creating hook histograms takes a lock. Exporters
+ * such as the metrics plugin read the histograms periodically.
+ *
+ * @author agent
+ */
+
+/** @struct BlockedTimingLoopStatistics::ThreadStatistics
+ * Loop time statistics of a single thread.
+ */
+
+namespace {
+
+Mutex &
+registry_mutex()
+{
+	static Mutex mutex;
+	return mutex;
+}
+
+std::map<BlockedTimingAspect::WakeupHook, std::shared_ptr<LatencyHistogram>> &
+hook_histograms()
+{
+	static std::map<BlockedTimingAspect::WakeupHook, std::shared_ptr<LatencyHistogram>> hooks;
+	return hooks;
+}
+
+std::list<BlockedTimingLoopStatistics::ThreadStatistics> &
+thread_statistics()
+{
+	static std::list<BlockedTimingLoopStatistics::ThreadStatistics> threads;
+	return threads;
+}
+
+} // end anonymous namespace
+
+/** Get histogram of a wakeup hook.
+ * The histogram is created on the first call for the given hook.
+ * @param hook wakeup hook to get the histogram for
+ * @return histogram of hook durations in microseconds
+ */
+std::shared_ptr<LatencyHistogram>
+BlockedTimingLoopStatistics::hook(BlockedTimingAspect::WakeupHook hook)
+{
+	MutexLocker lock(&registry_mutex());
+	std::shared_ptr<LatencyHistogram> &h = hook_histograms()[hook];
+	if (!h) {
+		h = std::make_shared<LatencyHistogram>();
+	}
+	return h;
+}
+
+/** Register loop time histogram of a thread.
+ * @param name name of the thread
+ * @param hook wakeup hook of the thread
+ * @param histogram histogram of loop times in microseconds
+ */
+void
+BlockedTimingLoopStatistics::register_thread(const std::string &                     name,
+                                             BlockedTimingAspect::WakeupHook         hook,
+                                             std::shared_ptr<const LatencyHistogram> histogram)
+{
+	MutexLocker lock(&registry_mutex());
+	thread_statistics().push_back({name, hook, histogram});
+}
+
+/** Unregister loop time histogram of a thread.
+ * @param histogram histogram previously passed to register_thread()
+ */
+void
+BlockedTimingLoopStatistics::unregister_thread(std::shared_ptr<const LatencyHistogram> histogram)
+{
+	MutexLocker lock(&registry_mutex());
+	thread_statistics().remove_if(
+	  [&histogram](const ThreadStatistics &s) { return s.histogram == histogram; });
+}
+
+/** Get statistics of all registered threads.
+ * @return copy of the list of registered threads, the histograms remain
+ * valid even if the thread is unregistered meanwhile
+ */
+std::list<BlockedTimingLoopStatistics::ThreadStatistics>
+BlockedTimingLoopStatistics::threads()
+{
+	MutexLocker lock(&registry_mutex());
+	return thread_statistics();
+}
+
+} // end namespace fawkes
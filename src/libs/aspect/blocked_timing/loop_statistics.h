@@ -0,0 +1,59 @@
+
+/***************************************************************************
+ *  loop_statistics.h - Loop time statistics of blocked timing threads
+ *
+ *  Created: Wed Oct 14 19:35:58 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _ASPECT_BLOCKED_TIMING_LOOP_STATISTICS_H_
+#define _ASPECT_BLOCKED_TIMING_LOOP_STATISTICS_H_
+
+#include <aspect/blocked_timing.h>
+#include <utils/time/latency_histogram.h>
+
+#include <list>
+#include <memory>
+#include <string>
+
+namespace fawkes {
+
+class BlockedTimingLoopStatistics
+{
+public:
+	/** Loop time statistics of a single thread. */
+	typedef struct
+	{
+		std::string                             name;      /**< thread name */
+		BlockedTimingAspect::WakeupHook         hook;      /**< wakeup hook of thread */
+		std::shared_ptr<const LatencyHistogram> histogram; /**< loop time histogram */
+	} ThreadStatistics;
+
+	static std::shared_ptr<LatencyHistogram> hook(BlockedTimingAspect::WakeupHook hook);
+
+	static void register_thread(const std::string &                     name,
+	                            BlockedTimingAspect::WakeupHook         hook,
+	                            std::shared_ptr<const LatencyHistogram> histogram);
+	static void unregister_thread(std::shared_ptr<const LatencyHistogram> histogram);
+
+	static std::list<ThreadStatistics> threads();
+};
+
+} // end namespace fawkes
+
+#endif
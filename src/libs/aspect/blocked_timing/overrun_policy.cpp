@@ -0,0 +1,149 @@
+
+/***************************************************************************
+ *  overrun_policy.cpp - Degrade blocked timing threads after loop overruns
+ *
+ *  Created: Wed Oct 14 19:38:07 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/blocked_timing/overrun_policy.h>
+
+#include <atomic>
+
+namespace fawkes {
+
+/** @class BlockedTimingOverrunPolicy <aspect/blocked_timing/overrun_policy.h>
+ * Degrade blocked timing threads after main loop overruns.
+ * When a main loop iteration takes longer than the desired loop time,
+ * the main loop reports this via loop_done(). For the following
+ * degraded_loops() iterations, threads of low criticality only run every
+ * low_criticality_divisor()-th loop, or not at all if the divisor is zero.
+ * This leaves more time to threads of normal and high criticality, e.g.
+ * sensor acquisition and actuation, to remain on deadline during load
+ * spikes. Every further overrun restarts the degraded period.
+ *
+ * The state is global and accessed lock-free, loop_done() must only be
+ * called by the main loop.
+ *
+ * @see BlockedTimingAspect::Criticality
+ * @author agent
+ */
+
+namespace {
+std::atomic<unsigned int> degraded_loops_{0};
+std::atomic<unsigned int> low_criticality_divisor_{0};
+std::atomic<unsigned int> degraded_remaining_{0};
+std::atomic<unsigned int> loop_count_{0};
+} // end anonymous namespace
+
+/** Set number of degraded loops.
+ * @param loops number of loops after an overrun during which threads of
+ * low criticality are degraded, zero disables degradation
+ */
+void
+BlockedTimingOverrunPolicy::set_degraded_loops(unsigned int loops)
+{
+	degraded_loops_.store(loops, std::memory_order_relaxed);
+	if (loops == 0) {
+		degraded_remaining_.store(0, std::memory_order_relaxed);
+	}
+}
+
+/** Set rate of low criticality threads while degraded.
+ * @param divisor threads of low criticality run every divisor-th loop while
+ * degraded, zero to skip them entirely
+ */
+void
+BlockedTimingOverrunPolicy::set_low_criticality_divisor(unsigned int divisor)
+{
+	low_criticality_divisor_.store(divisor, std::memory_order_relaxed);
+}
+
+/** Get number of main loop iterations.
+ * @return number of calls to loop_done(), wraps around on overflow
+ */
+unsigned int
+BlockedTimingOverrunPolicy::loop_count()
+{
+	return loop_count_.load(std::memory_order_relaxed);
+}
+
+/** Get number of degraded loops.
+ * @return number of loops during which threads are degraded after an overrun
+ */
+unsigned int
+BlockedTimingOverrunPolicy::degraded_loops()
+{
+	return degraded_loops_.load(std::memory_order_relaxed);
+}
+
+/** Get rate of low criticality threads while degraded.
+ * @return divisor, zero if low criticality threads are skipped
+ */
+unsigned int
+BlockedTimingOverrunPolicy::low_criticality_divisor()
+{
+	return low_criticality_divisor_.load(std::memory_order_relaxed);
+}
+
+/** Notify about the end of a main loop iteration.
+ * Call this after the last hook of an iteration has finished and before
+ * the next one starts.
+ * @param overrun true if the iteration exceeded the desired loop time
+ * @return true if the iteration started a new degraded period, i.e. the
+ * loop overran while not being degraded
+ */
+bool
+BlockedTimingOverrunPolicy::loop_done(bool overrun)
+{
+	loop_count_.fetch_add(1, std::memory_order_relaxed);
+	unsigned int remaining = degraded_remaining_.load(std::memory_order_relaxed);
+	if (overrun) {
+		degraded_remaining_.store(degraded_loops_.load(std::memory_order_relaxed),
+		                          std::memory_order_relaxed);
+		return (remaining == 0) && (degraded_loops_.load(std::memory_order_relaxed) > 0);
+	} else if (remaining > 0) {
+		degraded_remaining_.store(remaining - 1, std::memory_order_relaxed);
+	}
+	return false;
+}
+
+/** Check if the main loop currently is degraded.
+ * @return true if threads of low criticality are currently degraded
+ */
+bool
+BlockedTimingOverrunPolicy::degraded()
+{
+	return degraded_remaining_.load(std::memory_order_relaxed) > 0;
+}
+
+/** Check if a thread should skip the current loop.
+ * @param criticality criticality of the thread
+ * @return true if the thread should not run loop() in the current iteration
+ */
+bool
+BlockedTimingOverrunPolicy::skip(BlockedTimingAspect::Criticality criticality)
+{
+	if (criticality != BlockedTimingAspect::CRITICALITY_LOW || !degraded()) {
+		return false;
+	}
+	unsigned int divisor = low_criticality_divisor_.load(std::memory_order_relaxed);
+	return (divisor == 0) || (loop_count_.load(std::memory_order_relaxed) % divisor != 0);
+}
+
+} // end namespace fawkes
@@ -0,0 +1,48 @@
+
+/***************************************************************************
+ *  overrun_policy.h - Degrade blocked timing threads after loop overruns
+ *
+ *  Created: Wed Oct 14 19:38:07 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _ASPECT_BLOCKED_TIMING_OVERRUN_POLICY_H_
+#define _ASPECT_BLOCKED_TIMING_OVERRUN_POLICY_H_
+
+#include <aspect/blocked_timing.h>
+
+namespace fawkes {
+
+class BlockedTimingOverrunPolicy
+{
+public:
+	static void set_degraded_loops(unsigned int loops);
+	static void set_low_criticality_divisor(unsigned int divisor);
+
+	static bool loop_done(bool overrun);
+	static bool degraded();
+	static bool skip(BlockedTimingAspect::Criticality criticality);
+
+	static unsigned int loop_count();
+	static unsigned int degraded_loops();
+	static unsigned int low_criticality_divisor();
+};
+
+} // end namespace fawkes
+
+#endif
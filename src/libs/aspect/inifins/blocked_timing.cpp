@@ -22,6 +22,7 @@
  */
 
 #include <aspect/blocked_timing.h>
+#include <aspect/blocked_timing/executor.h>
 #include <aspect/inifins/blocked_timing.h>
 #include <core/macros.h>
 
@@ -32,9 +33,14 @@ namespace fawkes {
  * @author Tim Niemueller
  */
 
-/** Constructor. */
-BlockedTimingAspectIniFin::BlockedTimingAspectIniFin() : AspectIniFin("BlockedTimingAspect")
+/** Constructor.
+ * @param btexec blocked timing executor, queried whether threads are
+ * executed on a thread pool, may be NULL
+ */
+BlockedTimingAspectIniFin::BlockedTimingAspectIniFin(BlockedTimingExecutor *btexec)
+: AspectIniFin("BlockedTimingAspect")
 {
+	btexec_ = btexec;
 }
 
 void
@@ -56,7 +62,7 @@ BlockedTimingAspectIniFin::init(Thread *thread)
 		                                      thread->name());
 	}
 
-	blocked_timing_thread->init_BlockedTimingAspect(thread);
+	blocked_timing_thread->init_BlockedTimingAspect(thread, btexec_ && btexec_->pooled_execution());
 }
 
 void
@@ -28,13 +28,18 @@
 
 namespace fawkes {
 
+class BlockedTimingExecutor;
+
 class BlockedTimingAspectIniFin : public AspectIniFin
 {
 public:
-	BlockedTimingAspectIniFin();
+	BlockedTimingAspectIniFin(BlockedTimingExecutor *btexec = 0);
 
 	virtual void init(Thread *thread);
 	virtual void finalize(Thread *thread);
+
+private:
+	BlockedTimingExecutor *btexec_;
 };
 
 } // end namespace fawkes
@@ -47,7 +47,8 @@ SyncPointAspect::SyncPointAspect(SyncPoint::WakeupType type_in,
   identifier_in_(identifier_in),
   identifier_out_(identifier_out),
   sp_in_(NULL),
-  sp_out_(NULL)
+  sp_out_(NULL),
+  component_id_(SyncPoint::NO_COMPONENT)
 {
 	add_aspect("SyncPointAspect");
 	has_input_syncpoint_  = (identifier_in != "");
@@ -64,7 +65,8 @@ SyncPointAspect::SyncPointAspect(std::string identifier_out)
   identifier_in_(""),
   identifier_out_(identifier_out),
   sp_in_(NULL),
-  sp_out_(NULL)
+  sp_out_(NULL),
+  component_id_(SyncPoint::NO_COMPONENT)
 {
 	add_aspect("SyncPointAspect");
 	has_input_syncpoint_  = false;
@@ -86,6 +88,8 @@ SyncPointAspect::~SyncPointAspect()
 void
 SyncPointAspect::init_SyncPointAspect(Thread *thread, SyncPointManager *manager)
 {
+	component_id_ = SyncPoint::component_id(thread->name());
+
 	if (has_input_syncpoint_) {
 		sp_in_ = manager->get_syncpoint(thread->name(), identifier_in_);
 	}
@@ -129,7 +133,7 @@ void
 SyncPointAspect::pre_loop(Thread *thread)
 {
 	if (has_input_syncpoint_) {
-		sp_in_->wait(thread->name(), type_in_);
+		sp_in_->wait(component_id_, type_in_);
 	}
 }
 
@@ -140,8 +144,18 @@ void
 SyncPointAspect::post_loop(Thread *thread)
 {
 	if (has_output_syncpoint_) {
-		sp_out_->emit(thread->name());
+		sp_out_->emit(component_id_);
 	}
 }
 
+/** Get the input syncpoint.
+ * @return input syncpoint, invalid RefPtr if there is none or the aspect
+ * has not been initialized
+ */
+RefPtr<SyncPoint>
+SyncPointAspect::input_syncpoint() const
+{
+	return sp_in_;
+}
+
 } // end namespace fawkes
@@ -46,6 +46,9 @@ public:
 	void pre_loop(Thread *thread);
 	void post_loop(Thread *thread);
 
+protected:
+	RefPtr<SyncPoint> input_syncpoint() const;
+
 private:
 	SyncPoint::WakeupType type_in_;
 	std::string           identifier_in_;
@@ -54,6 +57,7 @@ private:
 	bool                  has_output_syncpoint_;
 	RefPtr<SyncPoint>     sp_in_;
 	RefPtr<SyncPoint>     sp_out_;
+	unsigned int          component_id_;
 };
 
 } // end namespace fawkes
@@ -0,0 +1,400 @@
+
+/***************************************************************************
+ *  blocked_timing_pool.cpp - Thread pool for blocked timing threads
+ *
+ *  Created: Wed Oct 14 19:14:57 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <baseapp/blocked_timing_pool.h>
+#include <core/exception.h>
+#include <core/exceptions/software.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+
+#include <ctime>
+#include <unistd.h>
+
+namespace fawkes {
+
+/** Worker thread of the pool. */
+class BlockedTimingThreadPool::Worker : public Thread
+{
+public:
+	/** Constructor.
+	 * @param pool pool to work for
+	 * @param index index of the worker and its queue
+	 */
+	Worker(BlockedTimingThreadPool *pool, unsigned int index)
+	: Thread("BlockedTimingThreadPoolWorker", Thread::OPMODE_CONTINUOUS)
+	{
+		set_name("BlockedTimingThreadPoolWorker %u", index);
+		pool_  = pool;
+		index_ = index;
+	}
+
+	virtual void
+	loop()
+	{
+		if (!pool_->work(index_)) {
+			exit();
+		}
+	}
+
+protected:
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	BlockedTimingThreadPool *pool_;
+	unsigned int             index_;
+};
+
+/** @class BlockedTimingThreadPool <baseapp/blocked_timing_pool.h>
+ * Thread pool for blocked timing threads.
+ * Instead of waking up one thread per blocked timing thread in each main
+ * loop iteration, the loops of the threads of a hook are executed by a
+ * fixed number of worker threads. Each worker has its own task queue.
+ * Dispatched tasks are distributed round-robin over the queues, a worker
+ * takes tasks from the back of its own queue and steals from the front of
+ * other queues if its own queue is empty. Hence load is balanced even if
+ * some threads of a hook take much longer than others.
+ *
+ * The loop of each thread is run via Thread::execute_loop(). A thread
+ * never runs concurrently with itself. If it is dispatched again while
+ * still running, another iteration is executed once the current one has
+ * finished.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param num_workers number of worker threads, 0 to use one per online
+ * processor core
+ */
+BlockedTimingThreadPool::BlockedTimingThreadPool(unsigned int num_workers)
+{
+	if (num_workers == 0) {
+		long int cores = sysconf(_SC_NPROCESSORS_ONLN);
+		num_workers    = (cores > 0) ? cores : 1;
+	}
+
+	mutex_      = new Mutex();
+	work_cond_  = new WaitCondition(mutex_);
+	done_cond_  = new WaitCondition(mutex_);
+	quit_       = false;
+	pending_    = 0;
+	next_queue_ = 0;
+
+	queues_.resize(num_workers);
+	for (unsigned int i = 0; i < num_workers; ++i) {
+		queue_mutexes_.push_back(new Mutex());
+	}
+	for (unsigned int i = 0; i < num_workers; ++i) {
+		workers_.push_back(new Worker(this, i));
+		workers_[i]->start();
+	}
+}
+
+/** Destructor.
+ * Workers finish their current task and are then stopped. Tasks which
+ * have not been started are dropped.
+ */
+BlockedTimingThreadPool::~BlockedTimingThreadPool()
+{
+	mutex_->lock();
+	quit_ = true;
+	work_cond_->wake_all();
+	mutex_->unlock();
+
+	for (unsigned int i = 0; i < workers_.size(); ++i) {
+		workers_[i]->join();
+		delete workers_[i];
+		delete queue_mutexes_[i];
+	}
+
+	for (std::map<Thread *, Task *>::iterator t = tasks_.begin(); t != tasks_.end(); ++t) {
+		delete t->second;
+	}
+
+	delete work_cond_;
+	delete done_cond_;
+	delete mutex_;
+}
+
+/** Get number of workers.
+ * @return number of worker threads
+ */
+unsigned int
+BlockedTimingThreadPool::num_workers() const
+{
+	return workers_.size();
+}
+
+/** Add thread.
+ * @param thread thread whose loop to execute on the pool
+ * @param hook wakeup hook of the thread
+ * @exception IllegalArgumentException thrown if the thread has already
+ * been added
+ */
+void
+BlockedTimingThreadPool::add_thread(Thread *thread, BlockedTimingAspect::WakeupHook hook)
+{
+	MutexLocker lock(mutex_);
+	if (tasks_.find(thread) != tasks_.end()) {
+		throw IllegalArgumentException("Thread '%s' has already been added to thread pool",
+		                               thread->name());
+	}
+
+	Task *task      = new Task();
+	task->thread    = thread;
+	task->hook      = hook;
+	task->scheduled = false;
+	task->rerun     = false;
+	tasks_[thread]  = task;
+	hook_tasks_[hook].push_back(task);
+}
+
+/** Remove thread.
+ * The thread is no longer dispatched. If its loop is currently queued or
+ * running, this waits until it has finished.
+ * @param thread thread to remove
+ */
+void
+BlockedTimingThreadPool::remove_thread(Thread *thread)
+{
+	MutexLocker lock(mutex_);
+	std::map<Thread *, Task *>::iterator t = tasks_.find(thread);
+	if (t == tasks_.end())
+		return;
+
+	Task *task = t->second;
+	tasks_.erase(t);
+	hook_tasks_[task->hook].remove(task);
+	if (hook_tasks_[task->hook].empty()) {
+		hook_tasks_.erase(task->hook);
+	}
+
+	task->rerun = false;
+	while (task->scheduled) {
+		done_cond_->wait();
+	}
+	delete task;
+}
+
+/** Check if any threads have been added.
+ * @return true if at least one thread is executed on the pool
+ */
+bool
+BlockedTimingThreadPool::has_threads()
+{
+	MutexLocker lock(mutex_);
+	return !tasks_.empty();
+}
+
+/** Dispatch threads of a hook.
+ * Queues the loops of all threads of the given hook for execution and
+ * returns immediately.
+ * @param hook hook to execute
+ */
+void
+BlockedTimingThreadPool::execute(BlockedTimingAspect::WakeupHook hook)
+{
+	MutexLocker lock(mutex_);
+	std::map<BlockedTimingAspect::WakeupHook, std::list<Task *>>::iterator h =
+	  hook_tasks_.find(hook);
+	if (h == hook_tasks_.end())
+		return;
+
+	for (std::list<Task *>::iterator t = h->second.begin(); t != h->second.end(); ++t) {
+		Task *task = *t;
+		if (task->scheduled) {
+			task->rerun = true;
+		} else {
+			task->scheduled = true;
+			outstanding_[hook] += 1;
+			push_task(next_queue_, task);
+			next_queue_ = (next_queue_ + 1) % queues_.size();
+			pending_ += 1;
+		}
+	}
+	work_cond_->wake_all();
+}
+
+/** Wait for threads of a hook.
+ * @param hook hook to wait for
+ * @param timeout_usec timeout in microseconds, 0 to wait indefinitely
+ * @return true if all loops of the hook have finished, false on timeout
+ */
+bool
+BlockedTimingThreadPool::wait(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec)
+{
+	struct timespec deadline;
+	if (timeout_usec > 0) {
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += timeout_usec / 1000000;
+		deadline.tv_nsec += (timeout_usec % 1000000) * 1000;
+		if (deadline.tv_nsec >= 1000000000) {
+			deadline.tv_sec += 1;
+			deadline.tv_nsec -= 1000000000;
+		}
+	}
+
+	MutexLocker lock(mutex_);
+	while (outstanding_[hook] > 0) {
+		if (timeout_usec > 0) {
+			if (!done_cond_->abstimed_wait(deadline.tv_sec, deadline.tv_nsec)) {
+				return (outstanding_[hook] == 0);
+			}
+		} else {
+			done_cond_->wait();
+		}
+	}
+	return true;
+}
+
+/** Get threads of a hook which are still queued or running.
+ * @param hook hook to check
+ * @return names of the threads which have not finished, yet
+ */
+std::list<std::string>
+BlockedTimingThreadPool::busy_threads(BlockedTimingAspect::WakeupHook hook)
+{
+	std::list<std::string> rv;
+	MutexLocker            lock(mutex_);
+	std::map<BlockedTimingAspect::WakeupHook, std::list<Task *>>::iterator h =
+	  hook_tasks_.find(hook);
+	if (h != hook_tasks_.end()) {
+		for (std::list<Task *>::iterator t = h->second.begin(); t != h->second.end(); ++t) {
+			if ((*t)->scheduled)
+				rv.push_back((*t)->thread->name());
+		}
+	}
+	return rv;
+}
+
+/** Push task to queue.
+ * @param worker index of the queue to push to
+ * @param task task to push
+ */
+void
+BlockedTimingThreadPool::push_task(unsigned int worker, Task *task)
+{
+	MutexLocker lock(queue_mutexes_[worker]);
+	queues_[worker].push_back(task);
+}
+
+/** Get next task for worker.
+ * Takes the most recently queued task of the worker's own queue, or the
+ * oldest task of another worker's queue if the own queue is empty.
+ * @param worker index of the worker
+ * @return task or NULL if all queues are empty
+ */
+BlockedTimingThreadPool::Task *
+BlockedTimingThreadPool::pop_task(unsigned int worker)
+{
+	Task *task = NULL;
+
+	queue_mutexes_[worker]->lock();
+	if (!queues_[worker].empty()) {
+		task = queues_[worker].back();
+		queues_[worker].pop_back();
+	}
+	queue_mutexes_[worker]->unlock();
+
+	for (unsigned int i = 1; !task && i < queues_.size(); ++i) {
+		unsigned int victim = (worker + i) % queues_.size();
+		MutexLocker  lock(queue_mutexes_[victim]);
+		if (!queues_[victim].empty()) {
+			task = queues_[victim].front();
+			queues_[victim].pop_front();
+		}
+	}
+
+	return task;
+}
+
+/** Run a task.
+ * Exceptions thrown by the loop are caught, the thread manager of a
+ * dedicated thread would not see them either.
+ * @param worker index of the worker running the task
+ * @param task task to run
+ */
+void
+BlockedTimingThreadPool::run_task(unsigned int worker, Task *task)
+{
+	try {
+		task->thread->execute_loop();
+	} catch (Exception &e) {
+		e.print_trace();
+	} catch (std::exception &e) {
+		// ignored, nothing sensible to do with it here
+	} catch (...) {
+		// ignored
+	}
+
+	MutexLocker lock(mutex_);
+	if (task->rerun) {
+		task->rerun = false;
+		push_task(worker, task);
+		pending_ += 1;
+		work_cond_->wake_one();
+	} else {
+		task->scheduled = false;
+		outstanding_[task->hook] -= 1;
+		done_cond_->wake_all();
+	}
+}
+
+/** Work on tasks.
+ * Called by the workers, waits for a task and runs it. Returns without
+ * running a task if the pool is being destroyed.
+ * @param worker index of the calling worker
+ * @return false if the worker shall exit, true otherwise
+ */
+bool
+BlockedTimingThreadPool::work(unsigned int worker)
+{
+	mutex_->lock();
+	while (pending_ == 0 && !quit_) {
+		work_cond_->wait();
+	}
+	if (quit_) {
+		mutex_->unlock();
+		return false;
+	}
+	pending_ -= 1;
+	mutex_->unlock();
+
+	Task *task = NULL;
+	while (!(task = pop_task(worker))) {
+		// the task is pushed before pending_ is increased, so it must be
+		// in one of the queues, another worker may just hold the queue lock
+		usleep(0);
+	}
+
+	run_task(worker, task);
+	return true;
+}
+
+} // end namespace fawkes
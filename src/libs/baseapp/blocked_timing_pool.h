@@ -0,0 +1,91 @@
+
+/***************************************************************************
+ *  blocked_timing_pool.h - Thread pool for blocked timing threads
+ *
+ *  Created: Wed Oct 14 19:14:57 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_BASEAPP_BLOCKED_TIMING_POOL_H_
+#define _LIBS_BASEAPP_BLOCKED_TIMING_POOL_H_
+
+#include <aspect/blocked_timing.h>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Thread;
+class Mutex;
+class WaitCondition;
+
+class BlockedTimingThreadPool
+{
+public:
+	BlockedTimingThreadPool(unsigned int num_workers = 0);
+	~BlockedTimingThreadPool();
+
+	unsigned int num_workers() const;
+
+	void add_thread(Thread *thread, BlockedTimingAspect::WakeupHook hook);
+	void remove_thread(Thread *thread);
+	bool has_threads();
+
+	void                   execute(BlockedTimingAspect::WakeupHook hook);
+	bool                   wait(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec = 0);
+	std::list<std::string> busy_threads(BlockedTimingAspect::WakeupHook hook);
+
+private:
+	/** Loop execution task of one thread. */
+	typedef struct
+	{
+		Thread *                        thread;    /**< thread to execute */
+		BlockedTimingAspect::WakeupHook hook;      /**< hook of the thread */
+		bool                            scheduled; /**< queued or running */
+		bool                            rerun;     /**< execute again when done */
+	} Task;
+
+	class Worker;
+
+	Task *pop_task(unsigned int worker);
+	void  push_task(unsigned int worker, Task *task);
+	void  run_task(unsigned int worker, Task *task);
+	bool  work(unsigned int worker);
+
+private:
+	Mutex *        mutex_;
+	WaitCondition *work_cond_;
+	WaitCondition *done_cond_;
+	bool           quit_;
+	unsigned int   pending_;
+	unsigned int   next_queue_;
+
+	std::vector<Worker *>                                        workers_;
+	std::vector<Mutex *>                                         queue_mutexes_;
+	std::vector<std::deque<Task *>>                              queues_;
+	std::map<Thread *, Task *>                                   tasks_;
+	std::map<BlockedTimingAspect::WakeupHook, std::list<Task *>> hook_tasks_;
+	std::map<BlockedTimingAspect::WakeupHook, unsigned int>      outstanding_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -21,23 +21,29 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <aspect/blocked_timing/loop_statistics.h>
+#include <aspect/blocked_timing/overrun_policy.h>
 #include <aspect/manager.h>
 #include <baseapp/main_thread.h>
 #include <config/config.h>
 #include <core/exceptions/system.h>
 #include <core/macros.h>
 #include <core/threading/interruptible_barrier.h>
+#include <core/threading/lock_profiler.h>
 #include <core/threading/mutex_locker.h>
 #include <core/version.h>
 #include <plugin/loader.h>
 #include <plugin/manager.h>
 #include <utils/time/clock.h>
+#include <utils/time/latency_histogram.h>
+#include <utils/time/trace_recorder.h>
 #include <utils/time/wait.h>
 
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <unistd.h>
 
 namespace fawkes {
@@ -80,6 +86,8 @@ FawkesMainThread::FawkesMainThread(Configuration *   config,
 	mainloop_mutex_   = new Mutex();
 	mainloop_barrier_ = new InterruptibleBarrier(mainloop_mutex_, 2);
 
+	syncpoint_component_ = SyncPoint::component_id("FawkesMainThread");
+
 	load_plugins_ = NULL;
 	if (load_plugins) {
 		load_plugins_ = strdup(load_plugins);
@@ -116,6 +124,19 @@ FawkesMainThread::FawkesMainThread(Configuration *   config,
 
 	desired_loop_time_sec_ = (float)desired_loop_time_usec_ / 1000000.f;
 
+	try {
+		BlockedTimingOverrunPolicy::set_degraded_loops(
+		  config_->get_uint("/fawkes/mainapp/overrun/degraded_loops"));
+	} catch (Exception &e) {
+		BlockedTimingOverrunPolicy::set_degraded_loops(0);
+	}
+	try {
+		BlockedTimingOverrunPolicy::set_low_criticality_divisor(
+		  config_->get_uint("/fawkes/mainapp/overrun/low_criticality_divisor"));
+	} catch (Exception &e) {
+		BlockedTimingOverrunPolicy::set_low_criticality_divisor(0);
+	}
+
 	try {
 		enable_looptime_warnings_ = config_->get_bool("/fawkes/mainapp/enable_looptime_warnings");
 		if (!enable_looptime_warnings_) {
@@ -124,6 +145,13 @@ FawkesMainThread::FawkesMainThread(Configuration *   config,
 	} catch (Exception &e) {
 		enable_looptime_warnings_ = true;
 	}
+
+	critical_path_interval_ = 0.;
+	try {
+		critical_path_interval_ = config_->get_float("/fawkes/mainapp/critical_path_interval");
+	} catch (Exception &e) {
+	} // ignore, we stick with the default
+	critical_path_last_ = new Time(clock_);
 }
 
 /** Destructor. */
@@ -181,6 +209,7 @@ FawkesMainThread::destruct()
 	delete time_wait_;
 	delete loop_start_;
 	delete loop_end_;
+	delete critical_path_last_;
 
 	delete mainloop_barrier_;
 	delete mainloop_mutex_;
@@ -206,7 +235,7 @@ void
 FawkesMainThread::once()
 {
 	// register to all syncpoints of the main loop
-	std::vector<BlockedTimingAspect::WakeupHook> hooks;
+	std::vector<BlockedTimingAspect::WakeupHook> &hooks = syncpoint_hooks_;
 	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP);
 	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE);
 	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PREPARE);
@@ -227,6 +256,9 @@ FawkesMainThread::once()
 			syncpoints_start_hook_.back()->register_emitter("FawkesMainThread");
 			syncpoints_end_hook_.push_back(syncpoint_manager_->get_syncpoint(
 			  "FawkesMainThread", BlockedTimingAspect::blocked_timing_hook_to_end_syncpoint(*it)));
+			hook_loop_time_.push_back(BlockedTimingLoopStatistics::hook(*it));
+			hook_trace_events_.push_back(
+			  TraceRecorder::event("hook", BlockedTimingAspect::blocked_timing_hook_to_string(*it)));
 		}
 	} catch (Exception &e) {
 		multi_logger_->log_error("FawkesMainThread", "Failed to acquire mainloop syncpoint");
@@ -321,6 +353,7 @@ FawkesMainThread::loop()
 			time_wait_->mark_start();
 		}
 		loop_start_->stamp_systime();
+		clock_->stamp_loop_time();
 
 		CancelState old_state;
 		set_cancel_state(CANCEL_DISABLED, &old_state);
@@ -343,17 +376,46 @@ FawkesMainThread::loop()
 				  "FawkesMainThread",
 				  "Hook syncpoints are not initialized properly, not waking up any threads!");
 			} else {
+				// Threads which depend on a syncpoint other than the start of
+				// their hook may finish before we wait for the end of the
+				// hook. Make them wait in emit() until we do so that the
+				// emission is not missed.
 				for (uint i = 0; i < num_hooks; i++) {
-					syncpoints_start_hook_[i]->emit("FawkesMainThread");
-					syncpoints_end_hook_[i]->reltime_wait_for_all("FawkesMainThread",
-					                                              0,
-					                                              max_thread_time_nanosec_);
+					syncpoints_end_hook_[i]->lock_until_next_wait(syncpoint_component_);
+				}
+				for (uint i = 0; i < num_hooks; i++) {
+					struct timespec hook_start, hook_end;
+					clock_gettime(CLOCK_MONOTONIC, &hook_start);
+					syncpoints_start_hook_[i]->emit(syncpoint_component_);
+					// pooled threads do not wait for the start syncpoint
+					thread_manager_->execute_pooled(syncpoint_hooks_[i]);
+					syncpoints_end_hook_[i]->wait(syncpoint_component_,
+					                              SyncPoint::WAIT_FOR_ALL,
+					                              0,
+					                              max_thread_time_nanosec_);
+					clock_gettime(CLOCK_MONOTONIC, &hook_end);
+					hook_loop_time_[i]->record((hook_end.tv_sec - hook_start.tv_sec) * 1000000
+					                           + (hook_end.tv_nsec - hook_start.tv_nsec) / 1000);
+					if (TraceRecorder::enabled()) {
+						TraceRecorder::complete(hook_trace_events_[i],
+						                        hook_start.tv_sec * 1000000000ull + hook_start.tv_nsec,
+						                        hook_end.tv_sec * 1000000000ull + hook_end.tv_nsec);
+					}
 				}
 			}
 		}
 		mainloop_mutex_->unlock();
 		set_cancel_state(old_state);
 
+		if (critical_path_interval_ > 0. && mainloop_thread_ == NULL
+		    && !syncpoints_end_hook_.empty()) {
+			Time now;
+			if (now - critical_path_last_ >= critical_path_interval_) {
+				*critical_path_last_ = now;
+				report_critical_path(now);
+			}
+		}
+
 		test_cancel();
 
 		thread_manager_->try_recover(recovered_threads_);
@@ -383,9 +445,11 @@ FawkesMainThread::loop()
 			recovered_threads_.clear();
 		}
 
+		bool overrun = false;
 		if (desired_loop_time_sec_ > 0) {
 			loop_end_->stamp_systime();
 			float loop_time = *loop_end_ - loop_start_;
+			overrun         = (loop_time > desired_loop_time_sec_);
 			if (enable_looptime_warnings_) {
 				// give some extra 10% to eliminate frequent false warnings due to regular
 				// time jitter (TimeWait might not be all that precise)
@@ -399,10 +463,15 @@ FawkesMainThread::loop()
 				}
 			}
 		}
+		if (BlockedTimingOverrunPolicy::loop_done(overrun) && enable_looptime_warnings_) {
+			multi_logger_->log_warn("FawkesMainThread",
+			                        "Loop overrun, degrading low criticality threads for %u loops",
+			                        BlockedTimingOverrunPolicy::degraded_loops());
+		}
 
 		plugin_manager_->unlock();
 
-		if (time_wait_) {
+		if (time_wait_ && !clock_->is_lockstep()) {
 			time_wait_->wait_systime();
 		} else {
 			yield();
@@ -422,6 +491,41 @@ FawkesMainThread::loop()
 	// at least needs to be rethrown.
 }
 
+/** Log the critical path of the last loop.
+ * The critical path is the chain of threads which released each other and
+ * ended with the last thread of the last hook. Its length bounds the loop
+ * time, speeding up other threads does not decrease the loop time.
+ * @param until time when the last hook ended
+ */
+void
+FawkesMainThread::report_critical_path(const Time &until)
+{
+	std::vector<SyncPointPathSegment> path =
+	  syncpoint_manager_->critical_path(syncpoints_end_hook_.back()->get_identifier(),
+	                                    until,
+	                                    *loop_start_);
+
+	float       length = 0.;
+	std::string threads;
+	for (std::vector<SyncPointPathSegment>::iterator s = path.begin(); s != path.end(); ++s) {
+		if (s->component == "FawkesMainThread")
+			continue;
+		float duration = s->end - &s->start;
+		length += duration;
+		char ms[32];
+		snprintf(ms, sizeof(ms), " (%.2f ms)", duration * 1000.);
+		if (!threads.empty())
+			threads += " -> ";
+		threads += s->component + ms;
+	}
+
+	multi_logger_->log_info("FawkesMainThread",
+	                        "Critical path %.2f ms of %.2f ms loop: %s",
+	                        length * 1000.,
+	                        (until - loop_start_) * 1000.,
+	                        threads.empty() ? "none" : threads.c_str());
+}
+
 /** Get logger.
  * @return logger
  */
@@ -457,6 +561,7 @@ FawkesMainThread::Runner::Runner(FawkesMainThread *fmt, bool register_signals)
 		SignalManager::register_handler(SIGINT, this);
 		SignalManager::register_handler(SIGTERM, this);
 		SignalManager::register_handler(SIGALRM, this);
+		SignalManager::register_handler(SIGUSR2, this);
 	}
 }
 
@@ -467,6 +572,7 @@ FawkesMainThread::Runner::~Runner()
 		SignalManager::unregister_handler(SIGINT);
 		SignalManager::unregister_handler(SIGTERM);
 		SignalManager::unregister_handler(SIGALRM);
+		SignalManager::unregister_handler(SIGUSR2);
 	}
 	delete init_mutex_;
 }
@@ -504,6 +610,8 @@ FawkesMainThread::Runner::handle_signal(int signum)
 		}
 		sigint_running_ = true;
 		alarm(3 /* sec */);
+	} else if (signum == SIGUSR2) {
+		LockProfiler::print();
 	} else if (signum == SIGALRM) {
 		// we could use fmt_->logger()->log_info(), but we prefer direct printf
 		// because we're mentioning Ctrl-C only useful on the console anyway
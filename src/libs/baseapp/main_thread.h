@@ -34,6 +34,7 @@
 
 #include <getopt.h>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -54,6 +55,7 @@ class Mutex;
 class ThreadManager;
 class SyncPointManager;
 class FawkesNetworkManager;
+class LatencyHistogram;
 
 class FawkesMainThread : public Thread, public MainLoopEmployer
 {
@@ -103,6 +105,7 @@ protected:
 
 private:
 	void destruct();
+	void report_critical_path(const Time &until);
 
 	inline void
 	safe_wake(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec)
@@ -144,9 +147,16 @@ private:
 	Time *                 loop_start_;
 	Time *                 loop_end_;
 	bool                   enable_looptime_warnings_;
+	float                  critical_path_interval_;
+	Time *                 critical_path_last_;
 
-	std::vector<RefPtr<SyncPoint>> syncpoints_start_hook_;
-	std::vector<RefPtr<SyncPoint>> syncpoints_end_hook_;
+	unsigned int                                 syncpoint_component_;
+	std::vector<BlockedTimingAspect::WakeupHook> syncpoint_hooks_;
+	std::vector<RefPtr<SyncPoint>>               syncpoints_start_hook_;
+	std::vector<RefPtr<SyncPoint>>               syncpoints_end_hook_;
+
+	std::vector<std::shared_ptr<LatencyHistogram>> hook_loop_time_;
+	std::vector<unsigned int>                      hook_trace_events_;
 };
 
 } // end namespace fawkes
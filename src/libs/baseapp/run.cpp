@@ -25,6 +25,9 @@
 #include <baseapp/main_thread.h>
 #include <baseapp/run.h>
 #include <baseapp/thread_manager.h>
+#include <baseapp/thread_policy.h>
+#include <core/threading/lock_profiler.h>
+#include <core/threading/spin_wait.h>
 #include <core/threading/thread.h>
 
 #ifdef HAVE_BLACKBOARD
@@ -107,7 +110,8 @@ LogFileDescriptorToLog *log_fd_redirect_stdout_ = NULL;
 #endif
 
 // this is NOT shared to the outside
-FawkesMainThread::Runner *runner = NULL;
+FawkesMainThread::Runner *runner        = NULL;
+ThreadPolicy *            thread_policy = NULL;
 
 bool
 init(int argc, char **argv, int &retval)
@@ -239,7 +243,9 @@ init(const InitOptions &options, int &retval)
 		sqconfig = new SQLiteConfiguration(CONFDIR);
 		config   = sqconfig;
 	} else {
-		config = new YamlConfiguration(CONFDIR);
+		YamlConfiguration *yconfig = new YamlConfiguration(CONFDIR);
+		yconfig->set_snapshot_file("config-snapshot.bin");
+		config = yconfig;
 	}
 
 	config->load(options.config_file());
@@ -293,6 +299,11 @@ init(const InitOptions &options, int &retval)
 		}
 	}
 
+	if (config->get_bool_or_default("/fawkes/mainapp/async_logging", false)) {
+		logger->set_async(true,
+		                  config->get_uint_or_default("/fawkes/mainapp/async_logging_queue", 1024));
+	}
+
 	if (config->exists("/fawkes/mainapp/log_stderr_as_warn")) {
 		try {
 			bool log_stderr_as_warn = config->get_bool("/fawkes/mainapp/log_stderr_as_warn");
@@ -309,13 +320,26 @@ init(const InitOptions &options, int &retval)
 		} // ignored
 	}
 
+	// Must be set before any barriers are created
+	try {
+		SpinWait::set_max_spin_time(config->get_uint("/fawkes/mainapp/spin_wait_usec"));
+	} catch (Exception &e) {
+	} // ignore, spinning stays disabled
+
+	try {
+		LockProfiler::set_enabled(config->get_bool("/fawkes/mainapp/lock_profiling"));
+	} catch (Exception &e) {
+	} // ignore, profiling stays disabled
+
 	// *** Determine network parameters
 	bool         enable_ipv4 = true;
 	bool         enable_ipv6 = true;
 	std::string  listen_ipv4;
 	std::string  listen_ipv6;
-	unsigned int net_tcp_port     = 1910;
-	std::string  net_service_name = "Fawkes on %h";
+	unsigned int net_tcp_port           = 1910;
+	std::string  net_service_name       = "Fawkes on %h";
+	unsigned int net_event_loop_workers = 0;
+	unsigned int net_compression_thresh = 1024;
 	if (options.has_net_tcp_port()) {
 		net_tcp_port = options.net_tcp_port();
 	} else {
@@ -356,6 +380,14 @@ init(const InitOptions &options, int &retval)
 		listen_ipv6 = config->get_string("/network/ipv6/listen");
 	} catch (Exception &e) {
 	} // ignore, we stick with the default
+	try {
+		net_event_loop_workers = config->get_uint("/network/fawkes/event_loop_workers");
+	} catch (Exception &e) {
+	} // ignore, we stick with the default
+	try {
+		net_compression_thresh = config->get_uint("/network/fawkes/compression_threshold");
+	} catch (Exception &e) {
+	} // ignore, we stick with the default
 
 	if (!enable_ipv4) {
 		logger->log_warn("FawkesMainThread", "Disabling IPv4 support");
@@ -399,12 +431,62 @@ init(const InitOptions &options, int &retval)
 		SharedMemoryRegistry::cleanup();
 	}
 
+	// Placement of shared memory segments, e.g. image buffers
+	try {
+		SharedMemory::set_huge_page_threshold(
+		  config->get_uint("/fawkes/mainapp/shm_huge_page_threshold"));
+	} catch (Exception &e) {
+		// ignore, use default threshold
+	}
+	try {
+		SharedMemory::set_default_numa_node(config->get_int("/fawkes/mainapp/shm_numa_node"));
+	} catch (Exception &e) {
+		// ignore, do not bind to a node
+	}
+	try {
+		SharedMemory::set_lock_created(config->get_bool("/fawkes/mainapp/shm_lock"));
+	} catch (Exception &e) {
+		// ignore, segments are swapable by default
+	}
+
 	LocalBlackBoard *lbb = NULL;
 	if (bb_magic_token == "") {
 		lbb = new LocalBlackBoard(bb_size);
 	} else {
 		lbb = new LocalBlackBoard(bb_size, bb_magic_token.c_str());
 	}
+	try {
+		std::string bb_allocator = config->get_string("/fawkes/mainapp/blackboard_allocator");
+		if (bb_allocator == "size-class") {
+			lbb->set_size_class_allocation(true);
+		} else if (bb_allocator != "best-fit") {
+			logger->log_warn("FawkesMainApp",
+			                 "Unknown BlackBoard allocator '%s', using best-fit",
+			                 bb_allocator.c_str());
+		}
+	} catch (Exception &e) {
+		// ignore, use default allocator
+	}
+	try {
+		Interface::set_stats_enabled(config->get_bool("/fawkes/mainapp/blackboard_stats"));
+	} catch (Exception &e) {
+		// ignore, statistics are disabled by default
+	}
+	try {
+		if (config->get_bool("/fawkes/mainapp/blackboard_huge_pages") && !lbb->advise_huge_pages()) {
+			logger->log_warn("FawkesMainApp", "Failed to enable huge pages for BlackBoard");
+		}
+	} catch (Exception &e) {
+		// ignore, use normal pages
+	}
+	try {
+		int bb_numa_node = config->get_int("/fawkes/mainapp/blackboard_numa_node");
+		if (!lbb->bind_numa_node(bb_numa_node)) {
+			logger->log_warn("FawkesMainApp", "Failed to bind BlackBoard to NUMA node %i", bb_numa_node);
+		}
+	} catch (Exception &e) {
+		// ignore, do not bind to a node
+	}
 	blackboard = lbb;
 #endif
 
@@ -416,6 +498,25 @@ init(const InitOptions &options, int &retval)
 	aspect_manager = new AspectManager();
 	thread_manager = new ThreadManager(aspect_manager, aspect_manager);
 
+	bool         enable_thread_pool  = false;
+	unsigned int thread_pool_workers = 0;
+	try {
+		enable_thread_pool = config->get_bool("/fawkes/mainapp/blocked_timing_pool/enable");
+	} catch (Exception &e) {
+	} // ignore, we stick with the default
+	try {
+		thread_pool_workers = config->get_uint("/fawkes/mainapp/blocked_timing_pool/workers");
+	} catch (Exception &e) {
+	} // ignore, we stick with the default
+	if (enable_thread_pool) {
+		thread_manager->enable_thread_pool(thread_pool_workers);
+	}
+
+	thread_policy = new ThreadPolicy(config, logger);
+	if (!thread_policy->empty()) {
+		thread_manager->set_thread_policy(thread_policy);
+	}
+
 	syncpoint_manager = new SyncPointManager(logger);
 
 	plugin_manager = new PluginManager(thread_manager,
@@ -423,6 +524,8 @@ init(const InitOptions &options, int &retval)
 	                                   "/fawkes/meta_plugins/",
 	                                   options.plugin_module_flags(),
 	                                   options.init_plugin_cache());
+	plugin_manager->set_parallel_loading(
+	  config->get_bool_or_default("/fawkes/mainapp/parallel_plugin_loading", false));
 #ifdef HAVE_NETWORK_MANAGER
 	network_manager = new FawkesNetworkManager(thread_manager,
 	                                           enable_ipv4,
@@ -430,7 +533,9 @@ init(const InitOptions &options, int &retval)
 	                                           listen_ipv4,
 	                                           listen_ipv6,
 	                                           net_tcp_port,
-	                                           net_service_name.c_str());
+	                                           net_service_name.c_str(),
+	                                           net_event_loop_workers,
+	                                           net_compression_thresh);
 #	ifdef HAVE_CONFIG_NETWORK_HANDLER
 	nethandler_config = new ConfigNetworkHandler(config, network_manager->hub());
 #	endif
@@ -459,6 +564,7 @@ init(const InitOptions &options, int &retval)
 	                                           plugin_manager,
 	                                           options.load_plugin_list(),
 	                                           options.default_plugin());
+	thread_policy->apply(main_thread);
 
 	aspect_manager->register_default_inifins(blackboard,
 	                                         thread_manager->aspect_collector(),
@@ -535,6 +641,7 @@ cleanup()
 	delete network_manager;
 #endif
 	delete thread_manager;
+	delete thread_policy;
 	delete aspect_manager;
 	delete shm_registry;
 #ifdef HAVE_LOGGING_FD_REDIRECT
@@ -551,6 +658,7 @@ cleanup()
 	network_manager   = NULL;
 	config            = NULL;
 	thread_manager    = NULL;
+	thread_policy     = NULL;
 	aspect_manager    = NULL;
 	shm_registry      = NULL;
 	blackboard        = NULL;
@@ -22,7 +22,9 @@
  */
 
 #include <aspect/blocked_timing.h>
+#include <baseapp/blocked_timing_pool.h>
 #include <baseapp/thread_manager.h>
+#include <baseapp/thread_policy.h>
 #include <core/exceptions/software.h>
 #include <core/exceptions/system.h>
 #include <core/threading/mutex_locker.h>
@@ -47,6 +49,9 @@ namespace fawkes {
  * (RTTI) supplied by C++ can be used to initialize threads if appropriate
  * (if the thread has certain aspects that need special treatment).
  *
+ * Optionally, the loops of threads with the BlockedTimingAspect can be
+ * executed on a work-stealing thread pool, see enable_thread_pool().
+ *
  * @author Tim Niemueller
  */
 
@@ -139,6 +144,8 @@ ThreadManager::ThreadManager()
 	waitcond_timedthreads_       = new WaitCondition();
 	interrupt_timed_thread_wait_ = false;
 	aspect_collector_            = new ThreadManagerAspectCollector(this);
+	pool_                        = NULL;
+	policy_                      = NULL;
 }
 
 /** Constructor.
@@ -155,6 +162,8 @@ ThreadManager::ThreadManager(ThreadInitializer *initializer, ThreadFinalizer *fi
 	waitcond_timedthreads_       = new WaitCondition();
 	interrupt_timed_thread_wait_ = false;
 	aspect_collector_            = new ThreadManagerAspectCollector(this);
+	pool_                        = NULL;
+	policy_                      = NULL;
 	set_inifin(initializer, finalizer);
 }
 
@@ -163,6 +172,13 @@ ThreadManager::~ThreadManager()
 {
 	// stop all threads, we call finalize, and we run through it as long as there are
 	// still running threads, after that, we force the thread's death.
+	// The pool is stopped first so that no pooled loop is running anymore.
+	delete pool_;
+	pool_ = NULL;
+	try {
+		pooled_threads_.force_stop(finalizer_);
+	} catch (Exception &e) {
+	} // ignore
 	for (tit_ = threads_.begin(); tit_ != threads_.end(); ++tit_) {
 		try {
 			tit_->second.force_stop(finalizer_);
@@ -191,6 +207,41 @@ ThreadManager::set_inifin(ThreadInitializer *initializer, ThreadFinalizer *final
 	finalizer_   = finalizer;
 }
 
+/** Set thread policy.
+ * The CPU affinity and scheduling policy is applied to threads added
+ * afterwards when they are started.
+ * @param policy thread policy, the thread manager does not take ownership,
+ * NULL to stop applying a policy
+ */
+void
+ThreadManager::set_thread_policy(ThreadPolicy *policy)
+{
+	MutexLocker lock(threads_.mutex());
+	policy_ = policy;
+}
+
+/** Execute blocked timing threads on a thread pool.
+ * Once enabled, the loops of blocked timing threads added afterwards are
+ * executed by a fixed number of pool workers, unless a thread requested a
+ * dedicated thread. The loops of the threads of one hook are dispatched
+ * by execute_pooled(), wakeup() or wakeup_and_wait(). This must be called
+ * before any blocked timing thread is added.
+ * @param num_workers number of workers, 0 to use one per processor core
+ * @exception Exception thrown if blocked timing threads have already
+ * been added
+ */
+void
+ThreadManager::enable_thread_pool(unsigned int num_workers)
+{
+	MutexLocker lock(threads_.mutex());
+	if (pool_)
+		return;
+	if (!threads_.empty()) {
+		throw Exception("Cannot enable thread pool, blocked timing threads already exist");
+	}
+	pool_ = new BlockedTimingThreadPool(num_workers);
+}
+
 /** Remove the given thread from internal structures.
  * Thread is removed from the internal structures. If the thread has the
  * BlockedTimingAspect then the hook is added to the changed list.
@@ -203,7 +254,11 @@ ThreadManager::internal_remove_thread(Thread *t)
 {
 	BlockedTimingAspect *timed_thread;
 
-	if ((timed_thread = dynamic_cast<BlockedTimingAspect *>(t)) != NULL) {
+	if ((timed_thread = dynamic_cast<BlockedTimingAspect *>(t)) != NULL
+	    && timed_thread->blocked_timing_pooled()) {
+		remove_pooled(t);
+		pooled_threads_.remove_locked(t);
+	} else if (timed_thread != NULL) {
 		// find thread and remove
 		BlockedTimingAspect::WakeupHook hook = timed_thread->blockedTimingAspectHook();
 		if (threads_.find(hook) != threads_.end()) {
@@ -230,6 +285,13 @@ ThreadManager::internal_add_thread(Thread *t)
 	if ((timed_thread = dynamic_cast<BlockedTimingAspect *>(t)) != NULL) {
 		BlockedTimingAspect::WakeupHook hook = timed_thread->blockedTimingAspectHook();
 
+		if (pool_ && timed_thread->blocked_timing_pooled()) {
+			pool_->add_thread(t, hook);
+			pooled_threads_.push_back_locked(t);
+			waitcond_timedthreads_->wake_all();
+			return;
+		}
+
 		if (threads_.find(hook) == threads_.end()) {
 			threads_[hook].set_name("ThreadManagerList Hook %i", hook);
 			threads_[hook].set_maintain_barrier(true);
@@ -277,7 +339,17 @@ ThreadManager::add_maybelocked(ThreadList &tl, bool lock)
 	}
 
 	tl.seal();
+	if (policy_) {
+		for (ThreadList::iterator i = tl.begin(); i != tl.end(); ++i) {
+			policy_->apply(*i);
+		}
+	}
 	tl.start();
+	if (policy_) {
+		for (ThreadList::iterator i = tl.begin(); i != tl.end(); ++i) {
+			policy_->check(*i);
+		}
+	}
 
 	// All thread initialized, now add threads to internal structure
 	MutexLocker locker(threads_.mutex(), lock);
@@ -348,7 +420,11 @@ ThreadManager::add_maybelocked(Thread *thread, bool lock)
 		throw cite;
 	}
 
+	if (policy_)
+		policy_->apply(thread);
 	thread->start();
+	if (policy_)
+		policy_->check(thread);
 	MutexLocker locker(threads_.mutex(), lock);
 	internal_add_thread(thread);
 }
@@ -400,6 +476,9 @@ ThreadManager::remove_maybelocked(ThreadList &tl, bool lock)
 		throw CannotFinalizeThreadException(e);
 	}
 
+	for (ThreadList::iterator i = tl.begin(); i != tl.end(); ++i) {
+		remove_pooled(*i);
+	}
 	tl.stop();
 	try {
 		tl.finalize(finalizer_);
@@ -449,6 +528,7 @@ ThreadManager::remove_maybelocked(Thread *thread, bool lock)
 		throw;
 	}
 
+	remove_pooled(thread);
 	thread->cancel();
 	thread->join();
 	thread->finalize();
@@ -484,6 +564,9 @@ ThreadManager::force_remove(ThreadList &tl)
 	threads_.mutex()->stopby();
 	bool      caught_exception = false;
 	Exception exc("Forced removal of thread list %s failed", tl.name());
+	for (ThreadList::iterator i = tl.begin(); i != tl.end(); ++i) {
+		remove_pooled(*i);
+	}
 	try {
 		tl.force_stop(finalizer_);
 	} catch (Exception &e) {
@@ -528,6 +611,7 @@ ThreadManager::force_remove(fawkes::Thread *thread)
 		// ignore
 	}
 
+	remove_pooled(thread);
 	thread->cancel();
 	thread->join();
 	thread->finalize();
@@ -537,11 +621,27 @@ ThreadManager::force_remove(fawkes::Thread *thread)
 	internal_remove_thread(thread);
 }
 
+/** Stop executing thread on the pool.
+ * If the thread is executed on the pool this waits for a currently
+ * running loop to finish and afterwards it is no longer dispatched.
+ * @param t thread to remove from the pool
+ */
+void
+ThreadManager::remove_pooled(Thread *t)
+{
+	if (pool_)
+		pool_->remove_thread(t);
+}
+
 void
 ThreadManager::wakeup_and_wait(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec)
 {
 	MutexLocker lock(threads_.mutex());
 
+	const unsigned int pool_timeout_usec = timeout_usec;
+	if (pool_)
+		pool_->execute(hook);
+
 	unsigned int timeout_sec = 0;
 	if (timeout_usec >= 1000000) {
 		timeout_sec = timeout_usec / 1000000;
@@ -552,6 +652,15 @@ ThreadManager::wakeup_and_wait(BlockedTimingAspect::WakeupHook hook, unsigned in
 	if (threads_.find(hook) != threads_.end()) {
 		threads_[hook].wakeup_and_wait(timeout_sec, timeout_usec * 1000);
 	}
+
+	if (pool_ && !pool_->wait(hook, pool_timeout_usec)) {
+		Exception e("Timeout waiting for pooled threads of hook %i", hook);
+		std::list<std::string> busy = pool_->busy_threads(hook);
+		for (std::list<std::string>::iterator b = busy.begin(); b != busy.end(); ++b) {
+			e.append("Thread '%s' did not finish in time", b->c_str());
+		}
+		throw e;
+	}
 }
 
 void
@@ -559,6 +668,10 @@ ThreadManager::wakeup(BlockedTimingAspect::WakeupHook hook, Barrier *barrier)
 {
 	MutexLocker lock(threads_.mutex());
 
+	// pooled threads do not take part in the barrier
+	if (pool_)
+		pool_->execute(hook);
+
 	if (threads_.find(hook) != threads_.end()) {
 		if (barrier) {
 			threads_[hook].wakeup(barrier);
@@ -581,10 +694,29 @@ ThreadManager::try_recover(std::list<std::string> &recovered_threads)
 	threads_.unlock();
 }
 
+bool
+ThreadManager::pooled_execution()
+{
+	return (pool_ != NULL);
+}
+
+/** Dispatch pooled threads of a hook.
+ * Queues the loops of the threads of the given hook which are executed on
+ * the thread pool and returns immediately. Threads which do not run on the
+ * pool are not affected. Does nothing if the thread pool is not enabled.
+ * @param hook hook to dispatch
+ */
+void
+ThreadManager::execute_pooled(BlockedTimingAspect::WakeupHook hook)
+{
+	if (pool_)
+		pool_->execute(hook);
+}
+
 bool
 ThreadManager::timed_threads_exist()
 {
-	return (threads_.size() > 0);
+	return (threads_.size() > 0) || (pool_ && pool_->has_threads());
 }
 
 void
@@ -38,6 +38,8 @@ class Mutex;
 class WaitCondition;
 class ThreadInitializer;
 class ThreadFinalizer;
+class BlockedTimingThreadPool;
+class ThreadPolicy;
 
 class ThreadManager : public ThreadCollector, public BlockedTimingExecutor
 {
@@ -47,6 +49,8 @@ public:
 	virtual ~ThreadManager();
 
 	void set_inifin(ThreadInitializer *initializer, ThreadFinalizer *finalizer);
+	void enable_thread_pool(unsigned int num_workers = 0);
+	void set_thread_policy(ThreadPolicy *policy);
 
 	virtual void
 	add(ThreadList &tl)
@@ -78,6 +82,9 @@ public:
 	virtual void wakeup_and_wait(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec = 0);
 	virtual void wakeup(BlockedTimingAspect::WakeupHook hook, Barrier *barrier = 0);
 	virtual void try_recover(std::list<std::string> &recovered_threads);
+	virtual bool pooled_execution();
+
+	void execute_pooled(BlockedTimingAspect::WakeupHook hook);
 
 	virtual bool timed_threads_exist();
 	virtual void wait_for_timed_threads();
@@ -92,6 +99,7 @@ private:
 	void add_maybelocked(Thread *t, bool lock);
 	void remove_maybelocked(ThreadList &tl, bool lock);
 	void remove_maybelocked(Thread *t, bool lock);
+	void remove_pooled(Thread *t);
 
 	class ThreadManagerAspectCollector : public ThreadCollector
 	{
@@ -119,10 +127,14 @@ private:
 	LockMap<BlockedTimingAspect::WakeupHook, ThreadList>::iterator tit_;
 
 	ThreadList     untimed_threads_;
+	ThreadList     pooled_threads_;
 	WaitCondition *waitcond_timedthreads_;
 
 	ThreadManagerAspectCollector *aspect_collector_;
 	bool                          interrupt_timed_thread_wait_;
+
+	BlockedTimingThreadPool *pool_;
+	ThreadPolicy *           policy_;
 };
 
 } // end namespace fawkes
@@ -0,0 +1,220 @@
+
+/***************************************************************************
+ *  thread_policy.cpp - Configurable CPU affinity and scheduling of threads
+ *
+ *  Created: Wed Oct 14 19:21:08 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <aspect/blocked_timing.h>
+#include <baseapp/thread_policy.h>
+#include <config/config.h>
+#include <core/exceptions/software.h>
+#include <logging/logger.h>
+
+#include <cstring>
+#include <fnmatch.h>
+#include <memory>
+#include <set>
+
+namespace fawkes {
+
+/** @class ThreadPolicy <baseapp/thread_policy.h>
+ * Configurable CPU affinity and scheduling policy of threads.
+ * Each entry below the configuration prefix describes a policy for the
+ * threads whose name matches the glob pattern given as "match", which
+ * defaults to the name of the entry. An entry may contain:
+ * - cpus: list of CPU cores the threads may run on
+ * - sched_policy: one of other, batch, best-effort (same as batch),
+ *   idle, fifo, or rr
+ * - priority: static priority for fifo and rr (1 to 99), nice value
+ *   for other and batch (-20 to 19)
+ * - loop_divisor: blocked timing threads only run every n-th main loop
+ *   iteration, see BlockedTimingAspect::set_blocked_timing_loop_divisor()
+ *
+ * The first matching entry in the order of the entry names applies. The
+ * policy is applied when a thread starts, before its once() method runs.
+ * Real-time policies require appropriate privileges, if applying the
+ * policy fails a warning is logged and the thread runs with the inherited
+ * settings.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param config configuration to read policies from
+ * @param logger logger for warnings
+ * @param prefix configuration prefix of policy entries, must end in a slash
+ */
+ThreadPolicy::ThreadPolicy(Configuration *config, Logger *logger, const char *prefix)
+: logger_(logger)
+{
+	std::string           pfx = prefix;
+	std::set<std::string> names;
+
+	std::unique_ptr<Configuration::ValueIterator> i(config->search(prefix));
+	while (i->next()) {
+		std::string name = std::string(i->path()).substr(pfx.length());
+		name             = name.substr(0, name.find("/"));
+		names.insert(name);
+	}
+
+	for (std::set<std::string>::iterator n = names.begin(); n != names.end(); ++n) {
+		std::string entry_prefix = pfx + *n + "/";
+
+		Rule rule;
+		rule.name         = *n;
+		rule.match        = *n;
+		rule.sched_policy = Thread::SCHED_POLICY_DEFAULT;
+		rule.priority     = 0;
+		rule.loop_divisor = 0;
+		try {
+			rule.match = config->get_string(entry_prefix + "match");
+		} catch (Exception &e) {
+		} // ignore, use name
+		try {
+			rule.cpus = config->get_uints(entry_prefix + "cpus");
+		} catch (Exception &e) {
+		} // ignore, no affinity
+		try {
+			rule.loop_divisor = config->get_uint(entry_prefix + "loop_divisor");
+		} catch (Exception &e) {
+		} // ignore, run every loop
+		try {
+			std::string policy = config->get_string(entry_prefix + "sched_policy");
+			rule.sched_policy  = parse_scheduling_policy(policy);
+			try {
+				rule.priority = config->get_int(entry_prefix + "priority");
+			} catch (Exception &e) {
+			} // ignore, default priority
+		} catch (IllegalArgumentException &e) {
+			logger_->log_warn("ThreadPolicy",
+			                  "Ignoring policy of %s: %s",
+			                  n->c_str(),
+			                  e.what_no_backtrace());
+			continue;
+		} catch (Exception &e) {
+		} // ignore, keep inherited policy
+
+		if (rule.cpus.empty() && rule.sched_policy == Thread::SCHED_POLICY_DEFAULT
+		    && rule.loop_divisor == 0)
+			continue;
+
+		rules_.push_back(rule);
+	}
+}
+
+/** Destructor. */
+ThreadPolicy::~ThreadPolicy()
+{
+}
+
+/** Check if any policy has been configured.
+ * @return true if there is no policy entry
+ */
+bool
+ThreadPolicy::empty() const
+{
+	return rules_.empty();
+}
+
+/** Parse scheduling policy.
+ * @param policy policy name, one of other, batch, best-effort, idle, fifo,
+ * rr, or default
+ * @return scheduling policy
+ * @exception IllegalArgumentException thrown if the policy is unknown
+ */
+Thread::SchedulingPolicy
+ThreadPolicy::parse_scheduling_policy(const std::string &policy)
+{
+	if (policy == "default") {
+		return Thread::SCHED_POLICY_DEFAULT;
+	} else if (policy == "other") {
+		return Thread::SCHED_POLICY_OTHER;
+	} else if (policy == "batch" || policy == "best-effort") {
+		return Thread::SCHED_POLICY_BATCH;
+	} else if (policy == "idle") {
+		return Thread::SCHED_POLICY_IDLE;
+	} else if (policy == "fifo") {
+		return Thread::SCHED_POLICY_FIFO;
+	} else if (policy == "rr") {
+		return Thread::SCHED_POLICY_RR;
+	} else {
+		throw IllegalArgumentException("Unknown scheduling policy '%s'", policy.c_str());
+	}
+}
+
+/** Find rule for thread.
+ * @param thread_name name of the thread
+ * @return first matching rule, NULL if none matches
+ */
+const ThreadPolicy::Rule *
+ThreadPolicy::find_rule(const char *thread_name) const
+{
+	for (std::vector<Rule>::const_iterator r = rules_.begin(); r != rules_.end(); ++r) {
+		if (fnmatch(r->match.c_str(), thread_name, 0) == 0) {
+			return &*r;
+		}
+	}
+	return NULL;
+}
+
+/** Apply policy to thread.
+ * Call this before the thread is started.
+ * @param thread thread to apply the policy to
+ */
+void
+ThreadPolicy::apply(Thread *thread)
+{
+	const Rule *rule = find_rule(thread->name());
+	if (!rule)
+		return;
+
+	if (!rule->cpus.empty()) {
+		thread->set_cpu_affinity(rule->cpus);
+	}
+	if (rule->sched_policy != Thread::SCHED_POLICY_DEFAULT) {
+		thread->set_scheduling(rule->sched_policy, rule->priority);
+	}
+	if (rule->loop_divisor > 0) {
+		BlockedTimingAspect *bta = dynamic_cast<BlockedTimingAspect *>(thread);
+		if (bta) {
+			bta->set_blocked_timing_loop_divisor(rule->loop_divisor);
+		}
+	}
+}
+
+/** Check if the policy could be applied.
+ * Call this after the thread has been started, logs a warning if the
+ * policy could not be applied.
+ * @param thread thread to check
+ */
+void
+ThreadPolicy::check(Thread *thread)
+{
+	int err = thread->scheduling_error();
+	if (err != 0) {
+		const Rule *rule = find_rule(thread->name());
+		logger_->log_warn("ThreadPolicy",
+		                  "Failed to apply policy %s to thread %s: %s",
+		                  rule ? rule->name.c_str() : "?",
+		                  thread->name(),
+		                  strerror(err));
+	}
+}
+
+} // end namespace fawkes
@@ -0,0 +1,69 @@
+
+/***************************************************************************
+ *  thread_policy.h - Configurable CPU affinity and scheduling of threads
+ *
+ *  Created: Wed Oct 14 19:21:08 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_BASEAPP_THREAD_POLICY_H_
+#define _LIBS_BASEAPP_THREAD_POLICY_H_
+
+#include <core/threading/thread.h>
+
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Configuration;
+class Logger;
+
+class ThreadPolicy
+{
+public:
+	ThreadPolicy(Configuration *config, Logger *logger, const char *prefix = "/fawkes/threads/");
+	~ThreadPolicy();
+
+	bool empty() const;
+	void apply(Thread *thread);
+	void check(Thread *thread);
+
+	static Thread::SchedulingPolicy parse_scheduling_policy(const std::string &policy);
+
+private:
+	/** Policy entry for threads matching a pattern. */
+	typedef struct
+	{
+		std::string               name;         /**< name of config entry */
+		std::string               match;        /**< glob pattern for thread names */
+		std::vector<unsigned int> cpus;         /**< CPU cores, empty for any */
+		Thread::SchedulingPolicy  sched_policy; /**< scheduling policy */
+		int                       priority;     /**< priority or nice value */
+		unsigned int              loop_divisor; /**< blocked timing loop divisor, 0 if unset */
+	} Rule;
+
+	const Rule *find_rule(const char *thread_name) const;
+
+private:
+	Logger *          logger_;
+	std::vector<Rule> rules_;
+};
+
+} // end namespace fawkes
+
+#endif
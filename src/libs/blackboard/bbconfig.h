@@ -24,7 +24,7 @@
 #ifndef _BLACKBOARD_BBCONFIG_H_
 #define _BLACKBOARD_BBCONFIG_H_
 
-#define BLACKBOARD_VERSION 1
+#define BLACKBOARD_VERSION 4
 
 // Can be used as useful defaults
 #define BLACKBOARD_MEMSIZE 2 * 1024 * 1024
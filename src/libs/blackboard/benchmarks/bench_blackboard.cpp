@@ -0,0 +1,180 @@
+
+/***************************************************************************
+ *  bench_blackboard.cpp - BlackBoard microbenchmarks
+ *
+ *  Created: Thu Oct 15 07:45:06 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <benchmark/benchmark.h>
+#include <blackboard/bbconfig.h>
+#include <blackboard/interface_listener.h>
+#include <blackboard/internal/memory_manager.h>
+#include <blackboard/local.h>
+#include <core/threading/thread.h>
+#include <interfaces/TestInterface.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace fawkes;
+
+class DataListener : public BlackBoardInterfaceListener
+{
+public:
+	DataListener(const std::string &name, Interface *interface)
+	: BlackBoardInterfaceListener("%s", name.c_str()), num_events(0)
+	{
+		bbil_add_data_interface(interface);
+	}
+
+	virtual void
+	bb_interface_data_refreshed(Interface *interface) noexcept
+	{
+		++num_events;
+	}
+
+	unsigned int num_events;
+};
+
+class BlackBoardBenchmark : public benchmark::Fixture
+{
+public:
+	void
+	SetUp(const benchmark::State &state)
+	{
+		bb     = new LocalBlackBoard(BLACKBOARD_MEMSIZE);
+		writer = bb->open_for_writing<TestInterface>("Benchmark");
+		reader = bb->open_for_reading<TestInterface>("Benchmark");
+	}
+
+	void
+	TearDown(const benchmark::State &state)
+	{
+		bb->close(reader);
+		bb->close(writer);
+		delete bb;
+	}
+
+protected:
+	BlackBoard *   bb;
+	TestInterface *writer;
+	TestInterface *reader;
+};
+
+BENCHMARK_DEFINE_F(BlackBoardBenchmark, InterfaceWrite)(benchmark::State &state)
+{
+	int i = 0;
+	for (auto _ : state) {
+		writer->set_test_int(++i);
+		writer->write();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(BlackBoardBenchmark, InterfaceWrite);
+
+BENCHMARK_DEFINE_F(BlackBoardBenchmark, InterfaceRead)(benchmark::State &state)
+{
+	writer->set_test_int(42);
+	writer->write();
+	for (auto _ : state) {
+		reader->read();
+		benchmark::DoNotOptimize(reader->test_int());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(BlackBoardBenchmark, InterfaceRead);
+
+// enqueue and pop, otherwise the queue grows with the number of iterations
+BENCHMARK_DEFINE_F(BlackBoardBenchmark, MsgqEnqueue)(benchmark::State &state)
+{
+	int i = 0;
+	for (auto _ : state) {
+		reader->msgq_enqueue(new TestInterface::SetTestIntMessage(++i));
+		writer->msgq_pop();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(BlackBoardBenchmark, MsgqEnqueue);
+
+// write with the given number of listeners for data changes
+BENCHMARK_DEFINE_F(BlackBoardBenchmark, NotifierDispatch)(benchmark::State &state)
+{
+	std::vector<std::unique_ptr<DataListener>> listeners;
+	for (int l = 0; l < state.range(0); ++l) {
+		listeners.emplace_back(new DataListener("Listener " + std::to_string(l), reader));
+		bb->register_listener(listeners.back().get(), BlackBoard::BBIL_FLAG_DATA);
+	}
+
+	int i = 0;
+	for (auto _ : state) {
+		writer->set_test_int(++i);
+		writer->write();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+
+	for (auto &l : listeners) {
+		bb->unregister_listener(l.get());
+	}
+}
+BENCHMARK_REGISTER_F(BlackBoardBenchmark, NotifierDispatch)->Arg(1)->Arg(4)->Arg(16);
+
+static void
+BM_MemoryManagerAllocFree(benchmark::State &state)
+{
+	BlackBoardMemoryManager mm(BLACKBOARD_MEMSIZE);
+	mm.set_allocation_strategy((BlackBoardMemoryManager::AllocationStrategy)state.range(1));
+	// keep some chunks allocated so that the free list is not trivial
+	std::vector<void *> fill;
+	for (unsigned int i = 0; i < 64; ++i) {
+		fill.push_back(mm.alloc(1024));
+	}
+	for (unsigned int i = 0; i < fill.size(); i += 2) {
+		mm.free(fill[i]);
+	}
+
+	for (auto _ : state) {
+		void *m = mm.alloc(state.range(0));
+		benchmark::DoNotOptimize(m);
+		mm.free(m);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryManagerAllocFree)
+  ->ArgNames({"bytes", "strategy"})
+  ->ArgsProduct({{64, 1024, 16384},
+                 {BlackBoardMemoryManager::ALLOC_BEST_FIT,
+                  BlackBoardMemoryManager::ALLOC_SIZE_CLASSES}});
+
+int
+main(int argc, char **argv)
+{
+	Thread::init_main();
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	Thread::destroy_main();
+	return 0;
+}
+
+/// @endcond
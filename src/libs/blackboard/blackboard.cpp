@@ -22,6 +22,7 @@
 
 #include <blackboard/blackboard.h>
 #include <blackboard/internal/notifier.h>
+#include <interface/interface_group.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -246,6 +247,68 @@ BlackBoard::unregister_observer(BlackBoardInterfaceObserver *observer)
 	notifier_->unregister_observer(observer);
 }
 
+/** Get usage statistics of registered listeners.
+ * Statistics are only gathered while enabled, see
+ * Interface::set_stats_enabled().
+ * @return statistics of all listeners registered for data or message events
+ */
+std::list<BlackBoard::ListenerStats>
+BlackBoard::listener_stats()
+{
+	if (!notifier_)
+		throw NullPointerException("BlackBoard initialized without notifier");
+	return notifier_->listener_stats();
+}
+
+/** Open a number of interfaces for reading at once.
+ * This opens the given interfaces like open_for_reading(). The default
+ * implementation opens them one by one, a local BlackBoard opens all of
+ * them in a single critical section. Either all interfaces are opened or,
+ * if one of them cannot be opened, none.
+ * @param interfaces list of pairs of interface type and identifier
+ * @param owner name of entity which opened this interface. If using the BlackBoardAspect
+ * to access the blackboard leave this untouched unless you have a good reason.
+ * @return list of new fully initialized interface instances, in the order of
+ * the given list
+ * @exception OutOfMemoryException thrown if there is not enough free space for
+ * the requested interfaces.
+ */
+std::list<Interface *>
+BlackBoard::open_all_for_reading(const std::list<std::pair<std::string, std::string>> &interfaces,
+                                 const char *                                          owner)
+{
+	std::list<Interface *> rv;
+	try {
+		std::list<std::pair<std::string, std::string>>::const_iterator i;
+		for (i = interfaces.begin(); i != interfaces.end(); ++i) {
+			rv.push_back(open_for_reading(i->first.c_str(), i->second.c_str(), owner));
+		}
+	} catch (Exception &e) {
+		for (std::list<Interface *>::iterator j = rv.begin(); j != rv.end(); ++j) {
+			close(*j);
+		}
+		throw;
+	}
+	return rv;
+}
+
+/** Read multiple interfaces at once.
+ * This reads all given interfaces acquiring each read lock only once
+ * and copying only interfaces which have been written since they have
+ * been read last. Use an InterfaceGroup directly to avoid re-sorting
+ * the locks on every call if the set of interfaces does not change.
+ * @param interfaces interfaces to read
+ * @return number of interfaces whose data has actually been copied
+ * @exception InterfaceInvalidException thrown if any of the interfaces
+ * has been marked invalid
+ */
+unsigned int
+BlackBoard::read_batch(const std::vector<Interface *> &interfaces)
+{
+	InterfaceGroup group(interfaces);
+	return group.read();
+}
+
 /** Produce interface name from C++ signature.
  * This extracts the interface name for a mangled signature. It has
  * has been coded with GCC (4) in mind and assumes interfaces to be
@@ -29,6 +29,8 @@
 #include <list>
 #include <string>
 #include <typeinfo>
+#include <utility>
+#include <vector>
 
 namespace fawkes {
 
@@ -67,6 +69,10 @@ public:
 	                                                         const char *id_pattern = "*",
 	                                                         const char *owner      = NULL) = 0;
 
+	virtual std::list<Interface *>
+	open_all_for_reading(const std::list<std::pair<std::string, std::string>> &interfaces,
+	                     const char *                                          owner = NULL);
+
 	template <class InterfaceType>
 	std::list<InterfaceType *> open_multiple_for_reading(const char *id_pattern = "*",
 	                                                     const char *owner      = NULL);
@@ -101,6 +107,18 @@ public:
 	virtual void register_observer(BlackBoardInterfaceObserver *observer);
 	virtual void unregister_observer(BlackBoardInterfaceObserver *observer);
 
+	/** Usage statistics of a listener. */
+	typedef struct
+	{
+		std::string name;          ///< name of the listener
+		uint64_t    num_events;    ///< number of data and message events delivered
+		uint64_t    dispatch_nsec; ///< time spent in callbacks in nanoseconds
+	} ListenerStats;
+
+	virtual std::list<ListenerStats> listener_stats();
+
+	unsigned int read_batch(const std::vector<Interface *> &interfaces);
+
 	std::string demangle_fawkes_interface_name(const char *type);
 	std::string format_identifier(const char *identifier_format, va_list arg);
 
@@ -22,6 +22,7 @@
  */
 
 #include <blackboard/interface_listener.h>
+#include <blackboard/internal/listener_dispatcher.h>
 #include <core/exceptions/system.h>
 #include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
@@ -94,6 +95,10 @@ BlackBoardInterfaceListener::BlackBoardInterfaceListener(const char *name_format
 
 	bbil_queue_mutex_ = new Mutex();
 	bbil_maps_mutex_  = new Mutex();
+	bbil_async_queue_ = NULL;
+
+	bbil_num_events_    = 0;
+	bbil_dispatch_nsec_ = 0;
 }
 
 /** Destructor. */
@@ -103,6 +108,7 @@ BlackBoardInterfaceListener::~BlackBoardInterfaceListener()
 
 	delete bbil_queue_mutex_;
 	delete bbil_maps_mutex_;
+	delete bbil_async_queue_;
 }
 
 /** Get BBIL name.
@@ -114,6 +120,100 @@ BlackBoardInterfaceListener::bbil_name() const
 	return name_;
 }
 
+/** Enable or disable asynchronous delivery.
+ * By default, listener callbacks are called synchronously from within
+ * the thread causing the event, e.g. from Interface::write() of the
+ * writer. With asynchronous delivery enabled events are queued and the
+ * callbacks are called from a separate dispatcher thread. Repeated data
+ * events of one interface are coalesced while queued. If more than
+ * @p max_queue_length events are pending, further events are dropped
+ * and counted, see bbil_async_overflows().
+ *
+ * Asynchronously delivered message events cannot prevent enqueuing the
+ * message, the return value of bb_interface_message_received() is
+ * ignored. The message stays valid during the call.
+ *
+ * This must be called before the listener is registered with the
+ * BlackBoard.
+ * @param enabled true to enable asynchronous delivery, false to disable
+ * @param max_queue_length maximum number of pending events
+ */
+void
+BlackBoardInterfaceListener::bbil_set_async_delivery(bool enabled, unsigned int max_queue_length)
+{
+	delete bbil_async_queue_;
+	bbil_async_queue_ = enabled ? new BlackBoardListenerEventQueue(max_queue_length) : NULL;
+}
+
+/** Check if asynchronous delivery is enabled.
+ * @return true if asynchronous delivery is enabled, false otherwise
+ */
+bool
+BlackBoardInterfaceListener::bbil_async_delivery() const
+{
+	return (bbil_async_queue_ != NULL);
+}
+
+/** Get number of dropped events.
+ * @return number of events dropped because the asynchronous delivery
+ * queue was full, zero if asynchronous delivery is disabled
+ */
+unsigned int
+BlackBoardInterfaceListener::bbil_async_overflows() const
+{
+	return bbil_async_queue_ ? bbil_async_queue_->overflows() : 0;
+}
+
+/** Get number of coalesced events.
+ * @return number of data events that have been merged into an already
+ * pending one, zero if asynchronous delivery is disabled
+ */
+unsigned int
+BlackBoardInterfaceListener::bbil_async_coalesced() const
+{
+	return bbil_async_queue_ ? bbil_async_queue_->coalesced() : 0;
+}
+
+/** Get number of handled data and message events.
+ * Events are only counted while statistics are enabled, see
+ * Interface::set_stats_enabled().
+ * @return number of data and message events delivered to this listener
+ */
+uint64_t
+BlackBoardInterfaceListener::bbil_num_events() const
+{
+	return __atomic_load_n(&bbil_num_events_, __ATOMIC_RELAXED);
+}
+
+/** Get time spent in callbacks.
+ * Time is only measured while statistics are enabled, see
+ * Interface::set_stats_enabled().
+ * @return accumulated time in nanoseconds spent in the data and message
+ * event callbacks of this listener
+ */
+uint64_t
+BlackBoardInterfaceListener::bbil_dispatch_nsec() const
+{
+	return __atomic_load_n(&bbil_dispatch_nsec_, __ATOMIC_RELAXED);
+}
+
+/** Account a delivered event.
+ * Called by the notifier and the dispatcher after a callback returned.
+ * @param start_nsec time in nanoseconds from interface_stats_clock_nsec()
+ * when delivery started, zero if statistics were disabled in which case
+ * nothing is accounted
+ */
+void
+BlackBoardInterfaceListener::bbil_count_event(uint64_t start_nsec) noexcept
+{
+	if (start_nsec == 0)
+		return;
+	__atomic_add_fetch(&bbil_num_events_, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&bbil_dispatch_nsec_,
+	                   interface_stats_clock_nsec() - start_nsec,
+	                   __ATOMIC_RELAXED);
+}
+
 /** BlackBoard data refreshed notification.
  * This is called whenever the data in an interface that you registered for is
  * refreshed. This happens when a writer calls the Interface::write(), regardless
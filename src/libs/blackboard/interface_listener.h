@@ -28,6 +28,8 @@
 #include <core/utils/lock_queue.h>
 #include <utils/misc/string_compare.h>
 
+#include <stdint.h>
+
 #include <list>
 #include <map>
 #include <string>
@@ -37,10 +39,13 @@ namespace fawkes {
 class Interface;
 class Message;
 class BlackBoardNotifier;
+class BlackBoardListenerDispatcher;
+class BlackBoardListenerEventQueue;
 
 class BlackBoardInterfaceListener
 {
 	friend BlackBoardNotifier;
+	friend BlackBoardListenerDispatcher;
 
 public:
 	/** Queue entry type. */
@@ -79,6 +84,14 @@ public:
 
 	const char *bbil_name() const;
 
+	void         bbil_set_async_delivery(bool enabled, unsigned int max_queue_length = 128);
+	bool         bbil_async_delivery() const;
+	unsigned int bbil_async_overflows() const;
+	unsigned int bbil_async_coalesced() const;
+
+	uint64_t bbil_num_events() const;
+	uint64_t bbil_dispatch_nsec() const;
+
 	virtual void bb_interface_data_refreshed(Interface *interface) noexcept;
 	virtual void bb_interface_data_changed(Interface *interface) noexcept;
 	virtual bool bb_interface_message_received(Interface *interface, Message *message) noexcept;
@@ -117,6 +130,8 @@ private:
 	const InterfaceMaps &bbil_acquire_maps() noexcept;
 	void                 bbil_release_maps() noexcept;
 
+	void bbil_count_event(uint64_t start_nsec) noexcept;
+
 private:
 	Mutex *bbil_queue_mutex_;
 	Mutex *bbil_maps_mutex_;
@@ -124,6 +139,11 @@ private:
 	InterfaceMaps  bbil_maps_;
 	InterfaceQueue bbil_queue_;
 
+	BlackBoardListenerEventQueue *bbil_async_queue_;
+
+	uint64_t bbil_num_events_;
+	uint64_t bbil_dispatch_nsec_;
+
 	char *name_;
 };
 
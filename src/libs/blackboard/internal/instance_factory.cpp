@@ -23,6 +23,8 @@
 
 #include <blackboard/exceptions.h>
 #include <blackboard/internal/instance_factory.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
 #include <utils/system/dynamic_module/module.h>
 #include <utils/system/dynamic_module/module_manager.h>
@@ -37,19 +39,96 @@ namespace fawkes {
  * This class is used to interact with the interface shared object to create
  * and delete interface instances.
  *
+ * The interface library of a type is opened on first use and its factory
+ * and destroyer functions are cached. The library is kept open for the
+ * lifetime of the factory, such that interfaces which are opened and
+ * closed repeatedly do not load and unload the library each time, and
+ * instances can be created with a map lookup while holding the interface
+ * manager lock.
+ *
  * @author Tim Niemueller
  */
 
 /** Constructor.*/
 BlackBoardInstanceFactory::BlackBoardInstanceFactory()
 {
-	mm_ = new ModuleManager(IFACEDIR);
+	mm_    = new ModuleManager(IFACEDIR);
+	mutex_ = new Mutex();
 }
 
 /** Destructor */
 BlackBoardInstanceFactory::~BlackBoardInstanceFactory()
 {
+	for (auto &t : types_) {
+		mm_->close_module(t.second.module);
+	}
+	types_.clear();
 	delete mm_;
+	delete mutex_;
+}
+
+/** Get cached information about an interface type.
+ * Opens the interface library if this has not been done before.
+ * @param type type of the interface
+ * @return information about the interface type
+ * @exception BlackBoardInterfaceNotFoundException thrown if the library or
+ * the factory or destroyer function for the given type could not be found
+ */
+BlackBoardInstanceFactory::TypeInfo
+BlackBoardInstanceFactory::type_info(const char *type)
+{
+	MutexLocker lock(mutex_);
+
+	std::map<std::string, TypeInfo>::iterator t = types_.find(type);
+	if (t != types_.end()) {
+		return t->second;
+	}
+
+	Module *    mod      = NULL;
+	std::string filename = std::string("lib") + type + "." + mm_->get_module_file_extension();
+	try {
+		mod = mm_->open_module(filename.c_str());
+	} catch (Exception &e) {
+		throw BlackBoardInterfaceNotFoundException(type, " Module file not found.");
+	}
+
+	if (!mod->has_symbol("interface_factory")) {
+		mm_->close_module(mod);
+		throw BlackBoardInterfaceNotFoundException(type, " Generator function not found.");
+	}
+	if (!mod->has_symbol("interface_destroy")) {
+		mm_->close_module(mod);
+		throw BlackBoardInterfaceNotFoundException(type, " Destroyer function not found.");
+	}
+
+	TypeInfo info;
+	info.module  = mod;
+	info.factory = (InterfaceFactoryFunc)mod->get_symbol("interface_factory");
+	info.destroy = (InterfaceDestroyFunc)mod->get_symbol("interface_destroy");
+	types_[type] = info;
+	return info;
+}
+
+/** Preload an interface type.
+ * Opens the library of the given interface type, if it has not been opened,
+ * yet. Call this before entering a critical section which creates instances
+ * of the type to keep loading the library out of it.
+ * @param type type of the interface
+ * @exception BlackBoardInterfaceNotFoundException thrown if the factory function
+ * for the given interface type could not be found
+ */
+void
+BlackBoardInstanceFactory::preload(const char *type)
+{
+	if (strlen(type) == 0) {
+		throw Exception("Interface type may not be empty");
+	}
+	if (strlen(type) > INTERFACE_TYPE_SIZE_) {
+		throw Exception("Interface type '%s' too long, maximum length is %zu",
+		                type,
+		                INTERFACE_TYPE_SIZE_);
+	}
+	type_info(type);
 }
 
 /** Creates a new interface instance.
@@ -80,21 +159,7 @@ BlackBoardInstanceFactory::new_interface_instance(const char *type, const char *
 		throw Exception("Interface ID '%s' too long, maximum length is %zu", type, INTERFACE_ID_SIZE_);
 	}
 
-	Module *    mod      = NULL;
-	std::string filename = std::string("lib") + type + "." + mm_->get_module_file_extension();
-	try {
-		mod = mm_->open_module(filename.c_str());
-	} catch (Exception &e) {
-		throw BlackBoardInterfaceNotFoundException(type, " Module file not found.");
-	}
-
-	if (!mod->has_symbol("interface_factory")) {
-		throw BlackBoardInterfaceNotFoundException(type, " Generator function not found.");
-	}
-
-	InterfaceFactoryFunc iff = (InterfaceFactoryFunc)mod->get_symbol("interface_factory");
-
-	Interface *iface = iff();
+	Interface *iface = type_info(type).factory();
 	iface->set_type_id(type, identifier);
 
 	return iface;
@@ -110,23 +175,17 @@ BlackBoardInstanceFactory::new_interface_instance(const char *type, const char *
 void
 BlackBoardInstanceFactory::delete_interface_instance(Interface *interface)
 {
-	std::string filename =
-	  std::string("lib") + interface->type_ + "." + mm_->get_module_file_extension();
-	Module *mod = mm_->get_module(filename.c_str());
-
-	if (!mod) {
-		throw BlackBoardInterfaceNotFoundException(interface->type_, " Interface module not opened.");
+	InterfaceDestroyFunc idf = NULL;
+	{
+		MutexLocker                               lock(mutex_);
+		std::map<std::string, TypeInfo>::iterator t = types_.find(interface->type_);
+		if (t == types_.end()) {
+			throw BlackBoardInterfaceNotFoundException(interface->type_, " Interface module not opened.");
+		}
+		idf = t->second.destroy;
 	}
 
-	if (!mod->has_symbol("interface_destroy")) {
-		throw BlackBoardInterfaceNotFoundException(interface->type_, " Destroyer function not found.");
-	}
-
-	InterfaceDestroyFunc idf = (InterfaceDestroyFunc)mod->get_symbol("interface_destroy");
 	idf(interface);
-
-	mod->unref();
-	mm_->close_module(mod);
 }
 
 } // end namespace fawkes
@@ -24,11 +24,16 @@
 #ifndef _BLACKBOARD_INSTANCE_FACTORY_H_
 #define _BLACKBOARD_INSTANCE_FACTORY_H_
 
+#include <interface/interface.h>
+
+#include <map>
+#include <string>
+
 namespace fawkes {
 
-class Interface;
 class Module;
 class ModuleManager;
+class Mutex;
 
 class BlackBoardInstanceFactory
 {
@@ -39,8 +44,24 @@ public:
 	Interface *new_interface_instance(const char *type, const char *identifier);
 	void       delete_interface_instance(Interface *interface);
 
+	void preload(const char *type);
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		Module *             module;
+		InterfaceFactoryFunc factory;
+		InterfaceDestroyFunc destroy;
+	} TypeInfo;
+	/// @endcond
+
+	TypeInfo type_info(const char *type);
+
 private:
-	ModuleManager *mm_;
+	ModuleManager *                 mm_;
+	Mutex *                         mutex_;
+	std::map<std::string, TypeInfo> types_;
 };
 
 } // end namespace fawkes
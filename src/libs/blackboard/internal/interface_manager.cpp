@@ -42,6 +42,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fnmatch.h>
+#include <map>
 
 namespace fawkes {
 
@@ -71,6 +72,7 @@ BlackBoardInterfaceManager::BlackBoardInterfaceManager(BlackBoardMemoryManager *
 	instance_serial  = 1;
 	instance_factory = new BlackBoardInstanceFactory();
 	mutex            = new Mutex();
+	mutex->set_name("BlackBoardInterfaceManager");
 
 	writer_interfaces.clear();
 	rwlocks.clear();
@@ -179,7 +181,8 @@ BlackBoardInterfaceManager::next_mem_serial()
  * @param interface reference to a pointer where the interface will be created
  * @param ptr reference to pointer of interface memory
  * @exception OutOfMemoryException thrown if there is not enough memory in the
- * BlackBoard to create the interface
+ * BlackBoard to create the interface. The interface instance has been created
+ * and must be deleted by the caller, which also still holds the locks.
  */
 void
 BlackBoardInterfaceManager::create_interface(const char *type,
@@ -199,8 +202,6 @@ BlackBoardInterfaceManager::create_interface(const char *type,
 		e.append(
 		  "BlackBoardInterfaceManager::createInterface: interface of type %s could not be created",
 		  type);
-		memmgr->unlock();
-		mutex->unlock();
 		throw;
 	}
 	memset(ptr, 0, interface->datasize() + sizeof(interface_header_t));
@@ -213,9 +214,16 @@ BlackBoardInterfaceManager::create_interface(const char *type,
 	ih->serial             = next_mem_serial();
 	ih->flag_writer_active = 0;
 	ih->num_readers        = 0;
-	rwlocks[ih->serial]    = new RefCountRWLock();
-
-	interface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+	ih->data_seq           = 0;
+	rwlocks[ih->serial]    = new RefCountRWLock(&ih->rwlock, /* initialize */ true);
+	rwlocks[ih->serial]->set_name(interface->uid());
+
+	interface->set_memory(ih->serial,
+	                      ptr,
+	                      (char *)ptr + sizeof(interface_header_t),
+	                      &ih->data_seq,
+	                      &ih->stats,
+	                      &ih->trace);
 }
 
 /** Open interface for reading.
@@ -243,6 +251,9 @@ BlackBoardInterfaceManager::open_for_reading(const char *type,
 		throw Exception("Interface ID '%s' too long, maximum length is %zu", type, INTERFACE_ID_SIZE_);
 	}
 
+	// load the type library, if necessary, before entering the critical section
+	instance_factory->preload(type);
+
 	mutex->lock();
 	Interface *         iface = NULL;
 	void *              ptr   = NULL;
@@ -262,7 +273,12 @@ BlackBoardInterfaceManager::open_for_reading(const char *type,
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
 				throw BlackBoardInterfaceVersionMismatchException();
 			}
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			iface->set_memory(ih->serial,
+			                  ptr,
+			                  (char *)ptr + sizeof(interface_header_t),
+			                  &ih->data_seq,
+			                  &ih->stats,
+			                  &ih->trace);
 			rwlocks[ih->serial]->ref();
 		} else {
 			created = true;
@@ -342,7 +358,12 @@ BlackBoardInterfaceManager::open_multiple_for_reading(const char *type_pattern,
 
 			void *ptr = *cit;
 			iface     = new_interface_instance(ih->type, ih->id, owner);
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			iface->set_memory(ih->serial,
+			                  ptr,
+			                  (char *)ptr + sizeof(interface_header_t),
+			                  &ih->data_seq,
+			                  &ih->stats,
+			                  &ih->trace);
 
 			if ((iface->hash_size() != INTERFACE_HASH_SIZE_)
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
@@ -380,6 +401,125 @@ BlackBoardInterfaceManager::open_multiple_for_reading(const char *type_pattern,
 	return rv;
 }
 
+/** Open a number of interfaces for reading at once.
+ * This opens the given interfaces like open_for_reading(), creating those
+ * which do not exist, yet. The interface libraries of all types are loaded
+ * before the BlackBoard is locked, and all interfaces are then opened in a
+ * single critical section, searching the memory only once. This is much
+ * faster than opening the interfaces one by one if there are many of them.
+ * Either all interfaces are opened or, if one of them cannot be opened, none.
+ * @param interfaces list of pairs of interface type and identifier
+ * @param owner name of entity which opened this interface. If using the BlackBoardAspect
+ * to access the blackboard leave this untouched unless you have a good reason.
+ * @return list of new fully initialized interface instances, in the order of
+ * the given list
+ * @exception OutOfMemoryException thrown if there is not enough free space for
+ * the requested interfaces.
+ */
+std::list<Interface *>
+BlackBoardInterfaceManager::open_all_for_reading(
+  const std::list<std::pair<std::string, std::string>> &interfaces,
+  const char *                                          owner)
+{
+	std::list<std::pair<std::string, std::string>>::const_iterator i;
+	for (i = interfaces.begin(); i != interfaces.end(); ++i) {
+		if (i->second.length() > INTERFACE_ID_SIZE_) {
+			throw Exception("Interface ID '%s' too long, maximum length is %zu",
+			                i->second.c_str(),
+			                INTERFACE_ID_SIZE_);
+		}
+		instance_factory->preload(i->first.c_str());
+	}
+
+	std::list<Interface *> rv;
+	std::list<Interface *> created;
+
+	mutex->lock();
+	memmgr->lock();
+
+	// index the existing chunks by UID instead of searching the memory per interface
+	std::map<std::string, void *>          chunks;
+	BlackBoardMemoryManager::ChunkIterator cit;
+	for (cit = memmgr->begin(); cit != memmgr->end(); ++cit) {
+		interface_header_t *ih = (interface_header_t *)*cit;
+		std::string         uid(ih->type, strnlen(ih->type, INTERFACE_TYPE_SIZE_));
+		uid += "::";
+		uid.append(ih->id, strnlen(ih->id, INTERFACE_ID_SIZE_));
+		chunks[uid] = *cit;
+	}
+
+	Interface *iface = NULL;
+	try {
+		for (i = interfaces.begin(); i != interfaces.end(); ++i) {
+			const char *        type       = i->first.c_str();
+			const char *        identifier = i->second.c_str();
+			void *              ptr        = NULL;
+			interface_header_t *ih;
+
+			std::map<std::string, void *>::iterator c = chunks.find(i->first + "::" + i->second);
+			if (c != chunks.end()) {
+				ptr   = c->second;
+				ih    = (interface_header_t *)ptr;
+				iface = new_interface_instance(type, identifier, owner);
+				if ((iface->hash_size() != INTERFACE_HASH_SIZE_)
+				    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
+					throw BlackBoardInterfaceVersionMismatchException();
+				}
+				iface->set_memory(ih->serial,
+				                  ptr,
+				                  (char *)ptr + sizeof(interface_header_t),
+				                  &ih->data_seq,
+				                  &ih->stats,
+				                  &ih->trace);
+				rwlocks[ih->serial]->ref();
+			} else {
+				create_interface(type, identifier, owner, iface, ptr);
+				ih                   = (interface_header_t *)ptr;
+				chunks[iface->uid()] = ptr;
+				created.push_back(iface);
+			}
+
+			owner_info_[iface->uid()].readers.push_back(iface);
+			iface->set_readwrite(false, rwlocks[ih->serial]);
+			ih->refcount++;
+			ih->num_readers++;
+
+			rv.push_back(iface);
+			iface = NULL;
+		}
+	} catch (Exception &e) {
+		if (iface)
+			delete_interface_instance(iface);
+		memmgr->unlock();
+		mutex->unlock();
+
+		// the interfaces opened so far are complete, announce and close them
+		// to leave the BlackBoard in the state it was before
+		for (std::list<Interface *>::iterator j = created.begin(); j != created.end(); ++j) {
+			notifier->notify_of_interface_created((*j)->type(), (*j)->id());
+		}
+		for (std::list<Interface *>::iterator j = rv.begin(); j != rv.end(); ++j) {
+			notifier->notify_of_reader_added(*j, (*j)->serial());
+		}
+		for (std::list<Interface *>::iterator j = rv.begin(); j != rv.end(); ++j) {
+			close(*j);
+		}
+		throw;
+	}
+
+	memmgr->unlock();
+	mutex->unlock();
+
+	for (std::list<Interface *>::iterator j = created.begin(); j != created.end(); ++j) {
+		notifier->notify_of_interface_created((*j)->type(), (*j)->id());
+	}
+	for (std::list<Interface *>::iterator j = rv.begin(); j != rv.end(); ++j) {
+		notifier->notify_of_reader_added(*j, (*j)->serial());
+	}
+
+	return rv;
+}
+
 /** Open interface for writing.
  * This will create a new interface instance of the given type. The result can be
  * casted to the appropriate type. This will only succeed if there is not already
@@ -408,6 +548,8 @@ BlackBoardInterfaceManager::open_for_writing(const char *type,
 		throw Exception("Interface ID '%s' too long, maximum length is %zu", type, INTERFACE_ID_SIZE_);
 	}
 
+	instance_factory->preload(type);
+
 	mutex->lock();
 	memmgr->lock();
 
@@ -431,7 +573,12 @@ BlackBoardInterfaceManager::open_for_writing(const char *type,
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
 				throw BlackBoardInterfaceVersionMismatchException();
 			}
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			iface->set_memory(ih->serial,
+			                  ptr,
+			                  (char *)ptr + sizeof(interface_header_t),
+			                  &ih->data_seq,
+			                  &ih->stats,
+			                  &ih->trace);
 			rwlocks[ih->serial]->ref();
 		} else {
 			created = true;
@@ -483,6 +630,9 @@ BlackBoardInterfaceManager::close(Interface *interface)
 		if (interface->write_access_) {
 			writer_interfaces.erase(interface->mem_serial_);
 		}
+		// the lock instance is released with the last interface, the
+		// lock memory goes away with the chunk
+		ReadWriteLock::destroy_shared(&ih->rwlock);
 		memmgr->free(interface->mem_real_ptr_);
 		destroyed = true;
 	} else {
@@ -540,7 +690,8 @@ BlackBoardInterfaceManager::list_all() const
 		             ih->num_readers,
 		             readers(uid),
 		             writer(uid),
-		             Time(data_ts->timestamp_sec, data_ts->timestamp_usec));
+		             Time(data_ts->timestamp_sec, data_ts->timestamp_usec),
+		             &ih->stats);
 	}
 
 	memmgr->unlock();
@@ -587,7 +738,8 @@ BlackBoardInterfaceManager::list(const char *type_pattern, const char *id_patter
 			             ih->num_readers,
 			             readers(uid),
 			             writer(uid),
-			             fawkes::Time(data_ts->timestamp_sec, data_ts->timestamp_usec));
+			             fawkes::Time(data_ts->timestamp_sec, data_ts->timestamp_usec),
+			             &ih->stats);
 		}
 	}
 
@@ -718,4 +870,17 @@ BlackBoardInterfaceManager::writer(const std::string &uid) const
 	return rv;
 }
 
+/** Get shared memory offset of interface.
+ * @param interface interface opened from this interface manager
+ * @param offset upon successful return the offset of the interface's
+ * memory chunk from the start of the shared memory data segment
+ * @return true if the BlackBoard is kept in shared memory, false otherwise
+ * @see BlackBoardMemoryManager::shmem_offset()
+ */
+bool
+BlackBoardInterfaceManager::shmem_offset(const Interface *interface, size_t &offset) const
+{
+	return memmgr->shmem_offset(interface->mem_real_ptr_, offset);
+}
+
 } // end namespace fawkes
@@ -29,6 +29,7 @@
 
 #include <list>
 #include <string>
+#include <utility>
 
 namespace fawkes {
 
@@ -65,6 +66,9 @@ public:
 	std::list<Interface *> open_multiple_for_reading(const char *type_pattern,
 	                                                 const char *id_pattern = "*",
 	                                                 const char *owner      = NULL);
+	std::list<Interface *>
+	open_all_for_reading(const std::list<std::pair<std::string, std::string>> &interfaces,
+	                     const char *                                          owner = NULL);
 
 	/* InterfaceMediator methods */
 	virtual bool         exists_writer(const Interface *interface) const;
@@ -76,6 +80,8 @@ public:
 	std::list<std::string> readers(const std::string &uid) const;
 	std::string            writer(const std::string &uid) const;
 
+	bool shmem_offset(const Interface *interface, size_t &offset) const;
+
 private:
 	const BlackBoardMemoryManager *memory_manager() const;
 
@@ -25,24 +25,35 @@
 #define _BLACKBOARD_INTERFACE_MEM_HEADER_H_
 
 #include <interface/interface.h>
+#include <interface/stats.h>
+#include <utils/time/latency_trace.h>
 
+#include <pthread.h>
 #include <stdint.h>
 
 namespace fawkes {
 
 /** This struct is used as header for interfaces in memory chunks.
  * This header is stored at the beginning of each allocated memory chunk.
+ * It contains the process-shared read/write lock protecting the data of
+ * the chunk, hence each interface instance has its own lock, the usage
+ * statistics of the interface, and the latency trace of the data, which
+ * is written together with the data.
  */
 typedef struct
 {
-	char          type[INTERFACE_TYPE_SIZE_]; /**< interface type */
-	char          id[INTERFACE_ID_SIZE_];     /**< interface identifier */
-	unsigned char hash[INTERFACE_HASH_SIZE_]; /**< interface type version hash */
-	uint16_t      flag_writer_active : 1;     /**< 1 if there is a writer, 0 otherwise */
-	uint16_t      flag_reserved : 15;         /**< reserved for future use */
-	uint16_t      num_readers;                /**< number of active readers */
-	uint32_t      refcount;                   /**< reference count */
-	uint32_t      serial;                     /**< memory serial */
+	char              type[INTERFACE_TYPE_SIZE_]; /**< interface type */
+	char              id[INTERFACE_ID_SIZE_];     /**< interface identifier */
+	unsigned char     hash[INTERFACE_HASH_SIZE_]; /**< interface type version hash */
+	uint16_t          flag_writer_active : 1;     /**< 1 if there is a writer, 0 otherwise */
+	uint16_t          flag_reserved : 15;         /**< reserved for future use */
+	uint16_t          num_readers;                /**< number of active readers */
+	uint32_t          refcount;                   /**< reference count */
+	uint32_t          serial;                     /**< memory serial */
+	uint32_t          data_seq;                   /**< write generation, odd while writing */
+	interface_stats_t stats;                      /**< usage statistics of all instances */
+	latency_trace_t   trace;                      /**< latency trace of the data */
+	pthread_rwlock_t  rwlock;                     /**< process-shared lock for the data */
 } interface_header_t;
 
 } // end namespace fawkes
@@ -0,0 +1,396 @@
+
+/***************************************************************************
+ *  listener_dispatcher.cpp - Asynchronous BlackBoard listener event delivery
+ *
+ *  Created: Wed Oct 14 18:26:06 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <blackboard/interface_listener.h>
+#include <blackboard/internal/listener_dispatcher.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+#include <interface/interface.h>
+#include <interface/message.h>
+
+#include <algorithm>
+
+namespace fawkes {
+
+/** @class BlackBoardListenerEventQueue <blackboard/internal/listener_dispatcher.h>
+ * Bounded event queue of an asynchronous BlackBoard interface listener.
+ * Events are stored until the dispatcher delivers them. Repeated data
+ * events for the same interface are coalesced into a single event, which
+ * is considered changed if any of the coalesced events was. If the queue
+ * is full further events are dropped and counted as overflows.
+ * The queue is not thread-safe, it is protected by the dispatcher.
+ */
+
+/** Constructor.
+ * @param max_length maximum number of queued events
+ */
+BlackBoardListenerEventQueue::BlackBoardListenerEventQueue(unsigned int max_length)
+{
+	max_length_ = max_length;
+	overflows_  = 0;
+	coalesced_  = 0;
+	events_.reserve(max_length);
+}
+
+/** Destructor. */
+BlackBoardListenerEventQueue::~BlackBoardListenerEventQueue()
+{
+	clear();
+}
+
+/** Append event if there is space left.
+ * @param e event to append
+ * @return true if the event has been queued, false on overflow
+ */
+bool
+BlackBoardListenerEventQueue::push(const Event &e)
+{
+	if (events_.size() >= max_length_) {
+		++overflows_;
+		return false;
+	}
+	events_.push_back(e);
+	return true;
+}
+
+/** Queue data event.
+ * @param uid UID of interface
+ * @param changed true if data has changed, false if only refreshed
+ * @return true if the event has been queued or coalesced, false on overflow
+ */
+bool
+BlackBoardListenerEventQueue::push_data(const char *uid, bool changed)
+{
+	std::map<std::string, std::vector<Event>::size_type>::iterator p = pending_data_.find(uid);
+	if (p != pending_data_.end()) {
+		events_[p->second].changed |= changed;
+		++coalesced_;
+		return true;
+	}
+	Event e = {DATA, uid, changed, NULL, Uuid()};
+	if (push(e)) {
+		pending_data_[uid] = events_.size() - 1;
+		return true;
+	}
+	return false;
+}
+
+/** Queue message event.
+ * The message is referenced until the event has been delivered.
+ * @param uid UID of interface
+ * @param message received message
+ * @return true if the event has been queued, false on overflow
+ */
+bool
+BlackBoardListenerEventQueue::push_message(const char *uid, Message *message)
+{
+	Event e = {MESSAGE, uid, false, message, Uuid()};
+	if (push(e)) {
+		message->ref();
+		return true;
+	}
+	return false;
+}
+
+/** Queue reader or writer event.
+ * @param type event type, one of the reader or writer types
+ * @param uid UID of interface
+ * @param instance_serial serial of the instance that caused the event
+ * @return true if the event has been queued, false on overflow
+ */
+bool
+BlackBoardListenerEventQueue::push_event(EventType type, const char *uid, const Uuid &instance_serial)
+{
+	Event e = {type, uid, false, NULL, instance_serial};
+	return push(e);
+}
+
+/** Check if queue is empty.
+ * @return true if no events are queued, false otherwise
+ */
+bool
+BlackBoardListenerEventQueue::empty() const
+{
+	return events_.empty();
+}
+
+/** Take all queued events.
+ * @param events vector to swap the queued events into, previous content
+ * is lost. Messages of MESSAGE events must be unref'ed by the caller.
+ */
+void
+BlackBoardListenerEventQueue::take(std::vector<Event> &events)
+{
+	events.clear();
+	events.swap(events_);
+	events_.reserve(max_length_);
+	pending_data_.clear();
+}
+
+/** Drop all queued events. */
+void
+BlackBoardListenerEventQueue::clear()
+{
+	for (Event &e : events_) {
+		if (e.message)
+			e.message->unref();
+	}
+	events_.clear();
+	pending_data_.clear();
+}
+
+/** Get number of dropped events.
+ * @return number of events dropped because the queue was full
+ */
+unsigned int
+BlackBoardListenerEventQueue::overflows() const
+{
+	return overflows_;
+}
+
+/** Get number of coalesced events.
+ * @return number of data events merged into an already queued one
+ */
+unsigned int
+BlackBoardListenerEventQueue::coalesced() const
+{
+	return coalesced_;
+}
+
+/** @class BlackBoardListenerDispatcher <blackboard/internal/listener_dispatcher.h>
+ * Delivery thread for asynchronous BlackBoard interface listeners.
+ * The notifier passes events for listeners which enabled asynchronous
+ * delivery to the dispatcher instead of calling them directly. The
+ * events are queued in the listener's event queue and delivered from
+ * this thread, hence a slow listener no longer stalls the writer.
+ * Interfaces are looked up by UID at delivery time, events for
+ * interfaces the listener no longer watches are silently dropped.
+ */
+
+/** Constructor. */
+BlackBoardListenerDispatcher::BlackBoardListenerDispatcher()
+: Thread("BlackBoardListenerDispatcher", Thread::OPMODE_WAITFORWAKEUP)
+{
+	mutex_          = new Mutex();
+	delivered_cond_ = new WaitCondition(mutex_);
+	running_        = false;
+	delivering_     = NULL;
+}
+
+/** Destructor. */
+BlackBoardListenerDispatcher::~BlackBoardListenerDispatcher()
+{
+	if (running_) {
+		cancel();
+		join();
+	}
+	delete delivered_cond_;
+	delete mutex_;
+}
+
+/** Add asynchronous listener.
+ * The dispatcher thread is started with the first listener.
+ * @param listener listener to accept events for
+ */
+void
+BlackBoardListenerDispatcher::add_listener(BlackBoardInterfaceListener *listener)
+{
+	MutexLocker lock(mutex_);
+	listeners_.insert(listener);
+	if (!running_) {
+		running_ = true;
+		start();
+	}
+}
+
+/** Remove asynchronous listener.
+ * Pending events of the listener are dropped. If the listener is
+ * currently being called from the dispatcher thread, waits until that
+ * has finished, unless called from within such a callback.
+ * @param listener listener to remove
+ */
+void
+BlackBoardListenerDispatcher::remove_listener(BlackBoardInterfaceListener *listener)
+{
+	MutexLocker lock(mutex_);
+	if (listeners_.erase(listener) == 0)
+		return;
+
+	ready_.remove(listener);
+	listener->bbil_async_queue_->clear();
+	while (delivering_ == listener && Thread::current_thread_noexc() != this) {
+		delivered_cond_->wait();
+	}
+}
+
+/** Schedule listener for delivery.
+ * Must be called with the mutex locked.
+ * @param listener listener with new events
+ */
+void
+BlackBoardListenerDispatcher::schedule(BlackBoardInterfaceListener *listener)
+{
+	if (std::find(ready_.begin(), ready_.end(), listener) == ready_.end()) {
+		ready_.push_back(listener);
+	}
+	wakeup();
+}
+
+/** Queue data event.
+ * @param listener listener to notify
+ * @param uid UID of interface
+ * @param changed true if data has changed, false if only refreshed
+ */
+void
+BlackBoardListenerDispatcher::push_data(BlackBoardInterfaceListener *listener,
+                                        const char *                 uid,
+                                        bool                         changed)
+{
+	MutexLocker lock(mutex_);
+	if (listeners_.find(listener) == listeners_.end())
+		return;
+	if (listener->bbil_async_queue_->push_data(uid, changed)) {
+		schedule(listener);
+	}
+}
+
+/** Queue message event.
+ * @param listener listener to notify
+ * @param uid UID of interface
+ * @param message received message, referenced until delivered
+ */
+void
+BlackBoardListenerDispatcher::push_message(BlackBoardInterfaceListener *listener,
+                                           const char *                 uid,
+                                           Message *                    message)
+{
+	MutexLocker lock(mutex_);
+	if (listeners_.find(listener) == listeners_.end())
+		return;
+	if (listener->bbil_async_queue_->push_message(uid, message)) {
+		schedule(listener);
+	}
+}
+
+/** Queue reader or writer event.
+ * @param listener listener to notify
+ * @param type event type, one of the reader or writer types
+ * @param uid UID of interface
+ * @param instance_serial serial of the instance that caused the event
+ */
+void
+BlackBoardListenerDispatcher::push_event(BlackBoardInterfaceListener *           listener,
+                                         BlackBoardListenerEventQueue::EventType type,
+                                         const char *                            uid,
+                                         const Uuid &                            instance_serial)
+{
+	MutexLocker lock(mutex_);
+	if (listeners_.find(listener) == listeners_.end())
+		return;
+	if (listener->bbil_async_queue_->push_event(type, uid, instance_serial)) {
+		schedule(listener);
+	}
+}
+
+void
+BlackBoardListenerDispatcher::loop()
+{
+	std::vector<BlackBoardListenerEventQueue::Event> events;
+
+	mutex_->lock();
+	while (!ready_.empty()) {
+		BlackBoardInterfaceListener *listener = ready_.front();
+		ready_.pop_front();
+		listener->bbil_async_queue_->take(events);
+		delivering_ = listener;
+		mutex_->unlock();
+
+		CancelState old_state;
+		set_cancel_state(CANCEL_DISABLED, &old_state);
+		for (BlackBoardListenerEventQueue::Event &e : events) {
+			deliver(listener, e);
+			if (e.message)
+				e.message->unref();
+		}
+		set_cancel_state(old_state);
+
+		mutex_->lock();
+		delivering_ = NULL;
+		delivered_cond_->wake_all();
+	}
+	mutex_->unlock();
+}
+
+/** Deliver a single event.
+ * @param listener listener to call
+ * @param e event to deliver
+ */
+void
+BlackBoardListenerDispatcher::deliver(BlackBoardInterfaceListener *        listener,
+                                      BlackBoardListenerEventQueue::Event &e)
+{
+	const char *uid = e.uid.c_str();
+	Interface * iface;
+	uint64_t    start_nsec;
+	switch (e.type) {
+	case BlackBoardListenerEventQueue::DATA:
+		if ((iface = listener->bbil_data_interface(uid)) != NULL) {
+			start_nsec = Interface::stats_enabled() ? interface_stats_clock_nsec() : 0;
+			listener->bb_interface_data_refreshed(iface);
+			if (e.changed)
+				listener->bb_interface_data_changed(iface);
+			listener->bbil_count_event(start_nsec);
+		}
+		break;
+	case BlackBoardListenerEventQueue::MESSAGE:
+		if ((iface = listener->bbil_message_interface(uid)) != NULL) {
+			start_nsec = Interface::stats_enabled() ? interface_stats_clock_nsec() : 0;
+			listener->bb_interface_message_received(iface, e.message);
+			listener->bbil_count_event(start_nsec);
+		}
+		break;
+	case BlackBoardListenerEventQueue::READER_ADDED:
+		if ((iface = listener->bbil_reader_interface(uid)) != NULL) {
+			listener->bb_interface_reader_added(iface, e.instance_serial);
+		}
+		break;
+	case BlackBoardListenerEventQueue::READER_REMOVED:
+		if ((iface = listener->bbil_reader_interface(uid)) != NULL) {
+			listener->bb_interface_reader_removed(iface, e.instance_serial);
+		}
+		break;
+	case BlackBoardListenerEventQueue::WRITER_ADDED:
+		if ((iface = listener->bbil_writer_interface(uid)) != NULL) {
+			listener->bb_interface_writer_added(iface, e.instance_serial);
+		}
+		break;
+	case BlackBoardListenerEventQueue::WRITER_REMOVED:
+		if ((iface = listener->bbil_writer_interface(uid)) != NULL) {
+			listener->bb_interface_writer_removed(iface, e.instance_serial);
+		}
+		break;
+	}
+}
+
+} // end namespace fawkes
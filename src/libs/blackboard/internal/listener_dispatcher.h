@@ -0,0 +1,133 @@
+
+/***************************************************************************
+ *  listener_dispatcher.h - Asynchronous BlackBoard listener event delivery
+ *
+ *  Created: Wed Oct 14 18:26:06 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_LISTENER_DISPATCHER_H_
+#define _BLACKBOARD_LISTENER_DISPATCHER_H_
+
+#include <core/threading/thread.h>
+#include <utils/uuid.h>
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+class BlackBoardInterfaceListener;
+class Message;
+class Mutex;
+class WaitCondition;
+
+class BlackBoardListenerEventQueue
+{
+public:
+	/** Type of queued event. */
+	typedef enum {
+		DATA,           ///< data refreshed, maybe changed
+		MESSAGE,        ///< message received
+		READER_ADDED,   ///< reader added
+		READER_REMOVED, ///< reader removed
+		WRITER_ADDED,   ///< writer added
+		WRITER_REMOVED  ///< writer removed
+	} EventType;
+
+	/** Queued event. */
+	typedef struct
+	{
+		EventType   type;            ///< event type
+		std::string uid;             ///< UID of interface the event concerns
+		bool        changed;         ///< for DATA events, true if data has changed
+		Message *   message;         ///< for MESSAGE events, referenced message
+		Uuid        instance_serial; ///< for reader/writer events, instance serial
+	} Event;
+
+	BlackBoardListenerEventQueue(unsigned int max_length);
+	~BlackBoardListenerEventQueue();
+
+	bool push_data(const char *uid, bool changed);
+	bool push_message(const char *uid, Message *message);
+	bool push_event(EventType type, const char *uid, const Uuid &instance_serial);
+
+	bool empty() const;
+	void take(std::vector<Event> &events);
+	void clear();
+
+	unsigned int overflows() const;
+	unsigned int coalesced() const;
+
+private:
+	bool push(const Event &e);
+
+private:
+	std::vector<Event>                        events_;
+	std::map<std::string, std::vector<Event>::size_type> pending_data_;
+	unsigned int                              max_length_;
+	unsigned int                              overflows_;
+	unsigned int                              coalesced_;
+};
+
+class BlackBoardListenerDispatcher : public Thread
+{
+public:
+	BlackBoardListenerDispatcher();
+	virtual ~BlackBoardListenerDispatcher();
+
+	void add_listener(BlackBoardInterfaceListener *listener);
+	void remove_listener(BlackBoardInterfaceListener *listener);
+
+	void push_data(BlackBoardInterfaceListener *listener, const char *uid, bool changed);
+	void push_message(BlackBoardInterfaceListener *listener, const char *uid, Message *message);
+	void push_event(BlackBoardInterfaceListener *            listener,
+	                BlackBoardListenerEventQueue::EventType type,
+	                const char *                            uid,
+	                const Uuid &                            instance_serial);
+
+	virtual void loop();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	void schedule(BlackBoardInterfaceListener *listener);
+	void deliver(BlackBoardInterfaceListener *listener, BlackBoardListenerEventQueue::Event &e);
+
+private:
+	Mutex *        mutex_;
+	WaitCondition *delivered_cond_;
+	bool           running_;
+
+	std::set<BlackBoardInterfaceListener *>  listeners_;
+	std::list<BlackBoardInterfaceListener *> ready_;
+	BlackBoardInterfaceListener *            delivering_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -31,10 +31,13 @@
 #include <sys/mman.h>
 #include <utils/ipc/shm.h>
 #include <utils/ipc/shm_exceptions.h>
+#include <utils/system/memory_placement.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 /** If a free chunk is allocated it may be split up into an allocated
  * and a new free chunk. This value determines when this is done. If
@@ -44,12 +47,36 @@
  */
 #define BBMM_MIN_FREE_CHUNK_SIZE sizeof(chunk_list_t)
 
+/** Smallest size class used by the size-class allocation strategy.
+ * Allocations are rounded up to at least 2^BBMM_MIN_SIZE_CLASS bytes.
+ */
+#define BBMM_MIN_SIZE_CLASS 6
+
 // shortcuts
 #define chunk_ptr(a) (shmem_ ? (chunk_list_t *)shmem_->ptr(a) : a)
 #define chunk_addr(a) (shmem_ ? (chunk_list_t *)shmem_->addr(a) : a)
 
 namespace fawkes {
 
+/// @cond INTERNALS
+static inline unsigned int
+size_class_floor(unsigned int num_bytes)
+{
+	if (num_bytes == 0)
+		return 0;
+	return (sizeof(unsigned int) * 8 - 1) - __builtin_clz(num_bytes);
+}
+
+static inline unsigned int
+size_class_ceil(unsigned int num_bytes)
+{
+	unsigned int c = size_class_floor(num_bytes);
+	if ((1u << c) < num_bytes)
+		++c;
+	return std::max(c, (unsigned int)BBMM_MIN_SIZE_CLASS);
+}
+/// @endcond
+
 /** @class BlackBoardMemoryManager <blackboard/internal/memory_manager.h>
  * BlackBoard memory manager.
  * This class is used by the BlackBoard to manage the memory in the shared memory
@@ -80,6 +107,15 @@ namespace fawkes {
  * of free memory are merged to one. Afterwards the free chunks list will contain
  * non-ajdacent free memory regions of maximum size between allocated chunks.
  *
+ * Alternatively the size-class allocation strategy can be enabled using
+ * set_allocation_strategy(). Allocations are then rounded up to the next
+ * power of two. Freed chunks are not merged but kept in a list per size
+ * class. Allocations of the same class are served from that list in
+ * constant time and without searching the free chunks list, which avoids
+ * fragmenting the segment if interfaces are opened and closed
+ * repeatedly. Only if an allocation cannot be served otherwise, all cached
+ * chunks are merged back into the free chunks list.
+ *
  * The memory manager is thread-safe as all appropriate operations are protected
  * by a mutex.
  *
@@ -102,11 +138,16 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t memsize)
 {
 	shmem_        = NULL;
 	shmem_header_ = NULL;
+	shmem_token_  = NULL;
 	memsize_      = memsize;
-	memory_       = malloc(memsize);
-	mutex_        = new Mutex();
 	master_       = true;
 
+	// align to huge pages so the memory can be backed by them
+	if (posix_memalign(&memory_, 2 * 1024 * 1024, memsize) != 0) {
+		throw OutOfMemoryException("Failed to allocate BlackBoard memory");
+	}
+	mutex_ = new Mutex();
+
 	// Lock memory to RAM to avoid swapping
 	mlock(memory_, memsize_);
 
@@ -118,6 +159,9 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t memsize)
 
 	free_list_head_  = f;
 	alloc_list_head_ = NULL;
+
+	memset(&heap_size_classes_, 0, sizeof(chunk_size_classes_t));
+	size_classes_ = &heap_size_classes_;
 }
 
 /** Shared Memory Constructor
@@ -170,6 +214,7 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t       memsize,
 		delete shmem_header_;
 		throw BBNotMasterException("Not owner of shared memory segment");
 	}
+	shmem_token_ = strdup(shmem_token);
 
 	// printf("Shared memory base pointer: 0x%x\n", (size_t)shmem->getMemPtr());
 
@@ -192,7 +237,8 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t       memsize,
 		shmem_header_->set_alloc_list_head(NULL);
 	}
 
-	mutex_ = new Mutex();
+	size_classes_ = shmem_header_->size_classes();
+	mutex_        = new Mutex();
 }
 
 /** Destructor */
@@ -201,23 +247,22 @@ BlackBoardMemoryManager::~BlackBoardMemoryManager()
 	// close shared memory segment, kill semaphore
 	delete shmem_;
 	delete shmem_header_;
+	::free(shmem_token_);
 	if (memory_) {
 		::free(memory_);
 	}
 	delete mutex_;
 }
 
-/** Allocate memory.
- * This will allocate memory in the shared memory segment. The strategy is described
- * in the class description. Note: this method does NOT lock the shared memory
- * system. Chaos and havoc will come down upon you if you do not ensure locking!
- * @exception OutOfMemoryException thrown if not enough free memory is available to
- *                                 accommodate a chunk of the desired size
+/** Allocate chunk from free chunks list.
+ * The smallest free chunk that is big enough is removed from the free chunks
+ * list and split if it is considerably bigger than requested.
  * @param num_bytes number of bytes to allocate
- * @return pointer to the memory chunk
+ * @return chunk, which is not yet part of the allocated chunks list
+ * @exception OutOfMemoryException thrown if no free chunk is big enough
  */
-void *
-BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
+chunk_list_t *
+BlackBoardMemoryManager::alloc_best_fit(unsigned int num_bytes)
 {
 	// search for smallest chunk just big enough for desired size
 	chunk_list_t *l = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
@@ -279,6 +324,69 @@ BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
 		f->overhang = f->size - num_bytes;
 	}
 
+	return f;
+}
+
+/** Allocate chunk from size classes.
+ * If a chunk of the appropriate size class has been cached it is used
+ * right away. Otherwise a chunk of the size class is carved from the free
+ * chunks list. If that fails all cached chunks are merged back and the
+ * allocation is retried.
+ * @param num_bytes number of bytes to allocate
+ * @return chunk, which is not yet part of the allocated chunks list
+ * @exception OutOfMemoryException thrown if not enough free memory is available
+ */
+chunk_list_t *
+BlackBoardMemoryManager::alloc_size_class(unsigned int num_bytes)
+{
+	unsigned int  c = size_class_ceil(num_bytes);
+	chunk_list_t *f = NULL;
+
+	if ((c < BBMM_NUM_SIZE_CLASSES) && size_classes_->heads[c]) {
+		f                       = chunk_ptr(size_classes_->heads[c]);
+		size_classes_->heads[c] = f->next;
+		f->next                 = NULL;
+		size_classes_->hits += 1;
+	} else {
+		unsigned int class_bytes = (c < BBMM_NUM_SIZE_CLASSES) ? (1u << c) : num_bytes;
+		size_classes_->misses += 1;
+		try {
+			f = alloc_best_fit(class_bytes);
+		} catch (OutOfMemoryException &e) {
+			if (!flush_size_classes() && (class_bytes == num_bytes))
+				throw;
+			try {
+				f = alloc_best_fit(class_bytes);
+			} catch (OutOfMemoryException &e) {
+				// rounding up does not fit anymore, try exact size as last resort
+				f = alloc_best_fit(num_bytes);
+			}
+		}
+	}
+
+	f->overhang = f->size - num_bytes;
+	return f;
+}
+
+/** Allocate memory.
+ * This will allocate memory in the shared memory segment. The strategy is described
+ * in the class description. Note: this method does NOT lock the shared memory
+ * system. Chaos and havoc will come down upon you if you do not ensure locking!
+ * @exception OutOfMemoryException thrown if not enough free memory is available to
+ *                                 accommodate a chunk of the desired size
+ * @param num_bytes number of bytes to allocate
+ * @return pointer to the memory chunk
+ */
+void *
+BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
+{
+	chunk_list_t *f;
+	if (size_classes_->enabled) {
+		f = alloc_size_class(num_bytes);
+	} else {
+		f = alloc_best_fit(num_bytes);
+	}
+
 	// alloc new chunk
 	if (shmem_) {
 		shmem_header_->set_alloc_list_head(list_add(shmem_header_->alloc_list_head(), f));
@@ -345,11 +453,17 @@ BlackBoardMemoryManager::free(void *ptr)
 		shmem_header_->set_alloc_list_head(list_remove(shmem_header_->alloc_list_head(), ac));
 
 		// reclaim as free memory
-		ac->overhang = 0;
-		shmem_header_->set_free_list_head(list_add(shmem_header_->free_list_head(), ac));
+		ac->overhang        = 0;
+		unsigned int sclass = size_class_floor(ac->size);
+		if (size_classes_->enabled && (sclass < BBMM_NUM_SIZE_CLASSES)) {
+			ac->next                     = size_classes_->heads[sclass];
+			size_classes_->heads[sclass] = chunk_addr(ac);
+		} else {
+			shmem_header_->set_free_list_head(list_add(shmem_header_->free_list_head(), ac));
 
-		// merge adjacent regions
-		cleanup_free_chunks();
+			// merge adjacent regions
+			cleanup_free_chunks();
+		}
 
 		shmem_->unlock();
 	} else {
@@ -363,11 +477,17 @@ BlackBoardMemoryManager::free(void *ptr)
 		alloc_list_head_ = list_remove(alloc_list_head_, ac);
 
 		// reclaim as free memory
-		ac->overhang    = 0;
-		free_list_head_ = list_add(free_list_head_, ac);
+		ac->overhang        = 0;
+		unsigned int sclass = size_class_floor(ac->size);
+		if (size_classes_->enabled && (sclass < BBMM_NUM_SIZE_CLASSES)) {
+			ac->next                     = size_classes_->heads[sclass];
+			size_classes_->heads[sclass] = ac;
+		} else {
+			free_list_head_ = list_add(free_list_head_, ac);
 
-		// merge adjacent regions
-		cleanup_free_chunks();
+			// merge adjacent regions
+			cleanup_free_chunks();
+		}
 	}
 
 	mutex_->unlock();
@@ -383,55 +503,39 @@ BlackBoardMemoryManager::free(void *ptr)
 void
 BlackBoardMemoryManager::check()
 {
-	chunk_list_t *f = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
-	chunk_list_t *a = shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
-	chunk_list_t *t = NULL;
-
-	unsigned int mem = 0;
+	std::vector<chunk_list_t *> chunks;
 
-	// we crawl through the memory and analyse if the chunks are continuous,
-	// assumption: chunk list sorted ascending by ptr
-	while (f || a) {
-		if (f == NULL) {
-			mem += a->size + sizeof(chunk_list_t);
-			t = chunk_ptr(a->next);
-			if (t) {
-				// check if a is continuous
-				void *next = (char *)a->ptr + a->size + sizeof(chunk_list_t);
-				if (next != t->ptr) {
-					throw BBInconsistentMemoryException("non-contiguos allocated memory");
-				}
-			}
-			a = t;
-		} else if (a == NULL) {
-			mem += f->size + sizeof(chunk_list_t);
-			t = chunk_ptr(f->next);
-			if (t) {
-				// check if f is continuous
-				void *next = (char *)f->ptr + f->size + sizeof(chunk_list_t);
-				if (next != t->ptr) {
-					throw BBInconsistentMemoryException("non-contiguos allocated memory");
-				}
+	chunk_list_t *l = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
+	for (; l; l = chunk_ptr(l->next))
+		chunks.push_back(l);
+	l = shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
+	for (; l; l = chunk_ptr(l->next))
+		chunks.push_back(l);
+	for (unsigned int c = 0; c < BBMM_NUM_SIZE_CLASSES; ++c) {
+		for (l = chunk_ptr(size_classes_->heads[c]); l; l = chunk_ptr(l->next)) {
+			if (size_class_floor(l->size) != c) {
+				throw BBInconsistentMemoryException("cached chunk in wrong size class");
 			}
-			f = t;
-		} else if (f->ptr == a->ptr) {
-			throw BBInconsistentMemoryException("ptr cannot be free and allocated at the same time");
-		} else if (f->ptr < a->ptr) {
-			mem += f->size + sizeof(chunk_list_t);
-			void *next = (char *)f->ptr + f->size;
-			t          = chunk_ptr(f->next);
-			if ((next != t) && (next != a)) {
-				throw BBInconsistentMemoryException("there are unallocated bytes between chunks (f)");
+			chunks.push_back(l);
+		}
+	}
+
+	// we crawl through the memory and analyse if the chunks are continuous
+	std::sort(chunks.begin(), chunks.end(), [](const chunk_list_t *a, const chunk_list_t *b) {
+		return a->ptr < b->ptr;
+	});
+
+	unsigned int mem = 0;
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		mem += chunks[i]->size + sizeof(chunk_list_t);
+		if (i + 1 < chunks.size()) {
+			if (chunks[i]->ptr == chunks[i + 1]->ptr) {
+				throw BBInconsistentMemoryException("ptr cannot be in two chunk lists at the same time");
 			}
-			f = t;
-		} else {
-			mem += a->size + sizeof(chunk_list_t);
-			void *next = (char *)a->ptr + a->size;
-			t          = chunk_ptr(a->next);
-			if ((next != t) && (next != f)) {
-				throw BBInconsistentMemoryException("there are unallocated bytes between chunks (a)");
+			void *next = (char *)chunks[i]->ptr + chunks[i]->size + sizeof(chunk_list_t);
+			if (next != chunks[i + 1]->ptr) {
+				throw BBInconsistentMemoryException("there are unallocated bytes between chunks");
 			}
-			a = t;
 		}
 	}
 
@@ -441,6 +545,63 @@ BlackBoardMemoryManager::check()
 	}
 }
 
+/** Set allocation strategy.
+ * Switching back to the best fit strategy merges all cached chunks into the
+ * free chunks list.
+ * @param strategy new allocation strategy
+ */
+void
+BlackBoardMemoryManager::set_allocation_strategy(AllocationStrategy strategy)
+{
+	lock();
+	if (strategy == ALLOC_SIZE_CLASSES) {
+		size_classes_->enabled = 1;
+	} else {
+		size_classes_->enabled = 0;
+		flush_size_classes();
+	}
+	unlock();
+}
+
+/** Get allocation strategy.
+ * @return currently used allocation strategy
+ */
+BlackBoardMemoryManager::AllocationStrategy
+BlackBoardMemoryManager::allocation_strategy() const
+{
+	return size_classes_->enabled ? ALLOC_SIZE_CLASSES : ALLOC_BEST_FIT;
+}
+
+/** Advise huge pages for the memory segment.
+ * Reduces TLB misses when accessing interfaces of a large BlackBoard.
+ * @return true if the advice was accepted, false otherwise
+ * @see MemoryPlacement::advise_huge_pages()
+ */
+bool
+BlackBoardMemoryManager::advise_huge_pages()
+{
+	if (shmem_) {
+		return shmem_->advise_huge_pages();
+	} else {
+		return MemoryPlacement::advise_huge_pages(memory_, memsize_);
+	}
+}
+
+/** Bind the memory segment to a NUMA node.
+ * @param node NUMA node, or one of the special values of MemoryPlacement
+ * @return true if the memory has been bound, false otherwise
+ * @see MemoryPlacement::bind_numa_node()
+ */
+bool
+BlackBoardMemoryManager::bind_numa_node(int node)
+{
+	if (shmem_) {
+		return shmem_->bind_numa_node(node);
+	} else {
+		return MemoryPlacement::bind_numa_node(memory_, memsize_, node);
+	}
+}
+
 /** Check if this BB memory manager is the master.
  * @return true if this BB memory manager instance is the master for the BB
  * shared memory segment, false otherwise
@@ -483,6 +644,14 @@ BlackBoardMemoryManager::print_performance_info() const
 	       max_free_size(),
 	       max_allocated_size(),
 	       overhang_size());
+	printf("cached chunks: %4u, cached: %10u, class hits: %8u, misses: %8u, flushes: %6u, "
+	       "fragmentation: %5.1f%%\n",
+	       num_cached_chunks(),
+	       cached_size(),
+	       size_class_hits(),
+	       size_class_misses(),
+	       size_class_flushes(),
+	       fragmentation() * 100.f);
 }
 
 /** Get maximum allocatable memory size.
@@ -554,6 +723,79 @@ BlackBoardMemoryManager::num_free_chunks() const
 	return list_length(shmem_ ? shmem_header_->free_list_head() : free_list_head_);
 }
 
+/** Get memory cached in size classes.
+ * This is the sum of the sizes of chunks that have been freed while the
+ * size-class allocation strategy was active and that are kept for re-use.
+ * @return sum of cached chunk sizes
+ */
+unsigned int
+BlackBoardMemoryManager::cached_size() const
+{
+	unsigned int cached_size = 0;
+	for (unsigned int c = 0; c < BBMM_NUM_SIZE_CLASSES; ++c) {
+		for (chunk_list_t *l = chunk_ptr(size_classes_->heads[c]); l; l = chunk_ptr(l->next)) {
+			cached_size += l->size;
+		}
+	}
+	return cached_size;
+}
+
+/** Get number of chunks cached in size classes.
+ * @return number of cached memory chunks
+ */
+unsigned int
+BlackBoardMemoryManager::num_cached_chunks() const
+{
+	unsigned int num = 0;
+	for (unsigned int c = 0; c < BBMM_NUM_SIZE_CLASSES; ++c) {
+		num += list_length(chunk_ptr(size_classes_->heads[c]));
+	}
+	return num;
+}
+
+/** Get number of allocations served from a size class.
+ * @return number of allocations that re-used a cached chunk
+ */
+unsigned int
+BlackBoardMemoryManager::size_class_hits() const
+{
+	return size_classes_->hits;
+}
+
+/** Get number of size class allocations carved from the free chunks list.
+ * @return number of allocations for which no cached chunk was available
+ */
+unsigned int
+BlackBoardMemoryManager::size_class_misses() const
+{
+	return size_classes_->misses;
+}
+
+/** Get number of size class flushes.
+ * @return number of times cached chunks have been merged back into the
+ * free chunks list
+ */
+unsigned int
+BlackBoardMemoryManager::size_class_flushes() const
+{
+	return size_classes_->flushes;
+}
+
+/** Get fragmentation of free memory.
+ * The fragmentation is the fraction of free memory (including cached chunks)
+ * that is not part of the biggest free chunk. A value of zero means that
+ * all free memory can be allocated in one chunk.
+ * @return fragmentation in the range [0, 1]
+ */
+float
+BlackBoardMemoryManager::fragmentation() const
+{
+	unsigned int total = free_size() + cached_size();
+	if (total == 0)
+		return 0.f;
+	return 1.f - (float)max_free_size() / (float)total;
+}
+
 /** Get size of memory.
  * This does not include memory headers, but only the size of the data segment.
  * @return size of memory.
@@ -573,6 +815,47 @@ BlackBoardMemoryManager::version() const
 	return shmem_ ? shmem_header_->version() : 0;
 }
 
+/** Get shared memory token.
+ * @return magic token of the shared memory segment, NULL if the memory
+ * is kept on the heap
+ */
+const char *
+BlackBoardMemoryManager::shmem_token() const
+{
+	return shmem_token_;
+}
+
+/** Get shared memory ID.
+ * @return System V shared memory ID of the segment, -1 if the memory is
+ * kept on the heap
+ */
+int
+BlackBoardMemoryManager::shmem_id() const
+{
+	return shmem_ ? shmem_->shmem_id() : -1;
+}
+
+/** Get offset of a pointer in the shared memory segment.
+ * The offset is relative to the start of the data segment and is the
+ * same for every process attached to the segment, while the mapped
+ * addresses may differ.
+ * @param ptr local pointer into the managed memory
+ * @param offset upon successful return the offset of @p ptr
+ * @return true if the memory is kept in shared memory and @p ptr points
+ * into it, false otherwise
+ */
+bool
+BlackBoardMemoryManager::shmem_offset(const void *ptr, size_t &offset) const
+{
+	if (!shmem_)
+		return false;
+	const char *base = (const char *)shmem_->memptr();
+	if ((const char *)ptr < base || (const char *)ptr >= base + shmem_->data_size())
+		return false;
+	offset = (const char *)ptr - base;
+	return true;
+}
+
 /** Lock memory.
  * Locks the whole memory segment used and managed by the memory manager. Will
  * aquire local mutex lock and global semaphore lock in shared memory segment.
@@ -681,6 +964,34 @@ BlackBoardMemoryManager::cleanup_free_chunks()
 	}
 }
 
+/** Merge cached chunks into free chunks list.
+ * All chunks cached in size classes are added to the free chunks list and
+ * adjacent free chunks are merged.
+ * @return true if any chunk was cached, false otherwise
+ */
+bool
+BlackBoardMemoryManager::flush_size_classes()
+{
+	bool flushed = false;
+	for (unsigned int c = 0; c < BBMM_NUM_SIZE_CLASSES; ++c) {
+		while (size_classes_->heads[c]) {
+			chunk_list_t *l         = chunk_ptr(size_classes_->heads[c]);
+			size_classes_->heads[c] = l->next;
+			if (shmem_) {
+				shmem_header_->set_free_list_head(list_add(shmem_header_->free_list_head(), l));
+			} else {
+				free_list_head_ = list_add(free_list_head_, l);
+			}
+			flushed = true;
+		}
+	}
+	if (flushed) {
+		cleanup_free_chunks();
+		size_classes_->flushes += 1;
+	}
+	return flushed;
+}
+
 /** Remove an element from a list.
  * @param list list to remove the element from
  * @param rmel element to remove
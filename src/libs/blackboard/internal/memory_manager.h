@@ -50,16 +50,36 @@ struct chunk_list_t
 	unsigned int  overhang; /**< number of overhanging bytes in this chunk */
 };
 
-// May be added later if we want/need per chunk semaphores
-//  int            semset_key;	/* key of semaphore for this chunk */
-//  unsigned int   reserved   :16;/* reserved bytes */
-//  unsigned int   semset_sem : 8;/* semaphore number in semaphore set */
+/** Number of size classes of the size-class allocation strategy.
+ * Free chunks in class i have a size of at least 2^i bytes.
+ */
+#define BBMM_NUM_SIZE_CLASSES 32
+
+/** Size class management data as stored in BlackBoard shared memory segment.
+ * Chunks freed while the size-class allocation strategy is active are not
+ * merged into the free chunks list, but cached in a per size class list,
+ * from which allocations of the same class are served in constant time.
+ */
+struct chunk_size_classes_t
+{
+	unsigned int  enabled;                      /**< 1 if size classes are used, 0 otherwise */
+	chunk_list_t *heads[BBMM_NUM_SIZE_CLASSES]; /**< offsets of the cached chunk list heads */
+	unsigned int  hits;                         /**< allocations served from a size class */
+	unsigned int  misses;                       /**< allocations carved from free chunks */
+	unsigned int  flushes;                      /**< merges of cached chunks into free list */
+};
 
 class BlackBoardMemoryManager
 {
 	friend BlackBoardInterfaceManager;
 
 public:
+	/** Memory allocation strategy. */
+	typedef enum {
+		ALLOC_BEST_FIT,    ///< smallest fitting free chunk, merge on free (default)
+		ALLOC_SIZE_CLASSES ///< power-of-two size classes, cache chunks on free
+	} AllocationStrategy;
+
 	BlackBoardMemoryManager(size_t memsize);
 	BlackBoardMemoryManager(size_t       memsize,
 	                        unsigned int version,
@@ -72,8 +92,14 @@ public:
 
 	void check();
 
+	void               set_allocation_strategy(AllocationStrategy strategy);
+	AllocationStrategy allocation_strategy() const;
+
 	bool is_master() const;
 
+	bool advise_huge_pages();
+	bool bind_numa_node(int node);
+
 	unsigned int max_free_size() const;
 	unsigned int max_allocated_size() const;
 
@@ -84,9 +110,20 @@ public:
 	unsigned int num_free_chunks() const;
 	unsigned int num_allocated_chunks() const;
 
+	unsigned int cached_size() const;
+	unsigned int num_cached_chunks() const;
+	unsigned int size_class_hits() const;
+	unsigned int size_class_misses() const;
+	unsigned int size_class_flushes() const;
+	float        fragmentation() const;
+
 	unsigned int memory_size() const;
 	unsigned int version() const;
 
+	const char *shmem_token() const;
+	int         shmem_id() const;
+	bool        shmem_offset(const void *ptr, size_t &offset) const;
+
 	void print_free_chunks_info() const;
 	void print_allocated_chunks_info() const;
 	void print_performance_info() const;
@@ -141,6 +178,10 @@ private:
 	chunk_list_t *list_next(const chunk_list_t *list) const;
 
 	void cleanup_free_chunks();
+	bool flush_size_classes();
+
+	chunk_list_t *alloc_best_fit(unsigned int num_bytes);
+	chunk_list_t *alloc_size_class(unsigned int num_bytes);
 
 	void list_print_info(const chunk_list_t *list) const;
 
@@ -154,9 +195,14 @@ private:
 	// Mutex to be used for all list operations (alloc, free)
 	Mutex *mutex_;
 
+	// size class data, in shmem header or heap_size_classes_
+	chunk_size_classes_t *size_classes_;
+	chunk_size_classes_t  heap_size_classes_;
+
 	// used for shmem
 	BlackBoardSharedMemoryHeader *shmem_header_;
 	SharedMemory *                shmem_;
+	char *                        shmem_token_;
 
 	// Used for heap memory
 	void *        memory_;
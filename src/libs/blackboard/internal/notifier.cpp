@@ -24,6 +24,7 @@
 #include <blackboard/blackboard.h>
 #include <blackboard/interface_listener.h>
 #include <blackboard/interface_observer.h>
+#include <blackboard/internal/listener_dispatcher.h>
 #include <blackboard/internal/notifier.h>
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
@@ -35,8 +36,8 @@
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
-#include <fnmatch.h>
 #include <functional>
+#include <set>
 
 namespace fawkes {
 
@@ -65,11 +66,15 @@ BlackBoardNotifier::BlackBoardNotifier()
 
 	bbio_events_ = 0;
 	bbio_mutex_  = new Mutex();
+
+	dispatcher_ = new BlackBoardListenerDispatcher();
 }
 
 /** Destructor */
 BlackBoardNotifier::~BlackBoardNotifier()
 {
+	delete dispatcher_;
+
 	delete bbil_writer_mutex_;
 	delete bbil_reader_mutex_;
 	delete bbil_data_mutex_;
@@ -99,6 +104,10 @@ void
 BlackBoardNotifier::update_listener(BlackBoardInterfaceListener *    listener,
                                     BlackBoard::ListenerRegisterFlag flag)
 {
+	if (listener->bbil_async_queue_) {
+		dispatcher_->add_listener(listener);
+	}
+
 	const BlackBoardInterfaceListener::InterfaceQueue &queue = listener->bbil_acquire_queue();
 
 	BlackBoardInterfaceListener::InterfaceQueue::const_iterator i = queue.begin();
@@ -245,6 +254,10 @@ BlackBoardNotifier::unregister_listener(BlackBoardInterfaceListener *listener)
 	}
 
 	listener->bbil_release_maps();
+
+	if (listener->bbil_async_queue_) {
+		dispatcher_->remove_listener(listener);
+	}
 }
 
 /** Add listener for specified map.
@@ -318,6 +331,8 @@ BlackBoardNotifier::register_observer(BlackBoardInterfaceObserver *observer)
 	} else {
 		add_observer(observer, observer->bbio_get_observed_create(), bbio_created_);
 		add_observer(observer, observer->bbio_get_observed_destroy(), bbio_destroyed_);
+		index_observers(bbio_created_, bbio_created_index_);
+		index_observers(bbio_destroyed_, bbio_destroyed_index_);
 	}
 	bbio_mutex_->unlock();
 }
@@ -364,6 +379,60 @@ BlackBoardNotifier::remove_observer(BBioMap &iomap, BlackBoardInterfaceObserver
 	}
 }
 
+/** Rebuild pattern index of observer map.
+ * Must be called whenever the type patterns of the map changed.
+ * @param iomap interface observer map to index
+ * @param index index to update
+ */
+void
+BlackBoardNotifier::index_observers(BBioMap &iomap, PatternIndex<BBioList *> &index)
+{
+	index.clear();
+	for (BBioMapIterator i = iomap.begin(); i != iomap.end(); ++i) {
+		index.insert(i->first, &i->second);
+	}
+}
+
+/** Notify observers of created or destroyed interface.
+ * Only observers whose type pattern matches are considered. They are
+ * notified in the order of their type patterns.
+ * @param index index of observer lists by type pattern
+ * @param created true to notify of a created, false of a destroyed interface
+ * @param type type of the interface
+ * @param id ID of the interface
+ */
+void
+BlackBoardNotifier::notify_observers(PatternIndex<BBioList *> &index,
+                                     bool                      created,
+                                     const char *              type,
+                                     const char *              id)
+{
+	std::vector<PatternIndex<BBioList *>::Match> matches;
+	index.find(type, matches);
+	if (matches.size() > 1) {
+		std::sort(matches.begin(),
+		          matches.end(),
+		          [](const PatternIndex<BBioList *>::Match &a,
+		             const PatternIndex<BBioList *>::Match &b) { return *a.first < *b.first; });
+	}
+
+	for (auto &m : matches) {
+		for (BBioListIterator i = m.second->begin(); i != m.second->end(); ++i) {
+			BlackBoardInterfaceObserver *bbio = i->first;
+			for (std::list<std::string>::iterator pi = i->second.begin(); pi != i->second.end(); ++pi) {
+				if (PatternIndex<BBioList *>::matches(*pi, id)) {
+					if (created) {
+						bbio->bb_interface_created(type, id);
+					} else {
+						bbio->bb_interface_destroyed(type, id);
+					}
+					break;
+				}
+			}
+		}
+	}
+}
+
 /** Unregister BB interface observer.
  * This will remove the given BlackBoard event listener from any event that it was
  * previously registered for.
@@ -390,9 +459,40 @@ BlackBoardNotifier::unregister_observer(BlackBoardInterfaceObserver *observer)
 	} else {
 		remove_observer(bbio_created_, observer);
 		remove_observer(bbio_destroyed_, observer);
+		index_observers(bbio_created_, bbio_created_index_);
+		index_observers(bbio_destroyed_, bbio_destroyed_index_);
 	}
 }
 
+/** Get usage statistics of registered listeners.
+ * @return statistics of all listeners registered for data or message events
+ */
+std::list<BlackBoard::ListenerStats>
+BlackBoardNotifier::listener_stats()
+{
+	// keep both maps locked so that no listener can be unregistered
+	MutexLocker data_lock(bbil_data_mutex_);
+	MutexLocker messages_lock(bbil_messages_mutex_);
+
+	std::set<BlackBoardInterfaceListener *> listeners;
+	for (const auto &l : bbil_data_) {
+		listeners.insert(l.second);
+	}
+	for (const auto &l : bbil_messages_) {
+		listeners.insert(l.second);
+	}
+
+	std::list<BlackBoard::ListenerStats> rv;
+	for (BlackBoardInterfaceListener *bbil : listeners) {
+		BlackBoard::ListenerStats s;
+		s.name          = bbil->bbil_name();
+		s.num_events    = bbil->bbil_num_events();
+		s.dispatch_nsec = bbil->bbil_dispatch_nsec();
+		rv.push_back(s);
+	}
+	return rv;
+}
+
 /** Notify that an interface has been created.
  * @param type type of the interface
  * @param id ID of the interface
@@ -404,23 +504,7 @@ BlackBoardNotifier::notify_of_interface_created(const char *type, const char *id
 	bbio_events_ += 1;
 	bbio_mutex_->unlock();
 
-	BBioMapIterator  lhmi;
-	BBioListIterator i, l;
-	for (lhmi = bbio_created_.begin(); lhmi != bbio_created_.end(); ++lhmi) {
-		if (fnmatch(lhmi->first.c_str(), type, 0) != 0)
-			continue;
-
-		BBioList &list = lhmi->second;
-		for (i = list.begin(); i != list.end(); ++i) {
-			BlackBoardInterfaceObserver *bbio = i->first;
-			for (std::list<std::string>::iterator pi = i->second.begin(); pi != i->second.end(); ++pi) {
-				if (fnmatch(pi->c_str(), id, 0) == 0) {
-					bbio->bb_interface_created(type, id);
-					break;
-				}
-			}
-		}
-	}
+	notify_observers(bbio_created_index_, /* created */ true, type, id);
 
 	bbio_mutex_->lock();
 	bbio_events_ -= 1;
@@ -439,23 +523,7 @@ BlackBoardNotifier::notify_of_interface_destroyed(const char *type, const char *
 	bbio_events_ += 1;
 	bbio_mutex_->unlock();
 
-	BBioMapIterator  lhmi;
-	BBioListIterator i, l;
-	for (lhmi = bbio_destroyed_.begin(); lhmi != bbio_destroyed_.end(); ++lhmi) {
-		if (fnmatch(lhmi->first.c_str(), type, 0) != 0)
-			continue;
-
-		BBioList &list = (*lhmi).second;
-		for (i = list.begin(); i != list.end(); ++i) {
-			BlackBoardInterfaceObserver *bbio = i->first;
-			for (std::list<std::string>::iterator pi = i->second.begin(); pi != i->second.end(); ++pi) {
-				if (fnmatch(pi->c_str(), id, 0) == 0) {
-					bbio->bb_interface_destroyed(type, id);
-					break;
-				}
-			}
-		}
-	}
+	notify_observers(bbio_destroyed_index_, /* created */ false, type, id);
 
 	bbio_mutex_->lock();
 	bbio_events_ -= 1;
@@ -481,6 +549,8 @@ BlackBoardNotifier::process_bbio_queue()
 				}
 				bbio_queue_.pop_front();
 			}
+			index_observers(bbio_created_, bbio_created_index_);
+			index_observers(bbio_destroyed_, bbio_destroyed_index_);
 		}
 	}
 }
@@ -504,6 +574,13 @@ BlackBoardNotifier::notify_of_writer_added(const Interface *interface,
 	for (BBilMap::iterator j = ret.first; j != ret.second; ++j) {
 		BlackBoardInterfaceListener *bbil = j->second;
 		if (!is_in_queue(/* remove op*/ false, bbil_writer_queue_, uid, bbil)) {
+			if (bbil->bbil_async_queue_) {
+				dispatcher_->push_event(bbil,
+				                        BlackBoardListenerEventQueue::WRITER_ADDED,
+				                        uid,
+				                        event_instance_serial);
+				continue;
+			}
 			Interface *bbil_iface = bbil->bbil_writer_interface(uid);
 			if (bbil_iface != NULL) {
 				bbil->bb_interface_writer_added(bbil_iface, event_instance_serial);
@@ -541,6 +618,13 @@ BlackBoardNotifier::notify_of_writer_removed(const Interface *interface,
 	for (BBilMap::iterator j = ret.first; j != ret.second; ++j) {
 		BlackBoardInterfaceListener *bbil = j->second;
 		if (!is_in_queue(/* remove op*/ false, bbil_data_queue_, uid, bbil)) {
+			if (bbil->bbil_async_queue_) {
+				dispatcher_->push_event(bbil,
+				                        BlackBoardListenerEventQueue::WRITER_REMOVED,
+				                        uid,
+				                        event_instance_serial);
+				continue;
+			}
 			Interface *bbil_iface = bbil->bbil_writer_interface(uid);
 			if (bbil_iface != NULL) {
 				bbil->bb_interface_writer_removed(bbil_iface, event_instance_serial);
@@ -598,6 +682,13 @@ BlackBoardNotifier::notify_of_reader_added(const Interface *interface,
 	for (BBilMap::iterator j = ret.first; j != ret.second; ++j) {
 		BlackBoardInterfaceListener *bbil = j->second;
 		if (!is_in_queue(/* remove op*/ false, bbil_reader_queue_, uid, bbil)) {
+			if (bbil->bbil_async_queue_) {
+				dispatcher_->push_event(bbil,
+				                        BlackBoardListenerEventQueue::READER_ADDED,
+				                        uid,
+				                        event_instance_serial);
+				continue;
+			}
 			Interface *bbil_iface = bbil->bbil_reader_interface(uid);
 			if (bbil_iface != NULL) {
 				bbil->bb_interface_reader_added(bbil_iface, event_instance_serial);
@@ -635,6 +726,13 @@ BlackBoardNotifier::notify_of_reader_removed(const Interface *interface,
 	for (BBilMap::iterator j = ret.first; j != ret.second; ++j) {
 		BlackBoardInterfaceListener *bbil = j->second;
 		if (!is_in_queue(/* remove op*/ false, bbil_data_queue_, uid, bbil)) {
+			if (bbil->bbil_async_queue_) {
+				dispatcher_->push_event(bbil,
+				                        BlackBoardListenerEventQueue::READER_REMOVED,
+				                        uid,
+				                        event_instance_serial);
+				continue;
+			}
 			Interface *bbil_iface = bbil->bbil_reader_interface(uid);
 			if (bbil_iface != NULL) {
 				bbil->bb_interface_reader_removed(bbil_iface, event_instance_serial);
@@ -697,11 +795,17 @@ BlackBoardNotifier::notify_of_data_refresh(const Interface *interface, bool has_
 	for (BBilMap::iterator j = ret.first; j != ret.second; ++j) {
 		BlackBoardInterfaceListener *bbil = j->second;
 		if (!is_in_queue(/* remove op*/ false, bbil_data_queue_, uid, bbil)) {
+			if (bbil->bbil_async_queue_) {
+				dispatcher_->push_data(bbil, uid, has_changed);
+				continue;
+			}
 			Interface *bbil_iface = bbil->bbil_data_interface(uid);
 			if (bbil_iface != NULL) {
+				uint64_t start_nsec = Interface::stats_enabled() ? interface_stats_clock_nsec() : 0;
 				bbil->bb_interface_data_refreshed(bbil_iface);
 				if (has_changed)
 					bbil->bb_interface_data_changed(bbil_iface);
+				bbil->bbil_count_event(start_nsec);
 			} else {
 				LibLogger::log_warn("BlackBoardNotifier",
 				                    "BBIL[%s] registered for data change events "
@@ -754,9 +858,15 @@ BlackBoardNotifier::notify_of_message_received(const Interface *interface, Messa
 	for (BBilMap::iterator j = ret.first; j != ret.second; ++j) {
 		BlackBoardInterfaceListener *bbil = j->second;
 		if (!is_in_queue(/* remove op*/ false, bbil_messages_queue_, uid, bbil)) {
+			if (bbil->bbil_async_queue_) {
+				dispatcher_->push_message(bbil, uid, message);
+				continue;
+			}
 			Interface *bbil_iface = bbil->bbil_message_interface(uid);
 			if (bbil_iface != NULL) {
-				bool abort = !bbil->bb_interface_message_received(bbil_iface, message);
+				uint64_t start_nsec = Interface::stats_enabled() ? interface_stats_clock_nsec() : 0;
+				bool     abort      = !bbil->bb_interface_message_received(bbil_iface, message);
+				bbil->bbil_count_event(start_nsec);
 				if (abort) {
 					enqueue = false;
 					break;
@@ -27,6 +27,7 @@
 #include <blackboard/blackboard.h>
 #include <blackboard/interface_listener.h>
 #include <blackboard/interface_observer.h>
+#include <blackboard/internal/pattern_index.h>
 #include <core/utils/rwlock_map.h>
 #include <utils/uuid.h>
 
@@ -39,6 +40,7 @@ namespace fawkes {
 class Interface;
 class Message;
 class Mutex;
+class BlackBoardListenerDispatcher;
 
 class BlackBoardNotifier
 {
@@ -55,6 +57,8 @@ public:
 	void register_observer(BlackBoardInterfaceObserver *observer);
 	void unregister_observer(BlackBoardInterfaceObserver *observer);
 
+	std::list<BlackBoard::ListenerStats> listener_stats();
+
 	void notify_of_data_refresh(const Interface *interface, bool has_changed);
 	bool notify_of_message_received(const Interface *interface, Message *message);
 	void notify_of_interface_created(const char *type, const char *id) noexcept;
@@ -111,6 +115,11 @@ private:
 	                  BBioMap &                                              bbiomap);
 
 	void remove_observer(BBioMap &iomap, BlackBoardInterfaceObserver *observer);
+	void index_observers(BBioMap &iomap, PatternIndex<BBioList *> &index);
+	void notify_observers(PatternIndex<BBioList *> &index,
+	                      bool                      created,
+	                      const char *              type,
+	                      const char *              id);
 
 	void process_writer_queue();
 	void process_reader_queue();
@@ -146,9 +155,14 @@ private:
 	BBioMap bbio_created_;
 	BBioMap bbio_destroyed_;
 
+	PatternIndex<BBioList *> bbio_created_index_;
+	PatternIndex<BBioList *> bbio_destroyed_index_;
+
 	Mutex *      bbio_mutex_;
 	unsigned int bbio_events_;
 	BBioQueue    bbio_queue_;
+
+	BlackBoardListenerDispatcher *dispatcher_;
 };
 
 } // end namespace fawkes
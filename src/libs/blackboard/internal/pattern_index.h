@@ -0,0 +1,142 @@
+
+/***************************************************************************
+ *  pattern_index.h - Index of shell wildcard patterns
+ *
+ *  Created: Wed Oct 14 18:23:03 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_PATTERN_INDEX_H_
+#define _BLACKBOARD_PATTERN_INDEX_H_
+
+#include <cstring>
+#include <fnmatch.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fawkes {
+
+/** @class PatternIndex <blackboard/internal/pattern_index.h>
+ * Index of shell wildcard patterns.
+ * Maps patterns as understood by fnmatch(3) to values and allows to
+ * find all values whose pattern matches a given string without testing
+ * every single pattern. Patterns are classified on insertion:
+ * - literal patterns without any wildcard are stored in a hash map,
+ * - prefix patterns with a single trailing asterisk (like "Laser*" or
+ *   "*") are stored in hash maps per prefix length,
+ * - all other patterns are kept in a list and tested with fnmatch().
+ * Matching therefore costs one hash lookup for literals, one per
+ * distinct prefix length, and one fnmatch() per complex pattern.
+ */
+template <typename ValueT>
+class PatternIndex
+{
+public:
+	/** Type of a single match. */
+	typedef std::pair<const std::string *, ValueT> Match;
+
+	/** Remove all patterns. */
+	void
+	clear()
+	{
+		exact_.clear();
+		prefix_.clear();
+		complex_.clear();
+	}
+
+	/** Add pattern.
+	 * @param pattern shell wildcard pattern
+	 * @param value value to return for strings matching the pattern
+	 */
+	void
+	insert(const std::string &pattern, ValueT value)
+	{
+		std::string::size_type wc = pattern.find_first_of("*?[\\");
+		if (wc == std::string::npos) {
+			exact_[pattern] = Entry(pattern, value);
+		} else if (wc == pattern.length() - 1 && pattern[wc] == '*') {
+			prefix_[wc][pattern.substr(0, wc)] = Entry(pattern, value);
+		} else {
+			complex_.push_back(Entry(pattern, value));
+		}
+	}
+
+	/** Find values of all patterns matching a string.
+	 * @param s string to match
+	 * @param matches upon return contains the pattern and value of each
+	 * matching pattern, in no particular order
+	 */
+	void
+	find(const char *s, std::vector<Match> &matches) const
+	{
+		size_t                                        len = strlen(s);
+		typename std::unordered_map<std::string, Entry>::const_iterator e;
+
+		if ((e = exact_.find(s)) != exact_.end()) {
+			matches.push_back(Match(&e->second.first, e->second.second));
+		}
+		for (const auto &p : prefix_) {
+			if (p.first > len)
+				break;
+			if ((e = p.second.find(std::string(s, p.first))) != p.second.end()) {
+				matches.push_back(Match(&e->second.first, e->second.second));
+			}
+		}
+		for (const auto &c : complex_) {
+			if (fnmatch(c.first.c_str(), s, 0) == 0) {
+				matches.push_back(Match(&c.first, c.second));
+			}
+		}
+	}
+
+	/** Match a single pattern.
+	 * Equivalent to fnmatch(pattern, s, 0) == 0, but avoids calling
+	 * fnmatch() for the common cases of literal and prefix patterns.
+	 * @param pattern shell wildcard pattern
+	 * @param s string to match
+	 * @return true if @p s matches @p pattern, false otherwise
+	 */
+	static bool
+	matches(const std::string &pattern, const char *s)
+	{
+		std::string::size_type wc = pattern.find_first_of("*?[\\");
+		if (wc == std::string::npos) {
+			return pattern == s;
+		} else if (wc == pattern.length() - 1 && pattern[wc] == '*') {
+			return strncmp(pattern.c_str(), s, wc) == 0;
+		} else {
+			return fnmatch(pattern.c_str(), s, 0) == 0;
+		}
+	}
+
+private:
+	/// @cond INTERNALS
+	typedef std::pair<std::string, ValueT> Entry;
+	/// @endcond
+
+	std::unordered_map<std::string, Entry>                    exact_;
+	std::map<size_t, std::unordered_map<std::string, Entry>> prefix_;
+	std::vector<Entry>                                        complex_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -54,7 +54,7 @@ namespace fawkes {
  */
 LocalBlackBoard::LocalBlackBoard(size_t memsize, const char *magic_token, bool master)
 {
-	memmgr_ = new BlackBoardMemoryManager(memsize, BLACKBOARD_VERSION, master);
+	memmgr_ = new BlackBoardMemoryManager(memsize, BLACKBOARD_VERSION, master, magic_token);
 
 	msgmgr_ = new BlackBoardMessageManager(notifier_);
 	im_     = new BlackBoardInterfaceManager(memmgr_, msgmgr_, notifier_);
@@ -124,6 +124,14 @@ LocalBlackBoard::open_multiple_for_reading(const char *type_pattern,
 	}
 }
 
+std::list<Interface *>
+LocalBlackBoard::open_all_for_reading(
+  const std::list<std::pair<std::string, std::string>> &interfaces,
+  const char *                                          owner)
+{
+	return im_->open_all_for_reading(interfaces, owner);
+}
+
 void
 LocalBlackBoard::close(Interface *interface)
 {
@@ -186,6 +194,57 @@ LocalBlackBoard::memory_manager() const
 	return memmgr_;
 }
 
+/** Get shared memory offset of interface.
+ * Other processes on the same host can attach to the segment identified
+ * by BlackBoardMemoryManager::shmem_token() and find the interface's
+ * memory chunk at this offset.
+ * @param interface interface opened from this BlackBoard
+ * @param offset upon successful return the offset of the interface's
+ * memory chunk from the start of the shared memory data segment
+ * @return true if the BlackBoard is kept in shared memory, false otherwise
+ */
+bool
+LocalBlackBoard::shmem_offset(const Interface *interface, size_t &offset) const
+{
+	return im_->shmem_offset(interface, offset);
+}
+
+/** Enable or disable size-class memory allocation.
+ * With size classes enabled, memory of closed interfaces is kept for
+ * re-use by interfaces of similar size instead of being merged into the
+ * free memory. This is beneficial if interfaces are opened and closed
+ * frequently, for example when reloading plugins.
+ * @param enabled true to use size classes, false to use best fit allocation
+ * @see BlackBoardMemoryManager::set_allocation_strategy()
+ */
+void
+LocalBlackBoard::set_size_class_allocation(bool enabled)
+{
+	memmgr_->set_allocation_strategy(enabled ? BlackBoardMemoryManager::ALLOC_SIZE_CLASSES
+	                                         : BlackBoardMemoryManager::ALLOC_BEST_FIT);
+}
+
+/** Advise huge pages for the BlackBoard memory.
+ * @return true if the advice was accepted, false otherwise
+ * @see BlackBoardMemoryManager::advise_huge_pages()
+ */
+bool
+LocalBlackBoard::advise_huge_pages()
+{
+	return memmgr_->advise_huge_pages();
+}
+
+/** Bind the BlackBoard memory to a NUMA node.
+ * @param node NUMA node, or one of the special values of MemoryPlacement
+ * @return true if the memory has been bound, false otherwise
+ * @see BlackBoardMemoryManager::bind_numa_node()
+ */
+bool
+LocalBlackBoard::bind_numa_node(int node)
+{
+	return memmgr_->bind_numa_node(node);
+}
+
 /** Start network handler.
  * This will start the network handler thread and register it with the given hub.
  * @param hub hub to use and to register with
@@ -62,11 +62,20 @@ public:
 	virtual std::list<Interface *> open_multiple_for_reading(const char *type_pattern,
 	                                                         const char *id_pattern = "*",
 	                                                         const char *owner      = NULL);
+	virtual std::list<Interface *>
+	open_all_for_reading(const std::list<std::pair<std::string, std::string>> &interfaces,
+	                     const char *                                          owner = NULL);
 
 	virtual void start_nethandler(FawkesNetworkHub *hub);
 
 	static void cleanup(const char *magic_token, bool use_lister = false);
 
+	void set_size_class_allocation(bool enabled);
+	bool advise_huge_pages();
+	bool bind_numa_node(int node);
+
+	bool shmem_offset(const Interface *interface, size_t &offset) const;
+
 	/* for debugging only */
 	const BlackBoardMemoryManager *memory_manager() const;
 
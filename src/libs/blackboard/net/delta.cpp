@@ -0,0 +1,144 @@
+
+/***************************************************************************
+ *  delta.cpp - BlackBoard network data delta encoding
+ *
+ *  Created: Wed Oct 14 18:28:59 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <arpa/inet.h>
+#include <blackboard/net/delta.h>
+#include <blackboard/net/messages.h>
+
+#include <cstring>
+
+namespace fawkes {
+
+/** Encode difference of two data chunks.
+ * Produces a sequence of runs as described for bb_idelta_msg_t. Unchanged
+ * gaps shorter than a run header are merged into the surrounding runs.
+ * @param base data the receiver currently has
+ * @param data current data to transmit
+ * @param data_size size in bytes of @p base and @p data
+ * @param delta buffer to write the encoded delta to
+ * @param max_delta_size size of @p delta in bytes
+ * @param delta_size upon successful return contains the number of bytes
+ * written to @p delta, zero if the data is unchanged
+ * @return true if the delta fit into @p delta, false otherwise, in which
+ * case a full update should be sent instead
+ */
+bool
+blackboard_delta_encode(const void *base,
+                        const void *data,
+                        size_t      data_size,
+                        void *      delta,
+                        size_t      max_delta_size,
+                        size_t &    delta_size)
+{
+	const unsigned char *b   = (const unsigned char *)base;
+	const unsigned char *d   = (const unsigned char *)data;
+	unsigned char *      out = (unsigned char *)delta;
+	size_t               o   = 0;
+	size_t               pos = 0; // first byte not yet covered by a run
+	size_t               i   = 0;
+
+	while (i < data_size) {
+		// skip unchanged bytes, word-wise where possible
+		while (i + sizeof(unsigned long) <= data_size
+		       && memcmp(b + i, d + i, sizeof(unsigned long)) == 0) {
+			i += sizeof(unsigned long);
+		}
+		while (i < data_size && b[i] == d[i])
+			++i;
+		if (i == data_size)
+			break;
+
+		// find end of run, bridging gaps shorter than a run header
+		size_t end = i + 1;
+		size_t gap = 0;
+		while (end + gap < data_size && gap < sizeof(bb_idelta_run_t)) {
+			if (b[end + gap] != d[end + gap]) {
+				end += gap + 1;
+				gap = 0;
+			} else {
+				++gap;
+			}
+		}
+
+		size_t length = end - i;
+		if (o + sizeof(bb_idelta_run_t) + length > max_delta_size)
+			return false;
+
+		bb_idelta_run_t run;
+		run.skip   = htonl(i - pos);
+		run.length = htonl(length);
+		memcpy(out + o, &run, sizeof(bb_idelta_run_t));
+		o += sizeof(bb_idelta_run_t);
+		for (size_t k = i; k < end; ++k) {
+			out[o++] = b[k] ^ d[k];
+		}
+		pos = i = end;
+	}
+
+	delta_size = o;
+	return true;
+}
+
+/** Apply delta to data chunk.
+ * The delta is validated completely before @p data is modified.
+ * @param data data to update in place
+ * @param data_size size in bytes of @p data
+ * @param delta delta as produced by blackboard_delta_encode()
+ * @param delta_size size in bytes of @p delta
+ * @return true if the delta has been applied, false if it was malformed
+ * and @p data has not been touched
+ */
+bool
+blackboard_delta_apply(void *data, size_t data_size, const void *delta, size_t delta_size)
+{
+	unsigned char *      d  = (unsigned char *)data;
+	const unsigned char *in = (const unsigned char *)delta;
+
+	for (int pass = 0; pass < 2; ++pass) {
+		size_t o = 0, pos = 0;
+		while (o < delta_size) {
+			bb_idelta_run_t run;
+			if (delta_size - o < sizeof(bb_idelta_run_t))
+				return false;
+			memcpy(&run, in + o, sizeof(bb_idelta_run_t));
+			o += sizeof(bb_idelta_run_t);
+
+			size_t skip   = ntohl(run.skip);
+			size_t length = ntohl(run.length);
+			if (skip > data_size - pos || length > data_size - pos - skip || length > delta_size - o) {
+				return false;
+			}
+			pos += skip;
+			if (pass == 1) {
+				for (size_t k = 0; k < length; ++k) {
+					d[pos + k] ^= in[o + k];
+				}
+			}
+			pos += length;
+			o += length;
+		}
+	}
+	return true;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,42 @@
+
+/***************************************************************************
+ *  delta.h - BlackBoard network data delta encoding
+ *
+ *  Created: Wed Oct 14 18:28:59 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_NET_DELTA_H_
+#define _BLACKBOARD_NET_DELTA_H_
+
+#include <cstddef>
+
+namespace fawkes {
+
+bool blackboard_delta_encode(const void *base,
+                             const void *data,
+                             size_t      data_size,
+                             void *      delta,
+                             size_t      max_delta_size,
+                             size_t &    delta_size);
+
+bool blackboard_delta_apply(void *data, size_t data_size, const void *delta, size_t delta_size);
+
+} // end namespace fawkes
+
+#endif
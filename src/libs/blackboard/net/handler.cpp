@@ -24,27 +24,49 @@
 #include <arpa/inet.h>
 #include <blackboard/blackboard.h>
 #include <blackboard/exceptions.h>
+#include <blackboard/internal/memory_manager.h>
+#include <blackboard/local.h>
 #include <blackboard/net/handler.h>
 #include <blackboard/net/ilist_content.h>
 #include <blackboard/net/interface_listener.h>
 #include <blackboard/net/interface_observer.h>
 #include <blackboard/net/messages.h>
+#include <blackboard/net/shmem_info.h>
+#include <blackboard/net/update_scheduler.h>
 #include <interface/interface.h>
 #include <interface/interface_info.h>
 #include <logging/liblogger.h>
 #include <netcomm/fawkes/component_ids.h>
+#include <netcomm/fawkes/frame_cache.h>
 #include <netcomm/fawkes/hub.h>
+#include <netcomm/fawkes/message.h>
 
 #include <cstdlib>
 #include <cstring>
 
 namespace fawkes {
 
+/** Maximum age of the cached list of all interfaces in milliseconds.
+ * Bounds how outdated writer, reader and timestamp information may be for
+ * changes not caused by remote clients. */
+#define BBNH_ILIST_CACHE_MSEC 250
+
 /** @class BlackBoardNetworkHandler <blackboard/net/handler.h>
  * BlackBoard Network Handler.
  * This class provides a network handler that can be registered with the
  * FawkesServerThread to handle client requests to a BlackBoard instance.
  *
+ * The list of all interfaces is requested by every remote tool when it
+ * connects. It is therefore serialized once and kept in a frame cache,
+ * further requests share the same payload until interfaces are created,
+ * destroyed, opened or closed, or the cached list becomes too old.
+ *
+ * If the BlackBoard is a LocalBlackBoard kept in shared memory, clients
+ * may negotiate BB_FEATURE_SHMEM. Interfaces they open for reading are
+ * then announced with their location in the segment. Once a client has
+ * attached to the segment it is only notified of data updates, the data
+ * is neither read nor sent anymore.
+ *
  * @author Tim Niemueller
  */
 
@@ -58,9 +80,18 @@ BlackBoardNetworkHandler::BlackBoardNetworkHandler(BlackBoard *blackboard, Fawke
 {
 	bb_   = blackboard;
 	nhub_ = hub;
+
+	shmem_bb_ = dynamic_cast<LocalBlackBoard *>(blackboard);
+	if (shmem_bb_ && !shmem_bb_->memory_manager()->shmem_token()) {
+		shmem_bb_ = NULL;
+	}
 	nhub_->add_handler(this);
 
-	observer_ = new BlackBoardNetHandlerInterfaceObserver(blackboard, hub);
+	bytes_saved_ = 0;
+
+	ilist_cache_ = new FawkesNetworkFrameCache(BBNH_ILIST_CACHE_MSEC);
+	observer_    = new BlackBoardNetHandlerInterfaceObserver(blackboard, hub, ilist_cache_);
+	scheduler_   = new BlackBoardNetHandlerUpdateScheduler();
 }
 
 /** Destructor. */
@@ -76,6 +107,18 @@ BlackBoardNetworkHandler::~BlackBoardNetworkHandler()
 	for (iit_ = interfaces_.begin(); iit_ != interfaces_.end(); ++iit_) {
 		bb_->close(iit_->second);
 	}
+	delete scheduler_;
+	delete ilist_cache_;
+}
+
+/** Get number of bytes saved by delta encoding.
+ * @return total number of bytes not sent to clients because data updates
+ * were sent as deltas instead of full data
+ */
+uint64_t
+BlackBoardNetworkHandler::bytes_saved() const
+{
+	return __atomic_load_n(&bytes_saved_, __ATOMIC_RELAXED);
 }
 
 /** Process all network messages that have been received. */
@@ -90,15 +133,23 @@ BlackBoardNetworkHandler::loop()
 
 		switch (msg->msgid()) {
 		case MSG_BB_LIST_ALL: {
-			BlackBoardInterfaceListContent *ilist = new BlackBoardInterfaceListContent();
-			InterfaceInfoList *             infl  = bb_->list_all();
+			FawkesNetworkMessage *m = ilist_cache_->get(MSG_BB_LIST_ALL, clid);
+			if (!m) {
+				unsigned int                    generation = ilist_cache_->generation();
+				BlackBoardInterfaceListContent *ilist      = new BlackBoardInterfaceListContent();
+				InterfaceInfoList *             infl       = bb_->list_all();
+
+				for (InterfaceInfoList::iterator i = infl->begin(); i != infl->end(); ++i) {
+					ilist->append_interface(*i);
+				}
+				delete infl;
 
-			for (InterfaceInfoList::iterator i = infl->begin(); i != infl->end(); ++i) {
-				ilist->append_interface(*i);
+				m = new FawkesNetworkMessage(clid, FAWKES_CID_BLACKBOARD, MSG_BB_INTERFACE_LIST, ilist);
+				ilist_cache_->put(MSG_BB_LIST_ALL, m, generation);
 			}
 
 			try {
-				nhub_->send(clid, FAWKES_CID_BLACKBOARD, MSG_BB_INTERFACE_LIST, ilist);
+				nhub_->send(m);
 			} catch (Exception &e) {
 				LibLogger::log_error("BlackBoardNetworkHandler",
 				                     "Failed to send interface "
@@ -106,7 +157,6 @@ BlackBoardNetworkHandler::loop()
 				                     clid);
 				LibLogger::log_error("BlackBoardNetworkHandler", e);
 			}
-			delete infl;
 		} break;
 
 		case MSG_BB_LIST: {
@@ -158,6 +208,7 @@ BlackBoardNetworkHandler::loop()
 				} else {
 					iface = bb_->open_for_writing(type, id, "remote");
 				}
+				ilist_cache_->clear();
 				if (memcmp(iface->hash(), om->hash, INTERFACE_HASH_SIZE_) != 0) {
 					LibLogger::log_warn("BlackBoardNetworkHandler",
 					                    "Opening interface %s::%s failed, "
@@ -166,12 +217,27 @@ BlackBoardNetworkHandler::loop()
 					                    id);
 					send_openfailure(clid, BB_ERR_HASH_MISMATCH);
 				} else {
+					bool deltas = false;
+					bool shmem  = false;
+					client_features_.lock();
+					if (client_features_.find(clid) != client_features_.end()) {
+						deltas = (client_features_[clid] & BB_FEATURE_DATA_DELTA) != 0;
+						shmem  = (client_features_[clid] & BB_FEATURE_SHMEM) != 0;
+					}
+					client_features_.unlock();
+
 					interfaces_[iface->serial()] = iface;
 					client_interfaces_[clid].push_back(iface);
 					serial_to_clid_[iface->serial()] = clid;
-					listeners_[iface->serial()] =
-					  new BlackBoardNetHandlerInterfaceListener(bb_, iface, nhub_, clid);
-					send_opensuccess(clid, iface);
+					BlackBoardNetHandlerInterfaceListener *listener =
+					  new BlackBoardNetHandlerInterfaceListener(
+					    bb_, iface, nhub_, clid, deltas, &bytes_saved_);
+					listeners_[iface->serial()] = listener;
+					// the initial data is the first keyframe, do not let updates slip in between
+					listener->data_mutex()->lock();
+					send_opensuccess(clid, iface, shmem && !iface->is_writer());
+					listener->keyframe_sent();
+					listener->data_mutex()->unlock();
 				}
 			} catch (BlackBoardInterfaceNotFoundException &nfe) {
 				LibLogger::log_warn("BlackBoardNetworkHandler",
@@ -236,6 +302,7 @@ BlackBoardNetworkHandler::loop()
 					bb_->close(interfaces_[sm_serial]);
 					interfaces_.erase(sm_serial);
 					interfaces_.unlock();
+					ilist_cache_->clear();
 				} else {
 					LibLogger::log_warn("BlackBoardNetworkHandler",
 					                    "Client %u tried to close "
@@ -256,6 +323,58 @@ BlackBoardNetworkHandler::loop()
 			//		     client_interfaces_.size());
 		} break;
 
+		case MSG_BB_FEATURES: {
+			bb_ifeatures_msg_t *fm       = msg->msg<bb_ifeatures_msg_t>();
+			uint32_t            supported = BB_FEATURE_DATA_DELTA | (shmem_bb_ ? BB_FEATURE_SHMEM : 0);
+			uint32_t            features  = ntohl(fm->features) & supported;
+			client_features_.lock();
+			client_features_[clid] = features;
+			client_features_.unlock();
+			send_features(clid, features);
+		} break;
+
+		case MSG_BB_SUBSCRIPTION: {
+			bb_isubscription_msg_t *sm        = msg->msg<bb_isubscription_msg_t>();
+			Uuid                    sm_serial = sm->serial;
+			serial_to_clid_.lock();
+			bool owned = serial_to_clid_.find(sm_serial) != serial_to_clid_.end()
+			             && serial_to_clid_[sm_serial] == clid;
+			serial_to_clid_.unlock();
+			if (owned && listeners_.find(sm_serial) != listeners_.end()) {
+				listeners_[sm_serial]->set_update_limit(ntohl(sm->min_period_usec),
+				                                        ntohl(sm->flags) & BB_SUBSCRIPTION_LATEST_ONLY,
+				                                        scheduler_);
+			} else {
+				LibLogger::log_warn("BlackBoardNetworkHandler",
+				                    "Client %u tried to set subscription "
+				                    "for interface with serial %s which it has not opened",
+				                    clid,
+				                    sm_serial.get_string().c_str());
+			}
+		} break;
+
+		case MSG_BB_SHMEM_ATTACHED: {
+			bb_iserial_msg_t *sm        = msg->msg<bb_iserial_msg_t>();
+			Uuid              sm_serial = sm->serial;
+			serial_to_clid_.lock();
+			bool owned = serial_to_clid_.find(sm_serial) != serial_to_clid_.end()
+			             && serial_to_clid_[sm_serial] == clid;
+			serial_to_clid_.unlock();
+			if (owned && listeners_.find(sm_serial) != listeners_.end()) {
+				LibLogger::log_debug("BlackBoardNetworkHandler",
+				                     "Remote %u reads interface %s from shared memory",
+				                     clid,
+				                     interfaces_[sm_serial]->uid());
+				listeners_[sm_serial]->set_notify_only(true);
+			} else {
+				LibLogger::log_warn("BlackBoardNetworkHandler",
+				                    "Client %u attached to shared memory "
+				                    "for interface with serial %s which it has not opened",
+				                    clid,
+				                    sm_serial.get_string().c_str());
+			}
+		} break;
+
 		case MSG_BB_DATA_CHANGED:
 		case MSG_BB_DATA_REFRESHED: {
 			bool            data_changed = msg->msgid() == MSG_BB_DATA_CHANGED;
@@ -346,9 +465,17 @@ BlackBoardNetworkHandler::loop()
 }
 
 void
-BlackBoardNetworkHandler::send_opensuccess(unsigned int clid, Interface *interface)
+BlackBoardNetworkHandler::send_opensuccess(unsigned int clid, Interface *interface, bool shmem)
 {
-	void *              payload = calloc(1, sizeof(bb_iopensucc_msg_t) + interface->datasize());
+	size_t offset = 0;
+	if (shmem && !(shmem_bb_ && shmem_bb_->shmem_offset(interface, offset))) {
+		shmem = false;
+	}
+
+	size_t data_end     = sizeof(bb_iopensucc_msg_t) + interface->datasize();
+	size_t payload_size = data_end + (shmem ? sizeof(bb_ishmem_info_t) : 0);
+
+	void *              payload = calloc(1, payload_size);
 	bb_iopensucc_msg_t *osm     = (bb_iopensucc_msg_t *)payload;
 	osm->serial                 = interface->serial();
 	osm->writer_readers         = htonl(interface->num_readers());
@@ -367,12 +494,19 @@ BlackBoardNetworkHandler::send_opensuccess(unsigned int clid, Interface *interfa
 	       interface->datachunk(),
 	       interface->datasize());
 
-	FawkesNetworkMessage *omsg =
-	  new FawkesNetworkMessage(clid,
-	                           FAWKES_CID_BLACKBOARD,
-	                           MSG_BB_OPEN_SUCCESS,
-	                           payload,
-	                           sizeof(bb_iopensucc_msg_t) + interface->datasize());
+	if (shmem) {
+		const BlackBoardMemoryManager *memmgr = shmem_bb_->memory_manager();
+		bb_ishmem_info_t *             si = (bb_ishmem_info_t *)((char *)payload + data_end);
+		strncpy(si->magic_token, memmgr->shmem_token(), BB_SHMEM_MAGIC_TOKEN_SIZE - 1);
+		blackboard_host_id(si->host_id, BB_SHMEM_HOST_ID_SIZE);
+		si->shmem_id = htonl(memmgr->shmem_id());
+		si->version  = htonl(memmgr->version());
+		si->memsize  = htonl(memmgr->memory_size());
+		si->offset   = htonl(offset);
+	}
+
+	FawkesNetworkMessage *omsg = new FawkesNetworkMessage(
+	  clid, FAWKES_CID_BLACKBOARD, MSG_BB_OPEN_SUCCESS, payload, payload_size);
 	try {
 		nhub_->send(omsg);
 	} catch (Exception &e) {
@@ -403,6 +537,23 @@ BlackBoardNetworkHandler::send_openfailure(unsigned int clid, unsigned int error
 	}
 }
 
+void
+BlackBoardNetworkHandler::send_features(unsigned int clid, uint32_t features)
+{
+	bb_ifeatures_msg_t *fm = (bb_ifeatures_msg_t *)malloc(sizeof(bb_ifeatures_msg_t));
+	fm->features           = htonl(features);
+
+	try {
+		nhub_->send(clid, FAWKES_CID_BLACKBOARD, MSG_BB_FEATURES, fm, sizeof(bb_ifeatures_msg_t));
+	} catch (Exception &e) {
+		LibLogger::log_error("BlackBoardNetworkHandler",
+		                     "Failed to send features "
+		                     "to %u, exception follows",
+		                     clid);
+		LibLogger::log_error("BlackBoardNetworkHandler", e);
+	}
+}
+
 /** Handle network message.
  * The message is put into the inbound queue and processed in processAfterLoop().
  * @param msg message
@@ -451,8 +602,11 @@ BlackBoardNetworkHandler::client_disconnected(unsigned int clid)
 			bb_->close(*ciit_);
 		}
 		client_interfaces_.erase(clid);
+		ilist_cache_->clear();
 	}
 	client_interfaces_.unlock();
+
+	client_features_.erase_locked(clid);
 }
 
 } // end namespace fawkes
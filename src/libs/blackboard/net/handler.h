@@ -31,6 +31,7 @@
 #include <utils/uuid.h>
 
 #include <list>
+#include <stdint.h>
 
 namespace fawkes {
 
@@ -39,6 +40,9 @@ class BlackBoard;
 class FawkesNetworkHub;
 class BlackBoardNetHandlerInterfaceListener;
 class BlackBoardNetHandlerInterfaceObserver;
+class BlackBoardNetHandlerUpdateScheduler;
+class FawkesNetworkFrameCache;
+class LocalBlackBoard;
 
 class BlackBoardNetworkHandler : public Thread, public FawkesNetworkHandler
 {
@@ -52,6 +56,8 @@ public:
 	virtual void client_disconnected(unsigned int clid);
 	virtual void loop();
 
+	uint64_t bytes_saved() const;
+
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
 	virtual void
@@ -61,10 +67,12 @@ protected:
 	}
 
 private:
-	void send_opensuccess(unsigned int clid, Interface *interface);
+	void send_opensuccess(unsigned int clid, Interface *interface, bool shmem = false);
 	void send_openfailure(unsigned int clid, unsigned int error_code);
+	void send_features(unsigned int clid, uint32_t features);
 
 	BlackBoard *                      bb_;
+	LocalBlackBoard *                 shmem_bb_;
 	LockQueue<FawkesNetworkMessage *> inbound_queue_;
 
 	// All interfaces, key is the instance serial, value the interface
@@ -75,6 +83,8 @@ private:
 	std::map<Uuid, BlackBoardNetHandlerInterfaceListener *>::iterator lit_;
 
 	BlackBoardNetHandlerInterfaceObserver *observer_;
+	BlackBoardNetHandlerUpdateScheduler *  scheduler_;
+	FawkesNetworkFrameCache *              ilist_cache_;
 
 	// Map from instance serial to clid
 	LockMap<Uuid, unsigned int> serial_to_clid_;
@@ -83,6 +93,11 @@ private:
 	LockMap<unsigned int, std::list<Interface *>> client_interfaces_;
 	std::list<Interface *>::iterator              ciit_;
 
+	// Negotiated protocol features, key is the client ID
+	LockMap<unsigned int, uint32_t> client_features_;
+
+	uint64_t bytes_saved_;
+
 	FawkesNetworkHub *nhub_;
 };
 
@@ -23,8 +23,12 @@
 
 #include <arpa/inet.h>
 #include <blackboard/blackboard.h>
+#include <blackboard/net/delta.h>
 #include <blackboard/net/interface_listener.h>
 #include <blackboard/net/messages.h>
+#include <blackboard/net/update_scheduler.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
 #include <logging/liblogger.h>
 #include <netcomm/fawkes/component_ids.h>
@@ -37,10 +41,31 @@
 
 namespace fawkes {
 
+/** Number of deltas after which a full keyframe is sent. */
+#define BBNIL_KEYFRAME_INTERVAL 50
+/** Interval in usec to check if a latest-only update has been transmitted. */
+#define BBNIL_LATEST_ONLY_POLL_USEC 10000L
+
 /** @class BlackBoardNetHandlerInterfaceListener <blackboard/net/interface_listener.h>
  * Interface listener for network handler.
  * This class is used by the BlackBoardNetworkHandler to track interface changes and
  * send out notifications timely.
+ *
+ * If the client negotiated BB_FEATURE_DATA_DELTA, data updates are sent
+ * as XOR/run-length deltas against the data last sent to the client.
+ * Every BBNIL_KEYFRAME_INTERVAL updates, or whenever the delta would not
+ * be smaller than the data itself, a full update is sent as keyframe.
+ *
+ * The client may limit the update rate with MSG_BB_SUBSCRIPTION. Data
+ * events are then only recorded and the newest data is sent from the
+ * BlackBoardNetHandlerUpdateScheduler thread once the minimum period has
+ * passed, or, in latest-only mode, once the previous update has left the
+ * client's send queue.
+ *
+ * If the client reads the data directly from the BlackBoard's shared
+ * memory segment, it is only notified of data updates with
+ * MSG_BB_DATA_NOTIFY_REFRESHED and MSG_BB_DATA_NOTIFY_CHANGED, see
+ * set_notify_only().
  * @author Tim Niemueller
  */
 
@@ -49,13 +74,33 @@ namespace fawkes {
  * @param interface interface to care about
  * @param hub Fawkes network hub to use to send messages
  * @param clid client ID of the client which opened this interface
+ * @param send_deltas true to send delta updates, the client must have
+ * negotiated BB_FEATURE_DATA_DELTA
+ * @param bytes_saved if not NULL, the number of bytes saved by sending
+ * deltas instead of full updates is atomically added to this counter
  */
 BlackBoardNetHandlerInterfaceListener::BlackBoardNetHandlerInterfaceListener(BlackBoard *blackboard,
                                                                              Interface * interface,
                                                                              FawkesNetworkHub *hub,
-                                                                             unsigned int      clid)
+                                                                             unsigned int      clid,
+                                                                             bool      send_deltas,
+                                                                             uint64_t *bytes_saved)
 : BlackBoardInterfaceListener("NetIL/%s", interface->uid())
 {
+	data_mutex_  = new Mutex();
+	send_deltas_ = send_deltas;
+	notify_only_ = false;
+	delta_base_  = NULL;
+	delta_seq_   = 0;
+	bytes_saved_ = bytes_saved;
+
+	scheduler_       = NULL;
+	min_period_usec_ = 0;
+	latest_only_     = false;
+	pending_         = false;
+	pending_changed_ = false;
+	last_msg_        = NULL;
+
 	bbil_add_data_interface(interface);
 	bbil_add_reader_interface(interface);
 	bbil_add_writer_interface(interface);
@@ -75,23 +120,171 @@ BlackBoardNetHandlerInterfaceListener::BlackBoardNetHandlerInterfaceListener(Bla
 BlackBoardNetHandlerInterfaceListener::~BlackBoardNetHandlerInterfaceListener()
 {
 	blackboard_->unregister_listener(this);
+	if (scheduler_)
+		scheduler_->remove(this);
+	if (last_msg_)
+		last_msg_->unref();
+	free(delta_base_);
+	delete data_mutex_;
+}
+
+/** Get data mutex.
+ * The mutex is locked while data updates are sent. Lock it while sending
+ * the initial data with the open success message and call keyframe_sent()
+ * afterwards, so that no update is sent in between.
+ * @return data mutex
+ */
+Mutex *
+BlackBoardNetHandlerInterfaceListener::data_mutex() const
+{
+	return data_mutex_;
 }
 
+/** Note that the current data chunk has been sent as a full update.
+ * Following deltas are encoded against this data. The data mutex must be
+ * locked.
+ */
 void
-BlackBoardNetHandlerInterfaceListener::bb_interface_data_refreshed(Interface *interface) noexcept
+BlackBoardNetHandlerInterfaceListener::keyframe_sent()
 {
-	// send out data refreshed notification
-	interface->read();
+	if (!send_deltas_)
+		return;
+	if (!delta_base_) {
+		delta_base_ = (char *)malloc(interface_->datasize());
+	}
+	memcpy(delta_base_, interface_->datachunk(), interface_->datasize());
+	delta_seq_ = 0;
+}
+
+/** Limit the rate of data updates.
+ * @param min_period_usec minimum time in microseconds between two data
+ * updates, zero for no time limit
+ * @param latest_only if true, do not send another update while the
+ * previous one is still queued for transmission
+ * @param scheduler scheduler to send deferred updates, must outlive this
+ * listener
+ */
+void
+BlackBoardNetHandlerInterfaceListener::set_update_limit(long int min_period_usec,
+                                                        bool     latest_only,
+                                                        BlackBoardNetHandlerUpdateScheduler *scheduler)
+{
+	MutexLocker lock(data_mutex_);
+	min_period_usec_ = min_period_usec;
+	latest_only_     = latest_only;
+	scheduler_       = scheduler;
+	if (!latest_only_ && last_msg_) {
+		last_msg_->unref();
+		last_msg_ = NULL;
+	}
+	if (pending_) {
+		scheduler_->schedule(this);
+	}
+}
+
+/** Send pending update if due.
+ * Called by the BlackBoardNetHandlerUpdateScheduler.
+ * @param now current time
+ * @param due upon return, if an update is still pending, the time when
+ * to try again
+ * @return true if an update is still pending, false otherwise
+ */
+bool
+BlackBoardNetHandlerInterfaceListener::flush(const Time &now, Time &due)
+{
+	MutexLocker lock(data_mutex_);
+	if (!pending_)
+		return false;
+	if (throttled(now, due))
+		return true;
+
+	pending_ = false;
+	transmit_data(pending_changed_);
+	pending_changed_ = false;
+	return false;
+}
+
+/** Only notify of data updates.
+ * Enable this once the client has attached to the shared memory segment
+ * of the BlackBoard and reads the data from there. Data updates are then
+ * no longer read and sent, but the client is only notified, subject to
+ * the same update limits.
+ * @param notify_only true to only send notifications, false to send data
+ */
+void
+BlackBoardNetHandlerInterfaceListener::set_notify_only(bool notify_only)
+{
+	MutexLocker lock(data_mutex_);
+	notify_only_ = notify_only;
+	if (!notify_only_) {
+		// the client's data is unknown, start over with a keyframe
+		free(delta_base_);
+		delta_base_ = NULL;
+	}
+}
 
-	size_t          payload_size = sizeof(bb_idata_msg_t) + interface->datasize();
+bool
+BlackBoardNetHandlerInterfaceListener::throttled(const Time &now, Time &due) const
+{
+	if (now < next_send_) {
+		due = next_send_;
+		return true;
+	}
+	if (latest_only_ && last_msg_ && last_msg_->refcount() > 1) {
+		due = now + BBNIL_LATEST_ONLY_POLL_USEC;
+		return true;
+	}
+	return false;
+}
+
+void
+BlackBoardNetHandlerInterfaceListener::send_data(bool changed)
+{
+	MutexLocker lock(data_mutex_);
+	if (min_period_usec_ > 0 || latest_only_) {
+		// coalesce, the scheduler sends the newest data when due
+		pending_ = true;
+		pending_changed_ |= changed;
+		scheduler_->schedule(this);
+		return;
+	}
+	transmit_data(changed);
+}
+
+void
+BlackBoardNetHandlerInterfaceListener::transmit_data(bool changed)
+{
+	if (notify_only_) {
+		bb_iserial_msg_t *sm = (bb_iserial_msg_t *)malloc(sizeof(bb_iserial_msg_t));
+		sm->serial           = interface_->serial();
+		try {
+			transmit(changed ? MSG_BB_DATA_NOTIFY_CHANGED : MSG_BB_DATA_NOTIFY_REFRESHED,
+			         sm,
+			         sizeof(bb_iserial_msg_t));
+		} catch (Exception &e) {
+			LibLogger::log_warn(bbil_name(), "Failed to send BlackBoard data notification");
+			LibLogger::log_warn(bbil_name(), e);
+		}
+		return;
+	}
+
+	interface_->read();
+
+	if (send_deltas_ && delta_base_ && delta_seq_ + 1 < BBNIL_KEYFRAME_INTERVAL
+	    && transmit_delta(changed)) {
+		return;
+	}
+
+	size_t          payload_size = sizeof(bb_idata_msg_t) + interface_->datasize();
 	void *          payload      = malloc(payload_size);
 	bb_idata_msg_t *dm           = (bb_idata_msg_t *)payload;
-	dm->serial                   = interface->serial();
-	dm->data_size                = htonl(interface->datasize());
-	memcpy((char *)payload + sizeof(bb_idata_msg_t), interface->datachunk(), interface->datasize());
+	dm->serial                   = interface_->serial();
+	dm->data_size                = htonl(interface_->datasize());
+	memcpy((char *)payload + sizeof(bb_idata_msg_t), interface_->datachunk(), interface_->datasize());
 
 	try {
-		fnh_->send(clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DATA_REFRESHED, payload, payload_size);
+		transmit(changed ? MSG_BB_DATA_CHANGED : MSG_BB_DATA_REFRESHED, payload, payload_size);
+		keyframe_sent();
 	} catch (Exception &e) {
 		LibLogger::log_warn(bbil_name(), "Failed to send BlackBoard data, exception follows");
 		LibLogger::log_warn(bbil_name(), e);
@@ -99,24 +292,81 @@ BlackBoardNetHandlerInterfaceListener::bb_interface_data_refreshed(Interface *in
 }
 
 void
-BlackBoardNetHandlerInterfaceListener::bb_interface_data_changed(Interface *interface) noexcept
+BlackBoardNetHandlerInterfaceListener::transmit(unsigned int msg_id,
+                                                void *       payload,
+                                                size_t       payload_size)
 {
-	// send out data changed notification
-	interface->read();
+	FawkesNetworkMessage *m =
+	  new FawkesNetworkMessage(clid_, FAWKES_CID_BLACKBOARD, msg_id, payload, payload_size);
+	if (latest_only_) {
+		// keep a reference to see when it has been transmitted
+		if (last_msg_)
+			last_msg_->unref();
+		m->ref();
+		last_msg_ = m;
+	}
+	if (min_period_usec_ > 0) {
+		next_send_.stamp();
+		next_send_ += min_period_usec_;
+	}
+	fnh_->send(m);
+}
 
-	size_t          payload_size = sizeof(bb_idata_msg_t) + interface->datasize();
-	void *          payload      = malloc(payload_size);
-	bb_idata_msg_t *dm           = (bb_idata_msg_t *)payload;
-	dm->serial                   = interface->serial();
-	dm->data_size                = htonl(interface->datasize());
-	memcpy((char *)payload + sizeof(bb_idata_msg_t), interface->datachunk(), interface->datasize());
+bool
+BlackBoardNetHandlerInterfaceListener::transmit_delta(bool changed)
+{
+	size_t full_size    = sizeof(bb_idata_msg_t) + interface_->datasize();
+	void * payload      = malloc(full_size);
+	size_t max_delta    = full_size - sizeof(bb_idelta_msg_t);
+	size_t delta_size   = 0;
+	bool   delta_fits   = full_size > sizeof(bb_idelta_msg_t)
+	                    && blackboard_delta_encode(delta_base_,
+	                                               interface_->datachunk(),
+	                                               interface_->datasize(),
+	                                               (char *)payload + sizeof(bb_idelta_msg_t),
+	                                               max_delta,
+	                                               delta_size);
+	size_t payload_size = sizeof(bb_idelta_msg_t) + delta_size;
+
+	if (!delta_fits || payload_size >= full_size) {
+		free(payload);
+		return false;
+	}
+
+	bb_idelta_msg_t *dm = (bb_idelta_msg_t *)payload;
+	dm->serial          = interface_->serial();
+	dm->data_size       = htonl(interface_->datasize());
+	dm->delta_size      = htonl(delta_size);
+	dm->seq             = htonl(delta_seq_ + 1);
 
 	try {
-		fnh_->send(clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DATA_CHANGED, payload, payload_size);
+		transmit(changed ? MSG_BB_DATA_DELTA_CHANGED : MSG_BB_DATA_DELTA_REFRESHED,
+		         payload,
+		         payload_size);
+		memcpy(delta_base_, interface_->datachunk(), interface_->datasize());
+		delta_seq_ += 1;
+		if (bytes_saved_) {
+			__atomic_add_fetch(bytes_saved_, full_size - payload_size, __ATOMIC_RELAXED);
+		}
 	} catch (Exception &e) {
-		LibLogger::log_warn(bbil_name(), "Failed to send BlackBoard data, exception follows");
+		LibLogger::log_warn(bbil_name(), "Failed to send BlackBoard data delta, exception follows");
 		LibLogger::log_warn(bbil_name(), e);
 	}
+	return true;
+}
+
+void
+BlackBoardNetHandlerInterfaceListener::bb_interface_data_refreshed(Interface *interface) noexcept
+{
+	// send out data refreshed notification
+	send_data(/* changed */ false);
+}
+
+void
+BlackBoardNetHandlerInterfaceListener::bb_interface_data_changed(Interface *interface) noexcept
+{
+	// send out data changed notification
+	send_data(/* changed */ true);
 }
 
 bool
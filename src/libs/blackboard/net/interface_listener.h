@@ -25,11 +25,17 @@
 #define _BLACKBOARD_NET_INTERFACE_LISTENER_H_
 
 #include <blackboard/interface_listener.h>
+#include <utils/time/time.h>
+
+#include <stdint.h>
 
 namespace fawkes {
 
 class FawkesNetworkHub;
 class BlackBoard;
+class Mutex;
+class FawkesNetworkMessage;
+class BlackBoardNetHandlerUpdateScheduler;
 
 class BlackBoardNetHandlerInterfaceListener : public BlackBoardInterfaceListener
 {
@@ -37,9 +43,20 @@ public:
 	BlackBoardNetHandlerInterfaceListener(BlackBoard *      blackboard,
 	                                      Interface *       interface,
 	                                      FawkesNetworkHub *hub,
-	                                      unsigned int      clid);
+	                                      unsigned int      clid,
+	                                      bool              send_deltas = false,
+	                                      uint64_t *        bytes_saved = NULL);
 	virtual ~BlackBoardNetHandlerInterfaceListener();
 
+	Mutex *data_mutex() const;
+	void   keyframe_sent();
+
+	void set_update_limit(long int                             min_period_usec,
+	                      bool                                 latest_only,
+	                      BlackBoardNetHandlerUpdateScheduler *scheduler);
+	bool flush(const Time &now, Time &due);
+	void set_notify_only(bool notify_only);
+
 	virtual void bb_interface_data_refreshed(Interface *interface) noexcept;
 	virtual void bb_interface_data_changed(Interface *interface) noexcept;
 	virtual bool bb_interface_message_received(Interface *interface, Message *message) noexcept;
@@ -50,12 +67,32 @@ public:
 
 private:
 	void send_event_serial(Interface *interface, unsigned int msg_id, Uuid event_serial);
+	void send_data(bool changed);
+	void transmit_data(bool changed);
+	bool transmit_delta(bool changed);
+	void transmit(unsigned int msg_id, void *payload, size_t payload_size);
+	bool throttled(const Time &now, Time &due) const;
 
 	BlackBoard *      blackboard_;
 	Interface *       interface_;
 	FawkesNetworkHub *fnh_;
 
 	unsigned int clid_;
+
+	Mutex *   data_mutex_;
+	bool      send_deltas_;
+	bool      notify_only_;
+	char *    delta_base_;
+	uint32_t  delta_seq_;
+	uint64_t *bytes_saved_;
+
+	BlackBoardNetHandlerUpdateScheduler *scheduler_;
+	long int                             min_period_usec_;
+	bool                                 latest_only_;
+	bool                                 pending_;
+	bool                                 pending_changed_;
+	Time                                 next_send_;
+	FawkesNetworkMessage *               last_msg_;
 };
 
 } // end namespace fawkes
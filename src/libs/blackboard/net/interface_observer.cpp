@@ -26,6 +26,7 @@
 #include <blackboard/net/messages.h>
 #include <logging/liblogger.h>
 #include <netcomm/fawkes/component_ids.h>
+#include <netcomm/fawkes/frame_cache.h>
 #include <netcomm/fawkes/hub.h>
 
 #include <cstdlib>
@@ -43,12 +44,17 @@ namespace fawkes {
 /** Constructor.
  * @param blackboard local BlackBoard
  * @param hub Fawkes network hub to use to send messages
+ * @param ilist_cache cache of interface lists, invalidated whenever an
+ * interface is created or destroyed, may be NULL
  */
-BlackBoardNetHandlerInterfaceObserver::BlackBoardNetHandlerInterfaceObserver(BlackBoard *blackboard,
-                                                                             FawkesNetworkHub *hub)
+BlackBoardNetHandlerInterfaceObserver::BlackBoardNetHandlerInterfaceObserver(
+  BlackBoard *             blackboard,
+  FawkesNetworkHub *       hub,
+  FawkesNetworkFrameCache *ilist_cache)
 {
-	blackboard_ = blackboard;
-	fnh_        = hub;
+	blackboard_  = blackboard;
+	fnh_         = hub;
+	ilist_cache_ = ilist_cache;
 
 	bbio_add_observed_create("*", "*");
 	bbio_add_observed_destroy("*", "*");
@@ -72,6 +78,10 @@ BlackBoardNetHandlerInterfaceObserver::send_event(unsigned int msg_id,
                                                   const char * type,
                                                   const char * id)
 {
+	// clients receiving the event may request a list right away
+	if (ilist_cache_)
+		ilist_cache_->clear();
+
 	bb_ievent_msg_t *esm = (bb_ievent_msg_t *)malloc(sizeof(bb_ievent_msg_t));
 	strncpy(esm->type, type, INTERFACE_TYPE_SIZE_ - 1);
 	strncpy(esm->id, id, INTERFACE_ID_SIZE_ - 1);
@@ -28,13 +28,17 @@
 
 namespace fawkes {
 
+class FawkesNetworkFrameCache;
+
 class FawkesNetworkHub;
 class BlackBoard;
 
 class BlackBoardNetHandlerInterfaceObserver : public BlackBoardInterfaceObserver
 {
 public:
-	BlackBoardNetHandlerInterfaceObserver(BlackBoard *blackboard, FawkesNetworkHub *hub);
+	BlackBoardNetHandlerInterfaceObserver(BlackBoard *             blackboard,
+	                                      FawkesNetworkHub *       hub,
+	                                      FawkesNetworkFrameCache *ilist_cache = NULL);
 	virtual ~BlackBoardNetHandlerInterfaceObserver();
 
 	virtual void bb_interface_created(const char *type, const char *id) noexcept;
@@ -44,8 +48,9 @@ private:
 	void send_event(unsigned int msg_id, const char *type, const char *id);
 
 private:
-	BlackBoard *      blackboard_;
-	FawkesNetworkHub *fnh_;
+	BlackBoard *             blackboard_;
+	FawkesNetworkHub *       fnh_;
+	FawkesNetworkFrameCache *ilist_cache_;
 };
 
 } // end namespace fawkes
@@ -25,6 +25,7 @@
 #include <blackboard/internal/instance_factory.h>
 #include <blackboard/internal/interface_mem_header.h>
 #include <blackboard/internal/notifier.h>
+#include <blackboard/net/delta.h>
 #include <blackboard/net/interface_proxy.h>
 #include <blackboard/net/messages.h>
 #include <core/threading/refc_rwlock.h>
@@ -74,6 +75,11 @@ BlackBoardInterfaceProxy::BlackBoardInterfaceProxy(FawkesNetworkClient * client,
 	data_size_       = ntohl(osm->data_size);
 	clid_            = msg->clid();
 	next_msg_id_     = 1;
+	shmem_attached_  = false;
+	delta_synced_    = true;
+	delta_seq_       = 0;
+	min_period_usec_ = 0;
+	latest_only_     = false;
 
 	if (interface->datasize() != data_size_) {
 		// Boom, sizes do not match
@@ -96,7 +102,7 @@ BlackBoardInterfaceProxy::BlackBoardInterfaceProxy(FawkesNetworkClient * client,
 	ih->refcount           = 1;
 
 	interface->set_instance_serial(instance_serial_);
-	interface->set_memory(0, mem_chunk_, data_chunk_);
+	interface->set_memory(0, mem_chunk_, data_chunk_, &ih->data_seq, &ih->stats, &ih->trace);
 	interface->set_mediators(this, this);
 	interface->set_readwrite(writer, rwlock_);
 }
@@ -141,11 +147,190 @@ BlackBoardInterfaceProxy::process_data_refreshed(FawkesNetworkMessage *msg)
 		return;
 	}
 
+	if (shmem_attached_) {
+		// sent before the remote side knew that we are attached, data is in shmem
+		notifier_->notify_of_data_refresh(interface_, msg->msgid() == MSG_BB_DATA_CHANGED);
+		return;
+	}
+
+	interface_header_t *ih = (interface_header_t *)mem_chunk_;
+	rwlock_->lock_for_write();
+	__atomic_store_n(&ih->data_seq, ih->data_seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
 	memcpy(data_chunk_, (char *)payload + sizeof(bb_idata_msg_t), data_size_);
+	__atomic_store_n(&ih->data_seq, ih->data_seq + 1, __ATOMIC_RELEASE);
+	rwlock_->unlock();
+
+	delta_synced_ = true;
+	delta_seq_    = 0;
 
 	notifier_->notify_of_data_refresh(interface_, msg->msgid() == MSG_BB_DATA_CHANGED);
 }
 
+/** Process MSG_BB_DATA_DELTA_CHANGED/REFRESHED message.
+ * The delta is applied to the current data. If a delta is missing the
+ * data stays unchanged until the next keyframe has been received.
+ * @param msg message to process.
+ */
+void
+BlackBoardInterfaceProxy::process_data_delta(FawkesNetworkMessage *msg)
+{
+	if (msg->msgid() != MSG_BB_DATA_DELTA_CHANGED && msg->msgid() != MSG_BB_DATA_DELTA_REFRESHED) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Expected data delta BB message, but "
+		                     "received message of type %u, ignoring.",
+		                     msg->msgid());
+		return;
+	}
+
+	void *           payload = msg->payload();
+	bb_idelta_msg_t *dm      = (bb_idelta_msg_t *)payload;
+	if (msg->payload_size() < sizeof(bb_idelta_msg_t)
+	    || msg->payload_size() - sizeof(bb_idelta_msg_t) != ntohl(dm->delta_size)) {
+		LibLogger::log_error("BlackBoardInterfaceProxy", "Malformed data delta, ignoring.");
+		return;
+	}
+	if (dm->serial != instance_serial_) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Serial mismatch, expected %s, "
+		                     "but got %s, ignoring.",
+		                     instance_serial_.get_string().c_str(),
+		                     dm->serial.get_string().c_str());
+		return;
+	}
+
+	if (ntohl(dm->data_size) != data_size_) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Data size mismatch, expected %zu, "
+		                     "but got %zu, ignoring.",
+		                     data_size_,
+		                     ntohl(dm->data_size));
+		return;
+	}
+
+	if (shmem_attached_) {
+		notifier_->notify_of_data_refresh(interface_, msg->msgid() == MSG_BB_DATA_DELTA_CHANGED);
+		return;
+	}
+
+	if (!delta_synced_ || ntohl(dm->seq) != delta_seq_ + 1) {
+		if (delta_synced_) {
+			LibLogger::log_warn("BlackBoardInterfaceProxy",
+			                    "Delta sequence mismatch for %s, expected %u, "
+			                    "but got %u, waiting for next keyframe.",
+			                    interface_->uid(),
+			                    delta_seq_ + 1,
+			                    ntohl(dm->seq));
+		}
+		delta_synced_ = false;
+		return;
+	}
+
+	interface_header_t *ih = (interface_header_t *)mem_chunk_;
+	rwlock_->lock_for_write();
+	__atomic_store_n(&ih->data_seq, ih->data_seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	bool applied = blackboard_delta_apply(data_chunk_,
+	                                      data_size_,
+	                                      (char *)payload + sizeof(bb_idelta_msg_t),
+	                                      ntohl(dm->delta_size));
+	__atomic_store_n(&ih->data_seq, ih->data_seq + 1, __ATOMIC_RELEASE);
+	rwlock_->unlock();
+
+	if (!applied) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Malformed data delta for %s, waiting for next keyframe.",
+		                     interface_->uid());
+		delta_synced_ = false;
+		return;
+	}
+	delta_seq_ += 1;
+
+	notifier_->notify_of_data_refresh(interface_, msg->msgid() == MSG_BB_DATA_DELTA_CHANGED);
+}
+
+/** Process MSG_BB_DATA_NOTIFY_CHANGED/REFRESHED message.
+ * The data has been written to the shared memory segment already, only
+ * notify listeners.
+ * @param msg message to process.
+ */
+void
+BlackBoardInterfaceProxy::process_data_notify(FawkesNetworkMessage *msg)
+{
+	if (msg->msgid() != MSG_BB_DATA_NOTIFY_CHANGED && msg->msgid() != MSG_BB_DATA_NOTIFY_REFRESHED) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Expected data notify BB message, but "
+		                     "received message of type %u, ignoring.",
+		                     msg->msgid());
+		return;
+	}
+
+	bb_iserial_msg_t *sm = msg->msg<bb_iserial_msg_t>();
+	if (sm->serial != instance_serial_) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Serial mismatch, expected %s, "
+		                     "but got %s, ignoring.",
+		                     instance_serial_.get_string().c_str(),
+		                     sm->serial.get_string().c_str());
+		return;
+	}
+	if (!shmem_attached_) {
+		LibLogger::log_error("BlackBoardInterfaceProxy",
+		                     "Received data notification for %s, but "
+		                     "not attached to shared memory, ignoring.",
+		                     interface_->uid());
+		return;
+	}
+
+	notifier_->notify_of_data_refresh(interface_, msg->msgid() == MSG_BB_DATA_NOTIFY_CHANGED);
+}
+
+/** Read data from shared memory.
+ * Points the interface to the memory chunk of the interface in the remote
+ * BlackBoard's shared memory segment, after checking that the chunk is
+ * the expected one. Must be called before the interface is used.
+ * @param mem_chunk interface memory chunk in the locally attached segment
+ * @param available number of bytes from @p mem_chunk to the end of the
+ * segment
+ * @return true if the interface now reads from shared memory, false if
+ * the chunk does not match, in which case nothing has been changed
+ */
+bool
+BlackBoardInterfaceProxy::attach_shmem(void *mem_chunk, size_t available)
+{
+	if (available < sizeof(interface_header_t) + data_size_) {
+		return false;
+	}
+
+	interface_header_t *ih = (interface_header_t *)mem_chunk;
+	if ((strncmp(ih->type, interface_->type(), INTERFACE_TYPE_SIZE_) != 0)
+	    || (strncmp(ih->id, interface_->id(), INTERFACE_ID_SIZE_) != 0)
+	    || (memcmp(ih->hash, interface_->hash(), INTERFACE_HASH_SIZE_) != 0)) {
+		return false;
+	}
+
+	// the local read lock does not exclude the writer in the other process,
+	// the segment is attached read-only, hence no shared statistics
+	interface_->set_memory(0,
+	                       mem_chunk,
+	                       (char *)mem_chunk + sizeof(interface_header_t),
+	                       &ih->data_seq,
+	                       /* stats */ NULL,
+	                       &ih->trace,
+	                       /* seqlock only */ true);
+	shmem_attached_ = true;
+	return true;
+}
+
+/** Check if data is read from shared memory.
+ * @return true if attach_shmem() succeeded, false otherwise
+ */
+bool
+BlackBoardInterfaceProxy::shmem_attached() const
+{
+	return shmem_attached_;
+}
+
 /** Process MSG_BB_INTERFACE message.
  * @param msg message to process.
  */
@@ -263,6 +448,39 @@ BlackBoardInterfaceProxy::writer_removed(Uuid event_serial)
 	notifier_->notify_of_writer_removed(interface_, event_serial);
 }
 
+/** Remember subscription options.
+ * The options are sent to the remote BlackBoard by RemoteBlackBoard, they
+ * are only stored here to re-establish them after reconnecting.
+ * @param min_period_usec minimum time between two data updates in
+ * microseconds, zero for no limit
+ * @param latest_only true to receive an update only after the previous
+ * one has been transmitted
+ */
+void
+BlackBoardInterfaceProxy::set_update_limit(unsigned int min_period_usec, bool latest_only)
+{
+	min_period_usec_ = min_period_usec;
+	latest_only_     = latest_only;
+}
+
+/** Get minimum update period.
+ * @return minimum time between two data updates in microseconds, zero for no limit
+ */
+unsigned int
+BlackBoardInterfaceProxy::min_period_usec() const
+{
+	return min_period_usec_;
+}
+
+/** Check for latest-only updates.
+ * @return true if updates are only sent after the previous one has been transmitted
+ */
+bool
+BlackBoardInterfaceProxy::latest_only() const
+{
+	return latest_only_;
+}
+
 /** Get instance serial of interface.
  * @return instance serial
  */
@@ -49,16 +49,25 @@ public:
 	~BlackBoardInterfaceProxy();
 
 	void process_data_refreshed(FawkesNetworkMessage *msg);
+	void process_data_delta(FawkesNetworkMessage *msg);
+	void process_data_notify(FawkesNetworkMessage *msg);
 	void process_interface_message(FawkesNetworkMessage *msg);
 	void reader_added(Uuid event_serial);
 	void reader_removed(Uuid event_serial);
 	void writer_added(Uuid event_serial);
 	void writer_removed(Uuid event_serial);
 
+	bool attach_shmem(void *mem_chunk, size_t available);
+	bool shmem_attached() const;
+
 	Uuid       serial() const;
 	Uuid       clid() const;
 	Interface *interface() const;
 
+	void         set_update_limit(unsigned int min_period_usec, bool latest_only);
+	unsigned int min_period_usec() const;
+	bool         latest_only() const;
+
 	/* InterfaceMediator */
 	virtual bool         exists_writer(const Interface *interface) const;
 	virtual unsigned int num_readers(const Interface *interface) const;
@@ -92,6 +101,14 @@ private:
 	unsigned int   num_readers_;
 	bool           has_writer_;
 	unsigned int   clid_;
+
+	bool shmem_attached_;
+
+	bool         delta_synced_;
+	unsigned int delta_seq_;
+
+	unsigned int min_period_usec_;
+	bool         latest_only_;
 };
 
 } // end namespace fawkes
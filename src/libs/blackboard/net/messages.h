@@ -52,9 +52,36 @@ typedef enum {
 	MSG_BB_WRITER_REMOVED,
 	MSG_BB_INTERFACE_CREATED,
 	MSG_BB_INTERFACE_DESTROYED,
-	MSG_BB_LIST
+	MSG_BB_LIST,
+	MSG_BB_FEATURES,
+	MSG_BB_DATA_DELTA_REFRESHED,
+	MSG_BB_DATA_DELTA_CHANGED,
+	MSG_BB_SUBSCRIPTION,
+	MSG_BB_SHMEM_ATTACHED,
+	MSG_BB_DATA_NOTIFY_REFRESHED,
+	MSG_BB_DATA_NOTIFY_CHANGED
 } blackboard_msgid_t;
 
+/** Optional protocol features, negotiated per client with MSG_BB_FEATURES. */
+typedef enum {
+	BB_FEATURE_DATA_DELTA = 1, /**< Client accepts MSG_BB_DATA_DELTA_REFRESHED and
+			     * MSG_BB_DATA_DELTA_CHANGED instead of full data updates. */
+	BB_FEATURE_SHMEM = 2 /**< Client can read interface data directly from the
+			     * server's shared memory segment if both run on the same host,
+			     * see bb_ishmem_info_t. */
+} blackboard_feature_t;
+
+/** Size of the host ID in bb_ishmem_info_t. */
+#define BB_SHMEM_HOST_ID_SIZE 40
+/** Size of the magic token in bb_ishmem_info_t. */
+#define BB_SHMEM_MAGIC_TOKEN_SIZE 32
+
+/** Subscription flags, see bb_isubscription_msg_t. */
+typedef enum {
+	BB_SUBSCRIPTION_LATEST_ONLY = 1 /**< Do not send another data update while the previous
+				   * one is still queued for transmission to the client. */
+} blackboard_subscription_flag_t;
+
 /** Error codes */
 typedef enum {
 	BB_ERR_UNKNOWN_ERR,   /**< Unknown error occured. Check log. */
@@ -137,6 +164,7 @@ typedef struct
  * BlackBoard.
  * This message struct is always followed by a data chunk that is of the
  * size data_size. It contains the current content of the interface.
+ * The data chunk may be followed by a bb_ishmem_info_t.
  */
 typedef struct
 {
@@ -148,6 +176,27 @@ typedef struct
 	uint32_t data_size;      /**< size in bytes of the following data. */
 } bb_iopensucc_msg_t;
 
+/** Shared memory location of an interface.
+ * If the client negotiated BB_FEATURE_SHMEM and the BlackBoard of the
+ * server is kept in shared memory, this struct is appended to the
+ * MSG_BB_OPEN_SUCCESS message of interfaces opened for reading, after
+ * the data chunk. If the host IDs match, the client may attach to the
+ * segment read-only, read the data directly from it and acknowledge with
+ * MSG_BB_SHMEM_ATTACHED. The server then only sends
+ * MSG_BB_DATA_NOTIFY_REFRESHED and MSG_BB_DATA_NOTIFY_CHANGED (with a
+ * bb_iserial_msg_t) instead of data updates.
+ */
+typedef struct
+{
+	char     magic_token[BB_SHMEM_MAGIC_TOKEN_SIZE]; /**< magic token of the segment */
+	char     host_id[BB_SHMEM_HOST_ID_SIZE];         /**< ID of the server's host */
+	uint32_t shmem_id;                               /**< System V shared memory ID (big endian) */
+	uint32_t version;                                /**< BlackBoard version (big endian) */
+	uint32_t memsize;                                /**< size of the segment's data (big endian) */
+	uint32_t offset; /**< offset of the interface memory chunk from the start
+			* of the segment's data (big endian) */
+} bb_ishmem_info_t;
+
 /** Message to send update data. */
 typedef struct
 {
@@ -167,6 +216,59 @@ typedef struct
 	uint32_t data_size; /**< size in bytes of the following data. */
 } bb_idata_msg_t;
 
+/** Protocol feature negotiation message.
+ * The client sends this message after connecting with the features it
+ * supports. The server replies with the subset it will use for this
+ * client. Servers which do not know the message simply ignore it and
+ * continue to send full data updates.
+ */
+typedef struct
+{
+	uint32_t features; /**< bitwise or of blackboard_feature_t (big endian) */
+} bb_ifeatures_msg_t;
+
+/** Interface data delta message.
+ * The serial denotes a unique instance of an interface within the (remote)
+ * BlackBoard.
+ * This message struct is always followed by a chunk of size delta_size
+ * which encodes the difference of the current data to the data last sent.
+ * It is a sequence of runs, each consisting of a bb_idelta_run_t followed
+ * by length bytes which must be XOR'ed into the data at the current
+ * position after skipping skip unchanged bytes. Every full data update
+ * (MSG_BB_DATA_REFRESHED, MSG_BB_DATA_CHANGED, or MSG_BB_OPEN_SUCCESS) is
+ * a keyframe and resets the sequence number. Each following delta
+ * increments it by one.
+ * This message is sent for MSG_BB_DATA_DELTA_REFRESHED and
+ * MSG_BB_DATA_DELTA_CHANGED.
+ */
+typedef struct
+{
+	Uuid     serial;     /**< instance serial to unique identify this instance */
+	uint32_t data_size;  /**< size in bytes of the full data. */
+	uint32_t delta_size; /**< size in bytes of the following delta. */
+	uint32_t seq;        /**< number of deltas since the last keyframe */
+} bb_idelta_msg_t;
+
+/** Run header in delta encoded data. */
+typedef struct
+{
+	uint32_t skip;   /**< number of unchanged bytes before this run (big endian) */
+	uint32_t length; /**< number of XOR bytes following this header (big endian) */
+} bb_idelta_run_t;
+
+/** Subscription options of an opened interface.
+ * Sent by the client for MSG_BB_SUBSCRIPTION to limit the data updates
+ * it receives for the given instance. Updates in between are coalesced,
+ * the client always receives the newest data.
+ */
+typedef struct
+{
+	Uuid     serial;          /**< instance serial to unique identify this instance */
+	uint32_t min_period_usec; /**< minimum time between two data updates in
+				   * microseconds, zero for no limit (big endian) */
+	uint32_t flags;           /**< bitwise or of blackboard_subscription_flag_t (big endian) */
+} bb_isubscription_msg_t;
+
 /** Interface message.
  * This type is used to transport interface messages. This struct is always followed
  * by a data chunk of the size data_size that transports the message data.
@@ -0,0 +1,65 @@
+
+/***************************************************************************
+ *  shmem_info.cpp - BlackBoard network shared memory transport helpers
+ *
+ *  Created: Wed Oct 14 19:02:03 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <blackboard/net/shmem_info.h>
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace fawkes {
+
+/** Get ID of this host.
+ * Two processes can share System V shared memory segments only if they
+ * run on the same host and boot. On Linux the kernel's boot ID is used,
+ * which changes on every boot and differs between virtual machines and
+ * containers with a separate kernel. Elsewhere the host name is used.
+ * @param host_id buffer to write the zero-terminated host ID to, the ID
+ * is truncated if it does not fit
+ * @param size size of @p host_id in bytes
+ */
+void
+blackboard_host_id(char *host_id, size_t size)
+{
+	if (size == 0)
+		return;
+	memset(host_id, 0, size);
+
+	FILE *f = fopen("/proc/sys/kernel/random/boot_id", "r");
+	if (f) {
+		bool ok = (fgets(host_id, size, f) != NULL);
+		fclose(f);
+		if (ok) {
+			host_id[strcspn(host_id, "\n")] = 0;
+			if (host_id[0] != 0)
+				return;
+		}
+	}
+
+	if (gethostname(host_id, size - 1) != 0) {
+		host_id[0] = 0;
+	}
+	host_id[size - 1] = 0;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,35 @@
+
+/***************************************************************************
+ *  shmem_info.h - BlackBoard network shared memory transport helpers
+ *
+ *  Created: Wed Oct 14 19:02:03 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_NET_SHMEM_INFO_H_
+#define _BLACKBOARD_NET_SHMEM_INFO_H_
+
+#include <cstddef>
+
+namespace fawkes {
+
+void blackboard_host_id(char *host_id, size_t size);
+
+} // end namespace fawkes
+
+#endif
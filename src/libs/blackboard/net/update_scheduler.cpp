@@ -0,0 +1,142 @@
+
+/***************************************************************************
+ *  update_scheduler.cpp - Deferred data updates for rate-limited remote readers
+ *
+ *  Created: Wed Oct 14 18:31:45 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <blackboard/net/interface_listener.h>
+#include <blackboard/net/update_scheduler.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+#include <utils/time/time.h>
+
+#include <vector>
+
+namespace fawkes {
+
+/** @class BlackBoardNetHandlerUpdateScheduler <blackboard/net/update_scheduler.h>
+ * Deferred data updates for rate-limited remote readers.
+ * Interface listeners of the BlackBoardNetworkHandler whose client
+ * requested a maximum update rate or latest-only updates do not send
+ * data from within the writer's thread. Instead they remember that an
+ * update is pending and schedule themselves here. This thread then sends
+ * the newest data once the listener becomes due, coalescing all writes
+ * that happened in between into a single update.
+ * @author agent
+ */
+
+/** Constructor. */
+BlackBoardNetHandlerUpdateScheduler::BlackBoardNetHandlerUpdateScheduler()
+: Thread("BlackBoardNetHandlerUpdateScheduler", Thread::OPMODE_CONTINUOUS)
+{
+	mutex_    = new Mutex();
+	cond_     = new WaitCondition(mutex_);
+	running_  = false;
+	flushing_ = NULL;
+}
+
+/** Destructor. */
+BlackBoardNetHandlerUpdateScheduler::~BlackBoardNetHandlerUpdateScheduler()
+{
+	if (running_) {
+		cancel();
+		join();
+	}
+	delete cond_;
+	delete mutex_;
+}
+
+/** Schedule pending update.
+ * The thread is started on first use.
+ * @param listener listener which has a pending update
+ */
+void
+BlackBoardNetHandlerUpdateScheduler::schedule(BlackBoardNetHandlerInterfaceListener *listener)
+{
+	MutexLocker lock(mutex_);
+	pending_.insert(listener);
+	if (!running_) {
+		running_ = true;
+		start();
+	}
+	cond_->wake_all();
+}
+
+/** Remove listener.
+ * If the listener is currently sending its update, waits until that has
+ * finished.
+ * @param listener listener to remove
+ */
+void
+BlackBoardNetHandlerUpdateScheduler::remove(BlackBoardNetHandlerInterfaceListener *listener)
+{
+	MutexLocker lock(mutex_);
+	pending_.erase(listener);
+	while (flushing_ == listener) {
+		cond_->wait();
+	}
+}
+
+void
+BlackBoardNetHandlerUpdateScheduler::loop()
+{
+	mutex_->lock();
+	while (pending_.empty()) {
+		cond_->wait();
+	}
+
+	Time now;
+	Time next = now + 1.0;
+
+	std::vector<BlackBoardNetHandlerInterfaceListener *> listeners(pending_.begin(), pending_.end());
+	for (BlackBoardNetHandlerInterfaceListener *l : listeners) {
+		if (pending_.find(l) == pending_.end())
+			continue; // removed in the meantime
+
+		flushing_ = l;
+		mutex_->unlock();
+
+		CancelState old_state;
+		set_cancel_state(CANCEL_DISABLED, &old_state);
+		Time due;
+		bool still_pending = l->flush(now, due);
+		set_cancel_state(old_state);
+
+		mutex_->lock();
+		flushing_ = NULL;
+		cond_->wake_all();
+		if (!still_pending) {
+			pending_.erase(l);
+		} else if (due < next) {
+			next = due;
+		}
+	}
+
+	if (!pending_.empty()) {
+		long int wait_usec = (next - Time()).in_usec();
+		if (wait_usec > 0) {
+			cond_->reltimed_wait(wait_usec / 1000000, (wait_usec % 1000000) * 1000);
+		}
+	}
+	mutex_->unlock();
+}
+
+} // end namespace fawkes
@@ -0,0 +1,67 @@
+
+/***************************************************************************
+ *  update_scheduler.h - Deferred data updates for rate-limited remote readers
+ *
+ *  Created: Wed Oct 14 18:31:45 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_NET_UPDATE_SCHEDULER_H_
+#define _BLACKBOARD_NET_UPDATE_SCHEDULER_H_
+
+#include <core/threading/thread.h>
+
+#include <set>
+
+namespace fawkes {
+
+class BlackBoardNetHandlerInterfaceListener;
+class Mutex;
+class WaitCondition;
+
+class BlackBoardNetHandlerUpdateScheduler : public Thread
+{
+public:
+	BlackBoardNetHandlerUpdateScheduler();
+	virtual ~BlackBoardNetHandlerUpdateScheduler();
+
+	void schedule(BlackBoardNetHandlerInterfaceListener *listener);
+	void remove(BlackBoardNetHandlerInterfaceListener *listener);
+
+	virtual void loop();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	Mutex *        mutex_;
+	WaitCondition *cond_;
+	bool           running_;
+
+	std::set<BlackBoardNetHandlerInterfaceListener *> pending_;
+	BlackBoardNetHandlerInterfaceListener *           flushing_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -82,6 +82,14 @@ BlackBoardWithOwnership::open_multiple_for_reading(const char *type_pattern,
 	                                              owner ? owner : owner_.c_str());
 }
 
+std::list<Interface *>
+BlackBoardWithOwnership::open_all_for_reading(
+  const std::list<std::pair<std::string, std::string>> &interfaces,
+  const char *                                          owner)
+{
+	return blackboard_->open_all_for_reading(interfaces, owner ? owner : owner_.c_str());
+}
+
 void
 BlackBoardWithOwnership::close(Interface *interface)
 {
@@ -152,4 +160,10 @@ BlackBoardWithOwnership::unregister_observer(BlackBoardInterfaceObserver *observ
 	blackboard_->unregister_observer(observer);
 }
 
+std::list<BlackBoard::ListenerStats>
+BlackBoardWithOwnership::listener_stats()
+{
+	return blackboard_->listener_stats();
+}
+
 } // end namespace fawkes
@@ -47,6 +47,9 @@ public:
 	virtual std::list<Interface *> open_multiple_for_reading(const char *type_pattern,
 	                                                         const char *id_pattern = "*",
 	                                                         const char *owner      = NULL);
+	virtual std::list<Interface *>
+	open_all_for_reading(const std::list<std::pair<std::string, std::string>> &interfaces,
+	                     const char *                                          owner = NULL);
 
 	virtual void register_listener(BlackBoardInterfaceListener *listener,
 	                               ListenerRegisterFlag         flag = BBIL_FLAG_ALL);
@@ -57,6 +60,8 @@ public:
 	virtual void register_observer(BlackBoardInterfaceObserver *observer);
 	virtual void unregister_observer(BlackBoardInterfaceObserver *observer);
 
+	virtual std::list<ListenerStats> listener_stats();
+
 private: /* members */
 	BlackBoard *blackboard_;
 	std::string owner_;
@@ -27,13 +27,17 @@
 #include <blackboard/net/ilist_content.h>
 #include <blackboard/net/interface_proxy.h>
 #include <blackboard/net/messages.h>
+#include <blackboard/net/shmem_info.h>
 #include <blackboard/remote.h>
+#include <blackboard/shmem/header.h>
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
 #include <core/threading/thread.h>
 #include <core/threading/wait_condition.h>
 #include <interface/interface_info.h>
+#include <logging/liblogger.h>
 #include <netcomm/fawkes/client.h>
+#include <utils/ipc/shm.h>
 #include <utils/time/time.h>
 
 #include <cstring>
@@ -47,6 +51,19 @@ namespace fawkes {
  * This class implements the access to a remote BlackBoard using the Fawkes
  * network protocol.
  *
+ * On connection, the RemoteBlackBoard announces that it accepts delta
+ * encoded data updates (BB_FEATURE_DATA_DELTA). Servers supporting it
+ * then transmit only the changed parts of the data of opened interfaces.
+ *
+ * It also announces that it can read from shared memory
+ * (BB_FEATURE_SHMEM). If the remote BlackBoard runs on the same host and
+ * is kept in shared memory, interfaces opened for reading are attached
+ * read-only to its segment. Their data is then read directly from there
+ * without being copied over the network, which is only used for control
+ * messages, interface messages, and update notifications. If attaching
+ * fails, for example due to missing permissions or a separate IPC
+ * namespace, the data is received over the network as usual.
+ *
  * @author Tim Niemueller
  */
 
@@ -72,6 +89,14 @@ RemoteBlackBoard::RemoteBlackBoard(FawkesNetworkClient *client)
 
 	inbound_thread_ = NULL;
 	m_              = NULL;
+
+	char host_id[BB_SHMEM_HOST_ID_SIZE];
+	blackboard_host_id(host_id, sizeof(host_id));
+	host_id_      = host_id;
+	shmem_        = NULL;
+	shmem_header_ = NULL;
+
+	send_features();
 }
 
 /** Constructor.
@@ -106,6 +131,14 @@ RemoteBlackBoard::RemoteBlackBoard(const char *hostname, unsigned short int port
 
 	inbound_thread_ = NULL;
 	m_              = NULL;
+
+	char host_id[BB_SHMEM_HOST_ID_SIZE];
+	blackboard_host_id(host_id, sizeof(host_id));
+	host_id_      = host_id;
+	shmem_        = NULL;
+	shmem_header_ = NULL;
+
+	send_features();
 }
 
 /** Destructor. */
@@ -119,6 +152,14 @@ RemoteBlackBoard::~RemoteBlackBoard()
 		delete pit_->second;
 	}
 
+	// interfaces may point into shared memory until here
+	delete shmem_;
+	delete shmem_header_;
+	for (auto &s : stale_shmems_) {
+		delete s.first;
+		delete s.second;
+	}
+
 	if (fnc_owner_) {
 		fnc_->disconnect();
 		delete fnc_;
@@ -128,6 +169,18 @@ RemoteBlackBoard::~RemoteBlackBoard()
 	delete wait_mutex_;
 }
 
+/** Announce supported protocol features to the remote BlackBoard. */
+void
+RemoteBlackBoard::send_features()
+{
+	bb_ifeatures_msg_t *fm = (bb_ifeatures_msg_t *)malloc(sizeof(bb_ifeatures_msg_t));
+	fm->features           = htonl(BB_FEATURE_DATA_DELTA | BB_FEATURE_SHMEM);
+
+	FawkesNetworkMessage *omsg =
+	  new FawkesNetworkMessage(FAWKES_CID_BLACKBOARD, MSG_BB_FEATURES, fm, sizeof(bb_ifeatures_msg_t));
+	fnc_->enqueue(omsg);
+}
+
 bool
 RemoteBlackBoard::is_alive() const noexcept
 {
@@ -144,6 +197,11 @@ RemoteBlackBoard::reopen_interfaces()
 			Interface *iface = (*ipit_)->interface();
 			open_interface(iface->type(), iface->id(), iface->owner(), iface->is_writer(), iface);
 			iface->set_validity(true);
+			if ((*ipit_)->min_period_usec() > 0 || (*ipit_)->latest_only()) {
+				BlackBoardInterfaceProxy *proxy = proxies_[iface->serial()];
+				proxy->set_update_limit((*ipit_)->min_period_usec(), (*ipit_)->latest_only());
+				send_subscription(proxy);
+			}
 			ipit_ = invalid_proxies_.erase(ipit_);
 		} catch (Exception &e) {
 			// we failed to re-establish validity for the given interface, bad luck
@@ -219,6 +277,9 @@ RemoteBlackBoard::open_interface(const char *type,
 		// We got the interface, create internal storage and prepare instance for return
 		BlackBoardInterfaceProxy *proxy =
 		  new BlackBoardInterfaceProxy(fnc_, m_, notifier_, iface, writer);
+		if (!writer) {
+			attach_shmem(proxy, m_);
+		}
 		proxies_[proxy->serial()] = proxy;
 	} else if (m_->msgid() == MSG_BB_OPEN_FAILURE) {
 		bb_iopenfail_msg_t *fm    = m_->msg<bb_iopenfail_msg_t>();
@@ -242,6 +303,109 @@ RemoteBlackBoard::open_interface(const char *type,
 	m_ = NULL;
 }
 
+/** Read interface data from shared memory if offered.
+ * @param proxy proxy of the newly opened reading interface, not yet
+ * registered in proxies_
+ * @param msg MSG_BB_OPEN_SUCCESS message the proxy has been created from
+ */
+void
+RemoteBlackBoard::attach_shmem(BlackBoardInterfaceProxy *proxy, FawkesNetworkMessage *msg)
+{
+	bb_iopensucc_msg_t *osm      = (bb_iopensucc_msg_t *)msg->payload();
+	size_t              info_pos = sizeof(bb_iopensucc_msg_t) + ntohl(osm->data_size);
+	if (msg->payload_size() != info_pos + sizeof(bb_ishmem_info_t)) {
+		// not offered, remote BlackBoard is on the heap or does not support it
+		return;
+	}
+
+	bb_ishmem_info_t *si = (bb_ishmem_info_t *)((char *)msg->payload() + info_pos);
+	if (strncmp(si->host_id, host_id_.c_str(), BB_SHMEM_HOST_ID_SIZE) != 0) {
+		return;
+	}
+
+	char magic_token[BB_SHMEM_MAGIC_TOKEN_SIZE + 1];
+	magic_token[BB_SHMEM_MAGIC_TOKEN_SIZE] = 0;
+	strncpy(magic_token, si->magic_token, BB_SHMEM_MAGIC_TOKEN_SIZE);
+
+	SharedMemory *shmem =
+	  shmem_for(magic_token, ntohl(si->shmem_id), ntohl(si->version), ntohl(si->memsize));
+	if (!shmem) {
+		return;
+	}
+
+	size_t offset = ntohl(si->offset);
+	if (offset >= shmem->data_size()
+	    || !proxy->attach_shmem((char *)shmem->memptr() + offset, shmem->data_size() - offset)) {
+		LibLogger::log_warn("RemoteBlackBoard",
+		                    "Shared memory chunk of %s does not match, "
+		                    "receiving data over the network",
+		                    proxy->interface()->uid());
+		return;
+	}
+
+	bb_iserial_msg_t *sm = (bb_iserial_msg_t *)calloc(1, sizeof(bb_iserial_msg_t));
+	sm->serial           = proxy->serial();
+	FawkesNetworkMessage *omsg =
+	  new FawkesNetworkMessage(FAWKES_CID_BLACKBOARD, MSG_BB_SHMEM_ATTACHED, sm, sizeof(bb_iserial_msg_t));
+	fnc_->enqueue(omsg);
+}
+
+/** Get shared memory segment of remote BlackBoard.
+ * Attaches read-only to the segment on first use.
+ * @param magic_token magic token of the segment
+ * @param shmem_id expected System V shared memory ID of the segment
+ * @param version BlackBoard version stored in the segment
+ * @param memsize size of the segment's data
+ * @return attached segment, NULL if it could not be attached
+ */
+SharedMemory *
+RemoteBlackBoard::shmem_for(const char * magic_token,
+                            int          shmem_id,
+                            unsigned int version,
+                            size_t       memsize)
+{
+	MutexLocker lock(mutex_);
+	if (shmem_) {
+		if (shmem_->shmem_id() == shmem_id) {
+			return shmem_;
+		}
+		// the remote BlackBoard has been restarted, interfaces opened before
+		// still point into the old segment until they are reopened
+		stale_shmems_.push_back(std::make_pair(shmem_, shmem_header_));
+		shmem_        = NULL;
+		shmem_header_ = NULL;
+	}
+
+	BlackBoardSharedMemoryHeader *header = new BlackBoardSharedMemoryHeader(memsize, version);
+	SharedMemory *                shmem  = NULL;
+	try {
+		shmem = new SharedMemory(magic_token,
+		                         header,
+		                         /* read only   */ true,
+		                         /* create      */ false,
+		                         /* dest on del */ false);
+		header->set_shared_memory(shmem);
+	} catch (Exception &e) {
+		delete header;
+		LibLogger::log_debug("RemoteBlackBoard",
+		                     "Cannot attach to shared memory segment %s, "
+		                     "receiving data over the network",
+		                     magic_token);
+		return NULL;
+	}
+
+	if (shmem->shmem_id() != shmem_id) {
+		// another segment with the same token, not the one of the remote BlackBoard
+		delete shmem;
+		delete header;
+		return NULL;
+	}
+
+	shmem_        = shmem;
+	shmem_header_ = header;
+	return shmem_;
+}
+
 Interface *
 RemoteBlackBoard::open_interface(const char *type,
                                  const char *identifier,
@@ -341,6 +505,51 @@ RemoteBlackBoard::close(Interface *interface)
 	instance_factory_->delete_interface_instance(interface);
 }
 
+/** Limit data updates of an interface.
+ * By default, the remote BlackBoard sends every single write of an
+ * interface. With this method the update rate can be limited per opened
+ * interface, intermediate writes are then coalesced and only the newest
+ * data is received. This is useful if the remote side writes at a much
+ * higher rate than the data is required here, e.g. for visualization.
+ * The limit is re-established after reconnecting. Remote BlackBoards that
+ * do not support this ignore the request.
+ * @param interface interface opened from this RemoteBlackBoard
+ * @param max_rate maximum number of updates per second, zero or negative
+ * for no limit
+ * @param latest_only if true, do not send another update while the previous
+ * one is still queued for transmission to this client, this adapts to
+ * the available bandwidth
+ * @exception Exception thrown if the interface has not been opened through
+ * this RemoteBlackBoard
+ */
+void
+RemoteBlackBoard::set_update_limit(Interface *interface, float max_rate, bool latest_only)
+{
+	MutexLocker lock(proxies_.mutex());
+	if (proxies_.find(interface->serial()) == proxies_.end()) {
+		throw Exception("Interface %s has not been opened remotely", interface->uid());
+	}
+	BlackBoardInterfaceProxy *proxy = proxies_[interface->serial()];
+	proxy->set_update_limit(max_rate > 0. ? (unsigned int)(1000000. / max_rate) : 0, latest_only);
+	send_subscription(proxy);
+}
+
+void
+RemoteBlackBoard::send_subscription(BlackBoardInterfaceProxy *proxy)
+{
+	bb_isubscription_msg_t *sm =
+	  (bb_isubscription_msg_t *)calloc(1, sizeof(bb_isubscription_msg_t));
+	sm->serial          = proxy->serial();
+	sm->min_period_usec = htonl(proxy->min_period_usec());
+	sm->flags           = htonl(proxy->latest_only() ? BB_SUBSCRIPTION_LATEST_ONLY : 0);
+
+	FawkesNetworkMessage *omsg = new FawkesNetworkMessage(FAWKES_CID_BLACKBOARD,
+	                                                      MSG_BB_SUBSCRIPTION,
+	                                                      sm,
+	                                                      sizeof(bb_isubscription_msg_t));
+	fnc_->enqueue(omsg);
+}
+
 InterfaceInfoList *
 RemoteBlackBoard::list_all()
 {
@@ -463,6 +672,18 @@ RemoteBlackBoard::inbound_received(FawkesNetworkMessage *m, unsigned int id) noe
 				if (proxies_.find(serial) != proxies_.end()) {
 					proxies_[serial]->process_data_refreshed(m);
 				}
+			} else if (msgid == MSG_BB_DATA_DELTA_CHANGED || msgid == MSG_BB_DATA_DELTA_REFRESHED) {
+				Uuid serial = ((Uuid *)m->payload())[0];
+				if (proxies_.find(serial) != proxies_.end()) {
+					proxies_[serial]->process_data_delta(m);
+				}
+			} else if (msgid == MSG_BB_DATA_NOTIFY_CHANGED || msgid == MSG_BB_DATA_NOTIFY_REFRESHED) {
+				Uuid serial = ((Uuid *)m->payload())[0];
+				if (proxies_.find(serial) != proxies_.end()) {
+					proxies_[serial]->process_data_notify(m);
+				}
+			} else if (msgid == MSG_BB_FEATURES) {
+				// nothing to do, the server only sends what we announced to support
 			} else if (msgid == MSG_BB_INTERFACE_MESSAGE) {
 				Uuid serial = ((Uuid *)m->payload())[0];
 				if (proxies_.find(serial) != proxies_.end()) {
@@ -528,6 +749,11 @@ RemoteBlackBoard::connection_died(unsigned int id) noexcept
 void
 RemoteBlackBoard::connection_established(unsigned int id) noexcept
 {
+	try {
+		send_features();
+	} catch (Exception &e) {
+		// the server will fall back to full data updates
+	}
 }
 
 } // end namespace fawkes
@@ -30,6 +30,8 @@
 #include <utils/uuid.h>
 
 #include <list>
+#include <string>
+#include <utility>
 
 namespace fawkes {
 
@@ -45,6 +47,8 @@ class BlackBoardNotifier;
 class BlackBoardInterfaceProxy;
 class BlackBoardInterfaceListener;
 class BlackBoardInterfaceObserver;
+class BlackBoardSharedMemoryHeader;
+class SharedMemory;
 
 class RemoteBlackBoard : public BlackBoard, public FawkesNetworkClientHandler
 {
@@ -68,6 +72,8 @@ public:
 	                                                 const char *id_pattern = "*",
 	                                                 const char *owner      = NULL);
 
+	void set_update_limit(Interface *interface, float max_rate, bool latest_only = false);
+
 	/* for FawkesNetworkClientHandler */
 	virtual void deregistered(unsigned int id) noexcept;
 	virtual void inbound_received(FawkesNetworkMessage *msg, unsigned int id) noexcept;
@@ -85,6 +91,13 @@ private: /* methods */
 	Interface *
 	     open_interface(const char *type, const char *identifier, const char *owner, bool writer);
 	void reopen_interfaces();
+	void send_features();
+	void send_subscription(BlackBoardInterfaceProxy *proxy);
+	void          attach_shmem(BlackBoardInterfaceProxy *proxy, FawkesNetworkMessage *msg);
+	SharedMemory *shmem_for(const char * magic_token,
+	                        int          shmem_id,
+	                        unsigned int version,
+	                        size_t       memsize);
 
 private: /* members */
 	Mutex *                                             mutex_;
@@ -101,6 +114,11 @@ private: /* members */
 	WaitCondition *wait_cond_;
 
 	const char *inbound_thread_;
+
+	std::string                   host_id_;
+	SharedMemory *                shmem_;
+	BlackBoardSharedMemoryHeader *shmem_header_;
+	std::list<std::pair<SharedMemory *, BlackBoardSharedMemoryHeader *>> stale_shmems_;
 };
 
 } // end namespace fawkes
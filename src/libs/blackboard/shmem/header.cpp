@@ -25,6 +25,7 @@
 #include <utils/ipc/shm.h>
 
 #include <cstddef>
+#include <cstring>
 
 namespace fawkes {
 
@@ -149,6 +150,7 @@ BlackBoardSharedMemoryHeader::initialize(void *memptr)
 	data->shm_addr        = memptr;
 	data->free_list_head  = NULL;
 	data->alloc_list_head = NULL;
+	memset(&data->size_classes, 0, sizeof(chunk_size_classes_t));
 }
 
 /** Set data of this header
@@ -217,6 +219,17 @@ BlackBoardSharedMemoryHeader::set_alloc_list_head(chunk_list_t *alh)
 	data->alloc_list_head = (chunk_list_t *)shmem->addr(alh);
 }
 
+/** Get size class data.
+ * The list heads stored in the returned struct are shared memory addresses
+ * and must be transformed before use.
+ * @return pointer to size class data in the shared memory segment
+ */
+chunk_size_classes_t *
+BlackBoardSharedMemoryHeader::size_classes()
+{
+	return &data->size_classes;
+}
+
 /** Get BlackBoard version.
  * @return BlackBoard version
  */
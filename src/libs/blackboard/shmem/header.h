@@ -38,10 +38,11 @@ private:
    */
 	typedef struct
 	{
-		unsigned int  version;         /**< version of the BB */
-		void *        shm_addr;        /**< base addr of shared memory */
-		chunk_list_t *free_list_head;  /**< offset of the free chunks list head */
-		chunk_list_t *alloc_list_head; /**< offset of the allocated chunks list head */
+		unsigned int         version;         /**< version of the BB */
+		void *               shm_addr;        /**< base addr of shared memory */
+		chunk_list_t *       free_list_head;  /**< offset of the free chunks list head */
+		chunk_list_t *       alloc_list_head; /**< offset of the allocated chunks list head */
+		chunk_size_classes_t size_classes;    /**< size class allocation data */
 	} BlackBoardSharedMemoryHeaderData;
 
 public:
@@ -62,6 +63,7 @@ public:
 	chunk_list_t *              alloc_list_head();
 	void                        set_free_list_head(chunk_list_t *flh);
 	void                        set_alloc_list_head(chunk_list_t *alh);
+	chunk_size_classes_t *      size_classes();
 
 	unsigned int version() const;
 
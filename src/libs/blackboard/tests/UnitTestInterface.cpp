@@ -0,0 +1,141 @@
+/***************************************************************************
+ *  UnitTestInterface.cpp - Interface for BlackBoard unit tests
+ *
+ *  Created: Thu Oct 15 10:48:02 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "UnitTestInterface.h"
+
+#include <core/exceptions/software.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace fawkes {
+
+/** @class UnitTestInterface "UnitTestInterface.h"
+ * Interface for BlackBoard unit tests.
+ * The interface is written by hand, such that the tests do not depend
+ * on the interface generator. Each record stores its number in every
+ * element of a large array. A copy that mixes two records therefore
+ * has different values, which consistent() detects.
+ * @author agent
+ */
+
+/** Constructor. */
+UnitTestInterface::UnitTestInterface() : Interface()
+{
+	data_size = sizeof(UnitTestInterface_data_t);
+	data_ptr  = malloc(data_size);
+	data      = (UnitTestInterface_data_t *)data_ptr;
+	data_ts   = (interface_data_ts_t *)data_ptr;
+	memset(data_ptr, 0, data_size);
+	add_fieldinfo(IFT_UINT32, "record", 1, &data->record);
+	add_fieldinfo(IFT_UINT32, "values", UNIT_TEST_INTERFACE_NUM_VALUES, &data->values);
+	unsigned char tmp_hash[] = {0x75, 0x6e, 0x69, 0x74, 0x2d, 0x74, 0x65, 0x73,
+	                            0x74, 0x2d, 0x69, 0x66, 0x61, 0x63, 0x65, 0x01};
+	set_hash(tmp_hash);
+}
+
+/** Destructor. */
+UnitTestInterface::~UnitTestInterface()
+{
+	free(data_ptr);
+}
+
+/** Get record number.
+ * @return record number
+ */
+uint32_t
+UnitTestInterface::record() const
+{
+	return data->record;
+}
+
+/** Check if all values belong to the same record.
+ * @return true if all values equal the record number, false otherwise
+ */
+bool
+UnitTestInterface::consistent() const
+{
+	for (unsigned int i = 0; i < UNIT_TEST_INTERFACE_NUM_VALUES; ++i) {
+		if (data->values[i] != data->record) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Set record.
+ * Sets the record number and all values to it.
+ * @param record record number
+ */
+void
+UnitTestInterface::set_record(uint32_t record)
+{
+	data->record = record;
+	for (unsigned int i = 0; i < UNIT_TEST_INTERFACE_NUM_VALUES; ++i) {
+		data->values[i] = record;
+	}
+	data_changed = true;
+}
+
+Message *
+UnitTestInterface::create_message(const char *type) const
+{
+	throw UnknownTypeException("The given type '%s' does not match any known "
+	                           "message type for this interface type.",
+	                           type);
+}
+
+/** Copy values from other interface.
+ * @param other other interface to copy values from
+ */
+void
+UnitTestInterface::copy_values(const Interface *other)
+{
+	const UnitTestInterface *oi = dynamic_cast<const UnitTestInterface *>(other);
+	if (oi == NULL) {
+		throw TypeMismatchException("Can only copy values from interface of same type (%s vs. %s)",
+		                            type(),
+		                            other->type());
+	}
+	memcpy(data, oi->data, sizeof(UnitTestInterface_data_t));
+}
+
+const char *
+UnitTestInterface::enum_tostring(const char *enumtype, int val) const
+{
+	throw UnknownTypeException("Unknown enum type %s", enumtype);
+}
+
+/** Check if message is valid and can be enqueued.
+ * @param message Message to check
+ * @return true if the message is valid, false otherwise.
+ */
+bool
+UnitTestInterface::message_valid(const Message *message) const
+{
+	return false;
+}
+
+/// @cond INTERNALS
+EXPORT_INTERFACE(UnitTestInterface)
+/// @endcond
+
+} // end namespace fawkes
@@ -0,0 +1,68 @@
+/***************************************************************************
+ *  UnitTestInterface.h - Interface for BlackBoard unit tests
+ *
+ *  Created: Thu Oct 15 10:48:02 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_TESTS_UNIT_TEST_INTERFACE_H_
+#define _BLACKBOARD_TESTS_UNIT_TEST_INTERFACE_H_
+
+#include <interface/interface.h>
+
+/** Number of values of the UnitTestInterface. */
+#define UNIT_TEST_INTERFACE_NUM_VALUES 4096
+
+namespace fawkes {
+
+class UnitTestInterface : public Interface
+{
+	/// @cond INTERNALS
+	INTERFACE_MGMT_FRIENDS(UnitTestInterface)
+	/// @endcond
+private:
+	/** Internal data storage, do NOT modify! */
+	typedef struct
+	{
+		int64_t  timestamp_sec;                          /**< Interface Unix timestamp, seconds */
+		int64_t  timestamp_usec;                         /**< Interface Unix timestamp, micro-seconds */
+		uint32_t record;                                 /**< record number */
+		uint32_t values[UNIT_TEST_INTERFACE_NUM_VALUES]; /**< all equal to record */
+	} UnitTestInterface_data_t;
+
+	UnitTestInterface_data_t *data;
+
+public:
+	uint32_t record() const;
+	bool     consistent() const;
+	void     set_record(uint32_t record);
+
+	virtual Message *   create_message(const char *type) const;
+	virtual void        copy_values(const Interface *other);
+	virtual const char *enum_tostring(const char *enumtype, int val) const;
+
+protected:
+	virtual bool message_valid(const Message *message) const;
+
+private:
+	UnitTestInterface();
+	~UnitTestInterface();
+};
+
+} // end namespace fawkes
+
+#endif
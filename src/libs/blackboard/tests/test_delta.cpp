@@ -0,0 +1,213 @@
+/***************************************************************************
+ *  test_delta.cpp - BlackBoard data delta encoding tests
+ *
+ *  Created: Thu Oct 15 11:24:53 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <arpa/inet.h>
+#include <blackboard/net/delta.h>
+#include <blackboard/net/messages.h>
+
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+
+/** Encode delta into a buffer as big as the data.
+ * @param base data the receiver has
+ * @param data data to transmit
+ * @param delta upon return contains the encoded delta
+ * @return true if the delta is smaller than the data
+ */
+bool
+encode_delta(const std::vector<unsigned char> &base,
+             const std::vector<unsigned char> &data,
+             std::vector<unsigned char> &      delta)
+{
+	delta.resize(data.size());
+	size_t delta_size = 0;
+	bool   ok =
+	  blackboard_delta_encode(&base[0], &data[0], data.size(), &delta[0], delta.size(), delta_size);
+	delta.resize(ok ? delta_size : 0);
+	return ok;
+}
+
+/** Apply delta to data.
+ * @param data data to update
+ * @param delta delta to apply
+ * @return true if the delta has been applied
+ */
+bool
+apply_delta(std::vector<unsigned char> &data, const std::vector<unsigned char> &delta)
+{
+	return blackboard_delta_apply(&data[0], data.size(), delta.data(), delta.size());
+}
+
+/** Append a delta run.
+ * @param delta delta to append the run to
+ * @param skip number of unchanged bytes before the run
+ * @param xor_bytes bytes to XOR into the data
+ */
+void
+append_run(std::vector<unsigned char> &      delta,
+           uint32_t                          skip,
+           const std::vector<unsigned char> &xor_bytes)
+{
+	bb_idelta_run_t run;
+	run.skip   = htonl(skip);
+	run.length = htonl(xor_bytes.size());
+	delta.insert(delta.end(), (unsigned char *)&run, (unsigned char *)&run + sizeof(run));
+	delta.insert(delta.end(), xor_bytes.begin(), xor_bytes.end());
+}
+
+} // namespace
+
+TEST_CASE("Deltas reproduce the data", "[blackboard][delta]")
+{
+	std::mt19937                       gen(11);
+	std::uniform_int_distribution<int> byte(0, 255);
+	std::uniform_int_distribution<int> num_changes(0, 40);
+
+	const size_t               data_size = 1024;
+	std::vector<unsigned char> sent(data_size, 0);
+	std::vector<unsigned char> received(data_size, 0);
+	std::vector<unsigned char> delta;
+
+	// the first update differs in every byte, it must be sent in full
+	std::vector<unsigned char> data(data_size);
+	for (size_t i = 0; i < data_size; ++i) {
+		data[i] = 1 + byte(gen) % 255;
+	}
+	REQUIRE_FALSE(encode_delta(sent, data, delta));
+
+	// as a delta it would reproduce the data nonetheless
+	std::vector<unsigned char> full_delta(data_size + sizeof(bb_idelta_run_t));
+	size_t                     full_delta_size = 0;
+	REQUIRE(blackboard_delta_encode(
+	  &sent[0], &data[0], data_size, &full_delta[0], full_delta.size(), full_delta_size));
+	REQUIRE(full_delta_size == full_delta.size());
+	REQUIRE(blackboard_delta_apply(&received[0], data_size, &full_delta[0], full_delta_size));
+	REQUIRE(received == data);
+	sent = data;
+
+	std::uniform_int_distribution<size_t> pos(0, data_size - 1);
+	for (unsigned int k = 0; k < 200; ++k) {
+		int n = num_changes(gen);
+		for (int c = 0; c < n; ++c) {
+			data[pos(gen)] = byte(gen);
+		}
+		// changes at the borders
+		if (k % 7 == 0)
+			data[0] ^= 0x5a;
+		if (k % 11 == 0)
+			data[data_size - 1] ^= 0xa5;
+
+		INFO("update " << k << ", " << n << " changes");
+		REQUIRE(encode_delta(sent, data, delta));
+		if (data == sent) {
+			REQUIRE(delta.empty());
+		}
+		REQUIRE(apply_delta(received, delta));
+		REQUIRE(received == data);
+		sent = data;
+	}
+}
+
+TEST_CASE("Nearby changes share a run", "[blackboard][delta]")
+{
+	std::vector<unsigned char> base(64, 0);
+	std::vector<unsigned char> data(base);
+	std::vector<unsigned char> delta;
+
+	// the gap is shorter than a run header and bridged
+	data[10] = 1;
+	data[12] = 2;
+	REQUIRE(encode_delta(base, data, delta));
+	REQUIRE(delta.size() == sizeof(bb_idelta_run_t) + 3);
+
+	// a gap longer than a run header starts a new run
+	data[40] = 3;
+	REQUIRE(encode_delta(base, data, delta));
+	REQUIRE(delta.size() == 2 * sizeof(bb_idelta_run_t) + 3 + 1);
+
+	std::vector<unsigned char> received(base);
+	REQUIRE(apply_delta(received, delta));
+	REQUIRE(received == data);
+}
+
+TEST_CASE("Malformed deltas are rejected", "[blackboard][delta]")
+{
+	std::vector<unsigned char> base(256, 0);
+	std::vector<unsigned char> data(base);
+	data[100] = 1;
+	data[200] = 2;
+	std::vector<unsigned char> delta;
+	REQUIRE(encode_delta(base, data, delta));
+
+	std::vector<unsigned char> received(base);
+
+	SECTION("Size mismatch")
+	{
+		// the delta reaches beyond the end of smaller data
+		std::vector<unsigned char> smaller(150, 0);
+		REQUIRE_FALSE(apply_delta(smaller, delta));
+		REQUIRE(smaller == std::vector<unsigned char>(150, 0));
+	}
+
+	SECTION("Truncated delta")
+	{
+		// each change is encoded in a run of its own
+		const size_t run_size = sizeof(bb_idelta_run_t) + 1;
+		REQUIRE(delta.size() == 2 * run_size);
+		for (size_t size = 1; size < delta.size(); ++size) {
+			if (size == run_size)
+				continue;
+			std::vector<unsigned char> truncated(delta.begin(), delta.begin() + size);
+			INFO("truncated to " << size << " bytes");
+			REQUIRE_FALSE(apply_delta(received, truncated));
+		}
+	}
+
+	SECTION("Run beyond the end")
+	{
+		std::vector<unsigned char> corrupt;
+		append_run(corrupt, 0, {0xff});
+		append_run(corrupt, 300, {0xff});
+		REQUIRE_FALSE(apply_delta(received, corrupt));
+
+		corrupt.clear();
+		append_run(corrupt, 250, std::vector<unsigned char>(10, 0xff));
+		REQUIRE_FALSE(apply_delta(received, corrupt));
+
+		// skip and length that overflow when added
+		bb_idelta_run_t run;
+		run.skip   = htonl(0xffffffff);
+		run.length = htonl(2);
+		corrupt.assign((unsigned char *)&run, (unsigned char *)&run + sizeof(run));
+		corrupt.push_back(0xff);
+		corrupt.push_back(0xff);
+		REQUIRE_FALSE(apply_delta(received, corrupt));
+	}
+
+	// rejected deltas leave the data untouched
+	REQUIRE(received == base);
+}
@@ -0,0 +1,240 @@
+/***************************************************************************
+ *  test_interface_seqlock.cpp - Lock-free interface read tests
+ *
+ *  Created: Thu Oct 15 10:52:37 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "UnitTestInterface.h"
+
+#include <blackboard/bbconfig.h>
+#include <blackboard/internal/interface_mem_header.h>
+#include <blackboard/local.h>
+#include <blackboard/remote.h>
+#include <core/threading/read_write_lock.h>
+#include <interface/read_guard.h>
+#include <netcomm/fawkes/server_thread.h>
+
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+
+/** Port of the network server for remote BlackBoard tests. */
+#define TEST_PORT 19110
+
+namespace {
+
+/** Get memory header of the chunk an interface reads from.
+ * @param interface interface reading from a local BlackBoard
+ * @return memory header of the chunk
+ */
+interface_header_t *
+chunk_header(Interface *interface)
+{
+	InterfaceReadGuard guard(interface);
+	return (interface_header_t *)((char *)guard.datachunk() - sizeof(interface_header_t));
+}
+
+} // namespace
+
+TEST_CASE("Concurrent readers never see mixed records", "[blackboard][seqlock]")
+{
+	const unsigned int num_readers = 3;
+	const uint32_t     num_records = 20000;
+
+	std::unique_ptr<BlackBoard> bb(new LocalBlackBoard(BLACKBOARD_MEMSIZE));
+	UnitTestInterface *         writer = bb->open_for_writing<UnitTestInterface>("seqlock");
+	std::vector<UnitTestInterface *> readers;
+	for (unsigned int i = 0; i < num_readers; ++i) {
+		readers.push_back(bb->open_for_reading<UnitTestInterface>("seqlock"));
+	}
+
+	std::atomic<bool>         done(false);
+	std::atomic<unsigned int> num_reads(0);
+	std::atomic<unsigned int> num_mixed(0);
+	std::atomic<unsigned int> num_backwards(0);
+
+	std::vector<std::thread> threads;
+	for (UnitTestInterface *reader : readers) {
+		threads.emplace_back([&, reader]() {
+			uint32_t last = 0;
+			while (!done.load()) {
+				reader->read();
+				if (!reader->consistent())
+					++num_mixed;
+				if (reader->record() < last)
+					++num_backwards;
+				last = reader->record();
+				++num_reads;
+			}
+		});
+	}
+	std::thread writer_thread([&]() {
+		for (uint32_t r = 1; r <= num_records; ++r) {
+			writer->set_record(r);
+			writer->write();
+		}
+		done.store(true);
+	});
+
+	writer_thread.join();
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	INFO(num_reads.load() << " reads");
+	REQUIRE(num_reads.load() > 0);
+	REQUIRE(num_mixed.load() == 0);
+	REQUIRE(num_backwards.load() == 0);
+
+	for (UnitTestInterface *reader : readers) {
+		reader->read();
+		REQUIRE(reader->record() == num_records);
+		REQUIRE(reader->consistent());
+		bb->close(reader);
+	}
+	bb->close(writer);
+}
+
+TEST_CASE("Read falls back to the lock while a write is in progress", "[blackboard][seqlock]")
+{
+	Interface::set_stats_enabled(true);
+
+	std::unique_ptr<BlackBoard> bb(new LocalBlackBoard(BLACKBOARD_MEMSIZE));
+	UnitTestInterface *         writer = bb->open_for_writing<UnitTestInterface>("seqlock");
+	UnitTestInterface *         reader = bb->open_for_reading<UnitTestInterface>("seqlock");
+	writer->set_record(1);
+	writer->write();
+	reader->read();
+	REQUIRE(reader->record() == 1);
+
+	interface_header_t *ih         = chunk_header(reader);
+	char *              shared     = (char *)ih + sizeof(interface_header_t);
+	const size_t        half       = writer->datasize() / 2;
+	const uint64_t      num_locked = reader->stats().num_read_locked;
+
+	// act like a writer that is half way through writing record 2, it
+	// holds the chunk's write lock and the sequence number is odd
+	ReadWriteLock chunk_lock(&ih->rwlock, /* initialize */ false);
+	chunk_lock.lock_for_write();
+	uint32_t seq = __atomic_load_n(&ih->data_seq, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&ih->data_seq, seq + 1, __ATOMIC_RELEASE);
+	writer->set_record(2);
+	memcpy(shared, writer->datachunk(), half);
+
+	std::atomic<bool> read_done(false);
+	std::thread       read_thread([&]() {
+		reader->read();
+		read_done.store(true);
+	});
+
+	// all optimistic attempts fail, the reader must wait for the lock
+	usleep(200000);
+	bool blocked = !read_done.load();
+
+	memcpy(shared + half, (const char *)writer->datachunk() + half, writer->datasize() - half);
+	__atomic_store_n(&ih->data_seq, seq + 2, __ATOMIC_RELEASE);
+	chunk_lock.unlock();
+	read_thread.join();
+
+	REQUIRE(blocked);
+	REQUIRE(reader->record() == 2);
+	REQUIRE(reader->consistent());
+	REQUIRE(reader->stats().num_read_locked == num_locked + 1);
+
+	// the fallback recorded an even sequence number, nothing left to copy
+	REQUIRE_FALSE(reader->read_if_changed());
+
+	bb->close(reader);
+	bb->close(writer);
+	Interface::set_stats_enabled(false);
+}
+
+TEST_CASE("Remote reader attached to shared memory never uses its own lock",
+          "[blackboard][seqlock][remote]")
+{
+	Interface::set_stats_enabled(true);
+
+	std::string      token = "fawkes-unit-test-" + std::to_string(getpid());
+	LocalBlackBoard *lbb   = new LocalBlackBoard(BLACKBOARD_MEMSIZE, token.c_str(), true);
+	FawkesNetworkServerThread *fns =
+	  new FawkesNetworkServerThread(true, false, "127.0.0.1", "::", TEST_PORT);
+	fns->start();
+	lbb->start_nethandler(fns);
+
+	BlackBoard *       bb     = lbb;
+	BlackBoard *       rbb    = new RemoteBlackBoard("localhost", TEST_PORT);
+	UnitTestInterface *writer = bb->open_for_writing<UnitTestInterface>("seqlock");
+	UnitTestInterface *reader = rbb->open_for_reading<UnitTestInterface>("seqlock");
+	writer->set_record(1);
+	writer->write();
+	// the segment is attached read-only, reads must not update statistics
+	const uint64_t num_reads = writer->stats().num_reads;
+	reader->read();
+	REQUIRE(reader->record() == 1);
+	REQUIRE(writer->stats().num_reads == num_reads);
+
+	interface_header_t *ih     = chunk_header(writer);
+	char *              shared = (char *)ih + sizeof(interface_header_t);
+	const size_t        half   = writer->datasize() / 2;
+
+	// act like a writer that is half way through writing record 2, the
+	// local lock of the remote reader does not know about it, a reader
+	// that receives data over the network would return immediately
+	ReadWriteLock chunk_lock(&ih->rwlock, /* initialize */ false);
+	chunk_lock.lock_for_write();
+	uint32_t seq = __atomic_load_n(&ih->data_seq, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&ih->data_seq, seq + 1, __ATOMIC_RELEASE);
+	writer->set_record(2);
+	memcpy(shared, writer->datachunk(), half);
+
+	std::atomic<bool> read_done(false);
+	std::thread       read_thread([&]() {
+		reader->read();
+		read_done.store(true);
+	});
+
+	// the reader must keep retrying until the write has been completed
+	usleep(200000);
+	bool blocked = !read_done.load();
+
+	memcpy(shared + half, (const char *)writer->datachunk() + half, writer->datasize() - half);
+	__atomic_store_n(&ih->data_seq, seq + 2, __ATOMIC_RELEASE);
+	chunk_lock.unlock();
+	read_thread.join();
+
+	REQUIRE(blocked);
+	REQUIRE(reader->record() == 2);
+	REQUIRE(reader->consistent());
+	REQUIRE_FALSE(reader->read_if_changed());
+
+	rbb->close(reader);
+	bb->close(writer);
+	delete rbb;
+	delete lbb;
+	fns->cancel();
+	fns->join();
+	delete fns;
+	Interface::set_stats_enabled(false);
+}
@@ -0,0 +1,162 @@
+/***************************************************************************
+ *  test_memory_manager.cpp - BlackBoard memory manager size class tests
+ *
+ *  Created: Thu Oct 15 11:06:41 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <blackboard/internal/memory_manager.h>
+#include <core/exceptions/system.h>
+
+#include <catch2/catch.hpp>
+
+using namespace fawkes;
+
+TEST_CASE("Size class allocations are rounded up", "[blackboard][memory_manager]")
+{
+	BlackBoardMemoryManager mm(16384);
+	mm.set_allocation_strategy(BlackBoardMemoryManager::ALLOC_SIZE_CLASSES);
+	REQUIRE(mm.allocation_strategy() == BlackBoardMemoryManager::ALLOC_SIZE_CLASSES);
+
+	mm.alloc(100);
+	REQUIRE(mm.allocated_size() == 128);
+	REQUIRE(mm.overhang_size() == 28);
+
+	// the smallest size class has 64 bytes
+	mm.alloc(10);
+	REQUIRE(mm.allocated_size() == 128 + 64);
+	REQUIRE(mm.overhang_size() == 28 + 54);
+
+	mm.alloc(64);
+	REQUIRE(mm.allocated_size() == 128 + 64 + 64);
+	REQUIRE(mm.overhang_size() == 28 + 54);
+
+	REQUIRE(mm.size_class_misses() == 3);
+	REQUIRE(mm.size_class_hits() == 0);
+	REQUIRE_NOTHROW(mm.check());
+}
+
+TEST_CASE("Freed chunks are cached by their lower size class", "[blackboard][memory_manager]")
+{
+	BlackBoardMemoryManager mm(16384);
+
+	// allocated with best fit, the chunk has exactly 100 bytes
+	void *p = mm.alloc(100);
+	REQUIRE(mm.allocated_size() == 100);
+
+	mm.set_allocation_strategy(BlackBoardMemoryManager::ALLOC_SIZE_CLASSES);
+	mm.free(p);
+	REQUIRE(mm.num_cached_chunks() == 1);
+	REQUIRE(mm.cached_size() == 100);
+	REQUIRE_NOTHROW(mm.check());
+
+	// 100 bytes round up to 128, the cached chunk is too small for that
+	void *q = mm.alloc(100);
+	REQUIRE(q != p);
+	REQUIRE(mm.size_class_misses() == 1);
+	REQUIRE(mm.num_cached_chunks() == 1);
+
+	// but it is big enough for every allocation of the 64 bytes class
+	REQUIRE(mm.alloc(64) == p);
+	REQUIRE(mm.size_class_hits() == 1);
+	REQUIRE(mm.num_cached_chunks() == 0);
+	REQUIRE(mm.overhang_size() == (128 - 100) + (100 - 64));
+
+	mm.free(q);
+	REQUIRE(mm.cached_size() == 128);
+	REQUIRE(mm.alloc(65) == q);
+	REQUIRE(mm.size_class_hits() == 2);
+	REQUIRE(mm.size_class_flushes() == 0);
+	REQUIRE_NOTHROW(mm.check());
+}
+
+TEST_CASE("Cached chunks are merged if memory runs out", "[blackboard][memory_manager]")
+{
+	const unsigned int      memsize = 4096;
+	BlackBoardMemoryManager mm(memsize);
+	mm.set_allocation_strategy(BlackBoardMemoryManager::ALLOC_SIZE_CLASSES);
+
+	SECTION("Flush and retry")
+	{
+		void *chunks[8];
+		for (unsigned int i = 0; i < 8; ++i) {
+			chunks[i] = mm.alloc(200);
+		}
+		for (unsigned int i = 0; i < 8; ++i) {
+			mm.free(chunks[i]);
+		}
+		REQUIRE(mm.num_cached_chunks() == 8);
+		REQUIRE(mm.max_free_size() < 2048);
+
+		mm.alloc(2000);
+		REQUIRE(mm.size_class_flushes() == 1);
+		REQUIRE(mm.num_cached_chunks() == 0);
+		REQUIRE(mm.allocated_size() == 2048);
+		REQUIRE_NOTHROW(mm.check());
+	}
+
+	SECTION("Exact size as last resort")
+	{
+		// 3000 bytes round up to 4096, which does not fit in any case
+		mm.alloc(3000);
+		REQUIRE(mm.allocated_size() == 3000);
+		REQUIRE(mm.size_class_flushes() == 0);
+
+		REQUIRE_THROWS_AS(mm.alloc(2000), OutOfMemoryException);
+		REQUIRE(mm.allocated_size() == 3000);
+		REQUIRE_NOTHROW(mm.check());
+	}
+}
+
+TEST_CASE("Switching strategies does not fragment memory", "[blackboard][memory_manager]")
+{
+	const unsigned int      memsize = 16384;
+	BlackBoardMemoryManager mm(memsize);
+
+	void *a = mm.alloc(100);
+	void *b = mm.alloc(300);
+	void *c = mm.alloc(1000);
+
+	mm.set_allocation_strategy(BlackBoardMemoryManager::ALLOC_SIZE_CLASSES);
+	mm.free(a);
+	mm.free(b);
+	REQUIRE(mm.num_cached_chunks() == 2);
+	REQUIRE(mm.fragmentation() > 0.f);
+	REQUIRE_NOTHROW(mm.check());
+
+	// best fit chunks are re-used by size classes they are big enough for
+	REQUIRE(mm.alloc(200) == b);
+	REQUIRE(mm.alloc(50) == a);
+	REQUIRE(mm.size_class_hits() == 2);
+	REQUIRE(mm.size_class_misses() == 0);
+	mm.free(a);
+	mm.free(b);
+
+	// switching back merges the cached chunks
+	mm.set_allocation_strategy(BlackBoardMemoryManager::ALLOC_BEST_FIT);
+	REQUIRE(mm.num_cached_chunks() == 0);
+	REQUIRE(mm.size_class_flushes() == 1);
+	REQUIRE(mm.num_free_chunks() == 2);
+	REQUIRE_NOTHROW(mm.check());
+
+	mm.free(c);
+	REQUIRE(mm.num_allocated_chunks() == 0);
+	REQUIRE(mm.num_free_chunks() == 1);
+	REQUIRE(mm.max_free_size() == memsize - sizeof(chunk_list_t));
+	REQUIRE(mm.fragmentation() == 0.f);
+	REQUIRE_NOTHROW(mm.check());
+}
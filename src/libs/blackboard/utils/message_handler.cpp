@@ -0,0 +1,324 @@
+
+/***************************************************************************
+ *  message_handler.cpp - Handle BlackBoard messages asynchronously
+ *
+ *  Created: Thu Oct 15 09:06:25 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <blackboard/blackboard.h>
+#include <blackboard/utils/message_handler.h>
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <interface/interface.h>
+#include <interface/message.h>
+#include <logging/liblogger.h>
+
+#include <vector>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+/** Number of threads executing message handlers. */
+#define BB_MESSAGE_HANDLER_THREADS 2
+
+class BlackBoardMessageHandlerWorker : public Thread
+{
+public:
+	BlackBoardMessageHandlerWorker(BlackBoardMessageHandlerPool *pool, unsigned int i);
+
+	virtual void loop();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	BlackBoardMessageHandlerPool *pool_;
+};
+
+/** Threads shared by all message handlers.
+ * Handlers with pending messages are kept in a ready list. A handler is
+ * processed by at most one worker at a time, hence messages of one
+ * interface are handled in the order they have been received.
+ */
+class BlackBoardMessageHandlerPool
+{
+public:
+	BlackBoardMessageHandlerPool() : executed_cond_(&mutex_), started_(false)
+	{
+	}
+
+	~BlackBoardMessageHandlerPool()
+	{
+		for (BlackBoardMessageHandlerWorker *w : workers_) {
+			w->cancel();
+			w->join();
+			delete w;
+		}
+	}
+
+	static BlackBoardMessageHandlerPool &
+	instance()
+	{
+		static BlackBoardMessageHandlerPool pool;
+		return pool;
+	}
+
+	void
+	push(BlackBoardMessageHandler *handler, Message *message)
+	{
+		MutexLocker lock(&mutex_);
+		if (!started_) {
+			started_ = true;
+			for (unsigned int i = 0; i < BB_MESSAGE_HANDLER_THREADS; ++i) {
+				workers_.push_back(new BlackBoardMessageHandlerWorker(this, i));
+				workers_.back()->start();
+			}
+		}
+		message->ref();
+		handler->pending_.push_back(message);
+		if (!handler->ready_ && !handler->executor_) {
+			handler->ready_ = true;
+			ready_.push_back(handler);
+			for (BlackBoardMessageHandlerWorker *w : workers_) {
+				w->wakeup();
+			}
+		}
+	}
+
+	void
+	remove(BlackBoardMessageHandler *handler)
+	{
+		MutexLocker lock(&mutex_);
+		if (handler->ready_) {
+			ready_.remove(handler);
+			handler->ready_ = false;
+		}
+		while (handler->executor_) {
+			executed_cond_.wait();
+		}
+		for (Message *m : handler->pending_) {
+			m->unref();
+		}
+		handler->pending_.clear();
+	}
+
+	unsigned int
+	num_handled(const BlackBoardMessageHandler *handler)
+	{
+		MutexLocker lock(&mutex_);
+		return handler->num_handled_;
+	}
+
+	void
+	process(Thread *worker)
+	{
+		std::list<Message *> messages;
+
+		mutex_.lock();
+		while (!ready_.empty()) {
+			BlackBoardMessageHandler *handler = ready_.front();
+			ready_.pop_front();
+			handler->ready_    = false;
+			handler->executor_ = worker;
+			messages.swap(handler->pending_);
+			mutex_.unlock();
+
+			Thread::CancelState old_state;
+			worker->set_cancel_state(Thread::CANCEL_DISABLED, &old_state);
+			handler->run_handlers(messages);
+			worker->set_cancel_state(old_state);
+
+			mutex_.lock();
+			handler->num_handled_ += messages.size();
+			for (Message *m : messages) {
+				m->unref();
+			}
+			messages.clear();
+			handler->executor_ = NULL;
+			if (!handler->pending_.empty()) {
+				handler->ready_ = true;
+				ready_.push_back(handler);
+			}
+			executed_cond_.wake_all();
+		}
+		mutex_.unlock();
+	}
+
+private:
+	Mutex                                         mutex_;
+	WaitCondition                                 executed_cond_;
+	bool                                          started_;
+	std::vector<BlackBoardMessageHandlerWorker *> workers_;
+	std::list<BlackBoardMessageHandler *>         ready_;
+};
+
+BlackBoardMessageHandlerWorker::BlackBoardMessageHandlerWorker(BlackBoardMessageHandlerPool *pool,
+                                                               unsigned int                  i)
+: Thread("BlackBoardMessageHandler", Thread::OPMODE_WAITFORWAKEUP), pool_(pool)
+{
+	set_name("BlackBoardMessageHandler-%u", i);
+}
+
+void
+BlackBoardMessageHandlerWorker::loop()
+{
+	pool_->process(this);
+}
+/// @endcond
+
+/** @class BlackBoardMessageHandler <blackboard/utils/message_handler.h>
+ * Handle BlackBoard messages asynchronously.
+ * Writers usually process their message queue in loop(), hence a message
+ * takes effect up to one main loop period after it has been sent. With
+ * this utility class a writer registers handlers for specific message
+ * types instead. Messages of these types are passed to the handler right
+ * after they have been received, executed by a small pool of threads
+ * shared by all handlers. Messages of one interface are handled one after
+ * another in the order they have been received. Messages for which no
+ * handler is registered are appended to the message queue as usual.
+ *
+ * This is meant for messages which must take effect immediately, like an
+ * emergency stop or cancelling a skill. Handlers run concurrently to the
+ * writer's loop and must synchronize access to shared data. A handler
+ * may decide to also enqueue its messages, e.g. to have the loop update
+ * the interface data accordingly.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param bb blackboard to register with
+ * @param interface writing interface to handle messages of
+ */
+BlackBoardMessageHandler::BlackBoardMessageHandler(BlackBoard *bb, Interface *interface)
+: BlackBoardInterfaceListener("MessageHandler[%s]", interface->uid()),
+  bb_(bb),
+  ready_(false),
+  executor_(NULL),
+  num_handled_(0)
+{
+	handlers_mutex_ = new Mutex();
+	bbil_add_message_interface(interface);
+	bb_->register_listener(this, BlackBoard::BBIL_FLAG_MESSAGES);
+}
+
+/** Destructor.
+ * Unregisters from the blackboard. Waits for running handlers to finish,
+ * hence the message handler must not be deleted from one of its handlers.
+ * Messages not yet handled are dropped.
+ */
+BlackBoardMessageHandler::~BlackBoardMessageHandler()
+{
+	bb_->unregister_listener(this);
+	BlackBoardMessageHandlerPool::instance().remove(this);
+	delete handlers_mutex_;
+}
+
+/** Add handler for a message type.
+ * A handler registered before for the same type is replaced.
+ * @param message_type type of messages to handle, as returned by Message::type()
+ * @param handler handler to call for each message of the given type
+ * @param enqueue true to also append the message to the message queue of
+ * the interface, false to only pass it to the handler
+ */
+void
+BlackBoardMessageHandler::add_handler(const char *message_type, Handler handler, bool enqueue)
+{
+	MutexLocker lock(handlers_mutex_);
+	HandlerEntry &e = handlers_[message_type];
+	e.handler       = handler;
+	e.enqueue       = enqueue;
+}
+
+/** Remove handler for a message type.
+ * Further messages of this type are enqueued as usual.
+ * @param message_type type of messages
+ */
+void
+BlackBoardMessageHandler::remove_handler(const char *message_type)
+{
+	MutexLocker lock(handlers_mutex_);
+	handlers_.erase(message_type);
+}
+
+/** Get number of handled messages.
+ * @return number of messages passed to handlers so far
+ */
+unsigned int
+BlackBoardMessageHandler::num_handled() const
+{
+	return BlackBoardMessageHandlerPool::instance().num_handled(this);
+}
+
+bool
+BlackBoardMessageHandler::bb_interface_message_received(Interface *interface,
+                                                        Message *  message) noexcept
+{
+	bool enqueue;
+	{
+		MutexLocker                                   lock(handlers_mutex_);
+		std::map<std::string, HandlerEntry>::iterator h = handlers_.find(message->type());
+		if (h == handlers_.end()) {
+			return true;
+		}
+		enqueue = h->second.enqueue;
+	}
+
+	BlackBoardMessageHandlerPool::instance().push(this, message);
+	return enqueue;
+}
+
+/** Run handlers for messages.
+ * Called from a pool thread.
+ * @param messages messages to handle
+ */
+void
+BlackBoardMessageHandler::run_handlers(std::list<Message *> &messages)
+{
+	for (Message *m : messages) {
+		Handler handler;
+		{
+			MutexLocker                                   lock(handlers_mutex_);
+			std::map<std::string, HandlerEntry>::iterator h = handlers_.find(m->type());
+			if (h == handlers_.end()) {
+				// removed meanwhile
+				continue;
+			}
+			handler = h->second.handler;
+		}
+
+		try {
+			handler(m);
+		} catch (Exception &e) {
+			LibLogger::log_warn(bbil_name(), "Handler for %s failed", m->type());
+			LibLogger::log_warn(bbil_name(), e);
+		} catch (std::exception &e) {
+			LibLogger::log_warn(bbil_name(), "Handler for %s failed: %s", m->type(), e.what());
+		}
+	}
+}
+
+} // end namespace fawkes
@@ -0,0 +1,99 @@
+
+/***************************************************************************
+ *  message_handler.h - Handle BlackBoard messages asynchronously
+ *
+ *  Created: Thu Oct 15 09:06:25 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_UTILS_MESSAGE_HANDLER_H_
+#define _BLACKBOARD_UTILS_MESSAGE_HANDLER_H_
+
+#include <blackboard/interface_listener.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+
+namespace fawkes {
+
+class BlackBoard;
+class Interface;
+class Message;
+class Mutex;
+class Thread;
+class BlackBoardMessageHandlerPool;
+
+class BlackBoardMessageHandler : public BlackBoardInterfaceListener
+{
+	friend BlackBoardMessageHandlerPool;
+
+public:
+	/** Handler function for a message type. */
+	typedef std::function<void(Message *)> Handler;
+
+	BlackBoardMessageHandler(BlackBoard *bb, Interface *interface);
+	virtual ~BlackBoardMessageHandler();
+
+	void add_handler(const char *message_type, Handler handler, bool enqueue = false);
+	void remove_handler(const char *message_type);
+
+	/** Add handler for a message type.
+	 * @param handler handler to call for each message of type MT
+	 * @param enqueue true to also append the message to the message queue
+	 * of the interface, false to only pass it to the handler */
+	template <class MT>
+	void
+	add_handler(std::function<void(MT *)> handler, bool enqueue = false)
+	{
+		MT m;
+		add_handler(
+		  m.type(), [handler](Message *msg) { handler(static_cast<MT *>(msg)); }, enqueue);
+	}
+
+	unsigned int num_handled() const;
+
+	virtual bool bb_interface_message_received(Interface *interface, Message *message) noexcept;
+
+private:
+	void run_handlers(std::list<Message *> &messages);
+
+private:
+	/** Registered handler. */
+	typedef struct
+	{
+		Handler handler; ///< function to call
+		bool    enqueue; ///< true to also enqueue the message
+	} HandlerEntry;
+
+	BlackBoard *bb_;
+	Mutex *     handlers_mutex_;
+
+	std::map<std::string, HandlerEntry> handlers_;
+
+	// guarded by the pool mutex
+	std::list<Message *> pending_;
+	bool                 ready_;
+	Thread *             executor_;
+	unsigned int         num_handled_;
+};
+
+} // end namespace fawkes
+
+#endif
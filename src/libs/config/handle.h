@@ -0,0 +1,222 @@
+
+/***************************************************************************
+ *  handle.h - Fawkes configuration value handle
+ *
+ *  Created: Thu Oct 15 06:39:21 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CONFIG_HANDLE_H_
+#define _CONFIG_HANDLE_H_
+
+#include <config/change_handler.h>
+#include <config/config.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+inline void
+config_handle_read(Configuration *config, const char *path, float &v)
+{
+	v = config->get_float(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, unsigned int &v)
+{
+	v = config->get_uint(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, int &v)
+{
+	v = config->get_int(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, bool &v)
+{
+	v = config->get_bool(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, std::string &v)
+{
+	v = config->get_string(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, std::vector<float> &v)
+{
+	v = config->get_floats(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, std::vector<unsigned int> &v)
+{
+	v = config->get_uints(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, std::vector<int> &v)
+{
+	v = config->get_ints(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, std::vector<bool> &v)
+{
+	v = config->get_bools(path);
+}
+
+inline void
+config_handle_read(Configuration *config, const char *path, std::vector<std::string> &v)
+{
+	v = config->get_strings(path);
+}
+/// @endcond
+
+/** @class ConfigHandle <config/handle.h>
+ * Typed handle to a configuration value.
+ * The handle reads the value once on first access and afterwards returns
+ * the cached value. It registers as a change handler for its path and
+ * reads the value again after it has been changed or erased, for
+ * example when a configuration file was modified. Use it for values
+ * that are read in a loop or for each received message.
+ *
+ * The type must be one of float, unsigned int, int, bool, std::string,
+ * or a std::vector of these.
+ * @author agent
+ */
+template <typename T>
+class ConfigHandle : public ConfigurationChangeHandler
+{
+public:
+	/** Constructor.
+	 * get() throws if the value does not exist.
+	 * @param config configuration to read the value from
+	 * @param path path of the value
+	 */
+	ConfigHandle(Configuration *config, const char *path)
+	: ConfigurationChangeHandler(path), config_(config), path_(path)
+	{
+		has_default_ = false;
+		valid_       = false;
+		config_->add_change_handler(this);
+	}
+
+	/** Constructor with default value.
+	 * @param config configuration to read the value from
+	 * @param path path of the value
+	 * @param default_value value returned by get() if the value does not exist
+	 */
+	ConfigHandle(Configuration *config, const char *path, const T &default_value)
+	: ConfigurationChangeHandler(path), config_(config), path_(path), default_(default_value)
+	{
+		has_default_ = true;
+		valid_       = false;
+		config_->add_change_handler(this);
+	}
+
+	/** Destructor. */
+	virtual ~ConfigHandle()
+	{
+		config_->rem_change_handler(this);
+	}
+
+	/** Get value.
+	 * @return current value
+	 * @exception ConfigEntryNotFoundException thrown if the value does not
+	 * exist and no default value was given
+	 */
+	T
+	get()
+	{
+		MutexLocker lock(&mutex_);
+		if (!valid_) {
+			try {
+				config_handle_read(config_, path_.c_str(), value_);
+			} catch (ConfigEntryNotFoundException &e) {
+				if (!has_default_)
+					throw;
+				value_ = default_;
+			}
+			valid_ = true;
+		}
+		return value_;
+	}
+
+	/** Get path of the value.
+	 * @return path of the value
+	 */
+	const std::string &
+	path() const
+	{
+		return path_;
+	}
+
+	/** Discard the cached value, it is read again on the next access. */
+	void
+	invalidate()
+	{
+		MutexLocker lock(&mutex_);
+		valid_ = false;
+	}
+
+	virtual void
+	config_tag_changed(const char *new_tag)
+	{
+		invalidate();
+	}
+
+	virtual void
+	config_value_changed(const Configuration::ValueIterator *v)
+	{
+		invalidate();
+	}
+
+	virtual void
+	config_comment_changed(const Configuration::ValueIterator *v)
+	{
+	}
+
+	virtual void
+	config_value_erased(const char *path)
+	{
+		invalidate();
+	}
+
+private:
+	Configuration *   config_;
+	const std::string path_;
+	bool              has_default_;
+	T                 default_;
+
+	Mutex mutex_;
+	bool  valid_;
+	T     value_;
+};
+
+} // end namespace fawkes
+
+#endif
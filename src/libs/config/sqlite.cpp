@@ -24,6 +24,7 @@
 #include <core/exceptions/software.h>
 #include <core/exceptions/system.h>
 #include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 
 #include <sqlite3.h>
 
@@ -127,6 +128,15 @@ namespace fawkes {
 
 #define SQL_SELECT_ALL_DEFAULT "SELECT *, 1 AS is_default FROM defaults.config"
 
+#define SQL_SELECT_CACHE_HOST "SELECT path, type, value, comment FROM config"
+
+#define SQL_SELECT_CACHE_DEFAULT "SELECT path, type, value, comment FROM defaults.config"
+
+#define SQL_SELECT_CACHE_HOST_PATH "SELECT path, type, value, comment FROM config WHERE path=?"
+
+#define SQL_SELECT_CACHE_DEFAULT_PATH \
+	"SELECT path, type, value, comment FROM defaults.config WHERE path=?"
+
 #define SQL_SELECT_ALL_HOSTSPECIFIC "SELECT *, 0 AS is_default FROM config"
 
 #define SQL_DELETE_VALUE "DELETE FROM config WHERE path=?"
@@ -230,6 +240,11 @@ SQLiteConfiguration::SQLiteConfiguration(const char *sysconfdir, const char *use
 /** Destructor. */
 SQLiteConfiguration::~SQLiteConfiguration()
 {
+	for (auto &st : stmt_cache_) {
+		sqlite3_finalize(st.second);
+	}
+	stmt_cache_.clear();
+
 	if (opened) {
 		opened = false;
 		if (sqlite3_close(db) == SQLITE_BUSY) {
@@ -541,6 +556,10 @@ SQLiteConfiguration::transaction_rollback()
 	if ((sqlite3_exec(db, sql, NULL, NULL, &errmsg) != SQLITE_OK)) {
 		throw ConfigurationException("Could not rollback transaction (%s)", errmsg);
 	}
+
+	// values written during the transaction are in the cache
+	MutexLocker lock(mutex);
+	load_cache();
 }
 
 void
@@ -703,6 +722,8 @@ SQLiteConfiguration::load(const char *file_path)
 	if (host_name)
 		free(host_name);
 
+	load_cache();
+
 	opened = true;
 
 	mutex->unlock();
@@ -743,119 +764,43 @@ SQLiteConfiguration::copy(Configuration *copyconf)
 bool
 SQLiteConfiguration::exists(const char *path)
 {
-	mutex->lock();
-	sqlite3_stmt *stmt;
-	const char *  tail;
-	bool          e;
-
-	if (sqlite3_prepare(db, SQL_SELECT_TYPE, -1, &stmt, &tail) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("exists/prepare", sqlite3_errmsg(db));
-	}
-	if (sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("exists/bind/path", sqlite3_errmsg(db));
-	}
-	if (sqlite3_bind_text(stmt, 2, path, -1, NULL) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("exists/bind/path", sqlite3_errmsg(db));
-	}
-	e = (sqlite3_step(stmt) == SQLITE_ROW);
-	sqlite3_finalize(stmt);
-
-	mutex->unlock();
-	return e;
+	MutexLocker lock(mutex);
+	bool        is_default;
+	return (cached_value(path, is_default) != NULL);
 }
 
 std::string
 SQLiteConfiguration::get_type(const char *path)
 {
-	sqlite3_stmt *stmt;
-	const char *  tail;
-	std::string   s = "";
-
-	mutex->lock();
-
-	if (sqlite3_prepare(db, SQL_SELECT_TYPE, -1, &stmt, &tail) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("get_type: Preparation SQL failed");
-	}
-	if (sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("get_type: Binding text for path failed (1)");
-	}
-	if (sqlite3_bind_text(stmt, 2, path, -1, NULL) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("get_type: Binding text for path failed (2)");
-	}
-	if (sqlite3_step(stmt) == SQLITE_ROW) {
-		s = (char *)sqlite3_column_text(stmt, 0);
-		sqlite3_finalize(stmt);
-		mutex->unlock();
-		return s;
-	} else {
-		sqlite3_finalize(stmt);
-		mutex->unlock();
+	MutexLocker        lock(mutex);
+	bool               is_default;
+	const CachedValue *v = cached_value(path, is_default);
+	if (!v) {
 		throw ConfigEntryNotFoundException(path);
 	}
+	return v->type;
 }
 
 std::string
 SQLiteConfiguration::get_comment(const char *path)
 {
-	sqlite3_stmt *stmt;
-	const char *  tail;
-	std::string   s = "";
-
-	mutex->lock();
-
-	if (sqlite3_prepare(db, SQL_SELECT_COMMENT, -1, &stmt, &tail) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("get_comment: Preparation SQL failed");
-	}
-	if (sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("get_comment: Binding text for path failed (1)");
-	}
-	if (sqlite3_step(stmt) == SQLITE_ROW) {
-		s = (char *)sqlite3_column_text(stmt, 0);
-		sqlite3_finalize(stmt);
-		mutex->unlock();
-		return s;
-	} else {
-		sqlite3_finalize(stmt);
-		mutex->unlock();
+	MutexLocker                lock(mutex);
+	ValueCache::const_iterator v = host_cache_.find(path);
+	if (v == host_cache_.end()) {
 		throw ConfigEntryNotFoundException(path);
 	}
+	return v->second.comment;
 }
 
 std::string
 SQLiteConfiguration::get_default_comment(const char *path)
 {
-	sqlite3_stmt *stmt;
-	const char *  tail;
-	std::string   s = "";
-
-	mutex->lock();
-
-	if (sqlite3_prepare(db, SQL_SELECT_DEFAULT_COMMENT, -1, &stmt, &tail) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("get_default_comment: Preparation SQL failed");
-	}
-	if (sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("get_default_comment: Binding text for path failed (1)");
-	}
-	if (sqlite3_step(stmt) == SQLITE_ROW) {
-		s = (char *)sqlite3_column_text(stmt, 0);
-		sqlite3_finalize(stmt);
-		mutex->unlock();
-		return s;
-	} else {
-		sqlite3_finalize(stmt);
-		mutex->unlock();
+	MutexLocker                lock(mutex);
+	ValueCache::const_iterator v = default_cache_.find(path);
+	if (v == default_cache_.end()) {
 		throw ConfigEntryNotFoundException(path);
 	}
+	return v->second.comment;
 }
 
 bool
@@ -897,161 +842,97 @@ SQLiteConfiguration::is_list(const char *path)
 bool
 SQLiteConfiguration::is_default(const char *path)
 {
-	mutex->lock();
-	sqlite3_stmt *stmt;
-	const char *  tail;
-	bool          e;
-
-	if (sqlite3_prepare(db, SQL_SELECT_TYPE, -1, &stmt, &tail) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("is_default/prepare", sqlite3_errmsg(db));
-	}
-	if (sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("is_default/bind/path", sqlite3_errmsg(db));
-	}
-	if (sqlite3_bind_text(stmt, 2, path, -1, NULL) != SQLITE_OK) {
-		mutex->unlock();
-		throw ConfigurationException("is_default/bind/path", sqlite3_errmsg(db));
-	}
-	e = ((sqlite3_step(stmt) == SQLITE_ROW) && (sqlite3_column_int(stmt, 1) == 1));
-	sqlite3_finalize(stmt);
-
-	mutex->unlock();
-	return e;
+	MutexLocker lock(mutex);
+	bool        is_default;
+	return (cached_value(path, is_default) != NULL) && is_default;
 }
 
-/** Get a value from the database.
+/** Get a value from the cache.
+ * The host-specific value is returned if it exists, the default value
+ * otherwise. Must be called with the mutex locked.
  * @param path path
- * @param type desired value, NULL to omit type check
+ * @param is_default upon return true if the default value was returned
+ * @return cached value, NULL if the path does not exist
  */
-sqlite3_stmt *
-SQLiteConfiguration::get_typed_value(const char *path, const char *type)
+const SQLiteConfiguration::CachedValue *
+SQLiteConfiguration::cached_value(const char *path, bool &is_default) const
 {
-	sqlite3_stmt *stmt;
-	const char *  tail;
-
-	if (sqlite3_prepare(db, SQL_SELECT_VALUE_TYPE, -1, &stmt, &tail) != SQLITE_OK) {
-		throw ConfigurationException("get_typed_value/prepare", sqlite3_errmsg(db));
-	}
-	if (sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK) {
-		throw ConfigurationException("get_typed_value/bind/path (1)", sqlite3_errmsg(db));
+	ValueCache::const_iterator v = host_cache_.find(path);
+	if (v != host_cache_.end()) {
+		is_default = false;
+		return &v->second;
 	}
-	if (sqlite3_bind_text(stmt, 2, path, -1, NULL) != SQLITE_OK) {
-		throw ConfigurationException("get_typed_value/bind/path (2)", sqlite3_errmsg(db));
+	v = default_cache_.find(path);
+	if (v != default_cache_.end()) {
+		is_default = true;
+		return &v->second;
 	}
+	return NULL;
+}
 
-	if (sqlite3_step(stmt) == SQLITE_ROW) {
-		if (type == NULL) {
-			// type check omitted
-			return stmt;
-		} else {
-			if (strcmp((char *)sqlite3_column_text(stmt, 0), type) != 0) {
-				ConfigTypeMismatchException ce(path, (char *)sqlite3_column_text(stmt, 0), type);
-				sqlite3_finalize(stmt);
-				throw ce;
-			} else {
-				return stmt;
-			}
-		}
-	} else {
-		sqlite3_finalize(stmt);
+/** Get a value of a specific type from the cache.
+ * Must be called with the mutex locked.
+ * @param path path
+ * @param type desired type
+ * @return cached value
+ * @exception ConfigEntryNotFoundException thrown if the path does not exist
+ * @exception ConfigTypeMismatchException thrown if the value has another type
+ */
+const SQLiteConfiguration::CachedValue &
+SQLiteConfiguration::get_typed_value(const char *path, const char *type) const
+{
+	bool               is_default;
+	const CachedValue *v = cached_value(path, is_default);
+	if (!v) {
 		throw ConfigEntryNotFoundException(path);
 	}
+	if (v->type != type) {
+		throw ConfigTypeMismatchException(path, v->type.c_str(), type);
+	}
+	return *v;
 }
 
 float
 SQLiteConfiguration::get_float(const char *path)
 {
-	sqlite3_stmt *stmt;
-	mutex->lock();
-	try {
-		stmt    = get_typed_value(path, "float");
-		float f = (float)sqlite3_column_double(stmt, 1);
-		sqlite3_finalize(stmt);
-		mutex->unlock();
-		return f;
-	} catch (Exception &e) {
-		// we can't handle
-		mutex->unlock();
-		throw;
-	}
+	MutexLocker lock(mutex);
+	return (float)get_typed_value(path, "float").num;
 }
 
 unsigned int
 SQLiteConfiguration::get_uint(const char *path)
 {
-	sqlite3_stmt *stmt;
-	mutex->lock();
-	try {
-		stmt  = get_typed_value(path, "unsigned int");
-		int i = sqlite3_column_int(stmt, 1);
-		sqlite3_finalize(stmt);
-		if (i < 0) {
-			mutex->unlock();
-			throw ConfigTypeMismatchException(path, "int", "unsigned int");
-		}
-		mutex->unlock();
-		return i;
-	} catch (Exception &e) {
-		// we can't handle
-		mutex->unlock();
-		throw;
+	MutexLocker lock(mutex);
+	int         i = (int)get_typed_value(path, "unsigned int").num;
+	if (i < 0) {
+		throw ConfigTypeMismatchException(path, "int", "unsigned int");
 	}
+	return i;
 }
 
 int
 SQLiteConfiguration::get_int(const char *path)
 {
-	sqlite3_stmt *stmt;
-	mutex->lock();
-	try {
-		stmt  = get_typed_value(path, "int");
-		int i = sqlite3_column_int(stmt, 1);
-		sqlite3_finalize(stmt);
-		mutex->unlock();
-		return i;
-	} catch (Exception &e) {
-		// we can't handle
-		mutex->unlock();
-		throw;
-	}
+	MutexLocker lock(mutex);
+	return (int)get_typed_value(path, "int").num;
 }
 
 bool
 SQLiteConfiguration::get_bool(const char *path)
 {
-	sqlite3_stmt *stmt;
-	mutex->lock();
-	try {
-		stmt  = get_typed_value(path, "bool");
-		int i = sqlite3_column_int(stmt, 1);
-		sqlite3_finalize(stmt);
-		mutex->unlock();
-		return (i != 0);
-	} catch (Exception &e) {
-		// we can't handle
-		mutex->unlock();
-		throw;
-	}
+	MutexLocker lock(mutex);
+	return ((int)get_typed_value(path, "bool").num != 0);
 }
 
 std::string
 SQLiteConfiguration::get_string(const char *path)
 {
-	sqlite3_stmt *stmt;
-	mutex->lock();
+	MutexLocker lock(mutex);
 	try {
-		stmt           = get_typed_value(path, "string");
-		const char *c  = (char *)sqlite3_column_text(stmt, 1);
-		std::string rv = c;
-		sqlite3_finalize(stmt);
-		mutex->unlock();
-		return rv;
+		return get_typed_value(path, "string").str;
 	} catch (Exception &e) {
 		// we can't handle
 		e.append("SQLiteConfiguration::get_string: Fetching %s failed.", path);
-		mutex->unlock();
 		throw;
 	}
 }
@@ -1108,15 +989,11 @@ SQLiteConfiguration::get_value(const char *path)
 sqlite3_stmt *
 SQLiteConfiguration::prepare_update(const char *sql, const char *path)
 {
-	sqlite3_stmt *stmt;
-	const char *  tail;
+	sqlite3_stmt *stmt = prepare_cached(sql);
 
-	if (sqlite3_prepare(db, sql, -1, &stmt, &tail) != SQLITE_OK) {
-		throw ConfigurationException("prepare_update/prepare", sqlite3_errmsg(db));
-	}
 	if (sqlite3_bind_text(stmt, 2, path, -1, NULL) != SQLITE_OK) {
 		ConfigurationException ce("prepare_update/bind", sqlite3_errmsg(db));
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 		throw ce;
 	}
 
@@ -1126,16 +1003,12 @@ SQLiteConfiguration::prepare_update(const char *sql, const char *path)
 sqlite3_stmt *
 SQLiteConfiguration::prepare_insert_value(const char *sql, const char *type, const char *path)
 {
-	sqlite3_stmt *stmt;
-	const char *  tail;
+	sqlite3_stmt *stmt = prepare_cached(sql);
 
-	if (sqlite3_prepare(db, sql, -1, &stmt, &tail) != SQLITE_OK) {
-		throw ConfigurationException("prepare_insert_value/prepare", sqlite3_errmsg(db));
-	}
 	if ((sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK)
 	    || (sqlite3_bind_text(stmt, 2, type, -1, NULL) != SQLITE_OK)) {
 		ConfigurationException ce("prepare_insert_value/bind", sqlite3_errmsg(db));
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 		throw ce;
 	}
 
@@ -1147,7 +1020,7 @@ SQLiteConfiguration::execute_insert_or_update(sqlite3_stmt *stmt)
 {
 	if (sqlite3_step(stmt) != SQLITE_DONE) {
 		ConfigurationException ce("execute_insert_or_update", sqlite3_errmsg(db));
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 		throw ce;
 	}
 }
@@ -1163,15 +1036,15 @@ SQLiteConfiguration::set_float(const char *path, float f)
 		stmt = prepare_update(SQL_UPDATE_VALUE, path);
 		if ((sqlite3_bind_double(stmt, 1, f) != SQLITE_OK)) {
 			ConfigurationException ce("set_float/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1183,20 +1056,21 @@ SQLiteConfiguration::set_float(const char *path, float f)
 			stmt = prepare_insert_value(SQL_INSERT_VALUE, "float", path);
 			if ((sqlite3_bind_double(stmt, 3, f) != SQLITE_OK)) {
 				ConfigurationException ce("set_float/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1213,15 +1087,15 @@ SQLiteConfiguration::set_uint(const char *path, unsigned int uint)
 		stmt = prepare_update(SQL_UPDATE_VALUE, path);
 		if ((sqlite3_bind_int(stmt, 1, uint) != SQLITE_OK)) {
 			ConfigurationException ce("set_uint/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1233,19 +1107,20 @@ SQLiteConfiguration::set_uint(const char *path, unsigned int uint)
 			stmt = prepare_insert_value(SQL_INSERT_VALUE, "unsigned int", path);
 			if ((sqlite3_bind_int(stmt, 3, uint) != SQLITE_OK)) {
 				ConfigurationException ce("set_uint/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1262,15 +1137,15 @@ SQLiteConfiguration::set_int(const char *path, int i)
 		stmt = prepare_update(SQL_UPDATE_VALUE, path);
 		if ((sqlite3_bind_int(stmt, 1, i) != SQLITE_OK)) {
 			ConfigurationException ce("set_int/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1282,20 +1157,21 @@ SQLiteConfiguration::set_int(const char *path, int i)
 			stmt = prepare_insert_value(SQL_INSERT_VALUE, "int", path);
 			if ((sqlite3_bind_int(stmt, 3, i) != SQLITE_OK)) {
 				ConfigurationException ce("set_int/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1312,15 +1188,15 @@ SQLiteConfiguration::set_bool(const char *path, bool b)
 		stmt = prepare_update(SQL_UPDATE_VALUE, path);
 		if ((sqlite3_bind_int(stmt, 1, (b ? 1 : 0)) != SQLITE_OK)) {
 			ConfigurationException ce("set_bool/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1332,20 +1208,21 @@ SQLiteConfiguration::set_bool(const char *path, bool b)
 			stmt = prepare_insert_value(SQL_INSERT_VALUE, "bool", path);
 			if ((sqlite3_bind_int(stmt, 3, (b ? 1 : 0)) != SQLITE_OK)) {
 				ConfigurationException ce("set_bool/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1364,15 +1241,15 @@ SQLiteConfiguration::set_string(const char *path, const char *s)
 		stmt = prepare_update(SQL_UPDATE_VALUE, path);
 		if ((sqlite3_bind_text(stmt, 1, s, s_length, SQLITE_STATIC) != SQLITE_OK)) {
 			ConfigurationException ce("set_string/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1384,20 +1261,21 @@ SQLiteConfiguration::set_string(const char *path, const char *s)
 			stmt = prepare_insert_value(SQL_INSERT_VALUE, "string", path);
 			if ((sqlite3_bind_text(stmt, 3, s, s_length, SQLITE_STATIC) != SQLITE_OK)) {
 				ConfigurationException ce("set_string/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1458,15 +1336,15 @@ SQLiteConfiguration::set_comment(const char *path, const char *comment)
 		stmt = prepare_update(SQL_UPDATE_COMMENT, path);
 		if ((sqlite3_bind_text(stmt, 1, comment, s_length, SQLITE_STATIC) != SQLITE_OK)) {
 			ConfigurationException ce("set_string/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1477,6 +1355,7 @@ SQLiteConfiguration::set_comment(const char *path, const char *comment)
 		throw ConfigurationException("set_comment", "Cannot set comment for inexistent path");
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path, true);
@@ -1491,25 +1370,26 @@ SQLiteConfiguration::set_comment(const char *path, std::string &comment)
 void
 SQLiteConfiguration::erase(const char *path)
 {
-	sqlite3_stmt *stmt;
-	const char *  tail;
+	mutex->lock();
+	sqlite3_stmt *stmt = prepare_cached(SQL_DELETE_VALUE);
 
-	if (sqlite3_prepare(db, SQL_DELETE_VALUE, -1, &stmt, &tail) != SQLITE_OK) {
-		throw ConfigurationException("erase/prepare", sqlite3_errmsg(db));
-	}
 	if (sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK) {
 		ConfigurationException ce("erase/bind", sqlite3_errmsg(db));
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
+		mutex->unlock();
 		throw ce;
 	}
 
 	if (sqlite3_step(stmt) != SQLITE_DONE) {
 		ConfigurationException ce("erase/execute", sqlite3_errmsg(db));
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
+		mutex->unlock();
 		throw ce;
 	}
 
-	sqlite3_finalize(stmt);
+	release_statement(stmt);
+	update_cache(path);
+	mutex->unlock();
 
 	notify_handlers(path);
 }
@@ -1525,15 +1405,15 @@ SQLiteConfiguration::set_default_float(const char *path, float f)
 		stmt = prepare_update(SQL_UPDATE_DEFAULT_VALUE, path);
 		if ((sqlite3_bind_double(stmt, 1, f) != SQLITE_OK)) {
 			ConfigurationException ce("set_default_float/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1545,20 +1425,21 @@ SQLiteConfiguration::set_default_float(const char *path, float f)
 			stmt = prepare_insert_value(SQL_INSERT_DEFAULT_VALUE, "float", path);
 			if ((sqlite3_bind_double(stmt, 3, f) != SQLITE_OK)) {
 				ConfigurationException ce("set_default_float/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1575,15 +1456,15 @@ SQLiteConfiguration::set_default_uint(const char *path, unsigned int uint)
 		stmt = prepare_update(SQL_UPDATE_DEFAULT_VALUE, path);
 		if ((sqlite3_bind_int(stmt, 1, uint) != SQLITE_OK)) {
 			ConfigurationException ce("set_default_uint/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1595,19 +1476,20 @@ SQLiteConfiguration::set_default_uint(const char *path, unsigned int uint)
 			stmt = prepare_insert_value(SQL_INSERT_DEFAULT_VALUE, "unsigned int", path);
 			if ((sqlite3_bind_int(stmt, 3, uint) != SQLITE_OK)) {
 				ConfigurationException ce("set_default_uint/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1623,15 +1505,15 @@ SQLiteConfiguration::set_default_int(const char *path, int i)
 		stmt = prepare_update(SQL_UPDATE_DEFAULT_VALUE, path);
 		if ((sqlite3_bind_int(stmt, 1, i) != SQLITE_OK)) {
 			ConfigurationException ce("set_default_int/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1642,20 +1524,21 @@ SQLiteConfiguration::set_default_int(const char *path, int i)
 			stmt = prepare_insert_value(SQL_INSERT_DEFAULT_VALUE, "int", path);
 			if ((sqlite3_bind_int(stmt, 3, i) != SQLITE_OK)) {
 				ConfigurationException ce("set_default_int/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1672,15 +1555,15 @@ SQLiteConfiguration::set_default_bool(const char *path, bool b)
 		stmt = prepare_update(SQL_UPDATE_DEFAULT_VALUE, path);
 		if ((sqlite3_bind_int(stmt, 1, (b ? 1 : 0)) != SQLITE_OK)) {
 			ConfigurationException ce("set_default_bool/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1692,20 +1575,21 @@ SQLiteConfiguration::set_default_bool(const char *path, bool b)
 			stmt = prepare_insert_value(SQL_INSERT_DEFAULT_VALUE, "bool", path);
 			if ((sqlite3_bind_int(stmt, 3, (b ? 1 : 0)) != SQLITE_OK)) {
 				ConfigurationException ce("set_default_bool/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1723,15 +1607,15 @@ SQLiteConfiguration::set_default_string(const char *path, const char *s)
 		stmt = prepare_update(SQL_UPDATE_DEFAULT_VALUE, path);
 		if ((sqlite3_bind_text(stmt, 1, s, s_length, SQLITE_STATIC) != SQLITE_OK)) {
 			ConfigurationException ce("set_default_string/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1743,20 +1627,21 @@ SQLiteConfiguration::set_default_string(const char *path, const char *s)
 			stmt = prepare_insert_value(SQL_INSERT_DEFAULT_VALUE, "string", path);
 			if ((sqlite3_bind_text(stmt, 3, s, s_length, SQLITE_STATIC) != SQLITE_OK)) {
 				ConfigurationException ce("set_default_string/insert/bind", sqlite3_errmsg(db));
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 				mutex->unlock();
 				throw ce;
 			}
 			execute_insert_or_update(stmt);
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		} catch (Exception &e) {
 			if (stmt != NULL)
-				sqlite3_finalize(stmt);
+				release_statement(stmt);
 			mutex->unlock();
 			throw;
 		}
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1780,15 +1665,15 @@ SQLiteConfiguration::set_default_comment(const char *path, const char *comment)
 		stmt = prepare_update(SQL_UPDATE_DEFAULT_COMMENT, path);
 		if ((sqlite3_bind_text(stmt, 1, comment, s_length, SQLITE_STATIC) != SQLITE_OK)) {
 			ConfigurationException ce("set_default_comment/update/bind", sqlite3_errmsg(db));
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 			mutex->unlock();
 			throw ce;
 		}
 		execute_insert_or_update(stmt);
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
 	} catch (Exception &e) {
 		if (stmt != NULL)
-			sqlite3_finalize(stmt);
+			release_statement(stmt);
 		mutex->unlock();
 		throw;
 	}
@@ -1799,6 +1684,7 @@ SQLiteConfiguration::set_default_comment(const char *path, const char *comment)
 		throw ConfigurationException("set_default_comment", "Cannot set comment for inexistent path");
 	}
 
+	update_cache(path);
 	mutex->unlock();
 
 	notify_handlers(path);
@@ -1813,29 +1699,127 @@ SQLiteConfiguration::set_default_comment(const char *path, std::string &comment)
 void
 SQLiteConfiguration::erase_default(const char *path)
 {
-	sqlite3_stmt *stmt;
-	const char *  tail;
+	mutex->lock();
+	sqlite3_stmt *stmt = prepare_cached(SQL_DELETE_DEFAULT_VALUE);
 
-	if (sqlite3_prepare(db, SQL_DELETE_DEFAULT_VALUE, -1, &stmt, &tail) != SQLITE_OK) {
-		throw ConfigurationException("erase_default/prepare", sqlite3_errmsg(db));
-	}
 	if (sqlite3_bind_text(stmt, 1, path, -1, NULL) != SQLITE_OK) {
 		ConfigurationException ce("erase_default/bind", sqlite3_errmsg(db));
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
+		mutex->unlock();
 		throw ce;
 	}
 
 	if (sqlite3_step(stmt) != SQLITE_DONE) {
 		ConfigurationException ce("erase_default/execute", sqlite3_errmsg(db));
-		sqlite3_finalize(stmt);
+		release_statement(stmt);
+		mutex->unlock();
 		throw ce;
 	}
 
-	sqlite3_finalize(stmt);
+	release_statement(stmt);
+	update_cache(path);
+	mutex->unlock();
 
 	notify_handlers(path);
 }
 
+/** Get a cached prepared statement.
+ * The statement is prepared on first use and kept until the
+ * configuration is destroyed. Must be called with the mutex locked.
+ * Hand the statement back with release_statement() instead of
+ * finalizing it.
+ * @param sql SQL query
+ * @return prepared statement
+ */
+sqlite3_stmt *
+SQLiteConfiguration::prepare_cached(const char *sql)
+{
+	std::map<std::string, sqlite3_stmt *>::iterator st = stmt_cache_.find(sql);
+	if (st != stmt_cache_.end()) {
+		return st->second;
+	}
+
+	sqlite3_stmt *stmt;
+	if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+		throw ConfigurationException("prepare_cached/prepare", sqlite3_errmsg(db));
+	}
+	stmt_cache_[sql] = stmt;
+	return stmt;
+}
+
+/** Reset a cached prepared statement for the next use.
+ * @param stmt statement retrieved with prepare_cached()
+ */
+void
+SQLiteConfiguration::release_statement(sqlite3_stmt *stmt)
+{
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+}
+
+/** Add the values of a query to a cache.
+ * @param cache cache to add to
+ * @param stmt statement returning rows of path, type, value, and comment
+ */
+void
+SQLiteConfiguration::cache_rows(ValueCache &cache, sqlite3_stmt *stmt)
+{
+	while (sqlite3_step(stmt) == SQLITE_ROW) {
+		const char *path    = (const char *)sqlite3_column_text(stmt, 0);
+		const char *type    = (const char *)sqlite3_column_text(stmt, 1);
+		const char *str     = (const char *)sqlite3_column_text(stmt, 2);
+		const char *comment = (const char *)sqlite3_column_text(stmt, 3);
+		if (!path || !type)
+			continue;
+
+		CachedValue &v = cache[path];
+		v.type         = type;
+		v.num          = sqlite3_column_double(stmt, 2);
+		v.str          = str ? str : "";
+		v.comment      = comment ? comment : "";
+	}
+}
+
+/** Read all values into the cache.
+ * Must be called with the mutex locked.
+ */
+void
+SQLiteConfiguration::load_cache()
+{
+	host_cache_.clear();
+	default_cache_.clear();
+
+	sqlite3_stmt *stmt = prepare_cached(SQL_SELECT_CACHE_HOST);
+	cache_rows(host_cache_, stmt);
+	release_statement(stmt);
+
+	stmt = prepare_cached(SQL_SELECT_CACHE_DEFAULT);
+	cache_rows(default_cache_, stmt);
+	release_statement(stmt);
+}
+
+/** Read values of a path into the cache.
+ * Call after the path has been modified. Must be called with the mutex
+ * locked.
+ * @param path path of the modified value
+ */
+void
+SQLiteConfiguration::update_cache(const char *path)
+{
+	host_cache_.erase(path);
+	default_cache_.erase(path);
+
+	sqlite3_stmt *stmt = prepare_cached(SQL_SELECT_CACHE_HOST_PATH);
+	sqlite3_bind_text(stmt, 1, path, -1, NULL);
+	cache_rows(host_cache_, stmt);
+	release_statement(stmt);
+
+	stmt = prepare_cached(SQL_SELECT_CACHE_DEFAULT_PATH);
+	sqlite3_bind_text(stmt, 1, path, -1, NULL);
+	cache_rows(default_cache_, stmt);
+	release_statement(stmt);
+}
+
 /** Lock the config.
  * No further changes or queries can be executed on the configuration and will block until
  * the config is unlocked.
@@ -28,7 +28,9 @@
 #include <utils/system/hostinfo.h>
 
 #include <list>
+#include <map>
 #include <string>
+#include <unordered_map>
 
 struct sqlite3;
 struct sqlite3_stmt;
@@ -177,8 +179,25 @@ public:
 	void try_dump();
 
 private:
-	void            init_dbs();
-	::sqlite3_stmt *get_typed_value(const char *path, const char *type);
+	/// @cond INTERNALS
+	struct CachedValue
+	{
+		std::string type;
+		double      num;
+		std::string str;
+		std::string comment;
+	};
+	typedef std::unordered_map<std::string, CachedValue> ValueCache;
+	/// @endcond
+
+	void               init_dbs();
+	const CachedValue *cached_value(const char *path, bool &is_default) const;
+	const CachedValue &get_typed_value(const char *path, const char *type) const;
+	void               load_cache();
+	void               update_cache(const char *path);
+	static void        cache_rows(ValueCache &cache, ::sqlite3_stmt *stmt);
+	::sqlite3_stmt *   prepare_cached(const char *sql);
+	void               release_statement(::sqlite3_stmt *stmt);
 	::sqlite3_stmt *prepare_update(const char *sql, const char *path);
 	::sqlite3_stmt *prepare_insert_value(const char *sql, const char *type, const char *path);
 	void            execute_insert_or_update(sqlite3_stmt *stmt);
@@ -192,6 +211,10 @@ private:
 	bool       opened;
 	Mutex *    mutex;
 
+	ValueCache                              host_cache_;
+	ValueCache                              default_cache_;
+	std::map<std::string, ::sqlite3_stmt *> stmt_cache_;
+
 	char *sysconfdir_;
 	char *userconfdir_;
 	char *host_file_;
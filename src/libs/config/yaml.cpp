@@ -296,6 +296,16 @@ YamlConfiguration::YamlValueIterator::is_default() const
 
 /** @class YamlConfiguration <config/yaml.h>
  * Configuration store using YAML documents.
+ * Besides the tree of documents a flat hash index of all values is kept,
+ * which is rebuilt whenever the configuration is loaded or modified. Value
+ * queries for complete paths are answered from the index without walking
+ * the tree. Use ConfigHandle to avoid even that lookup for values which
+ * are read frequently.
+ *
+ * If a snapshot file is set, the merged trees are written to it in a
+ * binary format after the YAML files have been parsed. The next load()
+ * reads the snapshot instead of the YAML files if none of the files and
+ * directories that were read (or tried to be read) have changed since.
  * @author Tim Niemueller
  */
 
@@ -402,7 +412,16 @@ YamlConfiguration::load(const char *file_path)
 
 	host_file_ = "";
 	std::list<std::string> files, dirs;
-	read_yaml_config(filename, host_file_, root_, host_root_, files, dirs);
+	if (snapshot_file_.empty() || !read_snapshot(files, dirs)) {
+		std::list<std::string> checked;
+		files.clear();
+		dirs.clear();
+		read_yaml_config(filename, host_file_, root_, host_root_, files, dirs, checked);
+		if (!snapshot_file_.empty()) {
+			write_snapshot(files, dirs, checked);
+		}
+	}
+	update_index();
 
 #ifdef HAVE_INOTIFY
 	fam_thread_                       = new FamThread();
@@ -476,7 +495,8 @@ YamlConfiguration::read_yaml_config(std::string                             file
                                     std::shared_ptr<YamlConfigurationNode> &root,
                                     std::shared_ptr<YamlConfigurationNode> &host_root,
                                     std::list<std::string> &                files,
-                                    std::list<std::string> &                dirs)
+                                    std::list<std::string> &                dirs,
+                                    std::list<std::string> &                checked)
 {
 	root = std::make_shared<YamlConfigurationNode>();
 
@@ -486,6 +506,7 @@ YamlConfiguration::read_yaml_config(std::string                             file
 	while (!load_queue.empty()) {
 		LoadQueueEntry &qe = load_queue.front();
 
+		checked.push_back(qe.filename);
 		if (qe.is_dir) {
 			dirs.push_back(qe.filename);
 		} else {
@@ -509,6 +530,7 @@ YamlConfiguration::read_yaml_config(std::string                             file
 		//LibLogger::log_debug("YamlConfiguration",
 		//			 "Reading Host YAML file '%s'", host_file.c_str());
 		std::queue<LoadQueueEntry> host_load_queue;
+		checked.push_back(host_file);
 		host_root = read_yaml_file(host_file, true, host_load_queue, host_file);
 		if (!host_load_queue.empty()) {
 			throw CouldNotOpenConfigException("YamlConfig: includes are not allowed "
@@ -531,9 +553,9 @@ YamlConfiguration::fam_event(const char *filename, unsigned int mask)
 	MutexLocker lock(mutex);
 	try {
 		std::string                            host_file = "";
-		std::list<std::string>                 files, dirs;
+		std::list<std::string>                 files, dirs, checked;
 		std::shared_ptr<YamlConfigurationNode> root, host_root;
-		read_yaml_config(config_file_, host_file, root, host_root, files, dirs);
+		read_yaml_config(config_file_, host_file, root, host_root, files, dirs, checked);
 
 		std::list<std::string> changes = YamlConfigurationNode::diff(root_, root);
 
@@ -541,6 +563,7 @@ YamlConfiguration::fam_event(const char *filename, unsigned int mask)
 			root_      = root;
 			host_root_ = host_root;
 			host_file_ = host_file;
+			update_index();
 
 			std::list<std::string>::iterator c;
 			for (c = changes.begin(); c != changes.end(); ++c) {
@@ -548,6 +571,10 @@ YamlConfiguration::fam_event(const char *filename, unsigned int mask)
 			}
 		}
 
+		if (!snapshot_file_.empty()) {
+			write_snapshot(files, dirs, checked);
+		}
+
 		// includes might have changed to include a new empty file
 		// so even though no value changes were seen, we might very
 		// well have new files we need to watch (or files we do no
@@ -708,6 +735,205 @@ YamlConfiguration::write_host_file()
 	}
 }
 
+/** Set snapshot file.
+ * Must be called before load() to have any effect.
+ * @param filename snapshot file name, relative names are taken to be
+ * in the user configuration directory. Pass NULL to disable snapshots.
+ */
+void
+YamlConfiguration::set_snapshot_file(const char *filename)
+{
+	if (filename == NULL || filename[0] == 0) {
+		snapshot_file_ = "";
+	} else if (filename[0] == '/' || userconfdir_ == NULL) {
+		snapshot_file_ = filename;
+	} else {
+		snapshot_file_ = std::string(userconfdir_) + "/" + filename;
+	}
+}
+
+/// @cond INTERNALS
+static const char *   SNAPSHOT_MAGIC   = "FAWKES-YAML-SNAPSHOT";
+static const uint64_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotFileStat
+{
+	uint64_t exists;
+	uint64_t ino;
+	uint64_t size;
+	uint64_t mtime_sec;
+	uint64_t mtime_nsec;
+
+	bool
+	operator==(const SnapshotFileStat &o) const
+	{
+		return exists == o.exists && ino == o.ino && size == o.size && mtime_sec == o.mtime_sec
+		       && mtime_nsec == o.mtime_nsec;
+	}
+};
+
+static SnapshotFileStat
+snapshot_file_stat(const std::string &filename)
+{
+	SnapshotFileStat fs;
+	struct stat      s;
+	memset(&fs, 0, sizeof(fs));
+	if (stat(filename.c_str(), &s) == 0) {
+		fs.exists     = 1;
+		fs.ino        = s.st_ino;
+		fs.size       = s.st_size;
+		fs.mtime_sec  = s.st_mtim.tv_sec;
+		fs.mtime_nsec = s.st_mtim.tv_nsec;
+	}
+	return fs;
+}
+
+static std::string
+snapshot_hostname()
+{
+	char hostname[256];
+	if (gethostname(hostname, sizeof(hostname)) != 0) {
+		return "";
+	}
+	hostname[sizeof(hostname) - 1] = 0;
+	return hostname;
+}
+/// @endcond
+
+/** Read configuration from snapshot file.
+ * The snapshot is only used if it was written for the same main
+ * configuration file and host, and if all files and directories it
+ * was created from still have the same size and modification time.
+ * @param files upon return contains files to watch for changes
+ * @param dirs upon return contains directories to watch for changes
+ * @return true if the configuration was read from the snapshot, false if
+ * it is missing, outdated, or corrupt and the YAML files must be read
+ */
+bool
+YamlConfiguration::read_snapshot(std::list<std::string> &files, std::list<std::string> &dirs)
+{
+	std::ifstream in(snapshot_file_.c_str(), std::ios::binary);
+	if (!in) {
+		return false;
+	}
+
+	try {
+		if (yaml_utils::read_snapshot_string(in) != SNAPSHOT_MAGIC
+		    || yaml_utils::read_snapshot_size(in) != SNAPSHOT_VERSION
+		    || yaml_utils::read_snapshot_string(in) != config_file_
+		    || yaml_utils::read_snapshot_string(in) != snapshot_hostname()) {
+			return false;
+		}
+
+		std::string host_file = yaml_utils::read_snapshot_string(in);
+
+		uint64_t num_checked = yaml_utils::read_snapshot_size(in);
+		for (uint64_t i = 0; i < num_checked; ++i) {
+			std::string      filename = yaml_utils::read_snapshot_string(in);
+			SnapshotFileStat fs;
+			fs.exists     = yaml_utils::read_snapshot_size(in);
+			fs.ino        = yaml_utils::read_snapshot_size(in);
+			fs.size       = yaml_utils::read_snapshot_size(in);
+			fs.mtime_sec  = yaml_utils::read_snapshot_size(in);
+			fs.mtime_nsec = yaml_utils::read_snapshot_size(in);
+			if (!(snapshot_file_stat(filename) == fs)) {
+				return false;
+			}
+		}
+
+		std::list<std::string> snap_files, snap_dirs;
+		uint64_t               num_files = yaml_utils::read_snapshot_size(in);
+		for (uint64_t i = 0; i < num_files; ++i) {
+			snap_files.push_back(yaml_utils::read_snapshot_string(in));
+		}
+		uint64_t num_dirs = yaml_utils::read_snapshot_size(in);
+		for (uint64_t i = 0; i < num_dirs; ++i) {
+			snap_dirs.push_back(yaml_utils::read_snapshot_string(in));
+		}
+
+		std::shared_ptr<YamlConfigurationNode> root      = YamlConfigurationNode::read_snapshot(in);
+		std::shared_ptr<YamlConfigurationNode> host_root = YamlConfigurationNode::read_snapshot(in);
+
+		root_      = root;
+		host_root_ = host_root;
+		host_file_ = host_file;
+		files.swap(snap_files);
+		dirs.swap(snap_dirs);
+		return true;
+	} catch (Exception &e) {
+		LibLogger::log_warn("YamlConfiguration",
+		                    "Ignoring config snapshot %s: %s",
+		                    snapshot_file_.c_str(),
+		                    e.what_no_backtrace());
+		return false;
+	}
+}
+
+/** Write configuration to snapshot file.
+ * The file is written to a temporary file first and then renamed, so
+ * that a concurrently starting instance never sees a partial snapshot.
+ * Failures are logged and otherwise ignored.
+ * @param files files to watch for changes
+ * @param dirs directories to watch for changes
+ * @param checked all files and directories that were read or tried to
+ * be read, their modification times validate the snapshot
+ */
+void
+YamlConfiguration::write_snapshot(const std::list<std::string> &files,
+                                  const std::list<std::string> &dirs,
+                                  const std::list<std::string> &checked)
+{
+	std::string tmp_file = snapshot_file_ + ".tmp";
+	{
+		std::ofstream out(tmp_file.c_str(), std::ios::binary | std::ios::trunc);
+		yaml_utils::write_snapshot_string(out, SNAPSHOT_MAGIC);
+		yaml_utils::write_snapshot_size(out, SNAPSHOT_VERSION);
+		yaml_utils::write_snapshot_string(out, config_file_);
+		yaml_utils::write_snapshot_string(out, snapshot_hostname());
+		yaml_utils::write_snapshot_string(out, host_file_);
+
+		yaml_utils::write_snapshot_size(out, checked.size());
+		for (const auto &c : checked) {
+			SnapshotFileStat fs = snapshot_file_stat(c);
+			yaml_utils::write_snapshot_string(out, c);
+			yaml_utils::write_snapshot_size(out, fs.exists);
+			yaml_utils::write_snapshot_size(out, fs.ino);
+			yaml_utils::write_snapshot_size(out, fs.size);
+			yaml_utils::write_snapshot_size(out, fs.mtime_sec);
+			yaml_utils::write_snapshot_size(out, fs.mtime_nsec);
+		}
+
+		yaml_utils::write_snapshot_size(out, files.size());
+		for (const auto &f : files) {
+			yaml_utils::write_snapshot_string(out, f);
+		}
+		yaml_utils::write_snapshot_size(out, dirs.size());
+		for (const auto &d : dirs) {
+			yaml_utils::write_snapshot_string(out, d);
+		}
+
+		root_->write_snapshot(out);
+		host_root_->write_snapshot(out);
+
+		out.close();
+		if (!out) {
+			LibLogger::log_warn("YamlConfiguration",
+			                    "Failed to write config snapshot %s",
+			                    tmp_file.c_str());
+			unlink(tmp_file.c_str());
+			return;
+		}
+	}
+
+	if (rename(tmp_file.c_str(), snapshot_file_.c_str()) != 0) {
+		LibLogger::log_warn("YamlConfiguration",
+		                    "Failed to replace config snapshot %s: %s",
+		                    snapshot_file_.c_str(),
+		                    strerror(errno));
+		unlink(tmp_file.c_str());
+	}
+}
+
 void
 YamlConfiguration::copy(Configuration *copyconf)
 {
@@ -718,7 +944,7 @@ bool
 YamlConfiguration::exists(const char *path)
 {
 	try {
-		std::shared_ptr<YamlConfigurationNode> n = root_->find(path);
+		std::shared_ptr<YamlConfigurationNode> n = find_node(path);
 		return !n->has_children();
 	} catch (Exception &e) {
 		return false;
@@ -728,7 +954,7 @@ YamlConfiguration::exists(const char *path)
 std::string
 YamlConfiguration::get_type(const char *path)
 {
-	std::shared_ptr<YamlConfigurationNode> n = root_->find(path);
+	std::shared_ptr<YamlConfigurationNode> n = find_node(path);
 	if (n->has_children()) {
 		throw ConfigEntryNotFoundException(path);
 	}
@@ -743,7 +969,7 @@ YamlConfiguration::get_comment(const char *path)
 }
 
 /** Retrieve value casted to given type T.
- * @param root root node of the tree to search
+ * @param n node found for @p path
  * @param path path to query
  * @return value casted as desired
  * @throw YAML::ScalarInvalid thrown if value does not exist or is of
@@ -751,9 +977,8 @@ YamlConfiguration::get_comment(const char *path)
  */
 template <typename T>
 static inline T
-get_value_as(std::shared_ptr<YamlConfigurationNode> root, const char *path)
+get_value_as(std::shared_ptr<YamlConfigurationNode> n, const char *path)
 {
-	std::shared_ptr<YamlConfigurationNode> n = root->find(path);
 	if (n->has_children()) {
 		throw ConfigEntryNotFoundException(path);
 	}
@@ -761,7 +986,7 @@ get_value_as(std::shared_ptr<YamlConfigurationNode> root, const char *path)
 }
 
 /** Retrieve value casted to given type T.
- * @param root root node of the tree to search
+ * @param n node found for @p path
  * @param path path to query
  * @return value casted as desired
  * @throw YAML::ScalarInvalid thrown if value does not exist or is of
@@ -769,9 +994,8 @@ get_value_as(std::shared_ptr<YamlConfigurationNode> root, const char *path)
  */
 template <typename T>
 static inline std::vector<T>
-get_list(std::shared_ptr<YamlConfigurationNode> root, const char *path)
+get_list(std::shared_ptr<YamlConfigurationNode> n, const char *path)
 {
-	std::shared_ptr<YamlConfigurationNode> n = root->find(path);
 	if (n->has_children()) {
 		throw ConfigEntryNotFoundException(path);
 	}
@@ -781,73 +1005,72 @@ get_list(std::shared_ptr<YamlConfigurationNode> root, const char *path)
 float
 YamlConfiguration::get_float(const char *path)
 {
-	return get_value_as<float>(root_, path);
+	return get_value_as<float>(find_node(path), path);
 }
 
 unsigned int
 YamlConfiguration::get_uint(const char *path)
 {
-	return get_value_as<unsigned int>(root_, path);
+	return get_value_as<unsigned int>(find_node(path), path);
 }
 
 int
 YamlConfiguration::get_int(const char *path)
 {
-	return get_value_as<int>(root_, path);
+	return get_value_as<int>(find_node(path), path);
 }
 
 bool
 YamlConfiguration::get_bool(const char *path)
 {
-	return get_value_as<bool>(root_, path);
+	return get_value_as<bool>(find_node(path), path);
 }
 
 std::string
 YamlConfiguration::get_string(const char *path)
 {
-	return get_value_as<std::string>(root_, path);
+	return get_value_as<std::string>(find_node(path), path);
 }
 
 std::vector<float>
 YamlConfiguration::get_floats(const char *path)
 {
-	return get_list<float>(root_, path);
+	return get_list<float>(find_node(path), path);
 }
 
 std::vector<unsigned int>
 YamlConfiguration::get_uints(const char *path)
 {
-	return get_list<unsigned int>(root_, path);
+	return get_list<unsigned int>(find_node(path), path);
 }
 
 std::vector<int>
 YamlConfiguration::get_ints(const char *path)
 {
-	return get_list<int>(root_, path);
+	return get_list<int>(find_node(path), path);
 }
 
 std::vector<bool>
 YamlConfiguration::get_bools(const char *path)
 {
-	return get_list<bool>(root_, path);
+	return get_list<bool>(find_node(path), path);
 }
 
 std::vector<std::string>
 YamlConfiguration::get_strings(const char *path)
 {
-	return get_list<std::string>(root_, path);
+	return get_list<std::string>(find_node(path), path);
 }
 
 /** Check if value is of given type T.
- * @param root root node of the tree to search
+ * @param n node found for @p path
  * @param path path to query
  * @return true if value is of desired type, false otherwise
  */
 template <typename T>
 static inline bool
-is_type(std::shared_ptr<YamlConfigurationNode> root, const char *path)
+is_type(std::shared_ptr<YamlConfigurationNode> n, const char *path)
 {
-	std::shared_ptr<YamlConfigurationNode> n = root->find(path);
 	if (n->has_children()) {
 		throw ConfigEntryNotFoundException(path);
 	}
@@ -857,13 +1080,13 @@ is_type(std::shared_ptr<YamlConfigurationNode> root, const char *path)
 bool
 YamlConfiguration::is_float(const char *path)
 {
-	return is_type<float>(root_, path);
+	return is_type<float>(find_node(path), path);
 }
 
 bool
 YamlConfiguration::is_uint(const char *path)
 {
-	std::shared_ptr<YamlConfigurationNode> n = root_->find(path);
+	std::shared_ptr<YamlConfigurationNode> n = find_node(path);
 	if (n->has_children()) {
 		throw ConfigEntryNotFoundException(path);
 	}
@@ -878,25 +1101,25 @@ YamlConfiguration::is_uint(const char *path)
 bool
 YamlConfiguration::is_int(const char *path)
 {
-	return is_type<int>(root_, path);
+	return is_type<int>(find_node(path), path);
 }
 
 bool
 YamlConfiguration::is_bool(const char *path)
 {
-	return is_type<bool>(root_, path);
+	return is_type<bool>(find_node(path), path);
 }
 
 bool
 YamlConfiguration::is_string(const char *path)
 {
-	return is_type<std::string>(root_, path);
+	return is_type<std::string>(find_node(path), path);
 }
 
 bool
 YamlConfiguration::is_list(const char *path)
 {
-	std::shared_ptr<YamlConfigurationNode> n = root_->find(path);
+	std::shared_ptr<YamlConfigurationNode> n = find_node(path);
 	if (n->has_children()) {
 		throw ConfigEntryNotFoundException(path);
 	}
@@ -919,7 +1142,7 @@ Configuration::ValueIterator *
 YamlConfiguration::get_value(const char *path)
 {
 	try {
-		std::shared_ptr<YamlConfigurationNode> n = root_->find(path);
+		std::shared_ptr<YamlConfigurationNode> n = find_node(path);
 		if (n->has_children()) {
 			return new YamlValueIterator();
 		}
@@ -936,6 +1159,7 @@ YamlConfiguration::set_float(const char *path, float f)
 {
 	root_->set_value(path, f);
 	host_root_->set_value(path, f);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -945,6 +1169,7 @@ YamlConfiguration::set_uint(const char *path, unsigned int uint)
 {
 	root_->set_value(path, uint);
 	host_root_->set_value(path, uint);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -954,6 +1179,7 @@ YamlConfiguration::set_int(const char *path, int i)
 {
 	root_->set_value(path, i);
 	host_root_->set_value(path, i);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -963,6 +1189,7 @@ YamlConfiguration::set_bool(const char *path, bool b)
 {
 	root_->set_value(path, b);
 	host_root_->set_value(path, b);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -972,6 +1199,7 @@ YamlConfiguration::set_string(const char *path, const char *s)
 {
 	root_->set_value(path, std::string(s));
 	host_root_->set_value(path, std::string(s));
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -987,6 +1215,7 @@ YamlConfiguration::set_floats(const char *path, std::vector<float> &f)
 {
 	root_->set_list(path, f);
 	host_root_->set_list(path, f);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -996,6 +1225,7 @@ YamlConfiguration::set_uints(const char *path, std::vector<unsigned int> &u)
 {
 	root_->set_list(path, u);
 	host_root_->set_list(path, u);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -1005,6 +1235,7 @@ YamlConfiguration::set_ints(const char *path, std::vector<int> &i)
 {
 	root_->set_list(path, i);
 	host_root_->set_list(path, i);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -1014,6 +1245,7 @@ YamlConfiguration::set_bools(const char *path, std::vector<bool> &b)
 {
 	root_->set_list(path, b);
 	host_root_->set_list(path, b);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -1023,6 +1255,7 @@ YamlConfiguration::set_strings(const char *path, std::vector<std::string> &s)
 {
 	root_->set_list(path, s);
 	host_root_->set_list(path, s);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -1032,6 +1265,7 @@ YamlConfiguration::set_strings(const char *path, std::vector<const char *> &s)
 {
 	root_->set_list(path, s);
 	host_root_->set_list(path, s);
+	update_index();
 	write_host_file();
 	notify_handlers(path, false);
 }
@@ -1051,7 +1285,9 @@ YamlConfiguration::erase(const char *path)
 {
 	host_root_->erase(path);
 	root_->erase(path);
+	update_index();
 	write_host_file();
+	notify_handlers(path);
 }
 
 void
@@ -1174,6 +1410,39 @@ YamlConfiguration::search(const char *path)
 	}
 }
 
+/** Rebuild the flat index of leaf nodes.
+ * Must be called whenever root_ is replaced or nodes are added or
+ * removed. The previous index stays valid for readers still holding it.
+ */
+void
+YamlConfiguration::update_index()
+{
+	std::map<std::string, std::shared_ptr<YamlConfigurationNode>> nodes;
+	root_->enum_leafs(nodes);
+	std::shared_ptr<FlatIndex> index = std::make_shared<FlatIndex>(nodes.begin(), nodes.end());
+	std::atomic_store(&index_, std::shared_ptr<const FlatIndex>(index));
+}
+
+/** Find node for a path.
+ * Leaf nodes are looked up in the flat index, for any other path, or
+ * paths not written in canonical form, the tree is searched.
+ * @param path path to retrieve node for
+ * @return node for the given path
+ * @throw ConfigEntryNotFoundException thrown if the path does not exist
+ */
+std::shared_ptr<YamlConfigurationNode>
+YamlConfiguration::find_node(const char *path) const
+{
+	std::shared_ptr<const FlatIndex> index = std::atomic_load(&index_);
+	if (index) {
+		FlatIndex::const_iterator n = index->find(path);
+		if (n != index->end()) {
+			return n->second;
+		}
+	}
+	return root_->find(path);
+}
+
 /** Query node for a specific path.
  * @param path path to retrieve node for
  * @return node representing requested path query result, if the path only
@@ -31,6 +31,7 @@
 #include <memory>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace fawkes {
@@ -50,6 +51,8 @@ public:
 
 	virtual void load(const char *file_path);
 
+	void set_snapshot_file(const char *filename);
+
 	virtual bool exists(const char *path);
 	virtual bool is_float(const char *path);
 	virtual bool is_uint(const char *path);
@@ -177,6 +180,8 @@ private:
 	/// @endcond
 
 	std::shared_ptr<YamlConfigurationNode> query(const char *path) const;
+	std::shared_ptr<YamlConfigurationNode> find_node(const char *path) const;
+	void                                   update_index();
 	void
 	read_meta_doc(YAML::Node &doc, std::queue<LoadQueueEntry> &load_queue, std::string &host_file);
 	std::shared_ptr<YamlConfigurationNode> read_config_doc(const YAML::Node &doc);
@@ -189,15 +194,25 @@ private:
 	                                                        std::shared_ptr<YamlConfigurationNode> &root,
 	                                                        std::shared_ptr<YamlConfigurationNode> &host_root,
 	                                                        std::list<std::string> &                files,
-	                                                        std::list<std::string> &                dirs);
+	                                                        std::list<std::string> &                dirs,
+	                                                        std::list<std::string> &                checked);
 	void                                   write_host_file();
+	bool                                   read_snapshot(std::list<std::string> &files,
+	                                                     std::list<std::string> &dirs);
+	void                                   write_snapshot(const std::list<std::string> &files,
+	                                                      const std::list<std::string> &dirs,
+	                                                      const std::list<std::string> &checked);
 
 	std::string config_file_;
 	std::string host_file_;
+	std::string snapshot_file_;
 
 	std::shared_ptr<YamlConfigurationNode> root_;
 	std::shared_ptr<YamlConfigurationNode> host_root_;
 
+	typedef std::unordered_map<std::string, std::shared_ptr<YamlConfigurationNode>> FlatIndex;
+	std::shared_ptr<const FlatIndex>                                                index_;
+
 	bool   write_pending_;
 	Mutex *write_pending_mutex_;
 
@@ -37,6 +37,7 @@
 #include <algorithm>
 #include <cerrno>
 #include <climits>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <limits>
@@ -209,6 +210,45 @@ convert(const std::string &input, T &rhs, typename YAML::enable_if<YAML::is_nume
 
 static std::regex url_regex{URL_REGEX, std::regex_constants::extended};
 static std::regex frame_regex{FRAME_REGEX, std::regex_constants::extended};
+
+// snapshots are only read on the host that wrote them, hence native byte order
+inline void
+write_snapshot_size(std::ostream &out, uint64_t s)
+{
+	out.write((const char *)&s, sizeof(s));
+}
+
+inline void
+write_snapshot_string(std::ostream &out, const std::string &s)
+{
+	write_snapshot_size(out, s.size());
+	out.write(s.data(), s.size());
+}
+
+inline uint64_t
+read_snapshot_size(std::istream &in)
+{
+	uint64_t s = 0;
+	if (!in.read((char *)&s, sizeof(s))) {
+		throw Exception("YamlConfig: truncated snapshot");
+	}
+	return s;
+}
+
+inline std::string
+read_snapshot_string(std::istream &in)
+{
+	uint64_t size = read_snapshot_size(in);
+	if (size > (1 << 24)) {
+		throw Exception("YamlConfig: corrupt snapshot (string of %llu bytes)",
+		                (unsigned long long)size);
+	}
+	std::string s(size, '\0');
+	if (size > 0 && !in.read(&s[0], size)) {
+		throw Exception("YamlConfig: truncated snapshot");
+	}
+	return s;
+}
 } // namespace yaml_utils
 
 class YamlConfigurationNode : public std::enable_shared_from_this<YamlConfigurationNode>
@@ -1001,6 +1041,48 @@ public:
 		fout << ye.c_str();
 	}
 
+	void
+	write_snapshot(std::ostream &out) const
+	{
+		yaml_utils::write_snapshot_string(out, name_);
+		yaml_utils::write_snapshot_size(out, type_);
+		yaml_utils::write_snapshot_size(out, is_default_ ? 1 : 0);
+		yaml_utils::write_snapshot_string(out, scalar_value_);
+		yaml_utils::write_snapshot_size(out, list_values_.size());
+		for (const auto &v : list_values_) {
+			yaml_utils::write_snapshot_string(out, v);
+		}
+		yaml_utils::write_snapshot_size(out, children_.size());
+		for (const auto &c : children_) {
+			yaml_utils::write_snapshot_string(out, c.first);
+			c.second->write_snapshot(out);
+		}
+	}
+
+	static std::shared_ptr<YamlConfigurationNode>
+	read_snapshot(std::istream &in)
+	{
+		auto     n    = std::make_shared<YamlConfigurationNode>(yaml_utils::read_snapshot_string(in));
+		uint64_t type = yaml_utils::read_snapshot_size(in);
+		if (type > Type::UNKNOWN) {
+			throw Exception("YamlConfig: corrupt snapshot (invalid type %llu)", (unsigned long long)type);
+		}
+		n->type_         = (Type::value)type;
+		n->is_default_   = (yaml_utils::read_snapshot_size(in) != 0);
+		n->scalar_value_ = yaml_utils::read_snapshot_string(in);
+
+		uint64_t num_values = yaml_utils::read_snapshot_size(in);
+		for (uint64_t i = 0; i < num_values; ++i) {
+			n->list_values_.push_back(yaml_utils::read_snapshot_string(in));
+		}
+		uint64_t num_children = yaml_utils::read_snapshot_size(in);
+		for (uint64_t i = 0; i < num_children; ++i) {
+			std::string key   = yaml_utils::read_snapshot_string(in);
+			n->children_[key] = read_snapshot(in);
+		}
+		return n;
+	}
+
 	const std::string &
 	name() const
 	{
@@ -0,0 +1,152 @@
+
+/***************************************************************************
+ *  qa_spin_wait.cpp - QA for spinning barriers and wait conditions
+ *
+ *  Created: Wed Oct 14 19:24:48 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+// Do not mention in API doc
+/// @cond QA
+
+// Measures the hand-over latency of Barrier and WaitCondition with
+// spinning disabled and enabled. Usage: qa_core_spin_wait [spin_usec]
+
+#include <core/threading/barrier.h>
+#include <core/threading/mutex.h>
+#include <core/threading/spin_wait.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+using namespace fawkes;
+
+#define ROUNDS 20000
+
+static double
+now_usec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000. + ts.tv_nsec / 1000.;
+}
+
+class BarrierThread : public Thread
+{
+public:
+	BarrierThread(Barrier *barrier) : Thread("BarrierThread", Thread::OPMODE_CONTINUOUS)
+	{
+		barrier_ = barrier;
+	}
+
+	virtual void
+	run()
+	{
+		for (unsigned int i = 0; i < ROUNDS; ++i) {
+			barrier_->wait();
+		}
+	}
+
+private:
+	Barrier *barrier_;
+};
+
+class PingPongThread : public Thread
+{
+public:
+	PingPongThread(Mutex *mutex, WaitCondition *waitcond, unsigned int *turn, unsigned int me)
+	: Thread("PingPongThread", Thread::OPMODE_CONTINUOUS)
+	{
+		mutex_    = mutex;
+		waitcond_ = waitcond;
+		turn_     = turn;
+		me_       = me;
+	}
+
+	virtual void
+	run()
+	{
+		for (unsigned int i = 0; i < ROUNDS; ++i) {
+			mutex_->lock();
+			while (*turn_ != me_) {
+				waitcond_->wait();
+			}
+			*turn_ = 1 - me_;
+			waitcond_->wake_all();
+			mutex_->unlock();
+		}
+	}
+
+private:
+	Mutex *        mutex_;
+	WaitCondition *waitcond_;
+	unsigned int * turn_;
+	unsigned int   me_;
+};
+
+static void
+bench_barrier()
+{
+	Barrier *     b = new Barrier(2);
+	BarrierThread t1(b), t2(b);
+	double        start = now_usec();
+	t1.start();
+	t2.start();
+	t1.join();
+	t2.join();
+	printf("  Barrier:       %8.2f usec per round\n", (now_usec() - start) / ROUNDS);
+	delete b;
+}
+
+static void
+bench_waitcond(bool spinning)
+{
+	Mutex         m;
+	WaitCondition wc(&m);
+	wc.set_spinning(spinning);
+	unsigned int   turn = 0;
+	PingPongThread t1(&m, &wc, &turn, 0), t2(&m, &wc, &turn, 1);
+	double         start = now_usec();
+	t1.start();
+	t2.start();
+	t1.join();
+	t2.join();
+	printf("  WaitCondition: %8.2f usec per hand-over\n", (now_usec() - start) / (2 * ROUNDS));
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int spin_usec = (argc > 1) ? atoi(argv[1]) : 50;
+
+	printf("Without spinning\n");
+	SpinWait::set_max_spin_time(0);
+	bench_barrier();
+	bench_waitcond(false);
+
+	SpinWait::set_max_spin_time(spin_usec);
+	printf("With spinning (%u usec, effective %u usec)\n", spin_usec, SpinWait::max_spin_time());
+	bench_barrier();
+	bench_waitcond(true);
+
+	return 0;
+}
+
+/// @endcond
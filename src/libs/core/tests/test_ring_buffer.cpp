@@ -0,0 +1,224 @@
+/***************************************************************************
+ *  test_ring_buffer.cpp - SpscRingBuffer and MpmcRingBuffer Unit Test
+ *
+ *  Created: Thu Oct 15 09:45:41 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/utils/mpmc_ring_buffer.h>
+#include <core/utils/spsc_ring_buffer.h>
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+using namespace fawkes;
+
+TEST_CASE("SPSC capacity", "[spsc_ring_buffer]")
+{
+	REQUIRE_THROWS_AS(SpscRingBuffer<int>(0), Exception);
+	REQUIRE(SpscRingBuffer<int>(1).capacity() == 1);
+	REQUIRE(SpscRingBuffer<int>(5).capacity() == 8);
+	REQUIRE(SpscRingBuffer<int>(8).capacity() == 8);
+}
+
+TEST_CASE("SPSC push and pop", "[spsc_ring_buffer]")
+{
+	SpscRingBuffer<int> buffer(4);
+	int                 x = -1;
+	REQUIRE(buffer.empty());
+	REQUIRE_FALSE(buffer.try_pop(x));
+	REQUIRE(x == -1);
+
+	for (int i = 0; i < 4; i++) {
+		REQUIRE(buffer.try_push(i));
+	}
+	REQUIRE(buffer.size() == 4);
+	REQUIRE_FALSE(buffer.try_push(4));
+
+	for (int i = 0; i < 4; i++) {
+		REQUIRE(buffer.try_pop(x));
+		REQUIRE(x == i);
+	}
+	REQUIRE(buffer.empty());
+	REQUIRE_FALSE(buffer.try_pop(x));
+}
+
+TEST_CASE("SPSC wrap around", "[spsc_ring_buffer]")
+{
+	SpscRingBuffer<int> buffer(4);
+	int                 x;
+	// each round moves head and tail by three, so elements are stored at
+	// every offset of the ring
+	for (int i = 0; i < 1000; i++) {
+		for (int j = 0; j < 3; j++) {
+			REQUIRE(buffer.try_push(3 * i + j));
+		}
+		for (int j = 0; j < 3; j++) {
+			REQUIRE(buffer.try_pop(x));
+			REQUIRE(x == 3 * i + j);
+		}
+		REQUIRE(buffer.empty());
+	}
+
+	// interleaved pushes and pops keep the buffer at one element
+	SpscRingBuffer<int> single(1);
+	for (int i = 0; i < 1000; i++) {
+		REQUIRE(single.try_push(i));
+		REQUIRE_FALSE(single.try_push(-1));
+		REQUIRE(single.try_pop(x));
+		REQUIRE(x == i);
+	}
+	REQUIRE(single.empty());
+}
+
+TEST_CASE("SPSC producer and consumer threads", "[spsc_ring_buffer]")
+{
+	const int           num_items = 200000;
+	SpscRingBuffer<int> buffer(64);
+
+	std::thread producer([&buffer]() {
+		for (int i = 0; i < num_items; i++) {
+			while (!buffer.try_push(i))
+				std::this_thread::yield();
+		}
+	});
+
+	int  x;
+	bool in_order = true;
+	for (int i = 0; i < num_items; i++) {
+		while (!buffer.try_pop(x))
+			std::this_thread::yield();
+		in_order = in_order && (x == i);
+	}
+	producer.join();
+
+	REQUIRE(in_order);
+	REQUIRE(buffer.empty());
+}
+
+TEST_CASE("MPMC capacity", "[mpmc_ring_buffer]")
+{
+	REQUIRE_THROWS_AS(MpmcRingBuffer<int>(0), Exception);
+	REQUIRE(MpmcRingBuffer<int>(1).capacity() == 2);
+	REQUIRE(MpmcRingBuffer<int>(5).capacity() == 8);
+	REQUIRE(MpmcRingBuffer<int>(8).capacity() == 8);
+}
+
+TEST_CASE("MPMC push and pop", "[mpmc_ring_buffer]")
+{
+	MpmcRingBuffer<int> buffer(4);
+	int                 x = -1;
+	REQUIRE(buffer.empty());
+	REQUIRE_FALSE(buffer.try_pop(x));
+	REQUIRE(x == -1);
+
+	for (int i = 0; i < 4; i++) {
+		REQUIRE(buffer.try_push(i));
+	}
+	REQUIRE(buffer.size() == 4);
+	REQUIRE_FALSE(buffer.try_push(4));
+
+	for (int i = 0; i < 4; i++) {
+		REQUIRE(buffer.try_pop(x));
+		REQUIRE(x == i);
+	}
+	REQUIRE(buffer.empty());
+	REQUIRE_FALSE(buffer.try_pop(x));
+}
+
+TEST_CASE("MPMC wrap around", "[mpmc_ring_buffer]")
+{
+	MpmcRingBuffer<int> buffer(4);
+	int                 x;
+	// each round moves head and tail by three, so cells are reused at
+	// every offset of the ring
+	for (int i = 0; i < 1000; i++) {
+		for (int j = 0; j < 3; j++) {
+			REQUIRE(buffer.try_push(3 * i + j));
+		}
+		for (int j = 0; j < 3; j++) {
+			REQUIRE(buffer.try_pop(x));
+			REQUIRE(x == 3 * i + j);
+		}
+		REQUIRE(buffer.empty());
+	}
+}
+
+TEST_CASE("MPMC stress", "[mpmc_ring_buffer]")
+{
+	const unsigned int num_producers = 4;
+	const unsigned int num_consumers = 4;
+	const int          num_items     = 100000;
+
+	MpmcRingBuffer<int>           buffer(128);
+	std::atomic<int>              num_popped(0);
+	std::vector<std::vector<int>> popped(num_consumers);
+	std::vector<std::thread>      threads;
+
+	for (unsigned int p = 0; p < num_producers; p++) {
+		threads.emplace_back([&buffer, p]() {
+			for (int i = 0; i < num_items; i++) {
+				while (!buffer.try_push(p * num_items + i))
+					std::this_thread::yield();
+			}
+		});
+	}
+	for (unsigned int c = 0; c < num_consumers; c++) {
+		threads.emplace_back([&buffer, &num_popped, &popped, c]() {
+			int x;
+			while (num_popped.load() < (int)(num_producers * num_items)) {
+				if (buffer.try_pop(x)) {
+					popped[c].push_back(x);
+					++num_popped;
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	// every item must have been popped exactly once, and each consumer
+	// must see the items of one producer in the order they were pushed
+	std::vector<unsigned int> count(num_producers * num_items, 0);
+	bool                      in_order = true;
+	for (const auto &items : popped) {
+		std::vector<int> last(num_producers, -1);
+		for (int x : items) {
+			count[x] += 1;
+			int &l   = last[x / num_items];
+			in_order = in_order && (x % num_items > l);
+			l        = x % num_items;
+		}
+	}
+	unsigned int num_lost = 0, num_duplicated = 0;
+	for (unsigned int n : count) {
+		if (n == 0)
+			++num_lost;
+		if (n > 1)
+			++num_duplicated;
+	}
+	REQUIRE(num_lost == 0);
+	REQUIRE(num_duplicated == 0);
+	REQUIRE(in_order);
+	REQUIRE(buffer.empty());
+}
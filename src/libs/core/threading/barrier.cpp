@@ -23,7 +23,11 @@
 
 #include <core/exception.h>
 #include <core/threading/barrier.h>
+#include <core/threading/mutex.h>
+#include <core/threading/spin_wait.h>
+#include <core/threading/wait_condition.h>
 
+#include <atomic>
 #include <pthread.h>
 #include <unistd.h>
 
@@ -32,8 +36,6 @@
 #	define USE_POSIX_BARRIERS
 #else
 #	undef USE_POSIX_BARRIERS
-#	include <core/threading/mutex.h>
-#	include <core/threading/wait_condition.h>
 #endif
 
 namespace fawkes {
@@ -42,13 +44,32 @@ namespace fawkes {
 class BarrierData
 {
 public:
-#ifdef USE_POSIX_BARRIERS
-	pthread_barrier_t barrier;
-#else
-	BarrierData() : threads_left(0), mutex(), waitcond(&mutex)
+	BarrierData()
+	: spinning(SpinWait::max_spin_time() > 0),
+	  arrived(0),
+	  generation(0),
+	  parked(0),
+	  park_waitcond(&park_mutex)
+#ifndef USE_POSIX_BARRIERS
+	  ,
+	  threads_left(0),
+	  waitcond(&mutex)
+#endif
 	{
 	}
 
+	// spin-then-park implementation, fixed at construction
+	bool                      spinning;
+	std::atomic<unsigned int> arrived;
+	std::atomic<unsigned int> generation;
+	std::atomic<unsigned int> parked;
+	SpinWait                  spin_wait;
+	Mutex                     park_mutex;
+	WaitCondition             park_waitcond;
+
+#ifdef USE_POSIX_BARRIERS
+	pthread_barrier_t barrier;
+#else
 	unsigned int  threads_left;
 	Mutex         mutex;
 	WaitCondition waitcond;
@@ -104,6 +125,11 @@ public:
  * delay may increase on a loaded system). Because of this on systems without
  * real POSIX barriers the performance may be not as good as is expected.
  *
+ * If spinning has been enabled with SpinWait::set_max_spin_time() before
+ * the barrier is created, waiting threads first busy-wait for a bounded
+ * time for the last thread to arrive and only then block. This avoids the
+ * sleep and wakeup latency if all threads arrive within a few microseconds.
+ *
  * @ingroup Threading
  * @author Tim Niemueller
  */
@@ -119,7 +145,8 @@ Barrier::Barrier(unsigned int count)
 	}
 	barrier_data = new BarrierData();
 #ifdef USE_POSIX_BARRIERS
-	pthread_barrier_init(&(barrier_data->barrier), NULL, _count);
+	if (!barrier_data->spinning)
+		pthread_barrier_init(&(barrier_data->barrier), NULL, _count);
 #else
 	barrier_data->threads_left = _count;
 #endif
@@ -139,7 +166,8 @@ Barrier::~Barrier()
 {
 	if (barrier_data) {
 #ifdef USE_POSIX_BARRIERS
-		pthread_barrier_destroy(&(barrier_data->barrier));
+		if (!barrier_data->spinning)
+			pthread_barrier_destroy(&(barrier_data->barrier));
 #endif
 		delete barrier_data;
 	}
@@ -152,6 +180,30 @@ Barrier::~Barrier()
 void
 Barrier::wait()
 {
+	if (barrier_data->spinning) {
+		BarrierData *d   = barrier_data;
+		unsigned int gen = d->generation.load();
+		if (d->arrived.fetch_add(1) + 1 == _count) {
+			// reset before releasing, waiters may immediately enter the next round
+			d->arrived.store(0);
+			d->generation.fetch_add(1);
+			if (d->parked.load() > 0) {
+				d->park_mutex.lock();
+				d->park_waitcond.wake_all();
+				d->park_mutex.unlock();
+			}
+		} else if (!d->spin_wait.spin([d, gen] { return d->generation.load() != gen; })) {
+			d->park_mutex.lock();
+			d->parked.fetch_add(1);
+			while (d->generation.load() == gen) {
+				d->park_waitcond.wait();
+			}
+			d->parked.fetch_sub(1);
+			d->park_mutex.unlock();
+		}
+		return;
+	}
+
 #ifdef USE_POSIX_BARRIERS
 	pthread_barrier_wait(&(barrier_data->barrier));
 #else
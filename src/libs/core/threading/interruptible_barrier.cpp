@@ -49,6 +49,7 @@ public:
 			own_mutex   = true;
 		}
 		waitcond = new WaitCondition(this->mutex);
+		waitcond->set_spinning(true);
 	}
 
 	~InterruptibleBarrierData()
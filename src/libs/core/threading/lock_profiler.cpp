@@ -0,0 +1,194 @@
+
+/***************************************************************************
+ *  lock_profiler.cpp - Contention profiling of named locks
+ *
+ *  Created: Thu Oct 15 07:27:11 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/lock_profiler.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+static pthread_mutex_t profiles_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// @endcond
+
+/** @class LockProfile <core/threading/lock_profiler.h>
+ * Contention profile of locks sharing a name.
+ * Profiles are created through LockProfiler::profile() and are updated
+ * by the locks with relaxed atomic operations only.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param name name of the locks
+ */
+LockProfile::LockProfile(const char *name)
+: name_(strdup(name)),
+  num_locks_(0),
+  num_contended_(0),
+  wait_nsec_(0),
+  max_wait_nsec_(0),
+  hold_nsec_(0),
+  max_hold_nsec_(0),
+  next_(NULL)
+{
+}
+
+/** @class LockProfiler <core/threading/lock_profiler.h>
+ * Contention profiler for locks.
+ * Locks which have been given a name, e.g. with Mutex::set_name(), record
+ * how often they have been acquired, how often and how long a thread had
+ * to wait for them, and how long they have been held exclusively. Locks
+ * with the same name share one profile, e.g. all locks of a certain kind
+ * of object. Locks without a name are not profiled.
+ *
+ * Profiling is disabled by default. While disabled, named locks only
+ * check a flag. While enabled, a lock first tries to acquire without
+ * blocking, and only if that fails measures the time until it acquired
+ * the lock.
+ *
+ * Profiles are never freed, they are kept in a list which can be
+ * traversed without locking. This allows to print the statistics from
+ * within a signal handler, e.g. to find the lock responsible for a loop
+ * overrun while it happens.
+ * @author agent
+ */
+
+/// @cond INTERNALS
+std::atomic<bool>          LockProfiler::enabled_(false);
+std::atomic<LockProfile *> LockProfiler::profiles_(NULL);
+/// @endcond
+
+/** Enable or disable profiling.
+ * @param enabled true to enable profiling, false to disable
+ */
+void
+LockProfiler::set_enabled(bool enabled)
+{
+	enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+/** Get profile for a name.
+ * The profile is created if it does not exist, yet.
+ * @param name name of the locks
+ * @return profile, valid for the lifetime of the process
+ */
+LockProfile *
+LockProfiler::profile(const char *name)
+{
+	pthread_mutex_lock(&profiles_mutex);
+	LockProfile *p = profiles_.load(std::memory_order_acquire);
+	for (; p != NULL; p = p->next_) {
+		if (strcmp(p->name_, name) == 0)
+			break;
+	}
+	if (!p) {
+		p        = new LockProfile(name);
+		p->next_ = profiles_.load(std::memory_order_relaxed);
+		profiles_.store(p, std::memory_order_release);
+	}
+	pthread_mutex_unlock(&profiles_mutex);
+	return p;
+}
+
+/** Get current statistics.
+ * @return statistics of all profiles
+ */
+std::list<LockProfiler::LockStats>
+LockProfiler::stats()
+{
+	std::list<LockStats> rv;
+	for (LockProfile *p = profiles_.load(std::memory_order_acquire); p != NULL; p = p->next_) {
+		LockStats s;
+		s.name          = p->name_;
+		s.num_locks     = p->num_locks_.load(std::memory_order_relaxed);
+		s.num_contended = p->num_contended_.load(std::memory_order_relaxed);
+		s.wait_nsec     = p->wait_nsec_.load(std::memory_order_relaxed);
+		s.max_wait_nsec = p->max_wait_nsec_.load(std::memory_order_relaxed);
+		s.hold_nsec     = p->hold_nsec_.load(std::memory_order_relaxed);
+		s.max_hold_nsec = p->max_hold_nsec_.load(std::memory_order_relaxed);
+		rv.push_back(s);
+	}
+	return rv;
+}
+
+/** Reset all statistics to zero. */
+void
+LockProfiler::reset()
+{
+	for (LockProfile *p = profiles_.load(std::memory_order_acquire); p != NULL; p = p->next_) {
+		p->num_locks_.store(0, std::memory_order_relaxed);
+		p->num_contended_.store(0, std::memory_order_relaxed);
+		p->wait_nsec_.store(0, std::memory_order_relaxed);
+		p->max_wait_nsec_.store(0, std::memory_order_relaxed);
+		p->hold_nsec_.store(0, std::memory_order_relaxed);
+		p->max_hold_nsec_.store(0, std::memory_order_relaxed);
+	}
+}
+
+/** Print statistics to stdout.
+ * This neither allocates memory nor acquires locks, it is hence safe to
+ * call from a signal handler.
+ */
+void
+LockProfiler::print()
+{
+	char buf[512];
+	int  len = snprintf(buf,
+	                    sizeof(buf),
+	                    "\nLock profile%s\n"
+	                    "%-40s %10s %10s %12s %10s %12s %10s\n",
+	                    enabled() ? "" : " (disabled)",
+	                    "Name",
+	                    "Locks",
+	                    "Contended",
+	                    "Wait ms",
+	                    "Max wait",
+	                    "Hold ms",
+	                    "Max hold");
+	if (write(STDOUT_FILENO, buf, len) < 0)
+		return;
+
+	for (LockProfile *p = profiles_.load(std::memory_order_acquire); p != NULL; p = p->next_) {
+		len = snprintf(buf,
+		               sizeof(buf),
+		               "%-40s %10" PRIu64 " %10" PRIu64 " %12.3f %10.3f %12.3f %10.3f\n",
+		               p->name_,
+		               p->num_locks_.load(std::memory_order_relaxed),
+		               p->num_contended_.load(std::memory_order_relaxed),
+		               p->wait_nsec_.load(std::memory_order_relaxed) / 1e6,
+		               p->max_wait_nsec_.load(std::memory_order_relaxed) / 1e6,
+		               p->hold_nsec_.load(std::memory_order_relaxed) / 1e6,
+		               p->max_hold_nsec_.load(std::memory_order_relaxed) / 1e6);
+		if (len > (int)sizeof(buf) - 1)
+			len = sizeof(buf) - 1;
+		if (write(STDOUT_FILENO, buf, len) < 0)
+			return;
+	}
+}
+
+} // end namespace fawkes
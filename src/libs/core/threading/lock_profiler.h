@@ -0,0 +1,152 @@
+
+/***************************************************************************
+ *  lock_profiler.h - Contention profiling of named locks
+ *
+ *  Created: Thu Oct 15 07:27:11 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_THREADING_LOCK_PROFILER_H_
+#define _CORE_THREADING_LOCK_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <time.h>
+
+namespace fawkes {
+
+class LockProfiler;
+
+class LockProfile
+{
+	friend LockProfiler;
+
+public:
+	/** Get name.
+	 * @return name of the profiled locks */
+	const char *
+	name() const
+	{
+		return name_;
+	}
+
+	/** Count acquisition of the lock.
+	 * @param contended true if the lock was not immediately available
+	 * @param wait_nsec time waited for the lock in nanoseconds */
+	void
+	count_lock(bool contended, uint64_t wait_nsec)
+	{
+		num_locks_.fetch_add(1, std::memory_order_relaxed);
+		if (contended) {
+			num_contended_.fetch_add(1, std::memory_order_relaxed);
+			wait_nsec_.fetch_add(wait_nsec, std::memory_order_relaxed);
+			update_max(max_wait_nsec_, wait_nsec);
+		}
+	}
+
+	/** Count wait for a condition.
+	 * @param wait_nsec time waited for the condition in nanoseconds */
+	void
+	count_wait(uint64_t wait_nsec)
+	{
+		num_locks_.fetch_add(1, std::memory_order_relaxed);
+		wait_nsec_.fetch_add(wait_nsec, std::memory_order_relaxed);
+		update_max(max_wait_nsec_, wait_nsec);
+	}
+
+	/** Count time the lock was held.
+	 * @param hold_nsec time the lock was held in nanoseconds */
+	void
+	count_hold(uint64_t hold_nsec)
+	{
+		hold_nsec_.fetch_add(hold_nsec, std::memory_order_relaxed);
+		update_max(max_hold_nsec_, hold_nsec);
+	}
+
+private:
+	explicit LockProfile(const char *name);
+
+	static void
+	update_max(std::atomic<uint64_t> &max, uint64_t v)
+	{
+		uint64_t cur = max.load(std::memory_order_relaxed);
+		while (v > cur && !max.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+		}
+	}
+
+	char *                name_;
+	std::atomic<uint64_t> num_locks_;
+	std::atomic<uint64_t> num_contended_;
+	std::atomic<uint64_t> wait_nsec_;
+	std::atomic<uint64_t> max_wait_nsec_;
+	std::atomic<uint64_t> hold_nsec_;
+	std::atomic<uint64_t> max_hold_nsec_;
+	LockProfile *         next_;
+};
+
+class LockProfiler
+{
+public:
+	/** Contention statistics of locks sharing a name. */
+	typedef struct
+	{
+		std::string name;          ///< name of the locks
+		uint64_t    num_locks;     ///< number of acquisitions
+		uint64_t    num_contended; ///< number of acquisitions which had to wait
+		uint64_t    wait_nsec;     ///< accumulated wait time in nanoseconds
+		uint64_t    max_wait_nsec; ///< maximum wait time in nanoseconds
+		uint64_t    hold_nsec;     ///< accumulated exclusive hold time in nanoseconds
+		uint64_t    max_hold_nsec; ///< maximum exclusive hold time in nanoseconds
+	} LockStats;
+
+	static void set_enabled(bool enabled);
+
+	/** Check if profiling is enabled.
+	 * @return true if profiling is enabled, false otherwise */
+	static bool
+	enabled()
+	{
+		return enabled_.load(std::memory_order_relaxed);
+	}
+
+	/** Get monotonic time for profiling.
+	 * @return monotonic time in nanoseconds */
+	static uint64_t
+	now_nsec()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+
+	static LockProfile *profile(const char *name);
+
+	static std::list<LockStats> stats();
+	static void                 reset();
+	static void                 print();
+
+private:
+	static std::atomic<bool>          enabled_;
+	static std::atomic<LockProfile *> profiles_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -86,9 +86,13 @@ Mutex::~Mutex()
 void
 Mutex::lock()
 {
-	int err = 0;
-	if ((err = pthread_mutex_lock(&(mutex_data->mutex))) != 0) {
-		throw Exception(err, "Failed to aquire lock for thread %s", Thread::current_thread()->name());
+	if (mutex_data->profile && LockProfiler::enabled()) {
+		mutex_data->lock_profiled();
+	} else {
+		int err = 0;
+		if ((err = pthread_mutex_lock(&(mutex_data->mutex))) != 0) {
+			MutexData::throw_lock_error(err);
+		}
 	}
 #ifdef DEBUG_THREADING
 	// do not switch order, lock holder must be protected with this mutex!
@@ -120,6 +124,10 @@ Mutex::try_lock()
 #ifdef DEBUG_THREADING
 		mutex_data->set_lock_holder();
 #endif
+		if (mutex_data->profile && LockProfiler::enabled()) {
+			mutex_data->profile->count_lock(false, 0);
+			mutex_data->locked_at = LockProfiler::now_nsec();
+		}
 		return true;
 	} else {
 		return false;
@@ -134,6 +142,7 @@ Mutex::unlock()
 	mutex_data->unset_lock_holder();
 	// do not switch order, lock holder must be protected with this mutex!
 #endif
+	mutex_data->hold_end();
 	pthread_mutex_unlock(&(mutex_data->mutex));
 }
 
@@ -153,4 +162,24 @@ Mutex::stopby()
 	pthread_mutex_unlock(&(mutex_data->mutex));
 }
 
+/** Set name for contention profiling.
+ * Named mutexes are profiled while the LockProfiler is enabled. Mutexes
+ * with the same name share one profile. Call this before the mutex is
+ * used concurrently.
+ * @param name name of the mutex, NULL to disable profiling of this mutex
+ */
+void
+Mutex::set_name(const char *name)
+{
+	mutex_data->profile = name ? LockProfiler::profile(name) : NULL;
+}
+
+/// @cond INTERNALS
+void
+MutexData::throw_lock_error(int err)
+{
+	throw Exception(err, "Failed to aquire lock for thread %s", Thread::current_thread()->name());
+}
+/// @endcond
+
 } // end namespace fawkes
@@ -50,6 +50,8 @@ public:
 
 	void stopby();
 
+	void set_name(const char *name);
+
 private:
 	MutexData *mutex_data;
 };
@@ -24,6 +24,8 @@
 #ifndef _CORE_THREADING_MUTEX_DATA_H_
 #define _CORE_THREADING_MUTEX_DATA_H_
 
+#include <core/threading/lock_profiler.h>
+
 #include <pthread.h>
 
 #ifdef DEBUG_THREADING
@@ -44,6 +46,41 @@ class MutexData
 {
 public:
 	pthread_mutex_t mutex;
+	LockProfile *   profile   = NULL;
+	uint64_t        locked_at = 0;
+
+	void
+	lock_profiled()
+	{
+		if (pthread_mutex_trylock(&mutex) == 0) {
+			profile->count_lock(false, 0);
+		} else {
+			uint64_t start = LockProfiler::now_nsec();
+			int      err   = pthread_mutex_lock(&mutex);
+			if (err != 0)
+				throw_lock_error(err);
+			profile->count_lock(true, LockProfiler::now_nsec() - start);
+		}
+		locked_at = LockProfiler::now_nsec();
+	}
+
+	void
+	hold_end()
+	{
+		if (locked_at != 0) {
+			profile->count_hold(LockProfiler::now_nsec() - locked_at);
+			locked_at = 0;
+		}
+	}
+
+	void
+	hold_begin()
+	{
+		if (profile && LockProfiler::enabled())
+			locked_at = LockProfiler::now_nsec();
+	}
+
+	static void throw_lock_error(int err);
 
 #ifdef DEBUG_THREADING
 	MutexData()
@@ -21,6 +21,7 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <core/threading/lock_profiler.h>
 #include <core/threading/read_write_lock.h>
 
 #include <cstring>
@@ -32,8 +33,51 @@ namespace fawkes {
 class ReadWriteLockData
 {
 public:
-	pthread_rwlock_t rwlock;
+	pthread_rwlock_t  local_rwlock;
+	pthread_rwlock_t *rwlock;
+	LockProfile *     profile         = NULL;
+	uint64_t          write_locked_at = 0;
 };
+
+static void
+lock_profiled(ReadWriteLockData *d, bool write)
+{
+	int (*trylock)(pthread_rwlock_t *) = write ? pthread_rwlock_trywrlock : pthread_rwlock_tryrdlock;
+	int (*lock)(pthread_rwlock_t *)    = write ? pthread_rwlock_wrlock : pthread_rwlock_rdlock;
+	if (trylock(d->rwlock) == 0) {
+		d->profile->count_lock(false, 0);
+	} else {
+		uint64_t start = LockProfiler::now_nsec();
+		lock(d->rwlock);
+		d->profile->count_lock(true, LockProfiler::now_nsec() - start);
+	}
+	if (write)
+		d->write_locked_at = LockProfiler::now_nsec();
+}
+
+static void
+init_rwlock(pthread_rwlock_t *rwlock, ReadWriteLock::ReadWriteLockPolicy policy, bool pshared)
+{
+	pthread_rwlockattr_t attr;
+	pthread_rwlockattr_init(&attr);
+	if (pshared) {
+		pthread_rwlockattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	}
+
+#if defined __USE_UNIX98 || defined __USE_XOPEN2K
+	switch (policy) {
+	case ReadWriteLock::RWLockPolicyPreferWriter:
+		pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+		break;
+	case ReadWriteLock::RWLockPolicyPreferReader:
+		pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_READER_NP);
+		break;
+	}
+#endif
+
+	pthread_rwlock_init(rwlock, &attr);
+	pthread_rwlockattr_destroy(&attr);
+}
 /// @endcond
 
 /** @class ReadWriteLock core/threading/read_write_lock.h
@@ -56,34 +100,54 @@ public:
  */
 ReadWriteLock::ReadWriteLock(ReadWriteLockPolicy policy)
 {
-	rwlock_data = new ReadWriteLockData();
-
-#if defined __USE_UNIX98 || defined __USE_XOPEN2K
-	pthread_rwlockattr_t attr;
-	pthread_rwlockattr_init(&attr);
+	rwlock_data         = new ReadWriteLockData();
+	rwlock_data->rwlock = &(rwlock_data->local_rwlock);
+	init_rwlock(rwlock_data->rwlock, policy, /* pshared */ false);
+}
 
-	switch (policy) {
-	case RWLockPolicyPreferWriter:
-		pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
-		break;
-	case RWLockPolicyPreferReader:
-		pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_READER_NP);
-		break;
+/** Process-shared lock constructor.
+ * The lock is not stored in the instance but in the given memory, which
+ * is typically part of a shared memory segment. The lock can then be
+ * shared among several processes which all create a ReadWriteLock for the
+ * same memory. The instance does not own the lock, it is not destroyed on
+ * deletion of the instance. Call destroy_shared() once the lock is no
+ * longer used by any process before releasing the memory.
+ * @param shared_rwlock memory to store the lock in, must be at least of the
+ * size of a pthread_rwlock_t and properly aligned
+ * @param initialize true to initialize the lock, must be done exactly
+ * once for the given memory, false to attach to an already initialized lock
+ * @param policy The read/write lock policy to use, only used if the
+ * lock is initialized.
+ */
+ReadWriteLock::ReadWriteLock(void *shared_rwlock, bool initialize, ReadWriteLockPolicy policy)
+{
+	rwlock_data         = new ReadWriteLockData();
+	rwlock_data->rwlock = static_cast<pthread_rwlock_t *>(shared_rwlock);
+	if (initialize) {
+		init_rwlock(rwlock_data->rwlock, policy, /* pshared */ true);
 	}
-
-	pthread_rwlock_init(&(rwlock_data->rwlock), &attr);
-#else
-	pthread_rwlock_init(&(rwlock_data->rwlock), NULL);
-#endif
 }
 
 /** Destructor */
 ReadWriteLock::~ReadWriteLock()
 {
-	pthread_rwlock_destroy(&(rwlock_data->rwlock));
+	if (rwlock_data->rwlock == &(rwlock_data->local_rwlock)) {
+		pthread_rwlock_destroy(rwlock_data->rwlock);
+	}
 	delete rwlock_data;
 }
 
+/** Destroy process-shared lock.
+ * @param shared_rwlock memory of a lock passed as initialized lock to the
+ * process-shared lock constructor before. No process may use the lock
+ * after it has been destroyed.
+ */
+void
+ReadWriteLock::destroy_shared(void *shared_rwlock)
+{
+	pthread_rwlock_destroy(static_cast<pthread_rwlock_t *>(shared_rwlock));
+}
+
 /** Aquire a reader lock.
  * This will aquire the lock for reading. Multiple readers can aquire the
  * lock at the same time. But never when a writer has the lock.
@@ -92,7 +156,11 @@ ReadWriteLock::~ReadWriteLock()
 void
 ReadWriteLock::lock_for_read()
 {
-	pthread_rwlock_rdlock(&(rwlock_data->rwlock));
+	if (rwlock_data->profile && LockProfiler::enabled()) {
+		lock_profiled(rwlock_data, /* write */ false);
+	} else {
+		pthread_rwlock_rdlock(rwlock_data->rwlock);
+	}
 }
 
 /** Aquire a writer lock.
@@ -103,7 +171,11 @@ ReadWriteLock::lock_for_read()
 void
 ReadWriteLock::lock_for_write()
 {
-	pthread_rwlock_wrlock(&(rwlock_data->rwlock));
+	if (rwlock_data->profile && LockProfiler::enabled()) {
+		lock_profiled(rwlock_data, /* write */ true);
+	} else {
+		pthread_rwlock_wrlock(rwlock_data->rwlock);
+	}
 }
 
 /** Tries to aquire a reader lock.
@@ -115,7 +187,7 @@ ReadWriteLock::lock_for_write()
 bool
 ReadWriteLock::try_lock_for_read()
 {
-	return (pthread_rwlock_tryrdlock(&(rwlock_data->rwlock)) == 0);
+	return (pthread_rwlock_tryrdlock(rwlock_data->rwlock) == 0);
 }
 
 /** Tries to aquire a writer lock.
@@ -127,7 +199,14 @@ ReadWriteLock::try_lock_for_read()
 bool
 ReadWriteLock::try_lock_for_write()
 {
-	return (pthread_rwlock_trywrlock(&(rwlock_data->rwlock)) == 0);
+	if (pthread_rwlock_trywrlock(rwlock_data->rwlock) != 0) {
+		return false;
+	}
+	if (rwlock_data->profile && LockProfiler::enabled()) {
+		rwlock_data->profile->count_lock(false, 0);
+		rwlock_data->write_locked_at = LockProfiler::now_nsec();
+	}
+	return true;
 }
 
 /** Release the lock.
@@ -136,7 +215,25 @@ ReadWriteLock::try_lock_for_write()
 void
 ReadWriteLock::unlock()
 {
-	pthread_rwlock_unlock(&(rwlock_data->rwlock));
+	// only set while write-locked, hence only the writer can see it
+	if (rwlock_data->write_locked_at != 0) {
+		rwlock_data->profile->count_hold(LockProfiler::now_nsec() - rwlock_data->write_locked_at);
+		rwlock_data->write_locked_at = 0;
+	}
+	pthread_rwlock_unlock(rwlock_data->rwlock);
+}
+
+/** Set name for contention profiling.
+ * Named locks are profiled while the LockProfiler is enabled. Locks with
+ * the same name share one profile. Acquisitions and wait times are
+ * recorded for readers and writers, hold times only for writers. Call
+ * this before the lock is used concurrently.
+ * @param name name of the lock, NULL to disable profiling of this lock
+ */
+void
+ReadWriteLock::set_name(const char *name)
+{
+	rwlock_data->profile = name ? LockProfiler::profile(name) : NULL;
 }
 
 } // end namespace fawkes
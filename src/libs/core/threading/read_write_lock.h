@@ -58,6 +58,9 @@ public:
 	};
 
 	ReadWriteLock(ReadWriteLockPolicy policy = RWLockPolicyPreferWriter);
+	ReadWriteLock(void *              shared_rwlock,
+	              bool                initialize,
+	              ReadWriteLockPolicy policy = RWLockPolicyPreferWriter);
 
 	virtual ~ReadWriteLock();
 
@@ -67,6 +70,10 @@ public:
 	bool try_lock_for_write();
 	void unlock();
 
+	void set_name(const char *name);
+
+	static void destroy_shared(void *shared_rwlock);
+
 private:
 	ReadWriteLockData *rwlock_data;
 };
@@ -46,6 +46,20 @@ RefCountRWLock::RefCountRWLock(ReadWriteLock::ReadWriteLockPolicy policy)
 {
 }
 
+/** Process-shared lock constructor.
+ * @param shared_rwlock memory to store the lock in
+ * @param initialize true to initialize the lock, false to attach to an
+ * already initialized lock
+ * @param policy Policy, see ReadWriteLock::ReadWriteLock() for more info on this.
+ * @see ReadWriteLock::ReadWriteLock(void *, bool, ReadWriteLockPolicy)
+ */
+RefCountRWLock::RefCountRWLock(void *                             shared_rwlock,
+                               bool                               initialize,
+                               ReadWriteLock::ReadWriteLockPolicy policy)
+: ReadWriteLock(shared_rwlock, initialize, policy), RefCount()
+{
+}
+
 /** Destructor */
 RefCountRWLock::~RefCountRWLock()
 {
@@ -34,6 +34,10 @@ class RefCountRWLock : public ReadWriteLock, public RefCount
 public:
 	RefCountRWLock(
 	  ReadWriteLock::ReadWriteLockPolicy policy = ReadWriteLock::RWLockPolicyPreferWriter);
+	RefCountRWLock(
+	  void *                             shared_rwlock,
+	  bool                               initialize,
+	  ReadWriteLock::ReadWriteLockPolicy policy = ReadWriteLock::RWLockPolicyPreferWriter);
 
 	virtual ~RefCountRWLock();
 };
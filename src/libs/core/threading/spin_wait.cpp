@@ -0,0 +1,76 @@
+
+/***************************************************************************
+ *  spin_wait.cpp - Adaptive bounded spinning before blocking
+ *
+ *  Created: Wed Oct 14 19:24:48 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/spin_wait.h>
+
+#include <unistd.h>
+
+namespace fawkes {
+
+/** @class SpinWait <core/threading/spin_wait.h>
+ * Adaptive bounded spinning before blocking.
+ * Blocking in the kernel and being woken up again takes several
+ * microseconds, which dominates short waits like the hand-over between
+ * the main loop and the threads of a hook. Synchronization primitives can
+ * use this class to first busy-wait for a bounded time, issuing CPU pause
+ * instructions, and only block if the wait takes longer.
+ *
+ * Spinning is disabled by default and is enabled application-wide by
+ * setting a maximum spin time. It is never enabled on single-core
+ * machines, where spinning only delays the thread we are waiting for.
+ * Spinning is a trade of CPU time and thus energy for latency, keep it
+ * disabled on battery-constrained hardware.
+ * @ingroup Threading
+ * @author agent
+ */
+
+std::atomic<unsigned int> SpinWait::max_spin_usec_(0);
+
+/** Constructor. */
+SpinWait::SpinWait() : budget_usec_(0)
+{
+}
+
+/** Set maximum spin time.
+ * This affects all spinning synchronization primitives. Barriers decide
+ * whether to spin when they are created, hence set this early.
+ * @param usec maximum time to spin before blocking in microseconds, 0 to
+ * disable spinning
+ */
+void
+SpinWait::set_max_spin_time(unsigned int usec)
+{
+	long int cores = sysconf(_SC_NPROCESSORS_ONLN);
+	max_spin_usec_.store((cores > 1) ? usec : 0, std::memory_order_relaxed);
+}
+
+/** Get maximum spin time.
+ * @return maximum spin time in microseconds, 0 if spinning is disabled
+ */
+unsigned int
+SpinWait::max_spin_time()
+{
+	return max_spin_usec_.load(std::memory_order_relaxed);
+}
+
+} // end namespace fawkes
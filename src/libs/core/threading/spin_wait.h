@@ -0,0 +1,103 @@
+
+/***************************************************************************
+ *  spin_wait.h - Adaptive bounded spinning before blocking
+ *
+ *  Created: Wed Oct 14 19:24:48 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_THREADING_SPIN_WAIT_H_
+#define _CORE_THREADING_SPIN_WAIT_H_
+
+#include <atomic>
+#include <ctime>
+
+namespace fawkes {
+
+class SpinWait
+{
+public:
+	SpinWait();
+
+	static void         set_max_spin_time(unsigned int usec);
+	static unsigned int max_spin_time();
+
+	/** Hint to the CPU that we are busy-waiting. */
+	static inline void
+	relax()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+		__asm__ __volatile__("yield");
+#else
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+	}
+
+	/** Spin until a condition holds or the spin budget is exhausted.
+	 * The budget adapts to how long waits take. It is doubled (up to the
+	 * maximum spin time) each time the condition became true while
+	 * spinning and halved each time spinning was in vain, hence waits which
+	 * regularly take longer than the maximum spin time quickly stop
+	 * wasting CPU time.
+	 * @param cond condition to wait for, called repeatedly
+	 * @return true if the condition holds, false if the caller should block
+	 */
+	template <typename Condition>
+	bool
+	spin(Condition cond)
+	{
+		unsigned int max = max_spin_usec_.load(std::memory_order_relaxed);
+		if (max == 0) {
+			return cond();
+		}
+		unsigned int budget = budget_usec_.load(std::memory_order_relaxed);
+		if (budget == 0 || budget > max) {
+			budget = max;
+		}
+
+		struct timespec start, now;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (unsigned int i = 1;; ++i) {
+			if (cond()) {
+				budget_usec_.store(budget * 2 < max ? budget * 2 : max, std::memory_order_relaxed);
+				return true;
+			}
+			relax();
+			if ((i & 63) == 0) {
+				clock_gettime(CLOCK_MONOTONIC, &now);
+				long int usec =
+				  (now.tv_sec - start.tv_sec) * 1000000 + (now.tv_nsec - start.tv_nsec) / 1000;
+				if (usec >= (long int)budget)
+					break;
+			}
+		}
+		unsigned int min = max / 16 > 0 ? max / 16 : 1;
+		budget_usec_.store(budget / 2 > min ? budget / 2 : min, std::memory_order_relaxed);
+		return cond();
+	}
+
+private:
+	std::atomic<unsigned int>        budget_usec_;
+	static std::atomic<unsigned int> max_spin_usec_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -45,7 +45,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
+#ifdef __linux__
+#	include <sys/resource.h>
+#	include <sys/syscall.h>
+#endif
 
 namespace fawkes {
 
@@ -260,6 +265,10 @@ Thread::__constructor(const char *name, OpMode op_mode)
 
 	thread_id_       = 0;
 	flags_           = 0;
+	sched_policy_    = SCHED_POLICY_DEFAULT;
+	sched_priority_  = 0;
+	sched_error_     = 0;
+	tid_             = 0;
 	barrier_         = NULL;
 	started_         = false;
 	cancelled_       = false;
@@ -548,6 +557,12 @@ Thread::entry(void *pthis)
 	// Set thread instance as TSD
 	set_tsd_thread_instance(t);
 
+#ifdef __linux__
+	t->tid_ = syscall(SYS_gettid);
+#endif
+	// apply CPU affinity and scheduling before anything else runs
+	t->sched_error_ = t->apply_scheduling(pthread_self(), 0);
+
 	// lock sleep mutex, needed such that thread waits for initial wakeup
 	t->lock_sleep_mutex();
 
@@ -718,6 +733,145 @@ Thread::set_prepfin_conc_loop(bool concurrent)
 	prepfin_conc_loop_ = concurrent;
 }
 
+/** Set CPU affinity.
+ * Restrict the thread to the given CPU cores. If the thread has not been
+ * started, yet, the affinity is applied when it starts, otherwise it is
+ * applied immediately. Failures are not fatal, check scheduling_error().
+ * CPU affinity is only supported on Linux.
+ * @param cpus indices of the CPU cores the thread may run on, empty to
+ * keep the inherited affinity
+ */
+void
+Thread::set_cpu_affinity(const std::vector<unsigned int> &cpus)
+{
+	cpu_affinity_ = cpus;
+	if (started_ && tid_ != 0) {
+		sched_error_ = apply_scheduling(thread_id_, tid_);
+	}
+}
+
+/** Get CPU affinity.
+ * @return CPU cores the thread has been restricted to, empty if unrestricted
+ */
+std::vector<unsigned int>
+Thread::cpu_affinity() const
+{
+	return cpu_affinity_;
+}
+
+/** Set scheduling policy and priority.
+ * If the thread has not been started, yet, the policy is applied when it
+ * starts, otherwise it is applied immediately. Failures, e.g. due to
+ * missing privileges for real-time policies, are not fatal, check
+ * scheduling_error().
+ * @param policy scheduling policy
+ * @param priority for real-time policies the static priority (1 to 99),
+ * for time-sharing policies the nice value (-20 to 19), ignored otherwise
+ */
+void
+Thread::set_scheduling(SchedulingPolicy policy, int priority)
+{
+	sched_policy_   = policy;
+	sched_priority_ = priority;
+	if (started_ && tid_ != 0) {
+		sched_error_ = apply_scheduling(thread_id_, tid_);
+	}
+}
+
+/** Get scheduling policy.
+ * @return scheduling policy set with set_scheduling()
+ */
+Thread::SchedulingPolicy
+Thread::scheduling_policy() const
+{
+	return sched_policy_;
+}
+
+/** Get scheduling priority.
+ * @return priority set with set_scheduling()
+ */
+int
+Thread::scheduling_priority() const
+{
+	return sched_priority_;
+}
+
+/** Get error of applying affinity and scheduling.
+ * @return 0 if CPU affinity and scheduling policy have been applied
+ * successfully or nothing had to be applied, the error number of the
+ * last failure otherwise
+ */
+int
+Thread::scheduling_error() const
+{
+	return sched_error_;
+}
+
+/** Apply CPU affinity and scheduling policy.
+ * @param thread_id ID of the thread to apply to
+ * @param tid kernel thread ID for setting the nice value, 0 for the
+ * calling thread
+ * @return 0 on success, error number of the last failure otherwise
+ */
+int
+Thread::apply_scheduling(pthread_t thread_id, pid_t tid)
+{
+	int err = 0;
+
+#ifdef __linux__
+	if (!cpu_affinity_.empty()) {
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		for (unsigned int cpu : cpu_affinity_) {
+			if (cpu < CPU_SETSIZE)
+				CPU_SET(cpu, &cpuset);
+		}
+		int rv = pthread_setaffinity_np(thread_id, sizeof(cpuset), &cpuset);
+		if (rv != 0)
+			err = rv;
+	}
+#endif
+
+	if (sched_policy_ != SCHED_POLICY_DEFAULT) {
+		int  policy   = SCHED_OTHER;
+		bool realtime = false;
+		switch (sched_policy_) {
+#ifdef SCHED_BATCH
+		case SCHED_POLICY_BATCH: policy = SCHED_BATCH; break;
+#endif
+#ifdef SCHED_IDLE
+		case SCHED_POLICY_IDLE: policy = SCHED_IDLE; break;
+#endif
+		case SCHED_POLICY_FIFO:
+			policy   = SCHED_FIFO;
+			realtime = true;
+			break;
+		case SCHED_POLICY_RR:
+			policy   = SCHED_RR;
+			realtime = true;
+			break;
+		default: break;
+		}
+
+		struct sched_param param;
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = realtime ? sched_priority_ : 0;
+		int rv               = pthread_setschedparam(thread_id, policy, &param);
+		if (rv != 0)
+			err = rv;
+
+#ifdef __linux__
+		// on Linux the nice value is a per-thread attribute
+		if (!realtime && sched_policy_ != SCHED_POLICY_IDLE
+		    && setpriority(PRIO_PROCESS, tid, sched_priority_) != 0) {
+			err = errno;
+		}
+#endif
+	}
+
+	return err;
+}
+
 /** Set wakeup coalescing.
  * The standard behavior of multiple calls to wakeup() (before the thread actually
  * got woken up, for instance because a loop iteration was still running) is to
@@ -935,17 +1089,25 @@ Thread::run()
 		if (!finalize_prepared) {
 			loop_done_ = false;
 
+			bool skip = false;
 			loop_listeners_->lock();
 			for (LockList<ThreadLoopListener *>::iterator it = loop_listeners_->begin();
 			     it != loop_listeners_->end();
 			     it++) {
 				(*it)->pre_loop(this);
 			}
+			for (LockList<ThreadLoopListener *>::iterator it = loop_listeners_->begin();
+			     it != loop_listeners_->end();
+			     it++) {
+				skip = (*it)->skip_loop(this) || skip;
+			}
 			loop_listeners_->unlock();
 
-			loop_mutex->lock();
-			loop();
-			loop_mutex->unlock();
+			if (!skip) {
+				loop_mutex->lock();
+				loop();
+				loop_mutex->unlock();
+			}
 
 			loop_listeners_->lock();
 			for (LockList<ThreadLoopListener *>::reverse_iterator it = loop_listeners_->rbegin();
@@ -1058,6 +1220,68 @@ Thread::wait_loop_done()
 	loop_done_mutex_->unlock();
 }
 
+/** Execute one loop iteration in the calling thread.
+ * This runs the loop listeners and loop() of this thread just like run()
+ * does, but in the context of the calling thread. It is meant for executors
+ * which run the loops of many threads on a small number of worker threads,
+ * while the threads themselves wait for a wakeup that never comes. The
+ * thread must therefore be in wait-for-wakeup mode and must not be woken up
+ * otherwise. During loop() current_thread() returns this thread. The loop
+ * is skipped if finalization has been prepared.
+ * Note that cancellation points and exit() in loop() affect the calling
+ * thread, threads relying on these must not be executed this way.
+ */
+void
+Thread::execute_loop()
+{
+	if (finalize_prepared)
+		return;
+
+	loopinterrupt_antistarve_mutex->stopby();
+
+	loop_done_mutex_->lock();
+	loop_done_ = false;
+	loop_done_mutex_->unlock();
+
+	Thread *caller = current_thread_noexc();
+	set_tsd_thread_instance(this);
+
+	bool skip = false;
+	loop_listeners_->lock();
+	for (LockList<ThreadLoopListener *>::iterator it = loop_listeners_->begin();
+	     it != loop_listeners_->end();
+	     it++) {
+		(*it)->pre_loop(this);
+	}
+	for (LockList<ThreadLoopListener *>::iterator it = loop_listeners_->begin();
+	     it != loop_listeners_->end();
+	     it++) {
+		skip = (*it)->skip_loop(this) || skip;
+	}
+	loop_listeners_->unlock();
+
+	if (!skip) {
+		loop_mutex->lock();
+		loop();
+		loop_mutex->unlock();
+	}
+
+	loop_listeners_->lock();
+	for (LockList<ThreadLoopListener *>::reverse_iterator it = loop_listeners_->rbegin();
+	     it != loop_listeners_->rend();
+	     it++) {
+		(*it)->post_loop(this);
+	}
+	loop_listeners_->unlock();
+
+	set_tsd_thread_instance(caller);
+
+	loop_done_mutex_->lock();
+	loop_done_ = true;
+	loop_done_mutex_->unlock();
+	loop_done_waitcond_->wake_all();
+}
+
 /** Code to execute in the thread.
  * Implement this method to hold the code you want to be executed continously.
  * If you do not implement this method, the default is that the thread will exit.
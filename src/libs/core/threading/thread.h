@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #define forever while (1)
 
@@ -66,6 +67,19 @@ public:
 		CANCEL_DISABLED /**< thread cannot be cancelled */
 	} CancelState;
 
+	/** Scheduling policy.
+   * Policies map to the respective POSIX/Linux scheduling classes. Real-time
+   * policies usually require privileges (CAP_SYS_NICE or an rtprio limit).
+   */
+	typedef enum {
+		SCHED_POLICY_DEFAULT, /**< keep inherited policy (default) */
+		SCHED_POLICY_OTHER,   /**< default time-sharing, priority is nice value */
+		SCHED_POLICY_BATCH,   /**< best-effort batch processing, priority is nice value */
+		SCHED_POLICY_IDLE,    /**< only run if the CPU would be idle otherwise */
+		SCHED_POLICY_FIFO,    /**< real-time first-in first-out, priority 1 to 99 */
+		SCHED_POLICY_RR       /**< real-time round-robin, priority 1 to 99 */
+	} SchedulingPolicy;
+
 	static const unsigned int FLAG_BAD;
 
 	virtual ~Thread();
@@ -88,6 +102,7 @@ public:
 	void wakeup(Barrier *barrier);
 
 	void wait_loop_done();
+	void execute_loop();
 
 	OpMode    opmode() const;
 	pthread_t thread_id() const;
@@ -102,6 +117,13 @@ public:
 		return name_;
 	}
 
+	void                      set_cpu_affinity(const std::vector<unsigned int> &cpus);
+	std::vector<unsigned int> cpu_affinity() const;
+	void             set_scheduling(SchedulingPolicy policy, int priority = 0);
+	SchedulingPolicy scheduling_policy() const;
+	int              scheduling_priority() const;
+	int              scheduling_error() const;
+
 	void set_flags(uint32_t flags);
 	void set_flag(uint32_t flag);
 	void unset_flag(uint32_t flag);
@@ -160,6 +182,7 @@ private:
 	void         __constructor(const char *name, OpMode op_mode);
 	void         notify_of_startup();
 	void         lock_sleep_mutex();
+	int          apply_scheduling(pthread_t thread_id, pid_t tid);
 
 	static void init_thread_key();
 	static void set_tsd_thread_instance(Thread *t);
@@ -194,6 +217,12 @@ private:
 
 	uint32_t flags_;
 
+	std::vector<unsigned int> cpu_affinity_;
+	SchedulingPolicy          sched_policy_;
+	int                       sched_priority_;
+	int                       sched_error_;
+	pid_t                     tid_;
+
 	LockList<ThreadNotificationListener *> *notification_listeners_;
 
 	LockList<ThreadLoopListener *> *loop_listeners_;
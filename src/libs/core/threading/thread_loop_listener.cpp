@@ -28,7 +28,9 @@ namespace fawkes {
 /** @class ThreadLoopListener <core/threading/thread_loop_listener.h>
  * Thread loop listener interface.
  * A thread loop listener can be added to a thread to define pre and post loop
- * tasks, which are executed before and after every loop.
+ * tasks, which are executed before and after every loop. A listener may
+ * also request that loop() is skipped for an iteration, the pre and post
+ * loop tasks are run nonetheless.
  *
  * @author Till Hofmann
  */
@@ -58,4 +60,17 @@ ThreadLoopListener::post_loop(Thread *thread)
 {
 }
 
+/** Check if loop() should be skipped.
+ * This function is called by the thread every time after all pre loop
+ * functions have been called. If any loop listener returns true, loop() is
+ * not called in this iteration, while post_loop() still is.
+ * @param thread thread this loop listener belongs to
+ * @return true to skip loop() in this iteration, false by default
+ */
+bool
+ThreadLoopListener::skip_loop(Thread *thread)
+{
+	return false;
+}
+
 } // end namespace fawkes
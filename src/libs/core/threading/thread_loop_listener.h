@@ -35,6 +35,7 @@ public:
 
 	virtual void pre_loop(Thread *thread);
 	virtual void post_loop(Thread *thread);
+	virtual bool skip_loop(Thread *thread);
 };
 
 } // end namespace fawkes
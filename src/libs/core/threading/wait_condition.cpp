@@ -24,8 +24,10 @@
 #include <core/exception.h>
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_data.h>
+#include <core/threading/spin_wait.h>
 #include <core/threading/wait_condition.h>
 
+#include <atomic>
 #include <cerrno>
 #include <pthread.h>
 #if defined(__MACH__) && defined(__APPLE__)
@@ -38,7 +40,17 @@ namespace fawkes {
 class WaitConditionData
 {
 public:
+	WaitConditionData() : spinning(false), generation(0), spinners(0)
+	{
+	}
+
 	pthread_cond_t cond;
+	LockProfile *  profile = NULL;
+
+	bool                      spinning;
+	std::atomic<unsigned int> generation;
+	std::atomic<unsigned int> spinners;
+	SpinWait                  spin_wait;
 };
 
 void
@@ -47,6 +59,20 @@ cleanup_mutex(void *arg)
 	Mutex *mutex = (Mutex *)arg;
 	mutex->unlock();
 }
+
+static int
+cond_wait(WaitConditionData *d, MutexData *m, const struct timespec *abstime)
+{
+	// the mutex is released while waiting, do not count it as held
+	m->hold_end();
+	uint64_t start = (d->profile && LockProfiler::enabled()) ? LockProfiler::now_nsec() : 0;
+	int      err   = abstime ? pthread_cond_timedwait(&d->cond, &m->mutex, abstime)
+	                         : pthread_cond_wait(&d->cond, &m->mutex);
+	m->hold_begin();
+	if (start != 0)
+		d->profile->count_wait(LockProfiler::now_nsec() - start);
+	return err;
+}
 /// @endcond
 
 /** @class WaitCondition <core/threading/wait_condition.h>
@@ -92,6 +118,10 @@ cleanup_mutex(void *arg)
  * external mutexes you get all the freedom, but also have the duty to ensure
  * proper locking from the outside! This applies to wait and wake methods.
  *
+ * Waiting threads can optionally busy-wait for a bounded time before they
+ * block, see set_spinning(). As for any wait condition, waiting threads
+ * must re-check their condition after being woken up.
+ *
  * @ingroup Threading
  * @ingroup FCL
  * @see Mutex
@@ -138,15 +168,19 @@ WaitCondition::~WaitCondition()
 void
 WaitCondition::wait()
 {
+	if (cond_data_->spinning && spin_for_wakeup()) {
+		return;
+	}
+
 	int err;
 	if (own_mutex_) {
 		mutex_->lock();
 		pthread_cleanup_push(cleanup_mutex, mutex_);
-		err = pthread_cond_wait(&(cond_data_->cond), &(mutex_->mutex_data->mutex));
+		err = cond_wait(cond_data_, mutex_->mutex_data, NULL);
 		mutex_->unlock();
 		pthread_cleanup_pop(0);
 	} else {
-		err = pthread_cond_wait(&(cond_data_->cond), &(mutex_->mutex_data->mutex));
+		err = cond_wait(cond_data_, mutex_->mutex_data, NULL);
 	}
 	if (err != 0) {
 		throw Exception(err, "Waiting for wait condition failed");
@@ -168,17 +202,21 @@ WaitCondition::wait()
 bool
 WaitCondition::abstimed_wait(long int sec, long int nanosec)
 {
+	if (cond_data_->spinning && spin_for_wakeup()) {
+		return true;
+	}
+
 	int             err = 0;
 	struct timespec ts  = {sec, nanosec};
 
 	if (own_mutex_) {
 		mutex_->lock();
 		pthread_cleanup_push(cleanup_mutex, mutex_);
-		err = pthread_cond_timedwait(&(cond_data_->cond), &(mutex_->mutex_data->mutex), &ts);
+		err = cond_wait(cond_data_, mutex_->mutex_data, &ts);
 		mutex_->unlock();
 		pthread_cleanup_pop(0);
 	} else {
-		err = pthread_cond_timedwait(&(cond_data_->cond), &(mutex_->mutex_data->mutex), &ts);
+		err = cond_wait(cond_data_, mutex_->mutex_data, &ts);
 	}
 
 	if (err == ETIMEDOUT) {
@@ -209,6 +247,10 @@ WaitCondition::reltimed_wait(unsigned int sec, unsigned int nanosec)
 		wait();
 		return true;
 	} else {
+		if (cond_data_->spinning && spin_for_wakeup()) {
+			return true;
+		}
+
 		struct timespec now;
 #if defined(__MACH__) && defined(__APPLE__)
 		struct timeval nowt;
@@ -236,11 +278,11 @@ WaitCondition::reltimed_wait(unsigned int sec, unsigned int nanosec)
 		if (own_mutex_) {
 			mutex_->lock();
 			pthread_cleanup_push(cleanup_mutex, mutex_);
-			err = pthread_cond_timedwait(&(cond_data_->cond), &(mutex_->mutex_data->mutex), &ts);
+			err = cond_wait(cond_data_, mutex_->mutex_data, &ts);
 			mutex_->unlock();
 			pthread_cleanup_pop(0);
 		} else {
-			err = pthread_cond_timedwait(&(cond_data_->cond), &(mutex_->mutex_data->mutex), &ts);
+			err = cond_wait(cond_data_, mutex_->mutex_data, &ts);
 		}
 
 		if (err == ETIMEDOUT) {
@@ -266,6 +308,9 @@ WaitCondition::reltimed_wait(unsigned int sec, unsigned int nanosec)
 void
 WaitCondition::wake_one()
 {
+	if (cond_data_->spinning && cond_data_->spinners.load() > 0) {
+		cond_data_->generation.fetch_add(1);
+	}
 	if (own_mutex_) { // it's our internal mutex, lock!
 		mutex_->lock();
 		pthread_cond_signal(&(cond_data_->cond));
@@ -286,6 +331,9 @@ WaitCondition::wake_one()
 void
 WaitCondition::wake_all()
 {
+	if (cond_data_->spinning) {
+		cond_data_->generation.fetch_add(1);
+	}
 	if (own_mutex_) { // it's our internal mutex, lock!
 		mutex_->lock();
 		pthread_cond_broadcast(&(cond_data_->cond));
@@ -295,4 +343,55 @@ WaitCondition::wake_all()
 	}
 }
 
+/** Enable or disable spinning.
+ * If enabled, waiting threads first busy-wait for a bounded time for a
+ * wakeup before they block, if spinning has been enabled globally with
+ * SpinWait::set_max_spin_time(). This reduces the wakeup latency for
+ * wait conditions which are typically signaled within microseconds, at
+ * the cost of CPU time. During spinning, an external mutex is unlocked.
+ * Must be set before the wait condition is used by multiple threads.
+ * @param spinning true to enable spinning, false to disable
+ */
+void
+WaitCondition::set_spinning(bool spinning)
+{
+	cond_data_->spinning = spinning;
+}
+
+/** Set name for profiling.
+ * Named wait conditions record the number of waits and the time spent
+ * waiting while the LockProfiler is enabled. Wait conditions with the
+ * same name share one profile. Waits satisfied by spinning are not
+ * recorded.
+ * @param name name of the wait condition, NULL to disable profiling
+ */
+void
+WaitCondition::set_name(const char *name)
+{
+	cond_data_->profile = name ? LockProfiler::profile(name) : NULL;
+}
+
+/** Spin for a wakeup.
+ * An external mutex must be locked and is locked again on return.
+ * @return true if woken up while spinning, false if the caller must block
+ */
+bool
+WaitCondition::spin_for_wakeup()
+{
+	if (SpinWait::max_spin_time() == 0) {
+		return false;
+	}
+
+	WaitConditionData *d   = cond_data_;
+	unsigned int       gen = d->generation.load();
+	d->spinners.fetch_add(1);
+	if (!own_mutex_)
+		mutex_->unlock();
+	d->spin_wait.spin([d, gen] { return d->generation.load() != gen; });
+	if (!own_mutex_)
+		mutex_->lock();
+	d->spinners.fetch_sub(1);
+	return (d->generation.load() != gen);
+}
+
 } // end namespace fawkes
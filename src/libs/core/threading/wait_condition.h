@@ -46,7 +46,12 @@ public:
 	void wake_one();
 	void wake_all();
 
+	void set_spinning(bool spinning);
+	void set_name(const char *name);
+
 private:
+	bool spin_for_wakeup();
+
 	WaitConditionData *cond_data_;
 	Mutex *            mutex_;
 	bool               own_mutex_;
@@ -0,0 +1,190 @@
+
+/***************************************************************************
+ *  mpmc_ring_buffer.h - Lock-free multi-producer multi-consumer ring buffer
+ *
+ *  Created: Wed Oct 14 19:27:32 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_UTILS_MPMC_RING_BUFFER_H_
+#define _CORE_UTILS_MPMC_RING_BUFFER_H_
+
+#include <core/exception.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace fawkes {
+
+/** @class MpmcRingBuffer <core/utils/mpmc_ring_buffer.h>
+ * Lock-free bounded multi-producer multi-consumer ring buffer.
+ * Any number of threads may push and pop elements concurrently without
+ * locking. Each slot carries a sequence number which tells producers and
+ * consumers whether the slot is free or filled for their turn, hence a
+ * push or pop only needs a single compare-and-swap on the shared index.
+ * Head and tail index are kept on separate cache lines to avoid false
+ * sharing between producers and consumers. The capacity is rounded up to
+ * the next power of two. Pushing to a full buffer fails rather than
+ * growing the buffer, it is up to the caller to handle that. Elements
+ * pushed by one thread are popped in the order they were pushed.
+ *
+ * @ingroup FCL
+ * @author agent
+ */
+template <typename Type>
+class MpmcRingBuffer
+{
+public:
+	/** The size_type of the buffer */
+	typedef std::size_t size_type;
+
+	/** Constructor.
+   * @param capacity minimum number of elements the buffer can hold
+   */
+	MpmcRingBuffer(size_type capacity)
+	{
+		if (capacity == 0) {
+			throw Exception("Ring buffer capacity must be at least 1");
+		}
+		size_type c = 2;
+		while (c < capacity)
+			c <<= 1;
+		mask_  = c - 1;
+		cells_ = new Cell[c];
+		for (size_type i = 0; i < c; ++i) {
+			cells_[i].seq.store(i, std::memory_order_relaxed);
+		}
+		head_.store(0, std::memory_order_relaxed);
+		tail_.store(0, std::memory_order_relaxed);
+	}
+
+	/** Destructor. */
+	~MpmcRingBuffer()
+	{
+		delete[] cells_;
+	}
+
+	/** Push element.
+   * @param x element to push
+   * @return true if the element was pushed, false if the buffer is full
+   */
+	bool
+	try_push(const Type &x)
+	{
+		size_type t = tail_.load(std::memory_order_relaxed);
+		Cell *    c;
+		for (;;) {
+			c                    = &cells_[t & mask_];
+			const size_type s    = c->seq.load(std::memory_order_acquire);
+			const long int  diff = (long int)s - (long int)t;
+			if (diff == 0) {
+				if (tail_.compare_exchange_weak(t, t + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return false;
+			} else {
+				t = tail_.load(std::memory_order_relaxed);
+			}
+		}
+		c->data = x;
+		c->seq.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Pop element.
+   * @param x upon return contains the popped element
+   * @return true if an element was popped, false if the buffer is empty
+   */
+	bool
+	try_pop(Type &x)
+	{
+		size_type h = head_.load(std::memory_order_relaxed);
+		Cell *    c;
+		for (;;) {
+			c                    = &cells_[h & mask_];
+			const size_type s    = c->seq.load(std::memory_order_acquire);
+			const long int  diff = (long int)s - (long int)(h + 1);
+			if (diff == 0) {
+				if (head_.compare_exchange_weak(h, h + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return false;
+			} else {
+				h = head_.load(std::memory_order_relaxed);
+			}
+		}
+		x = c->data;
+		c->seq.store(h + mask_ + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Check if buffer is empty.
+   * The result is only a snapshot if other threads are active.
+   * @return true if the buffer is empty
+   */
+	bool
+	empty() const
+	{
+		return size() == 0;
+	}
+
+	/** Get number of elements in buffer.
+   * The result is only a snapshot if other threads are active.
+   * @return number of elements, including those currently being pushed
+   */
+	size_type
+	size() const
+	{
+		const size_type h = head_.load(std::memory_order_acquire);
+		const size_type t = tail_.load(std::memory_order_acquire);
+		return (t > h) ? t - h : 0;
+	}
+
+	/** Get capacity.
+   * @return maximum number of elements the buffer can hold
+   */
+	size_type
+	capacity() const
+	{
+		return mask_ + 1;
+	}
+
+private:
+	MpmcRingBuffer(const MpmcRingBuffer<Type> &) = delete;
+	MpmcRingBuffer<Type> &operator=(const MpmcRingBuffer<Type> &) = delete;
+
+	static const size_type cache_line_size_ = 64;
+
+	/// @cond INTERNALS
+	struct Cell
+	{
+		std::atomic<size_type> seq;
+		Type                   data;
+	};
+	/// @endcond
+
+	Cell *    cells_;
+	size_type mask_;
+	alignas(cache_line_size_) std::atomic<size_type> head_;
+	alignas(cache_line_size_) std::atomic<size_type> tail_;
+	char padding_[cache_line_size_ - sizeof(std::atomic<size_type>)];
+};
+
+} // end namespace fawkes
+
+#endif
@@ -22,7 +22,6 @@
  */
 
 #include <core/exceptions/software.h>
-#include <core/threading/mutex.h>
 #include <core/utils/refcount.h>
 
 #include <unistd.h>
@@ -39,6 +38,9 @@ namespace fawkes {
  * class. This is the recommended way. If you want to use reference counting with
  * a class that you cannot or do not want to modify you can use the RefCounter
  * template class to accomplish the desired task.
+ *
+ * The reference count is an atomic counter embedded into the instance,
+ * referencing and unreferencing hence neither allocates nor locks.
  * @see RefCounter
  *
  * @ingroup FCL
@@ -46,16 +48,13 @@ namespace fawkes {
  */
 
 /** Constructor. */
-RefCount::RefCount()
+RefCount::RefCount() : refc(1)
 {
-	ref_mutex = new Mutex();
-	refc      = 1;
 }
 
 /** Destructor. */
 RefCount::~RefCount()
 {
-	delete ref_mutex;
 }
 
 /** Increment reference count.
@@ -66,12 +65,12 @@ RefCount::~RefCount()
 void
 RefCount::ref()
 {
-	ref_mutex->lock();
-	if (refc == 0) {
-		throw DestructionInProgressException("Tried to reference that is currently being deleted");
-	}
-	++refc;
-	ref_mutex->unlock();
+	unsigned int c = refc.load(std::memory_order_relaxed);
+	do {
+		if (c == 0) {
+			throw DestructionInProgressException("Tried to reference that is currently being deleted");
+		}
+	} while (!refc.compare_exchange_weak(c, c + 1, std::memory_order_relaxed));
 }
 
 /** Decrement reference count and conditionally delete this instance.
@@ -94,18 +93,43 @@ RefCount::ref()
 void
 RefCount::unref()
 {
-	ref_mutex->lock();
-	if (refc == 0) {
-		throw DestructionInProgressException("Tried to reference that is currently being deleted");
-	}
-	if (refc > 0)
-		--refc;
-	if (refc == 0) {
+	unsigned int c = refc.load(std::memory_order_relaxed);
+	do {
+		if (c == 0) {
+			throw DestructionInProgressException("Tried to reference that is currently being deleted");
+		}
+	} while (!refc.compare_exchange_weak(c, c - 1, std::memory_order_acq_rel));
+
+	if (c == 1) {
+		// give sub-classes a chance to keep the instance for re-use, the
+		// count is reset before as the instance may be taken right away
+		refc.store(1, std::memory_order_relaxed);
+		if (recycle()) {
+			return;
+		}
+		// not recycled, restore the count of zero for the destruction
+		refc.store(0, std::memory_order_relaxed);
 		// commit suicide
 		delete this;
-		return;
 	}
-	ref_mutex->unlock();
+}
+
+/** Recycle instance instead of deleting it.
+ * This is called by unref() when the last reference has been released,
+ * right before the instance would be deleted. Sub-classes can override
+ * this method to store the instance for later re-use, e.g. in a pool.
+ * If true is returned the instance is not deleted and its reference
+ * count has been reset to one, which is then owned by whoever took the
+ * instance. The instance must not be referenced or unreferenced from
+ * within this method.
+ * @return true if the instance has been recycled and must not be deleted,
+ * false to delete the instance. The default implementation always returns
+ * false.
+ */
+bool
+RefCount::recycle()
+{
+	return false;
 }
 
 /** Get reference count for this instance.
@@ -119,7 +143,7 @@ RefCount::unref()
 unsigned int
 RefCount::refcount()
 {
-	return refc;
+	return refc.load(std::memory_order_relaxed);
 }
 
 } // end namespace fawkes
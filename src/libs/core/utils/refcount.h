@@ -24,9 +24,9 @@
 #ifndef _CORE_UTILS_REFCOUNT_H_
 #define _CORE_UTILS_REFCOUNT_H_
 
-namespace fawkes {
+#include <atomic>
 
-class Mutex;
+namespace fawkes {
 
 class RefCount
 {
@@ -38,9 +38,11 @@ public:
 	void         unref();
 	unsigned int refcount();
 
+protected:
+	virtual bool recycle();
+
 private:
-	unsigned int refc;
-	Mutex *      ref_mutex;
+	std::atomic<unsigned int> refc;
 };
 
 } // end namespace fawkes
@@ -28,6 +28,8 @@
 
 #include <core/threading/mutex.h>
 
+#include <atomic>
+
 namespace fawkes {
 
 /** RefPtr<> is a reference-counting shared smartpointer.
@@ -41,7 +43,9 @@ namespace fawkes {
  * to delete the object explicitly, or know when a method expects you to delete 
  * the object that it returns.
  *
- * Note that RefPtr is thread-safe.
+ * Note that RefPtr is thread-safe. The reference count is a single atomic
+ * counter which is allocated along with the first RefPtr for an object,
+ * copying and destroying RefPtrs hence does not lock.
  *
  * @ingroup FCL
  */
@@ -168,7 +172,7 @@ public:
 
 		if (
 		  cpp_object) //Check whether dynamic_cast<> succeeded so we don't pass a null object with a used refcount:
-			return RefPtr<T_CppObject>(cpp_object, src.refcount_ptr(), src.refmutex_ptr());
+			return RefPtr<T_CppObject>(cpp_object, src.refcount_ptr());
 		else
 			return RefPtr<T_CppObject>();
 	}
@@ -188,7 +192,7 @@ public:
 	{
 		T_CppObject *const cpp_object = static_cast<T_CppObject *>(src.operator->());
 
-		return RefPtr<T_CppObject>(cpp_object, src.refcount_ptr(), src.refmutex_ptr());
+		return RefPtr<T_CppObject>(cpp_object, src.refcount_ptr());
 	}
 
 	/** Cast to non-const.
@@ -206,15 +210,14 @@ public:
 	{
 		T_CppObject *const cpp_object = const_cast<T_CppObject *>(src.operator->());
 
-		return RefPtr<T_CppObject>(cpp_object, src.refcount_ptr(), src.refmutex_ptr());
+		return RefPtr<T_CppObject>(cpp_object, src.refcount_ptr());
 	}
 
 	/** For use only in the internal implementation of sharedptr.
    * @param cpp_object C++ object to wrap
    * @param refcount reference count
-   * @param refmutex reference count mutex
    */
-	explicit inline RefPtr(T_CppObject *cpp_object, int *refcount, Mutex *refmutex);
+	explicit inline RefPtr(T_CppObject *cpp_object, std::atomic<int> *refcount);
 
 	/** For use only in the internal implementation of sharedptr.
    * Get reference count pointer.
@@ -222,7 +225,7 @@ public:
    * reference count with this pointer.
    * @return pointer to refcount integer
    */
-	inline int *
+	inline std::atomic<int> *
 	refcount_ptr() const
 	{
 		return ref_count_;
@@ -234,23 +237,12 @@ public:
 	inline int
 	use_count() const
 	{
-		return *ref_count_;
-	}
-
-	/** For use only in the internal implementation of sharedptr.
-   * Get reference mutex.
-   * @return pointer to refcount mutex
-   */
-	inline Mutex *
-	refmutex_ptr() const
-	{
-		return ref_mutex_;
+		return ref_count_ ? ref_count_->load(std::memory_order_relaxed) : 0;
 	}
 
 private:
-	T_CppObject *  cpp_object_;
-	mutable int *  ref_count_;
-	mutable Mutex *ref_mutex_;
+	T_CppObject *             cpp_object_;
+	mutable std::atomic<int> *ref_count_;
 };
 
 // RefPtr<>::operator->() comes first here since it's used by other methods.
@@ -271,65 +263,50 @@ RefPtr<T_CppObject>::operator*() const
 }
 
 template <class T_CppObject>
-inline RefPtr<T_CppObject>::RefPtr() : cpp_object_(0), ref_count_(0), ref_mutex_(0)
+inline RefPtr<T_CppObject>::RefPtr() : cpp_object_(0), ref_count_(0)
 {
 }
 
 template <class T_CppObject>
 inline RefPtr<T_CppObject>::~RefPtr()
 {
-	if (ref_count_ && ref_mutex_) {
-		ref_mutex_->lock();
-
-		--(*ref_count_);
-
-		if (*ref_count_ == 0) {
-			if (cpp_object_) {
-				delete cpp_object_;
-				cpp_object_ = 0;
-			}
-
-			delete ref_count_;
-			delete ref_mutex_;
-			ref_count_ = 0;
-			ref_mutex_ = 0;
-		} else {
-			ref_mutex_->unlock();
+	// acq_rel ordering makes all writes of other owners visible before deletion
+	if (ref_count_ && ref_count_->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		if (cpp_object_) {
+			delete cpp_object_;
+			cpp_object_ = 0;
 		}
+
+		delete ref_count_;
+		ref_count_ = 0;
 	}
 }
 
 template <class T_CppObject>
 inline RefPtr<T_CppObject>::RefPtr(T_CppObject *cpp_object)
-: cpp_object_(cpp_object), ref_count_(0), ref_mutex_(0)
+: cpp_object_(cpp_object), ref_count_(0)
 {
 	if (cpp_object) {
-		ref_count_  = new int;
-		ref_mutex_  = new Mutex();
-		*ref_count_ = 1; //This will be decremented in the destructor.
+		ref_count_ = new std::atomic<int>(1); //This will be decremented in the destructor.
 	}
 }
 
 //Used by cast_*() implementations:
 template <class T_CppObject>
-inline RefPtr<T_CppObject>::RefPtr(T_CppObject *cpp_object, int *refcount, Mutex *refmutex)
-: cpp_object_(cpp_object), ref_count_(refcount), ref_mutex_(refmutex)
+inline RefPtr<T_CppObject>::RefPtr(T_CppObject *cpp_object, std::atomic<int> *refcount)
+: cpp_object_(cpp_object), ref_count_(refcount)
 {
-	if (cpp_object_ && ref_count_ && ref_mutex_) {
-		ref_mutex_->lock();
-		++(*ref_count_);
-		ref_mutex_->unlock();
+	if (cpp_object_ && ref_count_) {
+		ref_count_->fetch_add(1, std::memory_order_relaxed);
 	}
 }
 
 template <class T_CppObject>
 inline RefPtr<T_CppObject>::RefPtr(const RefPtr<T_CppObject> &src)
-: cpp_object_(src.cpp_object_), ref_count_(src.ref_count_), ref_mutex_(src.ref_mutex_)
+: cpp_object_(src.cpp_object_), ref_count_(src.ref_count_)
 {
-	if (cpp_object_ && ref_count_ && ref_mutex_) {
-		ref_mutex_->lock();
-		++(*ref_count_);
-		ref_mutex_->unlock();
+	if (cpp_object_ && ref_count_) {
+		ref_count_->fetch_add(1, std::memory_order_relaxed);
 	}
 }
 
@@ -343,13 +320,10 @@ inline RefPtr<T_CppObject>::RefPtr(const RefPtr<T_CastFrom> &src)
   // to add a get_underlying() for this, but that would encourage incorrect
   // use, so we use the less well-known operator->() accessor:
   cpp_object_(src.operator->()),
-  ref_count_(src.refcount_ptr()),
-  ref_mutex_(src.refmutex_ptr())
+  ref_count_(src.refcount_ptr())
 {
-	if (cpp_object_ && ref_count_ && ref_mutex_) {
-		ref_mutex_->lock();
-		++(*ref_count_);
-		ref_mutex_->unlock();
+	if (cpp_object_ && ref_count_) {
+		ref_count_->fetch_add(1, std::memory_order_relaxed);
 	}
 }
 
@@ -358,16 +332,13 @@ inline void
 RefPtr<T_CppObject>::swap(RefPtr<T_CppObject> &other)
 {
 	T_CppObject *const temp       = cpp_object_;
-	int *              temp_count = ref_count_;
-	Mutex *            temp_mutex = ref_mutex_;
+	std::atomic<int> * temp_count = ref_count_;
 
 	cpp_object_ = other.cpp_object_;
 	ref_count_  = other.ref_count_;
-	ref_mutex_  = other.ref_mutex_;
 
 	other.cpp_object_ = temp;
 	other.ref_count_  = temp_count;
-	other.ref_mutex_  = temp_mutex;
 }
 
 template <class T_CppObject>
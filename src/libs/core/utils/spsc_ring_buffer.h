@@ -0,0 +1,157 @@
+
+/***************************************************************************
+ *  spsc_ring_buffer.h - Lock-free single-producer single-consumer ring buffer
+ *
+ *  Created: Wed Oct 14 19:27:32 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_UTILS_SPSC_RING_BUFFER_H_
+#define _CORE_UTILS_SPSC_RING_BUFFER_H_
+
+#include <core/exception.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace fawkes {
+
+/** @class SpscRingBuffer <core/utils/spsc_ring_buffer.h>
+ * Lock-free bounded single-producer single-consumer ring buffer.
+ * Exactly one thread may push elements and exactly one (possibly other)
+ * thread may pop them at the same time, without any locking. Head and tail
+ * index are kept on separate cache lines to avoid false sharing between
+ * producer and consumer. The capacity is rounded up to the next power of
+ * two. Pushing to a full buffer fails rather than growing the buffer, it is
+ * up to the caller to handle that, e.g. by dropping the element or applying
+ * back pressure. Use MpmcRingBuffer if there are multiple producers or
+ * consumers.
+ *
+ * @ingroup FCL
+ * @author agent
+ */
+template <typename Type>
+class SpscRingBuffer
+{
+public:
+	/** The size_type of the buffer */
+	typedef std::size_t size_type;
+
+	/** Constructor.
+   * @param capacity minimum number of elements the buffer can hold
+   */
+	SpscRingBuffer(size_type capacity)
+	{
+		if (capacity == 0) {
+			throw Exception("Ring buffer capacity must be at least 1");
+		}
+		size_type c = 1;
+		while (c < capacity)
+			c <<= 1;
+		mask_ = c - 1;
+		data_ = new Type[c];
+		head_.store(0, std::memory_order_relaxed);
+		tail_.store(0, std::memory_order_relaxed);
+	}
+
+	/** Destructor. */
+	~SpscRingBuffer()
+	{
+		delete[] data_;
+	}
+
+	/** Push element.
+   * May only be called by the producer.
+   * @param x element to push
+   * @return true if the element was pushed, false if the buffer is full
+   */
+	bool
+	try_push(const Type &x)
+	{
+		const size_type t = tail_.load(std::memory_order_relaxed);
+		if (t - head_.load(std::memory_order_acquire) > mask_) {
+			return false;
+		}
+		data_[t & mask_] = x;
+		tail_.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Pop element.
+   * May only be called by the consumer.
+   * @param x upon return contains the popped element
+   * @return true if an element was popped, false if the buffer is empty
+   */
+	bool
+	try_pop(Type &x)
+	{
+		const size_type h = head_.load(std::memory_order_relaxed);
+		if (h == tail_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		x = data_[h & mask_];
+		head_.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Check if buffer is empty.
+   * The result is only a snapshot if the other side is active.
+   * @return true if the buffer is empty
+   */
+	bool
+	empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+	/** Get number of elements in buffer.
+   * The result is only a snapshot if the other side is active.
+   * @return number of elements
+   */
+	size_type
+	size() const
+	{
+		const size_type h = head_.load(std::memory_order_acquire);
+		return tail_.load(std::memory_order_acquire) - h;
+	}
+
+	/** Get capacity.
+   * @return maximum number of elements the buffer can hold
+   */
+	size_type
+	capacity() const
+	{
+		return mask_ + 1;
+	}
+
+private:
+	SpscRingBuffer(const SpscRingBuffer<Type> &) = delete;
+	SpscRingBuffer<Type> &operator=(const SpscRingBuffer<Type> &) = delete;
+
+	static const size_type cache_line_size_ = 64;
+
+	Type *    data_;
+	size_type mask_;
+	alignas(cache_line_size_) std::atomic<size_type> head_;
+	alignas(cache_line_size_) std::atomic<size_type> tail_;
+	char padding_[cache_line_size_ - sizeof(std::atomic<size_type>)];
+};
+
+} // end namespace fawkes
+
+#endif
@@ -24,6 +24,7 @@
 #include <core/exceptions/software.h>
 
 #include <algorithm>
+#include <cctype>
 
 namespace fawkes {
 
@@ -31,8 +32,20 @@ namespace fawkes {
  * A manager for execution time providers.
  * It stores prioritized providers, where the provider with the maximal
  * priority is considered first.
+ *
+ * Planners often ask for the same estimates many times. Estimates retrieved
+ * through get_execution_time() or estimate_many() are therefore cached by
+ * the normalized skill string for a configurable time. An estimate is
+ * recomputed early if its estimator invalidated its estimates, e.g., because
+ * the navgraph changed, and estimators which do not allow caching are always
+ * asked.
  */
 
+/** Constructor. */
+ExecutionTimeEstimatorManager::ExecutionTimeEstimatorManager() : cache_ttl_(0.)
+{
+}
+
 /** Get the execution time provider for the given skill string.
  * @param skill_string The string to get the execution time for
  * @return a pointer to the provider
@@ -40,14 +53,131 @@ namespace fawkes {
  */
 std::shared_ptr<ExecutionTimeEstimator>
 ExecutionTimeEstimatorManager::get_provider(const std::string &skill_string) const
+{
+	return find_provider(ExecutionTimeEstimator::Skill(skill_string));
+}
+
+/** Get the execution time provider for the given skill.
+ * @param skill The skill to get the execution time for
+ * @return a pointer to the provider
+ * @throws IllegalArgumentException if no provider for the given skill exists
+ */
+std::shared_ptr<ExecutionTimeEstimator>
+ExecutionTimeEstimatorManager::find_provider(const ExecutionTimeEstimator::Skill &skill) const
 {
 	for (const auto &pair : execution_time_estimators_) {
 		const auto &provider = pair.second;
-		if (provider->can_execute(skill_string)) {
+		if (provider->can_execute(skill)) {
 			return provider;
 		}
 	}
-	throw IllegalArgumentException("No provider found for %s", skill_string.c_str());
+	throw IllegalArgumentException("No provider found for %s", skill.skill_name.c_str());
+}
+
+/** Get the estimated execution time for the given skill string.
+ * The estimate is taken from the cache if possible.
+ * @param skill_string The string to get the execution time for
+ * @return the execution time in seconds
+ * @throws IllegalArgumentException if no provider for the given skill exists
+ */
+float
+ExecutionTimeEstimatorManager::get_execution_time(const std::string &skill_string)
+{
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+	return cached_execution_time(skill_string);
+}
+
+/** Get the estimated execution times for a number of skill strings.
+ * This is equivalent to calling get_execution_time() for each of them, but
+ * locks the cache only once.
+ * @param skill_strings The strings to get the execution times for
+ * @return the execution times in seconds in the order of @p skill_strings
+ * @throws IllegalArgumentException if no provider for one of the skills exists
+ */
+std::vector<float>
+ExecutionTimeEstimatorManager::estimate_many(const std::vector<std::string> &skill_strings)
+{
+	std::vector<float>          rv;
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+	rv.reserve(skill_strings.size());
+	for (const auto &skill_string : skill_strings) {
+		rv.push_back(cached_execution_time(skill_string));
+	}
+	return rv;
+}
+
+/** Set the time estimates are cached.
+ * @param ttl_sec time in seconds after which an estimate is recomputed,
+ * caching is disabled if zero
+ */
+void
+ExecutionTimeEstimatorManager::set_cache_ttl(float ttl_sec)
+{
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+	cache_ttl_ = ttl_sec;
+	cache_.clear();
+}
+
+/** Remove all cached estimates. */
+void
+ExecutionTimeEstimatorManager::invalidate_cache()
+{
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+	cache_.clear();
+}
+
+/** Get the execution time from the cache or compute it.
+ * The cache mutex must be locked.
+ * @param skill_string The string to get the execution time for
+ * @return the execution time in seconds
+ */
+float
+ExecutionTimeEstimatorManager::cached_execution_time(const std::string &skill_string)
+{
+	const std::string key = normalize_skill_string(skill_string);
+	const auto        now = std::chrono::steady_clock::now();
+	auto              c   = cache_.find(key);
+	if (c != cache_.end()) {
+		if (now < c->second.expires && c->second.version == c->second.provider->estimates_version()) {
+			return c->second.exec_time;
+		}
+		cache_.erase(c);
+	}
+
+	const ExecutionTimeEstimator::Skill skill(skill_string);
+	auto                                provider  = find_provider(skill);
+	unsigned int                        version   = provider->estimates_version();
+	float                               exec_time = provider->get_execution_time(skill);
+	if (cache_ttl_ > 0. && provider->can_cache_estimates()) {
+		auto ttl    = std::chrono::duration<float>(cache_ttl_);
+		cache_[key] = {provider,
+		               version,
+		               exec_time,
+		               now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(ttl)};
+	}
+	return exec_time;
+}
+
+/** Normalize a skill string for use as cache key.
+ * Removes newlines and whitespace in front of arguments, which the skill
+ * parser ignores.
+ * @param skill_string skill string to normalize
+ * @return normalized skill string
+ */
+std::string
+ExecutionTimeEstimatorManager::normalize_skill_string(const std::string &skill_string)
+{
+	std::string rv;
+	rv.reserve(skill_string.size());
+	bool skip_space = false;
+	for (char c : skill_string) {
+		if (c == '\n' || (skip_space && isspace((unsigned char)c))) {
+			continue;
+		}
+		rv.push_back(c);
+		skip_space = (c == '{' || c == ',');
+	}
+	return rv;
 }
 
 /** Add an execution time provider.
@@ -59,6 +189,7 @@ ExecutionTimeEstimatorManager::register_provider(std::shared_ptr<ExecutionTimeEs
                                                  int                                     priority)
 {
 	execution_time_estimators_.insert(std::make_pair(priority, provider));
+	invalidate_cache();
 }
 
 /** Remove an execution time estimate provider.
@@ -78,6 +209,7 @@ ExecutionTimeEstimatorManager::unregister_provider(std::shared_ptr<ExecutionTime
 		}
 	}
 #endif
+	invalidate_cache();
 }
 
 /** @class ExecutionTimeEstimatorsAspect
@@ -23,21 +23,51 @@
 #include <aspect/aspect.h>
 #include <execution_time_estimator/execution_time_estimator.h>
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace fawkes {
 
 class ExecutionTimeEstimatorManager
 {
 public:
+	ExecutionTimeEstimatorManager();
 	std::shared_ptr<ExecutionTimeEstimator> get_provider(const std::string &skill_string) const;
 	void register_provider(std::shared_ptr<ExecutionTimeEstimator> provider, int priority = 0);
 	void unregister_provider(std::shared_ptr<ExecutionTimeEstimator> provider);
 
+	float              get_execution_time(const std::string &skill_string);
+	std::vector<float> estimate_many(const std::vector<std::string> &skill_strings);
+	void               set_cache_ttl(float ttl_sec);
+	void               invalidate_cache();
+
 private:
+	/// @cond INTERNALS
+	struct CachedEstimate
+	{
+		std::shared_ptr<ExecutionTimeEstimator> provider;
+		unsigned int                            version;
+		float                                   exec_time;
+		std::chrono::steady_clock::time_point   expires;
+	};
+	/// @endcond
+
+	std::shared_ptr<ExecutionTimeEstimator>
+	find_provider(const ExecutionTimeEstimator::Skill &skill) const;
+	float              cached_execution_time(const std::string &skill_string);
+	static std::string normalize_skill_string(const std::string &skill_string);
+
 	std::multimap<int, std::shared_ptr<ExecutionTimeEstimator>, std::greater<int>>
 	  execution_time_estimators_;
+
+	std::mutex                                      cache_mutex_;
+	float                                           cache_ttl_;
+	std::unordered_map<std::string, CachedEstimate> cache_;
 };
 
 class ExecutionTimeEstimatorsAspect : public virtual Aspect
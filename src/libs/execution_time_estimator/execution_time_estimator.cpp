@@ -61,6 +61,24 @@ using Skill = ExecutionTimeEstimator::Skill;
  * @param skill The skill object to check.
  * @return true if this estimator can give an execution time estimate for the given skill.
  *
+ * @fn bool ExecutionTimeEstimator::can_cache_estimates() const
+ * Check if estimates of this estimator may be cached.
+ * By default, estimates are assumed to only depend on the skill string and
+ * the estimator's state, which calls invalidate_estimates() when it changes.
+ * Override and return false if estimates must be recomputed on every call,
+ * e.g., because they are sampled.
+ * @return true if estimates may be cached
+ *
+ * @fn unsigned int ExecutionTimeEstimator::estimates_version() const
+ * Get the version of the estimates.
+ * The version is incremented by invalidate_estimates(), cached estimates with
+ * a different version are outdated.
+ * @return current version of the estimates
+ *
+ * @fn void ExecutionTimeEstimator::invalidate_estimates()
+ * Invalidate all cached estimates of this estimator.
+ * Call this whenever the state the estimates are computed from changes.
+ *
  * @fn std::pair<SkillerInterface::SkillStatusEnum, std::string> ExecutionTimeEstimator::execute(const Skill &skill) const
  * Let the estimator know that we are executing this skill, so it can apply
  * possible side effects.
@@ -112,11 +130,30 @@ ExecutionTimeEstimator::ExecutionTimeEstimator(Configuration *      config,
   cfg_prefix_(cfg_prefix),
   speed_(config->get_float_or_default((cfg_prefix_ + "speed").c_str(), 1)),
   whitelist_(get_skills_from_config(cfg_prefix_ + "whitelist")),
-  blacklist_(get_skills_from_config(cfg_prefix_ + "blacklist"))
+  blacklist_(get_skills_from_config(cfg_prefix_ + "blacklist")),
+  estimates_version_(0)
 {
 	assert(speed_ > 0);
 }
 
+bool
+ExecutionTimeEstimator::can_cache_estimates() const
+{
+	return true;
+}
+
+unsigned int
+ExecutionTimeEstimator::estimates_version() const
+{
+	return estimates_version_.load(std::memory_order_acquire);
+}
+
+void
+ExecutionTimeEstimator::invalidate_estimates()
+{
+	estimates_version_.fetch_add(1, std::memory_order_acq_rel);
+}
+
 bool
 ExecutionTimeEstimator::can_execute(const Skill &skill)
 {
@@ -23,6 +23,7 @@
 #include <config/config.h>
 #include <interfaces/SkillerInterface.h>
 
+#include <atomic>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -75,6 +76,8 @@ public:
 
 	virtual float get_execution_time(const Skill &skill) = 0;
 	virtual bool  can_execute(const Skill &skill);
+	virtual bool  can_cache_estimates() const;
+	unsigned int  estimates_version() const;
 	virtual std::pair<SkillerInterface::SkillStatusEnum, std::string>
 	execute(const Skill &skill)
 	{
@@ -86,6 +89,8 @@ protected:
 
 	virtual bool can_provide_exec_time(const Skill &skill) const = 0;
 
+	void invalidate_estimates();
+
 	template <typename T>
 	T get_property(const Property<T> &property) const;
 	/** Config to obtain common configurables */
@@ -102,6 +107,7 @@ protected:
 	const std::map<std::string, Skill> blacklist_;
 
 private:
+	std::atomic<unsigned int> estimates_version_;
 };
 
 } // namespace fawkes
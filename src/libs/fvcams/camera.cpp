@@ -139,4 +139,24 @@ Camera::capture_time()
 	throw fawkes::NotImplementedException("Timestamping not supported by this camera");
 }
 
+/** Capture images directly into a shared memory image buffer.
+ * The camera writes images into the slots of the given buffer instead of
+ * its own buffers, buffer() then points into one of the slots. The camera
+ * only fills slots which are neither current nor referenced by readers,
+ * see SharedMemoryImageBuffer. After capture() the caller publishes the
+ * slot holding the image with SharedMemoryImageBuffer::publish_slot()
+ * before calling dispose_buffer(). The buffer must have the colorspace
+ * and size of the camera images.
+ * @param shm shared memory image buffer to capture into, NULL to return to
+ * the camera's own buffers. The buffer must remain valid until the camera
+ * is closed or another buffer is set.
+ * @throw NotImplementedException thrown if the camera cannot capture into
+ * shared memory
+ */
+void
+Camera::set_capture_buffer(SharedMemoryImageBuffer *shm)
+{
+	throw fawkes::NotImplementedException("Capturing to shared memory not supported by this camera");
+}
+
 } // end namespace firevision
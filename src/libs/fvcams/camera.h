@@ -29,6 +29,8 @@
 
 namespace firevision {
 
+class SharedMemoryImageBuffer;
+
 class Camera
 {
 public:
@@ -53,6 +55,7 @@ public:
 	virtual unsigned int  pixel_height() = 0;
 	virtual colorspace_t  colorspace()   = 0;
 	virtual fawkes::Time *capture_time();
+	virtual void          set_capture_buffer(SharedMemoryImageBuffer *shm);
 
 	// virtual unsigned int     number_of_images()                      = 0;
 	virtual void set_image_number(unsigned int n) = 0;
@@ -47,6 +47,12 @@ namespace firevision {
  * locking times so that the interference between the two processes is
  * minimal.
  *
+ * If the shared memory buffer holds a ring of images, capture() without
+ * deep-copy takes a reference on the latest image, which is released by
+ * dispose_buffer() or the next capture(). The writer does not touch the
+ * image in the meantime, hence no copy is needed to read it
+ * asynchronously.
+ *
  * @author Tim Niemueller
  */
 
@@ -104,6 +110,7 @@ SharedMemoryCamera::~SharedMemoryCamera()
 	if (deep_buffer_ != NULL) {
 		free(deep_buffer_);
 	}
+	dispose_buffer();
 	delete shm_buffer_;
 	delete capture_time_;
 }
@@ -113,10 +120,17 @@ SharedMemoryCamera::init()
 {
 	deep_buffer_  = NULL;
 	capture_time_ = NULL;
+	slot_         = -1;
+	sequence_     = 0;
 	try {
 		shm_buffer_ = new SharedMemoryImageBuffer(image_id_);
+		if (shm_buffer_->num_slots() > 1) {
+			// slot references are counted in the segment itself
+			delete shm_buffer_;
+			shm_buffer_ = new SharedMemoryImageBuffer(image_id_, /* read-only */ false);
+		}
 		if (deep_copy_) {
-			deep_buffer_ = (unsigned char *)malloc(shm_buffer_->data_size());
+			deep_buffer_ = (unsigned char *)malloc(buffer_size());
 			if (!deep_buffer_) {
 				throw OutOfMemoryException("SharedMemoryCamera: Cannot allocate deep buffer");
 			}
@@ -154,11 +168,36 @@ SharedMemoryCamera::capture()
 {
 	if (deep_copy_) {
 		shm_buffer_->lock_for_read();
-		memcpy(deep_buffer_, shm_buffer_->buffer(), shm_buffer_->data_size());
+		memcpy(deep_buffer_, shm_buffer_->buffer(), buffer_size());
 		capture_time_->set_time(shm_buffer_->capture_time());
+		sequence_ = shm_buffer_->sequence();
 		shm_buffer_->unlock();
-	} else
+	} else if (shm_buffer_->num_slots() > 1) {
+		// hold the current image until dispose_buffer(), the writer
+		// meanwhile fills other slots
+		dispose_buffer();
+		shm_buffer_->lock_for_read();
+		slot_ = shm_buffer_->ref_slot();
+		shm_buffer_->unlock();
+		capture_time_->set_time(shm_buffer_->slot_capture_time(slot_));
+		sequence_ = shm_buffer_->slot_sequence(slot_);
+	} else {
 		capture_time_->set_time(shm_buffer_->capture_time());
+		sequence_ = shm_buffer_->sequence();
+	}
+}
+
+/** Get sequence number of the captured image.
+ * The writer numbers the images it publishes consecutively, compare the
+ * numbers of two captured images to detect whether an image is new or
+ * images have been skipped. Only valid after capture().
+ * @return sequence number of the image, 0 if the writer did not publish
+ * an image, yet
+ */
+uint64_t
+SharedMemoryCamera::sequence() const
+{
+	return sequence_;
 }
 
 unsigned char *
@@ -166,6 +205,8 @@ SharedMemoryCamera::buffer()
 {
 	if (deep_copy_) {
 		return deep_buffer_;
+	} else if (slot_ >= 0) {
+		return shm_buffer_->slot_buffer(slot_);
 	} else {
 		return shm_buffer_->buffer();
 	}
@@ -187,6 +228,10 @@ SharedMemoryCamera::close()
 void
 SharedMemoryCamera::dispose_buffer()
 {
+	if (slot_ >= 0) {
+		shm_buffer_->unref_slot(slot_);
+		slot_ = -1;
+	}
 }
 
 unsigned int
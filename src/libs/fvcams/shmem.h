@@ -61,6 +61,7 @@ public:
 	virtual void set_image_number(unsigned int n);
 
 	SharedMemoryImageBuffer *shared_memory_image_buffer();
+	uint64_t                 sequence() const;
 
 	virtual void lock_for_read();
 	virtual bool try_lock_for_read();
@@ -76,6 +77,8 @@ private:
 	char *image_id_;
 
 	SharedMemoryImageBuffer *shm_buffer_;
+	int                      slot_;
+	uint64_t                 sequence_;
 
 	unsigned char *deep_buffer_;
 
@@ -24,6 +24,7 @@
 #include <core/exception.h>
 #include <core/exceptions/software.h>
 #include <fvcams/v4l2.h>
+#include <fvutils/ipc/shm_image.h>
 #include <fvutils/system/camargp.h>
 #include <linux/version.h>
 #include <logging/liblogger.h>
@@ -35,6 +36,7 @@
 #include <cstring>
 #include <fcntl.h>
 #include <iostream>
+#include <unistd.h>
 
 using fawkes::Exception;
 using fawkes::LibLogger;
@@ -71,7 +73,11 @@ public:
 /** @class V4L2Camera <fvcams/v4l2.h>
  * Video4Linux 2 camera access implementation.
  *
- * @todo UPTR method
+ * With the user pointer method the driver writes images into buffers
+ * provided by the camera. These can also be the slots of a shared memory
+ * image buffer, see set_capture_buffer(). Images then land directly in the
+ * memory from which vision threads read them.
+ *
  * @todo v4l2_pix_format.field
  * @author Tobias Kellner
  * @author Tim Niemueller
@@ -100,6 +106,7 @@ V4L2Camera::V4L2Camera(const char *device_name)
 	_read_method                    = MMAP;
 	memset(_format, 0, 5);
 	_frame_buffers = NULL;
+	_shm_buffer    = NULL;
 	_capture_time  = NULL;
 	_device_name   = strdup(device_name);
 	_data          = new V4L2CameraData();
@@ -145,6 +152,7 @@ V4L2Camera::V4L2Camera(const CameraArgumentParser *cap)
 	_width = _height = _bytes_per_line = _buffers_length = 0;
 	_current_buffer                                      = -1;
 	_frame_buffers                                       = NULL;
+	_shm_buffer                                          = NULL;
 	_capture_time                                        = NULL;
 	_standard                                            = NULL;
 	_input                                               = NULL;
@@ -379,6 +387,7 @@ V4L2Camera::V4L2Camera(const char *device_name, int dev)
 	_read_method                    = UPTR;
 	memset(_format, 0, 5);
 	_frame_buffers = NULL;
+	_shm_buffer    = NULL;
 	_capture_time  = NULL;
 	_device_name   = strdup(device_name);
 	_standard      = NULL;
@@ -494,10 +503,14 @@ V4L2Camera::select_read_method()
 			buf.type        = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 			buf.memory      = V4L2_MEMORY_MMAP;
 		} else if (_read_method == UPTR) {
-			_buffers_length = 0;
-			buf.count       = 0;
-			buf.type        = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-			buf.memory      = V4L2_MEMORY_USERPTR;
+			if (_shm_buffer) {
+				_buffers_length = _shm_buffer->num_slots();
+			} else {
+				_buffers_length = MMAP_NUM_BUFFERS;
+			}
+			buf.count  = _buffers_length;
+			buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+			buf.memory = V4L2_MEMORY_USERPTR;
 		}
 
 		if (v4l2_ioctl(_dev, VIDIOC_REQBUFS, &buf)) {
@@ -510,6 +523,13 @@ V4L2Camera::select_read_method()
 				close();
 				throw Exception("V4L2Cam: Not enough memory for the buffers");
 			}
+		} else if (buf.count < _buffers_length) {
+			// the driver may limit the number of user pointer buffers
+			if (buf.count == 0) {
+				close();
+				throw Exception("V4L2Cam: Driver does not accept user pointer buffers");
+			}
+			_buffers_length = buf.count;
 		}
 	} else {
 		/* Read IO */
@@ -521,11 +541,7 @@ V4L2Camera::select_read_method()
 
 	case MMAP: LibLogger::log_debug("V4L2Cam", "Using memory mapping method"); break;
 
-	case UPTR:
-		LibLogger::log_debug("V4L2Cam", "Using user pointer method");
-		//TODO
-		throw Exception("V4L2Cam: user pointer method not supported yet");
-		break;
+	case UPTR: LibLogger::log_debug("V4L2Cam", "Using user pointer method"); break;
 	}
 }
 
@@ -985,10 +1001,172 @@ V4L2Camera::create_buffer()
 		break;
 	}
 
+	case UPTR: {
+		long int page = sysconf(_SC_PAGESIZE);
+		for (unsigned int i = 0; i < _buffers_length; ++i) {
+			_frame_buffers[i].queued = false;
+			if (_shm_buffer) {
+				_frame_buffers[i].size   = colorspace_buffer_size(_colorspace, _width, _height);
+				_frame_buffers[i].buffer = _shm_buffer->slot_buffer(i);
+			} else {
+				void *buffer           = NULL;
+				_frame_buffers[i].size = _bytes_per_line * _height;
+				if (posix_memalign(&buffer, page, _frame_buffers[i].size) != 0) {
+					_frame_buffers[i].buffer = NULL;
+					close();
+					throw Exception("V4L2Cam: Out of memory");
+				}
+				_frame_buffers[i].buffer = static_cast<unsigned char *>(buffer);
+			}
+		}
+		break;
+	}
+	}
+}
+
+/**
+ * Enqueue all user pointer buffers which are free.
+ * Buffers in shared memory are free if they are neither the current
+ * slot nor referenced by any reader.
+ * @return number of buffers enqueued for capturing
+ */
+unsigned int
+V4L2Camera::enqueue_free_buffers()
+{
+	unsigned int num_queued = 0;
+	for (unsigned int i = 0; i < _buffers_length; ++i) {
+		if (!_frame_buffers[i].queued && ((int)i != _current_buffer)
+		    && (!_shm_buffer
+		        || ((i != _shm_buffer->current_slot()) && (_shm_buffer->slot_refcount(i) == 0)))) {
+			v4l2_buffer buffer;
+			memset(&buffer, 0, sizeof(buffer));
+			buffer.type      = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+			buffer.memory    = V4L2_MEMORY_USERPTR;
+			buffer.index     = i;
+			buffer.m.userptr = (unsigned long)_frame_buffers[i].buffer;
+			buffer.length    = _frame_buffers[i].size;
+
+			if (v4l2_ioctl(_dev, VIDIOC_QBUF, &buffer)) {
+				int errno_save = errno;
+				close();
+				throw Exception(errno_save, "V4L2Cam: Enqueuing buffer failed");
+			}
+			_frame_buffers[i].queued = true;
+		}
+		if (_frame_buffers[i].queued) {
+			++num_queued;
+		}
+	}
+	return num_queued;
+}
+
+/**
+ * Release image buffers.
+ * Postconditions:
+ *  - _frame_buffers is NULL
+ *  - no buffers are requested from the driver
+ */
+void
+V4L2Camera::free_buffers()
+{
+	if (!_frame_buffers)
+		return;
+
+	switch (_read_method) {
+	case READ: {
+		free(_frame_buffers[0].buffer);
+		break;
+	}
+
+	case MMAP: {
+		for (unsigned int i = 0; i < _buffers_length; ++i) {
+			v4l2_munmap(_frame_buffers[i].buffer, _frame_buffers[i].size);
+		}
+		break;
+	}
+
 	case UPTR:
-		/* not supported yet */
+		if (!_shm_buffer) {
+			for (unsigned int i = 0; i < _buffers_length; ++i) {
+				free(_frame_buffers[i].buffer);
+			}
+		}
 		break;
 	}
+
+	if (_opened && (_read_method != READ)) {
+		// release the driver's buffers, required before changing the method
+		v4l2_requestbuffers buf;
+		memset(&buf, 0, sizeof(buf));
+		buf.count  = 0;
+		buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		buf.memory = (_read_method == MMAP) ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
+		v4l2_ioctl(_dev, VIDIOC_REQBUFS, &buf);
+	}
+
+	delete[] _frame_buffers;
+	_frame_buffers  = NULL;
+	_current_buffer = -1;
+}
+
+/** Capture images directly into a shared memory image buffer.
+ * Switches the camera to the user pointer method with one driver buffer
+ * per slot of the shared memory buffer. The driver only gets slots which
+ * are neither current nor referenced by a reader. The camera is restarted
+ * if it is running.
+ * @param shm shared memory image buffer with at least two slots and the
+ * camera's colorspace and image size, NULL to capture into the camera's
+ * own buffers again
+ */
+void
+V4L2Camera::set_capture_buffer(SharedMemoryImageBuffer *shm)
+{
+	if (!_opened)
+		throw Exception("V4L2Cam: Camera not opened");
+
+	if (shm) {
+		if (!(_data->caps.capabilities & V4L2_CAP_STREAMING)) {
+			throw NotImplementedException("V4L2Cam: Capturing to shared memory requires streaming IO");
+		}
+		if ((shm->colorspace() != _colorspace) || (shm->width() != _width)
+		    || (shm->height() != _height)) {
+			throw Exception("V4L2Cam: Shared memory buffer does not match camera image");
+		}
+		if ((size_t)_bytes_per_line * _height > colorspace_buffer_size(_colorspace, _width, _height)) {
+			throw NotImplementedException("V4L2Cam: Cannot capture padded lines to shared memory");
+		}
+		if (shm->num_slots() < 2) {
+			throw Exception("V4L2Cam: Shared memory buffer needs at least two slots");
+		}
+	}
+
+	bool started = _started;
+	if (_started)
+		stop();
+	free_buffers();
+
+	bool supported = true;
+	if (shm) {
+		// requesting no buffers fails if the method is not supported
+		v4l2_requestbuffers buf;
+		memset(&buf, 0, sizeof(buf));
+		buf.count  = 0;
+		buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		buf.memory = V4L2_MEMORY_USERPTR;
+		supported  = (v4l2_ioctl(_dev, VIDIOC_REQBUFS, &buf) == 0);
+	}
+
+	_shm_buffer  = supported ? shm : NULL;
+	_read_method = _shm_buffer ? UPTR : MMAP;
+	select_read_method();
+	create_buffer();
+
+	if (started)
+		start();
+
+	if (!supported) {
+		throw NotImplementedException("V4L2Cam: Driver does not support user pointers");
+	}
 }
 
 /**
@@ -1035,28 +1213,7 @@ V4L2Camera::close()
 	if (_started)
 		stop();
 
-	if (_frame_buffers) {
-		switch (_read_method) {
-		case READ: {
-			free(_frame_buffers[0].buffer);
-			break;
-		}
-
-		case MMAP: {
-			for (unsigned int i = 0; i < _buffers_length; ++i) {
-				v4l2_munmap(_frame_buffers[i].buffer, _frame_buffers[i].size);
-			}
-			break;
-		}
-
-		case UPTR:
-			/* not supported yet */
-			break;
-		}
-		delete[] _frame_buffers;
-		_frame_buffers  = NULL;
-		_current_buffer = -1;
-	}
+	free_buffers();
 
 	if (_opened) {
 		v4l2_close(_dev);
@@ -1108,10 +1265,21 @@ V4L2Camera::start()
 		break;
 	}
 
-	case UPTR:
-		/* not supported yet */
+	case UPTR: {
+		_current_buffer = -1;
+		if (enqueue_free_buffers() == 0) {
+			close();
+			throw Exception("V4L2Cam: No free buffer to enqueue");
+		}
+
+		int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		if (v4l2_ioctl(_dev, VIDIOC_STREAMON, &type)) {
+			close();
+			throw Exception("V4L2Cam: Starting stream failed");
+		}
 		break;
 	}
+	}
 
 	//LibLogger::log_debug("V4L2Cam", "start() complete");
 	_started = true;
@@ -1137,6 +1305,10 @@ V4L2Camera::stop()
 		if (v4l2_ioctl(_dev, VIDIOC_STREAMOFF, &type)) {
 			throw Exception("V4L2Cam: Stopping stream failed");
 		}
+		// stopping the stream dequeues all buffers
+		for (unsigned int i = 0; i < _buffers_length; ++i) {
+			_frame_buffers[i].queued = false;
+		}
 		break;
 	}
 	}
@@ -1206,10 +1378,35 @@ V4L2Camera::capture()
 		break;
 	}
 
-	case UPTR:
-		/* not supported yet */
+	case UPTR: {
+		// return buffers released by readers since the last capture
+		if (enqueue_free_buffers() == 0) {
+			LibLogger::log_warn("V4L2Cam", "All buffers in use by readers, dropping frame");
+			_current_buffer = -1;
+			break;
+		}
+
+		v4l2_buffer buffer;
+		memset(&buffer, 0, sizeof(buffer));
+		buffer.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		buffer.memory = V4L2_MEMORY_USERPTR;
+
+		if (v4l2_ioctl(_dev, VIDIOC_DQBUF, &buffer)) {
+			close();
+			throw Exception("V4L2Cam: Dequeuing buffer failed");
+		}
+
+		_current_buffer                        = buffer.index;
+		_frame_buffers[_current_buffer].queued = false;
+
+		if (_capture_time) {
+			_capture_time->set_time(&buffer.timestamp);
+		} else {
+			_capture_time = new fawkes::Time(&buffer.timestamp);
+		}
 		break;
 	}
+	}
 }
 
 unsigned char *
@@ -1259,7 +1456,12 @@ V4L2Camera::dispose_buffer()
 	}
 
 	case UPTR:
-		/* not supported yet */
+		/* in shared memory the buffer may be published, only enqueue
+		 * buffers no reader is using */
+		_current_buffer = -1;
+		if (_started) {
+			enqueue_free_buffers();
+		}
 		break;
 	}
 
@@ -65,6 +65,7 @@ public:
 	virtual unsigned int  pixel_height();
 	virtual colorspace_t  colorspace();
 	virtual fawkes::Time *capture_time();
+	virtual void          set_capture_buffer(SharedMemoryImageBuffer *shm);
 
 	virtual void set_image_number(unsigned int n);
 
@@ -136,6 +137,9 @@ private:
 	virtual void create_buffer();
 	virtual void reset_cropping();
 
+	unsigned int enqueue_free_buffers();
+	void         free_buffers();
+
 protected:
 	char *_device_name; ///< Device name
 
@@ -156,6 +160,7 @@ private:
 	{
 		unsigned char *buffer; ///< buffer
 		unsigned int   size;   ///< buffer size
+		bool           queued; ///< enqueued in the driver (UPTR only)
 	};
 
 	struct ControlParameterInt
@@ -184,6 +189,8 @@ private:
 	int           _current_buffer; ///< Current Image buffer (-1 if not set)
 	fawkes::Time *_capture_time;   ///< Time when last picture was captured
 
+	SharedMemoryImageBuffer *_shm_buffer; ///< Shared memory buffer captured into
+
 	bool         _switch_u_v; ///< Switch U and V channels
 	unsigned int _fps;        ///< Capture FPS
 
@@ -140,10 +140,11 @@ MultiColorClassifier::classify()
 
 	ROI r;
 
-	scanline_model->reset();
-	while (!scanline_model->finished()) {
-		x = (*scanline_model)->x;
-		y = (*scanline_model)->y;
+	const std::vector<fawkes::upoint_t> &points = scanline_model->points();
+	const unsigned int                   margin = scanline_model->get_margin();
+	for (const fawkes::upoint_t &p : points) {
+		x = p.x;
+		y = p.y;
 
 		YUV422_PLANAR_YUV(_src, _width, _height, x, y, yp, up, vp);
 
@@ -156,7 +157,7 @@ MultiColorClassifier::classify()
 			// useful for anything else than quick testing
 
 			if (neighbourhood_min_match) {
-				num_what = consider_neighbourhood((*scanline_model)->x, (*scanline_model)->y, c);
+				num_what = consider_neighbourhood(x, y, c);
 			}
 			if (num_what >= neighbourhood_min_match) {
 				bool ok = false;
@@ -170,7 +171,7 @@ MultiColorClassifier::classify()
 				}
 				if (!ok) {
 					for (roi_it = rois[c].begin(); roi_it != rois[c].end(); ++roi_it) {
-						if ((*roi_it).neighbours(x, y, scanline_model->get_margin())) {
+						if ((*roi_it).neighbours(x, y, margin)) {
 							// ROI is neighbour of this point, extend region
 							(*roi_it).extend(x, y);
 							ok = true;
@@ -195,8 +196,8 @@ MultiColorClassifier::classify()
 					r.start.x = x;
 					r.start.y = y;
 
-					unsigned int to_x = (*scanline_model)->x + box_extent;
-					unsigned int to_y = (*scanline_model)->y + box_extent;
+					unsigned int to_x = x + box_extent;
+					unsigned int to_y = y + box_extent;
 					if (to_x > _width)
 						to_x = _width;
 					if (to_y > _height)
@@ -223,8 +224,6 @@ MultiColorClassifier::classify()
 				}
 			} // End if enough neighbours
 		}   // end if is orange
-
-		++(*scanline_model);
 	}
 
 	// Grow regions
@@ -243,7 +242,7 @@ MultiColorClassifier::classify()
 			++roi_it2;
 
 			while (roi_it2 != map_it->second.end()) {
-				if ((roi_it != roi_it2) && roi_it->neighbours(&(*roi_it2), scanline_model->get_margin())) {
+				if ((roi_it != roi_it2) && roi_it->neighbours(&(*roi_it2), margin)) {
 					*roi_it += *roi_it2;
 					map_it->second.erase(roi_it2);
 					roi_it2 = map_it->second.begin(); //restart
@@ -23,8 +23,10 @@
 #include <core/exceptions/software.h>
 #include <fvclassifiers/qualifiers.h>
 #include <fvutils/color/yuv.h>
+#include <fvutils/statistical/integral_image.h>
 
 #include <cstdlib>
+#include <vector>
 
 using fawkes::upoint_t;
 
@@ -40,11 +42,13 @@ namespace firevision {
  */
 Qualifier::Qualifier()
 {
-	buffer_     = 0;
-	width_      = 0;
-	height_     = 0;
-	size_       = 0;
-	colorspace_ = CS_UNKNOWN;
+	buffer_         = 0;
+	width_          = 0;
+	height_         = 0;
+	size_           = 0;
+	colorspace_     = CS_UNKNOWN;
+	integral_       = NULL;
+	integral_valid_ = false;
 }
 
 /** Constructor.
@@ -63,6 +67,8 @@ Qualifier::Qualifier(unsigned char *buffer,
 	if (!width || !height)
 		throw fawkes::IllegalArgumentException("Qualifier: width and height may not be 0!");
 
+	integral_       = NULL;
+	integral_valid_ = false;
 	set_buffer(buffer, width, height);
 	colorspace_ = colorspace;
 }
@@ -71,6 +77,58 @@ Qualifier::Qualifier(unsigned char *buffer,
  */
 Qualifier::~Qualifier()
 {
+	delete integral_;
+}
+
+/** Get values of a line.
+ * The default implementation calls get() for each pixel, sub-classes
+ * should override it with a version that avoids per-pixel calls.
+ * @param y line of interest
+ * @param values upon return contains the value of each pixel of the line,
+ * must have room for one value per pixel
+ */
+void
+Qualifier::get_line(unsigned int y, int *values)
+{
+	upoint_t pixel;
+	pixel.y = y;
+	for (pixel.x = 0; pixel.x < width_; ++pixel.x) {
+		values[pixel.x] = get(pixel);
+	}
+}
+
+/** Get sum of the values of a region.
+ * The first call after the buffer has been set computes a summed-area
+ * table of the qualifier values of the image. This and all further calls
+ * for the same image then take constant time, regardless of the size of
+ * the region.
+ * @param start upper left corner of the region
+ * @param width width of the region
+ * @param height height of the region
+ * @return sum of the values of all pixels in the region
+ */
+int64_t
+Qualifier::get_region_sum(upoint_t start, unsigned int width, unsigned int height)
+{
+	if (!integral_valid_) {
+		if (buffer_ == NULL) {
+			throw fawkes::NullPointerException("Qualifier: buffer not set");
+		}
+		if (integral_ == NULL) {
+			integral_ = new IntegralImage();
+		}
+		if ((integral_->width() != width_) || (integral_->height() != height_)) {
+			integral_->resize(width_, height_);
+		}
+		std::vector<int> values(width_);
+		for (unsigned int y = 0; y < height_; ++y) {
+			get_line(y, &values[0]);
+			integral_->set_line(y, &values[0]);
+		}
+		integral_valid_ = true;
+	}
+
+	return integral_->sum(start.x, start.y, width, height);
 }
 
 /** Get buffer.
@@ -90,7 +148,8 @@ Qualifier::get_buffer()
 void
 Qualifier::set_buffer(unsigned char *buffer, unsigned int width, unsigned int height)
 {
-	buffer_ = buffer;
+	buffer_         = buffer;
+	integral_valid_ = false;
 
 	if (width)
 		width_ = width;
@@ -117,7 +176,8 @@ Qualifier::get_colorspace()
 void
 Qualifier::set_colorspace(colorspace_t colorspace)
 {
-	colorspace_ = colorspace;
+	colorspace_     = colorspace;
+	integral_valid_ = false;
 }
 
 /** @class LumaQualifier qualifiers.h <apps/nao_loc/qualifiers.h>
@@ -162,6 +222,25 @@ LumaQualifier::get(upoint_t pixel)
 	return buffer_[pixel.y * width_ + pixel.x];
 }
 
+/** Get values of a line.
+ * @param y line of interest
+ * @param values upon return contains the value of each pixel of the line
+ */
+void
+LumaQualifier::get_line(unsigned int y, int *values)
+{
+	if (y >= height_)
+		throw fawkes::OutOfBoundsException("LumaQualifier: requested line is out of bounds!",
+		                                   y,
+		                                   0,
+		                                   height_);
+
+	const unsigned char *yp = buffer_ + y * width_;
+	for (unsigned int x = 0; x < width_; ++x) {
+		values[x] = yp[x];
+	}
+}
+
 /** @class SkyblueQualifier qualifiers.h <apps/nao_loc/qualifiers.h>
  * SkyblueQualifier for a single pixel.
  * Uses the value of the U/V-channels
@@ -211,6 +290,28 @@ SkyblueQualifier::get(upoint_t pixel)
 	return u + v;
 }
 
+/** Get values of a line.
+ * @param y line of interest
+ * @param values upon return contains the value of each pixel of the line
+ */
+void
+SkyblueQualifier::get_line(unsigned int y, int *values)
+{
+	if (y >= height_)
+		throw fawkes::OutOfBoundsException("SkyblueQualifier: requested line is out of bounds!",
+		                                   y,
+		                                   0,
+		                                   height_);
+
+	for (unsigned int x = 0; x < width_; ++x) {
+		unsigned int  u_addr = size_ + (y * width_ + x) / 2;
+		unsigned char u      = buffer_[u_addr];
+		unsigned char v      = 255 - buffer_[u_addr + size_ / 2];
+
+		values[x] = ((u < threshold_) || (v < threshold_)) ? 0 : u + v;
+	}
+}
+
 /** @class YellowQualifier qualifiers.h <apps/nao_loc/qualifiers.h>
  * YellowQualifier for a single pixel.
  * Uses the value of the U/V-channels
@@ -262,4 +363,28 @@ YellowQualifier::get(upoint_t pixel)
 	return (u + v);
 }
 
+/** Get values of a line.
+ * @param y line of interest
+ * @param values upon return contains the value of each pixel of the line
+ */
+void
+YellowQualifier::get_line(unsigned int y, int *values)
+{
+	if (y >= height_)
+		throw fawkes::OutOfBoundsException("YellowQualifier: requested line is out of bounds!",
+		                                   y,
+		                                   0,
+		                                   height_);
+
+	for (unsigned int x = 0; x < width_; ++x) {
+		unsigned int  y_addr = (y * width_ + x);
+		unsigned int  u_addr = size_ + y_addr / 2;
+		unsigned char luma   = buffer_[y_addr];
+		unsigned int  u      = (255 - buffer_[u_addr]) * luma;
+		unsigned int  v      = (255 - abs(127 - buffer_[u_addr + size_ / 2]) * 2) * luma;
+
+		values[x] = ((u <= threshold_) || (v <= threshold_)) ? 0 : (u + v);
+	}
+}
+
 } // end namespace firevision
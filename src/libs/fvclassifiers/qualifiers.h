@@ -25,8 +25,12 @@
 #include <fvutils/base/types.h>
 #include <fvutils/color/colorspaces.h>
 
+#include <stdint.h>
+
 namespace firevision {
 
+class IntegralImage;
+
 class Qualifier
 {
 public:
@@ -39,6 +43,9 @@ public:
    */
 	virtual int get(fawkes::upoint_t pixel) = 0;
 
+	virtual void get_line(unsigned int y, int *values);
+	int64_t      get_region_sum(fawkes::upoint_t start, unsigned int width, unsigned int height);
+
 	virtual unsigned char *get_buffer();
 	virtual void set_buffer(unsigned char *buffer, unsigned int width = 0, unsigned int height = 0);
 
@@ -64,6 +71,10 @@ protected:
 
 	/** Colorspace of the buffer */
 	colorspace_t colorspace_;
+
+private:
+	IntegralImage *integral_;
+	bool           integral_valid_;
 };
 
 class LumaQualifier : public Qualifier
@@ -76,7 +87,8 @@ public:
 	              colorspace_t   colorspace);
 	virtual ~LumaQualifier(){};
 
-	virtual int get(fawkes::upoint_t pixel);
+	virtual int  get(fawkes::upoint_t pixel);
+	virtual void get_line(unsigned int y, int *values);
 };
 
 class SkyblueQualifier : public Qualifier
@@ -89,7 +101,8 @@ public:
 	                 colorspace_t   colorspace);
 	virtual ~SkyblueQualifier(){};
 
-	virtual int get(fawkes::upoint_t pixel);
+	virtual int  get(fawkes::upoint_t pixel);
+	virtual void get_line(unsigned int y, int *values);
 
 private:
 	static const unsigned int threshold_ = 128;
@@ -105,7 +118,8 @@ public:
 	                colorspace_t   colorspace);
 	virtual ~YellowQualifier(){};
 
-	virtual int get(fawkes::upoint_t pixel);
+	virtual int  get(fawkes::upoint_t pixel);
+	virtual void get_line(unsigned int y, int *values);
 
 private:
 	static const unsigned int threshold_ = 100;
@@ -25,6 +25,7 @@
 #include <fvutils/color/threshold.h>
 #include <fvutils/color/yuv.h>
 
+#include <algorithm>
 #include <math.h>
 
 namespace firevision {
@@ -64,16 +65,31 @@ FilterColorThreshold::apply()
 	  YUV422_PLANAR_V_PLANE(dst, dst_roi->image_width, dst_roi->image_height)
 	  + ((dst_roi->start.y * dst_roi->line_step) / 2 + (dst_roi->start.x * dst_roi->pixel_step) / 2);
 
-	unsigned const char *p_line_src_y = p_src_y, *p_line_src_u = p_src_u, *p_line_src_v = p_src_v,
-	                    *p_line_dst_y = p_dst_y, *p_line_dst_u = p_dst_u, *p_line_dst_v = p_dst_v;
+	unsigned char *p_line_src_y = p_src_y, *p_line_src_u = p_src_u, *p_line_src_v = p_src_v,
+	              *p_line_dst_y = p_dst_y, *p_line_dst_u = p_dst_u, *p_line_dst_v = p_dst_v;
+
+	unsigned int width = std::min(src_roi[0]->width, dst_roi->width);
+	if (colors_.size() < width) {
+		colors_.resize(width);
+	}
 
 	for (h = 0; (h < src_roi[0]->height) && (h < dst_roi->height); ++h) {
-		for (w = 0; (w < src_roi[0]->width) && (w < dst_roi->width); w += 2) {
+		// classify the whole line at once, avoids a virtual call per pixel
+		color_model_->determine_line(p_line_src_y, p_line_src_u, p_line_src_v, width, &colors_[0]);
+
+		p_src_y = p_line_src_y;
+		p_src_u = p_line_src_u;
+		p_src_v = p_line_src_v;
+		p_dst_y = p_line_dst_y;
+		p_dst_u = p_line_dst_u;
+		p_dst_v = p_line_dst_v;
+
+		for (w = 0; w < width; w += 2) {
 			// just copy Y plane from src to dst
 			*p_dst_y++ = *p_src_y++;
 			*p_dst_y++ = *p_src_y++;
 
-			if (color_model_->determine(*p_src_y, *p_src_u, *p_src_v) != C_OTHER) {
+			if (colors_[w] != C_OTHER) {
 				*p_dst_u++ = *p_src_u;
 				*p_dst_v++ = *p_src_v;
 			} else {
@@ -88,10 +104,16 @@ FilterColorThreshold::apply()
 		p_line_src_u += src_roi[0]->line_step / 2;
 		p_line_src_v += src_roi[0]->line_step / 2;
 
-		p_line_dst_y += src_roi[0]->line_step;
-		p_line_dst_u += src_roi[0]->line_step / 2;
-		p_line_dst_v += src_roi[0]->line_step / 2;
+		p_line_dst_y += dst_roi->line_step;
+		p_line_dst_u += dst_roi->line_step / 2;
+		p_line_dst_v += dst_roi->line_step / 2;
 	}
 }
 
+int
+FilterColorThreshold::kernel_radius() const
+{
+	return 0;
+}
+
 } /* namespace firevision */
@@ -27,6 +27,8 @@
 #include <fvmodels/color/similarity.h>
 #include <fvutils/color/rgb.h>
 
+#include <vector>
+
 namespace firevision {
 
 /**
@@ -44,9 +46,11 @@ public:
 	~FilterColorThreshold();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 
 private:
 	ColorModelSimilarity *color_model_;
+	std::vector<color_t>  colors_;
 };
 
 } /* namespace firevision */
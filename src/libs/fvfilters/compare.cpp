@@ -139,4 +139,10 @@ FilterCompare::apply()
 	}
 }
 
+int
+FilterCompare::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
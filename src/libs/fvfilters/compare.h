@@ -34,6 +34,7 @@ public:
 	FilterCompare();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 
 	static const unsigned int BACKGROUND;
 	static const unsigned int FOREGROUND;
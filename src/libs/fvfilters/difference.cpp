@@ -137,4 +137,10 @@ FilterDifference::apply()
 	}
 }
 
+int
+FilterDifference::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
@@ -34,6 +34,7 @@ public:
 	FilterDifference();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
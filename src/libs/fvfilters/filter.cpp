@@ -138,7 +138,21 @@ Filter::set_orientation(orientation_t ori, unsigned int buffer_num)
 		throw OutOfBoundsException("Invalid buffer number", buffer_num, 0, _max_num_buffers);
 	}
 
-	this->ori[buffer_num] = ORI_HORIZONTAL;
+	this->ori[buffer_num] = ori;
+}
+
+/** Get the orientation the filter is applied in.
+ * @param buffer_num buffer to get the orientation for
+ * @return orientation
+ */
+orientation_t
+Filter::orientation(unsigned int buffer_num) const
+{
+	if (buffer_num >= _max_num_buffers) {
+		throw OutOfBoundsException("Invalid buffer number", buffer_num, 0, _max_num_buffers);
+	}
+
+	return ori[buffer_num];
 }
 
 /** Get filter name
@@ -150,6 +164,20 @@ Filter::name()
 	return _name;
 }
 
+/** Get kernel radius.
+ * The radius is the number of lines above and below a pixel that are
+ * read to compute its result. It is used to split a ROI into bands that
+ * can be filtered independently, see FilterTiler. Filters which process
+ * each pixel on its own return 0.
+ * @return kernel radius, -1 if the result of a pixel may depend on the
+ * whole ROI and the filter must not be split (default)
+ */
+int
+Filter::kernel_radius() const
+{
+	return -1;
+}
+
 /** This shrinks the regions as needed for a N x N matrix.
  * @param r ROI to shrink
  * @param n size of the matrix
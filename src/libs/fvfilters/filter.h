@@ -45,10 +45,13 @@ public:
 	virtual void set_dst_buffer(unsigned char *buf, ROI *roi);
 
 	virtual void        set_orientation(orientation_t ori, unsigned int buffer_num);
+	orientation_t       orientation(unsigned int buffer_num = 0) const;
 	virtual const char *name();
 
 	virtual void apply() = 0;
 
+	virtual int kernel_radius() const;
+
 	void shrink_region(ROI *r, unsigned int n);
 
 protected:
@@ -110,4 +110,10 @@ FilterGauss::apply()
 #endif
 }
 
+int
+FilterGauss::kernel_radius() const
+{
+	return 2;
+}
+
 } // end namespace firevision
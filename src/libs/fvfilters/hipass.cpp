@@ -104,4 +104,10 @@ FilterHipass::apply()
 #endif
 }
 
+int
+FilterHipass::kernel_radius() const
+{
+	return 1;
+}
+
 } // end namespace firevision
@@ -37,6 +37,7 @@ public:
 	FilterHipass();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
@@ -132,4 +132,10 @@ FilterInvert::apply()
 	}
 }
 
+int
+FilterInvert::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
@@ -34,6 +34,7 @@ public:
 	FilterInvert();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
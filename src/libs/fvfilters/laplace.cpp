@@ -227,4 +227,10 @@ FilterLaplace::calculate_kernel(int *kernel, float sigma, unsigned int size, flo
   */
 }
 
+int
+FilterLaplace::kernel_radius() const
+{
+	return (kernel != NULL) ? (kernel_size + 1) / 2 : 2;
+}
+
 } // end namespace firevision
@@ -39,6 +39,7 @@ public:
 	~FilterLaplace();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 
 	static void calculate_kernel(int *kernel_buffer, float sigma, unsigned int size, float scale);
 
@@ -165,4 +165,10 @@ FilterMax::apply()
 	}
 }
 
+int
+FilterMax::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
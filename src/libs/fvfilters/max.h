@@ -34,6 +34,7 @@ public:
 	FilterMax();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
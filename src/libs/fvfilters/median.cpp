@@ -46,6 +46,15 @@ FilterMedian::FilterMedian(unsigned int mask_size) : Filter("FilterMedian")
 	this->mask_size = mask_size;
 }
 
+/** Get mask size.
+ * @return size of median mask
+ */
+unsigned int
+FilterMedian::get_mask_size() const
+{
+	return mask_size;
+}
+
 void
 FilterMedian::apply()
 {
@@ -98,4 +107,10 @@ FilterMedian::apply()
 #endif
 }
 
+int
+FilterMedian::kernel_radius() const
+{
+	return (mask_size + 1) / 2;
+}
+
 } // end namespace firevision
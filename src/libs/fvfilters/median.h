@@ -36,7 +36,10 @@ class FilterMedian : public Filter
 public:
 	FilterMedian(unsigned int mask_size);
 
+	unsigned int get_mask_size() const;
+
 	virtual void apply();
+	virtual int  kernel_radius() const;
 
 private:
 	unsigned int mask_size;
@@ -165,4 +165,10 @@ FilterMin::apply()
 	}
 }
 
+int
+FilterMin::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
@@ -34,6 +34,7 @@ public:
 	FilterMin();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
@@ -93,4 +93,10 @@ FilterClosing::apply()
 	erode->apply();
 }
 
+int
+FilterClosing::kernel_radius() const
+{
+	return dilate->kernel_radius() + erode->kernel_radius();
+}
+
 } // end namespace firevision
@@ -53,6 +53,7 @@ public:
 	                                     unsigned int   se_anchor_y);
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 
 private:
 	FilterDilation *dilate;
@@ -25,6 +25,7 @@
 #include <fvfilters/morphology/dilation.h>
 #include <fvutils/color/yuv.h>
 
+#include <algorithm>
 #include <cstddef>
 
 #ifdef HAVE_IPP
@@ -207,4 +208,10 @@ FilterDilation::apply()
 #endif
 }
 
+int
+FilterDilation::kernel_radius() const
+{
+	return (se != NULL) ? std::max(se_width, se_height) : 1;
+}
+
 } // end namespace firevision
@@ -38,6 +38,7 @@ public:
 	               unsigned int   se_anchor_y);
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
@@ -24,6 +24,7 @@
 #include <fvfilters/morphology/erosion.h>
 #include <fvutils/color/yuv.h>
 
+#include <algorithm>
 #include <cstddef>
 
 #ifdef HAVE_IPP
@@ -167,4 +168,10 @@ FilterErosion::apply()
 #endif
 }
 
+int
+FilterErosion::kernel_radius() const
+{
+	return (se != NULL) ? std::max(se_width, se_height) : 1;
+}
+
 } // end namespace firevision
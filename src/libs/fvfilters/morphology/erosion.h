@@ -33,6 +33,7 @@ public:
 	FilterErosion();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
@@ -72,4 +72,24 @@ MorphologicalFilter::set_structuring_element(unsigned char *se,
 	this->se_anchor_y = se_anchor_y;
 }
 
+/** Get the structuring element.
+ * @param se_width upon return contains the width of the structuring element
+ * @param se_height upon return contains the height of the structuring element
+ * @param se_anchor_x upon return contains the x coordinate of the anchor
+ * @param se_anchor_y upon return contains the y coordinate of the anchor
+ * @return structuring element buffer, NULL if none has been set
+ */
+unsigned char *
+MorphologicalFilter::get_structuring_element(unsigned int &se_width,
+                                             unsigned int &se_height,
+                                             unsigned int &se_anchor_x,
+                                             unsigned int &se_anchor_y) const
+{
+	se_width    = this->se_width;
+	se_height   = this->se_height;
+	se_anchor_x = this->se_anchor_x;
+	se_anchor_y = this->se_anchor_y;
+	return se;
+}
+
 } // end namespace firevision
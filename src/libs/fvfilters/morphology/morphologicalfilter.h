@@ -42,6 +42,11 @@ public:
 	                                     unsigned int   se_anchor_x,
 	                                     unsigned int   se_anchor_y);
 
+	unsigned char *get_structuring_element(unsigned int &se_width,
+	                                       unsigned int &se_height,
+	                                       unsigned int &se_anchor_x,
+	                                       unsigned int &se_anchor_y) const;
+
 protected:
 	/** Structuring element */
 	unsigned char *se;
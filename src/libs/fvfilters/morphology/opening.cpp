@@ -93,4 +93,10 @@ FilterOpening::apply()
 	dilate->apply();
 }
 
+int
+FilterOpening::kernel_radius() const
+{
+	return erode->kernel_radius() + dilate->kernel_radius();
+}
+
 } // end namespace firevision
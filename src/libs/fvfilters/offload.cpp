@@ -0,0 +1,297 @@
+
+/***************************************************************************
+ *  offload.cpp - Run a chain of filters on an OpenCL device
+ *
+ *  Created: Thu Oct 15 05:49:37 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <fvfilters/gauss.h>
+#include <fvfilters/median.h>
+#include <fvfilters/morphology/closing.h>
+#include <fvfilters/morphology/dilation.h>
+#include <fvfilters/morphology/erosion.h>
+#include <fvfilters/morphology/opening.h>
+#include <fvfilters/offload.h>
+#include <fvfilters/sobel.h>
+
+#include <algorithm>
+#include <opencv2/core/ocl.hpp>
+#include <opencv2/imgproc.hpp>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/** @class FilterOffload <fvfilters/offload.h>
+ * Run a chain of filters on an OpenCL device.
+ * The luminance plane of the source ROI is uploaded once, all filters of
+ * the chain are applied to device buffers, and only the final result is
+ * downloaded to the destination buffer. Intermediate images never leave
+ * the device. Device buffers are kept across frames and only reallocated
+ * if the ROI size changes.
+ *
+ * FilterGauss, FilterSobel with horizontal or vertical orientation,
+ * FilterMedian and the dilation, erosion, opening and closing filters run
+ * on the device, using the transparent API of OpenCV. Any other filter is
+ * called on the host, the image is downloaded before and uploaded after
+ * it. Such filters may only process the luminance plane. Filters which
+ * need the full image, like FilterRectify, must be applied before the
+ * chain.
+ *
+ * If no OpenCL device is available, or the device is disabled, the same
+ * operations run on the CPU. The filters added to the chain are only
+ * used for their parameters, their source and destination buffers need
+ * not be set.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param use_device true to run on an OpenCL device if one is available,
+ * false to always run on the CPU
+ */
+FilterOffload::FilterOffload(bool use_device) : Filter("FilterOffload")
+{
+	use_device_ = use_device;
+	dst         = NULL;
+	dst_roi     = NULL;
+}
+
+/** Destructor.
+ * Deletes all added filters.
+ */
+FilterOffload::~FilterOffload()
+{
+	for (Filter *f : filters_) {
+		delete f;
+	}
+}
+
+/** Append a filter to the chain.
+ * The chain takes ownership of the filter.
+ * @param filter filter to append
+ */
+void
+FilterOffload::add_filter(Filter *filter)
+{
+	if (filter == NULL) {
+		throw NullPointerException("FilterOffload: filter must not be NULL");
+	}
+	filters_.push_back(filter);
+}
+
+/** Get number of filters.
+ * @return number of filters in the chain
+ */
+unsigned int
+FilterOffload::num_filters() const
+{
+	return filters_.size();
+}
+
+/** Get filter.
+ * @param i index of the filter, less than num_filters()
+ * @return filter
+ */
+Filter *
+FilterOffload::filter(unsigned int i) const
+{
+	if (i >= filters_.size()) {
+		throw OutOfBoundsException("Invalid filter index", i, 0, filters_.size());
+	}
+	return filters_[i];
+}
+
+/** Check if a filter runs as part of the offloaded chain.
+ * @param i index of the filter, less than num_filters()
+ * @return true if the filter is applied to the device buffers, false if
+ * it is called on the host
+ */
+bool
+FilterOffload::offloaded(unsigned int i) const
+{
+	return operation(filter(i)) != OP_HOST;
+}
+
+/** Check if an OpenCL device is used.
+ * @return true if the chain runs on an OpenCL device, false if it runs
+ * on the CPU
+ */
+bool
+FilterOffload::use_device() const
+{
+	return use_device_ && device_available();
+}
+
+/** Check if an OpenCL device is available.
+ * @return true if OpenCV found an OpenCL device
+ */
+bool
+FilterOffload::device_available()
+{
+	return cv::ocl::haveOpenCL();
+}
+
+int
+FilterOffload::kernel_radius() const
+{
+	int radius = 0;
+	for (Filter *f : filters_) {
+		int r = f->kernel_radius();
+		if (r < 0) {
+			return -1;
+		}
+		radius += r;
+	}
+	return radius;
+}
+
+/** Determine operation for a filter.
+ * @param filter filter to check
+ * @return operation to run for the filter
+ */
+FilterOffload::Operation
+FilterOffload::operation(Filter *filter) const
+{
+	if (dynamic_cast<FilterGauss *>(filter)) {
+		return OP_GAUSS;
+	} else if (dynamic_cast<FilterSobel *>(filter)) {
+		// only the orientations OpenCV's Sobel supports directly
+		if (filter->orientation() == ORI_HORIZONTAL) {
+			return OP_SOBEL_HORIZ;
+		} else if (filter->orientation() == ORI_VERTICAL) {
+			return OP_SOBEL_VERT;
+		}
+	} else if (dynamic_cast<FilterMedian *>(filter)) {
+		return OP_MEDIAN;
+	} else if (dynamic_cast<FilterDilation *>(filter)) {
+		return OP_DILATION;
+	} else if (dynamic_cast<FilterErosion *>(filter)) {
+		return OP_EROSION;
+	} else if (dynamic_cast<FilterOpening *>(filter)) {
+		return OP_OPENING;
+	} else if (dynamic_cast<FilterClosing *>(filter)) {
+		return OP_CLOSING;
+	}
+	return OP_HOST;
+}
+
+/** Call a filter on the host.
+ * @param filter filter to call
+ * @param in device buffer with the input
+ * @param out device buffer for the output
+ */
+void
+FilterOffload::run_host(Filter *filter, cv::UMat &in, cv::UMat &out)
+{
+	// the output starts as a copy, filters may not write border pixels
+	in.copyTo(host_buffers_[0]);
+	in.copyTo(host_buffers_[1]);
+
+	// filters may shrink the ROIs, hence they are set for each call
+	host_src_roi_.start.x      = 0;
+	host_src_roi_.start.y      = 0;
+	host_src_roi_.width        = in.cols;
+	host_src_roi_.height       = in.rows;
+	host_src_roi_.image_width  = in.cols;
+	host_src_roi_.image_height = in.rows;
+	host_src_roi_.line_step    = host_buffers_[0].step;
+	host_src_roi_.pixel_step   = 1;
+	host_dst_roi_              = host_src_roi_;
+	host_dst_roi_.line_step    = host_buffers_[1].step;
+
+	filter->set_src_buffer(host_buffers_[0].data, &host_src_roi_, filter->orientation(), 0);
+	filter->set_dst_buffer(host_buffers_[1].data, &host_dst_roi_);
+	filter->apply();
+
+	host_buffers_[1].copyTo(out);
+}
+
+void
+FilterOffload::apply()
+{
+	if (filters_.empty()) {
+		throw Exception("FilterOffload: no filters added");
+	}
+	if ((src[0] == NULL) || (src_roi[0] == NULL)) {
+		throw NullPointerException("FilterOffload: source buffer must be set");
+	}
+	if (dst == NULL) {
+		dst     = src[0];
+		dst_roi = src_roi[0];
+	}
+
+	const int width  = std::min(src_roi[0]->width, dst_roi->width);
+	const int height = std::min(src_roi[0]->height, dst_roi->height);
+
+	cv::Mat srcm(height,
+	             width,
+	             CV_8UC1,
+	             src[0] + (src_roi[0]->start.y * src_roi[0]->line_step)
+	               + (src_roi[0]->start.x * src_roi[0]->pixel_step),
+	             src_roi[0]->line_step);
+
+	cv::Mat dstm(height,
+	             width,
+	             CV_8UC1,
+	             dst + (dst_roi->start.y * dst_roi->line_step)
+	               + (dst_roi->start.x * dst_roi->pixel_step),
+	             dst_roi->line_step);
+
+	// the setting is per thread in OpenCV
+	cv::ocl::setUseOpenCL(use_device_);
+
+	unsigned int cur = 0;
+	srcm.copyTo(buffers_[cur]);
+
+	for (Filter *f : filters_) {
+		cv::UMat &in  = buffers_[cur];
+		cv::UMat &out = buffers_[1 - cur];
+
+		Operation op = operation(f);
+		cv::Mat   se;
+		cv::Point anchor(-1, -1);
+		if ((op == OP_DILATION) || (op == OP_EROSION) || (op == OP_OPENING) || (op == OP_CLOSING)) {
+			unsigned int   se_width, se_height, se_anchor_x, se_anchor_y;
+			unsigned char *se_buf = static_cast<MorphologicalFilter *>(f)->get_structuring_element(
+			  se_width, se_height, se_anchor_x, se_anchor_y);
+			if (se_buf != NULL) {
+				se     = cv::Mat(se_height, se_width, CV_8UC1, se_buf);
+				anchor = cv::Point(se_anchor_x, se_anchor_y);
+			}
+		}
+
+		switch (op) {
+		case OP_GAUSS: cv::GaussianBlur(in, out, cv::Size(5, 5), 1.0); break;
+		case OP_SOBEL_HORIZ: cv::Sobel(in, out, -1, 1, 0, 3, 1); break;
+		case OP_SOBEL_VERT: cv::Sobel(in, out, -1, 0, 1, 3, 1); break;
+		case OP_MEDIAN: cv::medianBlur(in, out, static_cast<FilterMedian *>(f)->get_mask_size()); break;
+		case OP_DILATION: cv::dilate(in, out, se, anchor); break;
+		case OP_EROSION: cv::erode(in, out, se, anchor); break;
+		case OP_OPENING: cv::morphologyEx(in, out, cv::MORPH_OPEN, se, anchor); break;
+		case OP_CLOSING: cv::morphologyEx(in, out, cv::MORPH_CLOSE, se, anchor); break;
+		case OP_HOST: run_host(f, in, out); break;
+		}
+		cur = 1 - cur;
+	}
+
+	buffers_[cur].copyTo(dstm);
+}
+
+} // end namespace firevision
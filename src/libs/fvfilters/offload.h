@@ -0,0 +1,84 @@
+
+/***************************************************************************
+ *  offload.h - Run a chain of filters on an OpenCL device
+ *
+ *  Created: Thu Oct 15 05:49:37 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FILTER_OFFLOAD_H_
+#define _FIREVISION_FILTER_OFFLOAD_H_
+
+#ifndef HAVE_OPENCV
+#	error "OpenCV not installed"
+#endif
+
+#include <fvfilters/filter.h>
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace firevision {
+
+class FilterOffload : public Filter
+{
+public:
+	FilterOffload(bool use_device = true);
+	virtual ~FilterOffload();
+
+	void         add_filter(Filter *filter);
+	unsigned int num_filters() const;
+	Filter *     filter(unsigned int i) const;
+	bool         offloaded(unsigned int i) const;
+
+	bool        use_device() const;
+	static bool device_available();
+
+	virtual void apply();
+	virtual int  kernel_radius() const;
+
+private:
+	/** Operation run for a filter. */
+	typedef enum {
+		OP_HOST,         /**< call the filter on the host */
+		OP_GAUSS,        /**< Gaussian blur */
+		OP_SOBEL_HORIZ,  /**< horizontal Sobel */
+		OP_SOBEL_VERT,   /**< vertical Sobel */
+		OP_MEDIAN,       /**< median */
+		OP_DILATION,     /**< dilation */
+		OP_EROSION,      /**< erosion */
+		OP_OPENING,      /**< opening */
+		OP_CLOSING       /**< closing */
+	} Operation;
+
+	Operation operation(Filter *filter) const;
+	void      run_host(Filter *filter, cv::UMat &in, cv::UMat &out);
+
+private:
+	bool                  use_device_;
+	std::vector<Filter *> filters_;
+
+	cv::UMat buffers_[2];
+	cv::Mat  host_buffers_[2];
+	ROI      host_src_roi_;
+	ROI      host_dst_roi_;
+};
+
+} // end namespace firevision
+
+#endif
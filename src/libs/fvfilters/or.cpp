@@ -113,4 +113,10 @@ FilterOr::apply()
 #endif
 }
 
+int
+FilterOr::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
@@ -0,0 +1,356 @@
+
+/***************************************************************************
+ *  pipeline.cpp - Apply a chain of filters band by band
+ *
+ *  Created: Thu Oct 15 05:11:26 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/exceptions/software.h>
+#include <fvfilters/pipeline.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/// @cond INTERNAL
+/** Get the bytes per line of each plane of an image.
+ * @param cspace colorspace of the image
+ * @param width width of the image in pixels
+ * @param bytes upon return contains the bytes per line of each plane
+ * @return number of planes
+ */
+static unsigned int
+line_planes(colorspace_t cspace, unsigned int width, size_t bytes[3])
+{
+	switch (cspace) {
+	case YUV422_PLANAR:
+		bytes[0] = width;
+		bytes[1] = bytes[2] = width / 2;
+		return 3;
+	case YUV411_PLANAR:
+		bytes[0] = width;
+		bytes[1] = bytes[2] = width / 4;
+		return 3;
+	case RGB_PLANAR: bytes[0] = bytes[1] = bytes[2] = width; return 3;
+	case YUV420_PLANAR:
+	case YUV422_PLANAR_QUARTER:
+	case CS_UNKNOWN:
+		throw Exception("FilterPipeline: colorspace %s cannot be split into lines",
+		                colorspace_to_string(cspace));
+	default: bytes[0] = colorspace_buffer_size(cspace, width, 1); return 1;
+	}
+}
+
+/** Copy lines between two images of the same colorspace and width.
+ * @param cspace colorspace of both images
+ * @param width width of both images in pixels
+ * @param from image to copy from
+ * @param from_height height of @p from in lines
+ * @param from_line first line to copy in @p from
+ * @param from_x first column to copy in @p from
+ * @param to image to copy to
+ * @param to_height height of @p to in lines
+ * @param to_line first line to copy to in @p to
+ * @param to_x first column to copy to in @p to
+ * @param num_lines number of lines to copy
+ * @param num_x number of columns to copy
+ */
+static void
+copy_lines(colorspace_t         cspace,
+           unsigned int         width,
+           const unsigned char *from,
+           unsigned int         from_height,
+           unsigned int         from_line,
+           unsigned int         from_x,
+           unsigned char *      to,
+           unsigned int         to_height,
+           unsigned int         to_line,
+           unsigned int         to_x,
+           unsigned int         num_lines,
+           unsigned int         num_x)
+{
+	size_t       bytes[3];
+	unsigned int planes = line_planes(cspace, width, bytes);
+
+	for (unsigned int p = 0; p < planes; ++p) {
+		const unsigned char *f = from + from_line * bytes[p] + (from_x * bytes[p]) / width;
+		unsigned char *      t = to + to_line * bytes[p] + (to_x * bytes[p]) / width;
+		size_t               n = (num_x * bytes[p]) / width;
+
+		if (n == bytes[p]) {
+			memcpy(t, f, num_lines * n);
+		} else {
+			for (unsigned int l = 0; l < num_lines; ++l) {
+				memcpy(t + l * bytes[p], f + l * bytes[p], n);
+			}
+		}
+
+		from += bytes[p] * from_height;
+		to += bytes[p] * to_height;
+	}
+}
+/// @endcond
+
+/** @class FilterPipeline <fvfilters/pipeline.h>
+ * Apply a chain of filters band by band.
+ * Running filters one after another over whole images writes every
+ * intermediate image to memory and reads it back in the next step. The
+ * pipeline instead splits the ROI into bands of a few lines and passes
+ * each band through all filters before continuing with the next band.
+ * Intermediate results are kept in two strip buffers which are just
+ * large enough for one band, so they stay in the cache.
+ *
+ * The first filter reads the source buffer, each further filter reads
+ * the output of the previous one, and the output of the last filter is
+ * written to the destination buffer. Bands are extended by the kernel
+ * radii of the filters (see Filter::kernel_radius()), such that each
+ * filter sees the neighbouring lines it needs. Strips also contain the
+ * image lines next to the ROI for filters which read beyond it. If any
+ * filter does not report a radius, the whole ROI is processed as a
+ * single band.
+ *
+ * The pipeline is itself a filter with the summed kernel radius of its
+ * filters. Hence a pipeline can be run on multiple threads with
+ * FilterTiler, using a factory that creates a complete pipeline.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param input_colorspace colorspace of the source buffer
+ * @param band_lines number of lines of the ROI processed at once
+ */
+FilterPipeline::FilterPipeline(colorspace_t input_colorspace, unsigned int band_lines)
+: Filter("FilterPipeline")
+{
+	if (band_lines == 0) {
+		throw OutOfBoundsException("Band must have at least one line", 0, 1, 0xFFFFFFFF);
+	}
+	input_colorspace_ = input_colorspace;
+	band_lines_       = band_lines;
+	dst               = NULL;
+	dst_roi           = NULL;
+}
+
+/** Destructor.
+ * Deletes all added filters.
+ */
+FilterPipeline::~FilterPipeline()
+{
+	for (Stage &s : stages_) {
+		delete s.filter;
+	}
+}
+
+/** Append a filter to the pipeline.
+ * The pipeline takes ownership of the filter.
+ * @param filter filter to append
+ * @param output_colorspace colorspace of the images the filter produces,
+ * this is the input colorspace of the next filter
+ */
+void
+FilterPipeline::add_filter(Filter *filter, colorspace_t output_colorspace)
+{
+	if (filter == NULL) {
+		throw NullPointerException("FilterPipeline: filter must not be NULL");
+	}
+	Stage s;
+	s.filter     = filter;
+	s.colorspace = output_colorspace;
+	stages_.push_back(s);
+}
+
+/** Get number of filters.
+ * @return number of filters in the pipeline
+ */
+unsigned int
+FilterPipeline::num_filters() const
+{
+	return stages_.size();
+}
+
+/** Get filter.
+ * @param i index of the filter, less than num_filters()
+ * @return filter
+ */
+Filter *
+FilterPipeline::filter(unsigned int i) const
+{
+	if (i >= stages_.size()) {
+		throw OutOfBoundsException("Invalid filter index", i, 0, stages_.size());
+	}
+	return stages_[i].filter;
+}
+
+int
+FilterPipeline::kernel_radius() const
+{
+	int radius = 0;
+	for (const Stage &s : stages_) {
+		int r = s.filter->kernel_radius();
+		if (r < 0) {
+			return -1;
+		}
+		radius += r;
+	}
+	return radius;
+}
+
+/** Set ROI of a filter in a strip buffer.
+ * @param roi ROI to set
+ * @param colorspace colorspace of the strip buffer
+ * @param first_line first line of the ROI in the strip
+ * @param num_lines height of the ROI
+ * @param strip_lines number of lines in the strip
+ */
+void
+FilterPipeline::set_strip_roi(ROI &        roi,
+                              colorspace_t colorspace,
+                              unsigned int first_line,
+                              unsigned int num_lines,
+                              unsigned int strip_lines) const
+{
+	size_t bytes[3];
+	line_planes(colorspace, src_roi[0]->image_width, bytes);
+
+	roi.start.x      = src_roi[0]->start.x;
+	roi.start.y      = first_line;
+	roi.width        = src_roi[0]->width;
+	roi.height       = num_lines;
+	roi.image_width  = src_roi[0]->image_width;
+	roi.image_height = strip_lines;
+	roi.line_step    = bytes[0];
+	roi.pixel_step   = bytes[0] / src_roi[0]->image_width;
+}
+
+void
+FilterPipeline::apply()
+{
+	if (stages_.empty()) {
+		throw Exception("FilterPipeline: no filters added");
+	}
+	if ((src[0] == NULL) || (src_roi[0] == NULL) || (dst == NULL) || (dst_roi == NULL)) {
+		throw NullPointerException("FilterPipeline: source and destination buffers must be set");
+	}
+
+	const int          radius     = kernel_radius();
+	const unsigned int n          = stages_.size();
+	const unsigned int width      = src_roi[0]->image_width;
+	const unsigned int height     = std::min(src_roi[0]->height, dst_roi->height);
+	const unsigned int band       = (radius < 0) ? height : band_lines_;
+	const colorspace_t output_cs  = stages_[n - 1].colorspace;
+	const unsigned int total_halo = std::max(radius, 0);
+
+	if ((radius > 0) && (dst == src[0])) {
+		throw Exception("FilterPipeline: cannot filter in-place with kernel radius %i", radius);
+	}
+
+	// halo[k]: lines needed above and below a band in the input of stage k
+	std::vector<unsigned int> halo(n + 1, 0);
+	for (unsigned int k = n; k > 0; --k) {
+		halo[k - 1] = halo[k] + std::max(stages_[k - 1].filter->kernel_radius(), 0);
+	}
+
+	// a strip holds the band, its halo and as many image lines beyond the
+	// ROI as the filters may read, line_planes() throws for colorspaces
+	// which cannot be split into lines
+	size_t       bytes[3];
+	unsigned int max_lines  = std::min(band, height) + 4 * total_halo;
+	size_t       strip_size = colorspace_buffer_size(input_colorspace_, width, max_lines);
+	line_planes(input_colorspace_, width, bytes);
+	for (const Stage &s : stages_) {
+		line_planes(s.colorspace, width, bytes);
+		strip_size = std::max(strip_size, colorspace_buffer_size(s.colorspace, width, max_lines));
+	}
+	for (unsigned int i = 0; i < 2; ++i) {
+		if (strips_[i].size() < strip_size) {
+			strips_[i].resize(strip_size);
+		}
+	}
+
+	const unsigned int roi_y = src_roi[0]->start.y;
+
+	for (unsigned int first = 0; first < height; first += band) {
+		unsigned int last = std::min(height, first + band);
+
+		// lines of the ROI needed as input of the first stage
+		unsigned int in_first = (first > total_halo) ? first - total_halo : 0;
+		unsigned int in_last  = std::min(height, last + total_halo);
+		// image lines beyond them, clipped to the image
+		unsigned int image_last = std::max(src_roi[0]->image_height, roi_y + in_last);
+		unsigned int above      = std::min(total_halo, roi_y + in_first);
+		unsigned int below      = std::min(total_halo, image_last - (roi_y + in_last));
+
+		unsigned int strip_first = roi_y + in_first - above;
+		unsigned int strip_lines = above + (in_last - in_first) + below;
+
+		copy_lines(input_colorspace_,
+		           width,
+		           src[0],
+		           src_roi[0]->image_height,
+		           strip_first,
+		           0,
+		           &strips_[0][0],
+		           strip_lines,
+		           0,
+		           0,
+		           strip_lines,
+		           width);
+
+		colorspace_t cs = input_colorspace_;
+		for (unsigned int k = 0; k < n; ++k) {
+			Stage &      s = stages_[k];
+			unsigned int f = (first > halo[k]) ? first - halo[k] : 0;
+			unsigned int l = std::min(height, last + halo[k]);
+
+			set_strip_roi(s.src_roi, cs, roi_y + f - strip_first, l - f, strip_lines);
+			set_strip_roi(s.dst_roi, s.colorspace, roi_y + f - strip_first, l - f, strip_lines);
+
+			s.filter->set_src_buffer(&strips_[k % 2][0], &s.src_roi);
+			s.filter->set_dst_buffer(&strips_[(k + 1) % 2][0], &s.dst_roi);
+			s.filter->apply();
+
+			cs = s.colorspace;
+		}
+
+		// copy the band's lines, as far as the last filter processed them
+		const ROI &  out       = stages_[n - 1].dst_roi;
+		unsigned int out_first = std::max(roi_y + first - strip_first, out.start.y);
+		unsigned int out_last  = std::min(roi_y + last - strip_first, out.start.y + out.height);
+		if (out_first < out_last) {
+			copy_lines(output_cs,
+			           width,
+			           &strips_[n % 2][0],
+			           strip_lines,
+			           out_first,
+			           out.start.x,
+			           dst,
+			           dst_roi->image_height,
+			           dst_roi->start.y + (out_first + strip_first - roi_y),
+			           dst_roi->start.x + (out.start.x - src_roi[0]->start.x),
+			           out_last - out_first,
+			           out.width);
+		}
+	}
+}
+
+} // end namespace firevision
@@ -0,0 +1,72 @@
+
+/***************************************************************************
+ *  pipeline.h - Apply a chain of filters band by band
+ *
+ *  Created: Thu Oct 15 05:11:26 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FILTER_PIPELINE_H_
+#define _FIREVISION_FILTER_PIPELINE_H_
+
+#include <fvfilters/filter.h>
+#include <fvutils/color/colorspaces.h>
+
+#include <vector>
+
+namespace firevision {
+
+class FilterPipeline : public Filter
+{
+public:
+	FilterPipeline(colorspace_t input_colorspace, unsigned int band_lines = 32);
+	virtual ~FilterPipeline();
+
+	void         add_filter(Filter *filter, colorspace_t output_colorspace);
+	unsigned int num_filters() const;
+	Filter *     filter(unsigned int i) const;
+
+	virtual void apply();
+	virtual int  kernel_radius() const;
+
+private:
+	/** One filter of the pipeline. */
+	typedef struct
+	{
+		Filter *     filter;     /**< the filter */
+		colorspace_t colorspace; /**< colorspace of the filter's output */
+		ROI          src_roi;    /**< source ROI in the strip buffer */
+		ROI          dst_roi;    /**< destination ROI in the strip buffer */
+	} Stage;
+
+	void set_strip_roi(ROI &        roi,
+	                   colorspace_t colorspace,
+	                   unsigned int first_line,
+	                   unsigned int num_lines,
+	                   unsigned int strip_lines) const;
+
+private:
+	colorspace_t               input_colorspace_;
+	unsigned int               band_lines_;
+	std::vector<Stage>         stages_;
+	std::vector<unsigned char> strips_[2];
+};
+
+} // end namespace firevision
+
+#endif
@@ -0,0 +1,117 @@
+
+/***************************************************************************
+ *  qa_offload.cpp - QA and benchmark for offloaded filter chains
+ *
+ *  Created: Thu Oct 15 05:49:37 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <fvfilters/gauss.h>
+#include <fvfilters/median.h>
+#include <fvfilters/morphology/dilation.h>
+#include <fvfilters/offload.h>
+#include <fvfilters/sobel.h>
+#include <fvutils/color/colorspaces.h>
+#include <utils/time/tracker.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace fawkes;
+using namespace firevision;
+
+#define IMAGE_WIDTH 640
+#define IMAGE_HEIGHT 480
+
+#define NUM_CYCLES 100
+
+// OpenCL kernels may round differently than the CPU implementations
+#define MAX_DIFFERENCE 2
+
+static FilterOffload *
+create_chain(bool use_device)
+{
+	FilterOffload *chain = new FilterOffload(use_device);
+	chain->add_filter(new FilterGauss());
+	chain->add_filter(new FilterMedian(5));
+	chain->add_filter(new FilterDilation());
+	chain->add_filter(new FilterSobel(ORI_HORIZONTAL));
+	return chain;
+}
+
+int
+main(int argc, char **argv)
+{
+	size_t         size      = colorspace_buffer_size(YUV422_PLANAR, IMAGE_WIDTH, IMAGE_HEIGHT);
+	unsigned char *src       = malloc_buffer(YUV422_PLANAR, IMAGE_WIDTH, IMAGE_HEIGHT);
+	unsigned char *reference = malloc_buffer(YUV422_PLANAR, IMAGE_WIDTH, IMAGE_HEIGHT);
+	unsigned char *dst       = malloc_buffer(YUV422_PLANAR, IMAGE_WIDTH, IMAGE_HEIGHT);
+	for (size_t i = 0; i < size; ++i) {
+		src[i] = rand() & 0xFF;
+	}
+	memset(reference, 0, size);
+	memset(dst, 0, size);
+
+	FilterOffload *host   = create_chain(false);
+	FilterOffload *device = create_chain(true);
+	printf("OpenCL device %s\n", device->use_device() ? "available" : "not available");
+
+	TimeTracker  tracker;
+	unsigned int cls_host   = tracker.add_class("host");
+	unsigned int cls_device = tracker.add_class("device");
+
+	for (unsigned int i = 0; i < NUM_CYCLES; ++i) {
+		ROI *roi = ROI::full_image(IMAGE_WIDTH, IMAGE_HEIGHT);
+		host->set_src_buffer(src, roi);
+		host->set_dst_buffer(reference, roi);
+		tracker.ping_start(cls_host);
+		host->apply();
+		tracker.ping_end(cls_host);
+
+		device->set_src_buffer(src, roi);
+		device->set_dst_buffer(dst, roi);
+		tracker.ping_start(cls_device);
+		device->apply();
+		tracker.ping_end(cls_device);
+		delete roi;
+	}
+
+	int max_diff = 0;
+	for (unsigned int i = 0; i < IMAGE_WIDTH * IMAGE_HEIGHT; ++i) {
+		int diff = abs((int)reference[i] - (int)dst[i]);
+		if (diff > max_diff) {
+			max_diff = diff;
+		}
+	}
+	printf("Maximum difference: %i\n", max_diff);
+
+	tracker.print_to_stdout();
+
+	delete host;
+	delete device;
+	free(src);
+	free(reference);
+	free(dst);
+
+	return max_diff <= MAX_DIFFERENCE ? 0 : 1;
+}
+
+/// @endcond
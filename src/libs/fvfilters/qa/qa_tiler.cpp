@@ -0,0 +1,116 @@
+
+/***************************************************************************
+ *  qa_tiler.cpp - QA and benchmark for tiled filter execution
+ *
+ *  Created: Thu Oct 15 05:08:14 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <fvfilters/gauss.h>
+#include <fvfilters/median.h>
+#include <fvfilters/morphology/dilation.h>
+#include <fvfilters/sobel.h>
+#include <fvfilters/tiler.h>
+#include <fvutils/color/colorspaces.h>
+#include <utils/time/tracker.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace fawkes;
+using namespace firevision;
+
+#define IMAGE_WIDTH 640
+#define IMAGE_HEIGHT 480
+
+#define NUM_CYCLES 100
+
+struct TiledFilter
+{
+	const char *               name;
+	FilterTiler::FilterFactory factory;
+};
+
+int
+main(int argc, char **argv)
+{
+	const TiledFilter filters[] = {{"gauss", []() -> Filter * { return new FilterGauss(); }},
+	                               {"sobel", []() -> Filter * { return new FilterSobel(); }},
+	                               {"median", []() -> Filter * { return new FilterMedian(5); }},
+	                               {"dilation", []() -> Filter * { return new FilterDilation(); }}};
+
+	size_t         size      = colorspace_buffer_size(YUV422_PLANAR, IMAGE_WIDTH, IMAGE_HEIGHT);
+	unsigned char *src       = malloc_buffer(YUV422_PLANAR, IMAGE_WIDTH, IMAGE_HEIGHT);
+	unsigned char *reference = malloc_buffer(YUV422_PLANAR, IMAGE_WIDTH, IMAGE_HEIGHT);
+	unsigned char *dst       = malloc_buffer(YUV422_PLANAR, IMAGE_WIDTH, IMAGE_HEIGHT);
+	for (size_t i = 0; i < size; ++i) {
+		src[i] = rand() & 0xFF;
+	}
+
+	TimeTracker tracker;
+	int         failures = 0;
+
+	for (const TiledFilter &f : filters) {
+		FilterTiler  tiler(f.factory);
+		Filter *     single = f.factory();
+		printf("%s: %u threads\n", f.name, tiler.num_threads());
+		unsigned int cls_single = tracker.add_class(std::string(f.name) + " single");
+		unsigned int cls_tiled  = tracker.add_class(std::string(f.name) + " tiled");
+
+		memset(reference, 0, size);
+		memset(dst, 0, size);
+
+		for (unsigned int i = 0; i < NUM_CYCLES; ++i) {
+			ROI *roi = ROI::full_image(IMAGE_WIDTH, IMAGE_HEIGHT);
+			single->set_src_buffer(src, roi);
+			single->set_dst_buffer(reference, roi);
+			tracker.ping_start(cls_single);
+			single->apply();
+			tracker.ping_end(cls_single);
+			delete roi;
+
+			roi = ROI::full_image(IMAGE_WIDTH, IMAGE_HEIGHT);
+			tiler.set_src_buffer(src, roi);
+			tiler.set_dst_buffer(dst, roi);
+			tracker.ping_start(cls_tiled);
+			tiler.apply();
+			tracker.ping_end(cls_tiled);
+			delete roi;
+		}
+
+		if (memcmp(reference, dst, IMAGE_WIDTH * IMAGE_HEIGHT) != 0) {
+			printf("%s: tiled result differs from single-threaded\n", f.name);
+			++failures;
+		}
+		delete single;
+	}
+
+	tracker.print_to_stdout();
+
+	free(src);
+	free(reference);
+	free(dst);
+
+	return failures == 0 ? 0 : 1;
+}
+
+/// @endcond
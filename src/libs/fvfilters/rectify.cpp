@@ -23,7 +23,9 @@
 
 #include <core/exceptions/software.h>
 #include <fvfilters/rectify.h>
+#include <fvutils/color/simd.h>
 #include <fvutils/color/yuv.h>
+#include <fvutils/rectification/rectinfo_bilinear_block.h>
 #include <fvutils/rectification/rectinfo_block.h>
 #include <fvutils/rectification/rectinfo_lut_block.h>
 
@@ -36,7 +38,9 @@ namespace firevision {
  * Rectify image.
  * This filter can be used to use a rectification information block to rectify
  * the given image. It has special support for RectificationLutInfoBlocks by using the
- * raw data pointer for fast access. For other info blocks it will simply use the
+ * raw data pointer for fast access. RectificationBilinearInfoBlocks are interpolated
+ * bilinearly with remap_bilinear_simd(), the chroma of each pixel pair is taken from
+ * the center of the pair. For other info blocks it will simply use the
  * RectificationInfoBlock::mapping() method to get the information.
  * @author Tim Niemueller
  */
@@ -90,7 +94,8 @@ FilterRectify::apply()
 
 	unsigned char py1 = 0, py2 = 0, pu1 = 0, pu2 = 0, pv1 = 0, pv2 = 0;
 
-	RectificationLutInfoBlock *rlib = dynamic_cast<RectificationLutInfoBlock *>(rib_);
+	RectificationLutInfoBlock *     rlib = dynamic_cast<RectificationLutInfoBlock *>(rib_);
+	RectificationBilinearInfoBlock *rbib = dynamic_cast<RectificationBilinearInfoBlock *>(rib_);
 
 	if (rlib) {
 		if ((rlib->pixel_width() != dst_roi->image_width)
@@ -176,6 +181,63 @@ FilterRectify::apply()
 				lut = llut;
 			}
 		}
+	} else if (rbib) {
+		if ((rbib->pixel_width() != dst_roi->image_width)
+		    || (rbib->pixel_height() != dst_roi->image_height)) {
+			throw fawkes::IllegalArgumentException("Rectification LUT and image sizes do not match");
+		}
+
+		const unsigned int   src_width = src_roi[0]->image_width;
+		const unsigned char *syp       = src[0];
+		const unsigned char *sup =
+		  YUV422_PLANAR_U_PLANE(src[0], src_roi[0]->image_width, src_roi[0]->image_height);
+		const unsigned char *svp =
+		  YUV422_PLANAR_V_PLANE(src[0], src_roi[0]->image_width, src_roi[0]->image_height);
+
+		// chroma is sampled at the center of each pixel pair, in the half
+		// width chroma planes the right neighbour must exist as well
+		const unsigned int pairs  = dst_roi->width / 2;
+		const unsigned int max_cx = (src_width / 2 - 1) * 16 - 1;
+		chroma_map_.resize(2 * pairs);
+
+		const rectinfo_lut_bilinear_entry_t *lut =
+		  rbib->lut_data() + dst_roi->start.y * rbib->pixel_width() + dst_roi->start.x;
+
+		for (unsigned int h = 0; h < dst_roi->height; ++h) {
+			remap_bilinear_simd(syp, src_width, (const uint16_t *)lut, dyp, dst_roi->width);
+
+			for (unsigned int i = 0; i < pairs; ++i) {
+				unsigned int cx        = (lut[2 * i].x + lut[2 * i + 1].x) >> 2;
+				chroma_map_[2 * i]     = (cx < max_cx) ? cx : max_cx;
+				chroma_map_[2 * i + 1] = (lut[2 * i].y + lut[2 * i + 1].y) >> 1;
+			}
+			remap_bilinear_simd(sup, src_width / 2, &chroma_map_[0], dup, pairs);
+			remap_bilinear_simd(svp, src_width / 2, &chroma_map_[0], dvp, pairs);
+
+			if (mark_zeros_) {
+				// the luminance of the unrectified image is kept, the whole pixel
+				// pair is marked as the chroma is shared
+				const unsigned char *lsyp =
+				  syp + (dst_roi->start.y + h) * src_width + dst_roi->start.x;
+				for (unsigned int i = 0; i < pairs; ++i) {
+					bool z1 = (lut[2 * i].x == 0) && (lut[2 * i].y == 0);
+					bool z2 = (lut[2 * i + 1].x == 0) && (lut[2 * i + 1].y == 0);
+					if (z1) {
+						dyp[2 * i] = lsyp[2 * i];
+					}
+					if (z2) {
+						dyp[2 * i + 1] = lsyp[2 * i + 1];
+					}
+					if (z1 || z2) {
+						dup[i] = 0;
+						dvp[i] = 255;
+					}
+				}
+			}
+
+			FILTER_RECTIFY_ADVANCE_LINE;
+			lut += rbib->pixel_width();
+		}
 	} else {
 		printf("Unknown info block\n");
 
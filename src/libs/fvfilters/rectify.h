@@ -26,6 +26,8 @@
 
 #include <fvfilters/filter.h>
 
+#include <vector>
+
 namespace firevision {
 
 class RectificationInfoBlock;
@@ -40,6 +42,8 @@ public:
 private:
 	RectificationInfoBlock *rib_;
 	bool                    mark_zeros_;
+
+	std::vector<uint16_t> chroma_map_;
 };
 
 } // end namespace firevision
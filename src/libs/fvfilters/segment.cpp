@@ -102,4 +102,10 @@ FilterSegment::apply()
 	}
 }
 
+int
+FilterSegment::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
@@ -37,6 +37,7 @@ public:
 	FilterSegment(ColorModel *cm, color_t what);
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 
 private:
 	ColorModel *cm;
@@ -27,6 +27,7 @@
 #include <fvmodels/color/colormodel.h>
 #include <fvutils/color/yuv.h>
 
+#include <algorithm>
 #include <cstddef>
 
 namespace firevision {
@@ -88,14 +89,19 @@ FilterColorSegmentation::apply()
 	unsigned char *ldup = dup; // destination y-plane
 	unsigned char *ldvp = dvp; // destination y-plane
 
-	color_t c1;
-	// Unused for now: color_t c2;
+	color_t      c1;
+	unsigned int width = std::min(src_roi[0]->width, dst_roi->width);
+	if (colors_.size() < width) {
+		colors_.resize(width);
+	}
 
 	for (h = 0; (h < src_roi[0]->height) && (h < dst_roi->height); ++h) {
-		for (w = 0; (w < src_roi[0]->width) && (w < dst_roi->width); w += 2) {
-			c1 = cm->determine(*yp++, *up++, *vp++);
-			yp++;
-			//c2 = cm->determine(*yp++, *up++, *vp++);
+		// classify the whole line at once, avoids a virtual call per pixel
+		cm->determine_line(lyp, lup, lvp, width, &colors_[0]);
+
+		for (w = 0; w < width; w += 2) {
+			// the first pixel of each pair determines the marking
+			c1 = colors_[w];
 
 			switch (c1) {
 			case C_ORANGE:
@@ -160,13 +166,16 @@ FilterColorSegmentation::apply()
 		ldyp += dst_roi->line_step;
 		ldup += dst_roi->line_step / 2;
 		ldvp += dst_roi->line_step / 2;
-		yp  = lyp;
-		up  = lup;
-		vp  = lvp;
 		dyp = ldyp;
 		dup = ldup;
 		dvp = ldvp;
 	}
 }
 
+int
+FilterColorSegmentation::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
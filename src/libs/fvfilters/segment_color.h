@@ -26,6 +26,8 @@
 
 #include <fvfilters/filter.h>
 
+#include <vector>
+
 namespace firevision {
 
 class ColorModel;
@@ -36,9 +38,11 @@ public:
 	FilterColorSegmentation(ColorModel *cm);
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 
 private:
-	ColorModel *cm;
+	ColorModel *         cm;
+	std::vector<color_t> colors_;
 };
 
 } // end namespace firevision
@@ -103,4 +103,10 @@ FilterSharpen::apply()
 #endif
 }
 
+int
+FilterSharpen::kernel_radius() const
+{
+	return 1;
+}
+
 } // end namespace firevision
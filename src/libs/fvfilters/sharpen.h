@@ -37,6 +37,7 @@ public:
 	FilterSharpen();
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
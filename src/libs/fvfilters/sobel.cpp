@@ -43,6 +43,7 @@ namespace firevision {
  */
 FilterSobel::FilterSobel(orientation_t ori) : Filter("FilterSobel")
 {
+	this->ori[0] = ori;
 }
 
 /** Generate a sobel kernel for the given orientation.
@@ -274,4 +275,10 @@ FilterSobel::apply()
 #endif
 }
 
+int
+FilterSobel::kernel_radius() const
+{
+	return 1;
+}
+
 } // end namespace firevision
@@ -37,6 +37,7 @@ public:
 	FilterSobel(orientation_t ori = ORI_HORIZONTAL);
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 };
 
 } // end namespace firevision
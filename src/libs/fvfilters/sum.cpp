@@ -139,4 +139,10 @@ FilterSum::apply()
 	}
 }
 
+int
+FilterSum::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
@@ -167,4 +167,10 @@ FilterThreshold::apply()
 #endif
 }
 
+int
+FilterThreshold::kernel_radius() const
+{
+	return 0;
+}
+
 } // end namespace firevision
@@ -45,6 +45,7 @@ public:
 	                    unsigned char max_replace);
 
 	virtual void apply();
+	virtual int  kernel_radius() const;
 
 private:
 	unsigned char max;
@@ -0,0 +1,337 @@
+
+/***************************************************************************
+ *  tiler.cpp - Apply a filter to row bands of a ROI in parallel
+ *
+ *  Created: Thu Oct 15 05:08:14 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/exceptions/software.h>
+#include <core/threading/barrier.h>
+#include <core/threading/thread.h>
+#include <fvfilters/tiler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <unistd.h>
+
+/** Minimum number of lines of a tile, not counting the halo. */
+#define MIN_TILE_LINES 16
+
+using namespace fawkes;
+
+namespace firevision {
+
+/// @cond INTERNAL
+class FilterTiler::Worker : public Thread
+{
+public:
+	Worker(FilterTiler *tiler, unsigned int tile)
+	: Thread("FilterTilerWorker", Thread::OPMODE_WAITFORWAKEUP)
+	{
+		set_name("FilterTilerWorker %u", tile);
+		tiler_ = tiler;
+		tile_  = tile;
+	}
+
+	virtual void
+	loop()
+	{
+		tiler_->run_tile(tile_);
+	}
+
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	FilterTiler *tiler_;
+	unsigned int tile_;
+};
+/// @endcond
+
+/** @class FilterTiler <fvfilters/tiler.h>
+ * Apply a filter to row bands of a ROI in parallel.
+ * The ROI is split into horizontal bands, one per thread, and each band
+ * is processed by its own instance of the filter. The calling thread
+ * processes the first band, the others are handed to worker threads.
+ *
+ * How a ROI is split depends on the kernel radius the filter reports,
+ * see Filter::kernel_radius(). Filters which process each pixel on its
+ * own (radius 0) write their bands directly to the destination buffer.
+ * For filters with a larger radius each band is extended by a halo of
+ * that many lines from the neighbouring bands. The extended band is
+ * filtered into a scratch buffer of the thread, and only the band's own
+ * lines are copied to the destination. Hence the result is the same as
+ * when the filter is applied to the whole ROI, also for in-place
+ * filtering. Filters which do not report a radius are applied to the
+ * whole ROI in the calling thread.
+ *
+ * The tiler only splits along lines. Filters which write other planes
+ * than the first one of a planar image must therefore have a radius of 0.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param factory function called once per thread to create the filter
+ * instance for its bands. The tiler takes ownership of the filters.
+ * @param num_threads number of threads including the calling thread,
+ * 0 to use one per online processor core
+ * @param max_num_buffers maximum number of source buffers of the filter
+ */
+FilterTiler::FilterTiler(FilterFactory factory,
+                         unsigned int  num_threads,
+                         unsigned int  max_num_buffers)
+: Filter("FilterTiler", max_num_buffers)
+{
+	if (num_threads == 0) {
+		long int cores = sysconf(_SC_NPROCESSORS_ONLN);
+		num_threads    = (cores > 0) ? cores : 1;
+	}
+
+	tiles_.resize(num_threads);
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		tiles_[i].filter = factory();
+		if (tiles_[i].filter == NULL) {
+			for (unsigned int j = 0; j < i; ++j) {
+				delete tiles_[j].filter;
+			}
+			throw NullPointerException("FilterTiler: filter factory returned NULL");
+		}
+	}
+
+	for (unsigned int i = 1; i < num_threads; ++i) {
+		workers_.push_back(new Worker(this, i));
+		workers_.back()->start();
+	}
+}
+
+/** Destructor. */
+FilterTiler::~FilterTiler()
+{
+	for (Worker *w : workers_) {
+		w->cancel();
+		w->join();
+		delete w;
+	}
+	for (Tile &t : tiles_) {
+		delete t.filter;
+	}
+}
+
+/** Get number of threads.
+ * @return number of threads, including the calling thread
+ */
+unsigned int
+FilterTiler::num_threads() const
+{
+	return tiles_.size();
+}
+
+/** Get filter instance.
+ * Use this to change parameters of the filter. The same change must be
+ * applied to all instances.
+ * @param i index of the instance, less than num_threads()
+ * @return filter instance
+ */
+Filter *
+FilterTiler::filter(unsigned int i) const
+{
+	if (i >= tiles_.size()) {
+		throw OutOfBoundsException("Invalid filter instance", i, 0, tiles_.size());
+	}
+	return tiles_[i].filter;
+}
+
+int
+FilterTiler::kernel_radius() const
+{
+	return tiles_[0].filter->kernel_radius();
+}
+
+void
+FilterTiler::apply()
+{
+	if ((src[0] == NULL) || (src_roi[0] == NULL)) {
+		throw NullPointerException("FilterTiler: no source buffer set");
+	}
+
+	unsigned char *target     = (dst != NULL) ? dst : src[0];
+	ROI *          target_roi = (dst != NULL) ? dst_roi : src_roi[0];
+
+	const int    radius    = kernel_radius();
+	unsigned int height    = std::min(src_roi[0]->height, target_roi->height);
+	unsigned int min_lines = std::max(MIN_TILE_LINES, 4 * radius);
+	unsigned int num_tiles = 1;
+	if (radius >= 0) {
+		num_tiles = std::min<unsigned int>(tiles_.size(), std::max(1u, height / min_lines));
+	}
+
+	if (num_tiles == 1) {
+		Filter *f = tiles_[0].filter;
+		for (unsigned int b = 0; b < _max_num_buffers; ++b) {
+			if (src[b] != NULL) {
+				f->set_src_buffer(src[b], src_roi[b], ori[b], b);
+			}
+		}
+		f->set_dst_buffer(dst, dst_roi);
+		f->apply();
+		return;
+	}
+
+	bool in_place = false;
+	for (unsigned int b = 0; b < _max_num_buffers; ++b) {
+		in_place = in_place || (src[b] == target);
+	}
+
+	for (unsigned int i = 0; i < num_tiles; ++i) {
+		Tile &t = tiles_[i];
+
+		unsigned int core_begin = (unsigned int)(((size_t)height * i) / num_tiles);
+		unsigned int core_end   = (unsigned int)(((size_t)height * (i + 1)) / num_tiles);
+		unsigned int ext_begin  = (core_begin > (unsigned int)radius) ? core_begin - radius : 0;
+		unsigned int ext_end    = std::min(height, core_end + radius);
+
+		t.src_roi.resize(_max_num_buffers);
+		for (unsigned int b = 0; b < _max_num_buffers; ++b) {
+			if (src_roi[b] != NULL) {
+				t.src_roi[b] = *src_roi[b];
+				t.src_roi[b].start.y += ext_begin;
+				t.src_roi[b].height = ext_end - ext_begin;
+			}
+		}
+		t.dst_roi = *target_roi;
+		t.dst_roi.start.y += ext_begin;
+		t.dst_roi.height = ext_end - ext_begin;
+
+		t.target     = target;
+		t.core_start = target_roi->start.y + core_begin;
+		t.core_end   = target_roi->start.y + core_end;
+		t.error.clear();
+
+		if (radius == 0) {
+			// bands do not overlap, write directly
+			t.dst  = target;
+			t.copy = false;
+		} else {
+			size_t size = (size_t)target_roi->line_step * target_roi->image_height;
+			if (t.scratch.size() < size) {
+				t.scratch.resize(size);
+			}
+			t.dst = &t.scratch[0];
+			// in-place the halo of other bands would be overwritten, copy when all are done
+			t.copy = !in_place;
+		}
+	}
+
+	Barrier barrier(num_tiles);
+	for (unsigned int i = 1; i < num_tiles; ++i) {
+		workers_[i - 1]->wakeup(&barrier);
+	}
+	run_tile(0);
+	barrier.wait();
+
+	for (unsigned int i = 0; i < num_tiles; ++i) {
+		if (!tiles_[i].error.empty()) {
+			throw Exception("FilterTiler: %s failed on band %u: %s",
+			                tiles_[i].filter->name(),
+			                i,
+			                tiles_[i].error.c_str());
+		}
+	}
+
+	if ((radius > 0) && in_place) {
+		for (unsigned int i = 0; i < num_tiles; ++i) {
+			copy_tile(i);
+		}
+	}
+}
+
+/** Filter one band.
+ * @param i index of the band
+ */
+void
+FilterTiler::run_tile(unsigned int i)
+{
+	Tile &t = tiles_[i];
+	try {
+		for (unsigned int b = 0; b < _max_num_buffers; ++b) {
+			if ((src[b] != NULL) && (src_roi[b] != NULL)) {
+				t.filter->set_src_buffer(src[b], &t.src_roi[b], ori[b], b);
+			}
+		}
+		if (t.dst != t.target) {
+			// lines and columns the filter skips must keep their content
+			copy_lines(t.target, &t.scratch[0], t.dst_roi, t.core_start, t.core_end);
+		}
+		t.filter->set_dst_buffer(t.dst, &t.dst_roi);
+		t.filter->apply();
+		if (t.copy) {
+			copy_tile(i);
+		}
+	} catch (Exception &e) {
+		t.error = e.what_no_backtrace();
+	} catch (std::exception &e) {
+		t.error = e.what();
+	}
+}
+
+/** Copy the lines of a band from its scratch buffer to the destination.
+ * Filters may shrink the ROI to fit their kernel, only lines and columns
+ * inside the shrunk ROI are copied.
+ * @param i index of the band
+ */
+void
+FilterTiler::copy_tile(unsigned int i)
+{
+	const Tile &t = tiles_[i];
+	copy_lines(&t.scratch[0], t.target, t.dst_roi, t.core_start, t.core_end);
+}
+
+/** Copy the lines of a band between two buffers.
+ * @param from buffer to copy from
+ * @param to buffer to copy to
+ * @param roi ROI in both buffers, only lines and columns inside are copied
+ * @param first first line to copy
+ * @param last line after the last line to copy
+ */
+void
+FilterTiler::copy_lines(const unsigned char *from,
+                        unsigned char *      to,
+                        const ROI &          roi,
+                        unsigned int         first,
+                        unsigned int         last)
+{
+	first = std::max(first, roi.start.y);
+	last  = std::min(last, roi.start.y + roi.height);
+
+	size_t offset = (size_t)roi.start.x * roi.pixel_step;
+	size_t bytes  = (size_t)roi.width * roi.pixel_step;
+
+	for (unsigned int y = first; y < last; ++y) {
+		size_t line = (size_t)y * roi.line_step + offset;
+		memcpy(to + line, from + line, bytes);
+	}
+}
+
+} // end namespace firevision
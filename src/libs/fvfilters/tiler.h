@@ -0,0 +1,84 @@
+
+/***************************************************************************
+ *  tiler.h - Apply a filter to row bands of a ROI in parallel
+ *
+ *  Created: Thu Oct 15 05:08:14 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FILTER_TILER_H_
+#define _FIREVISION_FILTER_TILER_H_
+
+#include <fvfilters/filter.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace firevision {
+
+class FilterTiler : public Filter
+{
+public:
+	/** Function creating a filter instance for one tile. */
+	typedef std::function<Filter *()> FilterFactory;
+
+	FilterTiler(FilterFactory factory, unsigned int num_threads = 0, unsigned int max_num_buffers = 1);
+	virtual ~FilterTiler();
+
+	unsigned int num_threads() const;
+	Filter *     filter(unsigned int i) const;
+
+	virtual void apply();
+	virtual int  kernel_radius() const;
+
+private:
+	/** Work of one thread. */
+	typedef struct
+	{
+		Filter *                   filter;     /**< filter instance of the tile */
+		std::vector<ROI>           src_roi;    /**< source ROIs of the tile */
+		ROI                        dst_roi;    /**< destination ROI of the tile */
+		unsigned char *            dst;        /**< buffer the filter writes to */
+		unsigned char *            target;     /**< destination buffer of the tiler */
+		std::vector<unsigned char> scratch;    /**< destination for tiles with halo */
+		unsigned int               core_start; /**< first line of the tile in dst */
+		unsigned int               core_end;   /**< line after the tile in dst */
+		bool                       copy;       /**< copy core lines to dst after apply */
+		std::string                error;      /**< error message if the filter failed */
+	} Tile;
+
+	class Worker;
+
+	void run_tile(unsigned int i);
+	void copy_tile(unsigned int i);
+
+	static void copy_lines(const unsigned char *from,
+	                       unsigned char *      to,
+	                       const ROI &          roi,
+	                       unsigned int         first,
+	                       unsigned int         last);
+
+private:
+	std::vector<Tile>     tiles_;
+	std::vector<Worker *> workers_;
+};
+
+} // end namespace firevision
+
+#endif
@@ -53,6 +53,31 @@ ColorModel::~ColorModel()
 {
 }
 
+/** Determine classification of a line of YUV422_PLANAR pixels.
+ * Pixel i of the line has the luminance yp[i] and the chrominance
+ * up[i / 2] and vp[i / 2]. The default implementation calls determine()
+ * for each pixel. Color models which can classify lines more efficiently
+ * should override this method, filters and classifiers processing whole
+ * lines should prefer it over per-pixel calls.
+ * @param yp Y values of the line
+ * @param up U values of the line
+ * @param vp V values of the line
+ * @param num_pixels number of pixels to classify
+ * @param colors upon return contains the classification of each pixel, must
+ * have room for @p num_pixels values
+ */
+void
+ColorModel::determine_line(const unsigned char *yp,
+                           const unsigned char *up,
+                           const unsigned char *vp,
+                           unsigned int         num_pixels,
+                           color_t *            colors) const
+{
+	for (unsigned int i = 0; i < num_pixels; ++i) {
+		colors[i] = determine(yp[i], up[i / 2], vp[i / 2]);
+	}
+}
+
 /** Create image from color model.
  * Create image from color model, useful for debugging and analysing.
  * This method produces a representation of the color model for the full U/V plane
@@ -34,6 +34,11 @@ public:
 	virtual ~ColorModel();
 
 	virtual color_t determine(unsigned int y, unsigned int u, unsigned int v) const = 0;
+	virtual void    determine_line(const unsigned char *yp,
+	                               const unsigned char *up,
+	                               const unsigned char *vp,
+	                               unsigned int         num_pixels,
+	                               color_t *            colors) const;
 
 	virtual const char *get_name() = 0;
 
@@ -130,6 +130,16 @@ ColorModelLookupTable::determine(unsigned int y, unsigned int u, unsigned int v)
 	return colormap_->determine(y, u, v);
 }
 
+void
+ColorModelLookupTable::determine_line(const unsigned char *yp,
+                                      const unsigned char *up,
+                                      const unsigned char *vp,
+                                      unsigned int         num_pixels,
+                                      color_t *            colors) const
+{
+	colormap_->determine_line(yp, up, vp, num_pixels, colors);
+}
+
 const char *
 ColorModelLookupTable::get_name()
 {
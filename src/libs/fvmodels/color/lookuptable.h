@@ -43,6 +43,11 @@ public:
 	virtual ~ColorModelLookupTable();
 
 	virtual color_t determine(unsigned int y, unsigned int u, unsigned int v) const;
+	virtual void    determine_line(const unsigned char *yp,
+	                               const unsigned char *up,
+	                               const unsigned char *vp,
+	                               unsigned int         num_pixels,
+	                               color_t *            colors) const;
 
 	const char * get_name();
 	YuvColormap *get_colormap() const;
@@ -88,6 +88,7 @@ ScanlineBeams::ScanlineBeams(unsigned int image_width,
 	this->image_width        = image_width;
 	this->image_height       = image_height;
 	this->distribute_start_x = distribute_start_x;
+	this->points_valid       = false;
 
 	reset();
 }
@@ -249,6 +250,17 @@ ScanlineBeams::reset()
 	last_beam  = beam_end_pos.size() - 1;
 }
 
+const std::vector<upoint_t> &
+ScanlineBeams::points()
+{
+	// all parameters are fixed at construction
+	if (!points_valid) {
+		collect_points();
+		points_valid = true;
+	}
+	return points_;
+}
+
 const char *
 ScanlineBeams::get_name()
 {
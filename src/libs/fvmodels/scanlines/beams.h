@@ -64,10 +64,13 @@ public:
 	{
 	}
 
+	virtual const std::vector<fawkes::upoint_t> &points();
+
 private:
 	void advance();
 
 	bool _finished;
+	bool points_valid;
 
 	std::vector<fawkes::upoint_t> beam_current_pos;
 	std::vector<fawkes::upoint_t> beam_end_pos;
@@ -52,7 +52,8 @@ ScanlineGrid::ScanlineGrid(unsigned int width,
                            ROI *        roi,
                            bool         horizontal_grid)
 {
-	this->roi = NULL;
+	this->roi    = NULL;
+	points_valid = false;
 	setGridParams(width, height, offset_x, offset_y, roi, horizontal_grid);
 	//reset is done in setGridParams ()
 }
@@ -162,6 +163,16 @@ ScanlineGrid::set_pan_tilt(float pan, float tilt)
 	// ignored
 }
 
+const std::vector<upoint_t> &
+ScanlineGrid::points()
+{
+	if (!points_valid) {
+		collect_points();
+		points_valid = true;
+	}
+	return points_;
+}
+
 void
 ScanlineGrid::set_roi(ROI *roi)
 {
@@ -189,6 +200,7 @@ ScanlineGrid::set_roi(ROI *roi)
 			                                   this->height);
 	}
 
+	points_valid = false;
 	reset();
 }
 
@@ -220,6 +232,7 @@ ScanlineGrid::setOffset(unsigned int offset_x, unsigned int offset_y)
 	this->offset_x = offset_x;
 	this->offset_y = offset_y;
 
+	points_valid = false;
 	reset();
 }
 
@@ -55,6 +55,8 @@ public:
 	virtual void set_pan_tilt(float pan, float tilt);
 	virtual void set_roi(ROI *roi = NULL);
 
+	virtual const std::vector<fawkes::upoint_t> &points();
+
 	void setDimensions(unsigned int width, unsigned int height, ROI *roi = NULL);
 	void setOffset(unsigned int offset_x, unsigned int offset_y);
 	void setGridParams(unsigned int width,
@@ -74,6 +76,7 @@ private:
 
 	bool horizontal_grid;
 	bool more_to_come;
+	bool points_valid;
 
 	fawkes::upoint_t coord;
 	fawkes::upoint_t tmp_coord;
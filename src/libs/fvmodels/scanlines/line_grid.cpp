@@ -88,7 +88,7 @@ ScanlineLineGrid::operator->()
 void
 ScanlineLineGrid::calc_coords()
 {
-	point_list_.clear();
+	points_.clear();
 	bool         more_to_come = true;
 	upoint_t     coord;
 	unsigned int next_px;
@@ -100,7 +100,7 @@ ScanlineLineGrid::calc_coords()
 		coord.x      = roi_->start.x;
 		coord.y      = roi_->start.y
 		          + ((roi_->height - 1) % offset_hor_) / 2; //Center the horizontal lines in the image
-		point_list_.push_back(coord);
+		points_.push_back(coord);
 
 		while (more_to_come) {
 			if (coord.x < (roi_->image_width - next_px)) {
@@ -115,7 +115,7 @@ ScanlineLineGrid::calc_coords()
 			}
 
 			if (more_to_come)
-				point_list_.push_back(coord);
+				points_.push_back(coord);
 		}
 	}
 
@@ -126,7 +126,7 @@ ScanlineLineGrid::calc_coords()
 		coord.x      = roi_->start.x
 		          + ((roi_->width - 1) % offset_ver_) / 2; //Center the vertical lines in the image
 		coord.y = roi_->start.y;
-		point_list_.push_back(coord);
+		points_.push_back(coord);
 
 		while (more_to_come) {
 			if (coord.y < (roi_->image_height - next_px)) {
@@ -141,7 +141,7 @@ ScanlineLineGrid::calc_coords()
 			}
 
 			if (more_to_come)
-				point_list_.push_back(coord);
+				points_.push_back(coord);
 		}
 	}
 
@@ -151,31 +151,39 @@ ScanlineLineGrid::calc_coords()
 upoint_t *
 ScanlineLineGrid::operator++()
 {
-	if (cur_ != point_list_.end())
+	if (cur_ != points_.end())
 		++cur_;
-	return cur_ != point_list_.end() ? &*cur_ : &point_list_.back();
+	return cur_ != points_.end() ? &*cur_ : &points_.back();
 }
 
 upoint_t *
 ScanlineLineGrid::operator++(int)
 {
-	if (cur_ != point_list_.end()) {
+	if (cur_ != points_.end()) {
 		upoint_t *res = &*cur_++;
 		return res;
 	} else
-		return &point_list_.back();
+		return &points_.back();
 }
 
 bool
 ScanlineLineGrid::finished()
 {
-	return cur_ == point_list_.end();
+	return cur_ == points_.end();
 }
 
 void
 ScanlineLineGrid::reset()
 {
-	cur_ = point_list_.begin();
+	cur_ = points_.begin();
+}
+
+const std::vector<upoint_t> &
+ScanlineLineGrid::points()
+{
+	// points are calculated whenever a parameter is set
+	reset();
+	return points_;
 }
 
 const char *
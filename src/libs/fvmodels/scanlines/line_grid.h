@@ -29,7 +29,7 @@
 #include <fvutils/base/types.h>
 #include <fvutils/color/yuv.h>
 
-#include <list>
+#include <vector>
 
 namespace firevision {
 
@@ -37,9 +37,6 @@ class ROI;
 
 class ScanlineLineGrid : public ScanlineModel
 {
-private:
-	typedef std::list<fawkes::upoint_t> point_list_t;
-
 public:
 	ScanlineLineGrid(unsigned int width,
 	                 unsigned int height,
@@ -71,6 +68,8 @@ public:
 	                             ROI *        roi = NULL);
 	virtual void set_roi(ROI *roi = NULL);
 
+	virtual const std::vector<fawkes::upoint_t> &points();
+
 private:
 	unsigned int width_;
 	unsigned int height_;
@@ -80,8 +79,7 @@ private:
 
 	ROI *roi_;
 
-	point_list_t           point_list_;
-	point_list_t::iterator cur_;
+	std::vector<fawkes::upoint_t>::iterator cur_;
 
 	void calc_coords();
 };
@@ -70,6 +70,7 @@ ScanlineRadial::ScanlineRadial(unsigned int width,
 	this->dead_radius      = dead_radius;
 	this->max_radius       = max_radius;
 	this->auto_max_radius  = (max_radius == 0);
+	this->points_valid     = false;
 
 	reset();
 }
@@ -277,6 +278,16 @@ ScanlineRadial::reset()
 	}
 }
 
+const std::vector<upoint_t> &
+ScanlineRadial::points()
+{
+	if (!points_valid) {
+		collect_points();
+		points_valid = true;
+	}
+	return points_;
+}
+
 const char *
 ScanlineRadial::get_name()
 {
@@ -300,6 +311,7 @@ ScanlineRadial::set_center(unsigned int center_x, unsigned int center_y)
 {
 	this->center_x = center_x;
 	this->center_y = center_y;
+	points_valid   = false;
 	reset();
 }
 
@@ -315,6 +327,7 @@ ScanlineRadial::set_radius(unsigned int dead_radius, unsigned int max_radius)
 	this->max_radius      = max_radius;
 	this->dead_radius     = dead_radius;
 	this->auto_max_radius = (max_radius == 0);
+	points_valid          = false;
 
 	reset();
 }
@@ -63,6 +63,8 @@ public:
 	void set_center(unsigned int center_x, unsigned int center_y);
 	void set_radius(unsigned int dead_radius, unsigned int max_radius);
 
+	virtual const std::vector<fawkes::upoint_t> &points();
+
 private:
 	void simpleBubbleSort(unsigned int array[], unsigned int num_elements);
 
@@ -83,6 +85,7 @@ private:
 	unsigned int sector;
 
 	bool done;
+	bool points_valid;
 
 	int x;
 	int y;
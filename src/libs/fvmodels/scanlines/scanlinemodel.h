@@ -35,6 +35,7 @@
 #include <fvutils/base/types.h>
 
 #include <string>
+#include <vector>
 
 namespace firevision {
 
@@ -127,6 +128,42 @@ public:
 	{
 		throw fawkes::NotImplementedException("Setting ROI is not implemented.");
 	}
+
+	/** Get all points of the model.
+   * Iterating over the returned array yields the same points in the same
+   * order as a full iteration of the model, without a virtual call per
+   * point. The model is reset. The default implementation iterates the
+   * model on each call. Models whose points only depend on their
+   * parameters cache the points and regenerate them only after a
+   * parameter changed.
+   * @return points of the model, valid until the next call or until a
+   * parameter of the model is changed
+   */
+	virtual const std::vector<fawkes::upoint_t> &
+	points()
+	{
+		collect_points();
+		return points_;
+	}
+
+protected:
+	/** Collect points by iterating the model.
+   * Stores all points of a full iteration in points_ and resets the model.
+   */
+	void
+	collect_points()
+	{
+		points_.clear();
+		reset();
+		while (!finished()) {
+			points_.push_back(*operator->());
+			operator++();
+		}
+		reset();
+	}
+
+	/** Points of the model, filled by collect_points(). */
+	std::vector<fawkes::upoint_t> points_;
 };
 
 } // end namespace firevision
@@ -80,6 +80,7 @@ ScanlineStar::ScanlineStar(unsigned int   image_width,
 	m_previous_ray = 0;
 
 	m_first_on_ray = true;
+	m_points_valid = false;
 
 	// -- sanity checks --
 	// margin
@@ -174,6 +175,17 @@ ScanlineStar::reset()
 	m_current_point = (*m_point_iter).second;
 }
 
+const std::vector<upoint_t> &
+ScanlineStar::points()
+{
+	// the rays are generated once at construction
+	if (!m_points_valid) {
+		collect_points();
+		m_points_valid = true;
+	}
+	return points_;
+}
+
 const char *
 ScanlineStar::get_name()
 {
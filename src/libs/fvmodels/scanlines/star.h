@@ -66,6 +66,8 @@ public:
 	float        current_angle() const;
 	bool         first_on_ray() const;
 
+	virtual const std::vector<fawkes::upoint_t> &points();
+
 private:
 	void generate_scan_points();
 
@@ -82,6 +84,7 @@ private:
 
 	bool m_first_on_ray;
 	bool m_done;
+	bool m_points_valid;
 
 	fawkes::upoint_t m_current_point;
 	fawkes::upoint_t m_tmp_point;
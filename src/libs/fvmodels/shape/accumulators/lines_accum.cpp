@@ -0,0 +1,236 @@
+
+/***************************************************************************
+ *  lines_accum.cpp - Dense accumulator for Hough line transforms
+ *
+ *  Created: Thu Oct 15 05:24:17 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <fvmodels/shape/accumulators/lines_accum.h>
+#include <utils/math/angle.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace fawkes;
+
+/** Fractional bits of the fixed-point trigonometric tables. */
+#define FIXED_POINT_BITS 16
+
+namespace firevision {
+
+/** @class HtLinesAccumulator <fvmodels/shape/accumulators/lines_accum.h>
+ * Dense accumulator for Hough line transforms.
+ * Lines are represented by their distance r from the origin and their
+ * angle. For each vote r is computed for a fixed set of candidate angles
+ * with fixed-point sine and cosine tables and integer arithmetic, and the
+ * matching cells of a two-dimensional grid are incremented.
+ *
+ * The grid is kept across frames. Each cell remembers the generation in
+ * which it was last written, reset() just starts a new generation, so
+ * cells are cleared lazily when they get their first vote. The cells
+ * voted for in the current generation are recorded, such that nodes can
+ * be retrieved without scanning the whole grid.
+ *
+ * Candidates which round to the same angle in degrees share their cells,
+ * the angle is reported in degrees as by RhtAccumulator. Several
+ * accumulators with the same parameters can collect votes in parallel
+ * and be combined with merge().
+ * @author agent
+ */
+
+/** Constructor.
+ * @param nr_candidates number of candidate angles per vote
+ * @param angle_from angle of the first candidate in rad
+ * @param angle_increment angle between two candidates in rad
+ * @param r_scale distance represented by one cell
+ */
+HtLinesAccumulator::HtLinesAccumulator(unsigned int nr_candidates,
+                                       float        angle_from,
+                                       float        angle_increment,
+                                       int          r_scale)
+{
+	if (r_scale <= 0) {
+		throw OutOfBoundsException("Invalid r scale", r_scale, 1, 0x7FFFFFFF);
+	}
+
+	cos_.resize(nr_candidates);
+	sin_.resize(nr_candidates);
+	slot_.resize(nr_candidates);
+	for (unsigned int i = 0; i < nr_candidates; ++i) {
+		float phi = angle_from + i * angle_increment;
+		cos_[i]   = lrint(cos(phi) * (1 << FIXED_POINT_BITS) / r_scale);
+		sin_[i]   = lrint(sin(phi) * (1 << FIXED_POINT_BITS) / r_scale);
+
+		int                   angle = (int)round(rad2deg(phi));
+		vector<int>::iterator a     = find(slot_angle_.begin(), slot_angle_.end(), angle);
+		slot_[i]                    = a - slot_angle_.begin();
+		if (a == slot_angle_.end()) {
+			slot_angle_.push_back(angle);
+		}
+	}
+
+	r_scale_    = r_scale;
+	generation_ = 0;
+	width_      = 0;
+	height_     = 0;
+	r_bins_     = 0;
+	r_offset_   = 0;
+	num_votes_  = 0;
+	max_        = 0;
+	max_cell_   = 0;
+}
+
+/** Reset accumulator.
+ * Removes all votes. The grid is only reallocated if the image size changes.
+ * @param width width of the image to vote for
+ * @param height height of the image to vote for
+ */
+void
+HtLinesAccumulator::reset(unsigned int width, unsigned int height)
+{
+	if ((width != width_) || (height != height_)) {
+		width_  = width;
+		height_ = height;
+		// one extra cell on each side for rounding
+		r_offset_ = (int)ceil(sqrt((double)width * width + (double)height * height) / r_scale_) + 1;
+		r_bins_   = 2 * r_offset_ + 1;
+		counts_.assign((size_t)r_bins_ * slot_angle_.size(), 0);
+		generations_.assign(counts_.size(), 0);
+		generation_ = 0;
+	}
+
+	if (++generation_ == 0) {
+		// wrapped around, old generations might match again
+		generations_.assign(generations_.size(), 0);
+		generation_ = 1;
+	}
+	touched_.clear();
+	num_votes_ = 0;
+	max_       = 0;
+	max_cell_  = 0;
+}
+
+/** Add votes to a cell.
+ * @param cell index of the cell
+ * @param votes number of votes to add
+ */
+inline void
+HtLinesAccumulator::add(unsigned int cell, unsigned int votes)
+{
+	if (generations_[cell] != generation_) {
+		generations_[cell] = generation_;
+		counts_[cell]      = 0;
+		touched_.push_back(cell);
+	}
+	counts_[cell] += votes;
+	if (counts_[cell] > max_) {
+		max_      = counts_[cell];
+		max_cell_ = cell;
+	}
+}
+
+/** Vote for all lines through a pixel.
+ * Adds one vote for each candidate angle.
+ * @param x X coordinate of the pixel, less than the width passed to reset()
+ * @param y Y coordinate of the pixel, less than the height passed to reset()
+ */
+void
+HtLinesAccumulator::vote(unsigned int x, unsigned int y)
+{
+	const int64_t half = 1 << (FIXED_POINT_BITS - 1);
+
+	for (unsigned int i = 0; i < cos_.size(); ++i) {
+		int r = (int)((x * cos_[i] + y * sin_[i] + half) >> FIXED_POINT_BITS);
+		add(slot_[i] * r_bins_ + (r + r_offset_), 1);
+	}
+	num_votes_ += cos_.size();
+}
+
+/** Add the votes of another accumulator.
+ * @param acc accumulator to merge, must have been created with the same
+ * parameters and reset for the same image size
+ */
+void
+HtLinesAccumulator::merge(const HtLinesAccumulator &acc)
+{
+	if ((acc.counts_.size() != counts_.size()) || (acc.cos_ != cos_) || (acc.sin_ != sin_)) {
+		throw TypeMismatchException("Accumulators to merge have different parameters");
+	}
+	for (unsigned int cell : acc.touched_) {
+		add(cell, acc.counts_[cell]);
+	}
+	num_votes_ += acc.num_votes_;
+}
+
+/** Get cell with the most votes.
+ * @param r upon return contains the distance of the line in cells
+ * @param angle upon return contains the angle of the line in degrees
+ * @return number of votes of the cell
+ */
+int
+HtLinesAccumulator::getMax(int &r, int &angle) const
+{
+	if (max_ == 0) {
+		r = angle = 0;
+	} else {
+		r     = (int)(max_cell_ % r_bins_) - r_offset_;
+		angle = slot_angle_[max_cell_ / r_bins_];
+	}
+	return max_;
+}
+
+/** Get number of votes.
+ * @return number of votes
+ */
+unsigned int
+HtLinesAccumulator::getNumVotes() const
+{
+	return num_votes_;
+}
+
+/** Get nodes.
+ * Each node consists of the distance in cells, the angle in degrees, 0
+ * and the number of votes, the same layout as of RhtAccumulator::getNodes().
+ * Nodes are sorted by distance and angle.
+ * @param min_votes minimum number of votes of a node
+ * @return nodes, the caller takes ownership
+ */
+vector<vector<int>> *
+HtLinesAccumulator::getNodes(int min_votes) const
+{
+	vector<vector<int>> *rv = new vector<vector<int>>();
+
+	for (unsigned int cell : touched_) {
+		if ((int)counts_[cell] >= min_votes) {
+			vector<int> node(4);
+			node[0] = (int)(cell % r_bins_) - r_offset_;
+			node[1] = slot_angle_[cell / r_bins_];
+			node[2] = 0;
+			node[3] = counts_[cell];
+			rv->push_back(node);
+		}
+	}
+	sort(rv->begin(), rv->end());
+
+	return rv;
+}
+
+} // end namespace firevision
@@ -0,0 +1,75 @@
+
+/***************************************************************************
+ *  lines_accum.h - Dense accumulator for Hough line transforms
+ *
+ *  Created: Thu Oct 15 05:24:17 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_MODELS_SHAPE_ACCUMULATORS_LINES_ACCUM_H_
+#define _FIREVISION_MODELS_SHAPE_ACCUMULATORS_LINES_ACCUM_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace firevision {
+
+class HtLinesAccumulator
+{
+public:
+	HtLinesAccumulator(unsigned int nr_candidates,
+	                   float        angle_from,
+	                   float        angle_increment,
+	                   int          r_scale);
+
+	void reset(unsigned int width, unsigned int height);
+	void vote(unsigned int x, unsigned int y);
+	void merge(const HtLinesAccumulator &acc);
+
+	int                            getMax(int &r, int &angle) const;
+	unsigned int                   getNumVotes() const;
+	std::vector<std::vector<int>> *getNodes(int min_votes) const;
+
+private:
+	void add(unsigned int cell, unsigned int votes);
+
+private:
+	std::vector<int64_t>      cos_;
+	std::vector<int64_t>      sin_;
+	std::vector<unsigned int> slot_;
+	std::vector<int>          slot_angle_;
+
+	std::vector<unsigned int> counts_;
+	std::vector<uint32_t>     generations_;
+	std::vector<unsigned int> touched_;
+	uint32_t                  generation_;
+
+	int          r_scale_;
+	unsigned int width_;
+	unsigned int height_;
+	unsigned int r_bins_;
+	int          r_offset_;
+
+	unsigned int num_votes_;
+	unsigned int max_;
+	unsigned int max_cell_;
+};
+
+} // end namespace firevision
+
+#endif
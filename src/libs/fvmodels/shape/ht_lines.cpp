@@ -23,9 +23,10 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <core/threading/barrier.h>
+#include <core/threading/thread.h>
 #include <fvmodels/shape/ht_lines.h>
 #include <sys/time.h>
-#include <utils/math/angle.h>
 
 #include <cmath>
 
@@ -36,8 +37,42 @@ namespace firevision {
 
 #define TEST_IF_IS_A_PIXEL(x) ((x) > 230)
 
+/// @cond INTERNAL
+class HtLinesModel::Worker : public Thread
+{
+public:
+	Worker(HtLinesModel *model, unsigned int slice)
+	: Thread("HtLinesModelWorker", Thread::OPMODE_WAITFORWAKEUP)
+	{
+		set_name("HtLinesModelWorker %u", slice);
+		model_ = model;
+		slice_ = slice;
+	}
+
+	virtual void
+	loop()
+	{
+		model_->vote(slice_);
+	}
+
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	HtLinesModel *model_;
+	unsigned int  slice_;
+};
+/// @endcond
+
 /** @class HtLinesModel <fvmodels/shape/ht_lines.h>
  * Hough-Transform line matcher.
+ * Votes are collected in a HtLinesAccumulator. With more than one thread
+ * the edge pixels are split into slices, each thread votes for its slice
+ * into its own accumulator, and the accumulators are merged afterwards.
  */
 
 /** Constructor.
@@ -56,13 +91,15 @@ namespace firevision {
   * @param min_votes the minimum number of votes a point in the hough space has to have before it
   *                  is considered to be a line. The number may actually be higher if min_votes_ratio
   *                  is set too high (set min_votes_ration to 0 to use only min_votes)
+  * @param num_threads number of threads voting, including the calling thread
   */
 HtLinesModel::HtLinesModel(unsigned int nr_candidates,
                            float        angle_from,
                            float        angle_range,
                            int          r_scale,
                            float        min_votes_ratio,
-                           int          min_votes)
+                           int          min_votes,
+                           unsigned int num_threads)
 {
 	RHT_NR_CANDIDATES = nr_candidates;
 
@@ -74,36 +111,75 @@ HtLinesModel::HtLinesModel(unsigned int nr_candidates,
 	RHT_ANGLE_FROM      = angle_from - (floor(angle_from / (2 * M_PI)) * (2 * M_PI));
 	RHT_ANGLE_RANGE     = angle_range - (floor(angle_range / (2 * M_PI)) * (2 * M_PI));
 	RHT_ANGLE_INCREMENT = RHT_ANGLE_RANGE / RHT_NR_CANDIDATES;
+
+	accumulator =
+	  new HtLinesAccumulator(RHT_NR_CANDIDATES, RHT_ANGLE_FROM, RHT_ANGLE_INCREMENT, RHT_R_SCALE);
+
+	for (unsigned int i = 1; i < num_threads; ++i) {
+		slice_accumulators_.push_back(
+		  new HtLinesAccumulator(RHT_NR_CANDIDATES, RHT_ANGLE_FROM, RHT_ANGLE_INCREMENT, RHT_R_SCALE));
+		workers_.push_back(new Worker(this, i));
+		workers_.back()->start();
+	}
 }
 
 /** Destructor. */
 HtLinesModel::~HtLinesModel(void)
 {
+	for (Worker *w : workers_) {
+		w->cancel();
+		w->join();
+		delete w;
+	}
+	for (HtLinesAccumulator *a : slice_accumulators_) {
+		delete a;
+	}
+	delete accumulator;
 	m_Lines.clear();
 }
 
+/** Vote for the edge pixels of a slice.
+ * Slice 0 votes into the accumulator of the model, the others into
+ * their own accumulator.
+ * @param slice index of the slice, 0 up to the number of workers
+ */
+void
+HtLinesModel::vote(unsigned int slice)
+{
+	HtLinesAccumulator *acc = (slice == 0) ? accumulator : slice_accumulators_[slice - 1];
+
+	size_t num_slices = workers_.size() + 1;
+	size_t begin      = (pixels_.size() * slice) / num_slices;
+	size_t end        = (pixels_.size() * (slice + 1)) / num_slices;
+
+	// last pixel first, ties in the accumulator are decided as before
+	for (size_t i = end; i > begin; --i) {
+		acc->vote(pixels_[i - 1].x, pixels_[i - 1].y);
+	}
+}
+
 int
 HtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 {
 	unsigned char *buffer = roi->get_roi_buffer_start(buf);
 
 	// clear the accumulator
-	accumulator.reset();
+	accumulator->reset(roi->width, roi->height);
 
 	// clear all the remembered lines
 	m_Lines.clear();
 
 	// First, find all the edge pixels,
 	// and store them in the 'pixels' vector.
-	unsigned char *  line_start = buffer;
-	unsigned int     x, y;
-	vector<upoint_t> pixels;
+	unsigned char *line_start = buffer;
+	unsigned int   x, y;
+	pixels_.clear();
 
 	for (y = 0; y < roi->height; ++y) {
 		for (x = 0; x < roi->width; ++x) {
 			if (TEST_IF_IS_A_PIXEL(*buffer)) {
 				upoint_t pt = {x, y};
-				pixels.push_back(pt);
+				pixels_.push_back(pt);
 			}
 			// NOTE: this assumes roi->pixel_step == 1
 			++buffer;
@@ -112,32 +188,31 @@ HtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 		buffer = line_start;
 	}
 
-	// Then perform the RHT algorithm
-	upoint_t                   p;
-	float                      r, phi; // used for line representation
-	vector<upoint_t>::iterator pos;
-	if (pixels.size() == 0) {
+	// Then perform the HT algorithm
+	if (pixels_.size() == 0) {
 		// No edge pixels found => no lines
 		return 0;
 	}
 
-	while (pixels.size() > 0) {
-		p = pixels.back();
-		pixels.pop_back();
-
-		for (unsigned int i = 0; i < RHT_NR_CANDIDATES; ++i) {
-			phi = RHT_ANGLE_FROM + i * RHT_ANGLE_INCREMENT;
-			r   = p.x * cos(phi) + p.y * sin(phi);
-
-			int angle = (int)round(fawkes::rad2deg(phi));
+	if (workers_.empty()) {
+		vote(0);
+	} else {
+		Barrier barrier(workers_.size() + 1);
+		for (unsigned int i = 0; i < workers_.size(); ++i) {
+			slice_accumulators_[i]->reset(roi->width, roi->height);
+			workers_[i]->wakeup(&barrier);
+		}
+		vote(0);
+		barrier.wait();
 
-			accumulator.accumulate((int)round(r / RHT_R_SCALE), angle, 0);
+		for (HtLinesAccumulator *a : slice_accumulators_) {
+			accumulator->merge(*a);
 		}
 	}
 
 	// Find the most dense region, and decide on the lines
-	int max, r_max, phi_max, any_max;
-	max = accumulator.getMax(r_max, phi_max, any_max);
+	int max, r_max, phi_max;
+	max = accumulator->getMax(r_max, phi_max);
 
 	roi_width  = roi->width;
 	roi_height = roi->height;
@@ -191,7 +266,7 @@ HtLinesModel::getMostLikelyShape(void) const
 vector<LineShape> *
 HtLinesModel::getShapes()
 {
-	int votes = (int)(accumulator.getNumVotes() * (float)RHT_MIN_VOTES_RATIO);
+	int votes = (int)(accumulator->getNumVotes() * (float)RHT_MIN_VOTES_RATIO);
 
 	if (RHT_MIN_VOTES > votes) {
 		votes = RHT_MIN_VOTES;
@@ -199,7 +274,7 @@ HtLinesModel::getShapes()
 
 	vector<LineShape> *rv = new vector<LineShape>();
 
-	vector<vector<int>> *         rht_nodes = accumulator.getNodes(votes);
+	vector<vector<int>> *         rht_nodes = accumulator->getNodes(votes);
 	vector<vector<int>>::iterator node_it;
 
 	LineShape l(roi_width, roi_height);
@@ -212,6 +287,7 @@ HtLinesModel::getShapes()
 		l.calcPoints();
 		rv->push_back(l);
 	}
+	delete rht_nodes;
 
 	return rv;
 }
@@ -25,7 +25,7 @@
 #ifndef _FIREVISION_MODELS_SHAPE_HT_LINE_H_
 #define _FIREVISION_MODELS_SHAPE_HT_LINE_H_
 
-#include <fvmodels/shape/accumulators/ht_accum.h>
+#include <fvmodels/shape/accumulators/lines_accum.h>
 #include <fvmodels/shape/line.h>
 #include <fvutils/base/types.h>
 
@@ -41,7 +41,7 @@ class HtLinesModel : public ShapeModel
 {
 private:
 	std::vector<LineShape> m_Lines;
-	RhtAccumulator         accumulator;
+	HtLinesAccumulator *   accumulator;
 
 public:
 	HtLinesModel(unsigned int nr_candidates   = 40,
@@ -49,7 +49,8 @@ public:
 	             float        angle_range     = 2 * M_PI,
 	             int          r_scale         = 1,
 	             float        min_votes_ratio = 0.2f,
-	             int          min_votes       = -1);
+	             int          min_votes       = -1,
+	             unsigned int num_threads     = 1);
 	virtual ~HtLinesModel(void);
 
 	std::string
@@ -63,6 +64,11 @@ public:
 	LineShape *             getMostLikelyShape(void) const;
 	std::vector<LineShape> *getShapes();
 
+private:
+	class Worker;
+
+	void vote(unsigned int slice);
+
 private:
 	unsigned int RHT_NR_CANDIDATES;
 	float        RHT_ANGLE_INCREMENT;
@@ -78,6 +84,10 @@ private:
 
 	unsigned int roi_width;
 	unsigned int roi_height;
+
+	std::vector<fawkes::upoint_t>     pixels_;
+	std::vector<HtLinesAccumulator *> slice_accumulators_;
+	std::vector<Worker *>             workers_;
 };
 
 } // end namespace firevision
@@ -25,7 +25,6 @@
 
 #include <fvmodels/shape/rht_lines.h>
 #include <sys/time.h>
-#include <utils/math/angle.h>
 
 using namespace std;
 using namespace fawkes;
@@ -61,12 +60,16 @@ RhtLinesModel::RhtLinesModel(float        max_time,
 	RHT_ANGLE_FROM      = angle_from - (floor(angle_from / (2 * M_PI)) * (2 * M_PI));
 	RHT_ANGLE_RANGE     = angle_range - (floor(angle_range / (2 * M_PI)) * (2 * M_PI));
 	RHT_ANGLE_INCREMENT = RHT_ANGLE_RANGE / RHT_NR_CANDIDATES;
+
+	accumulator =
+	  new HtLinesAccumulator(RHT_NR_CANDIDATES, RHT_ANGLE_FROM, RHT_ANGLE_INCREMENT, RHT_R_SCALE);
 }
 
 /** Destructor. */
 RhtLinesModel::~RhtLinesModel(void)
 {
 	m_Lines.clear();
+	delete accumulator;
 }
 
 /**************************************************************
@@ -80,7 +83,7 @@ RhtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 	struct timeval start, now;
 
 	// clear the accumulator
-	accumulator.reset();
+	accumulator->reset(roi->width, roi->height);
 
 	// clear all the remembered lines
 	m_Lines.clear();
@@ -108,7 +111,6 @@ RhtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 
 	// Then perform the RHT algorithm
 	upoint_t                   p;
-	float                      r, phi; // used for line representation
 	vector<upoint_t>::iterator pos;
 	int                        num_iter = 0;
 	if (pixels.size() == 0) {
@@ -124,14 +126,7 @@ RhtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 			p      = *pos;
 			pixels.erase(pos);
 
-			for (unsigned int i = 0; i < RHT_NR_CANDIDATES; ++i) {
-				phi = RHT_ANGLE_FROM + i * RHT_ANGLE_INCREMENT;
-				r   = p.x * cos(phi) + p.y * sin(phi);
-
-				int angle = (int)round(fawkes::rad2deg(phi));
-
-				accumulator.accumulate((int)round(r / RHT_R_SCALE), angle, 0);
-			}
+			accumulator->vote(p.x, p.y);
 
 			gettimeofday(&now, NULL);
 
@@ -148,8 +143,8 @@ RhtLinesModel::parseImage(unsigned char *buf, ROI *roi)
 	} while ((++num_iter < RHT_MAX_ITER) && (f_diff_sec < RHT_MAX_TIME));
 
 	// Find the most dense region, and decide on the lines
-	int max, r_max, phi_max, any_max;
-	max = accumulator.getMax(r_max, phi_max, any_max);
+	int max, r_max, phi_max;
+	max = accumulator->getMax(r_max, phi_max);
 
 	roi_width  = roi->width;
 	roi_height = roi->height;
@@ -203,7 +198,7 @@ RhtLinesModel::getMostLikelyShape(void) const
 vector<LineShape> *
 RhtLinesModel::getShapes()
 {
-	int votes = (int)(accumulator.getNumVotes() * (float)RHT_MIN_VOTES_RATIO);
+	int votes = (int)(accumulator->getNumVotes() * (float)RHT_MIN_VOTES_RATIO);
 
 	if (RHT_MIN_VOTES > votes) {
 		votes = RHT_MIN_VOTES;
@@ -211,7 +206,7 @@ RhtLinesModel::getShapes()
 
 	vector<LineShape> *rv = new vector<LineShape>();
 
-	vector<vector<int>> *         rht_nodes = accumulator.getNodes(votes);
+	vector<vector<int>> *         rht_nodes = accumulator->getNodes(votes);
 	vector<vector<int>>::iterator node_it;
 
 	LineShape l(roi_width, roi_height);
@@ -224,6 +219,7 @@ RhtLinesModel::getShapes()
 		l.calcPoints();
 		rv->push_back(l);
 	}
+	delete rht_nodes;
 
 	return rv;
 }
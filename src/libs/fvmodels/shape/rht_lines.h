@@ -25,7 +25,7 @@
 #ifndef _FIREVISION_MODELS_SHAPE_RHT_LINE_H_
 #define _FIREVISION_MODELS_SHAPE_RHT_LINE_H_
 
-#include <fvmodels/shape/accumulators/ht_accum.h>
+#include <fvmodels/shape/accumulators/lines_accum.h>
 #include <fvmodels/shape/line.h>
 #include <fvutils/base/types.h>
 
@@ -41,7 +41,7 @@ class RhtLinesModel : public ShapeModel
 {
 private:
 	std::vector<LineShape> m_Lines;
-	RhtAccumulator         accumulator;
+	HtLinesAccumulator *   accumulator;
 
 public:
 	/** Creates a new RhtLinesModel instance
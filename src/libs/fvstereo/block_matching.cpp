@@ -0,0 +1,680 @@
+
+/***************************************************************************
+ *  block_matching.cpp - Block matching stereo processor
+ *
+ *  Created: Thu Oct 15 05:53:19 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <fvfilters/rectify.h>
+#include <fvstereo/block_matching.h>
+#include <fvutils/base/roi.h>
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/color/simd.h>
+#include <fvutils/rectification/rectinfo_bilinear_block.h>
+#include <fvutils/rectification/rectinfo_block.h>
+#include <fvutils/rectification/rectinfo_lut_block.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/** @class BlockMatchingStereoProcessor <fvstereo/block_matching.h>
+ * Block matching stereo processor.
+ * Disparities are determined by comparing square windows of the
+ * luminance planes of a left and a right image along the lines with the
+ * sum of absolute differences. The left image is the reference image,
+ * a pixel with disparity d in the left image corresponds to the pixel d
+ * columns further left in the right image. Both images must be
+ * rectified, either already when they are passed in or by rectification
+ * info blocks as created for FilterRectify, e.g. with bb2rectlut.
+ *
+ * Only the regions passed to calculate_disparity() are processed, and
+ * get_xyz() computes the disparity of a pixel on demand if it has not
+ * been calculated for the current frame. Rectification is done lazily
+ * for the lines needed. Hence a few regions or points cost only a
+ * fraction of a full frame. The window sums are updated incrementally
+ * as the window moves, the column sums of all disparities are updated
+ * with vector instructions (see absdiff_accumulate_simd()).
+ *
+ * Matches are rejected if another disparity, not adjacent to the best,
+ * has a cost within the uniqueness ratio of the best cost, which
+ * removes most matches in regions without texture. Disparities are
+ * stored as 16 bit values with DISPARITY_FRAC_BITS fractional bits, the
+ * fraction is determined by fitting a parabola to the costs around the
+ * best match if subpixel interpolation is enabled.
+ *
+ * A frame is processed by setting the buffers, calling
+ * preprocess_stereo() and then calculate_disparity() and get_xyz() as
+ * needed.
+ * @author agent
+ */
+
+/** Disparity of pixels which have not been calculated for the current frame. */
+const uint16_t BlockMatchingStereoProcessor::DISPARITY_UNKNOWN = 0xFFFF;
+/** Disparity of pixels without a reliable match. */
+const uint16_t BlockMatchingStereoProcessor::DISPARITY_INVALID = 0xFFFE;
+/** Number of fractional bits of disparities. */
+const unsigned int BlockMatchingStereoProcessor::DISPARITY_FRAC_BITS = 4;
+
+/** Constructor.
+ * @param width width of the images
+ * @param height height of the images
+ * @param focal_length focal length of the rectified images in pixels
+ * @param baseline distance between the cameras in meters
+ * @param center_x X coordinate of the principal point of the rectified
+ * images in pixels
+ * @param center_y Y coordinate of the principal point of the rectified
+ * images in pixels
+ */
+BlockMatchingStereoProcessor::BlockMatchingStereoProcessor(unsigned int width,
+                                                           unsigned int height,
+                                                           float        focal_length,
+                                                           float        baseline,
+                                                           float        center_x,
+                                                           float        center_y)
+{
+	if ((width == 0) || (height == 0)) {
+		throw IllegalArgumentException("BlockMatchingStereoProcessor: invalid image size");
+	}
+	if ((focal_length <= 0.f) || (baseline <= 0.f)) {
+		throw IllegalArgumentException("BlockMatchingStereoProcessor: invalid camera parameters");
+	}
+
+	width_        = width;
+	height_       = height;
+	focal_length_ = focal_length;
+	baseline_     = baseline;
+	center_x_     = center_x;
+	center_y_     = center_y;
+
+	tilt_    = 0.f;
+	trans_x_ = 0.f;
+	trans_y_ = 0.f;
+	trans_z_ = 0.f;
+
+	min_disparity_    = 0;
+	max_disparity_    = 63;
+	mask_size_        = 7;
+	subpixel_         = true;
+	uniqueness_ratio_ = 10;
+
+	left_      = NULL;
+	right_     = NULL;
+	rib_left_  = NULL;
+	rib_right_ = NULL;
+
+	rectified_.assign(height_, false);
+	disparity_.assign((size_t)width_ * height_, DISPARITY_UNKNOWN);
+
+	yuv_left_  = NULL;
+	yuv_right_ = NULL;
+}
+
+/** Destructor. */
+BlockMatchingStereoProcessor::~BlockMatchingStereoProcessor()
+{
+	free(yuv_left_);
+	free(yuv_right_);
+}
+
+/** Set image buffers.
+ * Call preprocess_stereo() afterwards to start processing the images.
+ * @param left left image, YUV422_PLANAR or a single luminance plane
+ * unless calculate_yuv() is used
+ * @param right right image of the same format
+ */
+void
+BlockMatchingStereoProcessor::set_buffers(unsigned char *left, unsigned char *right)
+{
+	left_  = left;
+	right_ = right;
+}
+
+/** Set rectification info blocks.
+ * The images are rectified with the given blocks before matching. LUT
+ * and bilinear blocks are supported efficiently, any other block is
+ * queried pixel by pixel.
+ * @param left rectification info for the left image, NULL if the left
+ * image is already rectified
+ * @param right rectification info for the right image, NULL if the right
+ * image is already rectified
+ */
+void
+BlockMatchingStereoProcessor::set_rectification(RectificationInfoBlock *left,
+                                                RectificationInfoBlock *right)
+{
+	RectificationInfoBlock *ribs[2] = {left, right};
+	for (RectificationInfoBlock *rib : ribs) {
+		RectificationLutInfoBlock *     rlib = dynamic_cast<RectificationLutInfoBlock *>(rib);
+		RectificationBilinearInfoBlock *rbib = dynamic_cast<RectificationBilinearInfoBlock *>(rib);
+		if ((rlib && ((rlib->pixel_width() != width_) || (rlib->pixel_height() != height_)))
+		    || (rbib && ((rbib->pixel_width() != width_) || (rbib->pixel_height() != height_)))) {
+			throw IllegalArgumentException("Rectification LUT and image sizes do not match");
+		}
+	}
+
+	rib_left_  = left;
+	rib_right_ = right;
+	rect_left_.resize(left ? (size_t)width_ * height_ : 0);
+	rect_right_.resize(right ? (size_t)width_ * height_ : 0);
+	rectified_.assign(height_, false);
+}
+
+/** Set pose of the camera on the robot.
+ * The pose is used by get_world_xyz().
+ * @param tilt angle in rad by which the camera is tilted downwards
+ * @param trans_x X coordinate of the left camera in the robot coordinate system
+ * @param trans_y Y coordinate of the left camera in the robot coordinate system
+ * @param trans_z Z coordinate of the left camera in the robot coordinate system
+ */
+void
+BlockMatchingStereoProcessor::set_camera_pose(float tilt,
+                                              float trans_x,
+                                              float trans_y,
+                                              float trans_z)
+{
+	tilt_    = tilt;
+	trans_x_ = trans_x;
+	trans_y_ = trans_y;
+	trans_z_ = trans_z;
+}
+
+/** Set disparity range.
+ * Takes effect for the next frame.
+ * @param min minimum disparity in pixels
+ * @param max maximum disparity in pixels
+ */
+void
+BlockMatchingStereoProcessor::set_disparity_range(unsigned int min, unsigned int max)
+{
+	const unsigned int limit =
+	  std::min(width_ - 1, (unsigned int)(DISPARITY_INVALID >> DISPARITY_FRAC_BITS) - 1);
+	if (max > limit) {
+		throw OutOfBoundsException("Invalid maximum disparity", max, min, limit);
+	}
+	if (min > max) {
+		throw OutOfBoundsException("Invalid minimum disparity", min, 0, max);
+	}
+	min_disparity_ = min;
+	max_disparity_ = max;
+}
+
+/** Set size of the matching window.
+ * Takes effect for the next frame.
+ * @param mask_size width and height of the window, an odd number from 1
+ * to 15
+ */
+void
+BlockMatchingStereoProcessor::set_stereo_masksize(unsigned int mask_size)
+{
+	// the window sums must fit into 16 bits
+	if ((mask_size % 2 == 0) || (mask_size > 15)) {
+		throw OutOfBoundsException("Invalid mask size", mask_size, 1, 15);
+	}
+	mask_size_ = mask_size;
+}
+
+/** Enable or disable subpixel interpolation.
+ * @param enabled true to interpolate disparities with subpixel precision
+ */
+void
+BlockMatchingStereoProcessor::set_subpixel_interpolation(bool enabled)
+{
+	subpixel_ = enabled;
+}
+
+/** Set uniqueness ratio.
+ * @param percent margin in percent by which the best match must be
+ * better than any other match which is not adjacent, 0 to disable the
+ * check
+ */
+void
+BlockMatchingStereoProcessor::set_uniqueness_ratio(unsigned int percent)
+{
+	uniqueness_ratio_ = percent;
+}
+
+/** Get minimum disparity.
+ * @return minimum disparity in pixels
+ */
+unsigned int
+BlockMatchingStereoProcessor::disparity_range_min() const
+{
+	return min_disparity_;
+}
+
+/** Get maximum disparity.
+ * @return maximum disparity in pixels
+ */
+unsigned int
+BlockMatchingStereoProcessor::disparity_range_max() const
+{
+	return max_disparity_;
+}
+
+/** Get size of the matching window.
+ * @return width and height of the window
+ */
+unsigned int
+BlockMatchingStereoProcessor::stereo_masksize() const
+{
+	return mask_size_;
+}
+
+/** Check if subpixel interpolation is enabled.
+ * @return true if disparities are interpolated with subpixel precision
+ */
+bool
+BlockMatchingStereoProcessor::subpixel_interpolation() const
+{
+	return subpixel_;
+}
+
+/** Get uniqueness ratio.
+ * @return margin in percent by which the best match must be better than
+ * any other match which is not adjacent
+ */
+unsigned int
+BlockMatchingStereoProcessor::uniqueness_ratio() const
+{
+	return uniqueness_ratio_;
+}
+
+/** Start processing a new frame.
+ * Resets the disparities and rectified lines of the previous frame.
+ */
+void
+BlockMatchingStereoProcessor::preprocess_stereo()
+{
+	if ((left_ == NULL) || (right_ == NULL)) {
+		throw NullPointerException("BlockMatchingStereoProcessor: buffers not set");
+	}
+	rectified_.assign(height_, false);
+	std::fill(disparity_.begin(), disparity_.end(), DISPARITY_UNKNOWN);
+}
+
+/** Rectify lines of both images which have not been rectified yet.
+ * @param first first line to rectify
+ * @param last line after the last line to rectify
+ */
+void
+BlockMatchingStereoProcessor::rectify_lines(unsigned int first, unsigned int last)
+{
+	for (unsigned int y = first; y < last; ++y) {
+		if (!rectified_[y]) {
+			rectify_line(y, true);
+			rectify_line(y, false);
+			rectified_[y] = true;
+		}
+	}
+}
+
+/** Rectify a line of the luminance plane.
+ * @param y line to rectify
+ * @param left true to rectify the left image, false for the right image
+ */
+void
+BlockMatchingStereoProcessor::rectify_line(unsigned int y, bool left)
+{
+	RectificationInfoBlock *rib = left ? rib_left_ : rib_right_;
+	if (rib == NULL) {
+		return;
+	}
+	const unsigned char *src = left ? left_ : right_;
+	unsigned char *      dst = &(left ? rect_left_ : rect_right_)[(size_t)y * width_];
+
+	RectificationLutInfoBlock *     rlib = dynamic_cast<RectificationLutInfoBlock *>(rib);
+	RectificationBilinearInfoBlock *rbib = dynamic_cast<RectificationBilinearInfoBlock *>(rib);
+
+	if (rlib) {
+		const rectinfo_lut_16x16_entry_t *lut = rlib->lut_data() + (size_t)y * width_;
+		for (unsigned int x = 0; x < width_; ++x) {
+			dst[x] = src[lut[x].y * width_ + lut[x].x];
+		}
+	} else if (rbib) {
+		const rectinfo_lut_bilinear_entry_t *lut = rbib->lut_data() + (size_t)y * width_;
+		remap_bilinear_simd(src, width_, (const uint16_t *)lut, dst, width_);
+	} else {
+		uint16_t ux = 0, uy = 0;
+		for (unsigned int x = 0; x < width_; ++x) {
+			rib->mapping(x, y, &ux, &uy);
+			dst[x] = src[uy * width_ + ux];
+		}
+	}
+}
+
+/** Get rectified line.
+ * @param y line to get, must have been rectified
+ * @param left true to get the line of the left image, false for the right image
+ * @return line of the rectified luminance plane
+ */
+const unsigned char *
+BlockMatchingStereoProcessor::rectified_line(unsigned int y, bool left) const
+{
+	if (left) {
+		return rib_left_ ? &rect_left_[(size_t)y * width_] : left_ + (size_t)y * width_;
+	} else {
+		return rib_right_ ? &rect_right_[(size_t)y * width_] : right_ + (size_t)y * width_;
+	}
+}
+
+/** Add or subtract a line to the column sums of all disparities.
+ * @param y line to accumulate
+ * @param first_col first column of the column sums
+ * @param num_cols number of column sums per disparity
+ * @param subtract true to subtract the line, false to add it
+ */
+void
+BlockMatchingStereoProcessor::accumulate_line(unsigned int y,
+                                              unsigned int first_col,
+                                              unsigned int num_cols,
+                                              bool         subtract)
+{
+	const unsigned char *l = rectified_line(y, true);
+	const unsigned char *r = rectified_line(y, false);
+
+	for (unsigned int d = min_disparity_; d <= max_disparity_; ++d) {
+		// columns left of d have no partner in the right image
+		unsigned int first = std::max(first_col, d);
+		if (first >= first_col + num_cols) {
+			break;
+		}
+		uint16_t *sums = &column_sums_[(size_t)(d - min_disparity_) * num_cols + (first - first_col)];
+		absdiff_accumulate_simd(l + first, r + first - d, sums, first_col + num_cols - first, subtract);
+	}
+}
+
+/** Match a region.
+ * The whole window of each pixel in the region must be within the
+ * image, and the leftmost pixel must allow for the minimum disparity.
+ * @param x0 first column
+ * @param y0 first line
+ * @param x1 column after the last column
+ * @param y1 line after the last line
+ */
+void
+BlockMatchingStereoProcessor::match(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1)
+{
+	const unsigned int r         = mask_size_ / 2;
+	const unsigned int num_d     = max_disparity_ - min_disparity_ + 1;
+	const unsigned int num_pix   = x1 - x0;
+	const unsigned int first_col = x0 - r;
+	const unsigned int num_cols  = num_pix + 2 * r;
+
+	rectify_lines(y0 - r, y1 + r);
+
+	column_sums_.assign((size_t)num_d * num_cols, 0);
+	costs_.resize((size_t)num_d * num_pix);
+
+	for (unsigned int y = y0 - r; y < y0 + r; ++y) {
+		accumulate_line(y, first_col, num_cols, false);
+	}
+
+	for (unsigned int y = y0; y < y1; ++y) {
+		// move the window down by one line
+		accumulate_line(y + r, first_col, num_cols, false);
+		if (y > y0) {
+			accumulate_line(y - r - 1, first_col, num_cols, true);
+		}
+
+		for (unsigned int i = 0; i < num_d; ++i) {
+			const unsigned int d    = min_disparity_ + i;
+			const uint16_t *   cs   = &column_sums_[(size_t)i * num_cols];
+			uint16_t *         cost = &costs_[(size_t)i * num_pix];
+
+			unsigned int sum = 0;
+			for (unsigned int c = 0; c < 2 * r; ++c) {
+				sum += cs[c];
+			}
+			for (unsigned int j = 0; j < num_pix; ++j) {
+				sum += cs[j + 2 * r];
+				// the window must be within the right image
+				cost[j] = (x0 + j >= d + r) ? sum : 0xFFFF;
+				sum -= cs[j];
+			}
+		}
+
+		uint16_t *disparity = &disparity_[(size_t)y * width_ + x0];
+		for (unsigned int j = 0; j < num_pix; ++j) {
+			unsigned int best   = 0xFFFF;
+			unsigned int best_i = num_d;
+			for (unsigned int i = 0; i < num_d; ++i) {
+				unsigned int c = costs_[(size_t)i * num_pix + j];
+				if (c < best) {
+					best   = c;
+					best_i = i;
+				}
+			}
+			if (best_i == num_d) {
+				disparity[j] = DISPARITY_INVALID;
+				continue;
+			}
+
+			bool unique = true;
+			if (uniqueness_ratio_ > 0) {
+				for (unsigned int i = 0; i < num_d; ++i) {
+					unsigned int c = costs_[(size_t)i * num_pix + j];
+					if (((i + 1 < best_i) || (i > best_i + 1))
+					    && (c * 100 <= best * (100 + uniqueness_ratio_))) {
+						unique = false;
+						break;
+					}
+				}
+			}
+			if (!unique) {
+				disparity[j] = DISPARITY_INVALID;
+				continue;
+			}
+
+			int d = (min_disparity_ + best_i) << DISPARITY_FRAC_BITS;
+			if (subpixel_ && (best_i > 0) && (best_i + 1 < num_d)) {
+				int prev = costs_[(size_t)(best_i - 1) * num_pix + j];
+				int next = costs_[(size_t)(best_i + 1) * num_pix + j];
+				int div  = prev + next - 2 * (int)best;
+				if ((prev != 0xFFFF) && (div > 0)) {
+					// vertex of the parabola through the three costs
+					d += ((prev - next) * (1 << DISPARITY_FRAC_BITS) + div) / (2 * div);
+				}
+			}
+			disparity[j] = d;
+		}
+	}
+}
+
+void
+BlockMatchingStereoProcessor::calculate_disparity(ROI *roi)
+{
+	unsigned int rx = 0, ry = 0, rw = width_, rh = height_;
+	if (roi) {
+		rx = std::min(roi->start.x, width_);
+		ry = std::min(roi->start.y, height_);
+		rw = std::min(roi->width, width_ - rx);
+		rh = std::min(roi->height, height_ - ry);
+	}
+
+	// pixels whose window leaves the image cannot be matched
+	const unsigned int r  = mask_size_ / 2;
+	const unsigned int x0 = std::max(rx, r + min_disparity_);
+	const unsigned int y0 = std::max(ry, r);
+	const unsigned int x1 = std::min(rx + rw, (width_ > r) ? width_ - r : 0);
+	const unsigned int y1 = std::min(ry + rh, (height_ > r) ? height_ - r : 0);
+
+	for (unsigned int y = ry; y < ry + rh; ++y) {
+		for (unsigned int x = rx; x < rx + rw; ++x) {
+			if ((y < y0) || (y >= y1) || (x < x0) || (x >= x1)) {
+				disparity_[(size_t)y * width_ + x] = DISPARITY_INVALID;
+			}
+		}
+	}
+
+	if ((x0 < x1) && (y0 < y1)) {
+		match(x0, y0, x1, y1);
+	}
+}
+
+/** Get coordinates for pixel in camera coordinate system.
+ * The disparity of the pixel is calculated if this has not been done
+ * for the current frame. The X axis of the camera coordinate system
+ * points right, the Y axis down and the Z axis along the optical axis
+ * of the left camera.
+ * @param px x position of pixel in the rectified left image
+ * @param py y position of pixel in the rectified left image
+ * @param x upon successful return contains the x coordinate in meters
+ * @param y upon successful return contains the y coordinate in meters
+ * @param z upon successful return contains the z coordinate in meters
+ * @return true, if valid information could be retrieved and was written
+ * to (x,y,z), false otherwise
+ */
+bool
+BlockMatchingStereoProcessor::get_xyz(unsigned int px,
+                                      unsigned int py,
+                                      float *      x,
+                                      float *      y,
+                                      float *      z)
+{
+	if ((px >= width_) || (py >= height_)) {
+		return false;
+	}
+
+	const size_t i = (size_t)py * width_ + px;
+	if (disparity_[i] == DISPARITY_UNKNOWN) {
+		ROI roi(px, py, 1, 1, width_, height_);
+		calculate_disparity(&roi);
+	}
+	if ((disparity_[i] >= DISPARITY_INVALID) || (disparity_[i] == 0)) {
+		return false;
+	}
+
+	const float d = (float)disparity_[i] / (1 << DISPARITY_FRAC_BITS);
+	*z            = focal_length_ * baseline_ / d;
+	*x            = (px - center_x_) * *z / focal_length_;
+	*y            = (py - center_y_) * *z / focal_length_;
+	return true;
+}
+
+/** Get coordinates for pixel in robot coordinate system.
+ * The coordinates are transformed with the pose set with
+ * set_camera_pose().
+ * @param px x position of pixel in the rectified left image
+ * @param py y position of pixel in the rectified left image
+ * @param x upon successful return contains the x coordinate in meters
+ * @param y upon successful return contains the y coordinate in meters
+ * @param z upon successful return contains the z coordinate in meters
+ * @return true, if valid information could be retrieved and was written
+ * to (x,y,z), false otherwise
+ */
+bool
+BlockMatchingStereoProcessor::get_world_xyz(unsigned int px,
+                                            unsigned int py,
+                                            float *      x,
+                                            float *      y,
+                                            float *      z)
+{
+	float cx, cy, cz;
+	if (!get_xyz(px, py, &cx, &cy, &cz)) {
+		return false;
+	}
+
+	// the optical axis points forward and is tilted downwards
+	*x = cosf(tilt_) * cz - sinf(tilt_) * cy + trans_x_;
+	*y = cx + trans_y_;
+	*z = sinf(tilt_) * cz + cosf(tilt_) * cy + trans_z_;
+	return true;
+}
+
+/** Rectify a YUV image.
+ * @param left true to rectify the left image, false for the right image
+ */
+void
+BlockMatchingStereoProcessor::rectify_yuv(bool left)
+{
+	unsigned char *&        dst = left ? yuv_left_ : yuv_right_;
+	unsigned char *         src = left ? left_ : right_;
+	RectificationInfoBlock *rib = left ? rib_left_ : rib_right_;
+
+	if (dst == NULL) {
+		dst = malloc_buffer(YUV422_PLANAR, width_, height_);
+	}
+
+	if (rib == NULL) {
+		memcpy(dst, src, colorspace_buffer_size(YUV422_PLANAR, width_, height_));
+	} else {
+		ROI *src_roi = ROI::full_image(width_, height_);
+		ROI *dst_roi = ROI::full_image(width_, height_);
+
+		FilterRectify rectify(rib, /* mark zeros */ false);
+		rectify.set_src_buffer(src, src_roi);
+		rectify.set_dst_buffer(dst, dst_roi);
+		rectify.apply();
+
+		delete src_roi;
+		delete dst_roi;
+	}
+}
+
+void
+BlockMatchingStereoProcessor::calculate_yuv(bool both)
+{
+	if ((left_ == NULL) || (right_ == NULL)) {
+		throw NullPointerException("BlockMatchingStereoProcessor: buffers not set");
+	}
+	rectify_yuv(true);
+	if (both) {
+		rectify_yuv(false);
+	}
+}
+
+/** Get the disparity image buffer.
+ * The buffer contains one 16 bit disparity per pixel of the left image
+ * with DISPARITY_FRAC_BITS fractional bits. Pixels not calculated for
+ * the current frame are DISPARITY_UNKNOWN, pixels without a reliable
+ * match DISPARITY_INVALID.
+ * @return pointer to the internal disparity image buffer
+ */
+unsigned char *
+BlockMatchingStereoProcessor::disparity_buffer()
+{
+	return (unsigned char *)&disparity_[0];
+}
+
+size_t
+BlockMatchingStereoProcessor::disparity_buffer_size() const
+{
+	return disparity_.size() * sizeof(uint16_t);
+}
+
+unsigned char *
+BlockMatchingStereoProcessor::yuv_buffer_left()
+{
+	return yuv_left_;
+}
+
+unsigned char *
+BlockMatchingStereoProcessor::yuv_buffer_right()
+{
+	return yuv_right_;
+}
+
+} // end namespace firevision
@@ -0,0 +1,127 @@
+
+/***************************************************************************
+ *  block_matching.h - Block matching stereo processor
+ *
+ *  Created: Thu Oct 15 05:53:19 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_STEREO_BLOCK_MATCHING_H_
+#define _FIREVISION_STEREO_BLOCK_MATCHING_H_
+
+#include <fvstereo/stereo_processor.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace firevision {
+
+class RectificationInfoBlock;
+
+class BlockMatchingStereoProcessor : public StereoProcessor
+{
+public:
+	static const uint16_t     DISPARITY_UNKNOWN;
+	static const uint16_t     DISPARITY_INVALID;
+	static const unsigned int DISPARITY_FRAC_BITS;
+
+	BlockMatchingStereoProcessor(unsigned int width,
+	                             unsigned int height,
+	                             float        focal_length,
+	                             float        baseline,
+	                             float        center_x,
+	                             float        center_y);
+	virtual ~BlockMatchingStereoProcessor();
+
+	void set_buffers(unsigned char *left, unsigned char *right);
+	void set_rectification(RectificationInfoBlock *left, RectificationInfoBlock *right);
+	void set_camera_pose(float tilt, float trans_x, float trans_y, float trans_z);
+
+	void set_disparity_range(unsigned int min, unsigned int max);
+	void set_stereo_masksize(unsigned int mask_size);
+	void set_subpixel_interpolation(bool enabled);
+	void set_uniqueness_ratio(unsigned int percent);
+
+	unsigned int disparity_range_min() const;
+	unsigned int disparity_range_max() const;
+	unsigned int stereo_masksize() const;
+	bool         subpixel_interpolation() const;
+	unsigned int uniqueness_ratio() const;
+
+	virtual bool get_xyz(unsigned int px, unsigned int py, float *x, float *y, float *z);
+
+	virtual bool get_world_xyz(unsigned int px, unsigned int py, float *x, float *y, float *z);
+
+	virtual void           preprocess_stereo();
+	virtual void           calculate_disparity(ROI *roi = 0);
+	virtual void           calculate_yuv(bool both = false);
+	virtual unsigned char *disparity_buffer();
+	virtual size_t         disparity_buffer_size() const;
+	virtual unsigned char *yuv_buffer_right();
+	virtual unsigned char *yuv_buffer_left();
+
+private:
+	void                 rectify_lines(unsigned int first, unsigned int last);
+	void                 rectify_line(unsigned int y, bool left);
+	const unsigned char *rectified_line(unsigned int y, bool left) const;
+	void                 accumulate_line(unsigned int y,
+	                                     unsigned int first_col,
+	                                     unsigned int num_cols,
+	                                     bool         subtract);
+	void                 match(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1);
+	void                 rectify_yuv(bool left);
+
+private:
+	unsigned int width_;
+	unsigned int height_;
+	float        focal_length_;
+	float        baseline_;
+	float        center_x_;
+	float        center_y_;
+
+	float tilt_;
+	float trans_x_;
+	float trans_y_;
+	float trans_z_;
+
+	unsigned int min_disparity_;
+	unsigned int max_disparity_;
+	unsigned int mask_size_;
+	bool         subpixel_;
+	unsigned int uniqueness_ratio_;
+
+	unsigned char *         left_;
+	unsigned char *         right_;
+	RectificationInfoBlock *rib_left_;
+	RectificationInfoBlock *rib_right_;
+
+	std::vector<unsigned char> rect_left_;
+	std::vector<unsigned char> rect_right_;
+	std::vector<bool>          rectified_;
+
+	std::vector<uint16_t> disparity_;
+	std::vector<uint16_t> column_sums_;
+	std::vector<uint16_t> costs_;
+
+	unsigned char *yuv_left_;
+	unsigned char *yuv_right_;
+};
+
+} // end namespace firevision
+
+#endif
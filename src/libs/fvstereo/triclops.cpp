@@ -28,6 +28,7 @@
 #include <fvutils/base/roi.h>
 #include <fvutils/color/conversions.h>
 #include <fvutils/rectification/rectfile.h>
+#include <fvutils/rectification/rectinfo_bilinear_block.h>
 #include <fvutils/rectification/rectinfo_lut_block.h>
 #include <utils/math/angle.h>
 
@@ -816,9 +817,12 @@ TriclopsStereoProcessor::get_world_xyz(unsigned int px,
  * @param lut_file name of the file to write to. The file will be created if
  * it does not exist and truncated otherwise. The directory where the file has to
  * be stored has to exist.
+ * @param bilinear true to store the unrectified positions with subpixel precision
+ * in RectificationBilinearInfoBlocks, such that FilterRectify interpolates the
+ * rectified image, false to store the nearest pixels in RectificationLutInfoBlocks
  */
 void
-TriclopsStereoProcessor::generate_rectification_lut(const char *lut_file)
+TriclopsStereoProcessor::generate_rectification_lut(const char *lut_file, bool bilinear)
 {
 	uint64_t    guid = 0;
 	const char *model;
@@ -838,30 +842,57 @@ TriclopsStereoProcessor::generate_rectification_lut(const char *lut_file)
 
 	RectificationInfoFile *rif = new RectificationInfoFile(guid, model);
 
-	RectificationLutInfoBlock *lib_left =
-	  new RectificationLutInfoBlock(_width, _height, FIREVISION_RECTINFO_CAMERA_LEFT);
-	RectificationLutInfoBlock *lib_right =
-	  new RectificationLutInfoBlock(_width, _height, FIREVISION_RECTINFO_CAMERA_RIGHT);
-
-	register float row, col;
-	for (unsigned int h = 0; h < _height; ++h) {
-		for (unsigned int w = 0; w < _width; ++w) {
-			if (triclopsUnrectifyPixel(data->triclops, TriCam_LEFT, h, w, &row, &col)
-			    != TriclopsErrorOk) {
-				throw Exception("Failed to get unrectified position from Triclops SDK");
+	if (bilinear) {
+		RectificationBilinearInfoBlock *bib_left =
+		  new RectificationBilinearInfoBlock(_width, _height, FIREVISION_RECTINFO_CAMERA_LEFT);
+		RectificationBilinearInfoBlock *bib_right =
+		  new RectificationBilinearInfoBlock(_width, _height, FIREVISION_RECTINFO_CAMERA_RIGHT);
+
+		float row, col;
+		for (unsigned int h = 0; h < _height; ++h) {
+			for (unsigned int w = 0; w < _width; ++w) {
+				if (triclopsUnrectifyPixel(data->triclops, TriCam_LEFT, h, w, &row, &col)
+				    != TriclopsErrorOk) {
+					throw Exception("Failed to get unrectified position from Triclops SDK");
+				}
+				bib_left->set_mapping(w, h, col, row);
+
+				if (triclopsUnrectifyPixel(data->triclops, TriCam_RIGHT, h, w, &row, &col)
+				    != TriclopsErrorOk) {
+					throw Exception("Failed to get unrectified position from Triclops SDK");
+				}
+				bib_right->set_mapping(w, h, col, row);
 			}
-			lib_left->set_mapping(w, h, (int)roundf(col), (int)roundf(row));
+		}
 
-			if (triclopsUnrectifyPixel(data->triclops, TriCam_RIGHT, h, w, &row, &col)
-			    != TriclopsErrorOk) {
-				throw Exception("Failed to get unrectified position from Triclops SDK");
+		rif->add_rectinfo_block(bib_left);
+		rif->add_rectinfo_block(bib_right);
+	} else {
+		RectificationLutInfoBlock *lib_left =
+		  new RectificationLutInfoBlock(_width, _height, FIREVISION_RECTINFO_CAMERA_LEFT);
+		RectificationLutInfoBlock *lib_right =
+		  new RectificationLutInfoBlock(_width, _height, FIREVISION_RECTINFO_CAMERA_RIGHT);
+
+		register float row, col;
+		for (unsigned int h = 0; h < _height; ++h) {
+			for (unsigned int w = 0; w < _width; ++w) {
+				if (triclopsUnrectifyPixel(data->triclops, TriCam_LEFT, h, w, &row, &col)
+				    != TriclopsErrorOk) {
+					throw Exception("Failed to get unrectified position from Triclops SDK");
+				}
+				lib_left->set_mapping(w, h, (int)roundf(col), (int)roundf(row));
+
+				if (triclopsUnrectifyPixel(data->triclops, TriCam_RIGHT, h, w, &row, &col)
+				    != TriclopsErrorOk) {
+					throw Exception("Failed to get unrectified position from Triclops SDK");
+				}
+				lib_right->set_mapping(w, h, (int)roundf(col), (int)roundf(row));
 			}
-			lib_right->set_mapping(w, h, (int)roundf(col), (int)roundf(row));
 		}
-	}
 
-	rif->add_rectinfo_block(lib_left);
-	rif->add_rectinfo_block(lib_right);
+		rif->add_rectinfo_block(lib_left);
+		rif->add_rectinfo_block(lib_right);
+	}
 
 	rif->write(lut_file);
 
@@ -949,6 +980,48 @@ TriclopsStereoProcessor::verify_rectification_lut(const char *lut_file)
 				}
 			}
 
+			if (lut_ok) {
+				if (rib->camera() == FIREVISION_RECTINFO_CAMERA_LEFT) {
+					left_ok = true;
+				} else {
+					right_ok = true;
+				}
+			}
+		} else if (rib->type() == FIREVISION_RECTINFO_TYPE_LUT_BILINEAR) {
+			RectificationBilinearInfoBlock *rbib = dynamic_cast<RectificationBilinearInfoBlock *>(rib);
+			if (rbib == NULL) {
+				continue;
+			}
+
+			TriclopsCamera cam;
+			if (rib->camera() == FIREVISION_RECTINFO_CAMERA_LEFT) {
+				cam = TriCam_LEFT;
+				if (left_ok)
+					continue;
+			} else {
+				cam = TriCam_RIGHT;
+				if (right_ok)
+					continue;
+			}
+
+			// positions are stored in sixteenths of a pixel, border positions are
+			// moved by another sixteenth
+			float row, col, rx, ry;
+			bool  lut_ok = true;
+			for (unsigned int h = 0; (h < _height) && lut_ok; ++h) {
+				for (unsigned int w = 0; w < _width; ++w) {
+					if (triclopsUnrectifyPixel(data->triclops, cam, h, w, &row, &col) != TriclopsErrorOk) {
+						throw Exception("Failed to get unrectified position from Triclops SDK");
+					}
+					rbib->subpixel_mapping(w, h, &rx, &ry);
+					if ((fabsf(rx - col) > 1.f / 16.f) || (fabsf(ry - row) > 1.f / 16.f)) {
+						printf("Value at (%u,%u) not ok\n", w, h);
+						lut_ok = false;
+						break;
+					}
+				}
+			}
+
 			if (lut_ok) {
 				if (rib->camera() == FIREVISION_RECTINFO_CAMERA_LEFT) {
 					left_ok = true;
@@ -81,7 +81,7 @@ public:
 	virtual unsigned char *yuv_buffer_right();
 	virtual unsigned char *yuv_buffer_left();
 
-	void generate_rectification_lut(const char *lut_file);
+	void generate_rectification_lut(const char *lut_file, bool bilinear = false);
 	bool verify_rectification_lut(const char *lut_file);
 
 	virtual void
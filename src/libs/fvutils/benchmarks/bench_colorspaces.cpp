@@ -0,0 +1,79 @@
+
+/***************************************************************************
+ *  bench_colorspaces.cpp - Colorspace conversion microbenchmarks
+ *
+ *  Created: Thu Oct 15 07:45:06 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <benchmark/benchmark.h>
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/color/conversions.h>
+
+#include <cstdlib>
+
+using namespace firevision;
+
+static void
+BM_Convert(benchmark::State &state, colorspace_t from, colorspace_t to)
+{
+	unsigned int width  = state.range(0);
+	unsigned int height = state.range(1);
+	size_t       size   = colorspace_buffer_size(from, width, height);
+
+	unsigned char *src = malloc_buffer(from, width, height);
+	unsigned char *dst = malloc_buffer(to, width, height);
+	// fixed seed for reproducible input
+	srand(4711);
+	for (size_t i = 0; i < size; ++i) {
+		src[i] = rand() & 0xFF;
+	}
+
+	for (auto _ : state) {
+		convert(from, to, src, dst, width, height);
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * size);
+	state.SetItemsProcessed(state.iterations() * width * height);
+
+	free(src);
+	free(dst);
+}
+
+#define CONVERSION(name, from, to)                \
+	BENCHMARK_CAPTURE(BM_Convert, name, from, to) \
+	  ->ArgNames({"width", "height"})             \
+	  ->Args({640, 480})                          \
+	  ->Args({1920, 1080})
+
+CONVERSION(yuv422planar_to_rgb, YUV422_PLANAR, RGB);
+CONVERSION(yuv422planar_to_bgr, YUV422_PLANAR, BGR);
+CONVERSION(yuv422packed_to_rgb, YUV422_PACKED, RGB);
+CONVERSION(yuv422packed_to_yuv422planar, YUV422_PACKED, YUV422_PLANAR);
+CONVERSION(yuv422planar_to_yuv422packed, YUV422_PLANAR, YUV422_PACKED);
+CONVERSION(rgb_to_yuv422planar, RGB, YUV422_PLANAR);
+CONVERSION(rgb_to_yuv422packed, RGB, YUV422_PACKED);
+CONVERSION(bgr_to_rgb, BGR, RGB);
+CONVERSION(yuy2_to_yuv422planar, YUY2, YUV422_PLANAR);
+CONVERSION(bayer_gbrg_to_yuv422planar, BAYER_MOSAIC_GBRG, YUV422_PLANAR);
+
+BENCHMARK_MAIN();
+
+/// @endcond
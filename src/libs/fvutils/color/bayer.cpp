@@ -21,11 +21,19 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <core/exception.h>
 #include <fvutils/color/bayer.h>
 #include <fvutils/color/colorspaces.h>
 #include <fvutils/color/rgbyuv.h>
+#include <fvutils/color/simd.h>
 #include <fvutils/color/yuv.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
 namespace firevision {
 
 /* The basic information has been taken from
@@ -1009,4 +1017,391 @@ bayerGRBG_to_rgb_bilinear(const unsigned char *bayer,
 	++bayer;
 }
 
+
+/// @cond INTERNAL
+
+/* Number of rows converted by one task when converting whole images with
+ * OpenMP. Each band reads one (bilinear) or three (edge-aware) rows
+ * outside of it. */
+#define BAYER_BAND_ROWS 64
+
+/** Ring buffer of Bayer rows mirrored at the image borders.
+ * Rows are copied with two extra pixels on each side, mirrored such that
+ * the Bayer pattern continues, so that row kernels need no border
+ * handling. Rows must be requested in ascending order, at most five
+ * consecutive rows are held at a time.
+ */
+class BayerRowRing
+{
+public:
+	BayerRowRing(const unsigned char *bayer, unsigned int width, unsigned int height)
+	: bayer_(bayer),
+	  width_(width),
+	  height_(height),
+	  stride_(width + 2 * PAD),
+	  buffer_(NUM_ROWS * stride_),
+	  rows_(NUM_ROWS, std::numeric_limits<int>::min())
+	{
+	}
+
+	const unsigned char *
+	row(int r)
+	{
+		unsigned int   slot = (unsigned int)(r + NUM_ROWS) % NUM_ROWS;
+		unsigned char *p    = &buffer_[slot * stride_ + PAD];
+		if (rows_[slot] != r) {
+			int src_row = r < 0 ? -r : (r >= (int)height_ ? 2 * ((int)height_ - 1) - r : r);
+			const unsigned char *src = bayer_ + (size_t)src_row * width_;
+			memcpy(p, src, width_);
+			p[-1]         = src[1];
+			p[-2]         = src[2];
+			p[width_]     = src[width_ - 2];
+			p[width_ + 1] = src[width_ - 3];
+			rows_[slot]   = r;
+		}
+		return p;
+	}
+
+private:
+	static const int PAD      = 2;
+	static const int NUM_ROWS = 5;
+
+	const unsigned char *      bayer_;
+	unsigned int               width_;
+	unsigned int               height_;
+	unsigned int               stride_;
+	std::vector<unsigned char> buffer_;
+	std::vector<int>           rows_;
+};
+
+static void
+bayer_row_layout(bayer_pattern_t pattern, unsigned int row, bool &green_first, bool &red_row)
+{
+	bool even = (row % 2) == 0;
+	switch (pattern) {
+	case BAYER_PATTERN_RGGB:
+		green_first = !even;
+		red_row     = even;
+		break;
+	case BAYER_PATTERN_GBRG:
+		green_first = even;
+		red_row     = !even;
+		break;
+	case BAYER_PATTERN_GRBG:
+		green_first = even;
+		red_row     = even;
+		break;
+	case BAYER_PATTERN_BGGR:
+		green_first = !even;
+		red_row     = !even;
+		break;
+	default: throw fawkes::Exception("Bayer pattern %08x cannot be demosaiced", pattern);
+	}
+}
+
+static inline unsigned char
+clamp_byte(int v)
+{
+	return (unsigned char)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+/* Green for all pixels of a row. At red and blue sites green is
+ * interpolated along the direction with the smaller gradient, corrected
+ * by the second derivative of the sampled color (Hamilton-Adams). The
+ * result is mirrored into one extra pixel on each side. */
+static void
+bayer_green_row_edge_aware(BayerRowRing & rows,
+                           int            r,
+                           unsigned int   width,
+                           bool           green_first,
+                           unsigned char *green)
+{
+	const unsigned char *u2 = rows.row(r - 2);
+	const unsigned char *u1 = rows.row(r - 1);
+	const unsigned char *c  = rows.row(r);
+	const unsigned char *d1 = rows.row(r + 1);
+	const unsigned char *d2 = rows.row(r + 2);
+
+	for (int i = 0; i < (int)width; ++i) {
+		if (((i & 1) == 0) == green_first) {
+			green[i] = c[i];
+			continue;
+		}
+		int lap_h = 2 * c[i] - c[i - 2] - c[i + 2];
+		int lap_v = 2 * c[i] - u2[i] - d2[i];
+		int grad_h = abs(c[i - 1] - c[i + 1]) + abs(lap_h);
+		int grad_v = abs(u1[i] - d1[i]) + abs(lap_v);
+		// four times the estimates
+		int est_h = 2 * (c[i - 1] + c[i + 1]) + lap_h;
+		int est_v = 2 * (u1[i] + d1[i]) + lap_v;
+
+		if (grad_h < grad_v) {
+			green[i] = clamp_byte((est_h + 2) >> 2);
+		} else if (grad_v < grad_h) {
+			green[i] = clamp_byte((est_v + 2) >> 2);
+		} else {
+			green[i] = clamp_byte((est_h + est_v + 4) >> 3);
+		}
+	}
+	green[-1]    = green[1];
+	green[width] = green[width - 2];
+}
+
+/* Red and blue of a row from the color differences to the interpolated
+ * green of the neighbouring pixels. */
+static void
+bayer_row_edge_aware(const unsigned char *above,
+                     const unsigned char *row,
+                     const unsigned char *below,
+                     const unsigned char *green_above,
+                     const unsigned char *green_row,
+                     const unsigned char *green_below,
+                     unsigned int         width,
+                     bool                 green_first,
+                     unsigned char *      row_color,
+                     unsigned char *      green,
+                     unsigned char *      other_color)
+{
+	for (int i = 0; i < (int)width; ++i) {
+		int g    = green_row[i];
+		green[i] = g;
+		if (((i & 1) == 0) == green_first) {
+			int dh = (row[i - 1] - green_row[i - 1]) + (row[i + 1] - green_row[i + 1]);
+			int dv = (above[i] - green_above[i]) + (below[i] - green_below[i]);
+			row_color[i]   = clamp_byte(g + ((dh + 1) >> 1));
+			other_color[i] = clamp_byte(g + ((dv + 1) >> 1));
+		} else {
+			int dd = (above[i - 1] - green_above[i - 1]) + (above[i + 1] - green_above[i + 1])
+			         + (below[i - 1] - green_below[i - 1]) + (below[i + 1] - green_below[i + 1]);
+			row_color[i]   = row[i];
+			other_color[i] = clamp_byte(g + ((dd + 2) >> 2));
+		}
+	}
+}
+
+/* Demosaic rows [first_row, first_row + num_rows) into planar RGB lines
+ * and hand each line to the given output function. */
+template <class Output>
+static void
+bayer_demosaic_rows(bayer_pattern_t      pattern,
+                    bayer_demosaic_t     method,
+                    const unsigned char *bayer,
+                    unsigned int         width,
+                    unsigned int         height,
+                    unsigned int         first_row,
+                    unsigned int         num_rows,
+                    Output               output)
+{
+	if ((width < 4) || (width % 2 != 0) || (height < 4)) {
+		throw fawkes::Exception("Cannot demosaic Bayer image of size %ux%u", width, height);
+	}
+	if (first_row + num_rows > height) {
+		throw fawkes::Exception("Rows %u to %u outside of Bayer image with %u rows",
+		                        first_row,
+		                        first_row + num_rows,
+		                        height);
+	}
+
+	BayerRowRing rows(bayer, width, height);
+
+	// planar R, G, B line, and three green lines padded by one pixel
+	std::vector<unsigned char> line(3 * width);
+	std::vector<unsigned char> green_lines(method == BAYER_DEMOSAIC_EDGE_AWARE ? 3 * (width + 2)
+	                                                                           : 0);
+	unsigned char *            lines[3] = {&line[0], &line[width], &line[2 * width]};
+
+	for (unsigned int r = first_row; r < first_row + num_rows; ++r) {
+		bool green_first, red_row;
+		bayer_row_layout(pattern, r, green_first, red_row);
+		unsigned char *row_color   = red_row ? lines[0] : lines[2];
+		unsigned char *other_color = red_row ? lines[2] : lines[0];
+
+		if (method == BAYER_DEMOSAIC_EDGE_AWARE) {
+			// green of the row below is computed ahead, the ones of this row
+			// and the row above are kept from previous iterations
+			for (int gr = (r == first_row) ? (int)r - 1 : (int)r + 1; gr <= (int)r + 1; ++gr) {
+				bool gf, rr;
+				bayer_row_layout(pattern, (unsigned int)(gr + 2) % 2, gf, rr);
+				bayer_green_row_edge_aware(
+				  rows, gr, width, gf, &green_lines[((gr + 3) % 3) * (width + 2) + 1]);
+			}
+			bayer_row_edge_aware(rows.row(r - 1),
+			                     rows.row(r),
+			                     rows.row(r + 1),
+			                     &green_lines[((r + 2) % 3) * (width + 2) + 1],
+			                     &green_lines[(r % 3) * (width + 2) + 1],
+			                     &green_lines[((r + 1) % 3) * (width + 2) + 1],
+			                     width,
+			                     green_first,
+			                     row_color,
+			                     lines[1],
+			                     other_color);
+		} else {
+			bayer_row_bilinear_simd(rows.row(r - 1),
+			                        rows.row(r),
+			                        rows.row(r + 1),
+			                        width,
+			                        green_first,
+			                        row_color,
+			                        lines[1],
+			                        other_color);
+		}
+
+		output(r, &line[0]);
+	}
+}
+
+/// @endcond
+
+/** Demosaic rows of a Bayer image to RGB.
+ * Only the given rows of the output image are written, the input is read
+ * from up to three rows above and below. Disjoint row bands can therefore
+ * be converted concurrently. The image is mirrored at its borders.
+ * @param pattern Bayer pattern of the image
+ * @param method demosaicing method
+ * @param bayer Bayer image
+ * @param rgb RGB image, the whole image buffer
+ * @param width Width of the image, must be even and at least 4
+ * @param height Height of the image, must be at least 4
+ * @param first_row first row to convert
+ * @param num_rows number of rows to convert
+ * @exception Exception thrown for unsupported patterns or image sizes
+ */
+void
+bayer_to_rgb_rows(bayer_pattern_t      pattern,
+                  bayer_demosaic_t     method,
+                  const unsigned char *bayer,
+                  unsigned char *      rgb,
+                  unsigned int         width,
+                  unsigned int         height,
+                  unsigned int         first_row,
+                  unsigned int         num_rows)
+{
+	bayer_demosaic_rows(pattern,
+	                    method,
+	                    bayer,
+	                    width,
+	                    height,
+	                    first_row,
+	                    num_rows,
+	                    [rgb, width](unsigned int r, const unsigned char *line) {
+		                    rgb_planar_to_rgb_simd(line, rgb + (size_t)r * width * 3, width, 1);
+	                    });
+}
+
+/** Demosaic rows of a Bayer image to YUV422 planar.
+ * Only the given rows of the output image are written, the input is read
+ * from up to three rows above and below. Disjoint row bands can therefore
+ * be converted concurrently. The image is mirrored at its borders.
+ * @param pattern Bayer pattern of the image
+ * @param method demosaicing method
+ * @param bayer Bayer image
+ * @param yuv YUV422 planar image, the whole image buffer
+ * @param width Width of the image, must be even and at least 4
+ * @param height Height of the image, must be at least 4
+ * @param first_row first row to convert
+ * @param num_rows number of rows to convert
+ * @exception Exception thrown for unsupported patterns or image sizes
+ */
+void
+bayer_to_yuv422planar_rows(bayer_pattern_t      pattern,
+                           bayer_demosaic_t     method,
+                           const unsigned char *bayer,
+                           unsigned char *      yuv,
+                           unsigned int         width,
+                           unsigned int         height,
+                           unsigned int         first_row,
+                           unsigned int         num_rows)
+{
+	unsigned char *            yp = yuv;
+	unsigned char *            up = YUV422_PLANAR_U_PLANE(yuv, width, height);
+	unsigned char *            vp = YUV422_PLANAR_V_PLANE(yuv, width, height);
+	std::vector<unsigned char> yuv_line(2 * width);
+
+	bayer_demosaic_rows(pattern,
+	                    method,
+	                    bayer,
+	                    width,
+	                    height,
+	                    first_row,
+	                    num_rows,
+	                    [&](unsigned int r, const unsigned char *line) {
+		                    // one line is a YUV422 planar image of height 1
+		                    rgb_planar_to_yuv422planar_simd(line, &yuv_line[0], width, 1);
+		                    memcpy(yp + (size_t)r * width, &yuv_line[0], width);
+		                    memcpy(up + (size_t)r * width / 2, &yuv_line[width], width / 2);
+		                    memcpy(vp + (size_t)r * width / 2, &yuv_line[width + width / 2], width / 2);
+	                    });
+}
+
+/** Demosaic a Bayer image to RGB.
+ * The rows are converted in bands, in parallel if compiled with OpenMP.
+ * @param pattern Bayer pattern of the image
+ * @param method demosaicing method
+ * @param bayer Bayer image
+ * @param rgb RGB image
+ * @param width Width of the image, must be even and at least 4
+ * @param height Height of the image, must be at least 4
+ * @exception Exception thrown for unsupported patterns or image sizes
+ */
+void
+bayer_to_rgb(bayer_pattern_t      pattern,
+             bayer_demosaic_t     method,
+             const unsigned char *bayer,
+             unsigned char *      rgb,
+             unsigned int         width,
+             unsigned int         height)
+{
+	int num_bands = (height + BAYER_BAND_ROWS - 1) / BAYER_BAND_ROWS;
+#ifdef _OPENMP
+#	pragma omp parallel for schedule(static)
+#endif
+	for (int b = 0; b < num_bands; ++b) {
+		unsigned int first_row = b * BAYER_BAND_ROWS;
+		bayer_to_rgb_rows(pattern,
+		                  method,
+		                  bayer,
+		                  rgb,
+		                  width,
+		                  height,
+		                  first_row,
+		                  std::min<unsigned int>(BAYER_BAND_ROWS, height - first_row));
+	}
+}
+
+/** Demosaic a Bayer image to YUV422 planar.
+ * The rows are converted in bands, in parallel if compiled with OpenMP.
+ * @param pattern Bayer pattern of the image
+ * @param method demosaicing method
+ * @param bayer Bayer image
+ * @param yuv YUV422 planar image
+ * @param width Width of the image, must be even and at least 4
+ * @param height Height of the image, must be at least 4
+ * @exception Exception thrown for unsupported patterns or image sizes
+ */
+void
+bayer_to_yuv422planar(bayer_pattern_t      pattern,
+                      bayer_demosaic_t     method,
+                      const unsigned char *bayer,
+                      unsigned char *      yuv,
+                      unsigned int         width,
+                      unsigned int         height)
+{
+	int num_bands = (height + BAYER_BAND_ROWS - 1) / BAYER_BAND_ROWS;
+#ifdef _OPENMP
+#	pragma omp parallel for schedule(static)
+#endif
+	for (int b = 0; b < num_bands; ++b) {
+		unsigned int first_row = b * BAYER_BAND_ROWS;
+		bayer_to_yuv422planar_rows(pattern,
+		                           method,
+		                           bayer,
+		                           yuv,
+		                           width,
+		                           height,
+		                           first_row,
+		                           std::min<unsigned int>(BAYER_BAND_ROWS, height - first_row));
+	}
+}
+
 } // end namespace firevision
@@ -37,6 +37,13 @@ typedef enum {
 	BAYER_PATTERN_BGGR = 0x42474752  /**< BGGR */
 } bayer_pattern_t;
 
+/** Demosaicing methods. */
+typedef enum {
+	BAYER_DEMOSAIC_BILINEAR,  /**< Average of the nearest neighbours of each color */
+	BAYER_DEMOSAIC_EDGE_AWARE /**< Green interpolated along edges, red and blue from
+	                           *   color differences to green */
+} bayer_demosaic_t;
+
 void bayerGBRG_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
                                                  unsigned char *      yuv,
                                                  unsigned int         width,
@@ -75,6 +82,38 @@ void bayerGRBG_to_rgb_bilinear(const unsigned char *bayer,
                                unsigned int         width,
                                unsigned int         height);
 
+void bayer_to_rgb(bayer_pattern_t      pattern,
+                  bayer_demosaic_t     method,
+                  const unsigned char *bayer,
+                  unsigned char *      rgb,
+                  unsigned int         width,
+                  unsigned int         height);
+
+void bayer_to_yuv422planar(bayer_pattern_t      pattern,
+                           bayer_demosaic_t     method,
+                           const unsigned char *bayer,
+                           unsigned char *      yuv,
+                           unsigned int         width,
+                           unsigned int         height);
+
+void bayer_to_rgb_rows(bayer_pattern_t      pattern,
+                       bayer_demosaic_t     method,
+                       const unsigned char *bayer,
+                       unsigned char *      rgb,
+                       unsigned int         width,
+                       unsigned int         height,
+                       unsigned int         first_row,
+                       unsigned int         num_rows);
+
+void bayer_to_yuv422planar_rows(bayer_pattern_t      pattern,
+                                bayer_demosaic_t     method,
+                                const unsigned char *bayer,
+                                unsigned char *      yuv,
+                                unsigned int         width,
+                                unsigned int         height,
+                                unsigned int         first_row,
+                                unsigned int         num_rows);
+
 } // end namespace firevision
 
 #endif
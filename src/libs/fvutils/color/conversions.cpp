@@ -26,6 +26,7 @@
 #include <fvutils/color/bayer.h>
 #include <fvutils/color/rgb.h>
 #include <fvutils/color/rgbyuv.h>
+#include <fvutils/color/simd.h>
 #include <fvutils/color/yuv.h>
 #include <fvutils/color/yuvrgb.h>
 
@@ -33,6 +34,26 @@
 
 namespace firevision {
 
+/// @cond INTERNAL
+static inline bool
+is_bayer(colorspace_t cspace)
+{
+	return (cspace == BAYER_MOSAIC_RGGB) || (cspace == BAYER_MOSAIC_GBRG)
+	       || (cspace == BAYER_MOSAIC_GRBG) || (cspace == BAYER_MOSAIC_BGGR);
+}
+
+static inline bayer_pattern_t
+bayer_pattern(colorspace_t cspace)
+{
+	switch (cspace) {
+	case BAYER_MOSAIC_RGGB: return BAYER_PATTERN_RGGB;
+	case BAYER_MOSAIC_GBRG: return BAYER_PATTERN_GBRG;
+	case BAYER_MOSAIC_GRBG: return BAYER_PATTERN_GRBG;
+	default: return BAYER_PATTERN_BGGR;
+	}
+}
+/// @endcond
+
 /** Convert image from one colorspace to another.
  * This is a convenience method for unified access to all conversion routines
  * available in FireVision.
@@ -75,11 +96,11 @@ convert(colorspace_t         from,
 	} else if ((from == RGB) && (to == YUV411_PACKED)) {
 		rgb_to_yuv411packed_plainc(src, dst, width, height);
 	} else if ((from == RGB) && (to == YUV422_PLANAR)) {
-		rgb_to_yuv422planar_plainc(src, dst, width, height);
+		rgb_to_yuv422planar_simd(src, dst, width, height);
 	} else if ((from == YUV420_PLANAR) && (to == YUV422_PLANAR)) {
 		yuv420planar_to_yuv422planar(src, dst, width, height);
 	} else if ((from == RGB) && (to == YUV422_PACKED)) {
-		rgb_to_yuv422packed_plainc(src, dst, width, height);
+		rgb_to_yuv422packed_simd(src, dst, width, height);
 	} else if ((from == RGB_PLANAR) && (to == YUV422_PACKED)) {
 		rgb_planar_to_yuv422packed_plainc(src, dst, width, height);
 	} else if ((from == RGB) && (to == RGB_PLANAR)) {
@@ -87,7 +108,7 @@ convert(colorspace_t         from,
 	} else if ((from == RGB_PLANAR) && (to == RGB)) {
 		rgb_planar_to_rgb_plainc(src, dst, width, height);
 	} else if ((from == BGR) && (to == YUV422_PLANAR)) {
-		bgr_to_yuv422planar_plainc(src, dst, width, height);
+		bgr_to_yuv422planar_simd(src, dst, width, height);
 	} else if ((from == GRAY8) && (to == YUY2)) {
 		gray8_to_yuy2(src, dst, width, height);
 	} else if ((from == GRAY8) && (to == YUV422_PLANAR)) {
@@ -105,11 +126,11 @@ convert(colorspace_t         from,
 	} else if ((from == YUV422_PLANAR_QUARTER) && (to == YUV422_PLANAR)) {
 		yuv422planar_quarter_to_yuv422planar(src, dst, width, height);
 	} else if ((from == YUV422_PLANAR) && (to == RGB)) {
-		yuv422planar_to_rgb_plainc(src, dst, width, height);
+		yuv422planar_to_rgb_simd(src, dst, width, height);
 	} else if ((from == YUV422_PACKED) && (to == RGB)) {
-		yuv422packed_to_rgb_plainc(src, dst, width, height);
+		yuv422packed_to_rgb_simd(src, dst, width, height);
 	} else if ((from == YUV422_PLANAR) && (to == BGR)) {
-		yuv422planar_to_bgr_plainc(src, dst, width, height);
+		yuv422planar_to_bgr_simd(src, dst, width, height);
 	} else if ((from == YUV422_PLANAR) && (to == RGB_WITH_ALPHA)) {
 		yuv422planar_to_rgb_with_alpha_plainc(src, dst, width, height);
 	} else if ((from == RGB) && (to == RGB_WITH_ALPHA)) {
@@ -120,12 +141,10 @@ convert(colorspace_t         from,
 		yuv422planar_to_bgr_with_alpha_plainc(src, dst, width, height);
 	} else if ((from == YUV422_PACKED) && (to == BGR_WITH_ALPHA)) {
 		yuv422packed_to_bgr_with_alpha_plainc(src, dst, width, height);
-	} else if ((from == BAYER_MOSAIC_GBRG) && (to == YUV422_PLANAR)) {
-		bayerGBRG_to_yuv422planar_bilinear(src, dst, width, height);
-	} else if ((from == BAYER_MOSAIC_GRBG) && (to == YUV422_PLANAR)) {
-		bayerGRBG_to_yuv422planar_nearest_neighbour(src, dst, width, height);
-	} else if ((from == BAYER_MOSAIC_GRBG) && (to == YUV422_PLANAR)) {
-		bayerGRBG_to_yuv422planar_bilinear(src, dst, width, height);
+	} else if (is_bayer(from) && (to == YUV422_PLANAR)) {
+		bayer_to_yuv422planar(bayer_pattern(from), BAYER_DEMOSAIC_BILINEAR, src, dst, width, height);
+	} else if (is_bayer(from) && (to == RGB)) {
+		bayer_to_rgb(bayer_pattern(from), BAYER_DEMOSAIC_BILINEAR, src, dst, width, height);
 	} else if ((from == YUV444_PACKED) && (to == YUV422_PLANAR)) {
 		yuv444packed_to_yuv422planar(src, dst, width, height);
 	} else if ((from == YUV444_PACKED) && (to == YUV422_PACKED)) {
@@ -160,7 +179,7 @@ grayscale(colorspace_t   cspace,
           unsigned int   height)
 {
 	switch (cspace) {
-	case YUV422_PACKED: grayscale_yuv422packed(src, dst, width, height); break;
+	case YUV422_PACKED: grayscale_yuv422packed_simd(src, dst, width, height); break;
 	case YUV422_PLANAR: grayscale_yuv422planar(src, dst, width, height); break;
 	default:
 		fawkes::Exception e("FirevisionUtils: Cannot grayscale image. "
@@ -0,0 +1,1941 @@
+
+/***************************************************************************
+ *  simd.cpp - Vectorized colorspace conversions
+ *
+ *  Created: Thu Oct 15 04:56:11 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvutils/color/rgb.h>
+#include <fvutils/color/rgbyuv.h>
+#include <fvutils/color/simd.h>
+#include <fvutils/color/yuv.h>
+#include <fvutils/color/yuvrgb.h>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	define FV_SIMD_X86
+#	include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	define FV_SIMD_NEON
+#	include <arm_neon.h>
+#endif
+
+namespace firevision {
+
+/// @cond INTERNAL
+
+/* All kernels compute exactly the same fixed point expressions as the
+ * plain C versions, hence their results are bit-identical. The x86
+ * kernels are compiled for their instruction set with function
+ * attributes, so that the library itself still runs on any CPU. */
+
+static inline void
+yuv_to_rgb_pixel(int y, int u, int v, unsigned char *d, bool bgr)
+{
+	y -= 16;
+	d[bgr ? 2 : 0] = clip((76284 * y + 104595 * v) >> 16);
+	d[1]           = clip((76284 * y - 25625 * u - 53281 * v) >> 16);
+	d[bgr ? 0 : 2] = clip((76284 * y + 132252 * u) >> 16);
+}
+
+static void
+yuv422planar_to_rgb_tail(const unsigned char *planar,
+                         unsigned char *      dst,
+                         unsigned int         i,
+                         unsigned int         n,
+                         bool                 bgr)
+{
+	const unsigned char *up = planar + n;
+	const unsigned char *vp = up + n / 2;
+	for (; i < n; i += 2) {
+		int u = up[i / 2] - 128;
+		int v = vp[i / 2] - 128;
+		yuv_to_rgb_pixel(planar[i], u, v, dst + 3 * i, bgr);
+		yuv_to_rgb_pixel(planar[i + 1], u, v, dst + 3 * i + 3, bgr);
+	}
+}
+
+static void
+yuv422packed_to_rgb_tail(const unsigned char *YUV, unsigned char *dst, unsigned int i, unsigned int n)
+{
+	for (; i < n; i += 2) {
+		const unsigned char *p = YUV + 2 * i;
+		yuv_to_rgb_pixel(p[1], p[0] - 128, p[2] - 128, dst + 3 * i, false);
+		yuv_to_rgb_pixel(p[3], p[0] - 128, p[2] - 128, dst + 3 * i + 3, false);
+	}
+}
+
+static void
+rgb_to_yuv422_tail(const unsigned char *src,
+                   unsigned char *      dst,
+                   unsigned int         i,
+                   unsigned int         n,
+                   bool                 bgr,
+                   bool                 packed)
+{
+	const int ri = bgr ? 2 : 0;
+	const int bi = bgr ? 0 : 2;
+	for (; i < n; i += 2) {
+		const unsigned char *p = src + 3 * i;
+		int                  y1, y2, u1, u2, v1, v2;
+		RGB2YUV(p[ri], p[1], p[bi], y1, u1, v1);
+		RGB2YUV(p[3 + ri], p[4], p[3 + bi], y2, u2, v2);
+
+		if (packed) {
+			unsigned char *d = dst + 2 * i;
+			d[0]             = (u1 + u2) / 2;
+			d[1]             = y1;
+			d[2]             = (v1 + v2) / 2;
+			d[3]             = y2;
+		} else {
+			dst[i]                 = y1;
+			dst[i + 1]             = y2;
+			dst[n + i / 2]         = (u1 + u2) / 2;
+			dst[n + n / 2 + i / 2] = (v1 + v2) / 2;
+		}
+	}
+}
+
+static void
+grayscale_yuv422packed_tail(const unsigned char *src, unsigned char *dst, unsigned int i, unsigned int n)
+{
+	for (; i < n; ++i) {
+		dst[i] = src[2 * i + 1];
+	}
+}
+
+static void
+rgb_planar_to_yuv422planar_tail(const unsigned char *src,
+                                unsigned char *      dst,
+                                unsigned int         i,
+                                unsigned int         n)
+{
+	const unsigned char *rp = src;
+	const unsigned char *gp = src + n;
+	const unsigned char *bp = src + 2 * n;
+	for (; i < n; i += 2) {
+		int y1, y2, u1, u2, v1, v2;
+		RGB2YUV(rp[i], gp[i], bp[i], y1, u1, v1);
+		RGB2YUV(rp[i + 1], gp[i + 1], bp[i + 1], y2, u2, v2);
+		dst[i]                 = y1;
+		dst[i + 1]             = y2;
+		dst[n + i / 2]         = (u1 + u2) / 2;
+		dst[n + n / 2 + i / 2] = (v1 + v2) / 2;
+	}
+}
+
+static void
+bayer_row_bilinear_tail(const unsigned char *above,
+                        const unsigned char *row,
+                        const unsigned char *below,
+                        int                  i,
+                        int                  width,
+                        bool                 green_first,
+                        unsigned char *      row_color,
+                        unsigned char *      green,
+                        unsigned char *      other_color)
+{
+	for (; i < width; ++i) {
+		if (((i & 1) == 0) == green_first) {
+			row_color[i]   = (row[i - 1] + row[i + 1] + 1) >> 1;
+			green[i]       = row[i];
+			other_color[i] = (above[i] + below[i] + 1) >> 1;
+		} else {
+			row_color[i] = row[i];
+			green[i]     = (row[i - 1] + row[i + 1] + above[i] + below[i] + 2) >> 2;
+			other_color[i] =
+			  (above[i - 1] + above[i + 1] + below[i - 1] + below[i + 1] + 2) >> 2;
+		}
+	}
+}
+
+// bilinear weights of the left and right pixel as bytes of one 16 bit
+// word, indexed by the fractional part of a 12.4 fixed point coordinate
+static const uint16_t remap_bilinear_weights[16] = {
+  0x0010, 0x010F, 0x020E, 0x030D, 0x040C, 0x050B, 0x060A, 0x0709,
+  0x0808, 0x0907, 0x0A06, 0x0B05, 0x0C04, 0x0D03, 0x0E02, 0x0F01};
+
+static void
+remap_bilinear_tail(const unsigned char *plane,
+                    unsigned int         line_step,
+                    const uint16_t *     map,
+                    unsigned char *      dst,
+                    unsigned int         i,
+                    unsigned int         n)
+{
+	for (; i < n; ++i) {
+		unsigned int         x  = map[2 * i];
+		unsigned int         y  = map[2 * i + 1];
+		unsigned int         fx = x & 0xF;
+		unsigned int         fy = y & 0xF;
+		const unsigned char *p  = plane + (y >> 4) * line_step + (x >> 4);
+
+		unsigned int top    = p[0] * (16 - fx) + p[1] * fx;
+		unsigned int bottom = p[line_step] * (16 - fx) + p[line_step + 1] * fx;
+		dst[i]              = (top * (16 - fy) + bottom * fy + 128) >> 8;
+	}
+}
+
+// box average of factor x factor pixels, factor is 2 or 4
+static void
+box_downsample_tail(const unsigned char *src,
+                    unsigned int         line_step,
+                    unsigned char *      dst,
+                    unsigned int         i,
+                    unsigned int         n,
+                    unsigned int         factor,
+                    unsigned int         channels)
+{
+	const unsigned int shift = (factor == 4) ? 4 : 2;
+	for (; i < n; ++i) {
+		for (unsigned int c = 0; c < channels; ++c) {
+			unsigned int         sum = 0;
+			const unsigned char *p   = src + i * factor * channels + c;
+			for (unsigned int y = 0; y < factor; ++y, p += line_step) {
+				for (unsigned int x = 0; x < factor; ++x) {
+					sum += p[x * channels];
+				}
+			}
+			dst[i * channels + c] = (sum + (1 << (shift - 1))) >> shift;
+		}
+	}
+}
+
+// points of one line of a depth image, returns the number of points
+// written, invalid measurements are zero or skipped if compact
+static unsigned int
+depth_to_points_tail(const uint16_t *depth,
+                     const float *   y_factors,
+                     float           z_factor,
+                     float           scale,
+                     uint16_t        no_sample,
+                     uint16_t        shadow,
+                     unsigned char * points,
+                     unsigned int    point_step,
+                     bool            compact,
+                     unsigned int *  indices,
+                     unsigned int    i,
+                     unsigned int    n,
+                     unsigned int    count)
+{
+	for (; i < n; ++i) {
+		unsigned int d     = depth[i];
+		bool         valid = (d != 0) && (d != no_sample) && (d != shadow);
+		if (compact && !valid) {
+			continue;
+		}
+		float *p = (float *)(points + (size_t)(compact ? count : i) * point_step);
+		if (valid) {
+			float x = d * scale;
+			p[0]    = x;
+			p[1]    = y_factors[i] * x;
+			p[2]    = z_factor * x;
+		} else {
+			p[0] = p[1] = p[2] = 0.f;
+		}
+		if (compact && indices) {
+			indices[count] = i;
+		}
+		++count;
+	}
+	return count;
+}
+
+// absolute differences of two lines added to or subtracted from sums
+static void
+absdiff_accumulate_tail(const unsigned char *a,
+                        const unsigned char *b,
+                        uint16_t *           sums,
+                        unsigned int         i,
+                        unsigned int         n,
+                        bool                 subtract)
+{
+	for (; i < n; ++i) {
+		unsigned int d = (a[i] > b[i]) ? (a[i] - b[i]) : (b[i] - a[i]);
+		sums[i]        = subtract ? (sums[i] - d) : (sums[i] + d);
+	}
+}
+
+#ifdef FV_SIMD_X86
+
+#	define FV_TARGET_SSE41 __attribute__((target("ssse3,sse4.1")))
+#	define FV_TARGET_AVX2 __attribute__((target("avx2")))
+
+// 16 pixels from three channel vectors to 48 interleaved bytes
+FV_TARGET_SSE41 static inline void
+store_interleaved_sse41(unsigned char *d, __m128i c0, __m128i c1, __m128i c2)
+{
+	const __m128i m00 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+	const __m128i m01 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+	const __m128i m02 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+	const __m128i m10 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+	const __m128i m11 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+	const __m128i m12 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+	const __m128i m20 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+	const __m128i m21 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+	const __m128i m22 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+
+	_mm_storeu_si128((__m128i *)d,
+	                 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, m00), _mm_shuffle_epi8(c1, m01)),
+	                              _mm_shuffle_epi8(c2, m02)));
+	_mm_storeu_si128((__m128i *)(d + 16),
+	                 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, m10), _mm_shuffle_epi8(c1, m11)),
+	                              _mm_shuffle_epi8(c2, m12)));
+	_mm_storeu_si128((__m128i *)(d + 32),
+	                 _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, m20), _mm_shuffle_epi8(c1, m21)),
+	                              _mm_shuffle_epi8(c2, m22)));
+}
+
+// 48 interleaved bytes to three channel vectors of 16 pixels
+FV_TARGET_SSE41 static inline void
+load_deinterleaved_sse41(const unsigned char *s, __m128i &c0, __m128i &c1, __m128i &c2)
+{
+	const __m128i m00 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i m01 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+	const __m128i m02 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+	const __m128i m10 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i m11 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+	const __m128i m12 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+	const __m128i m20 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i m21 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+	const __m128i m22 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+
+	__m128i a = _mm_loadu_si128((const __m128i *)s);
+	__m128i b = _mm_loadu_si128((const __m128i *)(s + 16));
+	__m128i c = _mm_loadu_si128((const __m128i *)(s + 32));
+
+	c0 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m00), _mm_shuffle_epi8(b, m01)),
+	                  _mm_shuffle_epi8(c, m02));
+	c1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m10), _mm_shuffle_epi8(b, m11)),
+	                  _mm_shuffle_epi8(c, m12));
+	c2 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m20), _mm_shuffle_epi8(b, m21)),
+	                  _mm_shuffle_epi8(c, m22));
+}
+
+// four 32 bit lanes of Y, U, V to R, G, B, not yet clipped
+FV_TARGET_SSE41 static inline void
+yuv_to_rgb_sse41(__m128i y, __m128i u, __m128i v, __m128i &r, __m128i &g, __m128i &b)
+{
+	y = _mm_mullo_epi32(_mm_sub_epi32(y, _mm_set1_epi32(16)), _mm_set1_epi32(76284));
+	u = _mm_sub_epi32(u, _mm_set1_epi32(128));
+	v = _mm_sub_epi32(v, _mm_set1_epi32(128));
+
+	r = _mm_srai_epi32(_mm_add_epi32(y, _mm_mullo_epi32(v, _mm_set1_epi32(104595))), 16);
+	g = _mm_srai_epi32(_mm_sub_epi32(y,
+	                                 _mm_add_epi32(_mm_mullo_epi32(u, _mm_set1_epi32(25625)),
+	                                               _mm_mullo_epi32(v, _mm_set1_epi32(53281)))),
+	                   16);
+	b = _mm_srai_epi32(_mm_add_epi32(y, _mm_mullo_epi32(u, _mm_set1_epi32(132252))), 16);
+}
+
+// four vectors of 32 bit lanes to 16 bytes, clipped to [0-255]
+FV_TARGET_SSE41 static inline __m128i
+pack_sse41(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+	return _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+}
+
+FV_TARGET_SSE41 static void
+yuv422planar_to_rgb_sse41(const unsigned char *planar,
+                          unsigned char *      dst,
+                          unsigned int         n,
+                          bool                 bgr)
+{
+	const unsigned char *up = planar + n;
+	const unsigned char *vp = up + n / 2;
+
+	// duplicate the chroma value of a pixel pair into both 32 bit lanes
+	const __m128i dup0 = _mm_setr_epi8(0, -1, -1, -1, 0, -1, -1, -1, 1, -1, -1, -1, 1, -1, -1, -1);
+	const __m128i dup1 = _mm_setr_epi8(2, -1, -1, -1, 2, -1, -1, -1, 3, -1, -1, -1, 3, -1, -1, -1);
+	const __m128i dup2 = _mm_setr_epi8(4, -1, -1, -1, 4, -1, -1, -1, 5, -1, -1, -1, 5, -1, -1, -1);
+	const __m128i dup3 = _mm_setr_epi8(6, -1, -1, -1, 6, -1, -1, -1, 7, -1, -1, -1, 7, -1, -1, -1);
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i y = _mm_loadu_si128((const __m128i *)(planar + i));
+		__m128i u = _mm_loadl_epi64((const __m128i *)(up + i / 2));
+		__m128i v = _mm_loadl_epi64((const __m128i *)(vp + i / 2));
+
+		__m128i r0, g0, b0, r1, g1, b1, r2, g2, b2, r3, g3, b3;
+		yuv_to_rgb_sse41(_mm_cvtepu8_epi32(y),
+		                 _mm_shuffle_epi8(u, dup0),
+		                 _mm_shuffle_epi8(v, dup0),
+		                 r0,
+		                 g0,
+		                 b0);
+		yuv_to_rgb_sse41(_mm_cvtepu8_epi32(_mm_srli_si128(y, 4)),
+		                 _mm_shuffle_epi8(u, dup1),
+		                 _mm_shuffle_epi8(v, dup1),
+		                 r1,
+		                 g1,
+		                 b1);
+		yuv_to_rgb_sse41(_mm_cvtepu8_epi32(_mm_srli_si128(y, 8)),
+		                 _mm_shuffle_epi8(u, dup2),
+		                 _mm_shuffle_epi8(v, dup2),
+		                 r2,
+		                 g2,
+		                 b2);
+		yuv_to_rgb_sse41(_mm_cvtepu8_epi32(_mm_srli_si128(y, 12)),
+		                 _mm_shuffle_epi8(u, dup3),
+		                 _mm_shuffle_epi8(v, dup3),
+		                 r3,
+		                 g3,
+		                 b3);
+
+		__m128i r = pack_sse41(r0, r1, r2, r3);
+		__m128i g = pack_sse41(g0, g1, g2, g3);
+		__m128i b = pack_sse41(b0, b1, b2, b3);
+		if (bgr) {
+			store_interleaved_sse41(dst + 3 * i, b, g, r);
+		} else {
+			store_interleaved_sse41(dst + 3 * i, r, g, b);
+		}
+	}
+	yuv422planar_to_rgb_tail(planar, dst, i, n, bgr);
+}
+
+FV_TARGET_SSE41 static void
+yuv422packed_to_rgb_sse41(const unsigned char *YUV, unsigned char *dst, unsigned int n)
+{
+	// gather Y, U and V of four pixels of a U Y0 V Y1 sequence into 32 bit lanes
+	const __m128i ym0 = _mm_setr_epi8(1, -1, -1, -1, 3, -1, -1, -1, 5, -1, -1, -1, 7, -1, -1, -1);
+	const __m128i ym1 = _mm_setr_epi8(9, -1, -1, -1, 11, -1, -1, -1, 13, -1, -1, -1, 15, -1, -1, -1);
+	const __m128i um0 = _mm_setr_epi8(0, -1, -1, -1, 0, -1, -1, -1, 4, -1, -1, -1, 4, -1, -1, -1);
+	const __m128i um1 = _mm_setr_epi8(8, -1, -1, -1, 8, -1, -1, -1, 12, -1, -1, -1, 12, -1, -1, -1);
+	const __m128i vm0 = _mm_setr_epi8(2, -1, -1, -1, 2, -1, -1, -1, 6, -1, -1, -1, 6, -1, -1, -1);
+	const __m128i vm1 = _mm_setr_epi8(10, -1, -1, -1, 10, -1, -1, -1, 14, -1, -1, -1, 14, -1, -1, -1);
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(YUV + 2 * i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(YUV + 2 * i + 16));
+
+		__m128i r0, g0, b0, r1, g1, b1, r2, g2, b2, r3, g3, b3;
+		yuv_to_rgb_sse41(_mm_shuffle_epi8(a, ym0),
+		                 _mm_shuffle_epi8(a, um0),
+		                 _mm_shuffle_epi8(a, vm0),
+		                 r0,
+		                 g0,
+		                 b0);
+		yuv_to_rgb_sse41(_mm_shuffle_epi8(a, ym1),
+		                 _mm_shuffle_epi8(a, um1),
+		                 _mm_shuffle_epi8(a, vm1),
+		                 r1,
+		                 g1,
+		                 b1);
+		yuv_to_rgb_sse41(_mm_shuffle_epi8(b, ym0),
+		                 _mm_shuffle_epi8(b, um0),
+		                 _mm_shuffle_epi8(b, vm0),
+		                 r2,
+		                 g2,
+		                 b2);
+		yuv_to_rgb_sse41(_mm_shuffle_epi8(b, ym1),
+		                 _mm_shuffle_epi8(b, um1),
+		                 _mm_shuffle_epi8(b, vm1),
+		                 r3,
+		                 g3,
+		                 b3);
+
+		store_interleaved_sse41(dst + 3 * i,
+		                        pack_sse41(r0, r1, r2, r3),
+		                        pack_sse41(g0, g1, g2, g3),
+		                        pack_sse41(b0, b1, b2, b3));
+	}
+	yuv422packed_to_rgb_tail(YUV, dst, i, n);
+}
+
+// weighted sum of four pixels, rg holds R/G pairs and b holds B/0 pairs
+FV_TARGET_SSE41 static inline __m128i
+dot_sse41(__m128i rg, __m128i b, short cr, short cg, short cb)
+{
+	const __m128i c_rg = _mm_setr_epi16(cr, cg, cr, cg, cr, cg, cr, cg);
+	const __m128i c_b  = _mm_setr_epi16(cb, 0, cb, 0, cb, 0, cb, 0);
+	return _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg, c_rg), _mm_madd_epi16(b, c_b)), 10);
+}
+
+FV_TARGET_SSE41 static inline __m128i
+chroma_sse41(__m128i rg, __m128i b, short cr, short cg, short cb)
+{
+	__m128i c = _mm_add_epi32(dot_sse41(rg, b, cr, cg, cb), _mm_set1_epi32(128));
+	return _mm_min_epi32(_mm_max_epi32(c, _mm_setzero_si128()), _mm_set1_epi32(255));
+}
+
+// 16 pixels to 16 Y and 8 U and V values in the lower half
+FV_TARGET_SSE41 static inline void
+rgb16_to_yuv422_sse41(__m128i r, __m128i g, __m128i b, __m128i &y, __m128i &u, __m128i &v)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i rg[4], bz[4];
+	for (int h = 0; h < 2; ++h) {
+		__m128i r16 = h == 0 ? _mm_unpacklo_epi8(r, zero) : _mm_unpackhi_epi8(r, zero);
+		__m128i g16 = h == 0 ? _mm_unpacklo_epi8(g, zero) : _mm_unpackhi_epi8(g, zero);
+		__m128i b16 = h == 0 ? _mm_unpacklo_epi8(b, zero) : _mm_unpackhi_epi8(b, zero);
+
+		rg[2 * h]     = _mm_unpacklo_epi16(r16, g16);
+		rg[2 * h + 1] = _mm_unpackhi_epi16(r16, g16);
+		bz[2 * h]     = _mm_unpacklo_epi16(b16, zero);
+		bz[2 * h + 1] = _mm_unpackhi_epi16(b16, zero);
+	}
+
+	__m128i ys[4], us[2], vs[2];
+	for (int k = 0; k < 4; ++k) {
+		ys[k] = dot_sse41(rg[k], bz[k], 306, 601, 117);
+	}
+	for (int k = 0; k < 2; ++k) {
+		// average the chroma of each pixel pair
+		us[k] = _mm_srli_epi32(_mm_hadd_epi32(chroma_sse41(rg[2 * k], bz[2 * k], -172, -340, 512),
+		                                      chroma_sse41(rg[2 * k + 1], bz[2 * k + 1], -172, -340, 512)),
+		                       1);
+		vs[k] = _mm_srli_epi32(_mm_hadd_epi32(chroma_sse41(rg[2 * k], bz[2 * k], 512, -429, -83),
+		                                      chroma_sse41(rg[2 * k + 1], bz[2 * k + 1], 512, -429, -83)),
+		                       1);
+	}
+
+	y = pack_sse41(ys[0], ys[1], ys[2], ys[3]);
+	u = _mm_packus_epi16(_mm_packs_epi32(us[0], us[1]), zero);
+	v = _mm_packus_epi16(_mm_packs_epi32(vs[0], vs[1]), zero);
+}
+
+FV_TARGET_SSE41 static void
+rgb_to_yuv422_sse41(const unsigned char *src, unsigned char *dst, unsigned int n, bool bgr, bool packed)
+{
+	unsigned char *up = dst + n;
+	unsigned char *vp = up + n / 2;
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i r, g, b, y, u, v;
+		if (bgr) {
+			load_deinterleaved_sse41(src + 3 * i, b, g, r);
+		} else {
+			load_deinterleaved_sse41(src + 3 * i, r, g, b);
+		}
+		rgb16_to_yuv422_sse41(r, g, b, y, u, v);
+
+		if (packed) {
+			__m128i uv = _mm_unpacklo_epi8(u, v);
+			_mm_storeu_si128((__m128i *)(dst + 2 * i), _mm_unpacklo_epi8(uv, y));
+			_mm_storeu_si128((__m128i *)(dst + 2 * i + 16), _mm_unpackhi_epi8(uv, y));
+		} else {
+			_mm_storeu_si128((__m128i *)(dst + i), y);
+			_mm_storel_epi64((__m128i *)(up + i / 2), u);
+			_mm_storel_epi64((__m128i *)(vp + i / 2), v);
+		}
+	}
+	rgb_to_yuv422_tail(src, dst, i, n, bgr, packed);
+}
+
+FV_TARGET_SSE41 static void
+grayscale_yuv422packed_sse41(const unsigned char *src, unsigned char *dst, unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i a = _mm_srli_epi16(_mm_loadu_si128((const __m128i *)(src + 2 * i)), 8);
+		__m128i b = _mm_srli_epi16(_mm_loadu_si128((const __m128i *)(src + 2 * i + 16)), 8);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(a, b));
+	}
+	grayscale_yuv422packed_tail(src, dst, i, n);
+}
+
+FV_TARGET_AVX2 static inline void
+yuv_to_rgb_avx2(__m256i y, __m256i u, __m256i v, __m256i &r, __m256i &g, __m256i &b)
+{
+	y = _mm256_mullo_epi32(_mm256_sub_epi32(y, _mm256_set1_epi32(16)), _mm256_set1_epi32(76284));
+	u = _mm256_sub_epi32(u, _mm256_set1_epi32(128));
+	v = _mm256_sub_epi32(v, _mm256_set1_epi32(128));
+
+	r = _mm256_srai_epi32(_mm256_add_epi32(y, _mm256_mullo_epi32(v, _mm256_set1_epi32(104595))), 16);
+	g = _mm256_srai_epi32(
+	  _mm256_sub_epi32(y,
+	                   _mm256_add_epi32(_mm256_mullo_epi32(u, _mm256_set1_epi32(25625)),
+	                                    _mm256_mullo_epi32(v, _mm256_set1_epi32(53281)))),
+	  16);
+	b = _mm256_srai_epi32(_mm256_add_epi32(y, _mm256_mullo_epi32(u, _mm256_set1_epi32(132252))), 16);
+}
+
+// four vectors of 32 bit lanes to 32 bytes, the packs work per 128 bit
+// lane and are put back into pixel order by the final permutation
+FV_TARGET_AVX2 static inline __m256i
+pack_avx2(__m256i a, __m256i b, __m256i c, __m256i d)
+{
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	return _mm256_permutevar8x32_epi32(
+	  _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d)), order);
+}
+
+FV_TARGET_AVX2 static inline void
+store_interleaved_avx2(unsigned char *d, __m256i c0, __m256i c1, __m256i c2)
+{
+	store_interleaved_sse41(d,
+	                        _mm256_castsi256_si128(c0),
+	                        _mm256_castsi256_si128(c1),
+	                        _mm256_castsi256_si128(c2));
+	store_interleaved_sse41(d + 48,
+	                        _mm256_extracti128_si256(c0, 1),
+	                        _mm256_extracti128_si256(c1, 1),
+	                        _mm256_extracti128_si256(c2, 1));
+}
+
+FV_TARGET_AVX2 static void
+yuv422planar_to_rgb_avx2(const unsigned char *planar,
+                         unsigned char *      dst,
+                         unsigned int         n,
+                         bool                 bgr)
+{
+	const unsigned char *up = planar + n;
+	const unsigned char *vp = up + n / 2;
+
+	unsigned int i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m128i u     = _mm_loadu_si128((const __m128i *)(up + i / 2));
+		__m128i v     = _mm_loadu_si128((const __m128i *)(vp + i / 2));
+		__m128i ud[2] = {_mm_unpacklo_epi8(u, u), _mm_unpackhi_epi8(u, u)};
+		__m128i vd[2] = {_mm_unpacklo_epi8(v, v), _mm_unpackhi_epi8(v, v)};
+
+		__m256i r[4], g[4], b[4];
+		for (int k = 0; k < 4; ++k) {
+			__m128i y  = _mm_loadl_epi64((const __m128i *)(planar + i + 8 * k));
+			__m128i uk = (k % 2 == 0) ? ud[k / 2] : _mm_srli_si128(ud[k / 2], 8);
+			__m128i vk = (k % 2 == 0) ? vd[k / 2] : _mm_srli_si128(vd[k / 2], 8);
+			yuv_to_rgb_avx2(_mm256_cvtepu8_epi32(y),
+			                _mm256_cvtepu8_epi32(uk),
+			                _mm256_cvtepu8_epi32(vk),
+			                r[k],
+			                g[k],
+			                b[k]);
+		}
+
+		__m256i rp = pack_avx2(r[0], r[1], r[2], r[3]);
+		__m256i gp = pack_avx2(g[0], g[1], g[2], g[3]);
+		__m256i bp = pack_avx2(b[0], b[1], b[2], b[3]);
+		if (bgr) {
+			store_interleaved_avx2(dst + 3 * i, bp, gp, rp);
+		} else {
+			store_interleaved_avx2(dst + 3 * i, rp, gp, bp);
+		}
+	}
+	yuv422planar_to_rgb_tail(planar, dst, i, n, bgr);
+}
+
+FV_TARGET_AVX2 static void
+yuv422packed_to_rgb_avx2(const unsigned char *YUV, unsigned char *dst, unsigned int n)
+{
+	// the lower lane gathers the first, the upper lane the second four
+	// pixels of 16 bytes of U Y0 V Y1 data broadcast to both lanes
+	const __m256i ym = _mm256_setr_epi8(1, -1, -1, -1, 3, -1, -1, -1, 5, -1, -1, -1, 7, -1, -1, -1,
+	                                    9, -1, -1, -1, 11, -1, -1, -1, 13, -1, -1, -1, 15, -1, -1, -1);
+	const __m256i um = _mm256_setr_epi8(0, -1, -1, -1, 0, -1, -1, -1, 4, -1, -1, -1, 4, -1, -1, -1,
+	                                    8, -1, -1, -1, 8, -1, -1, -1, 12, -1, -1, -1, 12, -1, -1, -1);
+	const __m256i vm = _mm256_setr_epi8(2, -1, -1, -1, 2, -1, -1, -1, 6, -1, -1, -1, 6, -1, -1, -1,
+	                                    10, -1, -1, -1, 10, -1, -1, -1, 14, -1, -1, -1, 14, -1, -1, -1);
+
+	unsigned int i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m256i r[4], g[4], b[4];
+		for (int k = 0; k < 4; ++k) {
+			__m256i c = _mm256_broadcastsi128_si256(
+			  _mm_loadu_si128((const __m128i *)(YUV + 2 * i + 16 * k)));
+			yuv_to_rgb_avx2(_mm256_shuffle_epi8(c, ym),
+			                _mm256_shuffle_epi8(c, um),
+			                _mm256_shuffle_epi8(c, vm),
+			                r[k],
+			                g[k],
+			                b[k]);
+		}
+
+		store_interleaved_avx2(dst + 3 * i,
+		                       pack_avx2(r[0], r[1], r[2], r[3]),
+		                       pack_avx2(g[0], g[1], g[2], g[3]),
+		                       pack_avx2(b[0], b[1], b[2], b[3]));
+	}
+	yuv422packed_to_rgb_tail(YUV, dst, i, n);
+}
+
+FV_TARGET_AVX2 static void
+grayscale_yuv422packed_avx2(const unsigned char *src, unsigned char *dst, unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m256i a = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)(src + 2 * i)), 8);
+		__m256i b = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)(src + 2 * i + 32)), 8);
+		// packus works per 128 bit lane, restore the order of the 64 bit blocks
+		_mm256_storeu_si256((__m256i *)(dst + i),
+		                    _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+	}
+	grayscale_yuv422packed_tail(src, dst, i, n);
+}
+
+FV_TARGET_SSE41 static void
+rgb_planar_to_rgb_sse41(const unsigned char *src, unsigned char *dst, unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		store_interleaved_sse41(dst + 3 * i,
+		                        _mm_loadu_si128((const __m128i *)(src + i)),
+		                        _mm_loadu_si128((const __m128i *)(src + n + i)),
+		                        _mm_loadu_si128((const __m128i *)(src + 2 * n + i)));
+	}
+	for (; i < n; ++i) {
+		dst[3 * i]     = src[i];
+		dst[3 * i + 1] = src[n + i];
+		dst[3 * i + 2] = src[2 * n + i];
+	}
+}
+
+FV_TARGET_SSE41 static void
+rgb_planar_to_yuv422planar_sse41(const unsigned char *src, unsigned char *dst, unsigned int n)
+{
+	unsigned char *up = dst + n;
+	unsigned char *vp = up + n / 2;
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i y, u, v;
+		rgb16_to_yuv422_sse41(_mm_loadu_si128((const __m128i *)(src + i)),
+		                      _mm_loadu_si128((const __m128i *)(src + n + i)),
+		                      _mm_loadu_si128((const __m128i *)(src + 2 * n + i)),
+		                      y,
+		                      u,
+		                      v);
+		_mm_storeu_si128((__m128i *)(dst + i), y);
+		_mm_storel_epi64((__m128i *)(up + i / 2), u);
+		_mm_storel_epi64((__m128i *)(vp + i / 2), v);
+	}
+	rgb_planar_to_yuv422planar_tail(src, dst, i, n);
+}
+
+// rounded average of four vectors, (a + b + c + d + 2) / 4
+FV_TARGET_SSE41 static inline __m128i
+avg4_sse41(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two  = _mm_set1_epi16(2);
+
+	__m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+	                           _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+	__m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)),
+	                           _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+	return _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(lo, two), 2),
+	                        _mm_srli_epi16(_mm_add_epi16(hi, two), 2));
+}
+
+FV_TARGET_SSE41 static void
+bayer_row_bilinear_sse41(const unsigned char *above,
+                         const unsigned char *row,
+                         const unsigned char *below,
+                         unsigned int         width,
+                         bool                 green_first,
+                         unsigned char *      row_color,
+                         unsigned char *      green,
+                         unsigned char *      other_color)
+{
+	// selects the green sites of the row
+	const __m128i gmask = green_first ? _mm_set1_epi16(0x00FF) : _mm_set1_epi16((short)0xFF00);
+
+	unsigned int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		__m128i c  = _mm_loadu_si128((const __m128i *)(row + i));
+		__m128i l  = _mm_loadu_si128((const __m128i *)(row + i - 1));
+		__m128i r  = _mm_loadu_si128((const __m128i *)(row + i + 1));
+		__m128i u  = _mm_loadu_si128((const __m128i *)(above + i));
+		__m128i d  = _mm_loadu_si128((const __m128i *)(below + i));
+		__m128i ul = _mm_loadu_si128((const __m128i *)(above + i - 1));
+		__m128i ur = _mm_loadu_si128((const __m128i *)(above + i + 1));
+		__m128i dl = _mm_loadu_si128((const __m128i *)(below + i - 1));
+		__m128i dr = _mm_loadu_si128((const __m128i *)(below + i + 1));
+
+		_mm_storeu_si128((__m128i *)(row_color + i), _mm_blendv_epi8(c, _mm_avg_epu8(l, r), gmask));
+		_mm_storeu_si128((__m128i *)(green + i), _mm_blendv_epi8(avg4_sse41(l, r, u, d), c, gmask));
+		_mm_storeu_si128((__m128i *)(other_color + i),
+		                 _mm_blendv_epi8(avg4_sse41(ul, ur, dl, dr), _mm_avg_epu8(u, d), gmask));
+	}
+	bayer_row_bilinear_tail(above, row, below, i, width, green_first, row_color, green, other_color);
+}
+
+FV_TARGET_AVX2 static inline __m256i
+avg4_avx2(__m256i a, __m256i b, __m256i c, __m256i d)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i two  = _mm256_set1_epi16(2);
+
+	// unpack and pack both work per 128 bit lane and keep the pixel order
+	__m256i lo = _mm256_add_epi16(
+	  _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)),
+	  _mm256_add_epi16(_mm256_unpacklo_epi8(c, zero), _mm256_unpacklo_epi8(d, zero)));
+	__m256i hi = _mm256_add_epi16(
+	  _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)),
+	  _mm256_add_epi16(_mm256_unpackhi_epi8(c, zero), _mm256_unpackhi_epi8(d, zero)));
+	return _mm256_packus_epi16(_mm256_srli_epi16(_mm256_add_epi16(lo, two), 2),
+	                           _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2));
+}
+
+FV_TARGET_AVX2 static void
+bayer_row_bilinear_avx2(const unsigned char *above,
+                        const unsigned char *row,
+                        const unsigned char *below,
+                        unsigned int         width,
+                        bool                 green_first,
+                        unsigned char *      row_color,
+                        unsigned char *      green,
+                        unsigned char *      other_color)
+{
+	const __m256i gmask =
+	  green_first ? _mm256_set1_epi16(0x00FF) : _mm256_set1_epi16((short)0xFF00);
+
+	unsigned int i = 0;
+	for (; i + 32 <= width; i += 32) {
+		__m256i c  = _mm256_loadu_si256((const __m256i *)(row + i));
+		__m256i l  = _mm256_loadu_si256((const __m256i *)(row + i - 1));
+		__m256i r  = _mm256_loadu_si256((const __m256i *)(row + i + 1));
+		__m256i u  = _mm256_loadu_si256((const __m256i *)(above + i));
+		__m256i d  = _mm256_loadu_si256((const __m256i *)(below + i));
+		__m256i ul = _mm256_loadu_si256((const __m256i *)(above + i - 1));
+		__m256i ur = _mm256_loadu_si256((const __m256i *)(above + i + 1));
+		__m256i dl = _mm256_loadu_si256((const __m256i *)(below + i - 1));
+		__m256i dr = _mm256_loadu_si256((const __m256i *)(below + i + 1));
+
+		_mm256_storeu_si256((__m256i *)(row_color + i),
+		                    _mm256_blendv_epi8(c, _mm256_avg_epu8(l, r), gmask));
+		_mm256_storeu_si256((__m256i *)(green + i),
+		                    _mm256_blendv_epi8(avg4_avx2(l, r, u, d), c, gmask));
+		_mm256_storeu_si256((__m256i *)(other_color + i),
+		                    _mm256_blendv_epi8(avg4_avx2(ul, ur, dl, dr), _mm256_avg_epu8(u, d), gmask));
+	}
+	bayer_row_bilinear_tail(above, row, below, i, width, green_first, row_color, green, other_color);
+}
+
+// Positions and weights of eight pixels are computed in vector registers,
+// the pixels are gathered with scalar loads, the left and right neighbour
+// with one 16 bit load, and then interpolated in vector registers.
+FV_TARGET_SSE41 static void
+remap_bilinear_sse41(const unsigned char *plane,
+                     unsigned int         line_step,
+                     const uint16_t *     map,
+                     unsigned char *      dst,
+                     unsigned int         n)
+{
+	const __m128i sixteen = _mm_set1_epi16(16);
+	const __m128i round   = _mm_set1_epi16(128);
+	const __m128i frac    = _mm_set1_epi32(0xF);
+	const __m128i step    = _mm_set1_epi32(line_step);
+	// weight bytes (16 - fx, fx) from fx in the low byte of each word
+	const __m128i wshuf = _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14);
+	const __m128i wmul  = _mm_set1_epi16(0x01FF);
+	const __m128i wadd  = _mm_set1_epi16(0x0010);
+
+	uint32_t offsets[8];
+	uint16_t top[8], bottom[8];
+
+	unsigned int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		// x and y are interleaved, split into 32 bit lanes
+		__m128i m0 = _mm_loadu_si128((const __m128i *)(map + 2 * i));
+		__m128i m1 = _mm_loadu_si128((const __m128i *)(map + 2 * i + 8));
+		__m128i x0 = _mm_and_si128(m0, _mm_set1_epi32(0xFFFF));
+		__m128i x1 = _mm_and_si128(m1, _mm_set1_epi32(0xFFFF));
+		__m128i y0 = _mm_srli_epi32(m0, 16);
+		__m128i y1 = _mm_srli_epi32(m1, 16);
+
+		_mm_storeu_si128((__m128i *)offsets,
+		                 _mm_add_epi32(_mm_mullo_epi32(_mm_srli_epi32(y0, 4), step),
+		                               _mm_srli_epi32(x0, 4)));
+		_mm_storeu_si128((__m128i *)(offsets + 4),
+		                 _mm_add_epi32(_mm_mullo_epi32(_mm_srli_epi32(y1, 4), step),
+		                               _mm_srli_epi32(x1, 4)));
+		for (unsigned int j = 0; j < 8; ++j) {
+			const unsigned char *p = plane + offsets[j];
+			memcpy(&top[j], p, 2);
+			memcpy(&bottom[j], p + line_step, 2);
+		}
+
+		__m128i fx = _mm_packus_epi32(_mm_and_si128(x0, frac), _mm_and_si128(x1, frac));
+		__m128i fy = _mm_packus_epi32(_mm_and_si128(y0, frac), _mm_and_si128(y1, frac));
+		// (fx, fx) * (-1, 1) + (16, 0) per byte pair
+		__m128i w = _mm_add_epi8(_mm_sign_epi8(_mm_shuffle_epi8(fx, wshuf), wmul), wadd);
+
+		// horizontal interpolation, at most 16 * 255 per pixel
+		__m128i t = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i *)top), w);
+		__m128i b = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i *)bottom), w);
+		// vertical interpolation, the sum fits into an unsigned 16 bit word
+		__m128i v = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(t, _mm_sub_epi16(sixteen, fy)),
+		                                        _mm_mullo_epi16(b, fy)),
+		                          round);
+		v         = _mm_srli_epi16(v, 8);
+		_mm_storel_epi64((__m128i *)(dst + i), _mm_packus_epi16(v, v));
+	}
+	remap_bilinear_tail(plane, line_step, map, dst, i, n);
+}
+
+FV_TARGET_SSE41 static void
+box_downsample_sse41(const unsigned char *src,
+                     unsigned int         line_step,
+                     unsigned char *      dst,
+                     unsigned int         n,
+                     unsigned int         factor)
+{
+	const __m128i ones = _mm_set1_epi8(1);
+
+	unsigned int i = 0;
+	if (factor == 2) {
+		const __m128i two = _mm_set1_epi16(2);
+		for (; i + 16 <= n; i += 16) {
+			const unsigned char *p = src + 2 * i;
+			// sums of horizontal pairs, then of both lines
+			__m128i lo = _mm_add_epi16(_mm_maddubs_epi16(_mm_loadu_si128((const __m128i *)p), ones),
+			                           _mm_maddubs_epi16(
+			                             _mm_loadu_si128((const __m128i *)(p + line_step)), ones));
+			__m128i hi =
+			  _mm_add_epi16(_mm_maddubs_epi16(_mm_loadu_si128((const __m128i *)(p + 16)), ones),
+			                _mm_maddubs_epi16(
+			                  _mm_loadu_si128((const __m128i *)(p + line_step + 16)), ones));
+			_mm_storeu_si128((__m128i *)(dst + i),
+			                 _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(lo, two), 2),
+			                                  _mm_srli_epi16(_mm_add_epi16(hi, two), 2)));
+		}
+	} else {
+		const __m128i eight = _mm_set1_epi16(8);
+		for (; i + 16 <= n; i += 16) {
+			// sums of horizontal pairs of all four lines, 64 pixels
+			__m128i v[4];
+			for (unsigned int k = 0; k < 4; ++k) {
+				const unsigned char *p = src + 4 * i + 16 * k;
+				v[k]                   = _mm_setzero_si128();
+				for (unsigned int y = 0; y < 4; ++y, p += line_step) {
+					v[k] =
+					  _mm_add_epi16(v[k], _mm_maddubs_epi16(_mm_loadu_si128((const __m128i *)p), ones));
+				}
+			}
+			// adjacent pairs of pair sums are the 4x4 sums
+			__m128i lo = _mm_hadd_epi16(v[0], v[1]);
+			__m128i hi = _mm_hadd_epi16(v[2], v[3]);
+			_mm_storeu_si128((__m128i *)(dst + i),
+			                 _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(lo, eight), 4),
+			                                  _mm_srli_epi16(_mm_add_epi16(hi, eight), 4)));
+		}
+	}
+	box_downsample_tail(src, line_step, dst, i, n, factor, 1);
+}
+
+// Interleaved channels, the lines are summed up in vector registers, then
+// the pixels of each block, which are channels bytes apart. Only one of
+// factor pixels is a block sum, these are collected with scalar moves.
+// Factor and channels are constant, such that all loops are unrolled.
+template <unsigned int factor, unsigned int channels>
+FV_TARGET_SSE41 static void
+box_downsample_channels_sse41(const unsigned char *src,
+                              unsigned int         line_step,
+                              unsigned char *      dst,
+                              unsigned int         n)
+{
+	const __m128i      zero  = _mm_setzero_si128();
+	const unsigned int shift = (factor == 4) ? 4 : 2;
+	const __m128i      round = _mm_set1_epi16(1 << (shift - 1));
+	// 16 pixels, plus padding for the reads of the last block sums
+	const unsigned int span = 16 * factor * channels;
+	uint16_t           sums[span + 16];
+	memset(sums + span, 0, 16 * sizeof(uint16_t));
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		const unsigned char *p = src + i * factor * channels;
+		for (unsigned int b = 0; b < span; b += 16) {
+			__m128i lo = zero, hi = zero;
+			for (unsigned int y = 0; y < factor; ++y) {
+				__m128i v = _mm_loadu_si128((const __m128i *)(p + y * line_step + b));
+				lo        = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+				hi        = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+			}
+			_mm_storeu_si128((__m128i *)(sums + b), lo);
+			_mm_storeu_si128((__m128i *)(sums + b + 8), hi);
+		}
+		// in place, each step only reads sums after the ones it writes
+		for (unsigned int b = 0; b < span; b += 8) {
+			__m128i h = _mm_loadu_si128((const __m128i *)(sums + b));
+			for (unsigned int x = 1; x < factor; ++x) {
+				h = _mm_add_epi16(h, _mm_loadu_si128((const __m128i *)(sums + b + x * channels)));
+			}
+			_mm_storeu_si128((__m128i *)(sums + b), _mm_srli_epi16(_mm_add_epi16(h, round), shift));
+		}
+		unsigned char *d = dst + i * channels;
+		for (unsigned int x = 0; x < 16; ++x) {
+			for (unsigned int c = 0; c < channels; ++c) {
+				*d++ = (unsigned char)sums[x * factor * channels + c];
+			}
+		}
+	}
+	box_downsample_tail(src, line_step, dst, i, n, factor, channels);
+}
+
+template <unsigned int factor>
+FV_TARGET_SSE41 static void
+box_downsample_channels_sse41(const unsigned char *src,
+                              unsigned int         line_step,
+                              unsigned char *      dst,
+                              unsigned int         n,
+                              unsigned int         channels)
+{
+	switch (channels) {
+	case 1: box_downsample_sse41(src, line_step, dst, n, factor); break;
+	case 2: box_downsample_channels_sse41<factor, 2>(src, line_step, dst, n); break;
+	case 3: box_downsample_channels_sse41<factor, 3>(src, line_step, dst, n); break;
+	case 4: box_downsample_channels_sse41<factor, 4>(src, line_step, dst, n); break;
+	default: box_downsample_tail(src, line_step, dst, 0, n, factor, channels); break;
+	}
+}
+FV_TARGET_SSE41 static inline void
+store_point_sse41(unsigned char *p, __m128 v)
+{
+	// exactly three floats, points might be packed or carry more fields
+	_mm_storel_pi((__m64 *)p, v);
+	_mm_store_ss((float *)p + 2, _mm_movehl_ps(v, v));
+}
+
+// Coordinates of four points are computed in vector registers and then
+// transposed into one register per point.
+FV_TARGET_SSE41 static unsigned int
+depth_to_points_sse41(const uint16_t *depth,
+                      const float *   y_factors,
+                      float           z_factor,
+                      float           scale,
+                      uint16_t        no_sample,
+                      uint16_t        shadow,
+                      unsigned char * points,
+                      unsigned int    point_step,
+                      bool            compact,
+                      unsigned int *  indices,
+                      unsigned int    n)
+{
+	const __m128  vscale  = _mm_set1_ps(scale);
+	const __m128  vz      = _mm_set1_ps(z_factor);
+	const __m128i zero    = _mm_setzero_si128();
+	const __m128i vnos    = _mm_set1_epi32(no_sample);
+	const __m128i vshadow = _mm_set1_epi32(shadow);
+
+	unsigned int count = 0;
+	unsigned int i     = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i d       = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(depth + i)));
+		__m128i invalid = _mm_or_si128(_mm_cmpeq_epi32(d, zero),
+		                               _mm_or_si128(_mm_cmpeq_epi32(d, vnos),
+		                                            _mm_cmpeq_epi32(d, vshadow)));
+		__m128  mask    = _mm_castsi128_ps(invalid);
+
+		__m128 x = _mm_mul_ps(_mm_cvtepi32_ps(d), vscale);
+		__m128 y = _mm_andnot_ps(mask, _mm_mul_ps(_mm_loadu_ps(y_factors + i), x));
+		__m128 z = _mm_andnot_ps(mask, _mm_mul_ps(vz, x));
+		__m128 w = _mm_setzero_ps();
+		x        = _mm_andnot_ps(mask, x);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		if (compact) {
+			const __m128 p[4]  = {x, y, z, w};
+			int          valid = ~_mm_movemask_ps(mask) & 0xF;
+			for (unsigned int j = 0; j < 4; ++j) {
+				if (valid & (1 << j)) {
+					store_point_sse41(points + (size_t)count * point_step, p[j]);
+					if (indices) {
+						indices[count] = i + j;
+					}
+					++count;
+				}
+			}
+		} else {
+			unsigned char *p = points + (size_t)i * point_step;
+			store_point_sse41(p, x);
+			store_point_sse41(p + point_step, y);
+			store_point_sse41(p + 2 * point_step, z);
+			store_point_sse41(p + 3 * point_step, w);
+			count += 4;
+		}
+	}
+	return depth_to_points_tail(depth,
+	                            y_factors,
+	                            z_factor,
+	                            scale,
+	                            no_sample,
+	                            shadow,
+	                            points,
+	                            point_step,
+	                            compact,
+	                            indices,
+	                            i,
+	                            n,
+	                            count);
+}
+
+FV_TARGET_SSE41 static void
+absdiff_accumulate_sse41(const unsigned char *a,
+                         const unsigned char *b,
+                         uint16_t *           sums,
+                         unsigned int         n,
+                         bool                 subtract)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		__m128i d  = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+		__m128i lo = _mm_loadu_si128((const __m128i *)(sums + i));
+		__m128i hi = _mm_loadu_si128((const __m128i *)(sums + i + 8));
+		if (subtract) {
+			lo = _mm_sub_epi16(lo, _mm_unpacklo_epi8(d, zero));
+			hi = _mm_sub_epi16(hi, _mm_unpackhi_epi8(d, zero));
+		} else {
+			lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(d, zero));
+			hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(d, zero));
+		}
+		_mm_storeu_si128((__m128i *)(sums + i), lo);
+		_mm_storeu_si128((__m128i *)(sums + i + 8), hi);
+	}
+	absdiff_accumulate_tail(a, b, sums, i, n, subtract);
+}
+
+#endif /* FV_SIMD_X86 */
+
+#ifdef FV_SIMD_NEON
+
+static inline void
+yuv_to_rgb_neon(int32x4_t y, int32x4_t u, int32x4_t v, int32x4_t &r, int32x4_t &g, int32x4_t &b)
+{
+	y = vmulq_n_s32(vsubq_s32(y, vdupq_n_s32(16)), 76284);
+	u = vsubq_s32(u, vdupq_n_s32(128));
+	v = vsubq_s32(v, vdupq_n_s32(128));
+
+	r = vshrq_n_s32(vmlaq_n_s32(y, v, 104595), 16);
+	g = vshrq_n_s32(vmlsq_n_s32(vmlsq_n_s32(y, u, 25625), v, 53281), 16);
+	b = vshrq_n_s32(vmlaq_n_s32(y, u, 132252), 16);
+}
+
+static inline uint8x8_t
+pack_neon(int32x4_t a, int32x4_t b)
+{
+	return vqmovun_s16(vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+}
+
+// eight pixels, u and v hold the chroma value for each pixel
+static inline void
+yuv8_to_rgb_neon(uint8x8_t y, uint8x8_t u, uint8x8_t v, uint8x8_t &r, uint8x8_t &g, uint8x8_t &b)
+{
+	int16x8_t y16 = vreinterpretq_s16_u16(vmovl_u8(y));
+	int16x8_t u16 = vreinterpretq_s16_u16(vmovl_u8(u));
+	int16x8_t v16 = vreinterpretq_s16_u16(vmovl_u8(v));
+
+	int32x4_t r0, g0, b0, r1, g1, b1;
+	yuv_to_rgb_neon(vmovl_s16(vget_low_s16(y16)),
+	                vmovl_s16(vget_low_s16(u16)),
+	                vmovl_s16(vget_low_s16(v16)),
+	                r0,
+	                g0,
+	                b0);
+	yuv_to_rgb_neon(vmovl_s16(vget_high_s16(y16)),
+	                vmovl_s16(vget_high_s16(u16)),
+	                vmovl_s16(vget_high_s16(v16)),
+	                r1,
+	                g1,
+	                b1);
+
+	r = pack_neon(r0, r1);
+	g = pack_neon(g0, g1);
+	b = pack_neon(b0, b1);
+}
+
+static void
+yuv422planar_to_rgb_neon(const unsigned char *planar, unsigned char *dst, unsigned int n, bool bgr)
+{
+	const unsigned char *up = planar + n;
+	const unsigned char *vp = up + n / 2;
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		uint8x16_t y = vld1q_u8(planar + i);
+		uint8x8_t  u = vld1_u8(up + i / 2);
+		uint8x8_t  v = vld1_u8(vp + i / 2);
+
+		uint8x8x2_t ud = vzip_u8(u, u);
+		uint8x8x2_t vd = vzip_u8(v, v);
+
+		uint8x8_t r0, g0, b0, r1, g1, b1;
+		yuv8_to_rgb_neon(vget_low_u8(y), ud.val[0], vd.val[0], r0, g0, b0);
+		yuv8_to_rgb_neon(vget_high_u8(y), ud.val[1], vd.val[1], r1, g1, b1);
+
+		uint8x16x3_t rgb;
+		rgb.val[bgr ? 2 : 0] = vcombine_u8(r0, r1);
+		rgb.val[1]           = vcombine_u8(g0, g1);
+		rgb.val[bgr ? 0 : 2] = vcombine_u8(b0, b1);
+		vst3q_u8(dst + 3 * i, rgb);
+	}
+	yuv422planar_to_rgb_tail(planar, dst, i, n, bgr);
+}
+
+static void
+yuv422packed_to_rgb_neon(const unsigned char *YUV, unsigned char *dst, unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		// val[0] to val[3] are U, Y0, V, Y1 of eight pixel pairs
+		uint8x8x4_t p = vld4_u8(YUV + 2 * i);
+
+		uint8x8_t re, ge, be, ro, go, bo;
+		yuv8_to_rgb_neon(p.val[1], p.val[0], p.val[2], re, ge, be);
+		yuv8_to_rgb_neon(p.val[3], p.val[0], p.val[2], ro, go, bo);
+
+		uint8x8x2_t  r = vzip_u8(re, ro);
+		uint8x8x2_t  g = vzip_u8(ge, go);
+		uint8x8x2_t  b = vzip_u8(be, bo);
+		uint8x16x3_t rgb;
+		rgb.val[0] = vcombine_u8(r.val[0], r.val[1]);
+		rgb.val[1] = vcombine_u8(g.val[0], g.val[1]);
+		rgb.val[2] = vcombine_u8(b.val[0], b.val[1]);
+		vst3q_u8(dst + 3 * i, rgb);
+	}
+	yuv422packed_to_rgb_tail(YUV, dst, i, n);
+}
+
+static inline int32x4_t
+dot_neon(int32x4_t r, int32x4_t g, int32x4_t b, int cr, int cg, int cb)
+{
+	return vshrq_n_s32(vmlaq_n_s32(vmlaq_n_s32(vmulq_n_s32(r, cr), g, cg), b, cb), 10);
+}
+
+// eight pixels to eight Y and four U and V values
+static inline void
+rgb8_to_yuv422_neon(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t &y, int16x4_t &u, int16x4_t &v)
+{
+	int16x8_t r16 = vreinterpretq_s16_u16(vmovl_u8(r));
+	int16x8_t g16 = vreinterpretq_s16_u16(vmovl_u8(g));
+	int16x8_t b16 = vreinterpretq_s16_u16(vmovl_u8(b));
+
+	int32x4_t rl = vmovl_s16(vget_low_s16(r16)), rh = vmovl_s16(vget_high_s16(r16));
+	int32x4_t gl = vmovl_s16(vget_low_s16(g16)), gh = vmovl_s16(vget_high_s16(g16));
+	int32x4_t bl = vmovl_s16(vget_low_s16(b16)), bh = vmovl_s16(vget_high_s16(b16));
+
+	y = pack_neon(dot_neon(rl, gl, bl, 306, 601, 117), dot_neon(rh, gh, bh, 306, 601, 117));
+
+	const int16x8_t c128 = vdupq_n_s16(128);
+	const int16x8_t c255 = vdupq_n_s16(255);
+	const int16x8_t zero = vdupq_n_s16(0);
+
+	int16x8_t u16 = vaddq_s16(vcombine_s16(vqmovn_s32(dot_neon(rl, gl, bl, -172, -340, 512)),
+	                                       vqmovn_s32(dot_neon(rh, gh, bh, -172, -340, 512))),
+	                          c128);
+	int16x8_t v16 = vaddq_s16(vcombine_s16(vqmovn_s32(dot_neon(rl, gl, bl, 512, -429, -83)),
+	                                       vqmovn_s32(dot_neon(rh, gh, bh, 512, -429, -83))),
+	                          c128);
+	u16           = vminq_s16(vmaxq_s16(u16, zero), c255);
+	v16           = vminq_s16(vmaxq_s16(v16, zero), c255);
+
+	// average the chroma of each pixel pair
+	u = vmovn_s32(vshrq_n_s32(vpaddlq_s16(u16), 1));
+	v = vmovn_s32(vshrq_n_s32(vpaddlq_s16(v16), 1));
+}
+
+static void
+rgb_to_yuv422_neon(const unsigned char *src, unsigned char *dst, unsigned int n, bool bgr, bool packed)
+{
+	unsigned char *up = dst + n;
+	unsigned char *vp = up + n / 2;
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		uint8x16x3_t p = vld3q_u8(src + 3 * i);
+		uint8x16_t   r = p.val[bgr ? 2 : 0];
+		uint8x16_t   g = p.val[1];
+		uint8x16_t   b = p.val[bgr ? 0 : 2];
+
+		uint8x8_t y0, y1;
+		int16x4_t u0, v0, u1, v1;
+		rgb8_to_yuv422_neon(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b), y0, u0, v0);
+		rgb8_to_yuv422_neon(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b), y1, u1, v1);
+
+		uint8x8_t u = vqmovun_s16(vcombine_s16(u0, u1));
+		uint8x8_t v = vqmovun_s16(vcombine_s16(v0, v1));
+
+		if (packed) {
+			uint8x8x2_t y = vuzp_u8(y0, y1);
+			uint8x8x4_t q;
+			q.val[0] = u;
+			q.val[1] = y.val[0];
+			q.val[2] = v;
+			q.val[3] = y.val[1];
+			vst4_u8(dst + 2 * i, q);
+		} else {
+			vst1q_u8(dst + i, vcombine_u8(y0, y1));
+			vst1_u8(up + i / 2, u);
+			vst1_u8(vp + i / 2, v);
+		}
+	}
+	rgb_to_yuv422_tail(src, dst, i, n, bgr, packed);
+}
+
+static void
+grayscale_yuv422packed_neon(const unsigned char *src, unsigned char *dst, unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		vst1q_u8(dst + i, vld2q_u8(src + 2 * i).val[1]);
+	}
+	grayscale_yuv422packed_tail(src, dst, i, n);
+}
+
+static void
+rgb_planar_to_rgb_neon(const unsigned char *src, unsigned char *dst, unsigned int n)
+{
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		uint8x16x3_t rgb;
+		rgb.val[0] = vld1q_u8(src + i);
+		rgb.val[1] = vld1q_u8(src + n + i);
+		rgb.val[2] = vld1q_u8(src + 2 * n + i);
+		vst3q_u8(dst + 3 * i, rgb);
+	}
+	for (; i < n; ++i) {
+		dst[3 * i]     = src[i];
+		dst[3 * i + 1] = src[n + i];
+		dst[3 * i + 2] = src[2 * n + i];
+	}
+}
+
+static void
+rgb_planar_to_yuv422planar_neon(const unsigned char *src, unsigned char *dst, unsigned int n)
+{
+	unsigned char *up = dst + n;
+	unsigned char *vp = up + n / 2;
+
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		uint8x16_t r = vld1q_u8(src + i);
+		uint8x16_t g = vld1q_u8(src + n + i);
+		uint8x16_t b = vld1q_u8(src + 2 * n + i);
+
+		uint8x8_t y0, y1;
+		int16x4_t u0, v0, u1, v1;
+		rgb8_to_yuv422_neon(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b), y0, u0, v0);
+		rgb8_to_yuv422_neon(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b), y1, u1, v1);
+
+		vst1q_u8(dst + i, vcombine_u8(y0, y1));
+		vst1_u8(up + i / 2, vqmovun_s16(vcombine_s16(u0, u1)));
+		vst1_u8(vp + i / 2, vqmovun_s16(vcombine_s16(v0, v1)));
+	}
+	rgb_planar_to_yuv422planar_tail(src, dst, i, n);
+}
+
+// rounded average of four vectors, (a + b + c + d + 2) / 4
+static inline uint8x16_t
+avg4_neon(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d)
+{
+	uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(a), vget_low_u8(b)),
+	                          vaddl_u8(vget_low_u8(c), vget_low_u8(d)));
+	uint16x8_t hi = vaddq_u16(vaddl_u8(vget_high_u8(a), vget_high_u8(b)),
+	                          vaddl_u8(vget_high_u8(c), vget_high_u8(d)));
+	return vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2));
+}
+
+static void
+bayer_row_bilinear_neon(const unsigned char *above,
+                        const unsigned char *row,
+                        const unsigned char *below,
+                        unsigned int         width,
+                        bool                 green_first,
+                        unsigned char *      row_color,
+                        unsigned char *      green,
+                        unsigned char *      other_color)
+{
+	const uint8x16_t gmask = vreinterpretq_u8_u16(vdupq_n_u16(green_first ? 0x00FF : 0xFF00));
+
+	unsigned int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		uint8x16_t c  = vld1q_u8(row + i);
+		uint8x16_t l  = vld1q_u8(row + i - 1);
+		uint8x16_t r  = vld1q_u8(row + i + 1);
+		uint8x16_t u  = vld1q_u8(above + i);
+		uint8x16_t d  = vld1q_u8(below + i);
+		uint8x16_t ul = vld1q_u8(above + i - 1);
+		uint8x16_t ur = vld1q_u8(above + i + 1);
+		uint8x16_t dl = vld1q_u8(below + i - 1);
+		uint8x16_t dr = vld1q_u8(below + i + 1);
+
+		vst1q_u8(row_color + i, vbslq_u8(gmask, vrhaddq_u8(l, r), c));
+		vst1q_u8(green + i, vbslq_u8(gmask, c, avg4_neon(l, r, u, d)));
+		vst1q_u8(other_color + i, vbslq_u8(gmask, vrhaddq_u8(u, d), avg4_neon(ul, ur, dl, dr)));
+	}
+	bayer_row_bilinear_tail(above, row, below, i, width, green_first, row_color, green, other_color);
+}
+
+static void
+absdiff_accumulate_neon(const unsigned char *a,
+                        const unsigned char *b,
+                        uint16_t *           sums,
+                        unsigned int         n,
+                        bool                 subtract)
+{
+	unsigned int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		uint8x16_t d  = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+		uint16x8_t lo = vld1q_u16(sums + i);
+		uint16x8_t hi = vld1q_u16(sums + i + 8);
+		if (subtract) {
+			lo = vsubw_u8(lo, vget_low_u8(d));
+			hi = vsubw_u8(hi, vget_high_u8(d));
+		} else {
+			lo = vaddw_u8(lo, vget_low_u8(d));
+			hi = vaddw_u8(hi, vget_high_u8(d));
+		}
+		vst1q_u16(sums + i, lo);
+		vst1q_u16(sums + i + 8, hi);
+	}
+	absdiff_accumulate_tail(a, b, sums, i, n, subtract);
+}
+
+#endif /* FV_SIMD_NEON */
+
+static simd_level_t
+detect_simd_level()
+{
+#if defined(FV_SIMD_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return SIMD_AVX2;
+	} else if (__builtin_cpu_supports("sse4.1")) {
+		return SIMD_SSE41;
+	}
+#elif defined(FV_SIMD_NEON)
+	return SIMD_NEON;
+#endif
+	return SIMD_NONE;
+}
+
+static simd_level_t
+effective_level(simd_level_t level)
+{
+	return simd_level_supported(level) ? level : simd_level();
+}
+
+/// @endcond
+
+/** Get best instruction set supported by the CPU.
+ * The CPU is queried on the first call only.
+ * @return best vector instruction set available for conversions
+ */
+simd_level_t
+simd_level()
+{
+	static const simd_level_t level = detect_simd_level();
+	return level;
+}
+
+/** Check if an instruction set can be used.
+ * @param level instruction set to check
+ * @return true if the conversions can use the given instruction set
+ * on this CPU, false otherwise
+ */
+bool
+simd_level_supported(simd_level_t level)
+{
+	switch (level) {
+	case SIMD_NONE: return true;
+	case SIMD_SSE41: return simd_level() == SIMD_SSE41 || simd_level() == SIMD_AVX2;
+	default: return simd_level() == level;
+	}
+}
+
+/** Get string for instruction set.
+ * @param level instruction set
+ * @return string representation of the instruction set
+ */
+const char *
+simd_level_to_string(simd_level_t level)
+{
+	switch (level) {
+	case SIMD_NONE: return "plainc";
+	case SIMD_SSE41: return "SSE4.1";
+	case SIMD_AVX2: return "AVX2";
+	case SIMD_NEON: return "NEON";
+	default: return "unknown";
+	}
+}
+
+/** YUV422 planar to RGB conversion.
+ * Vectorized version of yuv422planar_to_rgb_plainc() with identical results.
+ * If the requested instruction set is not available the best available
+ * one is used instead.
+ * @param planar YUV422 planar buffer
+ * @param RGB RGB buffer
+ * @param width Width of the image contained in the YUV buffer
+ * @param height Height of the image contained in the YUV buffer
+ * @param level instruction set to use
+ */
+void
+yuv422planar_to_rgb_simd(const unsigned char *planar,
+                         unsigned char *      RGB,
+                         unsigned int         width,
+                         unsigned int         height,
+                         simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2: yuv422planar_to_rgb_avx2(planar, RGB, width * height, false); break;
+	case SIMD_SSE41: yuv422planar_to_rgb_sse41(planar, RGB, width * height, false); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: yuv422planar_to_rgb_neon(planar, RGB, width * height, false); break;
+#endif
+	default: yuv422planar_to_rgb_plainc(planar, RGB, width, height); break;
+	}
+}
+
+/** YUV422 planar to BGR conversion.
+ * Vectorized version of yuv422planar_to_bgr_plainc() with identical results.
+ * If the requested instruction set is not available the best available
+ * one is used instead.
+ * @param planar YUV422 planar buffer
+ * @param BGR BGR buffer
+ * @param width Width of the image contained in the YUV buffer
+ * @param height Height of the image contained in the YUV buffer
+ * @param level instruction set to use
+ */
+void
+yuv422planar_to_bgr_simd(const unsigned char *planar,
+                         unsigned char *      BGR,
+                         unsigned int         width,
+                         unsigned int         height,
+                         simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2: yuv422planar_to_rgb_avx2(planar, BGR, width * height, true); break;
+	case SIMD_SSE41: yuv422planar_to_rgb_sse41(planar, BGR, width * height, true); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: yuv422planar_to_rgb_neon(planar, BGR, width * height, true); break;
+#endif
+	default: yuv422planar_to_bgr_plainc(planar, BGR, width, height); break;
+	}
+}
+
+/** YUV422 packed to RGB conversion.
+ * Vectorized version of yuv422packed_to_rgb_plainc() with identical results.
+ * If the requested instruction set is not available the best available
+ * one is used instead.
+ * @param YUV YUV422 packed buffer
+ * @param RGB RGB buffer
+ * @param width Width of the image contained in the YUV buffer
+ * @param height Height of the image contained in the YUV buffer
+ * @param level instruction set to use
+ */
+void
+yuv422packed_to_rgb_simd(const unsigned char *YUV,
+                         unsigned char *      RGB,
+                         unsigned int         width,
+                         unsigned int         height,
+                         simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2: yuv422packed_to_rgb_avx2(YUV, RGB, width * height); break;
+	case SIMD_SSE41: yuv422packed_to_rgb_sse41(YUV, RGB, width * height); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: yuv422packed_to_rgb_neon(YUV, RGB, width * height); break;
+#endif
+	default: yuv422packed_to_rgb_plainc(YUV, RGB, width, height); break;
+	}
+}
+
+/** RGB to YUV422 planar conversion.
+ * Vectorized version of rgb_to_yuv422planar_plainc() with identical results.
+ * The conversion is bound by the deinterleaving of the RGB data, therefore
+ * AVX2 uses the SSE4.1 implementation. If the requested instruction set is
+ * not available the best available one is used instead.
+ * @param RGB RGB buffer
+ * @param YUV YUV422 planar buffer
+ * @param width Width of the image contained in the RGB buffer
+ * @param height Height of the image contained in the RGB buffer
+ * @param level instruction set to use
+ */
+void
+rgb_to_yuv422planar_simd(const unsigned char *RGB,
+                         unsigned char *      YUV,
+                         unsigned int         width,
+                         unsigned int         height,
+                         simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41: rgb_to_yuv422_sse41(RGB, YUV, width * height, false, false); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: rgb_to_yuv422_neon(RGB, YUV, width * height, false, false); break;
+#endif
+	default: rgb_to_yuv422planar_plainc(RGB, YUV, width, height); break;
+	}
+}
+
+/** BGR to YUV422 planar conversion.
+ * Vectorized version of bgr_to_yuv422planar_plainc() with identical results.
+ * AVX2 uses the SSE4.1 implementation, see rgb_to_yuv422planar_simd().
+ * @param BGR BGR buffer
+ * @param YUV YUV422 planar buffer
+ * @param width Width of the image contained in the BGR buffer
+ * @param height Height of the image contained in the BGR buffer
+ * @param level instruction set to use
+ */
+void
+bgr_to_yuv422planar_simd(const unsigned char *BGR,
+                         unsigned char *      YUV,
+                         unsigned int         width,
+                         unsigned int         height,
+                         simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41: rgb_to_yuv422_sse41(BGR, YUV, width * height, true, false); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: rgb_to_yuv422_neon(BGR, YUV, width * height, true, false); break;
+#endif
+	default: bgr_to_yuv422planar_plainc(BGR, YUV, width, height); break;
+	}
+}
+
+/** RGB to YUV422 packed conversion.
+ * Vectorized version of rgb_to_yuv422packed_plainc() with identical results.
+ * AVX2 uses the SSE4.1 implementation, see rgb_to_yuv422planar_simd().
+ * @param RGB RGB buffer
+ * @param YUV YUV422 packed buffer
+ * @param width Width of the image contained in the RGB buffer
+ * @param height Height of the image contained in the RGB buffer
+ * @param level instruction set to use
+ */
+void
+rgb_to_yuv422packed_simd(const unsigned char *RGB,
+                         unsigned char *      YUV,
+                         unsigned int         width,
+                         unsigned int         height,
+                         simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41: rgb_to_yuv422_sse41(RGB, YUV, width * height, false, true); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: rgb_to_yuv422_neon(RGB, YUV, width * height, false, true); break;
+#endif
+	default: rgb_to_yuv422packed_plainc(RGB, YUV, width, height); break;
+	}
+}
+
+/** Extract the Y plane of a YUV422 packed image.
+ * Vectorized version of grayscale_yuv422packed() with identical results.
+ * @param src YUV422 packed buffer
+ * @param dst gray buffer of width * height bytes
+ * @param width Width of the image contained in the YUV buffer
+ * @param height Height of the image contained in the YUV buffer
+ * @param level instruction set to use
+ */
+void
+grayscale_yuv422packed_simd(const unsigned char *src,
+                            unsigned char *      dst,
+                            unsigned int         width,
+                            unsigned int         height,
+                            simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2: grayscale_yuv422packed_avx2(src, dst, width * height); break;
+	case SIMD_SSE41: grayscale_yuv422packed_sse41(src, dst, width * height); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: grayscale_yuv422packed_neon(src, dst, width * height); break;
+#endif
+	default: grayscale_yuv422packed(src, dst, width, height); break;
+	}
+}
+
+
+/** Planar RGB to RGB conversion.
+ * Vectorized version of rgb_planar_to_rgb_plainc() with identical results.
+ * AVX2 uses the SSE4.1 implementation.
+ * @param rgb_planar planar RGB buffer
+ * @param rgb RGB buffer
+ * @param width Width of the image contained in the planar RGB buffer
+ * @param height Height of the image contained in the planar RGB buffer
+ * @param level instruction set to use
+ */
+void
+rgb_planar_to_rgb_simd(const unsigned char *rgb_planar,
+                       unsigned char *      rgb,
+                       unsigned int         width,
+                       unsigned int         height,
+                       simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41: rgb_planar_to_rgb_sse41(rgb_planar, rgb, width * height); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: rgb_planar_to_rgb_neon(rgb_planar, rgb, width * height); break;
+#endif
+	default: rgb_planar_to_rgb_plainc(rgb_planar, rgb, width, height); break;
+	}
+}
+
+/** Planar RGB to YUV422 planar conversion.
+ * Uses the same formula as rgb_to_yuv422planar_plainc(). AVX2 uses the
+ * SSE4.1 implementation.
+ * @param rgb_planar planar RGB buffer
+ * @param yuv YUV422 planar buffer
+ * @param width Width of the image contained in the planar RGB buffer
+ * @param height Height of the image contained in the planar RGB buffer
+ * @param level instruction set to use
+ */
+void
+rgb_planar_to_yuv422planar_simd(const unsigned char *rgb_planar,
+                                unsigned char *      yuv,
+                                unsigned int         width,
+                                unsigned int         height,
+                                simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41: rgb_planar_to_yuv422planar_sse41(rgb_planar, yuv, width * height); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: rgb_planar_to_yuv422planar_neon(rgb_planar, yuv, width * height); break;
+#endif
+	default: rgb_planar_to_yuv422planar_tail(rgb_planar, yuv, 0, width * height); break;
+	}
+}
+
+/** Bilinear demosaicing of one row of a Bayer image.
+ * The missing colors of each pixel are the rounded averages of the
+ * nearest neighbours with that color. The row and its neighbour rows
+ * must be readable at indices -1 and @p width, e.g. by mirroring the
+ * image at its borders.
+ * @param above row above the row to demosaic
+ * @param row row to demosaic
+ * @param below row below the row to demosaic
+ * @param width number of pixels in the row
+ * @param green_first true if the first pixel of the row is green
+ * @param row_color upon return contains the color other than green which
+ * is sampled in this row, i.e. red or blue
+ * @param green upon return contains the green values of the row
+ * @param other_color upon return contains the color sampled in the
+ * neighbour rows only
+ * @param level instruction set to use
+ */
+void
+bayer_row_bilinear_simd(const unsigned char *above,
+                        const unsigned char *row,
+                        const unsigned char *below,
+                        unsigned int         width,
+                        bool                 green_first,
+                        unsigned char *      row_color,
+                        unsigned char *      green,
+                        unsigned char *      other_color,
+                        simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+		bayer_row_bilinear_avx2(above, row, below, width, green_first, row_color, green, other_color);
+		break;
+	case SIMD_SSE41:
+		bayer_row_bilinear_sse41(above, row, below, width, green_first, row_color, green, other_color);
+		break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON:
+		bayer_row_bilinear_neon(above, row, below, width, green_first, row_color, green, other_color);
+		break;
+#endif
+	default:
+		bayer_row_bilinear_tail(above, row, below, 0, width, green_first, row_color, green, other_color);
+		break;
+	}
+}
+
+/** Bilinear remapping of an image plane.
+ * Each destination pixel is interpolated from the four source pixels
+ * around a position given in 12.4 fixed point, i.e. in sixteenths of a
+ * pixel, with 8 bit weights. AVX2 uses the SSE4.1 implementation, which
+ * only computes the interpolation in vector registers, since the source
+ * pixels are scattered over the plane.
+ * @param plane source plane with one byte per pixel
+ * @param line_step bytes per line of the source plane
+ * @param map source positions, x and y for each destination pixel. The
+ * pixel right and below of each position must be within the plane, i.e.
+ * the integer part of x must be less than the width minus one and the
+ * integer part of y less than the height minus one.
+ * @param dst destination buffer, receives @p n pixels
+ * @param n number of pixels to remap
+ * @param level instruction set to use
+ */
+void
+remap_bilinear_simd(const unsigned char *plane,
+                    unsigned int         line_step,
+                    const uint16_t *     map,
+                    unsigned char *      dst,
+                    unsigned int         n,
+                    simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41: remap_bilinear_sse41(plane, line_step, map, dst, n); break;
+#endif
+	default: remap_bilinear_tail(plane, line_step, map, dst, 0, n); break;
+	}
+}
+
+/** Box downsampling of one line of an image.
+ * Each channel of a destination pixel is the rounded average of a block
+ * of @p factor x @p factor source pixels. AVX2 uses the SSE4.1
+ * implementation.
+ * @param src first of the @p factor source lines to average
+ * @param line_step bytes per line of the source image
+ * @param dst destination line, receives @p n pixels
+ * @param n number of destination pixels, the source lines must contain
+ * at least @p n times @p factor pixels
+ * @param factor downsampling factor, 2 or 4
+ * @param channels number of interleaved bytes per pixel, 1 to 4, e.g. 1
+ * for a plane of a YUV422_PLANAR image and 3 for an RGB image
+ * @param level instruction set to use
+ */
+void
+box_downsample_line_simd(const unsigned char *src,
+                         unsigned int         line_step,
+                         unsigned char *      dst,
+                         unsigned int         n,
+                         unsigned int         factor,
+                         unsigned int         channels,
+                         simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41:
+		if (factor == 4) {
+			box_downsample_channels_sse41<4>(src, line_step, dst, n, channels);
+		} else {
+			box_downsample_channels_sse41<2>(src, line_step, dst, n, channels);
+		}
+		break;
+#endif
+	default: box_downsample_tail(src, line_step, dst, 0, n, factor, channels); break;
+	}
+}
+
+/** Convert one line of a depth image to points.
+ * The X coordinate of each point is the depth scaled by @p scale, the Y
+ * coordinate is X multiplied by a factor for the pixel, and the Z
+ * coordinate is X multiplied by a factor for the whole line. With
+ * factors of the view ray through each pixel, precomputed from the
+ * camera intrinsics, this yields the point in a frame with X pointing
+ * forward without any division per pixel. Measurements of zero,
+ * @p no_sample or @p shadow are invalid. AVX2 uses the SSE4.1
+ * implementation.
+ * @param depth depth values of the line
+ * @param n number of pixels in the line
+ * @param y_factors Y factor for each pixel of the line
+ * @param z_factor Z factor for the line
+ * @param scale factor to convert depth values to the desired unit
+ * @param no_sample depth value denoting that there is no measurement
+ * @param shadow depth value denoting a shadowed pixel
+ * @param points receives the X, Y, and Z coordinates as consecutive
+ * floats for each point, further fields of the points are not touched
+ * @param point_step bytes from one point to the next in @p points
+ * @param compact false to write one point per pixel with all coordinates
+ * of invalid measurements zero, true to skip invalid measurements
+ * @param indices if not NULL and @p compact is true receives for each
+ * written point the index of its pixel in the line
+ * @param level instruction set to use
+ * @return number of points written, @p n if @p compact is false
+ */
+unsigned int
+depth_to_points_simd(const uint16_t *depth,
+                     unsigned int    n,
+                     const float *   y_factors,
+                     float           z_factor,
+                     float           scale,
+                     uint16_t        no_sample,
+                     uint16_t        shadow,
+                     float *         points,
+                     unsigned int    point_step,
+                     bool            compact,
+                     unsigned int *  indices,
+                     simd_level_t    level)
+{
+	unsigned char *p = (unsigned char *)points;
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41:
+		return depth_to_points_sse41(
+		  depth, y_factors, z_factor, scale, no_sample, shadow, p, point_step, compact, indices, n);
+#endif
+	default:
+		return depth_to_points_tail(
+		  depth, y_factors, z_factor, scale, no_sample, shadow, p, point_step, compact, indices, 0, n, 0);
+	}
+}
+
+/** Accumulate absolute differences of two lines.
+ * For each pixel the absolute difference of @p a and @p b is added to or
+ * subtracted from the 16 bit sum of the pixel. Sums wrap around on
+ * overflow, the caller must bound the number of accumulated lines. This
+ * is the inner loop of block matching, where the sums of a window
+ * column are updated as the window moves down. AVX2 uses the SSE4.1
+ * implementation.
+ * @param a first line
+ * @param b second line
+ * @param sums sums to update, one per pixel
+ * @param n number of pixels
+ * @param subtract true to subtract the differences, false to add them
+ * @param level instruction set to use
+ */
+void
+absdiff_accumulate_simd(const unsigned char *a,
+                        const unsigned char *b,
+                        uint16_t *           sums,
+                        unsigned int         n,
+                        bool                 subtract,
+                        simd_level_t         level)
+{
+	switch (effective_level(level)) {
+#ifdef FV_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE41: absdiff_accumulate_sse41(a, b, sums, n, subtract); break;
+#endif
+#ifdef FV_SIMD_NEON
+	case SIMD_NEON: absdiff_accumulate_neon(a, b, sums, n, subtract); break;
+#endif
+	default: absdiff_accumulate_tail(a, b, sums, 0, n, subtract); break;
+	}
+}
+
+} // end namespace firevision
@@ -0,0 +1,144 @@
+
+/***************************************************************************
+ *  simd.h - Vectorized colorspace conversions
+ *
+ *  Created: Thu Oct 15 04:56:11 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef FIREVISION_UTILS_COLOR_SIMD_H_
+#define FIREVISION_UTILS_COLOR_SIMD_H_
+
+#include <stdint.h>
+
+namespace firevision {
+
+/** Vector instruction sets used for colorspace conversions. */
+typedef enum {
+	SIMD_NONE  = 0, /**< Plain C implementation */
+	SIMD_SSE41 = 1, /**< x86 SSE4.1 */
+	SIMD_AVX2  = 2, /**< x86 AVX2 */
+	SIMD_NEON  = 3  /**< ARM NEON */
+} simd_level_t;
+
+simd_level_t simd_level();
+bool         simd_level_supported(simd_level_t level);
+const char * simd_level_to_string(simd_level_t level);
+
+void yuv422planar_to_rgb_simd(const unsigned char *planar,
+                              unsigned char *      RGB,
+                              unsigned int         width,
+                              unsigned int         height,
+                              simd_level_t         level = simd_level());
+
+void yuv422planar_to_bgr_simd(const unsigned char *planar,
+                              unsigned char *      BGR,
+                              unsigned int         width,
+                              unsigned int         height,
+                              simd_level_t         level = simd_level());
+
+void yuv422packed_to_rgb_simd(const unsigned char *YUV,
+                              unsigned char *      RGB,
+                              unsigned int         width,
+                              unsigned int         height,
+                              simd_level_t         level = simd_level());
+
+void rgb_to_yuv422planar_simd(const unsigned char *RGB,
+                              unsigned char *      YUV,
+                              unsigned int         width,
+                              unsigned int         height,
+                              simd_level_t         level = simd_level());
+
+void bgr_to_yuv422planar_simd(const unsigned char *BGR,
+                              unsigned char *      YUV,
+                              unsigned int         width,
+                              unsigned int         height,
+                              simd_level_t         level = simd_level());
+
+void rgb_to_yuv422packed_simd(const unsigned char *RGB,
+                              unsigned char *      YUV,
+                              unsigned int         width,
+                              unsigned int         height,
+                              simd_level_t         level = simd_level());
+
+void grayscale_yuv422packed_simd(const unsigned char *src,
+                                 unsigned char *      dst,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 simd_level_t         level = simd_level());
+
+void rgb_planar_to_rgb_simd(const unsigned char *rgb_planar,
+                            unsigned char *      rgb,
+                            unsigned int         width,
+                            unsigned int         height,
+                            simd_level_t         level = simd_level());
+
+void rgb_planar_to_yuv422planar_simd(const unsigned char *rgb_planar,
+                                     unsigned char *      yuv,
+                                     unsigned int         width,
+                                     unsigned int         height,
+                                     simd_level_t         level = simd_level());
+
+void bayer_row_bilinear_simd(const unsigned char *above,
+                             const unsigned char *row,
+                             const unsigned char *below,
+                             unsigned int         width,
+                             bool                 green_first,
+                             unsigned char *      row_color,
+                             unsigned char *      green,
+                             unsigned char *      other_color,
+                             simd_level_t         level = simd_level());
+
+void remap_bilinear_simd(const unsigned char *plane,
+                         unsigned int         line_step,
+                         const uint16_t *     map,
+                         unsigned char *      dst,
+                         unsigned int         n,
+                         simd_level_t         level = simd_level());
+
+void box_downsample_line_simd(const unsigned char *src,
+                              unsigned int         line_step,
+                              unsigned char *      dst,
+                              unsigned int         n,
+                              unsigned int         factor,
+                              unsigned int         channels = 1,
+                              simd_level_t         level    = simd_level());
+
+unsigned int depth_to_points_simd(const uint16_t *depth,
+                                  unsigned int    n,
+                                  const float *   y_factors,
+                                  float           z_factor,
+                                  float           scale,
+                                  uint16_t        no_sample,
+                                  uint16_t        shadow,
+                                  float *         points,
+                                  unsigned int    point_step,
+                                  bool            compact = false,
+                                  unsigned int *  indices = 0,
+                                  simd_level_t    level   = simd_level());
+
+void absdiff_accumulate_simd(const unsigned char *a,
+                             const unsigned char *b,
+                             uint16_t *           sums,
+                             unsigned int         n,
+                             bool                 subtract,
+                             simd_level_t         level = simd_level());
+
+} // end namespace firevision
+
+#endif
@@ -208,8 +208,12 @@ BayesColormapGenerator::consider()
 	unsigned int u;
 	unsigned int v;
 
-	for (unsigned int w = 0; w < image_width; ++w) {
-		for (unsigned int h = 0; h < image_height; ++h) {
+	Histogram *fg = fg_histos[fg_object];
+	Histogram *bg = bg_histos[fg_object];
+
+	// row by row to access the image buffer sequentially
+	for (unsigned int h = 0; h < image_height; ++h) {
+		for (unsigned int w = 0; w < image_width; ++w) {
 			y = YUV422_PLANAR_Y_AT(buffer, image_width, w, h);
 			u = YUV422_PLANAR_U_AT(buffer, image_width, image_height, w, h);
 			v = YUV422_PLANAR_V_AT(buffer, image_width, image_height, w, h);
@@ -219,14 +223,12 @@ BayesColormapGenerator::consider()
 			unsigned int v_index = (unsigned int)(v / 256.0f * float(lut_height));
 
 			if (is_in_region(w, h)) {
-				fg_histos[fg_object]->inc_value(u_index, v_index, y_index);
+				fg->inc_value(u_index, v_index, y_index);
 			} else {
-				bg_histos[fg_object]->inc_value(u_index, v_index, y_index);
+				bg->inc_value(u_index, v_index, y_index);
 			}
 		}
-		cout << "." << flush;
 	}
-	cout << endl;
 }
 
 /** Calculate. */
@@ -479,10 +481,15 @@ BayesColormapGenerator::normalize_histos()
 
 		norm_factor = norm_size / float(fg_sum + bg_sum);
 
+		// histograms are sparse, only touch bins which received samples
 		for (unsigned int x = 0; x < lut_width; ++x) {
 			for (unsigned int y = 0; y < lut_height; ++y) {
 				for (unsigned int z = 0; z < lut_depth; ++z) {
-					hval = (unsigned int)rint(float(fg->get_value(x, y, z)) * norm_factor);
+					unsigned int fval = fg->get_value(x, y, z);
+					if (fval == 0) {
+						continue;
+					}
+					hval = (unsigned int)rint(float(fval) * norm_factor);
 					h->set_value(x, y, z, hval);
 				}
 			}
@@ -514,7 +521,9 @@ BayesColormapGenerator::normalize_histos()
 				for (unsigned int z = 0; z < lut_depth; ++z) {
 					// normalize
 					hval = (unsigned int)rint(float(bg->get_value(x, y, z)) * norm_factor);
-					bh->add(x, y, z, hval);
+					if (hval != 0) {
+						bh->add(x, y, z, hval);
+					}
 
 					// substract all other normalized fg histograms
 					std::map<hint_t, Histogram *>::iterator hit;
@@ -524,7 +533,9 @@ BayesColormapGenerator::normalize_histos()
 						}
 
 						hval = hit->second->get_value(x, y, z);
-						bh->sub(x, y, z, hval);
+						if (hval != 0) {
+							bh->sub(x, y, z, hval);
+						}
 					}
 				}
 			}
@@ -537,7 +548,11 @@ BayesColormapGenerator::normalize_histos()
 	for (unsigned int x = 0; x < lut_width; ++x) {
 		for (unsigned int y = 0; y < lut_height; ++y) {
 			for (unsigned int z = 0; z < lut_depth; ++z) {
-				hval = (unsigned int)rint(float(bh->get_value(x, y, z)) * norm_factor);
+				unsigned int bval = bh->get_value(x, y, z);
+				if (bval == 0) {
+					continue;
+				}
+				hval = (unsigned int)rint(float(bval) * norm_factor);
 				bh->set_value(x, y, z, hval);
 			}
 		}
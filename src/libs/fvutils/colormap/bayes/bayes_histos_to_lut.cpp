@@ -34,15 +34,126 @@
 #include <fvutils/colormap/yuvcm.h>
 #include <fvutils/statistical/histogram.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
 namespace firevision {
 
+/// @cond INTERNALS
+namespace {
+
+typedef struct
+{
+	hint_t              object;
+	const unsigned int *values;
+	float               occurrences;
+	float               object_prob;
+	color_t             color;
+} ObjectModel;
+
+typedef struct
+{
+	std::vector<unsigned int> counts;
+	unsigned int              count_unknown;
+} ClassifyResult;
+
+/** Classify rows of the colormap.
+ * A row is a (Y, V) pair, histograms are stored with U varying fastest,
+ * hence the inner loops run over contiguous memory and are vectorized by
+ * the compiler. Rows which are empty in all histograms are classified as
+ * unknown without computing posteriors. The arithmetic is the same as in
+ * BayesHistosToLut::getAPosterioriProb().
+ */
+void
+classify_rows(const std::vector<ObjectModel> &objects,
+              YuvColormap *                   lut,
+              unsigned int                    width,
+              unsigned int                    height,
+              float                           min_probability,
+              color_t                         unknown_color,
+              unsigned int                    row_begin,
+              unsigned int                    row_end,
+              ClassifyResult &                result)
+{
+	const size_t       num_objects = objects.size();
+	std::vector<float> weighted(num_objects * width);
+	std::vector<float> sum(width);
+	std::vector<float> best(width);
+	std::vector<int>   best_k(width);
+
+	result.counts.assign(num_objects, 0);
+	result.count_unknown = 0;
+
+	for (unsigned int r = row_begin; r < row_end; ++r) {
+		unsigned int y       = r / height;
+		unsigned int v       = r % height;
+		size_t       base    = (size_t)y * width * height + (size_t)v * width;
+		unsigned int y_index = y * lut->deepness() / lut->depth();
+		unsigned int v_index = v * lut->deepness() / lut->height();
+
+		bool any = false;
+		for (size_t k = 0; k < num_objects && !any; ++k) {
+			const unsigned int *values = objects[k].values + base;
+			for (unsigned int u = 0; u < width; ++u) {
+				any |= (values[u] != 0);
+			}
+		}
+		if (!any) {
+			for (unsigned int u = 0; u < width; ++u) {
+				lut->set(y_index, u * lut->deepness() / lut->width(), v_index, unknown_color);
+			}
+			result.count_unknown += width;
+			continue;
+		}
+
+		std::fill(sum.begin(), sum.end(), 0.f);
+		for (size_t k = 0; k < num_objects; ++k) {
+			const unsigned int *values      = objects[k].values + base;
+			float *             w           = &weighted[k * width];
+			const float         occurrences = objects[k].occurrences;
+			const float         object_prob = objects[k].object_prob;
+			for (unsigned int u = 0; u < width; ++u) {
+				w[u] = float(values[u]) / occurrences * object_prob;
+				sum[u] += w[u];
+			}
+		}
+
+		std::fill(best.begin(), best.end(), 0.f);
+		std::fill(best_k.begin(), best_k.end(), -1);
+		for (size_t k = 0; k < num_objects; ++k) {
+			const float *w = &weighted[k * width];
+			for (unsigned int u = 0; u < width; ++u) {
+				float tmp = (sum[u] != 0) ? w[u] / sum[u] : 0.f;
+				if (tmp > best[u]) {
+					best[u]   = tmp;
+					best_k[u] = (int)k;
+				}
+			}
+		}
+
+		for (unsigned int u = 0; u < width; ++u) {
+			unsigned int u_index = u * lut->deepness() / lut->width();
+			if (best_k[u] >= 0 && best[u] > min_probability) {
+				result.counts[best_k[u]] += 1;
+				lut->set(y_index, u_index, v_index, objects[best_k[u]].color);
+			} else {
+				result.count_unknown += 1;
+				lut->set(y_index, u_index, v_index, unknown_color);
+			}
+		}
+	}
+}
+
+} // end anonymous namespace
+/// @endcond
+
 /** @class BayesHistosToLut <fvutils/colormap/bayes/bayes_histos_to_lut.h>
  * LUT generation by using Bayesian method on histograms.
  * Generates a YUV colormap.
@@ -79,6 +190,8 @@ BayesHistosToLut::BayesHistosToLut(std::map<hint_t, Histogram *> &histos,
 	min_prob_blue   = 0.0;
 	min_prob_white  = 0.0;
 	min_prob_black  = 0.0;
+
+	num_threads = std::max(1u, std::thread::hardware_concurrency());
 }
 
 /** Destructor. */
@@ -403,17 +516,13 @@ BayesHistosToLut::calculateLutValues(bool penalty)
      how many non-zero values its histogram has in total */
 	//  numberOfOccurrences.resize(histograms.size());
 
+	const size_t                       histogram_size = (size_t)width * height * depth;
 	map<hint_t, Histogram *>::iterator hit;
 	for (hit = histograms.begin(); hit != histograms.end(); hit++) {
-		unsigned int total = 0;
-		for (unsigned int y = 0; y < depth; ++y) {
-			for (unsigned int v = 0; v < height; ++v) {
-				for (unsigned int u = 0; u < width; ++u) {
-					unsigned int tmp = hit->second->get_value(u, v, y);
-					if (tmp > 0)
-						total += tmp;
-				}
-			}
+		const unsigned int *values = hit->second->get_histogram();
+		unsigned int        total  = 0;
+		for (size_t i = 0; i < histogram_size; ++i) {
+			total += values[i];
 		}
 		numberOfOccurrences[hit->first] = total;
 		cout << "[" << hit->first << "]: " << numberOfOccurrences[hit->first] << " occurences" << endl;
@@ -441,31 +550,70 @@ BayesHistosToLut::calculateLutValues(bool penalty)
 	unsigned int count_goal       = 0;
 	unsigned int count_unknown    = 0;
 
-	lut->reset();
+	// resolve histograms, probabilities, and colors once, not per cell
+	std::vector<ObjectModel> objects;
+	for (hit = histograms.begin(); hit != histograms.end(); hit++) {
+		ObjectModel o;
+		o.object      = hit->first;
+		o.values      = hit->second->get_histogram();
+		o.occurrences = float(numberOfOccurrences[hit->first]);
+		o.object_prob = getObjectProb(hit->first);
+		o.color       = ColorObjectMap::get_instance().get(hit->first);
+		objects.push_back(o);
+	}
+	color_t unknown_color = ColorObjectMap::get_instance().get(H_UNKNOWN);
+
+	// classify in parallel, each thread gets a contiguous range of rows
+	unsigned int num_rows = depth * height;
+	unsigned int num_jobs = std::max(1u, std::min(num_threads, num_rows));
+
+	std::vector<ClassifyResult> results(num_jobs);
+	std::vector<std::thread>    threads;
+	for (unsigned int j = 1; j < num_jobs; ++j) {
+		threads.emplace_back([&, j] {
+			classify_rows(objects,
+			              lut,
+			              width,
+			              height,
+			              min_probability,
+			              unknown_color,
+			              num_rows * j / num_jobs,
+			              num_rows * (j + 1) / num_jobs,
+			              results[j]);
+		});
+	}
+	classify_rows(objects,
+	              lut,
+	              width,
+	              height,
+	              min_probability,
+	              unknown_color,
+	              0,
+	              num_rows / num_jobs,
+	              results[0]);
+	for (auto &t : threads) {
+		t.join();
+	}
 
-	for (unsigned int y = 0; y < depth; ++y) {
-		unsigned int y_index = y * lut->deepness() / lut->depth();
-		for (unsigned int u = 0; u < width; ++u) {
-			unsigned int u_index = u * lut->deepness() / lut->width();
-			for (unsigned int v = 0; v < height; ++v) {
-				unsigned int v_index          = v * lut->deepness() / lut->height();
-				hint_t       mostLikelyObject = getMostLikelyObject(y, u, v);
-
-				switch (mostLikelyObject) {
-				case H_BALL: count_ball++; break;
-				case H_BACKGROUND: count_background++; break;
-				case H_ROBOT:
-				case H_ROBOT_OPP: count_robot++; break;
-				case H_FIELD: count_field++; break;
-				case H_LINE: count_line++; break;
-				case H_GOAL_YELLOW:
-				case H_GOAL_BLUE: count_goal++; break;
-				case H_UNKNOWN: count_unknown++; break;
-				default:
-					cout << "(BayesHistosToLut::calculateLutValues(): Invalid object." << endl;
-					throw fawkes::Exception("BayesHistosToLut::calculateLutValues(): Invalid object.");
-				}
-				lut->set(y_index, u_index, v_index, ColorObjectMap::get_instance().get(mostLikelyObject));
+	for (const ClassifyResult &r : results) {
+		count_unknown += r.count_unknown;
+		for (size_t k = 0; k < objects.size(); ++k) {
+			if (r.counts[k] == 0) {
+				continue;
+			}
+			switch (objects[k].object) {
+			case H_BALL: count_ball += r.counts[k]; break;
+			case H_BACKGROUND: count_background += r.counts[k]; break;
+			case H_ROBOT:
+			case H_ROBOT_OPP: count_robot += r.counts[k]; break;
+			case H_FIELD: count_field += r.counts[k]; break;
+			case H_LINE: count_line += r.counts[k]; break;
+			case H_GOAL_YELLOW:
+			case H_GOAL_BLUE: count_goal += r.counts[k]; break;
+			case H_UNKNOWN: count_unknown += r.counts[k]; break;
+			default:
+				cout << "(BayesHistosToLut::calculateLutValues(): Invalid object." << endl;
+				throw fawkes::Exception("BayesHistosToLut::calculateLutValues(): Invalid object.");
 			}
 		}
 	}
@@ -535,6 +683,17 @@ BayesHistosToLut::setMinProbability(float min_prob)
 	min_probability = min_prob;
 }
 
+/** Set number of threads.
+ * The colormap is computed by this many threads, by default one per
+ * CPU core.
+ * @param num_threads number of threads, at least one is used
+ */
+void
+BayesHistosToLut::setNumThreads(unsigned int num_threads)
+{
+	this->num_threads = std::max(1u, num_threads);
+}
+
 /** Set min probability for color.
  * @param min_prob minimum probability
  * @param hint color hint
@@ -65,6 +65,7 @@ public:
 
 	void setMinProbability(float min_prob);
 	void setMinProbForColor(float min_prob, hint_t hint);
+	void setNumThreads(unsigned int num_threads);
 
 	YuvColormap *get_colormap();
 
@@ -92,6 +93,8 @@ private:
 
 	float min_probability;
 
+	unsigned int num_threads;
+
 	// color thresholds:
 	float min_prob_ball;
 	float min_prob_green;
@@ -163,6 +163,10 @@ YuvColormap::constructor(unsigned int depth,
 	width_div_  = 256 / width_;
 	height_div_ = 256 / height_;
 	plane_size_ = width_ * height_;
+	// all divisors are powers of two
+	depth_shift_  = __builtin_ctz(depth_div_);
+	width_shift_  = __builtin_ctz(width_div_);
+	height_shift_ = __builtin_ctz(height_div_);
 
 	if (shmem_lut_id != NULL) {
 		shm_lut_ =
@@ -190,6 +194,39 @@ YuvColormap::~YuvColormap()
 	lut_size_ = 0;
 }
 
+/** Determine classification of a line of YUV422_PLANAR pixels.
+ * Pixel i of the line has the luminance yp[i] and the chrominance
+ * up[i / 2] and vp[i / 2]. Both pixels of a pair share the lookup of the
+ * U/V cell, only the plane is chosen per pixel.
+ * @param yp Y values of the line
+ * @param up U values of the line
+ * @param vp V values of the line
+ * @param num_pixels number of pixels to classify
+ * @param colors upon return contains the classification of each pixel, must
+ * have room for @p num_pixels values
+ */
+void
+YuvColormap::determine_line(const unsigned char *yp,
+                            const unsigned char *up,
+                            const unsigned char *vp,
+                            unsigned int         num_pixels,
+                            color_t *            colors) const
+{
+	const unsigned int ds = depth_shift_;
+	const unsigned int ps = plane_size_;
+
+	unsigned int i = 0;
+	for (; i + 1 < num_pixels; i += 2) {
+		const unsigned char *uv =
+		  lut_ + (vp[i / 2] >> height_shift_) * width_ + (up[i / 2] >> width_shift_);
+		colors[i]     = (color_t)uv[(yp[i] >> ds) * ps];
+		colors[i + 1] = (color_t)uv[(yp[i + 1] >> ds) * ps];
+	}
+	if (i < num_pixels) {
+		colors[i] = determine(yp[i], up[i / 2], vp[i / 2]);
+	}
+}
+
 void
 YuvColormap::set(unsigned int y, unsigned int u, unsigned int v, color_t c)
 {
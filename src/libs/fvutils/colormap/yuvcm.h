@@ -50,6 +50,11 @@ public:
 	virtual ~YuvColormap();
 
 	virtual color_t determine(unsigned int y, unsigned int u, unsigned int v) const;
+	void            determine_line(const unsigned char *yp,
+	                               const unsigned char *up,
+	                               const unsigned char *vp,
+	                               unsigned int         num_pixels,
+	                               color_t *            colors) const;
 	virtual void    set(unsigned int y, unsigned int u, unsigned int v, color_t c);
 
 	virtual void reset();
@@ -93,6 +98,9 @@ private:
 	unsigned int width_div_;
 	unsigned int height_div_;
 	unsigned int plane_size_;
+	unsigned int depth_shift_;
+	unsigned int width_shift_;
+	unsigned int height_shift_;
 };
 
 inline color_t
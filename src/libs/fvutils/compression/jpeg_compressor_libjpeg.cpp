@@ -24,10 +24,12 @@
 
 #include <core/exception.h>
 #include <fvutils/color/rgbyuv.h>
+#include <fvutils/color/yuv.h>
 #include <fvutils/color/yuvrgb.h>
 #include <fvutils/compression/jpeg_compressor.h>
 #include <fvutils/compression/jpeg_compressor_libjpeg.h>
 
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -185,10 +187,108 @@ fv_jpeg_memory_source_setup(j_decompress_ptr cinfo, unsigned char *ptr, size_t s
 	src->bytes_in_buffer   = size;
 }
 
+/** Lookup tables to expand YUV from video to full range. */
+class FvJpegRangeTables
+{
+public:
+	/** Constructor, fills the tables. */
+	FvJpegRangeTables()
+	{
+		for (int i = 0; i < 256; ++i) {
+			int y = (int)lrintf((i - 16) * 255.f / 219.f);
+			int c = (int)lrintf((i - 128) * 255.f / 224.f) + 128;
+			luma[i]   = (y < 0) ? 0 : ((y > 255) ? 255 : y);
+			chroma[i] = (c < 0) ? 0 : ((c > 255) ? 255 : c);
+		}
+	}
+
+	unsigned char luma[256];   /**< luminance table */
+	unsigned char chroma[256]; /**< chrominance table */
+};
+
+/** Compress a YUV422_PLANAR image as raw data.
+ * The planes are passed to libjpeg without conversion to RGB. The
+ * chrominance of each two lines is averaged for the 4:2:0 subsampling
+ * libjpeg uses by default. JPEG uses the full range of values for YCbCr
+ * while FireVision's YUV to RGB conversion assumes video range, values
+ * are expanded accordingly unless @p video_range is false. Otherwise
+ * luminance lines are read in place. Width and height must be multiples
+ * of 16.
+ * @param cinfo compression info, compression must have been started
+ * @param buffer YUV422_PLANAR image
+ * @param vflip true to flip the image vertically
+ * @param video_range true to expand values from video to full range
+ */
+static void
+fv_jpeg_write_yuv422planar_raw(j_compress_ptr       cinfo,
+                               const unsigned char *buffer,
+                               bool                 vflip,
+                               bool                 video_range)
+{
+	static const FvJpegRangeTables tables;
+
+	const unsigned int   width  = cinfo->image_width;
+	const unsigned int   height = cinfo->image_height;
+	const unsigned char *up     = YUV422_PLANAR_U_PLANE(buffer, width, height);
+	const unsigned char *vp     = YUV422_PLANAR_V_PLANE(buffer, width, height);
+	const unsigned int   cw     = width / 2;
+
+	JSAMPROW   y_rows[16];
+	JSAMPROW   u_rows[8];
+	JSAMPROW   v_rows[8];
+	JSAMPARRAY planes[3] = {y_rows, u_rows, v_rows};
+
+	unsigned char *scratch = (unsigned char *)malloc(2 * 8 * cw + (video_range ? 16 * width : 0));
+	for (unsigned int r = 0; r < 8; ++r) {
+		u_rows[r] = scratch + r * cw;
+		v_rows[r] = scratch + (8 + r) * cw;
+	}
+	unsigned char *luma = scratch + 2 * 8 * cw;
+
+	while (cinfo->next_scanline < height) {
+		unsigned int first = cinfo->next_scanline;
+		for (unsigned int r = 0; r < 16; ++r) {
+			unsigned int         line = vflip ? height - 1 - (first + r) : first + r;
+			const unsigned char *yp   = buffer + line * width;
+			if (video_range) {
+				y_rows[r] = luma + r * width;
+				for (unsigned int x = 0; x < width; ++x) {
+					y_rows[r][x] = tables.luma[yp[x]];
+				}
+			} else {
+				y_rows[r] = (JSAMPROW)yp;
+			}
+		}
+		for (unsigned int r = 0; r < 8; ++r) {
+			unsigned int         a  = vflip ? height - 1 - (first + 2 * r) : first + 2 * r;
+			unsigned int         b  = vflip ? a - 1 : a + 1;
+			const unsigned char *ua = up + a * cw, *ub = up + b * cw;
+			const unsigned char *va = vp + a * cw, *vb = vp + b * cw;
+			for (unsigned int x = 0; x < cw; ++x) {
+				u_rows[r][x] = (ua[x] + ub[x] + 1) >> 1;
+				v_rows[r][x] = (va[x] + vb[x] + 1) >> 1;
+			}
+			if (video_range) {
+				for (unsigned int x = 0; x < cw; ++x) {
+					u_rows[r][x] = tables.chroma[u_rows[r][x]];
+					v_rows[r][x] = tables.chroma[v_rows[r][x]];
+				}
+			}
+		}
+		jpeg_write_raw_data(cinfo, planes, 16);
+	}
+
+	free(scratch);
+}
+
 /// @endcond
 
 /** @class JpegImageCompressorLibJpeg <fvutils/compression/jpeg_compressor.h>
  * Jpeg image compressor.
+ * If width and height are multiples of 16 the YUV planes are handed to
+ * libjpeg as raw data. For the RGB colorspace this skips the conversion
+ * to RGB and libjpeg's conversion back to YCbCr, the values are only
+ * expanded from video to full range.
  */
 
 /** Constructor.
@@ -200,6 +300,7 @@ JpegImageCompressorLibJpeg::JpegImageCompressorLibJpeg(unsigned int
 {
 	this->quality = quality;
 	jpeg_cs       = jcs;
+	vflip         = false;
 }
 
 /** Destructor. */
@@ -253,11 +354,14 @@ JpegImageCompressorLibJpeg::compress()
 
 	jpeg_create_compress(&cinfo);
 
+	/* raw data must cover whole MCUs of 16x16 pixels */
+	bool raw = ((width % 16) == 0) && ((height % 16) == 0);
+
 	/* Setup JPEG datastructures */
 	cinfo.image_width      = width; /* image width and height, in pixels */
 	cinfo.image_height     = height;
 	cinfo.input_components = 3; /* # of color components per pixel=3 RGB */
-	if (jpeg_cs == JpegImageCompressor::JPEG_CS_RGB) {
+	if ((jpeg_cs == JpegImageCompressor::JPEG_CS_RGB) && !raw) {
 		cinfo.in_color_space = JCS_RGB;
 	} else {
 		cinfo.in_color_space = JCS_YCbCr;
@@ -277,13 +381,19 @@ JpegImageCompressorLibJpeg::compress()
 	}
 	/* Setup compression */
 	jpeg_set_defaults(&cinfo);
+	cinfo.raw_data_in = raw;
 	jpeg_set_quality(&cinfo, quality, true /* limit to baseline-JPEG values */);
 	jpeg_start_compress(&cinfo, true);
 
 	/* compress each scanline one-at-a-time */
 	row_buffer = (unsigned char *)malloc(row_stride);
 
-	if (jpeg_cs == JpegImageCompressor::JPEG_CS_RGB) {
+	if (raw) {
+		fv_jpeg_write_yuv422planar_raw(&cinfo,
+		                               buffer,
+		                               vflip,
+		                               jpeg_cs == JpegImageCompressor::JPEG_CS_RGB);
+	} else if (jpeg_cs == JpegImageCompressor::JPEG_CS_RGB) {
 		if (vflip) {
 			while (cinfo.next_scanline < cinfo.image_height) {
 				convert_line_yuv422planar_to_rgb(buffer,
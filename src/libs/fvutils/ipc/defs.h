@@ -33,4 +33,7 @@
 /** Maximum length of LUT ID (not including null-termination) */
 #define LUT_ID_MAX_LENGTH 32
 
+/** Maximum number of image slots of a shared memory image buffer */
+#define IMAGE_MAX_SLOTS 16
+
 #endif
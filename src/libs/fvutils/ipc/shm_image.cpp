@@ -22,6 +22,7 @@
  */
 
 #include <core/exception.h>
+#include <core/exceptions/software.h>
 #include <fvutils/ipc/shm_exceptions.h>
 #include <fvutils/ipc/shm_image.h>
 #include <utils/ipc/shm_exceptions.h>
@@ -33,15 +34,44 @@
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <stdint.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace fawkes;
 
 namespace firevision {
 
+/// @cond INTERNAL
+/** Get the distance of image slots in memory.
+ * Slots start at page boundaries, such that they can be handed to devices
+ * which require page-aligned buffers.
+ * @param frame_size size of one image in bytes
+ * @return distance of two slots in bytes
+ */
+static size_t
+slot_stride(size_t frame_size)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+	return ((frame_size + page - 1) / page) * page;
+}
+/// @endcond
+
 /** @class SharedMemoryImageBuffer <fvutils/ipc/shm_image.h>
  * Shared memory image buffer.
  * Write images to or retrieve images from a shared memory segment.
+ *
+ * A buffer may hold a ring of images, called slots. The writer fills a
+ * slot no reader is using, see free_slot(), and publishes it. Afterwards
+ * buffer() returns the new image. Each published image gets the next
+ * sequence number, which readers can use to detect new and skipped
+ * images. Readers which need the image to stay unchanged while they
+ * process it pin the latest complete image with ref_slot() and release
+ * it with unref_slot(). A writer must only fill slots which are neither
+ * current nor referenced. This allows acquisition and processing to run
+ * concurrently, without readers seeing partially written images and
+ * without copying images into private buffers. Devices may even write
+ * images directly into the shared memory segment.
  * @author Tim Niemueller
  */
 
@@ -57,17 +87,22 @@ namespace firevision {
  * @param cspace colorspace
  * @param width image width
  * @param height image height
+ * @param num_slots number of image slots, at most IMAGE_MAX_SLOTS
  */
 SharedMemoryImageBuffer::SharedMemoryImageBuffer(const char * image_id,
                                                  colorspace_t cspace,
                                                  unsigned int width,
-                                                 unsigned int height)
+                                                 unsigned int height,
+                                                 unsigned int num_slots)
 : SharedMemory(FIREVISION_SHM_IMAGE_MAGIC_TOKEN,
                /* read-only */ false,
                /* create */ true,
                /* destroy on delete */ true)
 {
-	constructor(image_id, cspace, width, height, false);
+	if ((num_slots == 0) || (num_slots > IMAGE_MAX_SLOTS)) {
+		throw OutOfBoundsException("Invalid number of image slots", num_slots, 1, IMAGE_MAX_SLOTS);
+	}
+	constructor(image_id, cspace, width, height, num_slots, false);
 	add_semaphore();
 }
 
@@ -87,7 +122,7 @@ SharedMemoryImageBuffer::SharedMemoryImageBuffer(const char *image_id, bool is_r
                /* create */ false,
                /* destroy */ false)
 {
-	constructor(image_id, CS_UNKNOWN, 0, 0, is_read_only);
+	constructor(image_id, CS_UNKNOWN, 0, 0, 1, is_read_only);
 }
 
 void
@@ -95,6 +130,7 @@ SharedMemoryImageBuffer::constructor(const char * image_id,
                                      colorspace_t cspace,
                                      unsigned int width,
                                      unsigned int height,
+                                     unsigned int num_slots,
                                      bool         is_read_only)
 {
 	_image_id     = strdup(image_id);
@@ -104,7 +140,7 @@ SharedMemoryImageBuffer::constructor(const char * image_id,
 	_width      = width;
 	_height     = height;
 
-	priv_header = new SharedMemoryImageBufferHeader(_image_id, _colorspace, width, height);
+	priv_header = new SharedMemoryImageBufferHeader(_image_id, _colorspace, width, height, num_slots);
 	_header     = priv_header;
 	try {
 		attach();
@@ -222,12 +258,209 @@ SharedMemoryImageBuffer::set_capture_time(long int sec, long int usec)
 }
 
 /** Get image buffer.
- * @return image buffer.
+ * @return image buffer, for a ring of images the current slot
  */
 unsigned char *
 SharedMemoryImageBuffer::buffer() const
 {
-	return (unsigned char *)_memptr;
+	return slot_buffer(current_slot());
+}
+
+/** Get number of image slots.
+ * @return number of images the buffer holds, 1 unless created as a ring
+ */
+unsigned int
+SharedMemoryImageBuffer::num_slots() const
+{
+	return (raw_header->num_slots > 1) ? raw_header->num_slots : 1;
+}
+
+/** Get current slot.
+ * @return index of the slot holding the latest image
+ */
+unsigned int
+SharedMemoryImageBuffer::current_slot() const
+{
+	return (num_slots() > 1) ? __atomic_load_n(&raw_header->current_slot, __ATOMIC_ACQUIRE) : 0;
+}
+
+/** Get sequence number of the latest image.
+ * @return sequence number of the current image, 0 if no image has been
+ * published, yet
+ */
+uint64_t
+SharedMemoryImageBuffer::sequence() const
+{
+	return __atomic_load_n(&raw_header->sequence, __ATOMIC_ACQUIRE);
+}
+
+/** Get image buffer of a slot.
+ * @param slot index of the slot, less than num_slots()
+ * @return image buffer of the slot
+ */
+unsigned char *
+SharedMemoryImageBuffer::slot_buffer(unsigned int slot) const
+{
+	unsigned int n = num_slots();
+	if (slot >= n) {
+		throw OutOfBoundsException("Invalid image slot", slot, 0, n - 1);
+	}
+	if (n == 1) {
+		return (unsigned char *)_memptr;
+	}
+
+	size_t    page  = sysconf(_SC_PAGESIZE);
+	uintptr_t first = ((uintptr_t)_memptr + page - 1) & ~(uintptr_t)(page - 1);
+	size_t    frame = colorspace_buffer_size(colorspace(), width(), height());
+	return (unsigned char *)(first + slot * slot_stride(frame));
+}
+
+/** Get sequence number of the image in a slot.
+ * @param slot index of the slot, less than num_slots()
+ * @return sequence number of the image, 0 if the slot has not been published
+ */
+uint64_t
+SharedMemoryImageBuffer::slot_sequence(unsigned int slot) const
+{
+	if (slot >= num_slots()) {
+		throw OutOfBoundsException("Invalid image slot", slot, 0, num_slots() - 1);
+	}
+	return __atomic_load_n(&raw_header->slots[slot].sequence, __ATOMIC_ACQUIRE);
+}
+
+/** Get the time when the image in a slot was captured.
+ * @param slot index of the slot, less than num_slots()
+ * @return capture time
+ */
+Time
+SharedMemoryImageBuffer::slot_capture_time(unsigned int slot) const
+{
+	if (slot >= num_slots()) {
+		throw OutOfBoundsException("Invalid image slot", slot, 0, num_slots() - 1);
+	}
+	return Time(raw_header->slots[slot].capture_time_sec, raw_header->slots[slot].capture_time_usec);
+}
+
+/** Set the time when the image in a slot was captured.
+ * Set the time before publishing the slot.
+ * @param slot index of the slot, less than num_slots()
+ * @param time capture time
+ */
+void
+SharedMemoryImageBuffer::set_slot_capture_time(unsigned int slot, const Time *time)
+{
+	if (_is_read_only) {
+		throw Exception("Buffer is read-only. Not setting capture time.");
+	}
+	if (slot >= num_slots()) {
+		throw OutOfBoundsException("Invalid image slot", slot, 0, num_slots() - 1);
+	}
+	const timeval *t                          = time->get_timeval();
+	raw_header->slots[slot].capture_time_sec  = t->tv_sec;
+	raw_header->slots[slot].capture_time_usec = t->tv_usec;
+}
+
+/** Find a slot to write the next image to.
+ * @return index of a slot which is neither current nor referenced, for a
+ * buffer with a single slot this is always 0
+ * @throw Exception thrown if all slots are in use
+ */
+unsigned int
+SharedMemoryImageBuffer::free_slot() const
+{
+	unsigned int n = num_slots();
+	if (n == 1) {
+		return 0;
+	}
+
+	// prefer the slot after the current one, such that the images
+	// readers may still look at without reference are reused last
+	unsigned int current = current_slot();
+	for (unsigned int i = 1; i < n; ++i) {
+		unsigned int slot = (current + i) % n;
+		if (slot_refcount(slot) == 0) {
+			return slot;
+		}
+	}
+	throw Exception("All %u image slots of %s are in use", n, _image_id);
+}
+
+/** Publish a slot.
+ * Makes the image in the slot the current image returned by buffer() and
+ * assigns it the next sequence number. The capture time of the slot is
+ * also set as capture time of the buffer. The buffer should be locked for
+ * writing while publishing, such that readers taking a reference see
+ * either the old or the new slot.
+ * @param slot index of the slot, less than num_slots()
+ */
+void
+SharedMemoryImageBuffer::publish_slot(unsigned int slot)
+{
+	if (_is_read_only) {
+		throw Exception("Buffer is read-only. Not publishing slot.");
+	}
+	if (slot >= num_slots()) {
+		throw OutOfBoundsException("Invalid image slot", slot, 0, num_slots() - 1);
+	}
+
+	SharedMemoryImageBuffer_slot_t &s = raw_header->slots[slot];
+
+	uint64_t sequence             = raw_header->sequence + 1;
+	raw_header->capture_time_sec  = s.capture_time_sec;
+	raw_header->capture_time_usec = s.capture_time_usec;
+	__atomic_store_n(&s.sequence, sequence, __ATOMIC_RELEASE);
+	__atomic_store_n(&raw_header->current_slot, slot, __ATOMIC_RELEASE);
+	__atomic_store_n(&raw_header->sequence, sequence, __ATOMIC_RELEASE);
+}
+
+/** Take a reference on the latest complete image.
+ * While a slot is referenced the writer does not reuse it, hence the
+ * image stays valid until the reference is released with unref_slot().
+ * Lock the buffer for reading while taking the reference, such that the
+ * current image is not replaced in the meantime.
+ * @return index of the referenced slot
+ */
+unsigned int
+SharedMemoryImageBuffer::ref_slot()
+{
+	if (_is_read_only && (num_slots() > 1)) {
+		throw Exception("Buffer is read-only. Cannot reference slot.");
+	}
+	unsigned int slot = current_slot();
+	if (num_slots() > 1) {
+		__atomic_add_fetch(&raw_header->slots[slot].refcount, 1, __ATOMIC_ACQ_REL);
+	}
+	return slot;
+}
+
+/** Release a reference on a slot.
+ * @param slot index of the slot as returned by ref_slot()
+ */
+void
+SharedMemoryImageBuffer::unref_slot(unsigned int slot)
+{
+	if (slot >= num_slots()) {
+		throw OutOfBoundsException("Invalid image slot", slot, 0, num_slots() - 1);
+	}
+	if (_is_read_only && (num_slots() > 1)) {
+		throw Exception("Buffer is read-only. Cannot release slot.");
+	}
+	if (num_slots() > 1) {
+		__atomic_sub_fetch(&raw_header->slots[slot].refcount, 1, __ATOMIC_ACQ_REL);
+	}
+}
+
+/** Get number of references on a slot.
+ * @param slot index of the slot, less than num_slots()
+ * @return number of readers holding the slot
+ */
+unsigned int
+SharedMemoryImageBuffer::slot_refcount(unsigned int slot) const
+{
+	if (slot >= num_slots()) {
+		throw OutOfBoundsException("Invalid image slot", slot, 0, num_slots() - 1);
+	}
+	return __atomic_load_n(&raw_header->slots[slot].refcount, __ATOMIC_ACQUIRE);
 }
 
 /** Get color space.
@@ -555,6 +788,7 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader()
 	_header        = NULL;
 	_orig_image_id = NULL;
 	_orig_frame_id = NULL;
+	_num_slots     = 1;
 }
 
 /** Constructor.
@@ -562,16 +796,19 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader()
  * @param colorspace colorspace
  * @param width width
  * @param height height
+ * @param num_slots number of image slots
  */
 SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const char * image_id,
                                                              colorspace_t colorspace,
                                                              unsigned int width,
-                                                             unsigned int height)
+                                                             unsigned int height,
+                                                             unsigned int num_slots)
 {
 	_image_id   = strdup(image_id);
 	_colorspace = colorspace;
 	_width      = width;
 	_height     = height;
+	_num_slots  = num_slots;
 	_header     = NULL;
 	_frame_id   = NULL;
 
@@ -579,6 +816,7 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const char * image_
 	_orig_frame_id   = NULL;
 	_orig_width      = 0;
 	_orig_height     = 0;
+	_orig_num_slots  = 1;
 	_orig_colorspace = CS_UNKNOWN;
 }
 
@@ -600,12 +838,14 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const SharedMemoryI
 	_colorspace = h->_colorspace;
 	_width      = h->_width;
 	_height     = h->_height;
+	_num_slots  = h->_num_slots;
 	_header     = h->_header;
 
 	_orig_image_id   = NULL;
 	_orig_frame_id   = NULL;
 	_orig_width      = 0;
 	_orig_height     = 0;
+	_orig_num_slots  = 1;
 	_orig_colorspace = CS_UNKNOWN;
 }
 
@@ -637,12 +877,21 @@ SharedMemoryImageBufferHeader::clone() const
 size_t
 SharedMemoryImageBufferHeader::data_size()
 {
+	size_t frame_size;
 	if (_header == NULL) {
-		return colorspace_buffer_size(_colorspace, _width, _height);
+		frame_size = colorspace_buffer_size(_colorspace, _width, _height);
+	} else {
+		frame_size = colorspace_buffer_size((colorspace_t)_header->colorspace,
+		                                    _header->width,
+		                                    _header->height);
+	}
+
+	unsigned int slots = num_slots();
+	if (slots <= 1) {
+		return frame_size;
 	} else {
-		return colorspace_buffer_size((colorspace_t)_header->colorspace,
-		                              _header->width,
-		                              _header->height);
+		// one more page to align the first slot
+		return sysconf(_SC_PAGESIZE) + slots * slot_stride(frame_size);
 	}
 }
 
@@ -658,6 +907,7 @@ SharedMemoryImageBufferHeader::matches(void *memptr)
 		if ((_colorspace == CS_UNKNOWN)
 		    || (((colorspace_t)h->colorspace == _colorspace) && (h->width == _width)
 		        && (h->height == _height)
+		        && (((h->num_slots > 1) ? h->num_slots : 1) == _num_slots)
 		        && (!_frame_id || (strncmp(h->frame_id, _frame_id, FRAME_ID_MAX_LENGTH) == 0)))) {
 			return true;
 		} else {
@@ -686,7 +936,8 @@ SharedMemoryImageBufferHeader::operator==(const SharedMemoryHeader &s) const
 	} else {
 		return ((strncmp(_image_id, h->_image_id, IMAGE_ID_MAX_LENGTH) == 0)
 		        && (!_frame_id || (strncmp(_frame_id, h->_frame_id, FRAME_ID_MAX_LENGTH) == 0))
-		        && (_colorspace == h->_colorspace) && (_width == h->_width) && (_height == h->_height));
+		        && (_colorspace == h->_colorspace) && (_width == h->_width) && (_height == h->_height)
+		        && (_num_slots == h->_num_slots));
 	}
 }
 
@@ -736,6 +987,7 @@ SharedMemoryImageBufferHeader::initialize(void *memptr)
 	header->colorspace = _colorspace;
 	header->width      = _width;
 	header->height     = _height;
+	header->num_slots  = _num_slots;
 
 	_header = header;
 }
@@ -762,6 +1014,7 @@ SharedMemoryImageBufferHeader::set(void *memptr)
 	}
 	_orig_width      = _width;
 	_orig_height     = _height;
+	_orig_num_slots  = _num_slots;
 	_orig_colorspace = _colorspace;
 	_header          = header;
 
@@ -791,6 +1044,7 @@ SharedMemoryImageBufferHeader::reset()
 	}
 	_width      = _orig_width;
 	_height     = _orig_height;
+	_num_slots  = _orig_num_slots;
 	_colorspace = _orig_colorspace;
 	_header     = NULL;
 }
@@ -831,6 +1085,27 @@ SharedMemoryImageBufferHeader::height() const
 		return _height;
 }
 
+/** Get number of image slots.
+ * @return number of image slots
+ */
+unsigned int
+SharedMemoryImageBufferHeader::num_slots() const
+{
+	if (_header)
+		return (_header->num_slots > 1) ? _header->num_slots : 1;
+	else
+		return _num_slots;
+}
+
+/** Get name of the segment.
+ * @return image ID, NULL if looking for any image
+ */
+const char *
+SharedMemoryImageBufferHeader::segment_name() const
+{
+	return _image_id;
+}
+
 /** Get image number
  * @return image number
  */
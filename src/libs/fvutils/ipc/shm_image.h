@@ -30,6 +30,7 @@
 #include <utils/ipc/shm_lister.h>
 #include <utils/time/time.h>
 
+#include <stdint.h>
 #include <string>
 
 // Magic token to identify FireVision shared memory images
@@ -37,6 +38,17 @@
 
 namespace firevision {
 
+/** Shared memory header struct for one slot of a ring of images. */
+typedef struct
+{
+	uint64_t     sequence;          /**< sequence number of the image, 0 if none */
+	long int     capture_time_sec;  /**< Time in seconds since the epoch when
+					 * the image was captured. */
+	long int     capture_time_usec; /**< Addendum to capture_time_sec in
+					 * micro seconds. */
+	unsigned int refcount;          /**< number of readers holding the slot */
+} SharedMemoryImageBuffer_slot_t;
+
 // Not that there is a relation to ITPimage_packet_header_t
 /** Shared memory header struct for FireVision images. */
 typedef struct
@@ -61,6 +73,11 @@ typedef struct
 	unsigned int flag_circle_found : 1; /**< 1 if circle found */
 	unsigned int flag_image_ready : 1;  /**< 1 if image ready */
 	unsigned int flag_reserved : 30;    /**< reserved for future use */
+	// Ring of images, see SharedMemoryImageBuffer::num_slots()
+	unsigned int                   num_slots;              /**< number of image slots */
+	unsigned int                   current_slot;           /**< slot of the latest image */
+	uint64_t                       sequence;               /**< sequence number of latest image */
+	SharedMemoryImageBuffer_slot_t slots[IMAGE_MAX_SLOTS]; /**< image slots */
 } SharedMemoryImageBuffer_header_t;
 
 class SharedMemoryImageBufferHeader : public fawkes::SharedMemoryHeader
@@ -70,7 +87,8 @@ public:
 	SharedMemoryImageBufferHeader(const char * image_id,
 	                              colorspace_t colorspace,
 	                              unsigned int width,
-	                              unsigned int height);
+	                              unsigned int height,
+	                              unsigned int num_slots = 1);
 	SharedMemoryImageBufferHeader(const SharedMemoryImageBufferHeader *h);
 	virtual ~SharedMemoryImageBufferHeader();
 
@@ -84,12 +102,14 @@ public:
 	virtual void                        reset();
 	virtual size_t                      data_size();
 	virtual bool                        operator==(const fawkes::SharedMemoryHeader &s) const;
+	virtual const char *                segment_name() const;
 
 	void         set_image_id(const char *image_id);
 	void         set_frame_id(const char *frame_id);
 	colorspace_t colorspace() const;
 	unsigned int width() const;
 	unsigned int height() const;
+	unsigned int num_slots() const;
 	const char * image_id() const;
 	const char * frame_id() const;
 
@@ -101,12 +121,14 @@ private:
 	colorspace_t _colorspace;
 	unsigned int _width;
 	unsigned int _height;
+	unsigned int _num_slots;
 
 	char *       _orig_image_id;
 	char *       _orig_frame_id;
 	colorspace_t _orig_colorspace;
 	unsigned int _orig_width;
 	unsigned int _orig_height;
+	unsigned int _orig_num_slots;
 
 	SharedMemoryImageBuffer_header_t *_header;
 };
@@ -186,7 +208,8 @@ public:
 	SharedMemoryImageBuffer(const char * image_id,
 	                        colorspace_t cspace,
 	                        unsigned int width,
-	                        unsigned int height);
+	                        unsigned int height,
+	                        unsigned int num_slots = 1);
 	SharedMemoryImageBuffer(const char *image_id, bool is_read_only = true);
 	~SharedMemoryImageBuffer();
 
@@ -222,6 +245,19 @@ public:
 	void         set_capture_time(fawkes::Time *time);
 	void         set_capture_time(long int sec, long int usec);
 
+	unsigned int   num_slots() const;
+	unsigned int   current_slot() const;
+	uint64_t       sequence() const;
+	unsigned char *slot_buffer(unsigned int slot) const;
+	uint64_t       slot_sequence(unsigned int slot) const;
+	fawkes::Time   slot_capture_time(unsigned int slot) const;
+	void           set_slot_capture_time(unsigned int slot, const fawkes::Time *time);
+	unsigned int   free_slot() const;
+	void           publish_slot(unsigned int slot);
+	unsigned int   ref_slot();
+	void           unref_slot(unsigned int slot);
+	unsigned int   slot_refcount(unsigned int slot) const;
+
 	static void list();
 	static void cleanup(bool use_lister = true);
 	static bool exists(const char *image_id);
@@ -234,6 +270,7 @@ private:
 	                 colorspace_t cspace,
 	                 unsigned int width,
 	                 unsigned int height,
+	                 unsigned int num_slots,
 	                 bool         is_read_only);
 
 	SharedMemoryImageBufferHeader *   priv_header;
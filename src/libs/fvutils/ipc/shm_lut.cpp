@@ -479,6 +479,15 @@ SharedMemoryLookupTableHeader::bytes_per_cell() const
 	return header_->bytes_per_cell;
 }
 
+/** Get name of the segment.
+ * @return LUT ID, NULL if looking for any lookup table
+ */
+const char *
+SharedMemoryLookupTableHeader::segment_name() const
+{
+	return lut_id_;
+}
+
 /** Get LUT ID.
  * @return LUT Id
  */
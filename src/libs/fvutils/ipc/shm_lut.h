@@ -70,6 +70,7 @@ public:
 	virtual void                        reset();
 	virtual size_t                      data_size();
 	virtual bool                        operator==(const fawkes::SharedMemoryHeader &s) const;
+	virtual const char *                segment_name() const;
 
 	virtual void print_info();
 
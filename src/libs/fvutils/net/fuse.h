@@ -64,12 +64,14 @@ typedef enum {
 	FUSE_MT_IMAGE_INFO_FAILED = 1009, /**< Retrieval of image info failed */
 
 	/* client to server, 2000-2999 */
-	FUSE_MT_GET_IMAGE      = 2000, /**< request image */
-	FUSE_MT_GET_LUT        = 2001, /**< request lookup table */
-	FUSE_MT_SET_LUT        = 2002, /**< set lookup table */
-	FUSE_MT_GET_IMAGE_LIST = 2003, /**< get image list */
-	FUSE_MT_GET_LUT_LIST   = 2004, /**< get LUT list */
-	FUSE_MT_GET_IMAGE_INFO = 2005, /**< get image info */
+	FUSE_MT_GET_IMAGE         = 2000, /**< request image */
+	FUSE_MT_GET_LUT           = 2001, /**< request lookup table */
+	FUSE_MT_SET_LUT           = 2002, /**< set lookup table */
+	FUSE_MT_GET_IMAGE_LIST    = 2003, /**< get image list */
+	FUSE_MT_GET_LUT_LIST      = 2004, /**< get LUT list */
+	FUSE_MT_GET_IMAGE_INFO    = 2005, /**< get image info */
+	FUSE_MT_SUBSCRIBE_IMAGE   = 2006, /**< push image on each new frame */
+	FUSE_MT_UNSUBSCRIBE_IMAGE = 2007, /**< stop pushing images */
 
 } FUSE_message_type_t;
 
@@ -151,6 +153,40 @@ typedef struct
 	uint32_t reserved : 24;                 /**< reserved for future use */
 } FUSE_imagereq_message_t;
 
+/** Image request flags. */
+typedef enum {
+	FUSE_IRF_ADAPTIVE = 1 /**< lower quality and resolution of subscribed images for slow links */
+} FUSE_imagereq_flags_t;
+
+/** Image request options.
+ * Optionally sent after a FUSE_imagereq_message_t, see
+ * FUSE_imagereq_opts_message_t. A zero value for any field requests the
+ * default, i.e. full image, no scaling and the server's JPEG quality.
+ */
+typedef struct
+{
+	uint32_t roi_x;            /**< ROI X coordinate */
+	uint32_t roi_y;            /**< ROI Y coordinate */
+	uint32_t roi_width;        /**< ROI width, 0 for full width */
+	uint32_t roi_height;       /**< ROI height, 0 for full height */
+	uint32_t scale : 8;        /**< integer downscale factor, 0 or 1 for none */
+	uint32_t jpeg_quality : 8; /**< JPEG quality 1-100, 0 for server default */
+	uint32_t flags : 8;        /**< bit-wise OR of FUSE_imagereq_flags_t */
+	uint32_t reserved : 8;     /**< reserved for future use */
+} FUSE_imagereq_options_t;
+
+/** Image request message with options.
+ * May be sent instead of FUSE_imagereq_message_t for FUSE_MT_GET_IMAGE and
+ * FUSE_MT_SUBSCRIBE_IMAGE, the server distinguishes both by payload size.
+ * ROI and scaling are applied to YUV422_PLANAR and MONO8 images only, the
+ * width and height in the image message header denote the resulting size.
+ */
+typedef struct
+{
+	FUSE_imagereq_message_t request; /**< image request */
+	FUSE_imagereq_options_t options; /**< request options, network byte order */
+} FUSE_imagereq_opts_message_t;
+
 /** Image description message. */
 typedef struct
 {
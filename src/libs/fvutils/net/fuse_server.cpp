@@ -21,23 +21,51 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <core/threading/thread_collector.h>
+#include <fvutils/color/yuv.h>
+#include <fvutils/compression/jpeg_compressor.h>
+#include <fvutils/ipc/shm_image.h>
+#include <fvutils/net/fuse_image_content.h>
+#include <fvutils/net/fuse_message.h>
 #include <fvutils/net/fuse_server.h>
 #include <fvutils/net/fuse_server_client_thread.h>
 #include <netcomm/utils/acceptor_thread.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 using namespace fawkes;
 
 namespace firevision {
 
+/** Interval after which images without capture time are encoded again; ms. */
+#define FUSE_UNTIMED_IMAGE_INTERVAL 30
+/** Time after which cached frames which have not been requested are dropped; sec. */
+#define FUSE_FRAME_EXPIRE_TIME 10
+/** JPEG quality used if the client does not request a specific one. */
+#define FUSE_DEFAULT_JPEG_QUALITY 80
+
 /** @class FuseServer <fvutils/net/fuse_server.h>
  * FireVision FUSE protocol server.
  * The FuseServer will open a StreamSocket and listen on it for incoming
  * connections. For each connection a client thread is started that will process
  * all requests issued by the client.
  *
+ * Image requests and image subscriptions of all clients are served from
+ * a shared frame cache. Each frame is copied or compressed only once per
+ * requested format and the resulting message is sent to all clients
+ * requesting it. A frame is considered new if the capture time of the image
+ * buffer changed. For images without capture time the cached frame is
+ * refreshed after FUSE_UNTIMED_IMAGE_INTERVAL ms.
+ *
+ * Clients may restrict images to a region of interest, request them
+ * downscaled by an integer factor, or set the JPEG quality, see
+ * FUSE_imagereq_options_t. Each such variant is cached separately and
+ * dropped if it has not been requested for FUSE_FRAME_EXPIRE_TIME sec.
+ *
  * @ingroup FUSE
  * @ingroup FireVision
  * @author Tim Niemueller
@@ -62,6 +90,7 @@ FuseServer::FuseServer(bool               enable_ipv4,
 : Thread("FuseServer", Thread::OPMODE_WAITFORWAKEUP)
 {
 	thread_collector_ = collector;
+	image_mutex_      = new Mutex();
 
 	if (enable_ipv4) {
 		acceptor_threads_.push_back(new NetworkAcceptorThread(
@@ -107,6 +136,324 @@ FuseServer::~FuseServer()
 		delete *cit_;
 	}
 	clients_.clear();
+
+	std::map<ImageFrameKey, ImageFrame>::iterator f;
+	for (f = image_frames_.begin(); f != image_frames_.end(); ++f) {
+		f->second.message->unref();
+	}
+	image_frames_.clear();
+
+	std::map<std::string, SharedMemoryImageBuffer *>::iterator b;
+	for (b = image_buffers_.begin(); b != image_buffers_.end(); ++b) {
+		delete b->second;
+	}
+	image_buffers_.clear();
+
+	std::map<unsigned int, JpegImageCompressor *>::iterator j;
+	for (j = jpeg_compressors_.begin(); j != jpeg_compressors_.end(); ++j) {
+		delete j->second;
+	}
+	jpeg_compressors_.clear();
+
+	delete image_mutex_;
+}
+
+/** Get message with the current frame of an image.
+ * If the frame has already been encoded in the requested format, the
+ * cached message is returned; otherwise the frame is encoded and cached.
+ * The message is packed and must not be modified, it may be enqueued to
+ * any number of client message queues at the same time.
+ * @param image_id ID of the shared memory image buffer
+ * @param format image format, one of FUSE_image_format_t
+ * @param options optional request options in host byte order, the flags
+ * are ignored
+ * @return image message, a reference is added for the caller
+ * @exception Exception thrown if the image buffer cannot be opened, the
+ * format is not supported, or the ROI is outside of the image
+ */
+FuseNetworkMessage *
+FuseServer::image_message(const char *                   image_id,
+                          unsigned int                   format,
+                          const FUSE_imagereq_options_t *options)
+{
+	if ((format != FUSE_IF_RAW) && (format != FUSE_IF_JPEG)) {
+		throw Exception("Unsupported image format %u", format);
+	}
+
+	FUSE_imagereq_options_t opts;
+	if (options) {
+		opts = *options;
+	} else {
+		memset(&opts, 0, sizeof(opts));
+	}
+	if (opts.scale == 0) {
+		opts.scale = 1;
+	}
+	if (format != FUSE_IF_JPEG) {
+		opts.jpeg_quality = 0;
+	} else if ((opts.jpeg_quality == 0) || (opts.jpeg_quality > 100)) {
+		opts.jpeg_quality = FUSE_DEFAULT_JPEG_QUALITY;
+	}
+
+	char tmp_image_id[IMAGE_ID_MAX_LENGTH + 1];
+	tmp_image_id[IMAGE_ID_MAX_LENGTH] = 0;
+	strncpy(tmp_image_id, image_id, IMAGE_ID_MAX_LENGTH);
+
+	MutexLocker lock(image_mutex_);
+	expire_image_frames();
+
+	SharedMemoryImageBuffer *                                  b;
+	std::map<std::string, SharedMemoryImageBuffer *>::iterator bi;
+	if ((bi = image_buffers_.find(tmp_image_id)) == image_buffers_.end()) {
+		b                            = new SharedMemoryImageBuffer(tmp_image_id);
+		image_buffers_[tmp_image_id] = b;
+	} else {
+		b = bi->second;
+	}
+
+	long int sec = 0, usec = 0;
+	b->capture_time(&sec, &usec);
+
+	ImageFrameKey key(tmp_image_id,
+	                  format,
+	                  opts.roi_x,
+	                  opts.roi_y,
+	                  opts.roi_width,
+	                  opts.roi_height,
+	                  (unsigned int)opts.scale,
+	                  (unsigned int)opts.jpeg_quality);
+	std::map<ImageFrameKey, ImageFrame>::iterator f;
+	if ((f = image_frames_.find(key)) != image_frames_.end()) {
+		ImageFrame &frame = f->second;
+		frame.access_time.stamp();
+		bool        fresh;
+		if ((sec == 0) && (usec == 0)) {
+			Time now;
+			fresh = ((now - frame.encode_time).in_msec() < FUSE_UNTIMED_IMAGE_INTERVAL);
+		} else {
+			fresh = (frame.capture_time_sec == sec) && (frame.capture_time_usec == usec);
+		}
+		if (fresh) {
+			frame.message->ref();
+			return frame.message;
+		}
+		frame.message->unref();
+		image_frames_.erase(f);
+	}
+
+	ImageFrame frame;
+	frame.message           = encode_image(b, format, opts);
+	frame.capture_time_sec  = sec;
+	frame.capture_time_usec = usec;
+	frame.encode_time.stamp();
+	frame.access_time  = frame.encode_time;
+	image_frames_[key] = frame;
+
+	frame.message->ref();
+	return frame.message;
+}
+
+/// @cond INTERNALS
+namespace {
+
+/** Copy region of interest of an image, subsampled by an integer factor.
+ * Only YUV422_PLANAR and MONO8 images are supported.
+ */
+void
+extract_region(const unsigned char *src,
+               colorspace_t         cspace,
+               unsigned int         width,
+               unsigned int         height,
+               unsigned int         roi_x,
+               unsigned int         roi_y,
+               unsigned int         out_width,
+               unsigned int         out_height,
+               unsigned int         scale,
+               unsigned char *      dst)
+{
+	for (unsigned int r = 0; r < out_height; ++r) {
+		const unsigned char *s = src + (size_t)(roi_y + r * scale) * width + roi_x;
+		unsigned char *      d = dst + (size_t)r * out_width;
+		if (scale == 1) {
+			memcpy(d, s, out_width);
+		} else {
+			for (unsigned int i = 0; i < out_width; ++i) {
+				d[i] = s[i * scale];
+			}
+		}
+	}
+
+	if (cspace != YUV422_PLANAR)
+		return;
+
+	// U and V planes have half the width, ROI X and output width are even
+	const unsigned char *su = YUV422_PLANAR_U_PLANE(src, width, height);
+	const unsigned char *sv = YUV422_PLANAR_V_PLANE(src, width, height);
+	unsigned char *      du = YUV422_PLANAR_U_PLANE(dst, out_width, out_height);
+	unsigned char *      dv = YUV422_PLANAR_V_PLANE(dst, out_width, out_height);
+	for (unsigned int r = 0; r < out_height; ++r) {
+		size_t soff = (size_t)(roi_y + r * scale) * (width / 2) + roi_x / 2;
+		size_t doff = (size_t)r * (out_width / 2);
+		for (unsigned int i = 0; i < out_width / 2; ++i) {
+			du[doff + i] = su[soff + i * scale];
+			dv[doff + i] = sv[soff + i * scale];
+		}
+	}
+}
+
+} // end anonymous namespace
+/// @endcond
+
+FuseNetworkMessage *
+FuseServer::encode_image(SharedMemoryImageBuffer *      b,
+                         unsigned int                   format,
+                         const FUSE_imagereq_options_t &options)
+{
+	unsigned int width  = b->width();
+	unsigned int height = b->height();
+
+	// determine region to send, only supported for planar formats
+	unsigned int roi_x = 0, roi_y = 0, out_width = width, out_height = height, scale = 1;
+	bool         crop  = false;
+	if ((b->colorspace() == YUV422_PLANAR) || (b->colorspace() == MONO8)) {
+		if ((options.roi_x >= width) || (options.roi_y >= height)) {
+			throw Exception("ROI (%u,%u) outside of image %s (%ux%u)",
+			                options.roi_x,
+			                options.roi_y,
+			                b->image_id(),
+			                width,
+			                height);
+		}
+		roi_x = options.roi_x;
+		roi_y = options.roi_y;
+		if (b->colorspace() == YUV422_PLANAR)
+			roi_x &= ~1u;
+		unsigned int roi_width  = width - roi_x;
+		unsigned int roi_height = height - roi_y;
+		if ((options.roi_width > 0) && (options.roi_width < roi_width))
+			roi_width = options.roi_width;
+		if ((options.roi_height > 0) && (options.roi_height < roi_height))
+			roi_height = options.roi_height;
+
+		scale      = options.scale;
+		out_width  = roi_width / scale;
+		out_height = roi_height / scale;
+		if (b->colorspace() == YUV422_PLANAR)
+			out_width &= ~1u;
+		if ((out_width == 0) || (out_height == 0)) {
+			throw Exception("Requested region of image %s is empty", b->image_id());
+		}
+		crop = (out_width != width) || (out_height != height);
+	}
+
+	long int sec = 0, usec = 0;
+	b->capture_time(&sec, &usec);
+
+	unsigned char *region      = NULL;
+	size_t         region_size = colorspace_buffer_size(b->colorspace(), out_width, out_height);
+	if (crop) {
+		region = (unsigned char *)malloc(region_size);
+		b->lock_for_read();
+		extract_region(b->buffer(),
+		               b->colorspace(),
+		               width,
+		               height,
+		               roi_x,
+		               roi_y,
+		               out_width,
+		               out_height,
+		               scale,
+		               region);
+		b->unlock();
+	}
+
+	FuseImageContent *im;
+	if (format == FUSE_IF_JPEG) {
+		JpegImageCompressor *jc = jpeg_compressor(options.jpeg_quality);
+		jc->set_image_dimensions(out_width, out_height);
+		unsigned char *compressed_buffer =
+		  (unsigned char *)malloc(jc->recommended_compressed_buffer_size());
+		jc->set_destination_buffer(compressed_buffer, jc->recommended_compressed_buffer_size());
+		if (crop) {
+			jc->set_image_buffer(b->colorspace(), region);
+			jc->compress();
+		} else {
+			b->lock_for_read();
+			jc->set_image_buffer(b->colorspace(), b->buffer());
+			jc->compress();
+			b->unlock();
+		}
+		im = new FuseImageContent(FUSE_IF_JPEG,
+		                          b->image_id(),
+		                          compressed_buffer,
+		                          jc->compressed_size(),
+		                          CS_UNKNOWN,
+		                          out_width,
+		                          out_height,
+		                          sec,
+		                          usec);
+		free(compressed_buffer);
+	} else if (crop) {
+		im = new FuseImageContent(FUSE_IF_RAW,
+		                          b->image_id(),
+		                          region,
+		                          region_size,
+		                          b->colorspace(),
+		                          out_width,
+		                          out_height,
+		                          sec,
+		                          usec);
+	} else {
+		im = new FuseImageContent(b);
+	}
+	free(region);
+
+	// take over the serialized payload, the message is shared among client
+	// threads and must not be touched by packing it on send
+	im->serialize();
+	FuseNetworkMessage *m = new FuseNetworkMessage(FUSE_MT_IMAGE, im->payload(), im->payload_size());
+	delete im;
+	return m;
+}
+
+/** Get JPEG compressor for a quality.
+ * Compressors are created on first use and kept for further frames.
+ * @param quality JPEG quality
+ * @return JPEG compressor
+ */
+JpegImageCompressor *
+FuseServer::jpeg_compressor(unsigned int quality)
+{
+	std::map<unsigned int, JpegImageCompressor *>::iterator j;
+	if ((j = jpeg_compressors_.find(quality)) != jpeg_compressors_.end()) {
+		return j->second;
+	}
+	JpegImageCompressor *jc = new JpegImageCompressor(quality);
+	jc->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
+	jpeg_compressors_[quality] = jc;
+	return jc;
+}
+
+/** Drop cached frames which have not been requested recently.
+ * Called with the image mutex locked.
+ */
+void
+FuseServer::expire_image_frames()
+{
+	Time now;
+	if ((now - last_expire_).in_sec() < 1.0)
+		return;
+	last_expire_ = now;
+
+	std::map<ImageFrameKey, ImageFrame>::iterator f = image_frames_.begin();
+	while (f != image_frames_.end()) {
+		if ((now - f->second.access_time).in_sec() > FUSE_FRAME_EXPIRE_TIME) {
+			f->second.message->unref();
+			image_frames_.erase(f++);
+		} else {
+			++f;
+		}
+	}
 }
 
 void
@@ -26,19 +26,27 @@
 
 #include <core/threading/thread.h>
 #include <core/utils/lock_list.h>
+#include <fvutils/net/fuse.h>
 #include <netcomm/utils/incoming_connection_handler.h>
+#include <utils/time/time.h>
 
+#include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace fawkes {
 class ThreadCollector;
 class StreamSocket;
 class NetworkAcceptorThread;
+class Mutex;
 } // namespace fawkes
 namespace firevision {
 
 class FuseServerClientThread;
+class FuseNetworkMessage;
+class SharedMemoryImageBuffer;
+class JpegImageCompressor;
 
 class FuseServer : public fawkes::Thread, public fawkes::NetworkIncomingConnectionHandler
 {
@@ -54,9 +62,46 @@ public:
 	virtual void add_connection(fawkes::StreamSocket *s) noexcept;
 	void         connection_died(FuseServerClientThread *client) noexcept;
 
+	FuseNetworkMessage *image_message(const char *                   image_id,
+	                                  unsigned int                   format,
+	                                  const FUSE_imagereq_options_t *options = NULL);
+
 	virtual void loop();
 
 private:
+	FuseNetworkMessage *encode_image(SharedMemoryImageBuffer *      b,
+	                                 unsigned int                   format,
+	                                 const FUSE_imagereq_options_t &options);
+	JpegImageCompressor *jpeg_compressor(unsigned int quality);
+	void                 expire_image_frames();
+
+	/** Key of a cached frame: image ID, format, ROI, scale, and JPEG quality. */
+	typedef std::tuple<std::string,
+	                   unsigned int,
+	                   unsigned int,
+	                   unsigned int,
+	                   unsigned int,
+	                   unsigned int,
+	                   unsigned int,
+	                   unsigned int>
+	  ImageFrameKey;
+
+	/** Most recently encoded frame of an image in a specific format. */
+	typedef struct
+	{
+		FuseNetworkMessage *message;           /**< encoded image message */
+		long int            capture_time_sec;  /**< capture time of encoded frame, sec part */
+		long int            capture_time_usec; /**< capture time of encoded frame, usec part */
+		fawkes::Time        encode_time;       /**< time when the frame was encoded */
+		fawkes::Time        access_time;       /**< time when the frame was last requested */
+	} ImageFrame;
+
+	fawkes::Mutex *                                  image_mutex_;
+	std::map<std::string, SharedMemoryImageBuffer *> image_buffers_;
+	std::map<ImageFrameKey, ImageFrame>              image_frames_;
+	std::map<unsigned int, JpegImageCompressor *>    jpeg_compressors_;
+	fawkes::Time                                     last_expire_;
+
 	std::vector<fawkes::NetworkAcceptorThread *> acceptor_threads_;
 
 	fawkes::LockList<FuseServerClientThread *>           clients_;
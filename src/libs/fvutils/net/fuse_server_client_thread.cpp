@@ -22,7 +22,6 @@
  */
 
 #include <core/exceptions/system.h>
-#include <fvutils/compression/jpeg_compressor.h>
 #include <fvutils/ipc/shm_image.h>
 #include <fvutils/ipc/shm_lut.h>
 #include <fvutils/net/fuse_image_content.h>
@@ -38,6 +37,7 @@
 #include <netcomm/utils/exceptions.h>
 #include <netinet/in.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <unistd.h>
@@ -46,10 +46,40 @@ using namespace fawkes;
 
 namespace firevision {
 
+/** Number of frames sent without skipping before improving the quality again. */
+#define FUSE_ADAPTIVE_RECOVER_FRAMES 30
+
+/// @cond INTERNALS
+/** Degradation levels of adaptive subscriptions.
+ * Each level multiplies the requested scale and limits the JPEG quality,
+ * quality 0 keeps the requested quality.
+ */
+static const struct
+{
+	unsigned int scale;
+	unsigned int jpeg_quality;
+} FUSE_ADAPTIVE_LEVELS[] = {{1, 0}, {1, 60}, {1, 40}, {2, 40}, {2, 25}, {4, 25}};
+/// @endcond
+
 /** @class FuseServerClientThread <fvutils/net/fuse_server_client_thread.h>
  * FUSE Server Client Thread.
  * This thread is instantiated and started for each client that connects to a
  * FuseServer.
+ *
+ * Besides answering requests, the thread pushes a FUSE_MT_IMAGE message
+ * for every new frame of images the client subscribed to with
+ * FUSE_MT_SUBSCRIBE_IMAGE. Image messages are retrieved from the shared
+ * frame cache of the FuseServer. A new frame is only pushed once all
+ * previous messages have been sent, so slow clients skip frames instead of
+ * building up a queue.
+ *
+ * If a subscription sets the FUSE_IRF_ADAPTIVE flag, the server tries to
+ * send each frame before the next one is captured. Whenever a new frame
+ * becomes available while the previous one is still being sent, JPEG
+ * quality and resolution are lowered to the next of the levels in
+ * FUSE_ADAPTIVE_LEVELS. After FUSE_ADAPTIVE_RECOVER_FRAMES frames sent in
+ * time the next better level is tried again. This only works for images
+ * which have a capture time.
  * @ingroup FUSE
  * @ingroup FireVision
  * @author Tim Niemueller
@@ -64,7 +94,6 @@ FuseServerClientThread::FuseServerClientThread(FuseServer *fuse_server, StreamSo
 {
 	fuse_server_     = fuse_server;
 	socket_          = s;
-	jpeg_compressor_ = NULL;
 
 	inbound_queue_  = new FuseNetworkMessageQueue();
 	outbound_queue_ = new FuseNetworkMessageQueue();
@@ -82,7 +111,13 @@ FuseServerClientThread::FuseServerClientThread(FuseServer *fuse_server, StreamSo
 FuseServerClientThread::~FuseServerClientThread()
 {
 	delete socket_;
-	delete jpeg_compressor_;
+
+	std::map<std::string, ImageSubscription>::iterator s;
+	for (s = subscriptions_.begin(); s != subscriptions_.end(); ++s) {
+		if (s->second.last_message)
+			s->second.last_message->unref();
+	}
+	subscriptions_.clear();
 
 	for (bit_ = buffers_.begin(); bit_ != buffers_.end(); ++bit_) {
 		delete bit_->second;
@@ -173,63 +208,212 @@ FuseServerClientThread::get_shmimgbuf(const char *id)
 	}
 }
 
+/** Parse image request.
+ * Accepts requests with and without options.
+ * @param m received message
+ * @param options upon return contains the request options in host byte
+ * order, all zero if the request has no options
+ * @return image request
+ * @exception TypeMismatchException thrown if the message has an invalid size
+ */
+FUSE_imagereq_message_t *
+FuseServerClientThread::parse_imagereq(FuseNetworkMessage *m, FUSE_imagereq_options_t *options)
+{
+	memset(options, 0, sizeof(FUSE_imagereq_options_t));
+	if (m->payload_size() == sizeof(FUSE_imagereq_message_t)) {
+		return m->msg<FUSE_imagereq_message_t>();
+	}
+
+	FUSE_imagereq_opts_message_t *irm = m->msg<FUSE_imagereq_opts_message_t>();
+	options->roi_x                    = ntohl(irm->options.roi_x);
+	options->roi_y                    = ntohl(irm->options.roi_y);
+	options->roi_width                = ntohl(irm->options.roi_width);
+	options->roi_height               = ntohl(irm->options.roi_height);
+	options->scale                    = irm->options.scale;
+	options->jpeg_quality             = irm->options.jpeg_quality;
+	options->flags                    = irm->options.flags;
+	return &irm->request;
+}
+
 /** Process image request message.
  * @param m received message
  */
 void
 FuseServerClientThread::process_getimage_message(FuseNetworkMessage *m)
 {
-	FUSE_imagereq_message_t *irm = m->msg<FUSE_imagereq_message_t>();
+	FUSE_imagereq_options_t  options;
+	FUSE_imagereq_message_t *irm = parse_imagereq(m, &options);
 
-	SharedMemoryImageBuffer *b;
 	try {
-		b = get_shmimgbuf(irm->image_id);
+		outbound_queue_->push(fuse_server_->image_message(irm->image_id, irm->format, &options));
 	} catch (Exception &e) {
 		FuseNetworkMessage *nm = new FuseNetworkMessage(FUSE_MT_GET_IMAGE_FAILED,
 		                                                m->payload(),
 		                                                m->payload_size(),
 		                                                /* copy payload */ true);
 		outbound_queue_->push(nm);
-		return;
 	}
+}
 
-	if (irm->format == FUSE_IF_RAW) {
-		FuseImageContent *im = new FuseImageContent(b);
-		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, im));
-	} else if (irm->format == FUSE_IF_JPEG) {
-		if (!jpeg_compressor_) {
-			jpeg_compressor_ = new JpegImageCompressor();
-			jpeg_compressor_->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
-		}
-		b->lock_for_read();
-		jpeg_compressor_->set_image_dimensions(b->width(), b->height());
-		jpeg_compressor_->set_image_buffer(b->colorspace(), b->buffer());
-		unsigned char *compressed_buffer =
-		  (unsigned char *)malloc(jpeg_compressor_->recommended_compressed_buffer_size());
-		jpeg_compressor_->set_destination_buffer(
-		  compressed_buffer, jpeg_compressor_->recommended_compressed_buffer_size());
-		jpeg_compressor_->compress();
-		b->unlock();
-		size_t   compressed_buffer_size = jpeg_compressor_->compressed_size();
-		long int sec = 0, usec = 0;
-		b->capture_time(&sec, &usec);
-		FuseImageContent *im = new FuseImageContent(FUSE_IF_JPEG,
-		                                            b->image_id(),
-		                                            compressed_buffer,
-		                                            compressed_buffer_size,
-		                                            CS_UNKNOWN,
-		                                            b->width(),
-		                                            b->height(),
-		                                            sec,
-		                                            usec);
-		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, im));
-		free(compressed_buffer);
-	} else {
+/** Process image subscription message.
+ * @param m received message
+ */
+void
+FuseServerClientThread::process_subscribeimage_message(FuseNetworkMessage *m)
+{
+	FUSE_imagereq_options_t  options;
+	FUSE_imagereq_message_t *irm = parse_imagereq(m, &options);
+
+	char tmp_image_id[IMAGE_ID_MAX_LENGTH + 1];
+	tmp_image_id[IMAGE_ID_MAX_LENGTH] = 0;
+	strncpy(tmp_image_id, irm->image_id, IMAGE_ID_MAX_LENGTH);
+
+	FuseNetworkMessage *im;
+	try {
+		im = fuse_server_->image_message(tmp_image_id, irm->format, &options);
+	} catch (Exception &e) {
 		FuseNetworkMessage *nm = new FuseNetworkMessage(FUSE_MT_GET_IMAGE_FAILED,
 		                                                m->payload(),
 		                                                m->payload_size(),
 		                                                /* copy payload */ true);
 		outbound_queue_->push(nm);
+		return;
+	}
+
+	std::map<std::string, ImageSubscription>::iterator s = subscriptions_.find(tmp_image_id);
+	if (s != subscriptions_.end() && s->second.last_message) {
+		s->second.last_message->unref();
+	}
+
+	// send current frame right away
+	im->ref();
+	outbound_queue_->push(im);
+
+	ImageSubscription sub;
+	sub.format       = irm->format;
+	sub.last_message = im;
+	sub.options      = options;
+	sub.level        = 0;
+	sub.good_frames  = 0;
+	sub.skipped      = false;
+	sub.capture_sec  = 0;
+	sub.capture_usec = 0;
+	try {
+		get_shmimgbuf(tmp_image_id)->capture_time(&sub.capture_sec, &sub.capture_usec);
+	} catch (Exception &e) {
+	} // cannot detect skipped frames, treated as untimed image
+	subscriptions_[tmp_image_id] = sub;
+}
+
+/** Process image unsubscription message.
+ * @param m received message
+ */
+void
+FuseServerClientThread::process_unsubscribeimage_message(FuseNetworkMessage *m)
+{
+	FUSE_imagedesc_message_t *idm = m->msg<FUSE_imagedesc_message_t>();
+
+	char tmp_image_id[IMAGE_ID_MAX_LENGTH + 1];
+	tmp_image_id[IMAGE_ID_MAX_LENGTH] = 0;
+	strncpy(tmp_image_id, idm->image_id, IMAGE_ID_MAX_LENGTH);
+
+	std::map<std::string, ImageSubscription>::iterator s = subscriptions_.find(tmp_image_id);
+	if (s != subscriptions_.end()) {
+		if (s->second.last_message)
+			s->second.last_message->unref();
+		subscriptions_.erase(s);
+	}
+}
+
+/** Update adaptive subscription and determine options for next frame.
+ * @param sub subscription
+ * @param options upon return contains the options to request the next
+ * frame with
+ */
+void
+FuseServerClientThread::adapt_subscription(ImageSubscription &      sub,
+                                           FUSE_imagereq_options_t *options)
+{
+	*options = sub.options;
+	if (!(sub.options.flags & FUSE_IRF_ADAPTIVE))
+		return;
+
+	const unsigned int max_level = sizeof(FUSE_ADAPTIVE_LEVELS) / sizeof(FUSE_ADAPTIVE_LEVELS[0]) - 1;
+	if (sub.skipped) {
+		if (sub.level < max_level)
+			sub.level += 1;
+		sub.good_frames = 0;
+	} else if (++sub.good_frames >= FUSE_ADAPTIVE_RECOVER_FRAMES) {
+		if (sub.level > 0)
+			sub.level -= 1;
+		sub.good_frames = 0;
+	}
+
+	unsigned int scale   = (sub.options.scale > 1) ? sub.options.scale : 1;
+	unsigned int quality = FUSE_ADAPTIVE_LEVELS[sub.level].jpeg_quality;
+	options->scale       = std::min(scale * FUSE_ADAPTIVE_LEVELS[sub.level].scale, 255u);
+	if ((quality > 0) && ((sub.options.jpeg_quality == 0) || (sub.options.jpeg_quality > quality))) {
+		options->jpeg_quality = quality;
+	}
+}
+
+/** Push new frames of subscribed images. */
+void
+FuseServerClientThread::push_subscribed_images()
+{
+	if (subscriptions_.empty())
+		return;
+
+	std::map<std::string, ImageSubscription>::iterator s;
+	if (!outbound_queue_->empty()) {
+		// still sending, note if adaptive subscriptions fall behind
+		for (s = subscriptions_.begin(); s != subscriptions_.end(); ++s) {
+			ImageSubscription &sub = s->second;
+			if (!(sub.options.flags & FUSE_IRF_ADAPTIVE) || sub.skipped
+			    || ((sub.capture_sec == 0) && (sub.capture_usec == 0)))
+				continue;
+			try {
+				long int sec = 0, usec = 0;
+				get_shmimgbuf(s->first.c_str())->capture_time(&sec, &usec);
+				sub.skipped = (sec != sub.capture_sec) || (usec != sub.capture_usec);
+			} catch (Exception &e) {
+			} // image vanished, handled on next push
+		}
+		return;
+	}
+
+	for (s = subscriptions_.begin(); s != subscriptions_.end(); ++s) {
+		FuseNetworkMessage *    im;
+		FUSE_imagereq_options_t options;
+		try {
+			long int sec = 0, usec = 0;
+			get_shmimgbuf(s->first.c_str())->capture_time(&sec, &usec);
+			if ((sec != 0) || (usec != 0)) {
+				if ((sec == s->second.capture_sec) && (usec == s->second.capture_usec)) {
+					// no new frame
+					continue;
+				}
+			}
+			adapt_subscription(s->second, &options);
+			im = fuse_server_->image_message(s->first.c_str(), s->second.format, &options);
+			s->second.skipped      = false;
+			s->second.capture_sec  = sec;
+			s->second.capture_usec = usec;
+		} catch (Exception &e) {
+			// image vanished, retry next time
+			continue;
+		}
+		if (im == s->second.last_message) {
+			// no new frame
+			im->unref();
+			continue;
+		}
+
+		if (s->second.last_message)
+			s->second.last_message->unref();
+		im->ref();
+		s->second.last_message = im;
+		outbound_queue_->push(im);
 	}
 }
 
@@ -422,6 +606,8 @@ FuseServerClientThread::process_inbound()
 			case FUSE_MT_GET_LUT_LIST: process_getlutlist_message(m); break;
 			case FUSE_MT_GET_LUT: process_getlut_message(m); break;
 			case FUSE_MT_SET_LUT: process_setlut_message(m); break;
+			case FUSE_MT_SUBSCRIBE_IMAGE: process_subscribeimage_message(m); break;
+			case FUSE_MT_UNSUBSCRIBE_IMAGE: process_unsubscribeimage_message(m); break;
 			default: throw Exception("Unknown message type received\n");
 			}
 		} catch (Exception &e) {
@@ -468,6 +654,7 @@ FuseServerClientThread::loop()
 	}
 
 	if (alive_) {
+		push_subscribed_images();
 		send();
 	}
 }
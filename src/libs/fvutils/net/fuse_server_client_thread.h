@@ -25,6 +25,7 @@
 #define _FIREVISION_FVUTILS_NET_FUSE_SERVER_CLIENT_THREAD_H_
 
 #include <core/threading/thread.h>
+#include <fvutils/net/fuse.h>
 
 #include <map>
 #include <string>
@@ -39,7 +40,6 @@ class FuseNetworkMessageQueue;
 class FuseNetworkMessage;
 class SharedMemoryImageBuffer;
 class SharedMemoryLookupTable;
-class JpegImageCompressor;
 
 class FuseServerClientThread : public fawkes::Thread
 {
@@ -58,9 +58,28 @@ public:
 	void process_getlut_message(FuseNetworkMessage *m);
 	void process_setlut_message(FuseNetworkMessage *m);
 	void process_getlutlist_message(FuseNetworkMessage *m);
+	void process_subscribeimage_message(FuseNetworkMessage *m);
+	void process_unsubscribeimage_message(FuseNetworkMessage *m);
 
 private:
+	/** Image subscription. */
+	typedef struct
+	{
+		unsigned int            format;       /**< requested image format */
+		FuseNetworkMessage *    last_message; /**< last pushed image message */
+		FUSE_imagereq_options_t options;      /**< requested options, host byte order */
+		unsigned int            level;        /**< adaptive degradation level */
+		unsigned int            good_frames;  /**< frames sent in time since last level change */
+		bool                    skipped;      /**< a new frame arrived while sending the last one */
+		long int                capture_sec;  /**< capture time of last pushed frame, sec part */
+		long int                capture_usec; /**< capture time of last pushed frame, usec part */
+	} ImageSubscription;
+
+	FUSE_imagereq_message_t *parse_imagereq(FuseNetworkMessage *m, FUSE_imagereq_options_t *options);
+	void                     adapt_subscription(ImageSubscription &      sub,
+	                                            FUSE_imagereq_options_t *options);
 	void                     process_inbound();
+	void                     push_subscribed_images();
 	SharedMemoryImageBuffer *get_shmimgbuf(const char *id);
 
 	FuseServer *          fuse_server_;
@@ -69,14 +88,14 @@ private:
 	FuseNetworkMessageQueue *outbound_queue_;
 	FuseNetworkMessageQueue *inbound_queue_;
 
-	JpegImageCompressor *jpeg_compressor_;
-
 	std::map<std::string, SharedMemoryImageBuffer *>           buffers_;
 	std::map<std::string, SharedMemoryImageBuffer *>::iterator bit_;
 
 	std::map<std::string, SharedMemoryLookupTable *>           luts_;
 	std::map<std::string, SharedMemoryLookupTable *>::iterator lit_;
 
+	std::map<std::string, ImageSubscription> subscriptions_;
+
 	bool alive_;
 };
 
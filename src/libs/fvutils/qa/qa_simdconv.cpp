@@ -0,0 +1,116 @@
+
+/***************************************************************************
+ *  qa_simdconv.cpp - QA and benchmark for vectorized colorspace conversions
+ *
+ *  Created: Thu Oct 15 04:56:11 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/color/simd.h>
+#include <utils/time/tracker.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace fawkes;
+using namespace firevision;
+
+#define IMAGE_WIDTH 640
+#define IMAGE_HEIGHT 480
+
+#define NUM_CYCLES 200
+
+typedef void (*simd_conversion_t)(const unsigned char *,
+                                  unsigned char *,
+                                  unsigned int,
+                                  unsigned int,
+                                  simd_level_t);
+
+struct Conversion
+{
+	const char *      name;
+	simd_conversion_t func;
+	colorspace_t      from;
+	colorspace_t      to;
+};
+
+int
+main(int argc, char **argv)
+{
+	const Conversion conversions[] = {
+	  {"yuv422planar_to_rgb", yuv422planar_to_rgb_simd, YUV422_PLANAR, RGB},
+	  {"yuv422planar_to_bgr", yuv422planar_to_bgr_simd, YUV422_PLANAR, BGR},
+	  {"yuv422packed_to_rgb", yuv422packed_to_rgb_simd, YUV422_PACKED, RGB},
+	  {"rgb_to_yuv422planar", rgb_to_yuv422planar_simd, RGB, YUV422_PLANAR},
+	  {"bgr_to_yuv422planar", bgr_to_yuv422planar_simd, BGR, YUV422_PLANAR},
+	  {"rgb_to_yuv422packed", rgb_to_yuv422packed_simd, RGB, YUV422_PACKED},
+	  {"grayscale_yuv422packed", grayscale_yuv422packed_simd, YUV422_PACKED, GRAY8}};
+	const simd_level_t levels[] = {SIMD_NONE, SIMD_SSE41, SIMD_AVX2, SIMD_NEON};
+
+	printf("Best instruction set: %s\n", simd_level_to_string(simd_level()));
+
+	TimeTracker tracker;
+	int         failures = 0;
+
+	for (const Conversion &c : conversions) {
+		size_t src_size = colorspace_buffer_size(c.from, IMAGE_WIDTH, IMAGE_HEIGHT);
+		size_t dst_size = colorspace_buffer_size(c.to, IMAGE_WIDTH, IMAGE_HEIGHT);
+
+		unsigned char *src       = malloc_buffer(c.from, IMAGE_WIDTH, IMAGE_HEIGHT);
+		unsigned char *reference = malloc_buffer(c.to, IMAGE_WIDTH, IMAGE_HEIGHT);
+		unsigned char *dst       = malloc_buffer(c.to, IMAGE_WIDTH, IMAGE_HEIGHT);
+		for (size_t i = 0; i < src_size; ++i) {
+			src[i] = rand() & 0xFF;
+		}
+		c.func(src, reference, IMAGE_WIDTH, IMAGE_HEIGHT, SIMD_NONE);
+
+		for (simd_level_t level : levels) {
+			if (!simd_level_supported(level))
+				continue;
+
+			memset(dst, 0, dst_size);
+			unsigned int cls =
+			  tracker.add_class(std::string(c.name) + " " + simd_level_to_string(level));
+			for (unsigned int i = 0; i < NUM_CYCLES; ++i) {
+				tracker.ping_start(cls);
+				c.func(src, dst, IMAGE_WIDTH, IMAGE_HEIGHT, level);
+				tracker.ping_end(cls);
+			}
+
+			if (memcmp(reference, dst, dst_size) != 0) {
+				printf("%s: %s result differs from plain C\n", c.name, simd_level_to_string(level));
+				++failures;
+			}
+		}
+
+		free(src);
+		free(reference);
+		free(dst);
+	}
+
+	tracker.print_to_stdout();
+
+	return failures == 0 ? 0 : 1;
+}
+
+/// @endcond
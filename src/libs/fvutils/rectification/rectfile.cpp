@@ -24,6 +24,7 @@
 #include <core/exceptions/system.h>
 #include <fvutils/rectification/rectfile.h>
 #include <fvutils/rectification/rectinfo.h>
+#include <fvutils/rectification/rectinfo_bilinear_block.h>
 #include <fvutils/rectification/rectinfo_block.h>
 #include <fvutils/rectification/rectinfo_lut_block.h>
 #include <netinet/in.h>
@@ -136,6 +137,9 @@ RectificationInfoFile::rectinfo_blocks()
 			printf("Pushing lut block\n");
 			RectificationLutInfoBlock *libl = new RectificationLutInfoBlock(*i);
 			rv->push_back(libl);
+		} else if ((*i)->type() == FIREVISION_RECTINFO_TYPE_LUT_BILINEAR) {
+			RectificationBilinearInfoBlock *bibl = new RectificationBilinearInfoBlock(*i);
+			rv->push_back(bibl);
 		}
 	}
 
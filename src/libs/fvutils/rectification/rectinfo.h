@@ -143,15 +143,44 @@ typedef struct _rectinfo_lut_16x16_entry_t
 	uint16_t y; /**< map to y pixel coordinate */
 } rectinfo_lut_16x16_entry_t;
 
+/** Block header for bilinear rectification LUTs.
+ * The layout is the same as for rectinfo_lut_16x16_block_header_t, following this
+ * header there have to be exactly width * height cells of type
+ * rectinfo_lut_bilinear_entry_t.
+ */
+typedef struct _rectinfo_lut_bilinear_block_header_t
+{
+	uint16_t width;  /**< width of the LUT file and image */
+	uint16_t height; /**< height of the LUT file and image */
+} rectinfo_lut_bilinear_block_header_t;
+
+/** Data type used to build a bilinear rectification LUT.
+ * The values are stored in the endianess of the host system and line by line as for
+ * rectinfo_lut_16x16_entry_t. The coordinates are 12.4 fixed point values, the upper
+ * 12 bits are the pixel coordinate in the unrectified image, the lower 4 bits the
+ * position between this and the next pixel in sixteenths of a pixel. The rectified
+ * pixel is interpolated from the four pixels around that position, the bilinear
+ * weights follow directly from the fractional bits. The maximum image size is 4095.
+ * The pixel right of and below the position must be within the image, positions
+ * at the last line or column are stored as 15/16 of the way from the previous one.
+ */
+typedef struct _rectinfo_lut_bilinear_entry_t
+{
+	uint16_t x; /**< map to x pixel coordinate, 12.4 fixed point */
+	uint16_t y; /**< map to y pixel coordinate, 12.4 fixed point */
+} rectinfo_lut_bilinear_entry_t;
+
 /** Rectification info block type.
  * An info block may come in different types, probably mainly depending on the data type
  * but also the data structure may change in future versions.
  */
 typedef enum _rectinfo_block_type_t {
 	/* supported by file version 1: */
-	FIREVISION_RECTINFO_TYPE_INVALID   = 0, /**< invalid */
-	FIREVISION_RECTINFO_TYPE_LUT_16x16 = 1  /**< Rectification LUT with 16 bit values,
+	FIREVISION_RECTINFO_TYPE_INVALID      = 0, /**< invalid */
+	FIREVISION_RECTINFO_TYPE_LUT_16x16    = 1, /**< Rectification LUT with 16 bit values,
 						   see rectinfo_lut_16x16_block_header_t */
+	FIREVISION_RECTINFO_TYPE_LUT_BILINEAR = 2 /**< Rectification LUT with 12.4 fixed point
+						     values, see rectinfo_lut_bilinear_block_header_t */
 } rectinfo_block_type_t;
 
 /** Rectification camera.
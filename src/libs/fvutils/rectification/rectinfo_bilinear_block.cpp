@@ -0,0 +1,187 @@
+
+/***************************************************************************
+ *  rectinfo_bilinear_block.cpp - Rectification info block for bilinear LUT
+ *
+ *  Created: Thu Oct 15 05:29:43 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <fvutils/rectification/rectinfo_bilinear_block.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/** @class RectificationBilinearInfoBlock <fvutils/rectification/rectinfo_bilinear_block.h>
+ * Bilinear rectification lookup table block.
+ * Like RectificationLutInfoBlock this block maps rectified to unrectified
+ * pixels, but the unrectified positions are stored with a precision of a
+ * sixteenth of a pixel, see rectinfo_lut_bilinear_entry_t. The rectified
+ * image is interpolated from the four pixels around each position, which
+ * avoids the jagged edges of a nearest neighbour lookup. The entries are
+ * stored in the form used by remap_bilinear_simd(), so the table can be
+ * used directly after loading.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param width width of the image, at least 2 and at most 4095
+ * @param height height of the image, at least 2 and at most 4095
+ * @param camera camera identifier, see rectinfo_camera_t
+ */
+RectificationBilinearInfoBlock::RectificationBilinearInfoBlock(uint16_t width,
+                                                               uint16_t height,
+                                                               uint8_t  camera)
+: RectificationInfoBlock(FIREVISION_RECTINFO_TYPE_LUT_BILINEAR,
+                         camera,
+                         sizeof(rectinfo_lut_bilinear_block_header_t)
+                           + ((size_t)width * height * sizeof(rectinfo_lut_bilinear_entry_t)))
+{
+	if ((width < 2) || (width > 4095)) {
+		throw OutOfBoundsException("Bilinear RectLUT width", width, 2, 4095);
+	}
+	if ((height < 2) || (height > 4095)) {
+		throw OutOfBoundsException("Bilinear RectLUT height", height, 2, 4095);
+	}
+
+	_lut_block_header = (rectinfo_lut_bilinear_block_header_t *)_data;
+	_lut_data         = (rectinfo_lut_bilinear_entry_t *)((char *)_data
+	                                              + sizeof(rectinfo_lut_bilinear_block_header_t));
+
+	_lut_block_header->width  = width;
+	_lut_block_header->height = height;
+}
+
+/** Copy Constructor.
+ * It is assumed that the block actually is a bilinear rectification LUT info block.
+ * Check that before calling this method.
+ * @param block block to copy
+ */
+RectificationBilinearInfoBlock::RectificationBilinearInfoBlock(FireVisionDataFileBlock *block)
+: RectificationInfoBlock(block)
+{
+	_lut_block_header = (rectinfo_lut_bilinear_block_header_t *)_data;
+	_lut_data         = (rectinfo_lut_bilinear_entry_t *)((char *)_data
+	                                              + sizeof(rectinfo_lut_bilinear_block_header_t));
+}
+
+void
+RectificationBilinearInfoBlock::mapping(uint16_t x, uint16_t y, uint16_t *to_x, uint16_t *to_y)
+{
+	if (x >= _lut_block_header->width) {
+		throw OutOfBoundsException("Bilinear RectLUT X (from)", x, 0, _lut_block_header->width);
+	}
+	if (y >= _lut_block_header->height) {
+		throw OutOfBoundsException("Bilinear RectLUT Y (from)", y, 0, _lut_block_header->height);
+	}
+
+	const rectinfo_lut_bilinear_entry_t &e = _lut_data[y * _lut_block_header->width + x];
+	*to_x                                  = (e.x + 8) >> 4;
+	*to_y                                  = (e.y + 8) >> 4;
+}
+
+/** Get mapping with subpixel precision.
+ * @param x X pixel coordinate to get mapping for
+ * @param y Y pixel coordinate to get mapping for
+ * @param to_x Upon return contains the X coordinate in the unrectified image
+ * @param to_y Upon return contains the Y coordinate in the unrectified image
+ */
+void
+RectificationBilinearInfoBlock::subpixel_mapping(uint16_t x, uint16_t y, float *to_x, float *to_y)
+{
+	if (x >= _lut_block_header->width) {
+		throw OutOfBoundsException("Bilinear RectLUT X (from)", x, 0, _lut_block_header->width);
+	}
+	if (y >= _lut_block_header->height) {
+		throw OutOfBoundsException("Bilinear RectLUT Y (from)", y, 0, _lut_block_header->height);
+	}
+
+	const rectinfo_lut_bilinear_entry_t &e = _lut_data[y * _lut_block_header->width + x];
+	*to_x                                  = e.x / 16.f;
+	*to_y                                  = e.y / 16.f;
+}
+
+/** Set mapping.
+ * The position is rounded to the nearest sixteenth of a pixel. Positions in the
+ * last line or column are moved by a sixteenth of a pixel towards the image, as
+ * the interpolation needs the pixel right of and below the position.
+ * @param x X pixel coordinate to set mapping for
+ * @param y Y pixel coordinate to set mapping for
+ * @param to_x X coordinate in the unrectified image
+ * @param to_y Y coordinate in the unrectified image
+ */
+void
+RectificationBilinearInfoBlock::set_mapping(uint16_t x, uint16_t y, float to_x, float to_y)
+{
+	const uint16_t width  = _lut_block_header->width;
+	const uint16_t height = _lut_block_header->height;
+
+	if (x >= width) {
+		throw OutOfBoundsException("Bilinear RectLUT X (from)", x, 0, width);
+	}
+	if (y >= height) {
+		throw OutOfBoundsException("Bilinear RectLUT Y (from)", y, 0, height);
+	}
+	if (!(to_x >= 0.f) || (to_x > width - 1)) {
+		throw OutOfBoundsException("Bilinear RectLUT X (to)", to_x, 0, width - 1);
+	}
+	if (!(to_y >= 0.f) || (to_y > height - 1)) {
+		throw OutOfBoundsException("Bilinear RectLUT Y (to)", to_y, 0, height - 1);
+	}
+
+	long fx = std::min(lrintf(to_x * 16.f), (long)(width - 1) * 16 - 1);
+	long fy = std::min(lrintf(to_y * 16.f), (long)(height - 1) * 16 - 1);
+
+	_lut_data[y * width + x].x = (uint16_t)fx;
+	_lut_data[y * width + x].y = (uint16_t)fy;
+}
+
+/** Get width of the LUT.
+ * @return width of LUT.
+ */
+uint16_t
+RectificationBilinearInfoBlock::pixel_width()
+{
+	return _lut_block_header->width;
+}
+
+/** Get height the LUT.
+ * @return height of LUT.
+ */
+uint16_t
+RectificationBilinearInfoBlock::pixel_height()
+{
+	return _lut_block_header->height;
+}
+
+/** Get raw LUT data.
+ * Use this to access the LUT, e.g. to pass a line of it to
+ * remap_bilinear_simd().
+ * @return pointer to raw LUT data
+ */
+rectinfo_lut_bilinear_entry_t *
+RectificationBilinearInfoBlock::lut_data()
+{
+	return _lut_data;
+}
+
+} // end namespace firevision
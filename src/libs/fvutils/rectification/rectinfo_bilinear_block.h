@@ -0,0 +1,53 @@
+
+/***************************************************************************
+ *  rectinfo_bilinear_block.h - Rectification info block for bilinear LUT
+ *
+ *  Created: Thu Oct 15 05:29:43 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FVUTILS_RECTIFICATION_RECTINFO_BILINEAR_BLOCK_H_
+#define _FIREVISION_FVUTILS_RECTIFICATION_RECTINFO_BILINEAR_BLOCK_H_
+
+#include <fvutils/rectification/rectinfo_block.h>
+
+namespace firevision {
+
+class RectificationBilinearInfoBlock : public RectificationInfoBlock
+{
+public:
+	RectificationBilinearInfoBlock(uint16_t width, uint16_t height, uint8_t camera);
+	RectificationBilinearInfoBlock(FireVisionDataFileBlock *block);
+
+	void         set_mapping(uint16_t x, uint16_t y, float to_x, float to_y);
+	virtual void mapping(uint16_t x, uint16_t y, uint16_t *to_x, uint16_t *to_y);
+	void         subpixel_mapping(uint16_t x, uint16_t y, float *to_x, float *to_y);
+
+	uint16_t pixel_width();
+	uint16_t pixel_height();
+
+	rectinfo_lut_bilinear_entry_t *lut_data();
+
+private:
+	rectinfo_lut_bilinear_block_header_t *_lut_block_header;
+	rectinfo_lut_bilinear_entry_t *       _lut_data;
+};
+
+} // end namespace firevision
+
+#endif
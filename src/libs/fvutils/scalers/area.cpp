@@ -0,0 +1,318 @@
+
+/***************************************************************************
+ *  area.cpp - Area averaging scaler
+ *
+ *  Created: Thu Oct 15 05:34:16 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <fvutils/color/simd.h>
+#include <fvutils/color/yuv.h>
+#include <fvutils/scalers/area.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/** @class AreaScaler <fvutils/scalers/area.h>
+ * Area averaging image scaler.
+ * Each pixel of the scaled image is the average of the block of original
+ * pixels it covers, which smoothes the image while scaling it down and
+ * avoids the aliasing of LossyScaler without a separate blur. When
+ * enlarging an image the nearest pixel is used.
+ *
+ * If the original image is exactly two or four times as large as the
+ * scaled image, which is the common case for thumbnails, the blocks are
+ * averaged with box_downsample_line_simd(). Otherwise the blocks are
+ * summed up first along the columns and then along the lines with
+ * integer arithmetic, which is considerably slower.
+ *
+ * The scaled image has exactly the dimensions given to
+ * set_scaled_dimensions(), the aspect ratio is not retained. Lines of the
+ * scaled image are independent of each other, scale_lines() can be used
+ * to scale disjoint parts of the image concurrently.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param colorspace colorspace of the original and the scaled image,
+ * YUV422_PLANAR, RGB, BGR, RGB_WITH_ALPHA, BGR_WITH_ALPHA, GRAY8 or MONO8
+ */
+AreaScaler::AreaScaler(colorspace_t colorspace)
+{
+	switch (colorspace) {
+	case YUV422_PLANAR:
+	case GRAY8:
+	case MONO8: channels_ = 1; break;
+	case RGB:
+	case BGR: channels_ = 3; break;
+	case RGB_WITH_ALPHA:
+	case BGR_WITH_ALPHA: channels_ = 4; break;
+	default:
+		throw IllegalArgumentException("AreaScaler: unsupported colorspace %s",
+		                               colorspace_to_string(colorspace));
+	}
+
+	colorspace_  = colorspace;
+	orig_width_  = orig_height_ = 0;
+	scal_width_  = scal_height_ = 0;
+	orig_buffer_ = NULL;
+	scal_buffer_ = NULL;
+
+	scale_factor_ = 1.f;
+}
+
+/** Destructor. */
+AreaScaler::~AreaScaler()
+{
+}
+
+/** Determine scaled dimensions from the scale factor. */
+void
+AreaScaler::update_scaled_dimensions()
+{
+	if ((orig_width_ == 0) || (orig_height_ == 0)) {
+		return;
+	}
+
+	scal_width_  = std::max(1L, lrintf(orig_width_ * scale_factor_));
+	scal_height_ = std::max(1L, lrintf(orig_height_ * scale_factor_));
+	if (colorspace_ == YUV422_PLANAR) {
+		// chroma is shared by pixel pairs
+		scal_width_ += (scal_width_ % 2);
+	}
+}
+
+void
+AreaScaler::set_scale_factor(float factor)
+{
+	if ((factor <= 0) || (factor > 1)) {
+		scale_factor_ = 1.f;
+	} else {
+		scale_factor_ = factor;
+	}
+	update_scaled_dimensions();
+}
+
+void
+AreaScaler::set_original_dimensions(unsigned int width, unsigned int height)
+{
+	orig_width_  = width;
+	orig_height_ = height;
+	update_scaled_dimensions();
+}
+
+void
+AreaScaler::set_scaled_dimensions(unsigned int width, unsigned int height)
+{
+	scal_width_  = width;
+	scal_height_ = height;
+
+	if ((orig_width_ != 0) && (orig_height_ != 0)) {
+		scale_factor_ = std::min(scal_width_ / float(orig_width_), scal_height_ / float(orig_height_));
+	}
+}
+
+void
+AreaScaler::set_original_buffer(unsigned char *buffer)
+{
+	orig_buffer_ = buffer;
+}
+
+void
+AreaScaler::set_scaled_buffer(unsigned char *buffer)
+{
+	scal_buffer_ = buffer;
+}
+
+unsigned int
+AreaScaler::needed_scaled_width()
+{
+	return scal_width_;
+}
+
+unsigned int
+AreaScaler::needed_scaled_height()
+{
+	return scal_height_;
+}
+
+float
+AreaScaler::get_scale_factor()
+{
+	return scale_factor_;
+}
+
+void
+AreaScaler::scale()
+{
+	scale_lines(0, scal_height_);
+}
+
+/** Scale part of the image.
+ * Only the given lines of the scaled image are written. This method may be
+ * called concurrently for disjoint sets of lines.
+ * @param first_line first line of the scaled image to write
+ * @param num_lines number of lines to write
+ */
+void
+AreaScaler::scale_lines(unsigned int first_line, unsigned int num_lines)
+{
+	if ((orig_width_ == 0) || (orig_height_ == 0) || (scal_width_ == 0) || (scal_height_ == 0)) {
+		return;
+	}
+	if ((orig_buffer_ == NULL) || (scal_buffer_ == NULL) || (first_line >= scal_height_)) {
+		return;
+	}
+
+	unsigned int last_line = std::min(first_line + num_lines, scal_height_);
+
+	scale_plane(orig_buffer_,
+	            orig_width_,
+	            orig_height_,
+	            scal_buffer_,
+	            scal_width_,
+	            scal_height_,
+	            channels_,
+	            first_line,
+	            last_line);
+
+	if (colorspace_ == YUV422_PLANAR) {
+		scale_plane(YUV422_PLANAR_U_PLANE(orig_buffer_, orig_width_, orig_height_),
+		            orig_width_ / 2,
+		            orig_height_,
+		            YUV422_PLANAR_U_PLANE(scal_buffer_, scal_width_, scal_height_),
+		            scal_width_ / 2,
+		            scal_height_,
+		            1,
+		            first_line,
+		            last_line);
+		scale_plane(YUV422_PLANAR_V_PLANE(orig_buffer_, orig_width_, orig_height_),
+		            orig_width_ / 2,
+		            orig_height_,
+		            YUV422_PLANAR_V_PLANE(scal_buffer_, scal_width_, scal_height_),
+		            scal_width_ / 2,
+		            scal_height_,
+		            1,
+		            first_line,
+		            last_line);
+	}
+}
+
+/** Scale lines of one plane.
+ * @param src original plane
+ * @param src_width width of the original plane in pixels
+ * @param src_height height of the original plane
+ * @param dst scaled plane
+ * @param dst_width width of the scaled plane in pixels
+ * @param dst_height height of the scaled plane
+ * @param channels number of interleaved bytes per pixel
+ * @param first_line first line of the scaled plane to write
+ * @param last_line line after the last line to write
+ */
+void
+AreaScaler::scale_plane(const unsigned char *src,
+                        unsigned int         src_width,
+                        unsigned int         src_height,
+                        unsigned char *      dst,
+                        unsigned int         dst_width,
+                        unsigned int         dst_height,
+                        unsigned int         channels,
+                        unsigned int         first_line,
+                        unsigned int         last_line)
+{
+	if ((src_width == 0) || (dst_width == 0)) {
+		return;
+	}
+
+	const unsigned int src_step = src_width * channels;
+	const unsigned int dst_step = dst_width * channels;
+
+	for (unsigned int factor = 2; factor <= 4; factor *= 2) {
+		if ((src_width == factor * dst_width) && (src_height == factor * dst_height)) {
+			for (unsigned int y = first_line; y < last_line; ++y) {
+				box_downsample_line_simd(src + (size_t)y * factor * src_step,
+				                         src_step,
+				                         dst + (size_t)y * dst_step,
+				                         dst_width,
+				                         factor,
+				                         channels);
+			}
+			return;
+		}
+	}
+
+	// block boundaries of the columns, at least one pixel wide
+	std::vector<unsigned int> x_from(dst_width), x_to(dst_width);
+	for (unsigned int x = 0; x < dst_width; ++x) {
+		x_from[x] = (unsigned int)((uint64_t)x * src_width / dst_width);
+		x_to[x]   = std::max(x_from[x] + 1, (unsigned int)((uint64_t)(x + 1) * src_width / dst_width));
+	}
+
+	// per line the sums of the block lines, summed up over the columns after
+	std::vector<uint32_t> sums(src_step);
+	// block sizes and their doubled reciprocals, blocks have at most two
+	// different heights
+	std::vector<double> count(dst_width), inv(dst_width);
+	unsigned int        inv_height = 0;
+	for (unsigned int y = first_line; y < last_line; ++y) {
+		unsigned int y_from = (unsigned int)((uint64_t)y * src_height / dst_height);
+		unsigned int y_to =
+		  std::max(y_from + 1, (unsigned int)((uint64_t)(y + 1) * src_height / dst_height));
+
+		if (y_to - y_from != inv_height) {
+			inv_height = y_to - y_from;
+			for (unsigned int x = 0; x < dst_width; ++x) {
+				count[x] = (x_to[x] - x_from[x]) * inv_height;
+				inv[x]   = 0.5 / count[x];
+			}
+		}
+
+		const unsigned char *s = src + (size_t)y_from * src_step;
+		for (unsigned int i = 0; i < src_step; ++i) {
+			sums[i] = s[i];
+		}
+		for (unsigned int sy = y_from + 1; sy < y_to; ++sy) {
+			s += src_step;
+			for (unsigned int i = 0; i < src_step; ++i) {
+				sums[i] += s[i];
+			}
+		}
+
+		unsigned char *d = dst + (size_t)y * dst_step;
+		for (unsigned int x = 0; x < dst_width; ++x) {
+			for (unsigned int c = 0; c < channels; ++c) {
+				uint32_t sum = 0;
+				for (unsigned int sx = x_from[x]; sx < x_to[x]; ++sx) {
+					sum += sums[sx * channels + c];
+				}
+				// (2 sum + count) / (2 count) rounds to nearest, with another half
+				// added the quotient is never within rounding errors of an integer
+				*d++ = (unsigned char)((2. * sum + count[x] + 0.5) * inv[x]);
+			}
+		}
+	}
+}
+
+} // end namespace firevision
@@ -0,0 +1,79 @@
+
+/***************************************************************************
+ *  area.h - Area averaging scaler
+ *
+ *  Created: Thu Oct 15 05:34:16 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_UTILS_SCALERS_AREA_H_
+#define _FIREVISION_UTILS_SCALERS_AREA_H_
+
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/scalers/scaler.h>
+
+namespace firevision {
+
+class AreaScaler : public Scaler
+{
+public:
+	AreaScaler(colorspace_t colorspace = YUV422_PLANAR);
+	virtual ~AreaScaler();
+
+	virtual void         set_scale_factor(float factor);
+	virtual void         set_original_dimensions(unsigned int width, unsigned int height);
+	virtual void         set_scaled_dimensions(unsigned int width, unsigned int height);
+	virtual void         set_original_buffer(unsigned char *buffer);
+	virtual void         set_scaled_buffer(unsigned char *buffer);
+	virtual void         scale();
+	virtual unsigned int needed_scaled_width();
+	virtual unsigned int needed_scaled_height();
+	virtual float        get_scale_factor();
+
+	void scale_lines(unsigned int first_line, unsigned int num_lines);
+
+private:
+	void update_scaled_dimensions();
+	void scale_plane(const unsigned char *src,
+	                 unsigned int         src_width,
+	                 unsigned int         src_height,
+	                 unsigned char *      dst,
+	                 unsigned int         dst_width,
+	                 unsigned int         dst_height,
+	                 unsigned int         channels,
+	                 unsigned int         first_line,
+	                 unsigned int         last_line);
+
+private:
+	colorspace_t colorspace_;
+	unsigned int channels_;
+
+	unsigned int   orig_width_;
+	unsigned int   orig_height_;
+	unsigned char *orig_buffer_;
+
+	unsigned int   scal_width_;
+	unsigned int   scal_height_;
+	unsigned char *scal_buffer_;
+
+	float scale_factor_;
+};
+
+} // end namespace firevision
+
+#endif
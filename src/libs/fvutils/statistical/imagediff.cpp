@@ -106,10 +106,10 @@ ImageDiff::different()
 		unsigned int  x, y;
 		unsigned char y_a, u_a, v_a, y_b, u_b, v_b;
 
-		scanline_model->reset();
-		while (!scanline_model->finished()) {
-			x = (*scanline_model)->x;
-			y = (*scanline_model)->y;
+		const std::vector<fawkes::upoint_t> &points = scanline_model->points();
+		for (const fawkes::upoint_t &p : points) {
+			x = p.x;
+			y = p.y;
 
 			YUV422_PLANAR_YUV(buffer_a, width_a, height_a, x, y, y_a, u_a, v_a);
 			YUV422_PLANAR_YUV(buffer_b, width_b, height_b, x, y, y_b, u_b, v_b);
@@ -161,10 +161,10 @@ ImageDiff::numDifferingPixels()
 		unsigned int  x, y;
 		unsigned char y_a, u_a, v_a, y_b, u_b, v_b;
 
-		scanline_model->reset();
-		while (!scanline_model->finished()) {
-			x = (*scanline_model)->x;
-			y = (*scanline_model)->y;
+		const std::vector<fawkes::upoint_t> &points = scanline_model->points();
+		for (const fawkes::upoint_t &p : points) {
+			x = p.x;
+			y = p.y;
 
 			YUV422_PLANAR_YUV(buffer_a, width_a, height_a, x, y, y_a, u_a, v_a);
 			YUV422_PLANAR_YUV(buffer_b, width_b, height_b, x, y, y_b, u_b, v_b);
@@ -0,0 +1,180 @@
+
+/***************************************************************************
+ *  integral_image.cpp - Summed-area table of an image
+ *
+ *  Created: Thu Oct 15 05:25:34 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <fvutils/statistical/integral_image.h>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/** @class IntegralImage <fvutils/statistical/integral_image.h>
+ * Summed-area table of an image.
+ * Each entry contains the sum of all values above and left of a pixel.
+ * Once computed, the sum and mean of any rectangular region are
+ * determined from four entries, independent of the size of the region.
+ * Compute the table once per frame, e.g. from the luminance plane, and
+ * query as many regions as needed.
+ *
+ * The table has one more line and column than the image, the first line
+ * and column are zero. Entries are 64 bit wide, so arbitrary per-pixel
+ * scores can be summed without overflow.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param width width of the image
+ * @param height height of the image
+ */
+IntegralImage::IntegralImage(unsigned int width, unsigned int height)
+{
+	width_  = 0;
+	height_ = 0;
+	resize(width, height);
+}
+
+/** Set image size.
+ * The table is cleared.
+ * @param width width of the image
+ * @param height height of the image
+ */
+void
+IntegralImage::resize(unsigned int width, unsigned int height)
+{
+	width_  = width;
+	height_ = height;
+	table_.assign((size_t)(width + 1) * (height + 1), 0);
+}
+
+/** Get width.
+ * @return width of the image
+ */
+unsigned int
+IntegralImage::width() const
+{
+	return width_;
+}
+
+/** Get height.
+ * @return height of the image
+ */
+unsigned int
+IntegralImage::height() const
+{
+	return height_;
+}
+
+/** Compute table from an image plane.
+ * @param plane plane with one byte per pixel, e.g. the Y plane of a
+ * YUV422_PLANAR image
+ * @param line_step bytes per line of the plane, 0 to use the width
+ */
+void
+IntegralImage::compute(const unsigned char *plane, unsigned int line_step)
+{
+	if (line_step == 0) {
+		line_step = width_;
+	}
+
+	const size_t stride = width_ + 1;
+	for (unsigned int y = 0; y < height_; ++y) {
+		const unsigned char *p     = plane + (size_t)y * line_step;
+		const int64_t *      above = &table_[y * stride];
+		int64_t *            row   = &table_[(y + 1) * stride];
+		// only the line sum is carried from pixel to pixel, the addition of
+		// the line above does not depend on the previous pixel
+		int64_t line_sum = 0;
+		for (unsigned int x = 0; x < width_; ++x) {
+			line_sum += p[x];
+			row[x + 1] = above[x + 1] + line_sum;
+		}
+	}
+}
+
+/** Set values of a line.
+ * Use this to sum values other than the bytes of a plane. Lines must be
+ * set in ascending order, starting with line 0.
+ * @param y line to set
+ * @param values values of the line, one per pixel
+ */
+void
+IntegralImage::set_line(unsigned int y, const int *values)
+{
+	if (y >= height_) {
+		throw OutOfBoundsException("IntegralImage: line out of bounds", y, 0, height_);
+	}
+
+	const size_t   stride   = width_ + 1;
+	const int64_t *above    = &table_[y * stride];
+	int64_t *      row      = &table_[(y + 1) * stride];
+	int64_t        line_sum = 0;
+	for (unsigned int x = 0; x < width_; ++x) {
+		line_sum += values[x];
+		row[x + 1] = above[x + 1] + line_sum;
+	}
+}
+
+/** Get sum of a region.
+ * @param x X coordinate of the upper left corner
+ * @param y Y coordinate of the upper left corner
+ * @param width width of the region
+ * @param height height of the region
+ * @return sum of all values in the region
+ */
+int64_t
+IntegralImage::sum(unsigned int x, unsigned int y, unsigned int width, unsigned int height) const
+{
+	if ((x > width_) || (width > width_ - x)) {
+		throw OutOfBoundsException("IntegralImage: region exceeds image width", x + width, 0, width_);
+	}
+	if ((y > height_) || (height > height_ - y)) {
+		throw OutOfBoundsException("IntegralImage: region exceeds image height",
+		                           y + height,
+		                           0,
+		                           height_);
+	}
+
+	const size_t   stride = width_ + 1;
+	const int64_t *top    = &table_[y * stride + x];
+	const int64_t *bottom = &table_[(y + height) * stride + x];
+	return bottom[width] - bottom[0] - top[width] + top[0];
+}
+
+/** Get mean of a region.
+ * @param x X coordinate of the upper left corner
+ * @param y Y coordinate of the upper left corner
+ * @param width width of the region
+ * @param height height of the region
+ * @return mean of all values in the region, 0 for an empty region
+ */
+float
+IntegralImage::mean(unsigned int x, unsigned int y, unsigned int width, unsigned int height) const
+{
+	int64_t s = sum(x, y, width, height);
+	if ((width == 0) || (height == 0)) {
+		return 0.f;
+	}
+	return (float)s / ((float)width * height);
+}
+
+} // end namespace firevision
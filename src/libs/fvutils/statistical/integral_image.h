@@ -0,0 +1,55 @@
+
+/***************************************************************************
+ *  integral_image.h - Summed-area table of an image
+ *
+ *  Created: Thu Oct 15 05:25:34 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_UTILS_STATISTICAL_INTEGRAL_IMAGE_H_
+#define _FIREVISION_UTILS_STATISTICAL_INTEGRAL_IMAGE_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace firevision {
+
+class IntegralImage
+{
+public:
+	IntegralImage(unsigned int width = 0, unsigned int height = 0);
+
+	void         resize(unsigned int width, unsigned int height);
+	unsigned int width() const;
+	unsigned int height() const;
+
+	void compute(const unsigned char *plane, unsigned int line_step = 0);
+	void set_line(unsigned int y, const int *values);
+
+	int64_t sum(unsigned int x, unsigned int y, unsigned int width, unsigned int height) const;
+	float   mean(unsigned int x, unsigned int y, unsigned int width, unsigned int height) const;
+
+private:
+	unsigned int         width_;
+	unsigned int         height_;
+	std::vector<int64_t> table_;
+};
+
+} // end namespace firevision
+
+#endif
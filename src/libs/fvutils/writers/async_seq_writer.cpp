@@ -0,0 +1,364 @@
+
+/***************************************************************************
+ *  async_seq_writer.cpp - Write image sequences in background threads
+ *
+ *  Created: Thu Oct 15 05:44:03 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/exceptions/software.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <fvutils/writers/async_seq_writer.h>
+#include <fvutils/writers/seq_writer.h>
+
+#include <cstring>
+#include <exception>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/// @cond INTERNAL
+class AsyncSeqWriter::Worker : public Thread
+{
+public:
+	Worker(AsyncSeqWriter *seq_writer, Writer *writer, unsigned int i)
+	: Thread("AsyncSeqWriterWorker", Thread::OPMODE_CONTINUOUS)
+	{
+		set_name("AsyncSeqWriterWorker %u", i);
+		seq_writer_ = seq_writer;
+		writer_     = writer;
+	}
+
+	virtual ~Worker()
+	{
+		delete writer_;
+	}
+
+protected:
+	virtual void
+	run()
+	{
+		while (seq_writer_->write_next(writer_)) {
+		}
+	}
+
+private:
+	AsyncSeqWriter *seq_writer_;
+	Writer *        writer_;
+};
+/// @endcond
+
+/** @class AsyncSeqWriter <fvutils/writers/async_seq_writer.h>
+ * Writes a sequence of images to disk in background threads.
+ * Works like SeqWriter, but write() only copies the image to a queue of
+ * fixed length. Worker threads encode and write the queued images, each
+ * with its own writer instance. Hence recording does not block the
+ * thread which provides the images, e.g. a vision loop, on encoding or
+ * disk I/O.
+ *
+ * If all queue slots are taken, for example because the disk cannot
+ * keep up, the image is dropped instead of waiting. Frame numbers are
+ * counted for dropped images as well, so gaps in the numbering of the
+ * files show where images have been dropped. The number of dropped and
+ * failed images is available for monitoring.
+ *
+ * With more than one worker images may be finished out of order, the
+ * filenames are determined when the image is queued.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param factory function called once per worker thread to create its
+ * writer. The AsyncSeqWriter takes ownership of the writers.
+ * @param num_threads number of worker threads, at least one
+ * @param queue_length maximum number of images queued or being written,
+ * at least one
+ */
+AsyncSeqWriter::AsyncSeqWriter(WriterFactory factory,
+                               unsigned int  num_threads,
+                               unsigned int  queue_length)
+{
+	if (num_threads == 0) {
+		throw OutOfBoundsException("AsyncSeqWriter: invalid number of threads", 0, 1, 0xFFFFFFFF);
+	}
+	if (queue_length == 0) {
+		throw OutOfBoundsException("AsyncSeqWriter: invalid queue length", 0, 1, 0xFFFFFFFF);
+	}
+
+	num_busy_     = 0;
+	stopping_     = false;
+	cspace_       = CS_UNKNOWN;
+	width_        = 0;
+	height_       = 0;
+	frame_number_ = 0;
+	num_written_  = 0;
+	num_dropped_  = 0;
+	num_failed_   = 0;
+
+	frames_.resize(queue_length);
+	for (size_t i = 0; i < queue_length; ++i) {
+		free_.push_back(i);
+	}
+
+	mutex_      = new Mutex();
+	queue_cond_ = new WaitCondition(mutex_);
+	done_cond_  = new WaitCondition(mutex_);
+
+	std::vector<Writer *> writers;
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		Writer *writer = factory();
+		if (writer == NULL) {
+			for (Writer *w : writers) {
+				delete w;
+			}
+			delete done_cond_;
+			delete queue_cond_;
+			delete mutex_;
+			throw NullPointerException("AsyncSeqWriter: writer factory returned NULL");
+		}
+		writers.push_back(writer);
+	}
+
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		workers_.push_back(new Worker(this, writers[i], i));
+		workers_.back()->start();
+	}
+}
+
+/** Destructor.
+ * Waits until all queued images have been written.
+ */
+AsyncSeqWriter::~AsyncSeqWriter()
+{
+	mutex_->lock();
+	stopping_ = true;
+	queue_cond_->wake_all();
+	mutex_->unlock();
+
+	for (Worker *w : workers_) {
+		w->join();
+		delete w;
+	}
+
+	delete done_cond_;
+	delete queue_cond_;
+	delete mutex_;
+}
+
+/** Set the path to where the images are stored.
+ * @param img_path the image path
+ */
+void
+AsyncSeqWriter::set_path(const char *img_path)
+{
+	MutexLocker lock(mutex_);
+	img_path_ = img_path;
+}
+
+/** Set a (base-) filename.
+ * If a filename is set the name of the files will look like this:
+ * filename_index.ext .
+ * @param filename the (base-) filename
+ */
+void
+AsyncSeqWriter::set_filename(const char *filename)
+{
+	MutexLocker lock(mutex_);
+	filename_ = filename;
+}
+
+/** Set the image dimensions.
+ * Images which are already queued are written with the dimensions set
+ * at the time they were queued.
+ * @param width the width of the image
+ * @param height the height of the image
+ */
+void
+AsyncSeqWriter::set_dimensions(unsigned int width, unsigned int height)
+{
+	MutexLocker lock(mutex_);
+	width_  = width;
+	height_ = height;
+}
+
+/** Set the colorspace of the image.
+ * @param cspace the colospace
+ */
+void
+AsyncSeqWriter::set_colorspace(colorspace_t cspace)
+{
+	MutexLocker lock(mutex_);
+	cspace_ = cspace;
+}
+
+/** Queue an image to be written to disk.
+ * A running number is added to the filename. The image is copied, the
+ * buffer may be changed right after the method returns.
+ * @param buffer the image buffer that is written to disk
+ * @return true if the image has been queued, false if it has been
+ * dropped because the queue is full
+ */
+bool
+AsyncSeqWriter::write(const unsigned char *buffer)
+{
+	mutex_->lock();
+	unsigned int frame_number = ++frame_number_;
+	if (free_.empty()) {
+		++num_dropped_;
+		mutex_->unlock();
+		return false;
+	}
+	size_t slot = free_.front();
+	free_.pop_front();
+	Frame &frame = frames_[slot];
+	frame.cspace = cspace_;
+	frame.width  = width_;
+	frame.height = height_;
+	std::string img_path(img_path_);
+	std::string filename(filename_);
+	mutex_->unlock();
+
+	// the slot belongs to the caller until it is queued, copy without lock
+	try {
+		frame.filename = SeqWriter::frame_filename(img_path.empty() ? NULL : img_path.c_str(),
+		                                           filename.empty() ? NULL : filename.c_str(),
+		                                           frame_number);
+		frame.buffer.resize(colorspace_buffer_size(frame.cspace, frame.width, frame.height));
+		memcpy(frame.buffer.data(), buffer, frame.buffer.size());
+	} catch (std::exception &e) {
+		MutexLocker lock(mutex_);
+		free_.push_back(slot);
+		throw;
+	}
+
+	mutex_->lock();
+	queued_.push_back(slot);
+	queue_cond_->wake_one();
+	mutex_->unlock();
+	return true;
+}
+
+/** Wait until all queued images have been written. */
+void
+AsyncSeqWriter::flush()
+{
+	MutexLocker lock(mutex_);
+	while (!queued_.empty() || (num_busy_ > 0)) {
+		done_cond_->wait();
+	}
+}
+
+/** Write next queued image.
+ * Called by the worker threads, waits for an image if none is queued.
+ * @param writer writer of the calling worker
+ * @return false if the writer is being destroyed and no more images are
+ * queued, true otherwise
+ */
+bool
+AsyncSeqWriter::write_next(Writer *writer)
+{
+	mutex_->lock();
+	while (queued_.empty() && !stopping_) {
+		queue_cond_->wait();
+	}
+	if (queued_.empty()) {
+		mutex_->unlock();
+		return false;
+	}
+	size_t slot = queued_.front();
+	queued_.pop_front();
+	++num_busy_;
+	mutex_->unlock();
+
+	Frame &     frame = frames_[slot];
+	bool        ok    = true;
+	std::string error;
+	try {
+		writer->set_filename(frame.filename.c_str());
+		writer->set_dimensions(frame.width, frame.height);
+		writer->set_buffer(frame.cspace, frame.buffer.data());
+		writer->write();
+	} catch (Exception &e) {
+		ok    = false;
+		error = e.what_no_backtrace();
+	} catch (std::exception &e) {
+		ok    = false;
+		error = e.what();
+	}
+
+	mutex_->lock();
+	if (ok) {
+		++num_written_;
+	} else {
+		++num_failed_;
+		last_error_ = error;
+	}
+	free_.push_back(slot);
+	--num_busy_;
+	done_cond_->wake_all();
+	mutex_->unlock();
+	return true;
+}
+
+/** Get number of written images.
+ * @return number of images written successfully
+ */
+unsigned int
+AsyncSeqWriter::num_written() const
+{
+	MutexLocker lock(mutex_);
+	return num_written_;
+}
+
+/** Get number of dropped images.
+ * @return number of images dropped because the queue was full
+ */
+unsigned int
+AsyncSeqWriter::num_dropped() const
+{
+	MutexLocker lock(mutex_);
+	return num_dropped_;
+}
+
+/** Get number of failed images.
+ * @return number of images the writer failed to write
+ */
+unsigned int
+AsyncSeqWriter::num_failed() const
+{
+	MutexLocker lock(mutex_);
+	return num_failed_;
+}
+
+/** Get last error.
+ * @return error message of the last image the writer failed to write,
+ * empty if none failed
+ */
+std::string
+AsyncSeqWriter::last_error() const
+{
+	MutexLocker lock(mutex_);
+	return last_error_;
+}
+
+} // end namespace firevision
@@ -0,0 +1,109 @@
+
+/***************************************************************************
+ *  async_seq_writer.h - Write image sequences in background threads
+ *
+ *  Created: Thu Oct 15 05:44:03 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FVUTILS_WRITERS_ASYNC_SEQ_WRITER_H_
+#define _FIREVISION_FVUTILS_WRITERS_ASYNC_SEQ_WRITER_H_
+
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/writers/writer.h>
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Mutex;
+class WaitCondition;
+} // namespace fawkes
+
+namespace firevision {
+
+class AsyncSeqWriter
+{
+public:
+	/** Function creating a writer instance for one worker thread. */
+	typedef std::function<Writer *()> WriterFactory;
+
+	AsyncSeqWriter(WriterFactory factory,
+	               unsigned int  num_threads  = 1,
+	               unsigned int  queue_length = 8);
+	~AsyncSeqWriter();
+
+	void set_path(const char *img_path);
+	void set_filename(const char *filename);
+
+	void set_dimensions(unsigned int width, unsigned int height);
+	void set_colorspace(colorspace_t cspace);
+
+	bool write(const unsigned char *buffer);
+	void flush();
+
+	unsigned int num_written() const;
+	unsigned int num_dropped() const;
+	unsigned int num_failed() const;
+	std::string  last_error() const;
+
+private:
+	/** Frame waiting to be written. */
+	typedef struct
+	{
+		std::vector<unsigned char> buffer;   /**< copy of the image */
+		std::string                filename; /**< filename without extension */
+		colorspace_t               cspace;   /**< colorspace of the image */
+		unsigned int               width;    /**< width of the image */
+		unsigned int               height;   /**< height of the image */
+	} Frame;
+
+	class Worker;
+
+	bool write_next(Writer *writer);
+
+private:
+	std::vector<Worker *> workers_;
+	std::vector<Frame>    frames_;
+	std::deque<size_t>    free_;
+	std::deque<size_t>    queued_;
+	unsigned int          num_busy_;
+	bool                  stopping_;
+
+	fawkes::Mutex *        mutex_;
+	fawkes::WaitCondition *queue_cond_;
+	fawkes::WaitCondition *done_cond_;
+
+	std::string  img_path_;
+	std::string  filename_;
+	colorspace_t cspace_;
+	unsigned int width_;
+	unsigned int height_;
+	unsigned int frame_number_;
+
+	unsigned int num_written_;
+	unsigned int num_dropped_;
+	unsigned int num_failed_;
+	std::string  last_error_;
+};
+
+} // end namespace firevision
+
+#endif
@@ -116,6 +116,29 @@ void
 SeqWriter::write(unsigned char *buffer)
 {
 	++frame_number;
+
+	std::string fn = frame_filename(img_path, filename, frame_number);
+	writer->set_filename(fn.c_str());
+
+	try {
+		writer->set_buffer(cspace, buffer);
+		writer->write();
+	} catch (Exception &e) {
+		throw;
+	}
+}
+
+/** Get filename of a frame.
+ * The filename contains the current time and the frame number, the
+ * extension is added by the writer.
+ * @param img_path path to where the images are stored, may be NULL
+ * @param filename (base-) filename, may be NULL
+ * @param frame_number running number of the frame
+ * @return filename of the frame
+ */
+std::string
+SeqWriter::frame_filename(const char *img_path, const char *filename, unsigned int frame_number)
+{
 	char *fn;
 
 	time_t         now = time(NULL);
@@ -139,39 +162,30 @@ SeqWriter::write(unsigned char *buffer)
 		throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (1)");
 	}
 
+	int rv;
 	if (filename) {
 		// filename: YYYYMMDD-hhmmss_uuuuuu_name_index.ext
 		if (img_path) {
-			if (asprintf(&fn, "%s/%s_%s-%04u", img_path, timestring, filename, frame_number) == -1) {
-				throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (2)");
-			}
+			rv = asprintf(&fn, "%s/%s_%s-%04u", img_path, timestring, filename, frame_number);
 		} else {
-			if (asprintf(&fn, "%s_%s-%04u", timestring, filename, frame_number) == -1) {
-				throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (2)");
-			}
+			rv = asprintf(&fn, "%s_%s-%04u", timestring, filename, frame_number);
 		}
 	} else {
 		// filename: YYYYMMDD-hhmmss_uuuuuu_index.ext
 		if (img_path) {
-			if (asprintf(&fn, "%s/%s-%04u", img_path, timestring, frame_number) == -1) {
-				throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (3)");
-			}
+			rv = asprintf(&fn, "%s/%s-%04u", img_path, timestring, frame_number);
 		} else {
-			if (asprintf(&fn, "%s-%04u", timestring, frame_number) == -1) {
-				throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (4)");
-			}
+			rv = asprintf(&fn, "%s-%04u", timestring, frame_number);
 		}
 	}
+	free(timestring);
+	if (rv == -1) {
+		throw OutOfMemoryException("SeqWriter::write(): asprintf() failed (2)");
+	}
 
-	writer->set_filename(fn);
+	std::string rv_fn(fn);
 	free(fn);
-
-	try {
-		writer->set_buffer(cspace, buffer);
-		writer->write();
-	} catch (Exception &e) {
-		throw;
-	}
+	return rv_fn;
 }
 
 } // end namespace firevision
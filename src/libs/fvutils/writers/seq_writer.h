@@ -28,6 +28,8 @@
 #include <fvutils/color/colorspaces.h>
 #include <fvutils/writers/writer.h>
 
+#include <string>
+
 namespace firevision {
 
 class SeqWriter
@@ -44,6 +46,9 @@ public:
 
 	void write(unsigned char *buffer);
 
+	static std::string
+	frame_filename(const char *img_path, const char *filename, unsigned int frame_number);
+
 private:
 	Writer *     writer;
 	char *       filename;
@@ -293,6 +293,34 @@ InterfaceFieldIterator::get_length() const
 	}
 }
 
+/** Get size of the data of the current field.
+ * @return number of bytes the field occupies in the data chunk
+ */
+size_t
+InterfaceFieldIterator::get_data_size() const
+{
+	if (infol_ == NULL) {
+		throw NullPointerException("Cannot get size of end element");
+	}
+	switch (infol_->type) {
+	case IFT_BOOL: return infol_->length * sizeof(bool);
+	case IFT_INT8: return infol_->length * sizeof(int8_t);
+	case IFT_UINT8: return infol_->length * sizeof(uint8_t);
+	case IFT_INT16: return infol_->length * sizeof(int16_t);
+	case IFT_UINT16: return infol_->length * sizeof(uint16_t);
+	case IFT_INT32: return infol_->length * sizeof(int32_t);
+	case IFT_UINT32: return infol_->length * sizeof(uint32_t);
+	case IFT_INT64: return infol_->length * sizeof(int64_t);
+	case IFT_UINT64: return infol_->length * sizeof(uint64_t);
+	case IFT_FLOAT: return infol_->length * sizeof(float);
+	case IFT_DOUBLE: return infol_->length * sizeof(double);
+	case IFT_STRING: return infol_->length;
+	case IFT_BYTE: return infol_->length * sizeof(uint8_t);
+	case IFT_ENUM: return infol_->length * sizeof(int32_t);
+	}
+	return 0;
+}
+
 /** Get value of current field as string.
  * @param array_sep in the case that the field is an array the given string is
  * used to split the individual elements in the array string representation
@@ -61,6 +61,7 @@ public:
 	const void *            get_value() const;
 	const char *            get_value_string(const char *array_sep = ", ");
 	size_t                  get_length() const;
+	size_t                  get_data_size() const;
 	bool                    get_bool(unsigned int index = 0) const;
 	int8_t                  get_int8(unsigned int index = 0) const;
 	uint8_t                 get_uint8(unsigned int index = 0) const;
@@ -25,19 +25,25 @@
 #include <core/threading/mutex_locker.h>
 #include <core/threading/refc_rwlock.h>
 #include <interface/interface.h>
+#include <interface/json.h>
 #include <interface/mediators/interface_mediator.h>
 #include <interface/mediators/message_mediator.h>
 #include <utils/misc/strndup.h>
 #include <utils/time/clock.h>
 #include <utils/time/time.h>
+#include <utils/time/trace_recorder.h>
 
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <regex.h>
+#include <sched.h>
 #include <typeinfo>
 
+// Number of optimistic copy attempts before falling back to the read lock
+#define INTERFACE_SEQLOCK_MAX_RETRIES 8
+
 namespace fawkes {
 
 /** @class InterfaceWriteDeniedException <interface/interface.h>
@@ -142,6 +148,20 @@ InterfaceInvalidException::InterfaceInvalidException(const Interface *interface,
  * section. Upon opening the interface, the private section is copied
  * once from the shared section, even when opening a writer.
  *
+ * If the shared section provides a data sequence counter (which is the
+ * case for interfaces opened from the LocalBlackBoard), reading
+ * instances do not acquire the ReadWriteLock at all. The writer
+ * increments the counter before and after copying data into the shared
+ * section, so that the counter is odd while a write is in
+ * progress. A reader copies the data optimistically and only retries
+ * if the counter changed during the copy. After a few unsuccessful
+ * attempts the reader falls back to acquiring the read lock, hence
+ * readers cannot be starved by a high-rate writer. Writers still
+ * exclude each other using the write lock.
+ * The counter also serves as a write generation: read() does not copy
+ * anything if the counter did not change since the last read, which
+ * makes polling slowly changing interfaces cheap.
+ *
  * An interface has an internal timestamp. This timestamp indicates
  * when the data in the interface has been modified last. The
  * timestamp is usually automatically updated. But it some occasions
@@ -240,6 +260,14 @@ Interface::Interface()
 {
 	write_access_         = false;
 	rwlock_               = NULL;
+	mem_data_seq_         = NULL;
+	read_data_seq_        = INTERFACE_DATA_SEQ_INVALID;
+	mem_stats_            = NULL;
+	mem_trace_            = NULL;
+	mem_seqlock_only_     = false;
+	latency_trace_        = {0, 0, 0, 0};
+	trace_write_event_    = 0;
+	trace_message_event_  = 0;
 	valid_                = true;
 	next_message_id_      = 0;
 	num_fields_           = 0;
@@ -261,6 +289,9 @@ Interface::Interface()
 	buffers_     = NULL;
 	num_buffers_ = 0;
 
+	field_descriptors_     = NULL;
+	num_field_descriptors_ = 0;
+
 	message_queue_ = new MessageQueue();
 	data_mutex_    = new Mutex();
 }
@@ -471,29 +502,202 @@ Interface::is_valid() const
 	return valid_;
 }
 
+/// @cond INTERNALS
+bool Interface::stats_enabled_ = false;
+/// @endcond
+
+/** Enable or disable usage statistics.
+ * If enabled, interfaces count reads, writes, and enqueued messages and
+ * measure the time waited for the read/write lock. The statistics are
+ * stored with the interface memory and shared among all instances of an
+ * interface. This applies to all interfaces of the process. It is
+ * disabled by default, as it requires atomic operations on shared memory
+ * and clock queries on each access.
+ * @param enabled true to enable statistics, false to disable
+ */
+void
+Interface::set_stats_enabled(bool enabled)
+{
+	__atomic_store_n(&stats_enabled_, enabled, __ATOMIC_RELAXED);
+}
+
+/** Check if usage statistics are enabled.
+ * @return true if statistics are enabled, false otherwise
+ */
+bool
+Interface::stats_enabled()
+{
+	return __atomic_load_n(&stats_enabled_, __ATOMIC_RELAXED);
+}
+
+/** Get usage statistics.
+ * @return usage statistics of the interface, shared among all instances,
+ * all zero if the interface has no statistics (e.g. remote interfaces)
+ */
+interface_stats_t
+Interface::stats() const
+{
+	interface_stats_t rv;
+	interface_stats_copy(mem_stats_, rv);
+	return rv;
+}
+
+/** Get latency trace of the data.
+ * For a reading instance this is the trace of the data at the last
+ * read(), for a writing instance the trace attached by the last write().
+ * @return latency trace, its ID is zero if the data is not traced
+ * @see LatencyTrace
+ */
+const latency_trace_t &
+Interface::latency_trace() const
+{
+	return latency_trace_;
+}
+
+/** Get statistics to update.
+ * @return statistics if available and enabled, NULL otherwise
+ */
+interface_stats_t *
+Interface::active_stats() const
+{
+	if (mem_stats_ && __atomic_load_n(&stats_enabled_, __ATOMIC_RELAXED)) {
+		return mem_stats_;
+	} else {
+		return NULL;
+	}
+}
+
+/** Copy shared memory to buffer without locking.
+ * This performs an optimistic copy of the shared memory section
+ * guarded by the data sequence counter. The copy is repeated if a
+ * concurrent write() was detected. If the read lock of the interface
+ * does not exclude the writer, see set_memory(), the copy is retried,
+ * yielding in between, until it succeeds.
+ * @param buffer buffer to copy to, must be at least of datasize() bytes
+ * @param seq upon successful return set to the data sequence number the
+ * copy corresponds to, may be NULL
+ * @param trace upon successful return set to the latency trace of the
+ * copied data, may be NULL
+ * @return true if a consistent copy has been made, false if no sequence
+ * counter is available or the maximum number of attempts was exceeded.
+ * In the latter case the caller must copy the data holding the read lock.
+ * Always true for chunks that are read with the sequence counter only.
+ */
+bool
+Interface::copy_shared_lockfree(void *buffer, uint32_t *seq, latency_trace_t *trace)
+{
+	if (mem_data_seq_ == NULL)
+		return false;
+
+	for (unsigned int i = 0; mem_seqlock_only_ || i < INTERFACE_SEQLOCK_MAX_RETRIES; ++i) {
+		uint32_t seq_begin = __atomic_load_n(mem_data_seq_, __ATOMIC_ACQUIRE);
+		if (seq_begin & 1) {
+			// write in progress
+			sched_yield();
+			continue;
+		}
+		memcpy(buffer, mem_data_ptr_, data_size);
+		latency_trace_t copied_trace = mem_trace_ ? *mem_trace_ : latency_trace_t{0, 0, 0, 0};
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(mem_data_seq_, __ATOMIC_RELAXED) == seq_begin) {
+			if (seq)
+				*seq = seq_begin;
+			if (trace)
+				*trace = copied_trace;
+			return true;
+		}
+		if (i >= INTERFACE_SEQLOCK_MAX_RETRIES) {
+			// the read lock cannot help, give the writer a chance to finish
+			sched_yield();
+		}
+	}
+	return false;
+}
+
 /** Read from BlackBoard into local copy.
+ * For interfaces with a data sequence counter this does not acquire the
+ * read lock unless a concurrent writer keeps interfering with the copy.
+ * If nothing has been written since the last read the data is not
+ * copied at all. The latency trace of the data is adopted by the calling
+ * thread, see LatencyTrace.
  * @exception InterfaceInvalidException thrown if the interface has
  * been marked invalid
+ * @see read_if_changed()
  */
 void
 Interface::read()
 {
-	rwlock_->lock_for_read();
+	read_if_changed();
+}
+
+/** Read from BlackBoard into local copy if data has been written.
+ * This compares the data sequence number of the shared section, which
+ * the writer increments on every write(), to the one the private copy
+ * corresponds to. Only if they differ the data is copied, otherwise
+ * this only updates the timestamps just like read(), hence refreshed()
+ * will return false afterwards. Interfaces without a data sequence
+ * counter are always copied.
+ * @return true if the data has been copied, false if the private copy
+ * was already up to date
+ * @exception InterfaceInvalidException thrown if the interface has
+ * been marked invalid
+ */
+bool
+Interface::read_if_changed()
+{
+	bool copied = false;
 	data_mutex_->lock();
 	if (valid_) {
-		memcpy(data_ptr, mem_data_ptr_, data_size);
-		*local_read_timestamp_ = *timestamp_;
-		timestamp_->set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
-	} else {
+		if (mem_data_seq_) {
+			uint32_t seq = __atomic_load_n(mem_data_seq_, __ATOMIC_ACQUIRE);
+			// odd numbers mark writes in progress and never match a read copy
+			copied = (seq & 1) || (seq != read_data_seq_);
+		} else {
+			copied = true;
+		}
+	}
+	interface_stats_t *stats = active_stats();
+	if (copied && !copy_shared_lockfree(data_ptr, &read_data_seq_, &latency_trace_)) {
+		// keep lock order of write(), read lock first
 		data_mutex_->unlock();
+		if (stats) {
+			uint64_t start = interface_stats_clock_nsec();
+			rwlock_->lock_for_read();
+			__atomic_fetch_add(&stats->read_lock_wait_nsec,
+			                   interface_stats_clock_nsec() - start,
+			                   __ATOMIC_RELAXED);
+			__atomic_fetch_add(&stats->num_read_locked, 1, __ATOMIC_RELAXED);
+		} else {
+			rwlock_->lock_for_read();
+		}
+		data_mutex_->lock();
+		if (valid_) {
+			memcpy(data_ptr, mem_data_ptr_, data_size);
+			read_data_seq_ = mem_data_seq_ ? *mem_data_seq_ : INTERFACE_DATA_SEQ_INVALID;
+			if (mem_trace_)
+				latency_trace_ = *mem_trace_;
+		}
 		rwlock_->unlock();
+	}
+	if (!valid_) {
+		data_mutex_->unlock();
 		throw InterfaceInvalidException(this, "read()");
 	}
+	*local_read_timestamp_ = *timestamp_;
+	timestamp_->set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
+	LatencyTrace::adopt(latency_trace_);
 	data_mutex_->unlock();
-	rwlock_->unlock();
+	if (stats) {
+		__atomic_fetch_add(&stats->num_reads, 1, __ATOMIC_RELAXED);
+		if (copied)
+			__atomic_fetch_add(&stats->num_read_copies, 1, __ATOMIC_RELAXED);
+	}
+	return copied;
 }
 
 /** Write from local copy into BlackBoard memory.
+ * The current latency trace of the calling thread is attached to the
+ * data, see LatencyTrace.
  * @exception InterfaceInvalidException thrown if the interface has
  * been marked invalid
  */
@@ -504,7 +708,18 @@ Interface::write()
 		throw InterfaceWriteDeniedException(type_, id_, "Cannot write.");
 	}
 
-	rwlock_->lock_for_write();
+	TraceRecorder::Scope trace(trace_write_event_);
+	interface_stats_t *  stats = active_stats();
+	if (stats) {
+		uint64_t start = interface_stats_clock_nsec();
+		rwlock_->lock_for_write();
+		__atomic_fetch_add(&stats->write_lock_wait_nsec,
+		                   interface_stats_clock_nsec() - start,
+		                   __ATOMIC_RELAXED);
+		__atomic_fetch_add(&stats->num_writes, 1, __ATOMIC_RELAXED);
+	} else {
+		rwlock_->lock_for_write();
+	}
 	data_mutex_->lock();
 	bool has_changed = false;
 	if (valid_) {
@@ -521,7 +736,21 @@ Interface::write()
 			has_changed  = true;
 			data_changed = false;
 		}
-		memcpy(mem_data_ptr_, data_ptr, data_size);
+		latency_trace_ = LatencyTrace::current();
+		if (mem_data_seq_) {
+			// odd sequence number marks a write in progress for lock-free readers
+			__atomic_store_n(mem_data_seq_, *mem_data_seq_ + 1, __ATOMIC_RELAXED);
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+			memcpy(mem_data_ptr_, data_ptr, data_size);
+			if (mem_trace_)
+				*mem_trace_ = latency_trace_;
+			__atomic_store_n(mem_data_seq_, *mem_data_seq_ + 1, __ATOMIC_RELEASE);
+			read_data_seq_ = *mem_data_seq_;
+		} else {
+			memcpy(mem_data_ptr_, data_ptr, data_size);
+			if (mem_trace_)
+				*mem_trace_ = latency_trace_;
+		}
 	} else {
 		data_mutex_->unlock();
 		rwlock_->unlock();
@@ -558,6 +787,10 @@ Interface::set_type_id(const char *type, const char *id)
 	type_[INTERFACE_TYPE_SIZE_] = 0;
 	id_[INTERFACE_ID_SIZE_]     = 0;
 	uid_[INTERFACE_UID_SIZE_]   = 0;
+
+	std::string uid(uid_);
+	trace_write_event_   = TraceRecorder::event("blackboard", ("write " + uid).c_str());
+	trace_message_event_ = TraceRecorder::event("blackboard", ("message " + uid).c_str());
 }
 
 /** Set instance serial.
@@ -584,13 +817,34 @@ Interface::set_mediators(InterfaceMediator *iface_mediator, MessageMediator *msg
  * @param serial mem serial
  * @param real_ptr pointer to whole chunk
  * @param data_ptr pointer to data chunk
+ * @param data_seq pointer to data sequence counter stored with the chunk,
+ * may be NULL in which case read() always acquires the read lock.
+ * @param stats pointer to usage statistics stored with the chunk, may be
+ * NULL in which case no statistics are recorded.
+ * @param trace pointer to latency trace stored with the chunk, may be
+ * NULL in which case the data is not traced.
+ * @param seqlock_only true if the read lock of the interface does not
+ * exclude the writer of the chunk, e.g. if the chunk is shared with
+ * another process. Reads then never fall back to copying under the read
+ * lock but only rely on @p data_seq, which must not be NULL in that case.
  */
 void
-Interface::set_memory(unsigned int serial, void *real_ptr, void *data_ptr)
+Interface::set_memory(unsigned int       serial,
+                      void *             real_ptr,
+                      void *             data_ptr,
+                      uint32_t *         data_seq,
+                      interface_stats_t *stats,
+                      latency_trace_t *  trace,
+                      bool               seqlock_only)
 {
 	mem_serial_   = serial;
 	mem_real_ptr_ = real_ptr;
 	mem_data_ptr_ = data_ptr;
+	mem_data_seq_ = data_seq;
+	mem_stats_    = stats;
+	mem_trace_    = trace;
+
+	mem_seqlock_only_ = seqlock_only && (data_seq != NULL);
 }
 
 /** Set read/write info.
@@ -767,6 +1021,7 @@ void
 Interface::mark_data_refreshed()
 {
 	data_refreshed = true;
+	read_data_seq_ = INTERFACE_DATA_SEQ_INVALID;
 }
 
 /** Mark data as changed. There should be no sensible reason for
@@ -836,6 +1091,7 @@ Interface::set_from_chunk(void *chunk)
 	//   throw NullPointerException("Interface not initialized");
 
 	memcpy(data_ptr, chunk, data_size);
+	read_data_seq_ = INTERFACE_DATA_SEQ_INVALID;
 }
 
 /** Check if there is a writer for the interface.
@@ -919,8 +1175,13 @@ Interface::msgq_enqueue(Message *message, bool proxy)
 	}
 
 	if (message_valid(message)) {
+		TraceRecorder::Scope trace(trace_message_event_);
+		interface_stats_t *  stats = active_stats();
+		if (stats)
+			__atomic_fetch_add(&stats->num_messages, 1, __ATOMIC_RELAXED);
 		message->set_interface(this, proxy);
 		message->set_id(next_msg_id());
+		message->latency_trace_ = LatencyTrace::current();
 		// transmit might change the message id!
 		message_mediator_->transmit(message);
 		unsigned int msgid = message->id();
@@ -960,9 +1221,14 @@ Interface::msgq_enqueue_copy(Message *message)
 	}
 
 	if (message_valid(message)) {
+		TraceRecorder::Scope trace(trace_message_event_);
+		interface_stats_t *  stats = active_stats();
+		if (stats)
+			__atomic_fetch_add(&stats->num_messages, 1, __ATOMIC_RELAXED);
 		Message *mcopy = message->clone();
 		mcopy->set_interface(this);
 		mcopy->set_id(next_msg_id());
+		mcopy->latency_trace_ = LatencyTrace::current();
 		message_mediator_->transmit(mcopy);
 		unsigned int msgid = mcopy->id();
 		mcopy->unref();
@@ -1192,7 +1458,8 @@ Interface::msgq_end()
 
 /** Get the first message from the message queue.
  *
- * This can only be called on a writing interface instance.
+ * This can only be called on a writing interface instance. The latency
+ * trace of the message is adopted by the calling thread, see LatencyTrace.
  *
  * @return first message in queue or NULL if there is none
  */
@@ -1205,7 +1472,10 @@ Interface::msgq_first()
 		                                    "Cannot work on message queue on "
 		                                    "reading instance of an interface (first).");
 	}
-	return message_queue_->first();
+	Message *m = message_queue_->first();
+	if (m)
+		LatencyTrace::adopt(m->latency_trace_);
+	return m;
 }
 
 /** Erase first message from queue.
@@ -1224,6 +1494,36 @@ Interface::msgq_pop()
 	message_queue_->pop();
 }
 
+/** Remove all messages from queue at once.
+ * All queued messages are appended to the given vector in queue order
+ * and removed from the queue in a single operation. This is cheaper than
+ * repeatedly calling msgq_first() and msgq_pop(), for example when
+ * processing bursts of messages. Ownership of one reference of each
+ * message is passed to the caller, hence call unref() on each message
+ * when done with it.
+ * This can only be called on a writing interface instance. The latency
+ * traces of the messages are adopted by the calling thread.
+ * @param messages vector to append messages to
+ * @return number of messages appended to @p messages
+ */
+unsigned int
+Interface::msgq_drain(std::vector<Message *> &messages)
+{
+	if (!write_access_) {
+		throw InterfaceWriteDeniedException(type_,
+		                                    id_,
+		                                    "Cannot work on message queue on "
+		                                    "reading instance of an interface (drain).");
+	}
+
+	size_t       first = messages.size();
+	unsigned int num   = message_queue_->drain(messages);
+	for (size_t i = first; i < messages.size(); ++i) {
+		LatencyTrace::adopt(messages[i]->latency_trace_);
+	}
+	return num;
+}
+
 /** Get iterator over all fields of this interface instance.
  * @return field iterator pointing to the very first value
  */
@@ -1242,6 +1542,50 @@ Interface::fields_end()
 	return InterfaceFieldIterator();
 }
 
+/** Get static field descriptors.
+ * The descriptors give type, name, and offset of each field in the data
+ * chunk. They are the same for all instances of an interface type and
+ * can be used to access the fields with datachunk() without walking
+ * the field info list.
+ * @param num_descriptors upon return contains the number of descriptors
+ * @return array of field descriptors, NULL if the interface does not
+ * provide descriptors
+ */
+const interface_field_descriptor_t *
+Interface::field_descriptors(unsigned int &num_descriptors) const
+{
+	num_descriptors = num_field_descriptors_;
+	return field_descriptors_;
+}
+
+/** Set static field descriptors.
+ * To be called by generated interfaces in their constructor.
+ * @param descriptors array of field descriptors, must stay valid for
+ * the lifetime of the interface
+ * @param num_descriptors number of elements in @p descriptors
+ */
+void
+Interface::set_field_descriptors(const interface_field_descriptor_t *descriptors,
+                                 unsigned int                        num_descriptors)
+{
+	field_descriptors_     = descriptors;
+	num_field_descriptors_ = num_descriptors;
+}
+
+/** Serialize data fields as JSON object.
+ * Appends a JSON object with one member per field of the local data
+ * copy to the given string. Enum values are written as their names.
+ * Generated interfaces override this with a specialized version which
+ * does not need to walk the field info list.
+ * @param json string to append the JSON object to
+ */
+void
+Interface::to_json(std::string &json) const
+{
+	Interface *iface = const_cast<Interface *>(this);
+	json_append_fields(json, iface->fields(), iface->fields_end());
+}
+
 /** Get the number of fields in the interface.
  * @return the number of fields
  */
@@ -1299,20 +1643,25 @@ Interface::copy_shared_to_buffer(unsigned int buffer)
 		throw OutOfBoundsException("Buffer ID out of bounds", buffer, 0, num_buffers_);
 	}
 
-	rwlock_->lock_for_read();
 	data_mutex_->lock();
 
 	void *buf = (char *)buffers_ + buffer * data_size;
 
-	if (valid_) {
-		memcpy(buf, mem_data_ptr_, data_size);
-	} else {
+	if (valid_ && !copy_shared_lockfree(buf)) {
 		data_mutex_->unlock();
+		rwlock_->lock_for_read();
+		data_mutex_->lock();
+		buf = (char *)buffers_ + buffer * data_size;
+		if (valid_) {
+			memcpy(buf, mem_data_ptr_, data_size);
+		}
 		rwlock_->unlock();
+	}
+	if (!valid_) {
+		data_mutex_->unlock();
 		throw InterfaceInvalidException(this, "copy_shared_to_buffer()");
 	}
 	data_mutex_->unlock();
-	rwlock_->unlock();
 }
 
 /** Copy data from private memory to buffer.
@@ -1344,6 +1693,7 @@ Interface::read_from_buffer(unsigned int buffer)
 	data_mutex_->lock();
 	void *buf = (char *)buffers_ + buffer * data_size;
 	memcpy(data_ptr, buf, data_size);
+	read_data_seq_         = INTERFACE_DATA_SEQ_INVALID;
 	*local_read_timestamp_ = *timestamp_;
 	timestamp_->set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
 
@@ -26,11 +26,14 @@
 #include <core/exception.h>
 #include <interface/message.h>
 #include <interface/message_queue.h>
+#include <interface/stats.h>
+#include <utils/time/latency_trace.h>
 #include <utils/uuid.h>
 
 #include <cstddef>
 #include <list>
 #include <stdint.h>
+#include <vector>
 
 #define INTERFACE_TYPE_SIZE_ 48
 #define INTERFACE_ID_SIZE_ 64
@@ -38,6 +41,9 @@
 #define INTERFACE_HASH_SIZE_ 16
 //  UID is:                                   type  ::   id
 #define INTERFACE_UID_SIZE_ INTERFACE_TYPE_SIZE_ + 2 + INTERFACE_ID_SIZE_
+/** Marker for a private copy not known to match any data sequence number.
+ * Sequence numbers of consistent shared data are always even. */
+#define INTERFACE_DATA_SEQ_INVALID 1
 
 namespace fawkes {
 
@@ -51,6 +57,8 @@ class BlackBoardInterfaceManager;
 class BlackBoardInstanceFactory;
 class BlackBoardMessageManager;
 class BlackBoardInterfaceProxy;
+class InterfaceReadGuard;
+class InterfaceGroup;
 
 class InterfaceWriteDeniedException : public Exception
 {
@@ -82,6 +90,8 @@ class Interface
 	friend BlackBoardInstanceFactory;
 	friend BlackBoardMessageManager;
 	friend BlackBoardInterfaceProxy;
+	friend InterfaceReadGuard;
+	friend InterfaceGroup;
 
 public:
 	virtual ~Interface();
@@ -102,12 +112,19 @@ public:
 	void                 set_validity(bool valid);
 	bool                 is_valid() const;
 	const char *         owner() const;
+	interface_stats_t    stats() const;
+
+	const latency_trace_t &latency_trace() const;
+
+	static void set_stats_enabled(bool enabled);
+	static bool stats_enabled();
 
 	void set_from_chunk(void *chunk);
 
 	virtual Message *   create_message(const char *type) const             = 0;
 	virtual void        copy_values(const Interface *interface)            = 0;
 	virtual const char *enum_tostring(const char *enumtype, int val) const = 0;
+	virtual void        to_json(std::string &json) const;
 
 	void         resize_buffers(unsigned int num_buffers);
 	unsigned int num_buffers() const;
@@ -119,6 +136,7 @@ public:
 	void         buffer_timestamp(unsigned int buffer, Time *timestamp);
 
 	void read();
+	bool read_if_changed();
 	void write();
 
 	bool                   has_writer() const;
@@ -150,6 +168,7 @@ public:
 	Message *    msgq_first();
 	bool         msgq_empty();
 	void         msgq_append(Message *message);
+	unsigned int msgq_drain(std::vector<Message *> &messages);
 
 	/** Check if first message has desired type.
    * @return true, if message has desired type, false otherwise
@@ -206,6 +225,8 @@ public:
 	InterfaceFieldIterator fields();
 	InterfaceFieldIterator fields_end();
 
+	const interface_field_descriptor_t *field_descriptors(unsigned int &num_descriptors) const;
+
 	unsigned int num_fields();
 
 	/* Convenience */
@@ -223,6 +244,8 @@ protected:
 	                   const char *                enumtype = 0,
 	                   const interface_enum_map_t *enum_map = 0);
 	void add_messageinfo(const char *name);
+	void set_field_descriptors(const interface_field_descriptor_t *descriptors,
+	                           unsigned int                        num_descriptors);
 
 	/** Set a field, set @ref data_changed to true and update
 	 * @ref data_changed accordingly
@@ -252,10 +275,20 @@ private:
 	void set_type_id(const char *type, const char *id);
 	void set_instance_serial(const Uuid &serial);
 	void set_mediators(InterfaceMediator *iface_mediator, MessageMediator *msg_mediator);
-	void set_memory(unsigned int serial, void *real_ptr, void *data_ptr);
+	void set_memory(unsigned int       serial,
+	                void *             real_ptr,
+	                void *             data_ptr,
+	                uint32_t *         data_seq,
+	                interface_stats_t *stats        = NULL,
+	                latency_trace_t *  trace        = NULL,
+	                bool               seqlock_only = false);
 	void set_readwrite(bool write_access, RefCountRWLock *rwlock);
 	void set_owner(const char *owner);
 
+	bool copy_shared_lockfree(void *buffer, uint32_t *seq = NULL, latency_trace_t *trace = NULL);
+
+	interface_stats_t *active_stats() const;
+
 	inline unsigned int
 	next_msg_id()
 	{
@@ -272,10 +305,20 @@ private:
 	Uuid instance_serial_;
 	bool valid_;
 
-	void *       mem_data_ptr_;
-	void *       mem_real_ptr_;
-	unsigned int mem_serial_;
-	bool         write_access_;
+	void *             mem_data_ptr_;
+	void *             mem_real_ptr_;
+	uint32_t *         mem_data_seq_;
+	uint32_t           read_data_seq_;
+	interface_stats_t *mem_stats_;
+	latency_trace_t *  mem_trace_;
+	bool               mem_seqlock_only_;
+	latency_trace_t    latency_trace_;
+	unsigned int       mem_serial_;
+	bool               write_access_;
+	unsigned int       trace_write_event_;
+	unsigned int       trace_message_event_;
+
+	static bool stats_enabled_;
 
 	void *       buffers_;
 	unsigned int num_buffers_;
@@ -293,6 +336,9 @@ private:
 
 	unsigned int num_fields_;
 
+	const interface_field_descriptor_t *field_descriptors_;
+	unsigned int                        num_field_descriptors_;
+
 	Clock *clock_;
 	Time * timestamp_;
 	Time * local_read_timestamp_;
@@ -305,6 +351,7 @@ Interface::set_field(FieldT &field, DataT &data)
 {
 	data_changed |= change_field(field, data);
 	data_refreshed = true;
+	read_data_seq_ = INTERFACE_DATA_SEQ_INVALID;
 }
 
 template <class FieldT, class DataT>
@@ -313,6 +360,7 @@ Interface::set_field(FieldT &field, unsigned int index, DataT &data)
 {
 	data_changed |= change_field(field, index, data);
 	data_refreshed = true;
+	read_data_seq_ = INTERFACE_DATA_SEQ_INVALID;
 }
 
 template <class MessageType>
@@ -0,0 +1,246 @@
+
+/***************************************************************************
+ *  interface_group.cpp - Group of interfaces read in one batch
+ *
+ *  Created: Wed Oct 14 18:16:22 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/refc_rwlock.h>
+#include <interface/interface.h>
+#include <interface/interface_group.h>
+#include <utils/time/latency_trace.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace fawkes {
+
+/** @class InterfaceGroup <interface/interface_group.h>
+ * Group of interfaces read in one batch.
+ * Components that consume many interfaces per loop, for example to
+ * synchronize or log them, would otherwise call Interface::read() on
+ * each of them. The group instead acquires the read locks of all
+ * interfaces once, copies the data of all interfaces that have been
+ * written since they have last been read, and then releases the locks
+ * again. Interfaces whose data sequence number did not change are not
+ * copied at all, only their timestamps are updated such that
+ * Interface::refreshed() and Interface::changed() keep their meaning.
+ *
+ * The read locks are acquired in a canonical order (sorted by lock
+ * address) and each lock only once, even if the same interface has
+ * been opened multiple times. Hence groups with overlapping members
+ * cannot deadlock each other. While read() is running no writer can
+ * modify any member, therefore the group yields a consistent snapshot
+ * of all of its interfaces. Members of a remote BlackBoard attached to
+ * its shared memory are an exception, the lock does not exclude their
+ * writers. Each of them is copied consistently, but not necessarily
+ * at the same point in time as the other members.
+ *
+ * Just like Interface::read() the group updates the usage statistics of
+ * each member and adopts the latency trace of each member's data, see
+ * LatencyTrace. The read lock is always taken, hence every read is
+ * accounted as locked read.
+ *
+ * The group does not own the interfaces. They must be removed before
+ * they are closed.
+ */
+
+/** Constructor. */
+InterfaceGroup::InterfaceGroup() : rwlocks_dirty_(false)
+{
+}
+
+/** Constructor.
+ * @param interfaces initial members of the group
+ */
+InterfaceGroup::InterfaceGroup(const std::vector<Interface *> &interfaces)
+: interfaces_(interfaces), rwlocks_dirty_(true)
+{
+}
+
+/** Constructor.
+ * @param interfaces initial members of the group, e.g. as returned by
+ * BlackBoard::open_multiple_for_reading()
+ */
+InterfaceGroup::InterfaceGroup(const std::list<Interface *> &interfaces)
+: interfaces_(interfaces.begin(), interfaces.end()), rwlocks_dirty_(true)
+{
+}
+
+/** Destructor. */
+InterfaceGroup::~InterfaceGroup()
+{
+}
+
+/** Add interface to group.
+ * @param interface interface to add
+ */
+void
+InterfaceGroup::add(Interface *interface)
+{
+	interfaces_.push_back(interface);
+	rwlocks_dirty_ = true;
+}
+
+/** Remove interface from group.
+ * @param interface interface to remove
+ */
+void
+InterfaceGroup::remove(Interface *interface)
+{
+	interfaces_.erase(std::remove(interfaces_.begin(), interfaces_.end(), interface), interfaces_.end());
+	rwlocks_dirty_ = true;
+}
+
+/** Remove all interfaces from group. */
+void
+InterfaceGroup::clear()
+{
+	interfaces_.clear();
+	rwlocks_.clear();
+	rwlocks_dirty_ = false;
+}
+
+/** Check if group is empty.
+ * @return true if the group has no members, false otherwise
+ */
+bool
+InterfaceGroup::empty() const
+{
+	return interfaces_.empty();
+}
+
+/** Get number of interfaces in group.
+ * @return number of interfaces
+ */
+size_t
+InterfaceGroup::size() const
+{
+	return interfaces_.size();
+}
+
+/** Get members of group.
+ * @return vector of interfaces in the group
+ */
+const std::vector<Interface *> &
+InterfaceGroup::interfaces() const
+{
+	return interfaces_;
+}
+
+/** Collect read locks of members in canonical order. */
+void
+InterfaceGroup::update_locks()
+{
+	rwlocks_.clear();
+	rwlocks_.reserve(interfaces_.size());
+	for (Interface *i : interfaces_) {
+		rwlocks_.push_back(i->rwlock_);
+	}
+	std::sort(rwlocks_.begin(), rwlocks_.end());
+	rwlocks_.erase(std::unique(rwlocks_.begin(), rwlocks_.end()), rwlocks_.end());
+	rwlocks_dirty_ = false;
+}
+
+/** Read all interfaces of the group.
+ * This has the same effect as calling Interface::read() on every
+ * member, including statistics and latency trace, but acquires each
+ * read lock only once and skips copying interfaces which have not been
+ * written since the last read.
+ * @return number of interfaces whose data has actually been copied
+ * @exception InterfaceInvalidException thrown if any of the interfaces
+ * has been marked invalid. All valid interfaces have been read when this
+ * is thrown.
+ */
+unsigned int
+InterfaceGroup::read()
+{
+	if (rwlocks_dirty_)
+		update_locks();
+
+	const bool stats_enabled = Interface::stats_enabled();
+	if (stats_enabled) {
+		lock_wait_nsec_.resize(rwlocks_.size());
+		for (size_t l = 0; l < rwlocks_.size(); ++l) {
+			uint64_t start = interface_stats_clock_nsec();
+			rwlocks_[l]->lock_for_read();
+			lock_wait_nsec_[l] = interface_stats_clock_nsec() - start;
+		}
+	} else {
+		for (RefCountRWLock *l : rwlocks_) {
+			l->lock_for_read();
+		}
+	}
+
+	unsigned int num_copied = 0;
+	Interface *  invalid    = NULL;
+	for (Interface *i : interfaces_) {
+		bool copied = false;
+		bool valid  = false;
+		i->data_mutex_->lock();
+		if (i->valid_) {
+			valid = true;
+			if (i->mem_seqlock_only_) {
+				// the lock does not exclude the writer, copy with the sequence counter
+				uint32_t seq = __atomic_load_n(i->mem_data_seq_, __ATOMIC_ACQUIRE);
+				if ((seq & 1) || seq != i->read_data_seq_) {
+					copied = i->copy_shared_lockfree(i->data_ptr, &i->read_data_seq_, &i->latency_trace_);
+				}
+			} else if (!i->mem_data_seq_ || *i->mem_data_seq_ != i->read_data_seq_) {
+				memcpy(i->data_ptr, i->mem_data_ptr_, i->data_size);
+				i->read_data_seq_ = i->mem_data_seq_ ? *i->mem_data_seq_ : INTERFACE_DATA_SEQ_INVALID;
+				if (i->mem_trace_)
+					i->latency_trace_ = *i->mem_trace_;
+				copied = true;
+			}
+			if (copied)
+				++num_copied;
+			*i->local_read_timestamp_ = *i->timestamp_;
+			i->timestamp_->set_time(i->data_ts->timestamp_sec, i->data_ts->timestamp_usec);
+			LatencyTrace::adopt(i->latency_trace_);
+		} else if (!invalid) {
+			invalid = i;
+		}
+		i->data_mutex_->unlock();
+
+		interface_stats_t *stats = stats_enabled ? i->active_stats() : NULL;
+		if (stats && valid) {
+			size_t l = std::lower_bound(rwlocks_.begin(), rwlocks_.end(), i->rwlock_) - rwlocks_.begin();
+			__atomic_fetch_add(&stats->num_reads, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&stats->num_read_locked, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&stats->read_lock_wait_nsec, lock_wait_nsec_[l], __ATOMIC_RELAXED);
+			if (copied)
+				__atomic_fetch_add(&stats->num_read_copies, 1, __ATOMIC_RELAXED);
+		}
+	}
+
+	for (auto l = rwlocks_.rbegin(); l != rwlocks_.rend(); ++l) {
+		(*l)->unlock();
+	}
+
+	if (invalid) {
+		throw InterfaceInvalidException(invalid, "InterfaceGroup::read()");
+	}
+
+	return num_copied;
+}
+
+} // end namespace fawkes
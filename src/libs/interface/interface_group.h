@@ -0,0 +1,67 @@
+
+/***************************************************************************
+ *  interface_group.h - Group of interfaces read in one batch
+ *
+ *  Created: Wed Oct 14 18:16:22 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _INTERFACE_INTERFACE_GROUP_H_
+#define _INTERFACE_INTERFACE_GROUP_H_
+
+#include <stdint.h>
+
+#include <list>
+#include <vector>
+
+namespace fawkes {
+
+class Interface;
+class RefCountRWLock;
+
+class InterfaceGroup
+{
+public:
+	InterfaceGroup();
+	InterfaceGroup(const std::vector<Interface *> &interfaces);
+	InterfaceGroup(const std::list<Interface *> &interfaces);
+	~InterfaceGroup();
+
+	void add(Interface *interface);
+	void remove(Interface *interface);
+	void clear();
+
+	bool                            empty() const;
+	size_t                          size() const;
+	const std::vector<Interface *> &interfaces() const;
+
+	unsigned int read();
+
+private:
+	void update_locks();
+
+private:
+	std::vector<Interface *>      interfaces_;
+	std::vector<RefCountRWLock *> rwlocks_;
+	std::vector<uint64_t>         lock_wait_nsec_;
+	bool                          rwlocks_dirty_;
+};
+
+} // end namespace fawkes
+
+#endif
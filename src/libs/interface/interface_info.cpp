@@ -48,6 +48,7 @@ namespace fawkes {
  * @param readers name of readers of interface
  * @param writer name of writer of interface
  * @param timestamp interface timestamp (time of last write or data timestamp)
+ * @param stats usage statistics of the interface, NULL if not available
  */
 InterfaceInfo::InterfaceInfo(const char *                  type,
                              const char *                  id,
@@ -57,7 +58,8 @@ InterfaceInfo::InterfaceInfo(const char *                  type,
                              unsigned int                  num_readers,
                              const std::list<std::string> &readers,
                              const std::string &           writer,
-                             const Time *                  timestamp)
+                             const Time *                  timestamp,
+                             const interface_stats_t *     stats)
 {
 	type_ = strndup(type, INTERFACE_TYPE_SIZE_);
 	id_   = strndup(id, INTERFACE_ID_SIZE_);
@@ -69,6 +71,7 @@ InterfaceInfo::InterfaceInfo(const char *                  type,
 	timestamp_   = new Time(timestamp);
 	readers_     = readers;
 	writer_      = writer;
+	interface_stats_copy(stats, stats_);
 }
 
 /** Copy constructor.
@@ -86,6 +89,7 @@ InterfaceInfo::InterfaceInfo(const InterfaceInfo &i)
 	timestamp_   = new Time(i.timestamp_);
 	readers_     = i.readers_;
 	writer_      = i.writer_;
+	stats_       = i.stats_;
 }
 
 /** Destructor. */
@@ -119,6 +123,7 @@ InterfaceInfo::operator=(const InterfaceInfo &i)
 	timestamp_   = new Time(i.timestamp_);
 	readers_     = i.readers_;
 	writer_      = i.writer_;
+	stats_       = i.stats_;
 
 	return *this;
 }
@@ -218,6 +223,18 @@ InterfaceInfo::timestamp() const
 	return timestamp_;
 }
 
+/** Get interface usage statistics.
+ * The statistics are a snapshot taken when the info was created. They
+ * are all zero if statistics are disabled or not available, e.g. for
+ * interfaces listed from a remote blackboard.
+ * @return usage statistics
+ */
+const interface_stats_t &
+InterfaceInfo::stats() const
+{
+	return stats_;
+}
+
 /** < operator
  * This compares two interface infos with respect to the less than (<) relation
  * considering the type and id of an interface.
@@ -255,6 +272,7 @@ InterfaceInfo::operator<(const InterfaceInfo &ii) const
  * @param readers name of readers of interface
  * @param writer name of writer of interface
  * @param timestamp interface timestamp (time of last write or data timestamp)
+ * @param stats usage statistics of the interface, NULL if not available
  */
 void
 InterfaceInfoList::append(const char *                  type,
@@ -265,10 +283,11 @@ InterfaceInfoList::append(const char *                  type,
                           unsigned int                  num_readers,
                           const std::list<std::string> &readers,
                           const std::string &           writer,
-                          const Time &                  timestamp)
+                          const Time &                  timestamp,
+                          const interface_stats_t *     stats)
 {
-	push_back(
-	  InterfaceInfo(type, id, hash, serial, has_writer, num_readers, readers, writer, &timestamp));
+	push_back(InterfaceInfo(
+	  type, id, hash, serial, has_writer, num_readers, readers, writer, &timestamp, stats));
 }
 
 } // end namespace fawkes
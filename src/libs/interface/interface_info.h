@@ -24,6 +24,8 @@
 #ifndef _INTERFACE_INTERFACE_INFO_H_
 #define _INTERFACE_INTERFACE_INFO_H_
 
+#include <interface/stats.h>
+
 #include <list>
 #include <string>
 
@@ -42,7 +44,8 @@ public:
 	              unsigned int                  num_readers,
 	              const std::list<std::string> &readers,
 	              const std::string &           writer,
-	              const Time *                  timestamp);
+	              const Time *                  timestamp,
+	              const interface_stats_t *     stats = NULL);
 	InterfaceInfo(const InterfaceInfo &i);
 	~InterfaceInfo();
 
@@ -56,6 +59,7 @@ public:
 	const std::string &           writer() const;
 	unsigned int                  serial() const;
 	const Time *                  timestamp() const;
+	const interface_stats_t &     stats() const;
 
 	InterfaceInfo &operator=(const InterfaceInfo &i);
 	bool           operator<(const InterfaceInfo &ii) const;
@@ -70,6 +74,7 @@ private:
 	Time *                 timestamp_;
 	std::list<std::string> readers_;
 	std::string            writer_;
+	interface_stats_t      stats_;
 };
 
 class InterfaceInfoList : public std::list<InterfaceInfo>
@@ -83,7 +88,8 @@ public:
 	            unsigned int                  num_readers,
 	            const std::list<std::string> &readers,
 	            const std::string &           writer,
-	            const Time &                  timestamp);
+	            const Time &                  timestamp,
+	            const interface_stats_t *     stats = NULL);
 };
 
 } // end namespace fawkes
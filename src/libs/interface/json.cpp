@@ -0,0 +1,285 @@
+
+/***************************************************************************
+ *  json.cpp - Serialize interface and message data to JSON
+ *
+ *  Created: Thu Oct 15 06:55:44 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <interface/field_iterator.h>
+#include <interface/json.h>
+
+#include <cmath>
+#include <cstdio>
+
+namespace fawkes {
+
+/** Append string value to JSON string.
+ * Characters are escaped as required by JSON.
+ * @param json string to append to
+ * @param s string to append, ends at the first NUL character or after
+ * @p max_length characters, whichever comes first
+ * @param max_length maximum number of characters to read from @p s
+ */
+void
+json_append_string(std::string &json, const char *s, size_t max_length)
+{
+	json += '"';
+	for (size_t i = 0; i < max_length && s[i] != 0; ++i) {
+		unsigned char c = s[i];
+		switch (c) {
+		case '"': json += "\\\""; break;
+		case '\\': json += "\\\\"; break;
+		case '\n': json += "\\n"; break;
+		case '\r': json += "\\r"; break;
+		case '\t': json += "\\t"; break;
+		default:
+			if (c < 0x20) {
+				char tmp[7];
+				snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+				json += tmp;
+			} else {
+				json += c;
+			}
+		}
+	}
+	json += '"';
+}
+
+/** Append bool value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, bool v)
+{
+	json += v ? "true" : "false";
+}
+
+/** Append int8 value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, int8_t v)
+{
+	json += std::to_string((int)v);
+}
+
+/** Append uint8 value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, uint8_t v)
+{
+	json += std::to_string((unsigned int)v);
+}
+
+/** Append int16 value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, int16_t v)
+{
+	json += std::to_string((int)v);
+}
+
+/** Append uint16 value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, uint16_t v)
+{
+	json += std::to_string((unsigned int)v);
+}
+
+/** Append int32 value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, int32_t v)
+{
+	json += std::to_string(v);
+}
+
+/** Append uint32 value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, uint32_t v)
+{
+	json += std::to_string(v);
+}
+
+/** Append int64 value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, int64_t v)
+{
+	json += std::to_string(v);
+}
+
+/** Append uint64 value to JSON string.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, uint64_t v)
+{
+	json += std::to_string(v);
+}
+
+/** Append float value to JSON string.
+ * JSON has no representation for NaN and infinity, such values are
+ * written as null.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, float v)
+{
+	if (!std::isfinite(v)) {
+		json += "null";
+	} else {
+		char tmp[32];
+		snprintf(tmp, sizeof(tmp), "%.9g", v);
+		json += tmp;
+	}
+}
+
+/** Append double value to JSON string.
+ * JSON has no representation for NaN and infinity, such values are
+ * written as null.
+ * @param json string to append to
+ * @param v value to append
+ */
+void
+json_append_value(std::string &json, double v)
+{
+	if (!std::isfinite(v)) {
+		json += "null";
+	} else {
+		char tmp[32];
+		snprintf(tmp, sizeof(tmp), "%.17g", v);
+		json += tmp;
+	}
+}
+
+/** Append enum value to JSON string.
+ * The value is written as its name. Values which are not in the map
+ * are written as integer.
+ * @param json string to append to
+ * @param enum_map map of enum values to names
+ * @param v value to append
+ */
+void
+json_append_enum(std::string &json, const interface_enum_map_t &enum_map, int32_t v)
+{
+	interface_enum_map_t::const_iterator e = enum_map.find(v);
+	if (e != enum_map.end()) {
+		json += '"';
+		json += e->second;
+		json += '"';
+	} else {
+		json_append_value(json, v);
+	}
+}
+
+/// @cond INTERNALS
+template <typename T>
+static void
+json_append_field(std::string &json, const InterfaceFieldIterator &i)
+{
+	const T *values = static_cast<const T *>(i.get_value());
+	size_t   length = i.get_length();
+	if (length > 1) {
+		json_append_array(json, values, length);
+	} else {
+		json_append_value(json, values[0]);
+	}
+}
+/// @endcond
+
+/** Append fields as JSON object.
+ * This walks the fields with the given iterator. It is used as the
+ * fallback for interfaces and messages which do not provide a
+ * generated to_json() method.
+ * @param json string to append to
+ * @param begin iterator pointing to the first field
+ * @param end end iterator
+ */
+void
+json_append_fields(std::string &json, InterfaceFieldIterator begin, InterfaceFieldIterator end)
+{
+	json += '{';
+	bool first = true;
+	for (InterfaceFieldIterator i = begin; i != end; ++i) {
+		json_append_key(json, i.get_name(), first);
+		first = false;
+
+		size_t         length = i.get_length();
+		const int32_t *enums  = static_cast<const int32_t *>(i.get_value());
+		switch (i.get_type()) {
+		case IFT_BOOL: json_append_field<bool>(json, i); break;
+		case IFT_INT8: json_append_field<int8_t>(json, i); break;
+		case IFT_UINT8: json_append_field<uint8_t>(json, i); break;
+		case IFT_INT16: json_append_field<int16_t>(json, i); break;
+		case IFT_UINT16: json_append_field<uint16_t>(json, i); break;
+		case IFT_INT32: json_append_field<int32_t>(json, i); break;
+		case IFT_UINT32: json_append_field<uint32_t>(json, i); break;
+		case IFT_INT64: json_append_field<int64_t>(json, i); break;
+		case IFT_UINT64: json_append_field<uint64_t>(json, i); break;
+		case IFT_FLOAT: json_append_field<float>(json, i); break;
+		case IFT_DOUBLE: json_append_field<double>(json, i); break;
+		case IFT_BYTE: json_append_field<uint8_t>(json, i); break;
+		case IFT_STRING: json_append_string(json, i.get_string(), length); break;
+		case IFT_ENUM:
+			if (length > 1) {
+				json += '[';
+				for (size_t j = 0; j < length; ++j) {
+					if (j > 0)
+						json += ',';
+					try {
+						json_append_string(json, i.get_enum_string(j), std::string::npos);
+					} catch (Exception &e) {
+						json_append_value(json, enums[j]);
+					}
+				}
+				json += ']';
+			} else {
+				try {
+					json_append_string(json, i.get_enum_string(), std::string::npos);
+				} catch (Exception &e) {
+					json_append_value(json, enums[0]);
+				}
+			}
+			break;
+		}
+	}
+	json += '}';
+}
+
+} // end namespace fawkes
@@ -0,0 +1,111 @@
+
+/***************************************************************************
+ *  json.h - Serialize interface and message data to JSON
+ *
+ *  Created: Thu Oct 15 06:55:44 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _INTERFACE_JSON_H_
+#define _INTERFACE_JSON_H_
+
+#include <interface/types.h>
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+
+namespace fawkes {
+
+class InterfaceFieldIterator;
+
+void json_append_string(std::string &json, const char *s, size_t max_length);
+void json_append_value(std::string &json, bool v);
+void json_append_value(std::string &json, int8_t v);
+void json_append_value(std::string &json, uint8_t v);
+void json_append_value(std::string &json, int16_t v);
+void json_append_value(std::string &json, uint16_t v);
+void json_append_value(std::string &json, int32_t v);
+void json_append_value(std::string &json, uint32_t v);
+void json_append_value(std::string &json, int64_t v);
+void json_append_value(std::string &json, uint64_t v);
+void json_append_value(std::string &json, float v);
+void json_append_value(std::string &json, double v);
+void json_append_enum(std::string &json, const interface_enum_map_t &enum_map, int32_t v);
+
+void json_append_fields(std::string &          json,
+                        InterfaceFieldIterator begin,
+                        InterfaceFieldIterator end);
+
+/** Append object key to JSON string.
+ * @param json string to append to
+ * @param key key name, must not require escaping
+ * @param first true if this is the first key of the object
+ */
+inline void
+json_append_key(std::string &json, const char *key, bool first = false)
+{
+	if (!first)
+		json += ',';
+	json += '"';
+	json += key;
+	json += "\":";
+}
+
+/** Append array of values to JSON string.
+ * @param json string to append to
+ * @param values array of values
+ * @param length number of elements in @p values
+ */
+template <typename T>
+inline void
+json_append_array(std::string &json, const T *values, size_t length)
+{
+	json += '[';
+	for (size_t i = 0; i < length; ++i) {
+		if (i > 0)
+			json += ',';
+		json_append_value(json, values[i]);
+	}
+	json += ']';
+}
+
+/** Append array of enum values to JSON string.
+ * @param json string to append to
+ * @param enum_map map of enum values to names
+ * @param values array of enum values
+ * @param length number of elements in @p values
+ */
+inline void
+json_append_enum_array(std::string &               json,
+                       const interface_enum_map_t &enum_map,
+                       const int32_t *             values,
+                       size_t                      length)
+{
+	json += '[';
+	for (size_t i = 0; i < length; ++i) {
+		if (i > 0)
+			json += ',';
+		json_append_enum(json, enum_map, values[i]);
+	}
+	json += ']';
+}
+
+} // end namespace fawkes
+
+#endif
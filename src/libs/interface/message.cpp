@@ -25,7 +25,9 @@
 #include <core/threading/mutex.h>
 #include <core/threading/thread.h>
 #include <interface/interface.h>
+#include <interface/json.h>
 #include <interface/message.h>
+#include <interface/message_pool.h>
 #include <utils/time/time.h>
 
 #include <cstdlib>
@@ -75,6 +77,11 @@ Message::Message(const char *type)
 	_transmit_via_iface              = NULL;
 	sender_interface_instance_serial = 0;
 	recipient_interface_mem_serial   = 0;
+	queue_next_                      = NULL;
+	recycler_                        = NULL;
+	queue_priority_                  = 0;
+	queue_replace_                   = false;
+	latency_trace_                   = {0, 0, 0, 0};
 
 	std::string sender_name = Thread::current_thread_name();
 	if (sender_name != "") {
@@ -106,6 +113,11 @@ Message::Message(const Message &mesg)
 	_transmit_via_iface              = NULL;
 	sender_interface_instance_serial = 0;
 	recipient_interface_mem_serial   = 0;
+	queue_next_                      = NULL;
+	recycler_                        = NULL;
+	queue_priority_                  = mesg.queue_priority_;
+	queue_replace_                   = mesg.queue_replace_;
+	latency_trace_                   = mesg.latency_trace_;
 
 	memcpy(data_ptr, mesg.data_ptr, data_size);
 
@@ -141,6 +153,11 @@ Message::Message(const Message *mesg)
 	_transmit_via_iface              = NULL;
 	sender_interface_instance_serial = 0;
 	recipient_interface_mem_serial   = 0;
+	queue_next_                      = NULL;
+	recycler_                        = NULL;
+	queue_priority_                  = mesg->queue_priority_;
+	queue_replace_                   = mesg->queue_replace_;
+	latency_trace_                   = mesg->latency_trace_;
 	time_enqueued_                   = new Time(mesg->time_enqueued_);
 	fieldinfo_list_                  = NULL;
 
@@ -162,6 +179,8 @@ Message::Message(const Message *mesg)
 /** Destructor. */
 Message::~Message()
 {
+	if (recycler_)
+		recycler_->unref();
 	free(_sender_thread_name);
 	free(_type);
 	delete time_enqueued_;
@@ -192,6 +211,52 @@ Message::hops() const
 	return hops_;
 }
 
+/** Get queue priority.
+ * Messages with a higher priority are moved ahead of queued messages with
+ * a lower priority, see MessageQueue.
+ * @return queue priority, 0 for regular messages
+ */
+unsigned int
+Message::queue_priority() const
+{
+	return queue_priority_;
+}
+
+/** Check if message replaces queued messages of the same type.
+ * @return true if a queued message of the same type is replaced by this
+ * message, false if it is queued in addition
+ */
+bool
+Message::queue_replace() const
+{
+	return queue_replace_;
+}
+
+/** Get latency trace of the message.
+ * This is the current trace of the thread which enqueued the message,
+ * it is only transmitted through local BlackBoards.
+ * @return latency trace, its ID is zero if the message is not traced
+ * @see LatencyTrace
+ */
+const latency_trace_t &
+Message::latency_trace() const
+{
+	return latency_trace_;
+}
+
+/** Set queue policy.
+ * Called by the constructors of generated messages according to the
+ * interface definition.
+ * @param priority queue priority, 0 for regular messages
+ * @param replace true to replace a queued message of the same type
+ */
+void
+Message::set_queue_policy(unsigned int priority, bool replace)
+{
+	queue_priority_ = priority;
+	queue_replace_  = replace;
+}
+
 /** Set message ID.
  * @param message_id message ID
  */
@@ -365,6 +430,38 @@ Message::set_interface(Interface *iface, bool proxy)
 	recipient_interface_mem_serial = iface->mem_serial();
 }
 
+/** Reset message for re-use.
+ * Clears the message data and all meta information set when enqueuing
+ * the message, such that the message looks like a freshly constructed one.
+ */
+void
+Message::reset()
+{
+	memset(data_ptr, 0, data_size);
+	message_id_                      = 0;
+	hops_                            = 0;
+	enqueued_                        = false;
+	queue_next_                      = NULL;
+	_transmit_via_iface              = NULL;
+	sender_interface_instance_serial = 0;
+	recipient_interface_mem_serial   = 0;
+	_sender_id                       = Uuid();
+	_source_id                       = Uuid();
+	latency_trace_                   = {0, 0, 0, 0};
+	time_enqueued_->set_time(0, 0);
+}
+
+/** Recycle message.
+ * Messages acquired from a MessagePool are handed back to the pool
+ * when their last reference is released instead of being deleted.
+ * @return true if the message has been taken by its pool, false otherwise
+ */
+bool
+Message::recycle()
+{
+	return (recycler_ != NULL) && recycler_->put(this);
+}
+
 /** Get transmitting interface.
  * @return transmitting interface, or NULL if message has not been enqueued, yet.
  */
@@ -410,6 +507,20 @@ Message::num_fields() const
 	return num_fields_;
 }
 
+/** Serialize message fields as JSON object.
+ * Appends a JSON object with one member per field to the given
+ * string. Enum values are written as their names. Generated messages
+ * override this with a specialized version which does not need to
+ * walk the field info list.
+ * @param json string to append the JSON object to
+ */
+void
+Message::to_json(std::string &json) const
+{
+	Message *msg = const_cast<Message *>(this);
+	json_append_fields(json, msg->fields(), msg->fields_end());
+}
+
 /** Clone this message.
  * Shall be implemented by every sub-class to return a message of proper type.
  * @return new message cloned from this instance
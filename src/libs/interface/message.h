@@ -29,6 +29,7 @@
 #include <interface/change_field.h>
 #include <interface/field_iterator.h>
 #include <interface/types.h>
+#include <utils/time/latency_trace.h>
 #include <utils/uuid.h>
 
 #define INTERFACE_MESSAGE_TYPE_SIZE_ 64
@@ -39,10 +40,14 @@ class Mutex;
 class Interface;
 class InterfaceFieldIterator;
 class Time;
+class MessageQueue;
+class MessageRecycler;
 
 class Message : public RefCount
 {
 	friend Interface;
+	friend MessageQueue;
+	friend MessageRecycler;
 
 public:
 	Message(const char *type);
@@ -77,11 +82,17 @@ public:
 	unsigned int hops() const;
 	void         set_hops(unsigned int hops);
 
+	unsigned int queue_priority() const;
+	bool         queue_replace() const;
+
+	const latency_trace_t &latency_trace() const;
+
 	void set_from_chunk(const void *chunk);
 
 	unsigned int recipient() const;
 
 	virtual Message *clone() const;
+	virtual void     to_json(std::string &json) const;
 
 	/** Check if message has desired type.
    * @return true, if message has desired type, false otherwise
@@ -117,10 +128,21 @@ private: // fields
 
 	unsigned int num_fields_;
 
+	Message *        queue_next_;
+	MessageRecycler *recycler_;
+	unsigned int     queue_priority_;
+	bool             queue_replace_;
+	latency_trace_t  latency_trace_;
+
 private: // methods
 	void set_interface(Interface *iface, bool proxy = false);
+	void reset();
 
 protected:
+	virtual bool recycle();
+
+	void set_queue_policy(unsigned int priority, bool replace);
+
 	void add_fieldinfo(interface_fieldtype_t       type,
 	                   const char *                name,
 	                   size_t                      length,
@@ -0,0 +1,267 @@
+
+/***************************************************************************
+ *  message_pool.cpp - Recycling pool for interface messages
+ *
+ *  Created: Wed Oct 14 18:21:46 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <interface/message.h>
+#include <interface/message_pool.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace fawkes {
+
+/** @class MessageRecycler <interface/message_pool.h>
+ * Shared state of a message pool.
+ * Every message acquired from a pool references the recycler, hence it
+ * stays valid as long as any pooled message exists, even if the
+ * MessagePool itself has already been destructed. This is internal to
+ * MessagePool and not meant to be used directly.
+ */
+
+/** Constructor.
+ * @param capacity maximum number of messages kept for re-use
+ */
+MessageRecycler::MessageRecycler(unsigned int capacity)
+{
+	mutex_     = new Mutex();
+	free_list_ = NULL;
+	size_      = 0;
+	capacity_  = capacity;
+	closed_    = false;
+	hits_      = 0;
+	misses_    = 0;
+	recycled_  = 0;
+	discarded_ = 0;
+}
+
+/** Destructor. */
+MessageRecycler::~MessageRecycler()
+{
+	delete mutex_;
+}
+
+/** Get message for re-use.
+ * @return recycled message or NULL if there is none available
+ */
+Message *
+MessageRecycler::get()
+{
+	mutex_->lock();
+	Message *m = free_list_;
+	if (m) {
+		free_list_     = m->queue_next_;
+		m->queue_next_ = NULL;
+		--size_;
+		++hits_;
+	} else {
+		++misses_;
+	}
+	mutex_->unlock();
+
+	if (m) {
+		std::string sender_name = Thread::current_thread_name();
+		if (sender_name == "")
+			sender_name = "Unknown";
+		if (strcmp(m->_sender_thread_name, sender_name.c_str()) != 0) {
+			free(m->_sender_thread_name);
+			m->_sender_thread_name = strdup(sender_name.c_str());
+		}
+	}
+	return m;
+}
+
+/** Take message for re-use.
+ * Called by Message::recycle() when the last reference has been released.
+ * @param m message to store
+ * @return true if the message has been stored, false if the pool is full
+ * or has been closed, in which case the message must be deleted
+ */
+bool
+MessageRecycler::put(Message *m)
+{
+	MutexLocker lock(mutex_);
+	if (closed_ || size_ >= capacity_) {
+		++discarded_;
+		return false;
+	}
+	m->reset();
+	m->queue_next_ = free_list_;
+	free_list_     = m;
+	++size_;
+	++recycled_;
+	return true;
+}
+
+/** Adopt newly created message.
+ * The message will be recycled by this pool once released.
+ * @param m message to adopt
+ */
+void
+MessageRecycler::adopt(Message *m)
+{
+	ref();
+	m->recycler_ = this;
+}
+
+/** Close recycler.
+ * Deletes all messages stored for re-use. Messages released afterwards
+ * are deleted immediately.
+ */
+void
+MessageRecycler::close()
+{
+	mutex_->lock();
+	closed_    = true;
+	Message *m = free_list_;
+	free_list_ = NULL;
+	size_      = 0;
+	mutex_->unlock();
+
+	// messages unref the recycler on deletion, do not hold the mutex
+	while (m) {
+		Message *next  = m->queue_next_;
+		m->queue_next_ = NULL;
+		delete m;
+		m = next;
+	}
+}
+
+/** @class MessagePoolBase <interface/message_pool.h>
+ * Type-independent part of a MessagePool.
+ * Provides the accounting information to size the pool.
+ */
+
+/** Constructor.
+ * @param capacity maximum number of messages kept for re-use
+ */
+MessagePoolBase::MessagePoolBase(unsigned int capacity)
+{
+	recycler_ = new MessageRecycler(capacity);
+}
+
+/** Destructor.
+ * Deletes all idle messages. Messages still in use are deleted once
+ * they are released.
+ */
+MessagePoolBase::~MessagePoolBase()
+{
+	recycler_->close();
+	recycler_->unref();
+}
+
+/** Get message from pool.
+ * @return recycled message or NULL if none is available
+ */
+Message *
+MessagePoolBase::get()
+{
+	return recycler_->get();
+}
+
+/** Adopt newly created message.
+ * @param m message to be recycled through this pool once released
+ */
+void
+MessagePoolBase::adopt(Message *m)
+{
+	recycler_->adopt(m);
+}
+
+/** Get capacity.
+ * @return maximum number of messages kept for re-use
+ */
+unsigned int
+MessagePoolBase::capacity() const
+{
+	MutexLocker lock(recycler_->mutex_);
+	return recycler_->capacity_;
+}
+
+/** Set capacity.
+ * If the new capacity is lower than the number of idle messages, the
+ * pool shrinks as messages are acquired.
+ * @param capacity maximum number of messages kept for re-use
+ */
+void
+MessagePoolBase::set_capacity(unsigned int capacity)
+{
+	MutexLocker lock(recycler_->mutex_);
+	recycler_->capacity_ = capacity;
+}
+
+/** Get number of idle messages.
+ * @return number of messages currently available for re-use
+ */
+unsigned int
+MessagePoolBase::size() const
+{
+	MutexLocker lock(recycler_->mutex_);
+	return recycler_->size_;
+}
+
+/** Get number of hits.
+ * @return number of acquisitions served by a recycled message
+ */
+unsigned int
+MessagePoolBase::hits() const
+{
+	MutexLocker lock(recycler_->mutex_);
+	return recycler_->hits_;
+}
+
+/** Get number of misses.
+ * @return number of acquisitions which required a new message
+ */
+unsigned int
+MessagePoolBase::misses() const
+{
+	MutexLocker lock(recycler_->mutex_);
+	return recycler_->misses_;
+}
+
+/** Get number of recycled messages.
+ * @return number of released messages that have been stored for re-use
+ */
+unsigned int
+MessagePoolBase::recycled() const
+{
+	MutexLocker lock(recycler_->mutex_);
+	return recycler_->recycled_;
+}
+
+/** Get number of discarded messages.
+ * A high number compared to recycled() indicates that the capacity is
+ * too small.
+ * @return number of released messages that have been deleted because
+ * the pool was full
+ */
+unsigned int
+MessagePoolBase::discarded() const
+{
+	MutexLocker lock(recycler_->mutex_);
+	return recycler_->discarded_;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,138 @@
+
+/***************************************************************************
+ *  message_pool.h - Recycling pool for interface messages
+ *
+ *  Created: Wed Oct 14 18:21:46 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _INTERFACE_MESSAGE_POOL_H_
+#define _INTERFACE_MESSAGE_POOL_H_
+
+#include <core/utils/refcount.h>
+
+namespace fawkes {
+
+class Message;
+class Mutex;
+class MessagePoolBase;
+
+class MessageRecycler : public RefCount
+{
+	friend Message;
+	friend MessagePoolBase;
+
+private:
+	MessageRecycler(unsigned int capacity);
+	virtual ~MessageRecycler();
+
+	Message *get();
+	bool     put(Message *m);
+	void     adopt(Message *m);
+	void     close();
+
+private:
+	Mutex *      mutex_;
+	Message *    free_list_;
+	unsigned int size_;
+	unsigned int capacity_;
+	bool         closed_;
+
+	unsigned int hits_;
+	unsigned int misses_;
+	unsigned int recycled_;
+	unsigned int discarded_;
+};
+
+class MessagePoolBase
+{
+public:
+	virtual ~MessagePoolBase();
+
+	unsigned int capacity() const;
+	void         set_capacity(unsigned int capacity);
+	unsigned int size() const;
+
+	unsigned int hits() const;
+	unsigned int misses() const;
+	unsigned int recycled() const;
+	unsigned int discarded() const;
+
+protected:
+	MessagePoolBase(unsigned int capacity);
+
+	Message *get();
+	void     adopt(Message *m);
+
+private:
+	MessagePoolBase(const MessagePoolBase &) = delete;
+	MessagePoolBase &operator=(const MessagePoolBase &) = delete;
+
+private:
+	MessageRecycler *recycler_;
+};
+
+/** @class MessagePool <interface/message_pool.h>
+ * Recycling pool for messages of one type.
+ * Instead of creating a new message for every command, acquire it from
+ * the pool. Once the last reference to the message has been released,
+ * typically after the writer processed and popped it, the message is
+ * returned to the pool instead of being deleted. Message data is
+ * zeroed, just like after default construction.
+ * @code
+ * MessagePool<MotorInterface::TransRotMessage> pool;
+ * MotorInterface::TransRotMessage *msg = pool.acquire();
+ * msg->set_vx(vx);
+ * motor_if->msgq_enqueue(msg);
+ * @endcode
+ * The pool may be destructed while messages are still in use, they are
+ * deleted normally once they have been released.
+ */
+template <class MessageType>
+class MessagePool : public MessagePoolBase
+{
+public:
+	/** Constructor.
+	 * @param capacity maximum number of messages kept for re-use
+	 */
+	MessagePool(unsigned int capacity = 16) : MessagePoolBase(capacity)
+	{
+	}
+
+	/** Acquire message.
+	 * @return recycled message if available, a new one otherwise. The
+	 * returned message has a reference count of one which is owned by the
+	 * caller, e.g. to pass it to Interface::msgq_enqueue().
+	 */
+	MessageType *
+	acquire()
+	{
+		Message *m = get();
+		if (m) {
+			return static_cast<MessageType *>(m);
+		} else {
+			MessageType *mt = new MessageType();
+			adopt(mt);
+			return mt;
+		}
+	}
+};
+
+} // end namespace fawkes
+
+#endif
@@ -27,7 +27,7 @@
 #include <interface/message_queue.h>
 
 #include <cstddef>
-#include <cstdlib>
+#include <cstring>
 
 namespace fawkes {
 
@@ -49,6 +49,24 @@ MessageAlreadyQueuedException::MessageAlreadyQueuedException()
  * This message queue handles the basic messaging operations. The methods the
  * Interface provides for handling message queues are forwarded to a
  * MessageQueue instance.
+ *
+ * The queue is intrusive, i.e. messages are linked through a pointer
+ * stored in the message itself, hence no memory is allocated to enqueue
+ * a message. Any number of producers may append() concurrently without
+ * ever acquiring a lock. They atomically push messages onto an inbox
+ * stack. The consumer, the writing interface instance, moves all
+ * messages from the inbox to the actual queue in FIFO order whenever it
+ * accesses the queue. All operations other than append() are meant to
+ * be called by the consumer and are protected by a mutex which producers
+ * never touch.
+ *
+ * Messages may define a queue policy in the interface definition, see
+ * Message::queue_priority() and Message::queue_replace(). A message with
+ * a priority is moved ahead of all queued messages with a lower priority.
+ * A message with replace semantics takes the place of a queued message of
+ * the same type, which is dropped, so that only the latest one is kept.
+ * The first message of the queue is never moved or replaced, since the
+ * consumer may be processing it.
  * @see Interface
  */
 
@@ -57,6 +75,7 @@ MessageQueue::MessageQueue()
 {
 	list_   = NULL;
 	end_el_ = NULL;
+	inbox_  = NULL;
 	mutex_  = new Mutex();
 }
 
@@ -67,6 +86,98 @@ MessageQueue::~MessageQueue()
 	delete mutex_;
 }
 
+/** Move messages from inbox to queue.
+ * The inbox is a stack, the messages are therefore reversed to be
+ * appended in the order they have been enqueued. The mutex must be held
+ * when calling this method.
+ */
+void
+MessageQueue::collect() const
+{
+	if (__atomic_load_n(&inbox_, __ATOMIC_RELAXED) == NULL)
+		return;
+
+	Message *m = __atomic_exchange_n(&inbox_, (Message *)NULL, __ATOMIC_ACQUIRE);
+	if (m == NULL)
+		return;
+
+	Message *first  = NULL;
+	Message *last   = m;
+	bool     policy = false;
+	while (m) {
+		Message *next  = m->queue_next_;
+		m->queue_next_ = first;
+		first          = m;
+		m              = next;
+		if ((first->queue_priority_ > 0) || first->queue_replace_)
+			policy = true;
+	}
+
+	if (policy) {
+		while (first) {
+			m              = first;
+			first          = first->queue_next_;
+			m->queue_next_ = NULL;
+			insert_collected(m);
+		}
+		return;
+	}
+
+	if (list_ == NULL) {
+		list_ = first;
+	} else {
+		end_el_->queue_next_ = first;
+	}
+	end_el_ = last;
+}
+
+/** Insert collected message according to its queue policy.
+ * The mutex must be held when calling this method.
+ * @param m message to insert
+ */
+void
+MessageQueue::insert_collected(Message *m) const
+{
+	if (list_ == NULL) {
+		list_   = m;
+		end_el_ = m;
+		return;
+	}
+
+	if (m->queue_replace_) {
+		for (Message *p = list_; p->queue_next_; p = p->queue_next_) {
+			Message *r = p->queue_next_;
+			if (strcmp(r->_type, m->_type) == 0) {
+				m->queue_next_ = r->queue_next_;
+				p->queue_next_ = m;
+				if (end_el_ == r) {
+					end_el_ = m;
+				}
+				r->queue_next_ = NULL;
+				r->unref();
+				return;
+			}
+		}
+	}
+
+	if ((m->queue_priority_ == 0) || (end_el_->queue_priority_ >= m->queue_priority_)) {
+		end_el_->queue_next_ = m;
+		end_el_              = m;
+		return;
+	}
+
+	// queue after the first message is ordered by priority
+	Message *p = list_;
+	while (p->queue_next_ && (p->queue_next_->queue_priority_ >= m->queue_priority_)) {
+		p = p->queue_next_;
+	}
+	m->queue_next_ = p->queue_next_;
+	p->queue_next_ = m;
+	if (m->queue_next_ == NULL) {
+		end_el_ = m;
+	}
+}
+
 /** Delete all messages from queue.
  * This method deletes all messages from the queue.
  */
@@ -74,20 +185,22 @@ void
 MessageQueue::flush()
 {
 	mutex_->lock();
-	// free list elements
-	msg_list_t *l = list_;
-	msg_list_t *next;
-	while (l) {
-		next = l->next;
-		l->msg->unref();
-		free(l);
-		l = next;
+	collect();
+	Message *m = list_;
+	while (m) {
+		Message *next  = m->queue_next_;
+		m->queue_next_ = NULL;
+		m->unref();
+		m = next;
 	}
-	list_ = NULL;
+	list_   = NULL;
+	end_el_ = NULL;
 	mutex_->unlock();
 }
 
 /** Append message to queue.
+ * This method is lock-free and may be called concurrently from any
+ * number of threads.
  * @param msg Message to append
  * @exception MessageAlreadyQueuedException thrown if the message has already been
  * enqueued to an interface.
@@ -98,24 +211,13 @@ MessageQueue::append(Message *msg)
 	if (msg->enqueued() != 0) {
 		throw MessageAlreadyQueuedException();
 	}
-	mutex_->lock();
 	msg->mark_enqueued();
-	if (list_ == NULL) {
-		list_         = (msg_list_t *)malloc(sizeof(msg_list_t));
-		list_->next   = NULL;
-		list_->msg    = msg;
-		list_->msg_id = msg->id();
-		end_el_       = list_;
-	} else {
-		msg_list_t *l = (msg_list_t *)malloc(sizeof(msg_list_t));
-		l->next       = NULL;
-		l->msg        = msg;
-		l->msg_id     = msg->id();
-		end_el_->next = l;
-		end_el_       = l;
-	}
 
-	mutex_->unlock();
+	Message *head = __atomic_load_n(&inbox_, __ATOMIC_RELAXED);
+	do {
+		msg->queue_next_ = head;
+	} while (
+	  !__atomic_compare_exchange_n(&inbox_, &head, msg, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
 }
 
 /** Enqueue message after given iterator.
@@ -140,13 +242,10 @@ MessageQueue::insert_after(const MessageIterator &it, Message *msg)
 		throw MessageAlreadyQueuedException();
 	}
 	msg->mark_enqueued();
-	msg_list_t *l = (msg_list_t *)malloc(sizeof(msg_list_t));
-	l->next       = it.cur->next;
-	l->msg        = msg;
-	l->msg_id     = msg->id();
-	it.cur->next  = l;
-	if (l->next == NULL) {
-		end_el_ = l;
+	msg->queue_next_    = it.cur->queue_next_;
+	it.cur->queue_next_ = msg;
+	if (msg->queue_next_ == NULL) {
+		end_el_ = msg;
 	}
 }
 
@@ -157,15 +256,16 @@ void
 MessageQueue::remove(const Message *msg)
 {
 	mutex_->lock();
-	msg_list_t *l = list_;
-	msg_list_t *p = NULL;
-	while (l) {
-		if (l->msg == msg) {
-			remove(l, p);
+	collect();
+	Message *m = list_;
+	Message *p = NULL;
+	while (m) {
+		if (m == msg) {
+			remove(m, p);
 			break;
 		} else {
-			p = l;
-			l = l->next;
+			p = m;
+			m = m->queue_next_;
 		}
 	}
 	mutex_->unlock();
@@ -178,39 +278,43 @@ void
 MessageQueue::remove(const unsigned int msg_id)
 {
 	mutex_->lock();
-	msg_list_t *l = list_;
-	msg_list_t *p = NULL;
-	while (l) {
-		if (l->msg_id == msg_id) {
-			remove(l, p);
+	collect();
+	Message *m = list_;
+	Message *p = NULL;
+	while (m) {
+		if (m->id() == msg_id) {
+			remove(m, p);
 			break;
 		} else {
-			p = l;
-			l = l->next;
+			p = m;
+			m = m->queue_next_;
 		}
 	}
 	mutex_->unlock();
 }
 
 /** Remove message from list.
- * @param l list item to remove
- * @param p predecessor of element, may be NULL if there is none
+ * @param m message to remove
+ * @param p predecessor of message, may be NULL if there is none
  */
 void
-MessageQueue::remove(msg_list_t *l, msg_list_t *p)
+MessageQueue::remove(Message *m, Message *p)
 {
 	if (mutex_->try_lock()) {
 		mutex_->unlock();
 		throw NotLockedException("Protected remove must be made safe by locking.");
 	}
 	if (p) {
-		p->next = l->next;
+		p->queue_next_ = m->queue_next_;
 	} else {
 		// was first element
-		list_ = l->next;
+		list_ = m->queue_next_;
 	}
-	l->msg->unref();
-	free(l);
+	if (end_el_ == m) {
+		end_el_ = p;
+	}
+	m->queue_next_ = NULL;
+	m->unref();
 }
 
 /** Get number of messages in queue.
@@ -220,11 +324,12 @@ unsigned int
 MessageQueue::size() const
 {
 	mutex_->lock();
+	collect();
 	unsigned int rv = 0;
-	msg_list_t * l  = list_;
-	while (l) {
+	Message *    m  = list_;
+	while (m) {
 		++rv;
-		l = l->next;
+		m = m->queue_next_;
 	}
 
 	mutex_->unlock();
@@ -238,7 +343,7 @@ bool
 MessageQueue::empty() const
 {
 	mutex_->lock();
-	bool rv = (list_ == NULL);
+	bool rv = (list_ == NULL) && (__atomic_load_n(&inbox_, __ATOMIC_RELAXED) == NULL);
 	mutex_->unlock();
 	return rv;
 }
@@ -247,12 +352,14 @@ MessageQueue::empty() const
  * No operations can be performed on the message queue after locking it.
  * Note that you cannot call any method of the message queue as long as
  * the queue is locked. Use lock() only to have a secure run-through with
- * the MessageIterator.
+ * the MessageIterator. Messages appended while the queue is locked will
+ * only become visible after the queue has been unlocked.
  */
 void
 MessageQueue::lock()
 {
 	mutex_->lock();
+	collect();
 }
 
 /** Try to lock message queue.
@@ -265,7 +372,12 @@ MessageQueue::lock()
 bool
 MessageQueue::try_lock()
 {
-	return mutex_->try_lock();
+	if (mutex_->try_lock()) {
+		collect();
+		return true;
+	} else {
+		return false;
+	}
 }
 
 /** Unlock message queue.
@@ -282,8 +394,13 @@ MessageQueue::unlock()
 Message *
 MessageQueue::first()
 {
+	// if the queue is locked, lock() already collected pending messages
+	if (mutex_->try_lock()) {
+		collect();
+		mutex_->unlock();
+	}
 	if (list_) {
-		return list_->msg;
+		return list_;
 	} else {
 		return NULL;
 	}
@@ -295,12 +412,41 @@ void
 MessageQueue::pop()
 {
 	mutex_->lock();
+	collect();
 	if (list_) {
 		remove(list_, NULL);
 	}
 	mutex_->unlock();
 }
 
+/** Remove all messages from queue at once.
+ * All messages currently in the queue are appended to the given vector
+ * in queue order and removed from the queue. The reference the queue
+ * held on each message is handed over to the caller, who must unref()
+ * each message after processing it.
+ * @param messages vector to append messages to
+ * @return number of messages appended to @p messages
+ */
+unsigned int
+MessageQueue::drain(std::vector<Message *> &messages)
+{
+	unsigned int num = 0;
+	mutex_->lock();
+	collect();
+	Message *m = list_;
+	while (m) {
+		Message *next  = m->queue_next_;
+		m->queue_next_ = NULL;
+		messages.push_back(m);
+		++num;
+		m = next;
+	}
+	list_   = NULL;
+	end_el_ = NULL;
+	mutex_->unlock();
+	return num;
+}
+
 /** Get iterator to first element in message queue.
  * @return iterator to first element in message queue
  * @exception NotLockedException thrown if message queue is not locked during this operation.
@@ -339,7 +485,7 @@ MessageQueue::end()
 /** Constructor
  * @param cur Current element for message list
  */
-MessageQueue::MessageIterator::MessageIterator(msg_list_t *cur)
+MessageQueue::MessageIterator::MessageIterator(Message *cur)
 {
 	this->cur = cur;
 }
@@ -372,7 +518,7 @@ MessageQueue::MessageIterator &
 MessageQueue::MessageIterator::operator++()
 {
 	if (cur != NULL)
-		cur = cur->next;
+		cur = cur->queue_next_;
 
 	return *this;
 }
@@ -397,7 +543,7 @@ MessageQueue::MessageIterator::operator++(int inc)
 {
 	MessageIterator rv(cur);
 	if (cur != NULL)
-		cur = cur->next;
+		cur = cur->queue_next_;
 
 	return rv;
 }
@@ -414,7 +560,7 @@ MessageQueue::MessageIterator &
 MessageQueue::MessageIterator::operator+(unsigned int i)
 {
 	for (unsigned int j = 0; (cur != NULL) && (j < i); ++j) {
-		cur = cur->next;
+		cur = cur->queue_next_;
 	}
 	return *this;
 }
@@ -429,7 +575,7 @@ MessageQueue::MessageIterator &
 MessageQueue::MessageIterator::operator+=(unsigned int i)
 {
 	for (unsigned int j = 0; (cur != NULL) && (j < i); ++j) {
-		cur = cur->next;
+		cur = cur->queue_next_;
 	}
 	return *this;
 }
@@ -464,7 +610,7 @@ MessageQueue::MessageIterator::operator!=(const MessageIterator &c) const
 Message *
 MessageQueue::MessageIterator::operator*() const
 {
-	return (cur != NULL) ? cur->msg : NULL;
+	return cur;
 }
 
 /** Act on current message.
@@ -474,7 +620,7 @@ MessageQueue::MessageIterator::operator*() const
 Message *
 MessageQueue::MessageIterator::operator->() const
 {
-	return cur->msg;
+	return cur;
 }
 
 /** Assign iterator.
@@ -497,7 +643,7 @@ MessageQueue::MessageIterator::id() const
 {
 	if (cur == NULL)
 		return 0;
-	return cur->msg_id;
+	return cur->id();
 }
 
 } // end namespace fawkes
@@ -27,6 +27,8 @@
 #include <core/exception.h>
 #include <core/exceptions/software.h>
 
+#include <vector>
+
 namespace fawkes {
 
 class Message;
@@ -40,17 +42,6 @@ public:
 
 class MessageQueue
 {
-private:
-	// define our own list type since std::list is way too fat
-	/** Message list, internal only
-   */
-	struct msg_list_t
-	{
-		msg_list_t * next;   /**< pointer to next element in list */
-		unsigned int msg_id; /**< message id */
-		Message *    msg;    /**< pointer to message */
-	};
-
 public:
 	MessageQueue();
 	virtual ~MessageQueue();
@@ -60,7 +51,7 @@ public:
 		friend MessageQueue;
 
 	private:
-		MessageIterator(msg_list_t *cur);
+		MessageIterator(Message *cur);
 
 	public:
 		MessageIterator();
@@ -84,7 +75,7 @@ public:
 		MessageType *get() const;
 
 	private:
-		msg_list_t *cur;
+		Message *cur;
 	};
 
 	void append(Message *msg);
@@ -101,18 +92,22 @@ public:
 	bool try_lock();
 	void unlock();
 
-	Message *first();
-	void     pop();
+	Message *    first();
+	void         pop();
+	unsigned int drain(std::vector<Message *> &messages);
 
 	MessageIterator begin();
 	MessageIterator end();
 
 private:
-	void remove(msg_list_t *l, msg_list_t *p);
-
-	msg_list_t *list_;
-	msg_list_t *end_el_;
-	Mutex *     mutex_;
+	void remove(Message *m, Message *p);
+	void collect() const;
+	void insert_collected(Message *m) const;
+
+	mutable Message *list_;
+	mutable Message *end_el_;
+	mutable Message *inbox_;
+	Mutex *          mutex_;
 };
 
 /** Check if message is of given type.
@@ -124,7 +119,7 @@ template <class MessageType>
 bool
 MessageQueue::MessageIterator::is() const
 {
-	MessageType *msg = dynamic_cast<MessageType *>(cur->msg);
+	MessageType *msg = dynamic_cast<MessageType *>(cur);
 	return (msg != 0);
 }
 
@@ -138,7 +133,7 @@ template <class MessageType>
 MessageType *
 MessageQueue::MessageIterator::get() const
 {
-	MessageType *msg = dynamic_cast<MessageType *>(cur->msg);
+	MessageType *msg = dynamic_cast<MessageType *>(cur);
 	if (msg == 0) {
 		throw TypeMismatchException("Message types do not match (get)");
 	}
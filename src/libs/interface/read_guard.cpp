@@ -0,0 +1,170 @@
+
+/***************************************************************************
+ *  read_guard.cpp - Scoped zero-copy read access to interface data
+ *
+ *  Created: Wed Oct 14 18:09:02 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <core/threading/refc_rwlock.h>
+#include <interface/interface.h>
+#include <interface/read_guard.h>
+#include <utils/time/time.h>
+
+#include <cstdlib>
+
+namespace fawkes {
+
+/** @class InterfaceReadGuard <interface/read_guard.h>
+ * Scoped zero-copy read access to interface data.
+ * Interface::read() always copies the complete shared memory chunk
+ * into the private copy of the interface. For large interfaces, like
+ * laser or path interfaces, consumers may instead process the data in
+ * place. The guard acquires the read lock of the interface on
+ * construction and releases it on destruction (or when calling
+ * release()). While the guard is locked the writer is blocked, hence
+ * keep the scope as short as possible.
+ *
+ * If the read lock does not exclude the writer, e.g. for interfaces of
+ * a remote BlackBoard attached to its shared memory, the guard instead
+ * takes a consistent copy of the shared chunk on construction and all
+ * accessors refer to that copy.
+ *
+ * The private copy of the interface is not modified. Field getters of
+ * the interface therefore still return the values of the last read().
+ * Use shared() to map a field of the private copy to the shared chunk:
+ * @code
+ * {
+ *   InterfaceReadGuard guard(laser_if);
+ *   const float *d = guard.shared(laser_if->distances(), laser_if->maxlenof_distances());
+ *   // process d[0..maxlenof_distances()-1] in place
+ * }
+ * @endcode
+ */
+
+/** Constructor.
+ * Locks the interface for reading.
+ * @param interface interface to access the shared data of
+ * @exception InterfaceInvalidException thrown if the interface has
+ * been marked invalid
+ */
+InterfaceReadGuard::InterfaceReadGuard(Interface *interface)
+{
+	interface_ = interface;
+	copy_      = NULL;
+	interface_->rwlock_->lock_for_read();
+	locked_ = true;
+	if (!interface_->valid_) {
+		release();
+		throw InterfaceInvalidException(interface_, "InterfaceReadGuard");
+	}
+	if (interface_->mem_seqlock_only_) {
+		copy_ = malloc(interface_->data_size);
+		interface_->copy_shared_lockfree(copy_);
+	}
+}
+
+/** Destructor.
+ * Releases the read lock if still held.
+ */
+InterfaceReadGuard::~InterfaceReadGuard()
+{
+	release();
+}
+
+/** Release read lock.
+ * After this call the pointers obtained from the guard must no longer
+ * be used.
+ */
+void
+InterfaceReadGuard::release()
+{
+	if (locked_) {
+		interface_->rwlock_->unlock();
+		locked_ = false;
+	}
+	if (copy_) {
+		free(copy_);
+		copy_ = NULL;
+	}
+}
+
+/** Check if guard still holds the read lock.
+ * @return true if locked, false after release()
+ */
+bool
+InterfaceReadGuard::locked() const
+{
+	return locked_;
+}
+
+/** Get shared data chunk.
+ * @return const pointer to the shared memory chunk of the interface
+ * @exception NotLockedException thrown if the guard has been released
+ */
+const void *
+InterfaceReadGuard::datachunk() const
+{
+	if (!locked_) {
+		throw NotLockedException("InterfaceReadGuard for %s released", interface_->uid());
+	}
+	return copy_ ? copy_ : interface_->mem_data_ptr_;
+}
+
+/** Get data size.
+ * @return size in bytes of the shared data chunk
+ */
+unsigned int
+InterfaceReadGuard::datasize() const
+{
+	return interface_->data_size;
+}
+
+/** Get timestamp of shared data.
+ * @return timestamp currently stored in the shared memory chunk
+ */
+Time
+InterfaceReadGuard::timestamp() const
+{
+	const Interface::interface_data_ts_t *ts =
+	  static_cast<const Interface::interface_data_ts_t *>(datachunk());
+	return Time(ts->timestamp_sec, ts->timestamp_usec);
+}
+
+/** Map pointer from private copy to shared chunk.
+ * @param private_ptr pointer into the private data copy
+ * @param size size in bytes of the referenced memory area
+ * @return pointer to the same offset in the shared data chunk
+ */
+const void *
+InterfaceReadGuard::translate(const void *private_ptr, size_t size) const
+{
+	const char *base   = static_cast<const char *>(interface_->data_ptr);
+	const char *ptr    = static_cast<const char *>(private_ptr);
+	size_t      offset = ptr - base;
+	if ((ptr < base) || (offset + size > interface_->data_size)) {
+		throw OutOfBoundsException("Field is not part of interface data",
+		                           offset,
+		                           0,
+		                           interface_->data_size);
+	}
+	return static_cast<const char *>(datachunk()) + offset;
+}
+
+} // end namespace fawkes
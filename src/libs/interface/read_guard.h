@@ -0,0 +1,79 @@
+
+/***************************************************************************
+ *  read_guard.h - Scoped zero-copy read access to interface data
+ *
+ *  Created: Wed Oct 14 18:09:02 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _INTERFACE_READ_GUARD_H_
+#define _INTERFACE_READ_GUARD_H_
+
+#include <cstddef>
+
+namespace fawkes {
+
+class Interface;
+class Time;
+
+class InterfaceReadGuard
+{
+public:
+	InterfaceReadGuard(Interface *interface);
+	~InterfaceReadGuard();
+
+	const void * datachunk() const;
+	unsigned int datasize() const;
+	Time         timestamp() const;
+	bool         locked() const;
+
+	void release();
+
+	/** Get field in shared memory.
+	 * Maps a pointer into the interface's private copy, for example as
+	 * returned by a generated array field getter, to the very same field
+	 * inside the shared memory chunk.
+	 * @param private_field pointer to field in the private data copy
+	 * @param num_elements number of elements of the field
+	 * @return pointer to the same field in the shared memory chunk, valid
+	 * only as long as the guard is locked
+	 * @exception OutOfBoundsException thrown if the field is not within
+	 * the interface's data
+	 */
+	template <typename T>
+	const T *
+	shared(const T *private_field, size_t num_elements = 1) const
+	{
+		return static_cast<const T *>(translate(private_field, num_elements * sizeof(T)));
+	}
+
+private:
+	InterfaceReadGuard(const InterfaceReadGuard &) = delete;
+	InterfaceReadGuard &operator=(const InterfaceReadGuard &) = delete;
+
+	const void *translate(const void *private_ptr, size_t size) const;
+
+private:
+	Interface *interface_;
+	bool       locked_;
+	void *     copy_;
+};
+
+} // end namespace fawkes
+
+#endif
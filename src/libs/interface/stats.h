@@ -0,0 +1,84 @@
+
+/***************************************************************************
+ *  stats.h - BlackBoard interface usage statistics
+ *
+ *  Created: Thu Oct 15 07:23:35 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _INTERFACE_STATS_H_
+#define _INTERFACE_STATS_H_
+
+#include <stdint.h>
+#include <time.h>
+
+namespace fawkes {
+
+/** Usage statistics of an interface.
+ * The statistics are kept in the memory header of the interface and are
+ * shared by all instances of the interface. They are only updated if
+ * statistics have been enabled with Interface::set_stats_enabled().
+ * Fields are updated with relaxed atomic operations.
+ */
+typedef struct
+{
+	uint64_t num_reads;            /**< number of read() calls */
+	uint64_t num_read_copies;      /**< number of reads which copied data */
+	uint64_t num_read_locked;      /**< number of reads which needed the read lock */
+	uint64_t num_writes;           /**< number of write() calls */
+	uint64_t num_messages;         /**< number of messages enqueued by readers */
+	uint64_t read_lock_wait_nsec;  /**< time waited to acquire the read lock */
+	uint64_t write_lock_wait_nsec; /**< time waited to acquire the write lock */
+} interface_stats_t;
+
+/** Get consistent copy of interface statistics.
+ * Each field is read atomically, the fields need not be consistent
+ * with each other.
+ * @param src statistics to copy, may be NULL
+ * @param dst upon return contains the copy, all zero if @p src is NULL
+ */
+inline void
+interface_stats_copy(const interface_stats_t *src, interface_stats_t &dst)
+{
+	if (src) {
+		dst.num_reads            = __atomic_load_n(&src->num_reads, __ATOMIC_RELAXED);
+		dst.num_read_copies      = __atomic_load_n(&src->num_read_copies, __ATOMIC_RELAXED);
+		dst.num_read_locked      = __atomic_load_n(&src->num_read_locked, __ATOMIC_RELAXED);
+		dst.num_writes           = __atomic_load_n(&src->num_writes, __ATOMIC_RELAXED);
+		dst.num_messages         = __atomic_load_n(&src->num_messages, __ATOMIC_RELAXED);
+		dst.read_lock_wait_nsec  = __atomic_load_n(&src->read_lock_wait_nsec, __ATOMIC_RELAXED);
+		dst.write_lock_wait_nsec = __atomic_load_n(&src->write_lock_wait_nsec, __ATOMIC_RELAXED);
+	} else {
+		dst = interface_stats_t();
+	}
+}
+
+/** Get monotonic time for statistics.
+ * @return monotonic time in nanoseconds
+ */
+inline uint64_t
+interface_stats_clock_nsec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+} // end namespace fawkes
+
+#endif
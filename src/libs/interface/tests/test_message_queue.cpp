@@ -0,0 +1,280 @@
+/***************************************************************************
+ *  test_message_queue.cpp - Interface message queue tests
+ *
+ *  Created: Thu Oct 15 11:12:26 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <interface/message.h>
+#include <interface/message_queue.h>
+
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+
+/** Message with a queue policy for the tests. */
+class TestMessage : public Message
+{
+public:
+	/** Constructor.
+	 * @param type message type, messages with replace semantics replace
+	 * queued messages of the same type
+	 * @param id message ID, used to identify the message in the tests
+	 * @param priority queue priority
+	 * @param replace true to replace queued messages of the same type
+	 * @param num_deleted if not NULL incremented when the message is deleted
+	 */
+	TestMessage(const char *  type,
+	            unsigned int  id,
+	            unsigned int  priority    = 0,
+	            bool          replace     = false,
+	            unsigned int *num_deleted = NULL)
+	: Message(type), num_deleted_(num_deleted)
+	{
+		data_size = sizeof(message_data_ts_t);
+		data_ptr  = calloc(1, data_size);
+		data_ts   = (message_data_ts_t *)data_ptr;
+		set_id(id);
+		set_queue_policy(priority, replace);
+	}
+
+	/** Destructor. */
+	~TestMessage()
+	{
+		free(data_ptr);
+		if (num_deleted_)
+			++*num_deleted_;
+	}
+
+private:
+	unsigned int *num_deleted_;
+};
+
+/** Get IDs of queued messages in queue order.
+ * @param q message queue
+ * @return message IDs
+ */
+std::vector<unsigned int>
+queued_ids(MessageQueue &q)
+{
+	std::vector<unsigned int> ids;
+	q.lock();
+	for (MessageQueue::MessageIterator i = q.begin(); i != q.end(); ++i) {
+		ids.push_back(i.id());
+	}
+	q.unlock();
+	return ids;
+}
+
+} // namespace
+
+TEST_CASE("Concurrent producers lose no messages", "[interface][message_queue]")
+{
+	const unsigned int num_producers = 4;
+	const unsigned int num_messages  = 5000;
+
+	MessageQueue             q;
+	std::vector<std::thread> producers;
+	for (unsigned int p = 0; p < num_producers; ++p) {
+		producers.emplace_back([&, p]() {
+			for (unsigned int i = 0; i < num_messages; ++i) {
+				q.append(new TestMessage("TestMessage", p * num_messages + i));
+			}
+		});
+	}
+
+	// consume while producing, alternating between single and bulk removal
+	std::vector<unsigned int> last(num_producers, 0);
+	std::vector<unsigned int> received(num_producers, 0);
+	unsigned int              num_received     = 0;
+	unsigned int              num_out_of_order = 0;
+	auto                      consume          = [&](Message *m) {
+		unsigned int p = m->id() / num_messages;
+		unsigned int i = m->id() % num_messages;
+		if ((received[p] > 0) && (i != last[p] + 1))
+			++num_out_of_order;
+		last[p] = i;
+		++received[p];
+		++num_received;
+		m->unref();
+	};
+	while (num_received < num_producers * num_messages) {
+		if (Message *m = q.first()) {
+			m->ref();
+			q.pop();
+			consume(m);
+		}
+		std::vector<Message *> drained;
+		q.drain(drained);
+		for (Message *m : drained) {
+			consume(m);
+		}
+		std::this_thread::yield();
+	}
+	for (auto &t : producers) {
+		t.join();
+	}
+
+	REQUIRE(num_received == num_producers * num_messages);
+	for (unsigned int p = 0; p < num_producers; ++p) {
+		REQUIRE(received[p] == num_messages);
+	}
+	REQUIRE(num_out_of_order == 0);
+	REQUIRE(q.empty());
+}
+
+TEST_CASE("Messages stay in FIFO order", "[interface][message_queue]")
+{
+	MessageQueue q;
+	for (unsigned int i = 1; i <= 5; ++i) {
+		q.append(new TestMessage("TestMessage", i));
+	}
+	REQUIRE(q.size() == 5);
+
+	// appended to the end of the already collected messages
+	for (unsigned int i = 6; i <= 8; ++i) {
+		q.append(new TestMessage("TestMessage", i));
+	}
+	REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 2, 3, 4, 5, 6, 7, 8});
+
+	REQUIRE(q.first()->id() == 1);
+	q.pop();
+	q.remove(8u);
+	REQUIRE(q.first()->id() == 2);
+
+	// the end of the queue must follow removal of the last message
+	q.append(new TestMessage("TestMessage", 9));
+	std::vector<Message *> drained;
+	REQUIRE(q.drain(drained) == 7);
+	std::vector<unsigned int> ids;
+	for (Message *m : drained) {
+		ids.push_back(m->id());
+		m->unref();
+	}
+	REQUIRE(ids == std::vector<unsigned int>{2, 3, 4, 5, 6, 7, 9});
+	REQUIRE(q.empty());
+
+	q.append(new TestMessage("TestMessage", 10));
+	REQUIRE(queued_ids(q) == std::vector<unsigned int>{10});
+}
+
+TEST_CASE("Messages with priority move ahead", "[interface][message_queue]")
+{
+	MessageQueue q;
+
+	SECTION("The first message is never moved")
+	{
+		q.append(new TestMessage("TestMessage", 1));
+		q.append(new TestMessage("TestMessage", 2));
+		REQUIRE(q.size() == 2);
+
+		q.append(new TestMessage("UrgentMessage", 3, 5));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 3, 2});
+
+		// same priority keeps FIFO order
+		q.append(new TestMessage("UrgentMessage", 4, 5));
+		q.append(new TestMessage("UrgentMessage", 5, 9));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 5, 3, 4, 2});
+	}
+
+	SECTION("Mixed messages collected at once")
+	{
+		q.append(new TestMessage("TestMessage", 1));
+		q.append(new TestMessage("TestMessage", 2));
+		REQUIRE(q.size() == 2);
+
+		q.append(new TestMessage("TestMessage", 3));
+		q.append(new TestMessage("UrgentMessage", 4, 5));
+		q.append(new TestMessage("TestMessage", 5));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 4, 2, 3, 5});
+	}
+
+	SECTION("Lower priority messages are appended")
+	{
+		q.append(new TestMessage("TestMessage", 1));
+		q.append(new TestMessage("UrgentMessage", 2, 5));
+		q.append(new TestMessage("UrgentMessage", 3, 3));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 2, 3});
+
+		// inserted at the end, following messages must come after it
+		q.append(new TestMessage("UrgentMessage", 4, 1));
+		q.append(new TestMessage("TestMessage", 5));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 2, 3, 4, 5});
+	}
+}
+
+TEST_CASE("Messages with replace semantics keep the latest", "[interface][message_queue]")
+{
+	MessageQueue q;
+	unsigned int num_deleted = 0;
+
+	SECTION("Queued message is replaced in place")
+	{
+		q.append(new TestMessage("TestMessage", 1));
+		q.append(new TestMessage("SetPointMessage", 2, 0, true, &num_deleted));
+		q.append(new TestMessage("TestMessage", 3));
+		REQUIRE(q.size() == 3);
+
+		q.append(new TestMessage("SetPointMessage", 4, 0, true, &num_deleted));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 4, 3});
+		REQUIRE(num_deleted == 1);
+	}
+
+	SECTION("The first message is never replaced")
+	{
+		q.append(new TestMessage("SetPointMessage", 1, 0, true, &num_deleted));
+		REQUIRE(q.size() == 1);
+
+		q.append(new TestMessage("SetPointMessage", 2, 0, true, &num_deleted));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 2});
+
+		q.append(new TestMessage("SetPointMessage", 3, 0, true, &num_deleted));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 3});
+		REQUIRE(num_deleted == 1);
+	}
+
+	SECTION("Replacing the last message updates the end of the queue")
+	{
+		q.append(new TestMessage("TestMessage", 1));
+		q.append(new TestMessage("SetPointMessage", 2, 0, true, &num_deleted));
+		REQUIRE(q.size() == 2);
+
+		q.append(new TestMessage("SetPointMessage", 3, 0, true, &num_deleted));
+		REQUIRE(q.size() == 2);
+		REQUIRE(num_deleted == 1);
+		q.append(new TestMessage("TestMessage", 4));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 3, 4});
+	}
+
+	SECTION("Replaced within one batch of appended messages")
+	{
+		q.append(new TestMessage("TestMessage", 1));
+		q.append(new TestMessage("SetPointMessage", 2, 0, true, &num_deleted));
+		q.append(new TestMessage("SetPointMessage", 3, 0, true, &num_deleted));
+		q.append(new TestMessage("SetPointMessage", 4, 0, true, &num_deleted));
+		REQUIRE(queued_ids(q) == std::vector<unsigned int>{1, 4});
+		REQUIRE(num_deleted == 2);
+	}
+
+	q.flush();
+	REQUIRE(q.empty());
+}
@@ -65,6 +65,19 @@ struct interface_fieldinfo_t
 	interface_fieldinfo_t *     next;     /**< next field, NULL if last */
 };
 
+/** Static interface field descriptor.
+ * Describes a field by its position in the data chunk. Generated
+ * interfaces provide a constant table of these per interface type.
+ */
+struct interface_field_descriptor_t
+{
+	interface_fieldtype_t type;     /**< type of this field */
+	const char *          name;     /**< name of this field */
+	size_t                offset;   /**< offset of the field in the data chunk */
+	size_t                length;   /**< number of elements (array, string) */
+	const char *          enumtype; /**< enum type name, NULL if not an enum */
+};
+
 } // namespace fawkes
 
 #endif /* INTERFACE_TYPES_H___ */
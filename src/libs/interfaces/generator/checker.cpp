@@ -185,6 +185,7 @@ reserved_names_interface()
 	        "compare_buffers",
 	        "buffer_timestamp",
 	        "read",
+	        "read_if_changed",
 	        "write",
 	        "has_writer",
 	        "num_readers",
@@ -208,6 +209,7 @@ reserved_names_interface()
 	        "msgq_first",
 	        "msgq_empty",
 	        "msgq_append",
+	        "msgq_drain",
 	        "msgq_first_is",
 	        "msgq_first",
 	        "msgq_first_safe",
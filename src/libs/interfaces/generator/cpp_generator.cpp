@@ -221,7 +221,8 @@ CppInterfaceGenerator::write_cpp(FILE *f)
 	write_header(f, filename_cpp);
 	fprintf(f,
 	        "#include <interfaces/%s>\n\n"
-	        "#include <core/exceptions/software.h>\n\n"
+	        "#include <core/exceptions/software.h>\n"
+	        "#include <interface/json.h>\n\n"
 	        "#include <map>\n"
 	        "#include <string>\n"
 	        "#include <cstring>\n"
@@ -238,10 +239,18 @@ CppInterfaceGenerator::write_cpp(FILE *f)
 	        class_name.c_str(),
 	        data_comment.c_str());
 	write_constants_cpp(f);
+	fprintf(f, "/// @cond INTERNALS\nconstexpr unsigned int %s::num_data_fields;\n", class_name.c_str());
+	if (!data_fields.empty()) {
+		fprintf(f,
+		        "constexpr interface_field_descriptor_t %s::data_fields[];\n",
+		        class_name.c_str());
+	}
+	fprintf(f, "/// @endcond\n\n");
 	write_ctor_dtor_cpp(f, class_name, "Interface", "", data_fields, messages);
 	write_enum_constants_tostring_cpp(f);
 	write_methods_cpp(f, class_name, class_name, data_fields, pseudo_maps, "");
 	write_basemethods_cpp(f);
+	write_to_json_method_cpp(f, class_name, data_fields);
 	write_messages_cpp(f);
 
 	write_management_funcs_cpp(f);
@@ -385,6 +394,7 @@ CppInterfaceGenerator::write_messages_h(FILE *f)
 		write_message_ctor_dtor_h(f, "    ", (*i).getName(), (*i).getFields());
 		write_methods_h(f, "    ", (*i).getFields());
 		write_message_clone_method_h(f, "    ");
+		write_to_json_method_h(f, "    ");
 		fprintf(f, "  };\n\n");
 	}
 	fprintf(f, "  virtual bool message_valid(const Message *message) const;\n");
@@ -409,9 +419,16 @@ CppInterfaceGenerator::write_messages_cpp(FILE *f)
 		        (*i).getName().c_str(),
 		        (*i).getComment().c_str());
 
-		write_message_ctor_dtor_cpp(f, (*i).getName(), "Message", class_name + "::", (*i).getFields());
+		write_message_ctor_dtor_cpp(f,
+		                            (*i).getName(),
+		                            "Message",
+		                            class_name + "::",
+		                            (*i).getFields(),
+		                            (*i).getQueuePriority(),
+		                            (*i).getQueueReplace());
 		write_methods_cpp(f, class_name, (*i).getName(), (*i).getFields(), class_name + "::");
 		write_message_clone_method_cpp(f, (class_name + "::" + (*i).getName()).c_str());
+		write_to_json_method_cpp(f, class_name + "::" + (*i).getName(), (*i).getFields());
 	}
 	fprintf(f,
 	        "/** Check if message is valid and can be enqueued.\n"
@@ -595,6 +612,22 @@ CppInterfaceGenerator::write_message_ctor_dtor_h(FILE *
 	fprintf(f, "%sexplicit %s(const %s *m);\n", is.c_str(), classname.c_str(), classname.c_str());
 }
 
+/** Write queue policy of message.
+ * Writes nothing for regular messages.
+ * @param f file to write to
+ * @param queue_priority queue priority of message
+ * @param queue_replace true if the message replaces queued messages of the same type
+ */
+void
+CppInterfaceGenerator::write_message_queue_policy(FILE *       f,
+                                                  unsigned int queue_priority,
+                                                  bool         queue_replace)
+{
+	if ((queue_priority > 0) || queue_replace) {
+		fprintf(f, "  set_queue_policy(%u, %s);\n", queue_priority, queue_replace ? "true" : "false");
+	}
+}
+
 /** Write message clone method header.
  * @param f file to write to
  * @param is indentation space
@@ -649,6 +682,44 @@ CppInterfaceGenerator::write_enum_map_population(FILE *f)
 	}
 }
 
+/** Get interface field type name.
+ * @param field field to get the type name for
+ * @return name of the interface_fieldtype_t value without IFT_ prefix
+ */
+static const char *
+field_type_name(const InterfaceField &field)
+{
+	if (field.getType() == "bool") {
+		return "BOOL";
+	} else if (field.getType() == "int8") {
+		return "INT8";
+	} else if (field.getType() == "uint8") {
+		return "UINT8";
+	} else if (field.getType() == "int16") {
+		return "INT16";
+	} else if (field.getType() == "uint16") {
+		return "UINT16";
+	} else if (field.getType() == "int32") {
+		return "INT32";
+	} else if (field.getType() == "uint32") {
+		return "UINT32";
+	} else if (field.getType() == "int64") {
+		return "INT64";
+	} else if (field.getType() == "uint64") {
+		return "UINT64";
+	} else if (field.getType() == "byte") {
+		return "BYTE";
+	} else if (field.getType() == "float") {
+		return "FLOAT";
+	} else if (field.getType() == "double") {
+		return "DOUBLE";
+	} else if (field.getType() == "string") {
+		return "STRING";
+	} else {
+		return "ENUM";
+	}
+}
+
 /** Write the add_fieldinfo() calls.
  * @param f file to write to
  * @param fields fields to write field info for
@@ -658,39 +729,11 @@ CppInterfaceGenerator::write_add_fieldinfo_calls(FILE *f, std::vector<InterfaceF
 {
 	std::vector<InterfaceField>::iterator i;
 	for (i = fields.begin(); i != fields.end(); ++i) {
-		const char *type    = "";
-		const char *dataptr = "&";
+		const char *type    = field_type_name(*i);
+		const char *dataptr = (i->getType() == "string") ? "" : "&";
 		std::string enumtype;
 
-		if (i->getType() == "bool") {
-			type = "BOOL";
-		} else if (i->getType() == "int8") {
-			type = "INT8";
-		} else if (i->getType() == "uint8") {
-			type = "UINT8";
-		} else if (i->getType() == "int16") {
-			type = "INT16";
-		} else if (i->getType() == "uint16") {
-			type = "UINT16";
-		} else if (i->getType() == "int32") {
-			type = "INT32";
-		} else if (i->getType() == "uint32") {
-			type = "UINT32";
-		} else if (i->getType() == "int64") {
-			type = "INT64";
-		} else if (i->getType() == "uint64") {
-			type = "UINT64";
-		} else if (i->getType() == "byte") {
-			type = "BYTE";
-		} else if (i->getType() == "float") {
-			type = "FLOAT";
-		} else if (i->getType() == "double") {
-			type = "DOUBLE";
-		} else if (i->getType() == "string") {
-			type    = "STRING";
-			dataptr = "";
-		} else {
-			type     = "ENUM";
+		if (i->isEnumType()) {
 			enumtype = i->getType();
 		}
 
@@ -746,6 +789,9 @@ CppInterfaceGenerator::write_ctor_dtor_cpp(FILE *                        f,
 
 	write_enum_map_population(f);
 	write_add_fieldinfo_calls(f, fields);
+	if (!fields.empty()) {
+		fprintf(f, "  set_field_descriptors(data_fields, num_data_fields);\n");
+	}
 
 	for (vector<InterfaceMessage>::iterator i = messages.begin(); i != messages.end(); ++i) {
 		fprintf(f, "  add_messageinfo(\"%s\");\n", i->getName().c_str());
@@ -776,13 +822,17 @@ CppInterfaceGenerator::write_ctor_dtor_cpp(FILE *                        f,
  * @param super_class name of base class
  * @param inclusion_prefix Used if class is included in another class.
  * @param fields vector of data fields of message
+ * @param queue_priority queue priority of message
+ * @param queue_replace true if the message replaces queued messages of the same type
  */
 void
 CppInterfaceGenerator::write_message_ctor_dtor_cpp(FILE *                      f,
                                                    std::string                 classname,
                                                    std::string                 super_class,
                                                    std::string                 inclusion_prefix,
-                                                   std::vector<InterfaceField> fields)
+                                                   std::vector<InterfaceField> fields,
+                                                   unsigned int                queue_priority,
+                                                   bool                        queue_replace)
 {
 	vector<InterfaceField>::iterator i;
 
@@ -850,6 +900,7 @@ CppInterfaceGenerator::write_message_ctor_dtor_cpp(FILE *                      f
 
 		write_enum_map_population(f);
 		write_add_fieldinfo_calls(f, fields);
+		write_message_queue_policy(f, queue_priority, queue_replace);
 
 		fprintf(f, "}\n");
 	}
@@ -875,6 +926,7 @@ CppInterfaceGenerator::write_message_ctor_dtor_cpp(FILE *                      f
 
 	write_enum_map_population(f);
 	write_add_fieldinfo_calls(f, fields);
+	write_message_queue_policy(f, queue_priority, queue_replace);
 
 	fprintf(f,
 	        "}\n\n"
@@ -1215,6 +1267,160 @@ CppInterfaceGenerator::write_methods_h(FILE *                          f,
 	}
 }
 
+/** Write static field descriptors and field visitor to h file.
+ * The descriptor table describes the data fields with their offsets into
+ * the data chunk. Generic consumers can use it via
+ * Interface::field_descriptors() to access fields without the field info
+ * list. Consumers knowing the interface type can use visit_fields() to
+ * get typed field references resolved at compile time.
+ * @param f file to write to
+ * @param is indentation space
+ */
+void
+CppInterfaceGenerator::write_field_descriptors_h(FILE *f, std::string is)
+{
+	fprintf(f,
+	        "\n%s/** Number of data fields. */\n"
+	        "%sstatic constexpr unsigned int num_data_fields = %zu;\n",
+	        is.c_str(),
+	        is.c_str(),
+	        data_fields.size());
+
+	if (!data_fields.empty()) {
+		fprintf(f,
+		        "%s/** Descriptors of the data fields, in order of the data struct. */\n"
+		        "%sstatic constexpr interface_field_descriptor_t data_fields[] = {\n",
+		        is.c_str(),
+		        is.c_str());
+		for (vector<InterfaceField>::iterator i = data_fields.begin(); i != data_fields.end(); ++i) {
+			fprintf(f,
+			        "%s  {IFT_%s, \"%s\", offsetof(%s_data_t, %s), %u, %s%s%s},\n",
+			        is.c_str(),
+			        field_type_name(*i),
+			        i->getName().c_str(),
+			        class_name.c_str(),
+			        i->getName().c_str(),
+			        (i->getLengthValue() > 0) ? i->getLengthValue() : 1,
+			        i->isEnumType() ? "\"" : "",
+			        i->isEnumType() ? i->getType().c_str() : "nullptr",
+			        i->isEnumType() ? "\"" : "");
+		}
+		fprintf(f, "%s};\n", is.c_str());
+	}
+
+	fprintf(f,
+	        "\n%s/** Visit all data fields.\n"
+	        "%s * Calls visitor(descriptor, value) for each data field, where descriptor\n"
+	        "%s * is the entry in data_fields and value a const reference to the field in\n"
+	        "%s * the data struct, arrays and strings are passed as array references.\n"
+	        "%s * Enum fields are passed as int32_t. The visitor is resolved at compile\n"
+	        "%s * time, typically by overloading operator() for the field types.\n"
+	        "%s * @param visitor visitor to call for each field\n"
+	        "%s */\n"
+	        "%stemplate <typename Visitor>\n"
+	        "%svoid\n"
+	        "%svisit_fields(Visitor &visitor) const\n"
+	        "%s{\n",
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str(),
+	        is.c_str());
+	unsigned int idx = 0;
+	for (vector<InterfaceField>::iterator i = data_fields.begin(); i != data_fields.end(); ++i) {
+		fprintf(f,
+		        "%s  visitor(data_fields[%u], const_cast<const %s_data_t *>(data)->%s);\n",
+		        is.c_str(),
+		        idx++,
+		        class_name.c_str(),
+		        i->getName().c_str());
+	}
+	if (data_fields.empty()) {
+		fprintf(f, "%s  (void)visitor;\n", is.c_str());
+	}
+	fprintf(f, "%s}\n", is.c_str());
+}
+
+/** Write to_json() method to h file.
+ * @param f file to write to
+ * @param is indentation space
+ */
+void
+CppInterfaceGenerator::write_to_json_method_h(FILE *f, std::string /* indent space */ is)
+{
+	fprintf(f, "%svirtual void to_json(std::string &json) const;\n", is.c_str());
+}
+
+/** Write to_json() method to cpp file.
+ * Writes straight-line code appending each field to the JSON string,
+ * the generic implementation walks the field info list instead.
+ * @param f file to write to
+ * @param classname fully qualified name of interface or message class
+ * @param fields fields to serialize
+ */
+void
+CppInterfaceGenerator::write_to_json_method_cpp(FILE *                      f,
+                                                std::string                 classname,
+                                                std::vector<InterfaceField> fields)
+{
+	fprintf(f,
+	        "/** Serialize fields as JSON object.\n"
+	        " * @param json string to append the JSON object to\n"
+	        " */\n"
+	        "void\n"
+	        "%s::to_json(std::string &json) const\n"
+	        "{\n",
+	        classname.c_str());
+
+	if (fields.empty()) {
+		fprintf(f, "  json += \"{}\";\n}\n\n");
+		return;
+	}
+
+	fprintf(f, "  json += '{';\n");
+	for (vector<InterfaceField>::iterator i = fields.begin(); i != fields.end(); ++i) {
+		std::string name = i->getName();
+		fprintf(f,
+		        "  json_append_key(json, \"%s\"%s);\n",
+		        name.c_str(),
+		        (i == fields.begin()) ? ", true" : "");
+		if (i->getType() == "string") {
+			fprintf(f,
+			        "  json_append_string(json, data->%s, sizeof(data->%s));\n",
+			        name.c_str(),
+			        name.c_str());
+		} else if (i->isEnumType() && i->getLength().length() > 0) {
+			fprintf(f,
+			        "  json_append_enum_array(json, enum_map_%s, data->%s, %s);\n",
+			        i->getType().c_str(),
+			        name.c_str(),
+			        i->getLength().c_str());
+		} else if (i->isEnumType()) {
+			fprintf(f,
+			        "  json_append_enum(json, enum_map_%s, data->%s);\n",
+			        i->getType().c_str(),
+			        name.c_str());
+		} else if (i->getLength().length() > 0) {
+			fprintf(f,
+			        "  json_append_array(json, data->%s, %s);\n",
+			        name.c_str(),
+			        i->getLength().c_str());
+		} else {
+			fprintf(f, "  json_append_value(json, data->%s);\n", name.c_str());
+		}
+	}
+	fprintf(f,
+	        "  json += '}';\n"
+	        "}\n\n");
+}
+
 /** Write base methods header entries.
  * @param f file to write to
  * @param is indentation string
@@ -1244,6 +1450,7 @@ CppInterfaceGenerator::write_h(FILE *f)
 	        "#include <interface/interface.h>\n"
 	        "#include <interface/message.h>\n"
 	        "#include <interface/field_iterator.h>\n\n"
+	        "#include <cstddef>\n\n"
 	        "namespace fawkes {\n\n"
 	        "class %s : public Interface\n"
 	        "{\n"
@@ -1272,6 +1479,8 @@ CppInterfaceGenerator::write_h(FILE *f)
 	fprintf(f, " public:\n");
 	write_methods_h(f, "  ", data_fields, pseudo_maps);
 	write_basemethods_h(f, "  ");
+	write_to_json_method_h(f, "  ");
+	write_field_descriptors_h(f, "  ");
 	fprintf(f, "\n};\n\n} // end namespace fawkes\n\n#endif\n");
 }
 
@@ -77,7 +77,10 @@ public:
 	                                 std::string                 classname,
 	                                 std::string                 super_class,
 	                                 std::string                 inclusion_prefix,
-	                                 std::vector<InterfaceField> fields);
+	                                 std::vector<InterfaceField> fields,
+	                                 unsigned int                queue_priority = 0,
+	                                 bool                        queue_replace  = false);
+	void write_message_queue_policy(FILE *f, unsigned int queue_priority, bool queue_replace);
 	void write_message_clone_method_h(FILE *f, std::string is);
 	void write_message_clone_method_cpp(FILE *f, std::string classname);
 
@@ -110,6 +113,10 @@ public:
 
 	void write_enum_map_population(FILE *f);
 	void write_add_fieldinfo_calls(FILE *f, std::vector<InterfaceField> &fields);
+	void write_field_descriptors_h(FILE *f, std::string /* indent space */ is);
+	void write_to_json_method_h(FILE *f, std::string /* indent space */ is);
+	void
+	write_to_json_method_cpp(FILE *f, std::string classname, std::vector<InterfaceField> fields);
 
 	void write_struct(FILE *                         f,
 	                  std::string                    name,
@@ -41,6 +41,8 @@ InterfaceMessage::InterfaceMessage(const std::string &name, const std::string &c
 	}
 	this->comment = comment;
 	fields.clear();
+	queue_priority = 0;
+	queue_replace  = false;
 }
 
 /** Get name of message.
@@ -78,3 +80,32 @@ InterfaceMessage::getFields()
 {
 	return fields;
 }
+
+/** Set queue policy of message.
+ * @param priority queue priority, 0 for regular messages
+ * @param replace true if the message replaces a queued message of the same type
+ */
+void
+InterfaceMessage::setQueuePolicy(unsigned int priority, bool replace)
+{
+	queue_priority = priority;
+	queue_replace  = replace;
+}
+
+/** Get queue priority of message.
+ * @return queue priority, 0 for regular messages
+ */
+unsigned int
+InterfaceMessage::getQueuePriority()
+{
+	return queue_priority;
+}
+
+/** Check if message replaces queued messages of the same type.
+ * @return true if the message replaces a queued message of the same type
+ */
+bool
+InterfaceMessage::getQueueReplace()
+{
+	return queue_replace;
+}
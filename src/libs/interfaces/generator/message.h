@@ -37,11 +37,16 @@ public:
 	std::string                 getComment();
 	void                        setFields(const std::vector<InterfaceField> &fields);
 	std::vector<InterfaceField> getFields();
+	void                        setQueuePolicy(unsigned int priority, bool replace);
+	unsigned int                getQueuePriority();
+	bool                        getQueueReplace();
 
 private:
 	std::string                 name;
 	std::string                 comment;
 	std::vector<InterfaceField> fields;
+	unsigned int                queue_priority;
+	bool                        queue_replace;
 };
 
 #endif
@@ -578,8 +578,10 @@ InterfaceParser::parse()
    */
 	set = root->find("/interface/message");
 	for (NodeSet::iterator i = set.begin(); i != set.end(); ++i) {
-		std::string msg_name;
-		std::string msg_comment;
+		std::string  msg_name;
+		std::string  msg_comment;
+		unsigned int msg_priority = 0;
+		bool         msg_replace  = false;
 
 		el = dynamic_cast<const Element *>(*i);
 		if (el) {
@@ -595,6 +597,26 @@ InterfaceParser::parse()
 				  msg_name.c_str(),
 				  INTERFACE_MESSAGE_TYPE_SIZE_ - 1 - std::string("Message").length());
 			}
+			attr = el->get_attribute("priority");
+			if (attr) {
+				if (attr->get_value().empty()
+				    || attr->get_value().find_first_not_of("0123456789") != std::string::npos) {
+					throw InterfaceGeneratorInvalidContentException(
+					  "Invalid priority '%s' for message %s", attr->get_value().c_str(), msg_name.c_str());
+				}
+				msg_priority = fawkes::StringConversions::to_uint(attr->get_value());
+			}
+			attr = el->get_attribute("replace");
+			if (attr) {
+				if (attr->get_value() == "true") {
+					msg_replace = true;
+				} else if (attr->get_value() != "false") {
+					throw InterfaceGeneratorInvalidContentException(
+					  "Invalid replace value '%s' for message %s, must be true or false",
+					  attr->get_value().c_str(),
+					  msg_name.c_str());
+				}
+			}
 		} else {
 			throw InterfaceGeneratorInvalidContentException("message is not an element");
 		}
@@ -644,6 +666,7 @@ InterfaceParser::parse()
 
 		InterfaceMessage msg(msg_name, msg_comment);
 		msg.setFields(msg_fields);
+		msg.setQueuePolicy(msg_priority, msg_replace);
 
 		messages.push_back(msg);
 	}
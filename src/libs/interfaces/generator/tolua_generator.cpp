@@ -337,6 +337,7 @@ ToLuaInterfaceGenerator::write_superclass_h(FILE *f)
 	        "const;\n"
 
 	        "  void          read();\n"
+	        "  bool          read_if_changed();\n"
 	        "  void          write();\n"
 
 	        "  bool          has_writer() const;\n"
@@ -411,6 +412,78 @@ ToLuaInterfaceGenerator::write_lua_code(FILE *f, std::string classname)
 	        classname.c_str());
 }
 
+/** Write C function to read all data fields at once.
+ * The function copies all data fields into a given Lua table using the
+ * Lua C API directly. Array fields are written to sub-tables, which are
+ * reused if they already exist. Lua code which reads many fields every
+ * loop can call read_fields() with the same table each time, instead of
+ * calling one tolua++ accessor per field, which has to check types and
+ * look up the method each time.
+ * @param f file to write to
+ */
+void
+ToLuaInterfaceGenerator::write_read_fields_c(FILE *f)
+{
+	fprintf(f,
+	        "${\n"
+	        "static void\n"
+	        "tolua_fawkes_%s_read_fields(fawkes::%s *iface, lua_State *L, lua_Object t)\n"
+	        "{\n",
+	        class_name.c_str(),
+	        class_name.c_str());
+
+	for (vector<InterfaceField>::iterator i = data_fields.begin(); i != data_fields.end(); ++i) {
+		std::string getter = ((i->getType() == "bool") ? "is_" : "") + i->getName();
+		std::string push;
+		if (i->getType() == "bool") {
+			push = "lua_pushboolean(L, ";
+		} else if (i->getType() == "string") {
+			push = "lua_pushstring(L, ";
+		} else {
+			push = "lua_pushnumber(L, (lua_Number)";
+		}
+
+		if ((i->getLengthValue() > 0) && (i->getType() != "string")) {
+			std::string array_type = i->getAccessType();
+			if (i->isEnumType()) {
+				array_type = "fawkes::" + class_name + "::" + array_type;
+			}
+			fprintf(f,
+			        "  {\n"
+			        "    %s v = iface->%s();\n"
+			        "    lua_getfield(L, t, \"%s\");\n"
+			        "    if (! lua_istable(L, -1)) {\n"
+			        "      lua_pop(L, 1);\n"
+			        "      lua_createtable(L, %s, 0);\n"
+			        "      lua_pushvalue(L, -1);\n"
+			        "      lua_setfield(L, t, \"%s\");\n"
+			        "    }\n"
+			        "    for (int i = 0; i < %s; ++i) {\n"
+			        "      %sv[i]);\n"
+			        "      lua_rawseti(L, -2, i + 1);\n"
+			        "    }\n"
+			        "    lua_pop(L, 1);\n"
+			        "  }\n",
+			        array_type.c_str(),
+			        getter.c_str(),
+			        i->getName().c_str(),
+			        i->getLength().c_str(),
+			        i->getName().c_str(),
+			        i->getLength().c_str(),
+			        push.c_str());
+		} else {
+			fprintf(f,
+			        "  %siface->%s());\n"
+			        "  lua_setfield(L, t, \"%s\");\n",
+			        push.c_str(),
+			        getter.c_str(),
+			        i->getName().c_str());
+		}
+	}
+
+	fprintf(f, "}\n$}\n\n");
+}
+
 /** Write methods to h file.
  * @param f file to write to
  * @param is indentation space.
@@ -494,17 +567,25 @@ ToLuaInterfaceGenerator::write_toluaf(FILE *f)
 	        "$#include <interfaces/%s>\n"
 	        "$#include <utils/time/time.h>\n"
 	        "$#include <utils/time/clock.h>\n"
-	        "$using namespace fawkes;\n"
+	        "$using namespace fawkes;\n",
+	        filename_h.c_str());
+
+	write_read_fields_c(f);
+
+	fprintf(f,
 	        "namespace fawkes {\n"
 	        "class %s : public Interface\n"
 	        "{\n",
-	        filename_h.c_str(),
 	        class_name.c_str());
 
 	write_constants_h(f);
 	write_messages_h(f);
 	//write_ctor_dtor_h(f, "  ", class_name);
 	write_methods_h(f, "  ", data_fields, pseudo_maps);
+	fprintf(f,
+	        "  tolua_outside void tolua_fawkes_%s_read_fields @ read_fields(lua_State *L,\n"
+	        "                                                      lua_Object table);\n",
+	        class_name.c_str());
 	write_superclass_h(f);
 	fprintf(f, "\n};\n\n");
 	write_lua_code(f, class_name);
@@ -21,6 +21,7 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <core/exceptions/software.h>
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
 #include <logging/cache.h>
@@ -29,6 +30,7 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 
 namespace fawkes {
@@ -37,6 +39,13 @@ namespace fawkes {
  * Logging Cache.
  * The CacheLogger will cache the log messages. By default these are
  * 20 messages.
+ *
+ * Messages are stored as compact records in a ring allocated up front,
+ * with the message text in a fixed-size slot of CACHE_MESSAGE_LENGTH
+ * bytes, longer messages are truncated. Component names are stored once
+ * and referenced by ID. Time strings are only formatted when messages
+ * are read, hence logging does not allocate memory once all components
+ * have been seen.
  * @author Tim Niemueller
  */
 
@@ -44,29 +53,70 @@ namespace fawkes {
  * @param num_entries number of entries in the cache, if the cache is full and a
  * new log message arrives the oldest message is erased.
  * @param log_level minimum level to log
+ * @exception OutOfBoundsException thrown if num_entries is zero
  */
 CacheLogger::CacheLogger(unsigned int num_entries, LogLevel log_level) : Logger(log_level)
 {
+	if (num_entries == 0) {
+		throw OutOfBoundsException("CacheLogger needs at least one entry");
+	}
 	max_num_entries_ = num_entries;
 	num_entries_     = 0;
+	next_seqnum_     = 0;
+	records_         = new Record[max_num_entries_];
+	slab_            = new char[(size_t)max_num_entries_ * CACHE_MESSAGE_LENGTH];
 
-	now_s = (struct ::tm *)malloc(sizeof(struct ::tm));
 	mutex = new Mutex();
 }
 
 /** Destructor. */
 CacheLogger::~CacheLogger()
 {
-	free(now_s);
+	delete[] records_;
+	delete[] slab_;
 	delete mutex;
 }
 
+/** Get messages.
+ * The list is rebuilt from the cache on each call and ordered newest
+ * first. Lock the logger while calling this and while accessing the
+ * list if messages may be logged concurrently. Prefer
+ * get_messages_since(), which does not require external locking and
+ * only returns new messages.
+ * @return reference to message list
+ */
 std::list<CacheLogger::CacheEntry> &
 CacheLogger::get_messages()
 {
+	messages_.clear();
+	for (unsigned long long s = next_seqnum_ - num_entries_; s < next_seqnum_; ++s) {
+		messages_.push_front(entry(s));
+	}
 	return messages_;
 }
 
+/** Get messages logged since a given sequence number.
+ * Messages are appended to @p entries oldest first and formatted only
+ * now. Pass the returned sequence number on the next call to only
+ * receive messages that were logged in the meantime. If messages have
+ * been dropped from the cache in between, the oldest message still in
+ * the cache is returned first. Start with zero to get all messages.
+ * @param seqnum sequence number of the first message to return
+ * @param entries upon return contains the new messages
+ * @return sequence number to pass on the next call
+ */
+unsigned long long
+CacheLogger::get_messages_since(unsigned long long seqnum, std::vector<CacheEntry> &entries)
+{
+	MutexLocker lock(mutex);
+	unsigned long long s = std::max(seqnum, next_seqnum_ - num_entries_);
+	entries.reserve(entries.size() + (size_t)(next_seqnum_ - std::min(s, next_seqnum_)));
+	for (; s < next_seqnum_; ++s) {
+		entries.push_back(entry(s));
+	}
+	return next_seqnum_;
+}
+
 void
 CacheLogger::clear()
 {
@@ -86,16 +136,35 @@ CacheLogger::size() const
 }
 
 /** Set maximum number of log entries in cache.
+ * The newest messages are kept if the cache shrinks.
  * @param new_size new size
+ * @exception OutOfBoundsException thrown if new_size is zero
  */
 void
 CacheLogger::set_size(unsigned int new_size)
 {
+	if (new_size == 0) {
+		throw OutOfBoundsException("CacheLogger needs at least one entry");
+	}
 	MutexLocker lock(mutex);
-	if (new_size < num_entries_) {
-		num_entries_ = new_size;
-		messages_.resize(num_entries_);
+	Record *records = new Record[new_size];
+	char *  slab    = new char[(size_t)new_size * CACHE_MESSAGE_LENGTH];
+
+	unsigned int num_entries = std::min(num_entries_, new_size);
+	for (unsigned long long s = next_seqnum_ - num_entries; s < next_seqnum_; ++s) {
+		size_t from = s % max_num_entries_;
+		size_t to   = s % new_size;
+		records[to] = records_[from];
+		memcpy(&slab[to * CACHE_MESSAGE_LENGTH],
+		       &slab_[from * CACHE_MESSAGE_LENGTH],
+		       CACHE_MESSAGE_LENGTH);
 	}
+
+	delete[] records_;
+	delete[] slab_;
+	records_         = records;
+	slab_            = slab;
+	num_entries_     = num_entries;
 	max_num_entries_ = new_size;
 }
 
@@ -115,48 +184,87 @@ CacheLogger::unlock()
 	mutex->unlock();
 }
 
+/** Get ID of a component name, registering it on first use.
+ * Must be called with the mutex locked.
+ * @param component component name
+ * @return component ID
+ */
+unsigned int
+CacheLogger::component_id(const char *component)
+{
+	auto c = component_ids_.find(component);
+	if (c != component_ids_.end()) {
+		return c->second;
+	}
+	unsigned int id = components_.size();
+	components_.push_back(component);
+	component_ids_[component] = id;
+	return id;
+}
+
+/** Claim the slot for a new message.
+ * Must be called with the mutex locked. The oldest message is
+ * overwritten if the cache is full.
+ * @param ll log level
+ * @param t time of the message
+ * @param component component name
+ * @return message buffer of CACHE_MESSAGE_LENGTH bytes for the slot
+ */
+char *
+CacheLogger::claim(LogLevel ll, struct timeval *t, const char *component)
+{
+	size_t  idx = next_seqnum_ % max_num_entries_;
+	Record &r   = records_[idx];
+	r.level     = ll;
+	r.time      = *t;
+	r.component = component_id(component);
+
+	++next_seqnum_;
+	if (num_entries_ < max_num_entries_) {
+		++num_entries_;
+	}
+	return &slab_[idx * CACHE_MESSAGE_LENGTH];
+}
+
+/** Format a cached message.
+ * Must be called with the mutex locked.
+ * @param seqnum sequence number of a message in the cache
+ * @return cache entry
+ */
+CacheLogger::CacheEntry
+CacheLogger::entry(unsigned long long seqnum) const
+{
+	size_t        idx = seqnum % max_num_entries_;
+	const Record &r   = records_[idx];
+
+	struct ::tm now_s;
+	localtime_r(&r.time.tv_sec, &now_s);
+	char timestr[32];
+	snprintf(timestr,
+	         sizeof(timestr),
+	         "%02d:%02d:%02d.%06ld",
+	         now_s.tm_hour,
+	         now_s.tm_min,
+	         now_s.tm_sec,
+	         (long)r.time.tv_usec);
+
+	CacheEntry e;
+	e.seqnum    = seqnum;
+	e.log_level = r.level;
+	e.component = components_[r.component];
+	e.time      = r.time;
+	e.timestr   = timestr;
+	e.message   = &slab_[idx * CACHE_MESSAGE_LENGTH];
+	return e;
+}
+
 void
 CacheLogger::push_message(LogLevel ll, const char *component, const char *format, va_list va)
 {
 	if (log_level <= ll) {
-		MutexLocker    lock(mutex);
 		struct timeval now;
 		gettimeofday(&now, NULL);
-		localtime_r(&now.tv_sec, now_s);
-		char *timestr;
-		if (asprintf(&timestr,
-		             "%02d:%02d:%02d.%06ld",
-		             now_s->tm_hour,
-		             now_s->tm_min,
-		             now_s->tm_sec,
-		             now.tv_usec)
-		    == -1) {
-			// Cannot do anything useful, drop log message
-			return;
-		}
-		char *msg;
-		if (vasprintf(&msg, format, va) == -1) {
-			// Cannot do anything useful, drop log message
-			free(timestr);
-			return;
-		}
-
-		CacheEntry e;
-		e.log_level = ll;
-		e.component = component;
-		e.time      = now;
-		e.timestr   = timestr;
-		e.message   = msg;
-		messages_.push_front(e);
-
-		free(timestr);
-		free(msg);
-
-		if (num_entries_ == max_num_entries_) {
-			messages_.pop_back();
-		} else {
-			++num_entries_;
-		}
+		tlog_push_message(ll, &now, component, format, va);
 	}
 }
 
@@ -164,38 +272,9 @@ void
 CacheLogger::push_message(LogLevel ll, const char *component, Exception &e)
 {
 	if (log_level <= ll) {
-		MutexLocker    lock(mutex);
 		struct timeval now;
 		gettimeofday(&now, NULL);
-		localtime_r(&now.tv_sec, now_s);
-		char *timestr;
-		if (asprintf(&timestr,
-		             "%02d:%02d:%02d.%06ld",
-		             now_s->tm_hour,
-		             now_s->tm_min,
-		             now_s->tm_sec,
-		             now.tv_usec)
-		    == -1) {
-			return;
-		}
-
-		for (Exception::iterator i = e.begin(); i != e.end(); ++i) {
-			CacheEntry ce;
-			ce.log_level = ll;
-			ce.component = component;
-			ce.time      = now;
-			ce.timestr   = timestr;
-			ce.message   = std::string("[EXCEPTION] ") + *i;
-			messages_.push_front(ce);
-			++num_entries_;
-		}
-
-		free(timestr);
-
-		if (num_entries_ > max_num_entries_) {
-			num_entries_ = max_num_entries_;
-			messages_.resize(max_num_entries_);
-		}
+		tlog_push_message(ll, &now, component, e);
 	}
 }
 
@@ -292,40 +371,8 @@ CacheLogger::tlog_push_message(LogLevel        ll,
 {
 	if (log_level <= ll) {
 		MutexLocker lock(mutex);
-		localtime_r(&t->tv_sec, now_s);
-		char *timestr;
-		if (asprintf(&timestr,
-		             "%02d:%02d:%02d.%06ld",
-		             now_s->tm_hour,
-		             now_s->tm_min,
-		             now_s->tm_sec,
-		             t->tv_usec)
-		    == -1) {
-			return;
-		}
-		char *msg;
-		if (vasprintf(&msg, format, va) == -1) {
-			free(timestr);
-			return;
-		}
-
-		CacheEntry e;
-		e.log_level = ll;
-		e.component = component;
-		e.time      = *t;
-		e.timestr   = timestr;
-		e.message   = msg;
-		messages_.push_front(e);
-
-		free(timestr);
-		free(msg);
-
-		if (num_entries_ == max_num_entries_) {
-			messages_.pop_back();
-		} else {
-			++num_entries_;
-		}
-		mutex->unlock();
+		char *      msg = claim(ll, t, component);
+		vsnprintf(msg, CACHE_MESSAGE_LENGTH, format, va);
 	}
 }
 
@@ -334,33 +381,9 @@ CacheLogger::tlog_push_message(LogLevel ll, struct timeval *t, const char *compo
 {
 	if (log_level <= ll) {
 		MutexLocker lock(mutex);
-		localtime_r(&t->tv_sec, now_s);
-		char *timestr;
-		if (asprintf(&timestr,
-		             "%02d:%02d:%02d.%06ld",
-		             now_s->tm_hour,
-		             now_s->tm_min,
-		             now_s->tm_sec,
-		             t->tv_usec)
-		    == -1) {
-			return;
-		}
 		for (Exception::iterator i = e.begin(); i != e.end(); ++i) {
-			CacheEntry ce;
-			ce.log_level = ll;
-			ce.component = component;
-			ce.time      = *t;
-			ce.timestr   = timestr;
-			ce.message   = std::string("[EXCEPTION] ") + *i;
-			messages_.push_front(ce);
-			++num_entries_;
-		}
-
-		free(timestr);
-
-		if (num_entries_ > max_num_entries_) {
-			num_entries_ = max_num_entries_;
-			messages_.resize(max_num_entries_);
+			char *msg = claim(ll, t, component);
+			snprintf(msg, CACHE_MESSAGE_LENGTH, "[EXCEPTION] %s", *i);
 		}
 	}
 }
@@ -27,13 +27,19 @@
 #include <logging/logger.h>
 
 #include <ctime>
+#include <functional>
 #include <list>
+#include <map>
 #include <string>
+#include <vector>
 
 namespace fawkes {
 
 class Mutex;
 
+/** Maximum length of a cached message, including the terminating zero. */
+#define CACHE_MESSAGE_LENGTH 512
+
 class CacheLogger : public Logger
 {
 public:
@@ -75,17 +81,17 @@ public:
 	/** Cache entry struct. */
 	typedef struct
 	{
-		LogLevel       log_level; /**< log level */
-		std::string    component; /**< component */
-		struct timeval time;      /**< raw time */
-		std::string    timestr;   /**< Time encoded as string */
-		std::string    message;   /**< Message */
+		unsigned long long seqnum;    /**< sequence number */
+		LogLevel           log_level; /**< log level */
+		std::string        component; /**< component */
+		struct timeval     time;      /**< raw time */
+		std::string        timestr;   /**< Time encoded as string */
+		std::string        message;   /**< Message */
 	} CacheEntry;
 
-	/** Get messages.
-   * @return reference to message list
-   */
 	std::list<CacheEntry> &get_messages();
+	unsigned long long     get_messages_since(unsigned long long       seqnum,
+	                                      std::vector<CacheEntry> &entries);
 
 	/** Clear messages. */
 	void clear();
@@ -97,6 +103,19 @@ public:
 	void unlock();
 
 private:
+	/// @cond INTERNALS
+	struct Record
+	{
+		struct timeval time;
+		LogLevel       level;
+		unsigned int   component;
+	};
+	/// @endcond
+
+	unsigned int component_id(const char *component);
+	char *       claim(LogLevel ll, struct timeval *t, const char *component);
+	CacheEntry   entry(unsigned long long seqnum) const;
+
 	void push_message(LogLevel ll, const char *component, const char *format, va_list va);
 	void push_message(LogLevel ll, const char *component, Exception &e);
 	void tlog_push_message(LogLevel        ll,
@@ -107,12 +126,18 @@ private:
 	void tlog_push_message(LogLevel ll, struct timeval *t, const char *component, Exception &);
 
 private:
-	struct ::tm *now_s;
-	Mutex *      mutex;
+	Mutex *mutex;
+
+	Record *           records_;
+	char *             slab_;
+	unsigned long long next_seqnum_;
+	unsigned int       num_entries_;
+	unsigned int       max_num_entries_;
+
+	std::vector<std::string>                         components_;
+	std::map<std::string, unsigned int, std::less<>> component_ids_;
 
 	std::list<CacheEntry> messages_;
-	unsigned int          num_entries_;
-	unsigned int          max_num_entries_;
 };
 
 } // end namespace fawkes
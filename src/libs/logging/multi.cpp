@@ -25,31 +25,182 @@
 #include <core/utils/lock_list.h>
 #include <logging/logger.h>
 #include <logging/multi.h>
+#include <semaphore.h>
 #include <sys/time.h>
 
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
 #include <time.h>
 
 namespace fawkes {
 
 /// @cond INTERNALS
+#define ASYNC_COMPONENT_LENGTH 64
+#define ASYNC_MESSAGE_LENGTH 1024
+
 class MultiLoggerData
 {
 public:
+	/* One slot of the message ring. The sequence number tells whether the
+	 * slot is free for the producer claiming position pos (seq == pos) or
+	 * holds a published message for the consumer (seq == pos + 1). */
+	struct AsyncMessage
+	{
+		std::atomic<size_t> seq;
+		Logger::LogLevel    level;
+		struct timeval      time;
+		char                component[ASYNC_COMPONENT_LENGTH];
+		char                message[ASYNC_MESSAGE_LENGTH];
+		bool                skip;
+	};
+
 	MultiLoggerData()
 	{
-		mutex = new Mutex();
+		mutex         = new Mutex();
+		ring          = NULL;
+		ring_mask     = 0;
+		enqueue_pos   = 0;
+		dequeue_pos   = 0;
+		async         = false;
+		dropped       = 0;
+		dropped_shown = 0;
+		sem_init(&wakeup, 0, 0);
 	}
 
 	~MultiLoggerData()
 	{
+		delete[] ring;
+		sem_destroy(&wakeup);
 		delete mutex;
 		mutex = NULL;
 	}
 
+	/* Claim a slot and format the message directly into it. Lock-free,
+	 * safe to call from any number of threads. If the ring is full, the
+	 * message is dropped and counted. Returns false if the message is
+	 * longer than a slot, the slot is then published empty and the
+	 * message must be logged synchronously. */
+	bool
+	push(Logger::LogLevel level,
+	     struct timeval * t,
+	     const char *     component,
+	     const char *     format,
+	     va_list          va)
+	{
+		AsyncMessage *slot;
+		size_t        pos = enqueue_pos.load(std::memory_order_relaxed);
+		for (;;) {
+			slot          = &ring[pos & ring_mask];
+			size_t   seq  = slot->seq.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0) {
+				if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			} else {
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->level = level;
+		if (t) {
+			slot->time = *t;
+		} else {
+			gettimeofday(&slot->time, NULL);
+		}
+		strncpy(slot->component, component ? component : "", ASYNC_COMPONENT_LENGTH - 1);
+		slot->component[ASYNC_COMPONENT_LENGTH - 1] = 0;
+		va_list vac;
+		va_copy(vac, va);
+		int len = vsnprintf(slot->message, ASYNC_MESSAGE_LENGTH, format, vac);
+		va_end(vac);
+		slot->skip = (len < 0 || len >= ASYNC_MESSAGE_LENGTH);
+		slot->seq.store(pos + 1, std::memory_order_release);
+
+		sem_post(&wakeup);
+		return !slot->skip;
+	}
+
+	/* Pass all queued messages to the sub-loggers. Must be called with
+	 * the mutex locked, which makes the caller the only consumer. */
+	void
+	flush_queue()
+	{
+		if (!ring)
+			return;
+
+		for (;;) {
+			AsyncMessage *slot = &ring[dequeue_pos & ring_mask];
+			if (slot->seq.load(std::memory_order_acquire) != dequeue_pos + 1)
+				break;
+
+			if (!slot->skip) {
+				for (logit = loggers.begin(); logit != loggers.end(); ++logit) {
+					(*logit)->tlog(slot->level, &slot->time, slot->component, "%s", slot->message);
+				}
+			}
+			slot->seq.store(dequeue_pos + ring_mask + 1, std::memory_order_release);
+			++dequeue_pos;
+		}
+
+		unsigned long d = dropped.load(std::memory_order_relaxed);
+		if (d != dropped_shown) {
+			struct timeval now;
+			gettimeofday(&now, NULL);
+			for (logit = loggers.begin(); logit != loggers.end(); ++logit) {
+				(*logit)->tlog_warn(&now,
+				                    "MultiLogger",
+				                    "Log queue overflow, dropped %lu messages",
+				                    d - dropped_shown);
+			}
+			dropped_shown = d;
+		}
+	}
+
+	/* Body of the logging thread. */
+	void
+	run()
+	{
+		while (async.load()) {
+			struct timespec timeout;
+			clock_gettime(CLOCK_REALTIME, &timeout);
+			timeout.tv_nsec += 100000000;
+			if (timeout.tv_nsec >= 1000000000) {
+				timeout.tv_sec += 1;
+				timeout.tv_nsec -= 1000000000;
+			}
+			sem_timedwait(&wakeup, &timeout);
+			while (sem_trywait(&wakeup) == 0) {
+			}
+
+			mutex->lock();
+			Thread::set_cancel_state(Thread::CANCEL_DISABLED, &old_state);
+			flush_queue();
+			Thread::set_cancel_state(old_state);
+			mutex->unlock();
+		}
+	}
+
 	LockList<Logger *>           loggers;
 	LockList<Logger *>::iterator logit;
 	Mutex *                      mutex;
 	Thread::CancelState          old_state;
+
+	AsyncMessage *             ring;
+	size_t                     ring_mask;
+	std::atomic<size_t>        enqueue_pos;
+	size_t                     dequeue_pos;
+	std::atomic<bool>          async;
+	std::atomic<unsigned long> dropped;
+	unsigned long              dropped_shown;
+	sem_t                      wakeup;
+	std::thread                thread;
 };
 /// @endcond
 
@@ -67,6 +218,17 @@ public:
  * itself. If you want to take over the loggers without destroying them you
  * have to properly remove them before destroying the multi logger.
  *
+ * By default all sub-loggers are called synchronously by the logging
+ * thread. A slow sub-logger, for example a file on a network share, then
+ * delays every thread that logs. In asynchronous mode, see set_async(),
+ * messages are formatted into a pre-allocated ring buffer without taking
+ * any lock and are passed to the sub-loggers by a separate thread. If
+ * the ring is full, messages are dropped and counted. Errors and
+ * exceptions are still logged synchronously, after all queued messages,
+ * so that they are not lost if the program is about to terminate.
+ * Messages longer than 1023 characters do not fit into a ring slot and
+ * are logged synchronously as well instead of being truncated.
+ *
  * @author Tim Niemueller
  */
 
@@ -94,6 +256,7 @@ MultiLogger::MultiLogger(Logger *logger)
  */
 MultiLogger::~MultiLogger()
 {
+	set_async(false);
 	data->loggers.lock();
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		delete (*data->logit);
@@ -111,6 +274,7 @@ MultiLogger::add_logger(Logger *logger)
 {
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 	data->loggers.lock();
 	data->loggers.push_back(logger);
 	logger->set_loglevel(log_level);
@@ -129,17 +293,105 @@ MultiLogger::remove_logger(Logger *logger)
 {
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	data->loggers.remove_locked(logger);
 	Thread::set_cancel_state(data->old_state);
 	data->mutex->unlock();
 }
 
+/** Enable or disable asynchronous logging.
+ * The ring buffer is allocated the first time asynchronous logging is
+ * enabled and kept until the logger is destroyed, later calls ignore
+ * @p queue_length. When disabling, all queued messages are passed to
+ * the sub-loggers before returning. Call this during setup, messages
+ * logged concurrently to disabling may only be output on the next
+ * synchronous message.
+ * @param async true to enable asynchronous logging, false to log
+ * synchronously
+ * @param queue_length maximum number of queued messages, rounded up
+ * to the next power of two
+ */
+void
+MultiLogger::set_async(bool async, unsigned int queue_length)
+{
+	if (async == data->async.load())
+		return;
+
+	if (async) {
+		data->mutex->lock();
+		if (!data->ring) {
+			size_t size = 2;
+			while (size < queue_length)
+				size <<= 1;
+			data->ring      = new MultiLoggerData::AsyncMessage[size];
+			data->ring_mask = size - 1;
+			for (size_t i = 0; i < size; ++i) {
+				data->ring[i].seq.store(i, std::memory_order_relaxed);
+			}
+		}
+		data->mutex->unlock();
+		data->async.store(true);
+		data->thread = std::thread(&MultiLoggerData::run, data);
+	} else {
+		data->async.store(false);
+		sem_post(&data->wakeup);
+		if (data->thread.joinable())
+			data->thread.join();
+		data->mutex->lock();
+		data->flush_queue();
+		data->mutex->unlock();
+	}
+}
+
+/** Check if asynchronous logging is enabled.
+ * @return true if messages are queued and logged by a separate thread
+ */
+bool
+MultiLogger::async() const
+{
+	return data->async.load();
+}
+
+/** Get number of dropped messages.
+ * @return number of messages dropped in asynchronous mode because the
+ * queue was full
+ */
+unsigned long
+MultiLogger::dropped_messages() const
+{
+	return data->dropped.load(std::memory_order_relaxed);
+}
+
+/** Queue a message in asynchronous mode.
+ * @param level log level
+ * @param t time of the message
+ * @param component component the message originates from
+ * @param format format string
+ * @param va variadic arguments for @p format
+ * @return true if the message has been handled, false if it must be
+ * logged synchronously
+ */
+bool
+MultiLogger::enqueue(LogLevel        level,
+                     struct timeval *t,
+                     const char *    component,
+                     const char *    format,
+                     va_list         va)
+{
+	if (level >= LL_ERROR || !data->async.load(std::memory_order_acquire))
+		return false;
+	if (level < log_level)
+		return true;
+	return data->push(level, t, component, format, va);
+}
+
 void
 MultiLogger::set_loglevel(LogLevel level)
 {
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 	log_level = level;
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
@@ -154,11 +406,16 @@ MultiLogger::log(LogLevel level, const char *component, const char *format, ...)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	va_list va;
+	va_start(va, format);
+	if (enqueue(level, &now, component, format, va)) {
+		va_end(va);
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
-	va_list va;
-	va_start(va, format);
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -175,11 +432,16 @@ MultiLogger::log_debug(const char *component, const char *format, ...)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	va_list va;
+	va_start(va, format);
+	if (enqueue(LL_DEBUG, &now, component, format, va)) {
+		va_end(va);
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
-	va_list va;
-	va_start(va, format);
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -196,11 +458,16 @@ MultiLogger::log_info(const char *component, const char *format, ...)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	va_list va;
+	va_start(va, format);
+	if (enqueue(LL_INFO, &now, component, format, va)) {
+		va_end(va);
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
-	va_list va;
-	va_start(va, format);
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -217,11 +484,16 @@ MultiLogger::log_warn(const char *component, const char *format, ...)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	va_list va;
+	va_start(va, format);
+	if (enqueue(LL_WARN, &now, component, format, va)) {
+		va_end(va);
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
-	va_list va;
-	va_start(va, format);
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -238,11 +510,16 @@ MultiLogger::log_error(const char *component, const char *format, ...)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	va_list va;
+	va_start(va, format);
+	if (enqueue(LL_ERROR, &now, component, format, va)) {
+		va_end(va);
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
-	va_list va;
-	va_start(va, format);
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -261,6 +538,7 @@ MultiLogger::log(LogLevel level, const char *component, Exception &e)
 	gettimeofday(&now, NULL);
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->log(level, component, e);
@@ -276,6 +554,7 @@ MultiLogger::log_debug(const char *component, Exception &e)
 	gettimeofday(&now, NULL);
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->tlog_debug(&now, component, e);
@@ -292,6 +571,7 @@ MultiLogger::log_info(const char *component, Exception &e)
 	gettimeofday(&now, NULL);
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->tlog_info(&now, component, e);
@@ -307,6 +587,7 @@ MultiLogger::log_warn(const char *component, Exception &e)
 	gettimeofday(&now, NULL);
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->tlog_warn(&now, component, e);
@@ -322,6 +603,7 @@ MultiLogger::log_error(const char *component, Exception &e)
 	gettimeofday(&now, NULL);
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->tlog_error(&now, component, e);
@@ -335,8 +617,12 @@ MultiLogger::vlog(LogLevel level, const char *component, const char *format, va_
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	if (enqueue(level, &now, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -353,8 +639,12 @@ MultiLogger::vlog_debug(const char *component, const char *format, va_list va)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	if (enqueue(LL_DEBUG, &now, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -371,8 +661,12 @@ MultiLogger::vlog_info(const char *component, const char *format, va_list va)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	if (enqueue(LL_INFO, &now, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -389,8 +683,12 @@ MultiLogger::vlog_warn(const char *component, const char *format, va_list va)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	if (enqueue(LL_WARN, &now, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -407,8 +705,12 @@ MultiLogger::vlog_error(const char *component, const char *format, va_list va)
 {
 	struct timeval now;
 	gettimeofday(&now, NULL);
+	if (enqueue(LL_ERROR, &now, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -423,10 +725,15 @@ MultiLogger::vlog_error(const char *component, const char *format, va_list va)
 void
 MultiLogger::tlog(LogLevel level, struct timeval *t, const char *component, const char *format, ...)
 {
-	data->mutex->lock();
-	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
 	va_list va;
 	va_start(va, format);
+	if (enqueue(level, t, component, format, va)) {
+		va_end(va);
+		return;
+	}
+	data->mutex->lock();
+	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -441,10 +748,15 @@ MultiLogger::tlog(LogLevel level, struct timeval *t, const char *component, cons
 void
 MultiLogger::tlog_debug(struct timeval *t, const char *component, const char *format, ...)
 {
-	data->mutex->lock();
-	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
 	va_list va;
 	va_start(va, format);
+	if (enqueue(LL_DEBUG, t, component, format, va)) {
+		va_end(va);
+		return;
+	}
+	data->mutex->lock();
+	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -459,11 +771,16 @@ MultiLogger::tlog_debug(struct timeval *t, const char *component, const char *fo
 void
 MultiLogger::tlog_info(struct timeval *t, const char *component, const char *format, ...)
 {
+	va_list va;
+	va_start(va, format);
+	if (enqueue(LL_INFO, t, component, format, va)) {
+		va_end(va);
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
-	va_list va;
-	va_start(va, format);
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -478,11 +795,16 @@ MultiLogger::tlog_info(struct timeval *t, const char *component, const char *for
 void
 MultiLogger::tlog_warn(struct timeval *t, const char *component, const char *format, ...)
 {
+	va_list va;
+	va_start(va, format);
+	if (enqueue(LL_WARN, t, component, format, va)) {
+		va_end(va);
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
-	va_list va;
-	va_start(va, format);
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -497,11 +819,16 @@ MultiLogger::tlog_warn(struct timeval *t, const char *component, const char *for
 void
 MultiLogger::tlog_error(struct timeval *t, const char *component, const char *format, ...)
 {
+	va_list va;
+	va_start(va, format);
+	if (enqueue(LL_ERROR, t, component, format, va)) {
+		va_end(va);
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
-	va_list va;
-	va_start(va, format);
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
 		va_copy(vac, va);
@@ -518,6 +845,7 @@ MultiLogger::tlog(LogLevel level, struct timeval *t, const char *component, Exce
 {
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->tlog(level, t, component, e);
@@ -539,6 +867,7 @@ MultiLogger::tlog_info(struct timeval *t, const char *component, Exception &e)
 {
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->tlog_error(t, component, e);
@@ -552,6 +881,7 @@ MultiLogger::tlog_warn(struct timeval *t, const char *component, Exception &e)
 {
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->tlog_error(t, component, e);
@@ -565,6 +895,7 @@ MultiLogger::tlog_error(struct timeval *t, const char *component, Exception &e)
 {
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		(*data->logit)->tlog_error(t, component, e);
@@ -580,8 +911,12 @@ MultiLogger::vtlog(LogLevel        level,
                    const char *    format,
                    va_list         va)
 {
+	if (enqueue(level, t, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -596,8 +931,12 @@ MultiLogger::vtlog(LogLevel        level,
 void
 MultiLogger::vtlog_debug(struct timeval *t, const char *component, const char *format, va_list va)
 {
+	if (enqueue(LL_DEBUG, t, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -612,8 +951,12 @@ MultiLogger::vtlog_debug(struct timeval *t, const char *component, const char *f
 void
 MultiLogger::vtlog_info(struct timeval *t, const char *component, const char *format, va_list va)
 {
+	if (enqueue(LL_INFO, t, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -628,8 +971,12 @@ MultiLogger::vtlog_info(struct timeval *t, const char *component, const char *fo
 void
 MultiLogger::vtlog_warn(struct timeval *t, const char *component, const char *format, va_list va)
 {
+	if (enqueue(LL_WARN, t, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -644,8 +991,12 @@ MultiLogger::vtlog_warn(struct timeval *t, const char *component, const char *fo
 void
 MultiLogger::vtlog_error(struct timeval *t, const char *component, const char *format, va_list va)
 {
+	if (enqueue(LL_ERROR, t, component, format, va)) {
+		return;
+	}
 	data->mutex->lock();
 	Thread::set_cancel_state(Thread::CANCEL_DISABLED, &(data->old_state));
+	data->flush_queue();
 
 	for (data->logit = data->loggers.begin(); data->logit != data->loggers.end(); ++data->logit) {
 		va_list vac;
@@ -41,6 +41,10 @@ public:
 	void add_logger(Logger *logger);
 	void remove_logger(Logger *logger);
 
+	void          set_async(bool async, unsigned int queue_length = 1024);
+	bool          async() const;
+	unsigned long dropped_messages() const;
+
 	virtual void set_loglevel(LogLevel level);
 
 	virtual void log(LogLevel level, const char *component, const char *format, ...);
@@ -83,6 +87,13 @@ public:
 	virtual void
 	vtlog_error(struct timeval *t, const char *component, const char *format, va_list va);
 
+private:
+	bool enqueue(LogLevel        level,
+	             struct timeval *t,
+	             const char *    component,
+	             const char *    format,
+	             va_list         va);
+
 private:
 	MultiLoggerData *data;
 };
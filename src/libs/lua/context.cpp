@@ -27,6 +27,7 @@
 #include <logging/liblogger.h>
 #include <lua/context.h>
 #include <lua/context_watcher.h>
+#include <utils/time/time.h>
 
 #include <algorithm>
 #include <cstdlib>
@@ -69,6 +70,11 @@ LuaContext::LuaContext(bool enable_tracebacks)
 
 	lua_mutex_ = new Mutex();
 
+	gc_mode_    = GC_INCREMENTAL;
+	gc_pause_   = 0;
+	gc_stepmul_ = 0;
+	memset(&gc_stats_, 0, sizeof(gc_stats_));
+
 	start_script_ = NULL;
 	L_            = init_state();
 }
@@ -89,6 +95,10 @@ LuaContext::LuaContext(lua_State *L)
 	start_script_ = NULL;
 	fam_          = NULL;
 	fam_thread_   = NULL;
+	gc_mode_      = GC_INCREMENTAL;
+	gc_pause_     = 0;
+	gc_stepmul_   = 0;
+	memset(&gc_stats_, 0, sizeof(gc_stats_));
 }
 
 /** Destructor. */
@@ -154,6 +164,7 @@ LuaContext::init_state()
 {
 	lua_State *L = luaL_newstate();
 	luaL_openlibs(L);
+	apply_gc_mode(L);
 
 	if (enable_tracebacks_) {
 		lua_getglobal(L, "debug");
@@ -319,6 +330,83 @@ LuaContext::restart()
 	}
 }
 
+/** Set garbage collector mode.
+ * The mode is applied immediately and again on each restart.
+ * @param mode collector mode, GC_GENERATIONAL falls back to
+ * GC_INCREMENTAL if not supported by the Lua version
+ * @param pause collector pause in percent, i.e. how much memory use
+ * may grow before a new cycle is started, 0 to keep the Lua default
+ * @param stepmul collector step multiplier in percent, i.e. how much
+ * work is done per step relative to memory allocation, 0 to keep the
+ * Lua default
+ */
+void
+LuaContext::set_gc_mode(GCMode mode, int pause, int stepmul)
+{
+	MutexLocker lock(lua_mutex_);
+	gc_mode_    = mode;
+	gc_pause_   = pause;
+	gc_stepmul_ = stepmul;
+	apply_gc_mode(L_);
+}
+
+void
+LuaContext::apply_gc_mode(lua_State *L)
+{
+#ifdef LUA_GCGEN
+	lua_gc(L, (gc_mode_ == GC_GENERATIONAL) ? LUA_GCGEN : LUA_GCINC, 0);
+#else
+	if (gc_mode_ == GC_GENERATIONAL) {
+		LibLogger::log_warn("LuaContext", "Generational GC not supported, using incremental");
+	}
+#endif
+	if (gc_pause_ > 0)
+		lua_gc(L, LUA_GCSETPAUSE, gc_pause_);
+	if (gc_stepmul_ > 0)
+		lua_gc(L, LUA_GCSETSTEPMUL, gc_stepmul_);
+}
+
+/** Perform a garbage collection step.
+ * Call this at the end of a loop to do collector work at a time when it
+ * does not delay execution. Work done here is not needed anymore when
+ * Lua code allocates memory in the next loop, reducing the collector
+ * pauses during Lua execution.
+ * @param step_kb step size, the collector performs work as if this many
+ * kilobytes had been allocated
+ * @return true if the step finished a collection cycle
+ */
+bool
+LuaContext::gc_step(int step_kb)
+{
+	MutexLocker lock(lua_mutex_);
+
+	Time start;
+	bool cycle_done = (lua_gc(L_, LUA_GCSTEP, step_kb) == 1);
+	Time end;
+
+	float step_ms = (end - &start) * 1000.;
+	gc_stats_.steps += 1;
+	if (cycle_done)
+		gc_stats_.cycles += 1;
+	gc_stats_.last_step_ms = step_ms;
+	gc_stats_.total_step_ms += step_ms;
+	if (step_ms > gc_stats_.max_step_ms)
+		gc_stats_.max_step_ms = step_ms;
+	gc_stats_.memory_kb = lua_gc(L_, LUA_GCCOUNT, 0);
+
+	return cycle_done;
+}
+
+/** Get garbage collection statistics.
+ * @return statistics of steps performed with gc_step()
+ */
+LuaContext::GCStats
+LuaContext::gc_stats()
+{
+	MutexLocker lock(lua_mutex_);
+	return gc_stats_;
+}
+
 /** Add a Lua package directory.
  * The directory is added to the search path for lua packages. Files with
  * a .lua suffix will be considered as Lua modules.
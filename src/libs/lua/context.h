@@ -43,6 +43,23 @@ class Mutex;
 class LuaContext : public FamListener
 {
 public:
+	/** Garbage collector mode. */
+	typedef enum {
+		GC_INCREMENTAL, ///< incremental collector, the Lua default
+		GC_GENERATIONAL ///< generational collector, Lua 5.2 only
+	} GCMode;
+
+	/** Garbage collection statistics for gc_step(). */
+	typedef struct
+	{
+		unsigned int steps;         ///< number of steps performed
+		unsigned int cycles;        ///< number of steps which finished a cycle
+		float        last_step_ms;  ///< duration of the most recent step in ms
+		float        max_step_ms;   ///< duration of the longest step in ms
+		float        total_step_ms; ///< sum of all step durations in ms
+		unsigned int memory_kb;     ///< memory in use by Lua after the last step
+	} GCStats;
+
 	LuaContext(bool enable_tracebacks = true);
 	LuaContext(lua_State *L);
 	~LuaContext();
@@ -57,6 +74,10 @@ public:
 
 	void restart();
 
+	void    set_gc_mode(GCMode mode, int pause = 0, int stepmul = 0);
+	bool    gc_step(int step_kb);
+	GCStats gc_stats();
+
 	void add_package_dir(const char *path, bool prefix = false);
 	void add_cpackage_dir(const char *path, bool prefix = false);
 	void add_package(const char *package);
@@ -148,6 +169,7 @@ public:
 
 private:
 	lua_State *init_state();
+	void       apply_gc_mode(lua_State *L);
 	void       do_string(lua_State *L, const char *format, ...);
 	void       do_file(lua_State *L, const char *s);
 	void       assert_unique_name(const char *name, std::string type);
@@ -186,6 +208,11 @@ private:
 	FamThread *                   fam_thread_;
 
 	LockList<LuaContextWatcher *> watchers_;
+
+	GCMode  gc_mode_;
+	int     gc_pause_;
+	int     gc_stepmul_;
+	GCStats gc_stats_;
 };
 
 } // end of namespace fawkes
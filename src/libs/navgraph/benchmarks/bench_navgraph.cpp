@@ -0,0 +1,85 @@
+
+/***************************************************************************
+ *  bench_navgraph.cpp - Navgraph path search microbenchmarks
+ *
+ *  Created: Thu Oct 15 07:45:06 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <benchmark/benchmark.h>
+#include <navgraph/navgraph.h>
+
+#include <string>
+
+using namespace fawkes;
+
+static std::string
+grid_node_name(int x, int y)
+{
+	return "N_" + std::to_string(x) + "_" + std::to_string(y);
+}
+
+// Search a path from one corner to the opposite corner of a grid graph
+// with the given number of nodes per side.
+static void
+BM_NavGraphSearchPath(benchmark::State &state)
+{
+	const int size = state.range(0);
+
+	NavGraph graph("benchmark");
+	graph.set_notifications_enabled(false);
+	for (int x = 0; x < size; ++x) {
+		for (int y = 0; y < size; ++y) {
+			graph.add_node(NavGraphNode(grid_node_name(x, y), x, y));
+		}
+	}
+	for (int x = 0; x < size; ++x) {
+		for (int y = 0; y < size; ++y) {
+			if (x + 1 < size) {
+				graph.add_edge(NavGraphEdge(grid_node_name(x, y), grid_node_name(x + 1, y)),
+				               NavGraph::EDGE_FORCE);
+			}
+			if (y + 1 < size) {
+				graph.add_edge(NavGraphEdge(grid_node_name(x, y), grid_node_name(x, y + 1)),
+				               NavGraph::EDGE_FORCE);
+			}
+		}
+	}
+	graph.calc_reachability();
+	graph.set_search_table_max_nodes(state.range(1) ? size * size : 0);
+
+	const std::string from = grid_node_name(0, 0);
+	const std::string to   = grid_node_name(size - 1, size - 1);
+	// first search computes the search table if enabled
+	graph.search_path(from, to);
+
+	for (auto _ : state) {
+		NavGraphPath path = graph.search_path(from, to);
+		benchmark::DoNotOptimize(path);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NavGraphSearchPath)
+  ->ArgNames({"size", "search_table"})
+  ->ArgsProduct({{8, 32}, {0, 1}});
+
+BENCHMARK_MAIN();
+
+/// @endcond
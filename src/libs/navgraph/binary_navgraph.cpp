@@ -0,0 +1,776 @@
+
+/***************************************************************************
+ *  binary_navgraph.cpp - Nav graph stored in a compact binary file
+ *
+ *  Created: Thu Oct 15 09:18:10 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/exceptions/software.h>
+#include <core/exceptions/system.h>
+#include <navgraph/binary_navgraph.h>
+#include <navgraph/navgraph.h>
+#include <navgraph/yaml_navgraph.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+namespace {
+
+const char     BINARY_NAVGRAPH_MAGIC[4]    = {'F', 'F', 'N', 'G'};
+const uint32_t BINARY_NAVGRAPH_VERSION     = 1;
+const uint32_t BINARY_NAVGRAPH_BYTE_ORDER  = 0x01020304;
+const uint32_t BINARY_NAVGRAPH_UNCONNECTED = 1;
+const uint32_t BINARY_NAVGRAPH_DIRECTED    = 1;
+
+std::string
+resolve_filename(const std::string &filename)
+{
+	//try to fix use of relative paths
+	if (filename[0] != '/') {
+		return std::string(CONFDIR) + "/" + filename;
+	}
+	return filename;
+}
+
+bool
+section_valid(size_t size, uint32_t offset, uint64_t count, size_t element_size)
+{
+	return (offset % 4 == 0) && (offset <= size) && (count * element_size <= size - offset);
+}
+
+class StringTable
+{
+public:
+	uint32_t
+	intern(const std::string &s)
+	{
+		auto i = ids.find(s);
+		if (i != ids.end()) {
+			return i->second;
+		}
+		uint32_t id = strings.size();
+		ids[s]      = id;
+		strings.push_back(s);
+		return id;
+	}
+
+	std::unordered_map<std::string, uint32_t> ids;
+	std::vector<std::string>                   strings;
+};
+
+template <typename T>
+uint32_t
+append(std::vector<char> &buffer, const T *data, size_t count)
+{
+	uint32_t offset = buffer.size();
+	buffer.insert(buffer.end(), (const char *)data, (const char *)(data + count));
+	// keep all sections 4-byte aligned
+	buffer.resize((buffer.size() + 3) & ~(size_t)3, 0);
+	return offset;
+}
+
+} // end anonymous namespace
+/// @endcond
+
+/** @class BinaryNavGraph <navgraph/binary_navgraph.h>
+ * Nav graph stored in a compact binary file.
+ * Loading large graphs from YAML is slow, the file has to be parsed
+ * completely and every node and edge is inserted with intersection
+ * checks. The binary format stores the graph as it has been loaded, i.e.
+ * after insert modes have been applied, in a form which can be used
+ * in-place after mapping the file into memory.
+ *
+ * Node names, property keys and property values are interned in a string
+ * table and referenced by index. Nodes and edges are stored as fixed-size
+ * records, the adjacency of nodes in compressed sparse row form, i.e. an
+ * offset array indexed by node pointing into a list of (neighbour, edge)
+ * pairs. Properties of nodes which equal the graph default properties are
+ * omitted. A node index sorted by name allows for lookup by name.
+ *
+ * An instance maps the file read-only and validates it once. Afterwards
+ * nodes, edges, properties and adjacency can be queried directly from the
+ * mapped file without building a NavGraph, e.g. by tools which only need
+ * a small part of the graph. Use to_navgraph() to create a full NavGraph.
+ * The file is stored in host byte order, files of a different byte order
+ * are rejected.
+ * @author agent
+ */
+
+/** Constructor.
+ * Maps and validates the file.
+ * @param filename name of the file to load, relative to the configuration
+ * directory unless it starts with a slash
+ * @exception CouldNotOpenFileException thrown if the file cannot be opened
+ * or mapped
+ * @exception Exception thrown if the file is not a valid binary navgraph
+ */
+BinaryNavGraph::BinaryNavGraph(std::string filename)
+: filename_(resolve_filename(filename)), data_(NULL), size_(0)
+{
+	int fd = open(filename_.c_str(), O_RDONLY);
+	if (fd == -1) {
+		throw CouldNotOpenFileException(filename_.c_str(), errno, "Failed to open navgraph");
+	}
+	struct stat s;
+	if (fstat(fd, &s) != 0) {
+		int err = errno;
+		close(fd);
+		throw CouldNotOpenFileException(filename_.c_str(), err, "Failed to stat navgraph");
+	}
+	if ((size_t)s.st_size < sizeof(header_t)) {
+		close(fd);
+		throw Exception("Navgraph %s is too small for a binary navgraph", filename_.c_str());
+	}
+	size_   = s.st_size;
+	data_   = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	int err = errno;
+	close(fd);
+	if (data_ == MAP_FAILED) {
+		data_ = NULL;
+		throw CouldNotOpenFileException(filename_.c_str(), err, "Failed to map navgraph");
+	}
+
+	const char *d      = (const char *)data_;
+	header_            = (const header_t *)d;
+	strings_           = (const uint32_t *)(d + header_->strings_offset);
+	string_data_       = d + header_->string_data_offset;
+	nodes_             = (const node_t *)(d + header_->nodes_offset);
+	node_index_        = (const uint32_t *)(d + header_->node_index_offset);
+	edges_             = (const edge_t *)(d + header_->edges_offset);
+	adjacency_offsets_ = (const uint32_t *)(d + header_->adjacency_offsets_offset);
+	adjacency_         = (const adjacency_t *)(d + header_->adjacency_offset);
+	properties_        = (const property_t *)(d + header_->properties_offset);
+
+	try {
+		validate();
+	} catch (Exception &e) {
+		munmap(data_, size_);
+		throw;
+	}
+}
+
+/** Destructor.
+ * Unmaps the file. Strings returned by accessors become invalid.
+ */
+BinaryNavGraph::~BinaryNavGraph()
+{
+	if (data_) {
+		munmap(data_, size_);
+	}
+}
+
+/** Check all sections and references of the mapped file.
+ * Afterwards accessors only need to check their arguments.
+ */
+void
+BinaryNavGraph::validate() const
+{
+	const char *    fn = filename_.c_str();
+	const header_t &h  = *header_;
+
+	if (memcmp(h.magic, BINARY_NAVGRAPH_MAGIC, sizeof(h.magic)) != 0) {
+		throw Exception("Navgraph %s is not a binary navgraph", fn);
+	}
+	if (h.byte_order != BINARY_NAVGRAPH_BYTE_ORDER) {
+		throw Exception("Binary navgraph %s has foreign byte order", fn);
+	}
+	if (h.version != BINARY_NAVGRAPH_VERSION) {
+		throw Exception("Binary navgraph %s has unsupported version %u (expected %u)",
+		                fn,
+		                h.version,
+		                BINARY_NAVGRAPH_VERSION);
+	}
+	if (h.file_size != size_) {
+		throw Exception("Binary navgraph %s has %zu instead of %u bytes", fn, size_, h.file_size);
+	}
+
+	if (!section_valid(size_, h.strings_offset, h.num_strings, sizeof(uint32_t))
+	    || !section_valid(size_, h.string_data_offset, h.string_data_size, 1)
+	    || !section_valid(size_, h.nodes_offset, h.num_nodes, sizeof(node_t))
+	    || !section_valid(size_, h.node_index_offset, h.num_nodes, sizeof(uint32_t))
+	    || !section_valid(size_, h.edges_offset, h.num_edges, sizeof(edge_t))
+	    || !section_valid(size_,
+	                      h.adjacency_offsets_offset,
+	                      (uint64_t)h.num_nodes + 1,
+	                      sizeof(uint32_t))
+	    || !section_valid(size_, h.adjacency_offset, h.num_adjacency, sizeof(adjacency_t))
+	    || !section_valid(size_, h.properties_offset, h.num_properties, sizeof(property_t))) {
+		throw Exception("Binary navgraph %s has invalid section bounds", fn);
+	}
+
+	if (h.string_data_size == 0 || string_data_[h.string_data_size - 1] != '\0') {
+		throw Exception("Binary navgraph %s has invalid string data", fn);
+	}
+	for (uint32_t i = 0; i < h.num_strings; ++i) {
+		if (strings_[i] >= h.string_data_size) {
+			throw Exception("Binary navgraph %s has invalid string %u", fn, i);
+		}
+	}
+	if (h.graph_name >= h.num_strings) {
+		throw Exception("Binary navgraph %s has invalid graph name", fn);
+	}
+
+	for (uint32_t i = 0; i < h.num_properties; ++i) {
+		if (properties_[i].key >= h.num_strings || properties_[i].value >= h.num_strings) {
+			throw Exception("Binary navgraph %s has invalid property %u", fn, i);
+		}
+	}
+	if ((uint64_t)h.default_props_begin + h.default_props_count > h.num_properties) {
+		throw Exception("Binary navgraph %s has invalid default properties", fn);
+	}
+
+	for (uint32_t i = 0; i < h.num_nodes; ++i) {
+		const node_t &n = nodes_[i];
+		if (n.name >= h.num_strings || node_index_[i] >= h.num_nodes
+		    || (uint64_t)n.props_begin + n.props_count > h.num_properties) {
+			throw Exception("Binary navgraph %s has invalid node %u", fn, i);
+		}
+	}
+	for (uint32_t i = 0; i < h.num_edges; ++i) {
+		const edge_t &e = edges_[i];
+		if (e.from >= h.num_nodes || e.to >= h.num_nodes
+		    || (uint64_t)e.props_begin + e.props_count > h.num_properties) {
+			throw Exception("Binary navgraph %s has invalid edge %u", fn, i);
+		}
+	}
+
+	if (adjacency_offsets_[0] != 0 || adjacency_offsets_[h.num_nodes] != h.num_adjacency) {
+		throw Exception("Binary navgraph %s has invalid adjacency", fn);
+	}
+	for (uint32_t i = 0; i < h.num_nodes; ++i) {
+		if (adjacency_offsets_[i] > adjacency_offsets_[i + 1]) {
+			throw Exception("Binary navgraph %s has invalid adjacency of node %u", fn, i);
+		}
+	}
+	for (uint32_t i = 0; i < h.num_adjacency; ++i) {
+		if (adjacency_[i].node >= h.num_nodes || adjacency_[i].edge >= h.num_edges) {
+			throw Exception("Binary navgraph %s has invalid adjacency entry %u", fn, i);
+		}
+	}
+}
+
+const char *
+BinaryNavGraph::string(uint32_t s) const
+{
+	return string_data_ + strings_[s];
+}
+
+const char *
+BinaryNavGraph::find_property(uint32_t begin, uint32_t count, const char *key) const
+{
+	for (uint32_t i = begin; i < begin + count; ++i) {
+		if (strcmp(string(properties_[i].key), key) == 0) {
+			return string(properties_[i].value);
+		}
+	}
+	return NULL;
+}
+
+std::map<std::string, std::string>
+BinaryNavGraph::properties(uint32_t begin, uint32_t count) const
+{
+	std::map<std::string, std::string> rv;
+	for (uint32_t i = begin; i < begin + count; ++i) {
+		rv[string(properties_[i].key)] = string(properties_[i].value);
+	}
+	return rv;
+}
+
+const BinaryNavGraph::node_t *
+BinaryNavGraph::node(unsigned int node) const
+{
+	if (node >= header_->num_nodes) {
+		throw OutOfBoundsException("Invalid node index", node, 0, header_->num_nodes);
+	}
+	return &nodes_[node];
+}
+
+const BinaryNavGraph::edge_t *
+BinaryNavGraph::edge(unsigned int edge) const
+{
+	if (edge >= header_->num_edges) {
+		throw OutOfBoundsException("Invalid edge index", edge, 0, header_->num_edges);
+	}
+	return &edges_[edge];
+}
+
+/** Get graph name.
+ * @return graph name
+ */
+const char *
+BinaryNavGraph::name() const
+{
+	return string(header_->graph_name);
+}
+
+/** Get number of nodes.
+ * @return number of nodes
+ */
+unsigned int
+BinaryNavGraph::num_nodes() const
+{
+	return header_->num_nodes;
+}
+
+/** Get number of edges.
+ * @return number of edges
+ */
+unsigned int
+BinaryNavGraph::num_edges() const
+{
+	return header_->num_edges;
+}
+
+/** Find node by name.
+ * @param name name of the node
+ * @return index of the node, or -1 if no such node exists
+ */
+int
+BinaryNavGraph::find_node(const char *name) const
+{
+	const uint32_t *end = node_index_ + header_->num_nodes;
+	const uint32_t *n =
+	  std::lower_bound(node_index_, end, name, [this](uint32_t i, const char *nm) {
+		  return strcmp(string(nodes_[i].name), nm) < 0;
+	  });
+	if (n != end && strcmp(string(nodes_[*n].name), name) == 0) {
+		return *n;
+	}
+	return -1;
+}
+
+/** Get name of node.
+ * @param node index of the node
+ * @return name of the node
+ */
+const char *
+BinaryNavGraph::node_name(unsigned int node) const
+{
+	return string(this->node(node)->name);
+}
+
+/** Get X coordinate of node.
+ * @param node index of the node
+ * @return X coordinate of the node
+ */
+float
+BinaryNavGraph::node_x(unsigned int node) const
+{
+	return this->node(node)->x;
+}
+
+/** Get Y coordinate of node.
+ * @param node index of the node
+ * @return Y coordinate of the node
+ */
+float
+BinaryNavGraph::node_y(unsigned int node) const
+{
+	return this->node(node)->y;
+}
+
+/** Check if node is unconnected.
+ * @param node index of the node
+ * @return true if the node is marked unconnected
+ */
+bool
+BinaryNavGraph::node_unconnected(unsigned int node) const
+{
+	return this->node(node)->flags & BINARY_NAVGRAPH_UNCONNECTED;
+}
+
+/** Get property of node.
+ * Falls back to the default properties of the graph.
+ * @param node index of the node
+ * @param key property key
+ * @return property value, or NULL if the node does not have the property
+ */
+const char *
+BinaryNavGraph::node_property(unsigned int node, const char *key) const
+{
+	const node_t *n = this->node(node);
+	const char *  v = find_property(n->props_begin, n->props_count, key);
+	if (!v) {
+		v = find_property(header_->default_props_begin, header_->default_props_count, key);
+	}
+	return v;
+}
+
+/** Get properties of node.
+ * Includes the default properties of the graph.
+ * @param node index of the node
+ * @return property map
+ */
+std::map<std::string, std::string>
+BinaryNavGraph::node_properties(unsigned int node) const
+{
+	const node_t *                     n  = this->node(node);
+	std::map<std::string, std::string> rv = properties(n->props_begin, n->props_count);
+	for (const auto &p : properties(header_->default_props_begin, header_->default_props_count)) {
+		rv.insert(p);
+	}
+	return rv;
+}
+
+/** Get number of nodes adjacent to a node.
+ * These are the nodes directly reachable from the given node.
+ * @param node index of the node
+ * @return number of adjacent nodes
+ */
+unsigned int
+BinaryNavGraph::num_adjacent(unsigned int node) const
+{
+	this->node(node);
+	return adjacency_offsets_[node + 1] - adjacency_offsets_[node];
+}
+
+/** Get adjacent node.
+ * @param node index of the node
+ * @param i index of the adjacency, 0 <= i < num_adjacent(node)
+ * @return index of the adjacent node
+ */
+unsigned int
+BinaryNavGraph::adjacent_node(unsigned int node, unsigned int i) const
+{
+	if (i >= num_adjacent(node)) {
+		throw OutOfBoundsException("Invalid adjacency index", i, 0, num_adjacent(node));
+	}
+	return adjacency_[adjacency_offsets_[node] + i].node;
+}
+
+/** Get edge to adjacent node.
+ * @param node index of the node
+ * @param i index of the adjacency, 0 <= i < num_adjacent(node)
+ * @return index of the edge connecting the node and the adjacent node
+ */
+unsigned int
+BinaryNavGraph::adjacent_edge(unsigned int node, unsigned int i) const
+{
+	if (i >= num_adjacent(node)) {
+		throw OutOfBoundsException("Invalid adjacency index", i, 0, num_adjacent(node));
+	}
+	return adjacency_[adjacency_offsets_[node] + i].edge;
+}
+
+/** Get originating node of edge.
+ * @param edge index of the edge
+ * @return index of the originating node
+ */
+unsigned int
+BinaryNavGraph::edge_from(unsigned int edge) const
+{
+	return this->edge(edge)->from;
+}
+
+/** Get target node of edge.
+ * @param edge index of the edge
+ * @return index of the target node
+ */
+unsigned int
+BinaryNavGraph::edge_to(unsigned int edge) const
+{
+	return this->edge(edge)->to;
+}
+
+/** Check if edge is directed.
+ * @param edge index of the edge
+ * @return true if the edge is directed, false if it is bidirectional
+ */
+bool
+BinaryNavGraph::edge_directed(unsigned int edge) const
+{
+	return this->edge(edge)->flags & BINARY_NAVGRAPH_DIRECTED;
+}
+
+/** Get property of edge.
+ * @param edge index of the edge
+ * @param key property key
+ * @return property value, or NULL if the edge does not have the property
+ */
+const char *
+BinaryNavGraph::edge_property(unsigned int edge, const char *key) const
+{
+	const edge_t *e = this->edge(edge);
+	return find_property(e->props_begin, e->props_count, key);
+}
+
+/** Get properties of edge.
+ * @param edge index of the edge
+ * @return property map
+ */
+std::map<std::string, std::string>
+BinaryNavGraph::edge_properties(unsigned int edge) const
+{
+	const edge_t *e = this->edge(edge);
+	return properties(e->props_begin, e->props_count);
+}
+
+/** Create navgraph.
+ * The nodes and edges are added as stored, insert modes have already
+ * been applied when the file was written.
+ * @param allow_multi_graph if true, allows multiple disconnected graph segments.
+ * @return newly created navgraph, the caller takes ownership
+ */
+NavGraph *
+BinaryNavGraph::to_navgraph(bool allow_multi_graph) const
+{
+	NavGraph *graph = new NavGraph(name());
+	try {
+		graph->set_notifications_enabled(false);
+		graph->set_default_properties(
+		  properties(header_->default_props_begin, header_->default_props_count));
+
+		for (uint32_t i = 0; i < header_->num_nodes; ++i) {
+			const node_t &n = nodes_[i];
+			NavGraphNode  node(string(n.name), n.x, n.y, properties(n.props_begin, n.props_count));
+			node.set_unconnected(n.flags & BINARY_NAVGRAPH_UNCONNECTED);
+			graph->add_node(node);
+		}
+
+		for (uint32_t i = 0; i < header_->num_edges; ++i) {
+			const edge_t &e = edges_[i];
+			NavGraphEdge  edge(string(nodes_[e.from].name),
+                        string(nodes_[e.to].name),
+                        properties(e.props_begin, e.props_count),
+                        e.flags & BINARY_NAVGRAPH_DIRECTED);
+			graph->add_edge(edge, NavGraph::EDGE_FORCE);
+		}
+
+		graph->calc_reachability(allow_multi_graph);
+		graph->set_notifications_enabled(true);
+	} catch (Exception &e) {
+		delete graph;
+		throw;
+	}
+	return graph;
+}
+
+/** Check if file is a binary navgraph.
+ * Only checks the magic token at the start of the file.
+ * @param filename name of the file to check, relative to the configuration
+ * directory unless it starts with a slash
+ * @return true if the file is a binary navgraph, false if it is not or
+ * cannot be read
+ */
+bool
+BinaryNavGraph::is_binary_navgraph(std::string filename)
+{
+	filename = resolve_filename(filename);
+	FILE *f  = fopen(filename.c_str(), "rb");
+	if (!f) {
+		return false;
+	}
+	char magic[sizeof(BINARY_NAVGRAPH_MAGIC)];
+	bool rv = (fread(magic, sizeof(magic), 1, f) == 1)
+	          && (memcmp(magic, BINARY_NAVGRAPH_MAGIC, sizeof(magic)) == 0);
+	fclose(f);
+	return rv;
+}
+
+/** Load navgraph from binary file.
+ * @param filename name of the file to load, relative to the configuration
+ * directory unless it starts with a slash
+ * @param allow_multi_graph if true, allows multiple disconnected graph segments.
+ * @return loaded navgraph
+ */
+NavGraph *
+load_binary_navgraph(std::string filename, bool allow_multi_graph)
+{
+	BinaryNavGraph bg(filename);
+	return bg.to_navgraph(allow_multi_graph);
+}
+
+/** Load navgraph from binary or YAML file.
+ * The format is determined from the file content.
+ * @param filename name of the file to load, relative to the configuration
+ * directory unless it starts with a slash
+ * @param allow_multi_graph if true, allows multiple disconnected graph segments.
+ * @return loaded navgraph
+ */
+NavGraph *
+load_navgraph(std::string filename, bool allow_multi_graph)
+{
+	if (BinaryNavGraph::is_binary_navgraph(filename)) {
+		return load_binary_navgraph(filename, allow_multi_graph);
+	} else {
+		return load_yaml_navgraph(filename, allow_multi_graph);
+	}
+}
+
+/** Save navgraph to binary file.
+ * The file is written to a temporary file first and then renamed, such
+ * that processes which have the previous version mapped are not affected.
+ * @param filename name of file to save to, relative to the configuration
+ * directory unless it starts with a slash
+ * @param graph graph to save
+ */
+void
+save_binary_navgraph(std::string filename, NavGraph *graph)
+{
+	typedef BinaryNavGraph::header_t    header_t;
+	typedef BinaryNavGraph::node_t      node_t;
+	typedef BinaryNavGraph::edge_t      edge_t;
+	typedef BinaryNavGraph::adjacency_t adjacency_t;
+	typedef BinaryNavGraph::property_t  property_t;
+
+	filename = resolve_filename(filename);
+
+	const std::vector<NavGraphNode> &         nodes     = graph->nodes();
+	const std::vector<NavGraphEdge> &         edges     = graph->edges();
+	const std::map<std::string, std::string> &def_props = graph->default_properties();
+
+	StringTable             strings;
+	std::vector<property_t> properties;
+
+	header_t h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, BINARY_NAVGRAPH_MAGIC, sizeof(h.magic));
+	h.version    = BINARY_NAVGRAPH_VERSION;
+	h.byte_order = BINARY_NAVGRAPH_BYTE_ORDER;
+	h.graph_name = strings.intern(graph->name());
+
+	h.default_props_begin = properties.size();
+	for (const auto &p : def_props) {
+		properties.push_back({strings.intern(p.first), strings.intern(p.second)});
+	}
+	h.default_props_count = def_props.size();
+
+	std::unordered_map<std::string, uint32_t> node_ids;
+	std::vector<node_t>                       bnodes(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		const NavGraphNode &n = nodes[i];
+		node_ids[n.name()]    = i;
+		bnodes[i].name        = strings.intern(n.name());
+		bnodes[i].x           = n.x();
+		bnodes[i].y           = n.y();
+		bnodes[i].flags       = n.unconnected() ? BINARY_NAVGRAPH_UNCONNECTED : 0;
+		bnodes[i].props_begin = properties.size();
+		for (const auto &p : n.properties()) {
+			// defaults are applied again when loading
+			auto d = def_props.find(p.first);
+			if (d == def_props.end() || d->second != p.second) {
+				properties.push_back({strings.intern(p.first), strings.intern(p.second)});
+			}
+		}
+		bnodes[i].props_count = properties.size() - bnodes[i].props_begin;
+	}
+
+	std::vector<uint32_t> node_index(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		node_index[i] = i;
+	}
+	std::sort(node_index.begin(), node_index.end(), [&nodes](uint32_t a, uint32_t b) {
+		return nodes[a].name() < nodes[b].name();
+	});
+
+	std::vector<edge_t>                   bedges(edges.size());
+	std::vector<std::vector<adjacency_t>> adjacency(nodes.size());
+	for (size_t i = 0; i < edges.size(); ++i) {
+		const NavGraphEdge &e    = edges[i];
+		auto                from = node_ids.find(e.from());
+		auto                to   = node_ids.find(e.to());
+		if (from == node_ids.end() || to == node_ids.end()) {
+			throw Exception("Edge %s--%s references unknown node", e.from().c_str(), e.to().c_str());
+		}
+		bedges[i].from        = from->second;
+		bedges[i].to          = to->second;
+		bedges[i].flags       = e.is_directed() ? BINARY_NAVGRAPH_DIRECTED : 0;
+		bedges[i].props_begin = properties.size();
+		for (const auto &p : e.properties()) {
+			properties.push_back({strings.intern(p.first), strings.intern(p.second)});
+		}
+		bedges[i].props_count = properties.size() - bedges[i].props_begin;
+
+		adjacency[from->second].push_back({to->second, (uint32_t)i});
+		if (!e.is_directed()) {
+			adjacency[to->second].push_back({from->second, (uint32_t)i});
+		}
+	}
+
+	std::vector<uint32_t>    adjacency_offsets(nodes.size() + 1, 0);
+	std::vector<adjacency_t> adjacency_list;
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		adjacency_offsets[i] = adjacency_list.size();
+		adjacency_list.insert(adjacency_list.end(), adjacency[i].begin(), adjacency[i].end());
+	}
+	adjacency_offsets[nodes.size()] = adjacency_list.size();
+
+	std::vector<uint32_t> string_offsets(strings.strings.size());
+	std::vector<char>     string_data;
+	for (size_t i = 0; i < strings.strings.size(); ++i) {
+		string_offsets[i] = string_data.size();
+		string_data.insert(string_data.end(), strings.strings[i].begin(), strings.strings[i].end());
+		string_data.push_back('\0');
+	}
+
+	h.num_strings      = string_offsets.size();
+	h.string_data_size = string_data.size();
+	h.num_nodes        = bnodes.size();
+	h.num_edges        = bedges.size();
+	h.num_adjacency    = adjacency_list.size();
+	h.num_properties   = properties.size();
+
+	std::vector<char> buffer(sizeof(header_t), 0);
+	h.strings_offset           = append(buffer, string_offsets.data(), string_offsets.size());
+	h.string_data_offset       = append(buffer, string_data.data(), string_data.size());
+	h.nodes_offset             = append(buffer, bnodes.data(), bnodes.size());
+	h.node_index_offset        = append(buffer, node_index.data(), node_index.size());
+	h.edges_offset             = append(buffer, bedges.data(), bedges.size());
+	h.adjacency_offsets_offset = append(buffer, adjacency_offsets.data(), adjacency_offsets.size());
+	h.adjacency_offset         = append(buffer, adjacency_list.data(), adjacency_list.size());
+	h.properties_offset        = append(buffer, properties.data(), properties.size());
+	h.file_size                = buffer.size();
+	memcpy(buffer.data(), &h, sizeof(h));
+
+	std::string tmp_filename = filename + ".tmp";
+	FILE *      f            = fopen(tmp_filename.c_str(), "wb");
+	if (!f) {
+		throw CouldNotOpenFileException(tmp_filename.c_str(), errno, "Failed to open navgraph");
+	}
+	if (fwrite(buffer.data(), buffer.size(), 1, f) != 1) {
+		int err = errno;
+		fclose(f);
+		unlink(tmp_filename.c_str());
+		throw FileWriteException(tmp_filename.c_str(), err, "Failed to write navgraph");
+	}
+	if (fclose(f) != 0) {
+		int err = errno;
+		unlink(tmp_filename.c_str());
+		throw FileWriteException(tmp_filename.c_str(), err, "Failed to close navgraph");
+	}
+	if (rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+		int err = errno;
+		unlink(tmp_filename.c_str());
+		throw FileWriteException(filename.c_str(), err, "Failed to replace navgraph");
+	}
+}
+
+} // end of namespace fawkes
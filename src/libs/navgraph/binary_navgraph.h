@@ -0,0 +1,160 @@
+
+/***************************************************************************
+ *  binary_navgraph.h - Nav graph stored in a compact binary file
+ *
+ *  Created: Thu Oct 15 09:18:10 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_NAVGRAPH_BINARY_NAVGRAPH_H_
+#define _LIBS_NAVGRAPH_BINARY_NAVGRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace fawkes {
+
+class NavGraph;
+
+class BinaryNavGraph
+{
+public:
+	BinaryNavGraph(std::string filename);
+	~BinaryNavGraph();
+
+	const char *name() const;
+
+	unsigned int num_nodes() const;
+	unsigned int num_edges() const;
+
+	int         find_node(const char *name) const;
+	const char *node_name(unsigned int node) const;
+	float       node_x(unsigned int node) const;
+	float       node_y(unsigned int node) const;
+	bool        node_unconnected(unsigned int node) const;
+	const char *node_property(unsigned int node, const char *key) const;
+
+	std::map<std::string, std::string> node_properties(unsigned int node) const;
+
+	unsigned int num_adjacent(unsigned int node) const;
+	unsigned int adjacent_node(unsigned int node, unsigned int i) const;
+	unsigned int adjacent_edge(unsigned int node, unsigned int i) const;
+
+	unsigned int edge_from(unsigned int edge) const;
+	unsigned int edge_to(unsigned int edge) const;
+	bool         edge_directed(unsigned int edge) const;
+	const char * edge_property(unsigned int edge, const char *key) const;
+
+	std::map<std::string, std::string> edge_properties(unsigned int edge) const;
+
+	NavGraph *to_navgraph(bool allow_multi_graph = false) const;
+
+	static bool is_binary_navgraph(std::string filename);
+
+	/// @cond INTERNALS
+	typedef struct
+	{
+		char     magic[4];
+		uint32_t version;
+		uint32_t byte_order;
+		uint32_t file_size;
+		uint32_t graph_name;
+		uint32_t num_strings;
+		uint32_t string_data_size;
+		uint32_t num_nodes;
+		uint32_t num_edges;
+		uint32_t num_adjacency;
+		uint32_t num_properties;
+		uint32_t default_props_begin;
+		uint32_t default_props_count;
+		uint32_t strings_offset;
+		uint32_t string_data_offset;
+		uint32_t nodes_offset;
+		uint32_t node_index_offset;
+		uint32_t edges_offset;
+		uint32_t adjacency_offsets_offset;
+		uint32_t adjacency_offset;
+		uint32_t properties_offset;
+	} header_t;
+
+	typedef struct
+	{
+		uint32_t name;
+		float    x;
+		float    y;
+		uint32_t flags;
+		uint32_t props_begin;
+		uint32_t props_count;
+	} node_t;
+
+	typedef struct
+	{
+		uint32_t from;
+		uint32_t to;
+		uint32_t flags;
+		uint32_t props_begin;
+		uint32_t props_count;
+	} edge_t;
+
+	typedef struct
+	{
+		uint32_t node;
+		uint32_t edge;
+	} adjacency_t;
+
+	typedef struct
+	{
+		uint32_t key;
+		uint32_t value;
+	} property_t;
+	/// @endcond
+
+private:
+	void        validate() const;
+	const char *string(uint32_t s) const;
+	const char *find_property(uint32_t begin, uint32_t count, const char *key) const;
+	std::map<std::string, std::string> properties(uint32_t begin, uint32_t count) const;
+
+	const node_t *node(unsigned int node) const;
+	const edge_t *edge(unsigned int edge) const;
+
+private:
+	std::string filename_;
+	void *      data_;
+	size_t      size_;
+
+	const header_t *   header_;
+	const uint32_t *   strings_;
+	const char *       string_data_;
+	const node_t *     nodes_;
+	const uint32_t *   node_index_;
+	const edge_t *     edges_;
+	const uint32_t *   adjacency_offsets_;
+	const adjacency_t *adjacency_;
+	const property_t * properties_;
+};
+
+extern NavGraph *load_binary_navgraph(std::string filename, bool allow_multi_graph = false);
+extern void      save_binary_navgraph(std::string filename, NavGraph *graph);
+extern NavGraph *load_navgraph(std::string filename, bool allow_multi_graph = false);
+
+} // end of namespace fawkes
+
+#endif
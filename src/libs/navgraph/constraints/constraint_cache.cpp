@@ -0,0 +1,82 @@
+
+/***************************************************************************
+ *  constraint_cache.cpp - Cache constraint evaluations for path searches
+ *
+ *  Created: Thu Oct 15 04:48:08 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <navgraph/constraints/constraint_cache.h>
+#include <navgraph/constraints/constraint_repo.h>
+
+namespace fawkes {
+
+/** @class NavGraphConstraintCache <navgraph/constraints/constraint_cache.h>
+ * Cache for constraint evaluations during path searches.
+ * Searches on node indices query the constraints for every expanded edge,
+ * and for many edges leading to the same node. The cache evaluates the
+ * constraints for each node and edge at most once, as long as it is not
+ * reset. It must be reset whenever the constraints or the graph change.
+ * @author agent
+ */
+
+/** Constructor. */
+NavGraphConstraintCache::NavGraphConstraintCache()
+{
+}
+
+/** Reset the cache.
+ * All nodes and edges will be evaluated again on their next query.
+ * @param adjacency adjacency of the graph to search
+ */
+void
+NavGraphConstraintCache::reset(const NavGraphSearchGraph::Adjacency &adjacency)
+{
+	node_blocked_.assign(adjacency.num_nodes(), -1);
+	edge_factors_.assign(adjacency.num_arcs(), -1.f);
+}
+
+/** Evaluate the constraints for an edge.
+ * @param repo constraint repository to evaluate
+ * @param nodes nodes of the graph
+ * @param from index of the node the edge originates from
+ * @param to index of the node the edge leads to
+ * @param e index of the arc
+ */
+void
+NavGraphConstraintCache::evaluate(NavGraphConstraintRepo *          repo,
+                                  const std::vector<NavGraphNode> &nodes,
+                                  unsigned int                      from,
+                                  unsigned int                      to,
+                                  size_t                            e)
+{
+	if (node_blocked_[to] < 0) {
+		node_blocked_[to] = repo->blocks(nodes[to]) ? 1 : 0;
+	}
+
+	if (node_blocked_[to] == 1 || repo->blocks(nodes[from], nodes[to])) {
+		edge_factors_[e] = 0.f;
+		return;
+	}
+
+	float cost_factor = 1.f;
+	repo->increases_cost(nodes[from], nodes[to], cost_factor);
+	edge_factors_[e] = cost_factor;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,88 @@
+
+/***************************************************************************
+ *  constraint_cache.h - Cache constraint evaluations for path searches
+ *
+ *  Created: Thu Oct 15 04:48:08 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _NAVGRAPH_CONSTRAINTS_CONSTRAINT_CACHE_H_
+#define _NAVGRAPH_CONSTRAINTS_CONSTRAINT_CACHE_H_
+
+#include <navgraph/navgraph_node.h>
+#include <navgraph/search_graph.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace fawkes {
+
+class NavGraphConstraintRepo;
+
+class NavGraphConstraintCache
+{
+public:
+	NavGraphConstraintCache();
+
+	void reset(const NavGraphSearchGraph::Adjacency &adjacency);
+
+	/** Check if an edge may be used and get its cost factor.
+   * Constraints are evaluated on the first query for an edge, later
+   * queries return the stored result.
+   * @param repo constraint repository to evaluate
+   * @param nodes nodes of the graph
+   * @param from index of the node the edge originates from
+   * @param arc index of the arc from @p from to @p to in the adjacency
+   * @param to index of the node the edge leads to
+   * @param cost_factor upon return contains the factor by which the
+   * constraints increase the cost of the edge, 1 if they do not
+   * @return true if the edge can be used, false if it is blocked
+   */
+	bool
+	edge_usable(NavGraphConstraintRepo *          repo,
+	            const std::vector<NavGraphNode> &nodes,
+	            unsigned int                      from,
+	            unsigned int                      arc,
+	            unsigned int                      to,
+	            float &                           cost_factor)
+	{
+		if (edge_factors_[arc] < 0.f) {
+			evaluate(repo, nodes, from, to, arc);
+		}
+		cost_factor = edge_factors_[arc];
+		return cost_factor > 0.f;
+	}
+
+private:
+	void evaluate(NavGraphConstraintRepo *          repo,
+	              const std::vector<NavGraphNode> &nodes,
+	              unsigned int                      from,
+	              unsigned int                      to,
+	              size_t                            e);
+
+private:
+	// for each node -1 if not evaluated, 0 if free, 1 if blocked
+	std::vector<signed char> node_blocked_;
+	// for each arc -1 if not evaluated, 0 if blocked,
+	// the cost factor otherwise
+	std::vector<float> edge_factors_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -36,6 +36,7 @@ namespace fawkes {
 NavGraphConstraintRepo::NavGraphConstraintRepo()
 {
 	modified_ = false;
+	revision_ = 0;
 }
 
 /** Destructor. */
@@ -50,6 +51,7 @@ void
 NavGraphConstraintRepo::register_constraint(NavGraphNodeConstraint *constraint)
 {
 	modified_ = true;
+	++revision_;
 	node_constraints_.push_back(constraint);
 }
 
@@ -60,6 +62,7 @@ void
 NavGraphConstraintRepo::register_constraint(NavGraphEdgeConstraint *constraint)
 {
 	modified_ = true;
+	++revision_;
 	edge_constraints_.push_back(constraint);
 }
 
@@ -70,6 +73,7 @@ void
 NavGraphConstraintRepo::register_constraint(NavGraphEdgeCostConstraint *constraint)
 {
 	modified_ = true;
+	++revision_;
 	edge_cost_constraints_.push_back(constraint);
 }
 
@@ -80,6 +84,7 @@ void
 NavGraphConstraintRepo::unregister_constraint(std::string name)
 {
 	modified_ = true;
+	++revision_;
 
 	NodeConstraintList::iterator nc =
 	  std::find_if(node_constraints_.begin(),
@@ -249,6 +254,9 @@ NavGraphConstraintRepo::compute()
 			modified = true;
 	}
 
+	if (modified)
+		++revision_;
+
 	return modified;
 }
 
@@ -457,4 +465,17 @@ NavGraphConstraintRepo::modified(bool reset_modified)
 	}
 }
 
+/** Get revision of the constraint repo.
+ * The revision is increased whenever a constraint is registered or
+ * unregistered and whenever compute() reports a change. Results of
+ * constraint evaluations may be reused as long as the revision remains
+ * the same and no constraint has been modified without being computed.
+ * @return revision of the constraint repo
+ */
+unsigned int
+NavGraphConstraintRepo::revision() const
+{
+	return revision_;
+}
+
 } // namespace fawkes
@@ -22,6 +22,7 @@
 
 #include <Eigen/Geometry>
 #include <algorithm>
+#include <limits>
 
 namespace fawkes {
 
@@ -60,6 +61,19 @@ NavGraphPolygonConstraint::add_polygon(const NavGraphPolygonConstraint::Polygon
 {
 	PolygonHandle handle = ++cur_polygon_handle_;
 	polygons_[handle]    = polygon;
+
+	BoundingBox &bbox = bboxes_[handle];
+	bbox.min_x        = std::numeric_limits<float>::infinity();
+	bbox.min_y        = std::numeric_limits<float>::infinity();
+	bbox.max_x        = -std::numeric_limits<float>::infinity();
+	bbox.max_y        = -std::numeric_limits<float>::infinity();
+	for (const Point &p : polygon) {
+		bbox.min_x = std::min(bbox.min_x, p.x);
+		bbox.min_y = std::min(bbox.min_y, p.y);
+		bbox.max_x = std::max(bbox.max_x, p.x);
+		bbox.max_y = std::max(bbox.max_y, p.y);
+	}
+
 	return handle;
 }
 
@@ -71,6 +85,7 @@ NavGraphPolygonConstraint::remove_polygon(const PolygonHandle &handle)
 {
 	if (polygons_.find(handle) != polygons_.end()) {
 		polygons_.erase(handle);
+		bboxes_.erase(handle);
 	}
 }
 
@@ -89,6 +104,7 @@ NavGraphPolygonConstraint::clear_polygons()
 {
 	if (!polygons_.empty()) {
 		polygons_.clear();
+		bboxes_.clear();
 	}
 }
 
@@ -202,4 +218,53 @@ NavGraphPolygonConstraint::on_poly(const Point &p1, const Point &p2, const Polyg
 	return false;
 }
 
+/** Check if given point lies inside any of the polygons.
+ * Polygons whose bounding box does not contain the point are skipped
+ * without testing the polygon itself.
+ * @param point point to check
+ * @return true if the point lies inside any polygon, false otherwise
+ */
+bool
+NavGraphPolygonConstraint::in_polygons(const Point &point)
+{
+	for (const auto &p : polygons_) {
+		const BoundingBox &bbox = bboxes_[p.first];
+		if (point.x < bbox.min_x || point.x > bbox.max_x || point.y < bbox.min_y
+		    || point.y > bbox.max_y) {
+			continue;
+		}
+		if (in_poly(point, p.second)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Check if a line segment lies on any of the polygons.
+ * Polygons whose bounding box does not overlap with the bounding box of
+ * the line segment are skipped without testing the polygon itself.
+ * @param p1 first point of line segment
+ * @param p2 second point of line segment
+ * @return true if the line segment lies on any polygon, false otherwise
+ */
+bool
+NavGraphPolygonConstraint::on_polygons(const Point &p1, const Point &p2)
+{
+	const float min_x = std::min(p1.x, p2.x);
+	const float min_y = std::min(p1.y, p2.y);
+	const float max_x = std::max(p1.x, p2.x);
+	const float max_y = std::max(p1.y, p2.y);
+
+	for (const auto &p : polygons_) {
+		const BoundingBox &bbox = bboxes_[p.first];
+		if (max_x < bbox.min_x || min_x > bbox.max_x || max_y < bbox.min_y || min_y > bbox.max_y) {
+			continue;
+		}
+		if (on_poly(p1, p2, p.second)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 } // end of namespace fawkes
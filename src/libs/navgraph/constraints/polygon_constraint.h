@@ -25,6 +25,7 @@
 #include <navgraph/constraints/static_list_node_constraint.h>
 #include <navgraph/navgraph.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -66,12 +67,25 @@ protected:
 
 	bool in_poly(const Point &point, const Polygon &polygon);
 	bool on_poly(const Point &p1, const Point &p2, const Polygon &polygon);
+	bool in_polygons(const Point &point);
+	bool on_polygons(const Point &p1, const Point &p2);
 
 protected:
 	PolygonMap polygons_; ///< currently registered polygons
 
 private:
-	unsigned int cur_polygon_handle_;
+	/// @cond INTERNAL
+	typedef struct
+	{
+		float min_x;
+		float min_y;
+		float max_x;
+		float max_y;
+	} BoundingBox;
+	/// @endcond
+
+	unsigned int                         cur_polygon_handle_;
+	std::map<PolygonHandle, BoundingBox> bboxes_;
 };
 
 } // end namespace fawkes
@@ -66,15 +66,7 @@ bool
 NavGraphPolygonEdgeConstraint::blocks(const fawkes::NavGraphNode &from,
                                       const fawkes::NavGraphNode &to) noexcept
 {
-	for (auto p : polygons_) {
-		Point from_p(from.x(), from.y());
-		Point to_p(to.x(), to.y());
-		if (on_poly(from_p, to_p, p.second)) {
-			return true;
-		}
-	}
-
-	return false;
+	return on_polygons(Point(from.x(), from.y()), Point(to.x(), to.y()));
 }
 
 } // end of namespace fawkes
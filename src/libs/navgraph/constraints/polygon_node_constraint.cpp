@@ -65,14 +65,7 @@ NavGraphPolygonNodeConstraint::compute(void) noexcept
 bool
 NavGraphPolygonNodeConstraint::blocks(const fawkes::NavGraphNode &node) noexcept
 {
-	for (auto p : polygons_) {
-		Point point(node.x(), node.y());
-		if (in_poly(point, p.second)) {
-			return true;
-		}
-	}
-
-	return false;
+	return in_polygons(Point(node.x(), node.y()));
 }
 
 } // end of namespace fawkes
@@ -27,6 +27,15 @@
 
 namespace fawkes {
 
+/// @cond INTERNAL
+// reservations block an edge in both directions
+static std::string
+edge_key(const std::string &from, const std::string &to)
+{
+	return (from < to) ? from + '\0' + to : to + '\0' + from;
+}
+/// @endcond
+
 /** @class NavGraphTimedReservationListEdgeConstraint <navgraph/constraints/timed_reservation_list_edge_constraint.h>
  * Constraint that holds a list of edges to block with timeouts.
  * @author Sebastian Reuter
@@ -44,8 +53,10 @@ NavGraphTimedReservationListEdgeConstraint::NavGraphTimedReservationListEdgeCons
   fawkes::Clock *clock)
 : NavGraphEdgeConstraint(name)
 {
-	logger_ = logger;
-	clock_  = clock;
+	logger_   = logger;
+	clock_    = clock;
+	modified_ = false;
+	update_index();
 }
 
 /** Constructor.
@@ -65,6 +76,8 @@ NavGraphTimedReservationListEdgeConstraint::NavGraphTimedReservationListEdgeCons
 	clock_           = clock;
 	constraint_name_ = name;
 	edge_time_list_  = edge_time_list;
+	modified_        = false;
+	update_index();
 }
 
 /** Virtual empty destructor. */
@@ -75,22 +88,27 @@ NavGraphTimedReservationListEdgeConstraint::~NavGraphTimedReservationListEdgeCon
 bool
 NavGraphTimedReservationListEdgeConstraint::compute(void) noexcept
 {
-	fawkes::Time                                       now(clock_);
-	std::vector<std::pair<NavGraphEdge, fawkes::Time>> erase_list;
-	for (const std::pair<NavGraphEdge, fawkes::Time> &ec : edge_time_list_) {
-		if (now > ec.second) {
-			erase_list.push_back(ec);
+	fawkes::Time now(clock_);
+
+	// nothing can have run out before the earliest reservation did
+	if (!edge_time_list_.empty() && now > earliest_valid_time_) {
+		std::vector<std::pair<NavGraphEdge, fawkes::Time>> erase_list;
+		for (const std::pair<NavGraphEdge, fawkes::Time> &ec : edge_time_list_) {
+			if (now > ec.second) {
+				erase_list.push_back(ec);
+			}
 		}
-	}
-	for (const std::pair<NavGraphEdge, fawkes::Time> &ec : erase_list) {
-		edge_time_list_.erase(std::remove(edge_time_list_.begin(), edge_time_list_.end(), ec),
-		                      edge_time_list_.end());
-		modified_ = true;
-		logger_->log_info("TimedEdgeConstraint",
-		                  "Deleted edge '%s_%s' from '%s' because it validity duration ran out",
-		                  ec.first.from().c_str(),
-		                  ec.first.to().c_str(),
-		                  name_.c_str());
+		for (const std::pair<NavGraphEdge, fawkes::Time> &ec : erase_list) {
+			edge_time_list_.erase(std::remove(edge_time_list_.begin(), edge_time_list_.end(), ec),
+			                      edge_time_list_.end());
+			modified_ = true;
+			logger_->log_info("TimedEdgeConstraint",
+			                  "Deleted edge '%s_%s' from '%s' because it validity duration ran out",
+			                  ec.first.from().c_str(),
+			                  ec.first.to().c_str(),
+			                  name_.c_str());
+		}
+		update_index();
 	}
 
 	if (modified_) {
@@ -121,6 +139,10 @@ NavGraphTimedReservationListEdgeConstraint::add_edge(const fawkes::NavGraphEdge
 	if (!has_edge(edge)) {
 		modified_ = true;
 		edge_time_list_.push_back(std::make_pair(edge, valid_time));
+		edge_keys_.insert(edge_key(edge.from(), edge.to()));
+		if (edge_time_list_.size() == 1 || valid_time < earliest_valid_time_) {
+			earliest_valid_time_ = valid_time;
+		}
 		std::string txt = edge.from();
 		txt += "_";
 		txt += edge.to();
@@ -162,6 +184,7 @@ NavGraphTimedReservationListEdgeConstraint::remove_edge(const fawkes::NavGraphEd
 	if (ec != edge_time_list_.end()) {
 		modified_ = true;
 		edge_time_list_.erase(ec);
+		update_index();
 	}
 }
 
@@ -184,13 +207,7 @@ bool
 NavGraphTimedReservationListEdgeConstraint::blocks(const fawkes::NavGraphNode &from,
                                                    const fawkes::NavGraphNode &to) noexcept
 {
-	for (const std::pair<fawkes::NavGraphEdge, fawkes::Time> &te : edge_time_list_) {
-		if (((te.first.from() == from.name()) && (te.first.to() == to.name()))
-		    || ((te.first.to() == from.name()) && (te.first.from() == to.name()))) {
-			return true;
-		}
-	}
-	return false;
+	return edge_keys_.find(edge_key(from.name(), to.name())) != edge_keys_.end();
 }
 
 /** Get list of blocked edges.
@@ -209,6 +226,23 @@ NavGraphTimedReservationListEdgeConstraint::clear_edges()
 	if (!edge_time_list_.empty()) {
 		modified_ = true;
 		edge_time_list_.clear();
+		update_index();
+	}
+}
+
+/** Rebuild the edge index and earliest reservation time from the list.
+ * The index makes blocks() independent of the number of reservations,
+ * which is called for every expansion during a path search.
+ */
+void
+NavGraphTimedReservationListEdgeConstraint::update_index()
+{
+	edge_keys_.clear();
+	for (const std::pair<fawkes::NavGraphEdge, fawkes::Time> &te : edge_time_list_) {
+		if (edge_keys_.empty() || te.second < earliest_valid_time_) {
+			earliest_valid_time_ = te.second;
+		}
+		edge_keys_.insert(edge_key(te.first.from(), te.first.to()));
 	}
 }
 
@@ -29,6 +29,7 @@
 #include <utils/time/time.h>
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace fawkes {
@@ -59,12 +60,18 @@ public:
 	virtual bool compute(void) noexcept;
 	virtual bool blocks(const fawkes::NavGraphNode &from, const fawkes::NavGraphNode &to) noexcept;
 
+private:
+	void update_index();
+
 private:
 	std::vector<std::pair<fawkes::NavGraphEdge, fawkes::Time>> edge_time_list_;
 	bool                                                       modified_;
 	Logger *                                                   logger_;
 	fawkes::Clock *                                            clock_;
 	std::string                                                constraint_name_;
+
+	std::unordered_set<std::string> edge_keys_;
+	fawkes::Time                    earliest_valid_time_;
 };
 
 } // end namespace fawkes
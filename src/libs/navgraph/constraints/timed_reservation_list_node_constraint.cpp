@@ -43,8 +43,10 @@ NavGraphTimedReservationListNodeConstraint::NavGraphTimedReservationListNodeCons
   fawkes::Clock *clock)
 : NavGraphNodeConstraint(name)
 {
-	logger_ = logger;
-	clock_  = clock;
+	logger_   = logger;
+	clock_    = clock;
+	modified_ = false;
+	update_index();
 }
 
 /** Constructor.
@@ -64,6 +66,8 @@ NavGraphTimedReservationListNodeConstraint::NavGraphTimedReservationListNodeCons
 	clock_           = clock;
 	constraint_name_ = name;
 	node_time_list_  = node_time_list;
+	modified_        = false;
+	update_index();
 }
 
 /** Virtual empty destructor. */
@@ -74,21 +78,26 @@ NavGraphTimedReservationListNodeConstraint::~NavGraphTimedReservationListNodeCon
 bool
 NavGraphTimedReservationListNodeConstraint::compute(void) noexcept
 {
-	fawkes::Time                                       now(clock_);
-	std::vector<std::pair<NavGraphNode, fawkes::Time>> erase_list;
-	for (const std::pair<NavGraphNode, fawkes::Time> &ec : node_time_list_) {
-		if (now > ec.second) {
-			erase_list.push_back(ec);
+	fawkes::Time now(clock_);
+
+	// nothing can have run out before the earliest reservation did
+	if (!node_time_list_.empty() && now > earliest_valid_time_) {
+		std::vector<std::pair<NavGraphNode, fawkes::Time>> erase_list;
+		for (const std::pair<NavGraphNode, fawkes::Time> &ec : node_time_list_) {
+			if (now > ec.second) {
+				erase_list.push_back(ec);
+			}
 		}
-	}
-	for (const std::pair<NavGraphNode, fawkes::Time> &ec : erase_list) {
-		node_time_list_.erase(std::remove(node_time_list_.begin(), node_time_list_.end(), ec),
-		                      node_time_list_.end());
-		modified_ = true;
-		logger_->log_debug("TimedNodeConstraint",
-		                   "Deleted node '%s' from '%s' because its validity duration ran out",
-		                   ec.first.name().c_str(),
-		                   name_.c_str());
+		for (const std::pair<NavGraphNode, fawkes::Time> &ec : erase_list) {
+			node_time_list_.erase(std::remove(node_time_list_.begin(), node_time_list_.end(), ec),
+			                      node_time_list_.end());
+			modified_ = true;
+			logger_->log_debug("TimedNodeConstraint",
+			                   "Deleted node '%s' from '%s' because its validity duration ran out",
+			                   ec.first.name().c_str(),
+			                   name_.c_str());
+		}
+		update_index();
 	}
 
 	if (modified_) {
@@ -119,6 +128,10 @@ NavGraphTimedReservationListNodeConstraint::add_node(const fawkes::NavGraphNode
 	if (!has_node(node)) {
 		modified_ = true;
 		node_time_list_.push_back(std::make_pair(node, valid_time));
+		node_names_.insert(node.name());
+		if (node_time_list_.size() == 1 || valid_time < earliest_valid_time_) {
+			earliest_valid_time_ = valid_time;
+		}
 		std::string txt = node.name();
 	}
 }
@@ -156,6 +169,7 @@ NavGraphTimedReservationListNodeConstraint::remove_node(const fawkes::NavGraphNo
 	if (ec != node_time_list_.end()) {
 		modified_ = true;
 		node_time_list_.erase(ec);
+		update_index();
 	}
 }
 
@@ -166,23 +180,13 @@ NavGraphTimedReservationListNodeConstraint::remove_node(const fawkes::NavGraphNo
 bool
 NavGraphTimedReservationListNodeConstraint::has_node(const fawkes::NavGraphNode &node)
 {
-	return (std::find_if(node_time_list_.begin(),
-	                     node_time_list_.end(),
-	                     [&node](const std::pair<fawkes::NavGraphNode, fawkes::Time> &p) {
-		                     return p.first == node;
-	                     })
-	        != node_time_list_.end());
+	return node_names_.find(node.name()) != node_names_.end();
 }
 
 bool
 NavGraphTimedReservationListNodeConstraint::blocks(const fawkes::NavGraphNode &node) noexcept
 {
-	for (const std::pair<fawkes::NavGraphNode, fawkes::Time> &te : node_time_list_) {
-		if (te.first.name() == node.name()) {
-			return true;
-		}
-	}
-	return false;
+	return node_names_.find(node.name()) != node_names_.end();
 }
 
 /** Get list of blocked nodes.
@@ -201,6 +205,23 @@ NavGraphTimedReservationListNodeConstraint::clear_nodes()
 	if (!node_time_list_.empty()) {
 		modified_ = true;
 		node_time_list_.clear();
+		update_index();
+	}
+}
+
+/** Rebuild the name index and earliest reservation time from the list.
+ * The index makes blocks() independent of the number of reservations,
+ * which is called for every expansion during a path search.
+ */
+void
+NavGraphTimedReservationListNodeConstraint::update_index()
+{
+	node_names_.clear();
+	for (const std::pair<fawkes::NavGraphNode, fawkes::Time> &te : node_time_list_) {
+		if (node_names_.empty() || te.second < earliest_valid_time_) {
+			earliest_valid_time_ = te.second;
+		}
+		node_names_.insert(te.first.name());
 	}
 }
 
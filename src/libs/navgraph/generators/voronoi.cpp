@@ -51,8 +51,6 @@ typedef VD::Ccb_halfedge_circulator Ccb_halfedge_circulator;
 
 typedef K::Iso_rectangle_2 Iso_rectangle;
 
-typedef std::map<std::string, Point_2> Point_map;
-
 namespace fawkes {
 
 /** @class NavGraphGeneratorVoronoi <navgraph/generators/voronoi.h>
@@ -70,28 +68,64 @@ NavGraphGeneratorVoronoi::~NavGraphGeneratorVoronoi()
 {
 }
 
-/** Check if a point is already contained in a map.
- * @param points map of points to check for @p point
- * @param point point to check whether it already exists
- * @param name if the point was found in the map will be assigned
- * the name of the point in the map upon return
- * @param near_threshold distance threshold for which to consider
- * nodes to be the same if the distance is smaller than this
- * threshold.
- * @return true if the point has been found in the map, false otherwise
- */
-static bool
-contains(Point_map points, Point_2 point, std::string &name, float near_threshold)
+/// @cond INTERNAL
+/** Points hashed into a uniform grid with cells of the size of the
+ * near threshold. Finding nodes in the vicinity of a point then only has
+ * to consider the 3x3 cells around it instead of all nodes. */
+class PointGrid
 {
-	for (auto p : points) {
-		K::FT dist = sqrt(CGAL::squared_distance(p.second, point));
-		if (dist < near_threshold) {
-			name = p.first;
-			return true;
+public:
+	PointGrid(float near_threshold)
+	: near_threshold_(near_threshold), cell_size_(near_threshold > 0. ? near_threshold : 1.)
+	{
+	}
+
+	bool
+	contains(const Point_2 &point, std::string &name) const
+	{
+		const long cx = cell(point.x());
+		const long cy = cell(point.y());
+
+		// same result as a linear search over the name-sorted map,
+		// i.e. the match with the lowest name wins
+		bool found = false;
+		for (long x = cx - 1; x <= cx + 1; ++x) {
+			for (long y = cy - 1; y <= cy + 1; ++y) {
+				auto c = cells_.find(std::make_pair(x, y));
+				if (c == cells_.end())
+					continue;
+				for (const auto &p : c->second) {
+					K::FT dist = sqrt(CGAL::squared_distance(p.second, point));
+					if (dist < near_threshold_ && (!found || p.first < name)) {
+						name  = p.first;
+						found = true;
+					}
+				}
+			}
 		}
+		return found;
 	}
-	return false;
-}
+
+	void
+	insert(const std::string &name, const Point_2 &point)
+	{
+		cells_[std::make_pair(cell(point.x()), cell(point.y()))].push_back(
+		  std::make_pair(name, point));
+	}
+
+private:
+	long
+	cell(double v) const
+	{
+		return (long)floor(v / cell_size_);
+	}
+
+private:
+	float                                                                         near_threshold_;
+	float                                                                         cell_size_;
+	std::map<std::pair<long, long>, std::vector<std::pair<std::string, Point_2>>> cells_;
+};
+/// @endcond
 
 /** Compute graph.
  * @param graph the resulting nodes and edges will be added to this graph.
@@ -110,7 +144,7 @@ NavGraphGeneratorVoronoi::compute(fawkes::LockPtr<fawkes::NavGraph> graph)
 
 	Iso_rectangle rect(Point_2(bbox_p1_x_, bbox_p1_y_), Point_2(bbox_p2_x_, bbox_p2_y_));
 
-	std::map<std::string, Point_2>     points;
+	PointGrid                          points(near_threshold_);
 	std::map<std::string, std::string> props_gen;
 	props_gen["generated"] = "true";
 
@@ -131,25 +165,28 @@ NavGraphGeneratorVoronoi::compute(fawkes::LockPtr<fawkes::NavGraph> graph)
 
 				// check if we have a point in the vicinity
 				std::string source_name, target_name;
-				bool have_source = contains(points, e->source()->point(), source_name, near_threshold_);
-				bool have_target = contains(points, e->target()->point(), target_name, near_threshold_);
+				bool have_source = points.contains(e->source()->point(), source_name);
+				bool have_target = points.contains(e->target()->point(), target_name);
 
 				if (!have_source) {
 					source_name = genname(num_nodes);
 					//printf("Adding source %s\n", source_name.c_str());
 					graph->add_node(NavGraphNode(
 					  source_name, e->source()->point().x(), e->source()->point().y(), props_gen));
-					points[source_name] = e->source()->point();
+					points.insert(source_name, e->source()->point());
 				}
 				if (!have_target) {
 					target_name = genname(num_nodes);
 					//printf("Adding target %s\n", target_name.c_str());
 					graph->add_node(NavGraphNode(
 					  target_name, e->target()->point().x(), e->target()->point().y(), props_gen));
-					points[target_name] = e->target()->point();
+					points.insert(target_name, e->target()->point());
 				}
 
-				graph->add_edge(NavGraphEdge(source_name, target_name, props_gen));
+				// Voronoi edges only meet in vertices, no need for intersection checks
+				graph->add_edge(NavGraphEdge(source_name, target_name, props_gen),
+				                NavGraph::EDGE_FORCE,
+				                /* allow existing */ true);
 			} else {
 				//printf("Unbounded edge\n");
 			}
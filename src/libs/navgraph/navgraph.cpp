@@ -26,6 +26,7 @@
 #include <navgraph/search_state.h>
 #include <utils/math/common.h>
 #include <utils/search/astar.h>
+#include <utils/search/astar_search.h>
 
 #include <Eigen/Geometry>
 #include <algorithm>
@@ -33,6 +34,7 @@
 #include <cstdio>
 #include <limits>
 #include <list>
+#include <map>
 #include <queue>
 #include <set>
 
@@ -42,6 +44,20 @@ namespace navgraph {
 const char *PROP_ORIENTATION = "orientation";
 } // namespace navgraph
 
+/// @cond INTERNAL
+static std::string
+edge_index_key(const std::string &from, const std::string &to, bool directed)
+{
+	std::string key;
+	key.reserve(from.size() + to.size() + 2);
+	key += from;
+	key += '\0';
+	key += to;
+	key += directed ? '>' : '-';
+	return key;
+}
+/// @endcond
+
 /** @class NavGraph <navgraph/navgraph.h>
  * Topological map graph.
  * This class represents a topological graph using 2D map coordinates
@@ -72,6 +88,13 @@ NavGraph::NavGraph(const std::string &graph_name)
 	search_cost_func_      = NavGraphSearchState::euclidean_cost;
 	reachability_calced_   = false;
 	notifications_enabled_ = true;
+
+	search_table_max_nodes_ = 0;
+	search_table_valid_     = false;
+
+	search_constraint_cache_valid_ = false;
+	search_constraint_revision_    = 0;
+	invalidate_indexes();
 }
 
 /** Copy constructor.
@@ -88,6 +111,14 @@ NavGraph::NavGraph(const NavGraph &g)
 	nodes_ = g.nodes_;
 	edges_.clear();
 	edges_ = g.edges_;
+
+	reachability_calced_    = false;
+	search_table_max_nodes_ = g.search_table_max_nodes_;
+	search_table_valid_     = false;
+
+	search_constraint_cache_valid_ = false;
+	search_constraint_revision_    = 0;
+	invalidate_indexes();
 }
 
 /** Virtual empty destructor. */
@@ -112,6 +143,13 @@ NavGraph::operator=(const NavGraph &g)
 	edges_.clear();
 	edges_ = g.edges_;
 
+	// index based search data refers to the old nodes
+	reachability_calced_           = false;
+	search_table_valid_            = false;
+	search_constraint_cache_valid_ = false;
+	search_graph_.clear();
+	invalidate_indexes();
+
 	notify_of_change();
 
 	return *this;
@@ -162,12 +200,9 @@ NavGraph::constraint_repo() const
 NavGraphNode
 NavGraph::node(const std::string &name) const
 {
-	std::vector<NavGraphNode>::const_iterator n =
-	  std::find_if(nodes_.begin(), nodes_.end(), [&name](const NavGraphNode &node) {
-		  return node.name() == name;
-	  });
-	if (n != nodes_.end()) {
-		return *n;
+	int n = node_index(name);
+	if (n >= 0) {
+		return nodes_[n];
 	} else {
 		return NavGraphNode();
 	}
@@ -250,29 +285,11 @@ NavGraph::closest_node(float              pos_x,
                        bool               consider_unconnected,
                        const std::string &property) const
 {
-	std::vector<NavGraphNode> nodes = search_nodes(property);
-
-	float min_dist = std::numeric_limits<float>::max();
-
-	std::vector<NavGraphNode>::iterator i;
-	std::vector<NavGraphNode>::iterator elem = nodes.end();
-	for (i = nodes.begin(); i != nodes.end(); ++i) {
-		if (!consider_unconnected && i->unconnected())
-			continue;
-
-		float dx   = i->x() - pos_x;
-		float dy   = i->y() - pos_y;
-		float dist = sqrtf(dx * dx + dy * dy);
-		if (sqrtf(dx * dx + dy * dy) < min_dist) {
-			min_dist = dist;
-			elem     = i;
-		}
-	}
-
-	if (elem == nodes.end()) {
+	int n = spatial_index().closest_node(nodes_, pos_x, pos_y, consider_unconnected, property);
+	if (n < 0) {
 		return NavGraphNode();
 	} else {
-		return *elem;
+		return nodes_[n];
 	}
 }
 
@@ -291,30 +308,16 @@ NavGraph::closest_node_to(const std::string &node_name,
                           bool               consider_unconnected,
                           const std::string &property) const
 {
-	NavGraphNode              n     = node(node_name);
-	std::vector<NavGraphNode> nodes = search_nodes(property);
-
-	float min_dist = std::numeric_limits<float>::max();
-
-	std::vector<NavGraphNode>::iterator i;
-	std::vector<NavGraphNode>::iterator elem = nodes.begin();
-	for (i = nodes.begin(); i != nodes.end(); ++i) {
-		if (!consider_unconnected && i->unconnected())
-			continue;
-
-		float dx   = i->x() - n.x();
-		float dy   = i->y() - n.y();
-		float dist = sqrtf(dx * dx + dy * dy);
-		if ((sqrtf(dx * dx + dy * dy) < min_dist) && (i->name() != node_name)) {
-			min_dist = dist;
-			elem     = i;
-		}
-	}
+	int n = node_index(node_name);
+	if (n < 0)
+		return NavGraphNode();
 
-	if (elem == nodes.end()) {
+	int closest = spatial_index().closest_node(
+	  nodes_, nodes_[n].x(), nodes_[n].y(), consider_unconnected, property, n);
+	if (closest < 0) {
 		return NavGraphNode();
 	} else {
-		return *elem;
+		return nodes_[closest];
 	}
 }
 
@@ -352,30 +355,12 @@ NavGraph::edge(const std::string &from, const std::string &to) const
 NavGraphEdge
 NavGraph::closest_edge(float pos_x, float pos_y) const
 {
-	float min_dist = std::numeric_limits<float>::max();
-
-	NavGraphEdge rv;
-
-	Eigen::Vector2f point(pos_x, pos_y);
-	for (const NavGraphEdge &edge : edges_) {
-		const Eigen::Vector2f origin(edge.from_node().x(), edge.from_node().y());
-		const Eigen::Vector2f target(edge.to_node().x(), edge.to_node().y());
-		const Eigen::Vector2f direction(target - origin);
-		const Eigen::Vector2f direction_norm = direction.normalized();
-		const Eigen::Vector2f diff           = point - origin;
-		const float           t              = direction.dot(diff) / direction.squaredNorm();
-
-		if (t >= 0.0 && t <= 1.0) {
-			// projection of the point onto the edge is within the line segment
-			float distance = (diff - direction_norm.dot(diff) * direction_norm).norm();
-			if (distance < min_dist) {
-				min_dist = distance;
-				rv       = edge;
-			}
-		}
+	int e = spatial_index().closest_edge(edges_, pos_x, pos_y);
+	if (e < 0) {
+		return NavGraphEdge();
+	} else {
+		return edges_[e];
 	}
-
-	return rv;
 }
 
 /** Search nodes for given property.
@@ -407,8 +392,7 @@ NavGraph::search_nodes(const std::string &property) const
 bool
 NavGraph::node_exists(const NavGraphNode &node) const
 {
-	std::vector<NavGraphNode>::const_iterator n = std::find(nodes_.begin(), nodes_.end(), node);
-	return (n != nodes_.end());
+	return node_index(node.name()) >= 0;
 }
 
 /** Check if a certain node exists.
@@ -418,11 +402,7 @@ NavGraph::node_exists(const NavGraphNode &node) const
 bool
 NavGraph::node_exists(const std::string &name) const
 {
-	std::vector<NavGraphNode>::const_iterator n =
-	  std::find_if(nodes_.begin(), nodes_.end(), [&name](const NavGraphNode &node) {
-		  return node.name() == name;
-	  });
-	return (n != nodes_.end());
+	return node_index(name) >= 0;
 }
 
 /** Check if a certain edge exists.
@@ -432,8 +412,7 @@ NavGraph::node_exists(const std::string &name) const
 bool
 NavGraph::edge_exists(const NavGraphEdge &edge) const
 {
-	std::vector<NavGraphEdge>::const_iterator e = std::find(edges_.begin(), edges_.end(), edge);
-	return (e != edges_.end());
+	return edge_indexed(edge.from(), edge.to(), edge.is_directed());
 }
 
 /** Check if a certain edge exists.
@@ -444,12 +423,8 @@ NavGraph::edge_exists(const NavGraphEdge &edge) const
 bool
 NavGraph::edge_exists(const std::string &from, const std::string &to) const
 {
-	std::vector<NavGraphEdge>::const_iterator e =
-	  std::find_if(edges_.begin(), edges_.end(), [&from, &to](const NavGraphEdge &e) -> bool {
-		  return (from == e.from() && to == e.to())
-		         || (!e.is_directed() && (from == e.to() && to == e.from()));
-	  });
-	return (e != edges_.end());
+	return edge_indexed(from, to, true) || edge_indexed(from, to, false)
+	       || edge_indexed(to, from, false);
 }
 
 /** Add a node.
@@ -464,6 +439,9 @@ NavGraph::add_node(const NavGraphNode &node)
 	} else {
 		nodes_.push_back(node);
 		apply_default_properties(nodes_.back());
+		if (node_index_valid_)
+			node_index_[node.name()] = nodes_.size() - 1;
+		spatial_index_valid_ = false;
 		reachability_calced_ = false;
 		notify_of_change();
 	}
@@ -597,9 +575,13 @@ NavGraph::add_edge(const NavGraphEdge &edge, NavGraph::EdgeMode mode, bool allow
 		case EDGE_FORCE:
 			edges_.push_back(edge);
 			edges_.back().set_nodes(node(edge.from()), node(edge.to()));
+			if (edge_index_valid_) {
+				edge_index_.insert(edge_index_key(edge.from(), edge.to(), edge.is_directed()));
+			}
 			break;
 		}
 
+		spatial_index_valid_ = false;
 		reachability_calced_ = false;
 		notify_of_change();
 	}
@@ -618,6 +600,7 @@ NavGraph::remove_node(const NavGraphNode &node)
 		                            return edge.from() == node.name() || edge.to() == node.name();
 	                            }),
 	             edges_.end());
+	invalidate_indexes();
 	reachability_calced_ = false;
 	notify_of_change();
 }
@@ -640,6 +623,7 @@ NavGraph::remove_node(const std::string &node_name)
 		                            return edge.from() == node_name || edge.to() == node_name;
 	                            }),
 	             edges_.end());
+	invalidate_indexes();
 	reachability_calced_ = false;
 	notify_of_change();
 }
@@ -684,6 +668,8 @@ NavGraph::remove_edge(const NavGraphEdge &edge)
 		                                       && (edge.from() == e.to() && edge.to() == e.from()));
 	                            }),
 	             edges_.end());
+	edge_index_valid_    = false;
+	spatial_index_valid_ = false;
 	reachability_calced_ = false;
 	notify_of_change();
 }
@@ -703,6 +689,8 @@ NavGraph::remove_edge(const std::string &from, const std::string &to)
 		                                       && (edge.to() == from && edge.from() == to));
 	                            }),
 	             edges_.end());
+	edge_index_valid_    = false;
+	spatial_index_valid_ = false;
 	reachability_calced_ = false;
 	notify_of_change();
 }
@@ -717,7 +705,10 @@ NavGraph::update_node(const NavGraphNode &node)
 {
 	std::vector<NavGraphNode>::iterator n = std::find(nodes_.begin(), nodes_.end(), node);
 	if (n != nodes_.end()) {
-		*n = node;
+		*n                   = node;
+		search_table_valid_  = false;
+		spatial_index_valid_ = false;
+		search_graph_.invalidate_costs();
 	} else {
 		throw Exception("No node with name %s known", node.name().c_str());
 	}
@@ -734,7 +725,10 @@ NavGraph::update_edge(const NavGraphEdge &edge)
 {
 	std::vector<NavGraphEdge>::iterator e = std::find(edges_.begin(), edges_.end(), edge);
 	if (e != edges_.end()) {
-		*e = edge;
+		*e                   = edge;
+		search_table_valid_  = false;
+		spatial_index_valid_ = false;
+		search_graph_.invalidate_costs();
 	} else {
 		throw Exception("No edge from %s to %s is known", edge.from().c_str(), edge.to().c_str());
 	}
@@ -749,6 +743,10 @@ NavGraph::clear()
 	nodes_.clear();
 	edges_.clear();
 	default_properties_.clear();
+	reachability_calced_ = false;
+	search_table_valid_  = false;
+	search_graph_.clear();
+	invalidate_indexes();
 	notify_of_change();
 }
 
@@ -937,6 +935,8 @@ NavGraph::set_search_funcs(navgraph::EstimateFunction estimate_func,
 	search_default_funcs_ = false;
 	search_estimate_func_ = estimate_func;
 	search_cost_func_     = cost_func;
+	search_table_valid_   = false;
+	search_graph_.invalidate_costs();
 }
 
 /** Reset actual and estimated cost function to defaults. */
@@ -946,6 +946,8 @@ NavGraph::unset_search_funcs()
 	search_default_funcs_ = true;
 	search_estimate_func_ = NavGraphSearchState::straight_line_estimate;
 	search_cost_func_     = NavGraphSearchState::euclidean_cost;
+	search_table_valid_   = false;
+	search_graph_.invalidate_costs();
 }
 
 /** Search for a path between two nodes with default distance costs.
@@ -973,8 +975,13 @@ NavGraph::search_path(const NavGraphNode &from,
                       bool                use_constraints,
                       bool                compute_constraints)
 {
-	return search_path(
-	  from, to, search_estimate_func_, search_cost_func_, use_constraints, compute_constraints);
+	return search_path_internal(from,
+	                            to,
+	                            search_estimate_func_,
+	                            search_cost_func_,
+	                            use_constraints,
+	                            compute_constraints,
+	                            /* use search table */ true);
 }
 
 /** Search for a path between two nodes with default distance costs.
@@ -1002,8 +1009,9 @@ NavGraph::search_path(const std::string &from,
                       bool               use_constraints,
                       bool               compute_constraints)
 {
-	return search_path(
-	  from, to, search_estimate_func_, search_cost_func_, use_constraints, compute_constraints);
+	NavGraphNode from_node(node(from));
+	NavGraphNode to_node(node(to));
+	return search_path(from_node, to_node, use_constraints, compute_constraints);
 }
 
 /** Search for a path between two nodes.
@@ -1073,10 +1081,106 @@ NavGraph::search_path(const NavGraphNode &       from,
                       navgraph::CostFunction     cost_func,
                       bool                       use_constraints,
                       bool                       compute_constraints)
+{
+	return search_path_internal(
+	  from, to, estimate_func, cost_func, use_constraints, compute_constraints, false);
+}
+
+/** Search for a path between two nodes.
+ * @param from node to search from
+ * @param to goal node
+ * @param estimate_func function to estimate the cost from any node to the goal.
+ * @param cost_func function to calculate the cost from a node to another adjacent
+ * node.
+ * @param use_constraints true to respect constraints imposed by the constraint
+ * repository, false to ignore the repository.
+ * @param compute_constraints if true re-compute constraints, otherwise use constraints
+ * as-is.
+ * @param use_search_table true to use the search table as estimate, if it is
+ * enabled, and the precomputed arc costs. Only valid if @p cost_func is the
+ * registered cost function.
+ * @return ordered vector of nodes which denote a path from @p from to @p to.
+ */
+fawkes::NavGraphPath
+NavGraph::search_path_internal(const NavGraphNode &       from,
+                               const NavGraphNode &       to,
+                               navgraph::EstimateFunction estimate_func,
+                               navgraph::CostFunction     cost_func,
+                               bool                       use_constraints,
+                               bool                       compute_constraints,
+                               bool                       use_search_table)
 {
 	if (!reachability_calced_)
 		calc_reachability(/* allow multi graph */ true);
 
+	// Nodes of the graph are searched on node indices, avoiding search state
+	// allocation. Other nodes, e.g. a copy with modified reachability, are
+	// searched with the state-based A*.
+	int from_idx = node_index(from.name());
+	int to_idx   = node_index(to.name());
+	if (from_idx >= 0 && to_idx >= 0
+	    && from.reachable_nodes() == nodes_[from_idx].reachable_nodes()) {
+		AStarSearch<NavGraphSearchDomain> astar;
+		std::vector<unsigned int>         solution;
+		float                             cost = -1;
+
+		// arc costs are precomputed for the registered cost function only
+		navgraph::CostFunction domain_cost_func;
+		if (!use_search_table) {
+			domain_cost_func = cost_func;
+		}
+
+		// exact costs without constraints, constraints can only increase costs
+		const float *goal_costs = NULL;
+		if (use_search_table && nodes_.size() <= search_table_max_nodes_) {
+			if (!search_table_valid_)
+				calc_search_table();
+			goal_costs = &search_table_[(size_t)to_idx * nodes_.size()];
+			if (std::isinf(goal_costs[from_idx])) {
+				std::vector<fawkes::NavGraphNode> no_path;
+				return NavGraphPath(this, no_path, -1);
+			}
+		}
+
+		if (use_constraints) {
+			constraint_repo_.lock();
+			if (compute_constraints && constraint_repo_->has_constraints()) {
+				constraint_repo_->compute();
+			}
+
+			NavGraphSearchDomain domain(nodes_,
+			                            search_graph().forward(),
+			                            to_idx,
+			                            estimate_func,
+			                            domain_cost_func,
+			                            *constraint_repo_,
+			                            goal_costs,
+			                            search_constraint_cache(compute_constraints));
+			astar.solve(domain, from_idx, solution, cost);
+			constraint_repo_.unlock();
+		} else {
+			NavGraphSearchDomain domain(nodes_,
+			                            search_graph().forward(),
+			                            to_idx,
+			                            estimate_func,
+			                            domain_cost_func,
+			                            NULL,
+			                            goal_costs);
+			astar.solve(domain, from_idx, solution, cost);
+		}
+
+		std::vector<fawkes::NavGraphNode> path(solution.size());
+		for (unsigned int i = 0; i < solution.size(); ++i) {
+			path[i] = nodes_[solution[i]];
+		}
+		if (!path.empty()) {
+			// the search starts with the given node
+			path[0] = from;
+		}
+
+		return NavGraphPath(this, path, cost);
+	}
+
 	AStar astar;
 
 	std::vector<AStarState *> a_star_solution;
@@ -1125,6 +1229,415 @@ NavGraph::cost(const NavGraphNode &from, const NavGraphNode &to) const
 	return search_cost_func_(from, to);
 }
 
+/** Get path costs between multiple nodes.
+ * This determines the costs of the shortest paths from each of the
+ * @p from nodes to each of the @p to nodes, using the registered cost
+ * function. This is much cheaper than searching each path individually,
+ * a single search is run for each origin node, or the costs are taken
+ * from the search table if it is enabled and no constraints apply.
+ * @param from names of nodes to search from
+ * @param to names of goal nodes
+ * @param use_constraints true to respect constraints imposed by the constraint
+ * repository, false to ignore the repository searching as if there were no
+ * constraints whatsoever.
+ * @param compute_constraints if true re-compute constraints, otherwise use constraints
+ * as-is, for example if they have been computed before to check for changes.
+ * @return matrix with one row per origin node and one column per goal node,
+ * containing the path cost or -1 if there is no path.
+ * @throw Exception if any of the nodes does not exist
+ */
+std::vector<std::vector<float>>
+NavGraph::path_cost_matrix(const std::vector<std::string> &from,
+                           const std::vector<std::string> &to,
+                           bool                            use_constraints,
+                           bool                            compute_constraints)
+{
+	if (!reachability_calced_)
+		calc_reachability(/* allow multi graph */ true);
+
+	auto index_of = [this](const std::string &name) {
+		int i = node_index(name);
+		if (i < 0)
+			throw Exception("No node with name %s known", name.c_str());
+		return (unsigned int)i;
+	};
+
+	std::vector<unsigned int> from_idx(from.size()), to_idx(to.size());
+	std::transform(from.begin(), from.end(), from_idx.begin(), index_of);
+	std::transform(to.begin(), to.end(), to_idx.begin(), index_of);
+
+	std::vector<std::vector<float>> costs(from.size(), std::vector<float>(to.size(), -1.f));
+
+	NavGraphConstraintRepo *constraint_repo = NULL;
+	if (use_constraints) {
+		constraint_repo_.lock();
+		if (compute_constraints && constraint_repo_->has_constraints()) {
+			constraint_repo_->compute();
+		}
+		if (constraint_repo_->has_constraints()) {
+			constraint_repo = *constraint_repo_;
+		}
+	}
+
+	if (!constraint_repo && nodes_.size() <= search_table_max_nodes_) {
+		if (!search_table_valid_)
+			calc_search_table();
+		for (unsigned int i = 0; i < from_idx.size(); ++i) {
+			for (unsigned int j = 0; j < to_idx.size(); ++j) {
+				float c = search_table_[(size_t)to_idx[j] * nodes_.size() + from_idx[i]];
+				if (!std::isinf(c))
+					costs[i][j] = c;
+			}
+		}
+	} else {
+		NavGraphConstraintCache *constraint_cache =
+		  constraint_repo ? search_constraint_cache(compute_constraints) : NULL;
+
+		std::vector<float> dist;
+		for (unsigned int i = 0; i < from_idx.size(); ++i) {
+			search_dijkstra(from_idx[i], false, constraint_repo, constraint_cache, dist, &to_idx);
+			for (unsigned int j = 0; j < to_idx.size(); ++j) {
+				if (!std::isinf(dist[to_idx[j]]))
+					costs[i][j] = dist[to_idx[j]];
+			}
+		}
+	}
+
+	if (use_constraints) {
+		constraint_repo_.unlock();
+	}
+
+	return costs;
+}
+
+/** Get path costs from one node to multiple nodes.
+ * This determines the costs of the shortest paths from @p from to each of
+ * the @p to nodes in a single search, see path_cost_matrix().
+ * @param from name of node to search from
+ * @param to names of goal nodes
+ * @param use_constraints true to respect constraints imposed by the constraint
+ * repository, false to ignore the repository searching as if there were no
+ * constraints whatsoever.
+ * @param compute_constraints if true re-compute constraints, otherwise use constraints
+ * as-is, for example if they have been computed before to check for changes.
+ * @return path cost for each of the @p to nodes, -1 if there is no path
+ * @throw Exception if any of the nodes does not exist
+ */
+std::vector<float>
+NavGraph::path_costs(const std::string &             from,
+                     const std::vector<std::string> &to,
+                     bool                            use_constraints,
+                     bool                            compute_constraints)
+{
+	return path_cost_matrix(
+	  std::vector<std::string>(1, from), to, use_constraints, compute_constraints)[0];
+}
+
+/** Search for paths from one node to multiple nodes.
+ * Unlike calling search_path() for each goal, this runs a single
+ * Dijkstra search from @p from, which stops once all goals are reached.
+ * The registered cost function is used, the estimate function is not
+ * required.
+ * @param from name of node to search from
+ * @param to names of goal nodes
+ * @param use_constraints true to respect constraints imposed by the constraint
+ * repository, false to ignore the repository searching as if there were no
+ * constraints whatsoever.
+ * @param compute_constraints if true re-compute constraints, otherwise use constraints
+ * as-is, for example if they have been computed before to check for changes.
+ * @return path for each of the @p to nodes. A path is empty with a cost of
+ * -1 if there is no path to the respective node.
+ * @throw Exception if any of the nodes does not exist
+ */
+std::vector<fawkes::NavGraphPath>
+NavGraph::search_paths(const std::string &             from,
+                       const std::vector<std::string> &to,
+                       bool                            use_constraints,
+                       bool                            compute_constraints)
+{
+	if (!reachability_calced_)
+		calc_reachability(/* allow multi graph */ true);
+
+	auto index_of = [this](const std::string &name) {
+		int i = node_index(name);
+		if (i < 0)
+			throw Exception("No node with name %s known", name.c_str());
+		return (unsigned int)i;
+	};
+
+	unsigned int              from_idx = index_of(from);
+	std::vector<unsigned int> to_idx(to.size());
+	std::transform(to.begin(), to.end(), to_idx.begin(), index_of);
+
+	std::vector<float>        dist;
+	std::vector<unsigned int> parents;
+	if (use_constraints) {
+		constraint_repo_.lock();
+		if (compute_constraints && constraint_repo_->has_constraints()) {
+			constraint_repo_->compute();
+		}
+		NavGraphConstraintRepo * constraint_repo  = NULL;
+		NavGraphConstraintCache *constraint_cache = NULL;
+		if (constraint_repo_->has_constraints()) {
+			constraint_repo  = *constraint_repo_;
+			constraint_cache = search_constraint_cache(compute_constraints);
+		}
+		search_dijkstra(from_idx, false, constraint_repo, constraint_cache, dist, &to_idx, &parents);
+		constraint_repo_.unlock();
+	} else {
+		search_dijkstra(from_idx, false, NULL, NULL, dist, &to_idx, &parents);
+	}
+
+	std::vector<NavGraphPath> paths;
+	paths.reserve(to_idx.size());
+	for (unsigned int t : to_idx) {
+		std::vector<NavGraphNode> path;
+		if (std::isinf(dist[t])) {
+			paths.push_back(NavGraphPath(this, path, -1));
+			continue;
+		}
+		for (unsigned int n = t; n != from_idx; n = parents[n]) {
+			path.push_back(nodes_[n]);
+		}
+		path.push_back(nodes_[from_idx]);
+		std::reverse(path.begin(), path.end());
+		paths.push_back(NavGraphPath(this, path, dist[t]));
+	}
+
+	return paths;
+}
+
+/** Enable or disable the search table.
+ * The search table contains the path costs between all pairs of nodes
+ * without constraints, using the registered cost function. It is used as
+ * exact estimate in path searches with the registered search functions and
+ * for path_cost_matrix() queries without constraints. Constraints can only
+ * block nodes or edges or increase costs, therefore the table remains a
+ * valid estimate while constraints change. The table is calculated on the
+ * first query after each change of the graph or of the search functions.
+ * It requires memory quadratic in the number of nodes.
+ * @param max_nodes maximum number of nodes of the graph to use the search
+ * table, 0 to disable
+ */
+void
+NavGraph::set_search_table_max_nodes(unsigned int max_nodes)
+{
+	search_table_max_nodes_ = max_nodes;
+	if (max_nodes == 0) {
+		search_table_.clear();
+		search_table_.shrink_to_fit();
+		search_table_valid_ = false;
+	}
+}
+
+/** Calculate the search table, one backwards search per goal node. */
+void
+NavGraph::calc_search_table()
+{
+	const size_t num_nodes = nodes_.size();
+	search_table_.resize(num_nodes * num_nodes);
+
+	std::vector<float> dist;
+	for (unsigned int t = 0; t < num_nodes; ++t) {
+		search_dijkstra(t, /* reverse */ true, NULL, NULL, dist);
+		std::copy(dist.begin(), dist.end(), search_table_.begin() + (size_t)t * num_nodes);
+	}
+	search_table_valid_ = true;
+}
+
+/** Calculate path costs from one node to all nodes.
+ * @param source index of the node to start from
+ * @param reverse true to search backwards along the edges, i.e. to get the
+ * costs from all nodes to @p source. Constraints are not supported for
+ * backwards searches.
+ * @param constraint_repo constraint repository, null to ignore constraints
+ * @param constraint_cache if not null, constraints are evaluated through
+ * this cache
+ * @param dist upon return contains the cost for each node, infinity if the
+ * node cannot be reached
+ * @param targets if not null, the search stops once the costs of all of
+ * these nodes are known. The costs of other nodes may then be too high.
+ * @param parents if not null, upon return contains for each reached node
+ * the index of its predecessor on the cheapest path, the source is its own
+ * predecessor
+ */
+void
+NavGraph::search_dijkstra(unsigned int                     source,
+                          bool                             reverse,
+                          NavGraphConstraintRepo *         constraint_repo,
+                          NavGraphConstraintCache *        constraint_cache,
+                          std::vector<float> &             dist,
+                          const std::vector<unsigned int> *targets,
+                          std::vector<unsigned int> *      parents)
+{
+	typedef std::pair<float, unsigned int> QueueEntry;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+	const NavGraphSearchGraph::Adjacency &adjacency =
+	  reverse ? search_graph().reverse() : search_graph().forward();
+
+	std::vector<bool> is_target;
+	size_t            num_open_targets = 0;
+	if (targets) {
+		is_target.assign(nodes_.size(), false);
+		for (unsigned int t : *targets) {
+			if (!is_target[t]) {
+				is_target[t] = true;
+				++num_open_targets;
+			}
+		}
+	}
+
+	dist.assign(nodes_.size(), std::numeric_limits<float>::infinity());
+	dist[source] = 0.;
+	queue.push(QueueEntry(0., source));
+	if (parents) {
+		parents->assign(nodes_.size(), source);
+	}
+
+	while (!queue.empty()) {
+		QueueEntry e = queue.top();
+		queue.pop();
+		if (e.first > dist[e.second])
+			continue;
+
+		if (targets && is_target[e.second]) {
+			// each node is settled only once, its cost is final
+			is_target[e.second] = false;
+			if (--num_open_targets == 0)
+				break;
+		}
+
+		for (unsigned int a = adjacency.begin(e.second); a < adjacency.end(e.second); ++a) {
+			const unsigned int c = adjacency.target(a);
+
+			float cost_factor = 1.;
+			if (constraint_cache) {
+				if (!constraint_cache->edge_usable(constraint_repo, nodes_, e.second, a, c, cost_factor)) {
+					continue;
+				}
+			} else if (constraint_repo) {
+				const NavGraphNode &from = nodes_[reverse ? c : e.second];
+				const NavGraphNode &to   = nodes_[reverse ? e.second : c];
+				if (constraint_repo->blocks(to) || constraint_repo->blocks(from, to)) {
+					continue;
+				}
+				constraint_repo->increases_cost(from, to, cost_factor);
+			}
+
+			float cost = adjacency.cost(a);
+			if (cost_factor != 1.) {
+				cost *= cost_factor;
+			}
+
+			if (e.first + cost < dist[c]) {
+				dist[c] = e.first + cost;
+				if (parents)
+					(*parents)[c] = e.second;
+				queue.push(QueueEntry(dist[c], c));
+			}
+		}
+	}
+}
+
+/** Get the constraint cache for a search on node indices.
+ * Constraint results are kept across searches as long as the constraints
+ * are computed for each search and the constraint repository does not
+ * report a change. Otherwise, the cache is reset and only shared among the
+ * expansions of a single search. The constraint repository must be locked.
+ * @param constraints_computed true if the constraints have been computed
+ * for this search
+ * @return constraint cache, valid for the current graph and constraints
+ */
+NavGraphConstraintCache *
+NavGraph::search_constraint_cache(bool constraints_computed)
+{
+	if (!constraints_computed || !search_constraint_cache_valid_
+	    || search_constraint_revision_ != constraint_repo_->revision()) {
+		search_constraint_cache_.reset(search_graph_.forward());
+		search_constraint_cache_valid_ = true;
+		search_constraint_revision_    = constraint_repo_->revision();
+	}
+	return &search_constraint_cache_;
+}
+
+/** Get index-based graph for searches.
+ * Calculates the arc costs with the registered cost function if they are
+ * outdated. Reachability must have been calculated.
+ * @return search graph
+ */
+const NavGraphSearchGraph &
+NavGraph::search_graph()
+{
+	if (!search_graph_.costs_valid()) {
+		search_graph_.calc_costs(nodes_, search_cost_func_);
+	}
+	return search_graph_;
+}
+
+/** Get index of a node.
+ * @param name name of the node
+ * @return index of the node in nodes_, -1 if there is no such node
+ */
+int
+NavGraph::node_index(const std::string &name) const
+{
+	if (!node_index_valid_) {
+		node_index_.clear();
+		node_index_.reserve(nodes_.size());
+		for (unsigned int i = 0; i < nodes_.size(); ++i) {
+			node_index_[nodes_[i].name()] = i;
+		}
+		node_index_valid_ = true;
+	}
+
+	auto n = node_index_.find(name);
+	return (n != node_index_.end()) ? (int)n->second : -1;
+}
+
+/** Check if an edge is contained in the edge index.
+ * @param from originating node name
+ * @param to target node name
+ * @param directed true to look for a directed, false for an undirected edge
+ * @return true if there is an edge with exactly these properties
+ */
+bool
+NavGraph::edge_indexed(const std::string &from, const std::string &to, bool directed) const
+{
+	if (!edge_index_valid_) {
+		edge_index_.clear();
+		edge_index_.reserve(edges_.size());
+		for (const NavGraphEdge &e : edges_) {
+			edge_index_.insert(edge_index_key(e.from(), e.to(), e.is_directed()));
+		}
+		edge_index_valid_ = true;
+	}
+
+	return edge_index_.find(edge_index_key(from, to, directed)) != edge_index_.end();
+}
+
+/** Get spatial index over nodes and edges, building it if necessary.
+ * @return spatial index valid for the current nodes and edges
+ */
+const NavGraphSpatialIndex &
+NavGraph::spatial_index() const
+{
+	if (!spatial_index_valid_) {
+		spatial_index_.build(nodes_, edges_);
+		spatial_index_valid_ = true;
+	}
+	return spatial_index_;
+}
+
+/** Invalidate name, edge, and spatial index after nodes have been removed or replaced. */
+void
+NavGraph::invalidate_indexes()
+{
+	node_index_valid_    = false;
+	edge_index_valid_    = false;
+	spatial_index_valid_ = false;
+}
+
 /** Make sure each node in the edges exists. */
 void
 NavGraph::assert_valid_edges()
@@ -1323,10 +1836,10 @@ NavGraph::assert_connected()
 	}
 
 	q.push(*fcon);
+	traversed.insert(fcon->name());
 
 	while (!q.empty()) {
 		NavGraphNode &n = q.front();
-		traversed.insert(n.name());
 
 		const std::vector<std::string> &reachable = n.reachable_nodes();
 
@@ -1342,8 +1855,9 @@ NavGraph::assert_connected()
 				                target.name().c_str(),
 				                n.name().c_str());
 			}
-			if (traversed.find(*r) == traversed.end())
-				q.push(node(*r));
+			// enqueue each node only once, nodes are reachable on many paths
+			if (traversed.insert(*r).second)
+				q.push(target);
 		}
 		q.pop();
 	}
@@ -1409,20 +1923,33 @@ NavGraph::assert_connected()
 void
 NavGraph::calc_reachability(bool allow_multi_graph)
 {
-	if (nodes_.empty())
+	if (nodes_.empty()) {
+		search_graph_.clear();
 		return;
+	}
 
 	assert_valid_edges();
 
-	std::vector<NavGraphNode>::iterator i;
-	for (i = nodes_.begin(); i != nodes_.end(); ++i) {
-		i->set_reachable_nodes(reachable_nodes(i->name()));
+	// one pass over the edges instead of one per node, the reachable nodes
+	// of the nodes are taken from the index-based graph
+	search_graph_.build(nodes_, edges_);
+	const NavGraphSearchGraph::Adjacency &adjacency = search_graph_.forward();
+	for (unsigned int n = 0; n < nodes_.size(); ++n) {
+		std::vector<std::string> reachable;
+		reachable.reserve(adjacency.end(n) - adjacency.begin(n));
+		for (unsigned int a = adjacency.begin(n); a < adjacency.end(n); ++a) {
+			reachable.push_back(nodes_[adjacency.target(a)].name());
+		}
+		nodes_[n].set_reachable_nodes(reachable);
 	}
+	search_table_valid_            = false;
+	search_constraint_cache_valid_ = false;
 
 	std::vector<NavGraphEdge>::iterator e;
 	for (e = edges_.begin(); e != edges_.end(); ++e) {
 		e->set_nodes(node(e->from()), node(e->to()));
 	}
+	spatial_index_valid_ = false;
 
 	if (!allow_multi_graph)
 		assert_connected();
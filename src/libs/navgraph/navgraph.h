@@ -24,13 +24,18 @@
 #define _LIBS_NAVGRAPH_NAVGRAPH_H_
 
 #include <core/utils/lockptr.h>
+#include <navgraph/constraints/constraint_cache.h>
 #include <navgraph/navgraph_edge.h>
 #include <navgraph/navgraph_node.h>
 #include <navgraph/navgraph_path.h>
+#include <navgraph/search_graph.h>
+#include <navgraph/spatial_index.h>
 
 #include <functional>
 #include <list>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace fawkes {
@@ -146,6 +151,23 @@ public:
 	                                 bool                       use_constraints     = true,
 	                                 bool                       compute_constraints = true);
 
+	std::vector<std::vector<float>> path_cost_matrix(const std::vector<std::string> &from,
+	                                                 const std::vector<std::string> &to,
+	                                                 bool use_constraints     = true,
+	                                                 bool compute_constraints = true);
+
+	std::vector<float> path_costs(const std::string &             from,
+	                              const std::vector<std::string> &to,
+	                              bool                            use_constraints     = true,
+	                              bool                            compute_constraints = true);
+
+	std::vector<fawkes::NavGraphPath> search_paths(const std::string &             from,
+	                                               const std::vector<std::string> &to,
+	                                               bool use_constraints     = true,
+	                                               bool compute_constraints = true);
+
+	void set_search_table_max_nodes(unsigned int max_nodes);
+
 	void add_node(const NavGraphNode &node);
 	void add_node_and_connect(const NavGraphNode &node, ConnectionMode conn_mode);
 	void connect_node_to_closest_node(const NavGraphNode &n);
@@ -210,6 +232,31 @@ private:
 	void edge_add_no_intersection(const NavGraphEdge &edge);
 	void edge_add_split_intersection(const NavGraphEdge &edge);
 
+	fawkes::NavGraphPath search_path_internal(const NavGraphNode &       from,
+	                                          const NavGraphNode &       to,
+	                                          navgraph::EstimateFunction estimate_func,
+	                                          navgraph::CostFunction     cost_func,
+	                                          bool                       use_constraints,
+	                                          bool                       compute_constraints,
+	                                          bool                       use_search_table);
+	void calc_search_table();
+	void search_dijkstra(unsigned int                     source,
+	                     bool                             reverse,
+	                     NavGraphConstraintRepo *         constraint_repo,
+	                     NavGraphConstraintCache *        constraint_cache,
+	                     std::vector<float> &             dist,
+	                     const std::vector<unsigned int> *targets = NULL,
+	                     std::vector<unsigned int> *      parents = NULL);
+	NavGraphConstraintCache *  search_constraint_cache(bool constraints_computed);
+	const NavGraphSearchGraph &search_graph();
+
+	int                         node_index(const std::string &name) const;
+	bool                        edge_indexed(const std::string &from,
+	                                         const std::string &to,
+	                                         bool               directed) const;
+	const NavGraphSpatialIndex &spatial_index() const;
+	void                        invalidate_indexes();
+
 private:
 	std::string                             graph_name_;
 	std::vector<NavGraphNode>               nodes_;
@@ -222,7 +269,24 @@ private:
 	navgraph::EstimateFunction search_estimate_func_;
 	navgraph::CostFunction     search_cost_func_;
 
-	bool reachability_calced_;
+	bool                reachability_calced_;
+	NavGraphSearchGraph search_graph_;
+
+	unsigned int       search_table_max_nodes_;
+	bool               search_table_valid_;
+	std::vector<float> search_table_;
+
+	NavGraphConstraintCache search_constraint_cache_;
+	bool                    search_constraint_cache_valid_;
+	unsigned int            search_constraint_revision_;
+
+	// lookup structures, built on demand from nodes_ and edges_
+	mutable bool                                          node_index_valid_;
+	mutable std::unordered_map<std::string, unsigned int> node_index_;
+	mutable bool                                          edge_index_valid_;
+	mutable std::unordered_set<std::string>               edge_index_;
+	mutable bool                                          spatial_index_valid_;
+	mutable NavGraphSpatialIndex                          spatial_index_;
 
 	bool notifications_enabled_;
 };
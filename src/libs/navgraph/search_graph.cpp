@@ -0,0 +1,150 @@
+
+/***************************************************************************
+ *  search_graph.cpp - Index-based adjacency of a navgraph for searches
+ *
+ *  Created: Thu Oct 15 09:23:16 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <navgraph/search_graph.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace fawkes {
+
+/** @class NavGraphSearchGraph <navgraph/search_graph.h>
+ * Index-based adjacency of a navgraph for searches.
+ * Nodes are identified by their index in the node list of the graph. The
+ * arcs, i.e. the possible moves along the edges, are stored in compressed
+ * sparse row form in both directions, together with their cost according
+ * to the graph's cost function. Searches thus expand nodes without name
+ * lookups and without calling the cost function. The arcs of each node
+ * are ordered by the name of the node they lead to, which is the order of
+ * the reachable nodes of the NavGraphNode.
+ * @author agent
+ */
+
+/** Constructor. */
+NavGraphSearchGraph::NavGraphSearchGraph() : costs_valid_(false)
+{
+}
+
+/** Build adjacency.
+ * The arc costs must be calculated afterwards.
+ * @param nodes nodes of the graph
+ * @param edges edges of the graph, edges referencing unknown nodes are
+ * ignored
+ */
+void
+NavGraphSearchGraph::build(const std::vector<NavGraphNode> &nodes,
+                           const std::vector<NavGraphEdge> &edges)
+{
+	const unsigned int num_nodes = nodes.size();
+
+	std::unordered_map<std::string, unsigned int> node_index;
+	node_index.reserve(num_nodes);
+	for (unsigned int i = 0; i < num_nodes; ++i) {
+		node_index[nodes[i].name()] = i;
+	}
+
+	std::vector<std::pair<unsigned int, unsigned int>> arcs;
+	arcs.reserve(edges.size() * 2);
+	for (const NavGraphEdge &e : edges) {
+		auto from = node_index.find(e.from());
+		auto to   = node_index.find(e.to());
+		if (from == node_index.end() || to == node_index.end())
+			continue;
+		arcs.push_back(std::make_pair(from->second, to->second));
+		if (!e.is_directed()) {
+			arcs.push_back(std::make_pair(to->second, from->second));
+		}
+	}
+	std::sort(arcs.begin(),
+	          arcs.end(),
+	          [&nodes](const std::pair<unsigned int, unsigned int> &a,
+	                   const std::pair<unsigned int, unsigned int> &b) {
+		          return a.first < b.first
+		                 || (a.first == b.first && nodes[a.second].name() < nodes[b.second].name());
+	          });
+	arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+	forward_.offsets_.assign(num_nodes + 1, 0);
+	forward_.targets_.resize(arcs.size());
+	reverse_.offsets_.assign(num_nodes + 1, 0);
+	reverse_.targets_.resize(arcs.size());
+	reverse_arcs_.resize(arcs.size());
+
+	for (const auto &a : arcs) {
+		forward_.offsets_[a.first + 1] += 1;
+		reverse_.offsets_[a.second + 1] += 1;
+	}
+	for (unsigned int n = 0; n < num_nodes; ++n) {
+		forward_.offsets_[n + 1] += forward_.offsets_[n];
+		reverse_.offsets_[n + 1] += reverse_.offsets_[n];
+	}
+
+	std::vector<unsigned int> reverse_fill(reverse_.offsets_.begin(), reverse_.offsets_.end() - 1);
+	for (unsigned int a = 0; a < arcs.size(); ++a) {
+		forward_.targets_[a] = arcs[a].second;
+		unsigned int r       = reverse_fill[arcs[a].second]++;
+		reverse_.targets_[r] = arcs[a].first;
+		reverse_arcs_[r]     = a;
+	}
+
+	forward_.costs_.clear();
+	reverse_.costs_.clear();
+	costs_valid_ = false;
+}
+
+/** Remove all nodes and arcs. */
+void
+NavGraphSearchGraph::clear()
+{
+	forward_ = Adjacency();
+	reverse_ = Adjacency();
+	reverse_arcs_.clear();
+	costs_valid_ = false;
+}
+
+/** Calculate arc costs.
+ * @param nodes nodes of the graph, must be the nodes passed to build()
+ * @param cost_func function to calculate the cost from a node to an
+ * adjacent node
+ */
+void
+NavGraphSearchGraph::calc_costs(const std::vector<NavGraphNode> &nodes,
+                                const CostFunction &             cost_func)
+{
+	forward_.costs_.resize(forward_.targets_.size());
+	for (unsigned int n = 0; n < forward_.num_nodes(); ++n) {
+		for (unsigned int a = forward_.begin(n); a < forward_.end(n); ++a) {
+			forward_.costs_[a] = cost_func(nodes[n], nodes[forward_.targets_[a]]);
+		}
+	}
+
+	reverse_.costs_.resize(reverse_.targets_.size());
+	for (unsigned int r = 0; r < reverse_arcs_.size(); ++r) {
+		reverse_.costs_[r] = forward_.costs_[reverse_arcs_[r]];
+	}
+	costs_valid_ = true;
+}
+
+} // end of namespace fawkes
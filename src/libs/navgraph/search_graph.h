@@ -0,0 +1,157 @@
+
+/***************************************************************************
+ *  search_graph.h - Index-based adjacency of a navgraph for searches
+ *
+ *  Created: Thu Oct 15 09:23:16 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_NAVGRAPH_SEARCH_GRAPH_H_
+#define _LIBS_NAVGRAPH_SEARCH_GRAPH_H_
+
+#include <navgraph/navgraph_edge.h>
+#include <navgraph/navgraph_node.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace fawkes {
+
+class NavGraphSearchGraph
+{
+public:
+	/** Function to calculate the cost of an arc. */
+	typedef std::function<float(const NavGraphNode &, const NavGraphNode &)> CostFunction;
+
+	/** Arcs of the graph in one direction in compressed sparse row form.
+	 * The arcs of node n are begin(n) <= a < end(n). */
+	class Adjacency
+	{
+		friend NavGraphSearchGraph;
+
+	public:
+		/** Get first arc of a node.
+		 * @param n node index
+		 * @return index of the first arc of @p n */
+		unsigned int
+		begin(unsigned int n) const
+		{
+			return offsets_[n];
+		}
+
+		/** Get end of the arcs of a node.
+		 * @param n node index
+		 * @return index after the last arc of @p n */
+		unsigned int
+		end(unsigned int n) const
+		{
+			return offsets_[n + 1];
+		}
+
+		/** Get node an arc leads to.
+		 * @param a arc index
+		 * @return index of the target node */
+		unsigned int
+		target(unsigned int a) const
+		{
+			return targets_[a];
+		}
+
+		/** Get precomputed cost of an arc.
+		 * Only valid if the costs have been calculated.
+		 * @param a arc index
+		 * @return cost of the arc along the direction of the graph edge */
+		float
+		cost(unsigned int a) const
+		{
+			return costs_[a];
+		}
+
+		/** Get number of nodes.
+		 * @return number of nodes */
+		size_t
+		num_nodes() const
+		{
+			return offsets_.empty() ? 0 : offsets_.size() - 1;
+		}
+
+		/** Get number of arcs.
+		 * @return number of arcs */
+		size_t
+		num_arcs() const
+		{
+			return targets_.size();
+		}
+
+	private:
+		std::vector<unsigned int> offsets_;
+		std::vector<unsigned int> targets_;
+		std::vector<float>        costs_;
+	};
+
+	NavGraphSearchGraph();
+
+	void build(const std::vector<NavGraphNode> &nodes, const std::vector<NavGraphEdge> &edges);
+	void clear();
+
+	void calc_costs(const std::vector<NavGraphNode> &nodes, const CostFunction &cost_func);
+
+	/** Mark the arc costs as outdated, e.g. after the cost function changed. */
+	void
+	invalidate_costs()
+	{
+		costs_valid_ = false;
+	}
+
+	/** Check if the arc costs are valid.
+	 * @return true if the costs have been calculated since the last change */
+	bool
+	costs_valid() const
+	{
+		return costs_valid_;
+	}
+
+	/** Get arcs along the direction of the graph edges.
+	 * @return forward adjacency */
+	const Adjacency &
+	forward() const
+	{
+		return forward_;
+	}
+
+	/** Get arcs against the direction of the graph edges.
+	 * @return reverse adjacency, the cost of an arc from n to m is the cost
+	 * of the forward arc from m to n */
+	const Adjacency &
+	reverse() const
+	{
+		return reverse_;
+	}
+
+private:
+	Adjacency forward_;
+	Adjacency reverse_;
+	// for each reverse arc the corresponding forward arc
+	std::vector<unsigned int> reverse_arcs_;
+	bool                      costs_valid_;
+};
+
+} // end of namespace fawkes
+
+#endif
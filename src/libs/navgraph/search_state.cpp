@@ -202,4 +202,47 @@ NavGraphSearchState::children()
 	return children;
 }
 
+/** @class NavGraphSearchDomain <navgraph/search_state.h>
+ * Graph-based path planner search domain for AStarSearch.
+ * This provides the same search as NavGraphSearchState, but states are
+ * node indices and successors are taken from the index-based adjacency
+ * of the graph, so that no search state objects or node copies are
+ * created.
+ */
+
+/** Constructor.
+ * @param nodes nodes of the graph
+ * @param adjacency arcs of the graph
+ * @param goal index of the goal node
+ * @param estimate_func function to estimate the cost from any node to the goal.
+ * Note that the estimate function must be admissible for optimal A* search.
+ * @param cost_func function to calculate the cost from a node to another adjacent
+ * node. If empty, the precomputed costs of the arcs are used.
+ * @param constraint_repo constraint repository, null to plan only without constraints
+ * @param goal_costs if not null, the unconstrained path cost from each node
+ * to the goal, used instead of the estimate function. Infinity marks nodes
+ * from which the goal cannot be reached.
+ * @param constraint_cache if not null, constraints of @p constraint_repo are
+ * evaluated through this cache, which must have been reset for @p adjacency
+ */
+NavGraphSearchDomain::NavGraphSearchDomain(const std::vector<NavGraphNode> &     nodes,
+                                           const NavGraphSearchGraph::Adjacency &adjacency,
+                                           unsigned int                          goal,
+                                           navgraph::EstimateFunction            estimate_func,
+                                           navgraph::CostFunction                cost_func,
+                                           fawkes::NavGraphConstraintRepo *      constraint_repo,
+                                           const float *                         goal_costs,
+                                           fawkes::NavGraphConstraintCache *     constraint_cache)
+: nodes_(nodes),
+  adjacency_(adjacency),
+  goal_(goal),
+  estimate_func_(estimate_func),
+  cost_func_(cost_func),
+  arc_costs_(!cost_func),
+  constraint_repo_(constraint_repo),
+  goal_costs_(goal_costs),
+  constraint_cache_(constraint_repo ? constraint_cache : NULL)
+{
+}
+
 } // end of namespace fawkes
@@ -23,8 +23,10 @@
 #define _LIBS_NAVGRAPH_SEARCH_STATE_H_
 
 #include <core/utils/lockptr.h>
+#include <navgraph/constraints/constraint_cache.h>
 #include <navgraph/constraints/constraint_repo.h>
 #include <navgraph/navgraph.h>
+#include <navgraph/search_graph.h>
 #include <utils/search/astar_state.h>
 
 #include <cmath>
@@ -111,6 +113,107 @@ private:
 	navgraph::CostFunction     cost_func_;
 };
 
+class NavGraphSearchDomain
+{
+public:
+	/** Search state, the index of a node in the graph's node list. */
+	typedef unsigned int State;
+
+	NavGraphSearchDomain(const std::vector<fawkes::NavGraphNode> &     nodes,
+	                     const fawkes::NavGraphSearchGraph::Adjacency &adjacency,
+	                     unsigned int                                  goal,
+	                     navgraph::EstimateFunction                    estimate_func,
+	                     navgraph::CostFunction                        cost_func,
+	                     fawkes::NavGraphConstraintRepo *              constraint_repo  = NULL,
+	                     const float *                                 goal_costs       = NULL,
+	                     fawkes::NavGraphConstraintCache *             constraint_cache = NULL);
+
+	/** Get number of states.
+   * @return number of nodes in the graph */
+	size_t
+	num_states() const
+	{
+		return nodes_.size();
+	}
+
+	/** Get key of a state.
+   * @param s state
+   * @return key of @p s */
+	size_t
+	key(State s) const
+	{
+		return s;
+	}
+
+	/** Estimate cost to the goal.
+   * @param s state
+   * @return estimated cost from @p s to the goal */
+	float
+	estimate(State s) const
+	{
+		return goal_costs_ ? goal_costs_[s] : estimate_func_(nodes_[s], nodes_[goal_]);
+	}
+
+	/** Check for goal.
+   * @param s state
+   * @return true if @p s is the goal */
+	bool
+	is_goal(State s) const
+	{
+		return s == goal_;
+	}
+
+	/** Expand a state.
+   * @param s state to expand
+   * @param f function called for each successor with its state and
+   * the cost to get there from @p s */
+	template <class F>
+	void
+	expand(State s, F &&f) const
+	{
+		const NavGraphNode &node = nodes_[s];
+		for (unsigned int a = adjacency_.begin(s); a < adjacency_.end(s); ++a) {
+			const unsigned int  c = adjacency_.target(a);
+			const NavGraphNode &d = nodes_[c];
+
+			// the goal cannot be reached from there, even without constraints
+			if (goal_costs_ && std::isinf(goal_costs_[c])) {
+				continue;
+			}
+
+			float cost_factor = 1.;
+			if (constraint_cache_) {
+				if (!constraint_cache_->edge_usable(constraint_repo_, nodes_, s, a, c, cost_factor)) {
+					continue;
+				}
+			} else if (constraint_repo_) {
+				if (constraint_repo_->blocks(d) || constraint_repo_->blocks(node, d)) {
+					continue;
+				}
+				constraint_repo_->increases_cost(node, d, cost_factor);
+			}
+
+			float d_cost = arc_costs_ ? adjacency_.cost(a) : cost_func_(node, d);
+			if (cost_factor != 1.) {
+				d_cost *= cost_factor;
+			}
+
+			f(c, d_cost);
+		}
+	}
+
+private:
+	const std::vector<fawkes::NavGraphNode> &     nodes_;
+	const fawkes::NavGraphSearchGraph::Adjacency &adjacency_;
+	unsigned int                                  goal_;
+	navgraph::EstimateFunction                    estimate_func_;
+	navgraph::CostFunction                        cost_func_;
+	bool                                          arc_costs_;
+	fawkes::NavGraphConstraintRepo *              constraint_repo_;
+	const float *                                 goal_costs_;
+	fawkes::NavGraphConstraintCache *             constraint_cache_;
+};
+
 } // end of namespace fawkes
 
 #endif
@@ -0,0 +1,374 @@
+
+/***************************************************************************
+ *  spatial_index.cpp - Uniform grid index over navgraph nodes and edges
+ *
+ *  Created: Thu Oct 15 04:27:58 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <navgraph/spatial_index.h>
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fawkes {
+
+/** @class NavGraphSpatialIndex <navgraph/spatial_index.h>
+ * Uniform grid over the nodes and edges of a navgraph.
+ * The grid covers the bounding box of the graph with roughly one node
+ * per cell. Nodes are stored in the cell containing them, edges in every
+ * cell their line segment passes through. Closest item queries visit the
+ * cells in rings of growing distance around the query point and stop as
+ * soon as no unvisited cell can contain a closer item.
+ *
+ * The index only stores positions into the node and edge vectors it was
+ * built from, it must be rebuilt whenever these change. Queries return
+ * the same item as a linear scan in vector order would, ties are broken
+ * in favor of the lower index.
+ */
+
+/** Constructor. */
+NavGraphSpatialIndex::NavGraphSpatialIndex()
+{
+	clear();
+}
+
+/** Remove all items from the index. */
+void
+NavGraphSpatialIndex::clear()
+{
+	min_x_     = 0.;
+	min_y_     = 0.;
+	cell_size_ = 1.;
+	width_     = 0;
+	height_    = 0;
+	stamp_     = 0;
+	node_cell_start_.clear();
+	node_items_.clear();
+	edge_cell_start_.clear();
+	edge_items_.clear();
+	edge_stamps_.clear();
+}
+
+/** Build index.
+ * @param nodes nodes to index
+ * @param edges edges to index, the geometry is taken from the nodes
+ * stored with the edge
+ */
+void
+NavGraphSpatialIndex::build(const std::vector<NavGraphNode> &nodes,
+                            const std::vector<NavGraphEdge> &edges)
+{
+	clear();
+	if (nodes.empty() && edges.empty())
+		return;
+
+	float max_x = -std::numeric_limits<float>::max();
+	float max_y = -std::numeric_limits<float>::max();
+	min_x_      = std::numeric_limits<float>::max();
+	min_y_      = std::numeric_limits<float>::max();
+	for (const NavGraphNode &n : nodes) {
+		min_x_ = std::min(min_x_, n.x());
+		min_y_ = std::min(min_y_, n.y());
+		max_x  = std::max(max_x, n.x());
+		max_y  = std::max(max_y, n.y());
+	}
+	for (const NavGraphEdge &e : edges) {
+		min_x_ = std::min(min_x_, std::min(e.from_node().x(), e.to_node().x()));
+		min_y_ = std::min(min_y_, std::min(e.from_node().y(), e.to_node().y()));
+		max_x  = std::max(max_x, std::max(e.from_node().x(), e.to_node().x()));
+		max_y  = std::max(max_y, std::max(e.from_node().y(), e.to_node().y()));
+	}
+
+	// about one node per cell, but no more cells per axis than items,
+	// which would happen for graphs that are (almost) a straight line
+	const float  extent_x  = max_x - min_x_;
+	const float  extent_y  = max_y - min_y_;
+	const size_t num_items = std::max(nodes.size(), edges.size());
+	cell_size_             = std::max(std::sqrt(extent_x * extent_y / num_items),
+                            std::max(extent_x, extent_y) / num_items);
+	if (!(cell_size_ > 0.))
+		cell_size_ = 1.;
+	width_  = (unsigned int)(extent_x / cell_size_) + 1;
+	height_ = (unsigned int)(extent_y / cell_size_) + 1;
+
+	const size_t num_cells = (size_t)width_ * height_;
+
+	node_cell_start_.assign(num_cells + 1, 0);
+	node_items_.resize(nodes.size());
+	std::vector<unsigned int> node_cells(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		node_cells[i] = cell_y(nodes[i].y()) * width_ + cell_x(nodes[i].x());
+		node_cell_start_[node_cells[i] + 1] += 1;
+	}
+	for (size_t c = 0; c < num_cells; ++c) {
+		node_cell_start_[c + 1] += node_cell_start_[c];
+	}
+	std::vector<unsigned int> fill(node_cell_start_.begin(), node_cell_start_.end() - 1);
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		node_items_[fill[node_cells[i]]++] = i;
+	}
+
+	std::vector<std::pair<unsigned int, unsigned int>> cell_items;
+	for (size_t i = 0; i < edges.size(); ++i) {
+		add_segment(i,
+		            edges[i].from_node().x(),
+		            edges[i].from_node().y(),
+		            edges[i].to_node().x(),
+		            edges[i].to_node().y(),
+		            cell_items);
+	}
+	edge_cell_start_.assign(num_cells + 1, 0);
+	edge_items_.resize(cell_items.size());
+	for (const auto &ci : cell_items) {
+		edge_cell_start_[ci.first + 1] += 1;
+	}
+	for (size_t c = 0; c < num_cells; ++c) {
+		edge_cell_start_[c + 1] += edge_cell_start_[c];
+	}
+	fill.assign(edge_cell_start_.begin(), edge_cell_start_.end() - 1);
+	for (const auto &ci : cell_items) {
+		edge_items_[fill[ci.first]++] = ci.second;
+	}
+	edge_stamps_.assign(edges.size(), 0);
+}
+
+/** Get closest node.
+ * @param nodes nodes the index was built from
+ * @param pos_x X coordinate in global (map) frame
+ * @param pos_y Y coordinate in global (map) frame
+ * @param consider_unconnected consider unconnected nodes
+ * @param property property the node must have to be considered,
+ * empty string to not check for any property
+ * @param exclude index of a node not to consider, -1 to consider all
+ * @return index of the closest node, -1 if no node matches
+ */
+int
+NavGraphSpatialIndex::closest_node(const std::vector<NavGraphNode> &nodes,
+                                   float                            pos_x,
+                                   float                            pos_y,
+                                   bool                             consider_unconnected,
+                                   const std::string &              property,
+                                   int                              exclude) const
+{
+	int   rv       = -1;
+	float min_dist = std::numeric_limits<float>::max();
+
+	visit_rings(
+	  pos_x,
+	  pos_y,
+	  [&](unsigned int cell) {
+		  for (unsigned int i = node_cell_start_[cell]; i < node_cell_start_[cell + 1]; ++i) {
+			  const int           ni = node_items_[i];
+			  const NavGraphNode &n  = nodes[ni];
+			  if (ni == exclude || (!consider_unconnected && n.unconnected())
+			      || (!property.empty() && !n.has_property(property))) {
+				  continue;
+			  }
+			  float dx   = n.x() - pos_x;
+			  float dy   = n.y() - pos_y;
+			  float dist = sqrtf(dx * dx + dy * dy);
+			  if (dist < min_dist || (dist == min_dist && ni < rv)) {
+				  min_dist = dist;
+				  rv       = ni;
+			  }
+		  }
+	  },
+	  [&](float bound) { return min_dist < bound; });
+
+	return rv;
+}
+
+/** Get closest edge.
+ * Only edges are considered for which a line perpendicular to the edge
+ * goes through the point and a point on the edge's line segment.
+ * @param edges edges the index was built from
+ * @param pos_x X coordinate in global (map) frame
+ * @param pos_y Y coordinate in global (map) frame
+ * @return index of the closest edge, -1 if there is none
+ */
+int
+NavGraphSpatialIndex::closest_edge(const std::vector<NavGraphEdge> &edges,
+                                   float                            pos_x,
+                                   float                            pos_y) const
+{
+	int   rv       = -1;
+	float min_dist = std::numeric_limits<float>::max();
+
+	if (++stamp_ == 0) {
+		std::fill(edge_stamps_.begin(), edge_stamps_.end(), 0);
+		stamp_ = 1;
+	}
+
+	const Eigen::Vector2f point(pos_x, pos_y);
+	visit_rings(
+	  pos_x,
+	  pos_y,
+	  [&](unsigned int cell) {
+		  for (unsigned int i = edge_cell_start_[cell]; i < edge_cell_start_[cell + 1]; ++i) {
+			  const int ei = edge_items_[i];
+			  if (edge_stamps_[ei] == stamp_)
+				  continue;
+			  edge_stamps_[ei] = stamp_;
+
+			  const NavGraphEdge &  edge = edges[ei];
+			  const Eigen::Vector2f origin(edge.from_node().x(), edge.from_node().y());
+			  const Eigen::Vector2f target(edge.to_node().x(), edge.to_node().y());
+			  const Eigen::Vector2f direction(target - origin);
+			  const Eigen::Vector2f direction_norm = direction.normalized();
+			  const Eigen::Vector2f diff           = point - origin;
+			  const float           t              = direction.dot(diff) / direction.squaredNorm();
+
+			  if (t >= 0.0 && t <= 1.0) {
+				  float distance = (diff - direction_norm.dot(diff) * direction_norm).norm();
+				  if (distance < min_dist || (distance == min_dist && ei < rv)) {
+					  min_dist = distance;
+					  rv       = ei;
+				  }
+			  }
+		  }
+	  },
+	  [&](float bound) { return min_dist < bound; });
+
+	return rv;
+}
+
+/** Visit cells in rings around the cell closest to the given point.
+ * After each ring, done is called with a lower bound for the distance
+ * of the point to any item in the cells not visited so far. Visiting
+ * stops when done returns true or all cells have been visited.
+ */
+template <class VisitCell, class Done>
+void
+NavGraphSpatialIndex::visit_rings(float       pos_x,
+                                  float       pos_y,
+                                  VisitCell &&visit_cell,
+                                  Done &&     done) const
+{
+	if (width_ == 0 || height_ == 0)
+		return;
+
+	const int cx = cell_x(pos_x);
+	const int cy = cell_y(pos_y);
+	const int w  = width_;
+	const int h  = height_;
+
+	for (int r = 0;; ++r) {
+		const int y_min = std::max(cy - r, 0);
+		const int y_max = std::min(cy + r, h - 1);
+		for (int y = y_min; y <= y_max; ++y) {
+			if (y == cy - r || y == cy + r) {
+				// full row at the top or bottom of the ring
+				const int x_min = std::max(cx - r, 0);
+				const int x_max = std::min(cx + r, w - 1);
+				for (int x = x_min; x <= x_max; ++x) {
+					visit_cell(y * w + x);
+				}
+			} else {
+				// only the left and right cell of the ring
+				if (cx - r >= 0)
+					visit_cell(y * w + cx - r);
+				if (r > 0 && cx + r < w)
+					visit_cell(y * w + cx + r);
+			}
+		}
+
+		// Remaining cells lie beyond the ring on at least one side, the
+		// distance to the closest such side bounds the distance to their
+		// items. This also works for points outside of the grid.
+		bool  remaining = false;
+		float bound     = std::numeric_limits<float>::max();
+		if (cx - r > 0) {
+			remaining = true;
+			bound     = std::min(bound, pos_x - (min_x_ + (cx - r) * cell_size_));
+		}
+		if (cx + r < w - 1) {
+			remaining = true;
+			bound     = std::min(bound, (min_x_ + (cx + r + 1) * cell_size_) - pos_x);
+		}
+		if (cy - r > 0) {
+			remaining = true;
+			bound     = std::min(bound, pos_y - (min_y_ + (cy - r) * cell_size_));
+		}
+		if (cy + r < h - 1) {
+			remaining = true;
+			bound     = std::min(bound, (min_y_ + (cy + r + 1) * cell_size_) - pos_y);
+		}
+
+		if (!remaining || done(bound))
+			return;
+	}
+}
+
+void
+NavGraphSpatialIndex::add_segment(unsigned int                                        edge,
+                                  float                                               x0,
+                                  float                                               y0,
+                                  float                                               x1,
+                                  float                                               y1,
+                                  std::vector<std::pair<unsigned int, unsigned int>> &cell_items)
+{
+	if (x1 < x0) {
+		std::swap(x0, x1);
+		std::swap(y0, y1);
+	}
+
+	// cells are widened slightly such that points on cell borders are
+	// registered in both adjacent cells despite rounding errors
+	const float eps = cell_size_ * 1e-4;
+
+	const unsigned int cx_min = cell_x(x0 - eps);
+	const unsigned int cx_max = cell_x(x1 + eps);
+	for (unsigned int cx = cx_min; cx <= cx_max; ++cx) {
+		float ya = y0, yb = y1;
+		if (x1 - x0 > eps) {
+			// part of the segment within the column
+			const float sx0 = std::max(x0, min_x_ + cx * cell_size_ - eps);
+			const float sx1 = std::min(x1, min_x_ + (cx + 1) * cell_size_ + eps);
+			ya              = y0 + (y1 - y0) * (sx0 - x0) / (x1 - x0);
+			yb              = y0 + (y1 - y0) * (sx1 - x0) / (x1 - x0);
+		}
+		const unsigned int cy_min = cell_y(std::min(ya, yb) - eps);
+		const unsigned int cy_max = cell_y(std::max(ya, yb) + eps);
+		for (unsigned int cy = cy_min; cy <= cy_max; ++cy) {
+			cell_items.push_back(std::make_pair(cy * width_ + cx, edge));
+		}
+	}
+}
+
+unsigned int
+NavGraphSpatialIndex::cell_x(float x) const
+{
+	float c = std::floor((x - min_x_) / cell_size_);
+	if (!(c > 0.))
+		return 0;
+	return std::min((unsigned int)c, width_ - 1);
+}
+
+unsigned int
+NavGraphSpatialIndex::cell_y(float y) const
+{
+	float c = std::floor((y - min_y_) / cell_size_);
+	if (!(c > 0.))
+		return 0;
+	return std::min((unsigned int)c, height_ - 1);
+}
+
+} // end of namespace fawkes
@@ -0,0 +1,88 @@
+
+/***************************************************************************
+ *  spatial_index.h - Uniform grid index over navgraph nodes and edges
+ *
+ *  Created: Thu Oct 15 04:27:58 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_NAVGRAPH_SPATIAL_INDEX_H_
+#define _LIBS_NAVGRAPH_SPATIAL_INDEX_H_
+
+#include <navgraph/navgraph_edge.h>
+#include <navgraph/navgraph_node.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fawkes {
+
+class NavGraphSpatialIndex
+{
+public:
+	NavGraphSpatialIndex();
+
+	void build(const std::vector<NavGraphNode> &nodes, const std::vector<NavGraphEdge> &edges);
+	void clear();
+
+	int closest_node(const std::vector<NavGraphNode> &nodes,
+	                 float                            pos_x,
+	                 float                            pos_y,
+	                 bool                             consider_unconnected,
+	                 const std::string &              property,
+	                 int                              exclude = -1) const;
+
+	int closest_edge(const std::vector<NavGraphEdge> &edges, float pos_x, float pos_y) const;
+
+private:
+	void         add_segment(unsigned int                                        edge,
+	                         float                                               x0,
+	                         float                                               y0,
+	                         float                                               x1,
+	                         float                                               y1,
+	                         std::vector<std::pair<unsigned int, unsigned int>> &cell_items);
+	unsigned int cell_x(float x) const;
+	unsigned int cell_y(float y) const;
+
+	template <class VisitCell, class Done>
+	void visit_rings(float pos_x, float pos_y, VisitCell &&visit_cell, Done &&done) const;
+
+private:
+	float        min_x_;
+	float        min_y_;
+	float        cell_size_;
+	unsigned int width_;
+	unsigned int height_;
+
+	// cells in row-major order, items of cell c are in
+	// items_[cell_start_[c] .. cell_start_[c + 1])
+	std::vector<unsigned int> node_cell_start_;
+	std::vector<unsigned int> node_items_;
+	std::vector<unsigned int> edge_cell_start_;
+	std::vector<unsigned int> edge_items_;
+
+	// an edge is registered in every cell its segment passes through,
+	// stamps avoid checking it more than once per query
+	mutable std::vector<unsigned int> edge_stamps_;
+	mutable unsigned int              stamp_;
+};
+
+} // end of namespace fawkes
+
+#endif
@@ -0,0 +1,246 @@
+/***************************************************************************
+ *  test_navgraph_index.cpp - NavGraph node and spatial index test
+ *
+ *  Created: Thu Oct 15 10:01:50 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <navgraph/navgraph.h>
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+
+/** Build a random graph.
+ * Every third node has the property "marked", every fifth node is
+ * unconnected. Nodes are clustered in one corner to get cells with
+ * many and cells without any nodes.
+ */
+void
+build_random_graph(NavGraph &graph, std::mt19937 &gen, unsigned int num_nodes)
+{
+	std::uniform_real_distribution<float>       pos(-50.f, 50.f);
+	std::uniform_real_distribution<float>       cluster(-50.f, -40.f);
+	std::uniform_int_distribution<unsigned int> node(0, num_nodes - 1);
+
+	graph.set_notifications_enabled(false);
+	for (unsigned int i = 0; i < num_nodes; ++i) {
+		float        x = (i % 2) ? cluster(gen) : pos(gen);
+		float        y = (i % 2) ? cluster(gen) : pos(gen);
+		NavGraphNode n(NavGraph::format_name("N%u", i), x, y);
+		if (i % 3 == 0) {
+			n.set_property("marked", true);
+		}
+		if (i % 5 == 0) {
+			n.set_unconnected(true);
+		}
+		graph.add_node(n);
+	}
+	for (unsigned int e = 0; e < num_nodes; ++e) {
+		unsigned int a = node(gen);
+		unsigned int b = node(gen);
+		if (a == b || a % 5 == 0 || b % 5 == 0) {
+			continue;
+		}
+		std::string from = NavGraph::format_name("N%u", a);
+		std::string to   = NavGraph::format_name("N%u", b);
+		if (!graph.edge_exists(from, to) && !graph.edge_exists(to, from)) {
+			graph.add_edge(NavGraphEdge(from, to), NavGraph::EDGE_FORCE);
+		}
+	}
+	graph.set_notifications_enabled(true);
+}
+
+/** Reference closest node distance by linear search.
+ * @return distance of the closest node, infinity if there is none
+ */
+float
+closest_node_distance(const NavGraph &    graph,
+                      float               x,
+                      float               y,
+                      bool                consider_unconnected,
+                      const std::string & property,
+                      const std::string & exclude = "")
+{
+	float min_dist = std::numeric_limits<float>::infinity();
+	for (const NavGraphNode &n : graph.nodes()) {
+		if ((!consider_unconnected && n.unconnected()) || n.name() == exclude
+		    || (property != "" && !n.has_property(property))) {
+			continue;
+		}
+		min_dist = std::min(min_dist, std::hypot(n.x() - x, n.y() - y));
+	}
+	return min_dist;
+}
+
+/** Distance of a point to an edge.
+ * @return perpendicular distance, or infinity if the projection of the
+ * point is not on the edge segment
+ */
+float
+edge_distance(const NavGraphEdge &edge, float x, float y)
+{
+	float ox = edge.from_node().x(), oy = edge.from_node().y();
+	float dx = edge.to_node().x() - ox, dy = edge.to_node().y() - oy;
+	float t  = (dx * (x - ox) + dy * (y - oy)) / (dx * dx + dy * dy);
+	if (t < 0.f || t > 1.f) {
+		return std::numeric_limits<float>::infinity();
+	}
+	return std::hypot(ox + t * dx - x, oy + t * dy - y);
+}
+
+/** Reference closest edge distance by linear search. */
+float
+closest_edge_distance(const NavGraph &graph, float x, float y)
+{
+	float min_dist = std::numeric_limits<float>::infinity();
+	for (const NavGraphEdge &e : graph.edges()) {
+		min_dist = std::min(min_dist, edge_distance(e, x, y));
+	}
+	return min_dist;
+}
+
+float
+node_distance(const NavGraphNode &n, float x, float y)
+{
+	return n.is_valid() ? std::hypot(n.x() - x, n.y() - y) : std::numeric_limits<float>::infinity();
+}
+
+/** Compare index queries to linear search at random points. */
+void
+check_queries(const NavGraph &graph, std::mt19937 &gen)
+{
+	// query points also outside of the bounding box of the nodes
+	std::uniform_real_distribution<float> pos(-70.f, 70.f);
+
+	for (unsigned int i = 0; i < 200; ++i) {
+		float x = pos(gen);
+		float y = pos(gen);
+		for (bool consider_unconnected : {false, true}) {
+			for (const std::string property : {"", "marked", "missing"}) {
+				float        expected = closest_node_distance(graph, x, y, consider_unconnected, property);
+				NavGraphNode n        = graph.closest_node(x, y, consider_unconnected, property);
+				if (std::isinf(expected)) {
+					REQUIRE_FALSE(n.is_valid());
+				} else {
+					REQUIRE(node_distance(n, x, y) == Approx(expected));
+				}
+			}
+		}
+
+		float        expected = closest_edge_distance(graph, x, y);
+		NavGraphEdge e        = graph.closest_edge(x, y);
+		if (std::isinf(expected)) {
+			REQUIRE_FALSE(e.is_valid());
+		} else {
+			REQUIRE(e.is_valid());
+			REQUIRE(edge_distance(e, x, y) == Approx(expected).margin(1e-4));
+		}
+	}
+
+	for (unsigned int i = 0; i < graph.nodes().size(); i += 11) {
+		const NavGraphNode &from = graph.nodes()[i];
+		for (bool consider_unconnected : {false, true}) {
+			float expected =
+			  closest_node_distance(graph, from.x(), from.y(), consider_unconnected, "", from.name());
+			NavGraphNode n = graph.closest_node_to(from.name(), consider_unconnected);
+			REQUIRE(n.name() != from.name());
+			REQUIRE(node_distance(n, from.x(), from.y()) == Approx(expected));
+		}
+	}
+}
+
+} // namespace
+
+TEST_CASE("Node lookup by name", "[navgraph]")
+{
+	std::mt19937 gen(1);
+	NavGraph     graph("random");
+	build_random_graph(graph, gen, 300);
+
+	for (const NavGraphNode &n : graph.nodes()) {
+		REQUIRE(graph.node_exists(n.name()));
+		REQUIRE(graph.node(n.name()).x() == n.x());
+		REQUIRE(graph.node(n.name()).y() == n.y());
+	}
+	REQUIRE_FALSE(graph.node_exists("missing"));
+	REQUIRE_FALSE(graph.node("missing").is_valid());
+
+	graph.remove_node("N7");
+	REQUIRE_FALSE(graph.node_exists("N7"));
+	REQUIRE(graph.node("N8").name() == "N8");
+	for (const NavGraphNode &n : graph.nodes()) {
+		REQUIRE(graph.node(n.name()).name() == n.name());
+	}
+
+	graph.add_node(NavGraphNode("N7", 1.f, 2.f));
+	REQUIRE(graph.node("N7").x() == 1.f);
+
+	for (const NavGraphEdge &e : graph.edges()) {
+		REQUIRE(graph.edge_exists(e.from(), e.to()));
+		REQUIRE(graph.edge_exists(e.to(), e.from()));
+	}
+	REQUIRE_FALSE(graph.edge_exists("N1", "missing"));
+}
+
+TEST_CASE("Spatial queries match linear search", "[navgraph]")
+{
+	std::mt19937 gen(2);
+	for (unsigned int num_nodes : {1u, 2u, 10u, 300u}) {
+		NavGraph graph("random");
+		build_random_graph(graph, gen, num_nodes);
+		check_queries(graph, gen);
+	}
+}
+
+TEST_CASE("Spatial index follows graph changes", "[navgraph]")
+{
+	std::mt19937 gen(3);
+	NavGraph     graph("random");
+	build_random_graph(graph, gen, 200);
+	check_queries(graph, gen);
+
+	// move a node far outside of the previous bounding box
+	NavGraphNode n = graph.node("N3");
+	n.set_x(200.f);
+	n.set_y(-200.f);
+	graph.update_node(n);
+	REQUIRE(graph.closest_node(190.f, -190.f).name() == "N3");
+	check_queries(graph, gen);
+
+	for (unsigned int i = 0; i < 200; i += 4) {
+		graph.remove_node(NavGraph::format_name("N%u", i));
+	}
+	check_queries(graph, gen);
+
+	graph.add_node(NavGraphNode("X1", 0.5f, 0.5f));
+	graph.add_node(NavGraphNode("X2", 30.5f, 0.5f));
+	graph.add_edge(NavGraphEdge("X1", "X2"), NavGraph::EDGE_FORCE);
+	REQUIRE(graph.closest_node(0.6f, 0.6f).name() == "X1");
+	check_queries(graph, gen);
+
+	graph.clear();
+	REQUIRE_FALSE(graph.closest_node(0.f, 0.f, true).is_valid());
+	REQUIRE_FALSE(graph.closest_edge(0.f, 0.f).is_valid());
+}
@@ -0,0 +1,243 @@
+/***************************************************************************
+ *  test_navgraph_search.cpp - NavGraph path search and cost query test
+ *
+ *  Created: Thu Oct 15 09:56:52 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/constraints/static_list_node_constraint.h>
+#include <navgraph/navgraph.h>
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+
+/** Build a random graph.
+ * Edges may cross and some are directed, nodes are not necessarily
+ * connected, hence some queries have no path.
+ */
+void
+build_random_graph(NavGraph &graph, unsigned int seed, unsigned int num_nodes)
+{
+	std::mt19937                                gen(seed);
+	std::uniform_real_distribution<float>       pos(0.f, 20.f);
+	std::uniform_int_distribution<unsigned int> node(0, num_nodes - 1);
+	std::bernoulli_distribution                 directed(0.2);
+
+	graph.set_notifications_enabled(false);
+	for (unsigned int i = 0; i < num_nodes; ++i) {
+		graph.add_node(NavGraphNode(NavGraph::format_name("N%u", i), pos(gen), pos(gen)));
+	}
+	for (unsigned int e = 0; e < 2 * num_nodes; ++e) {
+		unsigned int a = node(gen);
+		unsigned int b = node(gen);
+		if (a == b) {
+			continue;
+		}
+		std::string from = NavGraph::format_name("N%u", a);
+		std::string to   = NavGraph::format_name("N%u", b);
+		if (graph.edge_exists(from, to) || graph.edge_exists(to, from)) {
+			continue;
+		}
+		graph.add_edge(NavGraphEdge(from, to, directed(gen)), NavGraph::EDGE_FORCE);
+	}
+	graph.set_notifications_enabled(true);
+	graph.calc_reachability(/* allow multi graph */ true);
+}
+
+/** Reference path costs from one node to all nodes.
+ * Plain Dijkstra over the edge list with Euclidean costs.
+ */
+std::vector<float>
+dijkstra(const NavGraph &graph, const std::string &from)
+{
+	const std::vector<NavGraphNode> &nodes = graph.nodes();
+
+	std::map<std::string, unsigned int> index;
+	for (unsigned int i = 0; i < nodes.size(); ++i) {
+		index[nodes[i].name()] = i;
+	}
+	std::vector<std::vector<unsigned int>> adjacent(nodes.size());
+	for (const NavGraphEdge &e : graph.edges()) {
+		adjacent[index[e.from()]].push_back(index[e.to()]);
+		if (!e.is_directed()) {
+			adjacent[index[e.to()]].push_back(index[e.from()]);
+		}
+	}
+
+	typedef std::pair<float, unsigned int> Entry;
+	std::vector<float> dist(nodes.size(), std::numeric_limits<float>::infinity());
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> q;
+	dist[index[from]] = 0.f;
+	q.push(std::make_pair(0.f, index[from]));
+	while (!q.empty()) {
+		Entry e = q.top();
+		q.pop();
+		if (e.first > dist[e.second]) {
+			continue;
+		}
+		for (unsigned int a : adjacent[e.second]) {
+			const NavGraphNode &n = nodes[e.second];
+			float               c = e.first + std::hypot(nodes[a].x() - n.x(), nodes[a].y() - n.y());
+			if (c < dist[a]) {
+				dist[a] = c;
+				q.push(std::make_pair(c, a));
+			}
+		}
+	}
+	return dist;
+}
+
+std::vector<std::string>
+node_names(const NavGraph &graph)
+{
+	std::vector<std::string> names;
+	for (const NavGraphNode &n : graph.nodes()) {
+		names.push_back(n.name());
+	}
+	return names;
+}
+
+/** Check that a path is connected by edges of the graph. */
+bool
+path_valid(const NavGraph &graph, const NavGraphPath &path)
+{
+	const std::vector<NavGraphNode> &nodes = path.nodes();
+	for (size_t i = 1; i < nodes.size(); ++i) {
+		NavGraphEdge e = graph.edge(nodes[i - 1].name(), nodes[i].name());
+		if (!e.is_valid() || (e.is_directed() && e.from() != nodes[i - 1].name())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+TEST_CASE("Path search matches Dijkstra", "[navgraph]")
+{
+	for (unsigned int table_nodes : {0u, 1000u}) {
+		for (unsigned int seed = 1; seed <= 5; ++seed) {
+			NavGraph graph("random");
+			build_random_graph(graph, seed, 80);
+			graph.set_search_table_max_nodes(table_nodes);
+
+			for (unsigned int i = 0; i < graph.nodes().size(); i += 9) {
+				const std::string  from = graph.nodes()[i].name();
+				std::vector<float> dist = dijkstra(graph, from);
+
+				for (unsigned int j = 0; j < graph.nodes().size(); ++j) {
+					NavGraphPath p = graph.search_path(from, graph.nodes()[j].name());
+					if (std::isinf(dist[j])) {
+						REQUIRE(p.empty());
+						REQUIRE(p.cost() == -1.f);
+					} else {
+						REQUIRE(p.cost() == Approx(dist[j]).epsilon(1e-4));
+						REQUIRE(path_valid(graph, p));
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("Path cost matrix matches path search", "[navgraph]")
+{
+	for (unsigned int table_nodes : {0u, 1000u}) {
+		for (unsigned int seed = 1; seed <= 5; ++seed) {
+			NavGraph graph("random");
+			build_random_graph(graph, seed, 60);
+			graph.set_search_table_max_nodes(table_nodes);
+
+			std::vector<std::string>        names  = node_names(graph);
+			std::vector<std::vector<float>> matrix = graph.path_cost_matrix(names, names);
+			REQUIRE(matrix.size() == names.size());
+
+			for (unsigned int i = 0; i < names.size(); ++i) {
+				REQUIRE(matrix[i].size() == names.size());
+				REQUIRE(graph.path_costs(names[i], names) == matrix[i]);
+
+				std::vector<NavGraphPath> paths = graph.search_paths(names[i], names);
+				for (unsigned int j = 0; j < names.size(); ++j) {
+					float cost = graph.search_path(names[i], names[j]).cost();
+					REQUIRE(matrix[i][j] == Approx(cost).epsilon(1e-4));
+					REQUIRE(paths[j].cost() == Approx(cost).epsilon(1e-4));
+					REQUIRE(path_valid(graph, paths[j]));
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("Path cost matrix respects constraints", "[navgraph]")
+{
+	NavGraph graph("grid");
+	graph.set_notifications_enabled(false);
+	const int width = 10;
+	for (int y = 0; y < width; ++y) {
+		for (int x = 0; x < width; ++x) {
+			graph.add_node(NavGraphNode(NavGraph::format_name("N%d_%d", x, y), x, y));
+		}
+	}
+	for (int y = 0; y < width; ++y) {
+		for (int x = 0; x < width; ++x) {
+			std::string n = NavGraph::format_name("N%d_%d", x, y);
+			if (x + 1 < width) {
+				graph.add_edge(NavGraphEdge(n, NavGraph::format_name("N%d_%d", x + 1, y)),
+				               NavGraph::EDGE_FORCE);
+			}
+			if (y + 1 < width) {
+				graph.add_edge(NavGraphEdge(n, NavGraph::format_name("N%d_%d", x, y + 1)),
+				               NavGraph::EDGE_FORCE);
+			}
+		}
+	}
+	graph.set_notifications_enabled(true);
+	graph.calc_reachability();
+	graph.set_search_table_max_nodes(1000);
+
+	std::vector<std::string> goal{"N9_0"};
+	REQUIRE(graph.path_costs("N0_0", goal)[0] == Approx(9.f));
+
+	// block the direct way along the first row, forcing a detour of two
+	NavGraphStaticListNodeConstraint *c = new NavGraphStaticListNodeConstraint("block");
+	for (int x = 1; x < width - 1; ++x) {
+		c->add_node(graph.node(NavGraph::format_name("N%d_0", x)));
+	}
+	graph.constraint_repo()->register_constraint(c);
+
+	std::vector<std::string>        names  = node_names(graph);
+	std::vector<std::vector<float>> matrix = graph.path_cost_matrix(names, names);
+	for (unsigned int i = 0; i < names.size(); i += 7) {
+		for (unsigned int j = 0; j < names.size(); j += 3) {
+			REQUIRE(matrix[i][j] == Approx(graph.search_path(names[i], names[j]).cost()));
+		}
+	}
+	REQUIRE(graph.path_costs("N0_0", goal)[0] == Approx(11.f));
+	REQUIRE(graph.path_costs("N0_0", goal, /* use constraints */ false)[0] == Approx(9.f));
+}
@@ -28,10 +28,12 @@
 #include <core/threading/wait_condition.h>
 #include <netcomm/fawkes/client.h>
 #include <netcomm/fawkes/client_handler.h>
+#include <netcomm/fawkes/compression.h>
 #include <netcomm/fawkes/message_queue.h>
 #include <netcomm/fawkes/transceiver.h>
 #include <netcomm/socket/stream.h>
 #include <netcomm/utils/exceptions.h>
+#include <netinet/in.h>
 
 #include <cstdlib>
 #include <cstring>
@@ -198,6 +200,7 @@ public:
 		parent_       = parent;
 		inbound_msgq_ = new FawkesNetworkMessageQueue();
 		recv_mutex_   = recv_mutex;
+		transceiver_  = new FawkesNetworkTransceiver();
 	}
 
 	/** Destructor. */
@@ -209,6 +212,7 @@ public:
 			inbound_msgq_->pop();
 		}
 		delete inbound_msgq_;
+		delete transceiver_;
 	}
 
 	/** Receive and process messages. */
@@ -218,7 +222,7 @@ public:
 		std::list<unsigned int> wakeup_list;
 
 		try {
-			FawkesNetworkTransceiver::recv(s_, inbound_msgq_);
+			transceiver_->recv_buffered(s_, inbound_msgq_);
 
 			MutexLocker lock(recv_mutex_);
 
@@ -291,12 +295,17 @@ private:
 	FawkesNetworkClient *      parent_;
 	FawkesNetworkMessageQueue *inbound_msgq_;
 	Mutex *                    recv_mutex_;
+	FawkesNetworkTransceiver * transceiver_;
 };
 
 /** @class FawkesNetworkClient netcomm/fawkes/client.h
  * Simple Fawkes network client. Allows access to a remote instance via the
  * network. Encapsulates all needed interaction with the network.
  *
+ * If supported by the server, large messages are compressed in both
+ * directions, see FawkesNetworkCompression and
+ * set_compression_threshold().
+ *
  * @ingroup NetComm
  * @author Tim Niemueller
  */
@@ -331,6 +340,9 @@ FawkesNetworkClient::FawkesNetworkClient(const char *host, unsigned short int po
 	connest_waitcond_    = new WaitCondition(connest_mutex_);
 	connest_             = false;
 	connest_interrupted_ = false;
+
+	compression_threshold_ = FAWKES_COMPRESSION_THRESHOLD;
+	compression_           = FAWKES_COMPRESSION_NONE;
 }
 
 /** Constructor.
@@ -363,6 +375,9 @@ FawkesNetworkClient::FawkesNetworkClient()
 	connest_waitcond_    = new WaitCondition(connest_mutex_);
 	connest_             = false;
 	connest_interrupted_ = false;
+
+	compression_threshold_ = FAWKES_COMPRESSION_THRESHOLD;
+	compression_           = FAWKES_COMPRESSION_NONE;
 }
 
 /** Constructor.
@@ -396,6 +411,9 @@ FawkesNetworkClient::FawkesNetworkClient(unsigned int id, const char *host, unsi
 	connest_waitcond_    = new WaitCondition(connest_mutex_);
 	connest_             = false;
 	connest_interrupted_ = false;
+
+	compression_threshold_ = FAWKES_COMPRESSION_THRESHOLD;
+	compression_           = FAWKES_COMPRESSION_NONE;
 }
 
 /** Destructor. */
@@ -432,6 +450,7 @@ FawkesNetworkClient::connect()
 	}
 
 	connection_died_recently = false;
+	__atomic_store_n(&compression_, FAWKES_COMPRESSION_NONE, __ATOMIC_RELEASE);
 
 	try {
 		s = new StreamSocket();
@@ -446,6 +465,9 @@ FawkesNetworkClient::connect()
 		send_slave_->start();
 		recv_slave_ = new FawkesNetworkClientRecvThread(s, this, recv_mutex_);
 		recv_slave_->start();
+		if (compression_threshold_ > 0 && FawkesNetworkCompression::supported_codecs() != 0) {
+			send_slave_->enqueue(FawkesNetworkCompression::hello());
+		}
 	} catch (SocketException &e) {
 		connection_died_recently = true;
 		if (send_slave_) {
@@ -596,7 +618,7 @@ void
 FawkesNetworkClient::enqueue(FawkesNetworkMessage *message)
 {
 	if (send_slave_)
-		send_slave_->enqueue(message);
+		send_slave_->enqueue(compressed(message));
 }
 
 /** Enqueue message to send and wait for answer. It is guaranteed that an
@@ -622,8 +644,9 @@ FawkesNetworkClient::enqueue_and_wait(FawkesNetworkMessage *message, unsigned in
 			                "component id %u",
 			                cid);
 		}
-		send_slave_->enqueue(message);
-		unsigned int cid    = message->cid();
+		unsigned int cid   = message->cid();
+		unsigned int msgid = message->msgid();
+		send_slave_->enqueue(compressed(message));
 		recv_received_[cid] = false;
 		while (!recv_received_[cid] && !connection_died_recently) {
 			if (!recv_waitcond_->reltimed_wait(timeout_sec, 0)) {
@@ -631,8 +654,8 @@ FawkesNetworkClient::enqueue_and_wait(FawkesNetworkMessage *message, unsigned in
 				recv_mutex_->unlock();
 				throw TimeoutException("Timeout reached while waiting for incoming message "
 				                       "(outgoing was %u:%u)",
-				                       message->cid(),
-				                       message->msgid());
+				                       cid,
+				                       msgid);
 			}
 		}
 		recv_received_.erase(cid);
@@ -693,6 +716,10 @@ void
 FawkesNetworkClient::dispatch_message(FawkesNetworkMessage *m)
 {
 	unsigned int cid = m->cid();
+	if (cid == FAWKES_CID_NETCOMM) {
+		handle_netcomm_message(m);
+		return;
+	}
 	handlers.lock();
 	if (handlers.find(cid) != handlers.end()) {
 		handlers[cid]->inbound_received(m, _id);
@@ -700,6 +727,41 @@ FawkesNetworkClient::dispatch_message(FawkesNetworkMessage *m)
 	handlers.unlock();
 }
 
+void
+FawkesNetworkClient::handle_netcomm_message(FawkesNetworkMessage *m)
+{
+	if (m->msgid() == MSG_NETCOMM_COMPRESSION_ACCEPT) {
+		try {
+			fawkes_compression_accept_msg_t *a = m->msgge<fawkes_compression_accept_msg_t>();
+			unsigned int                     codec = ntohl(a->codec);
+			if (!FawkesNetworkCompression::is_supported(codec)) {
+				codec = FAWKES_COMPRESSION_NONE;
+			}
+			__atomic_store_n(&compression_, codec, __ATOMIC_RELEASE);
+		} catch (TypeMismatchException &e) {
+		} // ignore, compression stays disabled
+	}
+}
+
+FawkesNetworkMessage *
+FawkesNetworkClient::compressed(FawkesNetworkMessage *m)
+{
+	unsigned int codec = __atomic_load_n(&compression_, __ATOMIC_ACQUIRE);
+	if (codec == FAWKES_COMPRESSION_NONE || compression_threshold_ == 0) {
+		return m;
+	}
+	m->pack();
+	if (m->payload_size() < compression_threshold_) {
+		return m;
+	}
+	FawkesNetworkMessage *cm = FawkesNetworkCompression::compress(m, codec);
+	if (!cm) {
+		return m;
+	}
+	m->unref();
+	return cm;
+}
+
 void
 FawkesNetworkClient::wake_handlers(unsigned int cid)
 {
@@ -852,6 +914,30 @@ FawkesNetworkClient::id() const
 	return _id;
 }
 
+/** Set compression threshold.
+ * Messages with a payload of at least the given size are sent compressed
+ * if the server supports compression. Compression is negotiated when
+ * connecting, hence the threshold must be set before connect() to enable
+ * or disable compression.
+ * @param threshold minimum payload size in bytes for messages to be
+ * compressed, 0 to disable compression in either direction
+ */
+void
+FawkesNetworkClient::set_compression_threshold(unsigned int threshold)
+{
+	compression_threshold_ = threshold;
+}
+
+/** Get compression codec.
+ * @return codec negotiated with the server for the current connection,
+ * one of fawkes_compression_codec_t
+ */
+unsigned int
+FawkesNetworkClient::compression() const
+{
+	return __atomic_load_n(&compression_, __ATOMIC_ACQUIRE);
+}
+
 /** Get the client's hostname
  * @return hostname or NULL
  */
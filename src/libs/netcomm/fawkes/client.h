@@ -83,6 +83,9 @@ public:
 
 	const char *get_hostname() const;
 
+	void         set_compression_threshold(unsigned int threshold);
+	unsigned int compression() const;
+
 private:
 	void recv();
 	void notify_of_connection_established();
@@ -90,6 +93,9 @@ private:
 
 	void wake_handlers(unsigned int cid);
 	void dispatch_message(FawkesNetworkMessage *m);
+	void handle_netcomm_message(FawkesNetworkMessage *m);
+
+	FawkesNetworkMessage *compressed(FawkesNetworkMessage *m);
 	void connection_died();
 	void set_send_slave_alive();
 	void set_recv_slave_alive();
@@ -122,6 +128,9 @@ private:
 
 	struct sockaddr *addr_;
 	socklen_t        addr_len_;
+
+	unsigned int compression_threshold_;
+	unsigned int compression_;
 };
 
 } // end namespace fawkes
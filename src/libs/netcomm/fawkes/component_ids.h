@@ -54,6 +54,9 @@
 // NetworkLogger: netcomm/utils/network_logger.h
 #define FAWKES_CID_NETWORKLOGGER 4
 
+// Connection negotiation and compression: netcomm/fawkes/compression.h
+#define FAWKES_CID_NETCOMM 5
+
 /* **** Normal component CIDs **** */
 
 #define FAWKES_CID_FIREVISION 1001
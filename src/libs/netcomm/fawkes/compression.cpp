@@ -0,0 +1,326 @@
+
+/***************************************************************************
+ *  compression.cpp - Fawkes network message payload compression
+ *
+ *  Created: Wed Oct 14 18:53:27 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <netcomm/fawkes/component_ids.h>
+#include <netcomm/fawkes/compression.h>
+#include <netinet/in.h>
+
+#include <cstdlib>
+#include <cstring>
+#ifdef HAVE_ZSTD
+#	include <zstd.h>
+#endif
+#ifdef HAVE_LZ4
+#	include <lz4.h>
+#endif
+#ifdef HAVE_ZLIB
+#	include <zlib.h>
+#endif
+
+namespace fawkes {
+
+/** Maximum uncompressed payload size accepted when decompressing. */
+#define FAWKES_COMPRESSION_MAX_RAW_SIZE (64 * 1024 * 1024)
+
+/** @class FawkesNetworkCompression <netcomm/fawkes/compression.h>
+ * Fawkes network message payload compression.
+ * Compression is negotiated per connection. After connecting, the client
+ * sends a MSG_NETCOMM_COMPRESSION_HELLO message announcing the codecs it
+ * supports. The server selects one of them and replies with
+ * MSG_NETCOMM_COMPRESSION_ACCEPT. Afterwards each side may replace
+ * messages whose payload exceeds a size threshold by a
+ * MSG_NETCOMM_COMPRESSED message, which carries the original component
+ * and message ID and the compressed payload. The receiving transceiver
+ * restores the original message before it is dispatched, hence handlers
+ * never see compressed messages. Peers which do not know about
+ * compression ignore the hello, as they have no handler for
+ * FAWKES_CID_NETCOMM, and thus never receive compressed messages.
+ *
+ * Which codecs are available depends on the libraries found at build
+ * time. Zstandard is preferred over LZ4, which is preferred over zlib.
+ *
+ * @ingroup NetComm
+ * @author agent
+ */
+
+/** Get codecs supported by this build.
+ * @return bit field with bit (1 << codec) set for each supported codec
+ */
+unsigned int
+FawkesNetworkCompression::supported_codecs()
+{
+	unsigned int codecs = 0;
+#ifdef HAVE_ZSTD
+	codecs |= (1 << FAWKES_COMPRESSION_ZSTD);
+#endif
+#ifdef HAVE_LZ4
+	codecs |= (1 << FAWKES_COMPRESSION_LZ4);
+#endif
+#ifdef HAVE_ZLIB
+	codecs |= (1 << FAWKES_COMPRESSION_ZLIB);
+#endif
+	return codecs;
+}
+
+/** Check if a codec is supported by this build.
+ * Codecs received from the network are checked against the number of known
+ * codecs first, so that an arbitrary value never results in an invalid shift.
+ * @param codec codec to check
+ * @return true if the codec is supported, false otherwise
+ */
+bool
+FawkesNetworkCompression::is_supported(unsigned int codec)
+{
+	return (codec < FAWKES_COMPRESSION_NUM_CODECS) && (supported_codecs() & (1u << codec));
+}
+
+/** Select codec to use.
+ * @param offered_codecs bit field of codecs supported by the remote side
+ * @return preferred codec supported by both sides, FAWKES_COMPRESSION_NONE
+ * if there is none
+ */
+unsigned int
+FawkesNetworkCompression::select_codec(unsigned int offered_codecs)
+{
+	const unsigned int common = offered_codecs & supported_codecs();
+	if (common & (1 << FAWKES_COMPRESSION_ZSTD)) {
+		return FAWKES_COMPRESSION_ZSTD;
+	} else if (common & (1 << FAWKES_COMPRESSION_LZ4)) {
+		return FAWKES_COMPRESSION_LZ4;
+	} else if (common & (1 << FAWKES_COMPRESSION_ZLIB)) {
+		return FAWKES_COMPRESSION_ZLIB;
+	} else {
+		return FAWKES_COMPRESSION_NONE;
+	}
+}
+
+/** Get name of codec.
+ * @param codec codec to get the name for
+ * @return human-readable name of codec
+ */
+const char *
+FawkesNetworkCompression::codec_name(unsigned int codec)
+{
+	switch (codec) {
+	case FAWKES_COMPRESSION_NONE: return "none";
+	case FAWKES_COMPRESSION_ZSTD: return "zstd";
+	case FAWKES_COMPRESSION_LZ4: return "lz4";
+	case FAWKES_COMPRESSION_ZLIB: return "zlib";
+	default: return "unknown";
+	}
+}
+
+/** Compress a message.
+ * The message is packed if that has not happened, yet. The message itself
+ * is not modified.
+ * @param msg message to compress
+ * @param codec codec to use, must be one of supported_codecs()
+ * @return new compressed message to the same client, or NULL if the codec
+ * is not supported or compression did not reduce the size
+ */
+FawkesNetworkMessage *
+FawkesNetworkCompression::compress(FawkesNetworkMessage *msg, unsigned int codec)
+{
+	if (!is_supported(codec)) {
+		return NULL;
+	}
+
+	msg->pack();
+	const size_t raw_size = msg->payload_size();
+	if (raw_size == 0 || raw_size > FAWKES_COMPRESSION_MAX_RAW_SIZE) {
+		return NULL;
+	}
+	const char *src = (const char *)msg->payload();
+
+	size_t bound = 0;
+	switch (codec) {
+#ifdef HAVE_ZSTD
+	case FAWKES_COMPRESSION_ZSTD: bound = ZSTD_compressBound(raw_size); break;
+#endif
+#ifdef HAVE_LZ4
+	case FAWKES_COMPRESSION_LZ4: bound = LZ4_compressBound(raw_size); break;
+#endif
+#ifdef HAVE_ZLIB
+	case FAWKES_COMPRESSION_ZLIB: bound = compressBound(raw_size); break;
+#endif
+	default: return NULL;
+	}
+
+	const size_t hsize = sizeof(fawkes_compressed_header_t);
+	char *       buf   = (char *)malloc(hsize + bound);
+	char *       dst   = buf + hsize;
+	size_t       csize = 0;
+
+	switch (codec) {
+#ifdef HAVE_ZSTD
+	case FAWKES_COMPRESSION_ZSTD: {
+		size_t rv = ZSTD_compress(dst, bound, src, raw_size, /* level */ 1);
+		csize     = ZSTD_isError(rv) ? 0 : rv;
+	} break;
+#endif
+#ifdef HAVE_LZ4
+	case FAWKES_COMPRESSION_LZ4: {
+		int rv = LZ4_compress_default(src, dst, raw_size, bound);
+		csize  = (rv > 0) ? rv : 0;
+	} break;
+#endif
+#ifdef HAVE_ZLIB
+	case FAWKES_COMPRESSION_ZLIB: {
+		uLongf len = bound;
+		int    rv  = compress2((Bytef *)dst, &len, (const Bytef *)src, raw_size, Z_BEST_SPEED);
+		csize      = (rv == Z_OK) ? len : 0;
+	} break;
+#endif
+	default: break;
+	}
+
+	if (csize == 0 || hsize + csize >= raw_size) {
+		free(buf);
+		return NULL;
+	}
+
+	fawkes_compressed_header_t *h = (fawkes_compressed_header_t *)buf;
+	h->cid                        = htons(msg->cid());
+	h->msg_id                     = htons(msg->msgid());
+	h->raw_size                   = htonl(raw_size);
+	h->codec                      = codec;
+	memset(h->reserved, 0, sizeof(h->reserved));
+
+	buf = (char *)realloc(buf, hsize + csize);
+	return new FawkesNetworkMessage(
+	  msg->clid(), FAWKES_CID_NETCOMM, MSG_NETCOMM_COMPRESSED, buf, hsize + csize);
+}
+
+/** Check if message is compressed.
+ * @param msg message as received from the network
+ * @return true if the message is a compressed message, false otherwise
+ */
+bool
+FawkesNetworkCompression::is_compressed(const fawkes_message_t &msg)
+{
+	return ((ntohs(msg.header.cid) == FAWKES_CID_NETCOMM)
+	        && (ntohs(msg.header.msg_id) == MSG_NETCOMM_COMPRESSED));
+}
+
+/** Decompress a message.
+ * Replaces header and payload of the given compressed message by the
+ * original ones. The compressed payload is freed.
+ * @param msg compressed message as received from the network, the payload
+ * must have been allocated with malloc()
+ * @exception Exception thrown if the message cannot be decompressed, msg
+ * is unchanged in that case
+ */
+void
+FawkesNetworkCompression::decompress(fawkes_message_t &msg)
+{
+	const size_t hsize        = sizeof(fawkes_compressed_header_t);
+	const size_t payload_size = ntohl(msg.header.payload_size);
+	if (payload_size < hsize) {
+		throw Exception("Compressed message too small (%zu bytes)", payload_size);
+	}
+
+	const fawkes_compressed_header_t *h        = (const fawkes_compressed_header_t *)msg.payload;
+	const size_t                      raw_size = ntohl(h->raw_size);
+	const unsigned int                codec    = h->codec;
+	if (!is_supported(codec)) {
+		throw Exception("Unsupported compression codec %u", codec);
+	}
+	if (raw_size == 0 || raw_size > FAWKES_COMPRESSION_MAX_RAW_SIZE) {
+		throw Exception("Invalid uncompressed size %zu", raw_size);
+	}
+
+	const char * src   = (const char *)msg.payload + hsize;
+	const size_t csize = payload_size - hsize;
+	char *       dst   = (char *)malloc(raw_size);
+	bool         ok    = false;
+
+	switch (codec) {
+#ifdef HAVE_ZSTD
+	case FAWKES_COMPRESSION_ZSTD: {
+		size_t rv = ZSTD_decompress(dst, raw_size, src, csize);
+		ok        = !ZSTD_isError(rv) && (rv == raw_size);
+	} break;
+#endif
+#ifdef HAVE_LZ4
+	case FAWKES_COMPRESSION_LZ4: {
+		int rv = LZ4_decompress_safe(src, dst, csize, raw_size);
+		ok     = (rv >= 0) && ((size_t)rv == raw_size);
+	} break;
+#endif
+#ifdef HAVE_ZLIB
+	case FAWKES_COMPRESSION_ZLIB: {
+		uLongf len = raw_size;
+		int    rv  = uncompress((Bytef *)dst, &len, (const Bytef *)src, csize);
+		ok         = (rv == Z_OK) && (len == raw_size);
+	} break;
+#endif
+	default: break;
+	}
+
+	if (!ok) {
+		free(dst);
+		throw Exception("Failed to decompress %s message", codec_name(codec));
+	}
+
+	msg.header.cid          = h->cid;
+	msg.header.msg_id       = h->msg_id;
+	msg.header.payload_size = htonl(raw_size);
+	free(msg.payload);
+	msg.payload = dst;
+}
+
+/** Create compression hello message.
+ * @return message announcing the codecs supported by this build
+ */
+FawkesNetworkMessage *
+FawkesNetworkCompression::hello()
+{
+	fawkes_compression_hello_msg_t *h =
+	  (fawkes_compression_hello_msg_t *)malloc(sizeof(fawkes_compression_hello_msg_t));
+	h->codecs = htonl(supported_codecs());
+	return new FawkesNetworkMessage(FAWKES_CID_NETCOMM,
+	                                MSG_NETCOMM_COMPRESSION_HELLO,
+	                                h,
+	                                sizeof(fawkes_compression_hello_msg_t));
+}
+
+/** Create compression accept message.
+ * @param clid ID of client to send the message to
+ * @param codec selected codec, FAWKES_COMPRESSION_NONE to deny compression
+ * @return message announcing the selected codec
+ */
+FawkesNetworkMessage *
+FawkesNetworkCompression::accept(unsigned int clid, unsigned int codec)
+{
+	fawkes_compression_accept_msg_t *a =
+	  (fawkes_compression_accept_msg_t *)malloc(sizeof(fawkes_compression_accept_msg_t));
+	a->codec = htonl(codec);
+	return new FawkesNetworkMessage(clid,
+	                                FAWKES_CID_NETCOMM,
+	                                MSG_NETCOMM_COMPRESSION_ACCEPT,
+	                                a,
+	                                sizeof(fawkes_compression_accept_msg_t));
+}
+
+} // end namespace fawkes
@@ -0,0 +1,100 @@
+
+/***************************************************************************
+ *  compression.h - Fawkes network message payload compression
+ *
+ *  Created: Wed Oct 14 18:53:27 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _NETCOMM_FAWKES_COMPRESSION_H_
+#define _NETCOMM_FAWKES_COMPRESSION_H_
+
+#include <netcomm/fawkes/message.h>
+#include <stdint.h>
+
+namespace fawkes {
+
+/** Default minimum payload size in bytes for a message to be compressed. */
+#define FAWKES_COMPRESSION_THRESHOLD 1024
+
+/** Compression codec. */
+typedef enum {
+	FAWKES_COMPRESSION_NONE = 0, /**< no compression */
+	FAWKES_COMPRESSION_ZSTD = 1, /**< Zstandard */
+	FAWKES_COMPRESSION_LZ4  = 2, /**< LZ4 */
+	FAWKES_COMPRESSION_ZLIB = 3  /**< zlib deflate */
+} fawkes_compression_codec_t;
+
+/** Number of codecs including FAWKES_COMPRESSION_NONE. */
+#define FAWKES_COMPRESSION_NUM_CODECS 4
+
+/** Client announces supported codecs, payload is fawkes_compression_hello_msg_t. */
+#define MSG_NETCOMM_COMPRESSION_HELLO 1
+/** Server reply to hello, payload is fawkes_compression_accept_msg_t. */
+#define MSG_NETCOMM_COMPRESSION_ACCEPT 2
+/** Compressed message, payload is fawkes_compressed_header_t and data. */
+#define MSG_NETCOMM_COMPRESSED 3
+
+#pragma pack(push, 4)
+
+/** Compression hello message. */
+typedef struct
+{
+	uint32_t codecs; /**< bit (1 << codec) set for each supported codec, network byte order */
+} fawkes_compression_hello_msg_t;
+
+/** Compression accept message. */
+typedef struct
+{
+	uint32_t codec; /**< codec selected by the server, 0 for none, network byte order */
+} fawkes_compression_accept_msg_t;
+
+/** Header of a compressed message.
+ * Followed by the compressed payload of the original message.
+ * All fields are in network byte order.
+ */
+typedef struct
+{
+	uint16_t cid;         /**< component ID of original message */
+	uint16_t msg_id;      /**< message ID of original message */
+	uint32_t raw_size;    /**< uncompressed payload size */
+	uint8_t  codec;       /**< codec, one of fawkes_compression_codec_t */
+	uint8_t  reserved[3]; /**< reserved for future use, zero */
+} fawkes_compressed_header_t;
+
+#pragma pack(pop)
+
+class FawkesNetworkCompression
+{
+public:
+	static unsigned int supported_codecs();
+	static bool         is_supported(unsigned int codec);
+	static unsigned int select_codec(unsigned int offered_codecs);
+	static const char * codec_name(unsigned int codec);
+
+	static FawkesNetworkMessage *compress(FawkesNetworkMessage *msg, unsigned int codec);
+	static bool                  is_compressed(const fawkes_message_t &msg);
+	static void                  decompress(fawkes_message_t &msg);
+
+	static FawkesNetworkMessage *hello();
+	static FawkesNetworkMessage *accept(unsigned int clid, unsigned int codec);
+};
+
+} // end namespace fawkes
+
+#endif
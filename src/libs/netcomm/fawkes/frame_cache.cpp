@@ -0,0 +1,179 @@
+
+/***************************************************************************
+ *  frame_cache.cpp - Cache of pre-serialized Fawkes network messages
+ *
+ *  Created: Wed Oct 14 18:48:55 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <netcomm/fawkes/frame_cache.h>
+#include <netcomm/fawkes/message.h>
+
+namespace fawkes {
+
+/** @class FawkesNetworkFrameCache <netcomm/fawkes/frame_cache.h>
+ * Cache of pre-serialized Fawkes network messages.
+ * Handlers which repeatedly send the same large message to different
+ * clients, like interface or configuration lists requested by every tool
+ * at startup, can keep the packed message here. Messages retrieved from
+ * the cache share the payload of the cached message, hence it is neither
+ * rebuilt nor copied.
+ *
+ * Entries are identified by an arbitrary key, typically the message ID.
+ * An entry is dropped when invalidated or once it is older than the
+ * maximum age, if one is set. To avoid storing a message that was built
+ * from data which changed concurrently, get the generation() before
+ * building the message and pass it to put(). If the cache has been
+ * invalidated in the meantime the message is not stored.
+ *
+ * @ingroup NetComm
+ */
+
+/** Constructor.
+ * @param max_age_msec maximum age of cached messages in milliseconds,
+ * 0 to keep them until invalidated
+ */
+FawkesNetworkFrameCache::FawkesNetworkFrameCache(unsigned int max_age_msec)
+{
+	mutex_        = new Mutex();
+	max_age_usec_ = max_age_msec * 1000l;
+	generation_   = 0;
+	hits_         = 0;
+	misses_       = 0;
+}
+
+/** Destructor. */
+FawkesNetworkFrameCache::~FawkesNetworkFrameCache()
+{
+	clear();
+	delete mutex_;
+}
+
+/** Get cached message.
+ * @param key key of the message
+ * @param clid client ID for the returned message
+ * @return new message which shares the payload of the cached message, the
+ * caller takes ownership, or NULL if no valid message is cached
+ */
+FawkesNetworkMessage *
+FawkesNetworkFrameCache::get(unsigned int key, unsigned int clid)
+{
+	MutexLocker lock(mutex_);
+	std::map<unsigned int, Entry>::iterator f = frames_.find(key);
+	if (f != frames_.end() && max_age_usec_ > 0) {
+		Time now;
+		if ((now - &f->second.stamp) * 1000000. > max_age_usec_) {
+			f->second.msg->unref();
+			frames_.erase(f);
+			f = frames_.end();
+		}
+	}
+	if (f == frames_.end()) {
+		++misses_;
+		return NULL;
+	}
+	++hits_;
+	return new FawkesNetworkMessage(clid, f->second.msg);
+}
+
+/** Store message.
+ * The message is packed and referenced, the caller keeps its reference.
+ * @param key key of the message
+ * @param msg message to store
+ * @param generation generation obtained before building the message, the
+ * message is not stored if the cache has been invalidated since
+ */
+void
+FawkesNetworkFrameCache::put(unsigned int key, FawkesNetworkMessage *msg, unsigned int generation)
+{
+	MutexLocker lock(mutex_);
+	if (generation != generation_)
+		return;
+
+	msg->pack();
+	msg->ref();
+	std::map<unsigned int, Entry>::iterator f = frames_.find(key);
+	if (f != frames_.end()) {
+		f->second.msg->unref();
+	}
+	Entry &e = frames_[key];
+	e.msg    = msg;
+	e.stamp.stamp();
+}
+
+/** Get current generation.
+ * The generation changes whenever the cache is invalidated.
+ * @return current generation
+ */
+unsigned int
+FawkesNetworkFrameCache::generation() const
+{
+	MutexLocker lock(mutex_);
+	return generation_;
+}
+
+/** Invalidate cached message.
+ * @param key key of the message to drop
+ */
+void
+FawkesNetworkFrameCache::invalidate(unsigned int key)
+{
+	MutexLocker lock(mutex_);
+	++generation_;
+	std::map<unsigned int, Entry>::iterator f = frames_.find(key);
+	if (f != frames_.end()) {
+		f->second.msg->unref();
+		frames_.erase(f);
+	}
+}
+
+/** Drop all cached messages. */
+void
+FawkesNetworkFrameCache::clear()
+{
+	MutexLocker lock(mutex_);
+	++generation_;
+	for (std::map<unsigned int, Entry>::iterator f = frames_.begin(); f != frames_.end(); ++f) {
+		f->second.msg->unref();
+	}
+	frames_.clear();
+}
+
+/** Get number of cache hits.
+ * @return number of get() calls which returned a cached message
+ */
+unsigned int
+FawkesNetworkFrameCache::hits() const
+{
+	MutexLocker lock(mutex_);
+	return hits_;
+}
+
+/** Get number of cache misses.
+ * @return number of get() calls which found no valid message
+ */
+unsigned int
+FawkesNetworkFrameCache::misses() const
+{
+	MutexLocker lock(mutex_);
+	return misses_;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,71 @@
+
+/***************************************************************************
+ *  frame_cache.h - Cache of pre-serialized Fawkes network messages
+ *
+ *  Created: Wed Oct 14 18:48:55 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _NETCOMM_FAWKES_FRAME_CACHE_H_
+#define _NETCOMM_FAWKES_FRAME_CACHE_H_
+
+#include <utils/time/time.h>
+
+#include <map>
+
+namespace fawkes {
+
+class FawkesNetworkMessage;
+class Mutex;
+
+class FawkesNetworkFrameCache
+{
+public:
+	FawkesNetworkFrameCache(unsigned int max_age_msec = 0);
+	~FawkesNetworkFrameCache();
+
+	FawkesNetworkMessage *get(unsigned int key, unsigned int clid);
+	void                  put(unsigned int key, FawkesNetworkMessage *msg, unsigned int generation);
+
+	unsigned int generation() const;
+	void         invalidate(unsigned int key);
+	void         clear();
+
+	unsigned int hits() const;
+	unsigned int misses() const;
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		FawkesNetworkMessage *msg;
+		Time                  stamp;
+	} Entry;
+	/// @endcond
+
+	Mutex *                       mutex_;
+	std::map<unsigned int, Entry> frames_;
+	long int                      max_age_usec_;
+	unsigned int                  generation_;
+	unsigned int                  hits_;
+	unsigned int                  misses_;
+};
+
+} // end namespace fawkes
+
+#endif
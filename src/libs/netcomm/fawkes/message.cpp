@@ -76,6 +76,12 @@ FawkesNetworkMessageTooBigException::FawkesNetworkMessageTooBigException(size_t
  * FawkesNetworkMessage *m = new FawkesNetworkMessage(clid, cid, msgid, u, sizeof(unsigned int));
  * @endcode
  *
+ * Once a message has been packed for sending it must no longer be modified.
+ * Complex content is serialized only once, no matter to how many clients
+ * the message is sent. A packed message can also be the source of other
+ * messages which share its payload without copying it, for example to send
+ * the same data to several clients with different client IDs.
+ *
  * @ingroup NetComm
  * @author Tim Niemueller
  */
@@ -89,6 +95,8 @@ FawkesNetworkMessage::FawkesNetworkMessage()
 	memset(&_msg, 0, sizeof(_msg));
 	_clid    = 0;
 	_content = NULL;
+	_packed  = false;
+	_shared  = NULL;
 }
 
 /** Constructor to set message and client ID.
@@ -98,6 +106,8 @@ FawkesNetworkMessage::FawkesNetworkMessage()
 FawkesNetworkMessage::FawkesNetworkMessage(unsigned int clid, fawkes_message_t &msg)
 {
 	_content = NULL;
+	_packed  = false;
+	_shared  = NULL;
 	_clid    = clid;
 	memcpy(&_msg, &msg, sizeof(fawkes_message_t));
 }
@@ -109,6 +119,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int clid, fawkes_message_t &
 FawkesNetworkMessage::FawkesNetworkMessage(fawkes_message_t &msg)
 {
 	_content = NULL;
+	_packed  = false;
+	_shared  = NULL;
 	_clid    = 0;
 	memcpy(&_msg, &msg, sizeof(fawkes_message_t));
 }
@@ -127,6 +139,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int cid,
 {
 	_clid    = 0;
 	_content = NULL;
+	_packed  = false;
+	_shared  = NULL;
 	if (payload_size > 0xFFFFFFFF) {
 		// cannot carry that many bytes
 		throw FawkesNetworkMessageTooBigException(payload_size);
@@ -148,6 +162,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int cid,
                                            size_t             payload_size)
 {
 	_content = NULL;
+	_packed  = false;
+	_shared  = NULL;
 	_clid    = 0;
 	if (payload_size > 0xFFFFFFFF) {
 		// cannot carry that many bytes
@@ -167,6 +183,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int cid,
 FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int cid, unsigned short int msg_id)
 {
 	_content                 = NULL;
+	_packed                  = false;
+	_shared                  = NULL;
 	_clid                    = 0;
 	_msg.header.cid          = htons(cid);
 	_msg.header.msg_id       = htons(msg_id);
@@ -185,6 +203,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int           cid,
                                            FawkesNetworkMessageContent *content)
 {
 	_content                 = content;
+	_packed                  = false;
+	_shared                  = NULL;
 	_clid                    = 0;
 	_msg.header.cid          = htons(cid);
 	_msg.header.msg_id       = htons(msg_id);
@@ -204,6 +224,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int                 clid,
                                            FawkesNetworkMessageContent *content)
 {
 	_content                 = content;
+	_packed                  = false;
+	_shared                  = NULL;
 	_clid                    = clid;
 	_msg.header.cid          = htons(cid);
 	_msg.header.msg_id       = htons(msg_id);
@@ -225,6 +247,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int       clid,
                                            size_t             payload_size)
 {
 	_content = NULL;
+	_packed  = false;
+	_shared  = NULL;
 	if (payload_size > 0xFFFFFFFF) {
 		// cannot carry that many bytes
 		throw FawkesNetworkMessageTooBigException(payload_size);
@@ -246,6 +270,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int       clid,
                                            unsigned short int msg_id)
 {
 	_content                 = NULL;
+	_packed                  = false;
+	_shared                  = NULL;
 	_clid                    = clid;
 	_msg.header.cid          = htons(cid);
 	_msg.header.msg_id       = htons(msg_id);
@@ -253,12 +279,36 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int       clid,
 	_msg.payload             = NULL;
 }
 
+/** Constructor to share the payload of another message.
+ * The new message has the same component ID, message ID and payload as
+ * @p shared, but its own client ID. The payload is not copied, rather the
+ * shared message is referenced until this message is deleted. The payload
+ * must not be modified as long as any of the messages exist.
+ * @param clid client ID
+ * @param shared message to share the payload of, it is packed if that has
+ * not been done before
+ */
+FawkesNetworkMessage::FawkesNetworkMessage(unsigned int clid, FawkesNetworkMessage *shared)
+{
+	shared->pack();
+	shared->ref();
+	_content = NULL;
+	_packed  = true;
+	_shared  = shared;
+	_clid    = clid;
+	memcpy(&_msg, &(shared->_msg), sizeof(fawkes_message_t));
+}
+
 /** Destructor.
  * This destructor also frees the payload buffer if set!
  */
 FawkesNetworkMessage::~FawkesNetworkMessage()
 {
-	if (_content == NULL) {
+	if (_shared != NULL) {
+		// payload belongs to the shared message
+		_shared->unref();
+		_shared = NULL;
+	} else if (_content == NULL) {
 		if (_msg.payload != NULL) {
 			free(_msg.payload);
 			_msg.payload = NULL;
@@ -381,21 +431,36 @@ void
 FawkesNetworkMessage::set_content(FawkesNetworkMessageContent *content)
 {
 	_content = content;
+	_packed  = false;
 }
 
 /** Pack data for sending.
  * If complex message sending is required (message content object has been set)
  * then serialize() is called for the content and the message is prepared for
- * sending.
+ * sending. The content is serialized only on the first call, afterwards the
+ * message is considered immutable.
  */
 void
 FawkesNetworkMessage::pack()
 {
+	if (_packed)
+		return;
 	if (_content != NULL) {
 		_content->serialize();
 		_msg.payload             = _content->payload();
 		_msg.header.payload_size = htonl(_content->payload_size());
 	}
+	_packed = true;
+}
+
+/** Check if message has been packed.
+ * @return true if pack() has been called or the message shares the payload
+ * of another message, false otherwise
+ */
+bool
+FawkesNetworkMessage::packed() const
+{
+	return _packed;
 }
 
 } // end namespace fawkes
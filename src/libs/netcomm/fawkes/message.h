@@ -97,6 +97,7 @@ public:
 	                     FawkesNetworkMessageContent *content);
 	FawkesNetworkMessage(unsigned short int cid, unsigned short int msg_id, size_t payload_size);
 	FawkesNetworkMessage(unsigned short int cid, unsigned short int msg_id);
+	FawkesNetworkMessage(unsigned int clid, FawkesNetworkMessage *shared);
 	FawkesNetworkMessage();
 
 	virtual ~FawkesNetworkMessage();
@@ -176,6 +177,7 @@ public:
 	void set_content(FawkesNetworkMessageContent *content);
 
 	void pack();
+	bool packed() const;
 
 private:
 	void init_cid_msgid(unsigned short int cid, unsigned short int msg_id);
@@ -185,6 +187,8 @@ private:
 	fawkes_message_t _msg;
 
 	FawkesNetworkMessageContent *_content;
+	bool                         _packed;
+	FawkesNetworkMessage *       _shared;
 };
 
 } // end namespace fawkes
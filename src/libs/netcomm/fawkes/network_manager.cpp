@@ -56,6 +56,11 @@ namespace fawkes {
  * empty string or :: to listen on any local address
  * @param fawkes_port port to listen on for Fawkes network connections
  * @param service_name Avahi service name for Fawkes network service
+ * @param event_loop_workers number of event loop worker threads serving
+ * all clients, 0 to run a thread per client
+ * @param compression_threshold minimum payload size in bytes for messages
+ * to be compressed for clients which requested compression, 0 to deny
+ * compression
  */
 FawkesNetworkManager::FawkesNetworkManager(ThreadCollector *  thread_collector,
                                            bool               enable_ipv4,
@@ -63,12 +68,20 @@ FawkesNetworkManager::FawkesNetworkManager(ThreadCollector *  thread_collector,
                                            const std::string &listen_ipv4,
                                            const std::string &listen_ipv6,
                                            unsigned short int fawkes_port,
-                                           const char *       service_name)
+                                           const char *       service_name,
+                                           unsigned int       event_loop_workers,
+                                           unsigned int       compression_threshold)
 {
 	fawkes_port_           = fawkes_port;
 	thread_collector_      = thread_collector;
-	fawkes_network_thread_ = new FawkesNetworkServerThread(
-	  enable_ipv4, enable_ipv6, listen_ipv4, listen_ipv6, fawkes_port_, thread_collector_);
+	fawkes_network_thread_ = new FawkesNetworkServerThread(enable_ipv4,
+	                                                       enable_ipv6,
+	                                                       listen_ipv4,
+	                                                       listen_ipv6,
+	                                                       fawkes_port_,
+	                                                       thread_collector_,
+	                                                       event_loop_workers,
+	                                                       compression_threshold);
 	thread_collector_->add(fawkes_network_thread_);
 #ifdef HAVE_AVAHI
 	avahi_thread_      = new AvahiThread(enable_ipv4, enable_ipv6);
@@ -80,6 +93,8 @@ FawkesNetworkManager::FawkesNetworkManager(ThreadCollector *  thread_collector,
 	  new NetworkService(nnresolver_, service_name, "_fawkes._tcp", fawkes_port_);
 	avahi_thread_->publish_service(fawkes_service);
 	delete fawkes_service;
+	// cache the hosts of all Fawkes instances on the network
+	avahi_thread_->watch_service("_fawkes._tcp", nnresolver_);
 #else
 	service_publisher_ = new DummyServicePublisher();
 	service_browser_   = new DummyServiceBrowser();
@@ -93,6 +108,7 @@ FawkesNetworkManager::~FawkesNetworkManager()
 	thread_collector_->remove(fawkes_network_thread_);
 	delete fawkes_network_thread_;
 #ifdef HAVE_AVAHI
+	avahi_thread_->unwatch_service("_fawkes._tcp", nnresolver_);
 	thread_collector_->remove(avahi_thread_);
 	delete avahi_thread_;
 #else
@@ -24,6 +24,8 @@
 #ifndef _FAWKES_NETWORK_MANAGER_H_
 #define _FAWKES_NETWORK_MANAGER_H_
 
+#include <netcomm/fawkes/compression.h>
+
 #include <string>
 
 namespace fawkes {
@@ -45,7 +47,9 @@ public:
 	                     const std::string &listen_ipv4,
 	                     const std::string &listen_ipv6,
 	                     unsigned short int fawkes_port,
-	                     const char *       service_name);
+	                     const char *       service_name,
+	                     unsigned int       event_loop_workers    = 0,
+	                     unsigned int       compression_threshold = FAWKES_COMPRESSION_THRESHOLD);
 	~FawkesNetworkManager();
 
 	FawkesNetworkHub *   hub();
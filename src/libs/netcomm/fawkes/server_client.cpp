@@ -0,0 +1,89 @@
+
+/***************************************************************************
+ *  server_client.cpp - Client connection of the Fawkes network server
+ *
+ *  Created: Wed Oct 14 18:45:30 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <netcomm/fawkes/server_client.h>
+
+namespace fawkes {
+
+/** @class FawkesNetworkServerClient <netcomm/fawkes/server_client.h>
+ * Client connection of the Fawkes network server.
+ * The FawkesNetworkServerThread keeps one instance per connected client,
+ * either a FawkesNetworkServerClientThread or a connection served by the
+ * FawkesNetworkServerEventLoop.
+ *
+ * @ingroup NetComm
+ *
+ * @fn unsigned int FawkesNetworkServerClient::clid() const = 0
+ * Get client ID.
+ * @return client ID
+ *
+ * @fn void FawkesNetworkServerClient::set_clid(unsigned int client_id) = 0
+ * Set client ID.
+ * @param client_id new client ID
+ *
+ * @fn bool FawkesNetworkServerClient::alive() const = 0
+ * Check aliveness of connection.
+ * @return true if connection is still alive, false otherwise.
+ *
+ * @fn void FawkesNetworkServerClient::enqueue(FawkesNetworkMessage *msg) = 0
+ * Enqueue message to outbound queue.
+ * This method takes ownership of the message.
+ * @param msg message to enqueue
+ *
+ * @fn void FawkesNetworkServerClient::force_send() = 0
+ * Force sending of all pending outbound messages.
+ * Blocks until all messages queued so far have been sent.
+ */
+
+/** Constructor. */
+FawkesNetworkServerClient::FawkesNetworkServerClient()
+{
+	compression_ = 0;
+}
+
+/** Virtual empty destructor. */
+FawkesNetworkServerClient::~FawkesNetworkServerClient()
+{
+}
+
+/** Get compression codec.
+ * @return codec negotiated for messages sent to this client, one of
+ * fawkes_compression_codec_t
+ */
+unsigned int
+FawkesNetworkServerClient::compression() const
+{
+	return __atomic_load_n(&compression_, __ATOMIC_ACQUIRE);
+}
+
+/** Set compression codec.
+ * @param codec codec to use for messages sent to this client, one of
+ * fawkes_compression_codec_t
+ */
+void
+FawkesNetworkServerClient::set_compression(unsigned int codec)
+{
+	__atomic_store_n(&compression_, codec, __ATOMIC_RELEASE);
+}
+
+} // end namespace fawkes
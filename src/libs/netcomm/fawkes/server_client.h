@@ -0,0 +1,53 @@
+
+/***************************************************************************
+ *  server_client.h - Client connection of the Fawkes network server
+ *
+ *  Created: Wed Oct 14 18:45:30 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _NETCOMM_FAWKES_SERVER_CLIENT_H_
+#define _NETCOMM_FAWKES_SERVER_CLIENT_H_
+
+namespace fawkes {
+
+class FawkesNetworkMessage;
+
+class FawkesNetworkServerClient
+{
+public:
+	FawkesNetworkServerClient();
+	virtual ~FawkesNetworkServerClient();
+
+	virtual unsigned int clid() const                     = 0;
+	virtual void         set_clid(unsigned int client_id) = 0;
+
+	virtual bool alive() const                      = 0;
+	virtual void enqueue(FawkesNetworkMessage *msg) = 0;
+	virtual void force_send()                       = 0;
+
+	unsigned int compression() const;
+	void         set_compression(unsigned int codec);
+
+private:
+	unsigned int compression_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -24,6 +24,7 @@
 #include <core/exceptions/system.h>
 #include <core/threading/mutex.h>
 #include <core/threading/wait_condition.h>
+#include <core/utils/mpmc_ring_buffer.h>
 #include <netcomm/fawkes/message_queue.h>
 #include <netcomm/fawkes/server_client_thread.h>
 #include <netcomm/fawkes/server_thread.h>
@@ -31,14 +32,22 @@
 #include <netcomm/socket/stream.h>
 #include <netcomm/utils/exceptions.h>
 
+#include <atomic>
 #include <unistd.h>
 
 namespace fawkes {
 
+/** Number of outbound messages which can be enqueued without locking. */
+#define FAWKES_OUTBOUND_QUEUE_SIZE 512
+
 /** @class FawkesNetworkServerClientSendThread <netcomm/fawkes/server_client_thread.h>
  * Sending thread for a Fawkes client connected to the server.
  * This thread is spawned for each client connected to the server to handle the
- * server-side sending
+ * server-side sending.
+ * Messages are enqueued to a lock-free ring buffer. Only if it is
+ * full they are put to a mutex-protected overflow queue, and thereafter
+ * until the sending thread drained the overflow queue to keep the order
+ * of messages.
  * @ingroup NetComm
  * @author Tim Niemueller
  */
@@ -56,24 +65,28 @@ public:
 		s_                 = s;
 		parent_            = parent;
 		outbound_mutex_    = new Mutex();
-		outbound_msgqs_[0] = new FawkesNetworkMessageQueue();
-		outbound_msgqs_[1] = new FawkesNetworkMessageQueue();
-		outbound_active_   = 0;
-		outbound_msgq_     = outbound_msgqs_[0];
+		outbound_ring_     = new MpmcRingBuffer<FawkesNetworkMessage *>(FAWKES_OUTBOUND_QUEUE_SIZE);
+		outbound_overflow_ = new FawkesNetworkMessageQueue();
+		outbound_msgq_     = new FawkesNetworkMessageQueue();
+		outbound_overflowing_.store(false);
 	}
 
 	/** Destructor. */
 	~FawkesNetworkServerClientSendThread()
 	{
+		FawkesNetworkMessage *m;
+		while (outbound_ring_->try_pop(m)) {
+			m->unref();
+		}
+		FawkesNetworkMessageQueue *queues[2] = {outbound_overflow_, outbound_msgq_};
 		for (unsigned int i = 0; i < 2; ++i) {
-			while (!outbound_msgqs_[i]->empty()) {
-				FawkesNetworkMessage *m = outbound_msgqs_[i]->front();
-				m->unref();
-				outbound_msgqs_[i]->pop();
+			while (!queues[i]->empty()) {
+				queues[i]->front()->unref();
+				queues[i]->pop();
 			}
+			delete queues[i];
 		}
-		delete outbound_msgqs_[0];
-		delete outbound_msgqs_[1];
+		delete outbound_ring_;
 		delete outbound_mutex_;
 	}
 
@@ -83,21 +96,33 @@ public:
 		if (!parent_->alive())
 			return;
 
-		while (outbound_havemore_) {
-			outbound_mutex_->lock();
-			outbound_havemore_           = false;
-			FawkesNetworkMessageQueue *q = outbound_msgq_;
-			outbound_active_             = 1 - outbound_active_;
-			outbound_msgq_               = outbound_msgqs_[outbound_active_];
-			outbound_mutex_->unlock();
-
-			if (!q->empty()) {
-				try {
-					FawkesNetworkTransceiver::send(s_, q);
-				} catch (ConnectionDiedException &e) {
-					parent_->connection_died();
-					exit();
+		for (;;) {
+			FawkesNetworkMessage *m;
+			while (outbound_ring_->try_pop(m)) {
+				outbound_msgq_->push(m);
+			}
+			if (outbound_overflowing_.load()) {
+				// messages pushed to the ring before the overflow are older
+				outbound_mutex_->lock();
+				while (outbound_ring_->try_pop(m)) {
+					outbound_msgq_->push(m);
 				}
+				while (!outbound_overflow_->empty()) {
+					outbound_msgq_->push(outbound_overflow_->front());
+					outbound_overflow_->pop();
+				}
+				outbound_overflowing_.store(false);
+				outbound_mutex_->unlock();
+			}
+
+			if (outbound_msgq_->empty())
+				break;
+
+			try {
+				FawkesNetworkTransceiver::send(s_, outbound_msgq_);
+			} catch (ConnectionDiedException &e) {
+				parent_->connection_died();
+				exit();
 			}
 		}
 	}
@@ -112,10 +137,12 @@ public:
 	void
 	enqueue(FawkesNetworkMessage *msg)
 	{
-		outbound_mutex_->lock();
-		outbound_msgq_->push(msg);
-		outbound_havemore_ = true;
-		outbound_mutex_->unlock();
+		if (outbound_overflowing_.load() || !outbound_ring_->try_push(msg)) {
+			outbound_mutex_->lock();
+			outbound_overflowing_.store(true);
+			outbound_overflow_->push(msg);
+			outbound_mutex_->unlock();
+		}
 		wakeup();
 	}
 
@@ -139,11 +166,11 @@ private:
 	StreamSocket *                   s_;
 	FawkesNetworkServerClientThread *parent_;
 
-	Mutex *                    outbound_mutex_;
-	unsigned int               outbound_active_;
-	bool                       outbound_havemore_;
-	FawkesNetworkMessageQueue *outbound_msgq_;
-	FawkesNetworkMessageQueue *outbound_msgqs_[2];
+	Mutex *                                 outbound_mutex_;
+	MpmcRingBuffer<FawkesNetworkMessage *> *outbound_ring_;
+	FawkesNetworkMessageQueue *             outbound_overflow_;
+	std::atomic<bool>                       outbound_overflowing_;
+	FawkesNetworkMessageQueue *             outbound_msgq_;
 };
 
 /** @class FawkesNetworkServerClientThread netcomm/fawkes/server_client_thread.h
@@ -171,6 +198,7 @@ FawkesNetworkServerClientThread::FawkesNetworkServerClientThread(StreamSocket *
 	_alive         = true;
 	_clid          = 0;
 	_inbound_queue = new FawkesNetworkMessageQueue();
+	_transceiver   = new FawkesNetworkTransceiver();
 
 	_send_slave = new FawkesNetworkServerClientSendThread(_s, this);
 
@@ -185,6 +213,7 @@ FawkesNetworkServerClientThread::~FawkesNetworkServerClientThread()
 	delete _send_slave;
 	delete _s;
 	delete _inbound_queue;
+	delete _transceiver;
 }
 
 /** Get client ID.
@@ -214,7 +243,7 @@ void
 FawkesNetworkServerClientThread::recv()
 {
 	try {
-		FawkesNetworkTransceiver::recv(_s, _inbound_queue);
+		_transceiver->recv_buffered(_s, _inbound_queue);
 
 		_inbound_queue->lock();
 		while (!_inbound_queue->empty()) {
@@ -0,0 +1,659 @@
+
+/***************************************************************************
+ *  server_event_loop.cpp - Event-driven client handling for the network server
+ *
+ *  Created: Wed Oct 14 18:45:30 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/thread_collector.h>
+#include <core/threading/wait_condition.h>
+#include <netcomm/fawkes/message.h>
+#include <netcomm/fawkes/message_queue.h>
+#include <netcomm/fawkes/server_client.h>
+#include <netcomm/fawkes/server_event_loop.h>
+#include <netcomm/fawkes/server_thread.h>
+#include <netcomm/fawkes/transceiver.h>
+#include <netcomm/socket/stream.h>
+#include <netcomm/utils/exceptions.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+
+#include <cerrno>
+#include <deque>
+#include <map>
+#include <set>
+#include <unistd.h>
+
+namespace fawkes {
+
+/** Maximum number of messages gathered into a single write call. */
+#define FNSEL_SEND_BATCH 64
+/** Maximum number of events processed per epoll_wait() call. */
+#define FNSEL_MAX_EVENTS 64
+/** Epoll user data denoting the wakeup event descriptor, never a client ID. */
+#define FNSEL_WAKEUP_ID 0
+
+class FawkesNetworkServerEventWorker;
+
+/** @class FawkesNetworkServerConnection <netcomm/fawkes/server_event_loop.cpp>
+ * Client connection served by a FawkesNetworkServerEventWorker.
+ * Inbound data is received and dispatched from the worker thread when the
+ * socket becomes readable. Outbound messages are queued and written by the
+ * worker without blocking, whatever the socket does not accept right away
+ * is written once it becomes writable again.
+ * @ingroup NetComm
+ */
+
+class FawkesNetworkServerConnection : public FawkesNetworkServerClient
+{
+public:
+	/** Constructor.
+	 * @param s socket to client, ownership is taken
+	 * @param parent parent network thread
+	 * @param worker worker serving the connection
+	 */
+	FawkesNetworkServerConnection(StreamSocket *                  s,
+	                              FawkesNetworkServerThread *     parent,
+	                              FawkesNetworkServerEventWorker *worker)
+	{
+		s_             = s;
+		parent_        = parent;
+		worker_        = worker;
+		clid_          = 0;
+		alive_         = true;
+		want_output_   = false;
+		out_offset_    = 0;
+		out_mutex_     = new Mutex();
+		out_cond_      = new WaitCondition(out_mutex_);
+		inbound_queue_ = new FawkesNetworkMessageQueue();
+		transceiver_   = new FawkesNetworkTransceiver();
+	}
+
+	/** Destructor. */
+	~FawkesNetworkServerConnection()
+	{
+		for (FawkesNetworkMessage *m : outq_) {
+			m->unref();
+		}
+		delete transceiver_;
+		delete inbound_queue_;
+		delete out_cond_;
+		delete out_mutex_;
+		delete s_;
+	}
+
+	virtual unsigned int
+	clid() const
+	{
+		return clid_;
+	}
+
+	virtual void
+	set_clid(unsigned int client_id)
+	{
+		clid_ = client_id;
+	}
+
+	virtual bool
+	alive() const
+	{
+		return alive_;
+	}
+
+	virtual void enqueue(FawkesNetworkMessage *msg);
+	virtual void force_send();
+
+	/** Get socket.
+	 * @return socket to client */
+	StreamSocket *
+	socket() const
+	{
+		return s_;
+	}
+
+	/** Get worker.
+	 * @return worker serving this connection */
+	FawkesNetworkServerEventWorker *
+	worker() const
+	{
+		return worker_;
+	}
+
+	void recv();
+	bool flush();
+	bool has_output();
+	void connection_died();
+
+	/** Output interest registered with epoll, only used by the worker. */
+	bool want_output_;
+
+private:
+	StreamSocket *                  s_;
+	FawkesNetworkServerThread *     parent_;
+	FawkesNetworkServerEventWorker *worker_;
+	unsigned int                    clid_;
+	volatile bool                   alive_;
+
+	FawkesNetworkMessageQueue *inbound_queue_;
+	FawkesNetworkTransceiver * transceiver_;
+
+	Mutex *                            out_mutex_;
+	WaitCondition *                    out_cond_;
+	std::deque<FawkesNetworkMessage *> outq_;
+	size_t                             out_offset_;
+};
+
+/** @class FawkesNetworkServerEventWorker <netcomm/fawkes/server_event_loop.cpp>
+ * Worker thread of the FawkesNetworkServerEventLoop.
+ * Each worker has its own epoll instance and serves a subset of the
+ * connections. All socket operations of a connection happen in its
+ * worker thread. Other threads enqueue outbound messages and notify the
+ * worker through an eventfd that is registered with the same epoll
+ * instance.
+ * @ingroup NetComm
+ */
+
+class FawkesNetworkServerEventWorker : public Thread
+{
+public:
+	/** Constructor.
+	 * @param parent parent network thread
+	 */
+	FawkesNetworkServerEventWorker(FawkesNetworkServerThread *parent)
+	: Thread("FawkesNetworkServerEventWorker", Thread::OPMODE_CONTINUOUS)
+	{
+		parent_ = parent;
+
+		epfd_ = epoll_create1(EPOLL_CLOEXEC);
+		if (epfd_ == -1) {
+			throw Exception(errno, "Failed to create epoll instance");
+		}
+		wakefd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (wakefd_ == -1) {
+			int err = errno;
+			::close(epfd_);
+			throw Exception(err, "Failed to create event descriptor");
+		}
+		struct epoll_event ev;
+		ev.events   = EPOLLIN;
+		ev.data.u64 = FNSEL_WAKEUP_ID;
+		if (epoll_ctl(epfd_, EPOLL_CTL_ADD, wakefd_, &ev) == -1) {
+			int err = errno;
+			::close(wakefd_);
+			::close(epfd_);
+			throw Exception(err, "Failed to register event descriptor");
+		}
+
+		mutex_         = new Mutex();
+		pending_mutex_ = new Mutex();
+	}
+
+	/** Destructor. */
+	~FawkesNetworkServerEventWorker()
+	{
+		::close(wakefd_);
+		::close(epfd_);
+		delete pending_mutex_;
+		delete mutex_;
+	}
+
+	/** Add connection.
+	 * @param conn connection to serve, its client ID must have been set
+	 */
+	void
+	add(FawkesNetworkServerConnection *conn)
+	{
+		MutexLocker lock(mutex_);
+		struct epoll_event ev;
+		ev.events   = EPOLLIN | EPOLLRDHUP;
+		ev.data.u64 = conn->clid();
+		if (epoll_ctl(epfd_, EPOLL_CTL_ADD, conn->socket()->fd(), &ev) == -1) {
+			throw Exception(errno, "Failed to register client %u", conn->clid());
+		}
+		conns_[conn->clid()] = conn;
+	}
+
+	/** Remove connection.
+	 * Waits until the worker no longer uses the connection, afterwards
+	 * it may be deleted.
+	 * @param conn connection to remove
+	 */
+	void
+	remove(FawkesNetworkServerConnection *conn)
+	{
+		MutexLocker lock(mutex_);
+		if (conns_.erase(conn->clid()) > 0 && conn->alive()) {
+			epoll_ctl(epfd_, EPOLL_CTL_DEL, conn->socket()->fd(), NULL);
+		}
+		pending_mutex_->lock();
+		pending_.erase(conn->clid());
+		pending_mutex_->unlock();
+	}
+
+	/** Notify worker about new outbound messages.
+	 * @param clid ID of client with pending output
+	 */
+	void
+	notify_output(unsigned int clid)
+	{
+		pending_mutex_->lock();
+		bool notify = pending_.empty();
+		pending_.insert(clid);
+		pending_mutex_->unlock();
+		if (notify) {
+			uint64_t one = 1;
+			if (::write(wakefd_, &one, sizeof(one)) == -1) {
+				// counter overflow only, the worker is woken up anyway
+			}
+		}
+	}
+
+	virtual void loop();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	void process_output();
+	void update(FawkesNetworkServerConnection *conn);
+
+	FawkesNetworkServerThread *parent_;
+	int                        epfd_;
+	int                        wakefd_;
+
+	Mutex *                                                mutex_;
+	std::map<unsigned int, FawkesNetworkServerConnection *> conns_;
+
+	Mutex *                pending_mutex_;
+	std::set<unsigned int> pending_;
+};
+
+/** Enqueue message to outbound queue.
+ * The message is packed right away and written later by the worker.
+ * Messages for a dead connection are discarded.
+ * @param msg message to enqueue, ownership is taken
+ */
+void
+FawkesNetworkServerConnection::enqueue(FawkesNetworkMessage *msg)
+{
+	msg->pack();
+	out_mutex_->lock();
+	if (!alive_) {
+		out_mutex_->unlock();
+		msg->unref();
+		return;
+	}
+	bool notify = outq_.empty();
+	outq_.push_back(msg);
+	out_mutex_->unlock();
+	if (notify) {
+		worker_->notify_output(clid_);
+	}
+}
+
+/** Wait until all queued messages have been written.
+ * Returns early if the connection dies.
+ */
+void
+FawkesNetworkServerConnection::force_send()
+{
+	MutexLocker lock(out_mutex_);
+	while (alive_ && !outq_.empty()) {
+		out_cond_->wait();
+	}
+}
+
+/** Receive and dispatch available messages.
+ * To be called only by the worker if the socket is readable.
+ */
+void
+FawkesNetworkServerConnection::recv()
+{
+	try {
+		transceiver_->recv_buffered(s_, inbound_queue_);
+
+		inbound_queue_->lock();
+		while (!inbound_queue_->empty()) {
+			FawkesNetworkMessage *m = inbound_queue_->front();
+			m->set_client_id(clid_);
+			parent_->dispatch(m);
+			m->unref();
+			inbound_queue_->pop();
+		}
+		inbound_queue_->unlock();
+		parent_->wakeup();
+
+	} catch (ConnectionDiedException &e) {
+		connection_died();
+	}
+}
+
+/** Write as many queued messages as possible without blocking.
+ * To be called only by the worker.
+ * @return true if messages remain queued, false if all have been written
+ */
+bool
+FawkesNetworkServerConnection::flush()
+{
+	MutexLocker lock(out_mutex_);
+	try {
+		while (!outq_.empty()) {
+			struct iovec iov[2 * FNSEL_SEND_BATCH];
+			int          n     = 0;
+			size_t       total = 0;
+			size_t       skip  = out_offset_;
+			for (std::deque<FawkesNetworkMessage *>::iterator i = outq_.begin();
+			     i != outq_.end() && n + 2 <= 2 * FNSEL_SEND_BATCH;
+			     ++i) {
+				const fawkes_message_t &f     = (*i)->fmsg();
+				size_t                  hsize = sizeof(f.header);
+				size_t                  psize = (*i)->payload_size();
+				if (skip < hsize) {
+					iov[n].iov_base = (char *)&(f.header) + skip;
+					iov[n].iov_len  = hsize - skip;
+					total += iov[n++].iov_len;
+					skip = 0;
+				} else {
+					skip -= hsize;
+				}
+				if (psize > skip) {
+					iov[n].iov_base = (char *)f.payload + skip;
+					iov[n].iov_len  = psize - skip;
+					total += iov[n++].iov_len;
+				}
+				skip = 0;
+			}
+
+			size_t written = s_->writev_nonblocking(iov, n);
+			bool   blocked = (written < total);
+
+			// drop completely written messages
+			written += out_offset_;
+			while (!outq_.empty()) {
+				size_t msize = sizeof(fawkes_message_header_t) + outq_.front()->payload_size();
+				if (written < msize)
+					break;
+				written -= msize;
+				outq_.front()->unref();
+				outq_.pop_front();
+			}
+			out_offset_ = written;
+
+			if (blocked)
+				break;
+		}
+	} catch (SocketException &e) {
+		lock.unlock();
+		connection_died();
+		return false;
+	}
+	if (outq_.empty()) {
+		out_cond_->wake_all();
+	}
+	return !outq_.empty();
+}
+
+/** Check for queued outbound messages.
+ * @return true if messages remain to be written, false otherwise
+ */
+bool
+FawkesNetworkServerConnection::has_output()
+{
+	MutexLocker lock(out_mutex_);
+	return !outq_.empty();
+}
+
+/** Mark connection as dead.
+ * Wakes up threads waiting in force_send() and the parent thread, which
+ * will remove the connection.
+ */
+void
+FawkesNetworkServerConnection::connection_died()
+{
+	out_mutex_->lock();
+	alive_ = false;
+	out_cond_->wake_all();
+	out_mutex_->unlock();
+	parent_->wakeup();
+}
+
+/** Worker loop.
+ * Waits for socket events and output notifications and processes them.
+ * The worker mutex is held while processing, so that connections are not
+ * removed while they are in use.
+ */
+void
+FawkesNetworkServerEventWorker::loop()
+{
+	struct epoll_event events[FNSEL_MAX_EVENTS];
+
+	int num = epoll_wait(epfd_, events, FNSEL_MAX_EVENTS, -1);
+	if (num == -1) {
+		if (errno != EINTR) {
+			usleep(10000);
+		}
+		return;
+	}
+
+	CancelState old_state;
+	set_cancel_state(CANCEL_DISABLED, &old_state);
+	mutex_->lock();
+
+	for (int i = 0; i < num; ++i) {
+		if (events[i].data.u64 == FNSEL_WAKEUP_ID) {
+			uint64_t v;
+			if (::read(wakefd_, &v, sizeof(v)) == -1) {
+				// spurious wakeup, nothing to reset
+			}
+			process_output();
+			continue;
+		}
+
+		std::map<unsigned int, FawkesNetworkServerConnection *>::iterator c =
+		  conns_.find(events[i].data.u64);
+		if (c == conns_.end() || !c->second->alive())
+			continue;
+		FawkesNetworkServerConnection *conn = c->second;
+
+		if (events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+			conn->connection_died();
+		} else {
+			if (events[i].events & EPOLLIN) {
+				conn->recv();
+			}
+			if ((events[i].events & EPOLLOUT) && conn->alive()) {
+				conn->flush();
+			}
+		}
+		update(conn);
+	}
+
+	mutex_->unlock();
+	set_cancel_state(old_state);
+}
+
+/** Write pending output of notified connections.
+ * Must be called with the worker mutex locked.
+ */
+void
+FawkesNetworkServerEventWorker::process_output()
+{
+	std::set<unsigned int> pending;
+	pending_mutex_->lock();
+	pending.swap(pending_);
+	pending_mutex_->unlock();
+
+	for (unsigned int clid : pending) {
+		std::map<unsigned int, FawkesNetworkServerConnection *>::iterator c = conns_.find(clid);
+		if (c == conns_.end() || !c->second->alive())
+			continue;
+		// already waiting for the socket to become writable
+		if (c->second->want_output_)
+			continue;
+		c->second->flush();
+		update(c->second);
+	}
+}
+
+/** Update epoll registration of a connection.
+ * Dead connections are unregistered, for alive ones output interest is
+ * registered if and only if messages remain queued.
+ * Must be called with the worker mutex locked.
+ * @param conn connection to update
+ */
+void
+FawkesNetworkServerEventWorker::update(FawkesNetworkServerConnection *conn)
+{
+	int fd = conn->socket()->fd();
+	if (!conn->alive()) {
+		epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, NULL);
+		return;
+	}
+	bool want_output = conn->has_output();
+	if (want_output != conn->want_output_) {
+		struct epoll_event ev;
+		ev.events   = EPOLLIN | EPOLLRDHUP | (want_output ? EPOLLOUT : 0);
+		ev.data.u64 = conn->clid();
+		if (epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) == 0) {
+			conn->want_output_ = want_output;
+		}
+	}
+}
+
+/** @class FawkesNetworkServerEventLoop <netcomm/fawkes/server_event_loop.h>
+ * Event-driven client handling for the Fawkes network server.
+ * Instead of running two threads per connected client, all client
+ * sockets are multiplexed with epoll on a small fixed pool of worker
+ * threads. Connections are assigned to workers round-robin by client ID.
+ * Writes never block a worker, data the socket does not accept is kept
+ * queued until the socket becomes writable. Reads are triggered by
+ * readability, only the remainder of a message whose header has already
+ * been received is read blocking.
+ *
+ * The connections implement FawkesNetworkServerClient and therefore
+ * behave exactly like client threads towards the FawkesNetworkServerThread.
+ *
+ * @ingroup NetComm
+ */
+
+/** Constructor.
+ * @param parent parent network thread to dispatch messages to
+ * @param num_workers number of worker threads, must be at least one
+ * @param thread_collector thread collector to register the workers with,
+ * if NULL the workers are started directly
+ */
+FawkesNetworkServerEventLoop::FawkesNetworkServerEventLoop(FawkesNetworkServerThread *parent,
+                                                           unsigned int               num_workers,
+                                                           ThreadCollector *thread_collector)
+{
+	if (num_workers == 0) {
+		throw Exception("Fawkes network event loop requires at least one worker");
+	}
+	parent_           = parent;
+	thread_collector_ = thread_collector;
+
+	try {
+		for (unsigned int i = 0; i < num_workers; ++i) {
+			workers_.push_back(new FawkesNetworkServerEventWorker(parent_));
+		}
+	} catch (Exception &e) {
+		for (FawkesNetworkServerEventWorker *w : workers_) {
+			delete w;
+		}
+		throw;
+	}
+
+	for (FawkesNetworkServerEventWorker *w : workers_) {
+		if (thread_collector_) {
+			thread_collector_->add(w);
+		} else {
+			w->start();
+		}
+	}
+}
+
+/** Destructor.
+ * All connections must have been removed before.
+ */
+FawkesNetworkServerEventLoop::~FawkesNetworkServerEventLoop()
+{
+	for (FawkesNetworkServerEventWorker *w : workers_) {
+		if (thread_collector_) {
+			thread_collector_->remove(w);
+		} else {
+			w->cancel();
+			w->join();
+		}
+		delete w;
+	}
+	workers_.clear();
+}
+
+/** Add connection.
+ * @param s socket to client, ownership is taken
+ * @param clid client ID of the connection
+ * @return client connection, remove it with remove_connection() before
+ * deleting it
+ */
+FawkesNetworkServerClient *
+FawkesNetworkServerEventLoop::add_connection(StreamSocket *s, unsigned int clid)
+{
+	FawkesNetworkServerEventWorker *w = workers_[clid % workers_.size()];
+	FawkesNetworkServerConnection * c = new FawkesNetworkServerConnection(s, parent_, w);
+	c->set_clid(clid);
+	try {
+		w->add(c);
+	} catch (Exception &e) {
+		delete c;
+		throw;
+	}
+	return c;
+}
+
+/** Remove connection.
+ * Waits until the connection is no longer in use by its worker.
+ * @param client connection returned by add_connection()
+ */
+void
+FawkesNetworkServerEventLoop::remove_connection(FawkesNetworkServerClient *client)
+{
+	FawkesNetworkServerConnection *c = static_cast<FawkesNetworkServerConnection *>(client);
+	c->worker()->remove(c);
+}
+
+/** Get number of worker threads.
+ * @return number of worker threads
+ */
+unsigned int
+FawkesNetworkServerEventLoop::num_workers() const
+{
+	return workers_.size();
+}
+
+} // end namespace fawkes
@@ -0,0 +1,58 @@
+
+/***************************************************************************
+ *  server_event_loop.h - Event-driven client handling for the network server
+ *
+ *  Created: Wed Oct 14 18:45:30 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _NETCOMM_FAWKES_SERVER_EVENT_LOOP_H_
+#define _NETCOMM_FAWKES_SERVER_EVENT_LOOP_H_
+
+#include <vector>
+
+namespace fawkes {
+
+class ThreadCollector;
+class StreamSocket;
+class FawkesNetworkServerThread;
+class FawkesNetworkServerClient;
+class FawkesNetworkServerEventWorker;
+
+class FawkesNetworkServerEventLoop
+{
+public:
+	FawkesNetworkServerEventLoop(FawkesNetworkServerThread *parent,
+	                             unsigned int               num_workers,
+	                             ThreadCollector *          thread_collector = 0);
+	~FawkesNetworkServerEventLoop();
+
+	FawkesNetworkServerClient *add_connection(StreamSocket *s, unsigned int clid);
+	void                       remove_connection(FawkesNetworkServerClient *client);
+
+	unsigned int num_workers() const;
+
+private:
+	FawkesNetworkServerThread *                   parent_;
+	ThreadCollector *                             thread_collector_;
+	std::vector<FawkesNetworkServerEventWorker *> workers_;
+};
+
+} // end namespace fawkes
+
+#endif
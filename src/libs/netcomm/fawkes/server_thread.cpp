@@ -25,13 +25,16 @@
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
 #include <core/threading/thread_collector.h>
+#include <netcomm/fawkes/component_ids.h>
 #include <netcomm/fawkes/handler.h>
 #include <netcomm/fawkes/message.h>
 #include <netcomm/fawkes/message_content.h>
 #include <netcomm/fawkes/message_queue.h>
 #include <netcomm/fawkes/server_client_thread.h>
+#include <netcomm/fawkes/server_event_loop.h>
 #include <netcomm/fawkes/server_thread.h>
 #include <netcomm/utils/acceptor_thread.h>
+#include <netinet/in.h>
 
 #include <unistd.h>
 
@@ -42,6 +45,18 @@ namespace fawkes {
  * Maintains a list of clients and reacts on events triggered by the clients.
  * Also runs the acceptor thread.
  *
+ * By default every client is handled by a FawkesNetworkServerClientThread,
+ * which itself runs a second thread for sending. With many clients the
+ * number of threads and context switches becomes significant. Optionally
+ * all clients can instead be served by a FawkesNetworkServerEventLoop,
+ * which multiplexes the sockets on a small fixed number of worker threads.
+ * Handlers are not affected by the choice.
+ *
+ * Clients may request compression of large messages, see
+ * FawkesNetworkCompression. The server selects the codec and compresses
+ * messages to such clients transparently for handlers. A broadcast
+ * message is compressed at most once per codec.
+ *
  * @ingroup NetComm
  * @author Tim Niemueller
  */
@@ -55,19 +70,35 @@ namespace fawkes {
  * :: to listen on any local address
  * @param fawkes_port port for Fawkes network protocol
  * @param thread_collector thread collector to register new threads with
+ * @param event_loop_workers number of event loop worker threads serving
+ * all clients, 0 to run a thread per client. Ignored if the event loop is
+ * not supported on this platform.
+ * @param compression_threshold minimum payload size in bytes for messages
+ * to be compressed for clients which requested compression, 0 to deny
+ * compression
  */
 FawkesNetworkServerThread::FawkesNetworkServerThread(bool               enable_ipv4,
                                                      bool               enable_ipv6,
                                                      const std::string &listen_ipv4,
                                                      const std::string &listen_ipv6,
                                                      unsigned int       fawkes_port,
-                                                     ThreadCollector *  thread_collector)
+                                                     ThreadCollector *  thread_collector,
+                                                     unsigned int       event_loop_workers,
+                                                     unsigned int       compression_threshold)
 : Thread("FawkesNetworkServerThread", Thread::OPMODE_WAITFORWAKEUP)
 {
 	this->thread_collector = thread_collector;
 	clients.clear();
 	next_client_id   = 1;
 	inbound_messages = new FawkesNetworkMessageQueue();
+	event_loop       = NULL;
+
+	this->compression_threshold = compression_threshold;
+#ifdef HAVE_EPOLL
+	if (event_loop_workers > 0) {
+		event_loop = new FawkesNetworkServerEventLoop(this, event_loop_workers, thread_collector);
+	}
+#endif
 
 	if (enable_ipv4) {
 		acceptor_threads.push_back(new NetworkAcceptorThread(
@@ -93,12 +124,7 @@ FawkesNetworkServerThread::FawkesNetworkServerThread(bool               enable_i
 FawkesNetworkServerThread::~FawkesNetworkServerThread()
 {
 	for (cit = clients.begin(); cit != clients.end(); ++cit) {
-		if (thread_collector) {
-			thread_collector->remove((*cit).second);
-		} else {
-			(*cit).second->cancel();
-			(*cit).second->join();
-		}
+		remove_client((*cit).second);
 		delete (*cit).second;
 	}
 	for (size_t i = 0; i < acceptor_threads.size(); ++i) {
@@ -112,6 +138,7 @@ FawkesNetworkServerThread::~FawkesNetworkServerThread()
 	}
 	acceptor_threads.clear();
 
+	delete event_loop;
 	delete inbound_messages;
 }
 
@@ -122,14 +149,25 @@ FawkesNetworkServerThread::~FawkesNetworkServerThread()
 void
 FawkesNetworkServerThread::add_connection(StreamSocket *s) noexcept
 {
-	FawkesNetworkServerClientThread *client = new FawkesNetworkServerClientThread(s, this);
-
 	clients.lock();
-	client->set_clid(next_client_id);
-	if (thread_collector) {
-		thread_collector->add(client);
+	FawkesNetworkServerClient *client;
+	if (event_loop) {
+		try {
+			client = event_loop->add_connection(s, next_client_id);
+		} catch (Exception &e) {
+			// socket has been deleted, drop the connection
+			clients.unlock();
+			return;
+		}
 	} else {
-		client->start();
+		FawkesNetworkServerClientThread *ct = new FawkesNetworkServerClientThread(s, this);
+		ct->set_clid(next_client_id);
+		if (thread_collector) {
+			thread_collector->add(ct);
+		} else {
+			ct->start();
+		}
+		client = ct;
 	}
 	unsigned int cid = next_client_id++;
 	clients[cid]     = client;
@@ -201,13 +239,7 @@ FawkesNetworkServerThread::loop()
 
 		{
 			MutexLocker clients_lock(clients.mutex());
-			if (thread_collector) {
-				thread_collector->remove(clients[clid]);
-			} else {
-				clients[clid]->cancel();
-				clients[clid]->join();
-			}
-			usleep(5000);
+			remove_client(clients[clid]);
 			delete clients[clid];
 			clients.erase(clid);
 		}
@@ -217,7 +249,9 @@ FawkesNetworkServerThread::loop()
 	inbound_messages->lock();
 	while (!inbound_messages->empty()) {
 		FawkesNetworkMessage *m = inbound_messages->front();
-		{
+		if (m->cid() == FAWKES_CID_NETCOMM) {
+			handle_netcomm_message(m);
+		} else {
 			MutexLocker handlers_lock(handlers.mutex());
 			if (handlers.find(m->cid()) != handlers.end()) {
 				handlers[m->cid()]->handle_network_message(m);
@@ -229,6 +263,84 @@ FawkesNetworkServerThread::loop()
 	inbound_messages->unlock();
 }
 
+/** Stop serving a client.
+ * Stops the client thread or removes the connection from the event loop.
+ * Afterwards the client may be deleted.
+ * @param client client to remove
+ */
+void
+FawkesNetworkServerThread::remove_client(FawkesNetworkServerClient *client)
+{
+	if (event_loop) {
+		event_loop->remove_connection(client);
+		return;
+	}
+	FawkesNetworkServerClientThread *ct = static_cast<FawkesNetworkServerClientThread *>(client);
+	if (thread_collector) {
+		thread_collector->remove(ct);
+	} else {
+		ct->cancel();
+		ct->join();
+	}
+	usleep(5000);
+}
+
+/** Process connection-level message.
+ * Answers a compression hello of a client with the selected codec, which
+ * is used from then on for messages to that client.
+ * @param msg message received with component ID FAWKES_CID_NETCOMM
+ */
+void
+FawkesNetworkServerThread::handle_netcomm_message(FawkesNetworkMessage *msg)
+{
+	if (msg->msgid() != MSG_NETCOMM_COMPRESSION_HELLO) {
+		return;
+	}
+
+	unsigned int codec = FAWKES_COMPRESSION_NONE;
+	if (compression_threshold > 0) {
+		try {
+			fawkes_compression_hello_msg_t *h = msg->msgge<fawkes_compression_hello_msg_t>();
+			codec = FawkesNetworkCompression::select_codec(ntohl(h->codecs));
+		} catch (TypeMismatchException &e) {
+		} // ignore, compression stays disabled
+	}
+
+	{
+		MutexLocker clients_lock(clients.mutex());
+		if (clients.find(msg->clid()) == clients.end()) {
+			return;
+		}
+		clients[msg->clid()]->set_compression(codec);
+	}
+	send(FawkesNetworkCompression::accept(msg->clid(), codec));
+}
+
+/** Get compressed version of message.
+ * @param msg packed message to compress
+ * @param codec codec negotiated with the recipient
+ * @return compressed message, or NULL if the message shall be sent as is
+ */
+FawkesNetworkMessage *
+FawkesNetworkServerThread::compressed(FawkesNetworkMessage *msg, unsigned int codec)
+{
+	if (codec == FAWKES_COMPRESSION_NONE || compression_threshold == 0
+	    || msg->payload_size() < compression_threshold) {
+		return NULL;
+	}
+	return FawkesNetworkCompression::compress(msg, codec);
+}
+
+/** Check if clients are served by the event loop.
+ * @return true if an event loop serves all clients, false if a thread
+ * is run per client
+ */
+bool
+FawkesNetworkServerThread::event_loop_enabled() const
+{
+	return (event_loop != NULL);
+}
+
 /** Force sending of all pending messages. */
 void
 FawkesNetworkServerThread::force_send()
@@ -243,20 +355,43 @@ FawkesNetworkServerThread::force_send()
 /** Broadcast a message.
  * Method to broadcast a message to all connected clients. This method will take
  * ownership of the passed message. If you want to use if after enqueing it you
- * must reference it explicitly before calling this method.
+ * must reference it explicitly before calling this method. The message is
+ * packed once and then shared by the send queues of all clients, it must
+ * not be modified afterwards.
  * @param msg Message to broadcast
  */
 void
 FawkesNetworkServerThread::broadcast(FawkesNetworkMessage *msg)
 {
+	// serialize once, all clients send from the same immutable buffer
+	msg->pack();
+
+	// compressed at most once per codec, NULL if not worth it
+	FawkesNetworkMessage *cmsgs[FAWKES_COMPRESSION_NUM_CODECS] = {NULL};
+	bool                  tried[FAWKES_COMPRESSION_NUM_CODECS] = {false};
+
 	clients.lock();
 	for (cit = clients.begin(); cit != clients.end(); ++cit) {
 		if ((*cit).second->alive()) {
-			msg->ref();
-			(*cit).second->enqueue(msg);
+			FawkesNetworkMessage *m     = msg;
+			unsigned int          codec = (*cit).second->compression();
+			if (codec != FAWKES_COMPRESSION_NONE && codec < FAWKES_COMPRESSION_NUM_CODECS) {
+				if (!tried[codec]) {
+					cmsgs[codec] = compressed(msg, codec);
+					tried[codec] = true;
+				}
+				if (cmsgs[codec])
+					m = cmsgs[codec];
+			}
+			m->ref();
+			(*cit).second->enqueue(m);
 		}
 	}
 	clients.unlock();
+	for (unsigned int i = 0; i < FAWKES_COMPRESSION_NUM_CODECS; ++i) {
+		if (cmsgs[i])
+			cmsgs[i]->unref();
+	}
 	msg->unref();
 }
 
@@ -307,6 +442,12 @@ FawkesNetworkServerThread::send(FawkesNetworkMessage *msg)
 	unsigned int clid = msg->clid();
 	if (clients.find(clid) != clients.end()) {
 		if (clients[clid]->alive()) {
+			msg->pack();
+			FawkesNetworkMessage *cmsg = compressed(msg, clients[clid]->compression());
+			if (cmsg) {
+				msg->unref();
+				msg = cmsg;
+			}
 			clients[clid]->enqueue(msg);
 		}
 	}
@@ -26,6 +26,7 @@
 
 #include <core/threading/thread.h>
 #include <core/utils/lock_map.h>
+#include <netcomm/fawkes/compression.h>
 #include <netcomm/fawkes/hub.h>
 #include <netcomm/utils/incoming_connection_handler.h>
 
@@ -36,7 +37,8 @@ namespace fawkes {
 
 class ThreadCollector;
 class Mutex;
-class FawkesNetworkServerClientThread;
+class FawkesNetworkServerClient;
+class FawkesNetworkServerEventLoop;
 class NetworkAcceptorThread;
 class FawkesNetworkHandler;
 class FawkesNetworkMessage;
@@ -53,7 +55,9 @@ public:
 	                          const std::string &listen_ipv4,
 	                          const std::string &listen_ipv6,
 	                          unsigned int       fawkes_port,
-	                          ThreadCollector *  thread_collector = 0);
+	                          ThreadCollector *  thread_collector      = 0,
+	                          unsigned int       event_loop_workers    = 0,
+	                          unsigned int       compression_threshold = FAWKES_COMPRESSION_THRESHOLD);
 	virtual ~FawkesNetworkServerThread();
 
 	virtual void loop();
@@ -86,6 +90,8 @@ public:
 
 	void force_send();
 
+	bool event_loop_enabled() const;
+
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
 	virtual void
@@ -94,6 +100,11 @@ protected:
 		Thread::run();
 	}
 
+private:
+	void                  remove_client(FawkesNetworkServerClient *client);
+	void                  handle_netcomm_message(FawkesNetworkMessage *msg);
+	FawkesNetworkMessage *compressed(FawkesNetworkMessage *msg, unsigned int codec);
+
 private:
 	ThreadCollector *                    thread_collector;
 	unsigned int                         next_client_id;
@@ -103,11 +114,14 @@ private:
 	LockMap<unsigned int, FawkesNetworkHandler *>           handlers;
 	LockMap<unsigned int, FawkesNetworkHandler *>::iterator hit;
 
-	// key: client id,     value: client thread
-	LockMap<unsigned int, FawkesNetworkServerClientThread *>           clients;
-	LockMap<unsigned int, FawkesNetworkServerClientThread *>::iterator cit;
+	// key: client id,     value: client thread or event loop connection
+	LockMap<unsigned int, FawkesNetworkServerClient *>           clients;
+	LockMap<unsigned int, FawkesNetworkServerClient *>::iterator cit;
 
 	FawkesNetworkMessageQueue *inbound_messages;
+
+	FawkesNetworkServerEventLoop *event_loop;
+	unsigned int                  compression_threshold;
 };
 
 } // end namespace fawkes
@@ -21,27 +21,90 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <netcomm/fawkes/compression.h>
 #include <netcomm/fawkes/message.h>
 #include <netcomm/fawkes/message_queue.h>
 #include <netcomm/fawkes/transceiver.h>
 #include <netcomm/socket/stream.h>
 #include <netcomm/utils/exceptions.h>
 #include <netinet/in.h>
+#include <sys/uio.h>
 
+#include <climits>
 #include <cstdlib>
+#include <cstring>
 
 namespace fawkes {
 
+/** Maximum number of messages gathered into a single write call. */
+#define FNT_SEND_BATCH 128
+
+#if defined(IOV_MAX) && (IOV_MAX < 2 * FNT_SEND_BATCH)
+#	error IOV_MAX too small for FNT_SEND_BATCH
+#endif
+
+/** Restore original message if it was received compressed.
+ * @param msg received message
+ * @exception SocketException thrown if decompression fails, the payload
+ * has been freed in that case
+ */
+static inline void
+uncompress_message(fawkes_message_t &msg)
+{
+	if (FawkesNetworkCompression::is_compressed(msg)) {
+		try {
+			FawkesNetworkCompression::decompress(msg);
+		} catch (Exception &e) {
+			free(msg.payload);
+			throw SocketException("Invalid compressed message");
+		}
+	}
+}
+
+FawkesNetworkTransceiver::Statistics FawkesNetworkTransceiver::stats_ = {0, 0, 0, 0};
+
 /** @class FawkesNetworkTransceiver transceiver.h <netcomm/fawkes/transceiver.h>
  * Fawkes Network Transceiver.
  * Utility class that provides methods to send and receive messages via
  * the network. Operates on message queues and a given socket.
  *
+ * Sending gathers header and payload of many queued messages into a
+ * single write call. For receiving, an instance keeps a per-connection
+ * buffer so that a single read can deliver many small messages, use
+ * recv_buffered() for this. The static recv() reads each message with
+ * two separate calls and is kept for compatibility.
+ *
+ * Compressed messages are restored by either receive method, see
+ * FawkesNetworkCompression.
+ *
+ * The number of socket calls and messages in either direction is counted
+ * process-wide, see statistics().
+ *
  * @ingroup NetComm
  * @author Tim Niemueller
  */
 
+/** Constructor.
+ * @param recv_buffer_size size in bytes of the receive buffer, messages
+ * larger than that are read directly into their payload
+ */
+FawkesNetworkTransceiver::FawkesNetworkTransceiver(size_t recv_buffer_size)
+{
+	rbuf_size_  = recv_buffer_size;
+	rbuf_       = (char *)malloc(rbuf_size_);
+	rbuf_start_ = 0;
+	rbuf_end_   = 0;
+}
+
+/** Destructor. */
+FawkesNetworkTransceiver::~FawkesNetworkTransceiver()
+{
+	free(rbuf_);
+}
+
 /** Send messages.
+ * All messages of the queue are written with as few write calls as
+ * possible, usually one per FNT_SEND_BATCH messages.
  * @param s socket over which the data shall be transmitted.
  * @param msgq message queue that contains the messages that have to be sent
  * @exception ConnectionDiedException Thrown if any error occurs during the
@@ -50,19 +113,36 @@ namespace fawkes {
 void
 FawkesNetworkTransceiver::send(StreamSocket *s, FawkesNetworkMessageQueue *msgq)
 {
+	FawkesNetworkMessage *batch[FNT_SEND_BATCH];
+	struct iovec          iov[2 * FNT_SEND_BATCH];
+	unsigned int          n = 0;
+
 	msgq->lock();
 	try {
 		while (!msgq->empty()) {
-			FawkesNetworkMessage *m = msgq->front();
-			m->pack();
-			const fawkes_message_t &f            = m->fmsg();
-			unsigned int            payload_size = m->payload_size();
-			s->write(&(f.header), sizeof(f.header));
-			s->write(f.payload, payload_size);
-			m->unref();
-			msgq->pop();
+			for (n = 0; n < FNT_SEND_BATCH && !msgq->empty(); ++n) {
+				FawkesNetworkMessage *m = msgq->front();
+				msgq->pop();
+				m->pack();
+				const fawkes_message_t &f = m->fmsg();
+				batch[n]                  = m;
+				iov[2 * n].iov_base       = (void *)&(f.header);
+				iov[2 * n].iov_len        = sizeof(f.header);
+				iov[2 * n + 1].iov_base   = f.payload;
+				iov[2 * n + 1].iov_len    = m->payload_size();
+			}
+			s->writev(iov, 2 * n);
+			__atomic_add_fetch(&stats_.send_calls, 1, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&stats_.msgs_sent, n, __ATOMIC_RELAXED);
+			for (unsigned int i = 0; i < n; ++i) {
+				batch[i]->unref();
+			}
+			n = 0;
 		}
 	} catch (SocketException &e) {
+		for (unsigned int i = 0; i < n; ++i) {
+			batch[i]->unref();
+		}
 		msgq->unlock();
 		throw ConnectionDiedException("Write failed");
 	}
@@ -93,19 +173,24 @@ FawkesNetworkTransceiver::recv(StreamSocket *             s,
 		while (s->available() && (num_msgs++ < max_num_msgs)) {
 			fawkes_message_t msg;
 			s->read(&(msg.header), sizeof(msg.header));
+			__atomic_add_fetch(&stats_.recv_calls, 2, __ATOMIC_RELAXED);
 
 			unsigned int payload_size = ntohl(msg.header.payload_size);
 
 			if (payload_size > 0) {
 				msg.payload = malloc(payload_size);
 				s->read(msg.payload, payload_size);
+				__atomic_add_fetch(&stats_.recv_calls, 1, __ATOMIC_RELAXED);
 			} else {
 				msg.payload = NULL;
 			}
+			uncompress_message(msg);
 
 			FawkesNetworkMessage *m = new FawkesNetworkMessage(msg);
 			msgq->push(m);
+			__atomic_add_fetch(&stats_.msgs_received, 1, __ATOMIC_RELAXED);
 		}
+		__atomic_add_fetch(&stats_.recv_calls, 1, __ATOMIC_RELAXED);
 	} catch (SocketException &e) {
 		msgq->unlock();
 		throw ConnectionDiedException("Read failed");
@@ -113,4 +198,138 @@ FawkesNetworkTransceiver::recv(StreamSocket *             s,
 	msgq->unlock();
 }
 
+/** Read available data into receive buffer.
+ * Compacts the buffer if necessary and performs a single read.
+ * @param s socket to read from
+ */
+void
+FawkesNetworkTransceiver::fill(StreamSocket *s)
+{
+	if (rbuf_start_ > 0) {
+		memmove(rbuf_, rbuf_ + rbuf_start_, rbuf_end_ - rbuf_start_);
+		rbuf_end_ -= rbuf_start_;
+		rbuf_start_ = 0;
+	}
+	size_t bytes = s->read(rbuf_ + rbuf_end_, rbuf_size_ - rbuf_end_, /* read all */ false);
+	__atomic_add_fetch(&stats_.recv_calls, 1, __ATOMIC_RELAXED);
+	if (bytes == 0) {
+		throw SocketException("Connection closed");
+	}
+	rbuf_end_ += bytes;
+}
+
+/** Receive data through receive buffer.
+ * Like recv(), but reads as much data as is available with a single call
+ * and then parses all complete messages from the buffer. Incomplete
+ * messages remain buffered until more data arrives, except for a message
+ * whose header has already been received, its payload is read completely.
+ * All complete messages in the buffer are always delivered, max_num_msgs
+ * only limits additional reads from the socket.
+ * @param s socket to gather messages from, must always be the same for
+ * an instance
+ * @param msgq message queue to store received messages in
+ * @param max_num_msgs maximum number of messages after which no more data
+ * is read from the socket, 0 for no limit
+ * @exception ConnectionDiedException Thrown if any error occurs during the
+ * operation since for any error the conncetion is considered dead.
+ */
+void
+FawkesNetworkTransceiver::recv_buffered(StreamSocket *             s,
+                                        FawkesNetworkMessageQueue *msgq,
+                                        unsigned int               max_num_msgs)
+{
+	const size_t hsize = sizeof(fawkes_message_header_t);
+
+	msgq->lock();
+
+	try {
+		unsigned int num_msgs  = 0;
+		bool         may_read  = true;
+		bool         have_read = false;
+
+		for (;;) {
+			size_t buffered = rbuf_end_ - rbuf_start_;
+
+			if (buffered < hsize) {
+				if (!may_read || (max_num_msgs > 0 && num_msgs >= max_num_msgs))
+					break;
+				// first read is triggered by the caller's poll, later ones
+				// only if the previous read filled the buffer completely
+				if (have_read) {
+					__atomic_add_fetch(&stats_.recv_calls, 1, __ATOMIC_RELAXED);
+					if (!s->available())
+						break;
+				}
+				fill(s);
+				have_read = true;
+				// a partially filled buffer means the socket has been drained
+				may_read = (rbuf_end_ == rbuf_size_);
+				continue;
+			}
+
+			fawkes_message_t msg;
+			memcpy(&(msg.header), rbuf_ + rbuf_start_, hsize);
+			size_t payload_size = ntohl(msg.header.payload_size);
+
+			if (payload_size == 0) {
+				msg.payload = NULL;
+				rbuf_start_ += hsize;
+			} else {
+				msg.payload        = malloc(payload_size);
+				size_t have        = buffered - hsize;
+				size_t from_buffer = have < payload_size ? have : payload_size;
+				memcpy(msg.payload, rbuf_ + rbuf_start_ + hsize, from_buffer);
+				rbuf_start_ += hsize + from_buffer;
+				if (from_buffer < payload_size) {
+					try {
+						s->read((char *)msg.payload + from_buffer, payload_size - from_buffer);
+					} catch (SocketException &e) {
+						free(msg.payload);
+						throw;
+					}
+					__atomic_add_fetch(&stats_.recv_calls, 1, __ATOMIC_RELAXED);
+				}
+			}
+			if (rbuf_start_ == rbuf_end_) {
+				rbuf_start_ = rbuf_end_ = 0;
+			}
+			uncompress_message(msg);
+
+			FawkesNetworkMessage *m = new FawkesNetworkMessage(msg);
+			msgq->push(m);
+			++num_msgs;
+			__atomic_add_fetch(&stats_.msgs_received, 1, __ATOMIC_RELAXED);
+		}
+	} catch (SocketException &e) {
+		msgq->unlock();
+		throw ConnectionDiedException("Read failed");
+	}
+	msgq->unlock();
+}
+
+/** Get transmission statistics.
+ * The statistics are accumulated over all connections of this process.
+ * @return current statistics
+ */
+FawkesNetworkTransceiver::Statistics
+FawkesNetworkTransceiver::statistics()
+{
+	Statistics rv;
+	rv.msgs_sent     = __atomic_load_n(&stats_.msgs_sent, __ATOMIC_RELAXED);
+	rv.send_calls    = __atomic_load_n(&stats_.send_calls, __ATOMIC_RELAXED);
+	rv.msgs_received = __atomic_load_n(&stats_.msgs_received, __ATOMIC_RELAXED);
+	rv.recv_calls    = __atomic_load_n(&stats_.recv_calls, __ATOMIC_RELAXED);
+	return rv;
+}
+
+/** Reset transmission statistics. */
+void
+FawkesNetworkTransceiver::reset_statistics()
+{
+	__atomic_store_n(&stats_.msgs_sent, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats_.send_calls, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats_.msgs_received, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats_.recv_calls, 0, __ATOMIC_RELAXED);
+}
+
 } // end namespace fawkes
@@ -26,6 +26,9 @@
 
 #include <core/exception.h>
 
+#include <cstddef>
+#include <stdint.h>
+
 namespace fawkes {
 
 class StreamSocket;
@@ -34,8 +37,38 @@ class FawkesNetworkMessageQueue;
 class FawkesNetworkTransceiver
 {
 public:
+	/** Transmission statistics.
+	 * Counts messages and the socket calls needed to transfer them, which
+	 * allows to compute the number of system calls per message.
+	 */
+	typedef struct
+	{
+		uint64_t msgs_sent;     ///< number of messages sent
+		uint64_t send_calls;    ///< number of socket write calls for sending
+		uint64_t msgs_received; ///< number of messages received
+		uint64_t recv_calls;    ///< number of socket read and poll calls for receiving
+	} Statistics;
+
+	FawkesNetworkTransceiver(size_t recv_buffer_size = 65536);
+	~FawkesNetworkTransceiver();
+
+	void recv_buffered(StreamSocket *s, FawkesNetworkMessageQueue *msgq, unsigned int max_num_msgs = 8);
+
 	static void send(StreamSocket *s, FawkesNetworkMessageQueue *msgq);
 	static void recv(StreamSocket *s, FawkesNetworkMessageQueue *msgq, unsigned int max_num_msgs = 8);
+
+	static Statistics statistics();
+	static void       reset_statistics();
+
+private:
+	void fill(StreamSocket *s);
+
+	char * rbuf_;
+	size_t rbuf_size_;
+	size_t rbuf_start_;
+	size_t rbuf_end_;
+
+	static Statistics stats_;
 };
 
 } // end namespace fawkes
@@ -21,6 +21,9 @@ ifneq ($(PKGCONFIG),)
     HAVE_LIBCRYPTO := $(if $(shell $(PKGCONFIG) --exists 'openssl'; echo $${?/1/}),1,0)
     LIBCRYPTO_PKG  := openssl
   endif
+  HAVE_ZSTD      := $(if $(shell $(PKGCONFIG) --exists 'libzstd'; echo $${?/1/}),1,0)
+  HAVE_LZ4       := $(if $(shell $(PKGCONFIG) --exists 'liblz4'; echo $${?/1/}),1,0)
+  HAVE_ZLIB      := $(if $(shell $(PKGCONFIG) --exists 'zlib'; echo $${?/1/}),1,0)
 endif
 ifeq ($(HAVE_AVAHI),1)
   CFLAGS_AVAHI  = -DHAVE_AVAHI $(shell $(PKGCONFIG) --cflags avahi-client)
@@ -40,6 +40,7 @@
 #include <netdb.h>
 #include <string>
 #include <unistd.h>
+#include <vector>
 // include <linux/in.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -745,6 +746,105 @@ Socket::write(const void *buf, size_t count)
 	}
 }
 
+/** Write multiple buffers to the socket.
+ * Gathers the given buffers and writes them with as few system calls as
+ * possible, in the common case just one. This method can only be used on
+ * streams. Like write() it does not return before all data has been
+ * written.
+ * @param iov array of buffers to write, in order
+ * @param iovcnt number of elements in @p iov, at most IOV_MAX
+ * @see write
+ * @exception SocketException thrown for any error during writing
+ */
+void
+Socket::writev(const struct iovec *iov, int iovcnt)
+{
+	if (sock_fd == -1) {
+		throw SocketException("Socket not initialized, call bind() or connect()");
+	}
+
+	std::vector<struct iovec> local_iov(iov, iov + iovcnt);
+
+	struct iovec * cur = local_iov.data();
+	int            num = iovcnt;
+	struct timeval start, now;
+
+	gettimeofday(&start, NULL);
+
+	do {
+		// skip fully written buffers
+		while (num > 0 && cur->iov_len == 0) {
+			++cur;
+			--num;
+		}
+		if (num == 0)
+			break;
+
+		ssize_t retval = ::writev(sock_fd, cur, num);
+		if (retval == -1) {
+			if (errno != EAGAIN) {
+				throw SocketException(errno, "Could not write data");
+			}
+		} else {
+			size_t written = retval;
+			while (num > 0 && written >= cur->iov_len) {
+				written -= cur->iov_len;
+				++cur;
+				--num;
+			}
+			if (num > 0) {
+				cur->iov_base = (char *)cur->iov_base + written;
+				cur->iov_len -= written;
+			}
+			// reset timeout
+			gettimeofday(&start, NULL);
+		}
+		gettimeofday(&now, NULL);
+		if (num > 0)
+			usleep(0);
+	} while ((num > 0) && (time_diff_sec(now, start) < timeout));
+
+	if (num > 0) {
+		throw SocketException("Write timeout");
+	}
+}
+
+/** Write multiple buffers to the socket without blocking.
+ * Writes as much of the given buffers as the socket accepts right now
+ * and returns immediately. This is meant for event-driven I/O where the
+ * caller waits for the socket to become writable before writing the
+ * remainder. A broken connection does not raise SIGPIPE.
+ * @param iov array of buffers to write, in order
+ * @param iovcnt number of elements in @p iov, at most IOV_MAX
+ * @return number of bytes written, 0 if the operation would block
+ * @exception SocketException thrown for any error during writing
+ */
+size_t
+Socket::writev_nonblocking(const struct iovec *iov, int iovcnt)
+{
+	if (sock_fd == -1) {
+		throw SocketException("Socket not initialized, call bind() or connect()");
+	}
+
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov    = (struct iovec *)iov;
+	msg.msg_iovlen = iovcnt;
+
+	ssize_t retval;
+	do {
+		retval = ::sendmsg(sock_fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+	} while (retval == -1 && errno == EINTR);
+
+	if (retval == -1) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return 0;
+		}
+		throw SocketException(errno, "Could not write data");
+	}
+	return retval;
+}
+
 /** Read from socket.
  * Read from the socket. This method can only be used on streams.
  * @param buf buffer to write from
@@ -966,6 +1066,17 @@ Socket::listening()
 	return (i == 1);
 }
 
+/** Get file descriptor of socket.
+ * This is meant to register the socket with event notification
+ * facilities like epoll, do not read or write on it directly.
+ * @return file descriptor, -1 if the socket has not been created
+ */
+int
+Socket::fd() const
+{
+	return sock_fd;
+}
+
 /** Maximum Transfer Unit (MTU) of socket.
  * Note that this can only be retrieved of connected sockets!
  * @return MTU in bytes
@@ -29,6 +29,7 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 // just to be safe nobody else can do it
 #include <sys/signal.h>
 
@@ -104,6 +105,8 @@ public:
 
 	virtual size_t read(void *buf, size_t count, bool read_all = true);
 	virtual void   write(const void *buf, size_t count);
+	virtual void   writev(const struct iovec *iov, int iovcnt);
+	virtual size_t writev_nonblocking(const struct iovec *iov, int iovcnt);
 	virtual void   send(void *buf, size_t buf_len);
 	virtual void send(void *buf, size_t buf_len, const struct sockaddr *to_addr, socklen_t addr_len);
 	virtual size_t recv(void *buf, size_t buf_len);
@@ -118,6 +121,7 @@ public:
 	virtual short poll(int timeout = -1, short what = POLL_IN | POLL_HUP | POLL_PRI | POLL_RDHUP);
 
 	virtual bool listening();
+	int          fd() const;
 
 	virtual unsigned int mtu();
 
@@ -33,6 +33,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 #include <netdb.h>
 #include <unistd.h>
 
@@ -74,6 +75,19 @@ namespace fawkes {
  * answer is available via the host lookup facilities of the system or
  * optional via mDNS.
  *
+ * Failed name lookups are cached as well for the negative cache timeout.
+ * During that time the name is not looked up again and
+ * resolve_name_blocking() returns immediately, such that unreachable
+ * hosts do not stall callers repeatedly. Use prefetch() to order the
+ * lookup of a number of names at once, e.g. all peers read from the
+ * configuration on startup.
+ *
+ * The resolver is also a ServiceBrowseHandler. If registered to watch a
+ * service type, the host names and addresses of all announced services are
+ * put into the cache, without any further lookup. These entries do not
+ * expire with the cache timeout, but when the service is removed, which
+ * happens when its records expire according to their DNS-SD TTL.
+ *
  * @ingroup NetComm
  * @author Tim Niemueller
  */
@@ -86,7 +100,8 @@ NetworkNameResolver::NetworkNameResolver(AvahiThread *avahi_thread)
 {
 	addr2name_cache.clear();
 	name2addr_cache.clear();
-	cache_timeout_ = 30;
+	cache_timeout_          = 30;
+	negative_cache_timeout_ = 5;
 
 	resolver_thread = new NetworkNameResolverThread(this, avahi_thread);
 	resolver_thread->start();
@@ -127,12 +142,35 @@ NetworkNameResolver::cache_timeout()
 	return cache_timeout_;
 }
 
+/** Set negative cache timeout.
+ * @param sec the timeout in seconds for which a name whose lookup failed
+ * is not looked up again, 0 to disable negative caching
+ */
+void
+NetworkNameResolver::set_negative_cache_timeout(unsigned int sec)
+{
+	negative_cache_timeout_ = sec;
+}
+
+/** Get negative cache timeout.
+ * @return time in seconds for which failed lookups are cached
+ */
+unsigned int
+NetworkNameResolver::negative_cache_timeout()
+{
+	return negative_cache_timeout_;
+}
+
 /** Flush cache.
- * Flushes the caches for name to address and address to name mappings.
+ * Flushes the caches for name to address and address to name mappings
+ * and for failed lookups.
  */
 void
 NetworkNameResolver::flush_cache()
 {
+	failed_names_.lock();
+	failed_names_.clear();
+	failed_names_.unlock();
 	addr2name_cache.lock();
 	addr2name_cache.clear();
 	addr2name_cache.unlock();
@@ -183,11 +221,50 @@ NetworkNameResolver::resolve_name(const char *name, struct sockaddr **addr, sock
 		return true;
 	} else {
 		name2addr_cache.unlock();
-		resolver_thread->resolve_name(name);
+		if (!name_failed_recently(name)) {
+			resolver_thread->resolve_name(name);
+		}
 		return false;
 	}
 }
 
+/** Order lookup of a number of names.
+ * All names which are neither in the cache nor have failed recently are
+ * resolved concurrently in one batch. Call this early, e.g. with all
+ * peers from the configuration, such that later resolve_name() calls can
+ * be answered from the cache.
+ * @param names names to resolve
+ */
+void
+NetworkNameResolver::prefetch(const std::list<std::string> &names)
+{
+	std::list<std::string> lookup;
+	name2addr_cache.lock();
+	for (std::list<std::string>::const_iterator n = names.begin(); n != names.end(); ++n) {
+		if (name2addr_cache.find(*n) == name2addr_cache.end()) {
+			lookup.push_back(*n);
+		}
+	}
+	name2addr_cache.unlock();
+	lookup.remove_if([this](const std::string &n) { return name_failed_recently(n); });
+
+	if (!lookup.empty()) {
+		resolver_thread->resolve_names(lookup);
+	}
+}
+
+/** Check if the lookup of a name failed recently.
+ * @param name name to check
+ * @return true if the lookup failed less than the negative cache timeout ago
+ */
+bool
+NetworkNameResolver::name_failed_recently(const std::string &name)
+{
+	MutexLocker lock(failed_names_.mutex());
+	LockHashMap<std::string, time_t>::iterator f = failed_names_.find(name);
+	return (f != failed_names_.end()) && (f->second > time(NULL));
+}
+
 /** Resolve name and wait for the result.
  * This will lookup a name from the cache and return the value if available.
  * If there is no entry in the cache this will order a concurrent lookup of the
@@ -206,15 +283,18 @@ NetworkNameResolver::resolve_name_blocking(const char *      name,
 {
 	if (resolve_name(name, addr, addrlen)) {
 		return true;
+	} else if (name_failed_recently(name)) {
+		return false;
 	} else {
 		struct sockaddr *_addr;
 		socklen_t        _addrlen;
 		if (resolver_thread->resolve_name_immediately(name, &_addr, &_addrlen)) {
-			name_resolved(strdup(name), _addr, _addrlen);
+			name_resolved(name, _addr, _addrlen);
 			*addr    = _addr;
 			*addrlen = _addrlen;
 			return true;
 		} else {
+			name_resolution_failed(name);
 			return false;
 		}
 	}
@@ -294,13 +374,29 @@ NetworkNameResolver::resolve_address(struct sockaddr *addr, socklen_t addr_len,
 void
 NetworkNameResolver::name_resolved(std::string name, struct sockaddr *addr, socklen_t addrlen)
 {
+	cache_name(name, addr, time(NULL) + cache_timeout_);
+}
+
+/** Put a name into the cache.
+ * Replaces an existing entry and removes the name from the failed lookups.
+ * @param name host name
+ * @param addr address structure, ownership is taken over
+ * @param expires time when the entry becomes outdated
+ */
+void
+NetworkNameResolver::cache_name(const std::string &name, struct sockaddr *addr, time_t expires)
+{
+	failed_names_.lock();
+	failed_names_.erase(name);
+	failed_names_.unlock();
+
 	name2addr_cache.lock();
 	if ((n2acit = name2addr_cache.find(name)) != name2addr_cache.end()) {
 		// delete old entry
 		free(n2acit->second.first);
 		name2addr_cache.erase(n2acit);
 	}
-	name2addr_cache[name] = std::pair<struct sockaddr *, time_t>(addr, time(NULL) + cache_timeout_);
+	name2addr_cache[name] = std::pair<struct sockaddr *, time_t>(addr, expires);
 	name2addr_cache.unlock();
 }
 
@@ -330,6 +426,10 @@ NetworkNameResolver::addr_resolved(struct sockaddr *addr,
 void
 NetworkNameResolver::name_resolution_failed(std::string name)
 {
+	if (negative_cache_timeout_ > 0) {
+		MutexLocker lock(failed_names_.mutex());
+		failed_names_[name] = time(NULL) + negative_cache_timeout_;
+	}
 }
 
 void
@@ -338,6 +438,86 @@ NetworkNameResolver::address_resolution_failed(struct sockaddr *addr, socklen_t
 	free(addr);
 }
 
+void
+NetworkNameResolver::all_for_now()
+{
+}
+
+void
+NetworkNameResolver::cache_exhausted()
+{
+}
+
+void
+NetworkNameResolver::browse_failed(const char *name, const char *type, const char *domain)
+{
+}
+
+void
+NetworkNameResolver::service_added(const char *            name,
+                                   const char *            type,
+                                   const char *            domain,
+                                   const char *            host_name,
+                                   const char *            interface,
+                                   const struct sockaddr * addr,
+                                   const socklen_t         addr_size,
+                                   uint16_t                port,
+                                   std::list<std::string> &txt,
+                                   int                     flags)
+{
+	if (addr->sa_family != AF_INET) {
+		// the caches only hold IPv4 addresses
+		return;
+	}
+
+	service_hosts_.lock();
+	service_hosts_[std::string(name) + "." + type + "." + domain] = host_name;
+	service_hosts_.unlock();
+
+	// valid until the service is removed
+	const time_t     never = std::numeric_limits<time_t>::max();
+	struct sockaddr *a     = (struct sockaddr *)malloc(addr_size);
+	memcpy(a, addr, addr_size);
+	cache_name(host_name, a, never);
+
+	const struct sockaddr_in *saddr = (const struct sockaddr_in *)addr;
+	addr2name_cache.lock();
+	addr2name_cache[saddr->sin_addr.s_addr] = std::make_pair(std::string(host_name), never);
+	addr2name_cache.unlock();
+}
+
+void
+NetworkNameResolver::service_removed(const char *name, const char *type, const char *domain)
+{
+	MutexLocker                                 lock(service_hosts_.mutex());
+	LockMap<std::string, std::string>::iterator s =
+	  service_hosts_.find(std::string(name) + "." + type + "." + domain);
+	if (s == service_hosts_.end())
+		return;
+	std::string host_name = s->second;
+	service_hosts_.erase(s);
+
+	for (s = service_hosts_.begin(); s != service_hosts_.end(); ++s) {
+		// another service on the host is still announced
+		if (s->second == host_name)
+			return;
+	}
+
+	// entries are outdated now and refreshed on the next lookup, the address
+	// is kept valid since it may still be in use
+	name2addr_cache.lock();
+	if ((n2acit = name2addr_cache.find(host_name)) != name2addr_cache.end()) {
+		uint32_t s_addr       = ((struct sockaddr_in *)n2acit->second.first)->sin_addr.s_addr;
+		n2acit->second.second = 0;
+		addr2name_cache.lock();
+		if ((a2ncit = addr2name_cache.find(s_addr)) != addr2name_cache.end()) {
+			a2ncit->second.second = 0;
+		}
+		addr2name_cache.unlock();
+	}
+	name2addr_cache.unlock();
+}
+
 /** Get long hostname.
  * @return host name
  */
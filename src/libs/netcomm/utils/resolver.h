@@ -26,12 +26,14 @@
 
 #include <core/utils/lock_hashmap.h>
 #include <core/utils/lock_map.h>
+#include <netcomm/service_discovery/browse_handler.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <utils/misc/string_compare.h>
 
 #include <cstddef>
 #include <ctime>
+#include <list>
 #include <string>
 #include <utility>
 
@@ -41,7 +43,7 @@ class AvahiThread;
 class NetworkNameResolverThread;
 class HostInfo;
 
-class NetworkNameResolver
+class NetworkNameResolver : public ServiceBrowseHandler
 {
 	friend NetworkNameResolverThread;
 
@@ -52,27 +54,52 @@ public:
 	bool resolve_name(const char *name, struct sockaddr **addr, socklen_t *addrlen);
 	bool resolve_name_blocking(const char *name, struct sockaddr **addr, socklen_t *addrlen);
 	bool resolve_address(struct sockaddr *addr, socklen_t addr_len, std::string &name);
+	void prefetch(const std::list<std::string> &names);
 
 	void         flush_cache();
 	void         set_cache_timeout(unsigned int sec);
 	unsigned int cache_timeout();
+	void         set_negative_cache_timeout(unsigned int sec);
+	unsigned int negative_cache_timeout();
 
 	const char *hostname();
 	const char *short_hostname();
 
+	/* ServiceBrowseHandler methods */
+	virtual void all_for_now();
+	virtual void cache_exhausted();
+	virtual void browse_failed(const char *name, const char *type, const char *domain);
+	virtual void service_added(const char *            name,
+	                           const char *            type,
+	                           const char *            domain,
+	                           const char *            host_name,
+	                           const char *            interface,
+	                           const struct sockaddr * addr,
+	                           const socklen_t         addr_size,
+	                           uint16_t                port,
+	                           std::list<std::string> &txt,
+	                           int                     flags);
+	virtual void service_removed(const char *name, const char *type, const char *domain);
+
 private:
 	void name_resolved(std::string name, struct sockaddr *addr, socklen_t addrlen);
 	void addr_resolved(struct sockaddr *addr, socklen_t addrlen, std::string name, bool namefound);
 	void name_resolution_failed(std::string name);
 	void address_resolution_failed(struct sockaddr *addr, socklen_t addrlen);
 
+	void cache_name(const std::string &name, struct sockaddr *addr, time_t expires);
+	bool name_failed_recently(const std::string &name);
+
 private:
 	NetworkNameResolverThread *resolver_thread;
 	HostInfo *                 host_info_;
 	unsigned int               cache_timeout_;
+	unsigned int               negative_cache_timeout_;
 
 	LockHashMap<uint32_t, std::pair<std::string, time_t>>          addr2name_cache;
 	LockHashMap<std::string, std::pair<struct sockaddr *, time_t>> name2addr_cache;
+	LockHashMap<std::string, time_t>                               failed_names_;
+	LockMap<std::string, std::string>                              service_hosts_;
 
 	LockHashMap<uint32_t, std::pair<std::string, time_t>>::iterator          a2ncit;
 	LockHashMap<std::string, std::pair<struct sockaddr *, time_t>>::iterator n2acit;
@@ -216,6 +216,28 @@ NetworkNameResolverThread::resolve_name(const std::string &name)
 	}
 }
 
+/** Enqueue names for resolution.
+ * All names are enqueued at once and the resolver thread is woken up only
+ * once, such that the names are resolved in one batch.
+ * @param names names to resolve
+ */
+void
+NetworkNameResolverThread::resolve_names(const std::list<std::string> &names)
+{
+	namesq_mutex_->lock();
+	bool added = false;
+	for (std::list<std::string>::const_iterator n = names.begin(); n != names.end(); ++n) {
+		if (namesq_->find(*n) == namesq_->end()) {
+			namesq_->insert(*n);
+			added = true;
+		}
+	}
+	namesq_mutex_->unlock();
+	if (added) {
+		wakeup();
+	}
+}
+
 /** Enqueue address for resolution.
  * The address is enqueued and the resolver thread woken up. The result is reported
  * to the resolver given to the constructor.
@@ -58,6 +58,7 @@ public:
 	~NetworkNameResolverThread();
 
 	void resolve_name(const std::string &name);
+	void resolve_names(const std::list<std::string> &names);
 	void resolve_address(struct sockaddr *addr, socklen_t addrlen);
 
 	bool
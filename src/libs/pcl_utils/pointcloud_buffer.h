@@ -0,0 +1,182 @@
+
+/***************************************************************************
+ *  pointcloud_buffer.h - multi-buffered point cloud for producer/consumer
+ *
+ *  Created: Thu Oct 15 03:48:12 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_PCL_UTILS_POINTCLOUD_BUFFER_H_
+#define _LIBS_PCL_UTILS_POINTCLOUD_BUFFER_H_
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/utils/refptr.h>
+#include <pcl/point_cloud.h>
+
+#include <vector>
+
+namespace fawkes {
+namespace pcl_utils {
+
+/** @class PointCloudBuffer <pcl_utils/pointcloud_buffer.h>
+ * Multi-buffered point cloud.
+ * A single producer fills a back buffer which is invisible to readers
+ * and then publishes it, making it the current cloud. Readers retrieve
+ * a const snapshot of the current cloud which stays valid and unmodified
+ * for as long as they hold the reference. Buffers are reused once no
+ * reader holds them anymore, therefore in steady state no clouds are
+ * allocated. If all buffers are in use an additional one is allocated.
+ *
+ * Each publish increments a generation counter, which readers use to
+ * determine whether a new cloud is available since they last looked.
+ * Generation zero is an empty cloud available before the first publish.
+ *
+ * Readers that do not hold a snapshot, e.g. using the raw data pointer
+ * of a storage adapter, can rely on the data not being overwritten
+ * before the producer has published num_buffers - 1 more clouds.
+ * @author agent
+ */
+template <typename PointT>
+class PointCloudBuffer
+{
+public:
+	/** Point cloud type. */
+	typedef pcl::PointCloud<PointT> Cloud;
+
+	/** Constructor.
+   * @param num_buffers number of pre-allocated buffers, at least two
+   */
+	PointCloudBuffer(unsigned int num_buffers = 3) : current_(0), back_(-1), generation_(0)
+	{
+		if (num_buffers < 2)
+			num_buffers = 2;
+		for (unsigned int i = 0; i < num_buffers; ++i) {
+			buffers_.push_back(RefPtr<Cloud>(new Cloud()));
+		}
+	}
+
+	/** Get back buffer to fill.
+   * The back buffer is not visible to readers until publish() is
+   * called. Calling back() multiple times before publish() returns the
+   * same buffer. The buffer contains the data of an older cloud, the
+   * producer must set all fields, header and dimensions of the cloud.
+   * Resizing to the same size as before does not allocate. The producer
+   * must not modify the cloud after publishing it.
+   * @return back buffer
+   */
+	RefPtr<Cloud>
+	back()
+	{
+		MutexLocker lock(&mutex_);
+		if (back_ < 0) {
+			for (unsigned int i = 0; i < buffers_.size(); ++i) {
+				// use_count 1 means only we hold it, no reader has a snapshot
+				if ((int)i != current_ && buffers_[i].use_count() == 1) {
+					back_ = i;
+					break;
+				}
+			}
+			if (back_ < 0) {
+				buffers_.push_back(RefPtr<Cloud>(new Cloud()));
+				back_ = buffers_.size() - 1;
+			}
+		}
+		return buffers_[back_];
+	}
+
+	/** Publish the back buffer.
+   * Makes the buffer last returned by back() the current cloud and
+   * increments the generation. Does nothing if back() has not been
+   * called since the last publish.
+   */
+	void
+	publish()
+	{
+		MutexLocker lock(&mutex_);
+		if (back_ >= 0) {
+			current_ = back_;
+			back_    = -1;
+			++generation_;
+		}
+	}
+
+	/** Get current generation.
+   * @return generation of the current cloud
+   */
+	unsigned int
+	generation() const
+	{
+		MutexLocker lock(&mutex_);
+		return generation_;
+	}
+
+	/** Get snapshot of current cloud.
+   * @return current cloud
+   */
+	RefPtr<const Cloud>
+	snapshot() const
+	{
+		MutexLocker lock(&mutex_);
+		return buffers_[current_];
+	}
+
+	/** Get snapshot of current cloud.
+   * @param generation upon return contains the generation of the cloud
+   * @return current cloud
+   */
+	RefPtr<const Cloud>
+	snapshot(unsigned int &generation) const
+	{
+		MutexLocker lock(&mutex_);
+		generation = generation_;
+		return buffers_[current_];
+	}
+
+	/** Get snapshot if a newer cloud has been published.
+   * @param since_generation generation of the last cloud the caller has seen
+   * @param cloud upon return contains the current cloud if newer, unmodified otherwise
+   * @param generation upon return contains the generation of @p cloud if
+   * newer, unmodified otherwise. May be the same variable as @p since_generation.
+   * @return true if a cloud newer than @p since_generation was available
+   */
+	bool
+	snapshot_if_newer(unsigned int         since_generation,
+	                  RefPtr<const Cloud> &cloud,
+	                  unsigned int &       generation) const
+	{
+		MutexLocker lock(&mutex_);
+		if (generation_ == since_generation)
+			return false;
+		cloud      = buffers_[current_];
+		generation = generation_;
+		return true;
+	}
+
+private:
+	mutable Mutex              mutex_;
+	std::vector<RefPtr<Cloud>> buffers_;
+	int                        current_;
+	int                        back_;
+	unsigned int               generation_;
+};
+
+} // end namespace pcl_utils
+} // end namespace fawkes
+
+#endif
@@ -41,6 +41,25 @@ namespace fawkes {
  * @return point cloud
  * @exception Exception thrown if point cloud for given ID does not exist
  *
+ * For a point cloud added with add_pointcloud_buffer() this returns a
+ * snapshot of the current cloud, which is not updated later. Use
+ * get_pointcloud_buffer() to retrieve newer clouds.
+ *
+ * @fn RefPtr<pcl_utils::PointCloudBuffer<PointT>> PointCloudManager::add_pointcloud_buffer(const char *id, unsigned int num_buffers)
+ * Add buffered point cloud.
+ * Producers which refill a cloud every cycle should use this instead
+ * of add_pointcloud(). They fill the back buffer and publish it, while
+ * readers keep working on a consistent snapshot without copying.
+ * @param id ID of point cloud to add, must be unique
+ * @param num_buffers number of buffers to pre-allocate
+ * @return point cloud buffer to fill
+ *
+ * @fn RefPtr<pcl_utils::PointCloudBuffer<PointT>> PointCloudManager::get_pointcloud_buffer(const char *id)
+ * Get point cloud buffer.
+ * @param id ID of point cloud buffer to retrieve
+ * @return point cloud buffer
+ * @exception Exception thrown if no point cloud buffer of the given
+ * type exists for the given ID
  */
 
 /** Constructor. */
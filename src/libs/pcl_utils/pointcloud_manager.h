@@ -27,6 +27,7 @@
 #include <core/threading/mutex_locker.h>
 #include <core/utils/lock_map.h>
 #include <core/utils/refptr.h>
+#include <pcl_utils/pointcloud_buffer.h>
 #include <pcl_utils/storage_adapter.h>
 #include <utils/time/time.h>
 
@@ -52,6 +53,10 @@ public:
 	template <typename PointT>
 	void add_pointcloud(const char *id, RefPtr<pcl::PointCloud<PointT>> cloud);
 
+	template <typename PointT>
+	RefPtr<pcl_utils::PointCloudBuffer<PointT>> add_pointcloud_buffer(const char * id,
+	                                                                  unsigned int num_buffers = 3);
+
 	void remove_pointcloud(const char *id);
 
 	template <typename PointT>
@@ -65,6 +70,16 @@ public:
 	template <typename PointT>
 	bool exists_pointcloud(const char *id);
 
+	template <typename PointT>
+	RefPtr<pcl_utils::PointCloudBuffer<PointT>> get_pointcloud_buffer(const char *id);
+
+	/** Check if point cloud buffer of specified type exists.
+   * @param id ID of point cloud buffer to check
+   * @return true if the point cloud buffer exists, false otherwise
+   */
+	template <typename PointT>
+	bool exists_pointcloud_buffer(const char *id);
+
 	std::vector<std::string>                                         get_pointcloud_list() const;
 	const fawkes::LockMap<std::string, pcl_utils::StorageAdapter *> &get_pointclouds() const;
 	const pcl_utils::StorageAdapter *get_storage_adapter(const char *id);
@@ -86,6 +101,22 @@ PointCloudManager::add_pointcloud(const char *id, RefPtr<pcl::PointCloud<PointT>
 	}
 }
 
+template <typename PointT>
+RefPtr<pcl_utils::PointCloudBuffer<PointT>>
+PointCloudManager::add_pointcloud_buffer(const char *id, unsigned int num_buffers)
+{
+	fawkes::MutexLocker lock(clouds_.mutex());
+
+	if (clouds_.find(id) == clouds_.end()) {
+		RefPtr<pcl_utils::PointCloudBuffer<PointT>> buffer(
+		  new pcl_utils::PointCloudBuffer<PointT>(num_buffers));
+		clouds_[id] = new pcl_utils::PointCloudBufferStorageAdapter<PointT>(buffer);
+		return buffer;
+	} else {
+		throw Exception("Cloud %s already registered", id);
+	}
+}
+
 template <typename PointT>
 const RefPtr<const pcl::PointCloud<PointT>>
 PointCloudManager::get_pointcloud(const char *id)
@@ -97,6 +128,12 @@ PointCloudManager::get_pointcloud(const char *id)
 		  dynamic_cast<pcl_utils::PointCloudStorageAdapter<PointT> *>(clouds_[id]);
 
 		if (!pa) {
+			pcl_utils::PointCloudBufferStorageAdapter<PointT> *ba =
+			  dynamic_cast<pcl_utils::PointCloudBufferStorageAdapter<PointT> *>(clouds_[id]);
+			if (ba) {
+				return ba->buffer->snapshot();
+			}
+
 			// workaround for older compilers
 			if (strcmp(clouds_[id]->get_typename(),
 			           typeid(pcl_utils::PointCloudStorageAdapter<PointT> *).name())
@@ -112,6 +149,36 @@ PointCloudManager::get_pointcloud(const char *id)
 	}
 }
 
+template <typename PointT>
+RefPtr<pcl_utils::PointCloudBuffer<PointT>>
+PointCloudManager::get_pointcloud_buffer(const char *id)
+{
+	fawkes::MutexLocker lock(clouds_.mutex());
+
+	if (clouds_.find(id) != clouds_.end()) {
+		pcl_utils::PointCloudBufferStorageAdapter<PointT> *ba =
+		  dynamic_cast<pcl_utils::PointCloudBufferStorageAdapter<PointT> *>(clouds_[id]);
+		if (!ba) {
+			throw Exception("Point cloud '%s' is not buffered or of a different type", id);
+		}
+		return ba->buffer;
+	} else {
+		throw Exception("No point cloud with ID '%s' registered", id);
+	}
+}
+
+template <typename PointT>
+bool
+PointCloudManager::exists_pointcloud_buffer(const char *id)
+{
+	try {
+		get_pointcloud_buffer<PointT>(id);
+		return true;
+	} catch (Exception &e) {
+		return false;
+	}
+}
+
 template <typename PointT>
 bool
 PointCloudManager::exists_pointcloud(const char *id)
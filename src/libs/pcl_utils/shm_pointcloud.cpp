@@ -0,0 +1,730 @@
+
+/***************************************************************************
+ *  shm_pointcloud.cpp - shared memory point cloud
+ *
+ *  Created: Thu Oct 15 03:50:58 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <pcl_utils/shm_pointcloud.h>
+#include <utils/system/console_colors.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+namespace fawkes {
+namespace pcl_utils {
+
+/** @class SharedMemoryPointCloud <pcl_utils/shm_pointcloud.h>
+ * Shared memory point cloud.
+ * Makes a point cloud available to other processes without
+ * serialization. The segment has a fixed capacity of points of a fixed
+ * size. Meta data such as dimensions, frame, capture time and field
+ * layout are stored in the header, such that readers can interpret the
+ * data without knowing the point type at compile time.
+ *
+ * Readers can access the points in place with points() while holding
+ * the read lock, or copy them into a PCL point cloud with read(). The
+ * generation is incremented on every write, readers can compare it to
+ * determine whether new data is available.
+ * @author agent
+ */
+
+/** Write constructor.
+ * Create a new shared memory segment for the given point cloud.
+ * @param pcl_id point cloud ID
+ * @param point_size size of a single point in bytes
+ * @param capacity maximum number of points
+ */
+SharedMemoryPointCloud::SharedMemoryPointCloud(const char * pcl_id,
+                                               unsigned int point_size,
+                                               unsigned int capacity)
+: SharedMemory(FAWKES_SHM_POINTCLOUD_MAGIC_TOKEN,
+               /* read-only */ false,
+               /* create */ true,
+               /* destroy on delete */ true)
+{
+	constructor(pcl_id, point_size, capacity, false);
+	add_semaphore();
+}
+
+/** Read constructor.
+ * This constructor is used to search for an existing shared memory segment.
+ * It will throw an error if it cannot find a segment with the specified data.
+ * The segment is opened read-only by default, but this can be overridden with
+ * the is_read_only argument if needed.
+ * @param pcl_id point cloud ID
+ * @param is_read_only true to open read-only
+ */
+SharedMemoryPointCloud::SharedMemoryPointCloud(const char *pcl_id, bool is_read_only)
+: SharedMemory(FAWKES_SHM_POINTCLOUD_MAGIC_TOKEN, is_read_only, false, false)
+{
+	constructor(pcl_id, 0, 0, is_read_only);
+}
+
+void
+SharedMemoryPointCloud::constructor(const char * pcl_id,
+                                    unsigned int point_size,
+                                    unsigned int capacity,
+                                    bool         is_read_only)
+{
+	_is_read_only = is_read_only;
+	pcl_id_       = strdup(pcl_id);
+
+	priv_header_ = new SharedMemoryPointCloudHeader(pcl_id_, point_size, capacity);
+	_header      = priv_header_;
+	try {
+		attach();
+	} catch (Exception &e) {
+		delete priv_header_;
+		::free(pcl_id_);
+		throw;
+	}
+	raw_header_ = priv_header_->raw_header();
+
+	if (_memptr == NULL) {
+		delete priv_header_;
+		::free(pcl_id_);
+		throw Exception("Could not create shared memory segment for point cloud %s", pcl_id);
+	}
+}
+
+/** Destructor. */
+SharedMemoryPointCloud::~SharedMemoryPointCloud()
+{
+	delete priv_header_;
+	::free(pcl_id_);
+}
+
+/** Get point cloud ID.
+ * @return point cloud ID
+ */
+const char *
+SharedMemoryPointCloud::pcl_id() const
+{
+	return pcl_id_;
+}
+
+/** Get frame ID.
+ * @return coordinate frame ID of the current cloud
+ */
+const char *
+SharedMemoryPointCloud::frame_id() const
+{
+	return raw_header_->frame_id;
+}
+
+/** Set frame ID.
+ * @param frame_id coordinate frame ID of the current cloud
+ */
+void
+SharedMemoryPointCloud::set_frame_id(const char *frame_id)
+{
+	if (_is_read_only)
+		return;
+	strncpy(raw_header_->frame_id, frame_id, POINTCLOUD_FRAME_ID_MAX_LENGTH - 1);
+	raw_header_->frame_id[POINTCLOUD_FRAME_ID_MAX_LENGTH - 1] = 0;
+}
+
+/** Get point size.
+ * @return size of a single point in bytes
+ */
+unsigned int
+SharedMemoryPointCloud::point_size() const
+{
+	return raw_header_->point_size;
+}
+
+/** Get capacity.
+ * @return maximum number of points the segment can hold
+ */
+unsigned int
+SharedMemoryPointCloud::capacity() const
+{
+	return raw_header_->capacity;
+}
+
+/** Get width.
+ * @return width of the current cloud
+ */
+unsigned int
+SharedMemoryPointCloud::width() const
+{
+	return raw_header_->width;
+}
+
+/** Get height.
+ * @return height of the current cloud, 1 for unorganized clouds
+ */
+unsigned int
+SharedMemoryPointCloud::height() const
+{
+	return raw_header_->height;
+}
+
+/** Set dimensions.
+ * The product of width and height must not exceed the capacity.
+ * @param width width of the current cloud
+ * @param height height of the current cloud
+ * @exception Exception thrown if the dimensions exceed the capacity
+ */
+void
+SharedMemoryPointCloud::set_dimensions(unsigned int width, unsigned int height)
+{
+	if (_is_read_only)
+		return;
+	if ((size_t)width * height > raw_header_->capacity) {
+		throw Exception("Point cloud %s: %ux%u exceeds capacity %u",
+		                pcl_id_,
+		                width,
+		                height,
+		                raw_header_->capacity);
+	}
+	raw_header_->width  = width;
+	raw_header_->height = height;
+}
+
+/** Get number of valid points.
+ * @return number of points of the current cloud
+ */
+size_t
+SharedMemoryPointCloud::num_points() const
+{
+	return (size_t)raw_header_->width * raw_header_->height;
+}
+
+/** Check if cloud is dense.
+ * @return true if the current cloud contains no invalid points
+ */
+bool
+SharedMemoryPointCloud::is_dense() const
+{
+	return raw_header_->is_dense == 1;
+}
+
+/** Set dense flag.
+ * @param is_dense true if the current cloud contains no invalid points
+ */
+void
+SharedMemoryPointCloud::set_dense(bool is_dense)
+{
+	if (_is_read_only)
+		return;
+	raw_header_->is_dense = is_dense ? 1 : 0;
+}
+
+/** Get generation.
+ * @return generation of the current cloud, zero if nothing has been written
+ */
+unsigned int
+SharedMemoryPointCloud::generation() const
+{
+	return raw_header_->generation;
+}
+
+/** Increment generation.
+ * Call this after a new cloud has been written.
+ */
+void
+SharedMemoryPointCloud::increment_generation()
+{
+	if (_is_read_only)
+		return;
+	raw_header_->generation += 1;
+}
+
+/** Get capture time.
+ * @return capture time of the current cloud
+ */
+fawkes::Time
+SharedMemoryPointCloud::capture_time() const
+{
+	return fawkes::Time(raw_header_->capture_time_sec, raw_header_->capture_time_usec);
+}
+
+/** Set capture time.
+ * @param time capture time of the current cloud
+ */
+void
+SharedMemoryPointCloud::set_capture_time(const fawkes::Time &time)
+{
+	if (_is_read_only)
+		return;
+	raw_header_->capture_time_sec  = time.get_sec();
+	raw_header_->capture_time_usec = time.get_usec();
+}
+
+/** Get number of fields.
+ * @return number of valid field descriptions
+ */
+unsigned int
+SharedMemoryPointCloud::num_fields() const
+{
+	return raw_header_->num_fields;
+}
+
+/** Get field descriptions.
+ * @return array of num_fields() field descriptions
+ */
+const SharedMemoryPointCloud_field_t *
+SharedMemoryPointCloud::fields() const
+{
+	return raw_header_->fields;
+}
+
+/** Set field description.
+ * @param index index of field to set
+ * @param name name of field
+ * @param offset offset of field in bytes from the start of a point
+ * @param datatype data type, cf. pcl::PCLPointField::PointFieldTypes
+ * @param count number of elements of the field
+ * @exception Exception thrown if index is out of range
+ */
+void
+SharedMemoryPointCloud::set_field(unsigned int index,
+                                  const char * name,
+                                  unsigned int offset,
+                                  uint8_t      datatype,
+                                  unsigned int count)
+{
+	if (_is_read_only)
+		return;
+	if (index >= POINTCLOUD_MAX_FIELDS) {
+		throw Exception("Field index %u out of range", index);
+	}
+	SharedMemoryPointCloud_field_t &f = raw_header_->fields[index];
+	strncpy(f.name, name, POINTCLOUD_FIELD_NAME_MAX_LENGTH - 1);
+	f.name[POINTCLOUD_FIELD_NAME_MAX_LENGTH - 1] = 0;
+	f.offset                                     = offset;
+	f.datatype                                   = datatype;
+	f.count                                      = count;
+}
+
+/** Set number of fields.
+ * @param num_fields number of valid field descriptions
+ */
+void
+SharedMemoryPointCloud::set_num_fields(unsigned int num_fields)
+{
+	if (_is_read_only)
+		return;
+	raw_header_->num_fields =
+	  num_fields <= POINTCLOUD_MAX_FIELDS ? num_fields : POINTCLOUD_MAX_FIELDS;
+}
+
+/** Get point data.
+ * @return pointer to the first point
+ */
+void *
+SharedMemoryPointCloud::data() const
+{
+	return _memptr;
+}
+
+/** List shared memory point cloud segments. */
+void
+SharedMemoryPointCloud::list()
+{
+	SharedMemoryPointCloudLister *lister = new SharedMemoryPointCloudLister();
+	SharedMemoryPointCloudHeader *h      = new SharedMemoryPointCloudHeader();
+
+	SharedMemory::list(FAWKES_SHM_POINTCLOUD_MAGIC_TOKEN, h, lister);
+
+	delete lister;
+	delete h;
+}
+
+/** Erase all orphaned shared memory segments that contain point clouds.
+ * @param use_lister if true a lister is used to print the shared memory segments
+ * to stdout while cleaning up.
+ */
+void
+SharedMemoryPointCloud::cleanup(bool use_lister)
+{
+	SharedMemoryPointCloudLister *lister = NULL;
+	SharedMemoryPointCloudHeader *h      = new SharedMemoryPointCloudHeader();
+
+	if (use_lister) {
+		lister = new SharedMemoryPointCloudLister();
+	}
+
+	SharedMemory::erase_orphaned(FAWKES_SHM_POINTCLOUD_MAGIC_TOKEN, h, lister);
+
+	delete lister;
+	delete h;
+}
+
+/** Check point cloud availability.
+ * @param pcl_id point cloud ID to check
+ * @return true if shared memory segment with requested point cloud exists
+ */
+bool
+SharedMemoryPointCloud::exists(const char *pcl_id)
+{
+	SharedMemoryPointCloudHeader *h  = new SharedMemoryPointCloudHeader(pcl_id, 0, 0);
+	bool                          ex = SharedMemory::exists(FAWKES_SHM_POINTCLOUD_MAGIC_TOKEN, h);
+	delete h;
+	return ex;
+}
+
+/** Erase a specific shared memory segment that contains a point cloud.
+ * @param pcl_id point cloud ID
+ */
+void
+SharedMemoryPointCloud::wipe(const char *pcl_id)
+{
+	SharedMemoryPointCloudHeader *h = new SharedMemoryPointCloudHeader(pcl_id, 0, 0);
+	SharedMemory::erase(FAWKES_SHM_POINTCLOUD_MAGIC_TOKEN, h, NULL);
+	delete h;
+}
+
+/** @class SharedMemoryPointCloudHeader <pcl_utils/shm_pointcloud.h>
+ * Shared memory point cloud header.
+ * @author agent
+ */
+
+/** Constructor. */
+SharedMemoryPointCloudHeader::SharedMemoryPointCloudHeader()
+{
+	pcl_id_     = NULL;
+	point_size_ = 0;
+	capacity_   = 0;
+	header_     = NULL;
+}
+
+/** Constructor.
+ * @param pcl_id point cloud ID
+ * @param point_size size of a single point in bytes
+ * @param capacity maximum number of points
+ */
+SharedMemoryPointCloudHeader::SharedMemoryPointCloudHeader(const char * pcl_id,
+                                                           unsigned int point_size,
+                                                           unsigned int capacity)
+{
+	pcl_id_     = strdup(pcl_id);
+	point_size_ = point_size;
+	capacity_   = capacity;
+	header_     = NULL;
+}
+
+/** Copy constructor.
+ * @param h header to copy data from
+ */
+SharedMemoryPointCloudHeader::SharedMemoryPointCloudHeader(const SharedMemoryPointCloudHeader *h)
+{
+	if (h->pcl_id_ != NULL) {
+		pcl_id_ = strdup(h->pcl_id_);
+	} else {
+		pcl_id_ = NULL;
+	}
+	point_size_ = h->point_size_;
+	capacity_   = h->capacity_;
+	header_     = NULL;
+}
+
+/** Destructor. */
+SharedMemoryPointCloudHeader::~SharedMemoryPointCloudHeader()
+{
+	header_ = NULL;
+	if (pcl_id_ != NULL) {
+		free(pcl_id_);
+		pcl_id_ = NULL;
+	}
+}
+
+SharedMemoryHeader *
+SharedMemoryPointCloudHeader::clone() const
+{
+	return new SharedMemoryPointCloudHeader(this);
+}
+
+size_t
+SharedMemoryPointCloudHeader::size()
+{
+	return sizeof(SharedMemoryPointCloud_header_t);
+}
+
+size_t
+SharedMemoryPointCloudHeader::data_size()
+{
+	if (header_ == NULL) {
+		return (size_t)point_size_ * capacity_;
+	} else {
+		return (size_t)header_->point_size * header_->capacity;
+	}
+}
+
+bool
+SharedMemoryPointCloudHeader::matches(void *memptr)
+{
+	SharedMemoryPointCloud_header_t *h = (SharedMemoryPointCloud_header_t *)memptr;
+
+	if (pcl_id_ == NULL) {
+		return true;
+
+	} else if (strncmp(h->pcl_id, pcl_id_, POINTCLOUD_ID_MAX_LENGTH) == 0) {
+		if ((point_size_ == 0) || (capacity_ == 0)
+		    || ((h->point_size == point_size_) && (h->capacity == capacity_))) {
+			return true;
+		} else {
+			throw Exception("Inconsistent point cloud %s found in memory (meta)", pcl_id_);
+		}
+	} else {
+		return false;
+	}
+}
+
+/** Print Info. */
+void
+SharedMemoryPointCloudHeader::print_info()
+{
+	if (header_ == NULL) {
+		cout << "No point cloud set" << endl;
+		return;
+	}
+	cout << "SharedMemory Point Cloud Info: " << endl
+	     << "    PCL ID:         " << header_->pcl_id << endl
+	     << "    frame ID:       " << header_->frame_id << endl
+	     << "    dimensions:     " << header_->width << "x" << header_->height << endl
+	     << "    capacity:       " << header_->capacity << endl
+	     << "    point size:     " << header_->point_size << endl
+	     << "    generation:     " << header_->generation << endl
+	     << "    fields:        ";
+	for (unsigned int i = 0; i < header_->num_fields && i < POINTCLOUD_MAX_FIELDS; ++i) {
+		cout << " " << header_->fields[i].name;
+	}
+	cout << endl;
+}
+
+/** Check if buffer should be created.
+ * @return true, if point size and capacity are greater than zero.
+ */
+bool
+SharedMemoryPointCloudHeader::create()
+{
+	return ((point_size_ > 0) && (capacity_ > 0));
+}
+
+void
+SharedMemoryPointCloudHeader::initialize(void *memptr)
+{
+	header_ = (SharedMemoryPointCloud_header_t *)memptr;
+	memset(memptr, 0, sizeof(SharedMemoryPointCloud_header_t));
+
+	strncpy(header_->pcl_id, pcl_id_, POINTCLOUD_ID_MAX_LENGTH - 1);
+	header_->point_size = point_size_;
+	header_->capacity   = capacity_;
+	header_->height     = 1;
+}
+
+void
+SharedMemoryPointCloudHeader::set(void *memptr)
+{
+	header_ = (SharedMemoryPointCloud_header_t *)memptr;
+}
+
+void
+SharedMemoryPointCloudHeader::reset()
+{
+	header_ = NULL;
+}
+
+/** Check for equality of headers.
+ * First checks if passed SharedMemoryHeader is an instance of
+ * SharedMemoryPointCloudHeader. If not returns false, otherwise it
+ * compares point cloud ID, point size and capacity. If all match
+ * returns true, false if any of them differs.
+ * @param s shared memory header to compare to
+ * @return true if the two instances identify the very same shared memory segments,
+ * false otherwise
+ */
+bool
+SharedMemoryPointCloudHeader::operator==(const SharedMemoryHeader &s) const
+{
+	const SharedMemoryPointCloudHeader *h = dynamic_cast<const SharedMemoryPointCloudHeader *>(&s);
+	if (!h) {
+		return false;
+	} else {
+		return ((strncmp(pcl_id_, h->pcl_id_, POINTCLOUD_ID_MAX_LENGTH) == 0)
+		        && (point_size_ == h->point_size_) && (capacity_ == h->capacity_));
+	}
+}
+
+/** Get name of the segment.
+ * @return point cloud ID, NULL if looking for any point cloud
+ */
+const char *
+SharedMemoryPointCloudHeader::segment_name() const
+{
+	return pcl_id_;
+}
+
+/** Get point cloud ID.
+ * @return point cloud ID
+ */
+const char *
+SharedMemoryPointCloudHeader::pcl_id() const
+{
+	if (header_ == NULL)
+		return NULL;
+	return header_->pcl_id;
+}
+
+/** Get frame ID.
+ * @return frame ID
+ */
+const char *
+SharedMemoryPointCloudHeader::frame_id() const
+{
+	if (header_ == NULL)
+		return NULL;
+	return header_->frame_id;
+}
+
+/** Get point size.
+ * @return point size
+ */
+unsigned int
+SharedMemoryPointCloudHeader::point_size() const
+{
+	if (header_ == NULL)
+		return 0;
+	return header_->point_size;
+}
+
+/** Get capacity.
+ * @return maximum number of points
+ */
+unsigned int
+SharedMemoryPointCloudHeader::capacity() const
+{
+	if (header_ == NULL)
+		return 0;
+	return header_->capacity;
+}
+
+/** Get width.
+ * @return width of current cloud
+ */
+unsigned int
+SharedMemoryPointCloudHeader::width() const
+{
+	if (header_ == NULL)
+		return 0;
+	return header_->width;
+}
+
+/** Get height.
+ * @return height of current cloud
+ */
+unsigned int
+SharedMemoryPointCloudHeader::height() const
+{
+	if (header_ == NULL)
+		return 0;
+	return header_->height;
+}
+
+/** Get raw header.
+ * @return raw header.
+ */
+SharedMemoryPointCloud_header_t *
+SharedMemoryPointCloudHeader::raw_header()
+{
+	return header_;
+}
+
+/** @class SharedMemoryPointCloudLister <pcl_utils/shm_pointcloud.h>
+ * Shared memory point cloud lister.
+ * @author agent
+ */
+
+/** Constructor. */
+SharedMemoryPointCloudLister::SharedMemoryPointCloudLister()
+{
+}
+
+/** Destructor. */
+SharedMemoryPointCloudLister::~SharedMemoryPointCloudLister()
+{
+}
+
+void
+SharedMemoryPointCloudLister::print_header()
+{
+	cout << endl
+	     << cgreen << "Fawkes Shared Memory Segments - Point Clouds" << cnormal << endl
+	     << "========================================================================================"
+	     << endl
+	     << cdarkgray;
+	printf("%-23s %-10s %-10s %-10s %-9s %-9s %-9s\n",
+	       "PCL ID",
+	       "ShmID",
+	       "Semaphore",
+	       "Bytes",
+	       "Width",
+	       "Height",
+	       "State");
+	cout << cnormal
+	     << "----------------------------------------------------------------------------------------"
+	     << endl;
+}
+
+void
+SharedMemoryPointCloudLister::print_footer()
+{
+}
+
+void
+SharedMemoryPointCloudLister::print_no_segments()
+{
+	cout << "No shared memory segments containing point clouds found" << endl;
+}
+
+void
+SharedMemoryPointCloudLister::print_no_orphaned_segments()
+{
+	cout << "No orphaned shared memory segments containing point clouds found" << endl;
+}
+
+void
+SharedMemoryPointCloudLister::print_info(const SharedMemoryHeader *header,
+                                         int                       shm_id,
+                                         int                       semaphore,
+                                         unsigned int              mem_size,
+                                         const void *              memptr)
+{
+	SharedMemoryPointCloudHeader *h = (SharedMemoryPointCloudHeader *)header;
+
+	printf("%-23s %-10d %-10d %-10u %-9u %-9u %s%s\n",
+	       h->pcl_id(),
+	       shm_id,
+	       semaphore,
+	       mem_size,
+	       h->width(),
+	       h->height(),
+	       (SharedMemory::is_swapable(shm_id) ? "S" : ""),
+	       (SharedMemory::is_destroyed(shm_id) ? "D" : ""));
+}
+
+} // end namespace pcl_utils
+} // end namespace fawkes
@@ -0,0 +1,333 @@
+
+/***************************************************************************
+ *  shm_pointcloud.h - shared memory point cloud
+ *
+ *  Created: Thu Oct 15 03:50:58 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_PCL_UTILS_SHM_POINTCLOUD_H_
+#define _LIBS_PCL_UTILS_SHM_POINTCLOUD_H_
+
+#include <core/exception.h>
+#include <pcl/for_each_type.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_traits.h>
+#include <pcl_utils/utils.h>
+#include <utils/ipc/shm.h>
+#include <utils/ipc/shm_lister.h>
+#include <utils/time/time.h>
+
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Magic token to identify shared memory point clouds
+#define FAWKES_SHM_POINTCLOUD_MAGIC_TOKEN "Fawkes PointCloud"
+
+/** Maximum length of point cloud ID including terminating zero. */
+#define POINTCLOUD_ID_MAX_LENGTH 64
+/** Maximum length of frame ID including terminating zero. */
+#define POINTCLOUD_FRAME_ID_MAX_LENGTH 64
+/** Maximum length of field names including terminating zero. */
+#define POINTCLOUD_FIELD_NAME_MAX_LENGTH 16
+/** Maximum number of fields per point. */
+#define POINTCLOUD_MAX_FIELDS 16
+
+namespace fawkes {
+namespace pcl_utils {
+
+/** Shared memory point cloud field description. */
+typedef struct
+{
+	char     name[POINTCLOUD_FIELD_NAME_MAX_LENGTH]; /**< field name */
+	uint32_t offset;                                 /**< offset of field in point */
+	uint8_t  datatype; /**< data type, cf. pcl::PCLPointField::PointFieldTypes */
+	uint8_t  reserved[3]; /**< reserved for future use */
+	uint32_t count;       /**< number of elements */
+} SharedMemoryPointCloud_field_t;
+
+/** Shared memory point cloud header struct. */
+typedef struct
+{
+	char     pcl_id[POINTCLOUD_ID_MAX_LENGTH];         /**< point cloud ID */
+	char     frame_id[POINTCLOUD_FRAME_ID_MAX_LENGTH]; /**< coordinate frame ID */
+	uint32_t point_size;                               /**< size of a point in bytes */
+	uint32_t capacity;                                 /**< maximum number of points */
+	uint32_t width;                                    /**< width of current cloud */
+	uint32_t height;                                   /**< height of current cloud */
+	uint32_t is_dense;   /**< 1 if current cloud contains no invalid points */
+	uint32_t generation; /**< incremented on every write */
+	int64_t  capture_time_sec;  /**< capture time, seconds since the epoch */
+	int64_t  capture_time_usec; /**< addendum to capture_time_sec in micro seconds */
+	uint32_t num_fields;        /**< number of valid entries in fields */
+	SharedMemoryPointCloud_field_t fields[POINTCLOUD_MAX_FIELDS]; /**< point fields */
+} SharedMemoryPointCloud_header_t;
+
+class SharedMemoryPointCloudHeader : public fawkes::SharedMemoryHeader
+{
+public:
+	SharedMemoryPointCloudHeader();
+	SharedMemoryPointCloudHeader(const char * pcl_id,
+	                             unsigned int point_size,
+	                             unsigned int capacity);
+	SharedMemoryPointCloudHeader(const SharedMemoryPointCloudHeader *h);
+	virtual ~SharedMemoryPointCloudHeader();
+
+	virtual fawkes::SharedMemoryHeader *clone() const;
+	virtual bool                        matches(void *memptr);
+	virtual size_t                      size();
+	virtual bool                        create();
+	virtual void                        initialize(void *memptr);
+	virtual void                        set(void *memptr);
+	virtual void                        reset();
+	virtual size_t                      data_size();
+	virtual bool                        operator==(const fawkes::SharedMemoryHeader &s) const;
+	virtual const char *                segment_name() const;
+
+	virtual void print_info();
+
+	const char * pcl_id() const;
+	const char * frame_id() const;
+	unsigned int point_size() const;
+	unsigned int capacity() const;
+	unsigned int width() const;
+	unsigned int height() const;
+
+	SharedMemoryPointCloud_header_t *raw_header();
+
+private:
+	SharedMemoryPointCloud_header_t *header_;
+
+	char *       pcl_id_;
+	unsigned int point_size_;
+	unsigned int capacity_;
+};
+
+class SharedMemoryPointCloudLister : public fawkes::SharedMemoryLister
+{
+public:
+	SharedMemoryPointCloudLister();
+	virtual ~SharedMemoryPointCloudLister();
+
+	virtual void print_header();
+	virtual void print_footer();
+	virtual void print_no_segments();
+	virtual void print_no_orphaned_segments();
+	virtual void print_info(const fawkes::SharedMemoryHeader *header,
+	                        int                               shm_id,
+	                        int                               semaphore,
+	                        unsigned int                      mem_size,
+	                        const void *                      memptr);
+};
+
+class SharedMemoryPointCloud : public fawkes::SharedMemory
+{
+public:
+	SharedMemoryPointCloud(const char *pcl_id, unsigned int point_size, unsigned int capacity);
+	SharedMemoryPointCloud(const char *pcl_id, bool is_read_only = true);
+	~SharedMemoryPointCloud();
+
+	const char * pcl_id() const;
+	const char * frame_id() const;
+	void         set_frame_id(const char *frame_id);
+	unsigned int point_size() const;
+	unsigned int capacity() const;
+	unsigned int width() const;
+	unsigned int height() const;
+	void         set_dimensions(unsigned int width, unsigned int height);
+	size_t       num_points() const;
+	bool         is_dense() const;
+	void         set_dense(bool is_dense);
+	unsigned int generation() const;
+	void         increment_generation();
+	fawkes::Time capture_time() const;
+	void         set_capture_time(const fawkes::Time &time);
+
+	unsigned int                          num_fields() const;
+	const SharedMemoryPointCloud_field_t *fields() const;
+	void                                  set_field(unsigned int index,
+	                                                const char * name,
+	                                                unsigned int offset,
+	                                                uint8_t      datatype,
+	                                                unsigned int count);
+	void                                  set_num_fields(unsigned int num_fields);
+
+	void *data() const;
+
+	template <typename PointT>
+	const PointT *points() const;
+
+	template <typename PointT>
+	void write(const pcl::PointCloud<PointT> &cloud);
+
+	template <typename PointT>
+	bool read(pcl::PointCloud<PointT> &cloud, unsigned int *generation = NULL);
+
+	static void list();
+	static void cleanup(bool use_lister = true);
+	static bool exists(const char *pcl_id);
+	static void wipe(const char *pcl_id);
+
+private:
+	void constructor(const char * pcl_id,
+	                 unsigned int point_size,
+	                 unsigned int capacity,
+	                 bool         is_read_only);
+
+	SharedMemoryPointCloudHeader *   priv_header_;
+	SharedMemoryPointCloud_header_t *raw_header_;
+
+	char *pcl_id_;
+};
+
+/// @cond INTERNALS
+template <typename PointT>
+struct SharedMemoryPointCloudFieldAdder
+{
+	SharedMemoryPointCloudFieldAdder(SharedMemoryPointCloud *shm) : shm_(shm), index_(0)
+	{
+	}
+
+	template <typename U>
+	void
+	operator()()
+	{
+		if (index_ < POINTCLOUD_MAX_FIELDS) {
+			shm_->set_field(index_++,
+			                pcl::traits::name<PointT, U>::value,
+			                pcl::traits::offset<PointT, U>::value,
+			                pcl::traits::datatype<PointT, U>::value,
+			                pcl::traits::datatype<PointT, U>::size);
+			shm_->set_num_fields(index_);
+		}
+	}
+
+	SharedMemoryPointCloud *shm_;
+	unsigned int            index_;
+};
+/// @endcond
+
+/** Get points for zero-copy access.
+ * The segment should be locked for reading while accessing the points.
+ * Only the first num_points() points are valid.
+ * @return pointer to first point
+ * @exception Exception thrown if the point size does not match
+ */
+template <typename PointT>
+const PointT *
+SharedMemoryPointCloud::points() const
+{
+	if (point_size() != sizeof(PointT)) {
+		throw Exception("Point cloud '%s' has point size %u, expected %zu",
+		                pcl_id_,
+		                point_size(),
+		                sizeof(PointT));
+	}
+	return (const PointT *)_memptr;
+}
+
+/** Write point cloud.
+ * Copies the data and meta data of the given cloud into the segment
+ * and increments the generation. The segment is locked for writing
+ * during the operation.
+ * @param cloud cloud to write
+ * @exception Exception thrown if the point size does not match or the
+ * cloud exceeds the capacity of the segment
+ */
+template <typename PointT>
+void
+SharedMemoryPointCloud::write(const pcl::PointCloud<PointT> &cloud)
+{
+	if (point_size() != sizeof(PointT)) {
+		throw Exception("Point cloud '%s' has point size %u, got %zu",
+		                pcl_id_,
+		                point_size(),
+		                sizeof(PointT));
+	}
+	if (cloud.points.size() > capacity()) {
+		throw Exception("Point cloud '%s' has capacity %u, got %zu points",
+		                pcl_id_,
+		                capacity(),
+		                cloud.points.size());
+	}
+
+	fawkes::Time time;
+	pcl_utils::get_time(cloud, time);
+
+	lock_for_write();
+	if (num_fields() == 0) {
+		pcl::for_each_type<typename pcl::traits::fieldList<PointT>::type>(
+		  SharedMemoryPointCloudFieldAdder<PointT>(this));
+	}
+	set_frame_id(cloud.header.frame_id.c_str());
+	if (cloud.height * cloud.width == cloud.points.size()) {
+		set_dimensions(cloud.width, cloud.height);
+	} else {
+		set_dimensions(cloud.points.size(), 1);
+	}
+	set_dense(cloud.is_dense);
+	set_capture_time(time);
+	memcpy(_memptr, cloud.points.data(), cloud.points.size() * sizeof(PointT));
+	increment_generation();
+	unlock();
+}
+
+/** Read point cloud.
+ * Copies the data and meta data of the segment into the given cloud.
+ * Resizing to the same size as before does not allocate. The segment is
+ * locked for reading during the operation.
+ * @param cloud cloud to fill
+ * @param generation if not NULL, upon return contains the generation of
+ * the data copied to @p cloud
+ * @return true if the cloud was read, false if nothing has been written, yet
+ * @exception Exception thrown if the point size does not match
+ */
+template <typename PointT>
+bool
+SharedMemoryPointCloud::read(pcl::PointCloud<PointT> &cloud, unsigned int *generation)
+{
+	lock_for_read();
+	try {
+		const PointT *p = points<PointT>();
+		if (raw_header_->generation == 0) {
+			unlock();
+			return false;
+		}
+		cloud.header.frame_id = frame_id();
+		cloud.width           = width();
+		cloud.height          = height();
+		cloud.is_dense        = is_dense();
+		cloud.points.resize(num_points());
+		memcpy(cloud.points.data(), p, num_points() * sizeof(PointT));
+		pcl_utils::set_time<PointT>(cloud, capture_time());
+		if (generation)
+			*generation = raw_header_->generation;
+	} catch (Exception &e) {
+		unlock();
+		throw;
+	}
+	unlock();
+	return true;
+}
+
+} // end namespace pcl_utils
+} // end namespace fawkes
+
+#endif
@@ -95,5 +95,12 @@ namespace pcl_utils {
  * @author Tim Niemueller
  */
 
+/** @class PointCloudBufferStorageAdapter <pcl_utils/storage_adapter.h>
+ * Adapter class for buffered point clouds.
+ * All accessors refer to the current cloud of the buffer at the time
+ * of the call.
+ * @author agent
+ */
+
 } // end namespace pcl_utils
 } // end namespace fawkes
@@ -24,6 +24,7 @@
 #define _LIBS_PCL_UTILS_STORAGE_ADAPTER_H_
 
 #include <pcl/point_cloud.h>
+#include <pcl_utils/pointcloud_buffer.h>
 #include <pcl_utils/transforms.h>
 #include <pcl_utils/utils.h>
 
@@ -193,6 +194,135 @@ public:
 	virtual void get_time(fawkes::Time &time) const;
 };
 
+template <typename PointT>
+class PointCloudBufferStorageAdapter : public StorageAdapter
+{
+public:
+	/** Constructor.
+   * @param buffer buffer to encapsulate.
+   */
+	PointCloudBufferStorageAdapter(RefPtr<PointCloudBuffer<PointT>> buffer) : buffer(buffer)
+	{
+	}
+
+	/** The point cloud buffer. */
+	const RefPtr<PointCloudBuffer<PointT>> buffer;
+
+	/** Clone this storage adapter.
+   * The clone refers to the same buffer and thus always to the
+   * current cloud.
+   * @return A pointer to a copy of this storage adapter.
+   */
+	virtual StorageAdapter *
+	clone() const
+	{
+		return new PointCloudBufferStorageAdapter<PointT>(buffer);
+	}
+
+	/** Transform the point cloud.
+   * Not supported, buffered clouds must not be modified by readers.
+   * @param target_frame frame to transform to
+   * @param transformer transformer to get transform from
+   * @exception Exception always thrown
+   */
+	virtual void
+	transform(const std::string &target_frame, const tf::Transformer &transformer)
+	{
+		throw Exception("Cannot transform buffered point cloud in place");
+	}
+
+	/** Transform point cloud.
+   * Not supported, buffered clouds must not be modified by readers.
+   * @param target_frame frame to transform to
+   * @param target_time time for which to transform
+   * @param fixed_frame frame fixed over time
+   * @param transformer transformer to get transform from
+   * @exception Exception always thrown
+   */
+	virtual void
+	transform(const std::string &    target_frame,
+	          const Time &           target_time,
+	          const std::string &    fixed_frame,
+	          const tf::Transformer &transformer)
+	{
+		throw Exception("Cannot transform buffered point cloud in place");
+	}
+
+	/** Get typename of storage adapter.
+  * @return type name
+  */
+	virtual const char *
+	get_typename()
+	{
+		return typeid(this).name();
+	}
+
+	/** Get size of a point.
+   * @return size in bytes of a single point
+   */
+	virtual size_t
+	point_size() const
+	{
+		return sizeof(PointT);
+	}
+
+	/** Get width of current point cloud.
+   * @return width of point cloud
+   */
+	virtual unsigned int
+	width() const
+	{
+		return buffer->snapshot()->width;
+	}
+
+	/** Get height of current point cloud.
+   * @return height of point cloud
+   */
+	virtual unsigned int
+	height() const
+	{
+		return buffer->snapshot()->height;
+	}
+
+	/** Get numer of points in current point cloud.
+   * @return number of points
+   */
+	virtual size_t
+	num_points() const
+	{
+		return buffer->snapshot()->points.size();
+	}
+
+	/** Get pointer on data of current point cloud.
+   * The data is not overwritten before the producer has published
+   * further clouds, cf. PointCloudBuffer.
+   * @return pointer on data
+   */
+	virtual void *
+	data_ptr() const
+	{
+		return (void *)buffer->snapshot()->points.data();
+	}
+
+	/** Get frame ID of current point cloud.
+   * @return Frame ID of point cloud.
+   */
+	virtual std::string
+	frame_id() const
+	{
+		return buffer->snapshot()->header.frame_id;
+	}
+
+	/** Get last capture time.
+   * @param time upon return contains last capture time
+   */
+	virtual void
+	get_time(fawkes::Time &time) const
+	{
+		pcl_utils::get_time(buffer->snapshot(), time);
+	}
+};
+
 template <typename PointT>
 bool
 StorageAdapter::is_pointtype() const
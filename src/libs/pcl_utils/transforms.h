@@ -29,14 +29,113 @@
 #include <tf/transformer.h>
 #include <tf/types.h>
 
+#include <algorithm>
+#ifdef __SSE__
+#	include <xmmintrin.h>
+#	include <emmintrin.h>
+#endif
+#ifdef _OPENMP
+#	include <omp.h>
+#endif
+
 namespace fawkes {
 namespace pcl_utils {
 
+namespace detail {
+
+/** Minimum number of points for which to run the transform in parallel. */
+static const size_t TRANSFORM_PARALLEL_MIN_POINTS = 32768;
+
+/** Apply a rigid transform to a range of points.
+ * Only the XYZ coordinates are transformed, the fourth element of the
+ * point data is kept, all other fields must have been copied already.
+ * Invalid (non-finite) points stay invalid.
+ * @param in input points
+ * @param out output points, may be the same as @p in
+ * @param n number of points in @p in and @p out
+ * @param m row-major 3x4 transformation matrix, rotation in the
+ * left 3x3 block and translation in the right-most column
+ */
+template <typename PointT>
+inline void
+transform_points(const PointT *in, PointT *out, size_t n, const float m[12])
+{
+#ifdef __SSE__
+	// columns of the matrix, translation lane 3 is zero to keep data[3]
+	const __m128 c0 = _mm_setr_ps(m[0], m[4], m[8], 0.f);
+	const __m128 c1 = _mm_setr_ps(m[1], m[5], m[9], 0.f);
+	const __m128 c2 = _mm_setr_ps(m[2], m[6], m[10], 0.f);
+	const __m128 c3 = _mm_setr_ps(m[3], m[7], m[11], 0.f);
+	const __m128 w  = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+	for (size_t i = 0; i < n; ++i) {
+		const __m128 p = _mm_loadu_ps(in[i].data);
+		__m128       r = _mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0))),
+		                      _mm_mul_ps(c1, _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1))));
+		r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2))));
+		r = _mm_add_ps(r, _mm_or_ps(c3, _mm_and_ps(p, w)));
+		_mm_storeu_ps(out[i].data, r);
+	}
+#else
+	for (size_t i = 0; i < n; ++i) {
+		const float x = in[i].x, y = in[i].y, z = in[i].z;
+		out[i].x      = m[0] * x + m[1] * y + m[2] * z + m[3];
+		out[i].y      = m[4] * x + m[5] * y + m[6] * z + m[7];
+		out[i].z      = m[8] * x + m[9] * y + m[10] * z + m[11];
+	}
+#endif
+}
+
+} // end namespace detail
+
+/** Apply a rigid transform.
+ * Unlike pcl::transformPointCloud() this does not special-case clouds
+ * which are not dense. Large clouds, e.g. organized clouds of RGB-D
+ * cameras, are split among multiple threads if compiled with OpenMP.
+ * @param cloud_in the input point cloud
+ * @param cloud_out the output point cloud, may be the same as @p cloud_in
+ * @param transform rigid transformation
+ */
+template <typename PointT>
+void
+transform_pointcloud(const pcl::PointCloud<PointT> &cloud_in,
+                     pcl::PointCloud<PointT> &      cloud_out,
+                     const Eigen::Affine3f &        transform)
+{
+	if (&cloud_in != &cloud_out) {
+		cloud_out = cloud_in;
+	}
+
+	float m[12];
+	for (unsigned int r = 0; r < 3; ++r) {
+		for (unsigned int c = 0; c < 4; ++c) {
+			m[r * 4 + c] = transform(r, c);
+		}
+	}
+
+	const PointT *in  = cloud_in.points.data();
+	PointT *      out = cloud_out.points.data();
+	const size_t  n   = cloud_out.points.size();
+#ifdef _OPENMP
+	if (n >= detail::TRANSFORM_PARALLEL_MIN_POINTS) {
+		const long num_chunks = omp_get_max_threads();
+		const long chunk_size = (n + num_chunks - 1) / num_chunks;
+#	pragma omp parallel for
+		for (long c = 0; c < num_chunks; ++c) {
+			const size_t first = c * chunk_size;
+			if (first < n) {
+				detail::transform_points(in + first, out + first, std::min<size_t>(chunk_size, n - first), m);
+			}
+		}
+		return;
+	}
+#endif
+	detail::transform_points(in, out, n, m);
+}
+
 /** Apply a rigid transform.
  * @param cloud_in the input point cloud
- * @param cloud_out the input point cloud
+ * @param cloud_out the output point cloud
  * @param transform a rigid transformation from tf
- * @note calls the Eigen version
  */
 template <typename PointT>
 void
@@ -52,25 +151,22 @@ transform_pointcloud(const pcl::PointCloud<PointT> &cloud_in,
 	// mistake, we copy the quaternion, which is a small cost compared
 	// to the conversion of the point cloud anyway. Idem for the origin.
 
-	tf::Quaternion     q = transform.getRotation();
-	Eigen::Quaternionf rotation(q.w(), q.x(), q.y(), q.z()); // internally stored as (x,y,z,w)
-	tf::Vector3        v = transform.getOrigin();
-	Eigen::Vector3f    origin(v.x(), v.y(), v.z());
-	pcl::transformPointCloud(cloud_in, cloud_out, origin, rotation);
+	tf::Quaternion  q = transform.getRotation();
+	tf::Vector3     v = transform.getOrigin();
+	Eigen::Affine3f affine = Eigen::Translation3f(v.x(), v.y(), v.z())
+	                         * Eigen::Quaternionf(q.w(), q.x(), q.y(), q.z());
+	transform_pointcloud(cloud_in, cloud_out, affine);
 }
 
 /** Apply a rigid transform.
  * @param cloud_inout input and output point cloud
  * @param transform a rigid transformation from tf
- * @note calls the Eigen version
  */
 template <typename PointT>
 void
 transform_pointcloud(pcl::PointCloud<PointT> &cloud_inout, const tf::Transform &transform)
 {
-	pcl::PointCloud<PointT> tmp;
-	transform_pointcloud(cloud_inout, tmp, transform);
-	cloud_inout = tmp;
+	transform_pointcloud(cloud_inout, cloud_inout, transform);
 }
 
 /** Transform a point cloud in a given target TF frame using the given transfomer.
@@ -88,7 +184,9 @@ transform_pointcloud(const std::string &            target_frame,
                      const tf::Transformer &        transformer)
 {
 	if (cloud_in.header.frame_id == target_frame) {
-		cloud_out = cloud_in;
+		if (&cloud_in != &cloud_out) {
+			cloud_out = cloud_in;
+		}
 		return;
 	}
 
@@ -113,9 +211,7 @@ transform_pointcloud(const std::string &      target_frame,
                      pcl::PointCloud<PointT> &cloud_inout,
                      const tf::Transformer &  transformer)
 {
-	pcl::PointCloud<PointT> tmp;
-	transform_pointcloud(target_frame, cloud_inout, tmp, transformer);
-	cloud_inout = tmp;
+	transform_pointcloud(target_frame, cloud_inout, cloud_inout, transformer);
 }
 
 /** Transform a point cloud in a given target TF frame using the given transfomer.
@@ -135,7 +231,9 @@ transform_pointcloud(const std::string &            target_frame,
                      const tf::Transformer &        transformer)
 {
 	if (cloud_in.header.frame_id == target_frame) {
-		cloud_out = cloud_in;
+		if (&cloud_in != &cloud_out) {
+			cloud_out = cloud_in;
+		}
 		return;
 	}
 
@@ -166,9 +264,7 @@ transform_pointcloud(const std::string &      target_frame,
                      pcl::PointCloud<PointT> &cloud_inout,
                      const tf::Transformer &  transformer)
 {
-	pcl::PointCloud<PointT> tmp;
-	transform_pointcloud(target_frame, target_time, fixed_frame, cloud_inout, tmp, transformer);
-	cloud_inout = tmp;
+	transform_pointcloud(target_frame, target_time, fixed_frame, cloud_inout, cloud_inout, transformer);
 }
 
 } // end namespace pcl_utils
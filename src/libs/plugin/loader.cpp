@@ -21,6 +21,8 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <plugin/loader.h>
 #include <utils/system/dynamic_module/module.h>
 #include <utils/system/dynamic_module/module_manager.h>
@@ -43,6 +45,7 @@ class PluginLoader::Data
 {
 public:
 	ModuleManager *                 mm;
+	Mutex                           mutex;
 	std::map<Plugin *, Module *>    plugin_module_map;
 	std::map<std::string, Plugin *> name_plugin_map;
 	std::map<Plugin *, std::string> plugin_name_map;
@@ -108,6 +111,7 @@ PluginUnloadException::PluginUnloadException(const char *plugin_name, const char
  * This class manages plugins.
  * With this class plugins can be loaded and unloaded. Information is
  * kept about active plugins.
+ * Different plugins may be loaded concurrently from multiple threads.
  *
  * @author Tim Niemueller
  */
@@ -201,14 +205,19 @@ PluginLoader::load(const char *plugin_name)
 {
 	std::string pn = plugin_name;
 
+	d_->mutex.lock();
 	if (d_->name_plugin_map.find(pn) != d_->name_plugin_map.end()) {
-		return d_->name_plugin_map[pn];
+		Plugin *p = d_->name_plugin_map[pn];
+		d_->mutex.unlock();
+		return p;
 	}
+	d_->mutex.unlock();
 
 	try {
 		Module *module = open_module(plugin_name);
 		Plugin *p      = create_instance(plugin_name, module);
 
+		MutexLocker lock(&d_->mutex);
 		d_->plugin_module_map[p] = module;
 		d_->name_plugin_map[pn]  = p;
 		d_->plugin_name_map[p]   = pn;
@@ -347,6 +356,7 @@ PluginLoader::get_description(const char *plugin_name)
 bool
 PluginLoader::is_loaded(const char *plugin_name)
 {
+	MutexLocker lock(&d_->mutex);
 	return (d_->name_plugin_map.find(plugin_name) != d_->name_plugin_map.end());
 }
 
@@ -364,6 +374,7 @@ PluginLoader::is_loaded(const char *plugin_name)
 void
 PluginLoader::unload(Plugin *plugin)
 {
+	MutexLocker lock(&d_->mutex);
 	if (d_->plugin_module_map.find(plugin) != d_->plugin_module_map.end()) {
 		PluginDestroyFunc pdf =
 		  (PluginDestroyFunc)d_->plugin_module_map[plugin]->get_symbol("plugin_destroy");
@@ -38,6 +38,7 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <dirent.h>
@@ -96,6 +97,7 @@ PluginManager::PluginManager(ThreadCollector *   thread_collector,
 	next_plugin_id      = 1;
 	config_             = config;
 	meta_plugin_prefix_ = meta_plugin_prefix;
+	parallel_loading_   = false;
 
 	if (init_cache) {
 		init_pinfo_cache();
@@ -156,6 +158,21 @@ PluginManager::set_module_flags(Module::ModuleFlags flags)
 	plugin_loader->get_module_manager()->set_open_flags(flags);
 }
 
+/** Enable or disable parallel loading.
+ * If enabled, the modules of all plugins passed to load() are opened
+ * and the plugins instantiated concurrently. The threads of the plugins
+ * are still added to the thread collector, and thus initialized by the
+ * aspect initializers, one plugin at a time in the given order. This
+ * keeps the order of initialization and therefore dependencies between
+ * plugins intact.
+ * @param enabled true to enable parallel loading, false to disable
+ */
+void
+PluginManager::set_parallel_loading(bool enabled)
+{
+	parallel_loading_ = enabled;
+}
+
 /** Initialize plugin info cache. */
 void
 PluginManager::init_pinfo_cache()
@@ -336,6 +353,60 @@ PluginManager::load(const std::string &plugin_list)
 void
 PluginManager::load(const std::list<std::string> &plugin_list)
 {
+	std::map<std::string, std::future<Plugin *>> preloads;
+	if (parallel_loading_) {
+		preload(plugin_list, preloads);
+	}
+
+	try {
+		load(plugin_list, preloads);
+	} catch (...) {
+		// unload plugins preloaded for the failed request
+		for (auto &p : preloads) {
+			try {
+				plugin_loader->unload(p.second.get());
+			} catch (Exception &e) {
+			}
+		}
+		throw;
+	}
+}
+
+/** Open modules of plugins concurrently.
+ * Starts a task for each plugin in the list that is not a meta plugin and
+ * not loaded, yet, which opens the module and instantiates the plugin.
+ * @param plugin_list list of plugins about to be loaded
+ * @param preloads upon return contains a future per started task
+ */
+void
+PluginManager::preload(const std::list<std::string> &                plugin_list,
+                       std::map<std::string, std::future<Plugin *>> &preloads)
+{
+	for (const std::string &p : plugin_list) {
+		if (p.empty() || (preloads.find(p) != preloads.end())
+		    || (meta_plugins_.find(p) != meta_plugins_.end())
+		    || config_->exists((meta_plugin_prefix_ + p).c_str())
+		    || (find_if(plugins.begin(), plugins.end(), plname_eq(p)) != plugins.end())
+		    || plugin_loader->is_loaded(p.c_str())) {
+			continue;
+		}
+		preloads[p] =
+		  std::async(std::launch::async, [this, p]() { return plugin_loader->load(p.c_str()); });
+	}
+}
+
+/** Load plugins.
+ * @param plugin_list list of plugin names to load
+ * @param preloads plugins being opened concurrently, entries are removed
+ * as the plugins are loaded
+ */
+void
+PluginManager::load(const std::list<std::string> &                plugin_list,
+                    std::map<std::string, std::future<Plugin *>> &preloads)
+{
+	using namespace std::chrono;
+	steady_clock::time_point load_start = steady_clock::now();
+
 	for (std::list<std::string>::const_iterator i = plugin_list.begin(); i != plugin_list.end();
 	     ++i) {
 		if (i->length() == 0)
@@ -391,13 +462,30 @@ PluginManager::load(const std::list<std::string> &plugin_list)
 		    && (find_if(plugins.begin(), plugins.end(), plname_eq(*i)) == plugins.end())) {
 			try {
 				//printf("Going to load real plugin %s\n", i->c_str());
+				steady_clock::time_point open_start = steady_clock::now();
+				auto                     pre        = preloads.find(*i);
+				if (pre != preloads.end()) {
+					try {
+						pre->second.get();
+					} catch (Exception &e) {
+						// loaded again below to report the error
+					}
+					preloads.erase(pre);
+				}
 				Plugin *plugin = plugin_loader->load(i->c_str());
 				plugins.lock();
 				try {
+					steady_clock::time_point init_start = steady_clock::now();
 					thread_collector->add(plugin->threads());
 					plugins.push_back(plugin);
 					plugin_ids[*i] = next_plugin_id++;
-					LibLogger::log_debug("PluginManager", "Loaded plugin %s", i->c_str());
+					steady_clock::time_point init_end = steady_clock::now();
+					LibLogger::log_debug("PluginManager",
+					                     "Loaded plugin %s (at %.1f ms, module %.1f ms, init %.1f ms)",
+					                     i->c_str(),
+					                     duration<float, std::milli>(open_start - load_start).count(),
+					                     duration<float, std::milli>(init_start - open_start).count(),
+					                     duration<float, std::milli>(init_end - init_start).count());
 					notify_loaded(i->c_str());
 				} catch (CannotInitializeThreadException &e) {
 					e.append("Plugin >>> %s <<< could not be initialized, unloading", i->c_str());
@@ -30,6 +30,8 @@
 #include <utils/system/dynamic_module/module.h>
 #include <utils/system/fam.h>
 
+#include <future>
+#include <map>
 #include <string>
 #include <utility>
 
@@ -55,6 +57,7 @@ public:
 	~PluginManager();
 
 	void set_module_flags(Module::ModuleFlags flags);
+	void set_parallel_loading(bool enabled);
 	void init_pinfo_cache();
 
 	// for ConfigurationChangeHandler
@@ -90,6 +93,10 @@ private:
 	void notify_unloaded(const char *plugin_name);
 
 	std::list<std::string> parse_plugin_list(const char *plugin_type_list);
+	void                   preload(const std::list<std::string> &                plugin_list,
+	                               std::map<std::string, std::future<Plugin *>> &preloads);
+	void                   load(const std::list<std::string> &                plugin_list,
+	                            std::map<std::string, std::future<Plugin *>> &preloads);
 
 private:
 	ThreadCollector *thread_collector;
@@ -115,6 +122,8 @@ private:
 	std::string    meta_plugin_prefix_;
 
 	FamThread *fam_thread_;
+
+	bool parallel_loading_;
 };
 
 } // end namespace fawkes
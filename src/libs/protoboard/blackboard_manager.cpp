@@ -26,6 +26,8 @@
 
 #include "protobuf_to_bb.h"
 
+#include <google/protobuf/descriptor.h>
+
 namespace protoboard {
 
 using namespace fawkes;
@@ -70,6 +72,7 @@ void
 BlackboardManager::finalize()
 {
 	delete on_message_waker_;
+	pb_converters_.clear();
 	bb_receiving_interfaces_.clear();
 	pb_sender_->finalize();
 	blackboard->close(peer_iface_);
@@ -88,20 +91,21 @@ BlackboardManager::loop()
 	// Handle sending blackboard interfaces
 	pb_sender_->process_sending_interfaces();
 
-	// Handle receiving blackboard interfaces
-	while (message_handler_->pb_queue_incoming()) {
-		ProtobufThead::incoming_message inc = message_handler_->pb_queue_pop();
-		pb_conversion_map::iterator     it;
+	// Handle receiving blackboard interfaces, take all queued messages at once
+	message_handler_->pb_queue_take(pb_batch_);
+	while (!pb_batch_.empty()) {
+		ProtobufThead::incoming_message inc = std::move(pb_batch_.front());
+		pb_batch_.pop();
 
-		if ((it = bb_receiving_interfaces_.find(inc.msg->GetTypeName()))
-		    == bb_receiving_interfaces_.end()) {
+		pb_convert *converter = converter_for(*inc.msg);
+		if (!converter) {
 			logger->log_error(name(),
 			                  "Received message of unregistered type `%s'",
 			                  inc.msg->GetTypeName().c_str());
 			continue;
 		}
 		try {
-			it->second->handle(inc.msg);
+			converter->handle(inc.msg);
 		} catch (std::exception &e) {
 			logger->log_error(name(),
 			                  "Exception while handling %s: %s",
@@ -111,6 +115,31 @@ BlackboardManager::loop()
 	}
 }
 
+/** Get converter for a message.
+ * The converter is looked up by type name once and then cached by the
+ * message descriptor, which avoids creating the type name string for
+ * every received message.
+ * @param msg received message
+ * @return converter, nullptr if the message type is not registered
+ */
+pb_convert *
+BlackboardManager::converter_for(const google::protobuf::Message &msg)
+{
+	const google::protobuf::Descriptor *desc = msg.GetDescriptor();
+	auto                                c    = pb_converters_.find(desc);
+	if (c != pb_converters_.end()) {
+		return c->second;
+	}
+
+	pb_conversion_map::iterator it        = bb_receiving_interfaces_.find(desc->full_name());
+	pb_convert *                converter = nullptr;
+	if (it != bb_receiving_interfaces_.end()) {
+		converter = it->second.get();
+	}
+	pb_converters_[desc] = converter;
+	return converter;
+}
+
 BlackBoard *
 BlackboardManager::get_blackboard()
 {
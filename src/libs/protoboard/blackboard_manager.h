@@ -235,7 +235,11 @@ private:
 	unsigned int                            next_peer_idx_;
 	std::unique_ptr<AbstractProtobufSender> pb_sender_;
 
-	void add_peer(fawkes::ProtobufPeerInterface *iface, long peer_id);
+	std::queue<ProtobufThead::incoming_message> pb_batch_;
+	std::unordered_map<const google::protobuf::Descriptor *, pb_convert *> pb_converters_;
+
+	void        add_peer(fawkes::ProtobufPeerInterface *iface, long peer_id);
+	pb_convert *converter_for(const google::protobuf::Message &msg);
 
 	template <class MessageT, class InterfaceT>
 	void handle_message_type(InterfaceT *iface);
@@ -74,6 +74,13 @@ ProtobufThead::pb_queue_pop()
 	return msg;
 }
 
+void
+ProtobufThead::pb_queue_take(std::queue<incoming_message> &batch)
+{
+	fawkes::MutexLocker lock(&msgq_mutex_);
+	pb_queue_.swap(batch);
+}
+
 /** Enable protobuf peer.
  * @param address IP address to send messages to
  * @param send_to_port UDP port to send messages to
@@ -80,6 +80,10 @@ public:
 	/// @return The head of the incoming ProtoBuf message queue (popped)
 	incoming_message pb_queue_pop();
 
+	/** Take all incoming ProtoBuf messages at once
+	 * @param batch queue to swap with the incoming message queue, should be empty */
+	void pb_queue_take(std::queue<incoming_message> &batch);
+
 	long int peer_create(const std::string &host, int port);
 	long int peer_create_local(const std::string &host, int send_to_port, int recv_on_port);
 	long int peer_create_crypto(const std::string &host,
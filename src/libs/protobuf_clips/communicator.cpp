@@ -43,6 +43,7 @@
 #include <protobuf_comm/server.h>
 
 #include <boost/format.hpp>
+#include <iterator>
 
 using namespace google::protobuf;
 using namespace protobuf_comm;
@@ -56,6 +57,13 @@ namespace protobuf_clips {
  * environment. It supports the creation of communication channels
  * through protobuf_comm. An instance maintains its own message register
  * shared among server, peer, and clients.
+ *
+ * By default a protobuf-msg fact is asserted as soon as a message has been
+ * received. In deferred mode messages are queued instead and asserted as
+ * a batch by process_messages(), e.g. at the start of an agent cycle. In
+ * this mode messages of types marked for coalescing are only kept for the
+ * latest message per sender, and messages are asserted in the order of
+ * the priorities of their types.
  * @author Tim Niemueller
  */
 
@@ -67,7 +75,12 @@ namespace protobuf_clips {
 ClipsProtobufCommunicator::ClipsProtobufCommunicator(CLIPS::Environment *env,
                                                      fawkes::Mutex &     env_mutex,
                                                      fawkes::Logger *    logger)
-: clips_(env), clips_mutex_(env_mutex), logger_(logger), server_(NULL), next_client_id_(0)
+: clips_(env),
+  clips_mutex_(env_mutex),
+  logger_(logger),
+  server_(NULL),
+  next_client_id_(0),
+  deferred_(false)
 {
 	message_register_ = new MessageRegister();
 	setup_clips();
@@ -83,7 +96,12 @@ ClipsProtobufCommunicator::ClipsProtobufCommunicator(CLIPS::Environment *      e
                                                      fawkes::Mutex &           env_mutex,
                                                      std::vector<std::string> &proto_path,
                                                      fawkes::Logger *          logger)
-: clips_(env), clips_mutex_(env_mutex), logger_(logger), server_(NULL), next_client_id_(0)
+: clips_(env),
+  clips_mutex_(env_mutex),
+  logger_(logger),
+  server_(NULL),
+  next_client_id_(0),
+  deferred_(false)
 {
 	message_register_ = new MessageRegister(proto_path);
 	setup_clips();
@@ -198,6 +216,74 @@ ClipsProtobufCommunicator::setup_clips()
 	ADD_FUNCTION("pb-disconnect",
 	             (sigc::slot<void, long int>(
 	               sigc::mem_fun(*this, &ClipsProtobufCommunicator::clips_pb_disconnect))));
+	ADD_FUNCTION("pb-set-deferred",
+	             (sigc::slot<void, CLIPS::Value>(
+	               sigc::mem_fun(*this, &ClipsProtobufCommunicator::clips_pb_set_deferred))));
+	ADD_FUNCTION("pb-coalesce-type",
+	             (sigc::slot<void, std::string>(
+	               sigc::mem_fun(*this, &ClipsProtobufCommunicator::clips_pb_coalesce_type))));
+	ADD_FUNCTION("pb-set-priority",
+	             (sigc::slot<void, std::string, int>(
+	               sigc::mem_fun(*this, &ClipsProtobufCommunicator::clips_pb_set_priority))));
+	ADD_FUNCTION("pb-process-messages",
+	             (sigc::slot<void>(
+	               sigc::mem_fun(*this, &ClipsProtobufCommunicator::clips_pb_process_messages))));
+}
+
+/** Enable or disable deferred assertion of messages.
+ * When disabled, messages which are still queued are asserted with the
+ * next call to process_messages().
+ * @param deferred true to queue received messages until process_messages()
+ * is called, false to assert them immediately
+ */
+void
+ClipsProtobufCommunicator::set_deferred(bool deferred)
+{
+	fawkes::MutexLocker lock(&deferred_mutex_);
+	deferred_ = deferred;
+}
+
+/** Enable or disable coalescing for a message type.
+ * In deferred mode only the latest message of a coalesced type is kept
+ * per sender, e.g. for periodic beacon messages.
+ * @param type_name full name of the message type
+ * @param coalesce true to coalesce messages of this type
+ */
+void
+ClipsProtobufCommunicator::set_coalesce(const std::string &type_name, bool coalesce)
+{
+	fawkes::MutexLocker lock(&deferred_mutex_);
+	if (coalesce) {
+		coalesce_types_.insert(type_name);
+	} else {
+		coalesce_types_.erase(type_name);
+	}
+}
+
+/** Set priority of a message type.
+ * In deferred mode messages of types with a higher priority are asserted
+ * before those of types with a lower priority. Messages of the same
+ * priority are asserted in the order they were received. The default
+ * priority is zero.
+ * @param type_name full name of the message type
+ * @param priority priority of the message type
+ */
+void
+ClipsProtobufCommunicator::set_priority(const std::string &type_name, int priority)
+{
+	fawkes::MutexLocker lock(&deferred_mutex_);
+	priorities_[type_name] = priority;
+}
+
+/** Assert queued messages.
+ * Asserts a protobuf-msg fact for each message queued in deferred mode.
+ * Locks the CLIPS environment, call pb-process-messages from within CLIPS.
+ */
+void
+ClipsProtobufCommunicator::process_messages()
+{
+	fawkes::MutexLocker lock(&clips_mutex_);
+	assert_deferred_messages();
 }
 
 /** Enable protobuf stream server.
@@ -1018,6 +1104,86 @@ ClipsProtobufCommunicator::clips_assert_message(std::pair<std::string, unsigned
 	}
 }
 
+bool
+ClipsProtobufCommunicator::defer_message(std::pair<std::string, unsigned short> &    endpoint,
+                                         uint16_t                                    comp_id,
+                                         uint16_t                                    msg_type,
+                                         std::shared_ptr<google::protobuf::Message> &msg,
+                                         ClipsProtobufCommunicator::ClientType       ct,
+                                         long int                                    client_id)
+{
+	fawkes::MutexLocker lock(&deferred_mutex_);
+	if (!deferred_)
+		return false;
+
+	const std::string &type     = msg->GetDescriptor()->full_name();
+	auto               p        = priorities_.find(type);
+	int                priority = (p != priorities_.end()) ? p->second : 0;
+
+	if (coalesce_types_.find(type) != coalesce_types_.end()) {
+		std::string key = boost::str(boost::format("%s|%i|%li|%s|%u") % type % ct % client_id
+		                             % endpoint.first % endpoint.second);
+		auto        c   = coalesced_msgs_.find(key);
+		if (c != coalesced_msgs_.end()) {
+			// replace queued message, it has not been asserted, yet
+			c->second->comp_id  = comp_id;
+			c->second->msg_type = msg_type;
+			c->second->msg      = msg;
+			return true;
+		}
+		deferred_msgs_.push_back({endpoint, comp_id, msg_type, msg, ct, client_id, priority});
+		coalesced_msgs_[key] = std::prev(deferred_msgs_.end());
+	} else {
+		deferred_msgs_.push_back({endpoint, comp_id, msg_type, msg, ct, client_id, priority});
+	}
+	return true;
+}
+
+void
+ClipsProtobufCommunicator::assert_deferred_messages()
+{
+	std::list<DeferredMessage> msgs;
+	{
+		fawkes::MutexLocker lock(&deferred_mutex_);
+		msgs.swap(deferred_msgs_);
+		coalesced_msgs_.clear();
+	}
+
+	// stable, keeps order of reception within a priority
+	msgs.sort([](const DeferredMessage &a, const DeferredMessage &b) {
+		return a.priority > b.priority;
+	});
+
+	for (DeferredMessage &m : msgs) {
+		clips_assert_message(m.endpoint, m.comp_id, m.msg_type, m.msg, m.ct, m.client_id);
+	}
+}
+
+void
+ClipsProtobufCommunicator::clips_pb_set_deferred(CLIPS::Value deferred)
+{
+	set_deferred(deferred.type() == CLIPS::TYPE_SYMBOL && deferred.as_string() == "TRUE");
+}
+
+void
+ClipsProtobufCommunicator::clips_pb_coalesce_type(std::string full_name)
+{
+	set_coalesce(full_name);
+}
+
+void
+ClipsProtobufCommunicator::clips_pb_set_priority(std::string full_name, int priority)
+{
+	set_priority(full_name, priority);
+}
+
+void
+ClipsProtobufCommunicator::clips_pb_process_messages()
+{
+	// called from within CLIPS, the environment is already locked
+	assert_deferred_messages();
+}
+
 void
 ClipsProtobufCommunicator::handle_server_client_connected(ProtobufStreamServer::ClientID  client,
                                                           boost::asio::ip::tcp::endpoint &endpoint)
@@ -1071,13 +1237,23 @@ ClipsProtobufCommunicator::handle_server_client_msg(ProtobufStreamServer::Client
                                                     uint16_t                       msg_type,
                                                     std::shared_ptr<google::protobuf::Message> msg)
 {
-	fawkes::MutexLocker          lock(&clips_mutex_);
-	fawkes::MutexLocker          lock2(&map_mutex_);
-	RevServerClientMap::iterator c;
-	if ((c = rev_server_clients_.find(client)) != rev_server_clients_.end()) {
-		clips_assert_message(
-		  client_endpoints_[c->second], component_id, msg_type, msg, CT_SERVER, c->second);
+	std::pair<std::string, unsigned short> endpp;
+	long int                               client_id;
+	{
+		fawkes::MutexLocker          lock(&map_mutex_);
+		RevServerClientMap::iterator c;
+		if ((c = rev_server_clients_.find(client)) == rev_server_clients_.end()) {
+			return;
+		}
+		client_id = c->second;
+		endpp     = client_endpoints_[client_id];
 	}
+
+	if (defer_message(endpp, component_id, msg_type, msg, CT_SERVER, client_id))
+		return;
+
+	fawkes::MutexLocker lock(&clips_mutex_);
+	clips_assert_message(endpp, component_id, msg_type, msg, CT_SERVER, client_id);
 }
 
 /** Handle server reception failure
@@ -1121,9 +1297,12 @@ ClipsProtobufCommunicator::handle_peer_msg(long int
                                            uint16_t                                   msg_type,
                                            std::shared_ptr<google::protobuf::Message> msg)
 {
-	fawkes::MutexLocker                    lock(&clips_mutex_);
 	std::pair<std::string, unsigned short> endpp =
 	  std::make_pair(endpoint.address().to_string(), endpoint.port());
+	if (defer_message(endpp, component_id, msg_type, msg, CT_PEER, peer_id))
+		return;
+
+	fawkes::MutexLocker lock(&clips_mutex_);
 	clips_assert_message(endpp, component_id, msg_type, msg, CT_PEER, peer_id);
 }
 
@@ -1177,8 +1356,11 @@ ClipsProtobufCommunicator::handle_client_msg(long int
                                              uint16_t                                   msg_type,
                                              std::shared_ptr<google::protobuf::Message> msg)
 {
-	fawkes::MutexLocker                    lock(&clips_mutex_);
 	std::pair<std::string, unsigned short> endpp = std::make_pair(std::string(), 0);
+	if (defer_message(endpp, comp_id, msg_type, msg, CT_CLIENT, client_id))
+		return;
+
+	fawkes::MutexLocker lock(&clips_mutex_);
 	clips_assert_message(endpp, comp_id, msg_type, msg, CT_CLIENT, client_id);
 }
 
@@ -43,6 +43,7 @@
 #include <clipsmm.h>
 #include <list>
 #include <map>
+#include <set>
 
 namespace protobuf_comm {
 class ProtobufStreamClient;
@@ -70,6 +71,11 @@ public:
 	void enable_server(int port);
 	void disable_server();
 
+	void set_deferred(bool deferred);
+	void set_coalesce(const std::string &type_name, bool coalesce = true);
+	void set_priority(const std::string &type_name, int priority);
+	void process_messages();
+
 	/** Get Protobuf server.
    * @return protobuf server */
 	protobuf_comm::ProtobufStreamServer *
@@ -145,6 +151,10 @@ private:
 	void          clips_pb_disconnect(long int client_id);
 	void          clips_pb_broadcast(long int peer_id, void *msgptr);
 	void          clips_pb_enable_server(int port);
+	void          clips_pb_set_deferred(CLIPS::Value deferred);
+	void          clips_pb_coalesce_type(std::string full_name);
+	void          clips_pb_set_priority(std::string full_name, int priority);
+	void          clips_pb_process_messages();
 
 	long int clips_pb_peer_create(std::string host, int port);
 	long int clips_pb_peer_create_local(std::string host, int send_port, int recv_port);
@@ -167,6 +177,13 @@ private:
 	                          std::shared_ptr<google::protobuf::Message> &msg,
 	                          ClientType                                  ct,
 	                          long int                                    client_id = 0);
+	bool defer_message(std::pair<std::string, unsigned short> &    endpoint,
+	                   uint16_t                                    comp_id,
+	                   uint16_t                                    msg_type,
+	                   std::shared_ptr<google::protobuf::Message> &msg,
+	                   ClientType                                  ct,
+	                   long int                                    client_id);
+	void assert_deferred_messages();
 	void handle_server_client_connected(protobuf_comm::ProtobufStreamServer::ClientID client,
 	                                    boost::asio::ip::tcp::endpoint &              endpoint);
 	void handle_server_client_disconnected(protobuf_comm::ProtobufStreamServer::ClientID client,
@@ -236,6 +253,26 @@ private:
 
 	std::list<std::string> functions_;
 	CLIPS::Fact::pointer   avail_fact_;
+
+	/// @cond INTERNALS
+	typedef struct
+	{
+		std::pair<std::string, unsigned short>     endpoint;
+		uint16_t                                   comp_id;
+		uint16_t                                   msg_type;
+		std::shared_ptr<google::protobuf::Message> msg;
+		ClientType                                 ct;
+		long int                                   client_id;
+		int                                        priority;
+	} DeferredMessage;
+	/// @endcond
+
+	fawkes::Mutex                                               deferred_mutex_;
+	bool                                                        deferred_;
+	std::list<DeferredMessage>                                  deferred_msgs_;
+	std::map<std::string, std::list<DeferredMessage>::iterator> coalesced_msgs_;
+	std::set<std::string>                                       coalesce_types_;
+	std::map<std::string, int>                                  priorities_;
 };
 
 } // end namespace protobuf_clips
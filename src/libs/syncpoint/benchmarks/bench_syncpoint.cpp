@@ -0,0 +1,92 @@
+
+/***************************************************************************
+ *  bench_syncpoint.cpp - SyncPoint microbenchmarks
+ *
+ *  Created: Thu Oct 15 07:45:06 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <benchmark/benchmark.h>
+#include <logging/multi.h>
+#include <syncpoint/syncpoint.h>
+#include <syncpoint/syncpoint_manager.h>
+
+#include <string>
+
+using namespace fawkes;
+
+// Emit a syncpoint nested at the given depth, the emit is propagated to
+// all predecessors, e.g. /bench/1/2 to /bench/1, /bench, and /.
+static void
+BM_SyncPointEmit(benchmark::State &state)
+{
+	MultiLogger              logger;
+	RefPtr<SyncPointManager> manager(new SyncPointManager(&logger));
+
+	std::string identifier = "/bench";
+	for (int i = 1; i < state.range(0); ++i) {
+		identifier += "/" + std::to_string(i);
+	}
+	RefPtr<SyncPoint> sp = manager->get_syncpoint("emitter", identifier);
+	sp->register_emitter("emitter");
+	unsigned int component = SyncPoint::component_id("emitter");
+
+	for (auto _ : state) {
+		sp->emit(component);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	sp->unregister_emitter("emitter");
+	manager->release_syncpoint("emitter", sp);
+}
+BENCHMARK(BM_SyncPointEmit)->ArgName("depth")->Arg(1)->Arg(4);
+
+// Wait for all emitters while there are none, the wait returns
+// immediately and only does the bookkeeping.
+static void
+BM_SyncPointWaitNoEmitter(benchmark::State &state)
+{
+	MultiLogger              logger;
+	RefPtr<SyncPointManager> manager(new SyncPointManager(&logger));
+	RefPtr<SyncPoint>        sp = manager->get_syncpoint("waiter", "/bench");
+	unsigned int             component = SyncPoint::component_id("waiter");
+
+	for (auto _ : state) {
+		sp->wait(component, SyncPoint::WAIT_FOR_ALL);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	manager->release_syncpoint("waiter", sp);
+}
+BENCHMARK(BM_SyncPointWaitNoEmitter);
+
+static void
+BM_SyncPointComponentId(benchmark::State &state)
+{
+	const std::string component = "BenchmarkComponentThread";
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(SyncPoint::component_id(component));
+	}
+}
+BENCHMARK(BM_SyncPointComponentId);
+
+BENCHMARK_MAIN();
+
+/// @endcond
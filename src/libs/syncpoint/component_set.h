@@ -0,0 +1,232 @@
+/***************************************************************************
+ *  component_set.h - Sets of SyncPoint components by ID
+ *
+ *  Created: Wed Oct 14 19:30:23 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _SYNCPOINT_COMPONENT_SET_H_
+#define _SYNCPOINT_COMPONENT_SET_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace fawkes {
+
+/** @class SyncPointComponentSet <syncpoint/component_set.h>
+ * Set of SyncPoint components stored as a bitset indexed by component ID.
+ * Memory is only allocated when a component with an ID larger than any
+ * before is inserted, hence insert, erase and lookup of known components
+ * never allocate.
+ * @see SyncPoint::component_id()
+ * @author agent
+ */
+class SyncPointComponentSet
+{
+public:
+	/** Constructor. */
+	SyncPointComponentSet() : size_(0)
+	{
+	}
+
+	/** Insert component.
+   * @param id component ID
+   * @return true if the component was inserted, false if it was already contained
+   */
+	bool
+	insert(unsigned int id)
+	{
+		const unsigned int w = id / 64;
+		if (w >= bits_.size())
+			bits_.resize(w + 1, 0);
+		const uint64_t b = (uint64_t)1 << (id % 64);
+		if (bits_[w] & b)
+			return false;
+		bits_[w] |= b;
+		++size_;
+		return true;
+	}
+
+	/** Erase component.
+   * @param id component ID
+   * @return true if the component was erased, false if it was not contained
+   */
+	bool
+	erase(unsigned int id)
+	{
+		const unsigned int w = id / 64;
+		const uint64_t     b = (uint64_t)1 << (id % 64);
+		if (w >= bits_.size() || !(bits_[w] & b))
+			return false;
+		bits_[w] &= ~b;
+		--size_;
+		return true;
+	}
+
+	/** Check if component is contained.
+   * @param id component ID
+   * @return true if the component is contained
+   */
+	bool
+	contains(unsigned int id) const
+	{
+		const unsigned int w = id / 64;
+		return (w < bits_.size()) && (bits_[w] & ((uint64_t)1 << (id % 64)));
+	}
+
+	/** Remove all components. */
+	void
+	clear()
+	{
+		if (size_ == 0)
+			return;
+		for (uint64_t &w : bits_)
+			w = 0;
+		size_ = 0;
+	}
+
+	/** Check if set is empty.
+   * @return true if the set is empty
+   */
+	bool
+	empty() const
+	{
+		return size_ == 0;
+	}
+
+	/** Get number of components.
+   * @return number of components in the set
+   */
+	unsigned int
+	size() const
+	{
+		return size_;
+	}
+
+	/** Get IDs of all components.
+   * @return IDs of all contained components in ascending order
+   */
+	std::vector<unsigned int>
+	ids() const
+	{
+		std::vector<unsigned int> rv;
+		for (unsigned int w = 0; w < bits_.size(); ++w) {
+			for (unsigned int b = 0; b < 64; ++b) {
+				if (bits_[w] & ((uint64_t)1 << b))
+					rv.push_back(w * 64 + b);
+			}
+		}
+		return rv;
+	}
+
+private:
+	std::vector<uint64_t> bits_;
+	unsigned int          size_;
+};
+
+/** @class SyncPointComponentMultiSet <syncpoint/component_set.h>
+ * Multiset of SyncPoint components stored as counters indexed by component ID.
+ * A component may be contained multiple times, e.g., if it emits multiple
+ * successors of a SyncPoint. Like SyncPointComponentSet, operations on
+ * known components never allocate. Assigning a multiset of equal or
+ * smaller capacity does not allocate either.
+ * @author agent
+ */
+class SyncPointComponentMultiSet
+{
+public:
+	/** Constructor. */
+	SyncPointComponentMultiSet() : size_(0)
+	{
+	}
+
+	/** Insert component once.
+   * @param id component ID
+   */
+	void
+	insert(unsigned int id)
+	{
+		if (id >= counts_.size())
+			counts_.resize(id + 1, 0);
+		++counts_[id];
+		++size_;
+	}
+
+	/** Erase one instance of a component.
+   * @param id component ID
+   * @return true if an instance was erased, false if the component was not contained
+   */
+	bool
+	erase_one(unsigned int id)
+	{
+		if (id >= counts_.size() || counts_[id] == 0)
+			return false;
+		--counts_[id];
+		--size_;
+		return true;
+	}
+
+	/** Count instances of component.
+   * @param id component ID
+   * @return number of times the component is contained
+   */
+	unsigned int
+	count(unsigned int id) const
+	{
+		return (id < counts_.size()) ? counts_[id] : 0;
+	}
+
+	/** Check if multiset is empty.
+   * @return true if the multiset is empty
+   */
+	bool
+	empty() const
+	{
+		return size_ == 0;
+	}
+
+	/** Get number of instances.
+   * @return number of instances of all components
+   */
+	unsigned int
+	size() const
+	{
+		return size_;
+	}
+
+	/** Get IDs of all components.
+   * @return IDs of all contained components in ascending order, each
+   * repeated as often as it is contained
+   */
+	std::vector<unsigned int>
+	ids() const
+	{
+		std::vector<unsigned int> rv;
+		for (unsigned int id = 0; id < counts_.size(); ++id) {
+			rv.insert(rv.end(), counts_[id], id);
+		}
+		return rv;
+	}
+
+private:
+	std::vector<unsigned int> counts_;
+	unsigned int              size_;
+};
+
+} // end namespace fawkes
+
+#endif
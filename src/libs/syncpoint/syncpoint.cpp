@@ -23,11 +23,14 @@
 #include <syncpoint/exceptions.h>
 #include <syncpoint/syncpoint.h>
 #include <utils/time/time.h>
+#include <utils/time/trace_recorder.h>
 
 #include <algorithm>
+#include <deque>
 #include <pthread.h>
 #include <sstream>
 #include <string.h>
+#include <unordered_map>
 
 using namespace std;
 
@@ -73,10 +76,12 @@ SyncPoint::SyncPoint(string       identifier,
   mutex_wait_for_all_(new Mutex()),
   cond_wait_for_all_(new WaitCondition(mutex_wait_for_all_)),
   wait_for_all_timer_running_(false),
+  wait_for_all_timer_owner_(NO_COMPONENT),
   max_waittime_sec_(max_waittime_sec),
   max_waittime_nsec_(max_waittime_nsec),
   logger_(logger),
-  last_emitter_reset_(Time(0l))
+  emit_locker_(NO_COMPONENT),
+  last_emitter_reset_(0)
 {
 	if (identifier.empty()) {
 		cleanup();
@@ -93,6 +98,11 @@ SyncPoint::SyncPoint(string       identifier,
 		cleanup();
 		throw SyncPointInvalidIdentifierException(identifier.c_str());
 	}
+	// waiters are typically released within microseconds by the last emitter
+	cond_wait_for_one_->set_spinning(true);
+	cond_wait_for_all_->set_spinning(true);
+	trace_wait_event_ = TraceRecorder::event("syncpoint", ("wait " + identifier).c_str());
+	trace_emit_event_ = TraceRecorder::event("syncpoint", ("emit " + identifier).c_str());
 }
 
 SyncPoint::~SyncPoint()
@@ -100,6 +110,62 @@ SyncPoint::~SyncPoint()
 	cleanup();
 }
 
+/// @cond INTERNALS
+namespace {
+class ComponentRegistry
+{
+public:
+	Mutex                                         mutex;
+	std::unordered_map<std::string, unsigned int> ids;
+	std::deque<std::string>                       names;
+};
+
+ComponentRegistry &
+component_registry()
+{
+	static ComponentRegistry registry;
+	return registry;
+}
+} // namespace
+/// @endcond
+
+/** Get ID of a component.
+ * Component names are interned process-wide, i.e., the first call for a
+ * name assigns a new ID which is returned for this name ever after. SyncPoints
+ * keep their state per component ID, hence components which call emit() or
+ * wait() frequently should get their ID once and use the ID overloads to
+ * avoid the name lookup.
+ * @param component name of the component
+ * @return ID of the component
+ */
+unsigned int
+SyncPoint::component_id(const std::string &component)
+{
+	ComponentRegistry &r = component_registry();
+	MutexLocker        ml(&r.mutex);
+	auto               it = r.ids.find(component);
+	if (it != r.ids.end()) {
+		return it->second;
+	}
+	unsigned int id = r.names.size();
+	r.names.push_back(component);
+	r.ids[component] = id;
+	return id;
+}
+
+/** Get name of a component.
+ * @param id ID of the component as returned by component_id()
+ * @return name of the component, empty string for unknown IDs
+ */
+const std::string &
+SyncPoint::component_name(unsigned int id)
+{
+	static const std::string unknown;
+	ComponentRegistry &      r = component_registry();
+	MutexLocker              ml(&r.mutex);
+	return (id < r.names.size()) ? r.names[id] : unknown;
+}
+
 /**
  * @return the identifier of the SyncPoint
  */
@@ -148,6 +214,16 @@ SyncPoint::operator<(const SyncPoint &other) const
  */
 void
 SyncPoint::emit(const std::string &component)
+{
+	emit(component_id(component), true);
+}
+
+/** Wake up all components which are waiting for this SyncPoint
+ * @param component The ID of the component emitting the SyncPoint
+ * @see component_id()
+ */
+void
+SyncPoint::emit(unsigned int component)
 {
 	emit(component, true);
 }
@@ -158,16 +234,17 @@ SyncPoint::emit(const std::string &component)
  *        from the pending emitters for this syncpoint
  */
 void
-SyncPoint::emit(const std::string &component, bool remove_from_pending)
+SyncPoint::emit(unsigned int component, bool remove_from_pending)
 {
 	mutex_next_wait_->lock();
-	if (!emit_locker_.empty()) {
+	if (emit_locker_ != NO_COMPONENT) {
 		cond_next_wait_->wait();
 	}
 	mutex_next_wait_->unlock();
 	MutexLocker ml(mutex_);
-	if (!watchers_.count(component)) {
-		throw SyncPointNonWatcherCalledEmitException(component.c_str(), get_identifier().c_str());
+	if (!watchers_.contains(component)) {
+		throw SyncPointNonWatcherCalledEmitException(component_name(component).c_str(),
+		                                             get_identifier().c_str());
 	}
 
 	// unlock all wait_for_one waiters
@@ -177,7 +254,8 @@ SyncPoint::emit(const std::string &component, bool remove_from_pending)
 	mutex_wait_for_one_->unlock();
 
 	if (!emitters_.count(component)) {
-		throw SyncPointNonEmitterCalledEmitException(component.c_str(), get_identifier().c_str());
+		throw SyncPointNonEmitterCalledEmitException(component_name(component).c_str(),
+		                                             get_identifier().c_str());
 	}
 
 	/* 1. remember whether the component was pending; if so, it may be removed
@@ -187,11 +265,10 @@ SyncPoint::emit(const std::string &component, bool remove_from_pending)
    */
 	bool pred_remove_from_pending = false;
 	if (remove_from_pending) {
-		multiset<string>::iterator it_pending = pending_emitters_.find(component);
-		if (it_pending != pending_emitters_.end()) {
-			pending_emitters_.erase(it_pending);
+		if (pending_emitters_.erase_one(component)) {
 			if (predecessor_) {
-				if (last_emitter_reset_ <= predecessor_->last_emitter_reset_) {
+				if (last_emitter_reset_.load(std::memory_order_relaxed)
+				    <= predecessor_->last_emitter_reset_.load(std::memory_order_relaxed)) {
 					pred_remove_from_pending = true;
 				}
 			}
@@ -208,7 +285,12 @@ SyncPoint::emit(const std::string &component, bool remove_from_pending)
 	}
 
 	emit_calls_.push_back(SyncPointCall(component));
+	TraceRecorder::instant(trace_emit_event_);
 
+	// the predecessor is fixed once the SyncPoint has been handed out,
+	// propagate without holding the lock to not serialize emitters of
+	// different successors on each other
+	ml.unlock();
 	if (predecessor_) {
 		predecessor_->emit(component, pred_remove_from_pending);
 	}
@@ -243,14 +325,32 @@ SyncPoint::wait(const std::string &component,
                 uint               wait_sec /* = 0 */,
                 uint               wait_nsec /* = 0 */)
 {
-	MutexLocker ml(mutex_);
+	wait(component_id(component), type, wait_sec, wait_nsec);
+}
 
-	std::set<std::string> *        watchers;
+/** Wait until SyncPoint is emitted.
+ * @param component The ID of the component waiting for the SyncPoint
+ * @param type the wakeup type
+ * @param wait_sec number of seconds to wait for the SyncPoint
+ * @param wait_nsec number of nanoseconds to wait for the SyncPoint
+ * @see wait(const std::string &, WakeupType, uint, uint)
+ * @see component_id()
+ */
+void
+SyncPoint::wait(unsigned int component,
+                WakeupType   type /* = WAIT_FOR_ONE */,
+                uint         wait_sec /* = 0 */,
+                uint         wait_nsec /* = 0 */)
+{
+	TraceRecorder::Scope trace(trace_wait_event_);
+	MutexLocker          ml(mutex_);
+
+	SyncPointComponentSet *        watchers;
 	WaitCondition *                cond;
 	CircularBuffer<SyncPointCall> *calls;
 	Mutex *                        mutex_cond;
 	bool *                         timer_running;
-	string *                       timer_owner;
+	unsigned int *                 timer_owner;
 	// set watchers, cond and calls depending of the Wakeup type
 	if (type == WAIT_FOR_ONE) {
 		watchers      = &watchers_wait_for_one_;
@@ -273,14 +373,16 @@ SyncPoint::wait(const std::string &component,
 	mutex_cond->lock();
 
 	// check if calling component is registered for this SyncPoint
-	if (!watchers_.count(component)) {
+	if (!watchers_.contains(component)) {
 		mutex_cond->unlock();
-		throw SyncPointNonWatcherCalledWaitException(component.c_str(), get_identifier().c_str());
+		throw SyncPointNonWatcherCalledWaitException(component_name(component).c_str(),
+		                                             get_identifier().c_str());
 	}
 	// check if calling component is not already waiting
-	if (watchers->count(component)) {
+	if (watchers->contains(component)) {
 		mutex_cond->unlock();
-		throw SyncPointMultipleWaitCallsException(component.c_str(), get_identifier().c_str());
+		throw SyncPointMultipleWaitCallsException(component_name(component).c_str(),
+		                                          get_identifier().c_str());
 	}
 
 	/* if type == WAIT_FOR_ALL but no emitter has registered, we can
@@ -294,7 +396,7 @@ SyncPoint::wait(const std::string &component,
 
 	mutex_next_wait_->lock();
 	if (emit_locker_ == component) {
-		emit_locker_ = "";
+		emit_locker_ = NO_COMPONENT;
 		cond_next_wait_->wake_all();
 	}
 	mutex_next_wait_->unlock();
@@ -397,10 +499,11 @@ SyncPoint::reltime_wait_for_all(const string &component, uint wait_sec, uint wai
 void
 SyncPoint::unwait(const string &component)
 {
-	MutexLocker ml(mutex_);
-	watchers_wait_for_one_.erase(component);
-	watchers_wait_for_all_.erase(component);
-	if (wait_for_all_timer_owner_ == component) {
+	MutexLocker  ml(mutex_);
+	unsigned int id = component_id(component);
+	watchers_wait_for_one_.erase(id);
+	watchers_wait_for_all_.erase(id);
+	if (wait_for_all_timer_owner_ == id) {
 		// TODO: this lets the other waiting components wait indefinitely, even on
 		// a timed wait.
 		wait_for_all_timer_running_ = false;
@@ -416,17 +519,28 @@ SyncPoint::unwait(const string &component)
  */
 void
 SyncPoint::lock_until_next_wait(const string &component)
+{
+	lock_until_next_wait(component_id(component));
+}
+
+/** Lock the SyncPoint for emitters until the specified component does the next
+ *  wait() call.
+ *  @param component the ID of the component locking the SyncPoint
+ *  @see lock_until_next_wait(const std::string &)
+ */
+void
+SyncPoint::lock_until_next_wait(unsigned int component)
 {
 	MutexLocker ml(mutex_);
 	mutex_next_wait_->lock();
-	if (emit_locker_.empty()) {
+	if (emit_locker_ == NO_COMPONENT) {
 		emit_locker_ = component;
 	} else {
 		logger_->log_warn("SyncPoints",
 		                  "%s tried to call lock_until_next_wait, "
 		                  "but %s already did the same. Ignoring.",
-		                  component.c_str(),
-		                  emit_locker_.c_str());
+		                  component_name(component).c_str(),
+		                  component_name(emit_locker_).c_str());
 	}
 	mutex_next_wait_->unlock();
 }
@@ -438,9 +552,11 @@ SyncPoint::lock_until_next_wait(const string &component)
 void
 SyncPoint::register_emitter(const string &component)
 {
-	MutexLocker ml(mutex_);
-	emitters_.insert(component);
-	pending_emitters_.insert(component);
+	unsigned int id = component_id(component);
+	MutexLocker  ml(mutex_);
+	emitters_.insert(id);
+	pending_emitters_.insert(id);
+	ml.unlock();
 	if (predecessor_) {
 		predecessor_->register_emitter(component);
 	}
@@ -456,20 +572,21 @@ void
 SyncPoint::unregister_emitter(const string &component, bool emit_if_pending)
 {
 	// TODO should this throw if the calling component is not registered?
-	multiset<string>::iterator it_emitter = emitters_.find(component);
-	if (it_emitter == emitters_.end()) {
+	unsigned int id = component_id(component);
+	MutexLocker  ml(mutex_);
+	if (!emitters_.count(id)) {
 		// component is not an emitter
 		return;
 	}
-	MutexLocker ml(mutex_);
-	if (emit_if_pending && is_pending(component)) {
+	if (emit_if_pending && is_pending(id)) {
 		ml.unlock();
-		emit(component);
+		emit(id);
 		ml.relock();
 	}
 
 	// erase a single element from the set of emitters
-	emitters_.erase(it_emitter);
+	emitters_.erase_one(id);
+	ml.unlock();
 	if (predecessor_) {
 		// never emit the predecessor if it's pending; it is already emitted above
 		predecessor_->unregister_emitter(component, false);
@@ -483,8 +600,9 @@ SyncPoint::unregister_emitter(const string &component, bool emit_if_pending)
 bool
 SyncPoint::is_emitter(const string &component) const
 {
-	MutexLocker ml(mutex_);
-	return emitters_.count(component) > 0;
+	unsigned int id = component_id(component);
+	MutexLocker  ml(mutex_);
+	return emitters_.count(id) > 0;
 }
 
 /** Check if the given component is a watch.
@@ -494,21 +612,35 @@ SyncPoint::is_emitter(const string &component) const
 bool
 SyncPoint::is_watcher(const string &component) const
 {
-	MutexLocker ml(mutex_);
-	return watchers_.count(component) > 0;
+	unsigned int id = component_id(component);
+	MutexLocker  ml(mutex_);
+	return watchers_.contains(id);
 }
 
 /** Add a watcher to the watch list
  *  @param watcher the new watcher
- *  @return A pair, of which the first element is an iterator that points
- *           to the possibly inserted element, and the second is a bool
- *           that is true if the element was actually inserted.
+ *  @return true if the watcher was actually inserted, false if it was
+ *          already watching
  */
-pair<set<string>::iterator, bool>
-SyncPoint::add_watcher(string watcher)
+bool
+SyncPoint::add_watcher(const std::string &watcher)
 {
-	MutexLocker ml(mutex_);
-	return watchers_.insert(watcher);
+	unsigned int id = component_id(watcher);
+	MutexLocker  ml(mutex_);
+	return watchers_.insert(id);
+}
+
+/** Remove a watcher from the watch list
+ *  @param watcher the watcher to remove
+ *  @return true if the watcher was actually removed, false if it was
+ *          not watching
+ */
+bool
+SyncPoint::remove_watcher(const std::string &watcher)
+{
+	unsigned int id = component_id(watcher);
+	MutexLocker  ml(mutex_);
+	return watchers_.erase(id);
 }
 
 /**
@@ -517,8 +649,12 @@ SyncPoint::add_watcher(string watcher)
 std::set<std::string>
 SyncPoint::get_watchers() const
 {
-	MutexLocker ml(mutex_);
-	return watchers_;
+	MutexLocker           ml(mutex_);
+	std::set<std::string> watchers;
+	for (unsigned int id : watchers_.ids()) {
+		watchers.insert(component_name(id));
+	}
+	return watchers;
 }
 
 /**
@@ -544,7 +680,12 @@ SyncPoint::get_wait_calls(WakeupType type /* = WAIT_FOR_ONE */) const
 multiset<string>
 SyncPoint::get_emitters() const
 {
-	return emitters_;
+	MutexLocker      ml(mutex_);
+	multiset<string> emitters;
+	for (unsigned int id : emitters_.ids()) {
+		emitters.insert(component_name(id));
+	}
+	return emitters;
 }
 
 /**
@@ -569,11 +710,11 @@ SyncPoint::watcher_is_waiting(std::string watcher, WakeupType type) const
 	switch (type) {
 	case SyncPoint::WAIT_FOR_ONE: {
 		MutexLocker ml(*mutex_wait_for_one_);
-		return watchers_wait_for_one_.count(watcher);
+		return watchers_wait_for_one_.contains(component_id(watcher));
 	}
 	case SyncPoint::WAIT_FOR_ALL: {
 		MutexLocker ml(*mutex_wait_for_all_);
-		return watchers_wait_for_all_.count(watcher);
+		return watchers_wait_for_all_.contains(component_id(watcher));
 	}
 	default: throw Exception("Unknown watch type %u for syncpoint %s", type, identifier_.c_str());
 	}
@@ -582,25 +723,28 @@ SyncPoint::watcher_is_waiting(std::string watcher, WakeupType type) const
 void
 SyncPoint::reset_emitters()
 {
-	last_emitter_reset_ = Time();
-	pending_emitters_   = emitters_;
+	last_emitter_reset_.store(Time().in_usec(), std::memory_order_relaxed);
+	pending_emitters_ = emitters_;
 }
 
 bool
-SyncPoint::is_pending(string component)
+SyncPoint::is_pending(unsigned int component)
 {
 	return pending_emitters_.count(component) > 0;
 }
 
 void
-SyncPoint::handle_default(string component, WakeupType type)
+SyncPoint::handle_default(unsigned int component, WakeupType type)
 {
-	logger_->log_debug(component.c_str(),
+	const std::string &name = component_name(component);
+	logger_->log_debug(name.c_str(),
 	                   "Thread time limit exceeded while waiting for syncpoint '%s'. "
 	                   "Time limit: %f sec.",
 	                   get_identifier().c_str(),
 	                   max_waittime_sec_ + static_cast<float>(max_waittime_nsec_) / 1000000000.f);
-	bad_components_.insert(pending_emitters_.begin(), pending_emitters_.end());
+	for (unsigned int id : pending_emitters_.ids()) {
+		bad_components_.insert(component_name(id));
+	}
 	if (!bad_components_.empty()) {
 		stringstream message;
 		for (set<string>::const_iterator it = bad_components_.begin(); it != bad_components_.end();
@@ -614,11 +758,11 @@ SyncPoint::handle_default(string component, WakeupType type)
 				message << " (" << Time().in_sec() - last_call->get_call_time().in_sec() << "s)";
 			}
 		}
-		logger_->log_debug(component.c_str(), "bad components:%s", message.str().c_str());
+		logger_->log_debug(name.c_str(), "bad components:%s", message.str().c_str());
 	} else if (type == SyncPoint::WAIT_FOR_ALL) {
 		throw Exception("SyncPoints: component %s defaulted, "
 		                "but there is no pending emitter. This is probably a bug.",
-		                component.c_str());
+		                name.c_str());
 	}
 
 	watchers_wait_for_all_.erase(component);
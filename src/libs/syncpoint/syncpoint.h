@@ -28,9 +28,11 @@
 #include <core/utils/refptr.h>
 #include <interface/interface.h>
 #include <logging/multi.h>
+#include <syncpoint/component_set.h>
 #include <syncpoint/syncpoint_call.h>
 #include <utils/time/time.h>
 
+#include <atomic>
 #include <map>
 #include <set>
 #include <string>
@@ -61,14 +63,25 @@ public:
 	          uint         max_waittime_nsec = 0);
 	virtual ~SyncPoint();
 
+	/** Component ID which does not refer to any component. */
+	static const unsigned int NO_COMPONENT = 0xFFFFFFFF;
+
+	static unsigned int       component_id(const std::string &component);
+	static const std::string &component_name(unsigned int id);
+
 	/** send a signal to all waiting threads */
 	virtual void emit(const std::string &component);
+	void         emit(unsigned int component);
 
 	/** wait for the sync point to be emitted by any other component */
 	virtual void wait(const std::string &component,
 	                  WakeupType     = WAIT_FOR_ONE,
 	                  uint wait_sec  = 0,
 	                  uint wait_nsec = 0);
+	void wait(unsigned int component,
+	          WakeupType   type      = WAIT_FOR_ONE,
+	          uint         wait_sec  = 0,
+	          uint         wait_nsec = 0);
 	/** abort waiting */
 	virtual void unwait(const std::string &component);
 	virtual void wait_for_one(const std::string &component);
@@ -86,6 +99,7 @@ public:
 	bool         is_watcher(const std::string &component) const;
 
 	void lock_until_next_wait(const std::string &component);
+	void lock_until_next_wait(unsigned int component);
 
 	std::string get_identifier() const;
 	bool        operator==(const SyncPoint &other) const;
@@ -104,19 +118,20 @@ public:
 	friend class SyncPointManager;
 
 protected:
-	std::pair<std::set<std::string>::iterator, bool> add_watcher(std::string watcher);
+	bool add_watcher(const std::string &watcher);
+	bool remove_watcher(const std::string &watcher);
 	/** send a signal to all waiting threads */
-	virtual void emit(const std::string &component, bool remove_from_pending);
+	void emit(unsigned int component, bool remove_from_pending);
 
 protected:
 	/** The unique identifier of the SyncPoint */
 	const std::string identifier_;
 	/** Set of all components which use this SyncPoint */
-	std::set<std::string> watchers_;
+	SyncPointComponentSet watchers_;
 	/** Set of all components which are currently waiting for a single emitter */
-	std::set<std::string> watchers_wait_for_one_;
+	SyncPointComponentSet watchers_wait_for_one_;
 	/** Set of all components which are currently waiting on the barrier */
-	std::set<std::string> watchers_wait_for_all_;
+	SyncPointComponentSet watchers_wait_for_all_;
 
 	/** A buffer of the most recent emit calls. */
 	CircularBuffer<SyncPointCall> emit_calls_;
@@ -144,7 +159,7 @@ protected:
 	/** true if the wait for all timer is running */
 	bool wait_for_all_timer_running_;
 	/** the component that started the wait-for-all timer */
-	std::string wait_for_all_timer_owner_;
+	unsigned int wait_for_all_timer_owner_;
 	/** maximum waiting time in secs */
 	uint max_waittime_sec_;
 	/** maximum waiting time in nsecs */
@@ -155,8 +170,8 @@ protected:
 
 private:
 	void reset_emitters();
-	bool is_pending(std::string component);
-	void handle_default(std::string component, WakeupType type);
+	bool is_pending(unsigned int component);
+	void handle_default(unsigned int component, WakeupType type);
 	void cleanup();
 
 private:
@@ -168,14 +183,18 @@ private:
 	/** all successors */
 	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> successors_;
 
-	std::multiset<std::string> emitters_;
-	std::multiset<std::string> pending_emitters_;
+	SyncPointComponentMultiSet emitters_;
+	SyncPointComponentMultiSet pending_emitters_;
 
 	std::set<std::string> bad_components_;
 
-	std::string emit_locker_;
+	unsigned int emit_locker_;
+
+	/** Time of the last emitter reset in microseconds, read by successors without locking */
+	std::atomic<long> last_emitter_reset_;
 
-	Time last_emitter_reset_;
+	unsigned int trace_wait_event_;
+	unsigned int trace_emit_event_;
 };
 
 } // end namespace fawkes
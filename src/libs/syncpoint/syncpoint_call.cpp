@@ -19,6 +19,7 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
+#include <syncpoint/syncpoint.h>
 #include <syncpoint/syncpoint_call.h>
 
 namespace fawkes {
@@ -35,6 +36,17 @@ namespace fawkes {
  * @param wait_time The time the caller had to wait for the SyncPoint (wait calls)
  */
 SyncPointCall::SyncPointCall(const std::string &caller, Time call_time, Time wait_time)
+: caller_(SyncPoint::component_id(caller)), call_time_(call_time), wait_time_(wait_time)
+{
+}
+
+/** Constructor.
+ * @param call_time Time at which the SyncPoint was called
+ * @param caller ID of the calling component
+ * @param wait_time The time the caller had to wait for the SyncPoint (wait calls)
+ * @see SyncPoint::component_id()
+ */
+SyncPointCall::SyncPointCall(unsigned int caller, Time call_time, Time wait_time)
 : caller_(caller), call_time_(call_time), wait_time_(wait_time)
 {
 }
@@ -60,8 +72,17 @@ SyncPointCall::get_wait_time() const
 /** Get the name of the component which made the call
  * @return the component name
  */
-std::string
+const std::string &
 SyncPointCall::get_caller() const
+{
+	return SyncPoint::component_name(caller_);
+}
+
+/** Get the ID of the component which made the call
+ * @return the component ID
+ */
+unsigned int
+SyncPointCall::get_caller_id() const
 {
 	return caller_;
 }
@@ -32,16 +32,18 @@ class SyncPointCall
 {
 public:
 	SyncPointCall(const std::string &caller, Time call_time = Time(), Time wait_time = Time(0.f));
+	SyncPointCall(unsigned int caller, Time call_time = Time(), Time wait_time = Time(0.f));
 
 public:
-	Time        get_call_time() const;
-	Time        get_wait_time() const;
-	std::string get_caller() const;
+	Time               get_call_time() const;
+	Time               get_wait_time() const;
+	const std::string &get_caller() const;
+	unsigned int       get_caller_id() const;
 
 private:
-	const std::string caller_;
-	const Time        call_time_;
-	const Time        wait_time_;
+	const unsigned int caller_;
+	const Time         call_time_;
+	const Time         wait_time_;
 };
 
 } // namespace fawkes
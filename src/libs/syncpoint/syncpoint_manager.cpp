@@ -25,6 +25,8 @@
 #include <syncpoint/exceptions.h>
 #include <syncpoint/syncpoint_manager.h>
 
+#include <algorithm>
+#include <map>
 #include <string>
 
 namespace fawkes {
@@ -36,6 +38,13 @@ namespace fawkes {
  * All threads with the SyncPointManager Aspect share the same SyncPointManager.
  * SyncPointManager provides basic methods to get and release shared SyncPoints
  *
+ * SyncPoints are never removed once created. Besides the set of SyncPoints,
+ * which is modified under a mutex, the manager keeps an immutable index of
+ * them by identifier. The index is replaced by a new copy whenever
+ * SyncPoints are created, and read without locking. Getting an existing
+ * SyncPoint and inspecting the SyncPoints hence does not contend with other
+ * threads doing the same.
+ *
  * @author Till Hofmann
  * @see SyncPoint
  */
@@ -43,7 +52,8 @@ namespace fawkes {
 /** Constructor.
  *  @param logger the logger to use for logging messages
  */
-SyncPointManager::SyncPointManager(MultiLogger *logger) : mutex_(new Mutex()), logger_(logger)
+SyncPointManager::SyncPointManager(MultiLogger *logger)
+: mutex_(new Mutex()), logger_(logger), index_(std::make_shared<const SyncPointIndex>())
 {
 }
 
@@ -67,8 +77,28 @@ SyncPointManager::~SyncPointManager()
 RefPtr<SyncPoint>
 SyncPointManager::get_syncpoint(const std::string &component, const std::string &identifier)
 {
-	MutexLocker ml(mutex_);
-	return get_syncpoint_no_lock(component, identifier);
+	if (component == "") {
+		throw SyncPointInvalidComponentException(component.c_str(), identifier.c_str());
+	}
+
+	// an existing SyncPoint is linked to all its predecessors already, only
+	// the component needs to be added to their watchers
+	std::shared_ptr<const SyncPointIndex> idx = index();
+	SyncPointIndex::const_iterator        i   = idx->find(identifier);
+	if (i != idx->end()) {
+		for (SyncPoint *sp = *i->second; sp != NULL; sp = *sp->predecessor_) {
+			sp->add_watcher(component);
+		}
+		return i->second;
+	}
+
+	MutexLocker       ml(mutex_);
+	size_t            num_syncpoints = syncpoints_.size();
+	RefPtr<SyncPoint> syncpoint      = get_syncpoint_no_lock(component, identifier);
+	if (syncpoints_.size() != num_syncpoints) {
+		publish_index();
+	}
+	return syncpoint;
 }
 
 /**
@@ -114,8 +144,172 @@ SyncPointSetLessThan::operator()(const RefPtr<SyncPoint> sp1, const RefPtr<SyncP
 std::set<RefPtr<SyncPoint>, SyncPointSetLessThan>
 SyncPointManager::get_syncpoints()
 {
-	MutexLocker ml(mutex_);
-	return syncpoints_;
+	std::shared_ptr<const SyncPointIndex>             idx = index();
+	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> syncpoints;
+	for (SyncPointIndex::const_iterator i = idx->begin(); i != idx->end(); ++i) {
+		syncpoints.insert(syncpoints.end(), i->second);
+	}
+	return syncpoints;
+}
+
+/** Get the current index of SyncPoints.
+ * @return index of all SyncPoints, which remains valid and unchanged while
+ * it is referenced
+ */
+std::shared_ptr<const SyncPointManager::SyncPointIndex>
+SyncPointManager::index() const
+{
+	return std::atomic_load(&index_);
+}
+
+/** Replace the index by one containing all current SyncPoints.
+ * Must be called with the mutex locked after SyncPoints have been created
+ * and linked to their predecessors.
+ */
+void
+SyncPointManager::publish_index()
+{
+	std::shared_ptr<SyncPointIndex> idx = std::make_shared<SyncPointIndex>();
+	for (std::set<RefPtr<SyncPoint>>::const_iterator sp = syncpoints_.begin();
+	     sp != syncpoints_.end();
+	     ++sp) {
+		idx->insert(idx->end(), std::make_pair((*sp)->get_identifier(), *sp));
+	}
+	std::atomic_store(&index_, std::shared_ptr<const SyncPointIndex>(idx));
+}
+
+/** Determine the critical path leading to a SyncPoint emission.
+ * Starting at the last emission of the given SyncPoint before @p until,
+ * this walks backwards through the recorded emit and wait calls. For the
+ * component which emitted, it finds the SyncPoint whose wait returned last
+ * before the emission, i.e. the input which released the component, and
+ * the component which emitted that input last, and so on. Components which
+ * watch a SyncPoint without waiting for it, e.g. threads executed on a
+ * thread pool, are considered released by the last emission of that
+ * SyncPoint. The walk stops once a release happened before @p since.
+ *
+ * The result is based on the call history kept by the SyncPoints. It
+ * requires the relevant calls to still be in these buffers and is meant
+ * for occasional reporting, not to be called at high frequency.
+ * @param identifier identifier of the SyncPoint at the end of the path
+ * @param until only consider emissions up to this time
+ * @param since only consider segments which started after this time
+ * @return path segments, ordered from the earliest to the latest
+ */
+std::vector<SyncPointPathSegment>
+SyncPointManager::critical_path(const std::string &identifier,
+                                const Time &       until,
+                                const Time &       since)
+{
+	typedef struct
+	{
+		std::set<std::string>         watchers;
+		std::multiset<std::string>    emitters;
+		CircularBuffer<SyncPointCall> emit_calls;
+		CircularBuffer<SyncPointCall> wait_calls_one;
+		CircularBuffer<SyncPointCall> wait_calls_all;
+	} Snapshot;
+
+	std::map<std::string, Snapshot>       snapshots;
+	std::shared_ptr<const SyncPointIndex> idx = index();
+	for (SyncPointIndex::const_iterator i = idx->begin(); i != idx->end(); ++i) {
+		Snapshot snap = {i->second->get_watchers(),
+		                 i->second->get_emitters(),
+		                 i->second->get_emit_calls(),
+		                 i->second->get_wait_calls(SyncPoint::WAIT_FOR_ONE),
+		                 i->second->get_wait_calls(SyncPoint::WAIT_FOR_ALL)};
+		snapshots.insert(std::make_pair(i->first, snap));
+	}
+
+	std::vector<SyncPointPathSegment> path;
+	std::string                       output   = identifier;
+	Time                              released = until;
+
+	// the path cannot be longer than the number of SyncPoints unless there
+	// is a cycle, bound it to be safe
+	for (unsigned int depth = 0; depth <= snapshots.size(); ++depth) {
+		std::map<std::string, Snapshot>::const_iterator out = snapshots.find(output);
+		if (out == snapshots.end())
+			break;
+
+		// last emission of the output before it released the previous segment
+		const SyncPointCall *emit = NULL;
+		for (CircularBuffer<SyncPointCall>::const_reverse_iterator c = out->second.emit_calls.rbegin();
+		     c != out->second.emit_calls.rend();
+		     ++c) {
+			if (c->get_call_time() <= released) {
+				emit = &*c;
+				break;
+			}
+		}
+		if (!emit || emit->get_call_time() < since)
+			break;
+
+		SyncPointPathSegment segment;
+		segment.component = emit->get_caller();
+		segment.output    = output;
+		segment.end       = emit->get_call_time();
+		segment.start     = since;
+
+		// input which released the component last before it emitted
+		bool found = false;
+		for (std::map<std::string, Snapshot>::const_iterator in = snapshots.begin();
+		     in != snapshots.end();
+		     ++in) {
+			if (!in->second.watchers.count(segment.component)
+			    || in->second.emitters.count(segment.component)) {
+				continue;
+			}
+			bool waited = false;
+			Time release;
+			for (const CircularBuffer<SyncPointCall> *calls :
+			     {&in->second.wait_calls_one, &in->second.wait_calls_all}) {
+				for (CircularBuffer<SyncPointCall>::const_reverse_iterator c = calls->rbegin();
+				     c != calls->rend();
+				     ++c) {
+					if (c->get_caller() != segment.component)
+						continue;
+					Time r = c->get_call_time() + c->get_wait_time();
+					if (r <= segment.end) {
+						if (!waited || release < r)
+							release = r;
+						waited = true;
+						break;
+					}
+				}
+			}
+			if (!waited) {
+				for (CircularBuffer<SyncPointCall>::const_reverse_iterator c =
+				       in->second.emit_calls.rbegin();
+				     c != in->second.emit_calls.rend();
+				     ++c) {
+					if (c->get_call_time() <= segment.end) {
+						release = c->get_call_time();
+						waited  = true;
+						break;
+					}
+				}
+			}
+			if (waited && (!found || segment.start < release)) {
+				segment.start = release;
+				segment.input = in->first;
+				found         = true;
+			}
+		}
+
+		if (!found || segment.start < since) {
+			segment.start = since;
+			segment.input = "";
+			path.push_back(segment);
+			break;
+		}
+		path.push_back(segment);
+		output   = segment.input;
+		released = segment.start;
+	}
+
+	std::reverse(path.begin(), path.end());
+	return path;
 }
 
 /** Find the prefix of the SyncPoint's identifier which is the identifier of
@@ -143,9 +337,15 @@ SyncPointManager::get_syncpoint_no_lock(const std::string &component, const std:
 	}
 	// insert a new SyncPoint if no SyncPoint with the same identifier exists,
 	// otherwise, use that SyncPoint
-	std::pair<std::set<RefPtr<SyncPoint>>::iterator, bool> insert_ret;
-	insert_ret = syncpoints_.insert(RefPtr<SyncPoint>(new SyncPoint(identifier, logger_)));
-	std::set<RefPtr<SyncPoint>>::iterator sp_it = insert_ret.first;
+	// the index is up to date while holding the mutex
+	std::set<RefPtr<SyncPoint>>::iterator sp_it;
+	std::shared_ptr<const SyncPointIndex> idx = index();
+	SyncPointIndex::const_iterator        i   = idx->find(identifier);
+	if (i != idx->end()) {
+		sp_it = syncpoints_.find(i->second);
+	} else {
+		sp_it = syncpoints_.insert(RefPtr<SyncPoint>(new SyncPoint(identifier, logger_))).first;
+	}
 
 	// add component to the set of watchers
 	(*sp_it)->add_watcher(component);
@@ -176,7 +376,7 @@ SyncPointManager::release_syncpoint_no_lock(const std::string &component,
 		return;
 	}
 	(*sp_it)->unwait(component);
-	if (!(*sp_it)->watchers_.erase(component)) {
+	if (!(*sp_it)->remove_watcher(component)) {
 		throw SyncPointReleasedByNonWatcherException(component.c_str(),
 		                                             sync_point->get_identifier().c_str());
 	}
@@ -27,13 +27,26 @@
 #include <logging/multi.h>
 #include <syncpoint/syncpoint.h>
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace fawkes {
 
 class SyncPoint;
 
+/** Segment of a critical path through the SyncPoint graph. */
+typedef struct
+{
+	std::string component; /**< component which was running */
+	std::string input;     /**< SyncPoint which released the component, empty if unknown */
+	std::string output;    /**< SyncPoint emitted by the component */
+	Time        start;     /**< time the component was released */
+	Time        end;       /**< time the component emitted the output */
+} SyncPointPathSegment;
+
 class SyncPointManager
 {
 public:
@@ -45,13 +58,23 @@ public:
 
 	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> get_syncpoints();
 
+	std::vector<SyncPointPathSegment> critical_path(const std::string &identifier,
+	                                                const Time &       until,
+	                                                const Time &       since);
+
 protected:
 	/** Set of all existing SyncPoints */
 	std::set<RefPtr<SyncPoint>, SyncPointSetLessThan> syncpoints_;
-	/** Mutex used for all SyncPointManager calls */
+	/** Mutex used for all SyncPointManager calls which modify the SyncPoints */
 	Mutex *mutex_;
 
 private:
+	/** Immutable index of all SyncPoints by identifier. */
+	typedef std::map<std::string, RefPtr<SyncPoint>> SyncPointIndex;
+
+	std::shared_ptr<const SyncPointIndex> index() const;
+	void                                  publish_index();
+
 	std::string       find_prefix(const std::string &identifier) const;
 	RefPtr<SyncPoint> get_syncpoint_no_lock(const std::string &component,
 	                                        const std::string &identifier);
@@ -59,6 +82,8 @@ private:
 	bool         component_watches_any_successor(const RefPtr<SyncPoint> sp,
 	                                             const std::string       component) const;
 	MultiLogger *logger_;
+
+	std::shared_ptr<const SyncPointIndex> index_;
 };
 
 } // end namespace fawkes
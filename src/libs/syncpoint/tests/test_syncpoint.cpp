@@ -619,6 +619,28 @@ TEST_F(SyncBarrierTest, MultipleRegisterCalls)
 	EXPECT_NO_THROW(barrier->register_emitter(component));
 }
 
+/** Component IDs and names can be used interchangeably */
+TEST_F(SyncBarrierTest, ComponentIds)
+{
+	string       component = "emitter";
+	unsigned int id        = SyncPoint::component_id(component);
+	EXPECT_EQ(id, SyncPoint::component_id(component));
+	EXPECT_NE(id, SyncPoint::component_id("other emitter"));
+	EXPECT_EQ(component, SyncPoint::component_name(id));
+
+	RefPtr<SyncPoint> barrier = manager->get_syncpoint(component, "/test/barrier");
+	barrier->register_emitter(component);
+	barrier->register_emitter(component);
+	EXPECT_EQ(2, barrier->get_emitters().count(component));
+	EXPECT_NO_THROW(barrier->emit(id));
+	EXPECT_NO_THROW(barrier->emit(component));
+	ASSERT_EQ(2, barrier->get_emit_calls().size());
+	EXPECT_EQ(component, barrier->get_emit_calls().back().get_caller());
+	EXPECT_EQ(id, barrier->get_emit_calls().back().get_caller_id());
+	barrier->unregister_emitter(component);
+	EXPECT_EQ(1, barrier->get_emitters().count(component));
+}
+
 /** get a SyncBarrier, register as emitter and emit */
 void *
 start_barrier_emitter_thread(void *data)
@@ -1371,3 +1393,46 @@ TEST_F(SyncPointManagerTest, ReleaseBarrierWaiter)
 	sp = manager->get_syncpoint("component 1", "/test");
 	EXPECT_NO_THROW(sp->reltime_wait_for_all("component 1", 0, pow(10, 6)));
 }
+
+/** Test that the critical path follows the chain that released the last
+ *  emitter and ignores independent chains. */
+TEST_F(SyncPointManagerTest, CriticalPath)
+{
+	Time since;
+
+	RefPtr<SyncPoint> start = manager->get_syncpoint("main", "/start");
+	start->register_emitter("main");
+	RefPtr<SyncPoint> a_in  = manager->get_syncpoint("a", "/start");
+	RefPtr<SyncPoint> a_out = manager->get_syncpoint("a", "/a");
+	a_out->register_emitter("a");
+	RefPtr<SyncPoint> b_in  = manager->get_syncpoint("b", "/a");
+	RefPtr<SyncPoint> b_out = manager->get_syncpoint("b", "/b");
+	b_out->register_emitter("b");
+	RefPtr<SyncPoint> c_in  = manager->get_syncpoint("c", "/start");
+	RefPtr<SyncPoint> c_out = manager->get_syncpoint("c", "/c");
+	c_out->register_emitter("c");
+
+	start->emit("main");
+	usleep(5000);
+	c_out->emit("c");
+	usleep(5000);
+	a_out->emit("a");
+	usleep(20000);
+	b_out->emit("b");
+
+	std::vector<SyncPointPathSegment> path = manager->critical_path("/b", Time(), since);
+	ASSERT_EQ(3u, path.size());
+	EXPECT_EQ("main", path[0].component);
+	EXPECT_EQ("", path[0].input);
+	EXPECT_EQ("a", path[1].component);
+	EXPECT_EQ("/start", path[1].input);
+	EXPECT_EQ("/a", path[1].output);
+	EXPECT_EQ("b", path[2].component);
+	EXPECT_EQ("/a", path[2].input);
+	EXPECT_EQ("/b", path[2].output);
+	EXPECT_GE(path[2].end - &path[2].start, 0.015);
+	EXPECT_GE(path[1].end - &path[1].start, 0.008);
+
+	// nothing emitted in the given time frame
+	EXPECT_TRUE(manager->critical_path("/b", since, since - 1.0).empty());
+}
@@ -0,0 +1,106 @@
+
+/***************************************************************************
+ *  bench_tf.cpp - Transform lookup microbenchmarks
+ *
+ *  Created: Thu Oct 15 07:45:06 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <benchmark/benchmark.h>
+#include <tf/transformer.h>
+
+#include <string>
+
+using namespace fawkes;
+using namespace fawkes::tf;
+
+#define NUM_STAMPS 100
+
+// Build a chain /base -> /frame_1 -> ... -> /frame_<depth> with one second
+// of history at 100 Hz and look up the transform from the end of the chain
+// to its base.
+class TransformerBenchmark : public benchmark::Fixture
+{
+public:
+	void
+	SetUp(const benchmark::State &state)
+	{
+		transformer = new Transformer();
+		Transform t(Quaternion(0, 0, 0, 1), Vector3(1, 0, 0));
+
+		std::string parent = "/base";
+		for (int d = 1; d <= state.range(0); ++d) {
+			std::string child = "/frame_" + std::to_string(d);
+			for (unsigned int s = 0; s < NUM_STAMPS; ++s) {
+				StampedTransform st(t, Time(1000l + 10 * s), parent, child);
+				transformer->set_transform(st, "benchmark");
+			}
+			parent = child;
+		}
+		source = parent;
+	}
+
+	void
+	TearDown(const benchmark::State &state)
+	{
+		delete transformer;
+	}
+
+protected:
+	Transformer *transformer;
+	std::string  source;
+};
+
+BENCHMARK_DEFINE_F(TransformerBenchmark, LookupLatest)(benchmark::State &state)
+{
+	StampedTransform result;
+	Time             latest(0, 0);
+	for (auto _ : state) {
+		transformer->lookup_transform("/base", source, latest, result);
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(TransformerBenchmark, LookupLatest)
+  ->ArgName("depth")
+  ->Arg(1)
+  ->Arg(4)
+  ->Arg(16);
+
+// the time lies between two stamps, the transforms are interpolated
+BENCHMARK_DEFINE_F(TransformerBenchmark, LookupInterpolated)(benchmark::State &state)
+{
+	StampedTransform result;
+	Time             time(1000l + 10 * NUM_STAMPS / 2 + 5);
+	for (auto _ : state) {
+		transformer->lookup_transform("/base", source, time, result);
+		benchmark::DoNotOptimize(result);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(TransformerBenchmark, LookupInterpolated)
+  ->ArgName("depth")
+  ->Arg(1)
+  ->Arg(4)
+  ->Arg(16);
+
+BENCHMARK_MAIN();
+
+/// @endcond
@@ -124,11 +124,13 @@ BufferCore::validate_frame_id(const char *function_name_arg, const std::string &
 /** Constructor
  * @param cache_time How long to keep a history of transforms in nanoseconds
  */
-BufferCore::BufferCore(float cache_time) : cache_time_(cache_time)
+BufferCore::BufferCore(float cache_time) : cache_time_(cache_time), frame_table_(NULL)
 {
-	frameIDs_["NO_PARENT"] = 0;
-	frames_.push_back(TimeCacheInterfacePtr());
-	frameIDs_reverse.push_back("NO_PARENT");
+	FrameTable *table             = new FrameTable();
+	table->frame_ids["NO_PARENT"] = 0;
+	table->frames.push_back(TimeCacheInterfacePtr());
+	table->frame_ids_reverse.push_back("NO_PARENT");
+	publish_frame_table(table);
 }
 
 BufferCore::~BufferCore()
@@ -141,9 +143,10 @@ BufferCore::clear()
 {
 	//old_tf_.clear();
 	std::unique_lock<std::mutex> lock(frame_mutex_);
-	if (frames_.size() > 1) {
-		for (std::vector<TimeCacheInterfacePtr>::iterator cache_it = frames_.begin() + 1;
-		     cache_it != frames_.end();
+	const V_TimeCacheInterface & frames = frame_table().frames;
+	if (frames.size() > 1) {
+		for (V_TimeCacheInterface::const_iterator cache_it = frames.begin() + 1;
+		     cache_it != frames.end();
 		     ++cache_it) {
 			if (*cache_it)
 				(*cache_it)->clear_list();
@@ -215,14 +218,21 @@ BufferCore::set_transform(const StampedTransform &transform_in,
 
 	{
 		std::unique_lock<std::mutex> lock(frame_mutex_);
-		CompactFrameID        frame_number = lookup_or_insert_frame_number(stripped.child_frame_id);
-		TimeCacheInterfacePtr frame        = get_frame(frame_number);
-		if (!frame)
-			frame = allocate_frame(frame_number, is_static);
-
-		if (frame->insert_data(TransformStorage(stripped,
-		                                        lookup_or_insert_frame_number(stripped.frame_id),
-		                                        frame_number))) {
+		CompactFrameID        frame_number  = lookup_frame_number(stripped.child_frame_id);
+		CompactFrameID        parent_number = lookup_frame_number(stripped.frame_id);
+		TimeCacheInterfacePtr frame         = get_frame(frame_number);
+		if (!frame || parent_number == 0) {
+			// new frame or cache, publish modified copy of frame table
+			FrameTable *table = new FrameTable(frame_table());
+			frame_number      = lookup_or_insert_frame_number(*table, stripped.child_frame_id);
+			parent_number     = lookup_or_insert_frame_number(*table, stripped.frame_id);
+			frame             = table->frames[frame_number];
+			if (!frame)
+				frame = allocate_frame(*table, frame_number, is_static);
+			publish_frame_table(table);
+		}
+
+		if (frame->insert_data(TransformStorage(stripped, parent_number, frame_number))) {
 			frame_authority_[frame_number] = authority;
 		} else {
 			printf("TF_OLD_DATA ignoring data from the past for frame %s "
@@ -241,21 +251,37 @@ BufferCore::set_transform(const StampedTransform &transform_in,
 }
 
 /** Allocate a new frame cache.
+ * @param table unpublished frame table to add the cache to
  * @param cfid frame ID for which to create the frame cache
  * @param is_static true if the transforms for this frame are static, false otherwise
  * @return pointer to new cache
  */
 TimeCacheInterfacePtr
-BufferCore::allocate_frame(CompactFrameID cfid, bool is_static)
+BufferCore::allocate_frame(FrameTable &table, CompactFrameID cfid, bool is_static) const
 {
-	TimeCacheInterfacePtr frame_ptr = frames_[cfid];
 	if (is_static) {
-		frames_[cfid] = TimeCacheInterfacePtr(new StaticCache());
+		table.frames[cfid] = TimeCacheInterfacePtr(new StaticCache());
 	} else {
-		frames_[cfid] = TimeCacheInterfacePtr(new TimeCache(cache_time_));
+		table.frames[cfid] = TimeCacheInterfacePtr(new TimeCache(cache_time_));
 	}
 
-	return frames_[cfid];
+	return table.frames[cfid];
+}
+
+/** Publish frame table.
+ * Replaces the current snapshot of the frame table. Readers which still
+ * use the previous snapshot are not disturbed, old snapshots are kept
+ * until the BufferCore is destroyed. Frames are never removed and there
+ * are only a few replacements per frame, hence the memory overhead is
+ * small. Must be called with the frame mutex locked, except from the
+ * constructor.
+ * @param table new frame table, ownership is taken
+ */
+void
+BufferCore::publish_frame_table(FrameTable *table)
+{
+	frame_tables_.push_back(std::unique_ptr<const FrameTable>(table));
+	frame_table_.store(table, std::memory_order_release);
 }
 
 enum WalkEnding {
@@ -535,8 +561,94 @@ struct TransformAccum
 	Quaternion result_quat;
 	Vector3    result_vec;
 };
+
+struct TransformChainAccum : public TransformAccum
+{
+	enum Action { NONE, ACCUM_SOURCE, ACCUM_TARGET };
+
+	struct Step
+	{
+		TimeCacheInterfacePtr cache;
+		unsigned int          version;
+		CompactFrameID        parent;
+		Action                action;
+	};
+
+	CompactFrameID
+	gather(TimeCacheInterfacePtr cache, fawkes::Time time, std::string *error_string)
+	{
+		// read version before data, a concurrent modification thus
+		// always results in a different version later on
+		unsigned int   version = cache->get_version();
+		CompactFrameID parent  = TransformAccum::gather(cache, time, error_string);
+		Step           step    = {cache, version, parent, NONE};
+		steps.push_back(step);
+		return parent;
+	}
+
+	void
+	accum(bool source)
+	{
+		TransformAccum::accum(source);
+		steps.back().action = source ? ACCUM_SOURCE : ACCUM_TARGET;
+	}
+
+	void
+	finalize(WalkEnding end, fawkes::Time _time)
+	{
+		TransformAccum::finalize(end, _time);
+		ending = end;
+	}
+
+	/** Replay recorded walk for another point in time.
+	 * The same caches are queried in the same order, the walk is only
+	 * valid if each cache yields the same parent as before.
+	 * @param time time for which to get the transform
+	 * @param accum accumulator to replay the walk into
+	 * @return true if the walk could be replayed, false if the tree
+	 * differs at the given time or data is missing
+	 */
+	bool
+	replay(fawkes::Time time, TransformAccum &accum) const
+	{
+		for (const Step &step : steps) {
+			if (accum.gather(step.cache, time, NULL) != step.parent) {
+				return false;
+			}
+			if (step.action != NONE) {
+				accum.accum(step.action == ACCUM_SOURCE);
+			}
+		}
+		accum.finalize(ending, time);
+		return true;
+	}
+
+	std::vector<Step> steps;
+	WalkEnding        ending;
+};
 ///@endcond
 
+/** Throw exception for lookup error.
+ * @param error error value from ErrorValues
+ * @param error_string error message
+ * @exception ConnectivityException thrown for CONNECTIVITY_ERROR
+ * @exception ExtrapolationException thrown for EXTRAPOLATION_ERROR
+ * @exception LookupException thrown for LOOKUP_ERROR
+ * @exception TransformException thrown for any other error
+ */
+void
+BufferCore::throw_lookup_error(int error, const std::string &error_string)
+{
+	switch (error) {
+	case CONNECTIVITY_ERROR: throw ConnectivityException("%s", error_string.c_str());
+	case EXTRAPOLATION_ERROR: throw ExtrapolationException("%s", error_string.c_str());
+	case LOOKUP_ERROR: throw LookupException("%s", error_string.c_str());
+	default:
+		//logError("Unknown error code: %d", retval);
+		throw TransformException();
+	}
+}
+
 /** Lookup transform.
  * @param target_frame target frame ID
  * @param source_frame source frame ID
@@ -556,8 +668,6 @@ BufferCore::lookup_transform(const std::string & target_frame,
                              const fawkes::Time &time,
                              StampedTransform &  transform) const
 {
-	std::unique_lock<std::mutex> lock(frame_mutex_);
-
 	if (target_frame == source_frame) {
 		transform.setIdentity();
 		transform.frame_id       = target_frame;
@@ -585,14 +695,7 @@ BufferCore::lookup_transform(const std::string & target_frame,
 	TransformAccum accum;
 	int            retval = walk_to_top_parent(accum, time, target_id, source_id, &error_string);
 	if (retval != NO_ERROR) {
-		switch (retval) {
-		case CONNECTIVITY_ERROR: throw ConnectivityException("%s", error_string.c_str());
-		case EXTRAPOLATION_ERROR: throw ExtrapolationException("%s", error_string.c_str());
-		case LOOKUP_ERROR: throw LookupException("%s", error_string.c_str());
-		default:
-			//logError("Unknown error code: %d", retval);
-			throw TransformException();
-		}
+		throw_lookup_error(retval, error_string);
 	}
 
 	transform.setOrigin(accum.result_vec);
@@ -641,6 +744,113 @@ BufferCore::lookup_transform(const std::string & target_frame,
 	transform.child_frame_id = source_frame;
 }
 
+/** Lookup transforms for multiple points in time.
+ * This is equivalent to calling lookup_transform() for each time, but
+ * the tree is walked only once. For the remaining times the same chain
+ * of frames is re-evaluated, which avoids the frame lookups and parent
+ * traversal. This is useful for example to de-skew laser scans with a
+ * transform per beam. Should the tree differ for a particular time,
+ * the lookup falls back to a regular walk.
+ * @param target_frame target frame ID
+ * @param source_frame source frame ID
+ * @param times times for which to get the transforms, a time of (0,0)
+ * denotes the latest common time
+ * @param transforms upon return contains one transform per time
+ * @exception ConnectivityException thrown if no connection between
+ * the source and target frame could be found in the tree.
+ * @exception ExtrapolationException returning a value would have
+ * required extrapolation beyond current limits.
+ * @exception LookupException at least one of the two given frames is
+ * unknown
+ */
+void
+BufferCore::lookup_transforms(const std::string &              target_frame,
+                              const std::string &              source_frame,
+                              const std::vector<fawkes::Time> &times,
+                              std::vector<StampedTransform> &  transforms) const
+{
+	transforms.resize(times.size());
+
+	if (target_frame == source_frame) {
+		for (size_t i = 0; i < times.size(); ++i) {
+			lookup_transform(target_frame, source_frame, times[i], transforms[i]);
+		}
+		return;
+	}
+
+	CompactFrameID target_id =
+	  validate_frame_id("lookup_transforms argument target_frame", target_frame);
+	CompactFrameID source_id =
+	  validate_frame_id("lookup_transforms argument source_frame", source_frame);
+
+	TransformChainAccum chain;
+	bool                have_chain = false;
+
+	for (size_t i = 0; i < times.size(); ++i) {
+		TransformAccum  accum;
+		TransformAccum *result = &accum;
+		if (!(have_chain && !times[i].is_zero() && chain.replay(times[i], accum))) {
+			std::string error_string;
+			int         retval;
+			if (!have_chain && !times[i].is_zero()) {
+				retval     = walk_to_top_parent(chain, times[i], target_id, source_id, &error_string);
+				have_chain = (retval == NO_ERROR);
+				result     = &chain;
+			} else {
+				retval = walk_to_top_parent(accum, times[i], target_id, source_id, &error_string);
+			}
+			if (retval != NO_ERROR) {
+				throw_lookup_error(retval, error_string);
+			}
+		}
+
+		StampedTransform &transform = transforms[i];
+		transform.setOrigin(result->result_vec);
+		transform.setRotation(result->result_quat);
+		transform.child_frame_id = source_frame;
+		transform.frame_id       = target_frame;
+		transform.stamp          = result->time;
+	}
+}
+
+/** Lookup transform and get traversed frame caches.
+ * @param target_id frame number of target
+ * @param source_id frame number of source
+ * @param time time for which to get the transform
+ * @param transform upon return contains the transform, frame IDs are
+ * not set
+ * @param links if not NULL, upon return contains all frame caches
+ * queried to compute the transform with their data versions read before
+ * the data was retrieved
+ * @param error_string accumulated error string
+ * @return error flag from ErrorValues
+ */
+int
+BufferCore::lookup_transform_chain(CompactFrameID          target_id,
+                                   CompactFrameID          source_id,
+                                   const fawkes::Time &    time,
+                                   StampedTransform &      transform,
+                                   std::vector<ChainLink> *links,
+                                   std::string *           error_string) const
+{
+	TransformChainAccum accum;
+	int                 retval = walk_to_top_parent(accum, time, target_id, source_id, error_string);
+	if (retval != NO_ERROR) {
+		return retval;
+	}
+
+	transform.setOrigin(accum.result_vec);
+	transform.setRotation(accum.result_quat);
+	transform.stamp = accum.time;
+	if (links) {
+		links->clear();
+		for (const TransformChainAccum::Step &step : accum.steps) {
+			links->push_back(std::make_pair(step.cache, step.version));
+		}
+	}
+	return NO_ERROR;
+}
+
 /// @cond INTERNAL
 struct CanTransformAccum
 {
@@ -695,7 +905,8 @@ BufferCore::can_transform_no_lock(CompactFrameID      target_id,
 }
 
 /** Test if a transform is possible.
- * Internal check that does lock the frame mutex.
+ * Internal check, equivalent to can_transform_no_lock() since readers
+ * operate on a frame table snapshot without locking.
  * @param target_id The frame number into which to transform
  * @param source_id The frame number from which to transform
  * @param time The time at which to transform
@@ -708,7 +919,6 @@ BufferCore::can_transform_internal(CompactFrameID      target_id,
                                    const fawkes::Time &time,
                                    std::string *       error_msg) const
 {
-	std::unique_lock<std::mutex> lock(frame_mutex_);
 	return can_transform_no_lock(target_id, source_id, time, error_msg);
 }
 
@@ -734,8 +944,6 @@ BufferCore::can_transform(const std::string & target_frame,
 	if (warn_frame_id("canTransform argument source_frame", source_frame))
 		return false;
 
-	std::unique_lock<std::mutex> lock(frame_mutex_);
-
 	CompactFrameID target_id = lookup_frame_number(target_frame);
 	CompactFrameID source_id = lookup_frame_number(source_frame);
 
@@ -779,10 +987,11 @@ BufferCore::can_transform(const std::string & target_frame,
 TimeCacheInterfacePtr
 BufferCore::get_frame(CompactFrameID frame_id) const
 {
-	if (frame_id >= frames_.size())
+	const V_TimeCacheInterface &frames = frame_table().frames;
+	if (frame_id >= frames.size())
 		return TimeCacheInterfacePtr();
 	else {
-		return frames_[frame_id];
+		return frames[frame_id];
 	}
 }
 
@@ -794,8 +1003,9 @@ CompactFrameID
 BufferCore::lookup_frame_number(const std::string &frameid_str) const
 {
 	CompactFrameID                           retval;
-	M_StringToCompactFrameID::const_iterator map_it = frameIDs_.find(frameid_str);
-	if (map_it == frameIDs_.end()) {
+	const M_StringToCompactFrameID &         frame_ids = frame_table().frame_ids;
+	M_StringToCompactFrameID::const_iterator map_it    = frame_ids.find(frameid_str);
+	if (map_it == frame_ids.end()) {
 		retval = CompactFrameID(0);
 	} else
 		retval = map_it->second;
@@ -803,21 +1013,22 @@ BufferCore::lookup_frame_number(const std::string &frameid_str) const
 }
 
 /** Get compact ID for frame or create if not existant.
+ * @param table unpublished frame table to add the frame to
  * @param frameid_str frame ID string
  * @return compact frame ID
  */
 CompactFrameID
-BufferCore::lookup_or_insert_frame_number(const std::string &frameid_str)
+BufferCore::lookup_or_insert_frame_number(FrameTable &table, const std::string &frameid_str)
 {
 	CompactFrameID                     retval = 0;
-	M_StringToCompactFrameID::iterator map_it = frameIDs_.find(frameid_str);
-	if (map_it == frameIDs_.end()) {
-		retval = CompactFrameID(frames_.size());
-		frames_.push_back(TimeCacheInterfacePtr()); //Just a place holder for iteration
-		frameIDs_[frameid_str] = retval;
-		frameIDs_reverse.push_back(frameid_str);
+	M_StringToCompactFrameID::iterator map_it = table.frame_ids.find(frameid_str);
+	if (map_it == table.frame_ids.end()) {
+		retval = CompactFrameID(table.frames.size());
+		table.frames.push_back(TimeCacheInterfacePtr()); //Just a place holder for iteration
+		table.frame_ids[frameid_str] = retval;
+		table.frame_ids_reverse.push_back(frameid_str);
 	} else
-		retval = frameIDs_[frameid_str];
+		retval = map_it->second;
 
 	return retval;
 }
@@ -830,10 +1041,11 @@ BufferCore::lookup_or_insert_frame_number(const std::string &frameid_str)
 const std::string &
 BufferCore::lookup_frame_string(CompactFrameID frame_id_num) const
 {
-	if (frame_id_num >= frameIDs_reverse.size()) {
+	const std::vector<std::string> &frame_ids_reverse = frame_table().frame_ids_reverse;
+	if (frame_id_num >= frame_ids_reverse.size()) {
 		throw LookupException("Reverse lookup of frame id %u failed!", frame_id_num);
 	} else
-		return frameIDs_reverse[frame_id_num];
+		return frame_ids_reverse[frame_id_num];
 }
 
 /** Create error string.
@@ -863,7 +1075,6 @@ BufferCore::create_connectivity_error_string(CompactFrameID source_frame,
 std::string
 BufferCore::all_frames_as_string() const
 {
-	std::unique_lock<std::mutex> lock(frame_mutex_);
 	return this->all_frames_as_string_no_lock();
 }
 
@@ -875,13 +1086,14 @@ std::string
 BufferCore::all_frames_as_string_no_lock() const
 {
 	std::stringstream mstream;
+	const FrameTable &table = frame_table();
 
 	TransformStorage temp;
 
 	//  for (std::vector< TimeCache*>::iterator  it = frames_.begin(); it != frames_.end(); ++it)
 
 	///regular transforms
-	for (unsigned int counter = 1; counter < frames_.size(); counter++) {
+	for (unsigned int counter = 1; counter < table.frames.size(); counter++) {
 		TimeCacheInterfacePtr frame_ptr = get_frame(CompactFrameID(counter));
 		if (frame_ptr == NULL)
 			continue;
@@ -891,8 +1103,8 @@ BufferCore::all_frames_as_string_no_lock() const
 		else {
 			frame_id_num = 0;
 		}
-		mstream << "Frame " << frameIDs_reverse[counter] << " exists with parent "
-		        << frameIDs_reverse[frame_id_num] << "." << std::endl;
+		mstream << "Frame " << table.frame_ids_reverse[counter] << " exists with parent "
+		        << lookup_frame_string(frame_id_num) << "." << std::endl;
 	}
 
 	return mstream.str();
@@ -1093,17 +1305,18 @@ BufferCore::all_frames_as_YAML(double current_time) const
 {
 	std::stringstream            mstream;
 	std::unique_lock<std::mutex> lock(frame_mutex_);
+	const FrameTable &           table = frame_table();
 
 	TransformStorage temp;
 
-	if (frames_.size() == 1)
+	if (table.frames.size() == 1)
 		mstream << "[]";
 
 	mstream.precision(3);
 	mstream.setf(std::ios::fixed, std::ios::floatfield);
 
 	//  for (std::vector< TimeCache*>::iterator  it = frames_.begin(); it != frames_.end(); ++it)
-	for (unsigned int counter = 1; counter < frames_.size();
+	for (unsigned int counter = 1; counter < table.frames.size();
 	     counter++) //one referenced for 0 is no frame
 	{
 		CompactFrameID        cfid = CompactFrameID(counter);
@@ -1132,8 +1345,8 @@ BufferCore::all_frames_as_YAML(double current_time) const
 
 		mstream << std::fixed; //fixed point notation
 		mstream.precision(3);  //3 decimal places
-		mstream << frameIDs_reverse[cfid] << ": " << std::endl;
-		mstream << "  parent: '" << frameIDs_reverse[frame_id_num] << "'" << std::endl;
+		mstream << table.frame_ids_reverse[cfid] << ": " << std::endl;
+		mstream << "  parent: '" << lookup_frame_string(frame_id_num) << "'" << std::endl;
 		mstream << "  broadcaster: '" << authority << "'" << std::endl;
 		mstream << "  rate: " << rate << std::endl;
 		mstream << "  most_recent_transform: " << (cache->get_latest_timestamp()).in_sec() << std::endl;
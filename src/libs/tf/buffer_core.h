@@ -56,6 +56,8 @@
 #include <tf/types.h>
 #include <utils/time/time.h>
 
+#include <atomic>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -102,6 +104,10 @@ enum ErrorValues {
  *
  * All function calls which pass frame ids can potentially throw the
  * exception tf::LookupException
+ *
+ * Lookups do not lock the buffer. The frame ID maps and frame caches
+ * are kept in an immutable snapshot which is only replaced by writers
+ * adding new frames, and each frame cache synchronizes its own data.
  */
 class BufferCore
 {
@@ -132,6 +138,11 @@ public:
 	                      const std::string & fixed_frame,
 	                      StampedTransform &  transform) const;
 
+	void lookup_transforms(const std::string &              target_frame,
+	                       const std::string &              source_frame,
+	                       const std::vector<fawkes::Time> &times,
+	                       std::vector<StampedTransform> &  transforms) const;
+
 	bool can_transform(const std::string & target_frame,
 	                   const std::string & source_frame,
 	                   const fawkes::Time &time,
@@ -166,20 +177,36 @@ protected:
 
 	/// Vector data type for frame caches.
 	typedef std::vector<TimeCacheInterfacePtr> V_TimeCacheInterface;
-	/** The pointers to potential frames that the tree can be made of.
-   * The frames will be dynamically allocated at run time when set the
-   * first time. */
-	V_TimeCacheInterface frames_;
+	/** \brief A map from string frame ids to CompactFrameID */
+	typedef std::unordered_map<std::string, CompactFrameID> M_StringToCompactFrameID;
+
+	/** Snapshot of the frame tables.
+	 * A published snapshot is never modified. Writers copy the current
+	 * snapshot, modify the copy and publish it in place of the old one. */
+	typedef struct
+	{
+		/** The pointers to potential frames that the tree can be made of.
+		 * The frames will be dynamically allocated at run time when set the
+		 * first time. */
+		V_TimeCacheInterface frames;
+		/// Mapping from frame string IDs to compact IDs.
+		M_StringToCompactFrameID frame_ids;
+		/** \brief A map from CompactFrameID frame_id_numbers to string for debugging and output */
+		std::vector<std::string> frame_ids_reverse;
+	} FrameTable;
+
+	/** Get current frame table snapshot.
+	 * The snapshot remains valid for the lifetime of the BufferCore.
+	 * @return current frame table */
+	const FrameTable &
+	frame_table() const
+	{
+		return *frame_table_.load(std::memory_order_acquire);
+	}
 
-	/** \brief A mutex to protect testing and allocating new frames on the above vector. */
+	/** \brief A mutex to serialize writers and protect frame_authority_. */
 	mutable std::mutex frame_mutex_;
 
-	/** \brief A map from string frame ids to CompactFrameID */
-	typedef std::unordered_map<std::string, CompactFrameID> M_StringToCompactFrameID;
-	/// Mapping from frame string IDs to compact IDs.
-	M_StringToCompactFrameID frameIDs_;
-	/** \brief A map from CompactFrameID frame_id_numbers to string for debugging and output */
-	std::vector<std::string> frameIDs_reverse;
 	/** \brief A map to lookup the most recent authority for a given frame */
 	std::map<CompactFrameID, std::string> frame_authority_;
 
@@ -190,7 +217,8 @@ protected:
 
 	TimeCacheInterfacePtr get_frame(CompactFrameID c_frame_id) const;
 
-	TimeCacheInterfacePtr allocate_frame(CompactFrameID cfid, bool is_static);
+	TimeCacheInterfacePtr
+	allocate_frame(FrameTable &table, CompactFrameID cfid, bool is_static) const;
 
 	bool           warn_frame_id(const char *function_name_arg, const std::string &frame_id) const;
 	CompactFrameID validate_frame_id(const char *       function_name_arg,
@@ -200,7 +228,7 @@ protected:
 	CompactFrameID lookup_frame_number(const std::string &frameid_str) const;
 
 	/// String to number for frame lookup with dynamic allocation of new frames
-	CompactFrameID lookup_or_insert_frame_number(const std::string &frameid_str);
+	CompactFrameID lookup_or_insert_frame_number(FrameTable &table, const std::string &frameid_str);
 
 	///Number to string frame lookup may throw LookupException if number invalid
 	const std::string &lookup_frame_string(CompactFrameID frame_id_num) const;
@@ -237,6 +265,26 @@ protected:
 	                           CompactFrameID      source_id,
 	                           const fawkes::Time &time,
 	                           std::string *       error_msg) const;
+
+	/// Frame cache queried during a lookup and its data version at that time.
+	typedef std::pair<TimeCacheInterfacePtr, unsigned int> ChainLink;
+
+	int lookup_transform_chain(CompactFrameID          target_id,
+	                           CompactFrameID          source_id,
+	                           const fawkes::Time &    time,
+	                           StampedTransform &      transform,
+	                           std::vector<ChainLink> *links,
+	                           std::string *           error_string) const;
+
+	static void throw_lookup_error(int error, const std::string &error_string);
+
+	friend class TransformChainCache;
+
+private:
+	void publish_frame_table(FrameTable *table);
+
+	std::atomic<const FrameTable *>               frame_table_;
+	std::list<std::unique_ptr<const FrameTable>> frame_tables_;
 };
 
 } // end namespace tf
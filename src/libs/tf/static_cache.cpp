@@ -49,6 +49,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <core/threading/scoped_rwlock.h>
 #include <tf/exceptions.h>
 #include <tf/time_cache.h>
 #include <tf/types.h>
@@ -58,11 +59,12 @@ namespace tf {
 
 /** @class StaticCache <tf/time_cache.h>
  * Transform cache for static transforms.
+ * Access is synchronized by a read-write lock.
  */
 
 /** Constructor.
  */
-StaticCache::StaticCache() : storage_as_list_(1)
+StaticCache::StaticCache() : version_(0), storage_as_list_(1)
 {
 }
 
@@ -78,6 +80,7 @@ StaticCache::~StaticCache()
 TimeCacheInterfacePtr
 StaticCache::clone(const fawkes::Time &look_back_until) const
 {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
 	StaticCache *copy      = new StaticCache();
 	copy->storage_         = storage_;
 	copy->storage_as_list_ = storage_as_list_;
@@ -87,6 +90,7 @@ StaticCache::clone(const fawkes::Time &look_back_until) const
 bool
 StaticCache::get_data(fawkes::Time time, TransformStorage &data_out, std::string *error_str)
 {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
 	data_out       = storage_;
 	data_out.stamp = time;
 	return true;
@@ -95,8 +99,10 @@ StaticCache::get_data(fawkes::Time time, TransformStorage &data_out, std::string
 bool
 StaticCache::insert_data(const TransformStorage &new_data)
 {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_WRITE);
 	storage_                 = new_data;
 	storage_as_list_.front() = new_data;
+	version_.fetch_add(1, std::memory_order_release);
 	return true;
 }
 
@@ -115,12 +121,14 @@ StaticCache::get_list_length() const
 CompactFrameID
 StaticCache::get_parent(fawkes::Time time, std::string *error_str)
 {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
 	return storage_.frame_id;
 }
 
 P_TimeAndFrameID
 StaticCache::get_latest_time_and_parent()
 {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
 	return std::make_pair(fawkes::Time(0, 0), storage_.frame_id);
 }
 
@@ -136,16 +144,17 @@ StaticCache::get_oldest_timestamp() const
 	return fawkes::Time(0, 0);
 }
 
-const TimeCacheInterface::L_TransformStorage &
-StaticCache::get_storage() const
+TimeCacheInterface::L_TransformStorage
+StaticCache::get_storage_copy() const
 {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
 	return storage_as_list_;
 }
 
-TimeCacheInterface::L_TransformStorage
-StaticCache::get_storage_copy() const
+unsigned int
+StaticCache::get_version() const
 {
-	return storage_as_list_;
+	return version_.load(std::memory_order_acquire);
 }
 
 } // end namespace tf
@@ -49,6 +49,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <core/threading/scoped_rwlock.h>
 #include <tf/time_cache.h>
 
 #include <cstdio>
@@ -132,26 +133,43 @@ TransformStorage::TransformStorage(const StampedTransform &data,
  * Get oldest timestamp from cache.
  * @return oldest time stamp.
  *
- * @fn virtual const L_TransformStorage & TimeCacheInterface::get_storage() const = 0
- * Get storage list.
- * @return reference to list of storage elements
- *
  * @fn L_TransformStorage TimeCacheInterface::get_storage_copy() const = 0
  * Get copy of storage elements.
  * @return copied list of storage elements
+ *
+ * @fn unsigned int TimeCacheInterface::get_version() const = 0
+ * Get data version.
+ * The version is increased on any modification which may change the
+ * result of get_data() or get_parent() for a time for which data was
+ * available before. Appending data newer than all existing data does
+ * not increase the version. Removing old data does not either, check
+ * get_oldest_timestamp() for this.
+ * @return data version
  */
 
 /** @class TimeCache <tf/time_cache.h>
  * Time based transform cache.
- * A class to keep a sorted linked list in time. This builds and
+ * A class to keep a sorted buffer in time. This builds and
  * maintains a list of timestamped data.  And provides lookup
  * functions to get data out as a function of time.
+ *
+ * The data is kept in a contiguous ring buffer sorted by time stamp
+ * with the oldest element at the head. Transforms usually arrive in
+ * order, hence inserting appends at the tail and pruning advances the
+ * head, neither of which moves data. Lookups use binary search. The
+ * capacity is a power of two and doubles when the buffer runs full,
+ * up to MAX_LENGTH_LINKED_LIST elements. Once the storage time window
+ * has been filled no more allocations happen.
+ *
+ * Access is synchronized by a read-write lock per cache, hence lookups
+ * may run concurrently with each other.
  */
 
 /** Constructor.
  * @param max_storage_time maximum time in seconds to cache, defaults to 10 seconds
  */
-TimeCache::TimeCache(float max_storage_time) : max_storage_time_(max_storage_time)
+TimeCache::TimeCache(float max_storage_time)
+: version_(0), head_(0), size_(0), max_storage_time_(max_storage_time)
 {
 }
 
@@ -234,6 +252,42 @@ create_extrapolation_exception3(fawkes::Time t0, fawkes::Time t1, std::string *e
 	}
 }
 
+/** Find first element newer than the given time.
+ * @param time time to compare to
+ * @return chronological index of the first element with a time stamp
+ * greater than @p time, or the number of elements if there is none
+ */
+size_t
+TimeCache::upper_bound(const fawkes::Time &time) const
+{
+	size_t first = 0;
+	size_t count = size_;
+	while (count > 0) {
+		size_t step = count / 2;
+		if (at(first + step).stamp <= time) {
+			first += step + 1;
+			count -= step + 1;
+		} else {
+			count = step;
+		}
+	}
+	return first;
+}
+
+/** Double the capacity of the ring buffer.
+ * Elements are moved such that the oldest element is at index zero.
+ */
+void
+TimeCache::grow()
+{
+	std::vector<TransformStorage> grown(storage_.empty() ? INITIAL_CAPACITY : storage_.size() * 2);
+	for (size_t i = 0; i < size_; ++i) {
+		grown[i] = at(i);
+	}
+	storage_.swap(grown);
+	head_ = 0;
+}
+
 /// A helper function for getData
 //Assumes storage is already locked for it
 uint8_t
@@ -243,7 +297,7 @@ TimeCache::find_closest(TransformStorage *&one,
                         std::string *      error_str)
 {
 	//No values stored
-	if (storage_.empty()) {
+	if (size_ == 0) {
 		if (error_str)
 			*error_str = "Transform cache storage is empty";
 		return 0;
@@ -251,13 +305,13 @@ TimeCache::find_closest(TransformStorage *&one,
 
 	//If time == 0 return the latest
 	if (target_time.is_zero()) {
-		one = &storage_.front();
+		one = &at(size_ - 1);
 		return 1;
 	}
 
 	// One value stored
-	if (++storage_.begin() == storage_.end()) {
-		TransformStorage &ts = *storage_.begin();
+	if (size_ == 1) {
+		TransformStorage &ts = at(0);
 		if (ts.stamp == target_time) {
 			one = &ts;
 			return 1;
@@ -267,14 +321,14 @@ TimeCache::find_closest(TransformStorage *&one,
 		}
 	}
 
-	fawkes::Time latest_time   = (*storage_.begin()).stamp;
-	fawkes::Time earliest_time = (*(storage_.rbegin())).stamp;
+	fawkes::Time latest_time   = at(size_ - 1).stamp;
+	fawkes::Time earliest_time = at(0).stamp;
 
 	if (target_time == latest_time) {
-		one = &(*storage_.begin());
+		one = &at(size_ - 1);
 		return 1;
 	} else if (target_time == earliest_time) {
-		one = &(*storage_.rbegin());
+		one = &at(0);
 		return 1;
 	} else if (target_time > latest_time) {
 		// Catch cases that would require extrapolation
@@ -286,17 +340,13 @@ TimeCache::find_closest(TransformStorage *&one,
 	}
 
 	//At least 2 values stored
-	//Find the first value less than the target value
-	L_TransformStorage::iterator storage_it = storage_.begin();
-	while (storage_it != storage_.end()) {
-		if (storage_it->stamp <= target_time)
-			break;
-		storage_it++;
-	}
+	//Find the last value less than or equal to the target value,
+	//earliest_time < target_time < latest_time, hence 1 <= i < size_
+	size_t i = upper_bound(target_time);
 
 	//Finally the case were somewhere in the middle  Guarenteed no extrapolation :-)
-	one = &*(storage_it);   //Older
-	two = &*(--storage_it); //Newer
+	one = &at(i - 1); //Older
+	two = &at(i);     //Newer
 	return 2;
 }
 
@@ -328,16 +378,18 @@ TimeCache::interpolate(const TransformStorage &one,
 TimeCacheInterfacePtr
 TimeCache::clone(const fawkes::Time &look_back_until) const
 {
-	TimeCache *copy = new TimeCache(max_storage_time_);
-	if (look_back_until.is_zero()) {
-		copy->storage_ = storage_;
-	} else {
-		L_TransformStorage::const_iterator storage_it = storage_.begin();
-		for (storage_it = storage_.begin(); storage_it != storage_.end(); ++storage_it) {
-			if (storage_it->stamp <= look_back_until)
-				break;
-			copy->storage_.push_back(*storage_it);
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
+	TimeCache *copy  = new TimeCache(max_storage_time_);
+	size_t     first = look_back_until.is_zero() ? 0 : upper_bound(look_back_until);
+	if (first < size_) {
+		size_t capacity = INITIAL_CAPACITY;
+		while (capacity < size_ - first)
+			capacity *= 2;
+		copy->storage_.resize(capacity);
+		for (size_t i = first; i < size_; ++i) {
+			copy->storage_[i - first] = at(i);
 		}
+		copy->size_ = size_ - first;
 	}
 	return std::shared_ptr<TimeCacheInterface>(copy);
 }
@@ -345,6 +397,7 @@ TimeCache::clone(const fawkes::Time &look_back_until) const
 bool
 TimeCache::get_data(fawkes::Time time, TransformStorage &data_out, std::string *error_str)
 {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
 	TransformStorage *p_temp_1 = NULL;
 	TransformStorage *p_temp_2 = NULL;
 
@@ -367,6 +420,7 @@ TimeCache::get_data(fawkes::Time time, TransformStorage &data_out, std::string *
 CompactFrameID
 TimeCache::get_parent(fawkes::Time time, std::string *error_str)
 {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
 	TransformStorage *p_temp_1 = NULL;
 	TransformStorage *p_temp_2 = NULL;
 
@@ -381,20 +435,34 @@ TimeCache::get_parent(fawkes::Time time, std::string *error_str)
 bool
 TimeCache::insert_data(const TransformStorage &new_data)
 {
-	L_TransformStorage::iterator storage_it = storage_.begin();
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_WRITE);
+	if (size_ > 0 && at(size_ - 1).stamp > new_data.stamp + max_storage_time_) {
+		return false;
+	}
 
-	if (storage_it != storage_.end()) {
-		if (storage_it->stamp > new_data.stamp + max_storage_time_) {
-			return false;
+	if (size_ == storage_.size()) {
+		if (storage_.size() < MAX_LENGTH_LINKED_LIST) {
+			grow();
+		} else {
+			// drop oldest element to make room
+			head_ = (head_ + 1) & (storage_.size() - 1);
+			size_ -= 1;
 		}
 	}
 
-	while (storage_it != storage_.end()) {
-		if (storage_it->stamp <= new_data.stamp)
-			break;
-		storage_it++;
+	// common case: data arrives in order and is appended
+	size_t pos = size_;
+	if (size_ > 0 && !(new_data.stamp > at(size_ - 1).stamp)) {
+		version_.fetch_add(1, std::memory_order_release);
 	}
-	storage_.insert(storage_it, new_data);
+	if (size_ > 0 && at(size_ - 1).stamp > new_data.stamp) {
+		pos = upper_bound(new_data.stamp);
+		for (size_t i = size_; i > pos; --i) {
+			at(i) = at(i - 1);
+		}
+	}
+	at(pos) = new_data;
+	size_ += 1;
 
 	prune_list();
 	return true;
@@ -403,62 +471,76 @@ TimeCache::insert_data(const TransformStorage &new_data)
 void
 TimeCache::clear_list()
 {
-	storage_.clear();
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_WRITE);
+	head_ = 0;
+	size_ = 0;
+	version_.fetch_add(1, std::memory_order_release);
 }
 
 unsigned int
-TimeCache::get_list_length() const
+TimeCache::get_version() const
 {
-	return storage_.size();
+	return version_.load(std::memory_order_acquire);
 }
 
-const TimeCacheInterface::L_TransformStorage &
-TimeCache::get_storage() const
+unsigned int
+TimeCache::get_list_length() const
 {
-	return storage_;
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
+	return size_;
 }
 
 TimeCacheInterface::L_TransformStorage
 TimeCache::get_storage_copy() const
 {
-	return storage_;
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
+	// newest element first
+	L_TransformStorage rv;
+	for (size_t i = size_; i > 0; --i) {
+		rv.push_back(at(i - 1));
+	}
+	return rv;
 }
 
 P_TimeAndFrameID
 TimeCache::get_latest_time_and_parent()
 {
-	if (storage_.empty()) {
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
+	if (size_ == 0) {
 		return std::make_pair(fawkes::Time(), 0);
 	}
 
-	const TransformStorage &ts = storage_.front();
+	const TransformStorage &ts = at(size_ - 1);
 	return std::make_pair(ts.stamp, ts.frame_id);
 }
 
 fawkes::Time
 TimeCache::get_latest_timestamp() const
 {
-	if (storage_.empty())
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
+	if (size_ == 0)
 		return fawkes::Time(0, 0); //empty list case
-	return storage_.front().stamp;
+	return at(size_ - 1).stamp;
 }
 
 fawkes::Time
 TimeCache::get_oldest_timestamp() const
 {
-	if (storage_.empty())
+	ScopedRWLock lock(&rwlock_, ScopedRWLock::LOCK_READ);
+	if (size_ == 0)
 		return fawkes::Time(0, 0); //empty list case
-	return storage_.back().stamp;
+	return at(0).stamp;
 }
 
 /** Prune storage list based on maximum cache lifetime. */
 void
 TimeCache::prune_list()
 {
-	fawkes::Time latest_time = storage_.begin()->stamp;
+	fawkes::Time latest_time = at(size_ - 1).stamp;
 
-	while (!storage_.empty() && storage_.back().stamp + max_storage_time_ < latest_time) {
-		storage_.pop_back();
+	while (size_ > 0 && at(0).stamp + max_storage_time_ < latest_time) {
+		head_ = (head_ + 1) & (storage_.size() - 1);
+		size_ -= 1;
 	}
 }
 
@@ -52,12 +52,15 @@
 #ifndef _LIBS_TF_TIME_CACHE_H_
 #define _LIBS_TF_TIME_CACHE_H_
 
+#include <core/threading/read_write_lock.h>
 #include <tf/transform_storage.h>
 #include <tf/types.h>
 
+#include <atomic>
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace fawkes {
 namespace tf {
@@ -87,8 +90,9 @@ public:
 	virtual fawkes::Time get_latest_timestamp() const = 0;
 	virtual fawkes::Time get_oldest_timestamp() const = 0;
 
-	virtual const L_TransformStorage &get_storage() const      = 0;
-	virtual L_TransformStorage        get_storage_copy() const = 0;
+	virtual L_TransformStorage get_storage_copy() const = 0;
+
+	virtual unsigned int get_version() const = 0;
 };
 
 class TimeCache : public TimeCacheInterface
@@ -96,8 +100,10 @@ class TimeCache : public TimeCacheInterface
 public:
 	/// Number of nano-seconds to not interpolate below.
 	static const int MIN_INTERPOLATION_DISTANCE = 5;
-	/// Maximum length of linked list, to make sure not to be able to use unlimited memory.
-	static const unsigned int MAX_LENGTH_LINKED_LIST = 1000000;
+	/// Maximum number of stored transforms, to make sure not to be able to use unlimited memory.
+	static const unsigned int MAX_LENGTH_LINKED_LIST = 1 << 20;
+	/// Number of transforms for which space is allocated initially.
+	static const unsigned int INITIAL_CAPACITY = 64;
 	/// default value of 10 seconds storage
 	static const int64_t DEFAULT_MAX_STORAGE_TIME =
 	  1ULL * 1000000000LL; //!< default value of 10 seconds storage
@@ -113,18 +119,48 @@ public:
 	virtual CompactFrameID   get_parent(fawkes::Time time, std::string *error_str);
 	virtual P_TimeAndFrameID get_latest_time_and_parent();
 
-	virtual const L_TransformStorage &get_storage() const;
-	virtual L_TransformStorage        get_storage_copy() const;
+	virtual L_TransformStorage get_storage_copy() const;
 
 	virtual unsigned int get_list_length() const;
 	virtual fawkes::Time get_latest_timestamp() const;
 	virtual fawkes::Time get_oldest_timestamp() const;
 
+	virtual unsigned int get_version() const;
+
 private:
-	L_TransformStorage storage_;
+	mutable ReadWriteLock     rwlock_;
+	std::atomic<unsigned int> version_;
+
+	// ring buffer sorted by time stamp, oldest element at head_
+	std::vector<TransformStorage> storage_;
+	size_t                        head_;
+	size_t                        size_;
 
 	float max_storage_time_;
 
+	/** Get element by chronological index.
+	 * @param i index, 0 is the oldest element
+	 * @return element at the given index
+	 */
+	inline TransformStorage &
+	at(size_t i)
+	{
+		return storage_[(head_ + i) & (storage_.size() - 1)];
+	}
+
+	/** Get element by chronological index.
+	 * @param i index, 0 is the oldest element
+	 * @return element at the given index
+	 */
+	inline const TransformStorage &
+	at(size_t i) const
+	{
+		return storage_[(head_ + i) & (storage_.size() - 1)];
+	}
+
+	size_t upper_bound(const fawkes::Time &time) const;
+	void   grow();
+
 	inline uint8_t find_closest(TransformStorage *&one,
 	                            TransformStorage *&two,
 	                            fawkes::Time       target_time,
@@ -156,12 +192,15 @@ public:
 	virtual fawkes::Time get_latest_timestamp() const;
 	virtual fawkes::Time get_oldest_timestamp() const;
 
-	virtual const L_TransformStorage &get_storage() const;
-	virtual L_TransformStorage        get_storage_copy() const;
+	virtual L_TransformStorage get_storage_copy() const;
+
+	virtual unsigned int get_version() const;
 
 private:
-	TransformStorage   storage_;
-	L_TransformStorage storage_as_list_;
+	mutable ReadWriteLock     rwlock_;
+	std::atomic<unsigned int> version_;
+	TransformStorage          storage_;
+	L_TransformStorage        storage_as_list_;
 };
 
 } // end namespace tf
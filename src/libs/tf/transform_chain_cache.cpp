@@ -0,0 +1,204 @@
+/***************************************************************************
+ *  transform_chain_cache.cpp - Fawkes tf cache for composed transforms
+ *
+ *  Created: Thu Oct 15 03:38:56 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <tf/exceptions.h>
+#include <tf/time_cache.h>
+#include <tf/transform_chain_cache.h>
+#include <tf/utils.h>
+
+namespace fawkes {
+namespace tf {
+
+/** @class TransformChainCache <tf/transform_chain_cache.h>
+ * Cache for composed transforms.
+ * Looking up a transform walks the tree from source and target frame
+ * to their common parent and composes the transforms of all links on
+ * the way. Code which repeatedly looks up the same transform, for
+ * example to transform every point of a point cloud, can use this cache
+ * to memoize the composed transform.
+ *
+ * Entries are keyed by target frame, source frame, and time. Times are
+ * grouped into buckets of the given resolution. With a resolution of
+ * zero only lookups for the exact same time share an entry. Otherwise
+ * all lookups within a bucket yield the transform computed for the first
+ * time looked up in that bucket. An entry is invalidated if data is
+ * modified on any of its links in a way that could change the result,
+ * or if the data required for its time has been pruned.
+ *
+ * The cache has a fixed number of entries and does not allocate memory
+ * after the first lookup for each entry. A new entry replaces an
+ * existing one hashing to the same slot. Lookups for the latest common
+ * time, i.e. time (0,0), are never cached.
+ *
+ * The cache itself is not thread-safe. Use one instance per thread.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param transformer transformer to look up transforms with
+ * @param time_resolution resolution of time buckets in seconds, zero to
+ * only share entries among lookups for the exact same time
+ * @param size number of entries, rounded up to the next power of two
+ */
+TransformChainCache::TransformChainCache(Transformer *transformer,
+                                         float        time_resolution,
+                                         unsigned int size)
+: transformer_(transformer),
+  time_resolution_usec_((long)(time_resolution * 1000000.)),
+  hits_(0),
+  misses_(0)
+{
+	unsigned int capacity = 1;
+	while (capacity < size)
+		capacity *= 2;
+	entries_.resize(capacity);
+	clear();
+}
+
+/** Destructor. */
+TransformChainCache::~TransformChainCache()
+{
+}
+
+/** Lookup transform.
+ * @param target_frame target frame ID
+ * @param source_frame source frame ID
+ * @param time time for which to get the transform, set to (0,0) to get latest
+ * common time frame
+ * @param transform upon return contains the transform
+ * @exception ConnectivityException thrown if no connection between
+ * the source and target frame could be found in the tree.
+ * @exception ExtrapolationException returning a value would have
+ * required extrapolation beyond current limits.
+ * @exception LookupException at least one of the two given frames is
+ * unknown
+ * @exception DisabledException thrown if the transformer has been disabled
+ */
+void
+TransformChainCache::lookup_transform(const std::string & target_frame,
+                                      const std::string & source_frame,
+                                      const fawkes::Time &time,
+                                      StampedTransform &  transform)
+{
+	if (time.is_zero() || target_frame == source_frame) {
+		transformer_->lookup_transform(target_frame, source_frame, time, transform);
+		return;
+	}
+
+	if (!transformer_->is_enabled()) {
+		throw DisabledException("Transformer has been disabled");
+	}
+
+	std::string    stripped_target = strip_slash(target_frame);
+	std::string    stripped_source = strip_slash(source_frame);
+	CompactFrameID target_id =
+	  transformer_->validate_frame_id("TransformChainCache argument target_frame", stripped_target);
+	CompactFrameID source_id =
+	  transformer_->validate_frame_id("TransformChainCache argument source_frame", stripped_source);
+
+	long bucket = time.in_usec();
+	if (time_resolution_usec_ > 0) {
+		bucket /= time_resolution_usec_;
+	}
+
+	size_t hash = ((size_t)target_id * 31 + source_id) * 2654435761u ^ (size_t)bucket;
+	Entry &entry = entries_[hash & (entries_.size() - 1)];
+
+	if (entry.valid && entry.target_id == target_id && entry.source_id == source_id
+	    && entry.bucket == bucket && is_valid(entry)) {
+		hits_ += 1;
+		transform = entry.transform;
+		return;
+	}
+
+	misses_ += 1;
+	entry.valid = false;
+
+	const BufferCore::FrameTable *frame_table = &transformer_->frame_table();
+	std::string                   error_string;
+	int retval = transformer_->lookup_transform_chain(
+	  target_id, source_id, time, entry.transform, &entry.links, &error_string);
+	if (retval != NO_ERROR) {
+		BufferCore::throw_lookup_error(retval, error_string);
+	}
+
+	entry.transform.frame_id       = stripped_target;
+	entry.transform.child_frame_id = stripped_source;
+	entry.target_id                = target_id;
+	entry.source_id                = source_id;
+	entry.bucket                   = bucket;
+	entry.frame_table              = frame_table;
+	entry.valid                    = true;
+
+	transform = entry.transform;
+}
+
+/** Check if entry is still valid.
+ * @param entry entry to check
+ * @return true if neither the frames nor the data of any link have been
+ * modified such that the result could have changed
+ */
+bool
+TransformChainCache::is_valid(const Entry &entry) const
+{
+	if (entry.frame_table != &transformer_->frame_table()) {
+		// frames have been added, the tree may have changed
+		return false;
+	}
+	for (const BufferCore::ChainLink &link : entry.links) {
+		if (link.first->get_version() != link.second
+		    || link.first->get_oldest_timestamp() > entry.transform.stamp) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Remove all entries. */
+void
+TransformChainCache::clear()
+{
+	for (Entry &entry : entries_) {
+		entry.valid = false;
+	}
+}
+
+/** Get number of cache hits.
+ * @return number of lookups answered from the cache
+ */
+unsigned int
+TransformChainCache::hits() const
+{
+	return hits_;
+}
+
+/** Get number of cache misses.
+ * @return number of lookups which required walking the tree
+ */
+unsigned int
+TransformChainCache::misses() const
+{
+	return misses_;
+}
+
+} // end namespace tf
+} // end namespace fawkes
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *  transform_chain_cache.h - Fawkes tf cache for composed transforms
+ *
+ *  Created: Thu Oct 15 03:38:56 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_TF_TRANSFORM_CHAIN_CACHE_H_
+#define _LIBS_TF_TRANSFORM_CHAIN_CACHE_H_
+
+#include <tf/transformer.h>
+#include <tf/types.h>
+
+#include <string>
+#include <vector>
+
+namespace fawkes {
+namespace tf {
+
+class TransformChainCache
+{
+public:
+	TransformChainCache(Transformer *transformer,
+	                    float        time_resolution = 0.,
+	                    unsigned int size            = 64);
+	~TransformChainCache();
+
+	void lookup_transform(const std::string & target_frame,
+	                      const std::string & source_frame,
+	                      const fawkes::Time &time,
+	                      StampedTransform &  transform);
+
+	void clear();
+
+	unsigned int hits() const;
+	unsigned int misses() const;
+
+private:
+	typedef struct
+	{
+		bool                               valid;
+		CompactFrameID                     target_id;
+		CompactFrameID                     source_id;
+		long                               bucket;
+		const BufferCore::FrameTable *     frame_table;
+		std::vector<BufferCore::ChainLink> links;
+		StampedTransform                   transform;
+	} Entry;
+
+	bool is_valid(const Entry &entry) const;
+
+	Transformer *      transformer_;
+	long               time_resolution_usec_;
+	std::vector<Entry> entries_;
+	unsigned int       hits_;
+	unsigned int       misses_;
+};
+
+} // end namespace tf
+} // end namespace fawkes
+
+#endif
@@ -50,10 +50,13 @@
  */
 
 #include <blackboard/blackboard.h>
+#include <interfaces/TransformBatchInterface.h>
 #include <interfaces/TransformInterface.h>
 #include <tf/transform_listener.h>
 #include <tf/transformer.h>
+#include <utils/misc/string_split.h>
 
+#include <algorithm>
 #include <cstring>
 
 namespace fawkes {
@@ -63,7 +66,8 @@ namespace tf {
  * Receive transforms and answer queries.
  * This class connects to the blackboard and listens to all interfaces
  * publishing transforms. It opens all interfaces of type
- * TransformInterface with a TF prefix. The data is internally
+ * TransformInterface and TransformBatchInterface with a TF prefix.
+ * The data is internally
  * cached. Queries are then resolved based on the received
  * information.
  * @author Tim Niemueller
@@ -81,9 +85,14 @@ TransformListener::TransformListener(BlackBoard *bb, Transformer *tf_transformer
   bb_is_remote_(bb_is_remote)
 {
 	if (bb_) {
-		tfifs_ = bb_->open_multiple_for_reading<TransformInterface>("/tf*");
+		std::list<TransformInterface *> tfifs =
+		  bb_->open_multiple_for_reading<TransformInterface>("/tf*");
+		std::list<TransformBatchInterface *> batchifs =
+		  bb_->open_multiple_for_reading<TransformBatchInterface>("/tf*");
+		tfifs_.insert(tfifs_.end(), tfifs.begin(), tfifs.end());
+		tfifs_.insert(tfifs_.end(), batchifs.begin(), batchifs.end());
 
-		std::list<TransformInterface *>::iterator i;
+		std::list<Interface *>::iterator i;
 		for (i = tfifs_.begin(); i != tfifs_.end(); ++i) {
 			bbil_add_data_interface(*i);
 			// update data once we
@@ -92,6 +101,7 @@ TransformListener::TransformListener(BlackBoard *bb, Transformer *tf_transformer
 		bb_->register_listener(this);
 
 		bbio_add_observed_create("TransformInterface", "/tf*");
+		bbio_add_observed_create("TransformBatchInterface", "/tf*");
 		bb_->register_observer(this);
 		tf_transformer->set_enabled(true);
 	} else {
@@ -106,7 +116,7 @@ TransformListener::~TransformListener()
 		bb_->unregister_listener(this);
 		bb_->unregister_observer(this);
 
-		std::list<TransformInterface *>::iterator i;
+		std::list<Interface *>::iterator i;
 		for (i = tfifs_.begin(); i != tfifs_.end(); ++i) {
 			bb_->close(*i);
 		}
@@ -117,12 +127,15 @@ TransformListener::~TransformListener()
 void
 TransformListener::bb_interface_created(const char *type, const char *id) noexcept
 {
-	if (strncmp(type, "TransformInterface", INTERFACE_TYPE_SIZE_) != 0)
-		return;
-
-	TransformInterface *tfif;
+	Interface *tfif;
 	try {
-		tfif = bb_->open_for_reading<TransformInterface>(id, "TF-Listener");
+		if (strncmp(type, "TransformInterface", INTERFACE_TYPE_SIZE_) == 0) {
+			tfif = bb_->open_for_reading<TransformInterface>(id, "TF-Listener");
+		} else if (strncmp(type, "TransformBatchInterface", INTERFACE_TYPE_SIZE_) == 0) {
+			tfif = bb_->open_for_reading<TransformBatchInterface>(id, "TF-Listener");
+		} else {
+			return;
+		}
 	} catch (Exception &e) {
 		// ignored
 		return;
@@ -158,12 +171,13 @@ TransformListener::conditional_close(Interface *interface) noexcept
 	if (bb_is_remote_) {
 		return;
 	}
-	// Verify it's a TransformInterface
-	TransformInterface *tfif = dynamic_cast<TransformInterface *>(interface);
-	if (!tfif)
+	// Verify it's one of ours
+	if (!dynamic_cast<TransformInterface *>(interface)
+	    && !dynamic_cast<TransformBatchInterface *>(interface)) {
 		return;
+	}
 
-	std::list<TransformInterface *>::iterator i;
+	std::list<Interface *>::iterator i;
 	for (i = tfifs_.begin(); i != tfifs_.end(); ++i) {
 		if (*interface == **i) {
 			if (!interface->has_writer() && (interface->num_readers() == 1)) {
@@ -182,8 +196,12 @@ void
 TransformListener::bb_interface_data_refreshed(Interface *interface) noexcept
 {
 	TransformInterface *tfif = dynamic_cast<TransformInterface *>(interface);
-	if (!tfif)
+	if (!tfif) {
+		TransformBatchInterface *batchif = dynamic_cast<TransformBatchInterface *>(interface);
+		if (batchif)
+			set_transforms(batchif);
 		return;
+	}
 
 	tfif->read();
 
@@ -214,5 +232,43 @@ TransformListener::bb_interface_data_refreshed(Interface *interface) noexcept
 	}
 }
 
+/** Add all transforms of a batch interface.
+ * @param batchif interface to read transforms from
+ */
+void
+TransformListener::set_transforms(TransformBatchInterface *batchif)
+{
+	batchif->read();
+
+	std::string authority = bb_is_remote_ ? "remote" : batchif->writer();
+
+	const std::vector<std::string> frames      = str_split(batchif->frames(), ' ');
+	const Time *                   time        = batchif->timestamp();
+	double *                       translation = batchif->translation();
+	double *                       rotation    = batchif->rotation();
+	uint16_t *                     frame       = batchif->frame();
+	uint16_t *                     child_frame = batchif->child_frame();
+	const bool                     is_static   = batchif->is_static_transform();
+
+	const unsigned int num_transforms =
+	  std::min<unsigned int>(batchif->num_transforms(), batchif->maxlenof_child_frame());
+	for (unsigned int i = 0; i < num_transforms; ++i) {
+		if (frame[i] >= frames.size() || child_frame[i] >= frames.size())
+			continue;
+		try {
+			Vector3    t(translation[3 * i], translation[3 * i + 1], translation[3 * i + 2]);
+			Quaternion r(rotation[4 * i], rotation[4 * i + 1], rotation[4 * i + 2], rotation[4 * i + 3]);
+			assert_quaternion_valid(r);
+			Transform tr(r, t);
+
+			StampedTransform str(tr, *time, frames[frame[i]], frames[child_frame[i]]);
+
+			tf_transformer_->set_transform(str, authority, is_static);
+		} catch (InvalidArgumentException &e) {
+			// ignore invalid, might just be not initialized, yet.
+		}
+	}
+}
+
 } // end namespace tf
 } // end namespace fawkes
@@ -62,6 +62,7 @@ namespace fawkes {
 
 class BlackBoard;
 class TransformInterface;
+class TransformBatchInterface;
 
 namespace tf {
 
@@ -83,13 +84,14 @@ public:
 
 private:
 	void conditional_close(Interface *interface) noexcept;
+	void set_transforms(TransformBatchInterface *batchif);
 
 private:
 	BlackBoard * bb_;
 	Transformer *tf_transformer_;
 	bool         bb_is_remote_;
 
-	std::list<TransformInterface *> tfifs_;
+	std::list<Interface *> tfifs_;
 };
 
 } // end namespace tf
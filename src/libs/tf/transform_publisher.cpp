@@ -52,6 +52,7 @@
 #include <blackboard/blackboard.h>
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
+#include <interfaces/TransformBatchInterface.h>
 #include <interfaces/TransformInterface.h>
 #include <tf/transform_publisher.h>
 
@@ -65,6 +66,13 @@ namespace tf {
  * that interface. Assuming that the event-based listener is used
  * it will catch all updates even though we might send them in quick
  * succession.
+ *
+ * Multiple transforms, e.g. all transforms of a kinematic tree, should
+ * be sent at once with send_transforms(). They are published through a
+ * TransformBatchInterface with the same ID, requiring only a single
+ * write for up to 64 transforms. Static transforms sent this way are
+ * kept in separate interfaces, which are only written when a static
+ * transform is added or modified.
  * @author Tim Niemueller
  *
  * @fn   void TransformPublisher::send_transform(const Transform &transform, const fawkes::Time &time, const std::string frame, const std::string child_frame, const bool is_static = false)
@@ -87,11 +95,11 @@ namespace tf {
  * opened TransformInterface. Note that the name is prefixed with "/tf/".
  */
 TransformPublisher::TransformPublisher(BlackBoard *bb, const char *bb_iface_id)
-: bb_(bb), mutex_(new Mutex())
+: bb_(bb), tfif_(NULL), mutex_(new Mutex()), batchif_(NULL)
 {
 	if (bb_) {
-		std::string bbid = (bb_iface_id[0] == '/') ? bb_iface_id : std::string("/tf/") + bb_iface_id;
-		tfif_            = bb_->open_for_writing<TransformInterface>(bbid.c_str());
+		bbid_ = (bb_iface_id[0] == '/') ? bb_iface_id : std::string("/tf/") + bb_iface_id;
+		tfif_ = bb_->open_for_writing<TransformInterface>(bbid_.c_str());
 		tfif_->set_auto_timestamping(false);
 	}
 }
@@ -102,8 +110,14 @@ TransformPublisher::TransformPublisher(BlackBoard *bb, const char *bb_iface_id)
  */
 TransformPublisher::~TransformPublisher()
 {
-	if (bb_)
+	if (bb_) {
 		bb_->close(tfif_);
+		if (batchif_)
+			bb_->close(batchif_);
+		for (TransformBatchInterface *iface : static_batchifs_) {
+			bb_->close(iface);
+		}
+	}
 	delete mutex_;
 }
 
@@ -140,5 +154,138 @@ TransformPublisher::send_transform(const StampedTransform &transform, bool is_st
 	tfif_->write();
 }
 
+/** Publish multiple transforms.
+ * The transforms are written to a TransformBatchInterface, transforms
+ * with the same time stamp are written at once, up to the capacity of
+ * the interface. Static transforms are remembered and only written if
+ * any of them is new or has changed since the last call.
+ * @param transforms transforms to publish
+ * @param is_static true to mark transforms as static, false otherwise
+ */
+void
+TransformPublisher::send_transforms(const std::vector<StampedTransform> &transforms, bool is_static)
+{
+	if (!bb_) {
+		throw DisabledException("TransformPublisher is disabled");
+	}
+
+	MutexLocker lock(mutex_);
+
+	if (is_static) {
+		bool changed = false;
+		for (const StampedTransform &t : transforms) {
+			std::map<std::string, StampedTransform>::iterator st =
+			  static_transforms_.find(t.child_frame_id);
+			if (st == static_transforms_.end() || st->second.frame_id != t.frame_id
+			    || !(static_cast<const Transform &>(st->second) == static_cast<const Transform &>(t))) {
+				static_transforms_[t.child_frame_id] = t;
+				changed                              = true;
+			}
+		}
+		if (!changed)
+			return;
+
+		// one interface per segment, such that late readers get all of them
+		std::vector<StampedTransform> all;
+		for (const auto &st : static_transforms_) {
+			all.push_back(st.second);
+		}
+		size_t first = 0;
+		for (size_t segment = 0; first < all.size(); ++segment) {
+			if (segment >= static_batchifs_.size()) {
+				std::string id = bbid_ + "/static/" + std::to_string(segment);
+				static_batchifs_.push_back(bb_->open_for_writing<TransformBatchInterface>(id.c_str()));
+				static_batchifs_.back()->set_auto_timestamping(false);
+			}
+			first += write_batch(static_batchifs_[segment], all, first, true);
+		}
+	} else {
+		if (!batchif_) {
+			batchif_ = bb_->open_for_writing<TransformBatchInterface>(bbid_.c_str());
+			batchif_->set_auto_timestamping(false);
+		}
+		size_t first = 0;
+		while (first < transforms.size()) {
+			first += write_batch(batchif_, transforms, first, false);
+		}
+	}
+}
+
+/** Write a batch of transforms.
+ * Transforms are added starting at the given index until the interface
+ * is full or, for non-static transforms, the time stamp differs.
+ * @param iface interface to write to
+ * @param transforms transforms to write
+ * @param first index of first transform to write
+ * @param is_static true to mark transforms as static
+ * @return number of transforms written
+ */
+size_t
+TransformPublisher::write_batch(TransformBatchInterface *            iface,
+                                const std::vector<StampedTransform> &transforms,
+                                size_t                               first,
+                                bool                                 is_static)
+{
+	std::map<std::string, uint16_t> frame_indexes;
+	std::string                      frames;
+	fawkes::Time                     stamp = transforms[first].stamp;
+
+	size_t n = 0;
+	for (size_t i = first; i < transforms.size() && n < iface->maxlenof_child_frame(); ++i, ++n) {
+		const StampedTransform &t = transforms[i];
+		if (!is_static && t.stamp != stamp)
+			break;
+
+		std::string new_frames = frames;
+		uint16_t    ids[2];
+		const std::string *frame_ids[2] = {&t.frame_id, &t.child_frame_id};
+		for (unsigned int f = 0; f < 2; ++f) {
+			if (frame_ids[f]->find(' ') != std::string::npos) {
+				throw InvalidArgumentException("Frame ID '%s' contains a space", frame_ids[f]->c_str());
+			}
+			std::map<std::string, uint16_t>::iterator fi = frame_indexes.find(*frame_ids[f]);
+			if (fi != frame_indexes.end()) {
+				ids[f] = fi->second;
+			} else {
+				ids[f] = frame_indexes.size();
+				frame_indexes[*frame_ids[f]] = ids[f];
+				if (!new_frames.empty())
+					new_frames += " ";
+				new_frames += *frame_ids[f];
+			}
+		}
+		if (new_frames.size() >= iface->maxlenof_frames()) {
+			if (n == 0) {
+				throw InvalidArgumentException("Frame IDs of %s too long for batch",
+				                               t.child_frame_id.c_str());
+			}
+			break;
+		}
+		frames = new_frames;
+		if (is_static && stamp < t.stamp)
+			stamp = t.stamp;
+
+		const Vector3 &tr = t.getOrigin();
+		Quaternion     r  = t.getRotation();
+		assert_quaternion_valid(r);
+		iface->set_frame(n, ids[0]);
+		iface->set_child_frame(n, ids[1]);
+		iface->set_translation(3 * n, tr.x());
+		iface->set_translation(3 * n + 1, tr.y());
+		iface->set_translation(3 * n + 2, tr.z());
+		iface->set_rotation(4 * n, r.x());
+		iface->set_rotation(4 * n + 1, r.y());
+		iface->set_rotation(4 * n + 2, r.z());
+		iface->set_rotation(4 * n + 3, r.w());
+	}
+
+	iface->set_timestamp(&stamp);
+	iface->set_num_transforms(n);
+	iface->set_frames(frames.c_str());
+	iface->set_static_transform(is_static);
+	iface->write();
+	return n;
+}
+
 } // end namespace tf
 } // end namespace fawkes
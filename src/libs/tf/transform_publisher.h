@@ -55,10 +55,15 @@
 #include <tf/types.h>
 #include <utils/time/time.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace fawkes {
 
 class BlackBoard;
 class TransformInterface;
+class TransformBatchInterface;
 class Mutex;
 
 namespace tf {
@@ -81,10 +86,24 @@ public:
 		send_transform(StampedTransform(transform, time, frame, child_frame), is_static);
 	}
 
+	virtual void send_transforms(const std::vector<StampedTransform> &transforms,
+	                             const bool                           is_static = false);
+
+private:
+	size_t write_batch(TransformBatchInterface *            iface,
+	                   const std::vector<StampedTransform> &transforms,
+	                   size_t                               first,
+	                   bool                                 is_static);
+
 private:
 	BlackBoard *        bb_;
+	std::string         bbid_;
 	TransformInterface *tfif_;
 	Mutex *             mutex_;
+
+	TransformBatchInterface *               batchif_;
+	std::vector<TransformBatchInterface *>  static_batchifs_;
+	std::map<std::string, StampedTransform> static_transforms_;
 };
 
 } // end namespace tf
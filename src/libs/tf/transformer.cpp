@@ -131,8 +131,8 @@ Transformer::get_cache_time() const
 }
 
 /** Lock transformer.
- * No new transforms can be added and no lookups can be performed
- * while the lock is held.
+ * No new transforms can be added while the lock is held. Lookups
+ * are not blocked, they operate on a snapshot of the frame table.
  */
 void
 Transformer::lock()
@@ -165,9 +165,7 @@ Transformer::unlock()
 bool
 Transformer::frame_exists(const std::string &frame_id_str) const
 {
-	std::unique_lock<std::mutex> lock(frame_mutex_);
-
-	return (frameIDs_.count(frame_id_str) > 0);
+	return (frame_table().frame_ids.count(frame_id_str) > 0);
 }
 
 /** Get cache for specific frame.
@@ -186,7 +184,7 @@ Transformer::get_frame_cache(const std::string &frame_id) const
 std::vector<TimeCacheInterfacePtr>
 Transformer::get_frame_caches() const
 {
-	return frames_;
+	return frame_table().frames;
 }
 
 /** Get mappings from frame ID to names.
@@ -195,7 +193,7 @@ Transformer::get_frame_caches() const
 std::vector<std::string>
 Transformer::get_frame_id_mappings() const
 {
-	return frameIDs_reverse;
+	return frame_table().frame_ids_reverse;
 }
 
 /** Test if a transform is possible.
@@ -313,6 +311,37 @@ Transformer::lookup_transform(const std::string & target_frame,
 	  stripped_target, target_time, stripped_source, source_time, fixed_frame, transform);
 }
 
+/** Lookup transforms for multiple points in time.
+ * The tree is walked only once, see BufferCore::lookup_transforms().
+ * @param target_frame target frame ID
+ * @param source_frame source frame ID
+ * @param times times for which to get the transforms, a time of (0,0)
+ * denotes the latest common time
+ * @param transforms upon return contains one transform per time
+ * @exception ConnectivityException thrown if no connection between
+ * the source and target frame could be found in the tree.
+ * @exception ExtrapolationException returning a value would have
+ * required extrapolation beyond current limits.
+ * @exception LookupException at least one of the two given frames is
+ * unknown
+ * @exception DisabledException thrown if the transformer has been disabled
+ */
+void
+Transformer::lookup_transforms(const std::string &              target_frame,
+                               const std::string &              source_frame,
+                               const std::vector<fawkes::Time> &times,
+                               std::vector<StampedTransform> &  transforms) const
+{
+	if (!enabled_) {
+		throw DisabledException("Transformer has been disabled");
+	}
+
+	std::string stripped_target = strip_slash(target_frame);
+	std::string stripped_source = strip_slash(source_frame);
+
+	BufferCore::lookup_transforms(stripped_target, stripped_source, times, transforms);
+}
+
 /** Lookup transform at latest common time.
  * @param target_frame target frame ID
  * @param source_frame source frame ID
@@ -636,6 +665,7 @@ std::string
 Transformer::all_frames_as_dot(bool print_time, fawkes::Time *time) const
 {
 	std::unique_lock<std::mutex> lock(frame_mutex_);
+	const FrameTable &           table = frame_table();
 
 	fawkes::Time current_time;
 	if (time)
@@ -653,14 +683,14 @@ Transformer::all_frames_as_dot(bool print_time, fawkes::Time *time) const
 
 	TransformStorage temp;
 
-	if (frames_.size() == 1)
+	if (table.frames.size() == 1)
 		mstream << "\"no tf data received\"";
 
 	mstream.precision(3);
 	mstream.setf(std::ios::fixed, std::ios::floatfield);
 
 	//  for (std::vector< TimeCache*>::iterator  it = frames_.begin(); it != frames_.end(); ++it)
-	for (unsigned int cnt = 1; cnt < frames_.size(); ++cnt) //one referenced for 0 is no frame
+	for (unsigned int cnt = 1; cnt < table.frames.size(); ++cnt) //one referenced for 0 is no frame
 	{
 		std::shared_ptr<TimeCacheInterface> cache = get_frame(cnt);
 		if (!cache)
@@ -683,9 +713,9 @@ Transformer::all_frames_as_dot(bool print_time, fawkes::Time *time) const
 			                          - cache->get_oldest_timestamp().in_sec()),
 			                         0.0001);
 
-			mstream << "\"" << frameIDs_reverse[frame_id_num] << "\""
+			mstream << "\"" << lookup_frame_string(frame_id_num) << "\""
 			        << " -> "
-			        << "\"" << frameIDs_reverse[cnt] << "\""
+			        << "\"" << table.frame_ids_reverse[cnt] << "\""
 			        << "[label=\"";
 
 			std::shared_ptr<StaticCache> static_cache = std::dynamic_pointer_cast<StaticCache>(cache);
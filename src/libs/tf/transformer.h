@@ -96,6 +96,11 @@ public:
 	                      const std::string &source_frame,
 	                      StampedTransform & transform) const;
 
+	void lookup_transforms(const std::string &              target_frame,
+	                       const std::string &              source_frame,
+	                       const std::vector<fawkes::Time> &times,
+	                       std::vector<StampedTransform> &  transforms) const;
+
 	bool can_transform(const std::string & target_frame,
 	                   const std::string & source_frame,
 	                   const fawkes::Time &time,
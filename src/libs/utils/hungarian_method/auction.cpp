@@ -0,0 +1,275 @@
+
+/***************************************************************************
+ *  auction.cpp - Auction algorithm for sparse assignment problems
+ *
+ *  Created: Thu Oct 15 08:13:44 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/software.h>
+#include <utils/hungarian_method/auction.h>
+#include <utils/hungarian_method/hungarian.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace fawkes {
+
+/** @class AuctionAssignment <utils/hungarian_method/auction.h>
+ * Auction algorithm for sparse assignment problems.
+ * The HungarianMethod requires a dense, square cost matrix. In data
+ * association, most pairs are impossible, e.g., because a cluster is far
+ * away from a track. The auction algorithm only considers the given edges
+ * between rows and columns, its run time grows with the number of edges
+ * instead of the square of the matrix size.
+ *
+ * Every row is assigned to exactly one column, there must not be more rows
+ * than columns. Columns are the objects the rows bid for, each bid raises
+ * the price of the column by the bidder's margin to its second best column.
+ * Costs are scaled internally such that the result is an optimal
+ * assignment. For square problems, epsilon scaling is used and, if warm
+ * start is enabled, the prices of the previous problem of the same size
+ * are used as starting point, which makes solving a slightly changed
+ * problem cheap.
+ *
+ * The solver keeps its storage, reuse it for a sequence of problems by
+ * calling init(), add_edge(), and solve() for each.
+ * @author agent
+ */
+
+/** Constructor. */
+AuctionAssignment::AuctionAssignment()
+: num_rows_(0), num_cols_(0), warm_start_(false), have_prices_(false)
+{
+}
+
+/** Initialize a new problem.
+ * Removes all edges of the previous problem.
+ * @param rows number of rows, i.e., bidders
+ * @param cols number of columns, i.e., objects, must be at least @p rows
+ */
+void
+AuctionAssignment::init(int rows, int cols)
+{
+	if (rows != num_rows_ || cols != num_cols_) {
+		have_prices_ = false;
+	}
+	num_rows_ = rows;
+	num_cols_ = cols;
+	edge_rows_.clear();
+	edge_cols_.clear();
+	edge_costs_.clear();
+	col_mates_.assign(rows, -1);
+	row_mates_.assign(cols, -1);
+}
+
+/** Add possible assignment.
+ * @param row row index
+ * @param col column index
+ * @param cost cost of assigning @p row to @p col
+ * @exception OutOfBoundsException thrown if row or column are out of bounds
+ */
+void
+AuctionAssignment::add_edge(int row, int col, int cost)
+{
+	if (row < 0 || row >= num_rows_) {
+		throw OutOfBoundsException("Auction row out of bounds", row, 0, num_rows_ - 1);
+	}
+	if (col < 0 || col >= num_cols_) {
+		throw OutOfBoundsException("Auction column out of bounds", col, 0, num_cols_ - 1);
+	}
+	edge_rows_.push_back(row);
+	edge_cols_.push_back(col);
+	edge_costs_.push_back(cost);
+}
+
+/** Enable or disable warm start.
+ * @param warm_start true to start from the prices of the previous problem,
+ * if it has the same size and is square
+ */
+void
+AuctionAssignment::set_warm_start(bool warm_start)
+{
+	warm_start_ = warm_start;
+}
+
+/** Sort edges by row. */
+void
+AuctionAssignment::build_rows()
+{
+	row_start_.assign(num_rows_ + 1, 0);
+	for (int r : edge_rows_) {
+		row_start_[r + 1] += 1;
+	}
+	for (int r = 0; r < num_rows_; ++r) {
+		row_start_[r + 1] += row_start_[r];
+	}
+	row_cols_.resize(edge_cols_.size());
+	row_benefits_.resize(edge_cols_.size());
+	unassigned_.assign(row_start_.begin(), row_start_.end() - 1);
+	for (size_t e = 0; e < edge_rows_.size(); ++e) {
+		int pos            = unassigned_[edge_rows_[e]]++;
+		row_cols_[pos]     = edge_cols_[e];
+		row_benefits_[pos] = edge_costs_[e];
+	}
+}
+
+/** Run one auction.
+ * @param epsilon minimum bid increment
+ * @param price_limit maximum price, exceeding it means there is no
+ * complete assignment
+ * @param spread bid margin of a row with a single column
+ * @return true if all rows have been assigned
+ */
+bool
+AuctionAssignment::run_auction(int64_t epsilon, int64_t price_limit, int64_t spread)
+{
+	std::fill(col_mates_.begin(), col_mates_.end(), -1);
+	std::fill(row_mates_.begin(), row_mates_.end(), -1);
+	unassigned_.clear();
+	for (int r = num_rows_ - 1; r >= 0; --r) {
+		unassigned_.push_back(r);
+	}
+
+	while (!unassigned_.empty()) {
+		int row = unassigned_.back();
+		unassigned_.pop_back();
+
+		int64_t best = INT64_MIN, second = INT64_MIN;
+		int     best_col = -1;
+		for (int e = row_start_[row]; e < row_start_[row + 1]; ++e) {
+			int64_t v = row_benefits_[e] - prices_[row_cols_[e]];
+			if (v > best) {
+				second   = best;
+				best     = v;
+				best_col = row_cols_[e];
+			} else if (v > second) {
+				second = v;
+			}
+		}
+		if (best_col < 0) {
+			return false;
+		}
+
+		prices_[best_col] += ((second == INT64_MIN) ? spread : best - second) + epsilon;
+		if (prices_[best_col] > price_limit) {
+			return false;
+		}
+		int prev = row_mates_[best_col];
+		if (prev >= 0) {
+			col_mates_[prev] = -1;
+			unassigned_.push_back(prev);
+		}
+		row_mates_[best_col] = row;
+		col_mates_[row]      = best_col;
+	}
+	return true;
+}
+
+/** Solve the assignment problem.
+ * @param mode One of HUNGARIAN_MODE_MINIMIZE_COST and HUNGARIAN_MODE_MAXIMIZE_UTIL
+ * @return true if an assignment of all rows has been found, false if
+ * there is none given the edges
+ */
+bool
+AuctionAssignment::solve(int mode)
+{
+	if (num_rows_ > num_cols_) {
+		return false;
+	}
+	if (num_rows_ == 0) {
+		return true;
+	}
+
+	// scale such that epsilon 1 is below the cost resolution of 1/rows
+	build_rows();
+	const int64_t scale   = num_rows_ + 1;
+	int64_t       max_abs = 0;
+	for (int64_t &b : row_benefits_) {
+		b       = (mode == HUNGARIAN_MODE_MAXIMIZE_UTIL ? b : -b) * scale;
+		max_abs = std::max(max_abs, std::abs(b));
+	}
+	const int64_t spread = 2 * max_abs + 1;
+
+	// without reverse auction, epsilon scaling and warm start would leave
+	// unassigned columns with too high prices in non-square problems
+	const bool square  = num_rows_ == num_cols_;
+	int64_t    epsilon = 1;
+	if (!(warm_start_ && have_prices_ && square)) {
+		prices_.assign(num_cols_, 0);
+		if (square) {
+			epsilon = std::max<int64_t>(1, max_abs / 4);
+		}
+	}
+	while (true) {
+		// prices only exceed this if there is no complete assignment
+		const int64_t price_limit = *std::max_element(prices_.begin(), prices_.end())
+		                            + (2 * (int64_t)num_rows_ + 2) * (spread + epsilon);
+		if (!run_auction(epsilon, price_limit, spread)) {
+			std::fill(col_mates_.begin(), col_mates_.end(), -1);
+			std::fill(row_mates_.begin(), row_mates_.end(), -1);
+			have_prices_ = false;
+			return false;
+		}
+		if (epsilon == 1) {
+			break;
+		}
+		epsilon = std::max<int64_t>(1, epsilon / 4);
+	}
+
+	// all columns are assigned, shifting prices keeps them from growing
+	// over a sequence of warm started problems
+	if (square) {
+		const int64_t min_price = *std::min_element(prices_.begin(), prices_.end());
+		for (int64_t &price : prices_) {
+			price -= min_price;
+		}
+	}
+	have_prices_ = true;
+	return true;
+}
+
+/** Get column assignment.
+ * @param row row index
+ * @return column assigned to @p row, or -1 if @p row is out of bounds or
+ * no assignment has been found
+ */
+int
+AuctionAssignment::get_column_assignment(int row) const
+{
+	if (row < 0 || row >= (int)col_mates_.size()) {
+		return -1;
+	}
+	return col_mates_[row];
+}
+
+/** Get row assignment.
+ * @param col column index
+ * @return row assigned to @p col, or -1 if @p col is out of bounds or
+ * the column has not been assigned
+ */
+int
+AuctionAssignment::get_row_assignment(int col) const
+{
+	if (col < 0 || col >= (int)row_mates_.size()) {
+		return -1;
+	}
+	return row_mates_[col];
+}
+
+} // end namespace fawkes
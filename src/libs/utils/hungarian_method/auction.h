@@ -0,0 +1,70 @@
+
+/***************************************************************************
+ *  auction.h - Auction algorithm for sparse assignment problems
+ *
+ *  Created: Thu Oct 15 08:13:44 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_HUNGARIAN_METHOD_AUCTION_H_
+#define _UTILS_HUNGARIAN_METHOD_AUCTION_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace fawkes {
+
+class AuctionAssignment
+{
+public:
+	AuctionAssignment();
+
+	void init(int rows, int cols);
+	void add_edge(int row, int col, int cost);
+
+	void set_warm_start(bool warm_start);
+	bool solve(int mode);
+
+	int get_column_assignment(int row) const;
+	int get_row_assignment(int col) const;
+
+private:
+	void build_rows();
+	bool run_auction(int64_t epsilon, int64_t price_limit, int64_t spread);
+
+	int  num_rows_;
+	int  num_cols_;
+	bool warm_start_;
+	bool have_prices_;
+
+	std::vector<int>     edge_rows_;
+	std::vector<int>     edge_cols_;
+	std::vector<int>     edge_costs_;
+	std::vector<int>     row_start_;
+	std::vector<int>     row_cols_;
+	std::vector<int64_t> row_benefits_;
+
+	std::vector<int64_t> prices_;
+	std::vector<int>     col_mates_;
+	std::vector<int>     row_mates_;
+	std::vector<int>     unassigned_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -45,16 +45,42 @@ namespace fawkes {
 
 /** @class HungarianMethod <utils/hungarian_method/hungarian.h>
  * Hungarian method assignment solver.
+ * The object can be reused for a sequence of problems, e.g., to associate
+ * observations in every loop. Call init() and solve() for each problem, the
+ * matrices and work buffers are only allocated if the problem is larger than
+ * any before, use reserve() to allocate them upfront. free() releases the
+ * memory and is only required to give it back early.
+ *
+ * If warm start is enabled, solve() first tries to keep the assignment of
+ * the previous problem of the same size. Rows are only re-assigned if their
+ * previous column is no longer among their cheapest ones, which saves most
+ * of the augmentation steps when costs change only slightly.
  * @author Stefan Schiffer
  */
 
+/** Number of work buffers required by solve(). */
+#define HUNGARIAN_NUM_WORK_BUFFERS 8
+
 /** Constructor. */
 HungarianMethod::HungarianMethod()
 {
-	p          = (hungarian_problem_t *)malloc(sizeof(hungarian_problem_t));
-	num_cols_  = 0;
-	num_rows_  = 0;
-	available_ = false;
+	p                = (hungarian_problem_t *)malloc(sizeof(hungarian_problem_t));
+	p->num_rows      = 0;
+	p->num_cols      = 0;
+	p->cost          = NULL;
+	p->assignment    = NULL;
+	num_cols_        = 0;
+	num_rows_        = 0;
+	available_       = false;
+	col_mates_       = NULL;
+	row_mates_       = NULL;
+	capacity_        = 0;
+	cost_data_       = NULL;
+	assignment_data_ = NULL;
+	work_            = NULL;
+	prev_col_mates_  = NULL;
+	prev_size_       = 0;
+	warm_start_      = false;
 }
 
 /** Destructor. */
@@ -64,6 +90,46 @@ HungarianMethod::~HungarianMethod()
 	::free(p);
 }
 
+/** Reserve memory for problems up to the given size.
+ * @param size number of rows and columns of the largest expected problem
+ */
+void
+HungarianMethod::reserve(int size)
+{
+	if (size <= capacity_) {
+		return;
+	}
+	release();
+
+	capacity_ = size;
+	p->cost   = (int **)calloc(size, sizeof(int *));
+	hungarian_test_alloc(p->cost);
+	p->assignment = (int **)calloc(size, sizeof(int *));
+	hungarian_test_alloc(p->assignment);
+	cost_data_ = (int *)calloc((size_t)size * size, sizeof(int));
+	hungarian_test_alloc(cost_data_);
+	assignment_data_ = (int *)calloc((size_t)size * size, sizeof(int));
+	hungarian_test_alloc(assignment_data_);
+	col_mates_ = (int *)calloc(size, sizeof(int));
+	hungarian_test_alloc(col_mates_);
+	row_mates_ = (int *)calloc(size, sizeof(int));
+	hungarian_test_alloc(row_mates_);
+	prev_col_mates_ = (int *)calloc(size, sizeof(int));
+	hungarian_test_alloc(prev_col_mates_);
+	work_ = (int *)calloc((size_t)size * HUNGARIAN_NUM_WORK_BUFFERS, sizeof(int));
+	hungarian_test_alloc(work_);
+}
+
+/** Enable or disable warm start.
+ * @param warm_start true to start from the previous assignment, if the
+ * problem has the same size as the previous one
+ */
+void
+HungarianMethod::set_warm_start(bool warm_start)
+{
+	warm_start_ = warm_start;
+}
+
 /** Print matrix to stdout.
  * @param C values
  * @param rows number of rows
@@ -160,20 +226,19 @@ HungarianMethod::init(int **cost_matrix, int rows, int cols, int mode)
 	rows = std::max(cols, rows);
 	cols = rows;
 
+	reserve(rows);
+	if (rows != prev_size_) {
+		prev_size_ = 0;
+	}
+
 	p->num_rows = rows;
 	p->num_cols = cols;
 
-	p->cost = (int **)calloc(rows, sizeof(int *));
-	hungarian_test_alloc(p->cost);
-	p->assignment = (int **)calloc(rows, sizeof(int *));
-	hungarian_test_alloc(p->assignment);
-
 	//std::cout << "HungarianMethod(init): loop rows" << std::endl;
 	for (i = 0; i < p->num_rows; i++) {
-		p->cost[i] = (int *)calloc(cols, sizeof(int));
-		hungarian_test_alloc(p->cost[i]);
-		p->assignment[i] = (int *)calloc(cols, sizeof(int));
-		hungarian_test_alloc(p->assignment[i]);
+		// rows are stored contiguously
+		p->cost[i]       = cost_data_ + (size_t)i * cols;
+		p->assignment[i] = assignment_data_ + (size_t)i * cols;
 		for (j = 0; j < p->num_cols; j++) {
 			p->cost[i][j]       = (i < org_rows && j < org_cols) ? cost_matrix[i][j] : 0;
 			p->assignment[i][j] = 0;
@@ -199,46 +264,60 @@ HungarianMethod::init(int **cost_matrix, int rows, int cols, int mode)
 	// /////////////////////////////////////
 	//std::cout << "HungarianMethod(init): init assignment save" << std::endl;
 	//
-	num_cols_  = cols;
-	col_mates_ = (int *)calloc(cols, sizeof(int));
-	hungarian_test_alloc(col_mates_);
+	num_cols_ = cols;
 	for (int j = 0; j < num_cols_; ++j) {
 		col_mates_[j] = -1;
 	}
 	//
-	num_rows_  = rows;
-	row_mates_ = (int *)calloc(rows, sizeof(int));
-	hungarian_test_alloc(row_mates_);
+	num_rows_ = rows;
 	for (int i = 0; i < num_rows_; ++i) {
 		row_mates_[i] = -1;
 	}
 	// /////////////////////////////////////
 
+	available_ = false;
 	//   std::cout << "HungarianMethod(init): ... leaving." << std::endl;
 	return rows;
 }
 
-/** Free space alloacted by method. */
+/** Free space alloacted by method.
+ * This also drops the assignment used for warm start.
+ */
 void
 HungarianMethod::free()
 {
 	//   std::cout << "HungarianMethod(free): entering ..." << std::endl;
-	int i;
-	for (i = 0; i < p->num_rows; i++) {
-		::free(p->cost[i]);
-		::free(p->assignment[i]);
-	}
+	release();
+	available_ = false;
+	//   std::cout << "HungarianMethod(free): ... leaving." << std::endl;
+}
+
+/** Release all allocated memory. */
+void
+HungarianMethod::release()
+{
 	::free(p->cost);
 	::free(p->assignment);
-	p->cost       = NULL;
-	p->assignment = NULL;
-	//
-	num_cols_ = 0;
-	num_rows_ = 0;
+	::free(cost_data_);
+	::free(assignment_data_);
 	::free(col_mates_);
 	::free(row_mates_);
-	available_ = false;
-	//   std::cout << "HungarianMethod(free): ... leaving." << std::endl;
+	::free(prev_col_mates_);
+	::free(work_);
+	p->cost          = NULL;
+	p->assignment    = NULL;
+	p->num_rows      = 0;
+	p->num_cols      = 0;
+	cost_data_       = NULL;
+	assignment_data_ = NULL;
+	col_mates_       = NULL;
+	row_mates_       = NULL;
+	prev_col_mates_  = NULL;
+	work_            = NULL;
+	num_cols_        = 0;
+	num_rows_        = 0;
+	capacity_        = 0;
+	prev_size_       = 0;
 }
 
 /** Solve the assignment problem.
@@ -261,23 +340,15 @@ HungarianMethod::solve()
 	m    = p->num_rows;
 	n    = p->num_cols;
 
-	col_mate = (int *)calloc(p->num_rows, sizeof(int));
-	hungarian_test_alloc(col_mate);
-	unchosen_row = (int *)calloc(p->num_rows, sizeof(int));
-	hungarian_test_alloc(unchosen_row);
-	row_dec = (int *)calloc(p->num_rows, sizeof(int));
-	hungarian_test_alloc(row_dec);
-	slack_row = (int *)calloc(p->num_rows, sizeof(int));
-	hungarian_test_alloc(slack_row);
-
-	row_mate = (int *)calloc(p->num_cols, sizeof(int));
-	hungarian_test_alloc(row_mate);
-	parent_row = (int *)calloc(p->num_cols, sizeof(int));
-	hungarian_test_alloc(parent_row);
-	col_inc = (int *)calloc(p->num_cols, sizeof(int));
-	hungarian_test_alloc(col_inc);
-	slack = (int *)calloc(p->num_cols, sizeof(int));
-	hungarian_test_alloc(slack);
+	// the matrix is square, all work buffers have the same size
+	col_mate     = work_;
+	unchosen_row = work_ + m;
+	row_dec      = work_ + 2 * m;
+	slack_row    = work_ + 3 * m;
+	row_mate     = work_ + 4 * m;
+	parent_row   = work_ + 5 * m;
+	col_inc      = work_ + 6 * m;
+	slack        = work_ + 7 * m;
 
 	for (i = 0; i < p->num_rows; i++) {
 		col_mate[i]     = 0;
@@ -324,7 +395,23 @@ HungarianMethod::solve()
 		for (l = 1; l < n; l++)
 			if (p->cost[k][l] < s)
 				s = p->cost[k][l];
-		row_dec[k] = s;
+		row_dec[k]  = s;
+		col_mate[k] = -1;
+	}
+	if (warm_start_ && prev_size_ == m) {
+		// keep previous assignments which are still on a row minimum
+		for (k = 0; k < m; k++) {
+			l = prev_col_mates_[k];
+			if (l >= 0 && l < n && p->cost[k][l] == row_dec[k] && row_mate[l] < 0) {
+				col_mate[k] = l;
+				row_mate[l] = k;
+			}
+		}
+	}
+	for (k = 0; k < m; k++) {
+		if (col_mate[k] >= 0)
+			continue;
+		s = row_dec[k];
 		for (l = 0; l < n; l++)
 			if (s == p->cost[k][l] && row_mate[l] < 0) {
 				col_mate[k] = l;
@@ -509,19 +596,12 @@ done:
 		row_mates_[i] = row_mate[i];
 	}
 	for (int j = 0; j < num_cols_; ++j) {
-		col_mates_[j] = col_mate[j];
+		col_mates_[j]      = col_mate[j];
+		prev_col_mates_[j] = col_mate[j];
 	}
+	prev_size_ = m;
 	// /////////////////////////////////////
 
-	::free(slack);
-	::free(col_inc);
-	::free(parent_row);
-	::free(row_mate);
-	::free(slack_row);
-	::free(row_dec);
-	::free(unchosen_row);
-	::free(col_mate);
-
 	available_ = true;
 }
 
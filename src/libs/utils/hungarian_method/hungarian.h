@@ -52,8 +52,10 @@ public:
 
 	int init(int **cost_matrix, int rows, int cols, int mode);
 
+	void reserve(int size);
 	void free();
 
+	void set_warm_start(bool warm_start);
 	void solve();
 
 	bool is_available();
@@ -75,12 +77,22 @@ protected:
 	void print_matrix(int **C, int rows, int cols);
 
 private:
+	void release();
+
 	bool available_;
 	int  num_cols_;
 	int  num_rows_;
 
 	int *col_mates_;
 	int *row_mates_;
+
+	int  capacity_;
+	int *cost_data_;
+	int *assignment_data_;
+	int *work_;
+	int *prev_col_mates_;
+	int  prev_size_;
+	bool warm_start_;
 };
 
 } // end namespace fawkes
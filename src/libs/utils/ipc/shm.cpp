@@ -28,6 +28,7 @@
 #include <utils/ipc/shm_exceptions.h>
 #include <utils/ipc/shm_lister.h>
 #include <utils/ipc/shm_registry.h>
+#include <utils/system/memory_placement.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -114,6 +115,21 @@ namespace fawkes {
  * false otherwise
  */
 
+/** Get name of the segment.
+ * The name is recorded in the shared memory registry when the segment is
+ * created or opened. Lookups only attach to segments with the same name
+ * (or without a name) to check them with matches(). Return NULL if the
+ * header does not identify a specific segment, for example when listing
+ * all segments of a kind. The default implementation returns NULL, which
+ * means that all segments with the same magic token are checked.
+ * @return name of the segment, or NULL
+ */
+const char *
+SharedMemoryHeader::segment_name() const
+{
+	return NULL;
+}
+
 /** @class SharedMemory <utils/ipc/shm.h>
  * Shared memory segment.
  * This class gives access to shared memory segment to store arbitrary data.
@@ -220,6 +236,12 @@ const unsigned int SharedMemory::MagicTokenSize = MAGIC_TOKEN_SIZE;
  */
 const short SharedMemory::MaxNumConcurrentReaders = 8;
 
+/// @cond INTERNALS
+size_t SharedMemory::huge_page_threshold_ = 4 * 1024 * 1024;
+int    SharedMemory::default_numa_node_   = MemoryPlacement::NUMA_NODE_NONE;
+bool   SharedMemory::lock_created_        = false;
+/// @endcond
+
 #define WRITE_MUTEX_SEM 0
 #define READ_SEM 1
 
@@ -305,18 +327,23 @@ SharedMemory::SharedMemory(const SharedMemory &s)
 		registry_name_ = NULL;
 	}
 
+	// attach() looks up and registers segments in the registry
+	shm_registry_ = new SharedMemoryRegistry(registry_name_);
+
 	try {
 		attach();
 	} catch (Exception &e) {
+		delete shm_registry_;
+		shm_registry_ = NULL;
 		e.append("SharedMemory public copy constructor");
 		throw;
 	}
 
 	if (_memptr == NULL) {
+		delete shm_registry_;
+		shm_registry_ = NULL;
 		throw ShmCouldNotAttachException("Could not attach to created shared memory segment");
 	}
-
-	shm_registry_ = new SharedMemoryRegistry(registry_name_);
 }
 
 /** Create a new shared memory segment.
@@ -379,18 +406,23 @@ SharedMemory::SharedMemory(const char *        magic_token,
 		registry_name_ = strdup(registry_name);
 	}
 
+	// attach() looks up and registers segments in the registry
+	shm_registry_ = new SharedMemoryRegistry(registry_name_);
+
 	try {
 		attach();
 	} catch (Exception &e) {
+		delete shm_registry_;
+		shm_registry_ = NULL;
 		e.append("SharedMemory public constructor");
 		throw;
 	}
 
 	if (_memptr == NULL) {
+		delete shm_registry_;
+		shm_registry_ = NULL;
 		throw ShmCouldNotAttachException("Could not attach to created shared memory segment");
 	}
-
-	shm_registry_ = new SharedMemoryRegistry(registry_name_);
 }
 
 /** Destructor */
@@ -462,19 +494,24 @@ SharedMemory::operator=(const SharedMemory &s)
 		registry_name_ = NULL;
 	}
 
+	// attach() looks up and registers segments in the registry
+	shm_registry_ = new SharedMemoryRegistry(registry_name_);
+
 	try {
 		attach();
 	} catch (Exception &e) {
+		delete shm_registry_;
+		shm_registry_ = NULL;
 		e.append("SharedMemory public copy constructor");
 		throw;
 	}
 
 	if (_memptr == NULL) {
+		delete shm_registry_;
+		shm_registry_ = NULL;
 		throw ShmCouldNotAttachException("Could not attach to created shared memory segment");
 	}
 
-	shm_registry_ = new SharedMemoryRegistry(registry_name_);
-
 	return *this;
 }
 
@@ -522,7 +559,7 @@ SharedMemory::attach()
 	}
 
 	std::list<SharedMemoryRegistry::SharedMemID> segments =
-	  shm_registry_->find_segments(_magic_token);
+	  shm_registry_->find_segments(_magic_token, _header->segment_name());
 
 	std::list<SharedMemoryRegistry::SharedMemID>::iterator s;
 
@@ -578,13 +615,31 @@ SharedMemory::attach()
 
 		_data_size = _header->data_size();
 		_mem_size  = sizeof(SharedMemory_header_t) + MagicTokenSize + _header->size() + _data_size;
+		bool huge_pages  = (huge_page_threshold_ > 0) && (_mem_size >= huge_page_threshold_);
+		bool use_hugetlb = false;
+#ifdef SHM_HUGETLB
+		use_hugetlb = huge_pages;
+#endif
 		while ((_memptr == NULL) && (key < INT_MAX)) {
 			// no shm segment found, create one
-			shared_mem_id_ = shmget(key, _mem_size, IPC_CREAT | IPC_EXCL | 0666);
+			int shmflg = IPC_CREAT | IPC_EXCL | 0666;
+#ifdef SHM_HUGETLB
+			if (use_hugetlb)
+				shmflg |= SHM_HUGETLB;
+#endif
+			shared_mem_id_ = shmget(key, _mem_size, shmflg);
 			if (shared_mem_id_ != -1) {
 				shared_mem_ = shmat(shared_mem_id_, NULL, 0);
 				if (shared_mem_ != (void *)-1) {
+					// place memory before touching it for the first time
+					if (huge_pages && !use_hugetlb) {
+						MemoryPlacement::advise_huge_pages(shared_mem_, _mem_size);
+					}
+					MemoryPlacement::bind_numa_node(shared_mem_, _mem_size, default_numa_node_);
 					memset(shared_mem_, 0, _mem_size);
+					if (lock_created_) {
+						set_swapable(false);
+					}
 
 					_shm_magic_token      = (char *)shared_mem_;
 					_shm_header           = (SharedMemory_header_t *)((char *)shared_mem_ + MagicTokenSize);
@@ -610,6 +665,11 @@ SharedMemory::attach()
 					// note: we don't care about existing shared memory regions as we scanned
 					// them before already!
 					++key;
+#ifdef SHM_HUGETLB
+				} else if (use_hugetlb) {
+					// no huge pages available or not permitted, use normal pages
+					use_hugetlb = false;
+#endif
 				} else if (errno == EINVAL) {
 					throw ShmCouldNotAttachException("Could not attach, segment too small or too big");
 				} else {
@@ -624,7 +684,7 @@ SharedMemory::attach()
 	}
 
 	try {
-		shm_registry_->add_segment(shared_mem_id_, _magic_token);
+		shm_registry_->add_segment(shared_mem_id_, _magic_token, _header->segment_name(), _mem_size);
 	} catch (Exception &e) {
 		free();
 		throw;
@@ -885,19 +945,49 @@ SharedMemory::add_semaphore()
  * portions of memory. A resource limit is implied (see getrlimit(2)). In
  * most cases the maximum amout of locked memory is about 32 KB.
  * @param swapable set to true, if memory should be allowed to be swaped out.
+ * @return true if the segment has been locked or unlocked, false otherwise,
+ * for example if the resource limit has been exceeded
  */
-void
+bool
 SharedMemory::set_swapable(bool swapable)
 {
-#ifdef USE_MISC_
-	if (swapable) {
-		shmctl(shared_mem_id_, SHM_UNLOCK, NULL);
-	} else {
-		shmctl(shared_mem_id_, SHM_LOCK, NULL);
-	}
+#ifdef SHM_LOCK
+	return (shmctl(shared_mem_id_, swapable ? SHM_UNLOCK : SHM_LOCK, NULL) == 0);
+#else
+	return false;
 #endif
 }
 
+/** Advise transparent huge pages for the segment.
+ * Segments created at or above the huge page threshold already use huge
+ * pages. This can be used to request them for other segments, e.g. by
+ * a process which opened an existing segment.
+ * @return true if the advice was accepted, false otherwise
+ * @see MemoryPlacement::advise_huge_pages()
+ */
+bool
+SharedMemory::advise_huge_pages()
+{
+	if (shared_mem_ == NULL)
+		return false;
+	return MemoryPlacement::advise_huge_pages(shared_mem_, _mem_size);
+}
+
+/** Bind the segment to a NUMA node.
+ * Pages already allocated on another node are migrated if possible. Call
+ * this from the thread which mostly processes the data, e.g. a consumer
+ * of image buffers, with MemoryPlacement::NUMA_NODE_LOCAL.
+ * @param node NUMA node, or one of the special values of MemoryPlacement
+ * @return true if the segment has been bound, false otherwise
+ */
+bool
+SharedMemory::bind_numa_node(int node)
+{
+	if (shared_mem_ == NULL)
+		return false;
+	return MemoryPlacement::bind_numa_node(shared_mem_, _mem_size, node);
+}
+
 /** Lock shared memory segment for reading.
  * If the shared memory segment is protected by an associated semaphore it can be
  * locked with this semaphore by calling this method.
@@ -1072,7 +1162,7 @@ SharedMemory::is_destroyed(int shm_id)
 bool
 SharedMemory::is_swapable(int shm_id)
 {
-#ifdef USE_MISC_
+#ifdef SHM_LOCKED
 	struct shmid_ds  shm_segment;
 	struct ipc_perm *perm = &shm_segment.shm_perm;
 
@@ -1102,6 +1192,71 @@ SharedMemory::num_attached(int shm_id)
 	}
 }
 
+/** Set minimum size of segments to create with huge pages.
+ * Segments of at least this size, for example large image buffers, are
+ * created with huge pages where supported. This reduces TLB misses when
+ * processing the data. If no explicit huge pages are available, or the
+ * process is not permitted to use them, the segment is created with
+ * normal pages and transparent huge pages are requested instead.
+ * Huge pages are never swapped. The default is 4 MB.
+ * @param bytes minimum size of segments in bytes, 0 to disable huge pages
+ */
+void
+SharedMemory::set_huge_page_threshold(size_t bytes)
+{
+	huge_page_threshold_ = bytes;
+}
+
+/** Get minimum size of segments to create with huge pages.
+ * @return minimum size of segments in bytes, 0 if disabled
+ */
+size_t
+SharedMemory::huge_page_threshold()
+{
+	return huge_page_threshold_;
+}
+
+/** Set NUMA node for newly created segments.
+ * The memory of segments created afterwards by this process is placed on
+ * the given node. The default is MemoryPlacement::NUMA_NODE_NONE.
+ * @param node NUMA node, or one of the special values of MemoryPlacement
+ */
+void
+SharedMemory::set_default_numa_node(int node)
+{
+	default_numa_node_ = node;
+}
+
+/** Get NUMA node for newly created segments.
+ * @return NUMA node, or one of the special values of MemoryPlacement
+ */
+int
+SharedMemory::default_numa_node()
+{
+	return default_numa_node_;
+}
+
+/** Lock newly created segments in memory.
+ * If enabled, segments created afterwards by this process are made
+ * unswapable, see set_swapable(). This avoids page faults in real-time
+ * operation, but requires a sufficient resource limit for locked memory.
+ * @param lock true to lock new segments, false to leave them swapable
+ */
+void
+SharedMemory::set_lock_created(bool lock)
+{
+	lock_created_ = lock;
+}
+
+/** Check if newly created segments are locked in memory.
+ * @return true if new segments are locked, false otherwise
+ */
+bool
+SharedMemory::lock_created()
+{
+	return lock_created_;
+}
+
 /** List shared memory segments of a given type.
  * This method lists all shared memory segments that match the given magic
  * token (first MagicTokenSize bytes, filled with zero) and the given
@@ -1269,7 +1424,8 @@ SharedMemory::find(const char *magic_token, SharedMemoryHeader *header, const ch
 {
 	try {
 		SharedMemoryRegistry shm_registry(registry_name);
-		return SharedMemoryIterator(shm_registry.find_segments(magic_token), header);
+		return SharedMemoryIterator(shm_registry.find_segments(magic_token, header->segment_name()),
+		                            header);
 	} catch (Exception &e) {
 		return end();
 	}
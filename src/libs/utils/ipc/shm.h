@@ -44,6 +44,7 @@ public:
 	virtual size_t              data_size()                                   = 0;
 	virtual SharedMemoryHeader *clone() const                                 = 0;
 	virtual bool                operator==(const SharedMemoryHeader &s) const = 0;
+	virtual const char *        segment_name() const;
 };
 
 class SharedMemoryLister;
@@ -82,7 +83,9 @@ public:
 	void set(void *memptr);
 	void set_destroy_on_delete(bool destroy);
 	void add_semaphore();
-	void set_swapable(bool swapable);
+	bool set_swapable(bool swapable);
+	bool advise_huge_pages();
+	bool bind_numa_node(int node);
 
 	void lock_for_read();
 	bool try_lock_for_read();
@@ -115,6 +118,13 @@ public:
 	static bool         is_swapable(int shm_id);
 	static unsigned int num_attached(int shm_id);
 
+	static void   set_huge_page_threshold(size_t bytes);
+	static size_t huge_page_threshold();
+	static void   set_default_numa_node(int node);
+	static int    default_numa_node();
+	static void   set_lock_created(bool lock);
+	static bool   lock_created();
+
 	class SharedMemoryIterator
 	{
 	public:
@@ -193,6 +203,10 @@ protected:
 	long unsigned int      _shm_offset;
 
 private:
+	static size_t huge_page_threshold_;
+	static int    default_numa_node_;
+	static bool   lock_created_;
+
 	SharedMemoryRegistry *shm_registry_;
 	char *                registry_name_;
 
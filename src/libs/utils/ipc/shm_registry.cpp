@@ -30,6 +30,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <sched.h>
 #include <unistd.h>
 
 namespace fawkes {
@@ -48,6 +49,16 @@ namespace fawkes {
  * is created, it is registered to the registry so others can find
  * it. On destruction, it is unregistered from the registry.
  *
+ * Besides the magic token, the registry records the name and size of
+ * each segment, if provided when adding the segment. This serves as an
+ * index, segments can be found by name without attaching to all
+ * segments of a kind to check their header.
+ *
+ * Lookups do not take the lock. Modifications increment a version
+ * counter before and after changing entries, readers repeat the lookup
+ * if the version was odd or changed while reading (a sequence lock).
+ * Only if a writer keeps interfering readers fall back to the lock.
+ *
  * @author Tim Niemueller
  */
 
@@ -74,6 +85,17 @@ SharedMemoryRegistry::SharedMemoryRegistry(const char *name)
 
 	if ((shmfd_ < 0) && (errno == EEXIST)) {
 		shmfd_ = shm_open(shm_name_, O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+
+		struct stat st;
+		if ((shmfd_ >= 0) && (fstat(shmfd_, &st) == 0) && ((size_t)st.st_size < sizeof(MemInfo))) {
+			// created by an incompatible (older) version, mapping it would fail
+			close(shmfd_);
+			sem_post(sem_);
+			sem_close(sem_);
+			free(shm_name_);
+			throw Exception("Shared memory registry has incompatible size, "
+			                "clean up with SharedMemoryRegistry::cleanup()");
+		}
 	} else {
 		if (ftruncate(shmfd_, sizeof(MemInfo)) != 0) {
 			close(shmfd_);
@@ -105,7 +127,8 @@ SharedMemoryRegistry::SharedMemoryRegistry(const char *name)
 	}
 
 	if (created) {
-		memset(meminfo_, 0, sizeof(MemInfo));
+		memset((void *)meminfo_, 0, sizeof(MemInfo));
+		meminfo_->version.store(0);
 
 		for (unsigned int i = 0; i < MAXNUM_SHM_SEGMS; ++i) {
 			meminfo_->segments[i].shmid = -1;
@@ -139,59 +162,105 @@ SharedMemoryRegistry::cleanup(const char *name)
 	sem_unlink(name ? name : DEFAULT_SHM_NAME);
 }
 
-/** Get a snapshot of currently registered segments.
- * @return list of all currently registered segments
+/// @cond INTERNALS
+/** Collect matching entries without taking the lock.
+ * @param pred predicate which returns true for entries to collect
+ * @return consistent list of matching entries
  */
+template <typename Predicate>
 std::list<SharedMemoryRegistry::SharedMemID>
-SharedMemoryRegistry::get_snapshot() const
+SharedMemoryRegistry::collect(Predicate pred) const
 {
 	std::list<SharedMemID> rv;
 
-	sem_wait(sem_);
+	for (unsigned int tries = 0; tries < 100; ++tries) {
+		uint32_t version = meminfo_->version.load(std::memory_order_acquire);
+		if ((version & 1) == 0) {
+			for (unsigned int i = 0; i < MAXNUM_SHM_SEGMS; ++i) {
+				SharedMemID s = meminfo_->segments[i];
+				if (pred(s)) {
+					rv.push_back(s);
+				}
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (meminfo_->version.load(std::memory_order_relaxed) == version) {
+				return rv;
+			}
+			rv.clear();
+		}
+		sched_yield();
+	}
 
+	// writers keep interfering, wait for the lock
+	sem_wait(sem_);
 	for (unsigned int i = 0; i < MAXNUM_SHM_SEGMS; ++i) {
-		if (meminfo_->segments[i].shmid > 0) {
+		if (pred(meminfo_->segments[i])) {
 			rv.push_back(meminfo_->segments[i]);
 		}
 	}
-
 	sem_post(sem_);
 
 	return rv;
 }
 
+/** Start modification of entries.
+ * Acquires the lock and makes the version odd.
+ */
+void
+SharedMemoryRegistry::begin_write()
+{
+	sem_wait(sem_);
+	meminfo_->version.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+/** End modification of entries.
+ * Makes the version even and releases the lock.
+ */
+void
+SharedMemoryRegistry::end_write()
+{
+	meminfo_->version.fetch_add(1, std::memory_order_release);
+	sem_post(sem_);
+}
+/// @endcond
+
+/** Get a snapshot of currently registered segments.
+ * @return list of all currently registered segments
+ */
+std::list<SharedMemoryRegistry::SharedMemID>
+SharedMemoryRegistry::get_snapshot() const
+{
+	return collect([](const SharedMemID &s) { return s.shmid > 0; });
+}
+
 /** Find segments with particular magic token.
  * @param magic_token magic token to return IDs for
+ * @param name if not NULL only return segments with this name and
+ * segments which have been registered without a name
  * @return list of segments that currently exist with the given
  * magic token
  */
 std::list<SharedMemoryRegistry::SharedMemID>
-SharedMemoryRegistry::find_segments(const char *magic_token) const
+SharedMemoryRegistry::find_segments(const char *magic_token, const char *name) const
 {
-	std::list<SharedMemID> rv;
-
-	sem_wait(sem_);
-
-	for (unsigned int i = 0; i < MAXNUM_SHM_SEGMS; ++i) {
-		if ((meminfo_->segments[i].shmid > 0)
-		    && (strncmp(magic_token, meminfo_->segments[i].magic_token, MAGIC_TOKEN_SIZE) == 0)) {
-			rv.push_back(meminfo_->segments[i]);
-		}
-	}
-
-	sem_post(sem_);
-
-	return rv;
+	return collect([magic_token, name](const SharedMemID &s) {
+		return (s.shmid > 0) && (strncmp(magic_token, s.magic_token, MAGIC_TOKEN_SIZE) == 0)
+		       && (!name || s.name[0] == 0 || (strncmp(name, s.name, SEGMENT_NAME_SIZE) == 0));
+	});
 }
 
 /** Register a segment.
  * @param shmid shared memory ID of the SysV IPC segment
  * @param magic_token magic token for the new segment
+ * @param name name of the segment for lookups, e.g. the image ID,
+ * may be NULL if the segment has no name
+ * @param size size of the segment in bytes, 0 if unknown
  */
 void
-SharedMemoryRegistry::add_segment(int shmid, const char *magic_token)
+SharedMemoryRegistry::add_segment(int shmid, const char *magic_token, const char *name, size_t size)
 {
-	sem_wait(sem_);
+	begin_write();
 
 	bool valid = false;
 	for (unsigned int i = 0; i < MAXNUM_SHM_SEGMS; ++i) {
@@ -205,11 +274,17 @@ SharedMemoryRegistry::add_segment(int shmid, const char *magic_token)
 		if (meminfo_->segments[i].shmid == -1) {
 			meminfo_->segments[i].shmid = shmid;
 			strncpy(meminfo_->segments[i].magic_token, magic_token, MAGIC_TOKEN_SIZE);
+			if (name) {
+				strncpy(meminfo_->segments[i].name, name, SEGMENT_NAME_SIZE);
+			} else {
+				meminfo_->segments[i].name[0] = 0;
+			}
+			meminfo_->segments[i].size = size;
 			valid = true;
 		}
 	}
 
-	sem_post(sem_);
+	end_write();
 
 	if (!valid) {
 		throw Exception("Maximum number of shared memory segments already registered");
@@ -222,7 +297,7 @@ SharedMemoryRegistry::add_segment(int shmid, const char *magic_token)
 void
 SharedMemoryRegistry::remove_segment(int shmid)
 {
-	sem_wait(sem_);
+	begin_write();
 
 	for (unsigned int i = 0; i < MAXNUM_SHM_SEGMS; ++i) {
 		if (meminfo_->segments[i].shmid == shmid) {
@@ -230,7 +305,7 @@ SharedMemoryRegistry::remove_segment(int shmid)
 		}
 	}
 
-	sem_post(sem_);
+	end_write();
 }
 
 } // end namespace fawkes
@@ -24,10 +24,14 @@
 #ifndef _UTILS_IPC_SHM_REGISTRY_H_
 #define _UTILS_IPC_SHM_REGISTRY_H_
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <list>
 #include <semaphore.h>
 
 #define MAGIC_TOKEN_SIZE 32
+#define SEGMENT_NAME_SIZE 64
 #define MAXNUM_SHM_SEGMS 64
 #define DEFAULT_SHM_NAME "/fawkes-shmem-registry"
 #define USER_SHM_NAME "/fawkes-shmem-registry-%s"
@@ -40,8 +44,10 @@ public:
 	/** Shared memory identifier. */
 	typedef struct
 	{
-		int  shmid;                         /**< SysV IPC shared memory ID */
-		char magic_token[MAGIC_TOKEN_SIZE]; /**< Magic token */
+		int    shmid;                         /**< SysV IPC shared memory ID */
+		char   magic_token[MAGIC_TOKEN_SIZE]; /**< Magic token */
+		char   name[SEGMENT_NAME_SIZE];       /**< Segment name, empty if unknown */
+		size_t size;                          /**< Segment size in bytes, 0 if unknown */
 	} SharedMemID;
 
 public:
@@ -50,9 +56,10 @@ public:
 
 	std::list<SharedMemoryRegistry::SharedMemID> get_snapshot() const;
 
-	std::list<SharedMemoryRegistry::SharedMemID> find_segments(const char *magic_token) const;
+	std::list<SharedMemoryRegistry::SharedMemID> find_segments(const char *magic_token,
+	                                                           const char *name = 0) const;
 
-	void add_segment(int shmid, const char *magic_token);
+	void add_segment(int shmid, const char *magic_token, const char *name = 0, size_t size = 0);
 	void remove_segment(int shmid);
 
 	static void cleanup(const char *name = 0);
@@ -61,10 +68,17 @@ private:
 	/// @cond INTERNALS
 	typedef struct
 	{
-		SharedMemID segments[MAXNUM_SHM_SEGMS];
+		std::atomic<uint32_t> version;
+		SharedMemID           segments[MAXNUM_SHM_SEGMS];
 	} MemInfo;
 	/// @endcond
 
+	template <typename Predicate>
+	std::list<SharedMemID> collect(Predicate pred) const;
+
+	void begin_write();
+	void end_write();
+
 	bool  master_;
 	int   shmfd_;
 	char *shm_name_;
@@ -0,0 +1,126 @@
+
+/***************************************************************************
+ *  kalman_cv2d.cpp - Kalman filter (two dimensional, constant velocity)
+ *
+ *  Created: Thu Oct 15 08:26:52 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <utils/kalman/kalman_cv2d.h>
+
+namespace fawkes {
+
+/** @class KalmanFilterCV2D <utils/kalman/kalman_cv2d.h>
+ * Two-dimensional constant velocity Kalman filter for single-precision floats.
+ * The state consists of position and velocity in x and y, which is
+ * observed by position measurements. Accelerations are modeled as white
+ * noise. Since motion model, measurement model and noise are the same
+ * and independent for both axes, the 4D filter decomposes into one 2D
+ * filter per axis. The filter is hence computed per axis on small
+ * arrays, which is exact and avoids general 4x4 matrix operations.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param noise_acc Process noise, standard deviation of the acceleration, by default 1.0.
+ * @param noise_z Sensor noise, standard deviation of position measurements, by default 0.1.
+ * @param x Initial x position, by default 0.0.
+ * @param y Initial y position, by default 0.0.
+ * @param sig_vel Initial standard deviation of the velocity, by default 1.0.
+ */
+KalmanFilterCV2D::KalmanFilterCV2D(float noise_acc, float noise_z, float x, float y, float sig_vel)
+: noise_acc_(noise_acc), noise_z_(noise_z), sig_vel_(sig_vel)
+{
+	reset(x, y);
+}
+
+/** Reset filter.
+ * The position is set to the given one with the uncertainty of a single
+ * measurement, the velocity is set to zero with the initial uncertainty.
+ * @param x x position
+ * @param y y position
+ */
+void
+KalmanFilterCV2D::reset(float x, float y)
+{
+	pos_[0] = x;
+	pos_[1] = y;
+	for (unsigned int k = 0; k < 2; ++k) {
+		vel_[k]    = 0.;
+		cov_pp_[k] = noise_z_ * noise_z_;
+		cov_pv_[k] = 0.;
+		cov_vv_[k] = sig_vel_ * sig_vel_;
+	}
+}
+
+/** Predict state.
+ * Moves the state forward in time by the current velocity.
+ * @param dt time to predict ahead in seconds
+ */
+void
+KalmanFilterCV2D::predict(float dt)
+{
+	const float q   = noise_acc_ * noise_acc_;
+	const float dt2 = dt * dt;
+	for (unsigned int k = 0; k < 2; ++k) {
+		pos_[k] += vel_[k] * dt;
+		cov_pp_[k] += 2 * dt * cov_pv_[k] + dt2 * cov_vv_[k] + 0.25f * q * dt2 * dt2;
+		cov_pv_[k] += dt * cov_vv_[k] + 0.5f * q * dt2 * dt;
+		cov_vv_[k] += q * dt2;
+	}
+}
+
+/** Filters a position observation.
+ * @param x observed x position
+ * @param y observed y position
+ */
+void
+KalmanFilterCV2D::filter(float x, float y)
+{
+	const float r    = noise_z_ * noise_z_;
+	const float z[2] = {x, y};
+	for (unsigned int k = 0; k < 2; ++k) {
+		const float s   = cov_pp_[k] + r;
+		const float k_p = cov_pp_[k] / s;
+		const float k_v = cov_pv_[k] / s;
+		const float inn = z[k] - pos_[k];
+		pos_[k] += k_p * inn;
+		vel_[k] += k_v * inn;
+		cov_vv_[k] -= k_v * cov_pv_[k];
+		cov_pp_[k] *= (1.f - k_p);
+		cov_pv_[k] *= (1.f - k_p);
+	}
+}
+
+/** Get squared Mahalanobis distance of an observation.
+ * Can be used to gate observations, e.g. with a chi-square threshold
+ * with two degrees of freedom.
+ * @param x observed x position
+ * @param y observed y position
+ * @return squared Mahalanobis distance of the observation to the predicted position
+ */
+float
+KalmanFilterCV2D::mahalanobis_sq(float x, float y) const
+{
+	const float r  = noise_z_ * noise_z_;
+	const float dx = x - pos_[0];
+	const float dy = y - pos_[1];
+	return dx * dx / (cov_pp_[0] + r) + dy * dy / (cov_pp_[1] + r);
+}
+
+} // namespace fawkes
@@ -0,0 +1,98 @@
+
+/***************************************************************************
+ *  kalman_cv2d.h - Kalman filter (two dimensional, constant velocity)
+ *
+ *  Created: Thu Oct 15 08:26:52 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef UTILS_KALMAN_KALMAN_CV2D_H__
+#define UTILS_KALMAN_KALMAN_CV2D_H__
+
+namespace fawkes {
+
+class KalmanFilterCV2D
+{
+public:
+	KalmanFilterCV2D(float noise_acc = 1.0,
+	                 float noise_z   = 0.1,
+	                 float x         = 0.0,
+	                 float y         = 0.0,
+	                 float sig_vel   = 1.0);
+
+	void  reset(float x, float y);
+	void  predict(float dt);
+	void  filter(float x, float y);
+	float mahalanobis_sq(float x, float y) const;
+
+	/** Get estimated x position.
+	 * @return x position */
+	float
+	x() const
+	{
+		return pos_[0];
+	}
+
+	/** Get estimated y position.
+	 * @return y position */
+	float
+	y() const
+	{
+		return pos_[1];
+	}
+
+	/** Get estimated velocity in x direction.
+	 * @return velocity in x direction */
+	float
+	vx() const
+	{
+		return vel_[0];
+	}
+
+	/** Get estimated velocity in y direction.
+	 * @return velocity in y direction */
+	float
+	vy() const
+	{
+		return vel_[1];
+	}
+
+	/** Get variance of position.
+	 * @param axis 0 for x, 1 for y
+	 * @return variance of the position along the given axis */
+	float
+	position_variance(unsigned int axis) const
+	{
+		return cov_pp_[axis];
+	}
+
+private:
+	float noise_acc_; /**< process noise, std. deviation of acceleration */
+	float noise_z_;   /**< sensor noise, std. deviation of position measurement */
+	float sig_vel_;   /**< initial std. deviation of velocity */
+
+	// state and covariance per axis
+	float pos_[2];
+	float vel_[2];
+	float cov_pp_[2];
+	float cov_pv_[2];
+	float cov_vv_[2];
+};
+} // end namespace fawkes
+
+#endif
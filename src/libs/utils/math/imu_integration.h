@@ -0,0 +1,194 @@
+
+/***************************************************************************
+ *  imu_integration.h - Integrate high-rate IMU samples
+ *
+ *  Created: Thu Oct 15 08:21:13 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_MATH_IMU_INTEGRATION_H_
+#define _UTILS_MATH_IMU_INTEGRATION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fawkes {
+
+/** @class IMUIntegrator <utils/math/imu_integration.h>
+ * Integrate angular velocity and linear acceleration of IMU samples.
+ * Samples are integrated with the trapezoidal rule between consecutive
+ * timestamps, e.g. all samples of an IMUBatchInterface update. This gives
+ * the rotation and velocity change over an interval, for example between
+ * two odometry updates, without the error introduced by only looking at
+ * one sample per loop. The rotation is integrated per axis, which is
+ * exact for rotation about a single axis and a good approximation for the
+ * small rotations between two loops otherwise. The velocity change is
+ * given in the sensor frame at the start of the interval.
+ *
+ * Call restart() to start a new interval, the last sample is kept as the
+ * start of the next interval so that no time span is lost.
+ * @author agent
+ */
+class IMUIntegrator
+{
+public:
+	/** Constructor. */
+	IMUIntegrator() : have_last_(false), last_stamp_usec_(0)
+	{
+		restart();
+	}
+
+	/** Reset integrator, including the last sample. */
+	void
+	reset()
+	{
+		have_last_ = false;
+		restart();
+	}
+
+	/** Start a new integration interval.
+	 * The integrals are reset, the last sample is kept as start of the
+	 * new interval.
+	 */
+	void
+	restart()
+	{
+		for (unsigned int i = 0; i < 3; ++i) {
+			delta_angle_[i]    = 0.;
+			delta_velocity_[i] = 0.;
+		}
+		duration_    = 0.;
+		num_samples_ = 0;
+	}
+
+	/** Add a sample.
+	 * Samples with a timestamp not newer than the last sample are ignored.
+	 * @param stamp_usec time of the sample in microseconds
+	 * @param angular_velocity angular velocity (x, y, z) in rad/s
+	 * @param linear_acceleration linear acceleration (x, y, z) in m/s^2, may
+	 * be NULL if not available
+	 */
+	void
+	add_sample(int64_t stamp_usec, const float *angular_velocity, const float *linear_acceleration)
+	{
+		if (have_last_) {
+			if (stamp_usec <= last_stamp_usec_)
+				return;
+			const double dt = (stamp_usec - last_stamp_usec_) / 1000000.;
+			for (unsigned int i = 0; i < 3; ++i) {
+				delta_angle_[i] += 0.5 * (last_angular_velocity_[i] + angular_velocity[i]) * dt;
+			}
+			if (linear_acceleration) {
+				for (unsigned int i = 0; i < 3; ++i) {
+					delta_velocity_[i] +=
+					  0.5 * (last_linear_acceleration_[i] + linear_acceleration[i]) * dt;
+				}
+			}
+			duration_ += dt;
+		}
+
+		have_last_       = true;
+		last_stamp_usec_ = stamp_usec;
+		for (unsigned int i = 0; i < 3; ++i) {
+			last_angular_velocity_[i]    = angular_velocity[i];
+			last_linear_acceleration_[i] = linear_acceleration ? linear_acceleration[i] : 0.f;
+		}
+		++num_samples_;
+	}
+
+	/** Add a batch of samples.
+	 * The data is laid out as in the IMUBatchInterface.
+	 * @param num_samples number of samples
+	 * @param stamps_usec times of the samples in microseconds
+	 * @param angular_velocity angular velocities, 3 values per sample
+	 * @param linear_acceleration linear accelerations, 3 values per sample,
+	 * may be NULL if not available
+	 */
+	void
+	add_samples(unsigned int   num_samples,
+	            const int64_t *stamps_usec,
+	            const float *  angular_velocity,
+	            const float *  linear_acceleration)
+	{
+		for (unsigned int i = 0; i < num_samples; ++i) {
+			add_sample(stamps_usec[i],
+			           &angular_velocity[3 * i],
+			           linear_acceleration ? &linear_acceleration[3 * i] : NULL);
+		}
+	}
+
+	/** Get integrated rotation.
+	 * @return rotation about the x, y, and z axes in rad since restart() */
+	const double *
+	delta_angle() const
+	{
+		return delta_angle_;
+	}
+
+	/** Get integrated linear acceleration.
+	 * @return velocity change along the x, y, and z axes in m/s since restart() */
+	const double *
+	delta_velocity() const
+	{
+		return delta_velocity_;
+	}
+
+	/** Get integrated time span.
+	 * @return time covered by the integrals in seconds */
+	double
+	duration() const
+	{
+		return duration_;
+	}
+
+	/** Get number of samples.
+	 * @return number of samples added since restart() */
+	unsigned int
+	num_samples() const
+	{
+		return num_samples_;
+	}
+
+	/** Get mean angular velocity.
+	 * @param axis axis index, 0 for x, 1 for y, 2 for z
+	 * @return mean angular velocity about the given axis since restart(),
+	 * or the last sample's if no time span has been integrated, yet
+	 */
+	double
+	mean_angular_velocity(unsigned int axis) const
+	{
+		if (duration_ > 0.)
+			return delta_angle_[axis] / duration_;
+		return have_last_ ? last_angular_velocity_[axis] : 0.;
+	}
+
+private:
+	bool    have_last_;
+	int64_t last_stamp_usec_;
+	float   last_angular_velocity_[3];
+	float   last_linear_acceleration_[3];
+
+	double       delta_angle_[3];
+	double       delta_velocity_[3];
+	double       duration_;
+	unsigned int num_samples_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,235 @@
+
+/***************************************************************************
+ *  astar_search.h - Allocation-free A* search on dense state spaces
+ *
+ *  Created: Thu Oct 15 04:15:52 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_SEARCH_ASTAR_SEARCH_H_
+#define _UTILS_SEARCH_ASTAR_SEARCH_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace fawkes {
+
+/** @class AStarSearch <utils/search/astar_search.h>
+ * A* search without per-state allocations.
+ * Unlike AStar, states are plain values defined by a search domain
+ * instead of heap-allocated AStarState objects. Search nodes are kept in
+ * an arena, the open list is an indexed binary heap with decrease-key and
+ * the closed list is a dense array indexed by the state key. All storage
+ * is kept between calls to solve(), so repeated searches on the same
+ * domain do not allocate.
+ *
+ * The domain must provide:
+ * - a type State, which is copyable,
+ * - size_t num_states() const, the number of distinct state keys,
+ * - size_t key(const State &s) const, a key in [0, num_states()),
+ * - float estimate(const State &s) const, the heuristic cost to the goal,
+ * - bool is_goal(const State &s) const,
+ * - template <class F> void expand(const State &s, F &&f) const, which
+ *   calls f(child, step_cost) for every successor of s.
+ *
+ * The estimate must be consistent (monotone) for the search to be optimal,
+ * closed states are never reopened.
+ */
+template <class Domain>
+class AStarSearch
+{
+public:
+	/** State type of the domain. */
+	typedef typename Domain::State State;
+
+	/** Search for a path.
+   * @param domain search domain
+   * @param initial initial state
+   * @param path upon return contains the states from the initial state to
+   * the goal, empty if no goal was found
+   * @param cost upon return contains the path cost plus the estimate of the
+   * goal state, -1 if no goal was found
+   * @return true if a goal was found, false otherwise
+   */
+	bool
+	solve(const Domain &domain, const State &initial, std::vector<State> &path, float &cost)
+	{
+		reset(domain.num_states());
+		path.clear();
+		cost = -1;
+
+		size_t n = add_node(domain, initial, 0.f, NONE);
+		heap_push(n);
+
+		while (!heap_.empty()) {
+			size_t best = heap_pop();
+			nodes_[best].closed = true;
+
+			if (domain.is_goal(nodes_[best].state)) {
+				cost = nodes_[best].total_estimated_cost;
+				for (size_t i = best; i != NONE; i = nodes_[i].parent) {
+					path.push_back(nodes_[i].state);
+				}
+				std::reverse(path.begin(), path.end());
+				return true;
+			}
+
+			// copy, the node arena may grow while expanding
+			const State current = nodes_[best].state;
+			domain.expand(current, [&](const State &child, float step_cost) {
+				float  path_cost = nodes_[best].path_cost + step_cost;
+				size_t key       = domain.key(child);
+				size_t c         = index_[key];
+				if (c == NONE) {
+					heap_push(add_node(domain, child, path_cost, best));
+				} else if (!nodes_[c].closed && path_cost < nodes_[c].path_cost) {
+					float estimate = nodes_[c].total_estimated_cost - nodes_[c].path_cost;
+
+					nodes_[c].parent               = best;
+					nodes_[c].path_cost            = path_cost;
+					nodes_[c].total_estimated_cost = path_cost + estimate;
+					heap_up(nodes_[c].heap_pos);
+				}
+			});
+		}
+
+		return false;
+	}
+
+	/** Get number of states reached in the last search.
+   * @return number of states reached in the last search
+   */
+	size_t
+	num_reached() const
+	{
+		return nodes_.size();
+	}
+
+private:
+	static const size_t NONE = (size_t)-1;
+
+	/// @cond INTERNALS
+	struct Node
+	{
+		State  state;
+		float  path_cost;
+		float  total_estimated_cost;
+		size_t parent;
+		size_t heap_pos;
+		bool   closed;
+	};
+	/// @endcond
+
+	void
+	reset(size_t num_states)
+	{
+		if (index_.size() != num_states) {
+			index_.assign(num_states, (size_t)NONE);
+		} else {
+			for (size_t key : keys_)
+				index_[key] = NONE;
+		}
+		nodes_.clear();
+		heap_.clear();
+		keys_.clear();
+	}
+
+	size_t
+	add_node(const Domain &domain, const State &s, float path_cost, size_t parent)
+	{
+		size_t key = domain.key(s);
+		size_t n   = nodes_.size();
+		nodes_.push_back(Node{s, path_cost, path_cost + domain.estimate(s), parent, NONE, false});
+		keys_.push_back(key);
+		index_[key] = n;
+		return n;
+	}
+
+	bool
+	less(size_t a, size_t b) const
+	{
+		return nodes_[a].total_estimated_cost < nodes_[b].total_estimated_cost;
+	}
+
+	void
+	heap_push(size_t n)
+	{
+		nodes_[n].heap_pos = heap_.size();
+		heap_.push_back(n);
+		heap_up(nodes_[n].heap_pos);
+	}
+
+	size_t
+	heap_pop()
+	{
+		size_t top = heap_[0];
+		heap_swap(0, heap_.size() - 1);
+		heap_.pop_back();
+		nodes_[top].heap_pos = NONE;
+		if (!heap_.empty())
+			heap_down(0);
+		return top;
+	}
+
+	void
+	heap_up(size_t pos)
+	{
+		while (pos > 0) {
+			size_t parent = (pos - 1) / 2;
+			if (!less(heap_[pos], heap_[parent]))
+				break;
+			heap_swap(pos, parent);
+			pos = parent;
+		}
+	}
+
+	void
+	heap_down(size_t pos)
+	{
+		const size_t size = heap_.size();
+		while (true) {
+			size_t child = 2 * pos + 1;
+			if (child >= size)
+				break;
+			if (child + 1 < size && less(heap_[child + 1], heap_[child]))
+				++child;
+			if (!less(heap_[child], heap_[pos]))
+				break;
+			heap_swap(pos, child);
+			pos = child;
+		}
+	}
+
+	void
+	heap_swap(size_t a, size_t b)
+	{
+		std::swap(heap_[a], heap_[b]);
+		nodes_[heap_[a]].heap_pos = a;
+		nodes_[heap_[b]].heap_pos = b;
+	}
+
+	std::vector<Node>   nodes_;
+	std::vector<size_t> keys_;
+	std::vector<size_t> index_;
+	std::vector<size_t> heap_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,145 @@
+
+/***************************************************************************
+ *  memory_placement.cpp - Huge pages and NUMA placement of memory regions
+ *
+ *  Created: Thu Oct 15 08:32:37 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <sys/mman.h>
+#include <utils/system/memory_placement.h>
+
+#include <cstdint>
+#include <unistd.h>
+#ifdef __linux__
+#	include <sys/syscall.h>
+#endif
+
+namespace fawkes {
+
+/// @cond INTERNALS
+// from linux/mempolicy.h, numaif.h requires libnuma
+static const int MPOL_PREFERRED_ = 1;
+static const int MPOL_MF_MOVE_   = 1 << 1;
+
+/** Shrink region to the pages it fully covers.
+ * @param addr start of region, upon return page-aligned start
+ * @param size size of region, upon return size of the covered pages
+ * @return true if at least one page is covered
+ */
+static bool
+page_align(void *&addr, size_t &size)
+{
+	const uintptr_t page  = sysconf(_SC_PAGESIZE);
+	const uintptr_t start = ((uintptr_t)addr + page - 1) & ~(page - 1);
+	const uintptr_t end   = ((uintptr_t)addr + size) & ~(page - 1);
+	if (end <= start) {
+		return false;
+	}
+	addr = (void *)start;
+	size = end - start;
+	return true;
+}
+/// @endcond
+
+/** @class MemoryPlacement <utils/system/memory_placement.h>
+ * Huge pages and NUMA placement of memory regions.
+ * Large buffers which are processed as a whole, like the BlackBoard or
+ * image buffers, suffer from TLB misses when backed by small pages, and on
+ * multi-socket machines from remote memory accesses if they are placed on
+ * another NUMA node than the threads processing them. These utilities
+ * advise the kernel accordingly. All operations are hints, failure does
+ * not affect correctness and is only reported through the return value.
+ * @author agent
+ */
+
+/** Advise transparent huge pages for a memory region.
+ * The kernel will back the region with huge pages if transparent huge
+ * pages are enabled in advise mode (for shared memory see
+ * /sys/kernel/mm/transparent_hugepage/shmem_enabled). Only huge page
+ * aligned parts of the region can be backed by huge pages.
+ * @param addr start of region
+ * @param size size of region in bytes
+ * @return true if the advice was accepted, false otherwise
+ */
+bool
+MemoryPlacement::advise_huge_pages(void *addr, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+	if (!page_align(addr, size))
+		return false;
+	return (madvise(addr, size, MADV_HUGEPAGE) == 0);
+#else
+	return false;
+#endif
+}
+
+/** Bind a memory region to a NUMA node.
+ * The node is set as preferred node of the region, pages which have
+ * already been allocated on another node are migrated if possible.
+ * @param addr start of region
+ * @param size size of region in bytes
+ * @param node NUMA node, NUMA_NODE_LOCAL for the node of the calling
+ * thread, or NUMA_NODE_NONE to do nothing
+ * @return true if the region has been bound or NUMA_NODE_NONE was
+ * given, false otherwise, for example on a system without NUMA support
+ */
+bool
+MemoryPlacement::bind_numa_node(void *addr, size_t size, int node)
+{
+	if (node == NUMA_NODE_NONE)
+		return true;
+	if (node == NUMA_NODE_LOCAL)
+		node = current_numa_node();
+	if ((node < 0) || (node >= (int)sizeof(unsigned long) * 8))
+		return false;
+	if (!page_align(addr, size))
+		return false;
+
+#if defined(__linux__) && defined(SYS_mbind)
+	unsigned long nodemask = 1ul << node;
+	return (syscall(SYS_mbind,
+	                addr,
+	                size,
+	                MPOL_PREFERRED_,
+	                &nodemask,
+	                sizeof(nodemask) * 8 + 1,
+	                MPOL_MF_MOVE_)
+	        == 0);
+#else
+	return false;
+#endif
+}
+
+/** Get NUMA node of the calling thread.
+ * @return NUMA node of the CPU the calling thread currently runs on, or
+ * -1 if it cannot be determined
+ */
+int
+MemoryPlacement::current_numa_node()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+	unsigned int cpu, node;
+	if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) {
+		return node;
+	}
+#endif
+	return -1;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,46 @@
+
+/***************************************************************************
+ *  memory_placement.h - Huge pages and NUMA placement of memory regions
+ *
+ *  Created: Thu Oct 15 08:32:37 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_SYSTEM_MEMORY_PLACEMENT_H_
+#define _UTILS_SYSTEM_MEMORY_PLACEMENT_H_
+
+#include <cstddef>
+
+namespace fawkes {
+
+class MemoryPlacement
+{
+public:
+	/** Do not bind memory to a NUMA node. */
+	static const int NUMA_NODE_NONE = -1;
+	/** Bind memory to the NUMA node of the calling thread. */
+	static const int NUMA_NODE_LOCAL = -2;
+
+	static bool advise_huge_pages(void *addr, size_t size);
+	static bool bind_numa_node(void *addr, size_t size, int node);
+	static int  current_numa_node();
+};
+
+} // end namespace fawkes
+
+#endif
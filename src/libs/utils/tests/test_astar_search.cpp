@@ -0,0 +1,196 @@
+/***************************************************************************
+ *  test_astar_search.cpp - AStarSearch Unit Test
+ *
+ *  Created: Thu Oct 15 09:47:01 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <utils/search/astar_search.h>
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+
+/** Random geometric graph with Euclidean edge costs. */
+struct RandomGraph
+{
+	std::vector<float>                                  x, y;
+	std::vector<std::vector<std::pair<size_t, float>>> edges;
+
+	RandomGraph(unsigned int seed, size_t num_nodes, size_t num_edges)
+	: x(num_nodes), y(num_nodes), edges(num_nodes)
+	{
+		std::mt19937                          gen(seed);
+		std::uniform_real_distribution<float> pos(0.f, 100.f);
+		std::uniform_int_distribution<size_t> node(0, num_nodes - 1);
+		for (size_t i = 0; i < num_nodes; ++i) {
+			x[i] = pos(gen);
+			y[i] = pos(gen);
+		}
+		for (size_t e = 0; e < num_edges; ++e) {
+			size_t a = node(gen);
+			size_t b = node(gen);
+			if (a == b)
+				continue;
+			// detours make the heuristic inexact but keep it consistent
+			float cost = distance(a, b) * std::uniform_real_distribution<float>(1.f, 2.f)(gen);
+			edges[a].push_back(std::make_pair(b, cost));
+			edges[b].push_back(std::make_pair(a, cost));
+		}
+	}
+
+	float
+	distance(size_t a, size_t b) const
+	{
+		return std::sqrt((x[a] - x[b]) * (x[a] - x[b]) + (y[a] - y[b]) * (y[a] - y[b]));
+	}
+
+	/** Reference path costs from a start node to all nodes. */
+	std::vector<float>
+	dijkstra(size_t start) const
+	{
+		typedef std::pair<float, size_t> Entry;
+		std::vector<float> dist(x.size(), std::numeric_limits<float>::infinity());
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> q;
+		dist[start] = 0.f;
+		q.push(std::make_pair(0.f, start));
+		while (!q.empty()) {
+			Entry e = q.top();
+			q.pop();
+			if (e.first > dist[e.second])
+				continue;
+			for (const auto &a : edges[e.second]) {
+				if (e.first + a.second < dist[a.first]) {
+					dist[a.first] = e.first + a.second;
+					q.push(std::make_pair(dist[a.first], a.first));
+				}
+			}
+		}
+		return dist;
+	}
+};
+
+/** Search domain on a RandomGraph. */
+struct RandomGraphDomain
+{
+	typedef size_t State;
+
+	const RandomGraph &graph;
+	size_t             goal;
+
+	size_t
+	num_states() const
+	{
+		return graph.x.size();
+	}
+
+	size_t
+	key(const State &s) const
+	{
+		return s;
+	}
+
+	float
+	estimate(const State &s) const
+	{
+		return graph.distance(s, goal);
+	}
+
+	bool
+	is_goal(const State &s) const
+	{
+		return s == goal;
+	}
+
+	template <class F>
+	void
+	expand(const State &s, F &&f) const
+	{
+		for (const auto &a : graph.edges[s]) {
+			f(a.first, a.second);
+		}
+	}
+};
+
+float
+path_cost(const RandomGraph &graph, const std::vector<size_t> &path)
+{
+	float cost = 0.f;
+	for (size_t i = 1; i < path.size(); ++i) {
+		float step = std::numeric_limits<float>::infinity();
+		for (const auto &a : graph.edges[path[i - 1]]) {
+			if (a.first == path[i])
+				step = std::min(step, a.second);
+		}
+		cost += step;
+	}
+	return cost;
+}
+
+} // namespace
+
+TEST_CASE("A* matches Dijkstra on random graphs", "[astar_search]")
+{
+	// one search object for all queries, storage is reused between calls
+	AStarSearch<RandomGraphDomain> search;
+
+	for (unsigned int seed = 1; seed <= 10; ++seed) {
+		RandomGraph        graph(seed, 300, 900);
+		std::vector<float> dist = graph.dijkstra(0);
+
+		for (size_t goal = 1; goal < graph.x.size(); goal += 7) {
+			RandomGraphDomain   domain{graph, goal};
+			std::vector<size_t> path;
+			float               cost;
+			bool                found = search.solve(domain, 0, path, cost);
+
+			if (std::isinf(dist[goal])) {
+				REQUIRE_FALSE(found);
+				REQUIRE(path.empty());
+				REQUIRE(cost == -1.f);
+			} else {
+				REQUIRE(found);
+				REQUIRE(path.front() == 0);
+				REQUIRE(path.back() == goal);
+				REQUIRE(cost == Approx(dist[goal]).epsilon(1e-4));
+				REQUIRE(path_cost(graph, path) == Approx(dist[goal]).epsilon(1e-4));
+			}
+		}
+	}
+}
+
+TEST_CASE("A* start is goal", "[astar_search]")
+{
+	RandomGraph                    graph(1, 10, 20);
+	RandomGraphDomain              domain{graph, 3};
+	AStarSearch<RandomGraphDomain> search;
+	std::vector<size_t>            path;
+	float                          cost;
+
+	REQUIRE(search.solve(domain, 3, path, cost));
+	REQUIRE(path == std::vector<size_t>{3});
+	REQUIRE(cost == 0.f);
+	REQUIRE(search.num_reached() == 1);
+}
@@ -27,6 +27,7 @@
 #include <utils/time/timesource.h>
 
 #include <cstdlib>
+#include <ctime>
 
 namespace fawkes {
 
@@ -35,23 +36,39 @@ namespace fawkes {
  * It is implemented as a singleton to ensure that there is only
  * one object. So-called TimeSources can be registered at the Clock
  * their current time can be retrieved through the Clock.
+ *
+ * The time source used by default is kept in an atomic pointer, getting
+ * the time hence does not lock. Without an external time source the time
+ * is read with clock_gettime(), which does not enter the kernel on most
+ * platforms. Code which only needs main loop granularity can use the
+ * loop time instead, which is stamped once at the start of each loop.
  * @author Daniel Beck, Tim Niemueller
  */
 
+/// @cond INTERNALS
+static inline void
+realtime(struct timeval *tv)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	tv->tv_sec  = ts.tv_sec;
+	tv->tv_usec = ts.tv_nsec / 1000;
+}
+/// @endcond
+
 /** initialize static members */
 Clock *Clock::_instance = NULL;
 
 /** Constructor. */
-Clock::Clock()
+Clock::Clock() : ext_timesource(NULL), default_timesource_(NULL), loop_time_usec_(0),
+  lockstep_(false)
 {
-	ext_timesource = 0;
-	ext_default    = false;
 }
 
 /** Destructor. */
 Clock::~Clock()
 {
-	delete ext_timesource;
+	delete ext_timesource.load();
 }
 
 /** Clock initializer.
@@ -87,10 +104,10 @@ Clock::finalize()
 void
 Clock::register_ext_timesource(TimeSource *ts, bool make_default)
 {
-	ext_timesource = ts;
+	ext_timesource.store(ts, std::memory_order_release);
 
 	if (make_default) {
-		ext_default = true;
+		default_timesource_.store(ts, std::memory_order_release);
 	}
 }
 
@@ -102,9 +119,10 @@ Clock::register_ext_timesource(TimeSource *ts, bool make_default)
 void
 Clock::remove_ext_timesource(TimeSource *ts)
 {
-	if ((ts == NULL) || (ext_timesource == ts)) {
-		ext_timesource = NULL;
-		ext_default    = false;
+	if ((ts == NULL) || (ext_timesource.load() == ts)) {
+		default_timesource_.store(NULL, std::memory_order_release);
+		ext_timesource.store(NULL, std::memory_order_release);
+		lockstep_.store(false, std::memory_order_relaxed);
 	} else {
 		throw Exception("Time sources do not match. Not removing.");
 	}
@@ -118,24 +136,54 @@ void
 Clock::set_ext_default_timesource(bool ext_is_default)
 {
 	if (ext_is_default) {
-		if (NULL != ext_timesource) {
-			ext_default = true;
+		TimeSource *ts = ext_timesource.load(std::memory_order_acquire);
+		if (NULL != ts) {
+			default_timesource_.store(ts, std::memory_order_release);
 		} else {
 			throw Exception("Trying to make the external timesource the default timesource but there is "
 			                "no external timesource");
 		}
 	} else {
-		ext_default = false;
+		default_timesource_.store(NULL, std::memory_order_release);
+		lockstep_.store(false, std::memory_order_relaxed);
 	}
 }
 
+/** Enable or disable lockstep mode.
+ * In lockstep mode the external time source is advanced by one loop
+ * time during each main loop iteration, e.g. by stepping a simulation.
+ * The main loop then does not wait for the desired loop time to pass in
+ * real time but runs as fast as possible.
+ * @param lockstep true to enable lockstep mode, false to disable it
+ * @exception Exception thrown if lockstep mode is enabled and the external
+ * time source is not the default time source
+ */
+void
+Clock::set_lockstep(bool lockstep)
+{
+	if (lockstep && (NULL == default_timesource_.load())) {
+		throw Exception("Lockstep mode requires an external default time source");
+	}
+	lockstep_.store(lockstep, std::memory_order_relaxed);
+}
+
+/** Check whether lockstep mode is enabled.
+ * @return true if the main loop advances the external time source
+ * @see set_lockstep()
+ */
+bool
+Clock::is_lockstep() const
+{
+	return lockstep_.load(std::memory_order_relaxed);
+}
+
 /** Checks whether the external time source is the default time soucre.
  * @return true if external time source is default time source
  */
 bool
 Clock::is_ext_default_timesource() const
 {
-	return ext_default;
+	return default_timesource_.load(std::memory_order_relaxed) != NULL;
 }
 
 /** Returns the time of the selected time source.
@@ -145,12 +193,16 @@ Clock::is_ext_default_timesource() const
 void
 Clock::get_time(struct timeval *tv, TimesourceSelector sel) const
 {
-	if ((DEFAULT == sel && !ext_default) || REALTIME == sel) {
-		gettimeofday(tv, 0);
-	} else if ((EXTERNAL == sel) && (NULL == ext_timesource)) {
-		throw Exception("No external time source registered");
+	if (DEFAULT == sel) {
+		get_time(tv);
+	} else if (REALTIME == sel) {
+		realtime(tv);
 	} else {
-		ext_timesource->get_time(tv);
+		TimeSource *ts = ext_timesource.load(std::memory_order_acquire);
+		if (NULL == ts) {
+			throw Exception("No external time source registered");
+		}
+		ts->get_time(tv);
 	}
 }
 
@@ -160,13 +212,11 @@ Clock::get_time(struct timeval *tv, TimesourceSelector sel) const
 void
 Clock::get_time(struct timeval *tv) const
 {
-	if (ext_default) {
-		if (NULL == ext_timesource) {
-			throw Exception("No external time source registered");
-		}
-		ext_timesource->get_time(tv);
+	TimeSource *ts = default_timesource_.load(std::memory_order_acquire);
+	if (NULL != ts) {
+		ts->get_time(tv);
 	} else {
-		gettimeofday(tv, NULL);
+		realtime(tv);
 	}
 }
 
@@ -214,7 +264,7 @@ Clock::get_time(Time *time, TimesourceSelector sel) const
 void
 Clock::get_systime(struct timeval *tv) const
 {
-	gettimeofday(tv, 0);
+	realtime(tv);
 }
 
 /** Returns the time of the selected time source.
@@ -223,7 +273,7 @@ Clock::get_systime(struct timeval *tv) const
 void
 Clock::get_systime(Time &time) const
 {
-	gettimeofday(&(time.time_), 0);
+	realtime(&(time.time_));
 }
 
 /** Returns the time of the selected time source.
@@ -232,7 +282,7 @@ Clock::get_systime(Time &time) const
 void
 Clock::get_systime(Time *time) const
 {
-	gettimeofday(&(time->time_), 0);
+	realtime(&(time->time_));
 }
 
 /** Get the current time.
@@ -266,7 +316,7 @@ float
 Clock::sys_elapsed(Time *t) const
 {
 	struct timeval nowt;
-	gettimeofday(&nowt, NULL);
+	realtime(&nowt);
 	return time_diff_sec(nowt, t->time_);
 }
 
@@ -280,8 +330,9 @@ Clock::ext_to_realtime(const Time &t)
 	timeval tv;
 	Time    ret(t);
 
-	if (NULL != ext_timesource) {
-		tv = ext_timesource->conv_to_realtime(t.get_timeval());
+	TimeSource *ts = ext_timesource.load(std::memory_order_acquire);
+	if (NULL != ts) {
+		tv = ts->conv_to_realtime(t.get_timeval());
 		ret.set_time(&tv);
 	}
 
@@ -304,8 +355,9 @@ Clock::native_to_time(const Time &t)
 	timeval tv;
 	Time    ret(t);
 
-	if (NULL != ext_timesource) {
-		tv = ext_timesource->conv_native_to_exttime(t.get_timeval());
+	TimeSource *ts = ext_timesource.load(std::memory_order_acquire);
+	if (NULL != ts) {
+		tv = ts->conv_native_to_exttime(t.get_timeval());
 		ret.set_time(&tv);
 	}
 
@@ -318,11 +370,53 @@ Clock::native_to_time(const Time &t)
 bool
 Clock::has_ext_timesource() const
 {
-	if (0 != ext_timesource) {
-		return true;
+	return (NULL != ext_timesource.load(std::memory_order_relaxed));
+}
+
+/** Stamp the loop time.
+ * Stores the current time of the default time source as loop time. This
+ * is called by the main loop at the start of each iteration.
+ */
+void
+Clock::stamp_loop_time()
+{
+	struct timeval tv;
+	get_time(&tv);
+	loop_time_usec_.store((int64_t)tv.tv_sec * 1000000 + tv.tv_usec, std::memory_order_relaxed);
+}
+
+/** Get the loop time.
+ * The loop time is the time of the default time source at the start of
+ * the current main loop iteration. It is cheaper than get_time() and
+ * sufficient for code which only needs main loop granularity, e.g. for
+ * time stamps which are compared across threads of the same loop.
+ * Before the first loop the current time is returned.
+ * @param time upon return contains the loop time
+ */
+void
+Clock::get_loop_time(Time &time) const
+{
+	int64_t usec = loop_time_usec_.load(std::memory_order_relaxed);
+	if (usec == 0) {
+		// no loop has been run, yet
+		get_time(&(time.time_));
 	} else {
-		return false;
+		time.time_.tv_sec  = usec / 1000000;
+		time.time_.tv_usec = usec % 1000000;
 	}
 }
 
+/** Get the loop time.
+ * @return time of the default time source at the start of the current
+ * main loop iteration
+ * @see get_loop_time()
+ */
+Time
+Clock::loop_time() const
+{
+	Time t(0, 0, _instance);
+	get_loop_time(t);
+	return t;
+}
+
 } // end namespace fawkes
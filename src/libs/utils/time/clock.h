@@ -27,6 +27,9 @@
 
 #include <utils/time/time.h>
 
+#include <atomic>
+#include <cstdint>
+
 namespace fawkes {
 
 class TimeSource;
@@ -53,6 +56,8 @@ public:
 	Time ext_to_realtime(const Time &t);
 	Time native_to_time(const Time &t);
 	void remove_ext_timesource(TimeSource *ts = 0);
+	void set_lockstep(bool lockstep);
+	bool is_lockstep() const;
 
 	void get_time(struct timeval *tv) const;
 	void get_time(struct timeval *tv, TimesourceSelector sel) const;
@@ -71,11 +76,17 @@ public:
 	float elapsed(Time *t) const;
 	float sys_elapsed(Time *t) const;
 
+	void stamp_loop_time();
+	void get_loop_time(Time &time) const;
+	Time loop_time() const;
+
 private:
 	Clock();
 
-	TimeSource *ext_timesource;
-	bool        ext_default;
+	std::atomic<TimeSource *> ext_timesource;
+	std::atomic<TimeSource *> default_timesource_;
+	std::atomic<int64_t>      loop_time_usec_;
+	std::atomic<bool>         lockstep_;
 
 	static Clock *_instance;
 };
@@ -0,0 +1,208 @@
+
+/***************************************************************************
+ *  latency_histogram.cpp - Lock-free histogram of durations
+ *
+ *  Created: Wed Oct 14 19:35:58 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <utils/time/latency_histogram.h>
+
+namespace fawkes {
+
+/** @class LatencyHistogram <utils/time/latency_histogram.h>
+ * Lock-free histogram of durations.
+ * Durations are recorded in microseconds into logarithmic buckets, each
+ * power of two being split into SUB_BUCKETS linear buckets, similar to an
+ * HDR histogram. Values below SUB_BUCKETS are recorded exactly, larger
+ * values with a relative error of at most 1/SUB_BUCKETS. Recording a value
+ * takes a few relaxed atomic increments and never blocks or allocates,
+ * hence it can be done in hot paths like the main loop. Any number of
+ * threads may record and read concurrently. Readers may see a slightly
+ * inconsistent state, e.g., a count which does not include a value that
+ * is already contained in a bucket.
+ * @author agent
+ */
+
+/** Constructor. */
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+/** Reset all counters. */
+void
+LatencyHistogram::reset()
+{
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		buckets_[i].store(0, std::memory_order_relaxed);
+	}
+	count_.store(0, std::memory_order_relaxed);
+	sum_.store(0, std::memory_order_relaxed);
+	max_.store(0, std::memory_order_relaxed);
+}
+
+unsigned int
+LatencyHistogram::bucket_index(uint64_t usec)
+{
+	if (usec < SUB_BUCKETS) {
+		return usec;
+	}
+	if (usec >= ((uint64_t)1 << MAX_EXPONENT)) {
+		return NUM_BUCKETS - 1;
+	}
+	// exponent of highest set bit, at least log2(SUB_BUCKETS) = 3
+	unsigned int e     = 63 - __builtin_clzll(usec);
+	unsigned int shift = e - 3;
+	return SUB_BUCKETS * (e - 2) + (unsigned int)((usec >> shift) - SUB_BUCKETS);
+}
+
+/** Record a duration.
+ * @param usec duration in microseconds, negative values are recorded as 0
+ */
+void
+LatencyHistogram::record(int64_t usec)
+{
+	if (usec < 0)
+		usec = 0;
+	buckets_[bucket_index(usec)].fetch_add(1, std::memory_order_relaxed);
+	count_.fetch_add(1, std::memory_order_relaxed);
+	sum_.fetch_add(usec, std::memory_order_relaxed);
+	int64_t m = max_.load(std::memory_order_relaxed);
+	while (usec > m && !max_.compare_exchange_weak(m, usec, std::memory_order_relaxed)) {
+	}
+}
+
+/** Get number of recorded values.
+ * @return number of recorded values
+ */
+uint64_t
+LatencyHistogram::count() const
+{
+	return count_.load(std::memory_order_relaxed);
+}
+
+/** Get sum of recorded values.
+ * @return sum of all recorded values in microseconds
+ */
+uint64_t
+LatencyHistogram::sum() const
+{
+	return sum_.load(std::memory_order_relaxed);
+}
+
+/** Get maximum recorded value.
+ * @return largest recorded value in microseconds, 0 if none was recorded
+ */
+int64_t
+LatencyHistogram::max() const
+{
+	return max_.load(std::memory_order_relaxed);
+}
+
+/** Get mean of recorded values.
+ * @return mean in microseconds, 0 if no value was recorded
+ */
+double
+LatencyHistogram::mean() const
+{
+	uint64_t c = count();
+	return (c > 0) ? (double)sum() / c : 0.;
+}
+
+/** Get percentile.
+ * @param p percentile in the range [0, 1], e.g., 0.99 for the 99th percentile
+ * @return upper bound of the bucket containing the percentile in
+ * microseconds, but at most the maximum recorded value, 0 if no value has
+ * been recorded
+ */
+int64_t
+LatencyHistogram::percentile(double p) const
+{
+	uint64_t total = 0;
+	uint64_t counts[NUM_BUCKETS];
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		counts[i] = buckets_[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+	if (total == 0)
+		return 0;
+
+	if (p < 0.)
+		p = 0.;
+	if (p > 1.)
+		p = 1.;
+	uint64_t rank = (uint64_t)(p * total + 0.5);
+	if (rank == 0)
+		rank = 1;
+
+	const int64_t m   = max();
+	uint64_t      sum = 0;
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		sum += counts[i];
+		if (sum >= rank) {
+			const int64_t ub = bucket_upper_bound(i);
+			return (ub < m) ? ub : m;
+		}
+	}
+	return m;
+}
+
+/** Count values less than or equal to a bound.
+ * Counts all values in buckets whose upper bound does not exceed the given
+ * bound, hence the result is exact only if the bound is a bucket boundary.
+ * @param usec upper bound in microseconds
+ * @return number of recorded values which are at most the given bound
+ */
+uint64_t
+LatencyHistogram::count_le(int64_t usec) const
+{
+	uint64_t c = 0;
+	for (unsigned int i = 0; i < NUM_BUCKETS && bucket_upper_bound(i) <= usec; ++i) {
+		c += buckets_[i].load(std::memory_order_relaxed);
+	}
+	return c;
+}
+
+/** Get number of values in a bucket.
+ * @param bucket bucket index, less than NUM_BUCKETS
+ * @return number of values in the bucket
+ */
+uint64_t
+LatencyHistogram::bucket_count(unsigned int bucket) const
+{
+	return buckets_[bucket].load(std::memory_order_relaxed);
+}
+
+/** Get upper bound of a bucket.
+ * @param bucket bucket index, less than NUM_BUCKETS
+ * @return largest value in microseconds which is recorded into the bucket
+ */
+int64_t
+LatencyHistogram::bucket_upper_bound(unsigned int bucket)
+{
+	if (bucket < SUB_BUCKETS) {
+		return bucket;
+	}
+	unsigned int e     = bucket / SUB_BUCKETS + 2;
+	unsigned int sub   = bucket % SUB_BUCKETS;
+	unsigned int shift = e - 3;
+	return ((int64_t)(SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+} // end namespace fawkes
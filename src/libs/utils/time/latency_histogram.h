@@ -0,0 +1,69 @@
+
+/***************************************************************************
+ *  latency_histogram.h - Lock-free histogram of durations
+ *
+ *  Created: Wed Oct 14 19:35:58 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_TIME_LATENCY_HISTOGRAM_H_
+#define _UTILS_TIME_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace fawkes {
+
+class LatencyHistogram
+{
+public:
+	/** Number of linear sub-buckets per power of two. */
+	static const unsigned int SUB_BUCKETS = 8;
+	/** Values of 2^MAX_EXPONENT and above are recorded into the last bucket. */
+	static const unsigned int MAX_EXPONENT = 30;
+	/** Total number of buckets. */
+	static const unsigned int NUM_BUCKETS = SUB_BUCKETS * (MAX_EXPONENT - 2);
+
+	LatencyHistogram();
+
+	void record(int64_t usec);
+	void reset();
+
+	uint64_t count() const;
+	uint64_t sum() const;
+	int64_t  max() const;
+	double   mean() const;
+	int64_t  percentile(double p) const;
+	uint64_t count_le(int64_t usec) const;
+
+	uint64_t       bucket_count(unsigned int bucket) const;
+	static int64_t bucket_upper_bound(unsigned int bucket);
+
+private:
+	static unsigned int bucket_index(uint64_t usec);
+
+private:
+	std::atomic<uint64_t> buckets_[NUM_BUCKETS];
+	std::atomic<uint64_t> count_;
+	std::atomic<uint64_t> sum_;
+	std::atomic<int64_t>  max_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,280 @@
+
+/***************************************************************************
+ *  latency_trace.cpp - Causal tracing of end-to-end latency across threads
+ *
+ *  Created: Thu Oct 15 09:30:37 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <utils/time/latency_trace.h>
+
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace fawkes {
+
+/** @class LatencyTrace <utils/time/latency_trace.h>
+ * Causal tracing of end-to-end latency across threads.
+ * A source, e.g. a sensor driver, creates a trace for each piece of data
+ * it acquires. The trace carries a unique ID and the monotonic time of
+ * acquisition. Each thread has a current trace. The BlackBoard propagates
+ * it implicitly: reading an interface or taking a message from the queue
+ * adopts the trace of the data into the current trace of the thread,
+ * writing an interface or enqueuing a message attaches the current trace.
+ * Of several traces adopted in one loop the one with the most recent
+ * origin is kept, such that feedback loops do not keep stale traces
+ * alive. The current trace is cleared before each loop of a blocked
+ * timing thread, threads with a loop of their own call clear() at its
+ * start.
+ *
+ * A sink, e.g. the thread commanding the actuators, records the latency
+ * from the origin of a trace to now. One histogram is kept per pipeline,
+ * i.e., per pair of source and sink:
+ * @code
+ * // source, in the thread acquiring the data
+ * static uint32_t source = LatencyTrace::source("laser");
+ * LatencyTrace::adopt(LatencyTrace::create(source));
+ * laser_if->write();
+ *
+ * // sink, in the thread executing the command
+ * static unsigned int sink = LatencyTrace::sink("motor");
+ * motor_if->msgq_first_safe(msg);
+ * LatencyTrace::record(sink, msg->trace());
+ * @endcode
+ * Traces use the monotonic clock and are therefore comparable among
+ * processes on the same host. The metrics plugin exports the latency
+ * distribution of all pipelines.
+ * @author agent
+ */
+
+/** @struct LatencyTrace::PipelineStatistics
+ * Latency statistics of one pipeline from a source to a sink.
+ */
+
+/// @cond INTERNALS
+namespace {
+
+typedef struct
+{
+	uint32_t                          source;
+	unsigned int                      sink;
+	std::shared_ptr<LatencyHistogram> histogram;
+} Pipeline;
+
+class Registry
+{
+public:
+	Registry() : next_id(0)
+	{
+	}
+
+	Mutex                                            mutex;
+	std::unordered_map<uint32_t, std::string>        source_names;
+	std::unordered_map<std::string, unsigned int>    sink_ids;
+	std::deque<std::string>                          sink_names;
+	std::unordered_map<uint64_t, LatencyHistogram *> pipeline_index;
+	std::deque<Pipeline>                             pipelines;
+	std::atomic<uint64_t>                            next_id;
+};
+
+Registry &
+registry()
+{
+	static Registry r;
+	return r;
+}
+
+thread_local latency_trace_t current_trace = {0, 0, 0, 0};
+
+} // end anonymous namespace
+/// @endcond
+
+/** Get ID of source.
+ * The ID is a hash of the name, hence it is the same in all processes.
+ * The name is registered to resolve the ID in pipelines().
+ * @param name name of the source
+ * @return ID of the source, never zero
+ */
+uint32_t
+LatencyTrace::source(const char *name)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (const char *c = name; *c; ++c) {
+		hash ^= (unsigned char)*c;
+		hash *= 16777619u;
+	}
+	if (hash == 0)
+		hash = 1;
+
+	Registry &  r = registry();
+	MutexLocker lock(&r.mutex);
+	r.source_names.emplace(hash, name);
+	return hash;
+}
+
+/** Create new trace.
+ * The trace does not become the current trace of the thread, pass it
+ * to adopt() for this.
+ * @param source ID of the source as returned by source()
+ * @param origin_nsec monotonic time in nanoseconds when the data was
+ * acquired, zero to use the current time
+ * @return new trace
+ */
+latency_trace_t
+LatencyTrace::create(uint32_t source, uint64_t origin_nsec)
+{
+	static const uint64_t pid_bits = (uint64_t)getpid() << 40;
+	uint64_t              counter  = registry().next_id.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	latency_trace_t trace;
+	trace.id          = pid_bits | (counter & ((1ull << 40) - 1));
+	trace.origin_nsec = origin_nsec != 0 ? origin_nsec : now_nsec();
+	trace.source      = source;
+	trace.reserved    = 0;
+	return trace;
+}
+
+/** Adopt trace into the current trace of the thread.
+ * The trace replaces the current trace if the thread has none or if its
+ * origin is more recent.
+ * @param trace trace to adopt, ignored if it has no ID
+ */
+void
+LatencyTrace::adopt(const latency_trace_t &trace)
+{
+	if (trace.id != 0
+	    && (current_trace.id == 0 || trace.origin_nsec > current_trace.origin_nsec)) {
+		current_trace = trace;
+	}
+}
+
+/** Clear the current trace of the thread.
+ * Called at the start of each loop, data written afterwards is not
+ * traced unless traced data is read or a trace is adopted.
+ */
+void
+LatencyTrace::clear()
+{
+	current_trace = {0, 0, 0, 0};
+}
+
+/** Get current trace of the thread.
+ * @return current trace, its ID is zero if there is none
+ */
+const latency_trace_t &
+LatencyTrace::current()
+{
+	return current_trace;
+}
+
+/** Get ID of sink.
+ * The sink is created if it does not exist.
+ * @param name name of the sink
+ * @return ID of the sink
+ */
+unsigned int
+LatencyTrace::sink(const char *name)
+{
+	Registry &  r = registry();
+	MutexLocker lock(&r.mutex);
+	auto        i = r.sink_ids.find(name);
+	if (i != r.sink_ids.end()) {
+		return i->second;
+	}
+	unsigned int id = r.sink_names.size();
+	r.sink_names.push_back(name);
+	r.sink_ids[name] = id;
+	return id;
+}
+
+/** Record latency of trace at sink.
+ * Records the time from the origin of the trace to now into the
+ * histogram of the pipeline from the source of the trace to the sink.
+ * @param sink ID of the sink as returned by sink()
+ * @param trace trace to record, ignored if it has no ID
+ */
+void
+LatencyTrace::record(unsigned int sink, const latency_trace_t &trace)
+{
+	if (trace.id == 0)
+		return;
+
+	uint64_t now  = now_nsec();
+	int64_t  usec = now > trace.origin_nsec ? (now - trace.origin_nsec) / 1000 : 0;
+	uint64_t key  = ((uint64_t)trace.source << 32) | sink;
+
+	Registry &        r = registry();
+	LatencyHistogram *histogram;
+	{
+		MutexLocker lock(&r.mutex);
+		auto        i = r.pipeline_index.find(key);
+		if (i != r.pipeline_index.end()) {
+			histogram = i->second;
+		} else {
+			r.pipelines.push_back({trace.source, sink, std::make_shared<LatencyHistogram>()});
+			histogram             = r.pipelines.back().histogram.get();
+			r.pipeline_index[key] = histogram;
+		}
+	}
+	histogram->record(usec);
+}
+
+/** Record latency of current trace at sink.
+ * @param sink ID of the sink as returned by sink()
+ * @see record(unsigned int, const latency_trace_t &)
+ */
+void
+LatencyTrace::record(unsigned int sink)
+{
+	record(sink, current_trace);
+}
+
+/** Get statistics of all pipelines.
+ * A pipeline exists once a trace of its source has been recorded at
+ * its sink. Sources not known to this process, e.g. of traces created
+ * in another process, are named by their hexadecimal ID.
+ * @return list of all pipelines and their histograms
+ */
+std::list<LatencyTrace::PipelineStatistics>
+LatencyTrace::pipelines()
+{
+	Registry &                    r = registry();
+	MutexLocker                   lock(&r.mutex);
+	std::list<PipelineStatistics> rv;
+	for (const Pipeline &p : r.pipelines) {
+		std::string source;
+		auto        s = r.source_names.find(p.source);
+		if (s != r.source_names.end()) {
+			source = s->second;
+		} else {
+			char tmp[9];
+			snprintf(tmp, sizeof(tmp), "%08x", p.source);
+			source = tmp;
+		}
+		rv.push_back({source, r.sink_names[p.sink], p.histogram});
+	}
+	return rv;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,86 @@
+
+/***************************************************************************
+ *  latency_trace.h - Causal tracing of end-to-end latency across threads
+ *
+ *  Created: Thu Oct 15 09:30:37 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_TIME_LATENCY_TRACE_H_
+#define _UTILS_TIME_LATENCY_TRACE_H_
+
+#include <utils/time/latency_histogram.h>
+
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <string>
+
+namespace fawkes {
+
+/** Trace of data back to its origin.
+ * The struct is stored in shared memory and hence must remain a plain
+ * struct of fixed size.
+ */
+typedef struct
+{
+	uint64_t id;          /**< unique trace ID, 0 if the data is not traced */
+	uint64_t origin_nsec; /**< monotonic time the source acquired the data */
+	uint32_t source;      /**< ID of the source as returned by LatencyTrace::source() */
+	uint32_t reserved;    /**< reserved for future use, keeps the struct padding-free */
+} latency_trace_t;
+
+class LatencyTrace
+{
+public:
+	/** Latency statistics of one pipeline from a source to a sink. */
+	typedef struct
+	{
+		std::string                             source;    /**< source name */
+		std::string                             sink;      /**< sink name */
+		std::shared_ptr<const LatencyHistogram> histogram; /**< latencies in microseconds */
+	} PipelineStatistics;
+
+	static uint32_t        source(const char *name);
+	static latency_trace_t create(uint32_t source, uint64_t origin_nsec = 0);
+
+	static void                   adopt(const latency_trace_t &trace);
+	static void                   clear();
+	static const latency_trace_t &current();
+
+	static unsigned int sink(const char *name);
+	static void         record(unsigned int sink, const latency_trace_t &trace);
+	static void         record(unsigned int sink);
+
+	static std::list<PipelineStatistics> pipelines();
+
+	/** Get monotonic time for tracing.
+	 * @return monotonic time in nanoseconds */
+	static uint64_t
+	now_nsec()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+};
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,270 @@
+
+/***************************************************************************
+ *  section_tracker.cpp - Always-on profiling of code sections
+ *
+ *  Created: Thu Oct 15 03:29:42 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/utils/spsc_ring_buffer.h>
+#include <utils/time/section_tracker.h>
+
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+
+namespace fawkes {
+
+/** @class SectionTracker <utils/time/section_tracker.h>
+ * Always-on profiling of code sections.
+ * This is a thread-safe successor of TimeTracker with bounded memory use.
+ * Sections are identified by name, section() interns the name once and
+ * returns an ID to be used for recording. Each thread records the
+ * durations of the sections it executes into its own fixed-size
+ * single-producer single-consumer buffer, which takes no lock and does not
+ * allocate. aggregate() periodically drains the buffers of all threads
+ * into one LatencyHistogram per section. If a buffer runs full before it
+ * is drained, further samples are dropped and counted, see dropped().
+ *
+ * Sections are usually tracked using the TIMETRACK_SECTION macro from
+ * tracker_macros.h, which times the enclosing scope:
+ * @code
+ * void MyThread::loop()
+ * {
+ *   TIMETRACK_SECTION("MyThread::loop");
+ *   ...
+ * }
+ * @endcode
+ * The metrics plugin aggregates and exports all sections.
+ *
+ * @author agent
+ */
+
+/** @struct SectionTracker::SectionStatistics
+ * Statistics of a single section.
+ */
+
+namespace {
+
+typedef struct
+{
+	unsigned int section;
+	int64_t      usec;
+} Sample;
+
+class ThreadBuffer
+{
+public:
+	ThreadBuffer() : samples(SectionTracker::BUFFER_SIZE)
+	{
+	}
+
+	SpscRingBuffer<Sample> samples;
+};
+
+class Registry
+{
+public:
+	Registry() : enabled(true), dropped(0)
+	{
+	}
+
+	Mutex                                         mutex;
+	std::unordered_map<std::string, unsigned int> ids;
+	std::deque<std::string>                       names;
+	std::deque<std::shared_ptr<LatencyHistogram>> histograms;
+	std::list<std::shared_ptr<ThreadBuffer>>      buffers;
+	Mutex                                         aggregate_mutex;
+	std::atomic<bool>                             enabled;
+	std::atomic<uint64_t>                         dropped;
+};
+
+Registry &
+registry()
+{
+	static Registry r;
+	return r;
+}
+
+/** Buffer of the calling thread, registered on first use. */
+class ThreadBufferHolder
+{
+public:
+	ThreadBufferHolder() : buffer(std::make_shared<ThreadBuffer>())
+	{
+		MutexLocker lock(&registry().mutex);
+		registry().buffers.push_back(buffer);
+	}
+
+	std::shared_ptr<ThreadBuffer> buffer;
+};
+
+ThreadBuffer &
+thread_buffer()
+{
+	static thread_local ThreadBufferHolder holder;
+	return *holder.buffer;
+}
+
+} // end anonymous namespace
+
+/** Get ID of section.
+ * The section is created if it does not exist.
+ * @param name name of the section
+ * @return ID of the section
+ */
+unsigned int
+SectionTracker::section(const char *name)
+{
+	Registry &  r = registry();
+	MutexLocker lock(&r.mutex);
+	auto        i = r.ids.find(name);
+	if (i != r.ids.end()) {
+		return i->second;
+	}
+	unsigned int id = r.names.size();
+	r.names.push_back(name);
+	r.histograms.push_back(std::make_shared<LatencyHistogram>());
+	r.ids[name] = id;
+	return id;
+}
+
+/** Enable or disable tracking.
+ * While disabled, sections are not timed at all.
+ * @param enabled true to enable tracking, it is enabled by default
+ */
+void
+SectionTracker::set_enabled(bool enabled)
+{
+	registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/** Check if tracking is enabled.
+ * @return true if tracking is enabled
+ */
+bool
+SectionTracker::enabled()
+{
+	return registry().enabled.load(std::memory_order_relaxed);
+}
+
+/** Record duration of a section.
+ * The sample is buffered by the calling thread until the next aggregate().
+ * @param section ID of the section as returned by section()
+ * @param usec duration in microseconds
+ */
+void
+SectionTracker::record(unsigned int section, int64_t usec)
+{
+	if (!thread_buffer().samples.try_push({section, usec})) {
+		registry().dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+/** Aggregate samples of all threads.
+ * Drains the buffers of all threads into the section histograms. Buffers
+ * of threads which have exited are released.
+ */
+void
+SectionTracker::aggregate()
+{
+	Registry &  r = registry();
+	MutexLocker agg_lock(&r.aggregate_mutex);
+
+	std::list<std::shared_ptr<ThreadBuffer>>      buffers;
+	std::deque<std::shared_ptr<LatencyHistogram>> histograms;
+	{
+		MutexLocker lock(&r.mutex);
+		buffers    = r.buffers;
+		histograms = r.histograms;
+	}
+
+	for (auto &b : buffers) {
+		Sample s;
+		while (b->samples.try_pop(s)) {
+			if (s.section < histograms.size()) {
+				histograms[s.section]->record(s.usec);
+			}
+		}
+	}
+	buffers.clear();
+
+	MutexLocker lock(&r.mutex);
+	r.buffers.remove_if([](const std::shared_ptr<ThreadBuffer> &b) {
+		return b.use_count() == 1 && b->samples.empty();
+	});
+}
+
+/** Get statistics of all sections.
+ * Call aggregate() before to include the most recent samples.
+ * @return list of all sections and their histograms
+ */
+std::list<SectionTracker::SectionStatistics>
+SectionTracker::sections()
+{
+	Registry &                   r = registry();
+	MutexLocker                  lock(&r.mutex);
+	std::list<SectionStatistics> rv;
+	for (unsigned int i = 0; i < r.names.size(); ++i) {
+		rv.push_back({r.names[i], r.histograms[i]});
+	}
+	return rv;
+}
+
+/** Get number of dropped samples.
+ * @return number of samples which were dropped because the buffer of the
+ * recording thread was full
+ */
+uint64_t
+SectionTracker::dropped()
+{
+	return registry().dropped.load(std::memory_order_relaxed);
+}
+
+/** @class SectionTracker::Scope <utils/time/section_tracker.h>
+ * Track the duration of a scope.
+ * The time from construction to destruction is recorded for the given
+ * section, unless tracking is disabled.
+ */
+
+/** Constructor.
+ * @param section ID of the section as returned by SectionTracker::section()
+ */
+SectionTracker::Scope::Scope(unsigned int section)
+: section_(section), active_(SectionTracker::enabled())
+{
+	if (active_) {
+		clock_gettime(CLOCK_MONOTONIC, &start_);
+	}
+}
+
+/** Destructor. */
+SectionTracker::Scope::~Scope()
+{
+	if (active_) {
+		struct timespec end;
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		SectionTracker::record(section_,
+		                       (end.tv_sec - start_.tv_sec) * 1000000
+		                         + (end.tv_nsec - start_.tv_nsec) / 1000);
+	}
+}
+
+} // end namespace fawkes
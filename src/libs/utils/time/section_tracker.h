@@ -0,0 +1,76 @@
+
+/***************************************************************************
+ *  section_tracker.h - Always-on profiling of code sections
+ *
+ *  Created: Thu Oct 15 03:29:42 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_TIME_SECTION_TRACKER_H_
+#define _UTILS_TIME_SECTION_TRACKER_H_
+
+#include <utils/time/latency_histogram.h>
+
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <string>
+
+namespace fawkes {
+
+class SectionTracker
+{
+public:
+	/** Number of samples buffered per thread between aggregations. */
+	static const unsigned int BUFFER_SIZE = 4096;
+
+	/** Statistics of a single section. */
+	typedef struct
+	{
+		std::string                             name;      /**< section name */
+		std::shared_ptr<const LatencyHistogram> histogram; /**< durations in microseconds */
+	} SectionStatistics;
+
+	static unsigned int section(const char *name);
+
+	static void set_enabled(bool enabled);
+	static bool enabled();
+
+	static void record(unsigned int section, int64_t usec);
+	static void aggregate();
+
+	static std::list<SectionStatistics> sections();
+	static uint64_t                     dropped();
+
+	class Scope
+	{
+	public:
+		explicit Scope(unsigned int section);
+		~Scope();
+
+	private:
+		unsigned int    section_;
+		bool            active_;
+		struct timespec start_;
+	};
+};
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,394 @@
+
+/***************************************************************************
+ *  trace_recorder.cpp - Timeline tracing of main loop execution
+ *
+ *  Created: Thu Oct 15 07:32:26 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exceptions/system.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/utils/spsc_ring_buffer.h>
+#include <utils/time/trace_recorder.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+namespace fawkes {
+
+/** @class TraceRecorder <utils/time/trace_recorder.h>
+ * Timeline tracing of main loop execution.
+ * While the SectionTracker aggregates durations into histograms, the
+ * trace recorder keeps the individual events with their start time and
+ * the thread they ran in. This allows to inspect a timeline of the main
+ * loop, e.g. to reason about which threads run in parallel and what
+ * delays a hook.
+ *
+ * Events are identified by category and name, event() interns them once
+ * and returns an ID to be used for recording. Each thread records into
+ * its own fixed-size single-producer single-consumer buffer, which takes
+ * no lock and does not allocate. collect() must be called periodically to
+ * move the events of all threads into a bounded history, the oldest
+ * events are discarded if the history is full. If a thread buffer runs
+ * full before it is collected, further events are dropped and counted,
+ * see dropped(). The history can be written in the Chrome trace event
+ * format, which can be opened in chrome://tracing or the Perfetto UI.
+ *
+ * The main thread records the main loop hooks, the BlockedTimingAspect
+ * the loops of threads, SyncPoints waits and emits, and the BlackBoard
+ * interface writes and message deliveries. Tracing is disabled by default
+ * and then only costs checking a flag.
+ * @author agent
+ */
+
+/** @class TraceRecorder::Scope <utils/time/trace_recorder.h>
+ * Record the lifetime of a scope as event.
+ * The start time is only taken if tracing is enabled when the scope is
+ * entered, the event is recorded when leaving the scope.
+ */
+
+/// @cond INTERNALS
+std::atomic<bool> TraceRecorder::enabled_(false);
+
+namespace {
+
+/** Marks an instant event. */
+const uint64_t INSTANT = UINT64_MAX;
+
+typedef struct
+{
+	unsigned int event;
+	unsigned int tid;
+	uint64_t     start;
+	uint64_t     duration;
+} Record;
+
+class ThreadBuffer
+{
+public:
+	ThreadBuffer(unsigned int tid) : tid(tid), records(TraceRecorder::BUFFER_SIZE)
+	{
+	}
+
+	const unsigned int     tid;
+	SpscRingBuffer<Record> records;
+};
+
+class Registry
+{
+public:
+	Registry() : next_tid(1), max_history(262144), dropped(0)
+	{
+	}
+
+	Mutex                                    mutex;
+	std::map<std::string, unsigned int>      ids;
+	std::deque<std::string>                  names;
+	std::deque<std::string>                  categories;
+	std::list<std::shared_ptr<ThreadBuffer>> buffers;
+	std::map<unsigned int, std::string>      thread_names;
+	unsigned int                             next_tid;
+
+	Mutex              history_mutex;
+	std::deque<Record> history;
+	size_t             max_history;
+
+	std::atomic<uint64_t> dropped;
+};
+
+Registry &
+registry()
+{
+	static Registry r;
+	return r;
+}
+
+/** Buffer of the calling thread, registered on first use. */
+class ThreadBufferHolder
+{
+public:
+	ThreadBufferHolder()
+	{
+		Registry &  r = registry();
+		MutexLocker lock(&r.mutex);
+		buffer         = std::make_shared<ThreadBuffer>(r.next_tid++);
+		Thread *thread = Thread::current_thread_noexc();
+		r.thread_names[buffer->tid] = thread ? thread->name() : "Unknown";
+		r.buffers.push_back(buffer);
+	}
+
+	std::shared_ptr<ThreadBuffer> buffer;
+};
+
+ThreadBuffer &
+thread_buffer()
+{
+	static thread_local ThreadBufferHolder holder;
+	return *holder.buffer;
+}
+
+void
+record(const Record &rec)
+{
+	ThreadBuffer &b = thread_buffer();
+	Record        r = rec;
+	r.tid           = b.tid;
+	if (!b.records.try_push(r)) {
+		registry().dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void
+write_json_string(FILE *f, const std::string &s)
+{
+	fputc('"', f);
+	for (char c : s) {
+		switch (c) {
+		case '"': fputs("\\\"", f); break;
+		case '\\': fputs("\\\\", f); break;
+		case '\n': fputs("\\n", f); break;
+		default:
+			if ((unsigned char)c < 0x20) {
+				fprintf(f, "\\u%04x", c);
+			} else {
+				fputc(c, f);
+			}
+			break;
+		}
+	}
+	fputc('"', f);
+}
+
+} // end anonymous namespace
+/// @endcond
+
+/** Get ID of event.
+ * The event is created if it does not exist.
+ * @param category category of the event, e.g. "hook" or "syncpoint"
+ * @param name name of the event
+ * @return ID of the event
+ */
+unsigned int
+TraceRecorder::event(const char *category, const char *name)
+{
+	Registry &        r   = registry();
+	const std::string key = std::string(category) + '\0' + name;
+	MutexLocker       lock(&r.mutex);
+	auto              i = r.ids.find(key);
+	if (i != r.ids.end()) {
+		return i->second;
+	}
+	unsigned int id = r.names.size();
+	r.names.push_back(name);
+	r.categories.push_back(category);
+	r.ids[key] = id;
+	return id;
+}
+
+/** Enable or disable tracing.
+ * @param enabled true to enable tracing, it is disabled by default
+ */
+void
+TraceRecorder::set_enabled(bool enabled)
+{
+	enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+/** Record an event with duration.
+ * @param event ID of the event as returned by event()
+ * @param start_nsec start time from now_nsec()
+ * @param end_nsec end time from now_nsec()
+ */
+void
+TraceRecorder::complete(unsigned int event, uint64_t start_nsec, uint64_t end_nsec)
+{
+	record({event, 0, start_nsec, end_nsec - start_nsec});
+}
+
+/** Record an instant event.
+ * Nothing is recorded while tracing is disabled.
+ * @param event ID of the event as returned by event()
+ */
+void
+TraceRecorder::instant(unsigned int event)
+{
+	if (enabled()) {
+		record({event, 0, now_nsec(), INSTANT});
+	}
+}
+
+/** Collect events of all threads.
+ * Moves the buffered events of all threads into the history. Buffers of
+ * threads which have exited are released.
+ */
+void
+TraceRecorder::collect()
+{
+	Registry &  r = registry();
+	MutexLocker history_lock(&r.history_mutex);
+
+	std::list<std::shared_ptr<ThreadBuffer>> buffers;
+	{
+		MutexLocker lock(&r.mutex);
+		buffers = r.buffers;
+	}
+
+	for (auto &b : buffers) {
+		Record rec;
+		while (b->records.try_pop(rec)) {
+			r.history.push_back(rec);
+		}
+	}
+	buffers.clear();
+	while (r.history.size() > r.max_history) {
+		r.history.pop_front();
+	}
+
+	MutexLocker lock(&r.mutex);
+	r.buffers.remove_if([](const std::shared_ptr<ThreadBuffer> &b) {
+		return b.use_count() == 1 && b->records.empty();
+	});
+}
+
+/** Clear history. */
+void
+TraceRecorder::clear()
+{
+	Registry &  r = registry();
+	MutexLocker lock(&r.history_mutex);
+	r.history.clear();
+}
+
+/** Set maximum size of the history.
+ * @param max_events maximum number of events to keep, the oldest events
+ * are discarded on collect() if there are more
+ */
+void
+TraceRecorder::set_history_size(size_t max_events)
+{
+	Registry &  r = registry();
+	MutexLocker lock(&r.history_mutex);
+	r.max_history = max_events;
+}
+
+/** Get number of events in history.
+ * @return number of collected events
+ */
+size_t
+TraceRecorder::num_events()
+{
+	Registry &  r = registry();
+	MutexLocker lock(&r.history_mutex);
+	return r.history.size();
+}
+
+/** Get number of dropped events.
+ * @return number of events which were dropped because the buffer of the
+ * recording thread was full
+ */
+uint64_t
+TraceRecorder::dropped()
+{
+	return registry().dropped.load(std::memory_order_relaxed);
+}
+
+/** Write history as Chrome trace.
+ * Writes the collected events in the JSON trace event format. Call
+ * collect() before to include the most recent events.
+ * @param filename name of the file to write
+ * @exception CouldNotOpenFileException thrown if the file cannot be opened
+ * @exception FileWriteException thrown if writing the file failed
+ */
+void
+TraceRecorder::write_chrome_trace(const char *filename)
+{
+	FILE *f = fopen(filename, "w");
+	if (!f) {
+		throw CouldNotOpenFileException(filename, errno, "Failed to open trace file");
+	}
+
+	Registry &              r = registry();
+	std::deque<std::string> names, categories;
+	std::map<unsigned int, std::string> thread_names;
+	{
+		MutexLocker lock(&r.mutex);
+		names        = r.names;
+		categories   = r.categories;
+		thread_names = r.thread_names;
+	}
+
+	int pid = getpid();
+	fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", f);
+	bool first = true;
+	for (const auto &t : thread_names) {
+		fprintf(f,
+		        "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+		        first ? "" : ",\n",
+		        pid,
+		        t.first);
+		write_json_string(f, t.second);
+		fputs("}}", f);
+		first = false;
+	}
+
+	{
+		MutexLocker lock(&r.history_mutex);
+		for (const Record &rec : r.history) {
+			if (rec.event >= names.size())
+				continue;
+			fputs(first ? "{\"name\":" : ",\n{\"name\":", f);
+			write_json_string(f, names[rec.event]);
+			fputs(",\"cat\":", f);
+			write_json_string(f, categories[rec.event]);
+			if (rec.duration == INSTANT) {
+				fprintf(f,
+				        ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u}",
+				        rec.start / 1000.,
+				        pid,
+				        rec.tid);
+			} else {
+				fprintf(f,
+				        ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u}",
+				        rec.start / 1000.,
+				        rec.duration / 1000.,
+				        pid,
+				        rec.tid);
+			}
+			first = false;
+		}
+	}
+	fputs("\n]}\n", f);
+
+	if (ferror(f)) {
+		fclose(f);
+		throw FileWriteException(filename, errno, "Failed to write trace file");
+	}
+	if (fclose(f) != 0) {
+		throw FileWriteException(filename, errno, "Failed to close trace file");
+	}
+}
+
+} // end namespace fawkes
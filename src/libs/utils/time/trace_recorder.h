@@ -0,0 +1,102 @@
+
+/***************************************************************************
+ *  trace_recorder.h - Timeline tracing of main loop execution
+ *
+ *  Created: Thu Oct 15 07:32:26 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_TIME_TRACE_RECORDER_H_
+#define _UTILS_TIME_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+namespace fawkes {
+
+class TraceRecorder
+{
+public:
+	/** Number of events buffered per thread between collections. */
+	static const unsigned int BUFFER_SIZE = 16384;
+
+	static unsigned int event(const char *category, const char *name);
+
+	static void set_enabled(bool enabled);
+
+	/** Check if tracing is enabled.
+	 * @return true if tracing is enabled */
+	static bool
+	enabled()
+	{
+		return enabled_.load(std::memory_order_relaxed);
+	}
+
+	/** Get monotonic time for tracing.
+	 * @return monotonic time in nanoseconds */
+	static uint64_t
+	now_nsec()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+
+	static void complete(unsigned int event, uint64_t start_nsec, uint64_t end_nsec);
+	static void instant(unsigned int event);
+
+	static void   collect();
+	static void   clear();
+	static void   set_history_size(size_t max_events);
+	static size_t num_events();
+
+	static void     write_chrome_trace(const char *filename);
+	static uint64_t dropped();
+
+	class Scope
+	{
+	public:
+		/** Constructor.
+		 * @param event ID of the event as returned by TraceRecorder::event() */
+		explicit Scope(unsigned int event)
+		: event_(event), start_(TraceRecorder::enabled() ? TraceRecorder::now_nsec() : 0)
+		{
+		}
+
+		/** Destructor. */
+		~Scope()
+		{
+			if (start_ != 0) {
+				TraceRecorder::complete(event_, start_, TraceRecorder::now_nsec());
+			}
+		}
+
+	private:
+		unsigned int event_;
+		uint64_t     start_;
+	};
+
+private:
+	static std::atomic<bool> enabled_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -24,6 +24,8 @@
 #ifndef _UTILS_TIME_TRACKER_MACROS_H_
 #define _UTILS_TIME_TRACKER_MACROS_H_
 
+#include <utils/time/section_tracker.h>
+
 #ifndef TRACKER_VARIABLE
 #	define TRACKER_VARIABLE tt_
 #endif
@@ -49,4 +51,18 @@
 #	define TIMETRACK_SCOPE(c)
 #endif
 
+#define TIMETRACK_CONCAT_(a, b) a##b
+#define TIMETRACK_CONCAT(a, b) TIMETRACK_CONCAT_(a, b)
+
+/** Track duration of enclosing scope with the SectionTracker.
+ * Unlike the TimeTracker macros, this is always compiled in. The section
+ * name is only looked up on the first execution.
+ * @param name name of the section, e.g. "MyThread::loop"
+ */
+#define TIMETRACK_SECTION(name)                                                        \
+	static const unsigned int TIMETRACK_CONCAT(tt_section_id_, __LINE__) =            \
+	  fawkes::SectionTracker::section(name);                                            \
+	fawkes::SectionTracker::Scope TIMETRACK_CONCAT(tt_section_scope_, __LINE__)(       \
+	  TIMETRACK_CONCAT(tt_section_id_, __LINE__));
+
 #endif
@@ -0,0 +1,226 @@
+
+/***************************************************************************
+ *  multi_target_tracker.cpp - Track multiple targets in the plane
+ *
+ *  Created: Thu Oct 15 08:26:52 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <utils/tracking/multi_target_tracker.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace fawkes {
+
+/** @class MultiTargetTracker <utils/tracking/multi_target_tracker.h>
+ * Track multiple targets in the plane.
+ * Each track keeps its state in a constant velocity Kalman filter. On
+ * update() all tracks are predicted, then measurements are associated to
+ * tracks. A measurement is only considered for a track if it is within
+ * the gate distance of the track's predicted position. To find these
+ * candidates without comparing every track with every measurement, the
+ * measurements are binned into a grid with the gate distance as cell
+ * size, such that only the 3x3 cells around a track need to be checked.
+ * The tracks and measurements with at least one candidate are then
+ * assigned in one batch by the Hungarian method, minimizing the sum of
+ * distances while maximizing the number of associations.
+ *
+ * Associated tracks are updated with their measurement, tracks which
+ * have not been associated for more than the maximum number of misses
+ * are removed, and a new track is started for every measurement which
+ * has not been associated. Tracks keep their ID for their lifetime, which
+ * can be used to follow a target across updates.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param gate maximum distance of a measurement to the predicted position
+ * of a track to be associated
+ * @param noise_acc process noise, standard deviation of target acceleration
+ * @param noise_z measurement noise, standard deviation of positions
+ * @param max_misses number of consecutive updates without measurement
+ * after which a track is removed
+ * @param min_hits number of measurements after which a track is confirmed
+ */
+MultiTargetTracker::MultiTargetTracker(float        gate,
+                                       float        noise_acc,
+                                       float        noise_z,
+                                       unsigned int max_misses,
+                                       unsigned int min_hits)
+: gate_(gate),
+  noise_acc_(noise_acc),
+  noise_z_(noise_z),
+  max_misses_(max_misses),
+  min_hits_(min_hits),
+  next_id_(1)
+{
+}
+
+/** Remove all tracks. */
+void
+MultiTargetTracker::clear()
+{
+	tracks_.clear();
+	measurement_tracks_.clear();
+}
+
+/// @cond INTERNALS
+static inline int64_t
+grid_key(int cx, int cy)
+{
+	return ((int64_t)cx << 32) ^ (uint32_t)cy;
+}
+/// @endcond
+
+/** Get grid cell key of a position.
+ * @param x x position
+ * @param y y position
+ * @return key of the grid cell containing the position
+ */
+int64_t
+MultiTargetTracker::cell_key(float x, float y) const
+{
+	return grid_key((int)std::floor(x / gate_), (int)std::floor(y / gate_));
+}
+
+/** Update tracks with new measurements.
+ * @param measurements positions of all targets detected since the last update
+ * @param dt time since the last update in seconds
+ */
+void
+MultiTargetTracker::update(const std::vector<cart_coord_2d_t> &measurements, float dt)
+{
+	const unsigned int num_meas   = measurements.size();
+	const unsigned int num_tracks = tracks_.size();
+	const float        gate_sq    = gate_ * gate_;
+
+	measurement_tracks_.assign(num_meas, 0);
+
+	for (Track &t : tracks_) {
+		t.filter.predict(dt);
+	}
+
+	// drop cells which are no longer in use once in a while
+	if (grid_.size() > 4 * num_meas + 64) {
+		grid_.clear();
+	}
+	for (auto &cell : grid_) {
+		cell.second.clear();
+	}
+	for (unsigned int i = 0; i < num_meas; ++i) {
+		grid_[cell_key(measurements[i].x, measurements[i].y)].push_back(i);
+	}
+
+	// gating, only consider measurements in the cells around a track
+	candidates_.resize(num_tracks);
+	rows_.clear();
+	cols_.clear();
+	col_index_.assign(num_meas, -1);
+	for (unsigned int t = 0; t < num_tracks; ++t) {
+		const float x  = tracks_[t].filter.x();
+		const float y  = tracks_[t].filter.y();
+		const int   cx = (int)std::floor(x / gate_);
+		const int   cy = (int)std::floor(y / gate_);
+		candidates_[t].clear();
+		for (int dx = -1; dx <= 1; ++dx) {
+			for (int dy = -1; dy <= 1; ++dy) {
+				auto cell = grid_.find(grid_key(cx + dx, cy + dy));
+				if (cell == grid_.end())
+					continue;
+				for (unsigned int i : cell->second) {
+					const float ex = measurements[i].x - x;
+					const float ey = measurements[i].y - y;
+					if (ex * ex + ey * ey <= gate_sq) {
+						candidates_[t].push_back(i);
+						if (col_index_[i] < 0) {
+							col_index_[i] = cols_.size();
+							cols_.push_back(i);
+						}
+					}
+				}
+			}
+		}
+		if (!candidates_[t].empty()) {
+			rows_.push_back(t);
+		}
+	}
+
+	// batch assignment of gated tracks and measurements
+	std::vector<bool> track_updated(num_tracks, false);
+	if (!rows_.empty()) {
+		const int num_rows = rows_.size();
+		const int num_cols = cols_.size();
+		// more than the sum of any assignment of gated pairs, such that the
+		// number of gated associations is maximized first
+		const int not_gated = std::max(num_rows, num_cols) * ((int)(gate_ * 1000.f) + 1) + 1;
+
+		cost_data_.assign((size_t)num_rows * num_cols, not_gated);
+		cost_rows_.resize(num_rows);
+		for (int r = 0; r < num_rows; ++r) {
+			cost_rows_[r]  = &cost_data_[(size_t)r * num_cols];
+			const Track &t = tracks_[rows_[r]];
+			for (unsigned int i : candidates_[rows_[r]]) {
+				const float ex = measurements[i].x - t.filter.x();
+				const float ey = measurements[i].y - t.filter.y();
+				cost_rows_[r][col_index_[i]] = (int)(std::sqrt(ex * ex + ey * ey) * 1000.f);
+			}
+		}
+
+		hungarian_.init(&cost_rows_[0], num_rows, num_cols, HUNGARIAN_MODE_MINIMIZE_COST);
+		hungarian_.solve();
+
+		for (int r = 0; r < num_rows; ++r) {
+			const int c = hungarian_.get_column_assignment(r);
+			if (c < 0 || c >= num_cols || cost_rows_[r][c] == not_gated)
+				continue;
+			const unsigned int i = cols_[c];
+			Track &            t = tracks_[rows_[r]];
+			t.filter.filter(measurements[i].x, measurements[i].y);
+			t.hits += 1;
+			t.misses                = 0;
+			track_updated[rows_[r]] = true;
+			measurement_tracks_[i]  = t.id;
+		}
+	}
+
+	// remove lost tracks
+	unsigned int keep = 0;
+	for (unsigned int t = 0; t < num_tracks; ++t) {
+		if (!track_updated[t] && ++tracks_[t].misses > max_misses_)
+			continue;
+		if (keep != t)
+			tracks_[keep] = tracks_[t];
+		++keep;
+	}
+	tracks_.erase(tracks_.begin() + keep, tracks_.end());
+
+	// start new tracks for unassociated measurements
+	for (unsigned int i = 0; i < num_meas; ++i) {
+		if (measurement_tracks_[i] != 0)
+			continue;
+		Track t = {next_id_++,
+		           KalmanFilterCV2D(noise_acc_, noise_z_, measurements[i].x, measurements[i].y),
+		           1,
+		           0};
+		tracks_.push_back(t);
+		measurement_tracks_[i] = t.id;
+	}
+}
+
+} // end namespace fawkes
@@ -0,0 +1,110 @@
+
+/***************************************************************************
+ *  multi_target_tracker.h - Track multiple targets in the plane
+ *
+ *  Created: Thu Oct 15 08:26:52 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_TRACKING_MULTI_TARGET_TRACKER_H_
+#define _UTILS_TRACKING_MULTI_TARGET_TRACKER_H_
+
+#include <utils/hungarian_method/hungarian.h>
+#include <utils/kalman/kalman_cv2d.h>
+#include <utils/math/types.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace fawkes {
+
+class MultiTargetTracker
+{
+public:
+	/** A tracked target. */
+	typedef struct
+	{
+		unsigned int     id;     ///< ID of the track, unique for the tracker's lifetime
+		KalmanFilterCV2D filter; ///< filter with the current state estimate
+		unsigned int     hits;   ///< number of measurements associated with the track
+		unsigned int     misses; ///< number of consecutive updates without measurement
+	} Track;
+
+	MultiTargetTracker(float        gate,
+	                   float        noise_acc,
+	                   float        noise_z,
+	                   unsigned int max_misses,
+	                   unsigned int min_hits);
+
+	void update(const std::vector<cart_coord_2d_t> &measurements, float dt);
+	void clear();
+
+	/** Get tracks.
+	 * @return all current tracks, including tentative ones */
+	const std::vector<Track> &
+	tracks() const
+	{
+		return tracks_;
+	}
+
+	/** Get track IDs of measurements.
+	 * @return track ID for each measurement of the last update(), in the
+	 * same order as the measurements */
+	const std::vector<unsigned int> &
+	measurement_tracks() const
+	{
+		return measurement_tracks_;
+	}
+
+	/** Check if a track is confirmed.
+	 * @param track track to check
+	 * @return true if the track had at least the minimum number of hits */
+	bool
+	is_confirmed(const Track &track) const
+	{
+		return track.hits >= min_hits_;
+	}
+
+private:
+	int64_t cell_key(float x, float y) const;
+
+	float        gate_;
+	float        noise_acc_;
+	float        noise_z_;
+	unsigned int max_misses_;
+	unsigned int min_hits_;
+	unsigned int next_id_;
+
+	std::vector<Track>        tracks_;
+	std::vector<unsigned int> measurement_tracks_;
+
+	// buffers re-used across updates
+	std::unordered_map<int64_t, std::vector<unsigned int>> grid_;
+	std::vector<std::vector<unsigned int>>                 candidates_;
+	std::vector<int>                                       rows_;
+	std::vector<int>                                       cols_;
+	std::vector<int>                                       col_index_;
+	std::vector<int>                                       cost_data_;
+	std::vector<int *>                                     cost_rows_;
+	HungarianMethod                                        hungarian_;
+};
+
+} // end namespace fawkes
+
+#endif
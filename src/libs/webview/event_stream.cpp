@@ -0,0 +1,182 @@
+
+/***************************************************************************
+ *  event_stream.cpp - Server-sent events stream
+ *
+ *  Created: Thu Oct 15 07:00:44 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+#include <webview/event_stream.h>
+#include <webview/rest_api.h>
+
+#include <algorithm>
+
+namespace fawkes {
+
+/** Maximum time to block the web server thread while waiting for events. */
+#define WAIT_SLICE_MSEC 100
+
+/** @class WebviewEventStream <webview/event_stream.h>
+ * Server-sent events stream.
+ * A stream is a long-running reply with content type text/event-stream
+ * through which the server pushes events to the client, for example,
+ * whenever data the client subscribed to has changed. This avoids
+ * clients polling resources at a high rate.
+ *
+ * Sub-classes call notify() whenever there is new data, possibly from
+ * arbitrary threads, and implement collect_events() to append the
+ * actual events. It is called from the web server thread and at most
+ * once per minimum interval, such that all changes in between are
+ * coalesced. The stream is shared between the reply and its owner,
+ * it ends when close() has been called or the client disconnects.
+ *
+ * Note that the web server calls into the stream from its own threads.
+ * While no data is available, the stream waits for short periods of
+ * time before returning control to the server.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param min_interval_msec minimum time between two batches of events
+ * in milliseconds, 0 to send events as soon as possible
+ * @param keepalive_sec interval in seconds in which to send a comment
+ * line if there are no events to detect disconnected clients
+ */
+WebviewEventStream::WebviewEventStream(unsigned int min_interval_msec, unsigned int keepalive_sec)
+: pending_(false),
+  closed_(false),
+  min_interval_msec_(min_interval_msec),
+  keepalive_msec_(keepalive_sec * 1000l)
+{
+	mutex_    = new Mutex();
+	waitcond_ = new WaitCondition(mutex_);
+	last_sent_.stamp_systime();
+}
+
+/** Destructor. */
+WebviewEventStream::~WebviewEventStream()
+{
+	delete waitcond_;
+	delete mutex_;
+}
+
+/** Notify about new data.
+ * Cheap and may be called from any thread.
+ */
+void
+WebviewEventStream::notify()
+{
+	MutexLocker lock(mutex_);
+	pending_ = true;
+	waitcond_->wake_all();
+}
+
+/** Close stream.
+ * The reply ends after the currently pending data has been sent.
+ */
+void
+WebviewEventStream::close()
+{
+	MutexLocker lock(mutex_);
+	closed_ = true;
+	waitcond_->wake_all();
+}
+
+/** Check if stream has been closed.
+ * @return true if the stream has been closed, false otherwise
+ */
+bool
+WebviewEventStream::is_closed() const
+{
+	MutexLocker lock(mutex_);
+	return closed_;
+}
+
+/** Append an event in server-sent events format.
+ * @param buffer buffer to append to
+ * @param event event name
+ * @param data event data, must not contain line breaks
+ */
+void
+WebviewEventStream::append_event(std::string &      buffer,
+                                 const std::string &event,
+                                 const std::string &data)
+{
+	buffer += "event: ";
+	buffer += event;
+	buffer += "\ndata: ";
+	buffer += data;
+	buffer += "\n\n";
+}
+
+/** Produce next piece of the stream.
+ * @param buffer buffer to append data to, if any
+ * @return true if the stream continues, false if it has ended
+ */
+bool
+WebviewEventStream::produce(std::string &buffer)
+{
+	MutexLocker lock(mutex_);
+
+	Time now;
+	now.stamp_systime();
+	long since_sent = (now - last_sent_).in_msec();
+
+	if (!closed_ && (!pending_ || since_sent < min_interval_msec_)) {
+		long wait_msec = WAIT_SLICE_MSEC;
+		if (pending_) {
+			wait_msec = std::min(wait_msec, min_interval_msec_ - since_sent);
+		}
+		waitcond_->reltimed_wait(wait_msec / 1000, (wait_msec % 1000) * 1000000);
+		now.stamp_systime();
+		since_sent = (now - last_sent_).in_msec();
+	}
+
+	if (pending_ && since_sent >= min_interval_msec_) {
+		pending_ = false;
+		lock.unlock();
+		collect_events(buffer);
+		lock.relock();
+		last_sent_ = now;
+	} else if (since_sent >= keepalive_msec_) {
+		buffer += ":\n\n";
+		last_sent_ = now;
+	}
+
+	return !closed_ || pending_;
+}
+
+/** Create reply for stream.
+ * @param stream stream to send, the reply keeps a reference to it
+ * @return reply to return from the request handler
+ */
+std::unique_ptr<WebReply>
+WebviewEventStream::create_reply(std::shared_ptr<WebviewEventStream> stream)
+{
+	std::unique_ptr<WebReply> reply = std::make_unique<WebviewRestStreamReply>(
+	  WebReply::HTTP_OK,
+	  [stream](std::string &buffer) -> bool { return stream->produce(buffer); },
+	  "text/event-stream");
+	// disable response buffering in reverse proxies such as nginx
+	reply->add_header("X-Accel-Buffering", "no");
+	return reply;
+}
+
+} // end namespace fawkes
@@ -0,0 +1,77 @@
+
+/***************************************************************************
+ *  event_stream.h - Server-sent events stream
+ *
+ *  Created: Thu Oct 15 07:00:44 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _LIBS_WEBVIEW_EVENT_STREAM_H_
+#define _LIBS_WEBVIEW_EVENT_STREAM_H_
+
+#include <utils/time/time.h>
+#include <webview/reply.h>
+
+#include <memory>
+#include <string>
+
+namespace fawkes {
+
+class Mutex;
+class WaitCondition;
+
+class WebviewEventStream
+{
+public:
+	WebviewEventStream(unsigned int min_interval_msec, unsigned int keepalive_sec = 15);
+	virtual ~WebviewEventStream();
+
+	void notify();
+	void close();
+	bool is_closed() const;
+
+	static std::unique_ptr<WebReply> create_reply(std::shared_ptr<WebviewEventStream> stream);
+
+	static void
+	append_event(std::string &buffer, const std::string &event, const std::string &data);
+
+protected:
+	/** Collect pending events.
+	 * Called from the web server thread after notify() has been called,
+	 * at most once per minimum interval. Append the events to send with
+	 * append_event().
+	 * @param buffer buffer to append events to
+	 */
+	virtual void collect_events(std::string &buffer) = 0;
+
+private:
+	bool produce(std::string &buffer);
+
+private:
+	Mutex *        mutex_;
+	WaitCondition *waitcond_;
+	bool           pending_;
+	bool           closed_;
+
+	long min_interval_msec_;
+	long keepalive_msec_;
+	Time last_sent_;
+};
+
+} // end namespace fawkes
+
+#endif
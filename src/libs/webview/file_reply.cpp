@@ -34,6 +34,9 @@ namespace fawkes {
  * Dynamic raw file transfer reply.
  * This dynamic file transfer reply transmits the given file with a mime type
  * determined with libmagic.
+ * The request dispatcher does not read the file through next_chunk(), but
+ * hands the file descriptor to libmicrohttpd, which can then send the file
+ * with sendfile() without copying it through user space.
  * @author Tim Niemueller
  */
 
@@ -116,6 +119,17 @@ DynamicFileWebReply::size()
 	return size_;
 }
 
+/** Get file descriptor.
+ * The descriptor remains owned by the reply, duplicate it to use it
+ * beyond the lifetime of the reply.
+ * @return file descriptor of the file to transmit
+ */
+int
+DynamicFileWebReply::file_descriptor() const
+{
+	return fileno(file_);
+}
+
 size_t
 DynamicFileWebReply::next_chunk(size_t pos, char *buffer, size_t buf_max_size)
 {
@@ -40,6 +40,8 @@ public:
 	virtual size_t size();
 	virtual size_t next_chunk(size_t pos, char *buffer, size_t buf_max_size);
 
+	int file_descriptor() const;
+
 private:
 	void determine_file_size();
 
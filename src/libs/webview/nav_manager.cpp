@@ -35,7 +35,7 @@ namespace fawkes {
  */
 
 /** Constructor. */
-WebNavManager::WebNavManager()
+WebNavManager::WebNavManager() : revision_(0)
 {
 	mutex_ = new Mutex();
 }
@@ -59,6 +59,7 @@ WebNavManager::add_nav_entry(std::string baseurl, std::string name)
 		throw Exception("Navigation entry for %s has already been added", baseurl.c_str());
 	}
 	nav_entries_[baseurl] = name;
+	revision_.fetch_add(1, std::memory_order_release);
 }
 
 /** Remove a navigation entry.
@@ -68,7 +69,9 @@ void
 WebNavManager::remove_nav_entry(std::string baseurl)
 {
 	MutexLocker lock(mutex_);
-	nav_entries_.erase(baseurl);
+	if (nav_entries_.erase(baseurl) > 0) {
+		revision_.fetch_add(1, std::memory_order_release);
+	}
 }
 
 } // end namespace fawkes
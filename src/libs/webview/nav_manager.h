@@ -23,6 +23,7 @@
 #ifndef _LIBS_WEBVIEW_NAV_MANAGER_H_
 #define _LIBS_WEBVIEW_NAV_MANAGER_H_
 
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -55,9 +56,19 @@ public:
 		return mutex_;
 	}
 
+	/** Get revision of navigation entries.
+	 * The revision is incremented whenever an entry is added or removed.
+	 * @return revision of navigation entries */
+	unsigned int
+	revision() const
+	{
+		return revision_.load(std::memory_order_acquire);
+	}
+
 private:
-	Mutex *mutex_;
-	NavMap nav_entries_;
+	Mutex *                   mutex_;
+	NavMap                    nav_entries_;
+	std::atomic<unsigned int> revision_;
 };
 
 } // end namespace fawkes
@@ -20,6 +20,9 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <webview/nav_manager.h>
 #include <webview/page_header_generator.h>
 
 namespace fawkes {
@@ -47,4 +50,78 @@ WebPageHeaderGenerator::~WebPageHeaderGenerator()
 {
 }
 
+/** @class CachingWebPageHeaderGenerator <webview/page_header_generator.h>
+ * Caching wrapper for HTML header generators.
+ * Rendering the header including the navigation for every page is
+ * noticeable on slow machines, although it only changes if the
+ * navigation changes. This generator keeps the headers rendered by
+ * another generator per title, active base URL, and custom HTML header.
+ * The cache is cleared whenever the revision of the navigation manager
+ * changes. The wrapped generator must not produce other dynamic content,
+ * or invalidate() must be called when it changes.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param generator generator to render headers which are not cached
+ * @param nav_manager navigation manager whose changes invalidate the cache
+ * @param max_entries maximum number of cached headers, the cache is
+ * cleared if it would grow larger
+ */
+CachingWebPageHeaderGenerator::CachingWebPageHeaderGenerator(WebPageHeaderGenerator *generator,
+                                                             WebNavManager *nav_manager,
+                                                             unsigned int   max_entries)
+: generator_(generator), nav_manager_(nav_manager), max_entries_(max_entries)
+{
+	mutex_        = new Mutex();
+	nav_revision_ = nav_manager_->revision();
+}
+
+/** Destructor. */
+CachingWebPageHeaderGenerator::~CachingWebPageHeaderGenerator()
+{
+	delete mutex_;
+}
+
+std::string
+CachingWebPageHeaderGenerator::html_header(std::string &title,
+                                           std::string &active_baseurl,
+                                           std::string &html_header)
+{
+	std::string key = title + '\0' + active_baseurl + '\0' + html_header;
+
+	unsigned int revision = nav_manager_->revision();
+	{
+		MutexLocker lock(mutex_);
+		if (revision != nav_revision_) {
+			cache_.clear();
+			nav_revision_ = revision;
+		}
+		auto c = cache_.find(key);
+		if (c != cache_.end()) {
+			return c->second;
+		}
+	}
+
+	// render without holding the lock, the generator locks the navigation
+	std::string header = generator_->html_header(title, active_baseurl, html_header);
+
+	MutexLocker lock(mutex_);
+	if (revision == nav_revision_) {
+		if (cache_.size() >= max_entries_) {
+			cache_.clear();
+		}
+		cache_[key] = header;
+	}
+	return header;
+}
+
+/** Clear cached headers. */
+void
+CachingWebPageHeaderGenerator::invalidate()
+{
+	MutexLocker lock(mutex_);
+	cache_.clear();
+}
+
 } // end namespace fawkes
@@ -23,10 +23,14 @@
 #ifndef _LIBS_WEBVIEW_PAGE_HEADER_GENERATOR_H_
 #define _LIBS_WEBVIEW_PAGE_HEADER_GENERATOR_H_
 
+#include <map>
 #include <string>
 
 namespace fawkes {
 
+class Mutex;
+class WebNavManager;
+
 class WebPageHeaderGenerator
 {
 public:
@@ -36,6 +40,29 @@ public:
 	html_header(std::string &title, std::string &active_baseurl, std::string &html_header) = 0;
 };
 
+class CachingWebPageHeaderGenerator : public WebPageHeaderGenerator
+{
+public:
+	CachingWebPageHeaderGenerator(WebPageHeaderGenerator *generator,
+	                              WebNavManager *         nav_manager,
+	                              unsigned int            max_entries = 64);
+	virtual ~CachingWebPageHeaderGenerator();
+
+	virtual std::string
+	html_header(std::string &title, std::string &active_baseurl, std::string &html_header);
+
+	void invalidate();
+
+private:
+	WebPageHeaderGenerator *generator_;
+	WebNavManager *         nav_manager_;
+	unsigned int            max_entries_;
+
+	Mutex *                            mutex_;
+	unsigned int                       nav_revision_;
+	std::map<std::string, std::string> cache_;
+};
+
 } // end namespace fawkes
 
 #endif
@@ -20,7 +20,6 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
-#include <utils/system/hostinfo.h>
 #include <webview/page_footer_generator.h>
 #include <webview/page_header_generator.h>
 #include <webview/page_reply.h>
@@ -105,9 +104,8 @@ WebPageReply::pack(std::string             active_baseurl,
 	if (headergen && navbar_enabled_)
 		merged_body_ += headergen->html_header(_title, active_baseurl, html_header_);
 	else {
-		fawkes::HostInfo hi;
-		char *           s;
-		if (asprintf(&s, PAGE_HEADER, _title.c_str(), html_header_.c_str(), hi.short_name()) != -1) {
+		char *s;
+		if (asprintf(&s, PAGE_HEADER, _title.c_str(), html_header_.c_str()) != -1) {
 			merged_body_ += s;
 			free(s);
 		}
@@ -76,7 +76,8 @@ header_iterator(void *cls, enum MHD_ValueKind kind, const char *key, const char
 /** Constructor.
  * @param uri URI of the request
  */
-WebRequest::WebRequest(const char *uri) : pp_(NULL), is_setup_(false), uri_(uri)
+WebRequest::WebRequest(const char *uri)
+: pp_(NULL), is_setup_(false), deferred_(false), deferred_reply_(NULL), uri_(uri)
 {
 	reply_size_ = 0;
 }
@@ -170,6 +171,7 @@ WebRequest::~WebRequest()
 		MHD_destroy_post_processor(pp_);
 		pp_ = NULL;
 	}
+	delete deferred_reply_;
 }
 
 /** Set a POST value.
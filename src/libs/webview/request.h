@@ -356,6 +356,8 @@ private:
 private:
 	MHD_PostProcessor *pp_;
 	bool               is_setup_;
+	bool               deferred_;
+	WebReply *         deferred_reply_;
 
 	std::string                        uri_;
 	std::string                        url_;
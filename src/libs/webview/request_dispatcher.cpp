@@ -30,6 +30,7 @@
 #include <utils/time/time.h>
 #include <webview/access_log.h>
 #include <webview/error_reply.h>
+#include <webview/file_reply.h>
 #include <webview/page_reply.h>
 #include <webview/request_dispatcher.h>
 #include <webview/url_manager.h>
@@ -38,6 +39,7 @@
 #include <cstdarg>
 #include <cstdlib>
 #include <cstring>
+#include <unistd.h>
 
 #define UNAUTHORIZED_REPLY                                         \
 	"<html>\n"                                                       \
@@ -55,6 +57,12 @@ namespace fawkes {
  * Takes web request received via a webserver run by libmicrohttpd and dispatches
  * pages to registered URL handlers or gives a 404 error if no
  * handler was registered for the given url.
+ *
+ * Requests are processed in the threads of libmicrohttpd. If a worker
+ * pool has been set up, requests for paths which are known to take long
+ * are instead processed in the pool. The connection is suspended
+ * meanwhile, so that the server threads remain available for other
+ * requests.
  * @author Tim Niemueller
  */
 
@@ -140,6 +148,56 @@ WebRequestDispatcher::setup_cors(bool                       allow_all,
 	cors_max_age_   = max_age;
 }
 
+/** Setup worker pool for long-running requests.
+ * The server must allow to suspend and resume connections.
+ * @param num_threads number of worker threads
+ * @param max_queue_length maximum number of requests waiting for a
+ * worker, further requests are rejected as unavailable
+ * @param heavy_paths URL prefixes of requests to process in the pool
+ */
+void
+WebRequestDispatcher::setup_worker_pool(unsigned int               num_threads,
+                                        unsigned int               max_queue_length,
+                                        std::vector<std::string> &&heavy_paths)
+{
+#if MHD_VERSION >= 0x00093400
+	stop_worker_pool();
+	heavy_paths_ = std::move(heavy_paths);
+	worker_pool_.reset(new WebRequestWorkerPool(num_threads, max_queue_length));
+#else
+	throw Exception("libmicrohttpd >= 0.9.34 is required for the worker pool, "
+	                "which was not available at compile time.");
+#endif
+}
+
+/** Stop worker pool.
+ * Waits for all pending requests in the pool to be processed. This must
+ * be called before the server is stopped, which requires that no
+ * connection is suspended.
+ */
+void
+WebRequestDispatcher::stop_worker_pool()
+{
+	if (worker_pool_) {
+		worker_pool_->stop();
+	}
+}
+
+/** Get statistics of the worker pool.
+ * @param stats upon return contains the request queue statistics
+ * @return true if a worker pool is used and @p stats has been set,
+ * false otherwise
+ */
+bool
+WebRequestDispatcher::worker_pool_stats(WebRequestWorkerPool::Stats &stats) const
+{
+	if (!worker_pool_) {
+		return false;
+	}
+	stats = worker_pool_->stats();
+	return true;
+}
+
 /** Callback for new requests.
  * @param cls closure, must be WebRequestDispatcher
  * @param uri requested URI
@@ -277,9 +335,25 @@ WebRequestDispatcher::queue_dynamic_reply(struct MHD_Connection *connection,
 	dreply->pack_caching();
 	request->set_reply_code(dreply->code());
 
-	struct MHD_Response *response;
-	response = MHD_create_response_from_callback(
-	  dreply->size(), dreply->chunk_size(), dynamic_reply_data_cb, dreply, dynamic_reply_free_cb);
+	struct MHD_Response *response = NULL;
+
+	// Let libmicrohttpd send files directly from the descriptor, which uses
+	// sendfile() where available instead of copying chunks through a buffer.
+	DynamicFileWebReply *freply = dynamic_cast<DynamicFileWebReply *>(dreply);
+	int                  fd     = freply ? dup(freply->file_descriptor()) : -1;
+	if (fd != -1) {
+		response = MHD_create_response_from_fd(dreply->size(), fd);
+		if (response) {
+			request->increment_reply_size(dreply->size());
+		} else {
+			close(fd);
+		}
+	}
+	if (!response) {
+		response = MHD_create_response_from_callback(
+		  dreply->size(), dreply->chunk_size(), dynamic_reply_data_cb, dreply, dynamic_reply_free_cb);
+		freply = NULL;
+	}
 
 	const WebReply::HeaderMap &         headers = dreply->headers();
 	WebReply::HeaderMap::const_iterator i;
@@ -290,6 +364,11 @@ WebRequestDispatcher::queue_dynamic_reply(struct MHD_Connection *connection,
 	MHD_RESULT ret = MHD_queue_response(connection, dreply->code(), response);
 	MHD_destroy_response(response);
 
+	if (freply) {
+		// the response holds its own descriptor, the reply is no longer needed
+		delete freply;
+	}
+
 	return ret;
 }
 
@@ -427,6 +506,13 @@ WebRequestDispatcher::process_request(struct MHD_Connection *connection,
 		return MHD_YES;
 	}
 
+	if (request->deferred_) {
+		// processed in the worker pool, the connection has been resumed
+		WebReply *reply          = request->deferred_reply_;
+		request->deferred_reply_ = NULL;
+		return queue_reply(connection, request, reply);
+	}
+
 #if MHD_VERSION >= 0x00090400
 	if (realm_) {
 		char *user, *pass = NULL;
@@ -499,8 +585,84 @@ WebRequestDispatcher::process_request(struct MHD_Connection *connection,
 		request->finish_body();
 	}
 
+	if (worker_pool_ && is_heavy(request)) {
+		return defer_request(connection, request);
+	}
+
+	return queue_reply(connection, request, produce_reply(request));
+}
+
+/** Check if a request is processed in the worker pool.
+ * @param request request to check
+ * @return true if the URL of the request starts with one of the
+ * configured heavy paths
+ */
+bool
+WebRequestDispatcher::is_heavy(const WebRequest *request) const
+{
+	const std::string &url = request->url();
+	for (const auto &p : heavy_paths_) {
+		if (url.compare(0, p.length(), p) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Produce reply for a request.
+ * @param request request to process
+ * @return reply of the handler, an error page if it failed, or NULL if no
+ * handler has been registered for the request
+ */
+WebReply *
+WebRequestDispatcher::produce_reply(WebRequest *request)
+{
+	try {
+		return url_manager_->process_request(request);
+	} catch (Exception &e) {
+		return new WebErrorPageReply(WebReply::HTTP_INTERNAL_SERVER_ERROR, "%s", e.what_no_backtrace());
+	} catch (std::exception &e) {
+		return new WebErrorPageReply(WebReply::HTTP_INTERNAL_SERVER_ERROR, "%s", e.what());
+	}
+}
+
+/** Process request in the worker pool.
+ * The connection is suspended until the reply has been produced. It is
+ * then queued when libmicrohttpd calls process_request() again.
+ * @param connection connection of the request
+ * @param request request to process
+ * @return suitable libmicrohttpd return code
+ */
+MHD_RESULT
+WebRequestDispatcher::defer_request(struct MHD_Connection *connection, WebRequest *request)
+{
+	request->deferred_ = true;
+	MHD_suspend_connection(connection);
+	bool queued = worker_pool_->enqueue([this, connection, request]() {
+		request->deferred_reply_ = produce_reply(request);
+		MHD_resume_connection(connection);
+	});
+	if (!queued) {
+		request->deferred_reply_ =
+		  new WebErrorPageReply(WebReply::HTTP_SERVICE_UNAVAILABLE, "Too many pending requests");
+		MHD_resume_connection(connection);
+	}
+	return MHD_YES;
+}
+
+/** Queue reply.
+ * @param connection connection to queue the reply on
+ * @param request request the reply belongs to
+ * @param reply reply to queue, ownership is taken, if NULL a "not found"
+ * error is sent
+ * @return suitable libmicrohttpd return code
+ */
+MHD_RESULT
+WebRequestDispatcher::queue_reply(struct MHD_Connection *connection,
+                                  WebRequest *           request,
+                                  WebReply *             reply)
+{
 	try {
-		WebReply * reply = url_manager_->process_request(request);
 		MHD_RESULT ret;
 
 		if (reply) {
@@ -25,6 +25,7 @@
 #include "microhttpd_compat.h"
 
 #include <utils/time/time.h>
+#include <webview/worker_pool.h>
 
 #include <map>
 #include <memory>
@@ -45,6 +46,8 @@ class WebRequest;
 class WebviewAccessLog;
 class Mutex;
 
+class WebReply;
+
 class WebRequestDispatcher
 {
 public:
@@ -72,6 +75,11 @@ public:
 	void setup_basic_auth(const char *realm, WebUserVerifier *verifier);
 	void setup_access_log(const char *filename);
 	void setup_cors(bool allow_all, std::vector<std::string> &&origins, unsigned int max_age);
+	void setup_worker_pool(unsigned int               num_threads,
+	                       unsigned int               max_queue_length,
+	                       std::vector<std::string> &&heavy_paths);
+	void stop_worker_pool();
+	bool worker_pool_stats(WebRequestWorkerPool::Stats &stats) const;
 
 	unsigned int active_requests() const;
 	Time         last_request_completion_time() const;
@@ -85,6 +93,10 @@ private:
 	                                         WebRequest *           request,
 	                                         DynamicWebReply *      sreply);
 	MHD_RESULT queue_basic_auth_fail(struct MHD_Connection *connection, WebRequest *request);
+	MHD_RESULT queue_reply(struct MHD_Connection *connection, WebRequest *request, WebReply *reply);
+	MHD_RESULT defer_request(struct MHD_Connection *connection, WebRequest *request);
+	WebReply * produce_reply(WebRequest *request);
+	bool       is_heavy(const WebRequest *request) const;
 	MHD_RESULT process_request(struct MHD_Connection *connection,
 	                           const char *           url,
 	                           const char *           method,
@@ -114,6 +126,9 @@ private:
 	bool                     cors_allow_all_;
 	std::vector<std::string> cors_origins_;
 	unsigned int             cors_max_age_;
+
+	std::unique_ptr<WebRequestWorkerPool> worker_pool_;
+	std::vector<std::string>              heavy_paths_;
 };
 
 } // end namespace fawkes
@@ -85,4 +85,20 @@ WebRequestManager::last_request_completion_time() const
 	}
 }
 
+/** Get statistics of the request queue of the worker pool.
+ * @param stats upon return contains the request queue statistics
+ * @return true if the server uses a worker pool and @p stats has been
+ * set, false otherwise
+ */
+bool
+WebRequestManager::worker_pool_stats(WebRequestWorkerPool::Stats &stats) const
+{
+	MutexLocker lock(mutex_);
+	if (server_) {
+		return server_->worker_pool_stats(stats);
+	} else {
+		return false;
+	}
+}
+
 } // end namespace fawkes
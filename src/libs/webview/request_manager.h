@@ -23,6 +23,8 @@
 #ifndef _LIBS_WEBVIEW_REQUEST_MANAGER_H_
 #define _LIBS_WEBVIEW_REQUEST_MANAGER_H_
 
+#include <webview/worker_pool.h>
+
 #include <memory>
 
 namespace fawkes {
@@ -41,6 +43,7 @@ public:
 
 	unsigned int num_active_requests() const;
 	Time         last_request_completion_time() const;
+	bool         worker_pool_stats(WebRequestWorkerPool::Stats &stats) const;
 
 private:
 	void set_server(WebServer *server);
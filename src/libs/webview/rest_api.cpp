@@ -20,16 +20,69 @@
  */
 
 #include <core/exception.h>
+#include <webview/microhttpd_compat.h>
 #include <webview/rest_api.h>
 #include <webview/router.h>
 
+#include <algorithm>
+#include <cstring>
+#include <strings.h>
+
 namespace fawkes {
 
+/** Constructor.
+ * @param code HTTP response code
+ * @param producer function called repeatedly to produce the body
+ * @param content_type content type of reply, defaults to application/json
+ */
+WebviewRestStreamReply::WebviewRestStreamReply(WebReply::Code     code,
+                                               Producer           producer,
+                                               const std::string &content_type)
+: DynamicWebReply(code), producer_(producer), buffer_offset_(0), done_(false)
+{
+	add_header("Content-type", content_type);
+}
+
+size_t
+WebviewRestStreamReply::size()
+{
+	return MHD_SIZE_UNKNOWN;
+}
+
+size_t
+WebviewRestStreamReply::next_chunk(size_t pos, char *buffer, size_t buf_max_size)
+{
+	if (buffer_offset_ >= buffer_.size()) {
+		if (done_) {
+			return (size_t)MHD_CONTENT_READER_END_OF_STREAM;
+		}
+		buffer_.clear();
+		buffer_offset_ = 0;
+		try {
+			done_ = !producer_(buffer_);
+		} catch (Exception &e) {
+			return (size_t)MHD_CONTENT_READER_END_WITH_ERROR;
+		}
+		if (buffer_.empty()) {
+			// no data available right now, we are called again later
+			return done_ ? (size_t)MHD_CONTENT_READER_END_OF_STREAM : 0;
+		}
+	}
+
+	size_t n = std::min(buf_max_size, buffer_.size() - buffer_offset_);
+	memcpy(buffer, buffer_.data() + buffer_offset_, n);
+	buffer_offset_ += n;
+	return n;
+}
+
 /** @class WebviewRestApi <webview/rest_api.h>
  * Webview REST API component.
  * This class represents a specific REST API available through Webview.
  * The API's name will be part of the URL, e.g., '/api/[COMPONENT-NAME]/...'.
  * The REST API can process patterns according to the OpenAPI 3 specification.
+ *
+ * The handlers of an API are serialized with the handlers of all other
+ * APIs, unless the API has been marked concurrent with set_concurrent().
  * @author Tim Niemueller
  */
 
@@ -42,6 +95,7 @@ WebviewRestApi::WebviewRestApi(const std::string &name, fawkes::Logger *logger)
 : name_(name),
   logger_(logger),
   pretty_json_(false),
+  concurrent_(false),
   router_{std::make_shared<WebviewRouter<Handler>>()}
 {
 }
@@ -69,7 +123,23 @@ WebviewRestApi::process_request(const WebRequest *request, const std::string &re
 		WebviewRestParams params;
 		params.set_path_args(std::move(path_args));
 		params.set_query_args(request->get_values());
+		for (const auto &h : request->headers()) {
+			if (strcasecmp(h.first.c_str(), "If-None-Match") == 0) {
+				params.set_if_none_match(h.second);
+			}
+		}
 		std::unique_ptr<WebReply> reply = handler(request->body(), params);
+		if (reply && !params.etag().empty()) {
+			if (params.etag_matches() && reply->code() < WebReply::HTTP_MULTIPLE_CHOICES) {
+				reply = std::make_unique<WebviewRestReply>(WebReply::HTTP_NOT_MODIFIED);
+			}
+			if (reply->code() < WebReply::HTTP_BAD_REQUEST) {
+				// allow the client to keep the reply, but revalidate on every use
+				reply->set_caching(true);
+				reply->add_header("Cache-Control", "no-cache");
+				reply->add_header("ETag", params.etag());
+			}
+		}
 		return reply.release();
 	} catch (NullPointerException &e) {
 		return NULL;
@@ -96,4 +166,26 @@ WebviewRestApi::set_pretty_json(bool pretty)
 	pretty_json_ = pretty;
 }
 
+/** Allow concurrent execution of handlers.
+ * Only enable this if all handlers of the API protect any state they
+ * share, as they are then called from several threads at the same time.
+ * Must be called before the API is registered.
+ * @param concurrent true to run handlers concurrently, false to serialize
+ * them with the handlers of other APIs
+ */
+void
+WebviewRestApi::set_concurrent(bool concurrent)
+{
+	concurrent_ = concurrent;
+}
+
+/** Check if handlers may run concurrently.
+ * @return true if handlers may run concurrently, false otherwise
+ */
+bool
+WebviewRestApi::concurrent() const
+{
+	return concurrent_;
+}
+
 } // end of namespace fawkes
@@ -27,6 +27,7 @@
 #include <utils/misc/string_split.h>
 #include <webview/reply.h>
 #include <webview/request.h>
+#include <webview/rest_array.h>
 
 #include <algorithm>
 #include <functional>
@@ -62,6 +63,39 @@ public:
 	}
 };
 
+/** Streaming REST reply via Webview.
+ * The body is produced incrementally while it is being sent and
+ * transmitted with chunked transfer encoding. Use it for large replies
+ * which should not be assembled in memory as a whole.
+ * @author agent
+ */
+class WebviewRestStreamReply : public DynamicWebReply
+{
+public:
+	/** Producer function type.
+	 * The producer is called repeatedly and appends the next piece of the
+	 * body to the given string. It returns true if more data follows, or
+	 * false if this was the last piece. A producer which has no data
+	 * available right now may return true without appending anything, it
+	 * is called again later. It should then wait for a short time before
+	 * returning to avoid busy looping.
+	 */
+	typedef std::function<bool(std::string &)> Producer;
+
+	WebviewRestStreamReply(WebReply::Code     code,
+	                       Producer           producer,
+	                       const std::string &content_type = "application/json");
+
+	virtual size_t size();
+	virtual size_t next_chunk(size_t pos, char *buffer, size_t buf_max_size);
+
+private:
+	Producer    producer_;
+	std::string buffer_;
+	size_t      buffer_offset_;
+	bool        done_;
+};
+
 /** REST processing exception.
  * Use to indicate failure with more specific response. The HTTP code
  * will be used for the static response with the formatted error message.
@@ -185,6 +219,56 @@ public:
 		return pretty_json_;
 	}
 
+	/** Set entity tag of the requested resource.
+	 * Handlers which can cheaply determine whether a resource has changed,
+	 * for example from the timestamp of an interface, should set a tag
+	 * which changes whenever the resource does. The tag is sent to the
+	 * client in the ETag header. If the client already has the current
+	 * version, the reply is replaced by an empty 304 Not Modified reply.
+	 * @param etag entity tag, without quotes
+	 * @return true if the client already has the current version, the
+	 * handler may then skip generating the reply and throw a
+	 * WebviewRestException with code HTTP_NOT_MODIFIED.
+	 */
+	bool
+	set_etag(const std::string &etag)
+	{
+		etag_ = "\"" + etag + "\"";
+		return etag_matches();
+	}
+
+	/** Get entity tag of the requested resource.
+	 * @return quoted entity tag, empty if not set by handler
+	 */
+	const std::string &
+	etag() const
+	{
+		return etag_;
+	}
+
+	/** Check if client has the current version of the resource.
+	 * @return true if the entity tag has been set and is listed in the
+	 * If-None-Match header of the request, false otherwise
+	 */
+	bool
+	etag_matches() const
+	{
+		if (etag_.empty() || if_none_match_.empty())
+			return false;
+		if (if_none_match_ == "*")
+			return true;
+		for (const std::string &t : str_split(if_none_match_, ',')) {
+			std::string tag = t;
+			tag.erase(0, tag.find_first_not_of(" \t"));
+			tag.erase(tag.find_last_not_of(" \t") + 1);
+			if (tag.compare(0, 2, "W/") == 0)
+				tag.erase(0, 2);
+			if (tag == etag_)
+				return true;
+		}
+		return false;
+	}
+
 	/** Enable or disable pretty printed results.
 	 * Note that this only works when using the generated API
 	 * interface and classes which support the "pretty" flag.
@@ -209,8 +293,16 @@ private:
 		query_args_ = args;
 	}
 
+	void
+	set_if_none_match(const std::string &if_none_match)
+	{
+		if_none_match_ = if_none_match;
+	}
+
 private:
 	bool                               pretty_json_;
+	std::string                        etag_;
+	std::string                        if_none_match_;
 	std::map<std::string, std::string> path_args_;
 	std::map<std::string, std::string> query_args_;
 };
@@ -228,6 +320,8 @@ public:
 	const std::string &name() const;
 	void               add_handler(WebRequest::Method method, std::string path, Handler handler);
 	void               set_pretty_json(bool pretty);
+	void               set_concurrent(bool concurrent);
+	bool               concurrent() const;
 
 	/** Add simple handler.
 	 * For a handler that does not require input parameters and that outputs
@@ -288,9 +382,7 @@ public:
 				            if (m.has_query_arg("pretty")) {
 					            m.set_pretty_json(true);
 				            }
-				            return std::make_unique<WebviewRestReply>(WebReply::HTTP_OK,
-				                                                      output.to_json(pretty_json_
-				                                                                     || m.pretty_json()));
+				            return json_reply(output, pretty_json_ || m.pretty_json());
 			            } catch (WebviewRestException &e) {
 				            return std::make_unique<WebviewRestReply>(e.code(),
 				                                                      e.what_no_backtrace(),
@@ -363,9 +455,7 @@ public:
 				            if (m.has_query_arg("pretty")) {
 					            m.set_pretty_json(true);
 				            }
-				            return std::make_unique<WebviewRestReply>(WebReply::HTTP_OK,
-				                                                      output.to_json(pretty_json_
-				                                                                     || m.pretty_json()));
+				            return json_reply(output, pretty_json_ || m.pretty_json());
 			            } catch (WebviewRestException &e) {
 				            return std::make_unique<WebviewRestReply>(e.code(),
 				                                                      e.what_no_backtrace(),
@@ -383,9 +473,38 @@ public:
 	WebReply *process_request(const WebRequest *request, const std::string &rest_url);
 
 private:
+	/** Create reply for handler output.
+	 * @param output output object to serialize
+	 * @param pretty true to enable pretty printing
+	 * @return reply with the JSON representation of @p output
+	 */
+	template <class O>
+	static std::unique_ptr<WebReply>
+	json_reply(O &output, bool pretty)
+	{
+		return std::make_unique<WebviewRestReply>(WebReply::HTTP_OK, output.to_json(pretty));
+	}
+
+	/** Create streaming reply for array output.
+	 * Arrays may be large, e.g., lists of all interfaces or facts. They
+	 * are serialized element by element while the reply is being sent.
+	 * @param output output array to serialize, the items are moved to
+	 * the reply
+	 * @param pretty true to enable pretty printing
+	 * @return streaming reply with the JSON representation of @p output
+	 */
+	template <class M>
+	static std::unique_ptr<WebReply>
+	json_reply(WebviewRestArray<M> &output, bool pretty)
+	{
+		return std::make_unique<WebviewRestStreamReply>(WebReply::HTTP_OK, output.json_producer(pretty));
+	}
+
+
 	std::string                             name_;
 	fawkes::Logger *                        logger_;
 	bool                                    pretty_json_;
+	bool                                    concurrent_;
 	std::shared_ptr<WebviewRouter<Handler>> router_;
 };
 
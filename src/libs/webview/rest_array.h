@@ -25,8 +25,11 @@
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <functional>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 /** Container to return array via REST.
  * @author Tim Niemueller
@@ -71,6 +74,38 @@ public:
 		return rv;
 	}
 
+	/** Get function to render object to JSON incrementally.
+	 * The returned function appends the JSON representation of one item
+	 * per call to the given string. It returns false once the array has
+	 * been closed. The items are moved into the function, the array is
+	 * empty afterwards.
+	 * @param pretty true to enable pretty printing (readable spacing)
+	 * @return producer function
+	 */
+	std::function<bool(std::string &)>
+	json_producer(bool pretty = false)
+	{
+		auto   items = std::make_shared<std::vector<M>>(std::move(items_));
+		size_t i     = 0;
+		items_.clear();
+		return [items, pretty, i](std::string &chunk) mutable -> bool {
+			if (i == 0) {
+				chunk += "[\n";
+			}
+			if (i < items->size()) {
+				chunk += (*items)[i].to_json(pretty);
+				if (i < items->size() - 1) {
+					chunk += ",";
+				}
+			}
+			if (++i >= items->size()) {
+				chunk += "]";
+				return false;
+			}
+			return true;
+		};
+	}
+
 	/** Retrieve data from JSON string.
 	 * @param json JSON representation suitable for this object.
 	 * Will allow partial assignment and not validate automaticaly.
@@ -64,6 +64,9 @@ WebServer::WebServer(unsigned short int    port,
 
 	tls_enabled_ = false;
 	num_threads_ = 1;
+
+	worker_threads_          = 0;
+	worker_max_queue_length_ = 0;
 }
 
 /** Setup Transport Layer Security (encryption),
@@ -134,6 +137,29 @@ WebServer::setup_thread_pool(unsigned int num_threads)
 	return *this;
 }
 
+/** Setup worker pool for long-running requests.
+ * Requests whose URL starts with one of the given paths are not
+ * processed in the threads of the server, but in a separate pool of
+ * worker threads. This keeps the server responsive for other requests
+ * while, for example, a large data dump is produced.
+ * @param num_threads number of worker threads, zero to disable the pool
+ * @param max_queue_length maximum number of requests waiting for a
+ * worker, further requests are rejected as unavailable
+ * @param heavy_paths URL prefixes of requests to process in the pool
+ * @return *this to allow for chaining
+ */
+WebServer &
+WebServer::setup_worker_pool(unsigned int               num_threads,
+                             unsigned int               max_queue_length,
+                             std::vector<std::string> &&heavy_paths)
+{
+	worker_threads_          = num_threads;
+	worker_max_queue_length_ = max_queue_length;
+	worker_heavy_paths_      = std::move(heavy_paths);
+
+	return *this;
+}
+
 /** Start daemon and enable processing requests.
  */
 void
@@ -163,6 +189,17 @@ WebServer::start()
 		flags |= MHD_USE_SELECT_INTERNALLY;
 	}
 
+	if (worker_threads_ > 0 && !worker_heavy_paths_.empty()) {
+#if MHD_VERSION >= 0x00095208
+		flags |= MHD_ALLOW_SUSPEND_RESUME;
+#elif MHD_VERSION >= 0x00093400
+		flags |= MHD_USE_SUSPEND_RESUME;
+#endif
+		dispatcher_->setup_worker_pool(worker_threads_,
+		                               worker_max_queue_length_,
+		                               std::move(worker_heavy_paths_));
+	}
+
 	size_t num_options = 3 + (num_threads_ > 1 ? 1 : 0) + (tls_enabled_ ? 3 : 0);
 
 	size_t                cur_op = 0;
@@ -210,6 +247,8 @@ WebServer::~WebServer()
 		request_manager_->set_server(NULL);
 	}
 
+	// suspended connections must be resumed before stopping the daemon
+	dispatcher_->stop_worker_pool();
 	MHD_stop_daemon(daemon_);
 	daemon_     = NULL;
 	dispatcher_ = NULL;
@@ -310,6 +349,17 @@ WebServer::last_request_completion_time() const
 	return dispatcher_->last_request_completion_time();
 }
 
+/** Get statistics of the worker pool.
+ * @param stats upon return contains the request queue statistics
+ * @return true if a worker pool is used and @p stats has been set,
+ * false otherwise
+ */
+bool
+WebServer::worker_pool_stats(WebRequestWorkerPool::Stats &stats) const
+{
+	return dispatcher_->worker_pool_stats(stats);
+}
+
 /** Process requests.
  * This method waits for new requests and processes them when
  * received. It is necessary to call this function if running the
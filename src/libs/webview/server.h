@@ -23,6 +23,7 @@
 #define _LIBS_WEBVIEW_SERVER_H_
 
 #include <sys/types.h>
+#include <webview/worker_pool.h>
 
 #include <memory>
 #include <string>
@@ -51,6 +52,9 @@ public:
 	                     const char *cipher_suite = WEBVIEW_DEFAULT_CIPHERS);
 	WebServer &setup_ipv(bool enable_ipv4, bool enable_ipv6);
 	WebServer &setup_thread_pool(unsigned int num_threads);
+	WebServer &setup_worker_pool(unsigned int               num_threads,
+	                             unsigned int               max_queue_length,
+	                             std::vector<std::string> &&heavy_paths);
 
 	WebServer &setup_cors(bool allow_all, std::vector<std::string> &&origins, unsigned int max_age);
 	WebServer &setup_basic_auth(const char *realm, WebUserVerifier *verifier);
@@ -62,6 +66,7 @@ public:
 
 	unsigned int active_requests() const;
 	Time         last_request_completion_time() const;
+	bool         worker_pool_stats(WebRequestWorkerPool::Stats &stats) const;
 
 private:
 	std::string read_file(const char *filename);
@@ -85,6 +90,10 @@ private:
 	bool                     cors_allow_all_;
 	std::vector<std::string> cors_origins_;
 	unsigned int             cors_max_age_;
+
+	unsigned int             worker_threads_;
+	unsigned int             worker_max_queue_length_;
+	std::vector<std::string> worker_heavy_paths_;
 };
 
 } // end namespace fawkes
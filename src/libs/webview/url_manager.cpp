@@ -22,6 +22,8 @@
 
 #include <core/exception.h>
 #include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/read_write_lock.h>
 #include <webview/url_manager.h>
 
 namespace fawkes {
@@ -30,11 +32,24 @@ namespace fawkes {
  * Manage URL mappings.
  * This class maps (base) URLs to web request processors which handle all
  * requests for the given URL.
+ *
+ * Requests are processed concurrently if the web server runs a thread
+ * pool. Handlers are executed with a read lock held, adding or removing
+ * a handler waits until running handlers have completed. A handler must
+ * therefore not add or remove handlers itself.
+ *
+ * Handlers are serialized with each other by default, since most of them
+ * have been written for a single request at a time. Only handlers which
+ * have been added as concurrent, because they protect their own state,
+ * run in parallel with any other handler.
  * @author Tim Niemueller
  */
 
 /** Constructor. */
-WebUrlManager::WebUrlManager() : router_(std::make_shared<WebviewRouter<Handler>>())
+WebUrlManager::WebUrlManager()
+: rwlock_(new ReadWriteLock()),
+  serial_mutex_(new Mutex()),
+  router_(std::make_shared<WebviewRouter<Handler>>())
 {
 }
 
@@ -44,6 +59,7 @@ WebUrlManager::~WebUrlManager()
 }
 
 /** Add a request processor.
+ * The handler is serialized with all other non-concurrent handlers.
  * @param method HTTP method to register for
  * @param path path pattern to register for, may contain {var}, {var*}, and {var+} elements
  * @param handler handler function
@@ -53,8 +69,7 @@ WebUrlManager::~WebUrlManager()
 void
 WebUrlManager::add_handler(WebRequest::Method method, const std::string &path, Handler handler)
 {
-	std::lock_guard<std::mutex> lock(mutex_);
-	router_->add(method, path, handler, 0);
+	add_handler(method, path, handler, 0);
 }
 
 /** Add a request processor with weight.
@@ -63,6 +78,9 @@ WebUrlManager::add_handler(WebRequest::Method method, const std::string &path, H
  * @param path path pattern to register for, may contain {var}, {var*}, and {var+} elements
  * @param handler handler function
  * @param weight the higher the weight the later the handler will be tried.
+ * @param concurrent true if the handler may be called from several threads
+ * at the same time, false to serialize it with all other non-concurrent
+ * handlers
  * @exception Exception thrown if a processor has already been registered
  * for the given URL prefix.
  */
@@ -70,10 +88,24 @@ void
 WebUrlManager::add_handler(WebRequest::Method method,
                            const std::string &path,
                            Handler            handler,
-                           int                weight)
+                           int                weight,
+                           bool               concurrent)
 {
-	std::lock_guard<std::mutex> lock(mutex_);
-	router_->add(method, path, handler, weight);
+	if (!concurrent) {
+		Handler serialized = [mutex = serial_mutex_.get(), handler](const WebRequest *request) {
+			MutexLocker lock(mutex);
+			return handler(request);
+		};
+		handler = serialized;
+	}
+	rwlock_->lock_for_write();
+	try {
+		router_->add(method, path, handler, weight);
+	} catch (Exception &e) {
+		rwlock_->unlock();
+		throw;
+	}
+	rwlock_->unlock();
 }
 
 /** Remove a request processor.
@@ -83,28 +115,35 @@ WebUrlManager::add_handler(WebRequest::Method method,
 void
 WebUrlManager::remove_handler(WebRequest::Method method, const std::string &path)
 {
-	std::lock_guard<std::mutex> lock(mutex_);
+	rwlock_->lock_for_write();
 	router_->remove(method, path);
+	rwlock_->unlock();
 }
 
-/** Lock mutex and find processor.
- * This method determines if a processor has been registered for the URL.
- * It is the callers duty to ensure that the mutex has been locked while
- * searching and while using the found processor.
- * @param url url to get the processor for
- * @return request processor if found, NULL otherwise
+/** Find handler and process request.
+ * The read lock is held while the handler executes, so that it cannot be
+ * removed meanwhile, but other requests can be processed concurrently if
+ * the handler has been added as concurrent.
+ * @param request request to process
+ * @return reply of the handler, NULL if no handler was found
  */
 WebReply *
 WebUrlManager::process_request(WebRequest *request)
 {
-	std::lock_guard<std::mutex> lock(mutex_);
+	rwlock_->lock_for_read();
 	try {
 		std::map<std::string, std::string> path_args;
 		Handler                            handler = router_->find_handler(request, path_args);
 		request->set_path_args(std::move(path_args));
-		return handler(request);
+		WebReply *reply = handler(request);
+		rwlock_->unlock();
+		return reply;
 	} catch (NullPointerException &e) {
+		rwlock_->unlock();
 		return NULL;
+	} catch (...) {
+		rwlock_->unlock();
+		throw;
 	}
 }
 
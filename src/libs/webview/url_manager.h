@@ -27,11 +27,12 @@
 #include <webview/router.h>
 
 #include <list>
-#include <mutex>
+#include <memory>
 
 namespace fawkes {
 
 class Mutex;
+class ReadWriteLock;
 class WebReply;
 template <typename T>
 class WebviewRouter;
@@ -50,13 +51,18 @@ public:
 	void add_handler(WebRequest::Method method, const std::string &path, Handler handler);
 	void remove_handler(WebRequest::Method method, const std::string &path);
 
-	void add_handler(WebRequest::Method method, const std::string &path, Handler handler, int weight);
+	void add_handler(WebRequest::Method method,
+	                 const std::string &path,
+	                 Handler            handler,
+	                 int                weight,
+	                 bool               concurrent = false);
 
 private:
 	WebReply *process_request(WebRequest *request);
 
 private:
-	std::mutex                              mutex_;
+	std::unique_ptr<ReadWriteLock>          rwlock_;
+	std::unique_ptr<Mutex>                  serial_mutex_;
 	std::shared_ptr<WebviewRouter<Handler>> router_;
 };
 
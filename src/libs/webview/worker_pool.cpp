@@ -0,0 +1,151 @@
+
+/***************************************************************************
+ *  worker_pool.cpp - Worker pool for long-running web requests
+ *
+ *  Created: Thu Oct 15 08:49:14 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <webview/worker_pool.h>
+
+#include <algorithm>
+
+namespace fawkes {
+
+/** @class WebRequestWorkerPool <webview/worker_pool.h>
+ * Worker pool for long-running web requests.
+ * Requests which take long to process, e.g. dumping a large CLIPS fact
+ * base, are executed in this pool instead of in the threads of the web
+ * server, which then remain available for fast requests. Jobs are
+ * processed in the order they have been enqueued. The number of waiting
+ * jobs is bounded, further jobs are rejected.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param num_threads number of worker threads to start
+ * @param max_queue_length maximum number of jobs waiting for a worker
+ */
+WebRequestWorkerPool::WebRequestWorkerPool(unsigned int num_threads,
+                                           unsigned int max_queue_length)
+: stopping_(false), max_queue_length_(max_queue_length), stats_()
+{
+	if (num_threads == 0) {
+		throw Exception("Worker pool requires at least one thread");
+	}
+	stats_.num_threads = num_threads;
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		threads_.emplace_back(&WebRequestWorkerPool::run, this);
+	}
+}
+
+/** Destructor.
+ * Waits for all queued jobs to be completed.
+ */
+WebRequestWorkerPool::~WebRequestWorkerPool()
+{
+	stop();
+}
+
+/** Enqueue a job.
+ * @param job job to execute in a worker thread
+ * @return true if the job has been enqueued, false if the queue is full
+ * or the pool is stopping
+ */
+bool
+WebRequestWorkerPool::enqueue(Job job)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (stopping_ || queue_.size() >= max_queue_length_) {
+		stats_.num_rejected += 1;
+		return false;
+	}
+	queue_.push_back(std::make_pair(std::move(job), Clock::now()));
+	stats_.max_queue_length = std::max(stats_.max_queue_length, (unsigned int)queue_.size());
+	cond_.notify_one();
+	return true;
+}
+
+/** Stop the pool.
+ * No further jobs are accepted. Blocks until all queued jobs have been
+ * completed and the worker threads have exited.
+ */
+void
+WebRequestWorkerPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+		cond_.notify_all();
+	}
+	for (auto &t : threads_) {
+		if (t.joinable())
+			t.join();
+	}
+	threads_.clear();
+}
+
+/** Get queue statistics.
+ * @return current statistics
+ */
+WebRequestWorkerPool::Stats
+WebRequestWorkerPool::stats() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	Stats                       s = stats_;
+	s.queue_length                = queue_.size();
+	return s;
+}
+
+void
+WebRequestWorkerPool::run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		cond_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+		if (queue_.empty()) {
+			// stopping and all jobs done
+			return;
+		}
+
+		Job               job      = std::move(queue_.front().first);
+		Clock::time_point enqueued = queue_.front().second;
+		queue_.pop_front();
+		stats_.num_running += 1;
+		lock.unlock();
+
+		Clock::time_point start = Clock::now();
+		try {
+			job();
+		} catch (...) {
+		} // jobs must handle their errors, do not let them kill the worker
+		Clock::time_point end = Clock::now();
+
+		lock.lock();
+		double wait_sec = std::chrono::duration<double>(start - enqueued).count();
+		double exec_sec = std::chrono::duration<double>(end - start).count();
+		stats_.num_running -= 1;
+		stats_.num_processed += 1;
+		stats_.total_wait_sec += wait_sec;
+		stats_.total_exec_sec += exec_sec;
+		stats_.max_wait_sec = std::max(stats_.max_wait_sec, wait_sec);
+		stats_.max_exec_sec = std::max(stats_.max_exec_sec, exec_sec);
+	}
+}
+
+} // end namespace fawkes
@@ -0,0 +1,85 @@
+
+/***************************************************************************
+ *  worker_pool.h - Worker pool for long-running web requests
+ *
+ *  Created: Thu Oct 15 08:49:14 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _LIBS_WEBVIEW_WORKER_POOL_H_
+#define _LIBS_WEBVIEW_WORKER_POOL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fawkes {
+
+class WebRequestWorkerPool
+{
+public:
+	/** Job to run in the pool. */
+	typedef std::function<void()> Job;
+
+	/** Statistics of the request queue. */
+	typedef struct
+	{
+		unsigned int num_threads;      ///< number of worker threads
+		unsigned int queue_length;     ///< number of jobs waiting for a worker
+		unsigned int max_queue_length; ///< maximum queue length seen
+		unsigned int num_running;      ///< number of jobs currently running
+		uint64_t     num_processed;    ///< number of completed jobs
+		uint64_t     num_rejected;     ///< number of jobs rejected because the queue was full
+		double       total_wait_sec;   ///< accumulated time jobs waited for a worker
+		double       max_wait_sec;     ///< maximum time a job waited for a worker
+		double       total_exec_sec;   ///< accumulated execution time of jobs
+		double       max_exec_sec;     ///< maximum execution time of a job
+	} Stats;
+
+	WebRequestWorkerPool(unsigned int num_threads, unsigned int max_queue_length);
+	~WebRequestWorkerPool();
+
+	bool  enqueue(Job job);
+	void  stop();
+	Stats stats() const;
+
+private:
+	void run();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	mutable std::mutex       mutex_;
+	std::condition_variable  cond_;
+	std::vector<std::thread> threads_;
+	bool                     stopping_;
+
+	std::deque<std::pair<Job, Clock::time_point>> queue_;
+	unsigned int                                  max_queue_length_;
+
+	Stats stats_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -103,7 +103,8 @@ AmclThread::~AmclThread()
 void
 AmclThread::init()
 {
-	map_ = NULL;
+	map_         = NULL;
+	range_table_ = NULL;
 
 	fawkes::amcl::read_map_config(config,
 	                              cfg_map_file_,
@@ -125,13 +126,44 @@ AmclThread::init()
 	} catch (Exception &e) {
 	} // ignore, use default
 
-	map_        = fawkes::amcl::read_map(cfg_map_file_.c_str(),
-                                cfg_origin_x_,
-                                cfg_origin_y_,
-                                cfg_resolution_,
-                                cfg_occupied_thresh_,
-                                cfg_free_thresh_,
-                                free_space_indices);
+	bool cfg_map_cache = false;
+	try {
+		cfg_map_cache = config->get_bool(AMCL_CFG_PREFIX "map_cache");
+	} catch (Exception &e) {
+	} // ignored, use default
+
+	if (cfg_map_cache) {
+		std::string cfg_map_cache_file = cfg_map_file_ + ".cache";
+		try {
+			cfg_map_cache_file = config->get_string(AMCL_CFG_PREFIX "map_cache_file");
+		} catch (Exception &e) {
+		} // ignored, use default
+
+		float max_occ_dist = config->get_float(AMCL_CFG_PREFIX "laser_likelihood_max_dist");
+		bool  cache_hit    = false;
+		map_               = fawkes::amcl::read_map_cached(cfg_map_file_.c_str(),
+                                             cfg_map_cache_file.c_str(),
+                                             cfg_origin_x_,
+                                             cfg_origin_y_,
+                                             cfg_resolution_,
+                                             cfg_occupied_thresh_,
+                                             cfg_free_thresh_,
+                                             max_occ_dist,
+                                             free_space_indices,
+                                             cache_hit);
+		logger->log_info(name(),
+		                 "%s map cache %s",
+		                 cache_hit ? "Loaded" : "Created",
+		                 cfg_map_cache_file.c_str());
+	} else {
+		map_ = fawkes::amcl::read_map(cfg_map_file_.c_str(),
+		                              cfg_origin_x_,
+		                              cfg_origin_y_,
+		                              cfg_resolution_,
+		                              cfg_occupied_thresh_,
+		                              cfg_free_thresh_,
+		                              free_space_indices);
+	}
 	map_width_  = map_->size_x;
 	map_height_ = map_->size_y;
 
@@ -311,6 +343,13 @@ AmclThread::init()
 	pf_->pop_err = pf_err_;
 	pf_->pop_z   = pf_z_;
 
+	bool cfg_low_variance = false;
+	try {
+		cfg_low_variance = config->get_bool(AMCL_CFG_PREFIX "resample_low_variance");
+	} catch (Exception &e) {
+	} // ignored, use default
+	pf_->resample_low_variance = cfg_low_variance ? 1 : 0;
+
 	// Initialize the filter
 
 	pf_vector_t pf_init_pose_mean = pf_vector_zero();
@@ -348,8 +387,50 @@ AmclThread::init()
 	// Laser
 	laser_ = new ::amcl::AMCLLaser(max_beams_, map_);
 
+	bool parallel_laser_model = false;
+	try {
+		parallel_laser_model = config->get_bool(AMCL_CFG_PREFIX "laser_parallel");
+	} catch (Exception &e) {
+	} // ignored, use default
+	laser_->SetParallel(parallel_laser_model);
+
 	if (laser_model_type_ == ::amcl::LASER_MODEL_BEAM) {
 		laser_->SetModelBeam(z_hit_, z_short_, z_max_, z_rand_, sigma_hit_, lambda_short_, 0.0);
+
+		bool cfg_range_table = false;
+		try {
+			cfg_range_table = config->get_bool(AMCL_CFG_PREFIX "laser_range_table/enable");
+		} catch (Exception &e) {
+		} // ignored, use default
+		if (cfg_range_table && laser_max_range_ > 0.) {
+			unsigned int cfg_angle_bins = 180;
+			unsigned int cfg_max_memory = 512;
+			try {
+				cfg_angle_bins = config->get_uint(AMCL_CFG_PREFIX "laser_range_table/angle_bins");
+			} catch (Exception &e) {
+			} // ignored, use default
+			try {
+				cfg_max_memory = config->get_uint(AMCL_CFG_PREFIX "laser_range_table/max_memory");
+			} catch (Exception &e) {
+			} // ignored, use default
+
+			logger->log_info(name(), "Computing range table, this can take some time on large maps...");
+			range_table_ = map_range_table_alloc(map_,
+			                                     cfg_angle_bins,
+			                                     laser_max_range_,
+			                                     (size_t)cfg_max_memory * 1024 * 1024);
+			if (range_table_) {
+				logger->log_info(name(),
+				                 "Range table with %i angle bins uses %zu MB",
+				                 range_table_->angle_bins,
+				                 map_range_table_size(range_table_) / (1024 * 1024));
+				laser_->SetRangeTable(range_table_);
+			} else {
+				logger->log_warn(name(),
+				                 "Range table does not fit into %u MB, casting rays",
+				                 cfg_max_memory);
+			}
+		}
 	} else {
 		logger->log_info(name(),
 		                 "Initializing likelihood field model; "
@@ -881,6 +962,10 @@ AmclThread::finalize()
 	delete last_move_time_;
 	delete odom_;
 	delete laser_;
+	if (range_table_) {
+		map_range_table_free(range_table_);
+		range_table_ = NULL;
+	}
 
 	blackboard->close(laser_if_);
 	blackboard->close(pos3d_if_);
@@ -142,7 +142,8 @@ private:
 
 	bool   sent_first_transform_;
 	bool   latest_tf_valid_;
-	map_t *map_;
+	map_t *            map_;
+	map_range_table_t *range_table_;
 	pf_t * pf_;
 	int    resample_count_;
 
@@ -21,8 +21,11 @@
 #include "amcl_utils.h"
 
 #include <config/config.h>
+#include <core/exception.h>
 #include <fvutils/readers/png.h>
 
+#include <cerrno>
+#include <cstdio>
 #include <cstdlib>
 
 using namespace firevision;
@@ -92,6 +95,127 @@ read_map(const char *                      map_file,
 	return map;
 }
 
+// FNV-1a 64 bit hash
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static uint64_t
+fnv1a(uint64_t hash, const void *data, size_t size)
+{
+	const unsigned char *d = (const unsigned char *)data;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= d[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+/** Compute map cache key.
+ * The key is a hash over the contents of the map file and all
+ * parameters that influence the processed map.
+ * @param map_file filename of map
+ * @param origin_x origin x offset
+ * @param origin_y origin y offset
+ * @param resolution map resolution
+ * @param occupied_threshold minimum threshold when to consider a cell occupied
+ * @param free_threshold maximum threshold when to consider a cell free
+ * @param max_occ_dist maximum distance for cspace distances
+ * @return cache key
+ * @exception Exception thrown if the map file cannot be read
+ */
+uint64_t
+map_cache_key(const char *map_file,
+              float       origin_x,
+              float       origin_y,
+              float       resolution,
+              float       occupied_threshold,
+              float       free_threshold,
+              double      max_occ_dist)
+{
+	FILE *f = fopen(map_file, "rb");
+	if (!f) {
+		throw Exception(errno, "Failed to open map file %s", map_file);
+	}
+
+	uint64_t      hash = FNV_OFFSET_BASIS;
+	unsigned char buf[65536];
+	size_t        bytes;
+	while ((bytes = fread(buf, 1, sizeof(buf), f)) > 0) {
+		hash = fnv1a(hash, buf, bytes);
+	}
+	bool failed = ferror(f);
+	fclose(f);
+	if (failed) {
+		throw Exception("Failed to read map file %s", map_file);
+	}
+
+	hash = fnv1a(hash, &origin_x, sizeof(origin_x));
+	hash = fnv1a(hash, &origin_y, sizeof(origin_y));
+	hash = fnv1a(hash, &resolution, sizeof(resolution));
+	hash = fnv1a(hash, &occupied_threshold, sizeof(occupied_threshold));
+	hash = fnv1a(hash, &free_threshold, sizeof(free_threshold));
+	hash = fnv1a(hash, &max_occ_dist, sizeof(max_occ_dist));
+	return hash;
+}
+
+/** Read map using a cache file.
+ * If the cache file exists and matches the map file and parameters
+ * the map is mapped into memory from the cache file, including the
+ * cspace distances. Otherwise the map is read from the map file, the
+ * cspace distances are computed, and the result is stored in the cache
+ * file. Failing to write the cache file is not an error.
+ * @param map_file filename of map
+ * @param cache_file filename of cache file
+ * @param origin_x origin x offset
+ * @param origin_y origin y offset
+ * @param resolution map resolution
+ * @param occupied_threshold minimum threshold when to consider a cell occupied
+ * @param free_threshold maximum threshold when to consider a cell free
+ * @param max_occ_dist maximum distance for cspace distances, if zero
+ * no cspace distances are computed
+ * @param free_space_indices upon return contains indices of free cells
+ * @param cache_hit upon return true if the map was read from the cache file
+ * @return loaded map
+ */
+map_t *
+read_map_cached(const char *                      map_file,
+                const char *                      cache_file,
+                float                             origin_x,
+                float                             origin_y,
+                float                             resolution,
+                float                             occupied_threshold,
+                float                             free_threshold,
+                double                            max_occ_dist,
+                std::vector<std::pair<int, int>> &free_space_indices,
+                bool &                            cache_hit)
+{
+	uint64_t key = map_cache_key(
+	  map_file, origin_x, origin_y, resolution, occupied_threshold, free_threshold, max_occ_dist);
+
+	map_t *map = map_cache_load(cache_file, key);
+	cache_hit  = (map != NULL);
+	if (map) {
+		// same order as read_map(), top to bottom in image coordinates
+		for (int j = map->size_y - 1; j >= 0; --j) {
+			for (int i = 0; i < map->size_x; ++i) {
+				if (map->cells[MAP_IDX(map->size_x, i, j)].occ_state == -1) {
+					free_space_indices.push_back(std::make_pair(i, j));
+				}
+			}
+		}
+		return map;
+	}
+
+	map = read_map(
+	  map_file, origin_x, origin_y, resolution, occupied_threshold, free_threshold, free_space_indices);
+	if (max_occ_dist > 0.) {
+		map_update_cspace(map, max_occ_dist);
+	}
+	map_cache_save(map, cache_file, key);
+
+	return map;
+}
+
 /** Read map configuration.
  * @param config configuration to read from
  * @param cfg_map_file upon returns contains map filename
@@ -23,6 +23,7 @@
 
 #include "map/map.h"
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,25 @@ map_t *read_map(const char *                      map_file,
                 float                             free_threshold,
                 std::vector<std::pair<int, int>> &free_space_indices);
 
+uint64_t map_cache_key(const char *map_file,
+                       float       origin_x,
+                       float       origin_y,
+                       float       resolution,
+                       float       occupied_threshold,
+                       float       free_threshold,
+                       double      max_occ_dist);
+
+map_t *read_map_cached(const char *                      map_file,
+                       const char *                      cache_file,
+                       float                             origin_x,
+                       float                             origin_y,
+                       float                             resolution,
+                       float                             occupied_threshold,
+                       float                             free_threshold,
+                       double                            max_occ_dist,
+                       std::vector<std::pair<int, int>> &free_space_indices,
+                       bool &                            cache_hit);
+
 void read_map_config(Configuration *    config,
                      std::string &      cfg_map_file,
                      float &            cfg_resolution,
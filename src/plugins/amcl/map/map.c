@@ -36,6 +36,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <sys/mman.h>
 
 #include "map.h"
 
@@ -59,6 +60,13 @@ map_t *map_alloc(void)
   
   // Allocate storage for main map
   map->cells = (map_cell_t*) NULL;
+
+  // No cspace computed, yet
+  map->max_occ_dist = 0;
+  map->cspace_valid = 0;
+
+  map->mapping = NULL;
+  map->mapping_size = 0;
   
   return map;
 }
@@ -67,7 +75,10 @@ map_t *map_alloc(void)
 // Destroy a map
 void map_free(map_t *map)
 {
-  free(map->cells);
+  if (map->mapping)
+    munmap(map->mapping, map->mapping_size);
+  else
+    free(map->cells);
   free(map);
   return;
 }
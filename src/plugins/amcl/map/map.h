@@ -35,6 +35,7 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -82,6 +83,14 @@ typedef struct
 	// likelihood field
 	double max_occ_dist;
 
+	// Non-zero if occ_dist has been computed for max_occ_dist
+	int cspace_valid;
+
+	// File mapping the cells are stored in if loaded from a cache
+	// file, NULL if the cells have been allocated with malloc
+	void * mapping;
+	size_t mapping_size;
+
 } map_t;
 
 /**************************************************************************
@@ -106,6 +115,12 @@ int map_load_occ(map_t *map, const char *filename, double scale, int negate);
 // Update the cspace distances
 void map_update_cspace(map_t *map, double max_occ_dist);
 
+// Save map including cspace distances to a cache file
+int map_cache_save(map_t *map, const char *filename, uint64_t key);
+
+// Load a map from a cache file, NULL if missing or not matching key
+map_t *map_cache_load(const char *filename, uint64_t key);
+
 /**************************************************************************
  * Range functions
  **************************************************************************/
@@ -113,6 +128,48 @@ void map_update_cspace(map_t *map, double max_occ_dist);
 // Extract a single range reading from the map
 double map_calc_range(map_t *map, double ox, double oy, double oa, double max_range);
 
+// Precomputed ranges from every free cell for discrete angles
+typedef struct
+{
+	// Number of angle bins covering the full circle
+	int angle_bins;
+
+	// Range the table has been computed for and the range per unit
+	// of the stored values
+	double max_range, range_unit;
+
+	// Index of the first range per cell, -1 for cells that are not free
+	size_t   num_cells;
+	int32_t *cell_index;
+
+	// Ranges, angle_bins consecutive entries per free cell
+	uint16_t *ranges;
+	int       free_count;
+
+} map_range_table_t;
+
+// Create a range table with at most the given number of angle bins.
+// Less bins are used to stay within max_bytes, NULL is returned if
+// that is not possible with a useful number of bins.
+map_range_table_t *
+map_range_table_alloc(map_t *map, int angle_bins, double max_range, size_t max_bytes);
+
+// Destroy a range table
+void map_range_table_free(map_range_table_t *table);
+
+// Get the memory used by a range table in bytes
+size_t map_range_table_size(map_range_table_t *table);
+
+// Extract a single range reading from the table, the angle is rounded
+// to the nearest angle bin. Falls back to map_calc_range() if max_range
+// exceeds the range the table was computed for.
+double map_range_table_calc_range(map_range_table_t *table,
+                                  map_t *            map,
+                                  double             ox,
+                                  double             oy,
+                                  double             oa,
+                                  double             max_range);
+
 /**************************************************************************
  * GUI/diagnostic functions
  **************************************************************************/
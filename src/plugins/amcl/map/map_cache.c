@@ -0,0 +1,170 @@
+
+/***************************************************************************
+ *  map_cache.c: Binary map cache files
+ *
+ *  Created: Thu Oct 15 04:01:25 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/**************************************************************************
+ * Desc: Cache files storing a map with its cspace distances. The cells
+ *       are stored in memory layout after a fixed size header so that
+ *       the file can be mapped into memory without further processing.
+ *       Files are only valid on the machine architecture they were
+ *       written on, which is ensured by magic, version and cell size.
+ **************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "map.h"
+
+/// @cond EXTERNAL
+
+#define MAP_CACHE_MAGIC "AMCLMAP"
+#define MAP_CACHE_VERSION 1
+
+// File header, padded to 64 bytes to keep the cells aligned
+typedef struct
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t cell_size;
+  uint64_t key;
+  int32_t size_x;
+  int32_t size_y;
+  double origin_x;
+  double origin_y;
+  double scale;
+  double max_occ_dist;
+} map_cache_header_t;
+
+#define MAP_CACHE_HEADER_SIZE 64
+
+////////////////////////////////////////////////////////////////////////////
+// Save map to cache file, the file is written to a temporary file first
+// and then renamed so that concurrent readers never see a partial file
+int map_cache_save(map_t *map, const char *filename, uint64_t key)
+{
+  char header[MAP_CACHE_HEADER_SIZE];
+  map_cache_header_t *h = (map_cache_header_t *)header;
+  size_t num_cells = (size_t)map->size_x * map->size_y;
+  size_t tmp_len;
+  char *tmp_filename;
+  FILE *file;
+  int ok;
+
+  memset(header, 0, sizeof(header));
+  strcpy(h->magic, MAP_CACHE_MAGIC);
+  h->version = MAP_CACHE_VERSION;
+  h->cell_size = sizeof(map_cell_t);
+  h->key = key;
+  h->size_x = map->size_x;
+  h->size_y = map->size_y;
+  h->origin_x = map->origin_x;
+  h->origin_y = map->origin_y;
+  h->scale = map->scale;
+  h->max_occ_dist = map->cspace_valid ? map->max_occ_dist : 0.;
+
+  tmp_len = strlen(filename) + 5;
+  tmp_filename = (char *)malloc(tmp_len);
+  snprintf(tmp_filename, tmp_len, "%s.tmp", filename);
+
+  file = fopen(tmp_filename, "wb");
+  if (file == NULL)
+  {
+    fprintf(stderr, "%s: %s\n", strerror(errno), tmp_filename);
+    free(tmp_filename);
+    return -1;
+  }
+
+  ok = (fwrite(header, sizeof(header), 1, file) == 1) &&
+       (fwrite(map->cells, sizeof(map_cell_t), num_cells, file) == num_cells);
+  ok = (fclose(file) == 0) && ok;
+
+  if (!ok || rename(tmp_filename, filename) != 0)
+  {
+    fprintf(stderr, "%s: %s\n", strerror(errno), filename);
+    unlink(tmp_filename);
+    free(tmp_filename);
+    return -1;
+  }
+
+  free(tmp_filename);
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Load map from cache file. The file is mapped copy-on-write, modifying
+// the cells does not modify the file.
+map_t *map_cache_load(const char *filename, uint64_t key)
+{
+  int fd;
+  struct stat st;
+  void *mapping;
+  const map_cache_header_t *h;
+  size_t num_cells;
+  map_t *map;
+
+  fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < MAP_CACHE_HEADER_SIZE)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  mapping = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return NULL;
+
+  h = (const map_cache_header_t *)mapping;
+  num_cells = (size_t)h->size_x * h->size_y;
+  if (strncmp(h->magic, MAP_CACHE_MAGIC, sizeof(h->magic)) != 0 ||
+      h->version != MAP_CACHE_VERSION || h->cell_size != sizeof(map_cell_t) ||
+      h->key != key || h->size_x < 0 || h->size_y < 0 ||
+      (size_t)st.st_size != MAP_CACHE_HEADER_SIZE + num_cells * sizeof(map_cell_t))
+  {
+    munmap(mapping, st.st_size);
+    return NULL;
+  }
+
+  map = map_alloc();
+  map->size_x = h->size_x;
+  map->size_y = h->size_y;
+  map->origin_x = h->origin_x;
+  map->origin_y = h->origin_y;
+  map->scale = h->scale;
+  map->max_occ_dist = h->max_occ_dist;
+  map->cspace_valid = (h->max_occ_dist > 0.);
+  map->cells = (map_cell_t *)((char *)mapping + MAP_CACHE_HEADER_SIZE);
+  map->mapping = mapping;
+  map->mapping_size = st.st_size;
+
+  return map;
+}
+
+/// @endcond
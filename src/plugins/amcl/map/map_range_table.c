@@ -0,0 +1,235 @@
+
+/***************************************************************************
+ *  map_range_table.c: Precomputed range lookup table
+ *
+ *  Created: Thu Oct 15 04:07:12 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/**************************************************************************
+ * Desc: Range lookup table. For every free cell the range is cast once
+ *       per angle bin like map_calc_range() does from the cell center. Only
+ *       free cells are stored, a ray starting in any other cell has
+ *       zero range. Ranges are quantized to 16 bit.
+ **************************************************************************/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "map.h"
+
+/// @cond EXTERNAL
+
+// Fewer bins are too coarse to be useful
+#define MAP_RANGE_TABLE_MIN_BINS 16
+
+// Compute the cells traversed by a ray cast from the origin cell, in
+// the same order as map_calc_range(). As long as the ray starts at a
+// cell center, the traversed cells relative to the start cell do not
+// depend on the start cell. Returns the number of cells.
+static int map_range_table_ray(int x1, int y1, int *di, int *dj)
+{
+  int x, y, xstep, ystep, n;
+  int steep, deltax, deltay, error;
+
+  steep = (abs(y1) > abs(x1));
+  if (steep)
+  {
+    int tmp = x1;
+    x1 = y1;
+    y1 = tmp;
+  }
+
+  deltax = abs(x1);
+  deltay = abs(y1);
+  error = 0;
+  xstep = (0 < x1) ? 1 : -1;
+  ystep = (0 < y1) ? 1 : -1;
+
+  x = y = 0;
+  n = 0;
+  di[n] = 0;
+  dj[n++] = 0;
+
+  while (x != (x1 + xstep * 1))
+  {
+    x += xstep;
+    error += deltay;
+    if (2 * error >= deltax)
+    {
+      y += ystep;
+      error -= deltax;
+    }
+
+    di[n] = steep ? y : x;
+    dj[n++] = steep ? x : y;
+  }
+
+  return n;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Create a range table
+map_range_table_t *
+map_range_table_alloc(map_t *map, int angle_bins, double max_range, size_t max_bytes)
+{
+  map_range_table_t *table;
+  size_t num_cells, index_bytes, bins;
+  int i, j, b, free_count, ray_max;
+  int *di, *dj;
+
+  num_cells = (size_t)map->size_x * map->size_y;
+  index_bytes = num_cells * sizeof(int32_t);
+
+  free_count = 0;
+  for (i = 0; i < (int)num_cells; i++)
+    if (map->cells[i].occ_state == -1)
+      free_count++;
+
+  // Reduce the number of bins to fit into the memory budget
+  if (max_bytes <= index_bytes)
+    return NULL;
+  bins = angle_bins;
+  if (free_count > 0 && bins > (max_bytes - index_bytes) / ((size_t)free_count * sizeof(uint16_t)))
+    bins = (max_bytes - index_bytes) / ((size_t)free_count * sizeof(uint16_t));
+  // Indices into the ranges must fit into the cell index
+  if (free_count > 0 && bins > INT32_MAX / (size_t)free_count)
+    bins = INT32_MAX / (size_t)free_count;
+  if (bins < MAP_RANGE_TABLE_MIN_BINS)
+    return NULL;
+
+  table = calloc(1, sizeof(map_range_table_t));
+  table->angle_bins = bins;
+  table->max_range = max_range;
+  table->range_unit = max_range / 65535.;
+  table->num_cells = num_cells;
+  table->free_count = free_count;
+  table->cell_index = malloc(index_bytes);
+  table->ranges = malloc((size_t)free_count * bins * sizeof(uint16_t));
+
+  free_count = 0;
+  for (i = 0; i < (int)num_cells; i++)
+  {
+    if (map->cells[i].occ_state == -1)
+      table->cell_index[i] = (free_count++) * bins;
+    else
+      table->cell_index[i] = -1;
+  }
+
+  // The rays of all cells share the same cell offsets per angle bin
+  ray_max = 2 * ((int)ceil(max_range / map->scale) + 2);
+  di = malloc(ray_max * sizeof(int));
+  dj = malloc(ray_max * sizeof(int));
+
+  for (b = 0; b < table->angle_bins; b++)
+  {
+    double a = b * 2 * M_PI / table->angle_bins;
+    int x1 = (int)floor(max_range * cos(a) / map->scale + 0.5);
+    int y1 = (int)floor(max_range * sin(a) / map->scale + 0.5);
+    int n = map_range_table_ray(x1, y1, di, dj);
+
+    // Cells are independent, cast them in parallel
+    #pragma omp parallel for schedule(static)
+    for (j = 0; j < map->size_y; j++)
+    {
+      int i, k, ci, cj;
+      double r;
+
+      for (i = 0; i < map->size_x; i++)
+      {
+        int32_t index = table->cell_index[MAP_INDEX(map, i, j)];
+        if (index < 0)
+          continue;
+
+        r = max_range;
+        for (k = 1; k < n; k++)
+        {
+          ci = i + di[k];
+          cj = j + dj[k];
+          if (!MAP_VALID(map, ci, cj) || table->cell_index[MAP_INDEX(map, ci, cj)] < 0)
+          {
+            r = sqrt(di[k] * di[k] + dj[k] * dj[k]) * map->scale;
+            break;
+          }
+        }
+
+        table->ranges[index + b] = (uint16_t)floor(r / table->range_unit + 0.5);
+      }
+    }
+  }
+
+  free(di);
+  free(dj);
+
+  return table;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+// Destroy a range table
+void map_range_table_free(map_range_table_t *table)
+{
+  free(table->ranges);
+  free(table->cell_index);
+  free(table);
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+// Get the memory used by a range table
+size_t map_range_table_size(map_range_table_t *table)
+{
+  return sizeof(map_range_table_t) + table->num_cells * sizeof(int32_t) +
+         (size_t)table->free_count * table->angle_bins * sizeof(uint16_t);
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+// Extract a single range reading from the table
+double map_range_table_calc_range(map_range_table_t *table, map_t *map,
+                                  double ox, double oy, double oa, double max_range)
+{
+  int i, j, b, index;
+  double a, r;
+
+  if (max_range > table->max_range)
+    return map_calc_range(map, ox, oy, oa, max_range);
+
+  i = MAP_GXWX(map, ox);
+  j = MAP_GYWY(map, oy);
+  if (!MAP_VALID(map, i, j))
+    return 0.0;
+
+  index = table->cell_index[MAP_INDEX(map, i, j)];
+  if (index < 0)
+    return 0.0;
+
+  a = fmod(oa, 2 * M_PI);
+  if (a < 0)
+    a += 2 * M_PI;
+  b = (int)floor(a * table->angle_bins / (2 * M_PI) + 0.5);
+  if (b >= table->angle_bins)
+    b -= table->angle_bins;
+
+  r = table->ranges[index + b] * table->range_unit;
+  if (r > max_range)
+    r = max_range;
+  return r;
+}
+
+/// @endcond
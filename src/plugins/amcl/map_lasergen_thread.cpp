@@ -38,7 +38,8 @@ MapLaserGenThread::MapLaserGenThread()
   BlockedTimingAspect(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE),
   TransformAspect(TransformAspect::BOTH_DEFER_PUBLISHER, "Map Laser Odometry")
 {
-	map_ = NULL;
+	map_         = NULL;
+	range_table_ = NULL;
 }
 
 /** Destructor. */
@@ -110,6 +111,44 @@ MapLaserGenThread::init()
 	                 map_width_ * map_height_,
 	                 (float)free_space_indices.size() / (float)(map_width_ * map_height_) * 100.);
 
+	bool cfg_range_table = false;
+	try {
+		cfg_range_table = config->get_bool(AMCL_CFG_PREFIX "map-lasergen/range_table/enable");
+	} catch (Exception &e) {
+	} // ignored, use default
+	if (cfg_range_table) {
+		unsigned int cfg_angle_bins = 360;
+		unsigned int cfg_max_memory = 512;
+		float        cfg_max_range  = 30.;
+		try {
+			cfg_angle_bins = config->get_uint(AMCL_CFG_PREFIX "map-lasergen/range_table/angle_bins");
+		} catch (Exception &e) {
+		} // ignored, use default
+		try {
+			cfg_max_memory = config->get_uint(AMCL_CFG_PREFIX "map-lasergen/range_table/max_memory");
+		} catch (Exception &e) {
+		} // ignored, use default
+		try {
+			cfg_max_range = config->get_float(AMCL_CFG_PREFIX "map-lasergen/range_table/max_range");
+		} catch (Exception &e) {
+		} // ignored, use default
+
+		range_table_ = map_range_table_alloc(map_,
+		                                     cfg_angle_bins,
+		                                     cfg_max_range,
+		                                     (size_t)cfg_max_memory * 1024 * 1024);
+		if (range_table_) {
+			logger->log_info(name(),
+			                 "Range table with %i angle bins uses %zu MB",
+			                 range_table_->angle_bins,
+			                 map_range_table_size(range_table_) / (1024 * 1024));
+		} else {
+			logger->log_warn(name(),
+			                 "Range table does not fit into %u MB, casting rays",
+			                 cfg_max_memory);
+		}
+	}
+
 	laser_if_   = blackboard->open_for_writing<Laser360Interface>(cfg_laser_ifname_.c_str());
 	gt_pose_if_ = blackboard->open_for_writing<Position3DInterface>("Map LaserGen Groundtruth");
 
@@ -193,9 +232,20 @@ MapLaserGenThread::loop()
 	gt_pose_if_->write();
 
 	float dists[360];
-	for (unsigned int i = 0; i < 360; ++i) {
-		dists[i] = map_calc_range(
-		  map_, laser_pos_x_, laser_pos_y_, normalize_rad(deg2rad(i) + laser_pos_theta_), 100.);
+	if (range_table_) {
+		for (unsigned int i = 0; i < 360; ++i) {
+			dists[i] = map_range_table_calc_range(range_table_,
+			                                      map_,
+			                                      laser_pos_x_,
+			                                      laser_pos_y_,
+			                                      normalize_rad(deg2rad(i) + laser_pos_theta_),
+			                                      range_table_->max_range);
+		}
+	} else {
+		for (unsigned int i = 0; i < 360; ++i) {
+			dists[i] = map_calc_range(
+			  map_, laser_pos_x_, laser_pos_y_, normalize_rad(deg2rad(i) + laser_pos_theta_), 100.);
+		}
 	}
 #ifdef HAVE_RANDOM
 	if (cfg_add_noise_) {
@@ -222,6 +272,10 @@ MapLaserGenThread::loop()
 void
 MapLaserGenThread::finalize()
 {
+	if (range_table_) {
+		map_range_table_free(range_table_);
+		range_table_ = NULL;
+	}
 	if (map_) {
 		map_free(map_);
 		map_ = NULL;
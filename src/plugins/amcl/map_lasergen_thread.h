@@ -89,13 +89,14 @@ private:
 	fawkes::tf::Transform                 latest_tf_;
 	fawkes::tf::Stamped<fawkes::tf::Pose> laser_pose_;
 
-	float  pos_x_;
-	float  pos_y_;
-	float  pos_theta_;
-	float  laser_pos_x_;
-	float  laser_pos_y_;
-	float  laser_pos_theta_;
-	map_t *map_;
+	float              pos_x_;
+	float              pos_y_;
+	float              pos_theta_;
+	float              laser_pos_x_;
+	float              laser_pos_y_;
+	float              laser_pos_theta_;
+	map_t *            map_;
+	map_range_table_t *range_table_;
 
 	bool  cfg_add_noise_;
 	float cfg_noise_sigma_;
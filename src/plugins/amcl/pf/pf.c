@@ -78,6 +78,9 @@ pf_t *pf_alloc(int min_samples, int max_samples,
   // distrubition will be less than [err].
   pf->pop_err = 0.01;
   pf->pop_z = 3;
+
+  // KLD adaptive resampling by default
+  pf->resample_low_variance = 0;
   
   pf->current_set = 0;
   for (j = 0; j < 2; j++)
@@ -275,14 +278,11 @@ void pf_update_sensor(pf_t *pf, pf_sensor_model_fn_t sensor_fn, void *sensor_dat
 // Resample the distribution
 void pf_update_resample(pf_t *pf)
 {
-  int i;
+  int i, k, m, n;
   double total;
   pf_sample_set_t *set_a, *set_b;
   pf_sample_t *sample_a, *sample_b;
-
-  //double r,c,U;
-  //int m;
-  //double count_inv;
+  double r, step;
   double* c;
 
   double w_diff;
@@ -291,8 +291,6 @@ void pf_update_resample(pf_t *pf)
   set_b = pf->sets + (pf->current_set + 1) % 2;
 
   // Build up cumulative probability table for resampling.
-  // TODO: Replace this with a more efficient procedure
-  // (e.g., http://www.network-theory.co.uk/docs/gslref/GeneralDiscreteDistributions.html)
   c = (double*)malloc(sizeof(double)*(set_a->sample_count+1));
   c[0] = 0.0;
   for(i=0;i<set_a->sample_count;i++)
@@ -310,75 +308,85 @@ void pf_update_resample(pf_t *pf)
     w_diff = 0.0;
   //printf("w_diff: %9.6f\n", w_diff);
 
-  // Can't (easily) combine low-variance sampler with KLD adaptive
-  // sampling, so we'll take the more traditional route.
-  /*
-  // Low-variance resampler, taken from Probabilistic Robotics, p110
-  count_inv = 1.0/set_a->sample_count;
-  r = drand48() * count_inv;
-  c = set_a->samples[0].weight;
-  i = 0;
-  m = 0;
-  */
-  while(set_b->sample_count < pf->max_samples)
+  if (pf->resample_low_variance)
   {
-    sample_b = set_b->samples + set_b->sample_count++;
-
-    if(drand48() < w_diff)
-      sample_b->pose = (pf->random_pose_fn)(pf->random_pose_data);
-    else
+    // Low-variance resampler, taken from Probabilistic Robotics, p110.
+    // It cannot decide on the number of samples while drawing them,
+    // therefore determine it beforehand from the number of bins
+    // occupied by the current set, which is what resampling would
+    // yield without random samples.
+    k = set_a->kdtree->leaf_count;
+    n = pf_resample_limit(pf, k);
+    step = c[set_a->sample_count] / n;
+    r = drand48() * step;
+    i = 0;
+
+    for (m = 0; m < n; m++)
     {
-      // Can't (easily) combine low-variance sampler with KLD adaptive
-      // sampling, so we'll take the more traditional route.
-      /*
-      // Low-variance resampler, taken from Probabilistic Robotics, p110
-      U = r + m * count_inv;
-      while(U>c)
+      sample_b = set_b->samples + set_b->sample_count++;
+
+      if(drand48() < w_diff)
+        sample_b->pose = (pf->random_pose_fn)(pf->random_pose_data);
+      else
       {
-        i++;
-        // Handle wrap-around by resetting counters and picking a new random
-        // number
-        if(i >= set_a->sample_count)
-        {
-          r = drand48() * count_inv;
-          c = set_a->samples[0].weight;
-          i = 0;
-          m = 0;
-          U = r + m * count_inv;
-          continue;
-        }
-        c += set_a->samples[i].weight;
+        while (i < set_a->sample_count - 1 && c[i+1] <= r + m * step)
+          i++;
+        sample_b->pose = set_a->samples[i].pose;
       }
-      m++;
-      */
 
-      // Naive discrete event sampler
-      double r;
-      r = drand48();
-      for(i=0;i<set_a->sample_count;i++)
+      sample_b->weight = 1.0;
+      total += sample_b->weight;
+
+      // Add sample to histogram
+      pf_kdtree_insert(set_b->kdtree, sample_b->pose, sample_b->weight);
+    }
+  }
+  else
+  {
+    // KLD adaptive sampling, drawing samples independently until
+    // there are enough for the number of occupied bins.
+    while(set_b->sample_count < pf->max_samples)
+    {
+      sample_b = set_b->samples + set_b->sample_count++;
+
+      if(drand48() < w_diff)
+        sample_b->pose = (pf->random_pose_fn)(pf->random_pose_data);
+      else
       {
-        if((c[i] <= r) && (r < c[i+1]))
-          break;
-      }
-      assert(i<set_a->sample_count);
+        // Discrete event sampler, binary search for the first
+        // cumulative probability larger than r
+        r = drand48() * c[set_a->sample_count];
+        i = 0;
+        n = set_a->sample_count;
+        while (i < n)
+        {
+          m = (i + n) / 2;
+          if (c[m+1] <= r)
+            i = m + 1;
+          else
+            n = m;
+        }
+        if (i >= set_a->sample_count)
+          i = set_a->sample_count - 1;
 
-      sample_a = set_a->samples + i;
+        sample_a = set_a->samples + i;
 
-      assert(sample_a->weight > 0);
+        assert(sample_a->weight > 0);
 
-      // Add sample to list
-      sample_b->pose = sample_a->pose;
-    }
+        // Add sample to list
+        sample_b->pose = sample_a->pose;
+      }
 
-    sample_b->weight = 1.0;
-    total += sample_b->weight;
+      sample_b->weight = 1.0;
+      total += sample_b->weight;
 
-    // Add sample to histogram
-    pf_kdtree_insert(set_b->kdtree, sample_b->pose, sample_b->weight);
+      // Add sample to histogram
+      pf_kdtree_insert(set_b->kdtree, sample_b->pose, sample_b->weight);
 
-    // See if we have enough samples yet
-    if (set_b->sample_count > pf_resample_limit(pf, set_b->kdtree->leaf_count))
-      break;
+      // See if we have enough samples yet
+      if (set_b->sample_count > pf_resample_limit(pf, set_b->kdtree->leaf_count))
+        break;
+    }
   }
   
   // Reset averages, to avoid spiraling off into complete randomness.
@@ -412,8 +420,10 @@ int pf_resample_limit(pf_t *pf, int k)
   double a, b, c, x;
   int n;
 
+  // A single occupied bin means the samples are concentrated, do not
+  // waste the maximum number of samples on it
   if (k <= 1)
-    return pf->max_samples;
+    return pf->min_samples;
 
   a = 1;
   b = 2 / (9 * ((double) k - 1));
@@ -445,10 +455,11 @@ void pf_cluster_stats(pf_t *pf, pf_sample_set_t *set)
   // Cluster the samples
   pf_kdtree_cluster(set->kdtree);
   
-  // Initialize cluster stats
+  // Initialize cluster stats, there are at most as many clusters
+  // as occupied bins
   set->cluster_count = 0;
 
-  for (i = 0; i < set->cluster_max_count; i++)
+  for (i = 0; i < set->cluster_max_count && i < set->kdtree->leaf_count; i++)
   {
     cluster = set->clusters + i;
     cluster->count = 0;
@@ -119,6 +119,9 @@ typedef struct _pf_t
 	// Population size parameters
 	double pop_err, pop_z;
 
+	// Use low-variance instead of KLD adaptive resampling if non-zero
+	int resample_low_variance;
+
 	// The sample sets.  We keep two sets and use [current_set]
 	// to identify the active set.
 	int             current_set;
@@ -42,46 +42,43 @@
 
 /// @cond EXTERNAL
 
-// Info for a node in the tree
+// Info for an occupied bin of the histogram
 typedef struct pf_kdtree_node
 {
-	// Depth in the tree
-	int leaf, depth;
-
-	// Pivot dimension and value
-	int    pivot_dim;
-	double pivot_value;
-
-	// The key for this node
+	// The key for this bin
 	int key[3];
 
-	// The value for this node
+	// The value for this bin
 	double value;
 
-	// The cluster label (leaf nodes)
+	// The cluster label
 	int cluster;
 
-	// Child nodes
-	struct pf_kdtree_node *children[2];
-
 } pf_kdtree_node_t;
 
-// A kd tree
+// A histogram over poses. Originally a kd tree, the occupied bins are
+// stored in a flat array and found through an open addressing hash
+// table, which makes insertion and lookup constant time.
 typedef struct
 {
 	// Cell size
 	double size[3];
 
-	// The root node of the tree
-	pf_kdtree_node_t *root;
-
-	// The number of nodes in the tree
+	// The occupied bins
 	int               node_count, node_max_count;
 	pf_kdtree_node_t *nodes;
 
-	// The number of leaf nodes in the tree
+	// Hash table with bin index + 1 per slot, 0 for empty slots,
+	// the size is a power of two
+	int  table_size;
+	int *table;
+
+	// The number of occupied bins
 	int leaf_count;
 
+	// Workspace for clustering
+	int *stack;
+
 } pf_kdtree_t;
 
 // Create a tree
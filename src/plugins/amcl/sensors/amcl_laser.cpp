@@ -54,8 +54,9 @@ AMCLLaser::AMCLLaser(size_t max_beams, map_t *map) : AMCLSensor()
 {
 	this->time = 0.0;
 
-	this->max_beams = max_beams;
-	this->map       = map;
+	this->max_beams   = max_beams;
+	this->map         = map;
+	this->range_table = NULL;
 
 	this->model_type   = LASER_MODEL_BEAM;
 	this->z_hit        = .95;
@@ -65,6 +66,7 @@ AMCLLaser::AMCLLaser(size_t max_beams, map_t *map) : AMCLSensor()
 	this->sigma_hit    = .2;
 	this->lambda_short = .1;
 	this->chi_outlier  = 0.0;
+	this->parallel     = false;
 
 	return;
 }
@@ -99,7 +101,9 @@ AMCLLaser::SetModelLikelihoodField(double z_hit,
 	this->z_rand     = z_rand;
 	this->sigma_hit  = sigma_hit;
 
-	map_update_cspace(this->map, max_occ_dist);
+	// the map may come with distances, e.g., when read from a cache file
+	if (!this->map->cspace_valid || this->map->max_occ_dist != max_occ_dist)
+		map_update_cspace(this->map, max_occ_dist);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -124,6 +128,31 @@ AMCLLaser::UpdateSensor(pf_t *pf, AMCLSensorData *data)
 	return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Select the beams to consider and pre-compute their bearings
+void
+AMCLLaser::PrepareBeams(AMCLLaserData *data, bool skip_max_range)
+{
+	this->beam_range.clear();
+	this->beam_bearing.clear();
+	this->beam_cos.clear();
+	this->beam_sin.clear();
+
+	int step = (data->range_count - 1) / (this->max_beams - 1);
+	for (int i = 0; i < data->range_count; i += step) {
+		double obs_range   = data->ranges[i][0];
+		double obs_bearing = data->ranges[i][1];
+
+		if (skip_max_range && obs_range >= data->range_max)
+			continue;
+
+		this->beam_range.push_back(obs_range);
+		this->beam_bearing.push_back(obs_bearing);
+		this->beam_cos.push_back(cos(obs_bearing));
+		this->beam_sin.push_back(sin(obs_bearing));
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Determine the probability for the given pose
 double
@@ -132,7 +161,13 @@ AMCLLaser::BeamModel(AMCLLaserData *data, pf_sample_set_t *set)
 	AMCLLaser *self         = static_cast<AMCLLaser *>(data->sensor);
 	double     total_weight = 0.0;
 
-	// Compute the sample weights
+	self->PrepareBeams(data, false);
+	const int     num_beams    = self->beam_range.size();
+	const double *beam_range   = self->beam_range.data();
+	const double *beam_bearing = self->beam_bearing.data();
+
+	// Compute the sample weights, samples are independent
+#pragma omp parallel for schedule(static) if (self->parallel) reduction(+ : total_weight)
 	for (int j = 0; j < set->sample_count; j++) {
 		pf_sample_t *sample = set->samples + j;
 		pf_vector_t  pose{sample->pose};
@@ -142,14 +177,23 @@ AMCLLaser::BeamModel(AMCLLaserData *data, pf_sample_set_t *set)
 
 		double p = 1.0;
 
-		int step = (data->range_count - 1) / (self->max_beams - 1);
-		for (int i = 0; i < data->range_count; i += step) {
-			double obs_range   = data->ranges[i][0];
-			double obs_bearing = data->ranges[i][1];
+		for (int i = 0; i < num_beams; ++i) {
+			double obs_range   = beam_range[i];
+			double obs_bearing = beam_bearing[i];
 
 			// Compute the range according to the map
-			double map_range =
-			  map_calc_range(self->map, pose.v[0], pose.v[1], pose.v[2] + obs_bearing, data->range_max);
+			double map_range;
+			if (self->range_table) {
+				map_range = map_range_table_calc_range(self->range_table,
+				                                       self->map,
+				                                       pose.v[0],
+				                                       pose.v[1],
+				                                       pose.v[2] + obs_bearing,
+				                                       data->range_max);
+			} else {
+				map_range =
+				  map_calc_range(self->map, pose.v[0], pose.v[1], pose.v[2] + obs_bearing, data->range_max);
+			}
 			double pz = 0.0;
 
 			// Part 1: good, but noisy, hit
@@ -191,80 +235,98 @@ AMCLLaser::BeamModel(AMCLLaserData *data, pf_sample_set_t *set)
 double
 AMCLLaser::LikelihoodFieldModel(AMCLLaserData *data, pf_sample_set_t *set)
 {
-	AMCLLaser *  self;
-	int          i, j;
-	double       z, pz;
-	double       obs_range, obs_bearing;
-	double       total_weight;
-	pf_sample_t *sample;
-	pf_vector_t  pose;
-	pf_vector_t  hit;
+	AMCLLaser *self;
+	double     total_weight;
 
 	self = (AMCLLaser *)data->sensor;
 
 	total_weight = 0.0;
 
-	// Compute the sample weights
-	for (j = 0; j < set->sample_count; j++) {
-		sample = set->samples + j;
-		pose   = sample->pose;
-
-		// Take account of the laser pose relative to the robot
-		pose = pf_vector_coord_add(self->laser_pose, pose);
-
-		double p = 1.0;
-
-		// Pre-compute a couple of things
-		double z_hit_denom = 2 * self->sigma_hit * self->sigma_hit;
-		double z_rand_mult = 1.0 / data->range_max;
-
-		int step = (data->range_count - 1) / (self->max_beams - 1);
-		for (i = 0; i < data->range_count; i += step) {
-			obs_range   = data->ranges[i][0];
-			obs_bearing = data->ranges[i][1];
-
-			// This model ignores max range readings
-			if (obs_range >= data->range_max)
-				continue;
-
-			pz = 0.0;
-
-			// Compute the endpoint of the beam
-			hit.v[0] = pose.v[0] + obs_range * cos(pose.v[2] + obs_bearing);
-			hit.v[1] = pose.v[1] + obs_range * sin(pose.v[2] + obs_bearing);
-
-			// Convert to map grid coords.
-			int mi, mj;
-			mi = MAP_GXWX(self->map, hit.v[0]);
-			mj = MAP_GYWY(self->map, hit.v[1]);
-
-			// Part 1: Get distance from the hit to closest obstacle.
-			// Off-map penalized as max distance
-			if (!MAP_VALID(self->map, mi, mj))
-				z = self->map->max_occ_dist;
-			else
-				z = self->map->cells[MAP_INDEX(self->map, mi, mj)].occ_dist;
-			// Gaussian model
-			// NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
-			pz += self->z_hit * exp(-(z * z) / z_hit_denom);
-			// Part 2: random measurements
-			pz += self->z_rand * z_rand_mult;
-
-			// TODO: outlier rejection for short readings
-
-			//assert(pz <= 1.0);
-			//assert(pz >= 0.0);
-			if ((pz < 0.) || (pz > 1.))
-				pz = 0.;
-
-			//      p *= pz;
-			// here we have an ad-hoc weighting scheme for combining beam probs
-			// works well, though...
-			p += pz * pz * pz;
+	// Pre-compute a couple of things
+	double z_hit_denom = 2 * self->sigma_hit * self->sigma_hit;
+	double z_rand_mult = 1.0 / data->range_max;
+
+	// This model ignores max range readings
+	self->PrepareBeams(data, true);
+	const int     num_beams  = self->beam_range.size();
+	const double *beam_range = self->beam_range.data();
+	const float * beam_cos   = self->beam_cos.data();
+	const float * beam_sin   = self->beam_sin.data();
+
+	const map_t *map       = self->map;
+	const float  origin_x  = map->origin_x;
+	const float  origin_y  = map->origin_y;
+	const float  inv_scale = 1.0 / map->scale;
+	const int    half_x    = map->size_x / 2;
+	const int    half_y    = map->size_y / 2;
+
+	// Compute the sample weights, samples are independent
+#pragma omp parallel if (self->parallel) reduction(+ : total_weight)
+	{
+		std::vector<int> cell_x(num_beams);
+		std::vector<int> cell_y(num_beams);
+
+#pragma omp for schedule(static)
+		for (int j = 0; j < set->sample_count; j++) {
+			pf_sample_t *sample = set->samples + j;
+
+			// Take account of the laser pose relative to the robot
+			pf_vector_t pose = pf_vector_coord_add(self->laser_pose, sample->pose);
+
+			const float px = pose.v[0];
+			const float py = pose.v[1];
+			const float pc = cos(pose.v[2]);
+			const float ps = sin(pose.v[2]);
+
+			// Compute the endpoints of the beams and convert to map grid
+			// coords. The beam angle is the sum of the pose and the beam
+			// bearing, use the angle addition theorems on the pre-computed
+			// values instead of trig functions for every beam.
+			for (int i = 0; i < num_beams; ++i) {
+				float c   = pc * beam_cos[i] - ps * beam_sin[i];
+				float s   = ps * beam_cos[i] + pc * beam_sin[i];
+				float r   = beam_range[i];
+				float hx  = px + r * c;
+				float hy  = py + r * s;
+				cell_x[i] = (int)floorf((hx - origin_x) * inv_scale + 0.5f) + half_x;
+				cell_y[i] = (int)floorf((hy - origin_y) * inv_scale + 0.5f) + half_y;
+			}
+
+			double p = 1.0;
+
+			for (int i = 0; i < num_beams; ++i) {
+				int    mi = cell_x[i];
+				int    mj = cell_y[i];
+				double z, pz = 0.0;
+
+				// Part 1: Get distance from the hit to closest obstacle.
+				// Off-map penalized as max distance
+				if (!MAP_VALID(map, mi, mj))
+					z = map->max_occ_dist;
+				else
+					z = map->cells[MAP_INDEX(map, mi, mj)].occ_dist;
+				// Gaussian model
+				// NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
+				pz += self->z_hit * exp(-(z * z) / z_hit_denom);
+				// Part 2: random measurements
+				pz += self->z_rand * z_rand_mult;
+
+				// TODO: outlier rejection for short readings
+
+				//assert(pz <= 1.0);
+				//assert(pz >= 0.0);
+				if ((pz < 0.) || (pz > 1.))
+					pz = 0.;
+
+				//      p *= pz;
+				// here we have an ad-hoc weighting scheme for combining beam probs
+				// works well, though...
+				p += pz * pz * pz;
+			}
+
+			sample->weight *= p;
+			total_weight += sample->weight;
 		}
-
-		sample->weight *= p;
-		total_weight += sample->weight;
 	}
 
 	return (total_weight);
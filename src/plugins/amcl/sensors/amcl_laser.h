@@ -38,6 +38,8 @@
 #include "../map/map.h"
 #include "amcl_sensor.h"
 
+#include <vector>
+
 /// @cond EXTERNAL
 
 namespace amcl {
@@ -99,6 +101,23 @@ public:
 		this->laser_pose = laser_pose;
 	}
 
+	// Evaluate samples in parallel, requires OpenMP
+public:
+	void
+	SetParallel(bool parallel)
+	{
+		this->parallel = parallel;
+	}
+
+	// Use precomputed ranges for the beam model, NULL to cast rays.
+	// The table is not owned and must outlive this object.
+public:
+	void
+	SetRangeTable(map_range_table_t *range_table)
+	{
+		this->range_table = range_table;
+	}
+
 	// Determine the probability for the given pose
 private:
 	static double BeamModel(AMCLLaserData *data, pf_sample_set_t *set);
@@ -106,6 +125,10 @@ private:
 private:
 	static double LikelihoodFieldModel(AMCLLaserData *data, pf_sample_set_t *set);
 
+	// Select the beams to consider and pre-compute their bearings
+private:
+	void PrepareBeams(AMCLLaserData *data, bool skip_max_range);
+
 private:
 	laser_model_t model_type;
 
@@ -117,6 +140,10 @@ private:
 private:
 	map_t *map;
 
+	// Precomputed ranges, may be NULL
+private:
+	map_range_table_t *range_table;
+
 	// Laser offset relative to robot
 private:
 	pf_vector_t laser_pose;
@@ -149,6 +176,18 @@ private:
 	// Threshold for outlier rejection (unused)
 private:
 	double chi_outlier;
+
+	// Evaluate samples in parallel
+private:
+	bool parallel;
+
+	// Beams of the current update in SoA layout, with cosine and sine
+	// of the bearing relative to the laser
+private:
+	std::vector<double> beam_range;
+	std::vector<double> beam_bearing;
+	std::vector<float>  beam_cos;
+	std::vector<float>  beam_sin;
 };
 
 } // namespace amcl
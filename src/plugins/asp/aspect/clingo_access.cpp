@@ -90,6 +90,13 @@ private:
  * It provides a high-level interface to the solver, i.e., to configure, start,
  * or cancel the solving process. It also supports assigning and releasing
  * externals.
+ *
+ * The control is kept across solving calls for multi-shot solving. Parts
+ * which have been grounded once are remembered and not grounded again, e.g.
+ * the base program is grounded only on the first call, and externals are
+ * only passed to Clingo if their value changed. Use start_step() to ground
+ * new step parts, update externals, and start solving asynchronously in
+ * one go, results are delivered through the model and finish callbacks.
  * @author Björn Schäpers
  *
  * @property ClingoAccess::logger_
@@ -126,6 +133,12 @@ private:
  *
  * @property ClingoAccess::control_
  * @brief The clingo control.
+ *
+ * @property ClingoAccess::grounded_parts_
+ * @brief Name and parameters of the parts grounded in the current control.
+ *
+ * @property ClingoAccess::external_values_
+ * @brief The last value assigned to each external.
  */
 
 /**
@@ -467,6 +480,8 @@ ClingoAccess::reset(void)
 	logger_->log_warn(log_comp_.c_str(), "Resetting Clingo");
 	delete control_;
 	control_ = nullptr;
+	grounded_parts_.clear();
+	external_values_.clear();
 	alloc_control();
 	return true;
 }
@@ -555,7 +570,46 @@ ClingoAccess::load_file(const std::string &path)
 	return true;
 }
 
-/** Grounds a program part.
+/** Adds a program part.
+ * The part is parsed, but not grounded. If a part of that name has been
+ * grounded before, it has to be grounded again to include the new rules.
+ * @param[in] name The name of the part, e.g. "step".
+ * @param[in] params The names of the parameters of the part.
+ * @param[in] program The program code.
+ * @return true if the program was added
+ */
+bool
+ClingoAccess::add_program(const std::string &             name,
+                          const std::vector<std::string> &params,
+                          const std::string &             program)
+{
+	BoolMutexLocker locker(&control_mutex_, control_is_locked_);
+	if (solving_) {
+		return false;
+	}
+
+	std::vector<const char *> param_names;
+	for (const std::string &p : params) {
+		param_names.push_back(p.c_str());
+	}
+	if (debug_level_ >= ASP_DBG_PROGRAMS) {
+		logger_->log_info(log_comp_.c_str(), "Adding program part %s.", name.c_str());
+	}
+	control_->add(name.c_str(), param_names, program.c_str());
+
+	for (auto p = grounded_parts_.begin(); p != grounded_parts_.end();) {
+		if (p->first == name) {
+			p = grounded_parts_.erase(p);
+		} else {
+			++p;
+		}
+	}
+	return true;
+}
+
+/** Grounds program parts.
+ * Parts which have already been grounded with the same parameters are
+ * skipped, hence the base program can be passed on every call.
  * @param[in] parts The parts to ground.
  * @return true if parts could be grounded
  */
@@ -570,11 +624,48 @@ ClingoAccess::ground(const Clingo::PartSpan &parts)
 	if (solving_) {
 		return false;
 	}
+	ground_new_parts(parts);
+	return true;
+}
+
+/** Check if a part has been grounded.
+ * @param[in] name The name of the part.
+ * @param[in] params The parameters the part was grounded with.
+ * @return true if the part has been grounded with these parameters
+ */
+bool
+ClingoAccess::is_grounded(const std::string &name, const Clingo::SymbolVector &params)
+{
+	BoolMutexLocker locker(&control_mutex_, control_is_locked_);
+	return grounded_parts_.find(std::make_pair(name, params)) != grounded_parts_.end();
+}
+
+/** Grounds the parts which have not been grounded before.
+ * The control mutex must be locked.
+ * @param[in] parts The parts to ground.
+ */
+void
+ClingoAccess::ground_new_parts(const Clingo::PartSpan &parts)
+{
+	std::vector<Clingo::Part> new_parts;
+	for (const Clingo::Part &part : parts) {
+		Clingo::SymbolVector params(part.params().begin(), part.params().end());
+		if (grounded_parts_.insert(std::make_pair(std::string(part.name()), params)).second) {
+			new_parts.push_back(part);
+		}
+	}
+	if (new_parts.empty()) {
+		return;
+	}
+
 	if (debug_level_ >= ASP_DBG_TIME) {
-		logger_->log_info(log_comp_.c_str(), "Grounding %zu parts:", parts.size());
+		logger_->log_info(log_comp_.c_str(),
+		                  "Grounding %zu parts, %zu already grounded:",
+		                  new_parts.size(),
+		                  parts.size() - new_parts.size());
 		if (debug_level_ >= ASP_DBG_PROGRAMS) {
 			auto i = 0;
-			for (const Clingo::Part &part : parts) {
+			for (const Clingo::Part &part : new_parts) {
 				std::string params;
 				bool        first = true;
 				for (const auto &param : part.params()) {
@@ -590,12 +681,36 @@ ClingoAccess::ground(const Clingo::PartSpan &parts)
 		}
 	}
 
-	control_->ground(parts, ground_callback_);
+	control_->ground(new_parts, ground_callback_);
 
 	if (debug_level_ >= ASP_DBG_TIME) {
 		logger_->log_info(log_comp_.c_str(), "Grounding done.");
 	}
-	return true;
+}
+
+/** Grounds new parts, updates externals, and starts solving.
+ * This is one step of multi-shot solving. Only parts which have not been
+ * grounded before are grounded and only externals whose value changed are
+ * passed to Clingo. Solving is asynchronous, the results are delivered
+ * through the registered model and finish callbacks.
+ * @param[in] parts The parts to ground, e.g. base and the current step.
+ * @param[in] assignments The externals and their values.
+ * @return true if solving was started, false if it is already running
+ */
+bool
+ClingoAccess::start_step(
+  const Clingo::PartSpan &                                           parts,
+  const std::vector<std::pair<Clingo::Symbol, Clingo::TruthValue>> &assignments)
+{
+	BoolMutexLocker locker(&control_mutex_, control_is_locked_);
+	if (solving_) {
+		return false;
+	}
+	ground_new_parts(parts);
+	for (const auto &a : assignments) {
+		assign_changed_external(a.first, a.second);
+	}
+	return start_solving();
 }
 
 /** Assigns an external value.
@@ -610,6 +725,41 @@ ClingoAccess::assign_external(const Clingo::Symbol &atom, const Clingo::TruthVal
 	if (solving_) {
 		return false;
 	}
+	assign_changed_external(atom, value);
+	return true;
+}
+
+/** Assigns values to a number of externals.
+ * This locks the control only once for all assignments.
+ * @param[in] assignments The externals and their values.
+ * @return If they could be assigned.
+ */
+bool
+ClingoAccess::assign_externals(
+  const std::vector<std::pair<Clingo::Symbol, Clingo::TruthValue>> &assignments)
+{
+	BoolMutexLocker locker(&control_mutex_, control_is_locked_);
+	if (solving_) {
+		return false;
+	}
+	for (const auto &a : assignments) {
+		assign_changed_external(a.first, a.second);
+	}
+	return true;
+}
+
+/** Assigns an external value if it changed.
+ * The control mutex must be locked.
+ * @param[in] atom The atom to assign.
+ * @param[in] value The assigned value.
+ */
+void
+ClingoAccess::assign_changed_external(const Clingo::Symbol &atom, const Clingo::TruthValue value)
+{
+	auto v = external_values_.find(atom);
+	if (v != external_values_.end() && v->second == value) {
+		return;
+	}
 
 	if (debug_level_ >= ASP_DBG_EXTERNALS) {
 		logger_->log_info(
@@ -627,7 +777,7 @@ ClingoAccess::assign_external(const Clingo::Symbol &atom, const Clingo::TruthVal
 		  atom.to_string().c_str());
 	}
 	control_->assign_external(atom, value);
-	return true;
+	external_values_[atom] = value;
 }
 
 /** Releases an external value.
@@ -646,6 +796,7 @@ ClingoAccess::release_external(const Clingo::Symbol &atom)
 		logger_->log_info(log_comp_.c_str(), "Releasing %s.", atom.to_string().c_str());
 	}
 	control_->release_external(atom);
+	external_values_.erase(atom);
 	return true;
 }
 
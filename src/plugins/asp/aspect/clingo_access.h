@@ -28,7 +28,11 @@
 #include <atomic>
 #include <clingo.hh>
 #include <functional>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace fawkes {
@@ -76,7 +80,11 @@ public:
 
 	bool load_file(const std::string &path);
 
+	bool add_program(const std::string &           name,
+	                 const std::vector<std::string> &params,
+	                 const std::string &             program);
 	bool ground(const Clingo::PartSpan &parts);
+	bool is_grounded(const std::string &name, const Clingo::SymbolVector &params = {});
 
 	inline bool
 	assign_external(const Clingo::Symbol &atom, const bool value)
@@ -92,6 +100,11 @@ public:
 
 	bool assign_external(const Clingo::Symbol &atom, const Clingo::TruthValue value);
 	bool release_external(const Clingo::Symbol &atom);
+	bool assign_externals(
+	  const std::vector<std::pair<Clingo::Symbol, Clingo::TruthValue>> &assignments);
+
+	bool start_step(const Clingo::PartSpan &                                           parts,
+	                const std::vector<std::pair<Clingo::Symbol, Clingo::TruthValue>> &assignments);
 
 	DebugLevel_t debug_level() const;
 	void         set_debug_level(DebugLevel_t log_level);
@@ -101,6 +114,8 @@ private:
 	void on_finish(Clingo::SolveResult result) override;
 
 	void alloc_control(void);
+	void ground_new_parts(const Clingo::PartSpan &parts);
+	void assign_changed_external(const Clingo::Symbol &atom, const Clingo::TruthValue value);
 
 private:
 	Logger *const     logger_;
@@ -115,6 +130,9 @@ private:
 	bool             control_is_locked_;
 	Clingo::Control *control_;
 
+	std::set<std::pair<std::string, Clingo::SymbolVector>> grounded_parts_;
+	std::map<Clingo::Symbol, Clingo::TruthValue>           external_values_;
+
 	mutable Mutex        model_mutex_;
 	Clingo::SymbolVector model_symbols_, old_symbols_;
 	unsigned int         model_counter_;
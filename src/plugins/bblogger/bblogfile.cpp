@@ -48,6 +48,12 @@ using namespace fawkes;
 /** @class BBLogFile "bblogfile.h"
  * Class to easily access bblogger log files.
  * This class provides an easy way to interact with bblogger log files.
+ *
+ * The file is memory-mapped for reading. Since all entries have the same
+ * size, any entry can be accessed in constant time by its index, and
+ * entries are searched for by time offset with a binary search over the
+ * entry headers, which bblogger writes in chronological order. The
+ * mapping is extended as needed if the file grows while it is read.
  * @author Tim Niemueller
  */
 
@@ -114,8 +120,12 @@ BBLogFile::ctor(const char *filename, bool do_sanity_check)
 		throw CouldNotOpenFileException(filename, errno);
 	}
 
-	filename_ = strdup(filename);
-	header_   = (bblog_file_header *)malloc(sizeof(bblog_file_header));
+	filename_   = strdup(filename);
+	header_     = (bblog_file_header *)malloc(sizeof(bblog_file_header));
+	map_        = NULL;
+	map_size_   = 0;
+	num_mapped_ = 0;
+	next_index_ = 0;
 
 	try {
 		read_file_header();
@@ -130,7 +140,7 @@ BBLogFile::ctor(const char *filename, bool do_sanity_check)
 		throw;
 	}
 
-	ifdata_ = malloc(header_->data_size);
+	entry_size_ = sizeof(bblog_entry_header) + header_->data_size;
 }
 
 /** Destructor. */
@@ -141,6 +151,7 @@ BBLogFile::~BBLogFile()
 		instance_factory_.reset();
 	}
 
+	unmap();
 	fclose(f_);
 
 	free(filename_);
@@ -149,7 +160,6 @@ BBLogFile::~BBLogFile()
 	free(interface_id_);
 
 	free(header_);
-	free(ifdata_);
 }
 
 /** Read file header. */
@@ -219,7 +229,7 @@ BBLogFile::sanity_check()
 		throw e;
 	}
 
-#if BYTE_ORDER_ == LITTLE_ENDIAN_
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
 	if (header_->endianess == 1)
 #else
 	if (header_->endianess == 0)
@@ -231,20 +241,155 @@ BBLogFile::sanity_check()
 	}
 }
 
-/** Read entry at particular index.
- * @param index index of entry, 0-based
+/** Update memory mapping of the file.
+ * If the file has grown since it was last mapped the mapping is replaced
+ * with one covering the whole file. Pointers previously returned by
+ * entry_data() are invalid afterwards.
+ * @exception Exception thrown if the file shrank or cannot be mapped
  */
 void
-BBLogFile::read_index(unsigned int index)
+BBLogFile::update_mapping()
 {
-	long offset =
-	  sizeof(bblog_file_header) + (sizeof(bblog_entry_header) + header_->data_size) * index;
+	size_t fsize = file_size();
+	if (fsize == map_size_)
+		return;
+	if (fsize < map_size_) {
+		throw Exception("File %s shrank while reading it", filename_);
+	}
+
+#if _POSIX_MAPPED_FILES
+	void *m = mmap(NULL, fsize, PROT_READ, MAP_SHARED, fileno(f_), 0);
+	if (m == MAP_FAILED) {
+		throw Exception(errno, "Failed to mmap log file %s", filename_);
+	}
+	unmap();
+	map_        = (char *)m;
+	map_size_   = fsize;
+	num_mapped_ = (fsize - sizeof(bblog_file_header)) / entry_size_;
+#	ifdef POSIX_MADV_SEQUENTIAL
+	// entries are mostly read in order, enable aggressive read-ahead
+	posix_madvise(map_, map_size_, POSIX_MADV_SEQUENTIAL);
+#	endif
+#else
+	throw Exception("Cannot read log file %s, mmap not available.", filename_);
+#endif
+}
 
-	if (fseek(f_, offset, SEEK_SET) != 0) {
-		throw Exception(errno, "Cannot seek to index %u", index);
+/** Remove memory mapping of the file, if any. */
+void
+BBLogFile::unmap()
+{
+#if _POSIX_MAPPED_FILES
+	if (map_) {
+		munmap(map_, map_size_);
+	}
+#endif
+	map_        = NULL;
+	map_size_   = 0;
+	num_mapped_ = 0;
+}
+
+/** Get number of entries.
+ * The number is determined from the file size and thus also valid if the
+ * header has not been updated, e.g., while the file is still being written.
+ * @return number of complete entries in the file
+ */
+unsigned int
+BBLogFile::num_entries()
+{
+	update_mapping();
+	return num_mapped_;
+}
+
+/** Get entry data.
+ * This provides direct access to the mapped data without copying it.
+ * The pointer is valid until the file is closed or a read or query
+ * requires to extend the mapping because the file has grown.
+ * @param index index of entry, 0-based
+ * @param offset if not NULL, set to the offset of the entry from the start time
+ * @return pointer to data of entry in the interface's data chunk format
+ * @exception OutOfBoundsException thrown if the index is out of range
+ */
+const void *
+BBLogFile::entry_data(unsigned int index, fawkes::Time *offset)
+{
+	if (index >= num_mapped_ && index >= num_entries()) {
+		throw OutOfBoundsException("Entry index out of range", index, 0, num_mapped_);
+	}
+
+	const char *        entry = map_ + sizeof(bblog_file_header) + entry_size_ * index;
+	bblog_entry_header *entryh = (bblog_entry_header *)entry;
+	if (offset) {
+		offset->set_time(entryh->rel_time_sec, entryh->rel_time_usec);
+	}
+	return entry + sizeof(bblog_entry_header);
+}
+
+/** Find entry by time.
+ * This performs a binary search over the entry time offsets.
+ * @param offset time offset relative to the start time
+ * @return index of the first entry with an offset equal to or later than
+ * the given one, num_entries() if there is no such entry
+ */
+unsigned int
+BBLogFile::find_entry(const fawkes::Time &offset)
+{
+	unsigned int first = 0;
+	unsigned int count = num_entries();
+	long         sec   = offset.get_sec();
+	long         usec  = offset.get_usec();
+
+	while (count > 0) {
+		unsigned int step = count / 2;
+		unsigned int mid  = first + step;
+
+		const bblog_entry_header *entryh =
+		  (bblog_entry_header *)(map_ + sizeof(bblog_file_header) + entry_size_ * mid);
+		if (((long)entryh->rel_time_sec < sec)
+		    || (((long)entryh->rel_time_sec == sec) && ((long)entryh->rel_time_usec < usec))) {
+			first = mid + 1;
+			count -= step + 1;
+		} else {
+			count = step;
+		}
 	}
 
-	read_next();
+	return first;
+}
+
+/** Seek to entry by time.
+ * Moves the file cursor such that the next call to read_next() reads the
+ * first entry with an offset equal to or later than the given one.
+ * @param offset time offset relative to the start time
+ * @return index of the entry read next, num_entries() if there is no such
+ * entry and has_next() will return false
+ */
+unsigned int
+BBLogFile::seek_time(const fawkes::Time &offset)
+{
+	next_index_ = find_entry(offset);
+	return next_index_;
+}
+
+/** Read entry into interface.
+ * @param index index of entry, must be within the mapped range
+ */
+void
+BBLogFile::read_entry(unsigned int index)
+{
+	const void *data = entry_data(index, &entry_offset_);
+	interface_->set_from_chunk(const_cast<void *>(data));
+}
+
+/** Read entry at particular index.
+ * A following call to read_next() continues with the entry after it.
+ * @param index index of entry, 0-based
+ */
+void
+BBLogFile::read_index(unsigned int index)
+{
+	read_entry(index);
+	next_index_ = index + 1;
 }
 
 /** Rewind file to start.
@@ -253,9 +398,7 @@ BBLogFile::read_index(unsigned int index)
 void
 BBLogFile::rewind()
 {
-	if (fseek(f_, sizeof(bblog_file_header), SEEK_SET) != 0) {
-		throw Exception(errno, "Cannot reset file");
-	}
+	next_index_ = 0;
 	entry_offset_.set_time(0, 0);
 }
 
@@ -265,14 +408,10 @@ BBLogFile::rewind()
 bool
 BBLogFile::has_next()
 {
-	// we always re-test to support continuous file watching
-	clearerr(f_);
-	if (getc(f_) == EOF) {
-		return false;
-	} else {
-		fseek(f_, -1, SEEK_CUR);
+	if (next_index_ < num_mapped_)
 		return true;
-	}
+	// we always re-test to support continuous file watching
+	return (next_index_ < num_entries());
 }
 
 /** Read next entry.
@@ -282,15 +421,10 @@ BBLogFile::has_next()
 void
 BBLogFile::read_next()
 {
-	bblog_entry_header entryh;
-
-	if ((fread(&entryh, sizeof(bblog_entry_header), 1, f_) == 1)
-	    && (fread(ifdata_, header_->data_size, 1, f_) == 1)) {
-		entry_offset_.set_time(entryh.rel_time_sec, entryh.rel_time_usec);
-		interface_->set_from_chunk(ifdata_);
-	} else {
+	if (!has_next()) {
 		throw Exception("Cannot read interface data");
 	}
+	read_entry(next_index_++);
 }
 
 /** Set number of entries.
@@ -333,6 +467,8 @@ BBLogFile::repair_file(const char *filename)
 void
 BBLogFile::repair()
 {
+	unmap();
+
 	FILE *f = freopen(filename_, "r+", f_);
 	if (!f) {
 		throw Exception("Reopening file %s with new mode failed", filename_);
@@ -344,7 +480,7 @@ BBLogFile::repair()
 	Exception success("Successfully repaired file");
 	success.set_type_id("repair-success");
 
-#if BYTE_ORDER_ == LITTLE_ENDIAN_
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
 	if (header_->endianess == 1)
 #else
 	if (header_->endianess == 0)
@@ -423,9 +559,16 @@ BBLogFile::print_info(const char *line_prefix, FILE *outf)
 		throw Exception(errno, "Failed to get stat file");
 	}
 
+	unsigned int num_entries = this->num_entries();
+	fawkes::Time duration((long)0);
+	if (num_entries > 0) {
+		entry_data(num_entries - 1, &duration);
+	}
+
 	fprintf(outf,
 	        "%sFile version: %-10u  Endianess: %s Endian\n"
 	        "%s# data items: %-10u  Data size: %u bytes\n"
+	        "%s# in file:    %-10u  Duration:  %.3f sec\n"
 	        "%sHeader size:  %zu bytes   File size: %li bytes\n"
 	        "%s\n"
 	        "%sScenario:   %s\n"
@@ -438,6 +581,9 @@ BBLogFile::print_info(const char *line_prefix, FILE *outf)
 	        header_->num_data_items,
 	        header_->data_size,
 	        line_prefix,
+	        num_entries,
+	        duration.in_sec(),
+	        line_prefix,
 	        sizeof(bblog_file_header),
 	        (long int)fs.st_size,
 	        line_prefix,
@@ -604,17 +750,9 @@ BBLogFile::start_time()
 unsigned int
 BBLogFile::remaining_entries()
 {
-	// we make this so "complicated" to be able to use it from a FAM handler
-	size_t  entry_size = sizeof(bblog_entry_header) + header_->data_size;
-	long    curpos     = ftell(f_);
-	size_t  fsize      = file_size();
-	ssize_t sizediff   = fsize - curpos;
-
-	if (sizediff < 0) {
-		throw Exception("File %s shrank while reading it", filename_);
-	}
-
-	return sizediff / entry_size;
+	// re-check file size to be able to use it from a FAM handler
+	unsigned int num = num_entries();
+	return (next_index_ < num) ? num - next_index_ : 0;
 }
 
 /** Get file size.
@@ -49,6 +49,11 @@ public:
 	const fawkes::Time &entry_offset() const;
 	void                print_entry(FILE *outf = stdout);
 
+	unsigned int num_entries();
+	const void * entry_data(unsigned int index, fawkes::Time *offset = NULL);
+	unsigned int find_entry(const fawkes::Time &offset);
+	unsigned int seek_time(const fawkes::Time &offset);
+
 	void rewind();
 
 	void set_num_entries(size_t num_entries);
@@ -96,12 +101,19 @@ private: // methods
 	void read_file_header();
 	void sanity_check();
 	void repair();
+	void update_mapping();
+	void unmap();
+	void read_entry(unsigned int index);
 
 private: // members
 	FILE *             f_;
 	bblog_file_header *header_;
 
-	void *ifdata_;
+	char *       map_;
+	size_t       map_size_;
+	size_t       entry_size_;
+	unsigned int num_mapped_;
+	unsigned int next_index_;
 
 	char *filename_;
 	char *scenario_;
@@ -22,6 +22,7 @@
 
 #include "bblogger_plugin.h"
 
+#include "container.h"
 #include "log_thread.h"
 
 #include <sys/stat.h>
@@ -30,6 +31,7 @@
 
 #include <cerrno>
 #include <cstring>
+#include <memory>
 #include <set>
 #include <unistd.h>
 
@@ -38,7 +40,9 @@ using namespace fawkes;
 /** @class BlackBoardLoggerPlugin "bblogger_plugin.h"
  * BlackBoard logger plugin.
  * This plugin logs one or more (or even all) interfaces to data files
- * for later replay or analyzing.
+ * for later replay or analyzing. Either one file is written per interface,
+ * or, in container mode, the data of all interfaces is written to a single
+ * container file.
  *
  * @author Tim Niemueller
  */
@@ -71,9 +75,14 @@ BlackBoardLoggerPlugin::BlackBoardLoggerPlugin(Configuration *config) : Plugin(c
 	std::string scenario_prefix = prefix + scenario + "/";
 	std::string ifaces_prefix   = scenario_prefix + "interfaces/";
 
-	std::string logdir    = LOGDIR;
-	bool        buffering = true;
-	bool        flushing  = false;
+	std::string  logdir     = LOGDIR;
+	bool         buffering  = true;
+	bool         flushing   = false;
+	bool         container  = false;
+	bool         compress   = true;
+	unsigned int chunk_size = 65536;
+	unsigned int block_size = 262144;
+	unsigned int max_delay  = 1000;
 	try {
 		logdir = config->get_string((scenario_prefix + "logdir").c_str());
 	} catch (Exception &e) { /* ignored, use default set above */
@@ -86,6 +95,26 @@ BlackBoardLoggerPlugin::BlackBoardLoggerPlugin(Configuration *config) : Plugin(c
 		flushing = config->get_bool((scenario_prefix + "flushing").c_str());
 	} catch (Exception &e) { /* ignored, use default set above */
 	}
+	try {
+		block_size = config->get_uint((scenario_prefix + "block_size").c_str());
+	} catch (Exception &e) { /* ignored, use default set above */
+	}
+	try {
+		max_delay = config->get_uint((scenario_prefix + "max_delay_msec").c_str());
+	} catch (Exception &e) { /* ignored, use default set above */
+	}
+	try {
+		container = config->get_bool((scenario_prefix + "container").c_str());
+	} catch (Exception &e) { /* ignored, use default set above */
+	}
+	try {
+		compress = config->get_bool((scenario_prefix + "compress").c_str());
+	} catch (Exception &e) { /* ignored, use default set above */
+	}
+	try {
+		chunk_size = config->get_uint((scenario_prefix + "chunk_size").c_str());
+	} catch (Exception &e) { /* ignored, use default set above */
+	}
 
 	struct stat s;
 	int         err = stat(logdir.c_str(), &s);
@@ -110,17 +139,35 @@ BlackBoardLoggerPlugin::BlackBoardLoggerPlugin(Configuration *config) : Plugin(c
 	strftime(date, 21, "%F-%H-%M-%S", tmp);
 	std::string replay_cfg_prefix = replay_prefix + scenario + "-" + date + "/logs/";
 
+	std::shared_ptr<BBLogContainerWriter> container_writer;
+	if (container) {
+		std::string filename = logdir + "/" + scenario + "-" + date + ".bblog";
+		container_writer = std::make_shared<BBLogContainerWriter>(
+		  filename.c_str(), scenario.c_str(), start, chunk_size, compress);
+	}
+
 	Configuration::ValueIterator *i = config->search(ifaces_prefix.c_str());
 	while (i->next()) {
 		std::string iface_name = std::string(i->path()).substr(ifaces_prefix.length());
 		iface_name             = iface_name.substr(0, iface_name.find("/"));
 
 		//printf("Adding sync thread for peer %s\n", peer.c_str());
-		BBLoggerThread *log_thread = new BBLoggerThread(
-		  i->get_string().c_str(), logdir.c_str(), buffering, flushing, scenario.c_str(), &start);
-
-		std::string filename = log_thread->get_filename();
-		config->set_string((replay_cfg_prefix + iface_name + "/file").c_str(), filename);
+		BBLoggerThread *log_thread = new BBLoggerThread(i->get_string().c_str(),
+		                                                logdir.c_str(),
+		                                                buffering,
+		                                                flushing,
+		                                                scenario.c_str(),
+		                                                &start,
+		                                                block_size,
+		                                                max_delay);
+
+		if (container_writer) {
+			// replay reads per-interface files, unpack with ffbblog first
+			log_thread->set_container(container_writer);
+		} else {
+			std::string filename = log_thread->get_filename();
+			config->set_string((replay_cfg_prefix + iface_name + "/file").c_str(), filename);
+		}
 
 		thread_list.push_back(log_thread);
 	}
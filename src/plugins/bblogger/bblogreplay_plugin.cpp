@@ -24,6 +24,7 @@
 #include "bblogreplay_plugin.h"
 
 #include "logreplay_bt_thread.h"
+#include "logreplay_merged_thread.h"
 #include "logreplay_thread.h"
 
 #include <sys/stat.h>
@@ -35,6 +36,7 @@
 #include <memory>
 #include <set>
 #include <unistd.h>
+#include <vector>
 
 using namespace fawkes;
 
@@ -108,6 +110,27 @@ BlackBoardLogReplayPlugin::BlackBoardLogReplayPlugin(Configuration *config) : Pl
 	} catch (Exception &e) {
 	} // ignored, assume enabled
 
+	// merged replay of all logs in one thread, ordered by time
+	bool  scenario_merged   = false;
+	bool  scenario_sim_time = false;
+	float scenario_speed    = 1.0;
+	try {
+		scenario_merged = config->get_bool((scenario_prefix + "merged").c_str());
+	} catch (Exception &e) {
+	} // ignored, assume disabled
+	try {
+		scenario_sim_time = config->get_bool((scenario_prefix + "sim_time").c_str());
+	} catch (Exception &e) {
+	} // ignored, assume disabled
+	try {
+		scenario_speed = config->get_float((scenario_prefix + "speed").c_str());
+	} catch (Exception &e) {
+	} // ignored, assume real-time
+	if (scenario_speed < 0.) {
+		throw Exception("Invalid replay speed %f, must be zero or positive", scenario_speed);
+	}
+	std::vector<std::string> merged_logs;
+
 #if __cplusplus >= 201103L
 	std::unique_ptr<Configuration::ValueIterator> i(config->search(logs_prefix.c_str()));
 #else
@@ -122,6 +145,12 @@ BlackBoardLogReplayPlugin::BlackBoardLogReplayPlugin(Configuration *config) : Pl
 
 			printf("Log name: %s  log_prefix: %s\n", log_name.c_str(), log_prefix.c_str());
 
+			if (scenario_merged) {
+				merged_logs.push_back(i->get_string());
+				logs.insert(log_name);
+				continue;
+			}
+
 			bool        loop_replay  = scenario_loop_replay;
 			bool        non_blocking = scenario_non_blocking;
 			float       grace_period = scenario_grace_period;
@@ -191,6 +220,20 @@ BlackBoardLogReplayPlugin::BlackBoardLogReplayPlugin(Configuration *config) : Pl
 		}
 	}
 
+	if (!merged_logs.empty()) {
+		if (scenario_sim_time) {
+			thread_list.push_back(new BBLogMergedReplaySimTimeThread(merged_logs,
+			                                                         logdir.c_str(),
+			                                                         scenario_speed,
+			                                                         scenario_loop_replay));
+		} else {
+			thread_list.push_back(new BBLogMergedReplayThread(merged_logs,
+			                                                  logdir.c_str(),
+			                                                  scenario_speed,
+			                                                  scenario_loop_replay));
+		}
+	}
+
 	if (thread_list.empty()) {
 		throw Exception("No interfaces configured for log replay, aborting");
 	}
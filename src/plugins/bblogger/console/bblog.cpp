@@ -21,10 +21,13 @@
  */
 
 #include "../bblogfile.h"
+#include "../container.h"
 
 #include <arpa/inet.h>
 #include <blackboard/internal/instance_factory.h>
 #include <blackboard/remote.h>
+#include <core/exceptions/system.h>
+#include <fcntl.h>
 #include <interfaces/SwitchInterface.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -37,7 +40,10 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <memory>
 #include <unistd.h>
 
 using namespace fawkes;
@@ -47,7 +53,11 @@ print_usage(const char *program_name)
 {
 	printf("Usage: %s [-h] [-r host:port] <COMMAND> <logfile>\n"
 	       "       %s print <logfile> <index> [index ...]\n"
-	       "       %s convert <infile> <outfile> <format>\n"
+	       "       %s convert <infile> <outfile> <format> [start_sec [end_sec]]\n"
+	       "       %s query <coldir> <field> [start_sec [end_sec]]\n"
+	       "       %s replay <logfile> [start_sec]\n"
+	       "       %s pack <outfile> <logfile> [logfile ...]\n"
+	       "       %s unpack <infile> <outdir>\n"
 	       "\n"
 	       " -h  Print this usage information\n"
 	       "COMMANDS:\n"
@@ -56,6 +66,7 @@ print_usage(const char *program_name)
 	       " print     Print specific data index\n"
 	       "           <index> [index ...] is a list of indices to print\n"
 	       " replay    Replay log file in real-time to console\n"
+	       "           [start_sec] time offset in seconds to start from\n"
 	       " repair    Repair file, i.e. properly set number of entries\n"
 	       " enable    Enable logging on a remotely running bblogger\n"
 	       " disable   Disable logging on a remotely running bblogger\n"
@@ -63,16 +74,58 @@ print_usage(const char *program_name)
 	       "           <infile>  input log file\n"
 	       "           <outfile> converted output file\n"
 	       "           <format>  format to convert to, currently supported:\n"
-	       "             - csv  Comma-separated values\n",
+	       "             - csv      Comma-separated values\n"
+	       "             - columns  Directory with one binary file per field\n"
+	       "           [start_sec [end_sec]] only convert entries in time range\n"
+	       " query     Print a field of a columns directory, optionally in time range\n"
+	       " pack      Merge log files into a single container file\n"
+	       " unpack    Split container file into one log file per interface\n",
+	       program_name,
+	       program_name,
+	       program_name,
+	       program_name,
 	       program_name,
 	       program_name,
 	       program_name);
 }
 
+void
+print_container_info(std::string &filename)
+{
+	BBLogContainerReader cr(filename.c_str());
+
+	printf("Container file (version %u), %s index\n"
+	       "# chunks:   %-10u  File size: %zu bytes\n"
+	       "\n"
+	       "Scenario:   %s\n"
+	       "Start time: %s\n"
+	       "Interfaces:\n",
+	       BBLOGGER_CONTAINER_VERSION,
+	       cr.has_index() ? "with" : "rebuilt",
+	       cr.num_chunks(),
+	       cr.file_size(),
+	       cr.scenario(),
+	       cr.start_time().str());
+	for (unsigned int i = 0; i < cr.num_interfaces(); ++i) {
+		const bblog_interface_record &rec = cr.interface_info(i);
+		printf("  %3u: %.*s::%.*s (%u bytes)\n",
+		       i,
+		       BBLOG_INTERFACE_TYPE_SIZE,
+		       rec.interface_type,
+		       BBLOG_INTERFACE_ID_SIZE,
+		       rec.interface_id,
+		       rec.data_size);
+	}
+}
+
 int
 print_info(std::string &filename)
 {
 	try {
+		if (BBLogContainerReader::is_container(filename.c_str())) {
+			print_container_info(filename);
+			return 0;
+		}
 		BBLogFile bf(filename.c_str());
 		bf.print_info();
 		return 0;
@@ -123,13 +176,17 @@ print_indexes(std::string &filename, std::vector<unsigned int> &indexes)
 }
 
 int
-replay_file(std::string &filename)
+replay_file(std::string &filename, float start_sec)
 {
 	try {
 		BBLogFile bf(filename.c_str());
 
 		Time last_offset((long)0);
 
+		if (start_sec > 0.) {
+			bf.seek_time(Time((double)start_sec));
+		}
+
 		if (!bf.has_next()) {
 			printf("File does not have any entries, aborting.\n");
 			return -1;
@@ -254,8 +311,89 @@ set_enabled(const char *hostname, unsigned short int port, bool enabled)
 
 /// @endcond
 
+/// @cond INTERNAL
+typedef struct
+{
+	interface_fieldtype_t type;
+	const char *          name;
+	size_t                size;
+} column_type_t;
+
+static const column_type_t column_types[] = {{IFT_BOOL, "bool", sizeof(bool)},
+                                             {IFT_INT8, "int8", sizeof(int8_t)},
+                                             {IFT_UINT8, "uint8", sizeof(uint8_t)},
+                                             {IFT_INT16, "int16", sizeof(int16_t)},
+                                             {IFT_UINT16, "uint16", sizeof(uint16_t)},
+                                             {IFT_INT32, "int32", sizeof(int32_t)},
+                                             {IFT_UINT32, "uint32", sizeof(uint32_t)},
+                                             {IFT_INT64, "int64", sizeof(int64_t)},
+                                             {IFT_UINT64, "uint64", sizeof(uint64_t)},
+                                             {IFT_FLOAT, "float", sizeof(float)},
+                                             {IFT_DOUBLE, "double", sizeof(double)},
+                                             {IFT_STRING, "string", sizeof(char)},
+                                             {IFT_BYTE, "byte", sizeof(uint8_t)},
+                                             {IFT_ENUM, "enum", sizeof(int32_t)}};
+
+static const column_type_t *
+column_type(interface_fieldtype_t type)
+{
+	for (const column_type_t &ct : column_types) {
+		if (ct.type == type)
+			return &ct;
+	}
+	throw Exception("Unknown field type %i", type);
+}
+
+static const column_type_t *
+column_type(const char *name)
+{
+	for (const column_type_t &ct : column_types) {
+		if (strcmp(ct.name, name) == 0)
+			return &ct;
+	}
+	throw Exception("Unknown column type '%s'", name);
+}
+
+/** Memory-mapped column file. */
+class ColumnFile
+{
+public:
+	ColumnFile(const std::string &filename) : data(NULL), size(0)
+	{
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd == -1) {
+			throw CouldNotOpenFileException(filename.c_str(), errno);
+		}
+		struct stat s;
+		if (fstat(fd, &s) != 0) {
+			::close(fd);
+			throw FileReadException(filename.c_str(), errno, "Cannot stat column");
+		}
+		size = s.st_size;
+		if (size > 0) {
+			void *m = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+			if (m == MAP_FAILED) {
+				::close(fd);
+				throw FileReadException(filename.c_str(), errno, "Cannot map column");
+			}
+			data = (const char *)m;
+		}
+		::close(fd);
+	}
+
+	~ColumnFile()
+	{
+		if (data)
+			munmap((void *)data, size);
+	}
+
+	const char *data;
+	size_t      size;
+};
+/// @endcond
+
 void
-convert_file_csv(BBLogFile &bf, FILE *outf)
+convert_file_csv(BBLogFile &bf, FILE *outf, float end_sec)
 {
 	fawkes::Interface *iface = bf.interface();
 
@@ -269,6 +407,8 @@ convert_file_csv(BBLogFile &bf, FILE *outf)
 
 	while (bf.has_next()) {
 		bf.read_next();
+		if (bf.entry_offset().in_sec() > end_sec)
+			break;
 		fprintf(outf, "%f", bf.entry_offset().in_sec());
 
 		InterfaceFieldIterator i;
@@ -279,40 +419,362 @@ convert_file_csv(BBLogFile &bf, FILE *outf)
 	}
 }
 
+void
+convert_file_columns(BBLogFile &bf, std::string &outdir, float end_sec)
+{
+	fawkes::Interface *iface = bf.interface();
+
+	if (mkdir(outdir.c_str(), 0755) != 0) {
+		throw Exception(errno, "Cannot create column directory %s", outdir.c_str());
+	}
+
+	std::vector<FILE *>                outf;
+	std::vector<const column_type_t *> types;
+	std::vector<size_t>                sizes;
+	try {
+		outf.push_back(fopen((outdir + "/time.col").c_str(), "wx"));
+		InterfaceFieldIterator i;
+		for (i = iface->fields(); i != iface->fields_end(); ++i) {
+			outf.push_back(fopen((outdir + "/" + i.get_name() + ".col").c_str(), "wx"));
+			types.push_back(column_type(i.get_type()));
+			sizes.push_back(types.back()->size * i.get_length());
+		}
+		for (FILE *f : outf) {
+			if (!f)
+				throw CouldNotOpenFileException(outdir.c_str(), errno);
+		}
+
+		unsigned int num_rows = 0;
+		while (bf.has_next()) {
+			bf.read_next();
+			if (bf.entry_offset().in_sec() > end_sec)
+				break;
+
+			double offset = bf.entry_offset().in_sec();
+			bool   ok     = (fwrite(&offset, sizeof(offset), 1, outf[0]) == 1);
+
+			unsigned int c = 1;
+			for (i = iface->fields(); ok && i != iface->fields_end(); ++i, ++c) {
+				ok = (fwrite(i.get_value(), sizes[c - 1], 1, outf[c]) == 1);
+			}
+			if (!ok) {
+				throw FileWriteException(outdir.c_str(), errno, "Failed to write column");
+			}
+			num_rows += 1;
+		}
+
+		FILE *schema = fopen((outdir + "/schema").c_str(), "wx");
+		if (!schema) {
+			throw CouldNotOpenFileException(outdir.c_str(), errno);
+		}
+		fprintf(schema,
+		        "# %s::%s, %u rows\n"
+		        "# name type length\n"
+		        "time double 1\n",
+		        iface->type(),
+		        iface->id(),
+		        num_rows);
+		unsigned int c = 0;
+		for (i = iface->fields(); i != iface->fields_end(); ++i, ++c) {
+			fprintf(schema, "%s %s %zu\n", i.get_name(), types[c]->name, i.get_length());
+		}
+		fclose(schema);
+	} catch (Exception &e) {
+		for (FILE *f : outf) {
+			if (f)
+				fclose(f);
+		}
+		throw;
+	}
+
+	for (FILE *f : outf)
+		fclose(f);
+}
+
+int
+pack_files(std::string &outfile, std::vector<std::string> &infiles)
+{
+	try {
+		std::vector<std::unique_ptr<BBLogFile>> files;
+		std::vector<unsigned int>               next(infiles.size(), 0);
+		std::vector<unsigned int>               ifidx(infiles.size());
+		std::vector<Time>                       shift(infiles.size());
+
+		for (const std::string &f : infiles) {
+			files.emplace_back(new BBLogFile(f.c_str(), true));
+		}
+
+		// files of one run share the start time, otherwise align to the earliest
+		Time start = files[0]->start_time();
+		for (auto &f : files) {
+			if (f->start_time() < start)
+				start = f->start_time();
+		}
+
+		BBLogContainerWriter cw(outfile.c_str(), files[0]->scenario(), start);
+		for (unsigned int i = 0; i < files.size(); ++i) {
+			shift[i] = files[i]->start_time() - start;
+			ifidx[i] = cw.add_interface(files[i]->interface_type(),
+			                            files[i]->interface_id(),
+			                            files[i]->interface_hash(),
+			                            files[i]->data_size());
+		}
+
+		// merge entries of all files ordered by time
+		while (true) {
+			int         min_file = -1;
+			Time        min_time;
+			const void *min_data = NULL;
+			for (unsigned int i = 0; i < files.size(); ++i) {
+				if (next[i] < files[i]->num_entries()) {
+					Time        offset;
+					const void *data = files[i]->entry_data(next[i], &offset);
+					offset += shift[i];
+					if (min_file < 0 || offset < min_time) {
+						min_file = i;
+						min_time = offset;
+						min_data = data;
+					}
+				}
+			}
+			if (min_file < 0)
+				break;
+
+			cw.append(ifidx[min_file], min_time, min_data);
+			next[min_file] += 1;
+		}
+
+		cw.close();
+		printf("Packed %u entries of %zu files into %s\n",
+		       cw.num_records(),
+		       files.size(),
+		       outfile.c_str());
+		return 0;
+	} catch (Exception &e) {
+		printf("Failed to pack files, exception follows\n");
+		e.print_trace();
+		return -1;
+	}
+}
+
+int
+unpack_file(std::string &infile, std::string &outdir)
+{
+	std::vector<FILE *> outf;
+	try {
+		BBLogContainerReader cr(infile.c_str());
+
+		std::vector<bblog_file_header> headers(cr.num_interfaces());
+		for (unsigned int i = 0; i < cr.num_interfaces(); ++i) {
+			const bblog_interface_record &rec    = cr.interface_info(i);
+			bblog_file_header &           header = headers[i];
+
+			memset(&header, 0, sizeof(header));
+			header.file_magic   = htonl(BBLOGGER_FILE_MAGIC);
+			header.file_version = htonl(BBLOGGER_FILE_VERSION);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			header.endianess = BBLOG_BIG_ENDIAN;
+#else
+			header.endianess = BBLOG_LITTLE_ENDIAN;
+#endif
+			strncpy(header.scenario, cr.scenario(), BBLOG_SCENARIO_SIZE - 1);
+			memcpy(header.interface_type, rec.interface_type, BBLOG_INTERFACE_TYPE_SIZE);
+			memcpy(header.interface_id, rec.interface_id, BBLOG_INTERFACE_ID_SIZE);
+			memcpy(header.interface_hash, rec.interface_hash, BBLOG_INTERFACE_HASH_SIZE);
+			header.data_size = rec.data_size;
+			long start_time_sec, start_time_usec;
+			cr.start_time().get_timestamp(start_time_sec, start_time_usec);
+			header.start_time_sec  = start_time_sec;
+			header.start_time_usec = start_time_usec;
+
+			std::string filename = outdir + "/" + header.scenario + "-"
+			                       + std::string(rec.interface_type, strnlen(rec.interface_type,
+			                                                                 BBLOG_INTERFACE_TYPE_SIZE))
+			                       + "-"
+			                       + std::string(rec.interface_id,
+			                                     strnlen(rec.interface_id, BBLOG_INTERFACE_ID_SIZE))
+			                       + ".log";
+			FILE *f = fopen(filename.c_str(), "wx");
+			if (!f) {
+				throw CouldNotOpenFileException(filename.c_str(), errno);
+			}
+			outf.push_back(f);
+			if (fwrite(&header, sizeof(header), 1, f) != 1) {
+				throw FileWriteException(filename.c_str(), errno, "Failed to write header");
+			}
+		}
+
+		while (cr.has_next()) {
+			cr.read_next();
+			unsigned int i = cr.entry_interface();
+
+			bblog_entry_header ehead;
+			long               rel_time_sec, rel_time_usec;
+			cr.entry_offset().get_timestamp(rel_time_sec, rel_time_usec);
+			ehead.rel_time_sec  = rel_time_sec;
+			ehead.rel_time_usec = rel_time_usec;
+			if ((fwrite(&ehead, sizeof(ehead), 1, outf[i]) != 1)
+			    || (fwrite(cr.entry_data(), headers[i].data_size, 1, outf[i]) != 1)) {
+				throw FileWriteException(infile.c_str(), errno, "Failed to write entry");
+			}
+			headers[i].num_data_items += 1;
+		}
+
+		// update number of entries
+		for (unsigned int i = 0; i < outf.size(); ++i) {
+			if ((fseek(outf[i], 0, SEEK_SET) != 0)
+			    || (fwrite(&headers[i], sizeof(bblog_file_header), 1, outf[i]) != 1)) {
+				throw FileWriteException(infile.c_str(), errno, "Failed to update header");
+			}
+			printf("%.*s::%.*s: %u entries\n",
+			       BBLOG_INTERFACE_TYPE_SIZE,
+			       headers[i].interface_type,
+			       BBLOG_INTERFACE_ID_SIZE,
+			       headers[i].interface_id,
+			       headers[i].num_data_items);
+		}
+	} catch (Exception &e) {
+		for (FILE *f : outf)
+			fclose(f);
+		printf("Failed to unpack file, exception follows\n");
+		e.print_trace();
+		return -1;
+	}
+
+	for (FILE *f : outf)
+		fclose(f);
+	return 0;
+}
+
 int
-convert_file(std::string &infile, std::string &outfile, std::string &format)
+convert_file(std::string &infile,
+             std::string &outfile,
+             std::string &format,
+             float        start_sec,
+             float        end_sec)
 {
-	if (format != "csv") {
+	if ((format != "csv") && (format != "columns")) {
 		printf("Unsupported output format '%s'\n", format.c_str());
 		return 8;
 	}
 
-	FILE *outf = fopen(outfile.c_str(), "wx");
-	if (!outf) {
-		perror("Failed to open output file");
-		return 3;
+	FILE *outf = NULL;
+	if (format == "csv") {
+		outf = fopen(outfile.c_str(), "wx");
+		if (!outf) {
+			perror("Failed to open output file");
+			return 3;
+		}
 	}
 
 	try {
 		BBLogFile bf(infile.c_str());
 
+		// only touch entries in the requested time range
+		if (start_sec > 0.) {
+			bf.seek_time(Time((double)start_sec));
+		}
 		// Do the conversion!
 		if (format == "csv") {
-			convert_file_csv(bf, outf);
+			convert_file_csv(bf, outf, end_sec);
+		} else if (format == "columns") {
+			convert_file_columns(bf, outfile, end_sec);
 		}
 
 	} catch (Exception &e) {
 		printf("Failed to convert log file: %s\n", e.what());
 		e.print_trace();
-		fclose(outf);
+		if (outf)
+			fclose(outf);
 		return 4;
 	}
 
-	fclose(outf);
+	if (outf)
+		fclose(outf);
 
 	return 0;
 }
 
+void
+print_column_value(const column_type_t *type, const char *data, size_t length)
+{
+	if (type->type == IFT_STRING) {
+		printf("%.*s", (int)length, data);
+		return;
+	}
+
+	for (size_t i = 0; i < length; ++i, data += type->size) {
+		if (i > 0)
+			printf(", ");
+		switch (type->type) {
+		case IFT_BOOL: printf("%s", *(const bool *)data ? "true" : "false"); break;
+		case IFT_INT8: printf("%i", *(const int8_t *)data); break;
+		case IFT_UINT8:
+		case IFT_BYTE: printf("%u", *(const uint8_t *)data); break;
+		case IFT_INT16: printf("%i", *(const int16_t *)data); break;
+		case IFT_UINT16: printf("%u", *(const uint16_t *)data); break;
+		case IFT_INT32:
+		case IFT_ENUM: printf("%i", *(const int32_t *)data); break;
+		case IFT_UINT32: printf("%u", *(const uint32_t *)data); break;
+		case IFT_INT64: printf("%lli", (long long int)*(const int64_t *)data); break;
+		case IFT_UINT64: printf("%llu", (unsigned long long int)*(const uint64_t *)data); break;
+		case IFT_FLOAT: printf("%f", *(const float *)data); break;
+		case IFT_DOUBLE: printf("%f", *(const double *)data); break;
+		default: break;
+		}
+	}
+}
+
+int
+query_columns(std::string &coldir, std::string &field, float start_sec, float end_sec)
+{
+	try {
+		FILE *schema = fopen((coldir + "/schema").c_str(), "r");
+		if (!schema) {
+			throw CouldNotOpenFileException((coldir + "/schema").c_str(), errno);
+		}
+		const column_type_t *type   = NULL;
+		size_t               length = 0;
+		char                 line[1024];
+		while (!type && fgets(line, sizeof(line), schema)) {
+			char   name[256], type_name[64];
+			size_t l;
+			if ((line[0] != '#') && (sscanf(line, "%255s %63s %zu", name, type_name, &l) == 3)
+			    && (field == name)) {
+				type   = column_type(type_name);
+				length = l;
+			}
+		}
+		fclose(schema);
+		if (!type) {
+			throw Exception("Field %s not found in %s", field.c_str(), coldir.c_str());
+		}
+
+		ColumnFile    time_col(coldir + "/time.col");
+		ColumnFile    value_col(coldir + "/" + field + ".col");
+		const double *times     = (const double *)time_col.data;
+		size_t        num_rows  = time_col.size / sizeof(double);
+		size_t        elem_size = type->size * length;
+		if (value_col.size < num_rows * elem_size) {
+			throw Exception("Column %s is shorter than time column", field.c_str());
+		}
+
+		// times are sorted, only touch rows within the requested range
+		const double *first = std::lower_bound(times, times + num_rows, (double)start_sec);
+		const double *last  = std::upper_bound(first, times + num_rows, (double)end_sec);
+		for (const double *t = first; t != last; ++t) {
+			printf("%f;", *t);
+			print_column_value(type, value_col.data + (t - times) * elem_size, length);
+			printf("\n");
+		}
+		return 0;
+	} catch (Exception &e) {
+		printf("Failed to query columns, exception follows\n");
+		e.print_trace();
+		return -1;
+	}
+}
+
 /** BBLogger tool main.
  * @param argc argument count
  * @param argv arguments
@@ -366,7 +828,11 @@ main(int argc, char **argv)
 		return print_indexes(file, indexes);
 
 	} else if (command == "replay") {
-		return replay_file(file);
+		float start_sec = 0.;
+		if (argp.num_items() >= 3) {
+			start_sec = atof(argp.items()[2]);
+		}
+		return replay_file(file, start_sec);
 
 	} else if (command == "repair") {
 		return repair_file(file);
@@ -382,14 +848,53 @@ main(int argc, char **argv)
 		return rv;
 
 	} else if (command == "convert") {
-		if (argp.num_items() != 4) {
+		if ((argp.num_items() < 4) || (argp.num_items() > 6)) {
 			printf("Invalid number of arguments\n");
 			print_usage(argv[0]);
 			exit(7);
 		}
-		std::string outfile = argp.items()[2];
-		std::string format  = argp.items()[3];
-		return convert_file(file, outfile, format);
+		std::string outfile   = argp.items()[2];
+		std::string format    = argp.items()[3];
+		float       start_sec = 0.;
+		float       end_sec   = std::numeric_limits<float>::max();
+		if (argp.num_items() >= 5)
+			start_sec = atof(argp.items()[4]);
+		if (argp.num_items() >= 6)
+			end_sec = atof(argp.items()[5]);
+		return convert_file(file, outfile, format, start_sec, end_sec);
+
+	} else if (command == "query") {
+		if ((argp.num_items() < 3) || (argp.num_items() > 5)) {
+			printf("Invalid number of arguments\n");
+			print_usage(argv[0]);
+			exit(11);
+		}
+		std::string field     = argp.items()[2];
+		float       start_sec = 0.;
+		float       end_sec   = std::numeric_limits<float>::max();
+		if (argp.num_items() >= 4)
+			start_sec = atof(argp.items()[3]);
+		if (argp.num_items() >= 5)
+			end_sec = atof(argp.items()[4]);
+		return query_columns(file, field, start_sec, end_sec);
+
+	} else if (command == "pack") {
+		if (argp.num_items() < 3) {
+			printf("Invalid number of arguments\n");
+			print_usage(argv[0]);
+			exit(9);
+		}
+		std::vector<std::string> infiles(argp.items().begin() + 2, argp.items().end());
+		return pack_files(file, infiles);
+
+	} else if (command == "unpack") {
+		if (argp.num_items() != 3) {
+			printf("Invalid number of arguments\n");
+			print_usage(argv[0]);
+			exit(10);
+		}
+		std::string outdir = argp.items()[2];
+		return unpack_file(file, outdir);
 
 	} else {
 		printf("Invalid command '%s'\n", command.c_str());
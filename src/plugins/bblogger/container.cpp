@@ -0,0 +1,746 @@
+
+/***************************************************************************
+ *  container.cpp - BlackBoard log container files holding many interfaces
+ *
+ *  Created: Thu Oct 15 07:08:32 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "container.h"
+
+#include <core/exceptions/software.h>
+#include <core/exceptions/system.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <arpa/inet.h>
+#include <sys/stat.h>
+#ifdef HAVE_LZ4
+#	include <lz4.h>
+#endif
+
+using namespace fawkes;
+
+/** @class BBLogContainerWriter "container.h"
+ * Writer for bblogger container files.
+ * A container file holds the data of any number of interfaces in a single
+ * append-only file. Records are collected in memory and written in chunks
+ * of about the configured size, which are LZ4 compressed if available.
+ * On close an index of all chunks is appended which allows to seek in
+ * the file without reading it completely.
+ *
+ * All methods are thread-safe, one writer is shared among all logger
+ * threads of a scenario.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param filename name of the file to create, must not exist
+ * @param scenario ID of the log scenario
+ * @param start_time time to use as start time for the log
+ * @param chunk_size size of the uncompressed data after which a chunk is written
+ * @param compress true to compress chunks if compression is available
+ * @exception CouldNotOpenFileException thrown if the file cannot be created
+ * @exception FileWriteException thrown if the header cannot be written
+ */
+BBLogContainerWriter::BBLogContainerWriter(const char *        filename,
+                                           const char *        scenario,
+                                           const fawkes::Time &start_time,
+                                           size_t              chunk_size,
+                                           bool                compress)
+{
+	f_ = fopen(filename, "wx");
+	if (!f_) {
+		throw CouldNotOpenFileException(filename, errno, "Failed to create container log");
+	}
+
+	filename_    = strdup(filename);
+	mutex_       = new Mutex();
+	closed_      = false;
+	compress_    = compress && compression_available();
+	chunk_size_  = chunk_size;
+	num_records_ = 0;
+	last_rel_time_.set_time(0, 0);
+	memset(&chunk_header_, 0, sizeof(chunk_header_));
+	chunk_.reserve(chunk_size_ + 4096);
+
+	memset(&header_, 0, sizeof(header_));
+	header_.file_magic   = htonl(BBLOGGER_FILE_MAGIC);
+	header_.file_version = htonl(BBLOGGER_CONTAINER_VERSION);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	header_.endianess = BBLOG_BIG_ENDIAN;
+#else
+	header_.endianess = BBLOG_LITTLE_ENDIAN;
+#endif
+	strncpy(header_.scenario, scenario, BBLOG_SCENARIO_SIZE - 1);
+	long start_time_sec, start_time_usec;
+	start_time.get_timestamp(start_time_sec, start_time_usec);
+	header_.start_time_sec  = start_time_sec;
+	header_.start_time_usec = start_time_usec;
+
+	if (fwrite(&header_, sizeof(header_), 1, f_) != 1) {
+		fclose(f_);
+		free(filename_);
+		delete mutex_;
+		throw FileWriteException(filename, errno, "Failed to write container header");
+	}
+	fflush(f_);
+}
+
+/** Destructor.
+ * Closes the file if that has not been done before.
+ */
+BBLogContainerWriter::~BBLogContainerWriter()
+{
+	try {
+		close();
+	} catch (Exception &e) {
+		// nothing we can do about it at this point
+	}
+	free(filename_);
+	delete mutex_;
+}
+
+/** Check if chunks can be compressed.
+ * @return true if compression support has been compiled in, false otherwise
+ */
+bool
+BBLogContainerWriter::compression_available()
+{
+#ifdef HAVE_LZ4
+	return true;
+#else
+	return false;
+#endif
+}
+
+/** Get file name.
+ * @return name of the written file
+ */
+const char *
+BBLogContainerWriter::filename() const
+{
+	return filename_;
+}
+
+/** Get number of data records.
+ * @return number of data records appended so far
+ */
+unsigned int
+BBLogContainerWriter::num_records() const
+{
+	MutexLocker lock(mutex_);
+	return num_records_;
+}
+
+/** Announce an interface.
+ * @param type interface type
+ * @param id interface ID
+ * @param hash interface hash
+ * @param data_size size of the interface data chunk
+ * @return index of the interface to pass to append()
+ */
+unsigned int
+BBLogContainerWriter::add_interface(const char *         type,
+                                    const char *         id,
+                                    const unsigned char *hash,
+                                    size_t               data_size)
+{
+	MutexLocker lock(mutex_);
+
+	bblog_interface_record rec;
+	memset(&rec, 0, sizeof(rec));
+	strncpy(rec.interface_type, type, BBLOG_INTERFACE_TYPE_SIZE - 1);
+	strncpy(rec.interface_id, id, BBLOG_INTERFACE_ID_SIZE - 1);
+	memcpy(rec.interface_hash, hash, BBLOG_INTERFACE_HASH_SIZE);
+	rec.data_size = data_size;
+
+	unsigned int index = interfaces_.size();
+	if (index > UINT16_MAX) {
+		throw Exception("Container %s cannot hold more than %u interfaces", filename_, UINT16_MAX + 1);
+	}
+	interfaces_.push_back(rec);
+	append_record(BBLOG_RECORD_INTERFACE, index, last_rel_time_, &rec, sizeof(rec));
+
+	return index;
+}
+
+/** Append data record.
+ * @param interface index of the interface as returned by add_interface()
+ * @param rel_time time since the start time of the log
+ * @param data interface data chunk of the size given to add_interface()
+ */
+void
+BBLogContainerWriter::append(unsigned int interface, const fawkes::Time &rel_time, const void *data)
+{
+	MutexLocker lock(mutex_);
+	if (closed_) {
+		throw Exception("Container %s has already been closed", filename_);
+	}
+	if (interface >= interfaces_.size()) {
+		throw OutOfBoundsException("Invalid container interface", interface, 0, interfaces_.size());
+	}
+
+	append_record(BBLOG_RECORD_DATA, interface, rel_time, data, interfaces_[interface].data_size);
+	num_records_ += 1;
+	last_rel_time_ = rel_time;
+
+	if (chunk_.size() >= chunk_size_) {
+		write_chunk();
+	}
+}
+
+/** Write pending records and flush file stream. */
+void
+BBLogContainerWriter::flush()
+{
+	MutexLocker lock(mutex_);
+	if (closed_)
+		return;
+
+	write_chunk();
+	fflush(f_);
+}
+
+/** Close file.
+ * Writes pending records and the index and updates the header. Records
+ * can no longer be appended afterwards.
+ */
+void
+BBLogContainerWriter::close()
+{
+	MutexLocker lock(mutex_);
+	if (closed_)
+		return;
+	closed_ = true;
+
+	try {
+		write_chunk();
+
+		bblog_index_header ih;
+		memset(&ih, 0, sizeof(ih));
+		ih.index_magic    = BBLOG_INDEX_MAGIC;
+		ih.num_chunks     = index_.size();
+		ih.num_interfaces = interfaces_.size();
+
+		long offset = ftell(f_);
+		if ((fwrite(&ih, sizeof(ih), 1, f_) != 1)
+		    || (fwrite(interfaces_.data(), sizeof(bblog_interface_record), interfaces_.size(), f_)
+		        != interfaces_.size())
+		    || (fwrite(index_.data(), sizeof(bblog_index_entry), index_.size(), f_)
+		        != index_.size())) {
+			throw FileWriteException(filename_, errno, "Failed to write container index");
+		}
+
+		header_.num_chunks   = index_.size();
+		header_.index_offset = offset;
+		if ((fseek(f_, 0, SEEK_SET) != 0) || (fwrite(&header_, sizeof(header_), 1, f_) != 1)) {
+			throw FileWriteException(filename_, errno, "Failed to update container header");
+		}
+	} catch (Exception &e) {
+		fclose(f_);
+		throw;
+	}
+
+	fclose(f_);
+}
+
+/** Append record to current chunk.
+ * @param type record type
+ * @param interface interface index
+ * @param rel_time time since the start time of the log
+ * @param payload record payload
+ * @param size size of payload
+ */
+void
+BBLogContainerWriter::append_record(uint16_t            type,
+                                    unsigned int        interface,
+                                    const fawkes::Time &rel_time,
+                                    const void *        payload,
+                                    size_t              size)
+{
+	long sec, usec;
+	rel_time.get_timestamp(sec, usec);
+
+	bblog_record_header rh;
+	rh.type          = type;
+	rh.interface     = interface;
+	rh.size          = size;
+	rh.rel_time_sec  = sec;
+	rh.rel_time_usec = usec;
+
+	if (chunk_header_.num_records == 0) {
+		chunk_header_.first_rel_time_sec  = sec;
+		chunk_header_.first_rel_time_usec = usec;
+	}
+	chunk_header_.num_records += 1;
+
+	chunk_.insert(chunk_.end(), (const char *)&rh, (const char *)&rh + sizeof(rh));
+	chunk_.insert(chunk_.end(), (const char *)payload, (const char *)payload + size);
+}
+
+/** Write current chunk to file.
+ * mutex_ must be locked.
+ */
+void
+BBLogContainerWriter::write_chunk()
+{
+	if (chunk_header_.num_records == 0)
+		return;
+
+	chunk_header_.chunk_magic = BBLOG_CHUNK_MAGIC;
+	chunk_header_.compression = BBLOG_COMPRESSION_NONE;
+	chunk_header_.raw_size    = chunk_.size();
+	chunk_header_.stored_size = chunk_.size();
+	const char *data          = chunk_.data();
+
+#ifdef HAVE_LZ4
+	if (compress_) {
+		compressed_.resize(LZ4_compressBound(chunk_.size()));
+		int rv =
+		  LZ4_compress_default(chunk_.data(), compressed_.data(), chunk_.size(), compressed_.size());
+		if (rv > 0 && (size_t)rv < chunk_.size()) {
+			chunk_header_.compression = BBLOG_COMPRESSION_LZ4;
+			chunk_header_.stored_size = rv;
+			data                      = compressed_.data();
+		}
+	}
+#endif
+
+	bblog_index_entry ie;
+	ie.offset              = ftell(f_);
+	ie.first_rel_time_sec  = chunk_header_.first_rel_time_sec;
+	ie.first_rel_time_usec = chunk_header_.first_rel_time_usec;
+
+	if ((fwrite(&chunk_header_, sizeof(chunk_header_), 1, f_) != 1)
+	    || (fwrite(data, chunk_header_.stored_size, 1, f_) != 1)) {
+		throw FileWriteException(filename_, errno, "Failed to write chunk");
+	}
+	index_.push_back(ie);
+
+	chunk_.clear();
+	memset(&chunk_header_, 0, sizeof(chunk_header_));
+}
+
+/** @class BBLogContainerReader "container.h"
+ * Reader for bblogger container files.
+ * Iterates over the data records of all interfaces in the order in which
+ * they were written. If the file has not been closed properly and thus
+ * has no index, the index is rebuilt by scanning the file on opening.
+ * Any incomplete chunk at the end of the file is ignored.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param filename container file to open
+ * @exception CouldNotOpenFileException thrown if file cannot be opened
+ * @exception Exception thrown if the file is not a valid container file
+ */
+BBLogContainerReader::BBLogContainerReader(const char *filename)
+{
+	f_ = fopen(filename, "r");
+	if (!f_) {
+		throw CouldNotOpenFileException(filename, errno);
+	}
+	filename_ = strdup(filename);
+
+	try {
+		if (fread(&header_, sizeof(header_), 1, f_) != 1) {
+			throw FileReadException(filename_, errno, "Failed to read container header");
+		}
+		if ((ntohl(header_.file_magic) != BBLOGGER_FILE_MAGIC)
+		    || (ntohl(header_.file_version) != BBLOGGER_CONTAINER_VERSION)) {
+			throw Exception("File %s is not a bblogger container file", filename_);
+		}
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		if (header_.endianess == 1)
+#else
+		if (header_.endianess == 0)
+#endif
+		{
+			throw Exception("File %s has incompatible endianess", filename_);
+		}
+
+		has_index_ = false;
+		if (header_.index_offset != 0) {
+			try {
+				read_index();
+				has_index_ = true;
+			} catch (Exception &e) {
+				// file has been truncated or modified after closing, scan it
+				interfaces_.clear();
+				index_.clear();
+			}
+		}
+		if (!has_index_) {
+			scan_chunks();
+		}
+	} catch (Exception &e) {
+		fclose(f_);
+		free(filename_);
+		throw;
+	}
+
+	header_.scenario[BBLOG_SCENARIO_SIZE - 1] = 0;
+	start_time_.set_time(header_.start_time_sec, header_.start_time_usec);
+	rewind();
+}
+
+/** Destructor. */
+BBLogContainerReader::~BBLogContainerReader()
+{
+	fclose(f_);
+	free(filename_);
+}
+
+/** Check if a file is a container file.
+ * @param filename file to check
+ * @return true if the file header denotes a container file, false otherwise
+ */
+bool
+BBLogContainerReader::is_container(const char *filename)
+{
+	FILE *f = fopen(filename, "r");
+	if (!f)
+		return false;
+
+	uint32_t magic_version[2];
+	bool     rv = (fread(magic_version, sizeof(magic_version), 1, f) == 1)
+	          && (ntohl(magic_version[0]) == BBLOGGER_FILE_MAGIC)
+	          && (ntohl(magic_version[1]) == BBLOGGER_CONTAINER_VERSION);
+	fclose(f);
+	return rv;
+}
+
+/** Read index from end of file. */
+void
+BBLogContainerReader::read_index()
+{
+	bblog_index_header ih;
+	if ((fseek(f_, header_.index_offset, SEEK_SET) != 0) || (fread(&ih, sizeof(ih), 1, f_) != 1)
+	    || (ih.index_magic != BBLOG_INDEX_MAGIC)) {
+		throw FileReadException(filename_, "Failed to read container index");
+	}
+
+	interfaces_.resize(ih.num_interfaces);
+	index_.resize(ih.num_chunks);
+	if ((fread(interfaces_.data(), sizeof(bblog_interface_record), ih.num_interfaces, f_)
+	     != ih.num_interfaces)
+	    || (fread(index_.data(), sizeof(bblog_index_entry), ih.num_chunks, f_) != ih.num_chunks)) {
+		throw FileReadException(filename_, "Container index truncated");
+	}
+}
+
+/** Rebuild index by scanning all chunks.
+ * This is used for files which have not been closed properly.
+ */
+void
+BBLogContainerReader::scan_chunks()
+{
+	size_t fsize  = file_size();
+	long   offset = sizeof(bblog_container_header);
+
+	bblog_chunk_header ch;
+	while ((fseek(f_, offset, SEEK_SET) == 0) && (fread(&ch, sizeof(ch), 1, f_) == 1)
+	       && (ch.chunk_magic == BBLOG_CHUNK_MAGIC)
+	       && (offset + sizeof(ch) + ch.stored_size <= fsize)) {
+		bblog_index_entry ie;
+		ie.offset              = offset;
+		ie.first_rel_time_sec  = ch.first_rel_time_sec;
+		ie.first_rel_time_usec = ch.first_rel_time_usec;
+		index_.push_back(ie);
+
+		// the interface records are spread over the chunks
+		load_chunk(index_.size() - 1);
+		size_t pos = 0;
+		while (pos < chunk_.size()) {
+			bblog_record_header rh;
+			memcpy(&rh, &chunk_[pos], sizeof(rh));
+			if (rh.type == BBLOG_RECORD_INTERFACE) {
+				bblog_interface_record rec;
+				memcpy(&rec, &chunk_[pos + sizeof(rh)], sizeof(rec));
+				interfaces_.push_back(rec);
+			}
+			pos += sizeof(rh) + rh.size;
+		}
+
+		offset += sizeof(ch) + ch.stored_size;
+	}
+}
+
+/** Load chunk into memory.
+ * @param chunk index of chunk to load
+ */
+void
+BBLogContainerReader::load_chunk(unsigned int chunk)
+{
+	bblog_chunk_header ch;
+	if ((fseek(f_, index_[chunk].offset, SEEK_SET) != 0) || (fread(&ch, sizeof(ch), 1, f_) != 1)
+	    || (ch.chunk_magic != BBLOG_CHUNK_MAGIC)) {
+		throw FileReadException(filename_, "Failed to read chunk header");
+	}
+
+	chunk_.resize(ch.raw_size);
+	if (ch.compression == BBLOG_COMPRESSION_NONE) {
+		if ((ch.stored_size != ch.raw_size) || (fread(chunk_.data(), ch.raw_size, 1, f_) != 1)) {
+			throw FileReadException(filename_, "Failed to read chunk");
+		}
+#ifdef HAVE_LZ4
+	} else if (ch.compression == BBLOG_COMPRESSION_LZ4) {
+		compressed_.resize(ch.stored_size);
+		if (fread(compressed_.data(), ch.stored_size, 1, f_) != 1) {
+			throw FileReadException(filename_, "Failed to read chunk");
+		}
+		int rv = LZ4_decompress_safe(compressed_.data(), chunk_.data(), ch.stored_size, ch.raw_size);
+		if (rv < 0 || (uint32_t)rv != ch.raw_size) {
+			throw Exception("Failed to decompress chunk %u of %s", chunk, filename_);
+		}
+#endif
+	} else {
+		throw Exception("Unsupported compression %u in chunk %u of %s",
+		                ch.compression,
+		                chunk,
+		                filename_);
+	}
+
+	// validate records once so that iterating them needs no checks
+	size_t pos = 0;
+	while (pos + sizeof(bblog_record_header) <= chunk_.size()) {
+		bblog_record_header rh;
+		memcpy(&rh, &chunk_[pos], sizeof(rh));
+		if (rh.type == BBLOG_RECORD_INTERFACE && rh.size != sizeof(bblog_interface_record)) {
+			break;
+		}
+		pos += sizeof(rh) + rh.size;
+	}
+	if (pos != chunk_.size()) {
+		throw Exception("Chunk %u of %s is corrupt", chunk, filename_);
+	}
+
+	chunk_idx_    = chunk;
+	chunk_pos_    = 0;
+	chunk_loaded_ = true;
+}
+
+/** Advance to the next data record.
+ * @return true if chunk_pos_ points to a data record, false if there are
+ * no more data records
+ */
+bool
+BBLogContainerReader::find_data_record()
+{
+	while (true) {
+		while (chunk_loaded_ && chunk_pos_ < chunk_.size()) {
+			bblog_record_header rh;
+			memcpy(&rh, &chunk_[chunk_pos_], sizeof(rh));
+			if (rh.type == BBLOG_RECORD_DATA)
+				return true;
+			chunk_pos_ += sizeof(rh) + rh.size;
+		}
+
+		unsigned int next = chunk_loaded_ ? chunk_idx_ + 1 : chunk_idx_;
+		if (next >= index_.size())
+			return false;
+		load_chunk(next);
+	}
+}
+
+/** Check if another data record is available.
+ * @return true if a consecutive read_next() will succeed, false otherwise
+ */
+bool
+BBLogContainerReader::has_next()
+{
+	return find_data_record();
+}
+
+/** Read next data record.
+ * @exception Exception thrown if no more records are left
+ */
+void
+BBLogContainerReader::read_next()
+{
+	if (!find_data_record()) {
+		throw Exception("No more records in %s", filename_);
+	}
+
+	bblog_record_header rh;
+	memcpy(&rh, &chunk_[chunk_pos_], sizeof(rh));
+	if ((rh.interface >= interfaces_.size()) || (rh.size != interfaces_[rh.interface].data_size)) {
+		throw Exception("Record in chunk %u of %s has invalid interface", chunk_idx_, filename_);
+	}
+	entry_interface_ = rh.interface;
+	entry_offset_.set_time(rh.rel_time_sec, rh.rel_time_usec);
+	entry_data_ = &chunk_[chunk_pos_ + sizeof(rh)];
+	chunk_pos_ += sizeof(rh) + rh.size;
+}
+
+/** Rewind to the first record. */
+void
+BBLogContainerReader::rewind()
+{
+	chunk_idx_       = 0;
+	chunk_pos_       = 0;
+	chunk_loaded_    = false;
+	entry_interface_ = 0;
+	entry_data_      = NULL;
+	entry_offset_.set_time(0, 0);
+}
+
+/** Seek to record by time.
+ * Uses the index to find the chunk that contains the given time and then
+ * moves to the first data record with an offset equal to or later than
+ * the given one, which will be read by the next call to read_next().
+ * @param offset time offset relative to the start time
+ */
+void
+BBLogContainerReader::seek_time(const fawkes::Time &offset)
+{
+	long sec  = offset.get_sec();
+	long usec = offset.get_usec();
+
+	// find last chunk starting before or at the given time
+	std::vector<bblog_index_entry>::iterator c =
+	  std::upper_bound(index_.begin(),
+	                   index_.end(),
+	                   std::make_pair(sec, usec),
+	                   [](const std::pair<long, long> &t, const bblog_index_entry &e) {
+		                   return (t.first < (long)e.first_rel_time_sec)
+		                          || ((t.first == (long)e.first_rel_time_sec)
+		                              && (t.second < (long)e.first_rel_time_usec));
+	                   });
+
+	rewind();
+	if (c != index_.begin()) {
+		load_chunk((c - index_.begin()) - 1);
+	}
+
+	while (find_data_record()) {
+		bblog_record_header rh;
+		memcpy(&rh, &chunk_[chunk_pos_], sizeof(rh));
+		if (((long)rh.rel_time_sec > sec)
+		    || (((long)rh.rel_time_sec == sec) && ((long)rh.rel_time_usec >= usec))) {
+			break;
+		}
+		chunk_pos_ += sizeof(rh) + rh.size;
+	}
+}
+
+/** Get scenario identifier.
+ * @return scenario identifier
+ */
+const char *
+BBLogContainerReader::scenario() const
+{
+	return header_.scenario;
+}
+
+/** Get start time.
+ * @return starting time of log
+ */
+const fawkes::Time &
+BBLogContainerReader::start_time() const
+{
+	return start_time_;
+}
+
+/** Check if the file has an index.
+ * @return true if the file has been closed properly and has an index,
+ * false if the index has been rebuilt on opening
+ */
+bool
+BBLogContainerReader::has_index() const
+{
+	return has_index_;
+}
+
+/** Get number of chunks.
+ * @return number of chunks in file
+ */
+unsigned int
+BBLogContainerReader::num_chunks() const
+{
+	return index_.size();
+}
+
+/** Get file size.
+ * @return total size of container file
+ */
+size_t
+BBLogContainerReader::file_size() const
+{
+	struct stat fs;
+	if (fstat(fileno(f_), &fs) != 0) {
+		throw Exception(errno, "Failed to stat file %s", filename_);
+	}
+	return fs.st_size;
+}
+
+/** Get number of interfaces.
+ * @return number of interfaces in file
+ */
+unsigned int
+BBLogContainerReader::num_interfaces() const
+{
+	return interfaces_.size();
+}
+
+/** Get interface information.
+ * @param index interface index
+ * @return interface record
+ */
+const bblog_interface_record &
+BBLogContainerReader::interface_info(unsigned int index) const
+{
+	if (index >= interfaces_.size()) {
+		throw OutOfBoundsException("Invalid container interface", index, 0, interfaces_.size());
+	}
+	return interfaces_[index];
+}
+
+/** Get interface of current record.
+ * @return index of the interface of the last read record
+ */
+unsigned int
+BBLogContainerReader::entry_interface() const
+{
+	return entry_interface_;
+}
+
+/** Get current record offset.
+ * @return offset from start time of the last read record
+ */
+const fawkes::Time &
+BBLogContainerReader::entry_offset() const
+{
+	return entry_offset_;
+}
+
+/** Get current record data.
+ * The pointer is valid until the next call to read_next(), rewind() or
+ * seek_time().
+ * @return interface data chunk of the last read record
+ */
+const void *
+BBLogContainerReader::entry_data() const
+{
+	return entry_data_;
+}
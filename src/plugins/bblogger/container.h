@@ -0,0 +1,142 @@
+
+/***************************************************************************
+ *  container.h - BlackBoard log container files holding many interfaces
+ *
+ *  Created: Thu Oct 15 07:08:32 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBLOGGER_CONTAINER_H_
+#define _PLUGINS_BBLOGGER_CONTAINER_H_
+
+#include "file.h"
+
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Mutex;
+}
+
+class BBLogContainerWriter
+{
+public:
+	BBLogContainerWriter(const char *        filename,
+	                     const char *        scenario,
+	                     const fawkes::Time &start_time,
+	                     size_t              chunk_size = 65536,
+	                     bool                compress   = true);
+	~BBLogContainerWriter();
+
+	unsigned int add_interface(const char *         type,
+	                           const char *         id,
+	                           const unsigned char *hash,
+	                           size_t               data_size);
+	void         append(unsigned int interface, const fawkes::Time &rel_time, const void *data);
+	void         flush();
+	void         close();
+
+	const char * filename() const;
+	unsigned int num_records() const;
+
+	static bool compression_available();
+
+private:
+	void append_record(uint16_t            type,
+	                   unsigned int        interface,
+	                   const fawkes::Time &rel_time,
+	                   const void *        payload,
+	                   size_t              size);
+	void write_chunk();
+
+private:
+	FILE *         f_;
+	char *         filename_;
+	fawkes::Mutex *mutex_;
+	bool           closed_;
+	bool           compress_;
+	size_t         chunk_size_;
+
+	bblog_container_header header_;
+
+	std::vector<char>  chunk_;
+	std::vector<char>  compressed_;
+	bblog_chunk_header chunk_header_;
+	unsigned int       num_records_;
+	fawkes::Time       last_rel_time_;
+
+	std::vector<bblog_interface_record> interfaces_;
+	std::vector<bblog_index_entry>      index_;
+};
+
+class BBLogContainerReader
+{
+public:
+	explicit BBLogContainerReader(const char *filename);
+	~BBLogContainerReader();
+
+	static bool is_container(const char *filename);
+
+	const char *        scenario() const;
+	const fawkes::Time &start_time() const;
+	bool                has_index() const;
+	unsigned int        num_chunks() const;
+	size_t              file_size() const;
+
+	unsigned int                  num_interfaces() const;
+	const bblog_interface_record &interface_info(unsigned int index) const;
+
+	bool has_next();
+	void read_next();
+	void rewind();
+	void seek_time(const fawkes::Time &offset);
+
+	unsigned int        entry_interface() const;
+	const fawkes::Time &entry_offset() const;
+	const void *        entry_data() const;
+
+private:
+	void read_index();
+	void scan_chunks();
+	void load_chunk(unsigned int chunk);
+	bool find_data_record();
+
+private:
+	FILE *                 f_;
+	char *                 filename_;
+	bblog_container_header header_;
+	bool                   has_index_;
+	fawkes::Time           start_time_;
+
+	std::vector<bblog_interface_record> interfaces_;
+	std::vector<bblog_index_entry>      index_;
+
+	std::vector<char> chunk_;
+	std::vector<char> compressed_;
+	unsigned int      chunk_idx_;
+	size_t            chunk_pos_;
+	bool              chunk_loaded_;
+
+	unsigned int entry_interface_;
+	fawkes::Time entry_offset_;
+	const char * entry_data_;
+};
+
+#endif
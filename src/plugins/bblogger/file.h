@@ -78,6 +78,103 @@ typedef struct
 	uint32_t rel_time_usec; /**< time since start time, microseconds */
 } bblog_entry_header;
 
+/** Container file format version.
+ * Container files hold the data of any number of interfaces in a single
+ * file. They start with a bblog_container_header, followed by chunks
+ * which each consist of a bblog_chunk_header and the (possibly compressed)
+ * records. Each record starts with a bblog_record_header, interface
+ * records announce an interface before its first data record. Once the
+ * file is closed, an index is appended and referenced from the header.
+ */
+#define BBLOGGER_CONTAINER_VERSION 2
+
+/** Magic value at the start of each chunk, allows to detect corruption. */
+#define BBLOG_CHUNK_MAGIC 0xbbc0ffee
+/** Magic value at the start of the container index. */
+#define BBLOG_INDEX_MAGIC 0xbb1dbb1d
+
+/** Compression of chunk data. */
+typedef enum {
+	BBLOG_COMPRESSION_NONE = 0, /**< chunk is stored uncompressed */
+	BBLOG_COMPRESSION_LZ4  = 1  /**< chunk is LZ4 compressed */
+} bblog_compression_t;
+
+/** Container record type. */
+typedef enum {
+	BBLOG_RECORD_INTERFACE = 1, /**< payload is a bblog_interface_record */
+	BBLOG_RECORD_DATA      = 2  /**< payload is an interface data chunk */
+} bblog_record_type_t;
+
+/** BBLogger container file header.
+ * Magic and version are stored in network byte order, like in
+ * bblog_file_header, anything else in native byte order.
+ */
+typedef struct
+{
+	uint32_t file_magic;                    /**< Magic value, BBLOGGER_FILE_MAGIC (big endian) */
+	uint32_t file_version;                  /**< BBLOGGER_CONTAINER_VERSION (big endian) */
+	uint32_t endianess : 1;                 /**< Endianess, 0 little endian, 1 big endian */
+	uint32_t reserved : 31;                 /**< Reserved for future use */
+	uint32_t num_chunks;                    /**< Number of chunks, zero if the file
+	                                         * has not been closed properly */
+	char     scenario[BBLOG_SCENARIO_SIZE]; /**< Scenario as defined in config */
+	uint64_t start_time_sec;                /**< Start time, timestamp seconds */
+	uint64_t start_time_usec;               /**< Start time, timestamp microseconds */
+	uint64_t index_offset;                  /**< File offset of the index,
+	                                         * zero if no index has been written */
+} bblog_container_header;
+
+/** BBLogger container chunk header. */
+typedef struct
+{
+	uint32_t chunk_magic;         /**< BBLOG_CHUNK_MAGIC */
+	uint32_t compression;         /**< compression, one of bblog_compression_t */
+	uint32_t raw_size;            /**< size of the uncompressed records */
+	uint32_t stored_size;         /**< size of the data following this header */
+	uint32_t num_records;         /**< number of records in this chunk */
+	uint32_t first_rel_time_sec;  /**< time of first record since start time, seconds */
+	uint32_t first_rel_time_usec; /**< time of first record since start time, microseconds */
+} bblog_chunk_header;
+
+/** BBLogger container record header. */
+typedef struct
+{
+	uint16_t type;          /**< record type, one of bblog_record_type_t */
+	uint16_t interface;     /**< index of the interface in the order of announcement */
+	uint32_t size;          /**< size of the payload following this header */
+	uint32_t rel_time_sec;  /**< time since start time, seconds */
+	uint32_t rel_time_usec; /**< time since start time, microseconds */
+} bblog_record_header;
+
+/** BBLogger container interface record. */
+typedef struct
+{
+	char          interface_type[BBLOG_INTERFACE_TYPE_SIZE]; /**< Interface type */
+	char          interface_id[BBLOG_INTERFACE_ID_SIZE];     /**< Interface ID */
+	unsigned char interface_hash[BBLOG_INTERFACE_HASH_SIZE]; /**< Interface Hash */
+	uint32_t      data_size;                                 /**< size of one data block */
+} bblog_interface_record;
+
+/** BBLogger container index header.
+ * Followed by num_interfaces bblog_interface_record and num_chunks
+ * bblog_index_entry.
+ */
+typedef struct
+{
+	uint32_t index_magic;    /**< BBLOG_INDEX_MAGIC */
+	uint32_t num_chunks;     /**< number of chunk entries */
+	uint32_t num_interfaces; /**< number of interface records */
+	uint32_t reserved;       /**< Reserved for future use */
+} bblog_index_header;
+
+/** BBLogger container index entry. */
+typedef struct
+{
+	uint64_t offset;              /**< file offset of the chunk header */
+	uint32_t first_rel_time_sec;  /**< time of first record since start time, seconds */
+	uint32_t first_rel_time_usec; /**< time of first record since start time, microseconds */
+} bblog_index_entry;
+
 #pragma pack(pop)
 
 #endif
@@ -22,18 +22,22 @@
 
 #include "log_thread.h"
 
+#include "container.h"
 #include "file.h"
 
 #include <blackboard/blackboard.h>
 #include <core/exceptions/system.h>
+#include <core/threading/mutex_locker.h>
 #include <interfaces/SwitchInterface.h>
 #include <logging/logger.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <limits>
 #include <memory>
 #ifdef __FreeBSD__
 #	include <sys/endian.h>
@@ -45,9 +49,13 @@
 #include <arpa/inet.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 using namespace fawkes;
 
+/** Size of file extents to preallocate ahead of the written data. */
+#define BBLOGGER_PREALLOC_SIZE (8 * 1024 * 1024)
+
 /** @class BBLoggerThread "log_thread.h"
  * BlackBoard logger thread.
  * One instance of this thread handles logging of one specific interface.
@@ -59,11 +67,18 @@ using namespace fawkes;
  * thus the writing operation can slow down the overall system, but memory
  * requirements are low. This is useful if a lot of data is written or if the
  * storage device is slow. If the mode is enabled, during the event the BB data
- * will be copied into another memory segment and the thread will be woken up.
- * Once the thread is running it stores all of the BB data segments bufferd
- * up to then.
+ * is appended to an in-memory block. The thread is woken up once the block is
+ * half full or the oldest buffered entry exceeds the maximum delay, it then
+ * swaps in the second block and writes the filled one with a single write.
+ * This groups many entries into few large writes, which is crucial for
+ * sustained high-rate logging to slow storage such as SD cards. Only if the
+ * block fills up before the thread could write it, the event handler writes
+ * it itself. File extents are preallocated in large steps where supported
+ * to avoid fragmentation and frequent metadata updates.
  * The interface listener listens for events for a particular interface and
  * then writes the changes to the file.
+ * If a container has been set, the data is appended to the container shared
+ * among all logger threads instead of writing one file per interface.
  * @author Tim Niemueller
  */
 
@@ -74,30 +89,39 @@ using namespace fawkes;
  * @param flushing true to flush after each written chunk
  * @param scenario ID of the log scenario
  * @param start_time time to use as start time for the log
+ * @param block_size size in bytes of the blocks used to buffer entries
+ * @param max_delay_msec maximum time in milliseconds an entry is buffered
+ * before the thread is woken up to write it, if more entries arrive
  */
 BBLoggerThread::BBLoggerThread(const char *  iface_uid,
                                const char *  logdir,
                                bool          buffering,
                                bool          flushing,
                                const char *  scenario,
-                               fawkes::Time *start_time)
+                               fawkes::Time *start_time,
+                               size_t        block_size,
+                               unsigned int  max_delay_msec)
 : Thread("BBLoggerThread", Thread::OPMODE_WAITFORWAKEUP),
   BlackBoardInterfaceListener("BBLoggerThread(%s)", iface_uid)
 {
 	set_coalesce_wakeups(true);
 	set_name("BBLoggerThread(%s)", iface_uid);
 
-	buffering_   = buffering;
-	flushing_    = flushing;
-	uid_         = strdup(iface_uid);
-	logdir_      = strdup(logdir);
-	scenario_    = strdup(scenario);
-	start_       = new Time(start_time);
-	filename_    = NULL;
-	queue_mutex_ = new Mutex();
-	data_size_   = 0;
-	is_master_   = false;
-	enabled_     = true;
+	buffering_      = buffering;
+	flushing_       = flushing;
+	uid_            = strdup(iface_uid);
+	logdir_         = strdup(logdir);
+	scenario_       = strdup(scenario);
+	start_          = new Time(start_time);
+	filename_       = NULL;
+	write_mutex_    = new Mutex();
+	buffer_mutex_   = new Mutex();
+	block_size_     = block_size;
+	max_delay_msec_ = max_delay_msec;
+	data_size_      = 0;
+	is_master_      = false;
+	enabled_        = true;
+	f_data_         = NULL;
 
 	now_ = NULL;
 
@@ -123,24 +147,78 @@ BBLoggerThread::~BBLoggerThread()
 	free(logdir_);
 	free(scenario_);
 	free(filename_);
-	delete queue_mutex_;
+	delete write_mutex_;
+	delete buffer_mutex_;
 	delete start_;
 }
 
 void
 BBLoggerThread::init()
 {
-	queues_[0].clear();
-	queues_[1].clear();
-	act_queue_ = 0;
-
-	queue_mutex_ = new Mutex();
-	data_size_   = 0;
+	data_size_ = 0;
 
 	now_            = NULL;
 	num_data_items_ = 0;
 	session_start_  = 0;
+	file_pos_       = 0;
+	prealloc_end_   = 0;
+
+	if (container_) {
+		init_container();
+	} else {
+		init_file();
+	}
+
+	now_ = new Time(clock);
+
+	size_t entry_size = sizeof(bblog_entry_header) + data_size_;
+	block_size_       = std::max(block_size_, entry_size);
+	block_.reserve(block_size_ + entry_size);
+	write_block_.reserve(block_size_ + entry_size);
+
+	if (is_master_) {
+		try {
+			switch_if_ = blackboard->open_for_writing<SwitchInterface>("BBLogger");
+			switch_if_->set_enabled(enabled_);
+			switch_if_->write();
+			bbil_add_message_interface(switch_if_);
+		} catch (Exception &e) {
+			blackboard->close(iface_);
+			if (f_data_)
+				fclose(f_data_);
+			throw;
+		}
+	}
+
+	bbil_add_data_interface(iface_);
+	bbil_add_writer_interface(iface_);
+
+	blackboard->register_listener(this);
+
+	logger->log_info(
+	  name(), "Logging %s to %s%s", iface_->uid(), filename_, is_master_ ? " as master" : "");
+}
+
+/** Open interface and announce it in the container. */
+void
+BBLoggerThread::init_container()
+{
+	iface_     = blackboard->open_for_reading(type_.c_str(), id_.c_str());
+	data_size_ = iface_->datasize();
 
+	try {
+		container_iface_ =
+		  container_->add_interface(iface_->type(), iface_->id(), iface_->hash(), data_size_);
+	} catch (Exception &e) {
+		blackboard->close(iface_);
+		throw;
+	}
+}
+
+/** Open interface and create log file for it. */
+void
+BBLoggerThread::init_file()
+{
 	// use open because fopen does not provide O_CREAT | O_EXCL
 	// open read/write because of usage of mmap
 	mode_t m  = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
@@ -169,28 +247,6 @@ BBLoggerThread::init()
 		fclose(f_data_);
 		throw;
 	}
-
-	now_ = new Time(clock);
-
-	if (is_master_) {
-		try {
-			switch_if_ = blackboard->open_for_writing<SwitchInterface>("BBLogger");
-			switch_if_->set_enabled(enabled_);
-			switch_if_->write();
-			bbil_add_message_interface(switch_if_);
-		} catch (Exception &e) {
-			fclose(f_data_);
-			throw;
-		}
-	}
-
-	bbil_add_data_interface(iface_);
-	bbil_add_writer_interface(iface_);
-
-	blackboard->register_listener(this);
-
-	logger->log_info(
-	  name(), "Logging %s to %s%s", iface_->uid(), filename_, is_master_ ? " as master" : "");
 }
 
 void
@@ -200,15 +256,22 @@ BBLoggerThread::finalize()
 	if (is_master_) {
 		blackboard->close(switch_if_);
 	}
-	update_header();
-	fclose(f_data_);
-	for (unsigned int q = 0; q < 2; ++q) {
-		while (!queues_[q].empty()) {
-			void *t = queues_[q].front();
-			free(t);
-			queues_[q].pop();
+	flush_buffer();
+	if (container_) {
+		container_->flush();
+	} else {
+		update_header();
+#ifdef FALLOC_FL_KEEP_SIZE
+		// release extents preallocated beyond the end of the file
+		if (prealloc_end_ > file_pos_ && ftruncate(fileno(f_data_), file_pos_) != 0) {
+			logger->log_warn(name(), "Failed to release preallocated space: %s", strerror(errno));
 		}
+#endif
+		fclose(f_data_);
+		f_data_ = NULL;
 	}
+	std::vector<char>().swap(block_);
+	std::vector<char>().swap(write_block_);
 	delete now_;
 	now_ = NULL;
 }
@@ -236,8 +299,7 @@ BBLoggerThread::set_enabled(bool enabled)
 		logger->log_info(name(),
 		                 "Logging disabled (wrote %u entries), flushing",
 		                 (num_data_items_ - session_start_));
-		update_header();
-		fflush(f_data_);
+		flush();
 	}
 
 	enabled_ = enabled;
@@ -256,6 +318,20 @@ BBLoggerThread::set_threadlist(fawkes::ThreadList &thread_list)
 	threads_   = thread_list;
 }
 
+/** Set container to log to.
+ * If set, data is appended to the given container instead of writing a
+ * file for the interface. This must be called before the thread is
+ * initialized.
+ * @param container container shared among logger threads
+ */
+void
+BBLoggerThread::set_container(std::shared_ptr<BBLogContainerWriter> container)
+{
+	container_ = container;
+	free(filename_);
+	filename_ = strdup(container_->filename());
+}
+
 void
 BBLoggerThread::write_header()
 {
@@ -263,7 +339,7 @@ BBLoggerThread::write_header()
 	memset(&header, 0, sizeof(header));
 	header.file_magic   = htonl(BBLOGGER_FILE_MAGIC);
 	header.file_version = htonl(BBLOGGER_FILE_VERSION);
-#if BYTE_ORDER_ == BIG_ENDIAN_
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
 	header.endianess = BBLOG_BIG_ENDIAN;
 #else
 	header.endianess = BBLOG_LITTLE_ENDIAN;
@@ -281,7 +357,22 @@ BBLoggerThread::write_header()
 	if (fwrite(&header, sizeof(header), 1, f_data_) != 1) {
 		throw FileWriteException(filename_, "Failed to write header");
 	}
+	// entries are written to the file descriptor directly
 	fflush(f_data_);
+	file_pos_ = sizeof(header);
+}
+
+/** Write pending data to storage. */
+void
+BBLoggerThread::flush()
+{
+	flush_buffer();
+	if (container_) {
+		container_->flush();
+	} else {
+		update_header();
+		fflush(f_data_);
+	}
 }
 
 /** Updates the num_data_items field in the header. */
@@ -308,41 +399,118 @@ BBLoggerThread::update_header()
 #endif
 }
 
+/** Append entry to block.
+ * @param block block to append to
+ * @param chunk interface data chunk
+ */
 void
-BBLoggerThread::write_chunk(const void *chunk)
+BBLoggerThread::append_entry(std::vector<char> &block, const void *chunk)
 {
-	bblog_entry_header ehead;
 	now_->stamp();
 	Time d = *now_ - *start_;
 	long rel_time_sec, rel_time_usec;
 	d.get_timestamp(rel_time_sec, rel_time_usec);
+
+	bblog_entry_header ehead;
 	ehead.rel_time_sec  = rel_time_sec;
 	ehead.rel_time_usec = rel_time_usec;
-	if ((fwrite(&ehead, sizeof(ehead), 1, f_data_) == 1)
-	    && (fwrite(chunk, data_size_, 1, f_data_) == 1)) {
-		if (flushing_)
-			fflush(f_data_);
-		num_data_items_ += 1;
-	} else {
-		logger->log_warn(name(), "Failed to write chunk");
+
+	block.insert(block.end(), (const char *)&ehead, (const char *)&ehead + sizeof(ehead));
+	block.insert(block.end(), (const char *)chunk, (const char *)chunk + data_size_);
+}
+
+/** Write entries to file or container.
+ * write_mutex_ must be locked.
+ * @param block block of consecutive entries, each consisting of a
+ * bblog_entry_header followed by the interface data chunk
+ */
+void
+BBLoggerThread::write_entries(const std::vector<char> &block)
+{
+	size_t entry_size = sizeof(bblog_entry_header) + data_size_;
+
+	if (container_) {
+		try {
+			for (size_t pos = 0; pos < block.size(); pos += entry_size) {
+				const bblog_entry_header *ehead = (const bblog_entry_header *)&block[pos];
+				Time d((long)ehead->rel_time_sec, (long)ehead->rel_time_usec);
+				container_->append(container_iface_, d, &block[pos + sizeof(bblog_entry_header)]);
+				num_data_items_ += 1;
+			}
+			if (flushing_)
+				container_->flush();
+		} catch (Exception &e) {
+			logger->log_warn(name(), "Failed to write chunk: %s", e.what_no_backtrace());
+		}
+		return;
+	}
+
+	int fd = fileno(f_data_);
+#ifdef FALLOC_FL_KEEP_SIZE
+	if (file_pos_ + (off_t)block.size() > prealloc_end_) {
+		off_t len = std::max((off_t)block.size(), (off_t)BBLOGGER_PREALLOC_SIZE);
+		if (fallocate(fd, FALLOC_FL_KEEP_SIZE, file_pos_, len) == 0) {
+			prealloc_end_ = file_pos_ + len;
+		} else {
+			// not supported by the file system, do not try again
+			prealloc_end_ = std::numeric_limits<off_t>::max();
+		}
+	}
+#endif
+
+	const char *data      = block.data();
+	size_t      remaining = block.size();
+	while (remaining > 0) {
+		ssize_t written = ::write(fd, data, remaining);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			logger->log_warn(name(), "Failed to write chunk: %s", strerror(errno));
+			break;
+		}
+		data += written;
+		remaining -= written;
+	}
+	file_pos_ += block.size() - remaining;
+	num_data_items_ += (block.size() - remaining) / entry_size;
+}
+
+/** Write single entry immediately.
+ * This is used if buffering is disabled.
+ * @param chunk interface data chunk
+ */
+void
+BBLoggerThread::write_chunk(const void *chunk)
+{
+	MutexLocker lock(write_mutex_);
+	write_block_.clear();
+	append_entry(write_block_, chunk);
+	write_entries(write_block_);
+}
+
+/** Write all buffered entries.
+ * Swaps the blocks such that the event handler can continue to buffer
+ * entries while the filled block is written.
+ */
+void
+BBLoggerThread::flush_buffer()
+{
+	MutexLocker write_lock(write_mutex_);
+
+	buffer_mutex_->lock();
+	block_.swap(write_block_);
+	buffer_mutex_->unlock();
+
+	if (!write_block_.empty()) {
+		write_entries(write_block_);
+		write_block_.clear();
 	}
 }
 
 void
 BBLoggerThread::loop()
 {
-	unsigned int write_queue = act_queue_;
-	queue_mutex_->lock();
-	act_queue_ = 1 - act_queue_;
-	queue_mutex_->unlock();
-	LockQueue<void *> &queue = queues_[write_queue];
-	//logger->log_debug(name(), "Writing %zu entries", queue.size());
-	while (!queue.empty()) {
-		void *c = queue.front();
-		write_chunk(c);
-		free(c);
-		queue.pop();
-	}
+	flush_buffer();
 }
 
 bool
@@ -384,16 +552,27 @@ BBLoggerThread::bb_interface_data_refreshed(Interface *interface) noexcept
 		iface_->read();
 
 		if (buffering_) {
-			void *c = malloc(iface_->datasize());
-			memcpy(c, iface_->datachunk(), iface_->datasize());
-			queue_mutex_->lock();
-			queues_[act_queue_].push_locked(c);
-			queue_mutex_->unlock();
-			wakeup();
+			size_t      entry_size = sizeof(bblog_entry_header) + data_size_;
+			MutexLocker lock(buffer_mutex_);
+			if (block_.size() + entry_size > block_size_) {
+				// block full, the logger thread cannot keep up, write ourselves
+				lock.unlock();
+				flush_buffer();
+				lock.relock();
+			}
+
+			append_entry(block_, iface_->datachunk());
+			if (block_.size() == entry_size) {
+				block_start_ = *now_;
+			}
+
+			bool wake = flushing_ || (block_.size() >= block_size_ / 2)
+			            || ((*now_ - block_start_).in_msec() >= max_delay_msec_);
+			lock.unlock();
+			if (wake)
+				wakeup();
 		} else {
-			queue_mutex_->lock();
 			write_chunk(iface_->datachunk());
-			queue_mutex_->unlock();
 		}
 
 	} catch (Exception &e) {
@@ -414,6 +593,5 @@ BBLoggerThread::bb_interface_writer_removed(Interface *interface, Uuid instance_
 	logger->log_info(name(),
 	                 "Writer removed (wrote %u entries), flushing",
 	                 (num_data_items_ - session_start_));
-	update_header();
-	fflush(f_data_);
+	flush();
 }
@@ -30,10 +30,14 @@
 #include <blackboard/interface_listener.h>
 #include <core/threading/thread.h>
 #include <core/threading/thread_list.h>
-#include <core/utils/lock_queue.h>
+#include <sys/types.h>
 #include <utils/uuid.h>
 
 #include <cstdio>
+#include <memory>
+#include <vector>
+
+class BBLogContainerWriter;
 
 namespace fawkes {
 class BlackBoard;
@@ -56,11 +60,14 @@ public:
 	               bool          buffering,
 	               bool          flushing,
 	               const char *  scenario,
-	               fawkes::Time *start_time);
+	               fawkes::Time *start_time,
+	               size_t        block_size     = 262144,
+	               unsigned int  max_delay_msec = 1000);
 	virtual ~BBLoggerThread();
 
 	const char *get_filename() const;
 	void        set_threadlist(fawkes::ThreadList &thread_list);
+	void        set_container(std::shared_ptr<BBLogContainerWriter> container);
 	void        set_enabled(bool enabled);
 
 	virtual void init();
@@ -84,9 +91,15 @@ protected:
 	}
 
 private:
+	void init_file();
+	void init_container();
 	void write_header();
 	void update_header();
+	void flush();
 	void write_chunk(const void *chunk);
+	void append_entry(std::vector<char> &block, const void *chunk);
+	void write_entries(const std::vector<char> &block);
+	void flush_buffer();
 
 private:
 	fawkes::Interface *iface_;
@@ -106,6 +119,9 @@ private:
 	std::string id_;
 	FILE *      f_data_;
 
+	std::shared_ptr<BBLogContainerWriter> container_;
+	unsigned int                          container_iface_;
+
 	fawkes::Time *start_;
 	fawkes::Time *now_;
 
@@ -113,9 +129,15 @@ private:
 	fawkes::ThreadList       threads_;
 	fawkes::SwitchInterface *switch_if_;
 
-	fawkes::Mutex *           queue_mutex_;
-	unsigned int              act_queue_;
-	fawkes::LockQueue<void *> queues_[2];
+	fawkes::Mutex *   write_mutex_;
+	fawkes::Mutex *   buffer_mutex_;
+	std::vector<char> block_;
+	std::vector<char> write_block_;
+	size_t            block_size_;
+	fawkes::Time      block_start_;
+	long              max_delay_msec_;
+	off_t             file_pos_;
+	off_t             prealloc_end_;
 };
 
 #endif
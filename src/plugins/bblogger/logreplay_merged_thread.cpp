@@ -0,0 +1,260 @@
+
+/***************************************************************************
+ *  logreplay_merged_thread.cpp - BB Log Replay Thread for multiple logs
+ *
+ *  Created: Thu Oct 15 07:12:54 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "logreplay_merged_thread.h"
+
+#include "bblogfile.h"
+
+#include <blackboard/blackboard.h>
+#include <core/threading/wait_condition.h>
+#include <logging/logger.h>
+
+#include <algorithm>
+
+using namespace fawkes;
+
+/** @class BBLogMergedReplayThread "logreplay_merged_thread.h"
+ * BlackBoard log replay thread for multiple logs.
+ * In contrast to the BBLogReplayThread, which replays a single log file,
+ * this thread replays any number of log files of one recording. It keeps
+ * a heap of the next entry of each file and writes the entries to the
+ * blackboard strictly ordered by their time, relative to the earliest
+ * start time of all files.
+ *
+ * The replay speed is a factor relative to the recorded timing, e.g. 2.0
+ * replays twice as fast as recorded. A speed of zero replays as fast as
+ * possible, which is useful for offline evaluation.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param logfile_names file names of the logs to be replayed
+ * @param logdir directory containing the log files
+ * @param speed replay speed factor, 1.0 for real-time, 0 for as fast as possible
+ * @param loop_replay specifies if the replay should be looped
+ * @param thread_name initial thread name
+ */
+BBLogMergedReplayThread::BBLogMergedReplayThread(const std::vector<std::string> &logfile_names,
+                                                 const char *                    logdir,
+                                                 float                           speed,
+                                                 bool                            loop_replay,
+                                                 const char *                    thread_name)
+: Thread(thread_name, Thread::OPMODE_CONTINUOUS),
+  logfile_names_(logfile_names),
+  logdir_(logdir),
+  cfg_speed_(speed),
+  cfg_loop_replay_(loop_replay)
+{
+	set_prepfin_conc_loop(true);
+	simts_ = NULL;
+}
+
+/** Destructor. */
+BBLogMergedReplayThread::~BBLogMergedReplayThread()
+{
+}
+
+void
+BBLogMergedReplayThread::init()
+{
+	readers_.resize(logfile_names_.size());
+
+	Time start((long)0);
+	for (unsigned int i = 0; i < logfile_names_.size(); ++i) {
+		std::string filename = logdir_ + "/" + logfile_names_[i];
+
+		Reader &r   = readers_[i];
+		r.logfile   = NULL;
+		r.interface = NULL;
+		try {
+			r.logfile = new BBLogFile(filename.c_str(), true);
+			r.interface =
+			  blackboard->open_for_writing(r.logfile->interface_type(), r.logfile->interface_id());
+			r.logfile->set_interface(r.interface);
+		} catch (Exception &e) {
+			close_all();
+			throw;
+		}
+
+		if ((i == 0) || (r.logfile->start_time() < start)) {
+			start = r.logfile->start_time();
+		}
+	}
+
+	// logs of one recording share the start time, otherwise align them
+	for (Reader &r : readers_) {
+		r.shift = r.logfile->start_time() - start;
+	}
+
+	start_replay();
+	if (heap_.empty()) {
+		close_all();
+		throw Exception("None of the %zu log files has any entries", readers_.size());
+	}
+
+	logger->log_info(name(),
+	                 "Replaying %zu logs from %s at %s",
+	                 readers_.size(),
+	                 logdir_.c_str(),
+	                 (cfg_speed_ > 0.) ? "given speed" : "maximum speed");
+}
+
+void
+BBLogMergedReplayThread::finalize()
+{
+	close_all();
+}
+
+/** Close all logs and interfaces. */
+void
+BBLogMergedReplayThread::close_all()
+{
+	for (Reader &r : readers_) {
+		delete r.logfile;
+		if (r.interface)
+			blackboard->close(r.interface);
+	}
+	readers_.clear();
+	heap_.clear();
+}
+
+/** Compare readers for heap.
+ * @param a first reader
+ * @param b second reader
+ * @return true if the next entry of @p a is later than the one of @p b
+ */
+bool
+BBLogMergedReplayThread::later(const Reader *a, const Reader *b)
+{
+	return b->next_offset < a->next_offset;
+}
+
+/** Determine the next entry of a reader.
+ * @param reader reader to advance
+ * @return true if the reader has another entry, false otherwise
+ */
+bool
+BBLogMergedReplayThread::advance(Reader *reader)
+{
+	if (reader->next_index >= reader->logfile->num_entries())
+		return false;
+
+	reader->logfile->entry_data(reader->next_index, &reader->next_offset);
+	reader->next_offset += reader->shift;
+	return true;
+}
+
+/** (Re-)start replay from the beginning of all logs. */
+void
+BBLogMergedReplayThread::start_replay()
+{
+	heap_.clear();
+	for (Reader &r : readers_) {
+		r.next_index = 0;
+		if (advance(&r)) {
+			heap_.push_back(&r);
+		}
+	}
+	std::make_heap(heap_.begin(), heap_.end(), later);
+
+	if (!heap_.empty()) {
+		first_offset_ = heap_.front()->next_offset;
+		if (simts_)
+			simts_->set_start(first_offset_.in_sec());
+	}
+	clock->get_systime(replay_start_);
+	num_written_ = 0;
+}
+
+void
+BBLogMergedReplayThread::loop()
+{
+	if (heap_.empty()) {
+		logger->log_info(name(), "Replay finished after %u entries", num_written_);
+		if (cfg_loop_replay_) {
+			logger->log_info(name(), "Looping replay");
+			start_replay();
+		} else {
+			// block
+			WaitCondition waitcond;
+			waitcond.wait();
+		}
+		return;
+	}
+
+	std::pop_heap(heap_.begin(), heap_.end(), later);
+	Reader *r = heap_.back();
+	heap_.pop_back();
+
+	if (cfg_speed_ > 0.) {
+		Time now;
+		clock->get_systime(now);
+		Time due = replay_start_ + (r->next_offset - first_offset_).in_sec() / cfg_speed_;
+		if (now < due) {
+			Time wait_time = due - now;
+			wait_time.wait_systime();
+		}
+	}
+
+	if (simts_)
+		simts_->set_sim_offset(r->next_offset.in_sec());
+
+	r->logfile->read_index(r->next_index);
+	r->interface->write();
+	num_written_ += 1;
+
+	r->next_index += 1;
+	if (advance(r)) {
+		heap_.push_back(r);
+		std::push_heap(heap_.begin(), heap_.end(), later);
+	}
+}
+
+/** @class BBLogMergedReplaySimTimeThread "logreplay_merged_thread.h"
+ * BlackBoard log replay thread for multiple logs providing simulation time.
+ * This replays logs like BBLogMergedReplayThread, but additionally
+ * provides a time source which follows the time of the replayed entries.
+ * Components using the clock hence perceive the recorded timing, also
+ * if replaying faster than real-time.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param logfile_names file names of the logs to be replayed
+ * @param logdir directory containing the log files
+ * @param speed replay speed factor, 1.0 for real-time, 0 for as fast as possible
+ * @param loop_replay specifies if the replay should be looped
+ */
+BBLogMergedReplaySimTimeThread::BBLogMergedReplaySimTimeThread(
+  const std::vector<std::string> &logfile_names,
+  const char *                    logdir,
+  float                           speed,
+  bool                            loop_replay)
+: BBLogMergedReplayThread(logfile_names,
+                          logdir,
+                          speed,
+                          loop_replay,
+                          "BBLogMergedReplaySimTimeThread"),
+  TimeSourceAspect(&simts_source_)
+{
+	simts_ = &simts_source_;
+}
@@ -0,0 +1,119 @@
+
+/***************************************************************************
+ *  logreplay_merged_thread.h - BB Log Replay Thread for multiple logs
+ *
+ *  Created: Thu Oct 15 07:12:54 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBLOGGER_LOGREPLAY_MERGED_THREAD_H_
+#define _PLUGINS_BBLOGGER_LOGREPLAY_MERGED_THREAD_H_
+
+#include <aspect/blackboard.h>
+#include <aspect/clock.h>
+#include <aspect/configurable.h>
+#include <aspect/logging.h>
+#include <aspect/time_source.h>
+#include <core/threading/thread.h>
+#include <utils/time/simts.h>
+#include <utils/time/time.h>
+
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Interface;
+}
+
+class BBLogFile;
+
+class BBLogMergedReplayThread : public fawkes::Thread,
+                                public fawkes::LoggingAspect,
+                                public fawkes::ConfigurableAspect,
+                                public fawkes::ClockAspect,
+                                public fawkes::BlackBoardAspect
+{
+public:
+	BBLogMergedReplayThread(const std::vector<std::string> &logfile_names,
+	                        const char *                    logdir,
+	                        float                           speed,
+	                        bool                            loop_replay,
+	                        const char *                    thread_name = "BBLogMergedReplayThread");
+	virtual ~BBLogMergedReplayThread();
+
+	virtual void init();
+	virtual void finalize();
+	virtual void loop();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+protected:
+	/** Simulation time source to update with the replay time, may be NULL. */
+	fawkes::SimulatorTimeSource *simts_;
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		BBLogFile *        logfile;
+		fawkes::Interface *interface;
+		fawkes::Time       shift;
+		unsigned int       next_index;
+		fawkes::Time       next_offset;
+	} Reader;
+	/// @endcond
+
+	void start_replay();
+	bool advance(Reader *reader);
+	void close_all();
+
+	static bool later(const Reader *a, const Reader *b);
+
+private:
+	std::vector<std::string> logfile_names_;
+	std::string              logdir_;
+	float                    cfg_speed_;
+	bool                     cfg_loop_replay_;
+
+	std::vector<Reader>   readers_;
+	std::vector<Reader *> heap_;
+
+	fawkes::Time first_offset_;
+	fawkes::Time replay_start_;
+	unsigned int num_written_;
+};
+
+class BBLogMergedReplaySimTimeThread : public BBLogMergedReplayThread,
+                                       public fawkes::TimeSourceAspect
+{
+public:
+	BBLogMergedReplaySimTimeThread(const std::vector<std::string> &logfile_names,
+	                               const char *                    logdir,
+	                               float                           speed,
+	                               bool                            loop_replay);
+
+private:
+	fawkes::SimulatorTimeSource simts_source_;
+};
+
+#endif
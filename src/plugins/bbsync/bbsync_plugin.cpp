@@ -22,8 +22,10 @@
 
 #include "bbsync_plugin.h"
 
+#include "multicast_thread.h"
 #include "sync_thread.h"
 
+#include <list>
 #include <set>
 
 using namespace fawkes;
@@ -31,7 +33,9 @@ using namespace fawkes;
 /** @class BlackBoardSynchronizationPlugin "bbsync_plugin.h"
  * BlackBoard synchronization plugin.
  * This plugin synchronizes one or more (or even all) interfaces of two or
- * more Fawkes instances over the network.
+ * more Fawkes instances over the network. Peers with a configured host
+ * are synchronized via TCP. Additionally, selected interfaces can be
+ * distributed via lossy UDP multicast if enabled in the configuration.
  *
  * @author Tim Niemueller
  */
@@ -42,8 +46,9 @@ using namespace fawkes;
 BlackBoardSynchronizationPlugin::BlackBoardSynchronizationPlugin(Configuration *config)
 : Plugin(config)
 {
-	std::set<std::string> peers;
-	std::set<std::string> ignored_peers;
+	std::set<std::string>  peers;
+	std::set<std::string>  ignored_peers;
+	std::list<std::string> multicast_peers;
 
 	std::string prefix       = "/fawkes/bbsync/";
 	std::string peers_prefix = prefix + "peers/";
@@ -63,11 +68,14 @@ BlackBoardSynchronizationPlugin::BlackBoardSynchronizationPlugin(Configuration *
 			} // ignored, assume enabled
 
 			if (active) {
-				//printf("Adding sync thread for peer %s\n", peer.c_str());
-				BlackBoardSynchronizationThread *sync_thread;
-				sync_thread = new BlackBoardSynchronizationThread(prefix, peer_prefix, peer);
 				peers.insert(peer);
-				thread_list.push_back(sync_thread);
+				if (config->exists((peer_prefix + "host").c_str())) {
+					//printf("Adding sync thread for peer %s\n", peer.c_str());
+					BlackBoardSynchronizationThread *sync_thread;
+					sync_thread = new BlackBoardSynchronizationThread(prefix, peer_prefix, peer);
+					thread_list.push_back(sync_thread);
+				}
+				multicast_peers.push_back(peer);
 			} else {
 				//printf("Ignoring sync peer %s\n", peer.c_str());
 				ignored_peers.insert(peer);
@@ -76,6 +84,16 @@ BlackBoardSynchronizationPlugin::BlackBoardSynchronizationPlugin(Configuration *
 	}
 	delete i;
 
+	bool multicast = false;
+	try {
+		multicast = config->get_bool((prefix + "multicast/active").c_str());
+	} catch (Exception &e) {
+	} // ignored, assume disabled
+
+	if (multicast) {
+		thread_list.push_back(new BlackBoardMulticastThread(prefix, multicast_peers));
+	}
+
 	if (thread_list.empty()) {
 		throw Exception("No synchronization peers configured, aborting");
 	}
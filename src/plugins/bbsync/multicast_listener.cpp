@@ -0,0 +1,68 @@
+
+/***************************************************************************
+ *  multicast_listener.cpp - Multicast publishing interface listener
+ *
+ *  Created: Wed Oct 14 19:05:28 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "multicast_listener.h"
+
+#include "multicast_thread.h"
+
+using namespace fawkes;
+
+/** @class MulticastPublishListener "multicast_listener.h"
+ * Listener for data events of published interfaces.
+ * Every time one of the interfaces is written, the multicast thread is
+ * asked to publish the new data. Note that the listener is <i>not</i>
+ * automatically registered, this has to be done from the outside.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param thread multicast thread to publish data with
+ */
+MulticastPublishListener::MulticastPublishListener(BlackBoardMulticastThread *thread)
+: BlackBoardInterfaceListener("MulticastPublishListener")
+{
+	thread_ = thread;
+}
+
+/** Add an interface to publish.
+ * @param interface reading interface to listen to for data events
+ */
+void
+MulticastPublishListener::add_interface(Interface *interface)
+{
+	bbil_add_data_interface(interface);
+}
+
+/** Remove a published interface.
+ * @param interface interface not to listen any longer for data events
+ */
+void
+MulticastPublishListener::remove_interface(Interface *interface)
+{
+	bbil_remove_data_interface(interface);
+}
+
+void
+MulticastPublishListener::bb_interface_data_refreshed(Interface *interface) noexcept
+{
+	thread_->publish(interface);
+}
@@ -0,0 +1,45 @@
+
+/***************************************************************************
+ *  multicast_listener.h - Multicast publishing interface listener
+ *
+ *  Created: Wed Oct 14 19:05:28 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBSYNC_MULTICAST_LISTENER_H_
+#define _PLUGINS_BBSYNC_MULTICAST_LISTENER_H_
+
+#include <blackboard/interface_listener.h>
+
+class BlackBoardMulticastThread;
+
+class MulticastPublishListener : public fawkes::BlackBoardInterfaceListener
+{
+public:
+	MulticastPublishListener(BlackBoardMulticastThread *thread);
+
+	void add_interface(fawkes::Interface *interface);
+	void remove_interface(fawkes::Interface *interface);
+
+	// BlackBoardInterfaceListener
+	virtual void bb_interface_data_refreshed(fawkes::Interface *interface) noexcept;
+
+private:
+	BlackBoardMulticastThread *thread_;
+};
+
+#endif
@@ -0,0 +1,405 @@
+
+/***************************************************************************
+ *  multicast_thread.cpp - BlackBoard multicast synchronization thread
+ *
+ *  Created: Wed Oct 14 19:05:28 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "multicast_thread.h"
+
+#include "multicast_listener.h"
+
+#include <blackboard/blackboard.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <netcomm/socket/datagram_multicast.h>
+#include <netinet/in.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace fawkes;
+
+/** Maximum number of sequence numbers a datagram may lag behind the last
+ * applied one before it is assumed that the publisher has been restarted.
+ */
+#define BBSYNC_MULTICAST_RESTART_WINDOW 1024
+
+/** @class BlackBoardMulticastThread "multicast_thread.h"
+ * Lossy multicast synchronization of BlackBoard interfaces.
+ * High-rate sensor interfaces like laser scans or odometry should not
+ * queue up behind each other in the TCP connection of the synchronization
+ * threads when the network is congested, only the latest value matters.
+ * For interfaces listed in the multicast configuration this thread
+ * publishes the full interface data as a single UDP multicast datagram
+ * each time the local writer writes. Remote instances that list the
+ * interface for a peer apply the datagram to a local writing instance if
+ * its sequence number is newer than the last one applied, late or
+ * duplicated datagrams are dropped. Lost datagrams are not retransmitted.
+ *
+ * Interfaces synchronized this way must not also be synchronized by a
+ * BlackBoardSynchronizationThread, and messages are not forwarded.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param bbsync_cfg_prefix Configuration path for bbsync
+ * @param peers names of peers to read multicast configuration for
+ */
+BlackBoardMulticastThread::BlackBoardMulticastThread(std::string &           bbsync_cfg_prefix,
+                                                     std::list<std::string> &peers)
+: Thread("BlackBoardMulticastThread", Thread::OPMODE_CONTINUOUS)
+{
+	bbsync_cfg_prefix_ = bbsync_cfg_prefix;
+	peers_             = peers;
+
+	socket_      = NULL;
+	send_mutex_  = NULL;
+	send_buffer_ = NULL;
+	recv_buffer_ = NULL;
+	listener_    = NULL;
+}
+
+/** Destructor. */
+BlackBoardMulticastThread::~BlackBoardMulticastThread()
+{
+}
+
+void
+BlackBoardMulticastThread::init()
+{
+	std::string prefix = bbsync_cfg_prefix_ + "multicast/";
+
+	std::string  address = config->get_string((prefix + "address").c_str());
+	unsigned int port    = config->get_uint((prefix + "port").c_str());
+
+	unsigned int ttl = 1;
+	try {
+		ttl = config->get_uint((prefix + "ttl").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+
+	bool loop = false;
+	try {
+		loop = config->get_bool((prefix + "loop").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+
+	try {
+		source_ = config->get_string((prefix + "source").c_str());
+	} catch (Exception &e) {
+		char hostname[BBSYNC_MULTICAST_SOURCE_SIZE];
+		if (gethostname(hostname, sizeof(hostname)) != 0) {
+			throw Exception(errno, "Failed to determine host name for multicast source");
+		}
+		hostname[sizeof(hostname) - 1] = 0;
+		source_                        = hostname;
+	}
+	if (source_.length() >= BBSYNC_MULTICAST_SOURCE_SIZE) {
+		throw Exception("Multicast source name '%s' too long (max %u chars)",
+		                source_.c_str(),
+		                BBSYNC_MULTICAST_SOURCE_SIZE - 1);
+	}
+
+	send_buffer_ = (char *)malloc(BBSYNC_MULTICAST_MAX_DATAGRAM);
+	recv_buffer_ = (char *)malloc(BBSYNC_MULTICAST_MAX_DATAGRAM);
+	send_mutex_  = new Mutex();
+	listener_    = new MulticastPublishListener(this);
+
+	try {
+		socket_ = new MulticastDatagramSocket(Socket::IPv4, address.c_str(), port);
+		socket_->bind();
+		socket_->set_ttl(ttl);
+		socket_->set_loop(loop);
+
+		for (std::list<std::string>::iterator p = peers_.begin(); p != peers_.end(); ++p) {
+			std::string peer_prefix = bbsync_cfg_prefix_ + "peers/" + *p + "/multicast/";
+			std::string source      = *p;
+			try {
+				source = config->get_string((peer_prefix + "source").c_str());
+			} catch (Exception &e) {
+			} // ignored, use peer name
+			open_mirrors(peer_prefix, source);
+		}
+		open_published();
+	} catch (Exception &e) {
+		finalize();
+		throw;
+	}
+
+	logger->log_info(name(),
+	                 "Multicasting %zu and mirroring %zu interfaces via %s:%u as %s",
+	                 published_.size(),
+	                 mirrors_.size(),
+	                 address.c_str(),
+	                 port,
+	                 source_.c_str());
+}
+
+void
+BlackBoardMulticastThread::finalize()
+{
+	close_interfaces();
+
+	delete socket_;
+	delete listener_;
+	delete send_mutex_;
+	free(send_buffer_);
+	free(recv_buffer_);
+	socket_      = NULL;
+	listener_    = NULL;
+	send_mutex_  = NULL;
+	send_buffer_ = NULL;
+	recv_buffer_ = NULL;
+}
+
+void
+BlackBoardMulticastThread::open_published()
+{
+	std::string prefix = bbsync_cfg_prefix_ + "multicast/publish/";
+
+	std::list<std::pair<std::string, std::string>> type_ids;
+	Configuration::ValueIterator *                 i = config->search(prefix.c_str());
+	while (i->next()) {
+		if (strcmp(i->type(), "string") != 0) {
+			TypeMismatchException e("Only values of type string may occur in %s, "
+			                        "but found value of type %s",
+			                        prefix.c_str(),
+			                        i->type());
+			delete i;
+			throw e;
+		}
+
+		std::string uid = i->get_string();
+		size_t      sf;
+		if ((sf = uid.find("::")) == std::string::npos) {
+			Exception e("Interface UID '%s' at %s is not valid, missing double colon",
+			            uid.c_str(),
+			            i->path());
+			delete i;
+			throw e;
+		}
+		type_ids.push_back(std::make_pair(uid.substr(0, sf), uid.substr(sf + 2)));
+	}
+	delete i;
+
+	std::list<Interface *> ifaces = blackboard->open_all_for_reading(type_ids);
+	for (Interface *iface : ifaces) {
+		if (sizeof(bbsync_multicast_header_t) + iface->datasize() > BBSYNC_MULTICAST_MAX_DATAGRAM) {
+			logger->log_warn(name(),
+			                 "Interface %s too large for a datagram (%u bytes), not publishing",
+			                 iface->uid(),
+			                 iface->datasize());
+			blackboard->close(iface);
+			continue;
+		}
+
+		publish_info_t info = {iface, 0};
+		published_[iface]   = info;
+		listener_->add_interface(iface);
+	}
+
+	if (!published_.empty()) {
+		blackboard->register_listener(listener_, BlackBoard::BBIL_FLAG_DATA);
+	}
+}
+
+void
+BlackBoardMulticastThread::open_mirrors(std::string &peer_prefix, std::string &source)
+{
+	std::string prefix = peer_prefix + "reading/";
+
+	Configuration::ValueIterator *i = config->search(prefix.c_str());
+	while (i->next()) {
+		if (strcmp(i->type(), "string") != 0) {
+			TypeMismatchException e("Only values of type string may occur in %s, "
+			                        "but found value of type %s",
+			                        prefix.c_str(),
+			                        i->type());
+			delete i;
+			throw e;
+		}
+
+		std::string uid = i->get_string();
+		size_t      sf;
+		if ((sf = uid.find("::")) == std::string::npos) {
+			Exception e("Interface UID '%s' at %s is not valid, missing double colon",
+			            uid.c_str(),
+			            i->path());
+			delete i;
+			throw e;
+		}
+		std::string type      = uid.substr(0, sf);
+		std::string reader_id = uid.substr(sf + 2);
+		std::string writer_id = reader_id;
+		if ((sf = reader_id.find("=")) != std::string::npos) {
+			// we got a mapping
+			writer_id = reader_id.substr(sf + 1);
+			reader_id = reader_id.substr(0, sf);
+		}
+
+		logger->log_debug(name(),
+		                  "Mirroring %s::%s of %s as %s",
+		                  type.c_str(),
+		                  reader_id.c_str(),
+		                  source.c_str(),
+		                  writer_id.c_str());
+		Interface *iface = blackboard->open_for_writing(type.c_str(), writer_id.c_str());
+
+		mirror_info_t info = {iface, false, 0};
+		mirrors_[source + '\0' + type + "::" + reader_id] = info;
+	}
+	delete i;
+}
+
+void
+BlackBoardMulticastThread::close_interfaces()
+{
+	if (listener_ && !published_.empty()) {
+		blackboard->unregister_listener(listener_);
+	}
+
+	// listener is unregistered, no more concurrent publish() calls
+	std::map<Interface *, publish_info_t>::iterator p;
+	for (p = published_.begin(); p != published_.end(); ++p) {
+		blackboard->close(p->first);
+	}
+	published_.clear();
+
+	std::map<std::string, mirror_info_t>::iterator m;
+	for (m = mirrors_.begin(); m != mirrors_.end(); ++m) {
+		blackboard->close(m->second.interface);
+	}
+	mirrors_.clear();
+}
+
+/** Publish current data of an interface.
+ * Called by the listener whenever the local writer has written.
+ * @param interface published reading interface
+ */
+void
+BlackBoardMulticastThread::publish(Interface *interface) noexcept
+{
+	MutexLocker lock(send_mutex_);
+
+	std::map<Interface *, publish_info_t>::iterator p = published_.find(interface);
+	if (p == published_.end())
+		return;
+
+	interface->read();
+
+	bbsync_multicast_header_t *h = (bbsync_multicast_header_t *)send_buffer_;
+	memset(h, 0, sizeof(bbsync_multicast_header_t));
+	h->magic   = htons(BBSYNC_MULTICAST_MAGIC);
+	h->version = BBSYNC_MULTICAST_VERSION;
+	h->seq     = htonl(++p->second.seq);
+	strncpy(h->source, source_.c_str(), BBSYNC_MULTICAST_SOURCE_SIZE - 1);
+	strncpy(h->type, interface->type(), INTERFACE_TYPE_SIZE_);
+	strncpy(h->id, interface->id(), INTERFACE_ID_SIZE_);
+	memcpy(h->hash, interface->hash(), INTERFACE_HASH_SIZE_);
+	h->data_size = htonl(interface->datasize());
+	memcpy(send_buffer_ + sizeof(bbsync_multicast_header_t),
+	       interface->datachunk(),
+	       interface->datasize());
+
+	try {
+		socket_->send(send_buffer_, sizeof(bbsync_multicast_header_t) + interface->datasize());
+	} catch (Exception &e) {
+		// lossy by design, the next write will be sent again
+		logger->log_debug(name(), "Failed to send %s: %s", interface->uid(), e.what_no_backtrace());
+	}
+}
+
+void
+BlackBoardMulticastThread::loop()
+{
+	if (mirrors_.empty()) {
+		// nothing to receive, publishing happens in the listener
+		usleep(500000);
+		return;
+	}
+
+	try {
+		if (!(socket_->poll(100, Socket::POLL_IN) & Socket::POLL_IN))
+			return;
+
+		// drain all pending datagrams
+		do {
+			size_t len = socket_->recv(recv_buffer_, BBSYNC_MULTICAST_MAX_DATAGRAM);
+			receive(len);
+		} while (socket_->available());
+	} catch (Exception &e) {
+		logger->log_warn(name(), "Failed to receive datagram: %s", e.what_no_backtrace());
+		usleep(100000);
+	}
+}
+
+void
+BlackBoardMulticastThread::receive(size_t len)
+{
+	if (len < sizeof(bbsync_multicast_header_t))
+		return;
+
+	bbsync_multicast_header_t *h = (bbsync_multicast_header_t *)recv_buffer_;
+	if ((ntohs(h->magic) != BBSYNC_MULTICAST_MAGIC) || (h->version != BBSYNC_MULTICAST_VERSION)) {
+		return;
+	}
+
+	char source[BBSYNC_MULTICAST_SOURCE_SIZE + 1];
+	char type[INTERFACE_TYPE_SIZE_ + 1];
+	char id[INTERFACE_ID_SIZE_ + 1];
+	strncpy(source, h->source, BBSYNC_MULTICAST_SOURCE_SIZE);
+	strncpy(type, h->type, INTERFACE_TYPE_SIZE_);
+	strncpy(id, h->id, INTERFACE_ID_SIZE_);
+	source[BBSYNC_MULTICAST_SOURCE_SIZE] = 0;
+	type[INTERFACE_TYPE_SIZE_]           = 0;
+	id[INTERFACE_ID_SIZE_]               = 0;
+
+	std::map<std::string, mirror_info_t>::iterator m =
+	  mirrors_.find(std::string(source) + '\0' + type + "::" + id);
+	if (m == mirrors_.end())
+		return;
+
+	Interface *  iface     = m->second.interface;
+	unsigned int data_size = ntohl(h->data_size);
+	if ((memcmp(h->hash, iface->hash(), INTERFACE_HASH_SIZE_) != 0)
+	    || (data_size != iface->datasize())
+	    || (len != sizeof(bbsync_multicast_header_t) + data_size)) {
+		logger->log_debug(name(), "Dropping incompatible datagram for %s", iface->uid());
+		return;
+	}
+
+	// latest wins, but accept a large jump back as a restarted publisher
+	uint32_t seq = ntohl(h->seq);
+	if (m->second.have_seq) {
+		int32_t diff = (int32_t)(seq - m->second.seq);
+		if ((diff <= 0) && (diff > -BBSYNC_MULTICAST_RESTART_WINDOW))
+			return;
+	}
+	m->second.have_seq = true;
+	m->second.seq      = seq;
+
+	void *data = recv_buffer_ + sizeof(bbsync_multicast_header_t);
+	bool  changed = (memcmp(iface->datachunk(), data, data_size) != 0);
+	iface->set_from_chunk(data);
+	if (changed)
+		iface->mark_data_changed();
+	iface->write();
+}
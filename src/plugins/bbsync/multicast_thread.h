@@ -0,0 +1,136 @@
+
+/***************************************************************************
+ *  multicast_thread.h - BlackBoard multicast synchronization thread
+ *
+ *  Created: Wed Oct 14 19:05:28 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_BBSYNC_MULTICAST_THREAD_H_
+#define _PLUGINS_BBSYNC_MULTICAST_THREAD_H_
+
+#include <aspect/blackboard.h>
+#include <aspect/configurable.h>
+#include <aspect/logging.h>
+#include <core/threading/thread.h>
+#include <interface/interface.h>
+
+#include <list>
+#include <map>
+#include <stdint.h>
+#include <string>
+
+namespace fawkes {
+class Mutex;
+class MulticastDatagramSocket;
+} // namespace fawkes
+
+class MulticastPublishListener;
+
+/** Magic value identifying bbsync multicast datagrams. */
+#define BBSYNC_MULTICAST_MAGIC 0xBB5C
+/** Version of the bbsync multicast datagram format. */
+#define BBSYNC_MULTICAST_VERSION 1
+/** Maximum length of the source name in multicast datagrams. */
+#define BBSYNC_MULTICAST_SOURCE_SIZE 32
+/** Maximum UDP payload size of a single datagram. */
+#define BBSYNC_MULTICAST_MAX_DATAGRAM 65507
+
+#pragma pack(push, 4)
+/** Header of a bbsync multicast datagram.
+ * The header is followed by data_size bytes of interface data.
+ * Numeric fields are in network byte order.
+ */
+typedef struct
+{
+	uint16_t      magic;                                /**< BBSYNC_MULTICAST_MAGIC */
+	uint8_t       version;                              /**< BBSYNC_MULTICAST_VERSION */
+	uint8_t       reserved;                             /**< reserved for future use, zero */
+	uint32_t      seq;                                  /**< per-interface sequence number */
+	char          source[BBSYNC_MULTICAST_SOURCE_SIZE]; /**< name of publishing instance */
+	char          type[INTERFACE_TYPE_SIZE_];           /**< interface type */
+	char          id[INTERFACE_ID_SIZE_];               /**< interface ID */
+	unsigned char hash[INTERFACE_HASH_SIZE_];           /**< interface hash */
+	uint32_t      data_size;                            /**< size of data following the header */
+} bbsync_multicast_header_t;
+#pragma pack(pop)
+
+class BlackBoardMulticastThread : public fawkes::Thread,
+                                  public fawkes::LoggingAspect,
+                                  public fawkes::ConfigurableAspect,
+                                  public fawkes::BlackBoardAspect
+{
+public:
+	BlackBoardMulticastThread(std::string &bbsync_cfg_prefix, std::list<std::string> &peers);
+	virtual ~BlackBoardMulticastThread();
+
+	virtual void init();
+	virtual void loop();
+	virtual void finalize();
+
+	void publish(fawkes::Interface *interface) noexcept;
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	/** Published interface. */
+	typedef struct
+	{
+		fawkes::Interface *interface; /**< reading interface */
+		uint32_t           seq;       /**< last sent sequence number */
+	} publish_info_t;
+
+	/** Mirrored interface. */
+	typedef struct
+	{
+		fawkes::Interface *interface; /**< local writing interface */
+		bool               have_seq;  /**< true if a datagram has been received */
+		uint32_t           seq;       /**< last applied sequence number */
+	} mirror_info_t;
+
+	void open_published();
+	void open_mirrors(std::string &peer_prefix, std::string &source);
+	void close_interfaces();
+	void receive(size_t len);
+
+private:
+	std::string            bbsync_cfg_prefix_;
+	std::list<std::string> peers_;
+
+	std::string source_;
+
+	fawkes::MulticastDatagramSocket *socket_;
+	fawkes::Mutex *                  send_mutex_;
+
+	char *send_buffer_;
+	char *recv_buffer_;
+
+	MulticastPublishListener *listener_;
+
+	// Maps reading interface -> publish info
+	std::map<fawkes::Interface *, publish_info_t> published_;
+	// Maps source + NUL + type::id of remote interface -> mirror info
+	std::map<std::string, mirror_info_t> mirrors_;
+};
+
+#endif
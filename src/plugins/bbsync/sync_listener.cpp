@@ -23,6 +23,8 @@
 #include "sync_listener.h"
 
 #include <blackboard/blackboard.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <logging/logger.h>
 
 using namespace fawkes;
@@ -32,6 +34,15 @@ using namespace fawkes;
  * This class synchronizes two interfaces, a reading and a writing instance
  * of the same type. To accomplish this it listens for data changed and message
  * events and forwards them as appropriate to "the other side".
+ *
+ * In coalescing mode forwarding is throttled to the sync period, i.e. to
+ * the interval in which flush() is called. The first data change and the
+ * first message within a period are forwarded immediately, hence isolated
+ * events see only the network latency. Further data changes within the
+ * same period are merged and only the latest data is copied on flush().
+ * Further messages are queued and forwarded together on flush(), in the
+ * order in which they were received. Since such messages are enqueued
+ * only later, the ID of the original message is not updated for them.
  * @author Tim Niemueller
  */
 
@@ -45,12 +56,15 @@ using namespace fawkes;
  * created on
  * @param writer_bb the BlackBoard instance the writing instance has been
  * created on
+ * @param coalesce true to throttle forwarding to the interval in which
+ * flush() is called, false to forward every event immediately
  */
 SyncInterfaceListener::SyncInterfaceListener(fawkes::Logger *    logger,
                                              fawkes::Interface * reader,
                                              fawkes::Interface * writer,
                                              fawkes::BlackBoard *reader_bb,
-                                             fawkes::BlackBoard *writer_bb)
+                                             fawkes::BlackBoard *writer_bb,
+                                             bool                coalesce)
 : BlackBoardInterfaceListener("SyncInterfaceListener(%s-%s)", writer->uid(), reader->id())
 {
 	logger_    = logger;
@@ -59,6 +73,12 @@ SyncInterfaceListener::SyncInterfaceListener(fawkes::Logger *    logger,
 	reader_bb_ = reader_bb;
 	writer_bb_ = writer_bb;
 
+	coalesce_           = coalesce;
+	mutex_              = new Mutex();
+	data_forwarded_     = false;
+	data_pending_       = false;
+	messages_forwarded_ = false;
+
 	bbil_add_data_interface(reader_);
 	bbil_add_message_interface(writer_);
 	bb_interface_data_refreshed(reader_);
@@ -72,6 +92,56 @@ SyncInterfaceListener::~SyncInterfaceListener()
 {
 	reader_bb_->unregister_listener(this);
 	writer_bb_->unregister_listener(this);
+
+	std::list<Message *>::iterator m;
+	for (m = messages_pending_.begin(); m != messages_pending_.end(); ++m) {
+		(*m)->unref();
+	}
+	delete mutex_;
+}
+
+/** Forward coalesced data and queued messages.
+ * To be called once per sync period by the synchronization thread. Does
+ * nothing if the listener does not coalesce or nothing is pending.
+ */
+void
+SyncInterfaceListener::flush()
+{
+	if (!coalesce_)
+		return;
+
+	MutexLocker lock(mutex_);
+	try {
+		data_forwarded_ = data_pending_;
+		if (data_pending_) {
+			data_pending_ = false;
+			copy_data();
+		}
+
+		messages_forwarded_ = !messages_pending_.empty();
+		while (!messages_pending_.empty()) {
+			Message *m = messages_pending_.front();
+			messages_pending_.pop_front();
+			try {
+				// takes over our reference
+				reader_->msgq_enqueue(m, true);
+			} catch (Exception &e) {
+				m->unref();
+				throw;
+			}
+		}
+	} catch (Exception &e) {
+		logger_->log_error(bbil_name(), "Exception when flushing");
+		logger_->log_error(bbil_name(), e);
+	}
+}
+
+void
+SyncInterfaceListener::copy_data()
+{
+	reader_->read();
+	writer_->copy_values(reader_);
+	writer_->write();
 }
 
 bool
@@ -87,6 +157,15 @@ SyncInterfaceListener::bb_interface_message_received(Interface *interface,
 			                   message->source_id().get_string().c_str());
 			Message *m = message->clone();
 			m->set_hops(message->hops());
+			if (coalesce_) {
+				MutexLocker lock(mutex_);
+				if (messages_forwarded_) {
+					// forwarded with the next flush
+					messages_pending_.push_back(m);
+					return false;
+				}
+				messages_forwarded_ = true;
+			}
 			m->ref();
 			reader_->msgq_enqueue(m, true);
 			message->set_id(m->id());
@@ -116,9 +195,18 @@ SyncInterfaceListener::bb_interface_data_refreshed(Interface *interface) noexcep
 	try {
 		if (interface == reader_) {
 			//logger_->log_debug(bbil_name(), "Copying data");
-			reader_->read();
-			writer_->copy_values(reader_);
-			writer_->write();
+			if (coalesce_) {
+				MutexLocker lock(mutex_);
+				if (data_forwarded_) {
+					// copied with the next flush
+					data_pending_ = true;
+				} else {
+					data_forwarded_ = true;
+					copy_data();
+				}
+			} else {
+				copy_data();
+			}
 		} else {
 			// Don't know why we were called, let 'em enqueue
 			logger_->log_error(bbil_name(), "Data changed for unknown interface");
@@ -25,9 +25,12 @@
 
 #include <blackboard/interface_listener.h>
 
+#include <list>
+
 namespace fawkes {
 class BlackBoard;
 class Logger;
+class Mutex;
 } // namespace fawkes
 
 class SyncInterfaceListener : public fawkes::BlackBoardInterfaceListener
@@ -37,13 +40,19 @@ public:
 	                      fawkes::Interface * reader,
 	                      fawkes::Interface * writer,
 	                      fawkes::BlackBoard *reader_bb,
-	                      fawkes::BlackBoard *writer_bb);
+	                      fawkes::BlackBoard *writer_bb,
+	                      bool                coalesce = false);
 	virtual ~SyncInterfaceListener();
 
+	void flush();
+
 	virtual bool bb_interface_message_received(fawkes::Interface *interface,
 	                                           fawkes::Message *  message) noexcept;
 	virtual void bb_interface_data_refreshed(fawkes::Interface *interface) noexcept;
 
+private:
+	void copy_data();
+
 private:
 	fawkes::Logger *logger_;
 
@@ -52,6 +61,13 @@ private:
 
 	fawkes::BlackBoard *writer_bb_;
 	fawkes::BlackBoard *reader_bb_;
+
+	bool                         coalesce_;
+	fawkes::Mutex *              mutex_;
+	bool                         data_forwarded_;
+	bool                         data_pending_;
+	bool                         messages_forwarded_;
+	std::list<fawkes::Message *> messages_pending_;
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include <core/threading/mutex_locker.h>
 #include <utils/time/wait.h>
 
+#include <algorithm>
 #include <cstring>
 
 using namespace std;
@@ -84,6 +85,16 @@ BlackBoardSynchronizationThread::init()
 		logger->log_debug(name(), "No per-peer check interval set, using default");
 	}
 
+	sync_interval_ = 0;
+	try {
+		sync_interval_ = config->get_uint((bbsync_cfg_prefix_ + "sync_interval").c_str());
+	} catch (Exception &e) {
+	} // ignored, forward immediately
+	try {
+		sync_interval_ = config->get_uint((peer_cfg_prefix_ + "sync_interval").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+
 	read_config_combos(peer_cfg_prefix_ + "reading/", /* writing */ false);
 	read_config_combos(peer_cfg_prefix_ + "writing/", /* writing */ true);
 
@@ -105,7 +116,15 @@ BlackBoardSynchronizationThread::init()
 	}
 
 	logger->log_debug(name(), "Checking for remote aliveness every %u ms", check_interval);
-	timewait_ = new TimeWait(clock, check_interval * 1000);
+	loop_count_ = 0;
+	if (sync_interval_ > 0) {
+		logger->log_debug(name(), "Coalescing data and messages every %u ms", sync_interval_);
+		check_loops_ = std::max(1u, check_interval / sync_interval_);
+		timewait_    = new TimeWait(clock, sync_interval_ * 1000);
+	} else {
+		check_loops_ = 1;
+		timewait_    = new TimeWait(clock, check_interval * 1000);
+	}
 }
 
 void
@@ -125,10 +144,28 @@ void
 BlackBoardSynchronizationThread::loop()
 {
 	timewait_->mark_start();
-	check_connection();
+	if (++loop_count_ >= check_loops_) {
+		loop_count_ = 0;
+		check_connection();
+	}
+	flush_listeners();
 	timewait_->wait_systime();
 }
 
+void
+BlackBoardSynchronizationThread::flush_listeners()
+{
+	if (sync_interval_ == 0)
+		return;
+
+	MutexLocker               lock(interfaces_.mutex());
+	SyncListenerMap::iterator s;
+	for (s = sync_listeners_.begin(); s != sync_listeners_.end(); ++s) {
+		if (s->second)
+			s->second->flush();
+	}
+}
+
 bool
 BlackBoardSynchronizationThread::check_connection()
 {
@@ -253,7 +290,8 @@ BlackBoardSynchronizationThread::open_interfaces()
 		if (iface_writer) {
 			logger->log_debug(name(), "Creating sync listener");
 			sync_listener =
-			  new SyncInterfaceListener(logger, iface_reader, iface_writer, reader_bb, writer_bb);
+			  new SyncInterfaceListener(
+			    logger, iface_reader, iface_writer, reader_bb, writer_bb, sync_interval_ > 0);
 		}
 		sync_listeners_[iface_reader] = sync_listener;
 
@@ -335,7 +373,8 @@ BlackBoardSynchronizationThread::writer_added(fawkes::Interface *interface) noex
 			                  ii.combo->writer_id.c_str());
 
 			sync_listener =
-			  new SyncInterfaceListener(logger, interface, iface, ii.reader_bb, ii.writer_bb);
+			  new SyncInterfaceListener(
+			    logger, interface, iface, ii.reader_bb, ii.writer_bb, sync_interval_ > 0);
 
 			sync_listeners_[interface] = sync_listener;
 			ii.writer                  = iface;
@@ -137,6 +137,7 @@ private:
 	typedef fawkes::LockMap<fawkes::Interface *, SyncInterfaceListener *> SyncListenerMap;
 
 	bool check_connection();
+	void flush_listeners();
 	void read_config_combos(std::string prefix, bool writing);
 	void open_interfaces();
 	void close_interfaces();
@@ -150,6 +151,9 @@ private:
 	unsigned int port_;
 
 	fawkes::TimeWait *timewait_;
+	unsigned int      sync_interval_;
+	unsigned int      check_loops_;
+	unsigned int      loop_count_;
 
 	fawkes::BlackBoard *remote_bb_;
 
@@ -57,6 +57,17 @@ ClipsExecutiveThread::init()
 	} catch (Exception &e) {
 	} // ignore, use default
 
+	cfg_run_max_rules_ = 0;
+	try {
+		cfg_run_max_rules_ = config->get_uint("/clips-executive/run-budget/max-rules");
+	} catch (Exception &e) {
+	} // ignore, use default
+	cfg_run_max_time_ = 0;
+	try {
+		cfg_run_max_time_ = config->get_uint("/clips-executive/run-budget/max-time-ms");
+	} catch (Exception &e) {
+	} // ignore, use default
+
 	std::vector<std::string> clips_dirs;
 	try {
 		clips_dirs = config->get_strings("/clips-executive/clips-dirs");
@@ -159,7 +170,18 @@ ClipsExecutiveThread::finalize()
 {
 	clips->assert_fact("(executive-finalize)");
 	clips->refresh_agenda();
-	clips->run();
+	if (cfg_run_max_rules_ > 0 || cfg_run_max_time_ > 0) {
+		long int fired = clips_run_bounded(cfg_run_max_rules_, cfg_run_max_time_);
+		long int left  = clips_agenda_size();
+		if (left > 0) {
+			logger->log_debug(name(),
+			                  "Run budget exhausted after %li rules, %li activations left",
+			                  fired,
+			                  left);
+		}
+	} else {
+		clips->run();
+	}
 }
 
 void
@@ -174,7 +196,18 @@ ClipsExecutiveThread::loop()
 	}
 
 	clips->refresh_agenda();
-	clips->run();
+	if (cfg_run_max_rules_ > 0 || cfg_run_max_time_ > 0) {
+		long int fired = clips_run_bounded(cfg_run_max_rules_, cfg_run_max_time_);
+		long int left  = clips_agenda_size();
+		if (left > 0) {
+			logger->log_debug(name(),
+			                  "Run budget exhausted after %li rules, %li activations left",
+			                  fired,
+			                  left);
+		}
+	} else {
+		clips->run();
+	}
 }
 
 std::string
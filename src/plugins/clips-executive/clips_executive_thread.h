@@ -66,7 +66,9 @@ private:
 	clips_map_skill(std::string name, CLIPS::Values param_names, CLIPS::Values param_values);
 
 private:
-	bool cfg_assert_time_each_loop_;
+	bool         cfg_assert_time_each_loop_;
+	long int     cfg_run_max_rules_;
+	unsigned int cfg_run_max_time_;
 
 	std::shared_ptr<fawkes::ActionSkillMapping> action_skill_mapping_;
 };
@@ -21,6 +21,7 @@
 
 #include "clips_navgraph_thread.h"
 
+#include <core/threading/mutex_locker.h>
 #include <navgraph/constraints/constraint_repo.h>
 #include <navgraph/constraints/static_list_edge_constraint.h>
 #include <navgraph/navgraph.h>
@@ -63,6 +64,7 @@ ClipsNavGraphThread::finalize()
 	delete edge_constraint_;
 
 	navgraph->remove_change_listener(this);
+	MutexLocker lock(&envs_mutex_);
 	envs_.clear();
 }
 
@@ -70,7 +72,9 @@ void
 ClipsNavGraphThread::clips_context_init(const std::string &          env_name,
                                         LockPtr<CLIPS::Environment> &clips)
 {
+	envs_mutex_.lock();
 	envs_[env_name] = clips;
+	envs_mutex_.unlock();
 	logger->log_info(name(), "Called to initialize environment %s", env_name.c_str());
 
 	clips.lock();
@@ -87,13 +91,25 @@ ClipsNavGraphThread::clips_context_init(const std::string &          env_name,
 	                      sigc::mem_fun(*this, &ClipsNavGraphThread::clips_navgraph_unblock_edge),
 	                      env_name)));
 
+	clips->add_function("navgraph-path-costs",
+	                    sigc::slot<CLIPS::Values, std::string, CLIPS::Values>(sigc::bind<0>(
+	                      sigc::mem_fun(*this, &ClipsNavGraphThread::clips_navgraph_path_costs),
+	                      env_name)));
+
+	clips->add_function("navgraph-search-paths",
+	                    sigc::slot<CLIPS::Value, std::string, CLIPS::Values>(sigc::bind<0>(
+	                      sigc::mem_fun(*this, &ClipsNavGraphThread::clips_navgraph_search_paths),
+	                      env_name)));
+
 	clips.unlock();
 }
 
 void
 ClipsNavGraphThread::clips_context_destroyed(const std::string &env_name)
 {
+	envs_mutex_.lock();
 	envs_.erase(env_name);
+	envs_mutex_.unlock();
 	logger->log_info(name(), "Removing environment %s", env_name.c_str());
 }
 
@@ -184,10 +200,106 @@ ClipsNavGraphThread::clips_navgraph_unblock_edge(std::string env_name,
 	                 to.c_str());
 }
 
+bool
+ClipsNavGraphThread::clips_navgraph_goal_names(const std::string &       env_name,
+                                               const CLIPS::Values &     to,
+                                               std::vector<std::string> &goals)
+{
+	goals.clear();
+	for (const CLIPS::Value &v : to) {
+		if (v.type() != CLIPS::TYPE_STRING && v.type() != CLIPS::TYPE_SYMBOL) {
+			logger->log_warn(name(),
+			                 "Environment %s passed a goal which is not a node name",
+			                 env_name.c_str());
+			return false;
+		}
+		goals.push_back(v.as_string());
+	}
+	return true;
+}
+
+CLIPS::Values
+ClipsNavGraphThread::clips_navgraph_path_costs(std::string   env_name,
+                                               std::string   from,
+                                               CLIPS::Values to)
+{
+	std::vector<std::string> goals;
+	if (!clips_navgraph_goal_names(env_name, to, goals)) {
+		return CLIPS::Values(1, CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL));
+	}
+
+	try {
+		MutexLocker        lock(navgraph.objmutex_ptr());
+		std::vector<float> costs = navgraph->path_costs(from, goals);
+
+		CLIPS::Values rv;
+		for (float c : costs) {
+			rv.push_back(CLIPS::Value(c));
+		}
+		return rv;
+	} catch (Exception &e) {
+		logger->log_warn(name(),
+		                 "Environment %s failed to get path costs from %s: %s",
+		                 env_name.c_str(),
+		                 from.c_str(),
+		                 e.what_no_backtrace());
+		return CLIPS::Values(1, CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL));
+	}
+}
+
+CLIPS::Value
+ClipsNavGraphThread::clips_navgraph_search_paths(std::string   env_name,
+                                                 std::string   from,
+                                                 CLIPS::Values to)
+{
+	std::vector<std::string> goals;
+	if (!clips_navgraph_goal_names(env_name, to, goals)) {
+		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	}
+
+	std::vector<NavGraphPath> paths;
+	try {
+		MutexLocker lock(navgraph.objmutex_ptr());
+		paths = navgraph->search_paths(from, goals);
+	} catch (Exception &e) {
+		logger->log_warn(name(),
+		                 "Environment %s failed to search paths from %s: %s",
+		                 env_name.c_str(),
+		                 from.c_str(),
+		                 e.what_no_backtrace());
+		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	}
+
+	// called from within the environment, which is therefore locked already
+	fawkes::LockPtr<CLIPS::Environment> clips;
+	envs_mutex_.lock();
+	clips = envs_[env_name];
+	envs_mutex_.unlock();
+	for (size_t i = 0; i < paths.size(); ++i) {
+		std::string nodes_string;
+		for (const NavGraphNode &n : paths[i].nodes()) {
+			nodes_string += " \"" + n.name() + "\"";
+		}
+		clips->assert_fact_f("(navgraph-path (from \"%s\") (to \"%s\") (cost %f) (nodes%s))",
+		                     from.c_str(),
+		                     goals[i].c_str(),
+		                     paths[i].cost(),
+		                     nodes_string.c_str());
+	}
+
+	return CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
+}
+
 void
 ClipsNavGraphThread::graph_changed() noexcept
 {
-	for (auto e : envs_) {
+	// environments run in their own threads and may call into this
+	// thread while locked, hence do not keep envs_ locked meanwhile
+	envs_mutex_.lock();
+	std::map<std::string, fawkes::LockPtr<CLIPS::Environment>> envs = envs_;
+	envs_mutex_.unlock();
+
+	for (auto e : envs) {
 		logger->log_debug(name(), "Graph changed, re-asserting in environment %s", e.first.c_str());
 		fawkes::LockPtr<CLIPS::Environment> &clips = e.second;
 		clips.lock();
@@ -25,11 +25,13 @@
 
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
+#include <core/threading/mutex.h>
 #include <core/threading/thread.h>
 #include <navgraph/aspect/navgraph.h>
 #include <navgraph/navgraph.h>
 #include <plugins/clips/aspect/clips_feature.h>
 
+#include <clipsmm.h>
 #include <map>
 #include <string>
 #include <vector>
@@ -70,12 +72,20 @@ protected:
 	}
 
 private:
-	void clips_navgraph_load(fawkes::LockPtr<CLIPS::Environment> &clips);
-	void clips_navgraph_block_edge(std::string env_name, std::string from, std::string to);
-	void clips_navgraph_unblock_edge(std::string env_name, std::string from, std::string to);
+	void          clips_navgraph_load(fawkes::LockPtr<CLIPS::Environment> &clips);
+	void          clips_navgraph_block_edge(std::string env_name, std::string from, std::string to);
+	void          clips_navgraph_unblock_edge(std::string env_name, std::string from, std::string to);
+	CLIPS::Values clips_navgraph_path_costs(std::string env_name, std::string from, CLIPS::Values to);
+	CLIPS::Value  clips_navgraph_search_paths(std::string   env_name,
+	                                          std::string   from,
+	                                          CLIPS::Values to);
+	bool          clips_navgraph_goal_names(const std::string &       env_name,
+	                                        const CLIPS::Values &     to,
+	                                        std::vector<std::string> &goals);
 
 private:
 	std::map<std::string, fawkes::LockPtr<CLIPS::Environment>> envs_;
+	fawkes::Mutex                                              envs_mutex_;
 
 	fawkes::NavGraphStaticListEdgeConstraint *edge_constraint_;
 };
@@ -28,12 +28,24 @@
 #include <pddl_parser/pddl_exception.h>
 #include <pddl_parser/pddl_parser.h>
 
+#include <clips/clips.h>
 #include <clipsmm.h>
+#include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <functional>
+#include <sstream>
 
 using namespace std;
 using namespace pddl_parser;
 
+/// @cond INTERNALS
+/** Maximum number of translated domains to keep. */
+static const size_t MAX_CACHED_DOMAINS = 16;
+/** Maximum number of translated operators to keep. */
+static const size_t MAX_CACHED_OPERATORS = 1024;
+/// @endcond
+
 /** @class PDDLCLIPSFeature "clips_pddl_parser_feature.h"
  * Provide a PDDL parser to a CLIPS environment.
  * @author Till Hofmann
@@ -62,7 +74,9 @@ void
 PDDLCLIPSFeature::clips_context_init(const string &                       env_name,
                                      fawkes::LockPtr<CLIPS::Environment> &clips)
 {
+	envs_mutex_.lock();
 	envs_[env_name] = clips;
+	envs_mutex_.unlock();
 	//clips->evaluate("(path-load \"pddl.clp\")");
 	clips->add_function("parse-pddl-domain",
 	                    sigc::slot<void, string>(
@@ -80,38 +94,83 @@ PDDLCLIPSFeature::clips_context_init(const string &                       env_na
 void
 PDDLCLIPSFeature::clips_context_destroyed(const string &env_name)
 {
+	fawkes::MutexLocker lock(&envs_mutex_);
 	envs_.erase(env_name);
 }
 
 /** CLIPS function to parse a PDDL domain.
  * This parses the given domain and asserts domain facts for all parts of the
  * domain.
+ *
+ * The translated facts are cached by the hash of the domain file contents
+ * and shared among all environments, so that loading the same domain again
+ * asserts all facts in one bulk load without parsing. If the domain has
+ * changed, the facts of operators whose definition is unchanged are taken
+ * from the cache and only the changed operators are translated again.
  * @param env_name The name of the calling environment
  * @param domain_file The path of the domain file to parse.
  */
 void
 PDDLCLIPSFeature::parse_domain(std::string env_name, std::string domain_file)
 {
-	fawkes::MutexLocker lock(envs_[env_name].objmutex_ptr());
-	CLIPS::Environment &env = **(envs_[env_name]);
-	Domain              domain;
-	try {
-		ifstream     df(domain_file);
-		stringstream buffer;
-		buffer << df.rdbuf();
-		domain = PddlParser::parseDomain(buffer.str());
-	} catch (PddlParserException &e) {
-		logger_->log_error(("PDDLCLIPS|" + env_name).c_str(), "Failed to parse domain: %s", e.what());
-		return;
+	envs_mutex_.lock();
+	fawkes::LockPtr<CLIPS::Environment> clips = envs_[env_name];
+	envs_mutex_.unlock();
+
+	ifstream     df(domain_file);
+	stringstream buffer;
+	buffer << df.rdbuf();
+	const string domain_text = buffer.str();
+	const size_t domain_hash = std::hash<string>()(domain_text);
+
+	string facts;
+	{
+		fawkes::MutexLocker cache_lock(&cache_mutex_);
+		auto                c = domain_cache_.find(domain_hash);
+		if (c != domain_cache_.end()) {
+			facts = c->second;
+		}
 	}
+	if (facts.empty()) {
+		try {
+			facts = translate_domain(domain_text);
+		} catch (PddlParserException &e) {
+			logger_->log_error(("PDDLCLIPS|" + env_name).c_str(), "Failed to parse domain: %s", e.what());
+			return;
+		}
+		fawkes::MutexLocker cache_lock(&cache_mutex_);
+		if (domain_cache_.size() >= MAX_CACHED_DOMAINS) {
+			domain_cache_.clear();
+		}
+		domain_cache_[domain_hash] = facts;
+	}
+
+	fawkes::MutexLocker lock(clips.objmutex_ptr());
+	if (!EnvLoadFactsFromString(clips->cobj(), (char *)facts.c_str(), -1)) {
+		logger_->log_error(("PDDLCLIPS|" + env_name).c_str(),
+		                   "Failed to assert facts of domain %s",
+		                   domain_file.c_str());
+	}
+}
+
+/** Translate a domain to CLIPS facts.
+ * @param domain_text PDDL domain
+ * @return facts for the domain, separated by newlines, in the format
+ * expected by load-facts
+ * @exception PddlParserException thrown if the domain cannot be parsed
+ */
+string
+PDDLCLIPSFeature::translate_domain(const string &domain_text)
+{
+	Domain domain = PddlParser::parseDomain(domain_text);
+	string facts;
+
 	for (auto &type : domain.types) {
 		string super_type = "";
 		if (!type.second.empty()) {
 			super_type = "(super-type " + type.second + ")";
 		}
-		env.assert_fact("(domain-object-type "
-		                "(name "
-		                + type.first + ")" + super_type + ")");
+		facts += "(domain-object-type (name " + type.first + ")" + super_type + ")\n";
 	}
 	for (auto &predicate : domain.predicates) {
 		string param_string = "";
@@ -120,51 +179,120 @@ PDDLCLIPSFeature::parse_domain(std::string env_name, std::string domain_file)
 			param_string += " " + param.first;
 			type_string += " " + param.second;
 		}
-		env.assert_fact("(domain-predicate"
-		                " (name "
-		                + predicate.first
-		                + ")"
-		                  " (param-names "
-		                + param_string
-		                + ")"
-		                  " (param-types "
-		                + type_string
-		                + ")"
-		                  ")");
+		facts += "(domain-predicate (name " + predicate.first + ") (param-names " + param_string
+		         + ") (param-types " + type_string + "))\n";
 	}
 
+	map<string, size_t> sources = operator_sources(domain_text);
 	for (auto &action : domain.actions) {
-		string params_string = "(param-names";
-		for (auto &param_pair : action.action_params) {
-			string param_name = param_pair.first;
-			string param_type = param_pair.second;
-			params_string += " " + param_name;
-			env.assert_fact("(domain-operator-parameter"
-			                " (name "
-			                + param_name
-			                + ")"
-			                  " (operator "
-			                + action.name
-			                + ")"
-			                  " (type "
-			                + param_type
-			                + ")"
-			                  ")");
+		string name = action.name;
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+		auto   s = sources.find(name);
+		string key;
+		if (s != sources.end()) {
+			key = action.name + '\0' + std::to_string(s->second);
+			fawkes::MutexLocker cache_lock(&cache_mutex_);
+			auto                c = operator_cache_.find(key);
+			if (c != operator_cache_.end()) {
+				facts += c->second;
+				continue;
+			}
 		}
-		params_string += ")";
-		env.assert_fact("(domain-operator (name " + action.name + ")" + params_string + ")");
-		vector<string> precondition_facts =
-		  boost::apply_visitor(PreconditionToCLIPSFactVisitor(action.name, 1, true),
-		                       action.precondition.expression);
-		for (auto &fact : precondition_facts) {
-			env.assert_fact(fact);
+		string operator_facts = translate_operator(action);
+		facts += operator_facts;
+		if (!key.empty()) {
+			fawkes::MutexLocker cache_lock(&cache_mutex_);
+			if (operator_cache_.size() >= MAX_CACHED_OPERATORS) {
+				operator_cache_.clear();
+			}
+			operator_cache_[key] = operator_facts;
 		}
-		vector<string> effect_facts =
-		  boost::apply_visitor(EffectToCLIPSFactVisitor(action.name, true), action.effect.expression);
-		for (auto &fact : effect_facts) {
-			env.assert_fact(fact);
+	}
+	return facts;
+}
+
+/** Translate an operator to CLIPS facts.
+ * @param action operator to translate
+ * @return facts for the operator including its parameters, precondition
+ * and effects, separated by newlines
+ */
+string
+PDDLCLIPSFeature::translate_operator(Action &action)
+{
+	string facts;
+	string params_string = "(param-names";
+	for (auto &param_pair : action.action_params) {
+		string param_name = param_pair.first;
+		string param_type = param_pair.second;
+		params_string += " " + param_name;
+		facts += "(domain-operator-parameter (name " + param_name + ") (operator " + action.name
+		         + ") (type " + param_type + "))\n";
+	}
+	params_string += ")";
+	facts += "(domain-operator (name " + action.name + ")" + params_string + ")\n";
+	vector<string> precondition_facts =
+	  boost::apply_visitor(PreconditionToCLIPSFactVisitor(action.name, 1, true),
+	                       action.precondition.expression);
+	for (auto &fact : precondition_facts) {
+		facts += fact + "\n";
+	}
+	vector<string> effect_facts =
+	  boost::apply_visitor(EffectToCLIPSFactVisitor(action.name, true), action.effect.expression);
+	for (auto &fact : effect_facts) {
+		facts += fact + "\n";
+	}
+	return facts;
+}
+
+/** Determine source of operators.
+ * Finds all action definitions in the domain text and hashes their text,
+ * ignoring comments and whitespace. This is independent of the parser and
+ * allows to detect which operators changed between two versions of a
+ * domain.
+ * @param domain_text PDDL domain
+ * @return map from operator name to the hash of its definition
+ */
+map<string, size_t>
+PDDLCLIPSFeature::operator_sources(const string &domain_text)
+{
+	map<string, size_t> rv;
+	string::size_type   pos = 0;
+	while ((pos = domain_text.find(":action", pos)) != string::npos) {
+		string            normalized;
+		int               depth = 1;
+		string::size_type i     = pos + 1;
+		for (; i < domain_text.size() && depth > 0; ++i) {
+			char c = domain_text[i];
+			if (c == ';') {
+				i = domain_text.find('\n', i);
+				if (i == string::npos)
+					break;
+				c = ' ';
+			} else if (c == '(') {
+				depth += 1;
+			} else if (c == ')') {
+				depth -= 1;
+			}
+			if (isspace(c)) {
+				if (!normalized.empty() && normalized.back() != ' ')
+					normalized += ' ';
+			} else {
+				normalized += tolower(c);
+			}
+		}
+		if (i == string::npos || depth > 0) {
+			break;
 		}
+		// normalized starts with "action <name> ..."
+		string::size_type name_start = normalized.find(' ');
+		string::size_type name_end   = normalized.find_first_of(" ()", name_start + 1);
+		if (name_start != string::npos && name_end != string::npos) {
+			rv[normalized.substr(name_start + 1, name_end - name_start - 1)] =
+			  std::hash<string>()(normalized);
+		}
+		pos = i;
 	}
+	return rv;
 }
 
 /** CLIPS function to parse a PDDL formula.
@@ -179,8 +307,12 @@ PDDLCLIPSFeature::parse_formula(std::string env_name,
                                 std::string pddl_formula,
                                 std::string output_id)
 {
-	fawkes::MutexLocker lock(envs_[env_name].objmutex_ptr());
-	CLIPS::Environment &env = **(envs_[env_name]);
+	envs_mutex_.lock();
+	fawkes::LockPtr<CLIPS::Environment> clips = envs_[env_name];
+	envs_mutex_.unlock();
+
+	fawkes::MutexLocker lock(clips.objmutex_ptr());
+	CLIPS::Environment &env = **clips;
 	Expression          formula;
 	try {
 		formula = PddlParser::parseFormula(pddl_formula);
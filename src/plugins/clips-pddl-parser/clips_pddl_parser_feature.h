@@ -21,8 +21,11 @@
 #ifndef _PLUGINS_CLIPS_PDDL_PARSER_FEATURE_PDDL_H_
 #define _PLUGINS_CLIPS_PDDL_PARSER_FEATURE_PDDL_H_
 
+#include <core/threading/mutex.h>
+#include <pddl_parser/pddl_parser.h>
 #include <plugins/clips/aspect/clips_feature.h>
 
+#include <cstddef>
 #include <map>
 #include <string>
 
@@ -48,9 +51,18 @@ private:
 	void parse_domain(std::string env_name, std::string domain_file);
 	void parse_formula(std::string env_name, std::string pddl_formula, std::string output_id);
 
+	std::string                   translate_domain(const std::string &domain_text);
+	std::string                   translate_operator(pddl_parser::Action &action);
+	std::map<std::string, size_t> operator_sources(const std::string &domain_text);
+
 private:
 	fawkes::Logger *                                           logger_;
 	std::map<std::string, fawkes::LockPtr<CLIPS::Environment>> envs_;
+	fawkes::Mutex                                              envs_mutex_;
+
+	fawkes::Mutex                      cache_mutex_;
+	std::map<size_t, std::string>      domain_cache_;
+	std::map<std::string, std::string> operator_cache_;
 };
 
 #endif /* !PLUGINS_CLIPS_PDDL_PARSER_FEATURE_PDDL_H__ */
@@ -28,10 +28,26 @@
 #include <bsoncxx/document/element.hpp>
 #include <bsoncxx/exception/exception.hpp>
 #include <bsoncxx/types.hpp>
+#include <memory>
 #include <mongocxx/exception/exception.hpp>
+#include <mongocxx/model/write.hpp>
+#include <vector>
 
 using namespace fawkes;
 
+/// @cond INTERNAL
+// result of robmem-query, either from the database or from the cache
+struct QueryResult
+{
+	std::unique_ptr<mongocxx::cursor>     cursor;
+	std::vector<bsoncxx::document::value> documents;
+	size_t                                next = 0;
+};
+
+// writes collected by robmem-bulk-* for a single robmem-bulk-execute
+typedef std::vector<mongocxx::model::write> BulkWrites;
+/// @endcond
+
 /** @class ClipsRobotMemoryThread 'clips_robot_memory_thread.h' 
  * CLIPS feature to access the robot memory.
  * MongoDB access through CLIPS first appeared in the RCLL referee box.
@@ -120,6 +136,27 @@ ClipsRobotMemoryThread::clips_context_init(const std::string &          env_name
 	clips->add_function("robmem-replace",
 	                    sigc::slot<void, std::string, void *, CLIPS::Value>(
 	                      sigc::mem_fun(*this, &ClipsRobotMemoryThread::clips_robotmemory_replace)));
+	clips->add_function("robmem-bulk-create",
+	                    sigc::slot<CLIPS::Value>(
+	                      sigc::mem_fun(*this, &ClipsRobotMemoryThread::clips_robotmemory_bulk_create)));
+	clips->add_function("robmem-bulk-destroy",
+	                    sigc::slot<void, void *>(
+	                      sigc::mem_fun(*this, &ClipsRobotMemoryThread::clips_robotmemory_bulk_destroy)));
+	clips->add_function("robmem-bulk-insert",
+	                    sigc::slot<void, void *, void *>(
+	                      sigc::mem_fun(*this, &ClipsRobotMemoryThread::clips_robotmemory_bulk_insert)));
+	clips->add_function("robmem-bulk-upsert",
+	                    sigc::slot<void, void *, void *, CLIPS::Value>(
+	                      sigc::mem_fun(*this, &ClipsRobotMemoryThread::clips_robotmemory_bulk_upsert)));
+	clips->add_function("robmem-bulk-update",
+	                    sigc::slot<void, void *, void *, CLIPS::Value>(
+	                      sigc::mem_fun(*this, &ClipsRobotMemoryThread::clips_robotmemory_bulk_update)));
+	clips->add_function("robmem-bulk-remove",
+	                    sigc::slot<void, void *, void *>(
+	                      sigc::mem_fun(*this, &ClipsRobotMemoryThread::clips_robotmemory_bulk_remove)));
+	clips->add_function("robmem-bulk-execute",
+	                    sigc::slot<CLIPS::Value, std::string, void *, CLIPS::Value>(sigc::mem_fun(
+	                      *this, &ClipsRobotMemoryThread::clips_robotmemory_bulk_execute)));
 	clips->add_function("robmem-query",
 	                    sigc::slot<CLIPS::Value, std::string, void *>(
 	                      sigc::mem_fun(*this, &ClipsRobotMemoryThread::clips_robotmemory_query)));
@@ -548,6 +585,114 @@ ClipsRobotMemoryThread::clips_robotmemory_replace(std::string  collection,
 	robotmemory_update(collection, b->view(), query, false);
 }
 
+CLIPS::Value
+ClipsRobotMemoryThread::clips_robotmemory_bulk_create()
+{
+	return CLIPS::Value(new BulkWrites());
+}
+
+void
+ClipsRobotMemoryThread::clips_robotmemory_bulk_destroy(void *bulk)
+{
+	auto w = static_cast<BulkWrites *>(bulk);
+	if (!w) {
+		logger->log_error("MongoDB", "robmem-bulk-destroy: got invalid bulk write");
+		return;
+	}
+	delete w;
+}
+
+void
+ClipsRobotMemoryThread::clips_robotmemory_bulk_insert(void *bulk, void *bson)
+{
+	auto w = static_cast<BulkWrites *>(bulk);
+	auto b = static_cast<bsoncxx::builder::basic::document *>(bson);
+	if (!w || !b) {
+		logger->log_warn("MongoDB", "Invalid bulk write or BSON Builder passed");
+		return;
+	}
+	w->push_back(mongocxx::model::insert_one(bsoncxx::document::value(b->view())));
+}
+
+void
+ClipsRobotMemoryThread::clips_robotmemory_bulk_upsert(void *bulk, void *bson, CLIPS::Value query)
+{
+	robotmemory_bulk_update(bulk, bson, query, true);
+}
+
+void
+ClipsRobotMemoryThread::clips_robotmemory_bulk_update(void *bulk, void *bson, CLIPS::Value query)
+{
+	robotmemory_bulk_update(bulk, bson, query, false);
+}
+
+void
+ClipsRobotMemoryThread::robotmemory_bulk_update(void *        bulk,
+                                                void *        bson,
+                                                CLIPS::Value &query,
+                                                bool          upsert)
+{
+	using namespace bsoncxx::builder;
+	auto w = static_cast<BulkWrites *>(bulk);
+	auto b = static_cast<bsoncxx::builder::basic::document *>(bson);
+	if (!w || !b) {
+		logger->log_warn("MongoDB", "Invalid bulk write or BSON Builder passed");
+		return;
+	}
+	try {
+		// same semantics as robmem-update, i.e., set the fields of the document
+		bsoncxx::document::value update =
+		  basic::make_document(basic::kvp("$set", concatenate(b->view())));
+		if (query.type() == CLIPS::TYPE_STRING) {
+			mongocxx::model::update_many op(bsoncxx::from_json(query.as_string()), std::move(update));
+			w->push_back(std::move(op.upsert(upsert)));
+		} else if (query.type() == CLIPS::TYPE_EXTERNAL_ADDRESS) {
+			basic::document *            qb = static_cast<basic::document *>(query.as_address());
+			mongocxx::model::update_many op(bsoncxx::document::value(qb->view()), std::move(update));
+			w->push_back(std::move(op.upsert(upsert)));
+		} else {
+			logger->log_warn("MongoDB", "Invalid query, must be string or BSON document");
+		}
+	} catch (bsoncxx::exception &e) {
+		logger->log_warn("MongoDB", "Compiling query failed: %s", e.what());
+	}
+}
+
+void
+ClipsRobotMemoryThread::clips_robotmemory_bulk_remove(void *bulk, void *bson)
+{
+	auto w = static_cast<BulkWrites *>(bulk);
+	auto b = static_cast<bsoncxx::builder::basic::document *>(bson);
+	if (!w || !b) {
+		logger->log_warn("MongoDB", "Invalid bulk write or BSON Builder passed");
+		return;
+	}
+	w->push_back(mongocxx::model::delete_many(bsoncxx::document::value(b->view())));
+}
+
+CLIPS::Value
+ClipsRobotMemoryThread::clips_robotmemory_bulk_execute(std::string  collection,
+                                                       void *       bulk,
+                                                       CLIPS::Value ordered)
+{
+	auto w = static_cast<BulkWrites *>(bulk);
+	if (!w) {
+		logger->log_error("MongoDB", "robmem-bulk-execute: got invalid bulk write");
+		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+	}
+	bool ok = false;
+	try {
+		ok = robot_memory->bulk_write(*w,
+		                              collection,
+		                              !(ordered.type() == CLIPS::TYPE_SYMBOL
+		                                && ordered.as_string() == "FALSE"));
+	} catch (mongocxx::exception &e) {
+		logger->log_warn("MongoDB", "Bulk write failed: %s", e.what());
+	}
+	w->clear();
+	return CLIPS::Value(ok ? "TRUE" : "FALSE", CLIPS::TYPE_SYMBOL);
+}
+
 CLIPS::Value
 ClipsRobotMemoryThread::clips_robotmemory_query_sort(std::string collection,
                                                      void *      bson,
@@ -556,17 +701,23 @@ ClipsRobotMemoryThread::clips_robotmemory_query_sort(std::string collection,
 	auto b = static_cast<bsoncxx::builder::basic::document *>(bson);
 
 	try {
+		std::vector<bsoncxx::document::value> documents;
+		if (!bson_sort && robot_memory->query_cached(b->view(), collection, documents)) {
+			QueryResult *result = new QueryResult();
+			result->documents.swap(documents);
+			return CLIPS::Value(result, CLIPS::TYPE_EXTERNAL_ADDRESS);
+		}
+
 		mongocxx::options::find find_opts{};
 		if (bson_sort) {
 			auto *bs = static_cast<bsoncxx::builder::basic::document *>(bson_sort);
 			find_opts.sort(bs->view());
 		}
 
-		auto cursor = robot_memory->query(b->view(), collection, find_opts);
-		//std::unique_ptr<mongocxx::cursor> c = new mongocxx::cursor(std::move(cursor));
-		return CLIPS::Value(new std::unique_ptr<mongocxx::cursor>(
-		                      new mongocxx::cursor(std::move(cursor))),
-		                    CLIPS::TYPE_EXTERNAL_ADDRESS);
+		auto         cursor = robot_memory->query(b->view(), collection, find_opts);
+		QueryResult *result = new QueryResult();
+		result->cursor      = std::make_unique<mongocxx::cursor>(std::move(cursor));
+		return CLIPS::Value(result, CLIPS::TYPE_EXTERNAL_ADDRESS);
 	} catch (std::system_error &e) {
 		logger->log_warn("MongoDB", "Query failed: %s", e.what());
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
@@ -636,8 +787,8 @@ ClipsRobotMemoryThread::clips_robotmemory_query(const std::string &collection, v
 void
 ClipsRobotMemoryThread::clips_robotmemory_cursor_destroy(void *cursor)
 {
-	auto c = static_cast<std::unique_ptr<mongocxx::cursor> *>(cursor);
-	if (!c || !c->get()) {
+	auto c = static_cast<QueryResult *>(cursor);
+	if (!c) {
 		logger->log_error("MongoDB", "mongodb-cursor-destroy: got invalid cursor");
 		return;
 	}
@@ -655,16 +806,25 @@ ClipsRobotMemoryThread::clips_robotmemory_cursor_more(void *cursor)
 CLIPS::Value
 ClipsRobotMemoryThread::clips_robotmemory_cursor_next(void *cursor)
 {
-	auto c = static_cast<std::unique_ptr<mongocxx::cursor> *>(cursor);
+	auto c = static_cast<QueryResult *>(cursor);
 
-	if (!c || !c->get()) {
+	if (!c) {
 		logger->log_error("MongoDB", "mongodb-cursor-next: got invalid cursor");
 		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
 	}
 
+	if (!c->cursor) {
+		if (c->next >= c->documents.size()) {
+			return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+		}
+		auto b = new bsoncxx::builder::basic::document();
+		b->append(bsoncxx::builder::concatenate(c->documents[c->next++].view()));
+		return CLIPS::Value(b);
+	}
+
 	try {
-		auto it = (*c)->begin();
-		if (it == (*c)->end()) {
+		auto it = c->cursor->begin();
+		if (it == c->cursor->end()) {
 			return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
 		} else {
 			auto b = new bsoncxx::builder::basic::document();
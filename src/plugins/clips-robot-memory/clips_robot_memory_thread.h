@@ -98,6 +98,15 @@ private:
 	                                const bsoncxx::document::view &obj,
 	                                CLIPS::Value &                 query,
 	                                bool                           upsert);
+	CLIPS::Value clips_robotmemory_bulk_create();
+	void         clips_robotmemory_bulk_destroy(void *bulk);
+	void         clips_robotmemory_bulk_insert(void *bulk, void *bson);
+	void         clips_robotmemory_bulk_upsert(void *bulk, void *bson, CLIPS::Value query);
+	void         clips_robotmemory_bulk_update(void *bulk, void *bson, CLIPS::Value query);
+	void         clips_robotmemory_bulk_remove(void *bulk, void *bson);
+	void robotmemory_bulk_update(void *bulk, void *bson, CLIPS::Value &query, bool upsert);
+	CLIPS::Value
+	clips_robotmemory_bulk_execute(std::string collection, void *bulk, CLIPS::Value ordered);
 	CLIPS::Value clips_robotmemory_query_sort(std::string collection, void *bson, void *bson_sort);
 	CLIPS::Value clips_robotmemory_query(const std::string &collection, void *bson);
 	void         clips_robotmemory_remove(std::string collection, void *bson);
@@ -25,6 +25,9 @@
 
 #include <clipsmm.h>
 
+#include <chrono>
+#include <clips/clips.h>
+
 namespace fawkes {
 
 /** @class CLIPSAspect <plugins/clips/aspect/clips.h>
@@ -64,6 +67,54 @@ CLIPSAspect::~CLIPSAspect()
 {
 }
 
+/** Run CLIPS with bounded time and number of rule firings.
+ * Fires rules on the agenda until it is empty, @p max_rules rules have
+ * been fired, or @p max_msec milliseconds have passed, whichever comes
+ * first. Activations left on the agenda are kept and fired on the next
+ * call. Rules are fired one at a time while a time bound is set, hence
+ * a single long-running rule can still exceed the bound.
+ * The environment must be locked by the caller.
+ * @param max_rules maximum number of rules to fire, zero or less
+ * for no limit
+ * @param max_msec maximum time in milliseconds to run, zero for no limit
+ * @return number of rules fired
+ */
+long int
+CLIPSAspect::clips_run_bounded(long int max_rules, unsigned int max_msec)
+{
+	if (max_msec == 0) {
+		return clips->run(max_rules > 0 ? max_rules : -1);
+	}
+
+	auto deadline =
+	  std::chrono::steady_clock::now() + std::chrono::milliseconds(max_msec);
+	long int fired = 0;
+	while (max_rules <= 0 || fired < max_rules) {
+		if (clips->run(1) == 0)
+			break;
+		++fired;
+		if (std::chrono::steady_clock::now() >= deadline)
+			break;
+	}
+	return fired;
+}
+
+/** Get number of activations on the agenda.
+ * The environment must be locked by the caller.
+ * @return number of activations waiting to be fired
+ */
+long int
+CLIPSAspect::clips_agenda_size()
+{
+	void *   env  = clips->cobj();
+	long int size = 0;
+	for (void *act = EnvGetNextActivation(env, NULL); act != NULL;
+	     act       = EnvGetNextActivation(env, act)) {
+		++size;
+	}
+	return size;
+}
+
 /** Init CLIPS aspect.
  * This set the CLIPS environment.
  * It is guaranteed that this is called for a CLIPS Thread before start
@@ -45,6 +45,10 @@ public:
 	CLIPSAspect(const char *env_name, const char *log_component_name = 0);
 	virtual ~CLIPSAspect();
 
+protected:
+	long int clips_run_bounded(long int max_rules, unsigned int max_msec);
+	long int clips_agenda_size();
+
 protected:
 	const std::string           clips_env_name;
 	LockPtr<CLIPS::Environment> clips;
@@ -21,6 +21,8 @@
  */
 
 #include <baseapp/run.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <logging/logger.h>
 #include <plugins/clips/aspect/clips_env_manager.h>
 #include <plugins/clips/aspect/clips_feature.h>
@@ -162,6 +164,12 @@ log_router_exit(void *env, int exit_code)
  * The CLIPS environment manager creates and maintains CLIPS
  * environments, registers features and provides them to the CLIPS
  * environments, and allows access to any and all CLIPS environments.
+ *
+ * Environments are run by the threads which own them, possibly in
+ * parallel. The manager may therefore be called from several threads
+ * at once and guards its book keeping by an internal mutex. This mutex
+ * is never held while locking an environment, as the thread running
+ * it may call back into the manager, e.g., to request a feature.
  * @author Tim Niemueller
  */
 
@@ -175,11 +183,13 @@ CLIPSEnvManager::CLIPSEnvManager(Logger *logger, Clock *clock, std::string &clip
 	logger_    = logger;
 	clock_     = clock;
 	clips_dir_ = clips_dir;
+	mutex_     = new Mutex();
 }
 
 /** Destructor. */
 CLIPSEnvManager::~CLIPSEnvManager()
 {
+	delete mutex_;
 }
 
 /** Create a new environment.
@@ -238,31 +248,37 @@ LockPtr<CLIPS::Environment>
 CLIPSEnvManager::create_env(const std::string &env_name, const std::string &log_component_name)
 {
 	LockPtr<CLIPS::Environment> clips;
-	if (envs_.find(env_name) != envs_.end()) {
-		throw Exception("CLIPS environment '%s' already exists", env_name.c_str());
-	}
+	{
+		MutexLocker lock(mutex_);
+		if (envs_.find(env_name) != envs_.end()) {
+			throw Exception("CLIPS environment '%s' already exists", env_name.c_str());
+		}
 
-	clips = new_env(log_component_name);
+		clips = new_env(log_component_name);
+		if (!clips) {
+			throw Exception("Failed to initialize CLIPS environment '%s'", env_name.c_str());
+		}
 
-	if (clips) {
 		envs_[env_name].env = clips;
 
 		// add generic functions
 		add_functions(env_name, clips);
 
 		// assert all currently available features to environment
-		assert_features(clips, true);
+		std::list<std::string> features;
+		for (auto feat : features_) {
+			features.push_back(feat.first);
+		}
+		assert_features(clips, features, true);
+	}
 
-		guarded_load(env_name, clips_dir_ + "utils.clp");
-		guarded_load(env_name, clips_dir_ + "time.clp");
-		guarded_load(env_name, clips_dir_ + "path.clp");
+	guarded_load(env_name, clips, clips_dir_ + "utils.clp");
+	guarded_load(env_name, clips, clips_dir_ + "time.clp");
+	guarded_load(env_name, clips, clips_dir_ + "path.clp");
 
-		clips->evaluate("(path-add \"" + clips_dir_ + "\")");
+	clips->evaluate("(path-add \"" + clips_dir_ + "\")");
 
-		return clips;
-	} else {
-		throw Exception("Failed to initialize CLIPS environment '%s'", env_name.c_str());
-	}
+	return clips;
 }
 
 /** Destroy the named environment.
@@ -272,21 +288,35 @@ CLIPSEnvManager::create_env(const std::string &env_name, const std::string &log_
 void
 CLIPSEnvManager::destroy_env(const std::string &env_name)
 {
-	if (envs_.find(env_name) != envs_.end()) {
-		void *                  env = envs_[env_name].env->cobj();
-		CLIPSContextMaintainer *cm  = static_cast<CLIPSContextMaintainer *>(GetEnvironmentContext(env));
+	ClipsEnvData envd;
+	{
+		MutexLocker lock(mutex_);
+		auto        e = envs_.find(env_name);
+		if (e == envs_.end()) {
+			return;
+		}
+		envd = e->second;
+		envs_.erase(e);
+	}
+
+	void *                  env = envd.env->cobj();
+	CLIPSContextMaintainer *cm  = static_cast<CLIPSContextMaintainer *>(GetEnvironmentContext(env));
 
-		EnvDeleteRouter(env, (char *)ROUTER_NAME);
-		SetEnvironmentContext(env, NULL);
-		delete cm;
+	EnvDeleteRouter(env, (char *)ROUTER_NAME);
+	SetEnvironmentContext(env, NULL);
+	delete cm;
 
-		for (auto feat : envs_[env_name].req_feat) {
+	for (auto feat : envd.req_feat) {
+		CLIPSFeature *feature = NULL;
+		{
+			MutexLocker lock(mutex_);
 			if (features_.find(feat) != features_.end()) {
-				features_[feat]->clips_context_destroyed(env_name);
+				feature = features_[feat];
 			}
 		}
-
-		envs_.erase(env_name);
+		if (feature) {
+			feature->clips_context_destroyed(env_name);
+		}
 	}
 }
 
@@ -296,6 +326,7 @@ CLIPSEnvManager::destroy_env(const std::string &env_name)
 std::map<std::string, LockPtr<CLIPS::Environment>>
 CLIPSEnvManager::environments() const
 {
+	MutexLocker                                        lock(mutex_);
 	std::map<std::string, LockPtr<CLIPS::Environment>> rv;
 	for (auto envd : envs_) {
 		rv[envd.first] = envd.second.env;
@@ -313,52 +344,60 @@ CLIPSEnvManager::clips_request_feature(std::string env_name, std::string feature
 	                   env_name.c_str(),
 	                   feature_name.c_str());
 
-	if (envs_.find(env_name) == envs_.end()) {
-		logger_->log_warn("ClipsEnvManager",
-		                  "Feature %s request from non-existent environment %s",
-		                  feature_name.c_str(),
-		                  env_name.c_str());
-		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
-	}
-	if (features_.find(feature_name) == features_.end()) {
-		logger_->log_warn("ClipsEnvManager",
-		                  "Environment requested unavailable feature %s",
-		                  feature_name.c_str());
-		return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
-	}
+	LockPtr<CLIPS::Environment> clips;
+	CLIPSFeature *              feature;
+	std::string                 deffacts = "(deffacts ff-features-loaded";
+	{
+		MutexLocker lock(mutex_);
+		if (envs_.find(env_name) == envs_.end()) {
+			logger_->log_warn("ClipsEnvManager",
+			                  "Feature %s request from non-existent environment %s",
+			                  feature_name.c_str(),
+			                  env_name.c_str());
+			return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+		}
+		if (features_.find(feature_name) == features_.end()) {
+			logger_->log_warn("ClipsEnvManager",
+			                  "Environment requested unavailable feature %s",
+			                  feature_name.c_str());
+			return CLIPS::Value("FALSE", CLIPS::TYPE_SYMBOL);
+		}
 
-	ClipsEnvData &envd = envs_[env_name];
-	if (std::binary_search(envd.req_feat.begin(), envd.req_feat.end(), feature_name)) {
-		logger_->log_warn("ClipsEnvManager",
-		                  "Environment %s requested feature %s *again*",
-		                  env_name.c_str(),
-		                  feature_name.c_str());
-		return CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
-	}
+		ClipsEnvData &envd = envs_[env_name];
+		if (std::binary_search(envd.req_feat.begin(), envd.req_feat.end(), feature_name)) {
+			logger_->log_warn("ClipsEnvManager",
+			                  "Environment %s requested feature %s *again*",
+			                  env_name.c_str(),
+			                  feature_name.c_str());
+			return CLIPS::Value("TRUE", CLIPS::TYPE_SYMBOL);
+		}
 
-	envd.env.lock();
-	features_[feature_name]->clips_context_init(env_name, envd.env);
-	envd.req_feat.push_back(feature_name);
-	envd.req_feat.sort();
+		envd.req_feat.push_back(feature_name);
+		envd.req_feat.sort();
 
-	// deffact so it survives a reset
-	std::string deffacts = "(deffacts ff-features-loaded";
+		// deffact so it survives a reset
+		for (auto feat : envd.req_feat) {
+			deffacts += " (ff-feature-loaded " + feat + ")";
+		}
+		deffacts += ")";
 
-	for (auto feat : envd.req_feat) {
-		deffacts += " (ff-feature-loaded " + feat + ")";
+		clips   = envd.env;
+		feature = features_[feature_name];
 	}
-	deffacts += ")";
 
-	envd.env->assert_fact_f("(ff-feature-loaded %s)", feature_name.c_str());
+	clips.lock();
+	feature->clips_context_init(env_name, clips);
+
+	clips->assert_fact_f("(ff-feature-loaded %s)", feature_name.c_str());
 
-	if (!envd.env->build(deffacts)) {
+	if (!clips->build(deffacts)) {
 		logger_->log_warn("ClipsEnvManager",
 		                  "Failed to build deffacts ff-features-loaded "
 		                  "for %s",
 		                  env_name.c_str());
 		rv = false;
 	}
-	envd.env.unlock();
+	clips.unlock();
 
 	return CLIPS::Value(rv ? "TRUE" : "FALSE", CLIPS::TYPE_SYMBOL);
 }
@@ -401,16 +440,18 @@ CLIPSEnvManager::add_functions(const std::string &env_name, LockPtr<CLIPS::Envir
 }
 
 void
-CLIPSEnvManager::assert_features(LockPtr<CLIPS::Environment> &clips, bool immediate_assert)
+CLIPSEnvManager::assert_features(LockPtr<CLIPS::Environment> &  clips,
+                                 const std::list<std::string> &features,
+                                 bool                          immediate_assert)
 {
 	// deffact so it survives a reset
 	std::string deffacts = "(deffacts ff-features-available";
 
-	for (auto feat : features_) {
-		deffacts += " (ff-feature " + feat.first + ")";
+	for (auto feat : features) {
+		deffacts += " (ff-feature " + feat + ")";
 		if (immediate_assert) {
 			// assert so it is immediately available
-			clips->assert_fact_f("(ff-feature %s)", feat.first.c_str());
+			clips->assert_fact_f("(ff-feature %s)", feat.c_str());
 		}
 	}
 	deffacts += ")";
@@ -429,21 +470,32 @@ CLIPSEnvManager::add_features(const std::list<CLIPSFeature *> &features)
 	for (auto feat : features) {
 		const std::string &feature_name = feat->clips_feature_name;
 
-		if (features_.find(feature_name) != features_.end()) {
-			throw Exception("Feature '%s' has already been registered", feature_name.c_str());
-		}
+		std::list<LockPtr<CLIPS::Environment>> envs;
+		std::list<std::string>                 feature_names;
+		{
+			MutexLocker lock(mutex_);
+			if (features_.find(feature_name) != features_.end()) {
+				throw Exception("Feature '%s' has already been registered", feature_name.c_str());
+			}
 
-		logger_->log_info("ClipsEnvManager", "Adding feature %s", feature_name.c_str());
+			logger_->log_info("ClipsEnvManager", "Adding feature %s", feature_name.c_str());
 
-		features_[feature_name] = feat;
+			features_[feature_name] = feat;
+			for (auto env : envs_) {
+				envs.push_back(env.second.env);
+			}
+			for (auto f : features_) {
+				feature_names.push_back(f.first);
+			}
+		}
 
 		// assert fact to indicate feature availability to environments
-		for (auto env : envs_) {
-			env.second.env.lock();
-			assert_features(env.second.env, false);
+		for (auto env : envs) {
+			env.lock();
+			assert_features(env, feature_names, false);
 			// assert so it is immediately available
-			env.second.env->assert_fact_f("(ff-feature %s)", feature_name.c_str());
-			env.second.env.unlock();
+			env->assert_fact_f("(ff-feature %s)", feature_name.c_str());
+			env.unlock();
 		}
 	}
 }
@@ -458,6 +510,7 @@ CLIPSEnvManager::add_features(const std::list<CLIPSFeature *> &features)
 void
 CLIPSEnvManager::assert_can_remove_features(const std::list<CLIPSFeature *> &features)
 {
+	MutexLocker lock(mutex_);
 	for (auto feat : features) {
 		const std::string &feature_name = feat->clips_feature_name;
 
@@ -484,20 +537,17 @@ CLIPSEnvManager::remove_features(const std::list<CLIPSFeature *> &features)
 	// On plugin unload this would fail because destruction
 	// of threads is forced.
 	//assert_can_remove_features(features);
+	MutexLocker lock(mutex_);
 	for (auto feat : features) {
 		features_.erase(feat->clips_feature_name);
 	}
 }
 
 void
-CLIPSEnvManager::guarded_load(const std::string &env_name, const std::string &filename)
+CLIPSEnvManager::guarded_load(const std::string &          env_name,
+                              LockPtr<CLIPS::Environment> &clips,
+                              const std::string &          filename)
 {
-	if (envs_.find(env_name) == envs_.end()) {
-		throw Exception("guarded_load: env %s has not been registered", env_name.c_str());
-	}
-
-	LockPtr<CLIPS::Environment> &clips = envs_[env_name].env;
-
 	int load_rv = 0;
 	if ((load_rv = clips->load(filename)) != 1) {
 		if (load_rv == 0) {
@@ -35,6 +35,7 @@ namespace fawkes {
 class Logger;
 class Clock;
 class CLIPSFeature;
+class Mutex;
 
 class CLIPSEnvManager
 {
@@ -54,17 +55,22 @@ public:
 
 private:
 	LockPtr<CLIPS::Environment> new_env(const std::string &log_component_name);
-	void          assert_features(LockPtr<CLIPS::Environment> &clips, bool immediate_assert);
+	void          assert_features(LockPtr<CLIPS::Environment> &  clips,
+	                              const std::list<std::string> &features,
+	                              bool                          immediate_assert);
 	void          add_functions(const std::string &env_name, LockPtr<CLIPS::Environment> &clips);
 	CLIPS::Value  clips_request_feature(std::string env_name, std::string feature_name);
 	CLIPS::Values clips_now();
 	CLIPS::Values clips_now_systime();
-	void          guarded_load(const std::string &env_name, const std::string &filename);
+	void          guarded_load(const std::string &          env_name,
+	                           LockPtr<CLIPS::Environment> &clips,
+	                           const std::string &          filename);
 	void          quit();
 
 private:
 	Logger *logger_;
 	Clock * clock_;
+	Mutex * mutex_;
 
 	std::string clips_dir_;
 
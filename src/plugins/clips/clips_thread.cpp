@@ -63,6 +63,7 @@ CLIPSThread::init()
 		cfg_retract_early = config->get_bool("/clips/retract-early");
 	} catch (Exception &) {
 	}
+	bool cfg_delta_read = config->get_bool_or_default("/clips/delta-read", false);
 
 	CLIPS::init();
 	clips_env_mgr_ = new CLIPSEnvManager(logger, clock, clips_dir);
@@ -70,7 +71,7 @@ CLIPSThread::init()
 	clips_feature_aspect_inifin_.set_manager(clips_env_mgr_);
 	clips_manager_aspect_inifin_.set_manager(clips_env_mgr_);
 
-	features_.push_back(new BlackboardCLIPSFeature(logger, blackboard, cfg_retract_early));
+	features_.push_back(new BlackboardCLIPSFeature(logger, blackboard, cfg_retract_early, cfg_delta_read));
 	features_.push_back(new ConfigCLIPSFeature(logger, config));
 	features_.push_back(new RedefineWarningCLIPSFeature(logger));
 	clips_env_mgr_->add_features(features_);
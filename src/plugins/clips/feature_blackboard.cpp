@@ -24,6 +24,7 @@
 
 #include <blackboard/blackboard.h>
 #include <blackboard/exceptions.h>
+#include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
 #include <interface/interface_info.h>
 #include <logging/logger.h>
@@ -35,6 +36,55 @@
 
 using namespace fawkes;
 
+/// @cond INTERNAL
+// convert the value of an interface field to its CLIPS representation
+static std::string
+clips_value(InterfaceFieldIterator &f)
+{
+	std::string value;
+	if (f.get_type() == IFT_STRING) {
+		value                      = f.get_value_string();
+		std::string::size_type pos = 0;
+		while ((pos = value.find("\"", pos)) != std::string::npos) {
+			value.replace(pos, 1, "\\\"");
+			pos += 2;
+		}
+		value = std::string("\"") + value + "\"";
+	} else {
+		value = f.get_value_string();
+		std::string::size_type pos;
+		while ((pos = value.find(",")) != std::string::npos) {
+			value = value.erase(pos, 1);
+		}
+
+		if (f.get_type() == IFT_FLOAT || f.get_type() == IFT_DOUBLE) {
+			std::string::size_type pos;
+			while ((pos = value.find("-inf")) != std::string::npos) {
+				value = value.replace(pos, 4, std::to_string(std::numeric_limits<double>::min()));
+			}
+			while ((pos = value.find("inf")) != std::string::npos) {
+				value = value.replace(pos, 3, std::to_string(std::numeric_limits<double>::max()));
+			}
+			while ((pos = value.find("-nan")) != std::string::npos) {
+				value = value.replace(pos, 4, std::to_string(std::numeric_limits<double>::min() + 1));
+			}
+			while ((pos = value.find("nan")) != std::string::npos) {
+				value = value.replace(pos, 3, std::to_string(std::numeric_limits<double>::max() - 1));
+			}
+		} else if (f.get_type() == IFT_BOOL) {
+			std::string::size_type pos;
+			while ((pos = value.find("false")) != std::string::npos) {
+				value = value.replace(pos, 5, "FALSE");
+			}
+			while ((pos = value.find("true")) != std::string::npos) {
+				value = value.replace(pos, 4, "TRUE");
+			}
+		}
+	}
+	return value;
+}
+/// @endcond
+
 /** @class BlackboardCLIPSFeature "feature_blackboard.h"
  * CLIPS blackboard feature.
  * @author Tim Niemueller
@@ -47,41 +97,50 @@ using namespace fawkes;
  *        execution cycle they have been asserted in. If false (default),
  *        blackboard facts are only retracted immediately before a new
  *        fact representing a particular interface is asserted.
+ * @param delta_read Modify the fact of an interface on updates instead of
+ *        retracting it and asserting a new one, and only set the slots
+ *        whose values changed. Has no effect if @p retract_early is set.
  */
 BlackboardCLIPSFeature::BlackboardCLIPSFeature(fawkes::Logger *    logger,
                                                fawkes::BlackBoard *blackboard,
-                                               bool                retract_early)
+                                               bool                retract_early,
+                                               bool                delta_read)
 : CLIPSFeature("blackboard"),
   logger_(logger),
   blackboard_(blackboard),
-  cfg_retract_early_(retract_early)
+  cfg_retract_early_(retract_early),
+  cfg_delta_read_(delta_read && !retract_early)
 {
+	mutex_ = new Mutex();
 }
 
 /** Destructor. */
 BlackboardCLIPSFeature::~BlackboardCLIPSFeature()
 {
-	for (auto &iface_map : interfaces_) {
-		for (auto &iface_list : iface_map.second.reading) {
+	for (auto &envd : envs_) {
+		for (auto &iface_list : envd.second.interfaces.reading) {
 			for (auto iface : iface_list.second) {
 				blackboard_->close(iface);
 			}
 		}
-		for (auto &iface_list : iface_map.second.writing) {
+		for (auto &iface_list : envd.second.interfaces.writing) {
 			for (auto iface : iface_list.second) {
 				blackboard_->close(iface);
 			}
 		}
 	}
-	interfaces_.clear();
 	envs_.clear();
+	delete mutex_;
 }
 
 void
 BlackboardCLIPSFeature::clips_context_init(const std::string &                  env_name,
                                            fawkes::LockPtr<CLIPS::Environment> &clips)
 {
-	envs_[env_name] = clips;
+	{
+		MutexLocker lock(mutex_);
+		envs_[env_name].env = clips;
+	}
 	clips->evaluate("(path-load \"blackboard.clp\")");
 	clips->add_function(
 	  "blackboard-enable-time-read",
@@ -115,6 +174,11 @@ BlackboardCLIPSFeature::clips_context_init(const std::string &
 	                    sigc::slot<void>(sigc::bind<0>(
 	                      sigc::mem_fun(*this, &BlackboardCLIPSFeature::clips_blackboard_read),
 	                      env_name)));
+	clips->add_function(
+	  "blackboard-set-read-period",
+	  sigc::slot<void, std::string, std::string, float>(sigc::bind<0>(
+	    sigc::mem_fun(*this, &BlackboardCLIPSFeature::clips_blackboard_set_read_period),
+	    env_name)));
 	clips->add_function("blackboard-write",
 	                    sigc::slot<void, std::string>(sigc::bind<0>(
 	                      sigc::mem_fun(*this, &BlackboardCLIPSFeature::clips_blackboard_write),
@@ -160,32 +224,40 @@ BlackboardCLIPSFeature::clips_context_init(const std::string &
 void
 BlackboardCLIPSFeature::clips_context_destroyed(const std::string &env_name)
 {
-	if (interfaces_.find(env_name) != interfaces_.end()) {
-		for (auto &iface_map : interfaces_[env_name].reading) {
-			for (auto iface : iface_map.second) {
-				logger_->log_debug(("BBCLIPS|" + env_name).c_str(),
-				                   "Closing reading interface %s",
-				                   iface->uid());
-				blackboard_->close(iface);
-			}
+	EnvData envd;
+	{
+		MutexLocker lock(mutex_);
+		auto        e = envs_.find(env_name);
+		if (e == envs_.end()) {
+			return;
 		}
-		for (auto &iface_map : interfaces_[env_name].writing) {
-			for (auto iface : iface_map.second) {
-				logger_->log_debug(("BBCLIPS|" + env_name).c_str(),
-				                   "Closing writing interface %s",
-				                   iface->uid());
-				blackboard_->close(iface);
-			}
+		envd = std::move(e->second);
+		envs_.erase(e);
+	}
+
+	for (auto &iface_map : envd.interfaces.reading) {
+		for (auto iface : iface_map.second) {
+			logger_->log_debug(("BBCLIPS|" + env_name).c_str(),
+			                   "Closing reading interface %s",
+			                   iface->uid());
+			blackboard_->close(iface);
+		}
+	}
+	for (auto &iface_map : envd.interfaces.writing) {
+		for (auto iface : iface_map.second) {
+			logger_->log_debug(("BBCLIPS|" + env_name).c_str(),
+			                   "Closing writing interface %s",
+			                   iface->uid());
+			blackboard_->close(iface);
 		}
-		interfaces_.erase(env_name);
 	}
-	envs_.erase(env_name);
 }
 
 void
 BlackboardCLIPSFeature::clips_blackboard_enable_time_read(const std::string &env_name)
 {
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
 		                  "Cannot enable reading for environment %s "
 		                  "(not defined)",
@@ -200,8 +272,8 @@ BlackboardCLIPSFeature::clips_blackboard_enable_time_read(const std::string &env
 	                              "  (blackboard-read)\n"
 	                              ")";
 
-	fawkes::MutexLocker lock(envs_[env_name].objmutex_ptr());
-	envs_[env_name]->build(bb_read_defrule);
+	fawkes::MutexLocker lock(ed->env.objmutex_ptr());
+	ed->env->build(bb_read_defrule);
 }
 
 bool
@@ -210,6 +282,11 @@ BlackboardCLIPSFeature::clips_assert_interface_type(const std::string &env_name,
                                                     fawkes::Interface *iface,
                                                     const std::string &type)
 {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
+		return false;
+	}
+
 	std::string deftemplate = "(deftemplate " + type + "\n" + "  (slot id (type STRING))\n"
 	                          + "  (multislot time (type INTEGER) (cardinality 2 2))\n";
 
@@ -279,7 +356,7 @@ BlackboardCLIPSFeature::clips_assert_interface_type(const std::string &env_name,
 		logstr = "Deffunction";
 	}
 
-	if (envs_[env_name]->build(deftemplate) && envs_[env_name]->build(retract)) {
+	if (ed->env->build(deftemplate) && ed->env->build(retract)) {
 		logger_->log_debug(log_name.c_str(), "Deftemplate:\n%s", deftemplate.c_str());
 		logger_->log_debug(log_name.c_str(), "%s:\n%s", logstr.c_str(), retract.c_str());
 		return true;
@@ -298,7 +375,8 @@ BlackboardCLIPSFeature::clips_blackboard_preload(const std::string &env_name,
 {
 	std::string name = "BBCLIPS|" + env_name;
 
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		logger_->log_warn(name.c_str(),
 		                  "Environment %s has not been registered "
 		                  "for blackboard feature",
@@ -306,15 +384,15 @@ BlackboardCLIPSFeature::clips_blackboard_preload(const std::string &env_name,
 		return;
 	}
 
-	if (interfaces_[env_name].reading.find(type) == interfaces_[env_name].reading.end()
-	    && interfaces_[env_name].writing.find(type) == interfaces_[env_name].writing.end()) {
+	if (ed->interfaces.reading.find(type) == ed->interfaces.reading.end()
+	    && ed->interfaces.writing.find(type) == ed->interfaces.writing.end()) {
 		// no interface of this type registered yet, add deftemplate for it
 		Interface *iface = NULL;
 		try {
 			iface = blackboard_->open_for_reading(type.c_str(), "__clips_blackboard_preload__");
 			clips_assert_interface_type(env_name, name, iface, type);
 			blackboard_->close(iface);
-			interfaces_[env_name].reading.insert(std::make_pair(type, std::list<fawkes::Interface *>()));
+			ed->interfaces.reading.insert(std::make_pair(type, std::list<fawkes::Interface *>()));
 		} catch (Exception &e) {
 			logger_->log_warn(name.c_str(),
 			                  "Failed to preload interface type %s, "
@@ -335,7 +413,8 @@ BlackboardCLIPSFeature::clips_blackboard_open_interface(const std::string &env_n
 	std::string name  = "BBCLIPS|" + env_name;
 	std::string owner = "CLIPS:" + env_name;
 
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		logger_->log_warn(name.c_str(),
 		                  "Environment %s has not been registered "
 		                  "for blackboard feature",
@@ -343,10 +422,10 @@ BlackboardCLIPSFeature::clips_blackboard_open_interface(const std::string &env_n
 		return;
 	}
 
-	fawkes::LockPtr<CLIPS::Environment> clips = envs_[env_name];
+	fawkes::LockPtr<CLIPS::Environment> clips = ed->env;
 
 	Interface *   iface     = NULL;
-	InterfaceMap &iface_map = writing ? interfaces_[env_name].writing : interfaces_[env_name].reading;
+	InterfaceMap &iface_map = writing ? ed->interfaces.writing : ed->interfaces.reading;
 
 	if (iface_map.find(type) == iface_map.end()) {
 		// no interface of this type registered yet, add deftemplate for it
@@ -445,7 +524,8 @@ BlackboardCLIPSFeature::clips_blackboard_close_interface(const std::string &env_
 {
 	std::string name = "BBCLIPS|" + env_name;
 
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		logger_->log_warn(name.c_str(),
 		                  "Environment %s has not been registered "
 		                  "for blackboard feature",
@@ -453,19 +533,20 @@ BlackboardCLIPSFeature::clips_blackboard_close_interface(const std::string &env_
 		return;
 	}
 
-	if (interfaces_[env_name].reading.find(type) != interfaces_[env_name].reading.end()) {
-		auto &l = interfaces_[env_name].reading[type];
+	if (ed->interfaces.reading.find(type) != ed->interfaces.reading.end()) {
+		auto &l = ed->interfaces.reading[type];
 		auto  iface_it =
 		  find_if(l.begin(), l.end(), [&id](const Interface *iface) { return id == iface->id(); });
 		if (iface_it != l.end()) {
+			ed->read_states.erase((*iface_it)->uid());
 			blackboard_->close(*iface_it);
 			l.erase(iface_it);
 			// do NOT remove the list, even if empty, because we need to remember
 			// that we already built the deftemplate and added the cleanup rule
 		}
 	}
-	if (interfaces_[env_name].writing.find(type) != interfaces_[env_name].writing.end()) {
-		auto &l = interfaces_[env_name].writing[type];
+	if (ed->interfaces.writing.find(type) != ed->interfaces.writing.end()) {
+		auto &l = ed->interfaces.writing[type];
 		auto  iface_it =
 		  find_if(l.begin(), l.end(), [&id](const Interface *iface) { return id == iface->id(); });
 		if (iface_it != l.end()) {
@@ -480,10 +561,8 @@ BlackboardCLIPSFeature::clips_blackboard_close_interface(const std::string &env_
 void
 BlackboardCLIPSFeature::clips_blackboard_read(const std::string &env_name)
 {
-	// no interfaces registered, that's fine
-	if (interfaces_.find(env_name) == interfaces_.end())
-		return;
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		// Environment not registered, big bug
 		logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
 		                  "Environment %s not registered,"
@@ -492,82 +571,107 @@ BlackboardCLIPSFeature::clips_blackboard_read(const std::string &env_name)
 		return;
 	}
 
-	fawkes::MutexLocker lock(envs_[env_name].objmutex_ptr());
-	CLIPS::Environment &env = **(envs_[env_name]);
-	for (auto &iface_map : interfaces_[env_name].reading) {
+	fawkes::MutexLocker lock(ed->env.objmutex_ptr());
+	CLIPS::Environment &env = **(ed->env);
+
+	Time                              now;
+	std::map<std::string, ReadState> &states = ed->read_states;
+	std::vector<Interface *>          ifaces;
+	for (auto &iface_map : ed->interfaces.reading) {
 		for (auto i : iface_map.second) {
-			i->read();
-			if (i->refreshed()) {
-				if (!cfg_retract_early_) {
-					std::string fun = std::string("(") + i->type() + "-cleanup-late \"" + i->id() + "\")";
-					env.evaluate(fun);
+			auto s = states.find(i->uid());
+			if ((s != states.end()) && (s->second.read_period > 0.)) {
+				if (now < s->second.next_read) {
+					continue;
 				}
-				const Time *t = i->timestamp();
-
-				std::string fact = std::string("(") + i->type() + " (id \"" + i->id() + "\")" + " (time "
-				                   + StringConversions::to_string(t->get_sec()) + " "
-				                   + StringConversions::to_string(t->get_usec()) + ")";
-
-				InterfaceFieldIterator f, f_end = i->fields_end();
-				for (f = i->fields(); f != f_end; ++f) {
-					std::string value;
-					if (f.get_type() == IFT_STRING) {
-						value                      = f.get_value_string();
-						std::string::size_type pos = 0;
-						while ((pos = value.find("\"", pos)) != std::string::npos) {
-							value.replace(pos, 1, "\\\"");
-							pos += 2;
-						}
-						value = std::string("\"") + value + "\"";
-					} else {
-						value = f.get_value_string();
-						std::string::size_type pos;
-						while ((pos = value.find(",")) != std::string::npos) {
-							value = value.erase(pos, 1);
-						}
-
-						if (f.get_type() == IFT_FLOAT || f.get_type() == IFT_DOUBLE) {
-							std::string::size_type pos;
-							while ((pos = value.find("-inf")) != std::string::npos) {
-								value = value.replace(pos, 4, std::to_string(std::numeric_limits<double>::min()));
-							}
-							while ((pos = value.find("inf")) != std::string::npos) {
-								value = value.replace(pos, 3, std::to_string(std::numeric_limits<double>::max()));
-							}
-							while ((pos = value.find("-nan")) != std::string::npos) {
-								value =
-								  value.replace(pos, 4, std::to_string(std::numeric_limits<double>::min() + 1));
-							}
-							while ((pos = value.find("nan")) != std::string::npos) {
-								value =
-								  value.replace(pos, 3, std::to_string(std::numeric_limits<double>::max() - 1));
-							}
-						} else if (f.get_type() == IFT_BOOL) {
-							std::string::size_type pos;
-							while ((pos = value.find("false")) != std::string::npos) {
-								value = value.replace(pos, 5, "FALSE");
-							}
-							while ((pos = value.find("true")) != std::string::npos) {
-								value = value.replace(pos, 4, "TRUE");
-							}
-						}
+				s->second.next_read = now + (double)s->second.read_period;
+			}
+			ifaces.push_back(i);
+		}
+	}
+	blackboard_->read_batch(ifaces);
+
+	for (auto i : ifaces) {
+		if (!i->refreshed()) {
+			continue;
+		}
+		const Time *t = i->timestamp();
+
+		std::vector<std::pair<std::string, std::string>> slots;
+		slots.push_back(std::make_pair("time",
+		                               StringConversions::to_string(t->get_sec()) + " "
+		                                 + StringConversions::to_string(t->get_usec())));
+		InterfaceFieldIterator f, f_end = i->fields_end();
+		for (f = i->fields(); f != f_end; ++f) {
+			slots.push_back(std::make_pair(f.get_name(), clips_value(f)));
+		}
+
+		if (cfg_delta_read_) {
+			ReadState &state = states[i->uid()];
+			if (state.fact_index > 0) {
+				std::string changes;
+				for (const auto &slot : slots) {
+					std::string &prev = state.slots[slot.first];
+					if (prev != slot.second) {
+						changes += " (" + slot.first + " " + slot.second + ")";
+						prev = slot.second;
 					}
-					fact += std::string(" (") + f.get_name() + " " + value + ")";
 				}
-				fact += ")";
-				env.assert_fact(fact);
+				if (changes.empty()) {
+					continue;
+				}
+				std::string   index = StringConversions::to_string(state.fact_index);
+				CLIPS::Values rv    = env.evaluate("(if (fact-existp " + index
+				                                + ") then (fact-index (modify " + index + changes
+				                                + ")) else 0)");
+				if (!rv.empty() && (rv[0].type() == CLIPS::TYPE_INTEGER) && (rv[0].as_integer() > 0)) {
+					state.fact_index = rv[0].as_integer();
+					continue;
+				}
+				// the fact has been retracted elsewhere, assert a new one
 			}
 		}
+
+		if (!cfg_retract_early_) {
+			std::string fun = std::string("(") + i->type() + "-cleanup-late \"" + i->id() + "\")";
+			env.evaluate(fun);
+		}
+		std::string fact = std::string("(") + i->type() + " (id \"" + i->id() + "\")";
+		for (const auto &slot : slots) {
+			fact += " (" + slot.first + " " + slot.second + ")";
+		}
+		fact += ")";
+		CLIPS::Fact::pointer new_fact = env.assert_fact(fact);
+
+		if (cfg_delta_read_) {
+			ReadState &state = states[i->uid()];
+			state.fact_index = new_fact ? new_fact->index() : 0;
+			state.slots.clear();
+			state.slots.insert(slots.begin(), slots.end());
+		}
 	}
 }
 
 void
-BlackboardCLIPSFeature::clips_blackboard_write(const std::string &env_name, const std::string &uid)
+BlackboardCLIPSFeature::clips_blackboard_set_read_period(const std::string &env_name,
+                                                         const std::string &type,
+                                                         const std::string &id,
+                                                         float              period)
 {
-	// no interfaces registered, that's fine
-	if (interfaces_.find(env_name) == interfaces_.end())
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		return;
-	if (envs_.find(env_name) == envs_.end()) {
+	}
+	ReadState &state  = ed->read_states[type + "::" + id];
+	state.read_period = (period > 0.) ? period : 0.;
+	state.next_read   = Time(0, 0);
+}
+
+void
+BlackboardCLIPSFeature::clips_blackboard_write(const std::string &env_name, const std::string &uid)
+{
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		// Environment not registered, big bug
 		logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
 		                  "Environment %s not registered,"
@@ -578,11 +682,11 @@ BlackboardCLIPSFeature::clips_blackboard_write(const std::string &env_name, cons
 	}
 	std::string type, id;
 	Interface::parse_uid(uid.c_str(), type, id);
-	if (interfaces_[env_name].writing.find(type) != interfaces_[env_name].writing.end()) {
-		auto i = std::find_if(interfaces_[env_name].writing[type].begin(),
-		                      interfaces_[env_name].writing[type].end(),
+	if (ed->interfaces.writing.find(type) != ed->interfaces.writing.end()) {
+		auto i = std::find_if(ed->interfaces.writing[type].begin(),
+		                      ed->interfaces.writing[type].end(),
 		                      [&uid](const Interface *iface) -> bool { return uid == iface->uid(); });
-		if (i != interfaces_[env_name].writing[type].end()) {
+		if (i != ed->interfaces.writing[type].end()) {
 			(*i)->write();
 		} else {
 			logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
@@ -605,7 +709,8 @@ BlackboardCLIPSFeature::clips_blackboard_write(const std::string &env_name, cons
 void
 BlackboardCLIPSFeature::clips_blackboard_get_info(const std::string &env_name)
 {
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		// Environment not registered, big bug
 		logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
 		                  "Environment %s not registered,"
@@ -614,7 +719,7 @@ BlackboardCLIPSFeature::clips_blackboard_get_info(const std::string &env_name)
 		return;
 	}
 
-	fawkes::LockPtr<CLIPS::Environment> &clips = envs_[env_name];
+	fawkes::LockPtr<CLIPS::Environment> &clips = ed->env;
 
 	InterfaceInfoList *iil = blackboard_->list_all();
 
@@ -650,10 +755,8 @@ BlackboardCLIPSFeature::clips_blackboard_set(const std::string &env_name,
                                              const std::string &field,
                                              CLIPS::Value       value)
 {
-	// no interfaces registered, that's fine
-	if (interfaces_.find(env_name) == interfaces_.end())
-		return;
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		// Environment not registered, big bug
 		logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
 		                  "Environment %s not registered,"
@@ -665,11 +768,11 @@ BlackboardCLIPSFeature::clips_blackboard_set(const std::string &env_name,
 	}
 	std::string type, id;
 	Interface::parse_uid(uid.c_str(), type, id);
-	if (interfaces_[env_name].writing.find(type) != interfaces_[env_name].writing.end()) {
-		auto i = std::find_if(interfaces_[env_name].writing[type].begin(),
-		                      interfaces_[env_name].writing[type].end(),
+	if (ed->interfaces.writing.find(type) != ed->interfaces.writing.end()) {
+		auto i = std::find_if(ed->interfaces.writing[type].begin(),
+		                      ed->interfaces.writing[type].end(),
 		                      [&uid](const Interface *iface) -> bool { return uid == iface->uid(); });
-		if (i != interfaces_[env_name].writing[type].end()) {
+		if (i != ed->interfaces.writing[type].end()) {
 			set_field((*i)->fields(), (*i)->fields_end(), env_name, field, value);
 		} else {
 			logger_->log_error(("BBCLIPS|" + env_name).c_str(),
@@ -695,10 +798,8 @@ BlackboardCLIPSFeature::clips_blackboard_set_multifield(const std::string &env_n
                                                         const std::string &field,
                                                         CLIPS::Values      values)
 {
-	// no interfaces registered, that's fine
-	if (interfaces_.find(env_name) == interfaces_.end())
-		return;
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		// Environment not registered, big bug
 		logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
 		                  "Environment %s not registered,"
@@ -710,11 +811,11 @@ BlackboardCLIPSFeature::clips_blackboard_set_multifield(const std::string &env_n
 	}
 	std::string type, id;
 	Interface::parse_uid(uid.c_str(), type, id);
-	if (interfaces_[env_name].writing.find(type) != interfaces_[env_name].writing.end()) {
-		auto i = std::find_if(interfaces_[env_name].writing[type].begin(),
-		                      interfaces_[env_name].writing[type].end(),
+	if (ed->interfaces.writing.find(type) != ed->interfaces.writing.end()) {
+		auto i = std::find_if(ed->interfaces.writing[type].begin(),
+		                      ed->interfaces.writing[type].end(),
 		                      [&uid](const Interface *iface) -> bool { return uid == iface->uid(); });
-		if (i != interfaces_[env_name].writing[type].end()) {
+		if (i != ed->interfaces.writing[type].end()) {
 			set_multifield((*i)->fields(), (*i)->fields_end(), env_name, field, values);
 		} else {
 			logger_->log_error(("BBCLIPS|" + env_name).c_str(),
@@ -739,11 +840,8 @@ BlackboardCLIPSFeature::clips_blackboard_create_msg(const std::string &env_name,
                                                     const std::string &uid,
                                                     const std::string &msg_type)
 {
-	// no interfaces registered, that's fine
-	if (interfaces_.find(env_name) == interfaces_.end()) {
-		return CLIPS::Value(new std::shared_ptr<Message>());
-	}
-	if (envs_.find(env_name) == envs_.end()) {
+	EnvData *ed = env_data(env_name);
+	if (!ed) {
 		// Environment not registered, big bug
 		logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
 		                  "Environment %s not registered,"
@@ -751,23 +849,23 @@ BlackboardCLIPSFeature::clips_blackboard_create_msg(const std::string &env_name,
 		                  env_name.c_str());
 		return CLIPS::Value(new std::shared_ptr<Message>());
 	}
-	fawkes::MutexLocker lock(envs_[env_name].objmutex_ptr());
+	fawkes::MutexLocker lock(ed->env.objmutex_ptr());
 
 	std::string if_type, id;
 	Interface::parse_uid(uid.c_str(), if_type, id);
 
 	//get interface
-	if (interfaces_[env_name].reading.find(if_type) == interfaces_[env_name].reading.end()) {
+	if (ed->interfaces.reading.find(if_type) == ed->interfaces.reading.end()) {
 		logger_->log_warn(
 		  ("BBCLIPS|" + env_name).c_str(),
 		  "Can't create message for interface %s, because there is no opened interface with this type",
 		  uid.c_str());
 		return CLIPS::Value(new std::shared_ptr<Message>());
 	}
-	auto i = std::find_if(interfaces_[env_name].reading[if_type].begin(),
-	                      interfaces_[env_name].reading[if_type].end(),
+	auto i = std::find_if(ed->interfaces.reading[if_type].begin(),
+	                      ed->interfaces.reading[if_type].end(),
 	                      [&uid](const Interface *iface) -> bool { return uid == iface->uid(); });
-	if (i == interfaces_[env_name].reading[if_type].end()) {
+	if (i == ed->interfaces.reading[if_type].end()) {
 		logger_->log_warn(
 		  ("BBCLIPS|" + env_name).c_str(),
 		  "Can't create message for interface %s, because there is no opened interface with that uid",
@@ -797,7 +895,10 @@ BlackboardCLIPSFeature::clips_blackboard_create_msg(const std::string &env_name,
 	Message *m = (*i)->create_message(msg_type.c_str());
 
 	//save which interface belongs to the message
-	interface_of_msg_[m] = (*i);
+	{
+		MutexLocker lock(mutex_);
+		interface_of_msg_[m] = (*i);
+	}
 
 	//send message to clips
 	return CLIPS::Value(new std::shared_ptr<Message>(m));
@@ -872,7 +973,17 @@ BlackboardCLIPSFeature::clips_blackboard_send_msg(const std::string &env_name, v
 		                  "Can't set message field, the pointer is wrong.");
 		return CLIPS::Value(0);
 	}
-	if (!interface_of_msg_[m->get()]) {
+	Interface *iface = NULL;
+	{
+		MutexLocker lock(mutex_);
+		auto        i = interface_of_msg_.find(m->get());
+		if (i != interface_of_msg_.end()) {
+			iface = i->second;
+			//delete saved pointer to interface
+			interface_of_msg_.erase(i);
+		}
+	}
+	if (!iface) {
 		logger_->log_warn(("BBCLIPS|" + env_name).c_str(), "Can't send message, was it already sent?");
 		return CLIPS::Value(0);
 	}
@@ -884,7 +995,7 @@ BlackboardCLIPSFeature::clips_blackboard_send_msg(const std::string &env_name, v
 
 	//send message about the saved interface
 	try {
-		interface_of_msg_[m->get()]->msgq_enqueue(m->get());
+		iface->msgq_enqueue(m->get());
 		message_id = m->get()->id();
 	} catch (BlackBoardNoWritingInstanceException &e) {
 		// keep quiet, BlackBoardMessageManager will already have printed a warning
@@ -895,9 +1006,6 @@ BlackboardCLIPSFeature::clips_blackboard_send_msg(const std::string &env_name, v
 		                  e.what_no_backtrace());
 	}
 
-	//delete saved pointer to interface
-	interface_of_msg_.erase(m->get());
-
 	//remove added refference
 	m->get()->unref();
 
@@ -1172,3 +1280,19 @@ BlackboardCLIPSFeature::set_field(InterfaceFieldIterator fit_begin,
 	}
 	return true;
 }
+
+/** Get data of an environment.
+ * The map of environments is shared by all threads running CLIPS
+ * environments and is guarded by the feature mutex. The data of a
+ * particular environment is only used from the thread running it and
+ * remains valid until the environment is destroyed.
+ * @param env_name name of the environment
+ * @return data of the environment, NULL if it is not registered
+ */
+BlackboardCLIPSFeature::EnvData *
+BlackboardCLIPSFeature::env_data(const std::string &env_name)
+{
+	MutexLocker lock(mutex_);
+	auto        e = envs_.find(env_name);
+	return (e != envs_.end()) ? &e->second : NULL;
+}
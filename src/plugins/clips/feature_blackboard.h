@@ -25,6 +25,7 @@
 
 #include <clipsmm/value.h>
 #include <plugins/clips/aspect/clips_feature.h>
+#include <utils/time/time.h>
 
 #include <list>
 #include <map>
@@ -40,6 +41,7 @@ class Logger;
 class Interface;
 class Message;
 class InterfaceFieldIterator;
+class Mutex;
 } // namespace fawkes
 
 class BlackboardCLIPSFeature : public fawkes::CLIPSFeature
@@ -47,7 +49,8 @@ class BlackboardCLIPSFeature : public fawkes::CLIPSFeature
 public:
 	BlackboardCLIPSFeature(fawkes::Logger *    logger,
 	                       fawkes::BlackBoard *blackboard,
-	                       bool                retract_early);
+	                       bool                retract_early,
+	                       bool                delta_read = false);
 	virtual ~BlackboardCLIPSFeature();
 
 	// for CLIPSFeature
@@ -59,6 +62,7 @@ private: // members
 	fawkes::Logger *    logger_;
 	fawkes::BlackBoard *blackboard_;
 	bool                cfg_retract_early_;
+	bool                cfg_delta_read_;
 
 	typedef std::map<std::string, std::list<fawkes::Interface *>> InterfaceMap;
 	typedef struct
@@ -66,12 +70,28 @@ private: // members
 		InterfaceMap reading;
 		InterfaceMap writing;
 	} Interfaces;
-	std::map<std::string, Interfaces>                          interfaces_;
-	std::map<std::string, fawkes::LockPtr<CLIPS::Environment>> envs_;
+	/// read state of a reading interface
+	typedef struct
+	{
+		long int                           fact_index  = 0;  ///< index of current fact, 0 if none
+		std::map<std::string, std::string> slots;            ///< slot values of the current fact
+		float                              read_period = 0.; ///< min sec between reads
+		fawkes::Time                       next_read;        ///< earliest time of the next read
+	} ReadState;
+	/// data of an environment
+	typedef struct
+	{
+		fawkes::LockPtr<CLIPS::Environment> env;         ///< the environment
+		Interfaces                          interfaces;  ///< opened interfaces
+		std::map<std::string, ReadState>    read_states; ///< read state by interface UID
+	} EnvData;
+	fawkes::Mutex *                mutex_;
+	std::map<std::string, EnvData> envs_;
 	//which created message belongs to which interface
 	std::map<fawkes::Message *, fawkes::Interface *> interface_of_msg_;
 
 private: // methods
+	EnvData *env_data(const std::string &env_name);
 	void clips_blackboard_open_interface(const std::string &env_name,
 	                                     const std::string &type,
 	                                     const std::string &id,
@@ -86,6 +106,10 @@ private: // methods
 	                                      const std::string &type,
 	                                      const std::string &id);
 	void clips_blackboard_read(const std::string &env_name);
+	void clips_blackboard_set_read_period(const std::string &env_name,
+	                                      const std::string &type,
+	                                      const std::string &id,
+	                                      float              period);
 	void clips_blackboard_write(const std::string &env_name, const std::string &uid);
 
 	void          clips_blackboard_enable_time_read(const std::string &env_name);
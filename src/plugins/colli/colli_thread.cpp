@@ -40,6 +40,7 @@
 #include <interfaces/NavigatorInterface.h>
 #include <tf/time_cache.h>
 #include <utils/math/common.h>
+#include <utils/time/latency_trace.h>
 #include <utils/time/wait.h>
 
 #include <string>
@@ -284,6 +285,8 @@ void
 ColliThread::loop()
 {
 	timer_->mark_start();
+	// only propagate the latency trace of data read in this iteration
+	LatencyTrace::clear();
 
 	// Do not continue if we don't have a valid transform from base to laser yet
 	if (!laser_to_base_valid_) {
@@ -581,6 +584,9 @@ ColliThread::colli_execute_()
 					// call appopriate drive mode
 					select_drive_mode_->set_local_target(local_target_.x, local_target_.y);
 					select_drive_mode_->set_local_trajec(local_trajec_.x, local_trajec_.y);
+					select_drive_mode_->set_sampling_grid_information(occ_grid_,
+					                                                  robo_grid_pos_.x,
+					                                                  robo_grid_pos_.y);
 					select_drive_mode_->update();
 					proposed_.x   = select_drive_mode_->get_proposed_trans_x();
 					proposed_.y   = select_drive_mode_->get_proposed_trans_y();
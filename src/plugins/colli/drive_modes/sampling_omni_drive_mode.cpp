@@ -0,0 +1,296 @@
+
+/***************************************************************************
+ *  sampling_omni_drive_mode.cpp - Implementation of drive-mode "sampling"
+ *
+ *  Created: Thu Oct 15 08:17:53 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "sampling_omni_drive_mode.h"
+
+#include "../search/og_laser.h"
+
+#include <utils/math/angle.h>
+#include <utils/math/common.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+/** Maximum number of simulated steps per trajectory. */
+static const unsigned int MAX_STEPS = 64;
+/** Score of a trajectory which collides. */
+static const float COLLIDING = -std::numeric_limits<float>::infinity();
+/// @endcond
+
+/** @class SamplingOmniDriveModule <plugins/colli/drive_modes/sampling_omni_drive_mode.h>
+ * Sampling forward drive-module for omnidirectional robots.
+ * Instead of computing a single command from the local target, velocity
+ * triples (vx, vy, rot) are sampled in the window reachable within one
+ * loop given the acceleration limits. Each candidate is forward-simulated
+ * with constant velocity over a short horizon and checked against the
+ * occupancy grid, in which obstacles are already grown by the robot shape.
+ * Colliding candidates are discarded, the others are scored by progress
+ * towards the local target, heading, velocity and clearance. Candidates
+ * are scored in parallel if the plugin is built with OpenMP.
+ */
+
+/** Constructor.
+ * @param logger The fawkes logger
+ * @param config The fawkes configuration
+ */
+SamplingOmniDriveModule::SamplingOmniDriveModule(Logger *logger, Configuration *config)
+: AbstractDriveMode(logger, config)
+{
+	logger_->log_debug("SamplingOmniDriveModule", "(Constructor): Entering...");
+	drive_mode_  = NavigatorInterface::Forward;
+	occ_grid_    = NULL;
+	robo_grid_x_ = 0;
+	robo_grid_y_ = 0;
+
+	max_trans_ = config_->get_float("/plugins/colli/drive_mode/normal/max_trans");
+	max_rot_   = config_->get_float("/plugins/colli/drive_mode/normal/max_rot");
+
+	cfg_trans_acc_ = config_->get_float("/plugins/colli/motor_instruct/trans_acc");
+	cfg_rot_acc_   = config_->get_float("/plugins/colli/motor_instruct/rot_acc");
+
+	const std::string prefix = "/plugins/colli/drive_mode/sampling/";
+	cfg_samples_trans_       = std::max(2u, config_->get_uint(prefix + "samples_trans"));
+	cfg_samples_rot_         = std::max(2u, config_->get_uint(prefix + "samples_rot"));
+	cfg_sim_step_            = config_->get_float(prefix + "sim_step");
+	float horizon            = config_->get_float(prefix + "horizon");
+	cfg_steps_ = std::min(MAX_STEPS, std::max(1u, (unsigned int)std::ceil(horizon / cfg_sim_step_)));
+
+	cfg_weight_target_    = config_->get_float(prefix + "weights/target");
+	cfg_weight_heading_   = config_->get_float(prefix + "weights/heading");
+	cfg_weight_velocity_  = config_->get_float(prefix + "weights/velocity");
+	cfg_weight_clearance_ = config_->get_float(prefix + "weights/clearance");
+
+	const size_t num_candidates = cfg_samples_trans_ * cfg_samples_trans_ * cfg_samples_rot_;
+	cand_vx_.resize(num_candidates);
+	cand_vy_.resize(num_candidates);
+	cand_rot_.resize(num_candidates);
+	cand_score_.resize(num_candidates);
+
+	logger_->log_debug("SamplingOmniDriveModule", "(Constructor): Exiting...");
+}
+
+/** Destructor. */
+SamplingOmniDriveModule::~SamplingOmniDriveModule()
+{
+	logger_->log_debug("SamplingOmniDriveModule", "(Destructor): Entering...");
+	drive_mode_ = NavigatorInterface::MovingNotAllowed;
+	logger_->log_debug("SamplingOmniDriveModule", "(Destructor): Exiting...");
+}
+
+/** Set the grid information needed to check the sampled trajectories.
+ * Has to be set before update!
+ * @param occ_grid The laser occupancy grid
+ * @param robo_x The robots position in the grid in x-direction
+ * @param robo_y The robots position in the grid in y-direction
+ */
+void
+SamplingOmniDriveModule::set_grid_information(LaserOccupancyGrid *occ_grid, int robo_x, int robo_y)
+{
+	occ_grid_    = occ_grid;
+	robo_grid_x_ = robo_x;
+	robo_grid_y_ = robo_y;
+}
+
+/** Sample candidate velocities.
+ * The candidates are spread evenly over the dynamic window, i.e. the
+ * velocities reachable from the current velocity within one loop,
+ * limited by the maximum velocities.
+ */
+void
+SamplingOmniDriveModule::sample_velocities()
+{
+	const float vx_min  = std::max(-max_trans_, robot_vel_.x - cfg_trans_acc_);
+	const float vx_max  = std::min(max_trans_, robot_vel_.x + cfg_trans_acc_);
+	const float vy_min  = std::max(-max_trans_, robot_vel_.y - cfg_trans_acc_);
+	const float vy_max  = std::min(max_trans_, robot_vel_.y + cfg_trans_acc_);
+	const float rot_min = std::max(-max_rot_, robot_vel_.rot - cfg_rot_acc_);
+	const float rot_max = std::min(max_rot_, robot_vel_.rot + cfg_rot_acc_);
+
+	const float vx_step  = (vx_max - vx_min) / (cfg_samples_trans_ - 1);
+	const float vy_step  = (vy_max - vy_min) / (cfg_samples_trans_ - 1);
+	const float rot_step = (rot_max - rot_min) / (cfg_samples_rot_ - 1);
+
+	unsigned int i = 0;
+	for (unsigned int ix = 0; ix < cfg_samples_trans_; ++ix) {
+		for (unsigned int iy = 0; iy < cfg_samples_trans_; ++iy) {
+			for (unsigned int ir = 0; ir < cfg_samples_rot_; ++ir, ++i) {
+				cand_vx_[i]  = vx_min + ix * vx_step;
+				cand_vy_[i]  = vy_min + iy * vy_step;
+				cand_rot_[i] = rot_min + ir * rot_step;
+			}
+		}
+	}
+}
+
+/** Simulate and score a candidate.
+ * @param i index of the candidate
+ * @param des_alpha desired orientation relative to the robot
+ * @param dist_to_target distance to the local target
+ * @return score of the candidate, or negative infinity if the simulated
+ * trajectory collides with an obstacle
+ */
+float
+SamplingOmniDriveModule::score_trajectory(unsigned int i, float des_alpha, float dist_to_target)
+{
+	const float vx  = cand_vx_[i];
+	const float vy  = cand_vy_[i];
+	const float rot = cand_rot_[i];
+
+	// Poses of a constant velocity motion have a closed form, the steps do
+	// not depend on each other and the loops can be vectorized.
+	float px[MAX_STEPS];
+	float py[MAX_STEPS];
+	if (std::fabs(rot) < 1e-3f) {
+		for (unsigned int s = 0; s < cfg_steps_; ++s) {
+			const float t = (s + 1) * cfg_sim_step_;
+			px[s]         = vx * t;
+			py[s]         = vy * t;
+		}
+	} else {
+		for (unsigned int s = 0; s < cfg_steps_; ++s) {
+			const float th   = rot * (s + 1) * cfg_sim_step_;
+			const float sin_ = std::sin(th);
+			const float cos_ = std::cos(th);
+			px[s]            = (vx * sin_ + vy * (cos_ - 1.f)) / rot;
+			py[s]            = (vx * (1.f - cos_) + vy * sin_) / rot;
+		}
+	}
+
+	// check the cells the robot passes, obstacles are grown by the robot shape
+	const int   width      = occ_grid_->get_width();
+	const int   height     = occ_grid_->get_height();
+	const float cells_x    = 100.f / occ_grid_->get_cell_width();
+	const float cells_y    = 100.f / occ_grid_->get_cell_height();
+	float       worst_cost = cell_costs_.free;
+	for (unsigned int s = 0; s < cfg_steps_; ++s) {
+		const int x = robo_grid_x_ + (int)std::lround(px[s] * cells_x);
+		const int y = robo_grid_y_ + (int)std::lround(py[s] * cells_y);
+		if (x < 0 || x >= width || y < 0 || y >= height)
+			break;
+		const float cost = occ_grid_->occupancy_probs_[x * height + y];
+		if (cost >= cell_costs_.occ)
+			return COLLIDING;
+		worst_cost = std::max(worst_cost, cost);
+	}
+
+	const float horizon   = cfg_steps_ * cfg_sim_step_;
+	const float end_x     = px[cfg_steps_ - 1];
+	const float end_y     = py[cfg_steps_ - 1];
+	const float end_dist  = std::sqrt(sqr(local_target_.x - end_x) + sqr(local_target_.y - end_y));
+	const float progress  = (dist_to_target - end_dist) / (max_trans_ * horizon);
+	const float heading   = 1.f - std::fabs(angle_distance_signed(rot * horizon, des_alpha)) / M_PI;
+	const float cost_span = std::max(1.f, (float)cell_costs_.occ - cell_costs_.free);
+	const float clearance = 1.f - (worst_cost - cell_costs_.free) / cost_span;
+
+	// do not reward speed once the local target is reached within the horizon
+	float velocity = 0.f;
+	if (end_dist >= 0.1f) {
+		velocity = std::sqrt(sqr(vx) + sqr(vy)) / max_trans_;
+	}
+
+	return cfg_weight_target_ * progress + cfg_weight_heading_ * heading
+	       + cfg_weight_velocity_ * velocity + cfg_weight_clearance_ * clearance;
+}
+
+/* ************************************************************************** */
+/* ***********************        U P D A T E       ************************* */
+/* ************************************************************************** */
+
+/** Calculate the proposed settings.
+ * Samples the dynamic window, simulates and scores all candidates and
+ * proposes the best one which does not collide. If all candidates
+ * collide, the robot is stopped.
+ *
+ *  Afterwards filled should be:
+ *
+ *     proposed_          --> Desired translation and rotation speed
+ *
+ *  Those values are questioned after an update() was called.
+ */
+void
+SamplingOmniDriveModule::update()
+{
+	proposed_.x = proposed_.y = proposed_.rot = 0.f;
+
+	if (occ_grid_ == NULL) {
+		logger_->log_error("SamplingOmniDriveModule", "No grid information, stopping");
+		return;
+	}
+
+	float dist_to_target    = sqrt(sqr(local_target_.x) + sqr(local_target_.y));
+	float alpha_target      = normalize_mirror_rad(atan2(local_target_.y, local_target_.x));
+	float alpha_next_target = angle_distance_signed(robot_.ori, target_.ori);
+
+	// last time border check............. IMPORTANT!!!
+	// because the motorinstructor just tests robots physical borders.
+	if (dist_to_target < 0.04)
+		return;
+
+	// face the local target, but already turn towards the final orientation
+	float angle_tollerance = M_PI_4 / 2.;
+	float des_alpha        = alpha_target;
+	if (std::isfinite(alpha_next_target)) {
+		des_alpha = std::max(alpha_target - angle_tollerance,
+		                     std::min(alpha_next_target, alpha_target + angle_tollerance));
+	}
+
+	cell_costs_ = occ_grid_->get_cell_costs();
+	sample_velocities();
+
+	const int num_candidates = cand_score_.size();
+#pragma omp parallel for
+	for (int i = 0; i < num_candidates; ++i) {
+		cand_score_[i] = score_trajectory(i, des_alpha, dist_to_target);
+	}
+
+	std::vector<float>::iterator best = std::max_element(cand_score_.begin(), cand_score_.end());
+	if (*best == COLLIDING) {
+		// every candidate collides
+		return;
+	}
+
+	unsigned int b = best - cand_score_.begin();
+	proposed_.x    = cand_vx_[b];
+	proposed_.y    = cand_vy_[b];
+	proposed_.rot  = cand_rot_[b];
+
+	if (stop_at_target_) {
+		float target_rel     = std::sqrt(sqr(target_.x - robot_.x) + sqr(target_.y - robot_.y));
+		float robo_trans     = std::sqrt(sqr(robot_vel_.x) + sqr(robot_vel_.y));
+		float proposed_trans = std::sqrt(sqr(proposed_.x) + sqr(proposed_.y));
+		float target_trans   = guarantee_trans_stop(target_rel, robo_trans, proposed_trans);
+
+		float des = fabs(target_trans / proposed_trans);
+		if (proposed_trans == 0) {
+			des = 0;
+		}
+
+		proposed_.x *= des;
+		proposed_.y *= des;
+	}
+}
+
+} // namespace fawkes
@@ -0,0 +1,73 @@
+
+/***************************************************************************
+ *  sampling_omni_drive_mode.h - Implementation of drive-mode "sampling"
+ *
+ *  Created: Thu Oct 15 08:17:53 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_COLLI_SAMPLING_OMNI_DRIVE_MODE_H_
+#define _PLUGINS_COLLI_SAMPLING_OMNI_DRIVE_MODE_H_
+
+#include "abstract_drive_mode.h"
+
+#include <vector>
+
+namespace fawkes {
+
+class LaserOccupancyGrid;
+
+class SamplingOmniDriveModule : public AbstractDriveMode
+{
+public:
+	SamplingOmniDriveModule(Logger *logger, Configuration *config);
+	~SamplingOmniDriveModule();
+
+	virtual void update();
+
+	void set_grid_information(LaserOccupancyGrid *occ_grid, int robo_x, int robo_y);
+
+private:
+	void  sample_velocities();
+	float score_trajectory(unsigned int i, float des_alpha, float dist_to_target);
+
+	LaserOccupancyGrid *occ_grid_;
+	int                 robo_grid_x_;
+	int                 robo_grid_y_;
+	colli_cell_cost_t   cell_costs_;
+
+	unsigned int cfg_samples_trans_;
+	unsigned int cfg_samples_rot_;
+	unsigned int cfg_steps_;
+	float        cfg_sim_step_;
+	float        cfg_trans_acc_;
+	float        cfg_rot_acc_;
+	float        cfg_weight_target_;
+	float        cfg_weight_heading_;
+	float        cfg_weight_velocity_;
+	float        cfg_weight_clearance_;
+
+	// candidate velocities and their scores, stored as separate arrays
+	std::vector<float> cand_vx_;
+	std::vector<float> cand_vy_;
+	std::vector<float> cand_rot_;
+	std::vector<float> cand_score_;
+};
+
+} // namespace fawkes
+
+#endif
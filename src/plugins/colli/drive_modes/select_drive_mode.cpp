@@ -31,6 +31,7 @@
 #include "escape_potential_field_omni_drive_mode.h"
 #include "forward_drive_mode.h"
 #include "forward_omni_drive_mode.h"
+#include "sampling_omni_drive_mode.h"
 #include "stop_drive_mode.h"
 // YOUR CHANGES SHOULD END HERE!!!
 
@@ -65,6 +66,7 @@ SelectDriveMode::SelectDriveMode(MotorInterface *    motor,
   if_colli_target_(target),
   if_motor_(motor),
   cfg_escape_mode_(escape_mode),
+  sampling_(NULL),
   escape_flag_(0) // no escaping at the beginning
 {
 	logger_->log_debug("SelectDriveMode", "(Constructor): Entering");
@@ -147,8 +149,19 @@ SelectDriveMode::load_drive_modes_omnidirectional()
 		drive_modes_.push_back(new EscapePotentialFieldOmniDriveModule(logger_, config_));
 	}
 
-	ForwardOmniDriveModule *forward = new ForwardOmniDriveModule(logger_, config_);
-	drive_modes_.push_back(forward);
+	bool sampling_enabled = false;
+	try {
+		sampling_enabled = config_->get_bool("/plugins/colli/drive_mode/sampling/enabled");
+	} catch (Exception &e) {
+	} // ignore, use default
+
+	if (sampling_enabled) {
+		sampling_ = new SamplingOmniDriveModule(logger_, config_);
+		drive_modes_.push_back(sampling_);
+	} else {
+		ForwardOmniDriveModule *forward = new ForwardOmniDriveModule(logger_, config_);
+		drive_modes_.push_back(forward);
+	}
 }
 
 /** Set local target point before update!
@@ -222,6 +235,22 @@ SelectDriveMode::set_grid_information(LaserOccupancyGrid *occ_grid, int robo_x,
 	logger_->log_error("SelectDriveMode", "Can't find escape drive mode to set grid information");
 }
 
+/** Hand over grid information to the sampling drive mode.
+ * Does nothing if the sampling drive mode is not used.
+ * @param occ_grid pointer to the occ_grid
+ * @param robo_x   robot position on the grid in x
+ * @param robo_y   robot position on the grid in y
+ */
+void
+SelectDriveMode::set_sampling_grid_information(LaserOccupancyGrid *occ_grid,
+                                               int                 robo_x,
+                                               int                 robo_y)
+{
+	if (sampling_) {
+		sampling_->set_grid_information(occ_grid, robo_x, robo_y);
+	}
+}
+
 /**
  * search for the escape drive mode and hands over the given information to the escape drive mode
  * This should just be called if basic-escape mode is used!
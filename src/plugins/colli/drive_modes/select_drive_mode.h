@@ -36,6 +36,7 @@ class NavigatorInterface;
 class Logger;
 class Configuration;
 class LaserOccupancyGrid;
+class SamplingOmniDriveModule;
 
 class SelectDriveMode
 {
@@ -67,6 +68,8 @@ public:
 
 	void set_grid_information(LaserOccupancyGrid *occ_grid, int robo_x, int robo_y);
 
+	void set_sampling_grid_information(LaserOccupancyGrid *occ_grid, int robo_x, int robo_y);
+
 	void set_laser_data(std::vector<fawkes::polar_coord_2d_t> &laser_points);
 
 private:
@@ -82,6 +85,9 @@ private:
 	// Vector of drive modes
 	std::vector<AbstractDriveMode *> drive_modes_;
 
+	// sampling drive mode, if used instead of the forward drive mode
+	SamplingOmniDriveModule *sampling_;
+
 	// local copies of current local target values
 	cart_coord_2d_t local_target_;
 	cart_coord_2d_t local_trajec_;
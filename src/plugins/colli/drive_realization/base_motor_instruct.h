@@ -27,6 +27,7 @@
 #include "../common/types.h"
 
 #include <config/config.h>
+#include <interface/message_pool.h>
 #include <interfaces/MotorInterface.h>
 #include <logging/logger.h>
 #include <utils/time/time.h>
@@ -79,6 +80,8 @@ private:
 
 	MotorInterface *motor_;
 
+	MessagePool<MotorInterface::TransRotMessage> trans_rot_pool_;
+
 	colli_trans_rot_t current_;
 	colli_trans_rot_t desired_;
 	colli_trans_rot_t exec_;
@@ -162,7 +165,11 @@ BaseMotorInstruct::set_command()
 	}
 
 	// Send the commands to the motor. No controlling afterwards done!!!!
-	motor_->msgq_enqueue(new MotorInterface::TransRotMessage(cmd.x, cmd.y, cmd.rot));
+	MotorInterface::TransRotMessage *msg = trans_rot_pool_.acquire();
+	msg->set_vx(cmd.x);
+	msg->set_vy(cmd.y);
+	msg->set_omega(cmd.rot);
+	motor_->msgq_enqueue(msg);
 }
 
 /** Try to realize the proposed values with respect to the physical constraints of the robot.
@@ -23,6 +23,7 @@
 #include "astar_search.h"
 
 #include "astar.h"
+#include "incremental_astar.h"
 #include "og_laser.h"
 
 #include <config/config.h>
@@ -49,6 +50,14 @@ Search::Search(LaserOccupancyGrid *occ_grid, Logger *logger, Configuration *conf
 	std::string cfg_prefix            = "/plugins/colli/search/";
 	cfg_search_line_allowed_cost_max_ = config->get_int((cfg_prefix + "line/cost_max").c_str());
 	astar_.reset(new AStarColli(occ_grid, logger, config));
+
+	bool cfg_incremental = false;
+	try {
+		cfg_incremental = config->get_bool((cfg_prefix + "a_star/incremental").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+	if (cfg_incremental)
+		incremental_astar_.reset(new IncrementalAStarColli(occ_grid, logger, config));
 	logger_->log_debug("search", "(Constructor): Exiting");
 }
 
@@ -89,7 +98,10 @@ Search::update(int robo_x, int robo_y, int target_x, int target_y)
 		target_position_ = point_t(target_x, target_y);
 	}
 
-	astar_->solve(robo_position_, target_position_, plan_);
+	if (incremental_astar_)
+		incremental_astar_->solve(robo_position_, target_position_, plan_);
+	else
+		astar_->solve(robo_position_, target_position_, plan_);
 
 	if (plan_.size() > 0) {
 		updated_successful_ = true;
@@ -32,6 +32,7 @@ namespace fawkes {
 
 class LaserOccupancyGrid;
 class AStarColli;
+class IncrementalAStarColli;
 class Logger;
 class Configuration;
 
@@ -72,8 +73,9 @@ private:
 	/** Method for checking if an obstacle is between two points. */
 	bool is_obstacle_between(const point_t &a, const point_t &b, const int maxcount);
 
-	std::unique_ptr<AStarColli> astar_; /**< the A* search algorithm */
-	std::vector<point_t>        plan_;  /**< the local representation of the plan */
+	std::unique_ptr<AStarColli>            astar_; /**< the A* search algorithm */
+	std::unique_ptr<IncrementalAStarColli> incremental_astar_; /**< incremental A*, if enabled */
+	std::vector<point_t>                   plan_; /**< the local representation of the plan */
 
 	point_t robo_position_, target_position_;
 	bool    updated_successful_;
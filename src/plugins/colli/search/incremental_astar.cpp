@@ -0,0 +1,387 @@
+
+/***************************************************************************
+ *  incremental_astar.cpp - Incremental A* (D* Lite) search implementation
+ *
+ *  Created: Thu Oct 15 04:11:43 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "incremental_astar.h"
+
+#include "og_laser.h"
+
+#include <config/config.h>
+#include <logging/logger.h>
+#include <utils/math/types.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace fawkes {
+
+// Cost of an unreachable vertex, leaves room for adding cell costs
+static const int INF_COST = std::numeric_limits<int>::max() / 4;
+
+/** @class IncrementalAStarColli <plugins/colli/search/incremental_astar.h>
+ * Incremental A* search on the occupancy grid.
+ * This is D* Lite rooted at the robot cell. The robot stays in roughly the
+ * same grid cell between two colli loops, while the target and the grid
+ * costs change. The search tree of the previous loop is kept and only the
+ * vertices affected by changed cells are repaired. A moving target is
+ * handled by the key modifier of D* Lite, a moving robot requires a full
+ * search.
+ *
+ * Moves and costs are the same as in AStarColli: the four neighbours of a
+ * cell are reachable at the cost of the entered cell, occupied cells cannot
+ * be entered. All per-vertex data is allocated once for the whole grid.
+ */
+
+/** Constructor.
+ * @param occ_grid occupancy grid to search through
+ * @param logger The fawkes logger
+ * @param config The fawkes configuration
+ */
+IncrementalAStarColli::IncrementalAStarColli(LaserOccupancyGrid *occ_grid,
+                                             Logger             *logger,
+                                             Configuration      *config)
+: logger_(logger), occ_grid_(occ_grid)
+{
+	logger_->log_debug("IncrementalAStar", "(Constructor): Initializing");
+
+	max_changed_ratio_ = 0.25f;
+	try {
+		max_changed_ratio_ =
+		  config->get_float("/plugins/colli/search/a_star/incremental_max_changed_ratio");
+	} catch (Exception &e) {
+	} // ignored, use default
+
+	width_      = occ_grid_->get_width();
+	height_     = occ_grid_->get_height();
+	num_cells_  = width_ * height_;
+	cell_costs_ = occ_grid_->get_cell_costs();
+
+	root_   = -1;
+	target_ = -1;
+	km_     = 0;
+
+	costs_.resize(num_cells_, INF_COST);
+	g_.resize(num_cells_, INF_COST);
+	rhs_.resize(num_cells_, INF_COST);
+	keys_.resize(num_cells_);
+	heap_pos_.resize(num_cells_, -1);
+	heap_.reserve(num_cells_);
+	changed_.reserve(num_cells_);
+
+	logger_->log_debug("IncrementalAStar", "(Constructor): Initializing done");
+}
+
+/** Destructor. */
+IncrementalAStarColli::~IncrementalAStarColli()
+{
+}
+
+/** Search a path from the robot to the target position.
+ * The search tree of the previous call is reused if the robot did not
+ * move to another cell and not too many cells changed their costs.
+ * @param robo_pos The position of the robot in the grid
+ * @param target_pos The position of the target in the grid
+ * @param solution a vector that will be filled with the found path,
+ * empty if there is none
+ */
+void
+IncrementalAStarColli::solve(const point_t        &robo_pos,
+                             const point_t        &target_pos,
+                             std::vector<point_t> &solution)
+{
+	solution.clear();
+
+	if (robo_pos.x < 0 || robo_pos.x >= width_ || robo_pos.y < 0 || robo_pos.y >= height_
+	    || target_pos.x < 0 || target_pos.x >= width_ || target_pos.y < 0
+	    || target_pos.y >= height_) {
+		return;
+	}
+
+	int root   = robo_pos.x * height_ + robo_pos.y;
+	int target = target_pos.x * height_ + target_pos.y;
+
+	bool repair = update_costs() && (root == root_);
+
+	if (repair) {
+		if (target != target_) {
+			km_ += std::abs(target / height_ - target_ / height_)
+			       + std::abs(target % height_ - target_ % height_);
+			target_ = target;
+		}
+		for (int s : changed_)
+			update_vertex(s);
+	} else {
+		target_ = target;
+		reset(root);
+	}
+
+	compute_shortest_path();
+	get_solution_sequence(solution);
+}
+
+/* =========================================== */
+/* *************** PRIVATE PART ************** */
+/* =========================================== */
+
+/** Start over with an empty search tree rooted at the given vertex. */
+void
+IncrementalAStarColli::reset(int root)
+{
+	std::fill(g_.begin(), g_.end(), INF_COST);
+	std::fill(rhs_.begin(), rhs_.end(), INF_COST);
+	for (int s : heap_)
+		heap_pos_[s] = -1;
+	heap_.clear();
+
+	root_       = root;
+	km_         = 0;
+	rhs_[root_] = 0;
+	heap_insert(root_, calc_key(root_));
+}
+
+/** Read the cell costs from the grid and collect the changed cells.
+ * Returns false if so many cells changed that a full search is cheaper.
+ */
+bool
+IncrementalAStarColli::update_costs()
+{
+	changed_.clear();
+	for (int x = 0; x < width_; ++x) {
+		for (int y = 0; y < height_; ++y) {
+			float prob = occ_grid_->get_prob(x, y);
+			int   cost = (prob == cell_costs_.occ) ? INF_COST : (int)prob;
+			int   s    = x * height_ + y;
+			if (costs_[s] != cost) {
+				costs_[s] = cost;
+				changed_.push_back(s);
+			}
+		}
+	}
+	return changed_.size() <= max_changed_ratio_ * num_cells_;
+}
+
+/** Expand inconsistent vertices until the target is consistent and no
+ * vertex with a lower key is left.
+ */
+void
+IncrementalAStarColli::compute_shortest_path()
+{
+	while (!heap_.empty()
+	       && (key_less(keys_[heap_[0]], calc_key(target_)) || rhs_[target_] != g_[target_])) {
+		int u     = heap_[0];
+		Key k_old = keys_[u];
+		Key k_new = calc_key(u);
+
+		int x = u / height_;
+		int y = u % height_;
+
+		if (key_less(k_old, k_new)) {
+			heap_update(u, k_new);
+			continue;
+		}
+
+		if (g_[u] > rhs_[u]) {
+			g_[u] = rhs_[u];
+			heap_remove(u);
+		} else {
+			g_[u] = INF_COST;
+			update_vertex(u);
+		}
+
+		// the rhs values of all neighbours depend on g(u)
+		if (y > 0)
+			update_vertex(u - 1);
+		if (y < height_ - 1)
+			update_vertex(u + 1);
+		if (x > 0)
+			update_vertex(u - height_);
+		if (x < width_ - 1)
+			update_vertex(u + height_);
+	}
+}
+
+/** Recalculate the rhs value of a vertex and fix its heap membership. */
+void
+IncrementalAStarColli::update_vertex(int s)
+{
+	if (s != root_)
+		rhs_[s] = calc_rhs(s);
+
+	if (g_[s] != rhs_[s]) {
+		if (heap_pos_[s] >= 0)
+			heap_update(s, calc_key(s));
+		else
+			heap_insert(s, calc_key(s));
+	} else if (heap_pos_[s] >= 0) {
+		heap_remove(s);
+	}
+}
+
+/** One-step lookahead cost of a vertex based on its neighbours. */
+int
+IncrementalAStarColli::calc_rhs(int s) const
+{
+	if (costs_[s] >= INF_COST)
+		return INF_COST;
+
+	int x = s / height_;
+	int y = s % height_;
+
+	int min_g = INF_COST;
+	if (y > 0)
+		min_g = std::min(min_g, g_[s - 1]);
+	if (y < height_ - 1)
+		min_g = std::min(min_g, g_[s + 1]);
+	if (x > 0)
+		min_g = std::min(min_g, g_[s - height_]);
+	if (x < width_ - 1)
+		min_g = std::min(min_g, g_[s + height_]);
+
+	return (min_g >= INF_COST) ? INF_COST : min_g + costs_[s];
+}
+
+IncrementalAStarColli::Key
+IncrementalAStarColli::calc_key(int s) const
+{
+	int m = std::min(g_[s], rhs_[s]);
+	return Key{m + heuristic(s) + km_, m};
+}
+
+/** Manhattan distance to the target, the cheapest cell costs 1. */
+int
+IncrementalAStarColli::heuristic(int s) const
+{
+	return std::abs(s / height_ - target_ / height_) + std::abs(s % height_ - target_ % height_);
+}
+
+/** Follow the cheapest neighbours from the target back to the robot. */
+void
+IncrementalAStarColli::get_solution_sequence(std::vector<point_t> &solution) const
+{
+	if (g_[target_] >= INF_COST)
+		return;
+
+	int s = target_;
+	solution.push_back(point_t(s / height_, s % height_));
+	while (s != root_ && (int)solution.size() <= num_cells_) {
+		int x    = s / height_;
+		int y    = s % height_;
+		int next = -1;
+		int best = INF_COST;
+		if (y > 0 && g_[s - 1] < best)
+			best = g_[next = s - 1];
+		if (y < height_ - 1 && g_[s + 1] < best)
+			best = g_[next = s + 1];
+		if (x > 0 && g_[s - height_] < best)
+			best = g_[next = s - height_];
+		if (x < width_ - 1 && g_[s + height_] < best)
+			best = g_[next = s + height_];
+		if (next < 0) {
+			solution.clear();
+			return;
+		}
+		s = next;
+		solution.push_back(point_t(s / height_, s % height_));
+	}
+
+	if (s != root_) {
+		solution.clear();
+		return;
+	}
+	std::reverse(solution.begin(), solution.end());
+}
+
+void
+IncrementalAStarColli::heap_insert(int s, const Key &k)
+{
+	keys_[s]     = k;
+	heap_pos_[s] = heap_.size();
+	heap_.push_back(s);
+	heap_up(heap_pos_[s]);
+}
+
+void
+IncrementalAStarColli::heap_update(int s, const Key &k)
+{
+	bool decrease = key_less(k, keys_[s]);
+	keys_[s]      = k;
+	if (decrease)
+		heap_up(heap_pos_[s]);
+	else
+		heap_down(heap_pos_[s]);
+}
+
+void
+IncrementalAStarColli::heap_remove(int s)
+{
+	int pos = heap_pos_[s];
+	int end = heap_.size() - 1;
+	if (pos != end) {
+		heap_swap(pos, end);
+		heap_.pop_back();
+		heap_pos_[s] = -1;
+		heap_down(pos);
+		heap_up(pos);
+	} else {
+		heap_.pop_back();
+		heap_pos_[s] = -1;
+	}
+}
+
+void
+IncrementalAStarColli::heap_up(int pos)
+{
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+		if (!key_less(keys_[heap_[pos]], keys_[heap_[parent]]))
+			break;
+		heap_swap(pos, parent);
+		pos = parent;
+	}
+}
+
+void
+IncrementalAStarColli::heap_down(int pos)
+{
+	int size = heap_.size();
+	while (true) {
+		int child = 2 * pos + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && key_less(keys_[heap_[child + 1]], keys_[heap_[child]]))
+			++child;
+		if (!key_less(keys_[heap_[child]], keys_[heap_[pos]]))
+			break;
+		heap_swap(pos, child);
+		pos = child;
+	}
+}
+
+void
+IncrementalAStarColli::heap_swap(int a, int b)
+{
+	std::swap(heap_[a], heap_[b]);
+	heap_pos_[heap_[a]] = a;
+	heap_pos_[heap_[b]] = b;
+}
+
+} // namespace fawkes
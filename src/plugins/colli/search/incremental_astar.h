@@ -0,0 +1,106 @@
+
+/***************************************************************************
+ *  incremental_astar.h - Incremental A* (D* Lite) search implementation
+ *
+ *  Created: Thu Oct 15 04:11:43 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_COLLI_SEARCH_INCREMENTAL_ASTAR_H_
+#define _PLUGINS_COLLI_SEARCH_INCREMENTAL_ASTAR_H_
+
+#include "../common/types.h"
+
+#include <vector>
+
+namespace fawkes {
+
+class LaserOccupancyGrid;
+class Logger;
+class Configuration;
+
+typedef struct point_struct point_t;
+
+class IncrementalAStarColli
+{
+public:
+	IncrementalAStarColli(LaserOccupancyGrid *occ_grid, Logger *logger, Configuration *config);
+	~IncrementalAStarColli();
+
+	void solve(const point_t &robo_pos, const point_t &target_pos, std::vector<point_t> &solution);
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		int k1;
+		int k2;
+	} Key;
+	/// @endcond
+
+	void reset(int root);
+	bool update_costs();
+	void compute_shortest_path();
+	void update_vertex(int s);
+	int  calc_rhs(int s) const;
+	Key  calc_key(int s) const;
+	int  heuristic(int s) const;
+	void get_solution_sequence(std::vector<point_t> &solution) const;
+
+	static bool
+	key_less(const Key &a, const Key &b)
+	{
+		return (a.k1 < b.k1) || (a.k1 == b.k1 && a.k2 < b.k2);
+	}
+
+	// indexed binary heap over the vertices
+	void heap_insert(int s, const Key &k);
+	void heap_update(int s, const Key &k);
+	void heap_remove(int s);
+	void heap_up(int pos);
+	void heap_down(int pos);
+	void heap_swap(int a, int b);
+
+private:
+	Logger             *logger_;
+	LaserOccupancyGrid *occ_grid_;
+	int                 width_;
+	int                 height_;
+	int                 num_cells_;
+
+	colli_cell_cost_t cell_costs_;
+
+	// fraction of changed cells above which a full search is cheaper
+	float max_changed_ratio_;
+
+	int root_;
+	int target_;
+	int km_;
+
+	// per vertex data, allocated once for the whole grid
+	std::vector<int> costs_;
+	std::vector<int> g_;
+	std::vector<int> rhs_;
+	std::vector<Key> keys_;
+	std::vector<int> heap_pos_;
+	std::vector<int> heap_;
+	std::vector<int> changed_;
+};
+
+} // namespace fawkes
+
+#endif
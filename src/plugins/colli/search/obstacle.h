@@ -27,11 +27,21 @@
 
 #include <utils/math/common.h>
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
 namespace fawkes {
 
+/** A run of consecutive cells of an obstacle in one row of the grid. */
+typedef struct
+{
+	int          x;      /**< x offset of the row */
+	int          y;      /**< y offset of the first cell */
+	int          length; /**< number of cells */
+	unsigned int costs;  /**< index of the cost of the first cell in the span costs */
+} colli_obstacle_span_t;
+
 /** @class ColliFastObstacle <plugins/colli/search/obstacle.h>
  * This is an implementation of a a fast obstacle.
  */
@@ -46,12 +56,30 @@ public:
 	/** Return the occupied cells with their values
    * @return vector containing the occupied cells (alternating x and y coordinates)
    */
-	inline const std::vector<int>
-	get_obstacle()
+	inline const std::vector<int> &
+	get_obstacle() const
 	{
 		return occupied_cells_;
 	}
 
+	/** Get the occupied cells as runs along the rows of the grid.
+   * @return spans of occupied cells, ordered by x and y
+   */
+	inline const std::vector<colli_obstacle_span_t> &
+	get_spans() const
+	{
+		return spans_;
+	}
+
+	/** Get costs of the cells of the spans.
+   * @return costs, each span has its costs starting at colli_obstacle_span_t::costs
+   */
+	inline const std::vector<float> &
+	get_span_costs() const
+	{
+		return span_costs_;
+	}
+
 	/** Get the key
    * @return The key
    */
@@ -78,7 +106,44 @@ protected:
    */
 	std::vector<int> occupied_cells_;
 
+	/** Compute spans from the occupied cells, must be called by
+   * the constructors of derived classes after filling the cells. */
+	inline void
+	compute_spans()
+	{
+		std::vector<std::vector<int>::size_type> order;
+		for (std::vector<int>::size_type i = 0; i < occupied_cells_.size(); i += 3) {
+			order.push_back(i);
+		}
+		std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+			return (occupied_cells_[a] < occupied_cells_[b])
+			       || ((occupied_cells_[a] == occupied_cells_[b])
+			           && (occupied_cells_[a + 1] < occupied_cells_[b + 1]));
+		});
+
+		spans_.clear();
+		span_costs_.clear();
+		for (std::size_t i : order) {
+			int x = occupied_cells_[i];
+			int y = occupied_cells_[i + 1];
+			if (spans_.empty() || spans_.back().x != x
+			    || spans_.back().y + spans_.back().length != y) {
+				colli_obstacle_span_t span;
+				span.x      = x;
+				span.y      = y;
+				span.length = 0;
+				span.costs  = span_costs_.size();
+				spans_.push_back(span);
+			}
+			spans_.back().length += 1;
+			span_costs_.push_back(occupied_cells_[i + 2]);
+		}
+	}
+
 private:
+	std::vector<colli_obstacle_span_t> spans_;
+	std::vector<float>                 span_costs_;
+
 	// a unique identifier for each obstacle
 	int key_;
 };
@@ -134,6 +199,8 @@ inline ColliFastRectangle::ColliFastRectangle(int width, int height, colli_cell_
 			}
 		}
 	}
+
+	compute_spans();
 }
 
 /** Constructor for FastEllipse.
@@ -192,6 +259,8 @@ inline ColliFastEllipse::ColliFastEllipse(int                width,
 			}
 		}
 	}
+
+	compute_spans();
 }
 
 } // namespace fawkes
@@ -44,7 +44,11 @@ public:
 		obstacles_.clear();
 	}
 
-	const std::vector<int> get_obstacle(int width, int height, bool obstacle_increasement = true);
+	const std::vector<int> &
+	get_obstacle(int width, int height, bool obstacle_increasement = true);
+
+	const ColliFastObstacle *
+	get_fast_obstacle(int width, int height, bool obstacle_increasement = true);
 
 private:
 	std::map<unsigned int, ColliFastObstacle *> obstacles_;
@@ -68,8 +72,21 @@ inline ColliObstacleMap::ColliObstacleMap(colli_cell_cost_t cell_costs, bool is_
  * @param obstacle_increasement Enable obstacle increasement?
  * @return vector with pairwise cell coordinates (x,y), that are occupied by such an obstacle
  */
-inline const std::vector<int>
+inline const std::vector<int> &
 ColliObstacleMap::get_obstacle(int width, int height, bool obstacle_increasement)
+{
+	return get_fast_obstacle(width, height, obstacle_increasement)->get_obstacle();
+}
+
+/** Get the obstacle of the given size.
+ * The obstacle is created on first use and cached for later calls.
+ * @param width The width of the obstacle
+ * @param height The height of the obstacle
+ * @param obstacle_increasement Enable obstacle increasement?
+ * @return obstacle, owned by the map
+ */
+inline const ColliFastObstacle *
+ColliObstacleMap::get_fast_obstacle(int width, int height, bool obstacle_increasement)
 {
 	unsigned int key = ((unsigned int)width << 16) | (unsigned int)height;
 
@@ -83,11 +100,11 @@ ColliObstacleMap::get_obstacle(int width, int height, bool obstacle_increasement
 			obstacle = new ColliFastEllipse(width, height, cell_costs_, obstacle_increasement);
 		obstacle->set_key(key);
 		obstacles_[key] = obstacle;
-		return obstacle->get_obstacle();
+		return obstacle;
 
 	} else {
 		// obstacle found in p (previously created obstacles)
-		return obstacles_[key]->get_obstacle();
+		return p->second;
 	}
 }
 
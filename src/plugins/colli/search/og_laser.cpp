@@ -33,7 +33,9 @@
 #include <utils/math/coord.h>
 #include <utils/time/clock.h>
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
 
 namespace fawkes {
 
@@ -117,6 +119,13 @@ LaserOccupancyGrid::LaserOccupancyGrid(Laser360Interface *laser,
 	cfg_force_elipse_obstacle_ =
 	  config->get_bool((cfg_prefix + "laser_occupancy_grid/force_ellipse_obstacle").c_str());
 
+	cfg_max_dirty_ratio_ = 0.3f;
+	try {
+		cfg_max_dirty_ratio_ =
+		  config->get_float((cfg_prefix + "laser_occupancy_grid/max_dirty_ratio").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+
 	if_buffer_size_ = config->get_int((cfg_prefix + "laser_occupancy_grid/buffer_size").c_str());
 	if_buffer_size_ = std::max(
 	  if_buffer_size_,
@@ -137,6 +146,7 @@ LaserOccupancyGrid::LaserOccupancyGrid(Laser360Interface *laser,
 	robo_shape_.reset(new RoboShapeColli((cfg_prefix + "roboshape/").c_str(), logger, config));
 	old_readings_.clear();
 	init_grid();
+	grid_valid_ = false;
 
 	logger->log_debug("LaserOccupancyGrid", "Generating obstacle map");
 	bool obstacle_shape = robo_shape_->is_angular_robot() && !cfg_force_elipse_obstacle_;
@@ -285,25 +295,17 @@ void
 LaserOccupancyGrid::validate_old_laser_points(cart_coord_2d_t pos_robot,
                                               cart_coord_2d_t pos_new_laser_point)
 {
-	std::vector<LaserPoint> old_readings_tmp;
-
 	// vectors from robot to new and old laser-points
 	cart_coord_2d_t v_new(pos_new_laser_point.x - pos_robot.x, pos_new_laser_point.y - pos_robot.y);
-	cart_coord_2d_t v_old;
 
 	// distances from robot to new and old laser-points (i.e. length of v_new and v_old)
 	float d_new = sqrt(v_new.x * v_new.x + v_new.y * v_new.y);
 
-	// angle between the two vectors v_new and v_old. Use to determine whether they
-	// belong to the same laser-beam
-	float angle = 0.f;
-
 	static const float deg_unit = M_PI / 180.f; // 1 degree
 
-	for (std::vector<LaserPoint>::iterator it = old_readings_.begin(); it != old_readings_.end();
-	     ++it) {
-		v_old.x = (*it).coord.x - pos_robot.x;
-		v_old.y = (*it).coord.y - pos_robot.y;
+	// the history is filtered in place, this is called for every new reading
+	auto discard = [&](const LaserPoint &old_point) {
+		cart_coord_2d_t v_old(old_point.coord.x - pos_robot.x, old_point.coord.y - pos_robot.y);
 
 		// need to calculate distance here, needed for angle calculation
 		float d_old = sqrt(v_old.x * v_old.x + v_old.y * v_old.y);
@@ -312,31 +314,21 @@ LaserOccupancyGrid::validate_old_laser_points(cart_coord_2d_t pos_robot,
 		if (d_new <= d_old + obstacle_distance_) {
 			// in case both points belonged to the same laser-beam, p_old
 			// would be in shadow of p_new => keep p_old anyway
-			old_readings_tmp.push_back(*it);
-			continue;
+			return false;
 		}
 
 		// angle a between to vectors v,w: cos(a) = dot(v,w) / (|v|*|w|)
-		angle = acos((v_old.x * v_new.x + v_old.y * v_new.y) / (d_new * d_old));
-		if (std::isnan(angle) || angle > deg_unit) {
-			// p_old is not the range of this laser-beam. Keep it.
-			old_readings_tmp.push_back(*it);
-
-			/* No "else" here. It would mean that p_old is in the range of the
-       * same laser beam. And we already know that
-       * "d_new > d_old + obstacle_distance_" => this laser beam can see
-       * through p_old => discard p_old. In other words, do not add to
-       * old_readings_tmp.
-       */
-		}
-	}
+		float angle = acos((v_old.x * v_new.x + v_old.y * v_new.y) / (d_new * d_old));
 
-	old_readings_.clear();
-	old_readings_.reserve(old_readings_tmp.size());
+		/* If p_old is in the range of the same laser beam, we already know that
+     * "d_new > d_old + obstacle_distance_" => this laser beam can see
+     * through p_old => discard p_old. Otherwise keep it.
+     */
+		return !(std::isnan(angle) || angle > deg_unit);
+	};
 
-	for (unsigned int i = 0; i < old_readings_tmp.size(); ++i) {
-		old_readings_.push_back(old_readings_tmp[i]);
-	}
+	old_readings_.erase(std::remove_if(old_readings_.begin(), old_readings_.end(), discard),
+	                    old_readings_.end());
 }
 
 float
@@ -389,10 +381,6 @@ LaserOccupancyGrid::update_occ_grid(int midX, int midY, float inc, float vx, flo
 	laser_pos_.x = midX;
 	laser_pos_.y = midY;
 
-	for (int y = 0; y < width_; ++y)
-		for (int x = 0; x < height_; ++x)
-			occupancy_probs_[x][y] = cell_costs_.free;
-
 	update_laser();
 
 	tf::StampedTransform transform;
@@ -405,43 +393,42 @@ LaserOccupancyGrid::update_occ_grid(int midX, int midY, float inc, float vx, flo
 		                   "Unable to transform %s to %s. Can't put obstacles into the grid",
 		                   reference_frame_.c_str(),
 		                   laser_frame_.c_str());
+		std::fill(occupancy_probs_.begin(), occupancy_probs_.end(), cell_costs_.free);
+		prev_stamps_.clear();
+		grid_valid_ = true;
 		return 0.;
 	}
 
+	stamps_.clear();
 	integrate_old_readings(midX, midY, inc, vel, transform);
 	integrate_new_readings(midX, midY, inc, vel, transform);
+	draw_obstacles();
 
 	return next_obstacle;
 }
 
 /**
  * Transforms all given points with the given transform
- * @param laserPoints vector of LaserPoint, that contains the points to transform
+ * @param laser_points vector of LaserPoint, that contains the points to transform
  * @param transform stamped transform, the transform to transform with
- * @return the transformed laserPoints
+ * @param transformed vector that is filled with the transformed points
  */
-std::vector<LaserOccupancyGrid::LaserPoint> *
-LaserOccupancyGrid::transform_laser_points(std::vector<LaserOccupancyGrid::LaserPoint> &laserPoints,
-                                           tf::StampedTransform &                       transform)
+void
+LaserOccupancyGrid::transform_laser_points(const std::vector<LaserPoint> &laser_points,
+                                           tf::StampedTransform &         transform,
+                                           std::vector<LaserPoint> &      transformed)
 {
-	int                                          count_points = laserPoints.size();
-	std::vector<LaserOccupancyGrid::LaserPoint> *laserPointsTransformed =
-	  new std::vector<LaserOccupancyGrid::LaserPoint>();
-	laserPointsTransformed->reserve(count_points);
+	transformed.resize(laser_points.size());
 
 	tf::Point p;
 
-	for (int i = 0; i < count_points; ++i) {
-		p.setValue(laserPoints[i].coord.x, laserPoints[i].coord.y, 0.);
+	for (unsigned int i = 0; i < laser_points.size(); ++i) {
+		p.setValue(laser_points[i].coord.x, laser_points[i].coord.y, 0.);
 		p = transform * p;
 
-		LaserOccupancyGrid::LaserPoint point;
-		point.coord     = cart_coord_2d_struct(p.getX(), p.getY());
-		point.timestamp = laserPoints[i].timestamp;
-		laserPointsTransformed->push_back(point);
+		transformed[i].coord     = cart_coord_2d_struct(p.getX(), p.getY());
+		transformed[i].timestamp = laser_points[i].timestamp;
 	}
-
-	return laserPointsTransformed;
 }
 
 /** Get the laser's position in the grid
@@ -480,21 +467,19 @@ LaserOccupancyGrid::integrate_old_readings(int                   midX,
                                            float                 vel,
                                            tf::StampedTransform &transform)
 {
-	std::vector<LaserOccupancyGrid::LaserPoint> old_readings;
-	old_readings.reserve(old_readings_.size());
-	std::vector<LaserOccupancyGrid::LaserPoint> *pointsTransformed =
-	  transform_laser_points(old_readings_, transform);
+	transform_laser_points(old_readings_, transform, transformed_);
 
-	float newpos_x, newpos_y;
+	float        newpos_x, newpos_y;
+	unsigned int num_kept = 0;
 
 	Clock *clock   = Clock::instance();
 	Time   history = Time(clock) - Time(double(std::max(min_history_length_, max_history_length_)));
 
 	// update all old readings
-	for (unsigned int i = 0; i < pointsTransformed->size(); ++i) {
-		if ((*pointsTransformed)[i].timestamp.in_sec() >= history.in_sec()) {
-			newpos_x = (*pointsTransformed)[i].coord.x;
-			newpos_y = (*pointsTransformed)[i].coord.y;
+	for (unsigned int i = 0; i < transformed_.size(); ++i) {
+		if (transformed_[i].timestamp.in_sec() >= history.in_sec()) {
+			newpos_x = transformed_[i].coord.x;
+			newpos_y = transformed_[i].coord.y;
 
 			//newpos_x =  old_readings_[i].coord.x + xref;
 			//newpos_y =  old_readings_[i].coord.y + yref;
@@ -519,7 +504,7 @@ LaserOccupancyGrid::integrate_old_readings(int                   midX,
 			int posX = midX + (int)((newpos_x * 100.f) / ((float)cell_height_));
 			int posY = midY + (int)((newpos_y * 100.f) / ((float)cell_width_));
 			if (posX > 4 && posX < height_ - 5 && posY > 4 && posY < width_ - 5) {
-				old_readings.push_back(old_readings_[i]);
+				old_readings_[num_kept++] = old_readings_[i];
 
 				// 25 cm's in my opinion, that are here: 0.25*100/cell_width_
 				//int size = (int)(((0.25f+inc)*100.f)/(float)cell_width_);
@@ -527,20 +512,14 @@ LaserOccupancyGrid::integrate_old_readings(int                   midX,
 				width        = std::max(4.f, ((width + inc) * 100.f) / cell_width_);
 				float height = robo_shape_->get_complete_width_x();
 				height       = std::max(4.f, ((height + inc) * 100.f) / cell_height_);
-				integrate_obstacle(posX, posY, width, height);
+				add_obstacle(posX, posY, width, height);
 			}
 			//}
 		}
 	}
 
-	old_readings_.clear();
-	old_readings_.reserve(old_readings.size());
-
-	// integrate the new calculated old readings
-	for (unsigned int i = 0; i < old_readings.size(); i++)
-		old_readings_.push_back(old_readings[i]);
-
-	delete pointsTransformed;
+	// keep the still valid old readings, compacted in place
+	old_readings_.resize(num_kept);
 }
 
 void
@@ -550,11 +529,9 @@ LaserOccupancyGrid::integrate_new_readings(int                   midX,
                                            float                 vel,
                                            tf::StampedTransform &transform)
 {
-	std::vector<LaserOccupancyGrid::LaserPoint> *pointsTransformed =
-	  transform_laser_points(new_readings_, transform);
+	transform_laser_points(new_readings_, transform, transformed_);
 
-	int numberOfReadings = pointsTransformed->size();
-	//TODO resize, reserve??
+	int numberOfReadings = transformed_.size();
 
 	int             posX, posY;
 	cart_coord_2d_t point;
@@ -562,7 +539,7 @@ LaserOccupancyGrid::integrate_new_readings(int                   midX,
 	float           oldp_y = 1000.f;
 
 	for (int i = 0; i < numberOfReadings; i++) {
-		point = (*pointsTransformed)[i].coord;
+		point = transformed_[i].coord;
 
 		if (sqrt(sqr(point.x) + sqr(point.y)) >= min_laser_length_
 		    && distance(point.x, point.y, oldp_x, oldp_y) >= obstacle_distance_) {
@@ -578,33 +555,136 @@ LaserOccupancyGrid::integrate_new_readings(int                   midX,
 				float height = robo_shape_->get_complete_width_x();
 				height       = std::max(4.f, ((height + inc) * 100.f) / cell_height_);
 
-				integrate_obstacle(posX, posY, width, height);
+				add_obstacle(posX, posY, width, height);
 
 				old_readings_.push_back(new_readings_[i]);
 			}
 		}
 	}
-	delete pointsTransformed;
 }
 
 void
-LaserOccupancyGrid::integrate_obstacle(int x, int y, int width, int height)
+LaserOccupancyGrid::add_obstacle(int x, int y, int width, int height)
 {
-	std::vector<int> fast_obstacle = obstacle_map_->get_obstacle(width, height, cfg_obstacle_inc_);
-
-	// i = x offset, i+1 = y offset, i+2 is cost
-	for (unsigned int i = 0; i < fast_obstacle.size(); i += 3) {
-		/* On the laser-points, we draw obstacles based on base_link. The obstacle has the robot-shape,
-     * which means that we need to rotate the shape 180° around base_link and move that rotation-
-     * point onto the laser-point on the grid. That's the same as adding the center_to_base_offset
-     * to the calculated position of the obstacle-center ("x + fast_obstacle[i]" and "y" respectively).
-     */
-		int posX = x + fast_obstacle[i] + offset_base_.x;
-		int posY = y + fast_obstacle[i + 1] + offset_base_.y;
+	ObstacleStamp stamp;
+
+	/* On the laser-points, we draw obstacles based on base_link. The obstacle has the robot-shape,
+   * which means that we need to rotate the shape 180° around base_link and move that rotation-
+   * point onto the laser-point on the grid. That's the same as adding the center_to_base_offset
+   * to the calculated position of the obstacle-center ("x + span.x" and "y" respectively).
+   */
+	stamp.x        = x + offset_base_.x;
+	stamp.y        = y + offset_base_.y;
+	stamp.width    = width;
+	stamp.height   = height;
+	stamp.obstacle = obstacle_map_->get_fast_obstacle(width, height, cfg_obstacle_inc_);
+
+	const std::vector<colli_obstacle_span_t> &spans = stamp.obstacle->get_spans();
+	stamp.x_min = stamp.y_min = 0;
+	stamp.x_max = stamp.y_max = 0;
+	if (!spans.empty()) {
+		// spans are ordered by x
+		stamp.x_min = stamp.x + spans.front().x;
+		stamp.x_max = stamp.x + spans.back().x + 1;
+		stamp.y_min = stamp.y + spans.front().y;
+		stamp.y_max = stamp.y_min;
+		for (const colli_obstacle_span_t &span : spans) {
+			stamp.y_min = std::min(stamp.y_min, stamp.y + span.y);
+			stamp.y_max = std::max(stamp.y_max, stamp.y + span.y + span.length);
+		}
+	}
+
+	stamps_.push_back(stamp);
+}
+
+/* The grid is completely determined by the set of obstacles drawn into it.
+ * While the robot does not move in the grid, most obstacles are the same
+ * as in the previous update. Then only the bounding boxes of the obstacles
+ * that appeared or disappeared are cleared and all obstacles overlapping
+ * them are redrawn within the box. If too many obstacles changed, the
+ * whole grid is redrawn.
+ */
+void
+LaserOccupancyGrid::draw_obstacles()
+{
+	std::sort(stamps_.begin(), stamps_.end());
+	stamps_.erase(std::unique(stamps_.begin(), stamps_.end()), stamps_.end());
+
+	changed_stamps_.clear();
+	std::set_symmetric_difference(prev_stamps_.begin(),
+	                              prev_stamps_.end(),
+	                              stamps_.begin(),
+	                              stamps_.end(),
+	                              std::back_inserter(changed_stamps_));
+
+	// cells outside of these bounds are never drawn
+	const int grid_x_min = 1;
+	const int grid_x_max = height_;
+	const int grid_y_min = 1;
+	const int grid_y_max = width_;
+
+	if (!grid_valid_
+	    || changed_stamps_.size()
+	         > cfg_max_dirty_ratio_ * std::max(stamps_.size(), prev_stamps_.size())) {
+		std::fill(occupancy_probs_.begin(), occupancy_probs_.end(), cell_costs_.free);
+		for (const ObstacleStamp &stamp : stamps_)
+			integrate_obstacle(stamp, grid_x_min, grid_x_max, grid_y_min, grid_y_max);
+
+	} else {
+		for (const ObstacleStamp &dirty : changed_stamps_) {
+			int x_min = std::max(dirty.x_min, grid_x_min);
+			int x_max = std::min(dirty.x_max, grid_x_max);
+			int y_min = std::max(dirty.y_min, grid_y_min);
+			int y_max = std::min(dirty.y_max, grid_y_max);
+			if (x_min >= x_max || y_min >= y_max)
+				continue;
+
+			for (int x = x_min; x < x_max; ++x)
+				std::fill(row(x) + y_min, row(x) + y_max, (Probability)cell_costs_.free);
+
+			for (const ObstacleStamp &stamp : stamps_) {
+				if (stamp.x_min < x_max && stamp.x_max > x_min && stamp.y_min < y_max
+				    && stamp.y_max > y_min) {
+					integrate_obstacle(stamp, x_min, x_max, y_min, y_max);
+				}
+			}
+		}
+	}
+
+	grid_valid_ = true;
+	prev_stamps_.swap(stamps_);
+}
+
+void
+LaserOccupancyGrid::integrate_obstacle(const ObstacleStamp &stamp,
+                                       int                  x_min,
+                                       int                  x_max,
+                                       int                  y_min,
+                                       int                  y_max)
+{
+	const std::vector<colli_obstacle_span_t> &spans = stamp.obstacle->get_spans();
+	const float *                             costs = stamp.obstacle->get_span_costs().data();
+
+	// Blit the obstacle row by row, keeping the higher cost per cell
+	for (const colli_obstacle_span_t &span : spans) {
+		int posX = stamp.x + span.x;
+		if ((posX < x_min) || (posX >= x_max))
+			continue;
+
+		int y_begin = stamp.y + span.y;
+		int y_end   = y_begin + span.length;
+		int skip    = 0;
+		if (y_begin < y_min) {
+			skip    = y_min - y_begin;
+			y_begin = y_min;
+		}
+		if (y_end > y_max)
+			y_end = y_max;
 
-		if ((posX > 0) && (posX < height_) && (posY > 0) && (posY < width_)
-		    && (occupancy_probs_[posX][posY] < fast_obstacle[i + 2])) {
-			occupancy_probs_[posX][posY] = fast_obstacle[i + 2];
+		Probability *cells      = row(posX) + y_begin;
+		const float *span_costs = costs + span.costs + skip;
+		for (int i = 0; i < y_end - y_begin; ++i) {
+			cells[i] = std::max(cells[i], span_costs[i]);
 		}
 	}
 }
@@ -39,6 +39,7 @@ namespace fawkes {
 class Laser360Interface;
 class RoboShapeColli;
 class ColliObstacleMap;
+class ColliFastObstacle;
 
 class Logger;
 class Configuration;
@@ -92,14 +93,43 @@ private:
 		//    }
 	};
 
+	/** An obstacle put into the grid, with everything needed to draw it again */
+	class ObstacleStamp
+	{
+	public:
+		int                      x;        /**< x coordinate of obstacle center in the grid */
+		int                      y;        /**< y coordinate of obstacle center in the grid */
+		int                      width;    /**< total width of obstacle */
+		int                      height;   /**< total height of obstacle */
+		const ColliFastObstacle *obstacle; /**< the obstacle shape */
+		int                      x_min;    /**< first row of the occupied cells */
+		int                      x_max;    /**< row after the occupied cells */
+		int                      y_min;    /**< first column of the occupied cells */
+		int                      y_max;    /**< column after the occupied cells */
+
+		bool
+		operator<(const ObstacleStamp &o) const
+		{
+			return (x < o.x) || (x == o.x && y < o.y) || (x == o.x && y == o.y && width < o.width)
+			       || (x == o.x && y == o.y && width == o.width && height < o.height);
+		}
+
+		bool
+		operator==(const ObstacleStamp &o) const
+		{
+			return x == o.x && y == o.y && width == o.width && height == o.height;
+		}
+	};
+
 	void update_laser();
 
 	float obstacle_in_path_distance(float vx, float vy);
 
 	void validate_old_laser_points(cart_coord_2d_t pos_robot, cart_coord_2d_t pos_new_laser_point);
 
-	std::vector<LaserPoint> *transform_laser_points(std::vector<LaserPoint> &laser_points,
-	                                                tf::StampedTransform &   transform);
+	void transform_laser_points(const std::vector<LaserPoint> &laser_points,
+	                            tf::StampedTransform &         transform,
+	                            std::vector<LaserPoint> &      transformed);
 
 	/** Integrate historical readings to the current occgrid. */
 	void integrate_old_readings(int                   mid_x,
@@ -115,13 +145,25 @@ private:
 	                            float                 vel,
 	                            tf::StampedTransform &transform);
 
-	/** Integrate a single obstacle
+	/** Add a single obstacle to the obstacles of this update
    * @param x x coordinate of obstacle center
    * @param y y coordinate of obstacle center
    * @param width total width of obstacle
    * @param height total height of obstacle
    */
-	void integrate_obstacle(int x, int y, int width, int height);
+	void add_obstacle(int x, int y, int width, int height);
+
+	/** Bring the grid up to date with the obstacles of this update. */
+	void draw_obstacles();
+
+	/** Integrate a single obstacle, restricted to a region of the grid
+   * @param stamp the obstacle
+   * @param x_min first row of the region
+   * @param x_max row after the region
+   * @param y_min first column of the region
+   * @param y_max column after the region
+   */
+	void integrate_obstacle(const ObstacleStamp &stamp, int x_min, int x_max, int y_min, int y_max);
 
 	tf::Transformer *tf_listener_;
 	std::string      reference_frame_;
@@ -135,6 +177,13 @@ private:
 
 	std::vector<LaserPoint> new_readings_;
 	std::vector<LaserPoint> old_readings_; /**< readings history */
+	std::vector<LaserPoint> transformed_;  /**< readings in laser frame */
+
+	std::vector<ObstacleStamp> stamps_;         /**< obstacles of this update */
+	std::vector<ObstacleStamp> prev_stamps_;    /**< obstacles currently in the grid */
+	std::vector<ObstacleStamp> changed_stamps_; /**< obstacles added or removed */
+	bool                       grid_valid_;     /**< grid contains exactly prev_stamps_ */
+	float                      cfg_max_dirty_ratio_; /**< max changed obstacles for partial redraw */
 
 	point_t laser_pos_; /**< the laser's position in the grid */
 
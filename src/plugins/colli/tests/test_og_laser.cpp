@@ -0,0 +1,277 @@
+/***************************************************************************
+ *  test_og_laser.cpp - LaserOccupancyGrid partial redraw test
+ *
+ *  Created: Thu Oct 15 10:11:46 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "../search/og_laser.h"
+
+#include <blackboard/bbconfig.h>
+#include <blackboard/local.h>
+#include <config/memory.h>
+#include <interfaces/Laser360Interface.h>
+#include <logging/cache.h>
+#include <tf/transformer.h>
+#include <utils/time/clock.h>
+#include <utils/time/timesource.h>
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+
+/** Simulated time, advanced explicitly by the test. */
+class SimTimeSource : public TimeSource
+{
+public:
+	SimTimeSource()
+	{
+		now_.tv_sec  = 1000;
+		now_.tv_usec = 0;
+	}
+
+	void
+	advance(long usec)
+	{
+		now_.tv_usec += usec;
+		now_.tv_sec += now_.tv_usec / 1000000;
+		now_.tv_usec %= 1000000;
+	}
+
+	virtual void
+	get_time(timeval *tv) const
+	{
+		*tv = now_;
+	}
+
+	virtual timeval
+	conv_to_realtime(const timeval *tv) const
+	{
+		return *tv;
+	}
+
+	virtual timeval
+	conv_native_to_exttime(const timeval *tv) const
+	{
+		return *tv;
+	}
+
+private:
+	timeval now_;
+};
+
+/** Circular obstacle in the odometry frame. */
+struct Circle
+{
+	float x;
+	float y;
+	float radius;
+	bool  present;
+};
+
+/** Simulate a laser scan in a square room with circular obstacles.
+ * @param pose_x robot x position in the room
+ * @param pose_y robot y position in the room
+ * @param pose_yaw robot orientation
+ * @param circles obstacles in the room
+ * @param distances upon return contains the 360 beam distances
+ */
+void
+simulate_scan(float                      pose_x,
+              float                      pose_y,
+              float                      pose_yaw,
+              const std::vector<Circle> &circles,
+              float *                    distances)
+{
+	const float room = 2.5f;
+	for (unsigned int i = 0; i < 360; ++i) {
+		float a  = pose_yaw + i * M_PI / 180.f;
+		float dx = std::cos(a);
+		float dy = std::sin(a);
+
+		float d = 100.f;
+		if (dx > 0)
+			d = std::min(d, (room - pose_x) / dx);
+		if (dx < 0)
+			d = std::min(d, (-room - pose_x) / dx);
+		if (dy > 0)
+			d = std::min(d, (room - pose_y) / dy);
+		if (dy < 0)
+			d = std::min(d, (-room - pose_y) / dy);
+
+		for (const Circle &c : circles) {
+			if (!c.present)
+				continue;
+			float ox   = c.x - pose_x;
+			float oy   = c.y - pose_y;
+			float t    = ox * dx + oy * dy;
+			float disc = t * t - (ox * ox + oy * oy - c.radius * c.radius);
+			if (t > 0 && disc >= 0) {
+				d = std::min(d, t - std::sqrt(disc));
+			}
+		}
+		// some beams have no valid reading
+		distances[i] = (i % 17 == 0) ? 0.f : d;
+	}
+}
+
+void
+configure(MemoryConfiguration &config)
+{
+	const std::string p = "/plugins/colli/";
+	config.set_bool((p + "write_spam_debug").c_str(), false);
+	config.set_bool((p + "obstacle_increasement").c_str(), true);
+	config.set_string((p + "frame/odometry").c_str(), "odom");
+	config.set_string((p + "frame/laser").c_str(), "base_laser");
+	config.set_float((p + "laser/min_reading_length").c_str(), 0.02f);
+	config.set_float((p + "emergency_stopping/beams_used").c_str(), 11.f);
+
+	config.set_int((p + "roboshape/shape").c_str(), 1);
+	config.set_float((p + "roboshape/angular/width_x").c_str(), 0.38f);
+	config.set_float((p + "roboshape/angular/width_y").c_str(), 0.4f);
+	config.set_float((p + "roboshape/angular/laser_offset_x_from_back").c_str(), 0.062f);
+	config.set_float((p + "roboshape/angular/laser_offset_y_from_left").c_str(), 0.2f);
+	config.set_float((p + "roboshape/extension/front").c_str(), 0.2f);
+	config.set_float((p + "roboshape/extension/right").c_str(), 0.02f);
+	config.set_float((p + "roboshape/extension/back").c_str(), 0.05f);
+	config.set_float((p + "roboshape/extension/left").c_str(), 0.02f);
+
+	const std::string g = p + "laser_occupancy_grid/";
+	config.set_float((g + "distance_account").c_str(), 0.1f);
+	config.set_bool((g + "force_ellipse_obstacle").c_str(), false);
+	config.set_int((g + "history/initial_size").c_str(), 500);
+	config.set_float((g + "history/max_length").c_str(), 1.0f);
+	config.set_float((g + "history/min_length").c_str(), 0.5f);
+	config.set_bool((g + "history/delete_invisible_old_obstacles/enable").c_str(), true);
+	config.set_int((g + "history/delete_invisible_old_obstacles/angle_min").c_str(), 280);
+	config.set_int((g + "history/delete_invisible_old_obstacles/angle_max").c_str(), 80);
+	config.set_int((g + "buffer_size").c_str(), 2);
+	config.set_int((g + "cell_cost/occupied").c_str(), 1000);
+	config.set_int((g + "cell_cost/near").c_str(), 4);
+	config.set_int((g + "cell_cost/mid").c_str(), 3);
+	config.set_int((g + "cell_cost/far").c_str(), 2);
+	config.set_int((g + "cell_cost/free").c_str(), 1);
+}
+
+} // namespace
+
+TEST_CASE("Partial redraw matches full redraw", "[colli][og_laser]")
+{
+	SimTimeSource time_source;
+	Clock *       clock = Clock::instance();
+	clock->register_ext_timesource(&time_source, /* make default */ true);
+
+	MemoryConfiguration config;
+	CacheLogger         logger;
+	tf::Transformer     transformer;
+	LocalBlackBoard     blackboard(BLACKBOARD_MEMSIZE);
+	configure(config);
+
+	Laser360Interface *laser_writer = blackboard.open_for_writing<Laser360Interface>("Laser");
+	Laser360Interface *laser_full   = blackboard.open_for_reading<Laser360Interface>("Laser");
+	Laser360Interface *laser_part   = blackboard.open_for_reading<Laser360Interface>("Laser");
+
+	// a ratio of zero redraws the whole grid on any change, a large ratio
+	// always redraws only the changed regions
+	config.set_float("/plugins/colli/laser_occupancy_grid/max_dirty_ratio", 0.f);
+	LaserOccupancyGrid grid_full(laser_full, &logger, &config, &transformer);
+	config.set_float("/plugins/colli/laser_occupancy_grid/max_dirty_ratio", 1000.f);
+	LaserOccupancyGrid grid_part(laser_part, &logger, &config, &transformer);
+	grid_full.set_base_offset(0.1f, 0.f);
+	grid_part.set_base_offset(0.1f, 0.f);
+
+	std::mt19937                          gen(42);
+	std::uniform_real_distribution<float> pos(-2.f, 2.f);
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+	std::vector<Circle> circles;
+	for (unsigned int i = 0; i < 8; ++i) {
+		circles.push_back(Circle{pos(gen), pos(gen), 0.05f + 0.2f * unit(gen), unit(gen) < 0.5f});
+	}
+
+	float pose_x   = 0.f;
+	float pose_y   = 0.f;
+	float pose_yaw = 0.f;
+	int   mid_x    = 75;
+	int   mid_y    = 75;
+
+	float        distances[360];
+	unsigned int num_occupied = 0;
+
+	for (unsigned int step = 0; step < 300; ++step) {
+		time_source.advance(100000);
+
+		// obstacles appear and disappear, the robot moves now and then
+		if (unit(gen) < 0.5f) {
+			Circle &c = circles[gen() % circles.size()];
+			c.present = !c.present;
+		}
+		if (step % 40 == 39) {
+			pose_x += 0.2f * (unit(gen) - 0.5f);
+			pose_y += 0.2f * (unit(gen) - 0.5f);
+			pose_yaw += 0.5f * (unit(gen) - 0.5f);
+		}
+		if (step % 70 == 69) {
+			mid_x += (int)(gen() % 5) - 2;
+			mid_y += (int)(gen() % 5) - 2;
+		}
+
+		Time now(clock);
+		transformer.set_transform(
+		  tf::StampedTransform(tf::Transform(tf::create_quaternion_from_yaw(pose_yaw),
+		                                     tf::Vector3(pose_x, pose_y, 0.)),
+		                       now,
+		                       "odom",
+		                       "base_laser"),
+		  "test");
+
+		simulate_scan(pose_x, pose_y, pose_yaw, circles, distances);
+		laser_writer->set_distances(distances);
+		laser_writer->set_frame("base_laser");
+		laser_writer->set_timestamp(&now);
+		laser_writer->write();
+
+		float inc       = (step % 3) * 0.02f;
+		float next_full = grid_full.update_occ_grid(mid_x, mid_y, inc, 0.3f, 0.f);
+		float next_part = grid_part.update_occ_grid(mid_x, mid_y, inc, 0.3f, 0.f);
+		REQUIRE(next_full == next_part);
+
+		unsigned int num_diff = 0;
+		for (int x = 0; x < grid_full.get_height(); ++x) {
+			for (int y = 0; y < grid_full.get_width(); ++y) {
+				if (grid_full.get_prob(x, y) != grid_part.get_prob(x, y))
+					++num_diff;
+				if (grid_full.get_prob(x, y) == 1000.f)
+					++num_occupied;
+			}
+		}
+		INFO("step " << step);
+		REQUIRE(num_diff == 0);
+	}
+	// the scene must actually have put obstacles into the grid
+	REQUIRE(num_occupied > 0);
+
+	blackboard.close(laser_writer);
+	blackboard.close(laser_full);
+	blackboard.close(laser_part);
+	clock->remove_ext_timesource(&time_source);
+}
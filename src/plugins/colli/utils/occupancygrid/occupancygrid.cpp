@@ -22,6 +22,8 @@
 
 #include "occupancygrid.h"
 
+#include <algorithm>
+
 namespace fawkes {
 
 /** @class OccupancyGrid <plugins/colli/utils/occupancygrid/occupancygrid.h>
@@ -128,18 +130,6 @@ OccupancyGrid::set_height(int height)
 	init_grid();
 }
 
-/** Reset the occupancy probability of a cell
- * @param x the x-position of the cell
- * @param y the y-position of the cell
- * @param prob the occupancy probability of cell (x,y)
- */
-void
-OccupancyGrid::set_prob(int x, int y, Probability prob)
-{
-	if ((x < width_) && (y < height_) && ((isProb(prob)) || (prob == 2.f)))
-		occupancy_probs_[x][y] = prob;
-}
-
 /** Resets all occupancy probabilities
  * @param prob the occupancy probability the grid will become filled with
  */
@@ -147,49 +137,15 @@ void
 OccupancyGrid::fill(Probability prob)
 {
 	if ((isProb(prob)) || (prob == -1.f)) {
-		for (int x = 0; x < width_; x++) {
-			for (int y = 0; y < height_; y++) {
-				occupancy_probs_[x][y] = prob;
-			}
-		}
-	}
-}
-
-/** Get the occupancy probability of a cell
- * @param x the x-position of the cell
- * @param y the y-position of the cell
- * @return the occupancy probability of cell (x,y)
- */
-Probability
-OccupancyGrid::get_prob(int x, int y)
-{
-	if ((x >= 0) && (x < width_) && (y >= 0) && (y < height_)) {
-		return occupancy_probs_[x][y];
-	} else {
-		return 1;
+		std::fill(occupancy_probs_.begin(), occupancy_probs_.end(), prob);
 	}
 }
 
-/** Operator (), get occupancy probability of a cell
- * @param x the x-position of the cell
- * @param y the y-position of the cell
- * @return the occupancy probability of cell (x,y)
- */
-Probability &
-OccupancyGrid::operator()(const int x, const int y)
-{
-	return occupancy_probs_[x][y];
-}
-
 /** Init a new empty grid with the predefined parameters */
 void
 OccupancyGrid::init_grid()
 {
-	occupancy_probs_.clear();
-	std::vector<Probability> column;
-	column.resize(height_, 0.f);
-	occupancy_probs_.resize(width_, column);
-	fill(0.f);
+	occupancy_probs_.assign((size_t)width_ * height_, 0.f);
 }
 
 } // namespace fawkes
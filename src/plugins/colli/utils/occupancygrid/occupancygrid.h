@@ -63,7 +63,7 @@ public:
 	void set_height(int height);
 
 	///\brief Reset the occupancy probability of a cell
-	virtual void set_prob(int x, int y, Probability prob);
+	void set_prob(int x, int y, Probability prob);
 
 	///\brief Resets all occupancy probabilities
 	void fill(Probability prob);
@@ -74,11 +74,15 @@ public:
 	///\brief Get the occupancy probability of a cell
 	Probability &operator()(const int x, const int y);
 
+	///\brief Get the cells of a row of the grid
+	Probability *row(int x);
+
 	///\brief Init a new empty grid with the predefined parameters */
 	void init_grid();
 
-	/// The occupancy probability of the cells in a 2D array
-	std::vector<std::vector<Probability>> occupancy_probs_;
+	/// The occupancy probability of the cells, stored contiguously row
+	/// by row. A row contains the cells of one x coordinate.
+	std::vector<Probability> occupancy_probs_;
 
 protected:
 	int cell_width_;  /**< Cell width in cm */
@@ -87,6 +91,55 @@ protected:
 	int height_;      /**< Height of the grid in # cells */
 };
 
+/** Reset the occupancy probability of a cell
+ * @param x the x-position of the cell
+ * @param y the y-position of the cell
+ * @param prob the occupancy probability of cell (x,y)
+ */
+inline void
+OccupancyGrid::set_prob(int x, int y, Probability prob)
+{
+	if ((x >= 0) && (x < width_) && (y >= 0) && (y < height_) && ((isProb(prob)) || (prob == 2.f)))
+		occupancy_probs_[x * height_ + y] = prob;
+}
+
+/** Get the occupancy probability of a cell
+ * @param x the x-position of the cell
+ * @param y the y-position of the cell
+ * @return the occupancy probability of cell (x,y)
+ */
+inline Probability
+OccupancyGrid::get_prob(int x, int y)
+{
+	if ((x >= 0) && (x < width_) && (y >= 0) && (y < height_)) {
+		return occupancy_probs_[x * height_ + y];
+	} else {
+		return 1;
+	}
+}
+
+/** Operator (), get occupancy probability of a cell
+ * @param x the x-position of the cell
+ * @param y the y-position of the cell
+ * @return the occupancy probability of cell (x,y)
+ */
+inline Probability &
+OccupancyGrid::operator()(const int x, const int y)
+{
+	return occupancy_probs_[x * height_ + y];
+}
+
+/** Get the cells of a row of the grid.
+ * @param x the x-position of the row
+ * @return pointer to the cell (x,0), followed by the cells (x,1) to
+ * (x,height-1)
+ */
+inline Probability *
+OccupancyGrid::row(int x)
+{
+	return &occupancy_probs_[x * height_];
+}
+
 } // namespace fawkes
 
 #endif
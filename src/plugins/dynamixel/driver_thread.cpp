@@ -88,6 +88,18 @@ DynamixelDriverThread::init()
 	cfg_servos_to_discover_    = config->get_uints((cfg_prefix_ + "servos").c_str());
 	cfg_enable_verbose_output_ = config->get_bool((cfg_prefix_ + "enable_verbose_output").c_str());
 
+	cfg_bulk_read_ = false;
+	try {
+		cfg_bulk_read_ = config->get_bool((cfg_prefix_ + "bulk_read").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+	cfg_full_read_interval_ = 10;
+	try {
+		cfg_full_read_interval_ = config->get_uint((cfg_prefix_ + "full_read_interval").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+	num_reads_ = 0;
+
 	chain_                          = new DynamixelChain(cfg_device_.c_str(),
                               cfg_read_timeout_ms_,
                               cfg_enable_echo_fix_,
@@ -788,6 +800,8 @@ DynamixelDriverThread::has_fresh_data()
 void
 DynamixelDriverThread::loop()
 {
+	std::map<unsigned char, unsigned int> goal_positions;
+
 	for (auto &sp : servos_) {
 		unsigned int servo_id = sp.first;
 		Servo &      s        = sp.second;
@@ -846,9 +860,11 @@ DynamixelDriverThread::loop()
 			s.move_pending     = false;
 			float target_angle = s.target_angle;
 			s.value_rwlock->unlock();
-			exec_goto_angle(servo_id, target_angle);
-			if (s.mode_set_pending || s.recover_pending)
-				usleep(3000);
+			// sent for all servos at once below
+			unsigned int pos;
+			if (calc_goal_position(servo_id, target_angle, pos)) {
+				goal_positions[servo_id] = pos;
+			}
 		}
 
 		if (s.mode_set_pending) {
@@ -866,47 +882,100 @@ DynamixelDriverThread::loop()
 			chain_->set_torque_limit(servo_id, s.torque_limit);
 			s.value_rwlock->unlock();
 		}
+	}
 
-		try {
-			ScopedRWLock lock(chain_rwlock_, ScopedRWLock::LOCK_READ);
-			chain_->read_table_values(servo_id);
-
-			MutexLocker lock_fresh_data(fresh_data_mutex_);
-			fresh_data_ = true;
-			s.time.stamp();
-		} catch (Exception &e) {
-			// usually just a timeout, too noisy
-			//logger_->log_warn(name(), "Error while reading table values from servos, exception follows");
-			//logger_->log_warn(name(), e);
-		}
+	if (!goal_positions.empty()) {
+		ScopedRWLock lock(chain_rwlock_);
+		chain_->goto_positions(goal_positions);
 	}
 
+	read_servos();
+
 	update_waitcond_->wake_all();
 
 	// Wakeup ourselves for faster updates
 	wakeup();
 }
 
-/** Execute angle motion.
- * @param angle_rad angle in rad to move to
+/** Read the control tables of all servos.
+ * The part of the control table which changes during operation, i.e.,
+ * from P_TORQUE_ENABLE onwards, is read in every loop. The complete
+ * table is read only every full_read_interval loops. If bulk reading is
+ * enabled, all servos are read with a single request.
  */
 void
-DynamixelDriverThread::exec_goto_angle(unsigned int servo_id, float angle_rad)
+DynamixelDriverThread::read_servos()
+{
+	unsigned char addr   = DynamixelChain::P_TORQUE_ENABLE;
+	unsigned char length = DYNAMIXEL_CONTROL_TABLE_LENGTH - DynamixelChain::P_TORQUE_ENABLE;
+	if (cfg_full_read_interval_ <= 1 || (num_reads_++ % cfg_full_read_interval_) == 0) {
+		addr   = 0;
+		length = DYNAMIXEL_CONTROL_TABLE_LENGTH;
+	}
+
+	if (cfg_bulk_read_) {
+		DynamixelChain::DeviceList ids, replied;
+		for (auto &sp : servos_) {
+			ids.push_back(sp.first);
+		}
+		try {
+			ScopedRWLock lock(chain_rwlock_, ScopedRWLock::LOCK_READ);
+			replied = chain_->bulk_read_table_values(ids, addr, length);
+		} catch (Exception &e) {
+			logger->log_warn(name(), "Bulk read failed, exception follows");
+			logger->log_warn(name(), e);
+		}
+		if (!replied.empty()) {
+			MutexLocker lock_fresh_data(fresh_data_mutex_);
+			fresh_data_ = true;
+			for (unsigned char id : replied) {
+				auto s = servos_.find(id);
+				if (s != servos_.end())
+					s->second.time.stamp();
+			}
+		}
+	} else {
+		for (auto &sp : servos_) {
+			try {
+				ScopedRWLock lock(chain_rwlock_, ScopedRWLock::LOCK_READ);
+				chain_->read_table_value(sp.first, addr, length);
+
+				MutexLocker lock_fresh_data(fresh_data_mutex_);
+				fresh_data_ = true;
+				sp.second.time.stamp();
+			} catch (Exception &e) {
+				// usually just a timeout, too noisy to log
+			}
+		}
+	}
+}
+
+/** Calculate goal position for an angle.
+ * @param servo_id servo ID
+ * @param angle_rad angle in rad to move to
+ * @param pos upon return contains the goal position
+ * @return true if the position is within the angle limits of the servo,
+ * false otherwise
+ */
+bool
+DynamixelDriverThread::calc_goal_position(unsigned int  servo_id,
+                                          float         angle_rad,
+                                          unsigned int &pos)
 {
 	unsigned int pos_min = 0, pos_max = 0;
 	chain_->get_angle_limits(servo_id, pos_min, pos_max);
 
-	int pos =
+	int ipos =
 	  (int)roundf(DynamixelChain::POS_TICKS_PER_RAD * angle_rad) + DynamixelChain::CENTER_POSITION;
 
-	if ((pos < 0) || ((unsigned int)pos < pos_min) || ((unsigned int)pos > pos_max)) {
+	if ((ipos < 0) || ((unsigned int)ipos < pos_min) || ((unsigned int)ipos > pos_max)) {
 		logger->log_warn(
-		  name(), "Position out of bounds, min: %u  max: %u  des: %i", pos_min, pos_max, pos);
-		return;
+		  name(), "Position out of bounds, min: %u  max: %u  des: %i", pos_min, pos_max, ipos);
+		return false;
 	}
 
-	ScopedRWLock lock(chain_rwlock_);
-	chain_->goto_position(servo_id, pos);
+	pos = ipos;
+	return true;
 }
 
 /** Execute set mode.
@@ -132,6 +132,8 @@ private:
 	float                     cfg_max_voltage_;
 	std::vector<unsigned int> cfg_servos_to_discover_;
 	bool                      cfg_enable_verbose_output_;
+	bool                      cfg_bulk_read_;
+	unsigned int              cfg_full_read_interval_;
 
 	void  goto_angle(unsigned int servo_id, float angle);
 	void  goto_angle_timed(unsigned int servo_id, float angle, float time_sec);
@@ -150,14 +152,17 @@ private:
 	bool  has_fresh_data();
 	void  wait_for_fresh_data();
 
-	void exec_goto_angle(unsigned int servo_id, float angle);
+	bool calc_goal_position(unsigned int servo_id, float angle, unsigned int &pos);
 	void exec_set_mode(unsigned int servo_id, unsigned int new_mode);
+	void read_servos();
 
 private:
 	fawkes::WaitCondition *update_waitcond_;
 
 	bool           fresh_data_;
 	fawkes::Mutex *fresh_data_mutex_;
+
+	unsigned int num_reads_;
 };
 
 #endif
@@ -119,6 +119,7 @@ const unsigned char DynamixelChain::INST_SYSTEM_READ    = 0x0C; /**< INST_SYSTEM
 const unsigned char DynamixelChain::INST_SYSTEM_WRITE   = 0x0D; /**< INST_SYSTEM_WRITE */
 const unsigned char DynamixelChain::INST_SYNC_WRITE     = 0x83; /**< INST_SYNC_WRITE */
 const unsigned char DynamixelChain::INST_SYNC_REG_WRITE = 0x84; /**< INST_SYNC_REG_WRITE */
+const unsigned char DynamixelChain::INST_BULK_READ      = 0x92; /**< INST_BULK_READ */
 
 const unsigned char DynamixelChain::PACKET_OFFSET_ID     = 2; /**< PACKET_OFFSET_ID */
 const unsigned char DynamixelChain::PACKET_OFFSET_LENGTH = 3; /**< PACKET_OFFSET_LENGTH */
@@ -169,6 +170,7 @@ DynamixelChain::DynamixelChain(const char * device_file,
 	min_voltage_                 = min_voltage;
 	max_voltage_                 = max_voltage;
 	memset(control_table_, 0, DYNAMIXEL_MAX_NUM_SERVOS * DYNAMIXEL_CONTROL_TABLE_LENGTH);
+	memset(errors_, 0, sizeof(errors_));
 	try {
 		open();
 	} catch (Exception &e) {
@@ -465,6 +467,10 @@ DynamixelChain::recv(const unsigned char exp_length, unsigned int timeout_ms)
 		                ibuffer_[plength + 5]);
 	}
 
+	if (ibuffer_[PACKET_OFFSET_ID] < DYNAMIXEL_MAX_NUM_SERVOS) {
+		errors_[ibuffer_[PACKET_OFFSET_ID]] = ibuffer_[PACKET_OFFSET_ERROR];
+	}
+
 	ibuffer_length_ = plength + 2 + 4;
 }
 
@@ -615,6 +621,65 @@ DynamixelChain::finish_read_table_values()
 	       DYNAMIXEL_CONTROL_TABLE_LENGTH);
 }
 
+/** Read table values of multiple servos at once.
+ * This sends a single BULK_READ instruction for the given range of the
+ * control table of all given servos. The servos reply one after another
+ * without further requests, which saves a round trip per servo. The
+ * values are written to the control table (in memory, not in the
+ * servo), such that the appropriate get methods will return the new
+ * data. Note that BULK_READ is only supported by some models, e.g. the
+ * MX series, but not by AX or RX servos.
+ * @param ids IDs of the servos to read, not the broadcast ID
+ * @param addr start addr, one of the P_* constants.
+ * @param read_length number of bytes to read from each servo
+ * @return IDs of the servos which replied
+ */
+DynamixelChain::DeviceList
+DynamixelChain::bulk_read_table_values(const DeviceList &ids,
+                                       unsigned char     addr,
+                                       unsigned char     read_length)
+{
+	if (ids.size() > 84) {
+		// not enough space for everything in the parameters..
+		throw Exception("You cannot read more than 84 servos at once");
+	}
+	if (addr + read_length > DYNAMIXEL_CONTROL_TABLE_LENGTH) {
+		throw OutOfBoundsException("Read beyond control table",
+		                           addr + read_length,
+		                           0,
+		                           DYNAMIXEL_CONTROL_TABLE_LENGTH);
+	}
+
+	unsigned int  plength = 3 * ids.size() + 1;
+	unsigned char param[plength];
+	param[0]       = 0x00;
+	unsigned int i = 1;
+	for (DeviceList::const_iterator id = ids.begin(); id != ids.end(); ++id) {
+		assert_valid_id(*id);
+		param[i++] = read_length;
+		param[i++] = *id;
+		param[i++] = addr;
+	}
+
+	send(BROADCAST_ID, INST_BULK_READ, param, plength);
+
+	DeviceList rv;
+	for (size_t n = 0; n < ids.size(); ++n) {
+		try {
+			recv(read_length);
+		} catch (TimeoutException &e) {
+			// a servo did not reply, the following may still do
+			continue;
+		}
+		unsigned char id = ibuffer_[PACKET_OFFSET_ID];
+		if (id < DYNAMIXEL_MAX_NUM_SERVOS) {
+			memcpy(&control_table_[id][addr], &ibuffer_[PACKET_OFFSET_PARAM], read_length);
+			rv.push_back(id);
+		}
+	}
+	return rv;
+}
+
 /** Read a table value.
  * This will read the given value(s) and write the output to the control table
  * (in memory, not in the servo), such that the appropriate get method will return
@@ -861,12 +926,13 @@ DynamixelChain::get_delay_time(unsigned char id, bool refresh)
 
 /** Get error flags set by the servo
  * @param id servo ID, not the broadcast ID
- * @return error flags
+ * @return error flags of the last status packet received from the servo
  */
 unsigned char
 DynamixelChain::get_error(unsigned char id)
 {
-	return ibuffer_[PACKET_OFFSET_ERROR];
+	assert_valid_id(id);
+	return errors_[id];
 }
 
 /** Get angle limits.
@@ -1452,3 +1518,40 @@ DynamixelChain::goto_positions(unsigned int num_servos, ...)
 
 	send(BROADCAST_ID, INST_SYNC_WRITE, param, plength);
 }
+
+/** Move several servos to specified positions.
+ * The goal positions of all servos are sent in a single SYNC_WRITE
+ * instruction packet (see goto_position() for information on the
+ * valid values).
+ * @param positions map from servo ID to position, at most 83 servos
+ */
+void
+DynamixelChain::goto_positions(const std::map<unsigned char, unsigned int> &positions)
+{
+	if (positions.size() > 83) {
+		// not enough space for everything in the parameters..
+		throw Exception("You cannot set more than 83 servos at once");
+	}
+	if (positions.empty())
+		return;
+
+	unsigned int  plength = 3 * positions.size() + 2;
+	unsigned char param[plength];
+	param[0]       = P_GOAL_POSITION_L;
+	param[1]       = 2;
+	unsigned int i = 2;
+	for (const auto &p : positions) {
+		param[i++] = p.first;
+		param[i++] = (p.second & 0xFF);
+		param[i++] = (p.second >> 8) & 0xFF;
+	}
+
+	send(BROADCAST_ID, INST_SYNC_WRITE, param, plength);
+
+	for (const auto &p : positions) {
+		if (p.first < DYNAMIXEL_MAX_NUM_SERVOS) {
+			control_table_[p.first][P_GOAL_POSITION_L] = (p.second & 0xFF);
+			control_table_[p.first][P_GOAL_POSITION_H] = (p.second >> 8) & 0xFF;
+		}
+	}
+}
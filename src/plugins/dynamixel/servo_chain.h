@@ -28,6 +28,7 @@
 #include <cstddef>
 #include <cstdio>
 #include <list>
+#include <map>
 #include <vector>
 
 #define DYNAMIXEL_CONTROL_TABLE_LENGTH 0x32
@@ -66,9 +67,12 @@ public:
 	void read_table_value(unsigned char id, unsigned char addr, unsigned char read_length);
 	void start_read_table_values(unsigned char id);
 	void finish_read_table_values();
+	DeviceList
+	bulk_read_table_values(const DeviceList &ids, unsigned char addr, unsigned char read_length);
 
 	void goto_position(unsigned char id, unsigned int value);
 	void goto_positions(unsigned int num_positions, ...);
+	void goto_positions(const std::map<unsigned char, unsigned int> &positions);
 
 	const char *  get_model(unsigned char id, bool refresh = false);
 	unsigned int  get_model_number(unsigned char id, bool refresh = false);
@@ -222,6 +226,7 @@ private:
 	static const unsigned char INST_SYSTEM_WRITE;
 	static const unsigned char INST_SYNC_WRITE;
 	static const unsigned char INST_SYNC_REG_WRITE;
+	static const unsigned char INST_BULK_READ;
 
 	// Packet offsets
 	static const unsigned char PACKET_OFFSET_ID;
@@ -269,7 +274,8 @@ private:
 	int obuffer_length_;
 	int ibuffer_length_;
 
-	char control_table_[DYNAMIXEL_MAX_NUM_SERVOS][DYNAMIXEL_CONTROL_TABLE_LENGTH];
+	char          control_table_[DYNAMIXEL_MAX_NUM_SERVOS][DYNAMIXEL_CONTROL_TABLE_LENGTH];
+	unsigned char errors_[DYNAMIXEL_MAX_NUM_SERVOS];
 };
 
 #endif
@@ -93,13 +93,18 @@ BlackboardListenerThread::bb_interface_destroyed(const char *type, const char *i
 }
 
 /** Called by the BlackBoardInterfaceListener when an interface changes
+ * At most one change event per interface is queued, further changes
+ * before the event has been popped are covered by it since the agent
+ * reads the current data anyway.
  * @param interface The changed interface
  */
 void
 BlackboardListenerThread::bb_interface_data_changed(Interface *interface) noexcept
 {
 	MutexLocker lock(&state_mutex_);
-	iface_events_.emplace(new BlackboardListenerThread::Changed{interface});
+	if (changed_pending_.insert(interface->uid()).second) {
+		iface_events_.emplace(new BlackboardListenerThread::Changed{interface});
+	}
 }
 
 /** Test whether any events are in the queue
@@ -121,6 +126,9 @@ BlackboardListenerThread::event_pop()
 	MutexLocker                                 lock(&state_mutex_);
 	shared_ptr<BlackboardListenerThread::Event> rv = iface_events_.front();
 	iface_events_.pop();
+	if (dynamic_cast<BlackboardListenerThread::Changed *>(rv.get())) {
+		changed_pending_.erase(rv->uid());
+	}
 	return rv;
 }
 
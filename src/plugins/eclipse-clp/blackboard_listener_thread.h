@@ -34,6 +34,7 @@
 #include <map>
 #include <memory>
 #include <queue>
+#include <set>
 
 /** Keeps a queue of subscribed blackboard events that can be queried in a thread-safe manner */
 class BlackboardListenerThread : public fawkes::Thread,
@@ -146,6 +147,7 @@ private:
 
 	map<string, fawkes::Interface *> last_iface_of_type_;
 	queue<shared_ptr<Event>>         iface_events_;
+	std::set<string>                 changed_pending_;
 };
 
 #endif // BLACKBOARD_LISTENER_THREAD_H
@@ -103,12 +103,201 @@ EclExternalBlackBoard::interfaces()
 	return m_interfaces;
 }
 
+EclExternalBlackBoard::InterfaceState &
+EclExternalBlackBoard::interface_state(Interface *iface)
+{
+	InterfaceState &s = m_interface_states[iface];
+	if (s.fields.empty()) {
+		for (InterfaceFieldIterator fit = iface->fields(); fit != iface->fields_end(); ++fit) {
+			s.field_index[fit.get_name()] = s.fields.size();
+			s.fields.push_back(fit);
+		}
+	}
+	return s;
+}
+
+/** Get field of an interface.
+ * The fields are resolved once per interface, later lookups do not walk
+ * the field list.
+ * @param iface opened interface
+ * @param name name of the field
+ * @return iterator pointing to the field, NULL if there is no such field
+ */
+InterfaceFieldIterator *
+EclExternalBlackBoard::field(Interface *iface, const char *name)
+{
+	InterfaceState &s = interface_state(iface);
+	auto            f = s.field_index.find(name);
+	if (f == s.field_index.end()) {
+		return NULL;
+	}
+	return &s.fields[f->second];
+}
+
+/** Get all fields of an interface.
+ * @param iface opened interface
+ * @return iterators pointing to the fields in the order of the interface
+ */
+std::vector<InterfaceFieldIterator> &
+EclExternalBlackBoard::fields(Interface *iface)
+{
+	return interface_state(iface).fields;
+}
+
+/** Get fields which changed since the last call.
+ * Compares the current data of the interface with the data of the
+ * previous call. On the first call for an interface all fields are
+ * considered changed. The interface is not read.
+ * @param iface opened interface
+ * @param changed upon return contains the changed fields
+ */
+void
+EclExternalBlackBoard::changed_fields(Interface *                           iface,
+                                      std::list<InterfaceFieldIterator *> &changed)
+{
+	InterfaceState &s        = interface_state(iface);
+	const char *    data_now = (const char *)iface->datachunk();
+	if (s.last_data.size() == iface->datasize()
+	    && memcmp(&s.last_data[0], data_now, s.last_data.size()) == 0) {
+		return;
+	}
+
+	const char *data_last = s.last_data.empty() ? NULL : &s.last_data[0];
+	for (InterfaceFieldIterator &fit : s.fields) {
+		size_t offset = (const char *)fit.get_value() - data_now;
+		if (!data_last || memcmp(data_last + offset, data_now + offset, fit.get_data_size()) != 0) {
+			changed.push_back(&fit);
+		}
+	}
+	s.last_data.assign(data_now, data_now + iface->datasize());
+}
+
+/** Drop resolved fields and change state of an interface.
+ * Must be called before the interface is closed.
+ * @param iface interface to forget
+ */
+void
+EclExternalBlackBoard::forget_interface(Interface *iface)
+{
+	m_interface_states.erase(iface);
+}
+
 } // namespace fawkes
 
 using namespace fawkes;
 
 bool process_message_args(Message *msg, EC_word arg_list);
 
+/// @cond INTERNALS
+static InterfaceFieldIterator &
+field_ref(InterfaceFieldIterator &fit)
+{
+	return fit;
+}
+
+static InterfaceFieldIterator &
+field_ref(InterfaceFieldIterator *fit)
+{
+	return *fit;
+}
+/// @endcond
+
+static bool
+field_to_ec_word(InterfaceFieldIterator &fit, EC_word &value)
+{
+	switch (fit.get_type()) {
+	case IFT_BOOL:
+		if (fit.get_bool()) {
+			value = EC_atom((char *)"true");
+		} else {
+			value = EC_atom((char *)"false");
+		}
+		break;
+
+	case IFT_INT8: value = EC_word((long)fit.get_int8()); break;
+
+	case IFT_UINT8: value = EC_word((long)fit.get_uint8()); break;
+
+	case IFT_INT16: value = EC_word((long)fit.get_int16()); break;
+
+	case IFT_UINT16: value = EC_word((long)fit.get_uint16()); break;
+
+	case IFT_INT32: value = EC_word((long)fit.get_int32()); break;
+
+	case IFT_UINT32: value = EC_word((long)fit.get_uint32()); break;
+
+	case IFT_INT64: value = EC_word((long)fit.get_int64()); break;
+
+	case IFT_UINT64: value = EC_word((long)fit.get_uint64()); break;
+
+	case IFT_FLOAT:
+		if (fit.get_length() > 1) {
+			value          = nil();
+			float *f_array = fit.get_floats();
+			for (int i = fit.get_length() - 1; i >= 0; --i)
+				value = ::list(EC_word(f_array[i]), value);
+		} else {
+			value = EC_word((double)fit.get_float());
+		}
+		break;
+
+	case IFT_DOUBLE:
+		if (fit.get_length() > 1) {
+			value                = nil();
+			double *double_array = fit.get_doubles();
+			for (int i = fit.get_length() - 1; i >= 0; --i)
+				value = ::list(EC_word(double_array[i]), value);
+		} else {
+			value = EC_word((double)fit.get_double());
+		}
+		break;
+
+	case IFT_STRING: value = EC_word(fit.get_string()); break;
+
+	case IFT_BYTE:
+		if (fit.get_length() > 1) {
+			value          = nil();
+			uint8_t *array = fit.get_bytes();
+			for (int i = fit.get_length() - 1; i >= 0; i--)
+				value = ::list(EC_word((long)array[i]), value);
+		} else {
+			value = EC_word((long)fit.get_byte());
+		}
+		break;
+
+	case IFT_ENUM: value = EC_word(fit.get_value_string()); break;
+
+	default:
+		fprintf(stderr,
+		        "field_to_ec_word(): could not find type of interface! Type: %s (%d)",
+		        fit.get_typename(),
+		        fit.get_type());
+		return false;
+	}
+	return true;
+}
+
+/** Build list of Name-Value pairs.
+ * @param fields fields to add to the list
+ * @param list upon return contains the list
+ * @return true on success, false if a field could not be converted
+ */
+template <class FieldIterators>
+static bool
+fields_to_ec_list(FieldIterators &fields, EC_word &list)
+{
+	list = nil();
+	for (auto f = fields.rbegin(); f != fields.rend(); ++f) {
+		InterfaceFieldIterator &fit = field_ref(*f);
+		EC_word                 value;
+		if (!field_to_ec_word(fit, value)) {
+			return false;
+		}
+		list = ::list(::term(EC_functor((char *)"-", 2), EC_word(fit.get_name()), value), list);
+	}
+	return true;
+}
+
 int
 p_bb_open_interface()
 {
@@ -175,6 +364,7 @@ p_bb_close_interface()
 	std::map<std::string, Interface *> &interfaces = EclExternalBlackBoard::instance()->interfaces();
 
 	if (interfaces.find(uid) != interfaces.end()) {
+		EclExternalBlackBoard::instance()->forget_interface(interfaces[uid]);
 		EclExternalBlackBoard::instance()->blackboard_instance()->close(interfaces[uid]);
 		EclExternalBlackBoard::instance()->interfaces().erase(uid);
 	}
@@ -318,186 +508,139 @@ p_bb_interface_changed()
 }
 
 int
-p_bb_get()
+p_bb_read_changed()
 {
 	char *uid;
-	char *field;
-
 	if (EC_succeed != EC_arg(1).is_string(&uid)) {
-		fprintf(stderr, "p_bb_get(): no interface uid given\n");
+		fprintf(stderr, "p_bb_read_changed(): no interface UID given\n");
 		return EC_fail;
 	}
 
-	if (EC_succeed != EC_arg(2).is_string(&field)) {
-		fprintf(stderr, "p_bb_get(): no field given\n");
+	std::map<std::string, Interface *> &interfaces = EclExternalBlackBoard::instance()->interfaces();
+
+	if (interfaces.find(uid) == interfaces.end()) {
+		fprintf(stderr, "p_bb_read_changed: interface %s has not been opened\n", uid);
 		return EC_fail;
 	}
 
+	Interface *iface = interfaces[uid];
+	if (!iface->is_writer()) {
+		iface->read();
+	}
+
+	std::list<InterfaceFieldIterator *> changed;
+	EclExternalBlackBoard::instance()->changed_fields(iface, changed);
+
+	EC_word list;
+	if (!fields_to_ec_list(changed, list)) {
+		return EC_fail;
+	}
+	if (EC_succeed != EC_arg(2).unify(list)) {
+		fprintf(stderr, "p_bb_read_changed(): could not bind return value\n");
+		return EC_fail;
+	}
+
+	return EC_succeed;
+}
+
+int
+p_bb_read_changed_all()
+{
 	std::map<std::string, Interface *> &interfaces = EclExternalBlackBoard::instance()->interfaces();
 
-	if (interfaces.find(uid) != interfaces.end()) {
-		Interface *iface = interfaces[uid];
+	EC_word result = nil();
+	for (auto it = interfaces.rbegin(); it != interfaces.rend(); ++it) {
+		Interface *iface = it->second;
+		if (iface->is_writer()) {
+			continue;
+		}
+		iface->read();
 
-		InterfaceFieldIterator fit;
-		for (fit = iface->fields(); fit != iface->fields_end(); ++fit) {
-			if (0 == strcmp(field, fit.get_name())) {
-				switch (fit.get_type()) {
-				case IFT_BOOL:
-					if (fit.get_bool()) {
-						if (EC_succeed != EC_arg(3).unify(EC_atom((char *)"true"))) {
-							fprintf(stderr, "p_bb_get(): could not bind return value\n");
-							return EC_fail;
-						}
-					} else {
-						if (EC_succeed != EC_arg(3).unify(EC_atom((char *)"false"))) {
-							fprintf(stderr, "p_bb_get(): could not bind return value\n");
-							return EC_fail;
-						}
-					}
-					break;
+		std::list<InterfaceFieldIterator *> changed;
+		EclExternalBlackBoard::instance()->changed_fields(iface, changed);
+		if (changed.empty()) {
+			continue;
+		}
 
-				case IFT_INT8:
-					if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_int8()))) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+		EC_word list;
+		if (!fields_to_ec_list(changed, list)) {
+			return EC_fail;
+		}
+		result = ::list(::term(EC_functor((char *)"-", 2), EC_word(it->first.c_str()), list), result);
+	}
 
-				case IFT_UINT8:
-					if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_uint8()))) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+	if (EC_succeed != EC_arg(1).unify(result)) {
+		fprintf(stderr, "p_bb_read_changed_all(): could not bind return value\n");
+		return EC_fail;
+	}
 
-				case IFT_INT16:
-					if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_int16()))) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+	return EC_succeed;
+}
 
-				case IFT_UINT16:
-					if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_uint16()))) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+int
+p_bb_get()
+{
+	char *uid;
+	char *field;
 
-				case IFT_INT32:
-					if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_int32()))) {
-						fprintf(stderr, "p_bb_get: could not bind value\n");
-						return EC_fail;
-					}
-					break;
+	if (EC_succeed != EC_arg(1).is_string(&uid)) {
+		fprintf(stderr, "p_bb_get(): no interface uid given\n");
+		return EC_fail;
+	}
 
-				case IFT_UINT32:
-					if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_uint32()))) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+	if (EC_succeed != EC_arg(2).is_string(&field)) {
+		fprintf(stderr, "p_bb_get(): no field given\n");
+		return EC_fail;
+	}
 
-				case IFT_INT64:
-					if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_int64()))) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+	std::map<std::string, Interface *> &interfaces = EclExternalBlackBoard::instance()->interfaces();
 
-				case IFT_UINT64:
-					if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_uint64()))) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+	if (interfaces.find(uid) == interfaces.end()) {
+		fprintf(stderr, "p_bb_get(): no interface with id %s found\n", uid);
+		return EC_fail;
+	}
 
-				case IFT_FLOAT:
-					if (fit.get_length() > 1) {
-						EC_word res     = nil();
-						float * f_array = fit.get_floats();
-						for (int i = fit.get_length() - 1; i >= 0; --i)
-							res = ::list(EC_word(f_array[i]), res);
-						if (EC_succeed != EC_arg(3).unify(res)) {
-							fprintf(stderr, "p_bb_get(): could not bind return value\n");
-							return EC_fail;
-						}
-					} else {
-						if (EC_succeed != EC_arg(3).unify(EC_word((double)fit.get_float()))) {
-							fprintf(stderr, "p_bb_get(): could not bind return value\n");
-							return EC_fail;
-						}
-					}
-					break;
+	InterfaceFieldIterator *fit = EclExternalBlackBoard::instance()->field(interfaces[uid], field);
+	if (!fit) {
+		fprintf(stderr, "p_bb_get(): interface %s has no field %s\n", uid, field);
+		return EC_fail;
+	}
 
-				case IFT_DOUBLE:
-					if (fit.get_length() > 1) {
-						EC_word res          = nil();
-						double *double_array = fit.get_doubles();
-						for (int i = fit.get_length() - 1; i >= 0; --i)
-							res = ::list(EC_word(double_array[i]), res);
-						if (EC_succeed != EC_arg(3).unify(res)) {
-							fprintf(stderr, "p_bb_get(): could not bind return value\n");
-							return EC_fail;
-						}
-					} else {
-						if (EC_succeed != EC_arg(3).unify(EC_word((double)fit.get_double()))) {
-							fprintf(stderr, "p_bb_get(): could not bind return value\n");
-							return EC_fail;
-						}
-					}
-					break;
+	EC_word value;
+	if (!field_to_ec_word(*fit, value)) {
+		return EC_fail;
+	}
+	if (EC_succeed != EC_arg(3).unify(value)) {
+		fprintf(stderr, "p_bb_get(): could not bind return value\n");
+		return EC_fail;
+	}
 
-				case IFT_STRING:
-					if (EC_succeed != EC_arg(3).unify(EC_word(fit.get_string()))) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+	return EC_succeed;
+}
 
-				case IFT_BYTE:
-					if (fit.get_length() > 1) {
-						EC_word  res   = nil();
-						uint8_t *array = fit.get_bytes();
-						for (int i = fit.get_length() - 1; i >= 0; i--)
-							res = ::list(EC_word((long)array[i]), res);
-						if (EC_succeed != EC_arg(3).unify(res)) {
-							printf("p_bb_get(): could not bind return value\n");
-							return EC_fail;
-						}
-					} else {
-						if (EC_succeed != EC_arg(3).unify(EC_word((long)fit.get_byte()))) {
-							printf("p_bb_get(): could not bind return value\n");
-							return EC_fail;
-						}
-					}
-					break;
+int
+p_bb_get_fields()
+{
+	char *uid;
 
-				case IFT_ENUM:
-					if (EC_succeed != EC_arg(3).unify(fit.get_value_string())) {
-						fprintf(stderr, "p_bb_get(): could not bind return value\n");
-						return EC_fail;
-					}
-					break;
+	if (EC_succeed != EC_arg(1).is_string(&uid)) {
+		fprintf(stderr, "p_bb_get_fields(): no interface uid given\n");
+		return EC_fail;
+	}
 
-				default:
-					fprintf(stderr,
-					        "p_bb_get(): could not find type of interface! Type: %s (%d)",
-					        fit.get_typename(),
-					        fit.get_type());
-					break;
-				}
-				break;
-			}
-		}
+	std::map<std::string, Interface *> &interfaces = EclExternalBlackBoard::instance()->interfaces();
 
-		if (fit == iface->fields_end()) {
-			fprintf(stderr, "p_bb_get(): interface %s has no field %s\n", uid, field);
-			return EC_fail;
-		}
+	if (interfaces.find(uid) == interfaces.end()) {
+		fprintf(stderr, "p_bb_get_fields(): no interface with id %s found\n", uid);
+		return EC_fail;
+	}
 
-	} else {
-		fprintf(stderr, "p_bb_get(): no interface with id %s found\n", uid);
+	EC_word list;
+	if (!fields_to_ec_list(EclExternalBlackBoard::instance()->fields(interfaces[uid]), list)) {
+		return EC_fail;
+	}
+	if (EC_succeed != EC_arg(2).unify(list)) {
+		fprintf(stderr, "p_bb_get_fields(): could not bind return value\n");
 		return EC_fail;
 	}
 
@@ -530,139 +673,135 @@ p_bb_set()
 			return EC_fail;
 		}
 
-		InterfaceFieldIterator fit;
-		for (fit = iface->fields(); fit != iface->fields_end(); ++fit) {
-			if (0 == strcmp(field, fit.get_name())) {
-				switch (fit.get_type()) {
-				case IFT_BOOL: {
-					EC_atom val;
-					if (EC_succeed != EC_arg(3).is_atom(&val)) {
-						fprintf(stderr, "p_bb_set(): no value_given\n");
-						return EC_fail;
-					}
+		InterfaceFieldIterator *fitp = EclExternalBlackBoard::instance()->field(iface, field);
+		if (!fitp) {
+			fprintf(stderr, "p_bb_set(): interface %s has no field %s\n", uid, field);
+			return EC_fail;
+		}
 
-					if (0 == strcmp("true", val.name())) {
-						fit.set_bool(true);
-					} else if (0 == strcmp("false", val.name())) {
-						fit.set_bool(false);
-					} else {
-						fprintf(stderr, "p_bb_set(): boolean value neither true nor false\n");
-						return EC_fail;
-					}
-				} break;
+		InterfaceFieldIterator &fit = *fitp;
+		switch (fit.get_type()) {
+		case IFT_BOOL: {
+			EC_atom val;
+			if (EC_succeed != EC_arg(3).is_atom(&val)) {
+				fprintf(stderr, "p_bb_set(): no value_given\n");
+				return EC_fail;
+			}
 
-				case IFT_INT8: {
-					long val;
-					if (EC_succeed != EC_arg(3).is_long(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			if (0 == strcmp("true", val.name())) {
+				fit.set_bool(true);
+			} else if (0 == strcmp("false", val.name())) {
+				fit.set_bool(false);
+			} else {
+				fprintf(stderr, "p_bb_set(): boolean value neither true nor false\n");
+				return EC_fail;
+			}
+		} break;
 
-					fit.set_int8((int8_t)val);
-				} break;
+		case IFT_INT8: {
+			long val;
+			if (EC_succeed != EC_arg(3).is_long(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_UINT8: {
-					long val;
-					if (EC_succeed != EC_arg(3).is_long(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_int8((int8_t)val);
+		} break;
 
-					fit.set_uint8((uint8_t)val);
-				} break;
+		case IFT_UINT8: {
+			long val;
+			if (EC_succeed != EC_arg(3).is_long(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_INT16: {
-					long val;
-					if (EC_succeed != EC_arg(3).is_long(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_uint8((uint8_t)val);
+		} break;
 
-					fit.set_int16((int16_t)val);
-				} break;
+		case IFT_INT16: {
+			long val;
+			if (EC_succeed != EC_arg(3).is_long(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_UINT16: {
-					long val;
-					if (EC_succeed != EC_arg(3).is_long(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_int16((int16_t)val);
+		} break;
 
-					fit.set_uint16((uint16_t)val);
-				} break;
+		case IFT_UINT16: {
+			long val;
+			if (EC_succeed != EC_arg(3).is_long(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_INT32: {
-					long val;
-					if (EC_succeed != EC_arg(3).is_long(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_uint16((uint16_t)val);
+		} break;
 
-					fit.set_int32((int32_t)val);
-				} break;
+		case IFT_INT32: {
+			long val;
+			if (EC_succeed != EC_arg(3).is_long(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_UINT32: {
-					long val;
-					if (EC_succeed != EC_arg(3).is_long(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_int32((int32_t)val);
+		} break;
 
-					fit.set_uint32((uint32_t)val);
-				} break;
+		case IFT_UINT32: {
+			long val;
+			if (EC_succeed != EC_arg(3).is_long(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_INT64: {
-					long val;
-					if (EC_succeed != EC_arg(3).is_long(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_uint32((uint32_t)val);
+		} break;
 
-					fit.set_int64((int64_t)val);
-				} break;
+		case IFT_INT64: {
+			long val;
+			if (EC_succeed != EC_arg(3).is_long(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_UINT64: {
-					long val;
-					if (EC_succeed != EC_arg(3).is_long(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_int64((int64_t)val);
+		} break;
 
-					fit.set_uint64((uint64_t)val);
-				} break;
+		case IFT_UINT64: {
+			long val;
+			if (EC_succeed != EC_arg(3).is_long(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_FLOAT: {
-					double val;
-					if (EC_succeed != EC_arg(3).is_double(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_uint64((uint64_t)val);
+		} break;
 
-					fit.set_float((float)val);
-				} break;
+		case IFT_FLOAT: {
+			double val;
+			if (EC_succeed != EC_arg(3).is_double(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_STRING: {
-					char *val;
-					if (EC_succeed != EC_arg(3).is_string(&val)) {
-						fprintf(stderr, "p_bb_set(): no value given\n");
-						return EC_fail;
-					}
+			fit.set_float((float)val);
+		} break;
 
-					fit.set_string(val);
-				} break;
+		case IFT_STRING: {
+			char *val;
+			if (EC_succeed != EC_arg(3).is_string(&val)) {
+				fprintf(stderr, "p_bb_set(): no value given\n");
+				return EC_fail;
+			}
 
-				case IFT_BYTE:
-				case IFT_ENUM: fprintf(stderr, "p_bb_set(): NOT YET IMPLEMENTET\n"); break;
+			fit.set_string(val);
+		} break;
 
-				default: break;
-				}
-				break;
-			}
-		}
+		case IFT_BYTE:
+		case IFT_ENUM: fprintf(stderr, "p_bb_set(): NOT YET IMPLEMENTET\n"); break;
 
-		if (fit == iface->fields_end()) {
-			fprintf(stderr, "p_bb_set(): interface %s has no field %s\n", uid, field);
-			return EC_fail;
+		default: break;
 		}
 
 	} else {
@@ -25,9 +25,13 @@
 #define _ECLIPSE_EXTERNALS_BLACKBOARD_H_
 
 #include <blackboard/remote.h>
+#include <interface/field_iterator.h>
 #include <logging/logger.h>
 
 #include <cstdio>
+#include <list>
+#include <map>
+#include <string>
 #include <vector>
 
 /** @class fawkes::EclExternalBlackBoard
@@ -55,6 +59,11 @@ public:
 	static BlackBoard *                 blackboard_instance();
 	std::map<std::string, Interface *> &interfaces();
 
+	InterfaceFieldIterator *             field(Interface *iface, const char *name);
+	std::vector<InterfaceFieldIterator> &fields(Interface *iface);
+	void changed_fields(Interface *iface, std::list<InterfaceFieldIterator *> &changed);
+	void forget_interface(Interface *iface);
+
 	/**
    * @return A pointer to the plugin-central logger
    */
@@ -74,10 +83,23 @@ public:
 	}
 
 private:
-	static EclExternalBlackBoard *     m_instance;
-	std::map<std::string, Interface *> m_interfaces;
-	static BlackBoard *                m_blackboard;
-	static Logger *                    m_logger;
+	/// @cond INTERNALS
+	typedef struct
+	{
+		std::vector<InterfaceFieldIterator> fields;
+		std::map<std::string, size_t>       field_index;
+		std::vector<char>                   last_data;
+	} InterfaceState;
+	/// @endcond
+
+	InterfaceState &interface_state(Interface *iface);
+
+private:
+	static EclExternalBlackBoard *        m_instance;
+	std::map<std::string, Interface *>    m_interfaces;
+	std::map<Interface *, InterfaceState> m_interface_states;
+	static BlackBoard *                   m_blackboard;
+	static Logger *                       m_logger;
 };
 } // namespace fawkes
 
@@ -92,8 +114,11 @@ extern "C" int p_bb_read_interface();
 extern "C" int p_bb_write_interfaces();
 extern "C" int p_bb_write_interface();
 extern "C" int p_bb_interface_changed();
+extern "C" int p_bb_read_changed();
+extern "C" int p_bb_read_changed_all();
 
 extern "C" int p_bb_get();
+extern "C" int p_bb_get_fields();
 extern "C" int p_bb_set();
 
 extern "C" int p_bb_send_message();
@@ -22,9 +22,9 @@
 #include "rcsoft_map_graph.h"
 
 #include <core/exception.h>
+#include <navgraph/binary_navgraph.h>
 #include <navgraph/navgraph.h>
 #include <navgraph/navgraph_node.h>
-#include <navgraph/yaml_navgraph.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -62,7 +62,7 @@ public:
 		inf.close();
 
 		if (firstword == "%YAML") {
-			m_map_graph = load_yaml_navgraph(file);
+			m_map_graph = load_navgraph(file);
 		} else {
 			throw Exception("Unknown graph format");
 		}
@@ -147,6 +147,17 @@ LookupEstimator::get_execution_time(const Skill &skill)
 	}
 }
 
+/** Estimates must not be cached.
+ * Each estimate is a random sample and determines the outcome of the
+ * following call to execute().
+ * @return false
+ */
+bool
+LookupEstimator::can_cache_estimates() const
+{
+	return false;
+}
+
 std::pair<SkillerInterface::SkillStatusEnum, std::string>
 LookupEstimator::execute(const Skill &skill)
 {
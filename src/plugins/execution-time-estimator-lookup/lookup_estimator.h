@@ -45,6 +45,7 @@ public:
 	                Logger *            logger);
 	float get_execution_time(const Skill &skill) override;
 	bool  can_provide_exec_time(const Skill &skill) const override;
+	bool  can_cache_estimates() const override;
 	std::pair<SkillerInterface::SkillStatusEnum, std::string> execute(const Skill &skill) override;
 
 private:
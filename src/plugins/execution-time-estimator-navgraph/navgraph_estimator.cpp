@@ -25,6 +25,8 @@ namespace fawkes {
 /** @class NavGraphEstimator
  * Estimate the execution time for the skill goto by querying the distance from
  * the navgraph.
+ * Cached estimates are invalidated if the navgraph changes or a skill is
+ * executed, as this moves the assumed start position.
  */
 
 /** Constructor.
@@ -42,6 +44,20 @@ NavGraphEstimator::NavGraphEstimator(LockPtr<NavGraph>  navgraph,
 {
 	last_pose_x_ = config->get_float_or_default("plugins/amcl/init_pose_x", 0);
 	last_pose_y_ = config->get_float_or_default("plugins/amcl/init_pose_y", 0);
+	navgraph_->add_change_listener(this);
+}
+
+/** Destructor. */
+NavGraphEstimator::~NavGraphEstimator()
+{
+	navgraph_->remove_change_listener(this);
+}
+
+/** Invalidate cached estimates on navgraph changes. */
+void
+NavGraphEstimator::graph_changed() noexcept
+{
+	invalidate_estimates();
 }
 
 bool
@@ -75,6 +91,7 @@ NavGraphEstimator::execute(const Skill &skill)
 	auto node    = navgraph_->node(skill.skill_args.at("place"));
 	last_pose_x_ = node.x();
 	last_pose_y_ = node.y();
+	invalidate_estimates();
 	return std::make_pair(SkillerInterface::SkillStatusEnum::S_FINAL, "");
 }
 
@@ -30,15 +30,17 @@
 #include <vector>
 
 namespace fawkes {
-class NavGraphEstimator : public ExecutionTimeEstimator
+class NavGraphEstimator : public ExecutionTimeEstimator, public NavGraph::ChangeListener
 {
 public:
 	NavGraphEstimator(LockPtr<NavGraph>  navgraph,
 	                  Configuration *    config,
 	                  const std::string &cfg_prefix);
+	virtual ~NavGraphEstimator();
 	float get_execution_time(const Skill &skill) override;
 	bool  can_provide_exec_time(const Skill &skill) const override;
 	std::pair<SkillerInterface::SkillStatusEnum, std::string> execute(const Skill &skill) override;
+	void graph_changed() noexcept override;
 
 private:
 	LockPtr<NavGraph>           navgraph_;
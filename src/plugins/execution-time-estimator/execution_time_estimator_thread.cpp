@@ -40,6 +40,8 @@ ExecutionTimeEstimatorsThread::ExecutionTimeEstimatorsThread()
 void
 ExecutionTimeEstimatorsThread::init()
 {
+	execution_time_estimator_manager_.set_cache_ttl(
+	  config->get_float_or_default("/plugins/execution-time-estimator/cache-ttl", 0.));
 	execution_time_estimator_manager_.register_provider(
 	  std::make_shared<fawkes::ConfigExecutionTimeEstimator>(config, cfg_prefix_),
 	  config->get_int_or_default((std::string{cfg_prefix_} + "priority").c_str(), 0));
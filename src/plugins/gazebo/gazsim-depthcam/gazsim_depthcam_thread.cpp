@@ -22,9 +22,11 @@
 #include "gazsim_depthcam_thread.h"
 
 #include <aspect/logging.h>
+#include <core/threading/mutex_locker.h>
 #include <tf/types.h>
 #include <utils/math/angle.h>
 
+#include <algorithm>
 #include <gazebo/msgs/msgs.hh>
 #include <gazebo/transport/Node.hh>
 #include <gazebo/transport/transport.hh>
@@ -36,6 +38,8 @@ using namespace gazebo;
 
 /** @class DepthcamSimThread "gazsim_depthcam_thread.h"
  * Thread simulates a number of depthcams in Gazebo
+ * Only the latest message received from Gazebo is converted once per
+ * loop, and only if the point cloud is used by another thread.
  * @author Frederik Zwilling
  */
 
@@ -73,38 +77,48 @@ DepthcamSimThread::init()
 void
 DepthcamSimThread::finalize()
 {
+	depthcam_sub_.reset();
+	last_msg_.reset();
 	pcl_manager->remove_pointcloud(pcl_id_.c_str());
 }
 
 void
 DepthcamSimThread::loop()
 {
-	//The interesting stuff happens in the callback of the depthcam
-}
+	if (!last_msg_) {
+		return;
+	}
 
-void
-DepthcamSimThread::on_depthcam_data_msg(ConstPointCloudPtr &msg)
-{
-	// logger->log_info(name(), "Got Point Cloud!");
+	ConstPointCloudPtr msg;
+	msg.swap(last_msg_);
 
-	//only write when pcl is used
-	// if (pcl_.use_count() > 1)
-	// {
-	fawkes::Time capture_time = clock->now();
+	//only write when pcl is used, one reference is held by the manager
+	if (pcl_.use_count() <= 2) {
+		return;
+	}
 
 	pcl::PointCloud<pcl::PointXYZ> &pcl = **pcl_;
 	pcl.header.seq += 1;
-	pcl_utils::set_time(pcl_, capture_time);
+	pcl_utils::set_time(pcl_, last_msg_time_);
 
 	//insert or update points in pointcloud
-	unsigned int idx = 0;
-	for (unsigned int h = 0; h < height_; ++h) {
-		for (unsigned int w = 0; w < width_; ++w, ++idx) {
-			// Fill in XYZ
-			pcl.points[idx].x = msg->points(idx).z();
-			pcl.points[idx].y = -msg->points(idx).x();
-			pcl.points[idx].z = msg->points(idx).y();
-		}
+	const auto & points     = msg->points();
+	const size_t num_points = std::min((size_t)points.size(), pcl.points.size());
+	for (size_t idx = 0; idx < num_points; ++idx) {
+		// Fill in XYZ
+		const gazebo::msgs::Vector3d &p = points.Get(idx);
+		pcl.points[idx].x               = p.z();
+		pcl.points[idx].y               = -p.x();
+		pcl.points[idx].z               = p.y();
 	}
-	// }
+}
+
+void
+DepthcamSimThread::on_depthcam_data_msg(ConstPointCloudPtr &msg)
+{
+	MutexLocker lock(loop_mutex);
+
+	//keep the message, it is converted in the next loop
+	last_msg_ = msg;
+	last_msg_time_.stamp();
 }
@@ -32,6 +32,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 #include <plugins/gazebo/aspect/gazebo.h>
+#include <utils/time/time.h>
 
 #include <string.h>
 
@@ -73,6 +74,10 @@ private:
 	std::string pcl_id_;
 
 	fawkes::RefPtr<pcl::PointCloud<pcl::PointXYZ>> pcl_;
+
+	//latest point cloud message, converted in the next loop
+	ConstPointCloudPtr last_msg_;
+	fawkes::Time       last_msg_time_;
 };
 
 #endif
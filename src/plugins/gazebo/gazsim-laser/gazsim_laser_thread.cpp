@@ -27,6 +27,7 @@
 #include <tf/types.h>
 #include <utils/math/angle.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <gazebo/msgs/msgs.hh>
@@ -38,6 +39,9 @@ using namespace gazebo;
 
 /** @class LaserSimThread "gazsim_laser_thread.h"
  * Thread simulates the Hokuyo in Gazebo
+ * Only the latest message received from Gazebo is converted once per
+ * loop, straight into the data of the interface. If multiple messages
+ * arrive during a loop the older ones are dropped.
  * @author Frederik Zwilling
  */
 
@@ -59,6 +63,12 @@ LaserSimThread::init()
 	interface_id_ = config->get_string("/gazsim/laser/interface-id");
 	frame_id_     = config->get_string("/gazsim/laser/frame-id");
 
+	skip_without_readers_ = false;
+	try {
+		skip_without_readers_ = config->get_bool("/gazsim/laser/skip-without-readers");
+	} catch (Exception &e) {
+	} // ignored, use default
+
 	//open interface
 	laser_if_ = blackboard->open_for_writing<Laser360Interface>(interface_id_.c_str());
 	laser_if_->set_auto_timestamping(false);
@@ -66,10 +76,7 @@ LaserSimThread::init()
 	logger->log_info(name(), "Subscribing to laser topic '%s'", laser_topic_.c_str());
 	laser_sub_ = gazebonode->Subscribe(laser_topic_, &LaserSimThread::on_laser_data_msg, this);
 
-	//initialize laser data
-	laser_data_ = (float *)malloc(sizeof(float) * 360);
 	laser_time_ = new Time(clock);
-	new_data_   = false;
 
 	//set frame in the interface
 	laser_if_->set_frame(frame_id_.c_str());
@@ -78,48 +85,57 @@ LaserSimThread::init()
 void
 LaserSimThread::finalize()
 {
+	laser_sub_.reset();
+	last_msg_.reset();
 	blackboard->close(laser_if_);
-	free(laser_data_);
 	delete laser_time_;
 }
 
 void
 LaserSimThread::loop()
 {
-	if (new_data_) {
-		//write interface
-		laser_if_->set_distances(laser_data_);
-		laser_if_->set_timestamp(laser_time_);
-		laser_if_->write();
-
-		new_data_ = false;
+	if (!last_msg_) {
+		return;
 	}
-}
 
-void
-LaserSimThread::on_laser_data_msg(ConstLaserScanStampedPtr &msg)
-{
-	//logger->log_info(name(), "Got new Laser data.\n");
+	ConstLaserScanStampedPtr msg;
+	msg.swap(last_msg_);
 
-	MutexLocker lock(loop_mutex);
+	if (skip_without_readers_ && laser_if_->num_readers() == 0) {
+		return;
+	}
 
 	const gazebo::msgs::LaserScan &scan = msg->scan();
 
 	//calculate start angle
 	int start_index = (scan.angle_min() + 2 * M_PI) / M_PI * 180;
 
-	int number_beams = scan.ranges_size();
-
-	*laser_time_ = clock->now();
+	int    number_beams = std::min(scan.ranges_size(), 360);
+	auto   ranges       = scan.ranges().data();
+	float *distances    = laser_if_->distances();
 
-	//copy laser data
+	//copy laser data directly into the interface
 	for (int i = 0; i < number_beams; i++) {
-		const float range = scan.ranges(i);
+		const float range = ranges[i];
 		if (range < max_range_) {
-			laser_data_[(start_index + i) % 360] = range;
+			distances[(start_index + i) % 360] = range;
 		} else {
-			laser_data_[(start_index + i) % 360] = NAN;
+			distances[(start_index + i) % 360] = NAN;
 		}
 	}
-	new_data_ = true;
+
+	laser_if_->set_timestamp(laser_time_);
+	laser_if_->write();
+}
+
+void
+LaserSimThread::on_laser_data_msg(ConstLaserScanStampedPtr &msg)
+{
+	//logger->log_info(name(), "Got new Laser data.\n");
+
+	MutexLocker lock(loop_mutex);
+
+	//keep the message, it is converted in the next loop
+	last_msg_    = msg;
+	*laser_time_ = clock->now();
 }
@@ -62,12 +62,9 @@ private:
 	///provided interface
 	fawkes::Laser360Interface *laser_if_;
 
-	///storage for laser data
-	float *       laser_data_;
-	fawkes::Time *laser_time_;
-
-	///is there new information to write in the interface?
-	bool new_data_;
+	///latest laser message, converted in the next loop
+	ConstLaserScanStampedPtr last_msg_;
+	fawkes::Time *           laser_time_;
 
 	///handler function for incoming laser data messages
 	void on_laser_data_msg(ConstLaserScanStampedPtr &msg);
@@ -77,6 +74,9 @@ private:
 
 	std::string interface_id_;
 	std::string frame_id_;
+
+	///only convert data if the interface has readers
+	bool skip_without_readers_;
 };
 
 #endif
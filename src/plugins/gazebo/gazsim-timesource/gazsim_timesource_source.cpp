@@ -35,6 +35,9 @@ GazsimTimesource::GazsimTimesource(Clock *clock)
 	last_sim_time_         = get_system_time();
 	last_real_time_factor_ = 1.0;
 	clock_->get_systime(&last_sys_recv_time_);
+	lockstep_             = false;
+	lockstep_time_usec_   = 0;
+	lockstep_native_usec_ = -1;
 	//registration will be done by plugin
 }
 
@@ -50,6 +53,14 @@ GazsimTimesource::~GazsimTimesource()
 void
 GazsimTimesource::get_time(timeval *tv) const
 {
+	if (lockstep_) {
+		// the simulation only advances when stepped, do not extrapolate
+		int64_t usec = lockstep_time_usec_.load(std::memory_order_relaxed);
+		tv->tv_sec   = usec / 1000000;
+		tv->tv_usec  = usec % 1000000;
+		return;
+	}
+
 	//I do not use the Time - operator here because this would recursively call get_time
 	timeval now      = get_system_time();
 	timeval interval = subtract(now, last_sys_recv_time_);
@@ -104,6 +115,16 @@ GazsimTimesource::conv_native_to_exttime(const timeval *tv) const
 void
 GazsimTimesource::on_time_sync_msg(ConstSimTimePtr &msg)
 {
+	if (lockstep_) {
+		// advance by the simulated time which passed since the last message
+		int64_t native_usec = msg->sim_time_sec() * 1000000 + msg->sim_time_nsec() / 1000;
+		if (lockstep_native_usec_ >= 0 && native_usec > lockstep_native_usec_) {
+			lockstep_time_usec_.fetch_add(native_usec - lockstep_native_usec_,
+			                              std::memory_order_relaxed);
+		}
+		lockstep_native_usec_ = native_usec;
+	}
+
 	//we do not want to correct time back
 	get_time(&last_sim_time_);
 	last_real_time_factor_ = msg->real_time_factor();
@@ -112,6 +133,25 @@ GazsimTimesource::on_time_sync_msg(ConstSimTimePtr &msg)
 	last_native_sim_time_.tv_usec = msg->sim_time_nsec() / 1000;
 }
 
+/** Enable or disable lockstep mode.
+ * In lockstep mode the simulation is paused and stepped by the main
+ * loop. The time then is not extrapolated using the real time factor,
+ * it only advances by the simulated time reported by Gazebo.
+ * Must be called before the time source is registered.
+ * @param lockstep true to enable lockstep mode
+ */
+void
+GazsimTimesource::set_lockstep(bool lockstep)
+{
+	if (lockstep && !lockstep_) {
+		timeval now;
+		get_time(&now);
+		lockstep_time_usec_   = (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+		lockstep_native_usec_ = -1;
+	}
+	lockstep_ = lockstep;
+}
+
 timeval
 GazsimTimesource::get_system_time() const
 {
@@ -25,7 +25,9 @@
 #include <utils/time/clock.h>
 #include <utils/time/timesource.h>
 
+#include <atomic>
 #include <boost/asio.hpp>
+#include <cstdint>
 
 #ifndef _GAZEBO_TIMESOURCE_H_
 #	define _GAZEBO_TIMESOURCE_H_
@@ -52,6 +54,8 @@ public:
 	/// store data from gazebo time message
 	void on_time_sync_msg(ConstSimTimePtr &msg);
 
+	void set_lockstep(bool lockstep);
+
 private:
 	timeval get_system_time() const;
 	timeval add(timeval a, timeval b) const;
@@ -65,6 +69,10 @@ private:
 	timeval last_sys_recv_time_;
 	double  last_real_time_factor_;
 	timeval last_native_sim_time_;
+
+	bool                 lockstep_;
+	std::atomic<int64_t> lockstep_time_usec_;
+	int64_t              lockstep_native_usec_;
 };
 
 } // namespace fawkes
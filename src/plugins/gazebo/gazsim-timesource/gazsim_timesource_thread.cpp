@@ -22,10 +22,26 @@
 
 #include "gazsim_timesource_thread.h"
 
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+
+#include <algorithm>
+#include <cmath>
+
 using namespace fawkes;
 
 /** @class GazsimTimesourceThread "clips_thread.h"
  * Plugin provides the simulation time from gazebo
+ *
+ * In lockstep mode the simulation is paused and stepped by one main
+ * loop time in each loop. The thread then waits until Gazebo reports
+ * the new simulation time. Fawkes does not wait for the loop time to
+ * pass in real time, the simulation thus runs as fast as the main
+ * loop and the simulator allow. Only threads which are woken up by the
+ * main loop and which measure time with the Fawkes clock are in sync
+ * with the simulation, continuous threads or threads sleeping in real
+ * time will observe a different time scale.
  * @author Frederik Zwilling
  */
 
@@ -52,22 +68,98 @@ GazsimTimesourceThread::init()
 	//Create Time Source
 	time_source_ = new GazsimTimesource(clock);
 
+	lockstep_       = false;
+	sim_time_usec_  = -1;
+	sim_time_mutex_ = new Mutex();
+	sim_time_cond_  = new WaitCondition(sim_time_mutex_);
+	try {
+		lockstep_ = config->get_bool("/gazsim/timesource/lockstep");
+	} catch (Exception &e) {
+	} // ignored, use default
+
+	if (lockstep_) {
+		lockstep_step_usec_ = 100000;
+		float physics_step  = 0.001;
+		lockstep_timeout_   = 1.0;
+		try {
+			lockstep_step_usec_ = config->get_uint("/fawkes/mainapp/desired_loop_time");
+		} catch (Exception &e) {
+		} // ignored, use default
+		try {
+			physics_step = config->get_float("/gazsim/timesource/physics-step");
+		} catch (Exception &e) {
+		} // ignored, use default
+		try {
+			lockstep_timeout_ = config->get_float("/gazsim/timesource/lockstep-timeout");
+		} catch (Exception &e) {
+		} // ignored, use default
+		lockstep_steps_ = std::max(1L, std::lround(lockstep_step_usec_ / 1000000. / physics_step));
+
+		world_control_pub_ =
+		  gazebo_world_node->Advertise<gazebo::msgs::WorldControl>("~/world_control");
+		publish_world_control(/* pause */ true);
+		time_source_->set_lockstep(true);
+		logger->log_info(name(),
+		                 "Lockstep mode, stepping %u physics steps per loop",
+		                 lockstep_steps_);
+	}
+
 	//register timesource and make it default
 	clock->register_ext_timesource(time_source_, true);
+	if (lockstep_) {
+		clock->set_lockstep(true);
+	}
 }
 
 void
 GazsimTimesourceThread::finalize()
 {
+	time_sync_sub_.reset();
+
 	//remove time source
 	clock->remove_ext_timesource(time_source_);
+	if (lockstep_) {
+		publish_world_control(/* pause */ false);
+	}
 	delete time_source_;
+	delete sim_time_cond_;
+	delete sim_time_mutex_;
 }
 
 void
 GazsimTimesourceThread::loop()
 {
-	//nothing interesting
+	if (!lockstep_) {
+		return;
+	}
+
+	MutexLocker lock(sim_time_mutex_);
+	bool        had_time = (sim_time_usec_ >= 0);
+	int64_t     target   = sim_time_usec_ + lockstep_step_usec_;
+	publish_world_control(/* pause */ true, lockstep_steps_);
+
+	// without a time, yet, wait for the first message only
+	unsigned int timeout_sec  = (unsigned int)lockstep_timeout_;
+	unsigned int timeout_nsec = (unsigned int)((lockstep_timeout_ - timeout_sec) * 1e9);
+	while (had_time ? (sim_time_usec_ < target) : (sim_time_usec_ < 0)) {
+		if (!sim_time_cond_->reltimed_wait(timeout_sec, timeout_nsec)) {
+			logger->log_warn(name(),
+			                 "Simulation did not advance within %f sec, continuing",
+			                 lockstep_timeout_);
+			break;
+		}
+	}
+}
+
+void
+GazsimTimesourceThread::publish_world_control(bool pause, unsigned int steps)
+{
+	gazebo::msgs::WorldControl ctrl;
+	ctrl.set_pause(pause);
+	if (steps > 0) {
+		ctrl.set_multi_step(steps);
+	}
+	world_control_pub_->Publish(ctrl);
 }
 
 void
@@ -77,4 +169,8 @@ GazsimTimesourceThread::on_time_sync_msg(ConstSimTimePtr &msg)
 
 	//provide time source with newest message
 	time_source_->on_time_sync_msg(msg);
+
+	MutexLocker lock(sim_time_mutex_);
+	sim_time_usec_ = msg->sim_time_sec() * 1000000 + msg->sim_time_nsec() / 1000;
+	sim_time_cond_->wake_all();
 }
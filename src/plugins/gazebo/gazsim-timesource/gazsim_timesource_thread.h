@@ -35,8 +35,15 @@
 #include <plugins/gazebo/aspect/gazebo.h>
 
 #include <boost/asio.hpp>
+#include <cstdint>
+#include <gazebo/msgs/msgs.hh>
 #include <gazebo/physics/physics.hh>
 
+namespace fawkes {
+class Mutex;
+class WaitCondition;
+} // namespace fawkes
+
 typedef const boost::shared_ptr<gazsim_msgs::SimTime const> ConstSimTimePtr;
 
 class GazsimTimesourceThread : public fawkes::Thread,
@@ -61,6 +68,18 @@ private:
 	//subscriber to get time msgs from
 	gazebo::transport::SubscriberPtr time_sync_sub_;
 
+	//lockstep mode, the simulation is stepped once per main loop
+	bool                            lockstep_;
+	unsigned int                    lockstep_steps_;
+	int64_t                         lockstep_step_usec_;
+	float                           lockstep_timeout_;
+	gazebo::transport::PublisherPtr world_control_pub_;
+	fawkes::Mutex *                 sim_time_mutex_;
+	fawkes::WaitCondition *         sim_time_cond_;
+	int64_t                         sim_time_usec_;
+
+	void publish_world_control(bool pause, unsigned int steps = 0);
+
 	//handler
 	void on_time_sync_msg(ConstSimTimePtr &msg);
 };
@@ -44,6 +44,7 @@ VisLocalizationThread::VisLocalizationThread()
 : Thread("VisLocalizationThread", Thread::OPMODE_WAITFORWAKEUP),
   BlockedTimingAspect(BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE)
 {
+	set_blocked_timing_criticality(CRITICALITY_LOW);
 }
 
 void
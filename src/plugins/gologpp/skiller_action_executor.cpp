@@ -50,6 +50,11 @@ InvalidArgumentException::InvalidArgumentException(const char *format, ...) : Ex
  * An ActionExecutor that executes an activity using the Skiller.
  * An action is translated to a skill using the skill mapping from the configuration.
  * If the Skiller's status changes, the activity's status is updated accordingly.
+ * The status is not polled, the update is triggered by the data listener of the
+ * Skiller interface and only passed to golog++, which queues the transition for
+ * its execution context. Status updates are only considered if they refer to
+ * the ExecSkillMessage of the running activity, a stale final or failed status
+ * of the previous skill thus does not end the new activity.
  * @author Till Hofmann
  * @see ActionSkillMapping
  *
@@ -77,7 +82,9 @@ SkillerActionExecutor::SkillerActionExecutor(Logger *           logger,
   blackboard_(blackboard),
   blackboard_owner_(false),
   config_(config),
-  cfg_prefix_(cfg_prefix)
+  cfg_prefix_(cfg_prefix),
+  exec_msgid_(0),
+  start_reported_(false)
 {
 	try {
 		skiller_if_ = blackboard_->open_for_reading<SkillerInterface>("Skiller");
@@ -147,9 +154,12 @@ SkillerActionExecutor::start(std::shared_ptr<gologpp::Activity> activity)
 		                activity->mapped_name().c_str());
 	}
 	try {
-		skiller_if_->msgq_enqueue(
-		  new SkillerInterface::ExecSkillMessage(map_activity_to_skill(activity).c_str()));
+		SkillerInterface::ExecSkillMessage *msg =
+		  new SkillerInterface::ExecSkillMessage(map_activity_to_skill(activity).c_str());
+		std::lock_guard<std::mutex> lock(activity_mutex_);
+		exec_msgid_       = skiller_if_->msgq_enqueue(msg);
 		running_activity_ = activity;
+		start_reported_   = false;
 	} catch (InvalidArgumentException &e) {
 		logger_->log_error(name(), "Failed to start %s: %s", activity->name().c_str(), e.what());
 		activity->update(Transition::Hook::FAIL);
@@ -163,7 +173,8 @@ SkillerActionExecutor::start(std::shared_ptr<gologpp::Activity> activity)
 void
 SkillerActionExecutor::stop(std::shared_ptr<gologpp::Grounding<gologpp::Action>> activity)
 {
-	if (*running_activity_ == *activity) {
+	std::lock_guard<std::mutex> lock(activity_mutex_);
+	if (running_activity_ && *running_activity_ == *activity) {
 		skiller_if_->msgq_enqueue(new SkillerInterface::StopExecMessage());
 		running_activity_.reset();
 	}
@@ -211,11 +222,14 @@ SkillerActionExecutor::map_activity_to_skill(std::shared_ptr<gologpp::Activity>
 }
 
 /** Update the status of the activity according to the Skiller status.
+ * This is called from the thread writing the interface. The activity is only
+ * started once and updates for other skill executions are ignored.
  * @param iface The interface that has changed
  */
 void
 SkillerActionExecutor::bb_interface_data_refreshed(Interface *iface) noexcept
 {
+	std::lock_guard<std::mutex> lock(activity_mutex_);
 	if (!running_activity_) {
 		return;
 	}
@@ -224,6 +238,9 @@ SkillerActionExecutor::bb_interface_data_refreshed(Interface *iface) noexcept
 		return;
 	}
 	skiller_if->read();
+	if (skiller_if->msgid() != exec_msgid_) {
+		return;
+	}
 	switch (skiller_if->status()) {
 	case SkillerInterface::S_FINAL:
 		running_activity_->update(Transition::Hook::FINISH);
@@ -233,7 +250,12 @@ SkillerActionExecutor::bb_interface_data_refreshed(Interface *iface) noexcept
 		running_activity_->update(Transition::Hook::FAIL);
 		running_activity_.reset();
 		break;
-	case SkillerInterface::S_RUNNING: running_activity_->update(Transition::Hook::START); break;
+	case SkillerInterface::S_RUNNING:
+		if (!start_reported_) {
+			running_activity_->update(Transition::Hook::START);
+			start_reported_ = true;
+		}
+		break;
 	default: break;
 	}
 }
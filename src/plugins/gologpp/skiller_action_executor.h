@@ -26,6 +26,7 @@
 #include <blackboard/interface_listener.h>
 #include <utils/misc/map_skill.h>
 
+#include <mutex>
 #include <string>
 
 namespace fawkes {
@@ -66,6 +67,9 @@ private:
 	SkillerInterface * skiller_if_;
 	Configuration *    config_;
 	const std::string  cfg_prefix_;
+	std::mutex         activity_mutex_;
+	unsigned int       exec_msgid_;
+	bool               start_reported_;
 };
 
 } // namespace gpp
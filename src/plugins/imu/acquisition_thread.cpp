@@ -22,7 +22,9 @@
 #include "acquisition_thread.h"
 
 #include <core/threading/mutex.h>
+#include <interfaces/IMUBatchInterface.h>
 #include <interfaces/IMUInterface.h>
+#include <utils/time/time.h>
 
 #include <cstdlib>
 #include <cstring>
@@ -30,9 +32,19 @@
 
 using namespace fawkes;
 
+/** Number of samples queued between acquisition and consumer. */
+#define SAMPLE_QUEUE_SIZE 256
+
 /** @class IMUAcquisitionThread "acquisition_thread.h"
  * IMU acqusition thread.
  * Interface for different laser types.
+ *
+ * Besides the most recent data, sub-classes push every sample they
+ * receive into a lock-free queue with push_sample(). The consumer, i.e.
+ * the sensor thread or the acquisition thread itself if running
+ * continuous, publishes all queued samples with publish_samples() to an
+ * IMUBatchInterface and the newest one to the IMUInterface, without
+ * locking the acquisition thread.
  * @author Tim Niemueller
  */
 
@@ -103,7 +115,11 @@ IMUAcquisitionThread::IMUAcquisitionThread(const char *       thread_name,
 : Thread(thread_name, Thread::OPMODE_CONTINUOUS),
   cfg_name_(cfg_name),
   cfg_prefix_(cfg_prefix),
-  cfg_continuous_(continuous)
+  cfg_continuous_(continuous),
+  samples_(SAMPLE_QUEUE_SIZE),
+  sample_seq_(0),
+  dropped_samples_(0),
+  batch_(SAMPLE_QUEUE_SIZE)
 {
 	data_mutex_ = new Mutex();
 	timestamp_  = new Time();
@@ -135,8 +151,9 @@ IMUAcquisitionThread::init()
 	if (!cfg_continuous_)
 		return;
 
-	imu_if_    = NULL;
-	cfg_frame_ = config->get_string((cfg_prefix_ + "frame").c_str());
+	imu_if_       = NULL;
+	imu_batch_if_ = NULL;
+	cfg_frame_    = config->get_string((cfg_prefix_ + "frame").c_str());
 
 	std::string if_id = "IMU " + cfg_name_;
 
@@ -144,29 +161,129 @@ IMUAcquisitionThread::init()
 	imu_if_->set_auto_timestamping(false);
 	imu_if_->set_frame(cfg_frame_.c_str());
 	imu_if_->write();
+
+	try {
+		imu_batch_if_ = blackboard->open_for_writing<IMUBatchInterface>(if_id.c_str());
+	} catch (Exception &e) {
+		blackboard->close(imu_if_);
+		throw;
+	}
+	imu_batch_if_->set_auto_timestamping(false);
+	imu_batch_if_->set_frame(cfg_frame_.c_str());
+	imu_batch_if_->write();
 }
 
 void
 IMUAcquisitionThread::finalize()
 {
+	blackboard->close(imu_batch_if_);
 	blackboard->close(imu_if_);
 }
 
 void
 IMUAcquisitionThread::loop()
 {
-	data_mutex_->lock();
-	if (new_data_) {
-		imu_if_->set_timestamp(timestamp_);
-		imu_if_->set_orientation(orientation_);
-		imu_if_->set_orientation_covariance(orientation_covariance_);
-		imu_if_->set_angular_velocity(angular_velocity_);
-		imu_if_->set_angular_velocity_covariance(angular_velocity_covariance_);
-		imu_if_->set_linear_acceleration(linear_acceleration_);
-		imu_if_->set_linear_acceleration_covariance(linear_acceleration_covariance_);
-		imu_if_->write();
+	publish_samples(imu_if_, imu_batch_if_);
+}
+
+/** Queue the current data as sample.
+ * Copies the current orientation, angular velocity, linear acceleration
+ * and timestamp into the sample queue. Sub-classes must call this once
+ * for every sample they receive. If the queue is full the sample is
+ * dropped. Must only be called from the acquisition thread.
+ */
+void
+IMUAcquisitionThread::push_sample()
+{
+	imu_sample_t sample;
+	sample.stamp_usec = timestamp_->in_usec();
+	sample.sequence   = sample_seq_++;
+	memcpy(sample.orientation, orientation_, sizeof(sample.orientation));
+	memcpy(sample.angular_velocity, angular_velocity_, sizeof(sample.angular_velocity));
+	memcpy(sample.linear_acceleration, linear_acceleration_, sizeof(sample.linear_acceleration));
+	if (!samples_.try_push(sample)) {
+		dropped_samples_.fetch_add(1, std::memory_order_relaxed);
 	}
-	data_mutex_->unlock();
+}
+
+/** Get queued samples.
+ * Must only be called from one consumer thread.
+ * @param samples array to store the samples in, ordered from oldest to newest
+ * @param max_samples maximum number of samples to store in the array
+ * @return number of samples stored in the array
+ */
+size_t
+IMUAcquisitionThread::pop_samples(imu_sample_t *samples, size_t max_samples)
+{
+	size_t n = 0;
+	while (n < max_samples && samples_.try_pop(samples[n])) {
+		++n;
+	}
+	return n;
+}
+
+/** Get number of dropped samples.
+ * @return number of samples which were dropped because the queue was full
+ * or more samples were queued than fit into one batch
+ */
+unsigned int
+IMUAcquisitionThread::num_dropped_samples() const
+{
+	return dropped_samples_.load(std::memory_order_relaxed);
+}
+
+/** Publish queued samples.
+ * Writes all samples queued since the last call to the batch interface
+ * and the newest sample to the IMU interface. If more samples are queued
+ * than fit into one batch, the oldest are dropped. Nothing is written if
+ * no sample has been queued. Must only be called from one consumer
+ * thread. The covariances are only set on initialization and are hence
+ * read without locking.
+ * @param imu_if interface to write the newest sample to
+ * @param batch_if interface to write all samples to
+ */
+void
+IMUAcquisitionThread::publish_samples(IMUInterface *imu_if, IMUBatchInterface *batch_if)
+{
+	const size_t max_samples = batch_if->maxlenof_timestamps();
+
+	imu_sample_t sample;
+	while (samples_.size() > max_samples && samples_.try_pop(sample)) {
+		dropped_samples_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const size_t num_samples = pop_samples(&batch_[0], max_samples);
+	if (num_samples == 0)
+		return;
+
+	for (unsigned int i = 0; i < num_samples; ++i) {
+		batch_if->set_timestamps(i, batch_[i].stamp_usec);
+		for (unsigned int j = 0; j < 4; ++j) {
+			batch_if->set_orientation(4 * i + j, batch_[i].orientation[j]);
+		}
+		for (unsigned int j = 0; j < 3; ++j) {
+			batch_if->set_angular_velocity(3 * i + j, batch_[i].angular_velocity[j]);
+			batch_if->set_linear_acceleration(3 * i + j, batch_[i].linear_acceleration[j]);
+		}
+	}
+
+	const imu_sample_t &newest = batch_[num_samples - 1];
+	Time                stamp(newest.stamp_usec / 1000000, newest.stamp_usec % 1000000);
+
+	batch_if->set_timestamp(&stamp);
+	batch_if->set_num_samples(num_samples);
+	batch_if->set_sequence(batch_[0].sequence);
+	batch_if->set_dropped(num_dropped_samples());
+	batch_if->write();
+
+	imu_if->set_timestamp(&stamp);
+	imu_if->set_orientation(newest.orientation);
+	imu_if->set_orientation_covariance(orientation_covariance_);
+	imu_if->set_angular_velocity(newest.angular_velocity);
+	imu_if->set_angular_velocity_covariance(angular_velocity_covariance_);
+	imu_if->set_linear_acceleration(newest.linear_acceleration);
+	imu_if->set_linear_acceleration_covariance(linear_acceleration_covariance_);
+	imu_if->write();
 }
 
 /** Lock data if fresh.
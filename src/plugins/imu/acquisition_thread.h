@@ -27,6 +27,11 @@
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
 #include <core/threading/thread.h>
+#include <core/utils/spsc_ring_buffer.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 namespace fawkes {
 class Mutex;
@@ -34,8 +39,19 @@ class Configuration;
 class Logger;
 class Time;
 class IMUInterface;
+class IMUBatchInterface;
 } // namespace fawkes
 
+/** Timestamped IMU sample. */
+typedef struct
+{
+	int64_t  stamp_usec;             /**< time of the sample in microseconds since the epoch */
+	uint64_t sequence;               /**< sequence number of the sample */
+	float    orientation[4];         /**< orientation quaternion (x, y, z, w) */
+	float    angular_velocity[3];    /**< angular velocity (x, y, z) */
+	float    linear_acceleration[3]; /**< linear acceleration (x, y, z) */
+} imu_sample_t;
+
 class IMUAcquisitionThread : public fawkes::Thread,
                              public fawkes::LoggingAspect,
                              public fawkes::ConfigurableAspect,
@@ -52,6 +68,10 @@ public:
 	bool lock_if_new_data();
 	void unlock();
 
+	size_t       pop_samples(imu_sample_t *samples, size_t max_samples);
+	unsigned int num_dropped_samples() const;
+	void         publish_samples(fawkes::IMUInterface *imu_if, fawkes::IMUBatchInterface *batch_if);
+
 	// must be called from sub-classes in continuous case
 	virtual void init();
 	virtual void loop();
@@ -122,6 +142,8 @@ protected:
 	}
 
 protected:
+	void push_sample();
+
 	std::string cfg_name_;
 	std::string cfg_prefix_;
 	std::string cfg_frame_;
@@ -141,7 +163,15 @@ protected:
 
 private:
 	// only used if continuous
-	fawkes::IMUInterface *imu_if_;
+	fawkes::IMUInterface *     imu_if_;
+	fawkes::IMUBatchInterface *imu_batch_if_;
+
+	fawkes::SpscRingBuffer<imu_sample_t> samples_;
+	uint64_t                             sample_seq_;
+	std::atomic<unsigned int>            dropped_samples_;
+
+	// only used by the consumer
+	std::vector<imu_sample_t> batch_;
 };
 
 #endif
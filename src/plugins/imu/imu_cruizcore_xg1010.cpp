@@ -25,6 +25,7 @@
 #include <core/threading/mutex_locker.h>
 #include <tf/types.h>
 #include <utils/math/angle.h>
+#include <utils/time/time.h>
 #ifdef USE_TIMETRACKER
 #	include <utils/time/tracker.h>
 #endif
@@ -224,6 +225,7 @@ CruizCoreXG1010AcquisitionThread::loop()
 				data_mutex_->lock();
 				new_data_ = true;
 				data_mutex_->unlock();
+				push_sample();
 				close_device();
 			} else {
 				TIMETRACK_START(ttc_catch_up_);
@@ -282,34 +284,47 @@ CruizCoreXG1010AcquisitionThread::loop()
 				data_mutex_->lock();
 				new_data_ = true;
 				data_mutex_->unlock();
+				push_sample();
 				close_device();
 			} else {
 				if (input_buffer_.size() >= CRUIZCORE_XG1010_PACKET_SIZE) {
 					TIMETRACK_START(ttc_parse_);
-					if (input_buffer_.size() > CRUIZCORE_XG1010_PACKET_SIZE) {
-						input_buffer_.consume(input_buffer_.size() - CRUIZCORE_XG1010_PACKET_SIZE);
-					}
+					// packets are aligned to the end of the buffer, skip partial data in front
+					input_buffer_.consume(input_buffer_.size() % CRUIZCORE_XG1010_PACKET_SIZE);
+
+					// parse all packets we caught up with, not only the newest one, the
+					// older ones have been sent one data period earlier each
+					const size_t num_packets = input_buffer_.size() / CRUIZCORE_XG1010_PACKET_SIZE;
+					const Time   read_time(timestamp_);
 					std::istream in_stream(&input_buffer_);
-					in_stream.read((char *)in_packet_, CRUIZCORE_XG1010_PACKET_SIZE);
-
-					/*
-	  printf("Packet (%zu): ", bytes_read_);
-	  for (size_t i = 0; i < bytes_read_; ++i) {
-	    printf("%x ", in_packet_[i] & 0xff);
-	  }
-	  printf("\n");
-	  */
-
-					try {
-						parse_packet();
-					} catch (Exception &e) {
-						logger->log_warn(name(), e);
+					for (size_t p = 0; p < num_packets; ++p) {
+						in_stream.read((char *)in_packet_, CRUIZCORE_XG1010_PACKET_SIZE);
+
+						/*
+	    printf("Packet (%zu): ", bytes_read_);
+	    for (size_t i = 0; i < bytes_read_; ++i) {
+	      printf("%x ", in_packet_[i] & 0xff);
+	    }
+	    printf("\n");
+	    */
+
+						data_mutex_->lock();
+						*timestamp_ = read_time - (double)(num_packets - 1 - p) / cfg_freq_;
+						data_mutex_->unlock();
+
 						try {
-							resync();
-							logger->log_info(name(), "Successfully resynced");
+							parse_packet();
+							push_sample();
 						} catch (Exception &e) {
-							logger->log_warn(name(), "Resync failed, trying to re-open");
-							close_device();
+							logger->log_warn(name(), e);
+							try {
+								resync();
+								logger->log_info(name(), "Successfully resynced");
+							} catch (Exception &e) {
+								logger->log_warn(name(), "Resync failed, trying to re-open");
+								close_device();
+							}
+							break;
 						}
 					}
 					TIMETRACK_END(ttc_parse_);
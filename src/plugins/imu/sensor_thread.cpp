@@ -24,6 +24,7 @@
 
 #include "acquisition_thread.h"
 
+#include <interfaces/IMUBatchInterface.h>
 #include <interfaces/IMUInterface.h>
 
 using namespace fawkes;
@@ -31,7 +32,9 @@ using namespace fawkes;
 /** @class IMUSensorThread "sensor_thread.h"
  * IMU sensor thread.
  * This thread integrates into the Fawkes main loop at the sensor hook and
- * publishes new data when available from the IMUAcquisitionThread.
+ * publishes new data when available from the IMUAcquisitionThread. All
+ * samples received since the last loop are published to an
+ * IMUBatchInterface, the newest one to the IMUInterface.
  * @author Tim Niemueller
  */
 
@@ -55,7 +58,8 @@ IMUSensorThread::IMUSensorThread(std::string &         cfg_name,
 void
 IMUSensorThread::init()
 {
-	imu_if_ = NULL;
+	imu_if_       = NULL;
+	imu_batch_if_ = NULL;
 
 	cfg_frame_ = config->get_string((cfg_prefix_ + "frame").c_str());
 
@@ -65,26 +69,27 @@ IMUSensorThread::init()
 	imu_if_->set_auto_timestamping(false);
 	imu_if_->set_frame(cfg_frame_.c_str());
 	imu_if_->write();
+
+	try {
+		imu_batch_if_ = blackboard->open_for_writing<IMUBatchInterface>(if_id.c_str());
+	} catch (Exception &e) {
+		blackboard->close(imu_if_);
+		throw;
+	}
+	imu_batch_if_->set_auto_timestamping(false);
+	imu_batch_if_->set_frame(cfg_frame_.c_str());
+	imu_batch_if_->write();
 }
 
 void
 IMUSensorThread::finalize()
 {
+	blackboard->close(imu_batch_if_);
 	blackboard->close(imu_if_);
 }
 
 void
 IMUSensorThread::loop()
 {
-	if (aqt_->lock_if_new_data()) {
-		imu_if_->set_timestamp(aqt_->get_timestamp());
-		imu_if_->set_orientation(aqt_->get_orientation());
-		imu_if_->set_orientation_covariance(aqt_->get_orientation_covariance());
-		imu_if_->set_angular_velocity(aqt_->get_angular_velocity());
-		imu_if_->set_angular_velocity_covariance(aqt_->get_angular_velocity_covariance());
-		imu_if_->set_linear_acceleration(aqt_->get_linear_acceleration());
-		imu_if_->set_linear_acceleration_covariance(aqt_->get_linear_acceleration_covariance());
-		imu_if_->write();
-		aqt_->unlock();
-	}
+	aqt_->publish_samples(imu_if_, imu_batch_if_);
 }
@@ -33,7 +33,8 @@
 
 namespace fawkes {
 class IMUInterface;
-}
+class IMUBatchInterface;
+} // namespace fawkes
 
 class IMUAcquisitionThread;
 
@@ -59,7 +60,8 @@ protected:
 	}
 
 private:
-	fawkes::IMUInterface *imu_if_;
+	fawkes::IMUInterface *     imu_if_;
+	fawkes::IMUBatchInterface *imu_batch_if_;
 
 	IMUAcquisitionThread *aqt_;
 
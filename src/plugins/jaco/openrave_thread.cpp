@@ -68,6 +68,9 @@ JacoOpenraveThread::JacoOpenraveThread(const char *name, jaco_arm_t *arm, bool l
 	planner_env_.env   = NULL;
 	planner_env_.robot = NULL;
 	planner_env_.manip = NULL;
+	ik_env_.env        = NULL;
+	ik_env_.robot      = NULL;
+	ik_env_.manip      = NULL;
 
 	plotted_current_ = false;
 #endif
@@ -163,30 +166,48 @@ JacoOpenraveThread::_post_init()
 		usleep(100);
 	}
 
-	// create cloned environment for planning
-	logger->log_debug(name(), "Clone environment for planning");
+	// create cloned environment for planning. IK checks of new targets get
+	// their own environment, such that they need not wait for the planner
+	logger->log_debug(name(), "Clone environments for planning and IK");
 	openrave->clone(planner_env_.env, planner_env_.robot, planner_env_.manip);
+	openrave->clone(ik_env_.env, ik_env_.robot, ik_env_.manip);
 
-	if (!planner_env_.env || !planner_env_.robot || !planner_env_.manip) {
+	if (!planner_env_.env || !planner_env_.robot || !planner_env_.manip || !ik_env_.env
+	    || !ik_env_.robot || !ik_env_.manip) {
 		throw fawkes::Exception("Could not clone properly, received a NULL pointer");
 	}
 
 	// set name of environment
 	switch (arm_->config) {
-	case CONFIG_SINGLE: planner_env_.env->set_name("Planner"); break;
+	case CONFIG_SINGLE:
+		planner_env_.env->set_name("Planner");
+		ik_env_.env->set_name("IK");
+		break;
 
-	case CONFIG_LEFT: planner_env_.env->set_name("Planner_Left"); break;
+	case CONFIG_LEFT:
+		planner_env_.env->set_name("Planner_Left");
+		ik_env_.env->set_name("IK_Left");
+		break;
 
-	case CONFIG_RIGHT: planner_env_.env->set_name("Planner_Right"); break;
+	case CONFIG_RIGHT:
+		planner_env_.env->set_name("Planner_Right");
+		ik_env_.env->set_name("IK_Right");
+		break;
 	}
 
-	// set active manipulator in planning environment
+	// set active manipulator in planning and IK environment
 	{
 		EnvironmentMutex::scoped_lock lock(planner_env_.env->get_env_ptr()->GetMutex());
 		RobotBase::ManipulatorPtr     manip =
 		  planner_env_.robot->get_robot_ptr()->SetActiveManipulator(cfg_manipname_);
 		planner_env_.robot->get_robot_ptr()->SetActiveDOFs(manip->GetArmIndices());
 	}
+	{
+		EnvironmentMutex::scoped_lock lock(ik_env_.env->get_env_ptr()->GetMutex());
+		RobotBase::ManipulatorPtr     manip =
+		  ik_env_.robot->get_robot_ptr()->SetActiveManipulator(cfg_manipname_);
+		ik_env_.robot->get_robot_ptr()->SetActiveDOFs(manip->GetArmIndices());
+	}
 
 	// Get chain of links from arm base to manipulator in viewer_env. Used for plotting joints
 	robot_->GetChain(manip_->GetBase()->GetIndex(), manip_->GetEndEffector()->GetIndex(), links_);
@@ -205,6 +226,9 @@ JacoOpenraveThread::finalize()
 	planner_env_.robot = NULL;
 	planner_env_.manip = NULL;
 	planner_env_.env   = NULL;
+	ik_env_.robot      = NULL;
+	ik_env_.manip      = NULL;
+	ik_env_.env        = NULL;
 
 	JacoOpenraveBaseThread::finalize();
 #endif
@@ -359,6 +383,8 @@ JacoOpenraveThread::update_openrave()
  * The IK is solved, ignoring collisions of the end-effector with the environment.
  * We do this to generally decide if IK is generally solvable. Collision checking
  * is done in a later step in JacoOpenraveThread::_plan_path .
+ * The IK is solved in an environment of its own, hence this does not block
+ * while a trajectory is being planned.
  *
  * If IK is solvable, the target is enqueued in the target_queue.
  *
@@ -378,14 +404,17 @@ JacoOpenraveThread::add_target(float x, float y, float z, float e1, float e2, fl
 
 #ifdef HAVE_OPENRAVE
 	try {
+		// IK is checked in a separate environment, planning may be running concurrently
+		_sync_env(ik_env_);
+
 		// update planner params; set correct DOF and stuff
-		planner_env_.robot->get_planner_params();
+		ik_env_.robot->get_planner_params();
 
 		if (plan) {
 			// get IK from openrave. Ignore collisions with env though, as this is only for IK check and env might change at the
 			//  time we start planning. There will be separate IK checks though for planning!
-			planner_env_.robot->enable_ik_comparison(false);
-			solvable = planner_env_.robot->set_target_euler(
+			ik_env_.robot->enable_ik_comparison(false);
+			solvable = ik_env_.robot->set_target_euler(
 			  EULER_ZXZ, x, y, z, e1, e2, e3, IKFO_IgnoreEndEffectorEnvCollisions);
 
 			if (solvable) {
@@ -416,7 +445,7 @@ JacoOpenraveThread::add_target(float x, float y, float z, float e1, float e2, fl
 
 			// get IK from openrave. Do not ignore collisions this time, because we skip planning
 			//  and go straight to this configuration!
-			solvable = planner_env_.robot->set_target_euler(EULER_ZXZ, x, y, z, e1, e2, e3);
+			solvable = ik_env_.robot->set_target_euler(EULER_ZXZ, x, y, z, e1, e2, e3);
 
 			if (solvable) {
 				logger->log_debug(name(), "Skip planning, add this as TARGET_ANGULAR");
@@ -427,7 +456,7 @@ JacoOpenraveThread::add_target(float x, float y, float z, float e1, float e2, fl
 				target->trajec_state = TRAJEC_SKIP;
 				target->coord        = false;
 				// get target IK values
-				planner_env_.robot->get_target().manip->get_angles_device(target->pos);
+				ik_env_.robot->get_target().manip->get_angles_device(target->pos);
 
 				arm_->target_mutex->lock();
 				arm_->target_queue->push_back(target);
@@ -555,46 +584,46 @@ JacoOpenraveThread::set_target_ang(float j1,
 	return add_target_ang(j1, j2, j3, j4, j5, j6, plan);
 }
 
+#ifdef HAVE_OPENRAVE
+/** Update an environment to the state of the viewer environment.
+ * Copies the robot's joint values, all objects and the objects grabbed
+ * by our manipulator into the given environment.
+ * @param env environment set to update
+ */
 void
-JacoOpenraveThread::_plan_path(RefPtr<jaco_target_t> &from, RefPtr<jaco_target_t> &to)
+JacoOpenraveThread::_sync_env(jaco_openrave_set_t &env)
 {
-#ifdef HAVE_OPENRAVE
-	// update state of the trajectory
-	arm_->target_mutex->lock();
-	to->trajec_state = TRAJEC_PLANNING;
-	arm_->target_mutex->unlock();
-
-	// Update bodies in planner-environment
+	// Update bodies in environment
 	// clone robot state, ignoring grabbed bodies
 	{
 		EnvironmentMutex::scoped_lock view_lock(viewer_env_.env->get_env_ptr()->GetMutex());
-		EnvironmentMutex::scoped_lock plan_lock(planner_env_.env->get_env_ptr()->GetMutex());
-		planner_env_.robot->get_robot_ptr()->ReleaseAllGrabbed();
-		planner_env_.env->delete_all_objects();
+		EnvironmentMutex::scoped_lock env_lock(env.env->get_env_ptr()->GetMutex());
+		env.robot->get_robot_ptr()->ReleaseAllGrabbed();
+		env.env->delete_all_objects();
 
 		/*
     // Old method. Somehow we encountered problems. OpenRAVE internal bug?
     RobotBase::RobotStateSaver saver(viewer_env_.robot->get_robot_ptr(),
                                      0xffffffff&~KinBody::Save_GrabbedBodies&~KinBody::Save_ActiveManipulator&~KinBody::Save_ActiveDOF);
-    saver.Restore( planner_env_.robot->get_robot_ptr() );
+    saver.Restore( env.robot->get_robot_ptr() );
     */
 		// New method. Simply set the DOF values as they are in viewer_env_
 		vector<dReal> dofs;
 		viewer_env_.robot->get_robot_ptr()->GetDOFValues(dofs);
-		planner_env_.robot->get_robot_ptr()->SetDOFValues(dofs);
+		env.robot->get_robot_ptr()->SetDOFValues(dofs);
 	}
 
 	// then clone all objects
-	planner_env_.env->clone_objects(viewer_env_.env);
+	env.env->clone_objects(viewer_env_.env);
 
 	// restore robot state
 	{
-		EnvironmentMutex::scoped_lock lock(planner_env_.env->get_env_ptr()->GetMutex());
+		EnvironmentMutex::scoped_lock lock(env.env->get_env_ptr()->GetMutex());
 
 		// Set active manipulator and active DOFs (need for planner and IK solver!)
 		RobotBase::ManipulatorPtr manip =
-		  planner_env_.robot->get_robot_ptr()->SetActiveManipulator(cfg_manipname_);
-		planner_env_.robot->get_robot_ptr()->SetActiveDOFs(manip->GetArmIndices());
+		  env.robot->get_robot_ptr()->SetActiveManipulator(cfg_manipname_);
+		env.robot->get_robot_ptr()->SetActiveDOFs(manip->GetArmIndices());
 
 		// update robot state with attached objects
 		{
@@ -603,9 +632,9 @@ JacoOpenraveThread::_plan_path(RefPtr<jaco_target_t> &from, RefPtr<jaco_target_t
       // Old method. Somehow we encountered problems. OpenRAVE internal bug?
       RobotBase::RobotStateSaver saver(viewer_env_.robot->get_robot_ptr(),
                                        KinBody::Save_LinkTransformation|KinBody::Save_LinkEnable|KinBody::Save_GrabbedBodies);
-      saver.Restore( planner_env_.robot->get_robot_ptr() );
+      saver.Restore( env.robot->get_robot_ptr() );
       */
-			// New method. Grab all bodies in planner_env_ that are grabbed in viewer_env_ by this manipulator
+			// New method. Grab all bodies in env that are grabbed in viewer_env_ by this manipulator
 			vector<RobotBase::GrabbedInfoPtr> grabbed;
 			viewer_env_.robot->get_robot_ptr()->GetGrabbedInfo(grabbed);
 			for (vector<RobotBase::GrabbedInfoPtr>::iterator it = grabbed.begin(); it != grabbed.end();
@@ -616,13 +645,24 @@ JacoOpenraveThread::_plan_path(RefPtr<jaco_target_t> &from, RefPtr<jaco_target_t
 				                  manip->GetEndEffector()->GetName().c_str());
 				if ((*it)->_robotlinkname == manip->GetEndEffector()->GetName()) {
 					logger->log_debug(name(), "attach '%s'!", (*it)->_grabbedname.c_str());
-					planner_env_.robot->attach_object((*it)->_grabbedname.c_str(),
-					                                  planner_env_.env,
-					                                  cfg_manipname_.c_str());
+					env.robot->attach_object((*it)->_grabbedname.c_str(), env.env, cfg_manipname_.c_str());
 				}
 			}
 		}
 	}
+}
+#endif
+
+void
+JacoOpenraveThread::_plan_path(RefPtr<jaco_target_t> &from, RefPtr<jaco_target_t> &to)
+{
+#ifdef HAVE_OPENRAVE
+	// update state of the trajectory
+	arm_->target_mutex->lock();
+	to->trajec_state = TRAJEC_PLANNING;
+	arm_->target_mutex->unlock();
+
+	_sync_env(planner_env_);
 
 	// Set target point for planner. Check again for IK, avoiding collisions with the environment
 	//logger->log_debug(name(), "setting target %f %f %f %f %f %f",
@@ -68,6 +68,9 @@ private:
 
 	void _plan_path(fawkes::RefPtr<fawkes::jaco_target_t> &from,
 	                fawkes::RefPtr<fawkes::jaco_target_t> &to);
+#ifdef HAVE_OPENRAVE
+	void _sync_env(fawkes::jaco_openrave_set_t &env);
+#endif
 
 	fawkes::jaco_arm_t *arm_;
 
@@ -76,6 +79,7 @@ private:
 
 #ifdef HAVE_OPENRAVE
 	fawkes::jaco_openrave_set_t planner_env_;
+	fawkes::jaco_openrave_set_t ik_env_;
 
 	OpenRAVE::RobotBasePtr              robot_;
 	OpenRAVE::RobotBase::ManipulatorPtr manip_;
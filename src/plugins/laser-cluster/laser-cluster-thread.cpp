@@ -28,6 +28,7 @@
 #include <pcl_utils/utils.h>
 #include <utils/math/angle.h>
 #include <utils/time/wait.h>
+#include <utils/tracking/multi_target_tracker.h>
 #ifdef USE_TIMETRACKER
 #	include <utils/time/tracker.h>
 #endif
@@ -50,6 +51,7 @@
 #include <pcl/surface/convex_hull.h>
 #include <utils/time/tracker_macros.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <limits>
@@ -97,6 +99,16 @@ LaserClusterThread::init()
 		cfg_line_min_length_ = config->get_float(cfg_prefix_ + "line_removal/min_length");
 	}
 	cfg_switch_tolerance_  = config->get_float(cfg_prefix_ + "switch_tolerance");
+	cfg_cluster_mode_      = CLUSTER_EUCLIDEAN;
+	try {
+		std::string mode = config->get_string(cfg_prefix_ + "clustering/mode");
+		if (mode == "scanline") {
+			cfg_cluster_mode_ = CLUSTER_SCANLINE;
+		} else if (mode != "euclidean") {
+			logger->log_warn(name(), "Invalid clustering mode '%s', using euclidean", mode.c_str());
+		}
+	} catch (Exception &e) {
+	} // ignored, use default
 	cfg_cluster_tolerance_ = config->get_float(cfg_prefix_ + "clustering/tolerance");
 	cfg_cluster_min_size_  = config->get_uint(cfg_prefix_ + "clustering/min_size");
 	cfg_cluster_max_size_  = config->get_uint(cfg_prefix_ + "clustering/max_size");
@@ -132,6 +144,39 @@ LaserClusterThread::init()
 	} catch (Exception &e) {
 	} // ignored, use default
 
+	cfg_tracking_ = false;
+	try {
+		cfg_tracking_ = config->get_bool(cfg_prefix_ + "tracking/enable");
+	} catch (Exception &e) {
+	} // ignored, use default
+	float        cfg_track_gate    = cfg_switch_tolerance_;
+	float        cfg_track_acc     = 1.0;
+	float        cfg_track_noise   = 0.05;
+	unsigned int cfg_track_misses  = 3;
+	unsigned int cfg_track_minhits = 2;
+	if (cfg_tracking_) {
+		try {
+			cfg_track_gate = config->get_float(cfg_prefix_ + "tracking/gate");
+		} catch (Exception &e) {
+		} // ignored, use default
+		try {
+			cfg_track_acc = config->get_float(cfg_prefix_ + "tracking/process_noise");
+		} catch (Exception &e) {
+		} // ignored, use default
+		try {
+			cfg_track_noise = config->get_float(cfg_prefix_ + "tracking/measurement_noise");
+		} catch (Exception &e) {
+		} // ignored, use default
+		try {
+			cfg_track_misses = config->get_uint(cfg_prefix_ + "tracking/max_misses");
+		} catch (Exception &e) {
+		} // ignored, use default
+		try {
+			cfg_track_minhits = config->get_uint(cfg_prefix_ + "tracking/min_hits");
+		} catch (Exception &e) {
+		} // ignored, use default
+	}
+
 	current_max_x_ = cfg_bbox_max_x_;
 
 	finput_ = pcl_manager->get_pointcloud<PointType>(cfg_input_pcl_.c_str());
@@ -211,8 +256,26 @@ LaserClusterThread::init()
 	seg_.setMaxIterations(cfg_segm_max_iterations_);
 	seg_.setDistanceThreshold(cfg_segm_distance_threshold_);
 
+	// Allocate once and re-use in every loop
+	kdtree_seg_   = pcl::search::KdTree<PointType>::Ptr(new pcl::search::KdTree<PointType>());
+	kdtree_cl_    = pcl::search::KdTree<PointType>::Ptr(new pcl::search::KdTree<PointType>());
+	noline_cloud_ = CloudPtr(new Cloud());
+	tmp_cloud_    = CloudPtr(new Cloud());
+	coeff_        = pcl::ModelCoefficients::Ptr(new pcl::ModelCoefficients());
+	inliers_      = pcl::PointIndices::Ptr(new pcl::PointIndices());
+	num_clusters_ = 0;
+
 	loop_count_ = 0;
 
+	tracker_ = NULL;
+	if (cfg_tracking_) {
+		tracker_ = new MultiTargetTracker(
+		  cfg_track_gate, cfg_track_acc, cfg_track_noise, cfg_track_misses, cfg_track_minhits);
+	}
+	tracker_last_time_.set_time(0, 0);
+	cluster_track_ids_.clear();
+	cluster_track_ids_.resize(cfg_max_num_clusters_, 0);
+
 #ifdef USE_TIMETRACKER
 	tt_                = new TimeTracker();
 	tt_loopcount_      = 0;
@@ -229,6 +292,15 @@ LaserClusterThread::finalize()
 	input_.reset();
 	clusters_.reset();
 	clusters_labeled_.reset();
+	kdtree_seg_.reset();
+	kdtree_cl_.reset();
+	noline_cloud_.reset();
+	tmp_cloud_.reset();
+	coeff_.reset();
+	inliers_.reset();
+	cluster_indices_.clear();
+	delete tracker_;
+	tracker_ = NULL;
 
 	pcl_manager->remove_pointcloud(output_cluster_name_.c_str());
 
@@ -296,6 +368,12 @@ LaserClusterThread::loop()
 		//TimeWait::wait(250000);
 		for (unsigned int i = 0; i < cfg_max_num_clusters_; ++i) {
 			set_position(cluster_pos_ifs_[i], false);
+			cluster_track_ids_[i] = 0;
+		}
+		if (tracker_) {
+			// tracks become stale while disabled
+			tracker_->clear();
+			tracker_last_time_.set_time(0, 0);
 		}
 		return;
 	}
@@ -311,7 +389,7 @@ LaserClusterThread::loop()
 		return;
 	}
 
-	CloudPtr noline_cloud(new Cloud());
+	CloudPtr noline_cloud = noline_cloud_;
 
 	// Erase non-finite points
 	pcl::PassThrough<PointType> passthrough;
@@ -325,8 +403,8 @@ LaserClusterThread::loop()
 	//logger->log_info(name(), "[L %u] total: %zu   finite: %zu",
 	//		     loop_count_, input_->points.size(), noline_cloud->points.size());
 
-	pcl::ModelCoefficients::Ptr coeff(new pcl::ModelCoefficients());
-	pcl::PointIndices::Ptr      inliers(new pcl::PointIndices());
+	pcl::ModelCoefficients::Ptr coeff   = coeff_;
+	pcl::PointIndices::Ptr      inliers = inliers_;
 
 	if (cfg_line_removal_) {
 		std::list<CloudPtr> restore_pcls;
@@ -336,9 +414,8 @@ LaserClusterThread::loop()
 			//logger->log_info(name(), "[L %u] %zu points left",
 			//	               loop_count_, noline_cloud->points.size());
 
-			pcl::search::KdTree<PointType>::Ptr search(new pcl::search::KdTree<PointType>);
-			search->setInputCloud(noline_cloud);
-			seg_.setSamplesMaxDist(cfg_segm_sample_max_dist_, search);
+			kdtree_seg_->setInputCloud(noline_cloud);
+			seg_.setSamplesMaxDist(cfg_segm_sample_max_dist_, kdtree_seg_);
 			seg_.setInputCloud(noline_cloud);
 			seg_.segment(*inliers, *coeff);
 			if (inliers->indices.size() == 0) {
@@ -384,7 +461,7 @@ LaserClusterThread::loop()
 	}
 
 	{
-		CloudPtr tmp_cloud(new Cloud());
+		CloudPtr tmp_cloud = tmp_cloud_;
 		// Erase non-finite points
 		pcl::PassThrough<PointType> passthrough;
 		passthrough.setInputCloud(noline_cloud);
@@ -424,24 +501,19 @@ LaserClusterThread::loop()
 	//logger->log_info(name(), "[L %u] remaining: %zu",
 	//		   loop_count_, noline_cloud->points.size());
 
-	std::vector<pcl::PointIndices> cluster_indices;
+	num_clusters_ = 0;
 	if (noline_cloud->points.size() > 0) {
-		// Creating the KdTree object for the search method of the extraction
-		pcl::search::KdTree<PointType>::Ptr kdtree_cl(new pcl::search::KdTree<PointType>());
-		kdtree_cl->setInputCloud(noline_cloud);
-
-		pcl::EuclideanClusterExtraction<PointType> ec;
-		ec.setClusterTolerance(cfg_cluster_tolerance_);
-		ec.setMinClusterSize(cfg_cluster_min_size_);
-		ec.setMaxClusterSize(cfg_cluster_max_size_);
-		ec.setSearchMethod(kdtree_cl);
-		ec.setInputCloud(noline_cloud);
-		ec.extract(cluster_indices);
+		if (cfg_cluster_mode_ == CLUSTER_SCANLINE) {
+			extract_clusters_scanline(*noline_cloud);
+		} else {
+			extract_clusters_euclidean(noline_cloud);
+		}
 
-		//logger->log_info(name(), "Found %zu clusters", cluster_indices.size());
+		//logger->log_info(name(), "Found %u clusters", num_clusters_);
 
 		//unsigned int i = 0;
-		for (auto cluster : cluster_indices) {
+		for (unsigned int c = 0; c < num_clusters_; ++c) {
+			const pcl::PointIndices &cluster = cluster_indices_[c];
 			//Eigen::Vector4f centroid;
 			//pcl::compute3DCentroid(*noline_cloud, cluster.indices, centroid);
 
@@ -464,12 +536,12 @@ LaserClusterThread::loop()
 		//logger->log_info(name(), "Filter left no points for clustering");
 	}
 
-	if (!cluster_indices.empty()) {
+	if (num_clusters_ > 0) {
 		std::vector<ClusterInfo> cinfos;
 
-		for (unsigned int i = 0; i < cluster_indices.size(); ++i) {
+		for (unsigned int i = 0; i < num_clusters_; ++i) {
 			Eigen::Vector4f centroid;
-			pcl::compute3DCentroid(*noline_cloud, cluster_indices[i].indices, centroid);
+			pcl::compute3DCentroid(*noline_cloud, cluster_indices_[i].indices, centroid);
 			if (!cfg_use_bbox_
 			    || ((centroid.x() >= cfg_bbox_min_x_) && (centroid.x() <= cfg_bbox_max_x_)
 			        && (centroid.y() >= cfg_bbox_min_y_) && (centroid.y() <= cfg_bbox_max_y_))) {
@@ -477,6 +549,7 @@ LaserClusterThread::loop()
 				info.angle    = std::atan2(centroid.y(), centroid.x());
 				info.dist     = centroid.norm();
 				info.index    = i;
+				info.track_id = 0;
 				info.centroid = centroid;
 				cinfos.push_back(info);
 			} else {
@@ -490,6 +563,8 @@ LaserClusterThread::loop()
 			}
 		}
 
+		track_clusters(cinfos);
+
 		if (!cinfos.empty()) {
 			if (cfg_selection_mode_ == SELECT_MIN_ANGLE) {
 				std::sort(cinfos.begin(),
@@ -510,7 +585,7 @@ LaserClusterThread::loop()
 			unsigned int i;
 			for (i = 0; i < std::min(cinfos.size(), (size_t)cfg_max_num_clusters_); ++i) {
 				// color points of cluster
-				for (auto ci : cluster_indices[cinfos[i].index].indices) {
+				for (auto ci : cluster_indices_[cinfos[i].index].indices) {
 					ColorPointType &out_point     = clusters_->points[ci];
 					LabelPointType &out_lab_point = clusters_labeled_->points[ci];
 					out_point.r                   = cluster_colors[i][0];
@@ -521,23 +596,34 @@ LaserClusterThread::loop()
 					out_lab_point.label = i;
 				}
 
-				set_position(cluster_pos_ifs_[i], true, cinfos[i].centroid);
+				set_position(cluster_pos_ifs_[i],
+				             true,
+				             cinfos[i].centroid,
+				             Eigen::Quaternionf(1, 0, 0, 0),
+				             cinfos[i].track_id,
+				             cluster_track_ids_[i]);
+				cluster_track_ids_[i] = cinfos[i].track_id;
 			}
 			for (unsigned int j = i; j < cfg_max_num_clusters_; ++j) {
 				set_position(cluster_pos_ifs_[j], false);
+				cluster_track_ids_[j] = 0;
 			}
 		} else {
-			//logger->log_warn(name(), "No acceptable cluster found, %zu clusters",
-			//	         cluster_indices.size());
+			//logger->log_warn(name(), "No acceptable cluster found, %u clusters",
+			//	         num_clusters_);
 			for (unsigned int i = 0; i < cfg_max_num_clusters_; ++i) {
 				set_position(cluster_pos_ifs_[i], false);
+				cluster_track_ids_[i] = 0;
 			}
 		}
 	} else {
 		//logger->log_warn(name(), "No clusters found, %zu remaining points",
 		//	     noline_cloud->points.size());
+		std::vector<ClusterInfo> no_clusters;
+		track_clusters(no_clusters);
 		for (unsigned int i = 0; i < cfg_max_num_clusters_; ++i) {
 			set_position(cluster_pos_ifs_[i], false);
+			cluster_track_ids_[i] = 0;
 		}
 	}
 
@@ -561,11 +647,46 @@ LaserClusterThread::loop()
 #endif
 }
 
+/** Associate clusters with tracks.
+ * Runs the multi-target tracker on the cluster centroids and stores the
+ * resulting track IDs in the cluster infos. Does nothing if tracking is
+ * disabled, the track IDs then remain zero.
+ * @param cinfos cluster infos, track IDs are set upon return
+ */
+void
+LaserClusterThread::track_clusters(std::vector<ClusterInfo> &cinfos)
+{
+	if (!tracker_)
+		return;
+
+	fawkes::Time now;
+	pcl_utils::get_time(finput_, now);
+	float dt = 0.;
+	if (tracker_last_time_.in_sec() > 0.) {
+		dt = std::max(0., now - &tracker_last_time_);
+	}
+	tracker_last_time_ = now;
+
+	std::vector<cart_coord_2d_t> measurements(cinfos.size());
+	for (size_t i = 0; i < cinfos.size(); ++i) {
+		measurements[i].x = cinfos[i].centroid.x();
+		measurements[i].y = cinfos[i].centroid.y();
+	}
+	tracker_->update(measurements, dt);
+
+	const std::vector<unsigned int> &track_ids = tracker_->measurement_tracks();
+	for (size_t i = 0; i < cinfos.size(); ++i) {
+		cinfos[i].track_id = track_ids[i];
+	}
+}
+
 void
 LaserClusterThread::set_position(fawkes::Position3DInterface *iface,
                                  bool                         is_visible,
                                  const Eigen::Vector4f &      centroid,
-                                 const Eigen::Quaternionf &   attitude)
+                                 const Eigen::Quaternionf &   attitude,
+                                 unsigned int                 track_id,
+                                 unsigned int                 last_track_id)
 {
 	tf::Stamped<tf::Pose> baserel_pose;
 
@@ -610,8 +731,14 @@ LaserClusterThread::set_position(fawkes::Position3DInterface *iface,
 		                              iface->translation(1) - cfg_offset_y_,
 		                              iface->translation(2) - cfg_offset_z_,
 		                              0.);
-		bool            different_cluster =
-		  fabs((last_centroid - baserel_centroid).norm()) > cfg_switch_tolerance_;
+		// with tracking the identity of the cluster is known, otherwise
+		// assume a different cluster if it moved too far
+		bool different_cluster;
+		if (track_id != 0) {
+			different_cluster = (track_id != last_track_id);
+		} else {
+			different_cluster = fabs((last_centroid - baserel_centroid).norm()) > cfg_switch_tolerance_;
+		}
 
 		if (!different_cluster && visibility_history >= 0) {
 			iface->set_visibility_history(visibility_history + 1);
@@ -641,6 +768,96 @@ LaserClusterThread::set_position(fawkes::Position3DInterface *iface,
 	iface->write();
 }
 
+/** Extract clusters using PCL euclidean cluster extraction.
+ * Works for arbitrary clouds but requires building a KD-tree.
+ * @param cloud cloud to cluster
+ */
+void
+LaserClusterThread::extract_clusters_euclidean(CloudPtr cloud)
+{
+	kdtree_cl_->setInputCloud(cloud);
+
+	pcl::EuclideanClusterExtraction<PointType> ec;
+	ec.setClusterTolerance(cfg_cluster_tolerance_);
+	ec.setMinClusterSize(cfg_cluster_min_size_);
+	ec.setMaxClusterSize(cfg_cluster_max_size_);
+	ec.setSearchMethod(kdtree_cl_);
+	ec.setInputCloud(cloud);
+	ec.extract(cluster_indices_);
+	num_clusters_ = cluster_indices_.size();
+}
+
+/** Extract clusters by scan adjacency.
+ * In a 2D laser scan a point can only be connected to the points of
+ * the neighbouring beams. Points are therefore ordered by their angle
+ * around the sensor origin and consecutive points closer than the
+ * cluster tolerance are joined, including across the wrap-around of a
+ * full scan. This avoids building a KD-tree and does not depend on the
+ * order of points in the input cloud, e.g. after line removal or voxel
+ * filtering. The cloud must be in a frame centered at the sensor.
+ * Buffers are re-used across loops. Upon return, the first
+ * num_clusters_ entries of cluster_indices_ are valid.
+ * @param cloud cloud to cluster
+ */
+void
+LaserClusterThread::extract_clusters_scanline(const Cloud &cloud)
+{
+	const unsigned int n = cloud.points.size();
+
+	scan_order_.resize(n);
+	for (unsigned int i = 0; i < n; ++i) {
+		scan_order_[i].first  = std::atan2(cloud.points[i].y, cloud.points[i].x);
+		scan_order_[i].second = i;
+	}
+	std::sort(scan_order_.begin(), scan_order_.end());
+
+	const float tolerance_sq = cfg_cluster_tolerance_ * cfg_cluster_tolerance_;
+
+	// segments of scan_order_ as [begin, end) of connected points
+	scan_segments_.clear();
+	unsigned int begin = 0;
+	for (unsigned int i = 1; i <= n; ++i) {
+		if (i == n
+		    || pcl::squaredEuclideanDistance(cloud.points[scan_order_[i - 1].second],
+		                                     cloud.points[scan_order_[i].second])
+		         > tolerance_sq) {
+			scan_segments_.push_back(std::make_pair(begin, i));
+			begin = i;
+		}
+	}
+
+	// last and first segment are neighbours in a full scan
+	bool wrap = (scan_segments_.size() > 1
+	             && pcl::squaredEuclideanDistance(cloud.points[scan_order_[n - 1].second],
+	                                              cloud.points[scan_order_[0].second])
+	                  <= tolerance_sq);
+
+	num_clusters_                 = 0;
+	const unsigned int n_segments = scan_segments_.size() - (wrap ? 1 : 0);
+	for (unsigned int s = 0; s < n_segments; ++s) {
+		unsigned int size = scan_segments_[s].second - scan_segments_[s].first;
+		if (s == 0 && wrap) {
+			size += scan_segments_.back().second - scan_segments_.back().first;
+		}
+		if (size < cfg_cluster_min_size_ || size > cfg_cluster_max_size_)
+			continue;
+
+		if (cluster_indices_.size() <= num_clusters_) {
+			cluster_indices_.resize(num_clusters_ + 1);
+		}
+		std::vector<int> &indices = cluster_indices_[num_clusters_++].indices;
+		indices.clear();
+		if (s == 0 && wrap) {
+			for (unsigned int i = scan_segments_.back().first; i < scan_segments_.back().second; ++i) {
+				indices.push_back(scan_order_[i].second);
+			}
+		}
+		for (unsigned int i = scan_segments_[s].first; i < scan_segments_[s].second; ++i) {
+			indices.push_back(scan_order_[i].second);
+		}
+	}
+}
+
 float
 LaserClusterThread::calc_line_length(CloudPtr                    cloud,
                                      pcl::PointIndices::Ptr      inliers,
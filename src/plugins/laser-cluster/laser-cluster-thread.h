@@ -33,7 +33,9 @@
 #include <core/threading/thread.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
+#include <pcl/search/kdtree.h>
 #include <pcl/segmentation/sac_segmentation.h>
+#include <utils/time/time.h>
 
 #include <Eigen/StdVector>
 
@@ -44,6 +46,7 @@ class SwitchInterface;
 class TimeTracker;
 #endif
 class LaserClusterInterface;
+class MultiTargetTracker;
 } // namespace fawkes
 
 class LaserClusterThread : public fawkes::Thread,
@@ -80,15 +83,33 @@ private:
 	typedef LabelCloud::ConstPtr            LabelCloudConstPtr;
 
 private:
+	class ClusterInfo
+	{
+	public:
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+		double          angle;
+		double          dist;
+		unsigned int    index;
+		unsigned int    track_id;
+		Eigen::Vector4f centroid;
+	};
+
 	void set_position(fawkes::Position3DInterface *iface,
 	                  bool                         is_visible,
 	                  const Eigen::Vector4f &      centroid = Eigen::Vector4f(0, 0, 0, 0),
-	                  const Eigen::Quaternionf &   rotation = Eigen::Quaternionf(1, 0, 0, 0));
+	                  const Eigen::Quaternionf &   rotation = Eigen::Quaternionf(1, 0, 0, 0),
+	                  unsigned int                 track_id = 0,
+	                  unsigned int                 last_track_id = 0);
 
 	float calc_line_length(CloudPtr                    cloud,
 	                       pcl::PointIndices::Ptr      inliers,
 	                       pcl::ModelCoefficients::Ptr coeff);
 
+	void extract_clusters_euclidean(CloudPtr cloud);
+	void extract_clusters_scanline(const Cloud &cloud);
+	void track_clusters(std::vector<ClusterInfo> &cinfos);
+
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
 	virtual void
@@ -107,12 +128,25 @@ private:
 
 	pcl::SACSegmentation<PointType> seg_;
 
+	pcl::search::KdTree<PointType>::Ptr kdtree_seg_;
+	pcl::search::KdTree<PointType>::Ptr kdtree_cl_;
+	CloudPtr                            noline_cloud_;
+	CloudPtr                            tmp_cloud_;
+	pcl::ModelCoefficients::Ptr         coeff_;
+	pcl::PointIndices::Ptr              inliers_;
+
+	std::vector<pcl::PointIndices>                     cluster_indices_;
+	unsigned int                                       num_clusters_;
+	std::vector<std::pair<float, unsigned int>>        scan_order_;
+	std::vector<std::pair<unsigned int, unsigned int>> scan_segments_;
+
 	std::vector<fawkes::Position3DInterface *> cluster_pos_ifs_;
 
 	fawkes::SwitchInterface *      switch_if_;
 	fawkes::LaserClusterInterface *config_if_;
 
 	typedef enum { SELECT_MIN_ANGLE, SELECT_MIN_DIST } selection_mode_t;
+	typedef enum { CLUSTER_EUCLIDEAN, CLUSTER_SCANLINE } cluster_mode_t;
 
 	std::string cfg_name_;
 	std::string cfg_prefix_;
@@ -123,6 +157,7 @@ private:
 	unsigned int     cfg_segm_min_inliers_;
 	float            cfg_segm_sample_max_dist_;
 	float            cfg_line_min_length_;
+	cluster_mode_t   cfg_cluster_mode_;
 	float            cfg_cluster_tolerance_;
 	unsigned int     cfg_cluster_min_size_;
 	unsigned int     cfg_cluster_max_size_;
@@ -147,16 +182,10 @@ private:
 
 	unsigned int loop_count_;
 
-	class ClusterInfo
-	{
-	public:
-		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-
-		double          angle;
-		double          dist;
-		unsigned int    index;
-		Eigen::Vector4f centroid;
-	};
+	bool                        cfg_tracking_;
+	fawkes::MultiTargetTracker *tracker_;
+	fawkes::Time                tracker_last_time_;
+	std::vector<unsigned int>   cluster_track_ids_;
 
 #ifdef USE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
@@ -43,8 +43,10 @@
 #include <interfaces/Laser1080Interface.h>
 #include <interfaces/Laser360Interface.h>
 #include <interfaces/Laser720Interface.h>
+#include <interfaces/LaserScanInterface.h>
 #include <utils/time/time.h>
 
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <memory>
@@ -129,6 +131,13 @@ LaserFilterThread::init()
 			LaserDataFilterCascade *cascade =
 			  new LaserDataFilterCascade(cfg_name_, in_[0].size, in_bufs_);
 
+			bool fuse_filters = true;
+			try {
+				fuse_filters = config->get_bool((cfg_prefix_ + "fuse_filters").c_str());
+			} catch (Exception &e) {
+			} // ignored, use default
+			cascade->set_fused(fuse_filters);
+
 			try {
 				std::map<std::string, std::string>::iterator f;
 				for (f = filters.begin(); f != filters.end(); ++f) {
@@ -152,13 +161,22 @@ LaserFilterThread::init()
 			filter_ = cascade;
 		}
 
-		if (out_[0].size != filter_->get_out_data_size()) {
-			Exception e("Output interface and filter data size for %s do not match (%u != %u)",
-			            cfg_name_.c_str(),
-			            out_[0].size,
-			            filter_->get_out_data_size());
-			delete filter_;
-			throw e;
+		const unsigned int out_size = filter_->get_out_data_size();
+		for (unsigned int i = 0; i < out_.size(); ++i) {
+			if (out_[i].scan && out_size <= LaserScanInterface::MAX_BEAMS) {
+				// scan interfaces take whatever the filter produces
+				out_[i].size = out_size;
+				out_[i].interface_typed.asScan->set_angle_min(0.);
+				out_[i].interface_typed.asScan->set_angle_increment(2 * M_PI / out_size);
+				out_[i].interface_typed.asScan->set_num_beams(out_size);
+			} else if (out_[i].size != out_size) {
+				Exception e("Output interface and filter data size for %s do not match (%u != %u)",
+				            cfg_name_.c_str(),
+				            out_[i].scan ? LaserScanInterface::MAX_BEAMS : out_[i].size,
+				            out_size);
+				delete filter_;
+				throw e;
+			}
 		}
 
 		filter_->set_out_vector(out_bufs_);
@@ -215,7 +233,10 @@ LaserFilterThread::loop()
 	const size_t in_num = in_.size();
 	for (size_t i = 0; i != in_num; ++i) {
 		in_[i].interface->read();
-		if (in_[i].size == 360) {
+		if (in_[i].scan) {
+			in_bufs_[i]->frame      = in_[i].interface_typed.asScan->frame();
+			*in_bufs_[i]->timestamp = in_[i].interface_typed.asScan->timestamp();
+		} else if (in_[i].size == 360) {
 			in_bufs_[i]->frame      = in_[i].interface_typed.as360->frame();
 			*in_bufs_[i]->timestamp = in_[i].interface_typed.as360->timestamp();
 		} else if (in_[i].size == 720) {
@@ -238,7 +259,10 @@ LaserFilterThread::loop()
 	// Write output interfaces
 	const size_t num = out_.size();
 	for (size_t i = 0; i < num; ++i) {
-		if (out_[i].size == 360) {
+		if (out_[i].scan) {
+			out_[i].interface_typed.asScan->set_timestamp(out_bufs_[i]->timestamp);
+			out_[i].interface_typed.asScan->set_frame(out_bufs_[i]->frame.c_str());
+		} else if (out_[i].size == 360) {
 			out_[i].interface_typed.as360->set_timestamp(out_bufs_[i]->timestamp);
 			out_[i].interface_typed.as360->set_frame(out_bufs_[i]->frame.c_str());
 		} else if (out_[i].size == 720) {
@@ -304,6 +328,7 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 
 			LaserInterface lif;
 			lif.interface = NULL;
+			lif.scan      = false;
 
 			if (type == "Laser360Interface") {
 				lif.size = 360;
@@ -311,10 +336,14 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 				lif.size = 720;
 			} else if (type == "Laser1080Interface") {
 				lif.size = 1080;
+			} else if (type == "LaserScanInterface") {
+				// size is determined by the data once the interface is opened
+				lif.size = 0;
+				lif.scan = true;
 			} else {
 				throw Exception("Interfaces must be of type Laser360Interface, "
-				                "Laser720Interface, or Laser1080Interface, "
-				                "but it is '%s'",
+				                "Laser720Interface, Laser1080Interface, or "
+				                "LaserScanInterface, but it is '%s'",
 				                type.c_str());
 			}
 
@@ -329,16 +358,35 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 
 	bufs.resize(ifs.size());
 
-	unsigned int req_size = ifs[0].size;
+	unsigned int req_size = 0;
+	for (unsigned int i = 0; i < ifs.size(); ++i) {
+		if (!ifs[i].scan) {
+			req_size = ifs[i].size;
+			break;
+		}
+	}
 
 	try {
 		if (writing) {
 			for (unsigned int i = 0; i < ifs.size(); ++i) {
-				if (req_size != ifs[i].size) {
+				if (!ifs[i].scan && req_size != ifs[i].size) {
 					throw Exception("Interfaces of mixed sizes for %s", cfg_name_.c_str());
 				}
 
-				if (ifs[i].size == 360) {
+				if (ifs[i].scan) {
+					logger->log_debug(name(), "Opening writing LaserScanInterface::%s", ifs[i].id.c_str());
+					LaserScanInterface *laser_scan =
+					  blackboard->open_for_writing<LaserScanInterface>(ifs[i].id.c_str());
+
+					laser_scan->set_auto_timestamping(false);
+
+					ifs[i].interface_typed.asScan = laser_scan;
+					ifs[i].interface              = laser_scan;
+					bufs[i]                       = new LaserDataFilter::Buffer();
+					bufs[i]->name                 = laser_scan->uid();
+					bufs[i]->values               = laser_scan->distances();
+
+				} else if (ifs[i].size == 360) {
 					logger->log_debug(name(), "Opening writing Laser360Interface::%s", ifs[i].id.c_str());
 					Laser360Interface *laser360 =
 					  blackboard->open_for_writing<Laser360Interface>(ifs[i].id.c_str());
@@ -380,7 +428,35 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 			}
 		} else {
 			for (unsigned int i = 0; i < ifs.size(); ++i) {
-				if (ifs[i].size == 360) {
+				if (ifs[i].scan) {
+					logger->log_debug(name(), "Opening reading LaserScanInterface::%s", ifs[i].id.c_str());
+					LaserScanInterface *laser_scan =
+					  blackboard->open_for_reading<LaserScanInterface>(ifs[i].id.c_str());
+
+					ifs[i].interface_typed.asScan = laser_scan;
+					ifs[i].interface              = laser_scan;
+
+					// filters work on full circle scans starting at angle zero
+					laser_scan->read();
+					const unsigned int num_beams = laser_scan->num_beams();
+					if (num_beams == 0 || num_beams > LaserScanInterface::MAX_BEAMS) {
+						throw Exception("Scan interface %s has invalid number of beams %u",
+						                laser_scan->uid(),
+						                num_beams);
+					}
+					if (fabs(laser_scan->angle_min()) > 1e-4
+					    || fabs(laser_scan->angle_increment() * num_beams - 2 * M_PI) > 1e-3) {
+						throw Exception("Scan interface %s does not cover a full circle starting at zero",
+						                laser_scan->uid());
+					}
+					ifs[i].size = num_beams;
+
+					bufs[i]         = new LaserDataFilter::Buffer();
+					bufs[i]->name   = laser_scan->uid();
+					bufs[i]->frame  = laser_scan->frame();
+					bufs[i]->values = laser_scan->distances();
+
+				} else if (ifs[i].size == 360) {
 					logger->log_debug(name(), "Opening reading Laser360Interface::%s", ifs[i].id.c_str());
 					Laser360Interface *laser360 =
 					  blackboard->open_for_reading<Laser360Interface>(ifs[i].id.c_str());
@@ -42,6 +42,7 @@ namespace fawkes {
 class Laser360Interface;
 class Laser720Interface;
 class Laser1080Interface;
+class LaserScanInterface;
 } // namespace fawkes
 
 class LaserFilterThread : public fawkes::Thread,
@@ -71,10 +72,12 @@ private:
 	{
 		std::string  id;
 		unsigned int size;
+		bool         scan;
 		union {
 			fawkes::Laser360Interface * as360;
 			fawkes::Laser720Interface * as720;
 			fawkes::Laser1080Interface *as1080;
+			fawkes::LaserScanInterface *asScan;
 		} interface_typed;
 		fawkes::Interface *interface;
 	} LaserInterface;
@@ -22,9 +22,23 @@
 
 #include "cascade.h"
 
+#include <utils/time/time.h>
+
+#include <algorithm>
+
+/// Number of beams run through all stages of a fused run at a time
+static const unsigned int FUSED_BLOCK_SIZE = 256;
+
 /** @class LaserDataFilterCascade "filters/cascade.h"
  * Cascade of several laser filters to one.
  * The filters are executed in the order they are added to the cascade.
+ *
+ * In fused mode, which is the default, consecutive beamwise filters (see
+ * LaserDataFilter::beamwise()) are run together in a single pass. Each block
+ * of beams is read from the input of the first filter of such a run, passes
+ * through all filters of the run and is written to the output of the last
+ * one. The outputs of the other filters of the run are not updated. Filters
+ * which need the whole scan are run one by one as before.
  * @author Tim Niemueller
  */
 
@@ -40,6 +54,7 @@ LaserDataFilterCascade::LaserDataFilterCascade(const std::string &    filter_nam
 {
 	out_data_size = in_data_size;
 	out           = in;
+	fused_        = true;
 	set_array_ownership(false, false);
 }
 
@@ -92,10 +107,69 @@ LaserDataFilterCascade::delete_filters()
 	filters_.clear();
 }
 
+/** Enable or disable fused execution of beamwise filters.
+ * @param fused true to run consecutive beamwise filters in a single pass,
+ * false to run each filter on its own
+ */
+void
+LaserDataFilterCascade::set_fused(bool fused)
+{
+	fused_ = fused;
+}
+
 void
 LaserDataFilterCascade::filter()
 {
-	for (fit_ = filters_.begin(); fit_ != filters_.end(); ++fit_) {
-		(*fit_)->filter();
+	if (!fused_) {
+		for (fit_ = filters_.begin(); fit_ != filters_.end(); ++fit_) {
+			(*fit_)->filter();
+		}
+		return;
+	}
+
+	std::vector<Buffer *> *inbufs = &in;
+	fit_                          = filters_.begin();
+	while (fit_ != filters_.end()) {
+		run_.clear();
+		while (fit_ != filters_.end() && (*fit_)->beamwise()) {
+			run_.push_back(*fit_++);
+		}
+
+		if (run_.size() > 1) {
+			filter_fused(*inbufs);
+			inbufs = &run_.back()->get_out_vector();
+		} else {
+			if (run_.empty()) {
+				run_.push_back(*fit_++);
+			}
+			run_.back()->filter();
+			inbufs = &run_.back()->get_out_vector();
+		}
+	}
+}
+
+/** Run the beamwise filters collected in run_ in a single pass.
+ * @param inbufs input buffers of the first filter of the run
+ */
+void
+LaserDataFilterCascade::filter_fused(std::vector<LaserDataFilter::Buffer *> &inbufs)
+{
+	std::vector<Buffer *> &outbufs   = run_.back()->get_out_vector();
+	const unsigned int     vecsize   = std::min(inbufs.size(), outbufs.size());
+	const unsigned int     data_size = run_.back()->get_out_data_size();
+
+	for (unsigned int a = 0; a < vecsize; ++a) {
+		outbufs[a]->frame = inbufs[a]->frame;
+		outbufs[a]->timestamp->set_time(inbufs[a]->timestamp);
+
+		const float *inbuf  = inbufs[a]->values;
+		float *      outbuf = outbufs[a]->values;
+		for (unsigned int b = 0; b < data_size; b += FUSED_BLOCK_SIZE) {
+			const unsigned int e = std::min(b + FUSED_BLOCK_SIZE, data_size);
+			run_[0]->filter_beams(inbuf, outbuf, b, e);
+			for (size_t f = 1; f < run_.size(); ++f) {
+				run_[f]->filter_beams(outbuf, outbuf, b, e);
+			}
+		}
 	}
 }
@@ -26,6 +26,7 @@
 #include "filter.h"
 
 #include <list>
+#include <vector>
 
 class LaserDataFilterCascade : public LaserDataFilter
 {
@@ -51,6 +52,8 @@ public:
 
 	void filter();
 
+	void set_fused(bool fused);
+
 	/** Get filters.
    * @return list of active filters. */
 	const std::list<LaserDataFilter *> &
@@ -59,9 +62,15 @@ public:
 		return filters_;
 	}
 
+private:
+	void filter_fused(std::vector<LaserDataFilter::Buffer *> &inbufs);
+
 private:
 	std::list<LaserDataFilter *>           filters_;
 	std::list<LaserDataFilter *>::iterator fit_;
+
+	bool                           fused_;
+	std::vector<LaserDataFilter *> run_;
 };
 
 #endif
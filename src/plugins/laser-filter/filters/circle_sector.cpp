@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 
 using namespace fawkes;
 
@@ -62,24 +63,41 @@ LaserCircleSectorDataFilter::filter()
 	const unsigned int vecsize = std::min(in.size(), out.size());
 	const unsigned int arrsize = std::min(in_data_size, out_data_size);
 	for (unsigned int a = 0; a < vecsize; ++a) {
-		reset_outbuf(out[a]);
 		out[a]->frame = in[a]->frame;
 		out[a]->timestamp->set_time(in[a]->timestamp);
+		filter_beams(in[a]->values, out[a]->values, 0, arrsize);
+	}
+}
 
-		float *inbuf  = in[a]->values;
-		float *outbuf = out[a]->values;
+/** Check if the filter works beam by beam.
+ * @return always true
+ */
+bool
+LaserCircleSectorDataFilter::beamwise() const
+{
+	return true;
+}
 
-		if (from_ > to_) {
-			for (unsigned int i = from_; i < arrsize; ++i) {
-				outbuf[i] = inbuf[i];
-			}
-			for (unsigned int i = 0; i <= std::min(to_, arrsize - 1); ++i) {
-				outbuf[i] = inbuf[i];
-			}
-		} else {
-			for (unsigned int i = from_; i <= std::min(to_, arrsize - 1); ++i) {
-				outbuf[i] = inbuf[i];
-			}
+/** Filter a range of beams.
+ * @param inbuf input values
+ * @param outbuf output values, may be the same as @p inbuf
+ * @param begin index of first beam to filter
+ * @param end index after the last beam to filter
+ */
+void
+LaserCircleSectorDataFilter::filter_beams(const float *inbuf,
+                                          float *      outbuf,
+                                          unsigned int begin,
+                                          unsigned int end) const
+{
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	if (from_ > to_) {
+		for (unsigned int i = begin; i < end; ++i) {
+			outbuf[i] = (i >= from_ || i <= to_) ? inbuf[i] : nan;
+		}
+	} else {
+		for (unsigned int i = begin; i < end; ++i) {
+			outbuf[i] = (i >= from_ && i <= to_) ? inbuf[i] : nan;
 		}
 	}
 }
@@ -35,6 +35,8 @@ public:
 	                            std::vector<LaserDataFilter::Buffer *> &in);
 
 	void filter();
+	bool beamwise() const;
+	void filter_beams(const float *inbuf, float *outbuf, unsigned int begin, unsigned int end) const;
 
 private:
 	unsigned int from_;
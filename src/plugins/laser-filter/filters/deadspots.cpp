@@ -30,6 +30,7 @@
 #include <utils/math/angle.h>
 #include <utils/time/time.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <regex.h>
@@ -196,23 +197,39 @@ LaserDeadSpotsDataFilter::filter()
 	for (unsigned int a = 0; a < vecsize; ++a) {
 		out[a]->frame = in[a]->frame;
 		out[a]->timestamp->set_time(in[a]->timestamp);
-		float *inbuf  = in[a]->values;
-		float *outbuf = out[a]->values;
-
-		unsigned int start = 0;
-		for (unsigned int i = 0; i < num_spots_; ++i) {
-			const unsigned int spot_start = dead_spots_[i * 2];
-			const unsigned int spot_end   = dead_spots_[i * 2 + 1];
-			for (unsigned int j = start; j < spot_start; ++j) {
-				outbuf[j] = inbuf[j];
-			}
-			for (unsigned int j = spot_start; j <= spot_end; ++j) {
-				outbuf[j] = 0.0;
-			}
-			start = spot_end + 1;
-		}
-		for (unsigned int j = start; j < in_data_size; ++j) {
-			outbuf[j] = inbuf[j];
+		filter_beams(in[a]->values, out[a]->values, 0, in_data_size);
+	}
+}
+
+/** Check if the filter works beam by beam.
+ * @return always true
+ */
+bool
+LaserDeadSpotsDataFilter::beamwise() const
+{
+	return true;
+}
+
+/** Filter a range of beams.
+ * @param inbuf input values
+ * @param outbuf output values, may be the same as @p inbuf
+ * @param begin index of first beam to filter
+ * @param end index after the last beam to filter
+ */
+void
+LaserDeadSpotsDataFilter::filter_beams(const float *inbuf,
+                                       float *      outbuf,
+                                       unsigned int begin,
+                                       unsigned int end) const
+{
+	if (outbuf != inbuf) {
+		std::copy(inbuf + begin, inbuf + end, outbuf + begin);
+	}
+	for (unsigned int i = 0; i < num_spots_; ++i) {
+		const unsigned int spot_start = std::max(dead_spots_[i * 2], begin);
+		const unsigned int spot_end   = std::min(dead_spots_[i * 2 + 1] + 1, end);
+		for (unsigned int j = spot_start; j < spot_end; ++j) {
+			outbuf[j] = 0.0;
 		}
 	}
 }
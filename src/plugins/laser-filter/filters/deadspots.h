@@ -49,6 +49,8 @@ public:
 	LaserDeadSpotsDataFilter &operator=(const LaserDeadSpotsDataFilter &other);
 
 	void filter();
+	bool beamwise() const;
+	void filter_beams(const float *inbuf, float *outbuf, unsigned int begin, unsigned int end) const;
 
 private:
 	void calc_spots();
@@ -202,6 +202,36 @@ LaserDataFilter::copy_to_outbuf(LaserDataFilter::Buffer *      outbuf,
 	memcpy(outbuf->values, inbuf->values, sizeof(float) * out_data_size);
 }
 
+/** Check if the filter works beam by beam.
+ * A beamwise filter computes each output value solely from the input value
+ * with the same index and the index itself, has as many output as input
+ * arrays, equal input and output data size, and does not change the frame.
+ * The filter must then implement filter_beams(), which allows a cascade to
+ * run several such filters in one pass over the data.
+ * @return true if the filter is beamwise, false otherwise
+ */
+bool
+LaserDataFilter::beamwise() const
+{
+	return false;
+}
+
+/** Filter a range of beams of one array.
+ * Only needs to be implemented by filters for which beamwise() returns true.
+ * @param inbuf input values
+ * @param outbuf output values, may be the same as @p inbuf
+ * @param begin index of first beam to filter
+ * @param end index after the last beam to filter
+ */
+void
+LaserDataFilter::filter_beams(const float *inbuf,
+                              float *      outbuf,
+                              unsigned int begin,
+                              unsigned int end) const
+{
+	throw fawkes::Exception("Filter %s does not support beamwise filtering", filter_name.c_str());
+}
+
 /** Set input/output array ownership.
  * Owned arrays will be freed on destruction or when setting new arrays.
  * @param own_in true to assign ownership of input arrays, false otherwise
@@ -60,6 +60,12 @@ public:
 
 	virtual void filter() = 0;
 
+	virtual bool beamwise() const;
+	virtual void filter_beams(const float *inbuf,
+	                          float *      outbuf,
+	                          unsigned int begin,
+	                          unsigned int end) const;
+
 	void set_array_ownership(bool own_in, bool own_out);
 	/** Check if input arrays are owned by filter.
    * @return true if arrays are owned by this filter, false otherwise. */
@@ -28,6 +28,7 @@
 #include <utils/math/coord.h>
 #include <utils/time/time.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <string>
@@ -62,6 +63,44 @@ LaserMapFilterDataFilter::LaserMapFilterDataFilter(const std::string &filter_nam
 	frame_map_           = config_->get_string("/frames/fixed");
 	num_pixels_          = config_->get_int_or_default((prefix + "num_pixels").c_str(), 2);
 	cfg_occupied_thresh_ = std::numeric_limits<float>::max();
+	num_pixels_          = std::max(num_pixels_, 0);
+	calc_near_occupied();
+}
+
+/** Constructor for an already loaded map.
+ * @param filter_name name of this filter
+ * @param in_data_size number of entries input value arrays
+ * @param in vector of input arrays
+ * @param tf_listener to access the tf::Transformer aspect
+ * @param map map to filter against, the filter takes ownership
+ * @param frame_map coordinate frame of the map
+ * @param num_pixels remove beams within this many cells of an occupied cell
+ * @param logger to access the Logger aspect
+ */
+LaserMapFilterDataFilter::LaserMapFilterDataFilter(const std::string &filter_name,
+                                                   unsigned int       in_data_size,
+                                                   std::vector<LaserDataFilter::Buffer *> &in,
+                                                   fawkes::tf::Transformer *tf_listener,
+                                                   map_t *                  map,
+                                                   const std::string &      frame_map,
+                                                   int                      num_pixels,
+                                                   fawkes::Logger *         logger)
+: LaserDataFilter(filter_name, in_data_size, in, 1)
+{
+	tf_listener_         = tf_listener;
+	config_              = NULL;
+	logger_              = logger;
+	map_                 = map;
+	frame_map_           = frame_map;
+	cfg_occupied_thresh_ = std::numeric_limits<float>::max();
+	num_pixels_          = std::max(num_pixels, 0);
+	calc_near_occupied();
+}
+
+/** Destructor. */
+LaserMapFilterDataFilter::~LaserMapFilterDataFilter()
+{
+	map_free(map_);
 }
 
 /** loads map using amcl
@@ -111,6 +150,64 @@ LaserMapFilterDataFilter::is_in_map(int cell_x, int cell_y)
 	return true;
 }
 
+/** Mark all cells within num_pixels_ of an occupied cell.
+ * The neighborhood is the square of (2 * num_pixels_ + 1) cells around a
+ * cell, it is computed separably, first along rows, then along columns.
+ */
+void
+LaserMapFilterDataFilter::calc_near_occupied()
+{
+	const int k = num_pixels_;
+	const int w = map_->size_x + 2 * k;
+	const int h = map_->size_y + 2 * k;
+
+	// extended cell (x, y) corresponds to map cell (x - k, y - k)
+	std::vector<unsigned char> rows((size_t)w * map_->size_y, 0);
+	for (int my = 0; my < map_->size_y; ++my) {
+		int count = 0;
+		for (int x = 0; x < w; ++x) {
+			// window of map cells [x - 2k, x] in this row
+			const int enter = x;
+			const int leave = x - 2 * k - 1;
+			if (enter < map_->size_x && map_->cells[MAP_INDEX(map_, enter, my)].occ_state > 0)
+				++count;
+			if (leave >= 0 && map_->cells[MAP_INDEX(map_, leave, my)].occ_state > 0)
+				--count;
+			rows[(size_t)my * w + x] = (count > 0);
+		}
+	}
+
+	near_occupied_.assign((size_t)w * h, 0);
+	for (int x = 0; x < w; ++x) {
+		int count = 0;
+		for (int y = 0; y < h; ++y) {
+			const int enter = y;
+			const int leave = y - 2 * k - 1;
+			if (enter < map_->size_y && rows[(size_t)enter * w + x])
+				++count;
+			if (leave >= 0 && rows[(size_t)leave * w + x])
+				--count;
+			near_occupied_[(size_t)y * w + x] = (count > 0);
+		}
+	}
+
+	near_occupied_width_  = w;
+	near_occupied_height_ = h;
+}
+
+/** Calculate direction of each beam for the current data size. */
+void
+LaserMapFilterDataFilter::calc_beam_directions()
+{
+	beam_cos_.resize(out_data_size);
+	beam_sin_.resize(out_data_size);
+	for (unsigned int i = 0; i < out_data_size; ++i) {
+		double angle = M_PI * (360.f / out_data_size * i) / 180;
+		beam_cos_[i] = cosf(angle);
+		beam_sin_[i] = sinf(angle);
+	}
+}
+
 void
 LaserMapFilterDataFilter::filter()
 {
@@ -144,47 +241,39 @@ LaserMapFilterDataFilter::filter()
 		}
 		// set out meta info
 		out[a]->frame     = in[a]->frame;
-		out[a]->timestamp = in[a]->timestamp;
-		// for each point
+		out[a]->timestamp->set_time(in[a]->timestamp);
+
+		if (beam_cos_.size() != out_data_size)
+			calc_beam_directions();
+
+		// only the x and y rows of the transform are needed for points in
+		// the laser plane
+		const fawkes::tf::Matrix3x3 &basis  = transform.getBasis();
+		const fawkes::tf::Vector3 &  origin = transform.getOrigin();
+		const double                 m00 = basis[0][0], m01 = basis[0][1], tx = origin.x();
+		const double                 m10 = basis[1][0], m11 = basis[1][1], ty = origin.y();
+
+		const float *inbuf  = in[a]->values;
+		float *      outbuf = out[a]->values;
 		for (unsigned int i = 0; i < out_data_size; ++i) {
 			bool add = true;
 			// check nan
-			if (std::isfinite(in[a]->values[i])) {
-				// transform to cartesian
-				double angle = M_PI * (360.f / out_data_size * i) / 180;
-
-				float x, y;
-				fawkes::polar2cart2d(angle, in[a]->values[i], &x, &y);
-
-				// transform into map
-				fawkes::tf::Point p;
-				p.setValue(x, y, 0.);
-				p = transform * p;
-
-				// transform to map cells
-				int cell_x = (int)MAP_GXWX(map_, p.getX());
-				int cell_y = (int)MAP_GYWY(map_, p.getY());
-
-				// search in for a neighborhood in num_pixels_ * num_pixels_ - 1
-				// and itself for occupied pixels in map
-				for (int ox = -num_pixels_; add && ox <= num_pixels_; ++ox) {
-					for (int oy = -num_pixels_; oy <= num_pixels_; ++oy) {
-						int x = cell_x + ox;
-						int y = cell_y + oy;
-						if (MAP_VALID(map_, x, y)) {
-							if (map_->cells[MAP_INDEX(map_, x, y)].occ_state > 0) {
-								add = false;
-								break;
-							}
-						}
-					}
+			if (std::isfinite(inbuf[i])) {
+				// beam end point in map frame
+				const float  x  = inbuf[i] * beam_cos_[i];
+				const float  y  = inbuf[i] * beam_sin_[i];
+				const double px = m00 * x + m01 * y + tx;
+				const double py = m10 * x + m11 * y + ty;
+
+				// cell in the extended near occupied grid
+				int cell_x = (int)MAP_GXWX(map_, px) + num_pixels_;
+				int cell_y = (int)MAP_GYWY(map_, py) + num_pixels_;
+				if (cell_x >= 0 && cell_x < near_occupied_width_ && cell_y >= 0
+				    && cell_y < near_occupied_height_) {
+					add = !near_occupied_[(size_t)cell_y * near_occupied_width_ + cell_x];
 				}
 			}
-			if (add) {
-				out[a]->values[i] = in[a]->values[i];
-			} else {
-				out[a]->values[i] = std::numeric_limits<float>::quiet_NaN();
-			}
+			outbuf[i] = add ? inbuf[i] : std::numeric_limits<float>::quiet_NaN();
 		}
 	}
 }
@@ -44,6 +44,16 @@ private:
 	float       cfg_occupied_thresh_;
 	int         num_pixels_;
 
+	// map cells within num_pixels_ of an occupied cell, the map is extended
+	// by num_pixels_ on each side to cover beams ending outside of the map
+	std::vector<unsigned char> near_occupied_;
+	int                        near_occupied_width_;
+	int                        near_occupied_height_;
+
+	// per beam direction, computed for the current data size
+	std::vector<float> beam_cos_;
+	std::vector<float> beam_sin_;
+
 public:
 	LaserMapFilterDataFilter(const std::string &                     filter_name,
 	                         unsigned int                            in_data_size,
@@ -52,12 +62,24 @@ public:
 	                         fawkes::Configuration *                 config,
 	                         const std::string &                     prefix,
 	                         fawkes::Logger *                        logger);
+	LaserMapFilterDataFilter(const std::string &                     filter_name,
+	                         unsigned int                            in_data_size,
+	                         std::vector<LaserDataFilter::Buffer *> &in,
+	                         fawkes::tf::Transformer *               tf_listener,
+	                         map_t *                                 map,
+	                         const std::string &                     frame_map,
+	                         int                                     num_pixels,
+	                         fawkes::Logger *                        logger);
+
+	virtual ~LaserMapFilterDataFilter();
 
 	virtual void filter();
 
 private:
 	map_t *load_map();
 	bool   is_in_map(int cell_x, int cell_y);
+	void   calc_near_occupied();
+	void   calc_beam_directions();
 };
 
 #endif
@@ -26,6 +26,9 @@
 #include <utils/time/time.h>
 
 #include <cstdlib>
+#ifdef __SSE__
+#	include <xmmintrin.h>
+#endif
 
 /** @class LaserMaxCircleDataFilter "circle.h"
  * Cut of laser data at max distance.
@@ -56,14 +59,42 @@ LaserMaxCircleDataFilter::filter()
 	for (unsigned int a = 0; a < vecsize; ++a) {
 		out[a]->frame = in[a]->frame;
 		out[a]->timestamp->set_time(in[a]->timestamp);
-		float *inbuf  = in[a]->values;
-		float *outbuf = out[a]->values;
-		for (unsigned int i = 0; i < arrsize; ++i) {
-			if (inbuf[i] > radius_) {
-				outbuf[i] = radius_;
-			} else {
-				outbuf[i] = inbuf[i];
-			}
-		}
+		filter_beams(in[a]->values, out[a]->values, 0, arrsize);
+	}
+}
+
+/** Check if the filter works beam by beam.
+ * @return always true
+ */
+bool
+LaserMaxCircleDataFilter::beamwise() const
+{
+	return true;
+}
+
+/** Filter a range of beams.
+ * @param inbuf input values
+ * @param outbuf output values, may be the same as @p inbuf
+ * @param begin index of first beam to filter
+ * @param end index after the last beam to filter
+ */
+void
+LaserMaxCircleDataFilter::filter_beams(const float *inbuf,
+                                       float *      outbuf,
+                                       unsigned int begin,
+                                       unsigned int end) const
+{
+	unsigned int i = begin;
+#ifdef __SSE__
+	// no _mm_min_ps, it would turn invalid (NaN) beams into the radius
+	const __m128 radius = _mm_set1_ps(radius_);
+	for (; i + 4 <= end; i += 4) {
+		const __m128 v    = _mm_loadu_ps(inbuf + i);
+		const __m128 mask = _mm_cmpgt_ps(v, radius);
+		_mm_storeu_ps(outbuf + i, _mm_or_ps(_mm_and_ps(mask, radius), _mm_andnot_ps(mask, v)));
+	}
+#endif
+	for (; i < end; ++i) {
+		outbuf[i] = (inbuf[i] > radius_) ? radius_ : inbuf[i];
 	}
 }
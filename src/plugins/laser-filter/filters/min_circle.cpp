@@ -27,6 +27,9 @@
 
 #include <cstdlib>
 #include <limits>
+#ifdef __SSE__
+#	include <xmmintrin.h>
+#endif
 
 /** @class LaserMinCircleDataFilter "min_circle.h"
  * Erase beams below a certain minimum distance distance.
@@ -57,14 +60,43 @@ LaserMinCircleDataFilter::filter()
 	for (unsigned int a = 0; a < vecsize; ++a) {
 		out[a]->frame = in[a]->frame;
 		out[a]->timestamp->set_time(in[a]->timestamp);
-		float *inbuf  = in[a]->values;
-		float *outbuf = out[a]->values;
-		for (unsigned int i = 0; i < arrsize; ++i) {
-			if (inbuf[i] < radius_) {
-				outbuf[i] = std::numeric_limits<float>::quiet_NaN();
-			} else {
-				outbuf[i] = inbuf[i];
-			}
-		}
+		filter_beams(in[a]->values, out[a]->values, 0, arrsize);
+	}
+}
+
+/** Check if the filter works beam by beam.
+ * @return always true
+ */
+bool
+LaserMinCircleDataFilter::beamwise() const
+{
+	return true;
+}
+
+/** Filter a range of beams.
+ * @param inbuf input values
+ * @param outbuf output values, may be the same as @p inbuf
+ * @param begin index of first beam to filter
+ * @param end index after the last beam to filter
+ */
+void
+LaserMinCircleDataFilter::filter_beams(const float *inbuf,
+                                       float *      outbuf,
+                                       unsigned int begin,
+                                       unsigned int end) const
+{
+	const float  nan = std::numeric_limits<float>::quiet_NaN();
+	unsigned int i   = begin;
+#ifdef __SSE__
+	const __m128 radius = _mm_set1_ps(radius_);
+	const __m128 nans   = _mm_set1_ps(nan);
+	for (; i + 4 <= end; i += 4) {
+		const __m128 v    = _mm_loadu_ps(inbuf + i);
+		const __m128 mask = _mm_cmplt_ps(v, radius);
+		_mm_storeu_ps(outbuf + i, _mm_or_ps(_mm_and_ps(mask, nans), _mm_andnot_ps(mask, v)));
+	}
+#endif
+	for (; i < end; ++i) {
+		outbuf[i] = (inbuf[i] < radius_) ? nan : inbuf[i];
 	}
 }
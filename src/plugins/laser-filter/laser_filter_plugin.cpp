@@ -26,6 +26,7 @@
 
 #include <core/threading/barrier.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -135,53 +136,69 @@ LaserFilterPlugin::LaserFilterPlugin(Configuration *config) : Plugin(config)
 
 	// Detect inter-thread dependencies, setup proper serialization by
 	// create a list of threads that one threads depends on and setting
-	// it. Setup common "end of filtering" barrier.
+	// it. Dependencies are detected from matching input and output
+	// interfaces, additional ones can be given explicitly as a list of
+	// filter config names in depends_on. Threads which neither depend on
+	// another thread nor are depended on run independently.
 	try {
-		bool has_deps = false;
+		std::map<std::string, std::set<std::string>> deps;
 		for (c = configs.begin(); c != configs.end(); ++c) {
-			//printf("Config %s\n", c->c_str());
-
-			std::list<LaserFilterThread *> depthreads;
-
 			std::list<std::string>::iterator i, o;
 			std::list<std::string> &         cinputs = inputs[*c];
 			for (i = cinputs.begin(); i != cinputs.end(); ++i) {
-				//printf("  Input %s\n", i->c_str());
-
 				for (d = configs.begin(); d != configs.end(); ++d) {
 					if (*c == *d)
 						continue;
-					//printf("    Config %s\n", d->c_str());
 
 					std::list<std::string> &coutputs = outputs[*d];
 					for (o = coutputs.begin(); o != coutputs.end(); ++o) {
-						//printf("      Output %s\n", o->c_str());
 						if (*i == *o) {
-							has_deps = true;
-							//printf("        *** Dep Thread matches %s for %s\n",
-							//       d->c_str(), o->c_str());
-							depthreads.push_back(threads[*d]);
+							deps[*c].insert(*d);
 							break;
 						}
 					}
 				}
 			}
 
-			if (!depthreads.empty()) {
-				depthreads.sort();
-				depthreads.unique();
-				threads[*c]->set_wait_threads(depthreads);
+			std::vector<std::string> explicit_deps;
+			try {
+				explicit_deps = config->get_strings((prefix + *c + "/depends_on").c_str());
+			} catch (Exception &e) {
+			} // ignored, no explicit dependencies
+			for (const std::string &ed : explicit_deps) {
+				if (configs.find(ed) == configs.end()) {
+					throw Exception("Laser filter %s depends on unknown or inactive filter %s",
+					                c->c_str(),
+					                ed.c_str());
+				}
+				if (ed != *c)
+					deps[*c].insert(ed);
 			}
 		}
 
-		// If any dependencies have been detected, have all threads wait at
-		// a common "end of filtering" barrier, which allows for resetting
-		// a "need to wait for done" flag.
-		if (has_deps) {
-			std::map<std::string, LaserFilterThread *>::iterator t;
-			barrier_ = new Barrier(threads.size());
-			for (t = threads.begin(); t != threads.end(); ++t) {
-				t->second->set_wait_barrier(barrier_);
+		check_dependency_cycles(deps);
+
+		std::set<std::string> dependent_configs;
+		for (const auto &dep : deps) {
+			if (dep.second.empty())
+				continue;
+
+			std::list<LaserFilterThread *> depthreads;
+			for (const std::string &dn : dep.second) {
+				depthreads.push_back(threads[dn]);
+				dependent_configs.insert(dn);
+			}
+			threads[dep.first]->set_wait_threads(depthreads);
+			dependent_configs.insert(dep.first);
+		}
+
+		// Threads involved in dependencies wait at a common "end of
+		// filtering" barrier, which allows for resetting a "need to wait
+		// for done" flag.
+		if (!dependent_configs.empty()) {
+			barrier_ = new Barrier(dependent_configs.size());
+			for (const std::string &dc : dependent_configs) {
+				threads[dc]->set_wait_barrier(barrier_);
 			}
 		}
 
@@ -199,5 +216,42 @@ LaserFilterPlugin::~LaserFilterPlugin()
 	delete barrier_;
 }
 
+/** Make sure filter dependencies do not form a cycle.
+ * A cycle would make the involved threads wait for each other forever.
+ * @param deps map from filter config name to the names of the configs
+ * it depends on
+ * @exception Exception thrown if a cycle exists
+ */
+void
+LaserFilterPlugin::check_dependency_cycles(
+  const std::map<std::string, std::set<std::string>> &deps)
+{
+	// 0: not visited, 1: on the current path, 2: done
+	std::map<std::string, int> state;
+
+	std::function<void(const std::string &)> visit;
+	visit = [&](const std::string &name) {
+		state[name] = 1;
+		auto dep    = deps.find(name);
+		if (dep != deps.end()) {
+			for (const std::string &dn : dep->second) {
+				if (state[dn] == 1) {
+					throw Exception("Laser filter dependency cycle between %s and %s",
+					                name.c_str(),
+					                dn.c_str());
+				} else if (state[dn] == 0) {
+					visit(dn);
+				}
+			}
+		}
+		state[name] = 2;
+	};
+
+	for (const auto &dep : deps) {
+		if (state[dep.first] == 0)
+			visit(dep.first);
+	}
+}
+
 PLUGIN_DESCRIPTION("Filter laser data in blackboard")
 EXPORT_PLUGIN(LaserFilterPlugin)
@@ -25,6 +25,10 @@
 
 #include <core/plugin.h>
 
+#include <map>
+#include <set>
+#include <string>
+
 namespace fawkes {
 class Barrier;
 }
@@ -35,6 +39,9 @@ public:
 	explicit LaserFilterPlugin(fawkes::Configuration *config);
 	~LaserFilterPlugin();
 
+private:
+	void check_dependency_cycles(const std::map<std::string, std::set<std::string>> &deps);
+
 private:
 	fawkes::Barrier *barrier_;
 };
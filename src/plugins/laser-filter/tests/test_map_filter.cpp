@@ -0,0 +1,191 @@
+/***************************************************************************
+ *  test_map_filter.cpp - Laser map data filter test
+ *
+ *  Created: Thu Oct 15 10:16:08 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "../filters/map_filter.h"
+
+#include <logging/cache.h>
+#include <tf/transformer.h>
+#include <utils/math/coord.h>
+#include <utils/time/time.h>
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace fawkes;
+
+namespace {
+
+/** Create a map with walls and randomly occupied cells.
+ * @param gen random number generator
+ * @return map, free with map_free()
+ */
+map_t *
+create_map(std::mt19937 &gen)
+{
+	map_t *map    = map_alloc();
+	map->size_x   = 80;
+	map->size_y   = 60;
+	map->scale    = 0.05;
+	map->origin_x = 1.0;
+	map->origin_y = -0.5;
+	map->cells    = (map_cell_t *)malloc(sizeof(map_cell_t) * map->size_x * map->size_y);
+
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+	for (int y = 0; y < map->size_y; ++y) {
+		for (int x = 0; x < map->size_x; ++x) {
+			int   state = -1;
+			float r     = unit(gen);
+			if (x == 0 || y == 0 || x == map->size_x - 1 || y == map->size_y - 1 || r < 0.03f) {
+				state = 1;
+			} else if (r < 0.1f) {
+				state = 0;
+			}
+			map->cells[MAP_INDEX(map, x, y)].occ_state = state;
+		}
+	}
+	return map;
+}
+
+/** Reference filter, searches the neighborhood of each beam end point.
+ * @param map map to filter against
+ * @param num_pixels size of the neighborhood to search
+ * @param transform transform from laser to map frame
+ * @param in input values
+ * @return filtered values
+ */
+std::vector<float>
+reference_filter(const map_t *             map,
+                 int                       num_pixels,
+                 const tf::Transform &     transform,
+                 const std::vector<float> &in)
+{
+	std::vector<float> out(in.size());
+	for (unsigned int i = 0; i < in.size(); ++i) {
+		bool add = true;
+		if (std::isfinite(in[i])) {
+			double angle = M_PI * (360.f / in.size() * i) / 180;
+
+			float x, y;
+			polar2cart2d(angle, in[i], &x, &y);
+
+			tf::Point p;
+			p.setValue(x, y, 0.);
+			p = transform * p;
+
+			int cell_x = (int)MAP_GXWX(map, p.getX());
+			int cell_y = (int)MAP_GYWY(map, p.getY());
+
+			for (int ox = -num_pixels; add && ox <= num_pixels; ++ox) {
+				for (int oy = -num_pixels; oy <= num_pixels; ++oy) {
+					int cx = cell_x + ox;
+					int cy = cell_y + oy;
+					if (MAP_VALID(map, cx, cy) && map->cells[MAP_INDEX(map, cx, cy)].occ_state > 0) {
+						add = false;
+						break;
+					}
+				}
+			}
+		}
+		out[i] = add ? in[i] : std::numeric_limits<float>::quiet_NaN();
+	}
+	return out;
+}
+
+} // namespace
+
+TEST_CASE("Map filter matches neighborhood search", "[laser-filter][map_filter]")
+{
+	std::mt19937                          gen(7);
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+	CacheLogger                           logger;
+
+	for (unsigned int data_size : {360u, 720u}) {
+		for (int num_pixels : {0, 1, 2, 5}) {
+			map_t *map = create_map(gen);
+
+			std::vector<LaserDataFilter::Buffer *> in;
+			in.push_back(new LaserDataFilter::Buffer(data_size));
+			in[0]->frame = "base_laser";
+
+			tf::Transformer transformer;
+			// the map filter takes ownership of the map, keep a copy for reference
+			map_t *ref_map = map_alloc();
+			*ref_map       = *map;
+			ref_map->cells = (map_cell_t *)malloc(sizeof(map_cell_t) * map->size_x * map->size_y);
+			std::copy(map->cells, map->cells + map->size_x * map->size_y, ref_map->cells);
+
+			LaserMapFilterDataFilter filter(
+			  "map_filter", data_size, in, &transformer, map, "map", num_pixels, &logger);
+
+			unsigned int num_removed = 0;
+			for (unsigned int k = 0; k < 20; ++k) {
+				// poses also partly outside of the map, so that beams end
+				// beyond each border of the map
+				tf::Transform transform(tf::create_quaternion_from_yaw(2 * M_PI * unit(gen)),
+				                        tf::Vector3(-2.f + 6.f * unit(gen), -3.f + 5.f * unit(gen), 0.));
+				Time          stamp(1000 + k, 0);
+				transformer.set_transform(
+				  tf::StampedTransform(transform, stamp, "map", "base_laser"), "test");
+
+				std::vector<float> values(data_size);
+				for (unsigned int i = 0; i < data_size; ++i) {
+					if (i % 23 == 0) {
+						values[i] = std::numeric_limits<float>::quiet_NaN();
+					} else if (i % 31 == 0) {
+						values[i] = std::numeric_limits<float>::infinity();
+					} else {
+						values[i] = 6.f * unit(gen);
+					}
+				}
+				std::copy(values.begin(), values.end(), in[0]->values);
+				in[0]->timestamp->set_time(stamp);
+
+				filter.filter();
+
+				std::vector<float> expected = reference_filter(ref_map, num_pixels, transform, values);
+				const float *      out      = filter.get_out_vector()[0]->values;
+				unsigned int       num_diff = 0;
+				for (unsigned int i = 0; i < data_size; ++i) {
+					if (std::isnan(expected[i])) {
+						if (!std::isnan(out[i]))
+							++num_diff;
+						if (!std::isnan(values[i]))
+							++num_removed;
+					} else if (!(out[i] == expected[i])) {
+						++num_diff;
+					}
+				}
+				INFO("data size " << data_size << ", num pixels " << num_pixels << ", scan " << k);
+				REQUIRE(num_diff == 0);
+				REQUIRE(*filter.get_out_vector()[0]->timestamp == stamp);
+			}
+			// the scans must actually have hit the map
+			REQUIRE(num_removed > 0);
+
+			map_free(ref_map);
+			delete in[0];
+		}
+	}
+}
@@ -224,17 +224,29 @@ LaserLinesThread::loop()
 	} else {
 		//logger->log_info(name(), "[L %u] total: %zu   finite: %zu",
 		//		     loop_count_, input_->points.size(), in_cloud->points.size());
-		std::vector<LineInfo> linfos = calc_lines<PointType>(input_,
-		                                                     cfg_segm_min_inliers_,
-		                                                     cfg_segm_max_iterations_,
-		                                                     cfg_segm_distance_threshold_,
-		                                                     cfg_segm_sample_max_dist_,
-		                                                     cfg_cluster_tolerance_,
-		                                                     cfg_cluster_quota_,
-		                                                     cfg_min_length_,
-		                                                     cfg_max_length_,
-		                                                     cfg_min_dist_,
-		                                                     cfg_max_dist_);
+		std::vector<LineInfo> linfos;
+		if (cfg_ransac_backend_) {
+			line_ransac_.set_segmentation_params(cfg_segm_min_inliers_,
+			                                     cfg_segm_max_iterations_,
+			                                     cfg_segm_distance_threshold_,
+			                                     cfg_segm_sample_max_dist_);
+			line_ransac_.set_cluster_params(cfg_cluster_tolerance_, cfg_cluster_quota_);
+			line_ransac_.set_line_limits(cfg_min_length_, cfg_max_length_, cfg_min_dist_, cfg_max_dist_);
+			line_ransac_.set_parallel(cfg_ransac_parallel_);
+			linfos = line_ransac_.calc_lines(*input_);
+		} else {
+			linfos = calc_lines<PointType>(input_,
+			                               cfg_segm_min_inliers_,
+			                               cfg_segm_max_iterations_,
+			                               cfg_segm_distance_threshold_,
+			                               cfg_segm_sample_max_dist_,
+			                               cfg_cluster_tolerance_,
+			                               cfg_cluster_quota_,
+			                               cfg_min_length_,
+			                               cfg_max_length_,
+			                               cfg_min_dist_,
+			                               cfg_max_dist_);
+		}
 
 		TIMETRACK_INTER(ttc_extract_lines_, ttc_clustering_);
 		update_lines(linfos);
@@ -268,6 +280,22 @@ LaserLinesThread::read_config()
 	cfg_max_num_lines_ = config->get_uint(CFG_PREFIX "max_num_lines");
 
 	cfg_tracking_frame_id_ = config->get_string("/frames/odom");
+
+	cfg_ransac_backend_  = false;
+	cfg_ransac_parallel_ = false;
+	try {
+		std::string backend = config->get_string(CFG_PREFIX "line_extraction_backend");
+		if (backend == "ransac") {
+			cfg_ransac_backend_ = true;
+		} else if (backend != "pcl") {
+			logger->log_warn(name(), "Invalid line extraction backend '%s', using pcl", backend.c_str());
+		}
+	} catch (Exception &e) {
+	} // ignored, use default
+	try {
+		cfg_ransac_parallel_ = config->get_bool(CFG_PREFIX "line_extraction_parallel");
+	} catch (Exception &e) {
+	} // ignored, use default
 }
 
 void
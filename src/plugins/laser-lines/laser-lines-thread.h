@@ -24,6 +24,7 @@
 
 // must be first for reliable ROS detection
 #include "line_info.h"
+#include "line_ransac.h"
 
 #include <aspect/blackboard.h>
 #include <aspect/blocked_timing.h>
@@ -150,6 +151,8 @@ private:
 	CloudConstPtr                                    input_;
 	pcl::PointCloud<ColorPointType>::Ptr             lines_;
 
+	LineRansac line_ransac_;
+
 	std::vector<fawkes::LaserLineInterface *> line_ifs_;
 	std::vector<fawkes::LaserLineInterface *> line_avg_ifs_;
 	std::vector<TrackedLineInfo>              known_lines_;
@@ -174,6 +177,8 @@ private:
 	bool         cfg_moving_avg_enabled_;
 	unsigned int cfg_moving_avg_window_size_;
 	std::string  cfg_tracking_frame_id_;
+	bool         cfg_ransac_backend_;
+	bool         cfg_ransac_parallel_;
 
 	unsigned int loop_count_;
 
@@ -0,0 +1,480 @@
+
+/***************************************************************************
+ *  line_ransac.cpp - allocation-free RANSAC line extraction for 2D laser data
+ *
+ *  Created: Thu Oct 15 03:56:01 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "line_ransac.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+/** Number of neighbouring points in scan order to choose the second sample from. */
+#define SAMPLE_WINDOW 64
+/** Number of attempts to find a valid second sample. */
+#define SAMPLE_ATTEMPTS 16
+
+/** @class LineRansac "line_ransac.h"
+ * RANSAC line extraction for 2D laser data.
+ * This is an alternative to calc_lines() which produces comparable
+ * results without using PCL segmentation, search, and filter classes.
+ * Points are kept in flat arrays which are compacted in place after
+ * each extracted line, all buffers are re-used across calls. Therefore,
+ * in steady state, only the output line infos are allocated.
+ *
+ * Lines are searched in the X-Y plane. The second point of a hypothesis
+ * is chosen among the neighbours of the first point in the input order,
+ * which for laser data is the scan order, and must be within the
+ * sample max distance. Hypotheses can optionally be evaluated in
+ * parallel if compiled with OpenMP. Found lines are refined by a least
+ * squares fit and split into contiguous segments along the line, of
+ * which the largest is accepted, just like calc_lines() does.
+ * @author agent
+ */
+
+/** Constructor. */
+LineRansac::LineRansac()
+: min_inliers_(20),
+  max_iterations_(250),
+  distance_threshold_(0.05),
+  sample_max_dist_(0.25),
+  cluster_tolerance_(0.2),
+  cluster_quota_(0.1),
+  min_length_(-1.),
+  max_length_(-1.),
+  min_dist_(-1.),
+  max_dist_(-1.),
+  parallel_(false),
+  seed_(0)
+{
+}
+
+/** Set segmentation parameters.
+ * @param min_inliers minimum total number of required inliers to consider a line
+ * @param max_iterations maximum number of RANSAC iterations per line
+ * @param distance_threshold maximum distance of point to line to account it to a line
+ * @param sample_max_dist maximum distance between the two samples of a hypothesis,
+ * no limit if less or equal to zero
+ */
+void
+LineRansac::set_segmentation_params(unsigned int min_inliers,
+                                    unsigned int max_iterations,
+                                    float        distance_threshold,
+                                    float        sample_max_dist)
+{
+	min_inliers_        = min_inliers;
+	max_iterations_     = max_iterations;
+	distance_threshold_ = distance_threshold;
+	sample_max_dist_    = sample_max_dist;
+}
+
+/** Set line clustering parameters.
+ * @param tolerance maximum gap between points along a line
+ * @param quota minimum fraction of inliers that must remain in the
+ * largest contiguous segment to accept the line
+ */
+void
+LineRansac::set_cluster_params(float tolerance, float quota)
+{
+	cluster_tolerance_ = tolerance;
+	cluster_quota_     = quota;
+}
+
+/** Set line acceptance limits.
+ * Limits are ignored if less than zero.
+ * @param min_length minimum length of line to consider it
+ * @param max_length maximum length of a line to consider it
+ * @param min_dist minimum distance from frame origin to closest point on line to consider it
+ * @param max_dist maximum distance from frame origin to closest point on line to consider it
+ */
+void
+LineRansac::set_line_limits(float min_length, float max_length, float min_dist, float max_dist)
+{
+	min_length_ = min_length;
+	max_length_ = max_length;
+	min_dist_   = min_dist;
+	max_dist_   = max_dist;
+}
+
+/** Enable or disable parallel hypothesis evaluation.
+ * Only has an effect if compiled with OpenMP.
+ * @param parallel true to evaluate hypotheses in parallel
+ */
+void
+LineRansac::set_parallel(bool parallel)
+{
+	parallel_ = parallel;
+}
+
+/** Calculate lines from a given point cloud.
+ * @param input input point cloud from which to extract lines
+ * @return vector of info about detected lines
+ */
+std::vector<LineInfo>
+LineRansac::calc_lines(const pcl::PointCloud<pcl::PointXYZ> &input)
+{
+	x_.clear();
+	y_.clear();
+	z_.clear();
+	for (const pcl::PointXYZ &p : input.points) {
+		if (std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z)) {
+			x_.push_back(p.x);
+			y_.push_back(p.y);
+			z_.push_back(p.z);
+		}
+	}
+
+	std::vector<LineInfo> linfos;
+
+	while (x_.size() > min_inliers_) {
+		Hypothesis h;
+		if (!find_line(h) || h.num_inliers < min_inliers_) {
+			break;
+		}
+
+		// optimize coefficients based on all inliers
+		collect_inliers(h);
+		fit_line(inliers_, h);
+		collect_inliers(h);
+		if (inliers_.size() < min_inliers_) {
+			break;
+		}
+
+		// make sure it is a contiguous line, the hypothesis may combine
+		// lines at separate ends of the field of view
+		cluster_inliers(h);
+
+		if (cluster_.empty()) {
+			remove_points(inliers_);
+			continue;
+		}
+
+		fit_line(cluster_, h);
+
+		LineInfo info;
+		bool     valid = make_line_info(h, info);
+		remove_points(cluster_);
+		if (valid) {
+			linfos.push_back(info);
+		}
+	}
+
+	return linfos;
+}
+
+/** Find best line hypothesis among remaining points.
+ * @param best upon return contains the best hypothesis
+ * @return true if a hypothesis was found, false otherwise
+ */
+bool
+LineRansac::find_line(Hypothesis &best)
+{
+	best.num_inliers = 0;
+	best.iteration   = max_iterations_;
+
+	const unsigned int base_seed = seed_;
+	seed_ += max_iterations_;
+
+#pragma omp parallel if (parallel_)
+	{
+		Hypothesis local_best;
+		local_best.num_inliers = 0;
+		local_best.iteration   = max_iterations_;
+
+#pragma omp for schedule(static)
+		for (int i = 0; i < (int)max_iterations_; ++i) {
+			// per-iteration seed for reproducible results regardless of threads
+			unsigned int seed = (base_seed + i) * 2654435761u;
+			Hypothesis   h;
+			if (!sample(seed, h))
+				continue;
+			h.num_inliers = count_inliers(h);
+			h.iteration   = i;
+			if (h.num_inliers > local_best.num_inliers) {
+				local_best = h;
+			}
+		}
+
+#pragma omp critical
+		{
+			if (local_best.num_inliers > best.num_inliers
+			    || (local_best.num_inliers == best.num_inliers
+			        && local_best.iteration < best.iteration)) {
+				best = local_best;
+			}
+		}
+	}
+
+	return best.num_inliers > 0;
+}
+
+/** Sample a line hypothesis.
+ * @param seed random seed, modified
+ * @param h upon return contains the hypothesis
+ * @return true if a valid hypothesis was sampled, false otherwise
+ */
+bool
+LineRansac::sample(unsigned int &seed, Hypothesis &h) const
+{
+	const int n = x_.size();
+	if (n < 2)
+		return false;
+
+	const int   a              = rand_r(&seed) % n;
+	const int   window         = std::min(n - 1, SAMPLE_WINDOW);
+	const float max_dist_sq    = sample_max_dist_ * sample_max_dist_;
+	const bool  limit_distance = sample_max_dist_ > 0.;
+
+	for (unsigned int i = 0; i < SAMPLE_ATTEMPTS; ++i) {
+		int b;
+		if (limit_distance) {
+			int offset = 1 + rand_r(&seed) % window;
+			b          = (rand_r(&seed) & 1) ? a + offset : a - offset;
+			if (b < 0 || b >= n)
+				continue;
+		} else {
+			b = rand_r(&seed) % n;
+			if (b == a)
+				continue;
+		}
+
+		float dx      = x_[b] - x_[a];
+		float dy      = y_[b] - y_[a];
+		float dist_sq = dx * dx + dy * dy;
+		if (dist_sq < 1e-12 || (limit_distance && dist_sq > max_dist_sq))
+			continue;
+
+		float dist = sqrtf(dist_sq);
+		h.px       = x_[a];
+		h.py       = y_[a];
+		h.dx       = dx / dist;
+		h.dy       = dy / dist;
+		return true;
+	}
+	return false;
+}
+
+/** Count inliers of a hypothesis.
+ * @param h hypothesis to evaluate
+ * @return number of remaining points within the distance threshold
+ */
+unsigned int
+LineRansac::count_inliers(const Hypothesis &h) const
+{
+	const float  nx = -h.dy;
+	const float  ny = h.dx;
+	const float  d  = nx * h.px + ny * h.py;
+	const size_t n  = x_.size();
+	const float *x  = x_.data();
+	const float *y  = y_.data();
+
+	unsigned int count = 0;
+	for (size_t i = 0; i < n; ++i) {
+		count += (fabsf(nx * x[i] + ny * y[i] - d) <= distance_threshold_) ? 1 : 0;
+	}
+	return count;
+}
+
+/** Collect indices of inliers of a hypothesis into inliers_.
+ * @param h hypothesis
+ */
+void
+LineRansac::collect_inliers(const Hypothesis &h)
+{
+	const float nx = -h.dy;
+	const float ny = h.dx;
+	const float d  = nx * h.px + ny * h.py;
+
+	inliers_.clear();
+	for (unsigned int i = 0; i < x_.size(); ++i) {
+		if (fabsf(nx * x_[i] + ny * y_[i] - d) <= distance_threshold_) {
+			inliers_.push_back(i);
+		}
+	}
+}
+
+/** Least squares fit of a line.
+ * The line passes through the centroid of the given points along the
+ * principal axis of their covariance.
+ * @param indices indices of points to fit the line to
+ * @param h upon return contains the fitted line, number of inliers
+ * and iteration are not modified
+ */
+void
+LineRansac::fit_line(const std::vector<unsigned int> &indices, Hypothesis &h) const
+{
+	if (indices.size() < 2)
+		return;
+
+	double cx = 0., cy = 0.;
+	for (unsigned int i : indices) {
+		cx += x_[i];
+		cy += y_[i];
+	}
+	cx /= indices.size();
+	cy /= indices.size();
+
+	double sxx = 0., sxy = 0., syy = 0.;
+	for (unsigned int i : indices) {
+		double dx = x_[i] - cx;
+		double dy = y_[i] - cy;
+		sxx += dx * dx;
+		sxy += dx * dy;
+		syy += dy * dy;
+	}
+
+	// orientation of the principal axis of the 2x2 covariance matrix
+	double theta = 0.5 * atan2(2. * sxy, sxx - syy);
+	h.px         = cx;
+	h.py         = cy;
+	h.dx         = cos(theta);
+	h.dy         = sin(theta);
+}
+
+/** Split inliers into contiguous segments along the line.
+ * Upon return cluster_ contains the indices of the largest segment,
+ * or is empty if it has less points than the configured quota of
+ * inliers, and line_params_ contains the sorted line parameters of
+ * all inliers.
+ * @param h line hypothesis
+ */
+void
+LineRansac::cluster_inliers(const Hypothesis &h)
+{
+	line_params_.clear();
+	for (unsigned int i : inliers_) {
+		line_params_.push_back(std::make_pair(h.dx * (x_[i] - h.px) + h.dy * (y_[i] - h.py), i));
+	}
+	std::sort(line_params_.begin(), line_params_.end());
+
+	size_t best_begin = 0, best_end = 0;
+	size_t begin = 0;
+	for (size_t i = 1; i <= line_params_.size(); ++i) {
+		if (i == line_params_.size()
+		    || line_params_[i].first - line_params_[i - 1].first > cluster_tolerance_) {
+			if (i - begin > best_end - best_begin) {
+				best_begin = begin;
+				best_end   = i;
+			}
+			begin = i;
+		}
+	}
+
+	cluster_.clear();
+	size_t min_size = (size_t)floorf(cluster_quota_ * inliers_.size());
+	if (best_end - best_begin > 0 && best_end - best_begin >= min_size) {
+		for (size_t i = best_begin; i < best_end; ++i) {
+			cluster_.push_back(line_params_[i].second);
+		}
+	}
+}
+
+/** Remove points from the remaining points.
+ * @param indices indices of points to remove
+ */
+void
+LineRansac::remove_points(const std::vector<unsigned int> &indices)
+{
+	removed_.assign(x_.size(), 0);
+	for (unsigned int i : indices) {
+		removed_[i] = 1;
+	}
+
+	size_t o = 0;
+	for (size_t i = 0; i < x_.size(); ++i) {
+		if (!removed_[i]) {
+			x_[o] = x_[i];
+			y_[o] = y_[i];
+			z_[o] = z_[i];
+			++o;
+		}
+	}
+	x_.resize(o);
+	y_.resize(o);
+	z_.resize(o);
+}
+
+/** Create line info for cluster_.
+ * @param h line fitted to the points of cluster_
+ * @param info upon return contains the line info
+ * @return true if the line satisfies the configured limits, false otherwise
+ */
+bool
+LineRansac::make_line_info(const Hypothesis &h, LineInfo &info) const
+{
+	float t_min = std::numeric_limits<float>::max();
+	float t_max = -std::numeric_limits<float>::max();
+	float z     = 0.;
+	for (unsigned int i : cluster_) {
+		float t = h.dx * (x_[i] - h.px) + h.dy * (y_[i] - h.py);
+		t_min   = std::min(t_min, t);
+		t_max   = std::max(t_max, t);
+		z += z_[i];
+	}
+	z /= cluster_.size();
+
+	float length = t_max - t_min;
+	if (length == 0 || (min_length_ >= 0 && length < min_length_)
+	    || (max_length_ >= 0 && length > max_length_)) {
+		return false;
+	}
+
+	info.point_on_line  = Eigen::Vector3f(h.px, h.py, z);
+	info.line_direction = Eigen::Vector3f(h.dx, h.dy, 0.);
+	info.length         = length;
+
+	// closest point on line to the origin
+	Eigen::Vector3f P =
+	  info.point_on_line - info.point_on_line.dot(info.line_direction) * info.line_direction;
+	P[2]            = z;
+	info.base_point = P;
+
+	float dist = Eigen::Vector2f(P[0], P[1]).norm();
+	if ((min_dist_ >= 0. && dist < min_dist_) || (max_dist_ >= 0. && dist > max_dist_)) {
+		return false;
+	}
+
+	Eigen::Vector3f x_axis(1, 0, 0);
+	info.bearing = acosf(x_axis.dot(P) / P.norm());
+	// we also want to encode the direction of the angle
+	if (P[1] < 0)
+		info.bearing = fabs(info.bearing) * -1.;
+
+	// the direction vector points from end point 1 to end point 2
+	info.end_point_1 = info.point_on_line + t_min * info.line_direction;
+	info.end_point_2 = info.point_on_line + t_max * info.line_direction;
+
+	// points projected onto the line
+	info.cloud.reset(new pcl::PointCloud<pcl::PointXYZ>());
+	info.cloud->points.resize(cluster_.size());
+	for (size_t i = 0; i < cluster_.size(); ++i) {
+		const unsigned int idx = cluster_[i];
+		float              t   = h.dx * (x_[idx] - h.px) + h.dy * (y_[idx] - h.py);
+		pcl::PointXYZ &    p   = info.cloud->points[i];
+		p.x                    = h.px + t * h.dx;
+		p.y                    = h.py + t * h.dy;
+		p.z                    = z;
+	}
+	info.cloud->width  = cluster_.size();
+	info.cloud->height = 1;
+
+	return true;
+}
@@ -0,0 +1,96 @@
+
+/***************************************************************************
+ *  line_ransac.h - allocation-free RANSAC line extraction for 2D laser data
+ *
+ *  Created: Thu Oct 15 03:56:01 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_LASER_LINES_LINE_RANSAC_H_
+#define _PLUGINS_LASER_LINES_LINE_RANSAC_H_
+
+#include "line_info.h"
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+#include <utility>
+#include <vector>
+
+class LineRansac
+{
+public:
+	LineRansac();
+
+	void set_segmentation_params(unsigned int min_inliers,
+	                             unsigned int max_iterations,
+	                             float        distance_threshold,
+	                             float        sample_max_dist);
+	void set_cluster_params(float tolerance, float quota);
+	void set_line_limits(float min_length, float max_length, float min_dist, float max_dist);
+	void set_parallel(bool parallel);
+
+	std::vector<LineInfo> calc_lines(const pcl::PointCloud<pcl::PointXYZ> &input);
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		float        px;
+		float        py;
+		float        dx;
+		float        dy;
+		unsigned int num_inliers;
+		unsigned int iteration;
+	} Hypothesis;
+	/// @endcond
+
+	bool         find_line(Hypothesis &best);
+	bool         sample(unsigned int &seed, Hypothesis &h) const;
+	unsigned int count_inliers(const Hypothesis &h) const;
+	void         collect_inliers(const Hypothesis &h);
+	void         fit_line(const std::vector<unsigned int> &indices, Hypothesis &h) const;
+	void         cluster_inliers(const Hypothesis &h);
+	void         remove_points(const std::vector<unsigned int> &indices);
+	bool         make_line_info(const Hypothesis &h, LineInfo &info) const;
+
+private:
+	unsigned int min_inliers_;
+	unsigned int max_iterations_;
+	float        distance_threshold_;
+	float        sample_max_dist_;
+	float        cluster_tolerance_;
+	float        cluster_quota_;
+	float        min_length_;
+	float        max_length_;
+	float        min_dist_;
+	float        max_dist_;
+	bool         parallel_;
+	unsigned int seed_;
+
+	// remaining points, compacted after each extracted line
+	std::vector<float> x_;
+	std::vector<float> y_;
+	std::vector<float> z_;
+
+	std::vector<unsigned int>                   inliers_;
+	std::vector<std::pair<float, unsigned int>> line_params_;
+	std::vector<unsigned int>                   cluster_;
+	std::vector<char>                           removed_;
+};
+
+#endif
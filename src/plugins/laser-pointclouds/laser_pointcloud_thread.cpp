@@ -28,13 +28,17 @@
 #include <pcl_utils/utils.h>
 #include <utils/math/angle.h>
 
+#include <cmath>
+
 using namespace fawkes;
 
-/** @class LaserPointCloudThread "tf_thread.h"
- * Thread to exchange transforms between Fawkes and ROS.
- * This threads connects to Fawkes and ROS to read and write transforms.
- * Transforms received on one end are republished to the other side. To
- * Fawkes new frames are published during the sensor hook.
+#define CFG_PREFIX "/laser-pointclouds/"
+
+/** @class LaserPointCloudThread "laser_pointcloud_thread.h"
+ * Thread to convert laser data to point clouds.
+ * For each laser interface a point cloud is published. Optionally, a
+ * reduced cloud cropped to a range and downsampled by a voxel grid is
+ * published in addition for consumers that do not need the full cloud.
  * @author Tim Niemueller
  */
 
@@ -54,6 +58,31 @@ LaserPointCloudThread::~LaserPointCloudThread()
 void
 LaserPointCloudThread::init()
 {
+	cfg_reduce_           = false;
+	cfg_reduce_suffix_    = "-reduced";
+	cfg_reduce_leaf_size_ = 0.;
+	cfg_reduce_min_range_ = 0.;
+	cfg_reduce_max_range_ = 0.;
+	try {
+		cfg_reduce_ = config->get_bool(CFG_PREFIX "reduce/enable");
+	} catch (Exception &e) {
+	} // ignored, use default
+	if (cfg_reduce_) {
+		try {
+			cfg_reduce_suffix_ = config->get_string(CFG_PREFIX "reduce/suffix");
+		} catch (Exception &e) {
+		} // ignored, use default
+		cfg_reduce_leaf_size_ = config->get_float(CFG_PREFIX "reduce/leaf_size");
+		cfg_reduce_min_range_ = config->get_float(CFG_PREFIX "reduce/min_range");
+		cfg_reduce_max_range_ = config->get_float(CFG_PREFIX "reduce/max_range");
+
+		cropped_ = pcl::PointCloud<pcl::PointXYZ>::Ptr(new pcl::PointCloud<pcl::PointXYZ>());
+		if (cfg_reduce_leaf_size_ > 0.) {
+			voxel_grid_.setLeafSize(cfg_reduce_leaf_size_, cfg_reduce_leaf_size_, cfg_reduce_leaf_size_);
+			voxel_grid_.setInputCloud(cropped_);
+		}
+	}
+
 	std::list<Laser360Interface *> l360ifs =
 	  blackboard->open_multiple_for_reading<Laser360Interface>("*");
 
@@ -76,7 +105,7 @@ LaserPointCloudThread::init()
 		mapping.cloud->header.frame_id = (*i)->frame();
 		mapping.cloud->height          = 1;
 		mapping.cloud->width           = 360;
-		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+		add_pointclouds(mapping);
 		bbil_add_reader_interface(*i);
 		bbil_add_writer_interface(*i);
 		mappings_.push_back(mapping);
@@ -94,7 +123,7 @@ LaserPointCloudThread::init()
 		mapping.cloud->header.frame_id = (*j)->frame();
 		mapping.cloud->height          = 1;
 		mapping.cloud->width           = 720;
-		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+		add_pointclouds(mapping);
 		bbil_add_reader_interface(*j);
 		bbil_add_writer_interface(*j);
 		mappings_.push_back(mapping);
@@ -113,7 +142,7 @@ LaserPointCloudThread::init()
 		mapping.cloud->header.frame_id = (*k)->frame();
 		mapping.cloud->height          = 1;
 		mapping.cloud->width           = 1080;
-		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+		add_pointclouds(mapping);
 		bbil_add_reader_interface(*k);
 		bbil_add_writer_interface(*k);
 		mappings_.push_back(mapping);
@@ -150,9 +179,10 @@ LaserPointCloudThread::finalize()
 	LockList<InterfaceCloudMapping>::iterator m;
 	for (m = mappings_.begin(); m != mappings_.end(); ++m) {
 		blackboard->close(m->interface);
-		pcl_manager->remove_pointcloud(m->id.c_str());
+		remove_pointclouds(*m);
 	}
 	mappings_.clear();
+	cropped_.reset();
 }
 
 void
@@ -192,6 +222,79 @@ LaserPointCloudThread::loop()
 		}
 
 		pcl_utils::set_time(m->cloud, *(m->interface->timestamp()));
+
+		if (cfg_reduce_) {
+			reduce(*m);
+		}
+	}
+}
+
+/** Add point clouds of a mapping to the point cloud manager.
+ * Adds the full cloud and, if enabled, the reduced cloud.
+ * @param mapping mapping whose clouds to add
+ */
+void
+LaserPointCloudThread::add_pointclouds(InterfaceCloudMapping &mapping)
+{
+	pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+	if (cfg_reduce_) {
+		mapping.reduced = new pcl::PointCloud<pcl::PointXYZ>();
+		mapping.reduced->header.frame_id = mapping.cloud->header.frame_id;
+		mapping.reduced->height          = 1;
+		mapping.reduced->width           = 0;
+		try {
+			pcl_manager->add_pointcloud((mapping.id + cfg_reduce_suffix_).c_str(), mapping.reduced);
+		} catch (Exception &e) {
+			pcl_manager->remove_pointcloud(mapping.id.c_str());
+			throw;
+		}
+	}
+}
+
+/** Remove point clouds of a mapping from the point cloud manager.
+ * @param mapping mapping whose clouds to remove
+ */
+void
+LaserPointCloudThread::remove_pointclouds(InterfaceCloudMapping &mapping)
+{
+	pcl_manager->remove_pointcloud(mapping.id.c_str());
+	if (cfg_reduce_) {
+		pcl_manager->remove_pointcloud((mapping.id + cfg_reduce_suffix_).c_str());
+	}
+}
+
+/** Compute reduced cloud.
+ * Removes points outside the configured range, which includes invalid
+ * readings of zero distance, and downsamples the remaining points with
+ * a voxel grid filter. This is done once per scan so that consumers
+ * need not filter the full cloud individually.
+ * @param mapping mapping whose reduced cloud to update
+ */
+void
+LaserPointCloudThread::reduce(InterfaceCloudMapping &mapping)
+{
+	const float min_sq = cfg_reduce_min_range_ * cfg_reduce_min_range_;
+	const float max_sq = cfg_reduce_max_range_ * cfg_reduce_max_range_;
+
+	const pcl::PointCloud<pcl::PointXYZ> &in = *mapping.cloud;
+
+	cropped_->header = in.header;
+	cropped_->points.clear();
+	for (const pcl::PointXYZ &p : in.points) {
+		const float dist_sq = p.x * p.x + p.y * p.y;
+		if (std::isfinite(dist_sq) && dist_sq > 0. && dist_sq >= min_sq
+		    && (cfg_reduce_max_range_ <= 0. || dist_sq <= max_sq)) {
+			cropped_->points.push_back(p);
+		}
+	}
+	cropped_->height   = 1;
+	cropped_->width    = cropped_->points.size();
+	cropped_->is_dense = true;
+
+	if (cfg_reduce_leaf_size_ > 0.) {
+		voxel_grid_.filter(*mapping.reduced);
+	} else {
+		*mapping.reduced = *cropped_;
 	}
 }
 
@@ -219,7 +322,7 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) no
 			mapping.cloud->points.resize(360);
 			mapping.cloud->header.frame_id = lif->frame();
 			mapping.cloud->width           = 360;
-			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+			add_pointclouds(mapping);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
 			blackboard->close(lif);
@@ -242,7 +345,7 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) no
 			mapping.cloud->points.resize(720);
 			mapping.cloud->header.frame_id = lif->frame();
 			mapping.cloud->width           = 720;
-			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+			add_pointclouds(mapping);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
 			blackboard->close(lif);
@@ -265,7 +368,7 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) no
 			mapping.cloud->points.resize(1080);
 			mapping.cloud->header.frame_id = lif->frame();
 			mapping.cloud->width           = 1080;
-			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+			add_pointclouds(mapping);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
 			blackboard->close(lif);
@@ -282,7 +385,7 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) no
 			bbil_remove_data_interface(mapping.interface);
 			blackboard->update_listener(this);
 			blackboard->close(mapping.interface);
-			pcl_manager->remove_pointcloud(mapping.id.c_str());
+			remove_pointclouds(mapping);
 		} catch (Exception &e) {
 			logger->log_error(
 			  name(), "Failed to deregister %s:%s during error recovery: %s", type, id, e.what());
@@ -345,7 +448,7 @@ LaserPointCloudThread::conditional_close(Interface *interface) noexcept
 			bbil_remove_data_interface(mapping.interface);
 			blackboard->update_listener(this);
 			blackboard->close(mapping.interface);
-			pcl_manager->remove_pointcloud(mapping.id.c_str());
+			remove_pointclouds(mapping);
 		} catch (Exception &e) {
 			logger->log_error(name(), "Failed to unregister or close %s: %s", uid.c_str(), e.what());
 		}
@@ -25,12 +25,14 @@
 // must be first for reliable ROS detection
 #include <aspect/blackboard.h>
 #include <aspect/blocked_timing.h>
+#include <aspect/configurable.h>
 #include <aspect/logging.h>
 #include <aspect/pointcloud.h>
 #include <blackboard/interface_listener.h>
 #include <blackboard/interface_observer.h>
 #include <core/threading/thread.h>
 #include <core/utils/lock_list.h>
+#include <pcl/filters/voxel_grid.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 
@@ -43,6 +45,7 @@ class Laser1080Interface;
 
 class LaserPointCloudThread : public fawkes::Thread,
                               public fawkes::LoggingAspect,
+                              public fawkes::ConfigurableAspect,
                               public fawkes::BlackBoardAspect,
                               public fawkes::BlockedTimingAspect,
                               public fawkes::PointCloudAspect,
@@ -92,9 +95,14 @@ private:
 		fawkes::Interface *interface;
 
 		fawkes::RefPtr<pcl::PointCloud<pcl::PointXYZ>> cloud;
+		fawkes::RefPtr<pcl::PointCloud<pcl::PointXYZ>> reduced;
 	} InterfaceCloudMapping;
 	/// @endcond
 
+	void add_pointclouds(InterfaceCloudMapping &mapping);
+	void remove_pointclouds(InterfaceCloudMapping &mapping);
+	void reduce(InterfaceCloudMapping &mapping);
+
 	fawkes::LockList<InterfaceCloudMapping> mappings_;
 
 	float sin_angles360[360];
@@ -103,6 +111,15 @@ private:
 	float cos_angles720[720];
 	float sin_angles1080[1080];
 	float cos_angles1080[1080];
+
+	bool        cfg_reduce_;
+	std::string cfg_reduce_suffix_;
+	float       cfg_reduce_leaf_size_;
+	float       cfg_reduce_min_range_;
+	float       cfg_reduce_max_range_;
+
+	pcl::PointCloud<pcl::PointXYZ>::Ptr cropped_;
+	pcl::VoxelGrid<pcl::PointXYZ>       voxel_grid_;
 };
 
 #endif
@@ -23,6 +23,7 @@
 
 #include <core/threading/mutex.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
@@ -32,6 +33,15 @@ using namespace fawkes;
 /** @class LaserAcquisitionThread "acquisition_thread.h"
  * Laser acqusition thread.
  * Interface for different laser types.
+ *
+ * Data is handed to the sensor thread through three buffers. The
+ * acquisition thread writes into one buffer and calls publish_data() when a
+ * scan is complete, which makes it the latest buffer and hands out another
+ * one for writing. The sensor thread takes the latest buffer with
+ * fetch_new_data(). Neither side ever waits for the other, in particular
+ * the sensor thread does not block while a device read is in progress.
+ * Each published scan starts a new latency trace named after the thread,
+ * which the sensor thread attaches to the laser interfaces.
  * @author Tim Niemueller
  *
  * @fn void LaserAcquisitionThread::pre_init(fawkes::Configuration *config, fawkes::Logger *logger) = 0;
@@ -44,20 +54,18 @@ using namespace fawkes;
  */
 
 /** @var fawkes::Mutex * LaserAcquisitionThread::_data_mutex
- * Lock while writing to distances or echoes array or marking new data
- */
-
-/** @var bool LaserAcquisitionThread::_new_data
- * Set to true in your loop if new data is available. Set to false automatically
- * in get_distance_data() and get_echoes_data().
+ * Lock while writing to distances or echoes array. This only serializes
+ * writers within the acquisition thread, readers never lock it.
  */
 
 /** @var float * LaserAcquisitionThread::_distances
- * Allocate a float array and copy your distance values measured in meters here.
+ * Write buffer for distance values measured in meters. Allocate with
+ * alloc_distances(). The pointer changes with every call to publish_data().
  */
 
 /** @var float * LaserAcquisitionThread::_echoes
- * Allocate a float array and copy your echo values here.
+ * Write buffer for echo values. Allocate with alloc_echoes(). The pointer
+ * changes with every call to publish_data().
  */
 
 /** @var unsigned int LaserAcquisitionThread::_distances_size
@@ -69,7 +77,19 @@ using namespace fawkes;
  */
 
 /** @var fawkes::Time * LaserAcquisitionThread::_timestamp
- * Time when the most recent data was received.
+ * Time when the data in the write buffer was received.
+ * If _scan_duration is set this must be the time the first beam of the
+ * scan was measured.
+ */
+
+/** @var float LaserAcquisitionThread::_scan_duration
+ * Time in seconds the scanner takes for a full revolution, zero if unknown.
+ * Beams are assumed to be measured in the order of increasing index,
+ * starting at _scan_first_beam.
+ */
+
+/** @var unsigned int LaserAcquisitionThread::_scan_first_beam
+ * Index of the beam in _distances that is measured first in a scan.
  */
 
 /** Constructor.
@@ -78,64 +98,85 @@ using namespace fawkes;
 LaserAcquisitionThread::LaserAcquisitionThread(const char *thread_name)
 : Thread(thread_name, Thread::OPMODE_CONTINUOUS)
 {
-	_data_mutex     = new Mutex();
-	_timestamp      = new Time();
-	_new_data       = false;
-	_distances      = NULL;
-	_echoes         = NULL;
-	_distances_size = 0;
-	_echoes_size    = 0;
+	_data_mutex       = new Mutex();
+	_distances        = NULL;
+	_echoes           = NULL;
+	_distances_size   = 0;
+	_echoes_size      = 0;
+	_scan_duration    = 0.;
+	_scan_first_beam  = 0;
+	distance_buffers_ = NULL;
+	echo_buffers_     = NULL;
+	read_buffer_      = 0;
+	latency_source_   = LatencyTrace::source(thread_name);
+	memset(latency_traces_, 0, sizeof(latency_traces_));
+	latest_.store(1);
+	set_write_buffer(2);
 }
 
 LaserAcquisitionThread::~LaserAcquisitionThread()
 {
 	delete _data_mutex;
-	delete _timestamp;
+	free(distance_buffers_);
+	free(echo_buffers_);
 }
 
-/** Lock data if fresh.
- * If new data has been received since get_distance_data() or get_echo_data()
- * was called last the data is locked, no new data can arrive until you call
- * unlock(), otherwise the lock is immediately released after checking.
- * @return true if the lock was acquired and there is new data, false otherwise
+/** Fetch the latest data if fresh.
+ * If new data has been published since the last call, the latest buffer
+ * becomes the read buffer returned by get_distance_data(), get_echo_data(),
+ * and get_timestamp(). The read buffer is not modified until the next call
+ * to this method. This never blocks.
+ * @return true if there is new data, false otherwise
  */
 bool
-LaserAcquisitionThread::lock_if_new_data()
+LaserAcquisitionThread::fetch_new_data()
 {
-	_data_mutex->lock();
-	if (_new_data) {
-		return true;
-	} else {
-		_data_mutex->unlock();
+	if (!(latest_.load(std::memory_order_relaxed) & NEW_DATA)) {
 		return false;
 	}
+	read_buffer_ = latest_.exchange(read_buffer_, std::memory_order_acq_rel) & ~NEW_DATA;
+	return true;
 }
 
-/** Unlock data, */
+/** Publish the write buffer.
+ * Call this from a laser acquisition thread implementation when the
+ * distances, echoes, and timestamp of a scan have been written. The write
+ * buffer becomes the latest buffer and _distances, _echoes, and _timestamp
+ * point to another buffer afterwards, which still holds older data.
+ */
 void
-LaserAcquisitionThread::unlock()
+LaserAcquisitionThread::publish_data()
 {
-	_data_mutex->unlock();
+	latency_traces_[write_buffer_] = LatencyTrace::create(latency_source_);
+	unsigned int previous = latest_.exchange(write_buffer_ | NEW_DATA, std::memory_order_acq_rel);
+	set_write_buffer(previous & ~NEW_DATA);
+}
+
+void
+LaserAcquisitionThread::set_write_buffer(unsigned int buffer)
+{
+	write_buffer_ = buffer;
+	_timestamp    = &timestamps_[buffer];
+	_distances    = distance_buffers_ ? distance_buffers_ + buffer * _distances_size : NULL;
+	_echoes       = echo_buffers_ ? echo_buffers_ + buffer * _echoes_size : NULL;
 }
 
 /** Get distance data.
- * @return Float array with distance values
+ * @return Float array with distance values of the read buffer
  */
 const float *
 LaserAcquisitionThread::get_distance_data()
 {
-	_new_data = false;
-	return _distances;
+	return distance_buffers_ ? distance_buffers_ + read_buffer_ * _distances_size : NULL;
 }
 
 /** Get echo data.
- * @return Float array with echo values
+ * @return Float array with echo values of the read buffer
  */
 const float *
 LaserAcquisitionThread::get_echo_data()
 {
-	_new_data = false;
-	return _echoes;
+	return echo_buffers_ ? echo_buffers_ + read_buffer_ * _echoes_size : NULL;
 }
 
 /** Get distance data size.
@@ -156,70 +197,100 @@ LaserAcquisitionThread::get_echo_data_size()
 	return _echoes_size;
 }
 
+/** Get scan duration.
+ * @return time in seconds for a full revolution of the scanner, zero if
+ * the acquisition thread does not provide it
+ */
+float
+LaserAcquisitionThread::get_scan_duration()
+{
+	return _scan_duration;
+}
+
+/** Get index of first measured beam.
+ * @return index of the beam that is measured first in a scan, the
+ * timestamp refers to this beam if the scan duration is known
+ */
+unsigned int
+LaserAcquisitionThread::get_scan_first_beam()
+{
+	return _scan_first_beam;
+}
+
 /** Get timestamp of data
- * @return most recent data time
+ * @return time of the data in the read buffer
  */
 const fawkes::Time *
 LaserAcquisitionThread::get_timestamp()
 {
-	return _timestamp;
+	return &timestamps_[read_buffer_];
+}
+
+/** Get latency trace of data.
+ * @return latency trace of the data in the read buffer, started when
+ * the data was published
+ */
+const fawkes::latency_trace_t &
+LaserAcquisitionThread::get_latency_trace()
+{
+	return latency_traces_[read_buffer_];
 }
 
 /** Allocate distances array.
  * Call this from a laser acqusition thread implementation to properly
- * initialize the distances array.
+ * initialize the distances array. This allocates all three buffers and must
+ * not be called while the sensor thread is reading.
  * @param num_distances number of distances to allocate the array for
  */
 void
 LaserAcquisitionThread::alloc_distances(unsigned int num_distances)
 {
-	if (_distances)
-		free(_distances);
+	free(distance_buffers_);
 
-	_distances_size = num_distances;
-	_distances      = (float *)malloc(sizeof(float) * _distances_size);
-	std::fill_n(_distances, _distances_size, std::numeric_limits<float>::quiet_NaN());
+	_distances_size   = num_distances;
+	distance_buffers_ = (float *)malloc(sizeof(float) * _distances_size * 3);
+	std::fill_n(distance_buffers_, _distances_size * 3, std::numeric_limits<float>::quiet_NaN());
+	set_write_buffer(write_buffer_);
 }
 
 /** Allocate echoes array.
  * Call this from a laser acqusition thread implementation to properly
- * initialize the echoes array.
+ * initialize the echoes array. This allocates all three buffers and must
+ * not be called while the sensor thread is reading.
  * @param num_echoes number of echoes to allocate the array for
  */
 void
 LaserAcquisitionThread::alloc_echoes(unsigned int num_echoes)
 {
-	if (_echoes)
-		free(_echoes);
+	free(echo_buffers_);
 
-	_echoes_size = num_echoes;
-	_echoes      = (float *)malloc(sizeof(float) * _echoes_size);
-	memset(_echoes, 0, sizeof(float) * _echoes_size);
+	_echoes_size  = num_echoes;
+	echo_buffers_ = (float *)malloc(sizeof(float) * _echoes_size * 3);
+	memset(echo_buffers_, 0, sizeof(float) * _echoes_size * 3);
+	set_write_buffer(write_buffer_);
 }
 
-/** Reset all distance values to NaN. */
+/** Reset all distance values of the write buffer to NaN.
+ * The values are published with the next call to publish_data().
+ */
 void
 LaserAcquisitionThread::reset_distances()
 {
 	_data_mutex->lock();
-	if (!_distances)
-		return;
-
-	for (size_t i = 0; i < _distances_size; ++i) {
-		_distances[i] = std::numeric_limits<float>::quiet_NaN();
+	if (_distances) {
+		std::fill_n(_distances, _distances_size, std::numeric_limits<float>::quiet_NaN());
 	}
-	_new_data = true;
 	_data_mutex->unlock();
 }
 
-/** Reset all distance values to NaN. */
+/** Reset all echo values of the write buffer to NaN.
+ * The values are published with the next call to publish_data().
+ */
 void
 LaserAcquisitionThread::reset_echoes()
 {
 	if (!_echoes)
 		return;
 
-	for (size_t i = 0; i < _echoes_size; ++i) {
-		_echoes[i] = std::numeric_limits<float>::quiet_NaN();
-	}
+	std::fill_n(_echoes, _echoes_size, std::numeric_limits<float>::quiet_NaN());
 }
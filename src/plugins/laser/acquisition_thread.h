@@ -27,12 +27,15 @@
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
 #include <core/threading/thread.h>
+#include <utils/time/latency_trace.h>
+#include <utils/time/time.h>
+
+#include <atomic>
 
 namespace fawkes {
 class Mutex;
 class Configuration;
 class Logger;
-class Time;
 } // namespace fawkes
 
 class LaserAcquisitionThread : public fawkes::Thread,
@@ -44,8 +47,7 @@ public:
 	LaserAcquisitionThread(const char *thread_name);
 	virtual ~LaserAcquisitionThread();
 
-	bool lock_if_new_data();
-	void unlock();
+	bool fetch_new_data();
 
 	virtual void pre_init(fawkes::Configuration *config, fawkes::Logger *logger) = 0;
 
@@ -53,9 +55,14 @@ public:
 	const float *       get_echo_data();
 	const fawkes::Time *get_timestamp();
 
+	const fawkes::latency_trace_t &get_latency_trace();
+
 	unsigned int get_distance_data_size();
 	unsigned int get_echo_data_size();
 
+	float        get_scan_duration();
+	unsigned int get_scan_first_beam();
+
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
 	virtual void
@@ -69,17 +76,38 @@ protected:
 	void alloc_echoes(unsigned int num_echoes);
 	void reset_distances();
 	void reset_echoes();
+	void publish_data();
 
 protected:
 	fawkes::Mutex *_data_mutex;
 	fawkes::Time * _timestamp;
 
-	bool   _new_data;
 	float *_distances;
 	float *_echoes;
 
 	unsigned int _distances_size;
 	unsigned int _echoes_size;
+
+	float        _scan_duration;
+	unsigned int _scan_first_beam;
+
+private:
+	void set_write_buffer(unsigned int buffer);
+
+private:
+	static const unsigned int NEW_DATA = 4;
+
+	// three buffers each: the one being written, the latest complete one,
+	// and the one being read; latest_ is the index of the latest complete
+	// buffer or'ed with NEW_DATA if it has not been fetched yet
+	float *                   distance_buffers_;
+	float *                   echo_buffers_;
+	fawkes::Time              timestamps_[3];
+	fawkes::latency_trace_t   latency_traces_[3];
+	uint32_t                  latency_source_;
+	unsigned int              write_buffer_;
+	unsigned int              read_buffer_;
+	std::atomic<unsigned int> latest_;
 };
 
 #endif
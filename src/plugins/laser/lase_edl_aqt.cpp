@@ -290,17 +290,13 @@ LaseEdlAcquisitionThread::init()
 		}
 	}
 
-	_distances = (float *)malloc(sizeof(float) * number_of_values_);
-	_echoes    = (float *)malloc(sizeof(float) * number_of_values_);
+	alloc_distances(number_of_values_);
+	alloc_echoes(number_of_values_);
 }
 
 void
 LaseEdlAcquisitionThread::finalize()
 {
-	free(_distances);
-	free(_echoes);
-	_distances = _echoes = NULL;
-
 	logger->log_debug("LaseEdlAcquisitionThread", "Resetting laser");
 	DO_RESET(RESETLEVEL_HALT_IDLE);
 }
@@ -661,15 +657,15 @@ LaseEdlAcquisitionThread::process_profiles()
 	register int   echo_index = dist_index;
 
 	_data_mutex->lock();
-	_new_data = true;
 	_timestamp->stamp();
 
 	// see which data is requested
 	if (cfg_profile_format_ == PROFILEFORMAT_DISTANCE) {
 		// only distances
 		for (int i = 3; i < response_size; ++i) {
-			dist                                       = ((float)real_response[i]) / DISTANCE_FACTOR;
-			_distances[number_of_values_ - dist_index] = dist;
+			dist = ((float)real_response[i]) / DISTANCE_FACTOR;
+			// keep the index in range when the index counter is zero
+			_distances[(number_of_values_ - dist_index) % number_of_values_] = dist;
 			if (++dist_index >= (int)number_of_values_)
 				dist_index = 0;
 		}
@@ -677,13 +673,15 @@ LaseEdlAcquisitionThread::process_profiles()
 	} else if (cfg_profile_format_ == (PROFILEFORMAT_DISTANCE | PROFILEFORMAT_ECHO_AMPLITUDE)) {
 		// distances + echos
 		for (int i = 3; i < response_size; ++i) {
-			dist                                       = ((float)real_response[i]) / DISTANCE_FACTOR;
-			_distances[number_of_values_ - dist_index] = dist;
+			dist = ((float)real_response[i]) / DISTANCE_FACTOR;
+			// keep the index in range when the index counter is zero
+			_distances[(number_of_values_ - dist_index) % number_of_values_] = dist;
 			if (++dist_index >= (int)number_of_values_)
 				dist_index = 0;
 			++i;
-			echo                                    = real_response[i];
-			_echoes[number_of_values_ - echo_index] = echo;
+			echo = real_response[i];
+			// keep the index in range when the index counter is zero
+			_echoes[(number_of_values_ - echo_index) % number_of_values_] = echo;
 			if (++echo_index >= (int)number_of_values_)
 				echo_index = 0;
 		}
@@ -691,13 +689,15 @@ LaseEdlAcquisitionThread::process_profiles()
 	} else if (cfg_profile_format_ == PROFILEFORMAT_ECHO_AMPLITUDE) {
 		// only echos
 		for (int i = 3; i < response_size; ++i) {
-			echo                                    = real_response[i];
-			_echoes[number_of_values_ - echo_index] = echo;
+			echo = real_response[i];
+			// keep the index in range when the index counter is zero
+			_echoes[(number_of_values_ - echo_index) % number_of_values_] = echo;
 			if (++echo_index >= (int)number_of_values_)
 				echo_index = 0;
 		}
 	}
 
+	publish_data();
 	_data_mutex->unlock();
 
 	free(real_response);
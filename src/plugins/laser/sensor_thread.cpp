@@ -27,6 +27,13 @@
 #include <interfaces/Laser1080Interface.h>
 #include <interfaces/Laser360Interface.h>
 #include <interfaces/Laser720Interface.h>
+#include <interfaces/LaserScanInterface.h>
+
+#include <utils/time/latency_trace.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace fawkes;
 
@@ -57,9 +64,10 @@ LaserSensorThread::LaserSensorThread(std::string &           cfg_name,
 void
 LaserSensorThread::init()
 {
-	laser360_if_  = NULL;
-	laser720_if_  = NULL;
-	laser1080_if_ = NULL;
+	laser360_if_   = NULL;
+	laser720_if_   = NULL;
+	laser1080_if_  = NULL;
+	laser_scan_if_ = NULL;
 
 	bool main_sensor = false;
 
@@ -74,6 +82,26 @@ LaserSensorThread::init()
 
 	num_values_ = aqt_->get_distance_data_size();
 
+#ifdef HAVE_TF
+	cfg_deskew_       = false;
+	cfg_deskew_frame_ = "odom";
+	deskew_failed_    = false;
+	try {
+		cfg_deskew_ = config->get_bool((cfg_prefix_ + "deskew").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+	try {
+		cfg_deskew_frame_ = config->get_string((cfg_prefix_ + "deskew_frame").c_str());
+	} catch (Exception &e) {
+	} // ignored, use default
+
+	if (cfg_deskew_) {
+		beam_times_.resize(num_values_);
+		beam_transforms_.resize(num_values_);
+		deskewed_.resize(num_values_);
+	}
+#endif
+
 	std::string if_id = main_sensor ? "Laser" : ("Laser " + cfg_name_);
 
 	if (num_values_ == 360) {
@@ -91,9 +119,19 @@ LaserSensorThread::init()
 		laser1080_if_->set_auto_timestamping(false);
 		laser1080_if_->set_frame(cfg_frame_.c_str());
 		laser1080_if_->write();
+	} else if (num_values_ > 0 && num_values_ <= LaserScanInterface::MAX_BEAMS) {
+		// no fixed-size interface matches, publish the scan as is
+		laser_scan_if_ = blackboard->open_for_writing<LaserScanInterface>(if_id.c_str());
+		laser_scan_if_->set_auto_timestamping(false);
+		laser_scan_if_->set_frame(cfg_frame_.c_str());
+		laser_scan_if_->set_angle_min(0.);
+		laser_scan_if_->set_angle_increment(2 * M_PI / num_values_);
+		laser_scan_if_->set_num_beams(num_values_);
+		laser_scan_if_->write();
 	} else {
-		throw Exception("Laser acquisition thread must produce either 360, 720, or 1080 "
+		throw Exception("Laser acquisition thread must produce between 1 and %u "
 		                "distance values, but it produces %u",
+		                LaserScanInterface::MAX_BEAMS,
 		                aqt_->get_distance_data_size());
 	}
 }
@@ -104,25 +142,110 @@ LaserSensorThread::finalize()
 	blackboard->close(laser360_if_);
 	blackboard->close(laser720_if_);
 	blackboard->close(laser1080_if_);
+	blackboard->close(laser_scan_if_);
 }
 
 void
 LaserSensorThread::loop()
 {
-	if (aqt_->lock_if_new_data()) {
+	if (aqt_->fetch_new_data()) {
+		LatencyTrace::adopt(aqt_->get_latency_trace());
+		const float *distances     = aqt_->get_distance_data();
+		float        scan_duration = aqt_->get_scan_duration();
+
+#ifdef HAVE_TF
+		if (cfg_deskew_ && scan_duration > 0.
+		    && deskew(distances, aqt_->get_timestamp(), scan_duration)) {
+			distances     = &deskewed_[0];
+			scan_duration = 0.;
+		}
+#endif
+
 		if (num_values_ == 360) {
 			laser360_if_->set_timestamp(aqt_->get_timestamp());
-			laser360_if_->set_distances(aqt_->get_distance_data());
+			laser360_if_->set_distances(distances);
 			laser360_if_->write();
 		} else if (num_values_ == 720) {
 			laser720_if_->set_timestamp(aqt_->get_timestamp());
-			laser720_if_->set_distances(aqt_->get_distance_data());
+			laser720_if_->set_distances(distances);
 			laser720_if_->write();
 		} else if (num_values_ == 1080) {
 			laser1080_if_->set_timestamp(aqt_->get_timestamp());
-			laser1080_if_->set_distances(aqt_->get_distance_data());
+			laser1080_if_->set_distances(distances);
 			laser1080_if_->write();
+		} else if (laser_scan_if_) {
+			laser_scan_if_->set_timestamp(aqt_->get_timestamp());
+			laser_scan_if_->set_scan_duration(scan_duration);
+			laser_scan_if_->set_first_beam(aqt_->get_scan_first_beam());
+			std::copy(distances, distances + num_values_, laser_scan_if_->distances());
+			laser_scan_if_->write();
 		}
-		aqt_->unlock();
 	}
 }
+
+#ifdef HAVE_TF
+/** Compensate the motion of the laser during a scan.
+ * Each beam is transformed into the deskew frame with the laser pose at the
+ * time the beam was measured, and then back into the laser frame with the
+ * pose at the time of the first beam. The points are binned into the beam
+ * they now fall into, keeping the closest one. Beams without a valid
+ * reading or without a point after compensation are NaN.
+ * @param distances distances as measured by the acquisition thread
+ * @param start time the first beam of the scan was measured
+ * @param duration time in seconds for a full revolution of the scanner
+ * @return true if the scan has been written to deskewed_, false if the
+ * transforms for the scan are not available
+ */
+bool
+LaserSensorThread::deskew(const float *distances, const fawkes::Time *start, float duration)
+{
+	const unsigned int first_beam = aqt_->get_scan_first_beam() % num_values_;
+	const float        angle_inc  = 2 * M_PI / num_values_;
+	const double       time_inc   = (double)duration / num_values_;
+
+	for (unsigned int i = 0; i < num_values_; ++i) {
+		unsigned int seq = (i + num_values_ - first_beam) % num_values_;
+		beam_times_[i]   = *start + seq * time_inc;
+	}
+
+	try {
+		tf_listener->lookup_transforms(cfg_deskew_frame_, cfg_frame_, beam_times_, beam_transforms_);
+	} catch (Exception &e) {
+		if (!deskew_failed_) {
+			logger->log_warn(name(),
+			                 "Cannot deskew scan, publishing raw data: %s",
+			                 e.what_no_backtrace());
+			deskew_failed_ = true;
+		}
+		return false;
+	}
+	if (deskew_failed_) {
+		logger->log_info(name(), "Transforms available, deskewing scans again");
+		deskew_failed_ = false;
+	}
+
+	const tf::Transform ref_inv = beam_transforms_[first_beam].inverse();
+
+	std::fill(deskewed_.begin(), deskewed_.end(), std::numeric_limits<float>::quiet_NaN());
+	for (unsigned int i = 0; i < num_values_; ++i) {
+		const float d = distances[i];
+		if (!std::isfinite(d) || d <= 0.)
+			continue;
+
+		const float     a = i * angle_inc;
+		const tf::Point p =
+		  (ref_inv * beam_transforms_[i]) * tf::Point(d * cosf(a), d * sinf(a), 0.);
+
+		float angle = atan2f(p.y(), p.x());
+		if (angle < 0.)
+			angle += 2 * M_PI;
+		const unsigned int b    = (unsigned int)lroundf(angle / angle_inc) % num_values_;
+		const float        dist = sqrtf(p.x() * p.x() + p.y() * p.y());
+		if (!(deskewed_[b] <= dist)) {
+			deskewed_[b] = dist;
+		}
+	}
+
+	return true;
+}
+#endif
@@ -28,13 +28,19 @@
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
 #include <core/threading/thread.h>
+#ifdef HAVE_TF
+#	include <aspect/tf.h>
+#	include <utils/time/time.h>
+#endif
 
 #include <string>
+#include <vector>
 
 namespace fawkes {
 class Laser360Interface;
 class Laser720Interface;
 class Laser1080Interface;
+class LaserScanInterface;
 } // namespace fawkes
 
 class LaserAcquisitionThread;
@@ -43,6 +49,9 @@ class LaserSensorThread : public fawkes::Thread,
                           public fawkes::BlockedTimingAspect,
                           public fawkes::LoggingAspect,
                           public fawkes::ConfigurableAspect,
+#ifdef HAVE_TF
+                          public fawkes::TransformAspect,
+#endif
                           public fawkes::BlackBoardAspect
 {
 public:
@@ -60,10 +69,16 @@ protected:
 		Thread::run();
 	}
 
+private:
+#ifdef HAVE_TF
+	bool deskew(const float *distances, const fawkes::Time *start, float duration);
+#endif
+
 private:
 	fawkes::Laser360Interface * laser360_if_;
 	fawkes::Laser720Interface * laser720_if_;
 	fawkes::Laser1080Interface *laser1080_if_;
+	fawkes::LaserScanInterface *laser_scan_if_;
 
 	LaserAcquisitionThread *aqt_;
 
@@ -72,6 +87,16 @@ private:
 	std::string cfg_name_;
 	std::string cfg_frame_;
 	std::string cfg_prefix_;
+
+#ifdef HAVE_TF
+	bool        cfg_deskew_;
+	std::string cfg_deskew_frame_;
+	bool        deskew_failed_;
+
+	std::vector<fawkes::Time>                 beam_times_;
+	std::vector<fawkes::tf::StampedTransform> beam_transforms_;
+	std::vector<float>                        deskewed_;
+#endif
 };
 
 #endif
@@ -354,13 +354,16 @@ SickTiM55xCommonAcquisitionThread::parse_datagram(const unsigned char *datagram,
 		}
 	}
 
-	_new_data = true;
-
 	float time_increment = scan_time * angle_increment / (2.0 * M_PI);
 
 	*_timestamp -= (double)number_of_data * time_increment;
 	*_timestamp += cfg_time_offset_;
 
+	_scan_duration   = scan_time;
+	_scan_first_beam = (_distances_size + start_idx) % _distances_size;
+
+	publish_data();
+
 	_data_mutex->unlock();
 
 	// 26 + n: RSSI data included
@@ -87,12 +87,6 @@ SickTiM55xEthernetAcquisitionThread::init()
 void
 SickTiM55xEthernetAcquisitionThread::finalize()
 {
-	free(_distances);
-	_distances = NULL;
-
-	free(_echoes);
-	_echoes = NULL;
-
 	delete socket_mutex_;
 }
 
@@ -134,7 +128,7 @@ SickTiM55xEthernetAcquisitionThread::loop()
 				}
 				_data_mutex->lock();
 				_timestamp->stamp();
-				_new_data = true;
+				publish_data();
 				_data_mutex->unlock();
 				close_device();
 
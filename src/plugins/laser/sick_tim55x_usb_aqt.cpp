@@ -117,12 +117,6 @@ SickTiM55xUSBAcquisitionThread::finalize()
 	}
 	libusb_exit(usb_ctx_);
 
-	free(_distances);
-	_distances = NULL;
-
-	free(_echoes);
-	_echoes = NULL;
-
 	delete usb_mutex_;
 }
 
@@ -155,6 +149,10 @@ SickTiM55xUSBAcquisitionThread::loop()
 			}
 			reset_distances();
 			reset_echoes();
+			_data_mutex->lock();
+			_timestamp->stamp();
+			publish_data();
+			_data_mutex->unlock();
 			return;
 		} else {
 			recv_buf[actual_length] = 0;
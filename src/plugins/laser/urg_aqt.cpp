@@ -284,6 +284,11 @@ HokuyoUrgAcquisitionThread::init()
 	} catch (Exception &e) {
 	} // ignored, use default
 
+	// rays are measured from first_ray_ on, beam a is at front_ray_ + a steps
+	int first_beam   = (int)roundf(((int)first_ray_ - (int)front_ray_) * angle_per_step_);
+	_scan_duration   = scan_msec_ / 1000.;
+	_scan_first_beam = ((first_beam % 360) + 360) % 360;
+
 	// that should be 1000 really to convert msec -> usec. But empirically
 	// the results are slightly better with 990 as factor.
 	timer_ = new TimeWait(clock, scan_msec_ * 990);
@@ -296,8 +301,6 @@ HokuyoUrgAcquisitionThread::init()
 void
 HokuyoUrgAcquisitionThread::finalize()
 {
-	free(_distances);
-	_distances = NULL;
 	delete timer_;
 
 	ctrl_->stop();
@@ -320,7 +323,6 @@ HokuyoUrgAcquisitionThread::loop()
 		//logger->log_debug(name(), "Captured %i values", num_values);
 		_data_mutex->lock();
 
-		_new_data = true;
 		_timestamp->stamp();
 		*_timestamp += cfg_time_offset_;
 		for (unsigned int a = 0; a < 360; ++a) {
@@ -386,6 +388,7 @@ HokuyoUrgAcquisitionThread::loop()
 				}
 			}
 		}
+		publish_data();
 		_data_mutex->unlock();
 		//} else {
 		//logger->log_warn(name(), "No new scan available, ignoring");
@@ -167,9 +167,6 @@ HokuyoUrgGbxAcquisitionThread::init()
 void
 HokuyoUrgGbxAcquisitionThread::finalize()
 {
-	free(_distances);
-	_distances = NULL;
-
 	logger->log_debug(name(), "Stopping laser");
 #ifdef HAVE_URG_GBX_9_11
 	laser_->SetPower(false);
@@ -217,7 +214,6 @@ HokuyoUrgGbxAcquisitionThread::loop()
 
 	_data_mutex->lock();
 
-	_new_data = true;
 	_timestamp->stamp();
 	for (unsigned int a = 0; a < 360; ++a) {
 		unsigned int frontrel_idx = front_idx_ + roundf(a * step_per_angle_);
@@ -227,5 +223,6 @@ HokuyoUrgGbxAcquisitionThread::loop()
 			_distances[a] = ranges[idx] / 1000.f;
 		}
 	}
+	publish_data();
 	_data_mutex->unlock();
 }
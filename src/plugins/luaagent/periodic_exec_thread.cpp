@@ -25,6 +25,7 @@
 #include <core/exceptions/software.h>
 #include <core/exceptions/system.h>
 #include <core/threading/mutex.h>
+#include <interfaces/LuaGCInterface.h>
 #include <interfaces/SkillerDebugInterface.h>
 #include <interfaces/SkillerInterface.h>
 #include <logging/component.h>
@@ -74,6 +75,8 @@ LuaAgentPeriodicExecutionThread::init_failure_cleanup()
 		}
 		if (agdbg_if_)
 			blackboard->close(agdbg_if_);
+		if (gc_if_)
+			blackboard->close(gc_if_);
 
 		delete lua_ifi_;
 
@@ -98,6 +101,12 @@ LuaAgentPeriodicExecutionThread::init()
 		throw;
 	}
 
+	std::string cfg_gc_mode = config->get_string_or_default("/luaagent/lua-gc/mode", "incremental");
+
+	unsigned int cfg_gc_pause   = config->get_uint_or_default("/luaagent/lua-gc/pause", 0);
+	unsigned int cfg_gc_stepmul = config->get_uint_or_default("/luaagent/lua-gc/stepmul", 0);
+	cfg_gc_step_kb_             = config->get_uint_or_default("/luaagent/lua-gc/step-kb", 0);
+
 	logger->log_debug("LuaAgentPeriodicExecutionThread", "Agent: %s", cfg_agent_.c_str());
 
 	clog_ = new ComponentLogger(logger, "LuaAgentLua");
@@ -106,6 +115,7 @@ LuaAgentPeriodicExecutionThread::init()
 	lua_ifi_    = NULL;
 	skiller_if_ = NULL;
 	agdbg_if_   = NULL;
+	gc_if_      = NULL;
 
 	std::string reading_prefix = "/luaagent/interfaces/" + cfg_agent_ + "/reading/";
 	std::string writing_prefix = "/luaagent/interfaces/" + cfg_agent_ + "/writing/";
@@ -121,7 +131,13 @@ LuaAgentPeriodicExecutionThread::init()
 	agdbg_if_ = blackboard->open_for_writing<SkillerDebugInterface>("LuaAgent");
 
 	try {
+		gc_if_ = blackboard->open_for_writing<LuaGCInterface>("LuaAgent Lua GC");
+
 		lua_ = new LuaContext();
+		lua_->set_gc_mode((cfg_gc_mode == "generational") ? LuaContext::GC_GENERATIONAL
+		                                                  : LuaContext::GC_INCREMENTAL,
+		                  cfg_gc_pause,
+		                  cfg_gc_stepmul);
 		if (cfg_watch_files_) {
 			lua_->setup_fam(/* auto restart */ true, /* conc thread */ false);
 		}
@@ -173,6 +189,7 @@ LuaAgentPeriodicExecutionThread::finalize()
 
 	blackboard->close(skiller_if_);
 	blackboard->close(agdbg_if_);
+	blackboard->close(gc_if_);
 
 	delete lua_ifi_;
 	delete lua_;
@@ -239,4 +256,17 @@ LuaAgentPeriodicExecutionThread::loop()
 	}
 
 	lua_ifi_->write();
+
+	if (cfg_gc_step_kb_ > 0) {
+		lua_->gc_step(cfg_gc_step_kb_);
+
+		LuaContext::GCStats stats = lua_->gc_stats();
+		gc_if_->set_memory_kb(stats.memory_kb);
+		gc_if_->set_steps(stats.steps);
+		gc_if_->set_cycles(stats.cycles);
+		gc_if_->set_last_step_ms(stats.last_step_ms);
+		gc_if_->set_max_step_ms(stats.max_step_ms);
+		gc_if_->set_total_step_ms(stats.total_step_ms);
+		gc_if_->write();
+	}
 }
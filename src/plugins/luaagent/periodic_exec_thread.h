@@ -46,6 +46,7 @@ class LuaInterfaceImporter;
 class Interface;
 class SkillerInterface;
 class SkillerDebugInterface;
+class LuaGCInterface;
 } // namespace fawkes
 
 class LuaAgentPeriodicExecutionThread : public fawkes::Thread,
@@ -82,11 +83,13 @@ private: /* members */
 	fawkes::ComponentLogger *clog_;
 
 	// config values
-	std::string cfg_agent_;
-	bool        cfg_watch_files_;
+	std::string  cfg_agent_;
+	bool         cfg_watch_files_;
+	unsigned int cfg_gc_step_kb_;
 
 	fawkes::SkillerInterface *     skiller_if_;
 	fawkes::SkillerDebugInterface *agdbg_if_;
+	fawkes::LuaGCInterface *       gc_if_;
 
 	fawkes::LuaContext *          lua_;
 	fawkes::LuaInterfaceImporter *lua_ifi_;
@@ -25,11 +25,30 @@ namespace fawkes {
 
 /** @class MetricsAspect <plugins/metrics/aspect/metrics_supplier.h>
  * Thread aspect to provide metrics.
+ * A thread can either supply metric families through a MetricsSupplier,
+ * or register metrics with the metrics_registry and update them directly,
+ * or both.
 
  * @ingroup Aspects
  * @author Tim Niemueller
  */
 
+/** @var fawkes::MetricsRegistry *  MetricsAspect::metrics_registry
+ * Registry to create metrics which are updated directly. The metric
+ * objects can be updated from hot paths without locking. The registry
+ * is set when the thread is initialized.
+ */
+
+/** Constructor.
+ * Use this constructor if the thread only uses the metrics_registry.
+ */
+MetricsAspect::MetricsAspect()
+{
+	add_aspect("MetricsAspect");
+	metrics_supplier_ = nullptr;
+	metrics_registry  = nullptr;
+}
+
 /** Constructor.
  * @param metrics_supplier metrics supplier
  */
@@ -37,6 +56,7 @@ MetricsAspect::MetricsAspect(MetricsSupplier *metrics_supplier)
 {
 	add_aspect("MetricsAspect");
 	metrics_supplier_ = metrics_supplier;
+	metrics_registry  = nullptr;
 }
 
 /** Virtual empty destructor. */
@@ -44,8 +64,19 @@ MetricsAspect::~MetricsAspect()
 {
 }
 
+/** Init metrics aspect.
+ * It is guaranteed that this is called for a thread with the aspect
+ * before start is called (when running regularly inside Fawkes).
+ * @param registry metrics registry to use
+ */
+void
+MetricsAspect::init_MetricsAspect(MetricsRegistry *registry)
+{
+	metrics_registry = registry;
+}
+
 /** Get metrics supplier of this thread.
- * @return metrics supplier
+ * @return metrics supplier, NULL if the thread does not have one
  */
 MetricsSupplier *
 MetricsAspect::get_metrics_supplier() const
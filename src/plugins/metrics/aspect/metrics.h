@@ -29,6 +29,7 @@
 namespace fawkes {
 
 class MetricsAspectIniFin;
+class MetricsRegistry;
 class MetricsSupplier;
 
 class MetricsAspect : public virtual Aspect
@@ -36,9 +37,15 @@ class MetricsAspect : public virtual Aspect
 	friend MetricsAspectIniFin;
 
 public:
+	MetricsAspect();
 	MetricsAspect(MetricsSupplier *metrics_supplier) __attribute__((nonnull));
 	virtual ~MetricsAspect();
 
+	void init_MetricsAspect(MetricsRegistry *registry);
+
+protected:
+	MetricsRegistry *metrics_registry;
+
 private:
 	MetricsSupplier *get_metrics_supplier() const;
 
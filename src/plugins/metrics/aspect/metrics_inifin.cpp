@@ -55,7 +55,10 @@ MetricsAspectIniFin::init(Thread *thread)
 		                                      thread->name());
 	}
 
-	metrics_mgr_->add_supplier(metrics_thread->get_metrics_supplier());
+	metrics_thread->init_MetricsAspect(metrics_mgr_->registry());
+	if (metrics_thread->get_metrics_supplier()) {
+		metrics_mgr_->add_supplier(metrics_thread->get_metrics_supplier());
+	}
 }
 
 void
@@ -70,7 +73,9 @@ MetricsAspectIniFin::finalize(Thread *thread)
 		                                    thread->name());
 	}
 
-	metrics_mgr_->remove_supplier(metrics_thread->get_metrics_supplier());
+	if (metrics_thread->get_metrics_supplier()) {
+		metrics_mgr_->remove_supplier(metrics_thread->get_metrics_supplier());
+	}
 }
 
 /** Set Metrics environment manger.
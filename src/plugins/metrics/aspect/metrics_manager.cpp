@@ -43,6 +43,11 @@ namespace fawkes {
  * @fn const std::LockList<MetricsSupplier *> &  MetricsManager::metrics_suppliers() const
  * Get list of current metrics suppliers.
  * @return list of metrics suppliers
+ *
+ * @fn MetricsRegistry *  MetricsManager::registry()
+ * Get registry of directly updated metrics.
+ * The metrics of the registry are not included in all_metrics().
+ * @return metrics registry
 
 
  * @author Tim Niemueller
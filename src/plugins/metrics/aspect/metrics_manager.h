@@ -23,6 +23,7 @@
 #define _PLUGINS_METRICS_ASPECT_METRICS_MANAGER_H_
 
 #include <core/utils/lock_list.h>
+#include <plugins/metrics/aspect/metrics_registry.h>
 #include <plugins/metrics/aspect/metrics_supplier.h>
 #include <plugins/metrics/protobuf/metrics.pb.h>
 
@@ -39,6 +40,8 @@ public:
 	virtual void remove_supplier(MetricsSupplier *supplier) = 0;
 
 	virtual const fawkes::LockList<MetricsSupplier *> &metrics_suppliers() const = 0;
+
+	virtual MetricsRegistry *registry() = 0;
 };
 
 } // end namespace fawkes
@@ -0,0 +1,377 @@
+
+/***************************************************************************
+ *  metrics_registry.cpp - Registry of directly updated metrics
+ *
+ *  Created: Thu Oct 15 07:17:15 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <plugins/metrics/aspect/metrics_registry.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+static void
+atomic_add(std::atomic<double> &a, double v)
+{
+	double old = a.load(std::memory_order_relaxed);
+	while (!a.compare_exchange_weak(old, old + v, std::memory_order_relaxed)) {
+	}
+}
+
+static std::string
+format_value(double v)
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%f", v);
+	return buf;
+}
+
+static std::string
+format_labels(const MetricsRegistry::Labels &labels,
+              const char *                   extra_name  = NULL,
+              const std::string &            extra_value = "")
+{
+	if (labels.empty() && !extra_name)
+		return "";
+
+	std::string rv = "{";
+	for (const auto &l : labels) {
+		if (rv.size() > 1)
+			rv += ",";
+		rv += l.first + "=\"";
+		for (char c : l.second) {
+			switch (c) {
+			case '\\': rv += "\\\\"; break;
+			case '"': rv += "\\\""; break;
+			case '\n': rv += "\\n"; break;
+			default: rv += c; break;
+			}
+		}
+		rv += "\"";
+	}
+	if (extra_name) {
+		if (rv.size() > 1)
+			rv += ",";
+		rv += std::string(extra_name) + "=\"" + extra_value + "\"";
+	}
+	rv += "}";
+	return rv;
+}
+/// @endcond
+
+/** @class MetricsCounter <plugins/metrics/aspect/metrics_registry.h>
+ * Counter metric which can be updated without locking.
+ * Counters are created through the MetricsRegistry and may be
+ * incremented concurrently from any thread.
+ * @author agent
+ */
+
+/** @class MetricsGauge <plugins/metrics/aspect/metrics_registry.h>
+ * Gauge metric which can be updated without locking.
+ * Gauges are created through the MetricsRegistry and may be
+ * updated concurrently from any thread.
+ * @author agent
+ */
+
+/** Increment gauge.
+ * @param v value to add
+ */
+void
+MetricsGauge::inc(double v)
+{
+	atomic_add(value_, v);
+}
+
+/** @class MetricsHistogram <plugins/metrics/aspect/metrics_registry.h>
+ * Histogram metric which can be updated without locking.
+ * The bucket upper bounds are fixed on creation through the
+ * MetricsRegistry. Observations only increment atomic counters, the
+ * cumulative bucket counts are computed when the metrics are scraped.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param bounds sorted bucket upper bounds
+ */
+MetricsHistogram::MetricsHistogram(const std::vector<double> &bounds)
+: bounds_(bounds), buckets_(bounds.size() + 1), sum_(0.)
+{
+}
+
+/** Add observation.
+ * @param v observed value
+ */
+void
+MetricsHistogram::observe(double v)
+{
+	size_t b = std::lower_bound(bounds_.begin(), bounds_.end(), v) - bounds_.begin();
+	buckets_[b].fetch_add(1, std::memory_order_relaxed);
+	atomic_add(sum_, v);
+}
+
+/** Get number of observations.
+ * @return number of observations
+ */
+uint64_t
+MetricsHistogram::count() const
+{
+	uint64_t count = 0;
+	for (const auto &b : buckets_) {
+		count += b.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+/** @class MetricsRegistry <plugins/metrics/aspect/metrics_registry.h>
+ * Registry of metrics updated directly from C++ code.
+ * Metrics are registered once, e.g. during thread initialization, and
+ * the returned object is then updated directly on the hot path using
+ * atomic operations only. No blackboard interface is involved. When
+ * metrics are scraped the current values are read from the atomics,
+ * label strings are prepared on registration and cached.
+ *
+ * Registering a metric with the same name and labels again returns the
+ * existing object. The objects are owned by the registry and remain
+ * valid for as long as the registry exists.
+ * @author agent
+ */
+
+/** Constructor. */
+MetricsRegistry::MetricsRegistry()
+{
+	mutex_ = new Mutex();
+}
+
+/** Destructor. */
+MetricsRegistry::~MetricsRegistry()
+{
+	delete mutex_;
+}
+
+/** Get or create a series of a metric family.
+ * @param name name of the metric family
+ * @param help help string of the metric family
+ * @param type type of the metric family
+ * @param bounds bucket upper bounds for histograms
+ * @param labels labels of the series
+ * @return series, the metric object of which is set according to @p type
+ */
+MetricsRegistry::Series *
+MetricsRegistry::get_series(const std::string &        name,
+                            const std::string &        help,
+                            MetricType                 type,
+                            const std::vector<double> &bounds,
+                            const Labels &             labels)
+{
+	MutexLocker lock(mutex_);
+
+	auto f = families_.find(name);
+	if (f == families_.end()) {
+		Family family;
+		family.help   = help;
+		family.type   = type;
+		family.bounds = bounds;
+		std::sort(family.bounds.begin(), family.bounds.end());
+		f = families_.insert(std::make_pair(name, std::move(family))).first;
+	} else if (f->second.type != type) {
+		throw Exception("Metric %s already registered with different type", name.c_str());
+	}
+
+	Family &family = f->second;
+	for (Series &s : family.series) {
+		if (s.labels == labels)
+			return &s;
+	}
+
+	family.series.emplace_back();
+	Series &s   = family.series.back();
+	s.labels    = labels;
+	s.label_str = format_labels(labels);
+	switch (type) {
+	case TYPE_COUNTER: s.counter.reset(new MetricsCounter()); break;
+	case TYPE_GAUGE: s.gauge.reset(new MetricsGauge()); break;
+	case TYPE_HISTOGRAM:
+		s.histogram.reset(new MetricsHistogram(family.bounds));
+		for (double b : family.bounds) {
+			s.bucket_label_strs.push_back(format_labels(labels, "le", format_value(b)));
+		}
+		s.bucket_label_strs.push_back(format_labels(labels, "le", "+Inf"));
+		break;
+	}
+	return &s;
+}
+
+/** Get counter.
+ * @param name name of the metric family
+ * @param help help string of the metric family
+ * @param labels labels of the counter
+ * @return counter, owned by the registry
+ */
+MetricsCounter *
+MetricsRegistry::counter(const std::string &name, const std::string &help, const Labels &labels)
+{
+	return get_series(name, help, TYPE_COUNTER, {}, labels)->counter.get();
+}
+
+/** Get gauge.
+ * @param name name of the metric family
+ * @param help help string of the metric family
+ * @param labels labels of the gauge
+ * @return gauge, owned by the registry
+ */
+MetricsGauge *
+MetricsRegistry::gauge(const std::string &name, const std::string &help, const Labels &labels)
+{
+	return get_series(name, help, TYPE_GAUGE, {}, labels)->gauge.get();
+}
+
+/** Get histogram.
+ * @param name name of the metric family
+ * @param help help string of the metric family
+ * @param bounds bucket upper bounds, only used when the family is created,
+ * all histograms of a family share the bounds
+ * @param labels labels of the histogram
+ * @return histogram, owned by the registry
+ */
+MetricsHistogram *
+MetricsRegistry::histogram(const std::string &        name,
+                           const std::string &        help,
+                           const std::vector<double> &bounds,
+                           const Labels &             labels)
+{
+	return get_series(name, help, TYPE_HISTOGRAM, bounds, labels)->histogram.get();
+}
+
+/** Get current values as metric families.
+ * @return list of metric families
+ */
+std::list<io::prometheus::client::MetricFamily>
+MetricsRegistry::metrics()
+{
+	std::list<io::prometheus::client::MetricFamily> rv;
+
+	MutexLocker lock(mutex_);
+	for (const auto &f : families_) {
+		const Family &family = f.second;
+
+		io::prometheus::client::MetricFamily mf;
+		mf.set_name(f.first);
+		mf.set_help(family.help);
+		switch (family.type) {
+		case TYPE_COUNTER: mf.set_type(io::prometheus::client::COUNTER); break;
+		case TYPE_GAUGE: mf.set_type(io::prometheus::client::GAUGE); break;
+		case TYPE_HISTOGRAM: mf.set_type(io::prometheus::client::HISTOGRAM); break;
+		}
+
+		for (const Series &s : family.series) {
+			io::prometheus::client::Metric *m = mf.add_metric();
+			for (const auto &l : s.labels) {
+				io::prometheus::client::LabelPair *lp = m->add_label();
+				lp->set_name(l.first);
+				lp->set_value(l.second);
+			}
+			switch (family.type) {
+			case TYPE_COUNTER: m->mutable_counter()->set_value(s.counter->value()); break;
+			case TYPE_GAUGE: m->mutable_gauge()->set_value(s.gauge->value()); break;
+			case TYPE_HISTOGRAM: {
+				io::prometheus::client::Histogram *h = m->mutable_histogram();
+				uint64_t                           cumulative_count = 0;
+				for (size_t b = 0; b < family.bounds.size(); ++b) {
+					cumulative_count += s.histogram->buckets_[b].load(std::memory_order_relaxed);
+					io::prometheus::client::Bucket *bucket = h->add_bucket();
+					bucket->set_upper_bound(family.bounds[b]);
+					bucket->set_cumulative_count(cumulative_count);
+				}
+				cumulative_count += s.histogram->buckets_.back().load(std::memory_order_relaxed);
+				h->set_sample_count(cumulative_count);
+				h->set_sample_sum(s.histogram->sum());
+			} break;
+			}
+		}
+		rv.push_back(std::move(mf));
+	}
+
+	return rv;
+}
+
+/** Append current values in the Prometheus text format.
+ * This serializes the atomic values directly using the cached label
+ * strings without creating intermediate metric family messages.
+ * @param out string to append to
+ */
+void
+MetricsRegistry::append_text(std::string &out)
+{
+	char buf[64];
+
+	MutexLocker lock(mutex_);
+	for (const auto &f : families_) {
+		const std::string &name   = f.first;
+		const Family &     family = f.second;
+		if (family.series.empty())
+			continue;
+
+		const char *typestr = NULL;
+		switch (family.type) {
+		case TYPE_COUNTER: typestr = "counter"; break;
+		case TYPE_GAUGE: typestr = "gauge"; break;
+		case TYPE_HISTOGRAM: typestr = "histogram"; break;
+		}
+		out += "\n# HELP " + name + " " + family.help + "\n";
+		out += "# TYPE " + name + " " + typestr + "\n";
+
+		for (const Series &s : family.series) {
+			switch (family.type) {
+			case TYPE_COUNTER:
+				snprintf(buf, sizeof(buf), " %" PRIu64 "\n", s.counter->value());
+				out += name + s.label_str + buf;
+				break;
+			case TYPE_GAUGE:
+				snprintf(buf, sizeof(buf), " %f\n", s.gauge->value());
+				out += name + s.label_str + buf;
+				break;
+			case TYPE_HISTOGRAM: {
+				// derive count from buckets so that the counts are consistent
+				uint64_t cumulative_count = 0;
+				for (size_t b = 0; b < family.bounds.size(); ++b) {
+					cumulative_count += s.histogram->buckets_[b].load(std::memory_order_relaxed);
+					snprintf(buf, sizeof(buf), " %" PRIu64 "\n", cumulative_count);
+					out += name + "_bucket" + s.bucket_label_strs[b] + buf;
+				}
+				cumulative_count += s.histogram->buckets_.back().load(std::memory_order_relaxed);
+				snprintf(buf, sizeof(buf), " %" PRIu64 "\n", cumulative_count);
+				out += name + "_bucket" + s.bucket_label_strs.back() + buf;
+				snprintf(buf, sizeof(buf), " %f\n", s.histogram->sum());
+				out += name + "_sum" + s.label_str + buf;
+				snprintf(buf, sizeof(buf), " %" PRIu64 "\n", cumulative_count);
+				out += name + "_count" + s.label_str + buf;
+			} break;
+			}
+		}
+	}
+}
+
+} // end namespace fawkes
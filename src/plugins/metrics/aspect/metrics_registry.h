@@ -0,0 +1,193 @@
+
+/***************************************************************************
+ *  metrics_registry.h - Registry of directly updated metrics
+ *
+ *  Created: Thu Oct 15 07:17:15 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _PLUGINS_METRICS_ASPECT_METRICS_REGISTRY_H_
+#define _PLUGINS_METRICS_ASPECT_METRICS_REGISTRY_H_
+
+#include <plugins/metrics/protobuf/metrics.pb.h>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+
+class Mutex;
+class MetricsRegistry;
+
+class MetricsCounter
+{
+	friend MetricsRegistry;
+
+public:
+	/** Increment counter.
+	 * @param n value to add */
+	void
+	inc(uint64_t n = 1)
+	{
+		value_.fetch_add(n, std::memory_order_relaxed);
+	}
+
+	/** Get current value.
+	 * @return current value */
+	uint64_t
+	value() const
+	{
+		return value_.load(std::memory_order_relaxed);
+	}
+
+private:
+	MetricsCounter() : value_(0)
+	{
+	}
+
+	std::atomic<uint64_t> value_;
+};
+
+class MetricsGauge
+{
+	friend MetricsRegistry;
+
+public:
+	/** Set gauge value.
+	 * @param v new value */
+	void
+	set(double v)
+	{
+		value_.store(v, std::memory_order_relaxed);
+	}
+
+	void inc(double v = 1.);
+
+	/** Decrement gauge.
+	 * @param v value to subtract */
+	void
+	dec(double v = 1.)
+	{
+		inc(-v);
+	}
+
+	/** Get current value.
+	 * @return current value */
+	double
+	value() const
+	{
+		return value_.load(std::memory_order_relaxed);
+	}
+
+private:
+	MetricsGauge() : value_(0.)
+	{
+	}
+
+	std::atomic<double> value_;
+};
+
+class MetricsHistogram
+{
+	friend MetricsRegistry;
+
+public:
+	void observe(double v);
+
+	uint64_t count() const;
+
+	/** Get sum of observations.
+	 * @return sum of observations */
+	double
+	sum() const
+	{
+		return sum_.load(std::memory_order_relaxed);
+	}
+
+private:
+	explicit MetricsHistogram(const std::vector<double> &bounds);
+
+	const std::vector<double>          bounds_;
+	std::vector<std::atomic<uint64_t>> buckets_;
+	std::atomic<double>                sum_;
+};
+
+class MetricsRegistry
+{
+public:
+	/** Labels of a metric, mapping label names to values. */
+	typedef std::map<std::string, std::string> Labels;
+
+	MetricsRegistry();
+	~MetricsRegistry();
+
+	MetricsCounter *
+	counter(const std::string &name, const std::string &help, const Labels &labels = Labels());
+	MetricsGauge *
+	gauge(const std::string &name, const std::string &help, const Labels &labels = Labels());
+	MetricsHistogram *histogram(const std::string &        name,
+	                            const std::string &        help,
+	                            const std::vector<double> &bounds,
+	                            const Labels &             labels = Labels());
+
+	std::list<io::prometheus::client::MetricFamily> metrics();
+	void                                            append_text(std::string &out);
+
+private:
+	/// @cond INTERNALS
+	typedef enum { TYPE_COUNTER, TYPE_GAUGE, TYPE_HISTOGRAM } MetricType;
+
+	typedef struct
+	{
+		Labels                   labels;
+		std::string              label_str;
+		std::vector<std::string> bucket_label_strs;
+
+		std::unique_ptr<MetricsCounter>   counter;
+		std::unique_ptr<MetricsGauge>     gauge;
+		std::unique_ptr<MetricsHistogram> histogram;
+	} Series;
+
+	typedef struct
+	{
+		std::string         help;
+		MetricType          type;
+		std::vector<double> bounds;
+		std::list<Series>   series;
+	} Family;
+	/// @endcond
+
+	Series *get_series(const std::string &        name,
+	                   const std::string &        help,
+	                   MetricType                 type,
+	                   const std::vector<double> &bounds,
+	                   const Labels &             labels);
+
+private:
+	Mutex *                       mutex_;
+	std::map<std::string, Family> families_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -80,6 +80,13 @@ MetricsRequestProcessor::process_request(const fawkes::WebRequest *request)
 	std::list<io::prometheus::client::MetricFamily> metrics(
 	  std::move(metrics_manager_->all_metrics()));
 
+	// the text format is serialized directly from the registry below
+	bool text_format = (accepted_encoding.find("application/vnd.google.protobuf") == std::string::npos
+	                    && accepted_encoding.find("application/json") == std::string::npos);
+	if (!text_format) {
+		metrics.splice(metrics.end(), metrics_manager_->registry()->metrics());
+	}
+
 	if (accepted_encoding.find("application/vnd.google.protobuf") != std::string::npos) {
 		reply->add_header("Content-type",
 		                  "application/vnd.google.protobuf; "
@@ -282,6 +289,10 @@ MetricsRequestProcessor::process_request(const fawkes::WebRequest *request)
 				}
 			}
 		}
+
+		std::string registry_text;
+		metrics_manager_->registry()->append_text(registry_text);
+		reply->append_body(registry_text);
 	}
 
 	return reply;
@@ -22,12 +22,20 @@
 
 #include "metrics_processor.h"
 
+#include <aspect/blocked_timing/loop_statistics.h>
+#include <core/threading/lock_profiler.h>
 #include <core/threading/mutex_locker.h>
+#include <interface/interface_info.h>
+#include <interfaces/LoopTimeInterface.h>
 #include <interfaces/MetricCounterInterface.h>
 #include <interfaces/MetricGaugeInterface.h>
 #include <interfaces/MetricHistogramInterface.h>
 #include <interfaces/MetricUntypedInterface.h>
+#include <interfaces/PipelineLatencyInterface.h>
 #include <utils/misc/string_split.h>
+#include <utils/time/latency_histogram.h>
+#include <utils/time/latency_trace.h>
+#include <utils/time/section_tracker.h>
 #include <webview/url_manager.h>
 
 #include <algorithm>
@@ -39,8 +47,20 @@ using namespace fawkes;
 #define CFG_PREFIX "/metrics/"
 #define URL_PREFIX "/metrics"
 
+/** Default loop time histogram bucket bounds in seconds. */
+static const std::vector<float> LOOP_TIME_DEFAULT_BUCKETS =
+  {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.02, 0.04, 0.08, 0.16, 0.5};
+
 /** @class MetricsThread "metrics_thread.h"
  * Thread to export metrics for Prometheus.
+ * Besides metrics from the blackboard and from suppliers, the thread
+ * exports the loop time histograms of main loop hooks and blocked timing
+ * threads kept by BlockedTimingLoopStatistics. They are also written
+ * periodically to one LoopTimeInterface per hook and per thread. The
+ * durations of sections tracked with the SectionTracker are aggregated
+ * periodically and exported as well. End-to-end latencies of pipelines
+ * recorded with LatencyTrace are exported and written periodically to one
+ * PipelineLatencyInterface per pipeline.
  * @author Tim Niemueller
  */
 
@@ -122,6 +142,19 @@ MetricsThread::init()
 		                 "Internal metric metrics_proctime bucket bounds not configured, disabling");
 	}
 
+	try {
+		loop_time_buckets_ = config->get_floats(CFG_PREFIX "loop_time/buckets");
+	} catch (Exception &e) {
+		loop_time_buckets_ = LOOP_TIME_DEFAULT_BUCKETS;
+	}
+	std::sort(loop_time_buckets_.begin(), loop_time_buckets_.end());
+	try {
+		loop_time_interval_ = config->get_float(CFG_PREFIX "loop_time/interval");
+	} catch (Exception &e) {
+		loop_time_interval_ = 1.0;
+	}
+	loop_time_last_ = std::chrono::steady_clock::now();
+
 	metrics_suppliers_.push_back(this);
 
 	req_proc_ = new MetricsRequestProcessor(this, logger, URL_PREFIX);
@@ -137,6 +170,15 @@ MetricsThread::finalize()
 {
 	webview_url_manager->remove_handler(WebRequest::METHOD_GET, URL_PREFIX);
 	delete req_proc_;
+
+	for (auto &i : loop_time_ifs_) {
+		blackboard->close(i.second);
+	}
+	loop_time_ifs_.clear();
+	for (auto &i : pipeline_latency_ifs_) {
+		blackboard->close(i.second);
+	}
+	pipeline_latency_ifs_.clear();
 }
 
 void
@@ -144,6 +186,16 @@ MetricsThread::loop()
 {
 	imf_loop_count_->mutable_metric(0)->mutable_counter()->set_value(
 	  imf_loop_count_->metric(0).counter().value() + 1);
+
+	if (loop_time_interval_ > 0.) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (std::chrono::duration<float>(now - loop_time_last_).count() >= loop_time_interval_) {
+			loop_time_last_ = now;
+			SectionTracker::aggregate();
+			write_loop_time_interfaces();
+			write_pipeline_latency_interfaces();
+		}
+	}
 }
 
 void
@@ -278,9 +330,350 @@ MetricsThread::metrics()
 		rv.push_back(std::move(*im));
 	}
 
+	io::prometheus::client::MetricFamily hook_mf;
+	hook_mf.set_name("fawkes_hook_loop_time_seconds");
+	hook_mf.set_help("Duration of main loop hooks");
+	hook_mf.set_type(io::prometheus::client::HISTOGRAM);
+	for (int h = BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP;
+	     h <= BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP;
+	     ++h) {
+		BlockedTimingAspect::WakeupHook hook = (BlockedTimingAspect::WakeupHook)h;
+		add_loop_time_metric(hook_mf,
+		                     *BlockedTimingLoopStatistics::hook(hook),
+		                     {{"hook", BlockedTimingAspect::blocked_timing_hook_to_string(hook)}});
+	}
+	rv.push_back(std::move(hook_mf));
+
+	io::prometheus::client::MetricFamily thread_mf;
+	thread_mf.set_name("fawkes_thread_loop_time_seconds");
+	thread_mf.set_help("Loop duration of blocked timing threads");
+	thread_mf.set_type(io::prometheus::client::HISTOGRAM);
+	for (const auto &t : BlockedTimingLoopStatistics::threads()) {
+		add_loop_time_metric(thread_mf,
+		                     *t.histogram,
+		                     {{"hook", BlockedTimingAspect::blocked_timing_hook_to_string(t.hook)},
+		                      {"thread", t.name}});
+	}
+	rv.push_back(std::move(thread_mf));
+
+	SectionTracker::aggregate();
+	io::prometheus::client::MetricFamily section_mf;
+	section_mf.set_name("fawkes_section_time_seconds");
+	section_mf.set_help("Duration of code sections tracked with the SectionTracker");
+	section_mf.set_type(io::prometheus::client::HISTOGRAM);
+	for (const auto &sec : SectionTracker::sections()) {
+		add_loop_time_metric(section_mf, *sec.histogram, {{"section", sec.name}});
+	}
+	rv.push_back(std::move(section_mf));
+
+	io::prometheus::client::MetricFamily dropped_mf;
+	dropped_mf.set_name("fawkes_section_samples_dropped");
+	dropped_mf.set_help("Number of section samples dropped due to full buffers");
+	dropped_mf.set_type(io::prometheus::client::COUNTER);
+	dropped_mf.add_metric()->mutable_counter()->set_value(SectionTracker::dropped());
+	rv.push_back(std::move(dropped_mf));
+
+	io::prometheus::client::MetricFamily pipeline_mf;
+	pipeline_mf.set_name("fawkes_pipeline_latency_seconds");
+	pipeline_mf.set_help("End-to-end latency from a trace source to a sink");
+	pipeline_mf.set_type(io::prometheus::client::HISTOGRAM);
+	for (const auto &p : LatencyTrace::pipelines()) {
+		add_loop_time_metric(pipeline_mf, *p.histogram, {{"source", p.source}, {"sink", p.sink}});
+	}
+	rv.push_back(std::move(pipeline_mf));
+
+	if (Interface::stats_enabled()) {
+		add_blackboard_metrics(rv);
+	}
+	if (LockProfiler::enabled()) {
+		add_lock_metrics(rv);
+	}
+
 	return rv;
 }
 
+/** Add BlackBoard usage statistics.
+ * @param mfs list to append the metric families to
+ */
+void
+MetricsThread::add_blackboard_metrics(std::list<io::prometheus::client::MetricFamily> &mfs)
+{
+	typedef struct
+	{
+		const char *name;
+		const char *help;
+		double (*value)(const interface_stats_t &s);
+	} InterfaceStat;
+
+	static const InterfaceStat interface_stats[] = {
+	  {"fawkes_blackboard_interface_reads",
+	   "Number of reads of the interface",
+	   [](const interface_stats_t &s) -> double { return s.num_reads; }},
+	  {"fawkes_blackboard_interface_read_copies",
+	   "Number of reads of the interface which copied data",
+	   [](const interface_stats_t &s) -> double { return s.num_read_copies; }},
+	  {"fawkes_blackboard_interface_read_locked",
+	   "Number of reads of the interface which acquired the read lock",
+	   [](const interface_stats_t &s) -> double { return s.num_read_locked; }},
+	  {"fawkes_blackboard_interface_writes",
+	   "Number of writes of the interface",
+	   [](const interface_stats_t &s) -> double { return s.num_writes; }},
+	  {"fawkes_blackboard_interface_messages",
+	   "Number of messages enqueued to the interface",
+	   [](const interface_stats_t &s) -> double { return s.num_messages; }},
+	  {"fawkes_blackboard_interface_read_lock_wait_seconds",
+	   "Time spent waiting for the read lock of the interface",
+	   [](const interface_stats_t &s) -> double { return s.read_lock_wait_nsec / 1e9; }},
+	  {"fawkes_blackboard_interface_write_lock_wait_seconds",
+	   "Time spent waiting for the write lock of the interface",
+	   [](const interface_stats_t &s) -> double { return s.write_lock_wait_nsec / 1e9; }},
+	};
+
+	InterfaceInfoList *infl = blackboard->list_all();
+	for (const InterfaceStat &is : interface_stats) {
+		io::prometheus::client::MetricFamily mf;
+		mf.set_name(is.name);
+		mf.set_help(is.help);
+		mf.set_type(io::prometheus::client::COUNTER);
+		for (const InterfaceInfo &ii : *infl) {
+			io::prometheus::client::Metric *   m  = mf.add_metric();
+			io::prometheus::client::LabelPair *lp = m->add_label();
+			lp->set_name("interface");
+			lp->set_value(std::string(ii.type()) + "::" + ii.id());
+			m->mutable_counter()->set_value(is.value(ii.stats()));
+		}
+		mfs.push_back(std::move(mf));
+	}
+	delete infl;
+
+	std::list<BlackBoard::ListenerStats> listeners = blackboard->listener_stats();
+
+	io::prometheus::client::MetricFamily events_mf;
+	events_mf.set_name("fawkes_blackboard_listener_events");
+	events_mf.set_help("Number of data and message events delivered to the listener");
+	events_mf.set_type(io::prometheus::client::COUNTER);
+	io::prometheus::client::MetricFamily dispatch_mf;
+	dispatch_mf.set_name("fawkes_blackboard_listener_dispatch_seconds");
+	dispatch_mf.set_help("Time spent in event callbacks of the listener");
+	dispatch_mf.set_type(io::prometheus::client::COUNTER);
+	for (const auto &l : listeners) {
+		io::prometheus::client::Metric *   m  = events_mf.add_metric();
+		io::prometheus::client::LabelPair *lp = m->add_label();
+		lp->set_name("listener");
+		lp->set_value(l.name);
+		m->mutable_counter()->set_value(l.num_events);
+
+		m  = dispatch_mf.add_metric();
+		lp = m->add_label();
+		lp->set_name("listener");
+		lp->set_value(l.name);
+		m->mutable_counter()->set_value(l.dispatch_nsec / 1e9);
+	}
+	mfs.push_back(std::move(events_mf));
+	mfs.push_back(std::move(dispatch_mf));
+}
+
+/** Add lock contention profile.
+ * @param mfs list to append the metric families to
+ */
+void
+MetricsThread::add_lock_metrics(std::list<io::prometheus::client::MetricFamily> &mfs)
+{
+	typedef struct
+	{
+		const char *                       name;
+		const char *                       help;
+		io::prometheus::client::MetricType type;
+		double (*value)(const LockProfiler::LockStats &s);
+	} LockStat;
+
+	static const LockStat lock_stats[] = {
+	  {"fawkes_lock_acquisitions",
+	   "Number of acquisitions of named locks, or waits of named wait conditions",
+	   io::prometheus::client::COUNTER,
+	   [](const LockProfiler::LockStats &s) -> double { return s.num_locks; }},
+	  {"fawkes_lock_contended",
+	   "Number of acquisitions of named locks which had to wait",
+	   io::prometheus::client::COUNTER,
+	   [](const LockProfiler::LockStats &s) -> double { return s.num_contended; }},
+	  {"fawkes_lock_wait_seconds",
+	   "Time spent waiting for named locks",
+	   io::prometheus::client::COUNTER,
+	   [](const LockProfiler::LockStats &s) -> double { return s.wait_nsec / 1e9; }},
+	  {"fawkes_lock_hold_seconds",
+	   "Time named locks have been held exclusively",
+	   io::prometheus::client::COUNTER,
+	   [](const LockProfiler::LockStats &s) -> double { return s.hold_nsec / 1e9; }},
+	  {"fawkes_lock_max_wait_seconds",
+	   "Maximum time spent waiting for named locks",
+	   io::prometheus::client::GAUGE,
+	   [](const LockProfiler::LockStats &s) -> double { return s.max_wait_nsec / 1e9; }},
+	  {"fawkes_lock_max_hold_seconds",
+	   "Maximum time named locks have been held exclusively",
+	   io::prometheus::client::GAUGE,
+	   [](const LockProfiler::LockStats &s) -> double { return s.max_hold_nsec / 1e9; }},
+	};
+
+	std::list<LockProfiler::LockStats> stats = LockProfiler::stats();
+	for (const LockStat &ls : lock_stats) {
+		io::prometheus::client::MetricFamily mf;
+		mf.set_name(ls.name);
+		mf.set_help(ls.help);
+		mf.set_type(ls.type);
+		for (const auto &s : stats) {
+			io::prometheus::client::Metric *   m  = mf.add_metric();
+			io::prometheus::client::LabelPair *lp = m->add_label();
+			lp->set_name("lock");
+			lp->set_value(s.name);
+			if (ls.type == io::prometheus::client::COUNTER) {
+				m->mutable_counter()->set_value(ls.value(s));
+			} else {
+				m->mutable_gauge()->set_value(ls.value(s));
+			}
+		}
+		mfs.push_back(std::move(mf));
+	}
+}
+
+/** Add loop time histogram to metric family.
+ * @param mf metric family to add the histogram to
+ * @param histogram histogram of durations in microseconds
+ * @param labels labels of the metric
+ */
+void
+MetricsThread::add_loop_time_metric(io::prometheus::client::MetricFamily &    mf,
+                                    const LatencyHistogram &                  histogram,
+                                    const std::map<std::string, std::string> &labels)
+{
+	io::prometheus::client::Metric *m = mf.add_metric();
+	for (const auto &l : labels) {
+		io::prometheus::client::LabelPair *lp = m->add_label();
+		lp->set_name(l.first);
+		lp->set_value(l.second);
+	}
+
+	io::prometheus::client::Histogram *h = m->mutable_histogram();
+	h->set_sample_count(histogram.count());
+	h->set_sample_sum(histogram.sum() / 1000000.);
+	for (float &b : loop_time_buckets_) {
+		io::prometheus::client::Bucket *bucket = h->add_bucket();
+		bucket->set_upper_bound(b);
+		bucket->set_cumulative_count(histogram.count_le((int64_t)(b * 1000000.)));
+	}
+}
+
+/** Write loop time statistics to a blackboard interface.
+ * The interface is opened for writing if it is not open, yet.
+ * @param id ID of the interface
+ * @param histogram loop time histogram in microseconds
+ * @param hook name of the wakeup hook
+ * @param thread name of the thread, empty for a hook
+ * @param written list to which the ID is appended on success
+ */
+void
+MetricsThread::write_loop_time(const std::string &     id,
+                               const LatencyHistogram &histogram,
+                               const std::string &     hook,
+                               const std::string &     thread,
+                               std::list<std::string> &written)
+{
+	LoopTimeInterface *iface;
+	auto               i = loop_time_ifs_.find(id);
+	if (i != loop_time_ifs_.end()) {
+		iface = i->second;
+	} else {
+		try {
+			iface              = blackboard->open_for_writing<LoopTimeInterface>(id.c_str());
+			loop_time_ifs_[id] = iface;
+		} catch (Exception &e) {
+			logger->log_warn(name(), "Failed to open %s: %s", id.c_str(), e.what_no_backtrace());
+			return;
+		}
+	}
+
+	iface->set_hook(hook.c_str());
+	iface->set_thread(thread.c_str());
+	iface->set_count(histogram.count());
+	iface->set_mean(histogram.mean() / 1000000.);
+	iface->set_p50(histogram.percentile(0.5) / 1000000.);
+	iface->set_p99(histogram.percentile(0.99) / 1000000.);
+	iface->set_max(histogram.max() / 1000000.);
+	iface->write();
+	written.push_back(id);
+}
+
+/** Write loop time statistics of all hooks and threads to the blackboard.
+ * Interfaces of threads which have been finalized are closed.
+ */
+void
+MetricsThread::write_loop_time_interfaces()
+{
+	std::list<std::string> written;
+
+	for (int h = BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP;
+	     h <= BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP;
+	     ++h) {
+		BlockedTimingAspect::WakeupHook hook      = (BlockedTimingAspect::WakeupHook)h;
+		std::string                     hook_name = blocked_timing_hook_to_string(hook);
+		write_loop_time("LoopTime " + hook_name,
+		                *BlockedTimingLoopStatistics::hook(hook),
+		                hook_name,
+		                "",
+		                written);
+	}
+
+	for (const auto &t : BlockedTimingLoopStatistics::threads()) {
+		std::string id = ("LoopTime " + t.name).substr(0, INTERFACE_ID_SIZE_ - 1);
+		write_loop_time(
+		  id, *t.histogram, blocked_timing_hook_to_string(t.hook), t.name, written);
+	}
+
+	for (auto i = loop_time_ifs_.begin(); i != loop_time_ifs_.end();) {
+		if (std::find(written.begin(), written.end(), i->first) == written.end()) {
+			blackboard->close(i->second);
+			i = loop_time_ifs_.erase(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+/** Write latency statistics of all pipelines to the blackboard.
+ * Pipelines are never removed, hence interfaces stay open until the
+ * thread is finalized.
+ */
+void
+MetricsThread::write_pipeline_latency_interfaces()
+{
+	for (const auto &p : LatencyTrace::pipelines()) {
+		std::string id =
+		  ("PipelineLatency " + p.source + " to " + p.sink).substr(0, INTERFACE_ID_SIZE_ - 1);
+
+		PipelineLatencyInterface *iface;
+		auto                      i = pipeline_latency_ifs_.find(id);
+		if (i != pipeline_latency_ifs_.end()) {
+			iface = i->second;
+		} else {
+			try {
+				iface = blackboard->open_for_writing<PipelineLatencyInterface>(id.c_str());
+				pipeline_latency_ifs_.emplace(id, iface);
+			} catch (Exception &e) {
+				logger->log_warn(name(), "Failed to open %s: %s", id.c_str(), e.what_no_backtrace());
+				continue;
+			}
+		}
+
+		iface->set_source(p.source.c_str());
+		iface->set_sink(p.sink.c_str());
+		iface->set_count(p.histogram->count());
+		iface->set_mean(p.histogram->mean() / 1000000.);
+		iface->set_p50(p.histogram->percentile(0.5) / 1000000.);
+		iface->set_p99(p.histogram->percentile(0.99) / 1000000.);
+		iface->set_max(p.histogram->max() / 1000000.);
+		iface->write();
+	}
+}
+
 std::list<io::prometheus::client::MetricFamily>
 MetricsThread::all_metrics()
 {
@@ -319,6 +712,12 @@ MetricsThread::metrics_suppliers() const
 	return metrics_suppliers_;
 }
 
+MetricsRegistry *
+MetricsThread::registry()
+{
+	return &metrics_registry_;
+}
+
 void
 MetricsThread::parse_labels(const std::string &labels, io::prometheus::client::Metric *m)
 {
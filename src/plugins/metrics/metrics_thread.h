@@ -36,15 +36,20 @@
 #include <core/utils/lock_map.h>
 #include <interfaces/MetricFamilyInterface.h>
 
+#include <chrono>
+#include <map>
 #include <memory>
 
 class MetricsRequestProcessor;
 
 namespace fawkes {
+class LatencyHistogram;
+class LoopTimeInterface;
 class MetricCounterInterface;
 class MetricGaugeInterface;
 class MetricUntypedInterface;
 class MetricHistogramInterface;
+class PipelineLatencyInterface;
 //MetricSummaryInterface;
 } // namespace fawkes
 
@@ -122,15 +127,31 @@ private:
 
 	virtual const fawkes::LockList<MetricsSupplier *> &metrics_suppliers() const;
 
+	virtual fawkes::MetricsRegistry *registry();
+
 	bool conditional_open(const std::string &id, MetricFamilyBB &mfbb);
 	void conditional_close(fawkes::Interface *interface) noexcept;
 	void parse_labels(const std::string &labels, io::prometheus::client::Metric *m);
 
+	void add_loop_time_metric(io::prometheus::client::MetricFamily &    mf,
+	                          const fawkes::LatencyHistogram &          histogram,
+	                          const std::map<std::string, std::string> &labels);
+	void add_blackboard_metrics(std::list<io::prometheus::client::MetricFamily> &mfs);
+	void add_lock_metrics(std::list<io::prometheus::client::MetricFamily> &mfs);
+	void write_loop_time(const std::string &             id,
+	                     const fawkes::LatencyHistogram &histogram,
+	                     const std::string &             hook,
+	                     const std::string &             thread,
+	                     std::list<std::string> &        written);
+	void write_loop_time_interfaces();
+	void write_pipeline_latency_interfaces();
+
 private:
 	MetricsRequestProcessor *                    req_proc_;
 	fawkes::LockMap<std::string, MetricFamilyBB> metric_bbs_;
 
 	fawkes::MetricsAspectIniFin metrics_aspect_inifin_;
+	fawkes::MetricsRegistry     metrics_registry_;
 
 	// Internal metric families
 	std::shared_ptr<io::prometheus::client::MetricFamily> imf_loop_count_;
@@ -140,6 +161,13 @@ private:
 	std::vector<std::shared_ptr<io::prometheus::client::MetricFamily>> internal_metrics_;
 
 	fawkes::LockList<MetricsSupplier *> metrics_suppliers_;
+
+	std::vector<float>                                 loop_time_buckets_;
+	float                                              loop_time_interval_;
+	std::chrono::steady_clock::time_point              loop_time_last_;
+	std::map<std::string, fawkes::LoopTimeInterface *> loop_time_ifs_;
+
+	std::map<std::string, fawkes::PipelineLatencyInterface *> pipeline_latency_ifs_;
 };
 
 #endif
@@ -22,13 +22,19 @@
 
 #include "mongodb_log_bb_thread.h"
 
+#include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
-#include <plugins/mongodb/aspect/mongodb_conncreator.h>
+#include <core/threading/wait_condition.h>
 
+#include <cmath>
 #include <cstdlib>
 #include <fnmatch.h>
+#include <map>
 #include <mongocxx/client.hpp>
 #include <mongocxx/exception/operation_exception.hpp>
+#include <mongocxx/options/insert.hpp>
+#include <mongocxx/write_concern.hpp>
+#include <vector>
 
 using namespace mongocxx;
 using namespace fawkes;
@@ -38,12 +44,20 @@ using namespace fawkes;
  * This thread registers to interfaces specified with patterns in the
  * configurationa and logs any changes to MongoDB.
  *
+ * The listeners only convert the interface data to a document and queue
+ * it, the thread writes the queued documents in batches with one bulk
+ * insert per collection. A batch is written once it reaches the
+ * configured size or when the flush interval has passed. If the queue
+ * is full, for example because the database cannot keep up, documents
+ * are dropped instead of stalling the interface writers, and the number
+ * of dropped documents is logged.
+ *
  * @author Tim Niemueller
  */
 
 /** Constructor. */
 MongoLogBlackboardThread::MongoLogBlackboardThread()
-: Thread("MongoLogBlackboardThread", Thread::OPMODE_WAITFORWAKEUP), MongoDBAspect("default")
+: Thread("MongoLogBlackboardThread", Thread::OPMODE_CONTINUOUS), MongoDBAspect("default")
 {
 }
 
@@ -63,6 +77,28 @@ MongoLogBlackboardThread::init()
 		logger->log_info(name(), "No database configured, writing to %s", database_.c_str());
 	}
 
+	cfg_batch_size_ = config->get_uint_or_default("/plugins/mongodb-log/blackboard/batch-size", 100);
+	cfg_queue_length_ =
+	  config->get_uint_or_default("/plugins/mongodb-log/blackboard/queue-length", 10000);
+	cfg_flush_interval_ =
+	  config->get_float_or_default("/plugins/mongodb-log/blackboard/flush-interval", 0.5);
+	cfg_ordered_ = config->get_bool_or_default("/plugins/mongodb-log/blackboard/ordered", false);
+	cfg_acknowledge_ =
+	  config->get_bool_or_default("/plugins/mongodb-log/blackboard/acknowledge", true);
+	if (cfg_batch_size_ == 0) {
+		cfg_batch_size_ = 1;
+	}
+	if (cfg_queue_length_ < cfg_batch_size_) {
+		cfg_queue_length_ = cfg_batch_size_;
+	}
+
+	queue_mutex_          = new Mutex();
+	queue_cond_           = new WaitCondition(queue_mutex_);
+	num_written_          = 0;
+	num_dropped_          = 0;
+	num_dropped_reported_ = 0;
+	num_failed_           = 0;
+
 	std::vector<std::string> includes;
 	try {
 		includes = config->get_strings("/plugins/mongodb-log/blackboard/includes");
@@ -100,10 +136,9 @@ MongoLogBlackboardThread::init()
 				continue;
 
 			logger->log_debug(name(), "Adding %s", (*i)->uid());
-			client *    mc          = mongodb_connmgr->create_client();
 			std::string agent_name  = config->get_string_or_default("/fawkes/agent/name", "");
-			listeners_[(*i)->uid()] = new InterfaceListener(
-			  blackboard, *i, mc, database_, collections_, agent_name, logger, now_);
+			listeners_[(*i)->uid()] =
+			  new InterfaceListener(blackboard, *i, this, collections_, agent_name, logger, now_);
 		}
 	}
 
@@ -117,16 +152,126 @@ MongoLogBlackboardThread::finalize()
 
 	std::map<std::string, InterfaceListener *>::iterator i;
 	for (i = listeners_.begin(); i != listeners_.end(); ++i) {
-		client *mc = i->second->mongodb_client();
 		delete i->second;
-		mongodb_connmgr->delete_client(mc);
 	}
 	listeners_.clear();
+
+	// the loop has been cancelled, write what is left
+	std::deque<QueueEntry> batch;
+	batch.swap(queue_);
+	write(batch);
+
+	logger->log_info(name(),
+	                 "Wrote %u documents, dropped %u, failed to write %u",
+	                 num_written_,
+	                 num_dropped_,
+	                 num_failed_);
+
+	delete queue_cond_;
+	delete queue_mutex_;
 }
 
 void
 MongoLogBlackboardThread::loop()
 {
+	queue_mutex_->lock();
+	if (queue_.size() < cfg_batch_size_) {
+		float        integral;
+		float        fraction = modff(cfg_flush_interval_, &integral);
+		unsigned int sec      = (unsigned int)integral;
+		unsigned int nanosec  = (unsigned int)(fraction * 1000000000.f);
+		queue_cond_->reltimed_wait(sec, nanosec);
+	}
+	std::deque<QueueEntry> batch;
+	batch.swap(queue_);
+	unsigned int dropped  = num_dropped_ - num_dropped_reported_;
+	num_dropped_reported_ = num_dropped_;
+	queue_mutex_->unlock();
+
+	if (dropped > 0) {
+		logger->log_warn(name(),
+		                 "Queue full, dropped %u documents (%u in total)",
+		                 dropped,
+		                 num_dropped_reported_);
+	}
+
+	// do not leave the client in an undefined state
+	CancelState old_state;
+	set_cancel_state(CANCEL_DISABLED, &old_state);
+	write(batch);
+	set_cancel_state(old_state);
+}
+
+/** Queue a document to be written.
+ * Called by the interface listeners.
+ * @param collection collection to write the document to
+ * @param document document to write
+ * @return true if the document has been queued, false if it has been
+ * dropped because the queue is full
+ */
+bool
+MongoLogBlackboardThread::enqueue(const std::string &         collection,
+                                  bsoncxx::document::value &&document)
+{
+	MutexLocker lock(queue_mutex_);
+	if (queue_.size() >= cfg_queue_length_) {
+		++num_dropped_;
+		return false;
+	}
+	queue_.emplace_back(collection, std::move(document));
+	if (queue_.size() >= cfg_batch_size_) {
+		queue_cond_->wake_all();
+	}
+	return true;
+}
+
+/** Write a batch of documents.
+ * The documents are written with one bulk insert per collection.
+ * @param batch documents to write
+ */
+void
+MongoLogBlackboardThread::write(std::deque<QueueEntry> &batch)
+{
+	if (batch.empty()) {
+		return;
+	}
+
+	std::map<std::string, std::vector<bsoncxx::document::view>> collections;
+	for (const QueueEntry &e : batch) {
+		collections[e.first].push_back(e.second.view());
+	}
+
+	mongocxx::write_concern write_concern;
+	if (!cfg_acknowledge_) {
+		write_concern.acknowledge_level(mongocxx::write_concern::level::k_unacknowledged);
+	}
+	options::insert insert_options;
+	insert_options.ordered(cfg_ordered_);
+	insert_options.write_concern(write_concern);
+
+	unsigned int written = 0;
+	unsigned int failed  = 0;
+	for (const auto &c : collections) {
+		try {
+			mongodb_client->database(database_)[c.first].insert_many(c.second, insert_options);
+			written += c.second.size();
+		} catch (operation_exception &e) {
+			failed += c.second.size();
+			logger->log_warn(
+			  name(), "Failed to log to %s.%s: %s", database_.c_str(), c.first.c_str(), e.what());
+		} catch (std::exception &e) {
+			failed += c.second.size();
+			logger->log_warn(name(),
+			                 "Failed to log to %s.%s: %s (*)",
+			                 database_.c_str(),
+			                 c.first.c_str(),
+			                 e.what());
+		}
+	}
+
+	MutexLocker lock(queue_mutex_);
+	num_written_ += written;
+	num_failed_ += failed;
 }
 
 // for BlackBoardInterfaceObserver
@@ -147,10 +292,9 @@ MongoLogBlackboardThread::bb_interface_created(const char *type, const char *id)
 		Interface *interface = blackboard->open_for_reading(type, id);
 		if (listeners_.find(interface->uid()) == listeners_.end()) {
 			logger->log_debug(name(), "Opening new %s", interface->uid());
-			client *    mc               = mongodb_connmgr->create_client();
 			std::string agent_name       = config->get_string_or_default("/fawkes/agent/name", "");
-			listeners_[interface->uid()] = new InterfaceListener(
-			  blackboard, interface, mc, database_, collections_, agent_name, logger, now_);
+			listeners_[interface->uid()] =
+			  new InterfaceListener(blackboard, interface, this, collections_, agent_name, logger, now_);
 		} else {
 			logger->log_warn(name(), "Interface %s already opened", interface->uid());
 			blackboard->close(interface);
@@ -164,29 +308,27 @@ MongoLogBlackboardThread::bb_interface_created(const char *type, const char *id)
 /** Constructor.
  * @param blackboard blackboard
  * @param interface interface to listen for
- * @param mongodb MongoDB client to write to
- * @param database name of database to write to
+ * @param thread thread which writes the queued documents
  * @param colls collections
  * @param agent_name agent belonging to the fawkes instance.
  * @param logger logger
  * @param now Time
  */
-MongoLogBlackboardThread::InterfaceListener::InterfaceListener(BlackBoard *          blackboard,
-                                                               Interface *           interface,
-                                                               client *              mongodb,
-                                                               std::string &         database,
-                                                               LockSet<std::string> &colls,
-                                                               const std::string &   agent_name,
-                                                               Logger *              logger,
-                                                               Time *                now)
+MongoLogBlackboardThread::InterfaceListener::InterfaceListener(
+  BlackBoard *               blackboard,
+  Interface *                interface,
+  MongoLogBlackboardThread * thread,
+  LockSet<std::string> &     colls,
+  const std::string &        agent_name,
+  Logger *                   logger,
+  Time *                     now)
 : BlackBoardInterfaceListener("MongoLogListener-%s", interface->uid()),
-  database_(database),
   collections_(colls),
   agent_name_(agent_name)
 {
 	blackboard_ = blackboard;
 	interface_  = interface;
-	mongodb_    = mongodb;
+	thread_     = thread;
 	logger_     = logger;
 	now_        = now;
 
@@ -407,15 +549,8 @@ MongoLogBlackboardThread::InterfaceListener::bb_interface_data_refreshed(
 		}
 
 		document.append(basic::kvp("agent-name", agent_name_));
-		mongodb_->database(database_)[collection_].insert_one(document.view());
-	} catch (operation_exception &e) {
-		logger_->log_warn(
-		  bbil_name(), "Failed to log to %s.%s: %s", database_.c_str(), collection_.c_str(), e.what());
+		thread_->enqueue(collection_, document.extract());
 	} catch (std::exception &e) {
-		logger_->log_warn(bbil_name(),
-		                  "Failed to log to %s.%s: %s (*)",
-		                  database_.c_str(),
-		                  collection_.c_str(),
-		                  e.what());
+		logger_->log_warn(bbil_name(), "Failed to log %s: %s", collection_.c_str(), e.what());
 	}
 }
@@ -34,7 +34,15 @@
 #include <core/utils/lock_set.h>
 #include <plugins/mongodb/aspect/mongodb.h>
 
+#include <bsoncxx/document/value.hpp>
+#include <deque>
 #include <string>
+#include <utility>
+
+namespace fawkes {
+class Mutex;
+class WaitCondition;
+} // namespace fawkes
 
 class MongoLogBlackboardThread : public fawkes::Thread,
                                  public fawkes::LoggingAspect,
@@ -70,43 +78,53 @@ private:
 	public:
 		InterfaceListener(fawkes::BlackBoard *          blackboard,
 		                  fawkes::Interface *           interface,
-		                  mongocxx::client *            mongodb,
-		                  std::string &                 database,
+		                  MongoLogBlackboardThread *    thread,
 		                  fawkes::LockSet<std::string> &colls,
 		                  const std::string &           agent_name,
 		                  fawkes::Logger *              logger,
 		                  fawkes::Time *                now);
 		~InterfaceListener();
 
-		/** Get MongoDB Client.
-     * @return MongoDB client */
-		mongocxx::client *
-		mongodb_client() const
-		{
-			return mongodb_;
-		}
-
 		// for BlackBoardInterfaceListener
 		virtual void bb_interface_data_refreshed(fawkes::Interface *interface) noexcept;
 
 	private:
 		fawkes::BlackBoard *          blackboard_;
 		fawkes::Interface *           interface_;
-		mongocxx::client *            mongodb_;
+		MongoLogBlackboardThread *    thread_;
 		fawkes::Logger *              logger_;
 		std::string                   collection_;
-		std::string &                 database_;
 		fawkes::LockSet<std::string> &collections_;
 		const std::string             agent_name_;
 		fawkes::Time *                now_;
 	};
 
+	/** Queued document with the collection to write it to. */
+	typedef std::pair<std::string, bsoncxx::document::value> QueueEntry;
+
+	bool enqueue(const std::string &collection, bsoncxx::document::value &&document);
+	void write(std::deque<QueueEntry> &batch);
+
 	fawkes::LockMap<std::string, InterfaceListener *> listeners_;
 	fawkes::LockSet<std::string>                      collections_;
 	std::string                                       database_;
 	fawkes::Time *                                    now_;
 
 	std::vector<std::string> excludes_;
+
+	unsigned int cfg_batch_size_;
+	unsigned int cfg_queue_length_;
+	float        cfg_flush_interval_;
+	bool         cfg_ordered_;
+	bool         cfg_acknowledge_;
+
+	fawkes::Mutex *         queue_mutex_;
+	fawkes::WaitCondition * queue_cond_;
+	std::deque<QueueEntry>  queue_;
+	unsigned int            num_written_;
+	unsigned int            num_dropped_;
+	unsigned int            num_dropped_reported_;
+	unsigned int            num_failed_;
 };
 
 #endif
@@ -174,7 +174,7 @@ MongoLogTransformsThread::store(std::vector<tf::TimeCacheInterfacePtr> &caches,
 		document.append(basic::kvp("timestamp", static_cast<int64_t>(from[i].in_msec())));
 		document.append(basic::kvp("timestamp_from", static_cast<int64_t>(from[i].in_msec())));
 		document.append(basic::kvp("timestamp_to", static_cast<int64_t>(to[i].in_msec())));
-		const tf::TimeCache::L_TransformStorage &storage = tc->get_storage();
+		const tf::TimeCache::L_TransformStorage storage = tc->get_storage_copy();
 
 		if (storage.empty()) {
 			/*
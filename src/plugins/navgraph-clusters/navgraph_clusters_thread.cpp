@@ -29,6 +29,8 @@
 #include <navgraph/constraints/constraint_repo.h>
 #include <navgraph/navgraph.h>
 #include <tf/utils.h>
+#include <utils/time/time.h>
+#include <utils/tracking/multi_target_tracker.h>
 
 #include <Eigen/StdVector>
 #include <algorithm>
@@ -65,6 +67,38 @@ NavGraphClustersThread::init()
 	cfg_min_vishistory_  = config->get_int("/navgraph-clusters/min-visibility-history");
 	cfg_mode_            = config->get_string("/navgraph-clusters/constraint-mode");
 
+	float        cfg_track_gate       = 0.5;
+	float        cfg_track_acc        = 1.0;
+	float        cfg_track_noise      = 0.1;
+	unsigned int cfg_track_max_misses = 5;
+	cfg_track_update_dist_            = 0.05;
+	try {
+		cfg_track_gate = config->get_float("/navgraph-clusters/tracking/gate");
+	} catch (Exception &e) {
+	} // ignored, use default
+	try {
+		cfg_track_acc = config->get_float("/navgraph-clusters/tracking/process-noise");
+	} catch (Exception &e) {
+	} // ignored, use default
+	try {
+		cfg_track_noise = config->get_float("/navgraph-clusters/tracking/measurement-noise");
+	} catch (Exception &e) {
+	} // ignored, use default
+	try {
+		cfg_track_max_misses = config->get_uint("/navgraph-clusters/tracking/max-misses");
+	} catch (Exception &e) {
+	} // ignored, use default
+	try {
+		cfg_track_update_dist_ = config->get_float("/navgraph-clusters/tracking/update-distance");
+	} catch (Exception &e) {
+	} // ignored, use default
+
+	tracker_ =
+	  new MultiTargetTracker(cfg_track_gate, cfg_track_acc, cfg_track_noise, cfg_track_max_misses, 1);
+	tracker_last_time_ = new Time(0, 0);
+	graph_changed_     = true;
+	navgraph->add_change_listener(this);
+
 	std::string pattern = cfg_iface_prefix_ + "*";
 
 	cluster_ifs_ = blackboard->open_multiple_for_reading<Position3DInterface>(pattern.c_str());
@@ -113,6 +147,7 @@ NavGraphClustersThread::finalize()
 		delete edge_cost_constraint_;
 	}
 
+	navgraph->remove_change_listener(this);
 	blackboard->unregister_listener(this);
 	blackboard->unregister_observer(this);
 
@@ -120,6 +155,10 @@ NavGraphClustersThread::finalize()
 		blackboard->close(pif);
 	}
 	cluster_ifs_.clear();
+
+	delete tracker_;
+	delete tracker_last_time_;
+	track_blockages_.clear();
 }
 
 void
@@ -174,6 +213,12 @@ NavGraphClustersThread::bb_interface_reader_removed(fawkes::Interface *interface
 	conditional_close(interface);
 }
 
+void
+NavGraphClustersThread::graph_changed() noexcept
+{
+	graph_changed_ = true;
+}
+
 void
 NavGraphClustersThread::conditional_close(Interface *interface) noexcept
 {
@@ -227,6 +272,9 @@ NavGraphClustersThread::blocked_edges() noexcept
 }
 
 /** Get a list of edges close to a clusters and its centroid considered blocked.
+ * The cluster centroids are tracked over time. The edges blocked by a
+ * track are cached and only re-evaluated if the track moved noticeably
+ * or the graph changed.
  * @return list of tuples of blocked edges' start and end name and the centroid
  * of the object close to the edge.
  */
@@ -236,8 +284,7 @@ NavGraphClustersThread::blocked_edges_centroids() noexcept
 	MutexLocker                                                      lock(cluster_ifs_.mutex());
 	std::list<std::tuple<std::string, std::string, Eigen::Vector2f>> blocked;
 
-	const std::vector<NavGraphEdge> &graph_edges = navgraph->edges();
-
+	std::vector<cart_coord_2d_t> centroids;
 	for (Position3DInterface *pif : cluster_ifs_) {
 		pif->read();
 		if (pif->visibility_history() >= cfg_min_vishistory_) {
@@ -246,28 +293,56 @@ NavGraphClustersThread::blocked_edges_centroids() noexcept
 				// would always run into an extrapolation exception
 				Eigen::Vector2f centroid(fixed_frame_pose(
 				  pif->frame(), fawkes::Time(0, 0), pif->translation(0), pif->translation(1)));
-
-				for (const NavGraphEdge &edge : graph_edges) {
-					const Eigen::Vector2f origin(edge.from_node().x(), edge.from_node().y());
-					const Eigen::Vector2f target(edge.to_node().x(), edge.to_node().y());
-					const Eigen::Vector2f direction(target - origin);
-					const Eigen::Vector2f direction_norm = direction.normalized();
-					const Eigen::Vector2f diff           = centroid - origin;
-					const float           t              = direction.dot(diff) / direction.squaredNorm();
-
-					if (t >= 0.0 && t <= 1.0) {
-						// projection of the centroid onto the edge is within the line segment
-						float distance = (diff - direction_norm.dot(diff) * direction_norm).norm();
-						if (distance < cfg_close_threshold_) {
-							blocked.push_back(make_tuple(edge.from(), edge.to(), centroid));
-						}
-					}
-				}
+				centroids.push_back(cart_coord_2d_t{centroid[0], centroid[1]});
 			} catch (Exception &e) {
 				//logger->log_info(name(), "Failed to transform %s, ignoring", pif->uid());
 			}
 		}
 	}
+
+	fawkes::Time now(clock);
+	float        dt = 0.;
+	if (tracker_last_time_->in_sec() > 0.) {
+		dt = std::max(0., now - tracker_last_time_);
+	}
+	*tracker_last_time_ = now;
+	tracker_->update(centroids, dt);
+
+	if (graph_changed_.exchange(false)) {
+		track_blockages_.clear();
+	}
+
+	// drop cached blockages of lost tracks
+	const std::vector<MultiTargetTracker::Track> &tracks = tracker_->tracks();
+	for (auto b = track_blockages_.begin(); b != track_blockages_.end();) {
+		if (std::none_of(tracks.begin(), tracks.end(), [&b](const MultiTargetTracker::Track &t) {
+			    return t.id == b->first;
+		    })) {
+			b = track_blockages_.erase(b);
+		} else {
+			++b;
+		}
+	}
+
+	const std::vector<unsigned int> &track_ids = tracker_->measurement_tracks();
+	for (size_t i = 0; i < centroids.size(); ++i) {
+		const Eigen::Vector2f centroid(centroids[i].x, centroids[i].y);
+
+		auto b = track_blockages_.find(track_ids[i]);
+		if (b == track_blockages_.end()) {
+			b = track_blockages_.insert(std::make_pair(track_ids[i], TrackBlockage())).first;
+			b->second.position = centroid;
+			close_edges(centroid, b->second.edges);
+		} else if ((b->second.position - centroid).norm() > cfg_track_update_dist_) {
+			b->second.position = centroid;
+			close_edges(centroid, b->second.edges);
+		}
+
+		for (const auto &e : b->second.edges) {
+			blocked.push_back(make_tuple(e.first, e.second, centroid));
+		}
+	}
+
 	blocked.sort([](const std::tuple<std::string, std::string, Eigen::Vector2f> &a,
 	                const std::tuple<std::string, std::string, Eigen::Vector2f> &b) {
 		return (std::get<0>(a) < std::get<0>(b)
@@ -278,6 +353,36 @@ NavGraphClustersThread::blocked_edges_centroids() noexcept
 	return blocked;
 }
 
+/** Determine edges close to a centroid.
+ * @param centroid centroid in the fixed frame
+ * @param edges upon return contains start and end name of edges closer
+ * than the close threshold to the centroid
+ */
+void
+NavGraphClustersThread::close_edges(const Eigen::Vector2f &                           centroid,
+                                    std::vector<std::pair<std::string, std::string>> &edges)
+{
+	edges.clear();
+
+	const std::vector<NavGraphEdge> &graph_edges = navgraph->edges();
+	for (const NavGraphEdge &edge : graph_edges) {
+		const Eigen::Vector2f origin(edge.from_node().x(), edge.from_node().y());
+		const Eigen::Vector2f target(edge.to_node().x(), edge.to_node().y());
+		const Eigen::Vector2f direction(target - origin);
+		const Eigen::Vector2f direction_norm = direction.normalized();
+		const Eigen::Vector2f diff           = centroid - origin;
+		const float           t              = direction.dot(diff) / direction.squaredNorm();
+
+		if (t >= 0.0 && t <= 1.0) {
+			// projection of the centroid onto the edge is within the line segment
+			float distance = (diff - direction_norm.dot(diff) * direction_norm).norm();
+			if (distance < cfg_close_threshold_) {
+				edges.push_back(std::make_pair(edge.from(), edge.to()));
+			}
+		}
+	}
+}
+
 Eigen::Vector2f
 NavGraphClustersThread::fixed_frame_pose(std::string         frame,
                                          const fawkes::Time &timestamp,
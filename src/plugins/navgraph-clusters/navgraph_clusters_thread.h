@@ -31,17 +31,22 @@
 #include <core/threading/thread.h>
 #include <core/utils/lock_list.h>
 #include <navgraph/aspect/navgraph.h>
+#include <navgraph/navgraph.h>
 
 #include <Eigen/Geometry>
+#include <atomic>
 #include <list>
+#include <map>
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace fawkes {
 class Position3DInterface;
 class Time;
 class NavGraphEdgeConstraint;
 class NavGraphEdgeCostConstraint;
+class MultiTargetTracker;
 } // namespace fawkes
 
 class NavGraphClustersThread : public fawkes::Thread,
@@ -52,7 +57,8 @@ class NavGraphClustersThread : public fawkes::Thread,
                                public fawkes::TransformAspect,
                                public fawkes::NavGraphAspect,
                                public fawkes::BlackBoardInterfaceObserver,
-                               public fawkes::BlackBoardInterfaceListener
+                               public fawkes::BlackBoardInterfaceListener,
+                               public fawkes::NavGraph::ChangeListener
 {
 public:
 	NavGraphClustersThread();
@@ -87,11 +93,25 @@ private:
 	virtual void bb_interface_reader_removed(fawkes::Interface *interface,
 	                                         fawkes::Uuid       instance_serial) noexcept;
 
+	// for NavGraph::ChangeListener
+	virtual void graph_changed() noexcept;
+
 	void conditional_close(fawkes::Interface *interface) noexcept;
 
 	Eigen::Vector2f
 	fixed_frame_pose(std::string frame, const fawkes::Time &timestamp, float x, float y);
 
+	void close_edges(const Eigen::Vector2f &                           centroid,
+	                 std::vector<std::pair<std::string, std::string>> &edges);
+
+	/// @cond INTERNALS
+	typedef struct
+	{
+		Eigen::Vector2f                                  position;
+		std::vector<std::pair<std::string, std::string>> edges;
+	} TrackBlockage;
+	/// @endcond
+
 private:
 	std::string cfg_iface_prefix_;
 	float       cfg_close_threshold_;
@@ -99,6 +119,12 @@ private:
 	std::string cfg_base_frame_;
 	int         cfg_min_vishistory_;
 	std::string cfg_mode_;
+	float       cfg_track_update_dist_;
+
+	fawkes::MultiTargetTracker *          tracker_;
+	fawkes::Time *                        tracker_last_time_;
+	std::map<unsigned int, TrackBlockage> track_blockages_;
+	std::atomic<bool>                     graph_changed_;
 
 	fawkes::LockList<fawkes::Position3DInterface *> cluster_ifs_;
 
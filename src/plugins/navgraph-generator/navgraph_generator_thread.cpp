@@ -45,6 +45,7 @@ NavGraphGeneratorThread::NavGraphGeneratorThread()
 : Thread("NavGraphGeneratorThread", Thread::OPMODE_WAITFORWAKEUP),
   BlackBoardInterfaceListener("NavGraphGeneratorThread")
 {
+	map_ = NULL;
 #ifdef HAVE_VISUALIZATION
 	vt_ = NULL;
 #endif
@@ -56,7 +57,8 @@ NavGraphGeneratorThread::NavGraphGeneratorThread(NavGraphGeneratorVisualizationT
 : Thread("NavGraphGeneratorThread", Thread::OPMODE_WAITFORWAKEUP),
   BlackBoardInterfaceListener("NavGraphGeneratorThread")
 {
-	vt_ = vt;
+	map_ = NULL;
+	vt_  = vt;
 }
 #endif
 
@@ -70,6 +72,7 @@ NavGraphGeneratorThread::init()
 {
 	bbox_set_                = false;
 	copy_default_properties_ = true;
+	base_dirty_              = true;
 
 	filter_["FILTER_EDGES_BY_MAP"] = false;
 	filter_["FILTER_ORPHAN_NODES"] = false;
@@ -133,10 +136,23 @@ NavGraphGeneratorThread::finalize()
 	blackboard->unregister_listener(this);
 	bbil_remove_message_interface(navgen_if_);
 	blackboard->close(navgen_if_);
+
+	base_graph_.reset();
+	if (map_) {
+		map_free(map_);
+		map_ = NULL;
+	}
+	map_free_space_indices_.clear();
 }
 
-void
-NavGraphGeneratorThread::loop()
+/** Generate the graph from obstacles and apply filters.
+ * Must be called with the navgraph locked. The result is stored as base
+ * graph to which POIs and edges are added in subsequent loops as long as
+ * no message changed the input of the generation.
+ * @return true on success, false if the graph could not be computed
+ */
+bool
+NavGraphGeneratorThread::compute_base_graph()
 {
 	std::shared_ptr<NavGraphGenerator> ng;
 
@@ -156,13 +172,9 @@ NavGraphGeneratorThread::loop()
 		navgen_if_->set_error_message(e.what_no_backtrace());
 		navgen_if_->set_final(true);
 		navgen_if_->write();
-		return;
+		return false;
 	}
 
-	logger->log_debug(name(),
-	                  "Calculating new graph (%s)",
-	                  navgen_if_->tostring_Algorithm(algorithm_));
-
 	if (bbox_set_) {
 		logger->log_debug(name(),
 		                  "  Setting bound box (%f,%f) to (%f,%f)",
@@ -185,28 +197,6 @@ NavGraphGeneratorThread::loop()
 		ng->add_obstacle(o.second.x, o.second.y);
 	}
 
-	// Acquire lock on navgraph, no more searches/modifications until we are done
-	MutexLocker lock(navgraph.objmutex_ptr());
-
-	// disable notifications as to not trigger one for all the many
-	// operations we are going to perform
-	navgraph->set_notifications_enabled(false);
-
-	// remember default properties
-	std::map<std::string, std::string> default_props = navgraph->default_properties();
-
-	navgraph->clear();
-
-	// restore default properties
-	if (copy_default_properties_) {
-		navgraph->set_default_properties(default_props);
-	}
-
-	// set properties received as message
-	for (auto p : default_properties_) {
-		navgraph->set_default_property(p.first, p.second);
-	}
-
 	logger->log_debug(name(), "  Computing navgraph");
 	try {
 		ng->compute(navgraph);
@@ -216,8 +206,7 @@ NavGraphGeneratorThread::loop()
 		navgen_if_->set_ok(false);
 		navgen_if_->set_error_message(e.what_no_backtrace());
 		navgen_if_->write();
-		navgraph->set_notifications_enabled(true);
-		return;
+		return false;
 	}
 
 	// post-processing
@@ -234,6 +223,51 @@ NavGraphGeneratorThread::loop()
 		filter_multi_graph();
 	}
 
+	base_graph_.reset(new NavGraph(**navgraph));
+	base_dirty_ = false;
+
+	return true;
+}
+
+void
+NavGraphGeneratorThread::loop()
+{
+	logger->log_debug(name(),
+	                  "Calculating new graph (%s)",
+	                  navgen_if_->tostring_Algorithm(algorithm_));
+
+	// Acquire lock on navgraph, no more searches/modifications until we are done
+	MutexLocker lock(navgraph.objmutex_ptr());
+
+	// disable notifications as to not trigger one for all the many
+	// operations we are going to perform
+	navgraph->set_notifications_enabled(false);
+
+	// remember default properties
+	std::map<std::string, std::string> default_props = navgraph->default_properties();
+
+	navgraph->clear();
+
+	// restore default properties
+	if (copy_default_properties_) {
+		navgraph->set_default_properties(default_props);
+	}
+
+	// set properties received as message
+	for (auto p : default_properties_) {
+		navgraph->set_default_property(p.first, p.second);
+	}
+
+	if (base_dirty_ || !base_graph_) {
+		if (!compute_base_graph()) {
+			navgraph->set_notifications_enabled(true);
+			return;
+		}
+	} else {
+		logger->log_debug(name(), "  Obstacles unchanged, re-using generated graph");
+		**navgraph = *base_graph_;
+	}
+
 	// add POIs
 	for (const auto &p : pois_) {
 		// add poi
@@ -383,18 +417,21 @@ NavGraphGeneratorThread::bb_interface_message_received(Interface *interface,
 		for (auto &f : filter_) {
 			f.second = false;
 		}
+		base_dirty_ = true;
 
 	} else if (message->is_of_type<NavGraphGeneratorInterface::SetAlgorithmMessage>()) {
 		NavGraphGeneratorInterface::SetAlgorithmMessage *msg =
 		  message->as_type<NavGraphGeneratorInterface::SetAlgorithmMessage>();
 
-		algorithm_ = msg->algorithm();
+		algorithm_  = msg->algorithm();
+		base_dirty_ = true;
 
 	} else if (message->is_of_type<NavGraphGeneratorInterface::SetAlgorithmParameterMessage>()) {
 		NavGraphGeneratorInterface::SetAlgorithmParameterMessage *msg =
 		  message->as_type<NavGraphGeneratorInterface::SetAlgorithmParameterMessage>();
 
 		algorithm_params_[msg->param()] = msg->value();
+		base_dirty_                     = true;
 
 	} else if (message->is_of_type<NavGraphGeneratorInterface::SetBoundingBoxMessage>()) {
 		NavGraphGeneratorInterface::SetBoundingBoxMessage *msg =
@@ -403,13 +440,15 @@ NavGraphGeneratorThread::bb_interface_message_received(Interface *interface,
 		bbox_p1_.x = msg->p1_x();
 		bbox_p1_.y = msg->p1_y();
 		bbox_p2_.x = msg->p2_x();
-		bbox_p2_.y = msg->p2_y();
+		bbox_p2_.y  = msg->p2_y();
+		base_dirty_ = true;
 
 	} else if (message->is_of_type<NavGraphGeneratorInterface::SetFilterMessage>()) {
 		NavGraphGeneratorInterface::SetFilterMessage *msg =
 		  message->as_type<NavGraphGeneratorInterface::SetFilterMessage>();
 
 		filter_[navgen_if_->tostring_FilterType(msg->filter())] = msg->is_enable();
+		base_dirty_                                             = true;
 
 	} else if (message->is_of_type<NavGraphGeneratorInterface::SetFilterParamFloatMessage>()) {
 		NavGraphGeneratorInterface::SetFilterParamFloatMessage *msg =
@@ -420,6 +459,7 @@ NavGraphGeneratorThread::bb_interface_message_received(Interface *interface,
 
 		if (param_float.find(msg->param()) != param_float.end()) {
 			param_float[msg->param()] = msg->value();
+			base_dirty_               = true;
 		} else {
 			logger->log_warn(name(),
 			                 "Filter %s has no float parameter named %s, ignoring",
@@ -431,12 +471,14 @@ NavGraphGeneratorThread::bb_interface_message_received(Interface *interface,
 		NavGraphGeneratorInterface::AddMapObstaclesMessage *msg =
 		  message->as_type<NavGraphGeneratorInterface::AddMapObstaclesMessage>();
 		map_obstacles_ = map_obstacles(msg->max_line_point_distance());
+		base_dirty_    = true;
 
 	} else if (message->is_of_type<NavGraphGeneratorInterface::AddObstacleMessage>()) {
 		NavGraphGeneratorInterface::AddObstacleMessage *msg =
 		  message->as_type<NavGraphGeneratorInterface::AddObstacleMessage>();
 		if (std::isfinite(msg->x()) && std::isfinite(msg->y())) {
 			obstacles_[msg->name()] = cart_coord_2d_t(msg->x(), msg->y());
+			base_dirty_             = true;
 		} else {
 			logger->log_error(name(),
 			                  "Received non-finite obstacle (%.2f,%.2f), ignoring",
@@ -449,6 +491,7 @@ NavGraphGeneratorThread::bb_interface_message_received(Interface *interface,
 		ObstacleMap::iterator f;
 		if ((f = obstacles_.find(msg->name())) != obstacles_.end()) {
 			obstacles_.erase(f);
+			base_dirty_ = true;
 		}
 
 	} else if (message->is_of_type<NavGraphGeneratorInterface::AddPointOfInterestMessage>()) {
@@ -544,8 +587,12 @@ NavGraphGeneratorThread::bb_interface_message_received(Interface *interface,
 }
 
 map_t *
-NavGraphGeneratorThread::load_map(std::vector<std::pair<int, int>> &free_space_indices)
+NavGraphGeneratorThread::load_map()
 {
+	// the map is only read once and then kept until finalization
+	if (map_)
+		return map_;
+
 	std::string cfg_map_file;
 	float       cfg_resolution;
 	float       cfg_origin_x;
@@ -563,13 +610,14 @@ NavGraphGeneratorThread::load_map(std::vector<std::pair<int, int>> &free_space_i
 	                              cfg_occupied_thresh,
 	                              cfg_free_thresh);
 
-	return fawkes::amcl::read_map(cfg_map_file.c_str(),
+	map_ = fawkes::amcl::read_map(cfg_map_file.c_str(),
 	                              cfg_origin_x,
 	                              cfg_origin_y,
 	                              cfg_resolution,
 	                              cfg_occupied_thresh,
 	                              cfg_free_thresh,
-	                              free_space_indices);
+	                              map_free_space_indices_);
+	return map_;
 }
 
 NavGraphGeneratorThread::ObstacleMap
@@ -578,8 +626,8 @@ NavGraphGeneratorThread::map_obstacles(float line_max_dist)
 	ObstacleMap  obstacles;
 	unsigned int obstacle_i = 0;
 
-	std::vector<std::pair<int, int>> free_space_indices;
-	map_t *                          map = load_map(free_space_indices);
+	map_t *                                 map                = load_map();
+	const std::vector<std::pair<int, int>> &free_space_indices = map_free_space_indices_;
 
 	logger->log_info(name(),
 	                 "Map Obstacles: map size: %ux%u (%zu of %u cells free, %.1f%%)",
@@ -674,28 +722,37 @@ NavGraphGeneratorThread::map_obstacles(float line_max_dist)
 		  cart_coord_2d_t(centroid.x(), centroid.y());
 	}
 
-	map_free(map);
-
 	return obstacles;
 }
 
 void
 NavGraphGeneratorThread::filter_edges_from_map(float max_dist)
 {
-	std::vector<std::pair<int, int>> free_space_indices;
-	map_t *                          map = load_map(free_space_indices);
+	map_t *map = load_map();
 
 	const std::vector<NavGraphEdge> &edges = navgraph->edges();
 
-	for (int x = 0; x < map->size_x; ++x) {
-		for (int y = 0; y < map->size_y; ++y) {
-			if (map->cells[MAP_INDEX(map, x, y)].occ_state > 0) {
-				// cell is occupied, generate point in cloud
-				Eigen::Vector2f gp;
-				gp[0] = MAP_WXGX(map, x) + 0.5 * map->scale;
-				gp[1] = MAP_WYGY(map, y) + 0.5 * map->scale;
+	std::list<NavGraphEdge> remove_edges;
+
+	for (const NavGraphEdge &e : edges) {
+		// only cells around the edge can be close enough
+		const NavGraphNode &from   = e.from_node();
+		const NavGraphNode &to     = e.to_node();
+		const float         margin = max_dist + map->scale;
+
+		int min_x = std::max(0, (int)MAP_GXWX(map, std::min(from.x(), to.x()) - margin));
+		int max_x = std::min(map->size_x - 1, (int)MAP_GXWX(map, std::max(from.x(), to.x()) + margin));
+		int min_y = std::max(0, (int)MAP_GYWY(map, std::min(from.y(), to.y()) - margin));
+		int max_y = std::min(map->size_y - 1, (int)MAP_GYWY(map, std::max(from.y(), to.y()) + margin));
+
+		bool too_close = false;
+		for (int x = min_x; x <= max_x && !too_close; ++x) {
+			for (int y = min_y; y <= max_y && !too_close; ++y) {
+				if (map->cells[MAP_INDEX(map, x, y)].occ_state > 0) {
+					Eigen::Vector2f gp;
+					gp[0] = MAP_WXGX(map, x) + 0.5 * map->scale;
+					gp[1] = MAP_WYGY(map, y) + 0.5 * map->scale;
 
-				for (const NavGraphEdge &e : edges) {
 					try {
 						cart_coord_2d_t poe = e.closest_point_on_edge(gp[0], gp[1]);
 						Eigen::Vector2f p;
@@ -709,16 +766,21 @@ NavGraphGeneratorThread::filter_edges_from_map(float max_dist)
 							                  e.to().c_str(),
 							                  gp[0],
 							                  gp[1]);
-							navgraph->remove_edge(e);
-							break;
+							too_close = true;
 						}
 					} catch (Exception &e) {
 					} // alright, not close
 				}
 			}
 		}
+
+		if (too_close)
+			remove_edges.push_back(e);
+	}
+
+	for (const NavGraphEdge &e : remove_edges) {
+		navgraph->remove_edge(e);
 	}
-	map_free(map);
 }
 
 void
@@ -727,15 +789,16 @@ NavGraphGeneratorThread::filter_nodes_orphans()
 	const std::vector<NavGraphEdge> &edges = navgraph->edges();
 	const std::vector<NavGraphNode> &nodes = navgraph->nodes();
 
+	std::set<std::string> connected;
+	for (const NavGraphEdge &e : edges) {
+		connected.insert(e.from());
+		connected.insert(e.to());
+	}
+
 	std::list<NavGraphNode> remove_nodes;
 
 	for (const NavGraphNode &n : nodes) {
-		std::string                               nname = n.name();
-		std::vector<NavGraphEdge>::const_iterator e =
-		  std::find_if(edges.begin(), edges.end(), [nname](const NavGraphEdge &e) -> bool {
-			  return (e.from() == nname || e.to() == nname);
-		  });
-		if (e == edges.end() && !n.unconnected()) {
+		if (connected.find(n.name()) == connected.end() && !n.unconnected()) {
 			// node is not connected to any other node -> remove
 			remove_nodes.push_back(n);
 		}
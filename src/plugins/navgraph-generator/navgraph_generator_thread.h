@@ -89,7 +89,8 @@ private:
 	                                           fawkes::Message *  message) noexcept;
 
 	ObstacleMap map_obstacles(float line_max_dist);
-	map_t *     load_map(std::vector<std::pair<int, int>> &free_space_indices);
+	map_t *     load_map();
+	bool        compute_base_graph();
 
 	void filter_edges_from_map(float max_dist);
 	void filter_nodes_orphans();
@@ -132,6 +133,14 @@ private:
 	fawkes::cart_coord_2d_t bbox_p1_;
 	fawkes::cart_coord_2d_t bbox_p2_;
 
+	// generated and filtered graph without POIs and edges, reused as long
+	// as only those change between compute requests
+	std::shared_ptr<fawkes::NavGraph> base_graph_;
+	bool                              base_dirty_;
+
+	map_t *                          map_;
+	std::vector<std::pair<int, int>> map_free_space_indices_;
+
 #ifdef HAVE_VISUALIZATION
 	NavGraphGeneratorVisualizationThread *vt_;
 #endif
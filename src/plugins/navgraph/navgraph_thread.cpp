@@ -22,6 +22,7 @@
 #include "navgraph_thread.h"
 
 #include <core/utils/lockptr.h>
+#include <navgraph/binary_navgraph.h>
 #include <navgraph/constraints/constraint_repo.h>
 #include <navgraph/yaml_navgraph.h>
 #include <tf/utils.h>
@@ -103,6 +104,12 @@ NavGraphThread::init()
 	} catch (Exception &e) {
 	} // ignored
 
+	cfg_search_table_max_nodes_ = 0;
+	try {
+		cfg_search_table_max_nodes_ = config->get_uint("/navgraph/search_table_max_nodes");
+	} catch (Exception &e) {
+	} // ignored
+
 	if (config->exists("/navgraph/travel_tolerance") || config->exists("/navgraph/target_tolerance")
 	    || config->exists("/navgraph/orientation_tolerance")
 	    || config->exists("/navgraph/shortcut_tolerance")) {
@@ -130,6 +137,7 @@ NavGraphThread::init()
 	} else {
 		graph_ = LockPtr<NavGraph>(new NavGraph("generated"), /* recursive mutex */ true);
 	}
+	graph_->set_search_table_max_nodes(cfg_search_table_max_nodes_);
 
 	if (!graph_->has_default_property("travel_tolerance")) {
 		throw Exception("Graph must specify travel tolerance");
@@ -439,6 +447,12 @@ NavGraphThread::loop()
 fawkes::LockPtr<fawkes::NavGraph>
 NavGraphThread::load_graph(std::string filename)
 {
+	if (BinaryNavGraph::is_binary_navgraph(filename)) {
+		logger->log_info(name(), "Loading binary graph from %s", filename.c_str());
+		return fawkes::LockPtr<NavGraph>(load_binary_navgraph(filename, cfg_allow_multi_graph_),
+		                                 /* recursive mutex */ true);
+	}
+
 	std::ifstream inf(filename);
 	std::string   firstword;
 	inf >> firstword;
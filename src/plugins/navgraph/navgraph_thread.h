@@ -114,6 +114,8 @@ private:
 	bool  cfg_enable_path_execution_;
 	bool  cfg_allow_multi_graph_;
 
+	unsigned int cfg_search_table_max_nodes_;
+
 	fawkes::NavigatorInterface *nav_if_;
 	fawkes::NavigatorInterface *pp_nav_if_;
 	fawkes::NavPathInterface *  path_if_;
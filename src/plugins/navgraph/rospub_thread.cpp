@@ -213,56 +213,56 @@ bool
 NavGraphROSPubThread::svs_get_pwcosts_cb(fawkes_msgs::NavGraphGetPairwiseCosts::Request & req,
                                          fawkes_msgs::NavGraphGetPairwiseCosts::Response &res)
 {
+	std::vector<fawkes::NavGraphNode> nodes(req.nodes.size());
+	std::vector<std::string>          search_nodes(req.nodes.size());
+	for (unsigned int i = 0; i < req.nodes.size(); ++i) {
+		nodes[i] = navgraph->node(req.nodes[i]);
+		if (!nodes[i].is_valid()) {
+			res.ok     = false;
+			res.errmsg = "Failed to get path for unknown node '" + req.nodes[i] + "'";
+			res.path_costs.clear();
+			return true;
+		}
+		if (nodes[i].unconnected()) {
+			// search from and to the closest connected node instead
+			search_nodes[i] = navgraph->closest_node_to(nodes[i].name()).name();
+		} else {
+			search_nodes[i] = nodes[i].name();
+		}
+	}
+
+	// all costs at once, one search per origin node
+	std::vector<std::vector<float>> costs;
+	try {
+		costs = navgraph->path_cost_matrix(search_nodes, search_nodes);
+	} catch (fawkes::Exception &e) {
+		res.ok     = false;
+		res.errmsg = std::string("Failed to get path costs: ") + e.what_no_backtrace();
+		res.path_costs.clear();
+		return true;
+	}
+
 	for (unsigned int i = 0; i < req.nodes.size(); ++i) {
 		for (unsigned int j = 0; j < req.nodes.size(); ++j) {
 			if (i == j)
 				continue;
 
-			fawkes::NavGraphNode from_node, to_node;
-			try {
-				from_node = navgraph->node(req.nodes[i]);
-				to_node   = navgraph->node(req.nodes[j]);
-			} catch (fawkes::Exception &e) {
+			if (costs[i][j] < 0.) {
 				res.ok     = false;
-				res.errmsg = "Failed to get path from '" + req.nodes[i] + "' to '" + req.nodes[j]
-				             + "': " + e.what_no_backtrace();
-				res.path_costs.clear();
-				return true;
-			}
-
-			fawkes::NavGraphNode start_node, goal_node;
-
-			if (from_node.unconnected()) {
-				start_node = navgraph->closest_node_to(from_node.name());
-				//logger->log_warn(name(), "[F-NavGraph] From node %s is UNCONNECTED, starting instead from %s",
-				//                 from_node.name().c_str(), start_node.name().c_str());
-			} else {
-				start_node = from_node;
-			}
-			if (to_node.unconnected()) {
-				goal_node = navgraph->closest_node_to(to_node.name());
-				//logger->log_warn(name(), "[F-NavGraph] To node %s is UNCONNECTED, ending instead at %s",
-				//                 to_node.name().c_str(), goal_node.name().c_str());
-			} else {
-				goal_node = to_node;
-			}
-			fawkes::NavGraphPath p = navgraph->search_path(start_node, goal_node);
-			if (p.empty()) {
-				res.ok = false;
 				res.errmsg =
-				  "Failed to get path from '" + start_node.name() + "' to '" + goal_node.name() + "'";
+				  "Failed to get path from '" + search_nodes[i] + "' to '" + search_nodes[j] + "'";
 				res.path_costs.clear();
 				return true;
 			}
 			fawkes_msgs::NavGraphPathCost pc;
 			pc.from_node = req.nodes[i];
 			pc.to_node   = req.nodes[j];
-			pc.cost      = p.cost();
-			if (from_node.unconnected()) {
-				pc.cost += navgraph->cost(from_node, start_node);
+			pc.cost      = costs[i][j];
+			if (nodes[i].unconnected()) {
+				pc.cost += navgraph->cost(nodes[i], navgraph->node(search_nodes[i]));
 			}
-			if (to_node.unconnected()) {
-				pc.cost += navgraph->cost(goal_node, to_node);
+			if (nodes[j].unconnected()) {
+				pc.cost += navgraph->cost(navgraph->node(search_nodes[j]), nodes[j]);
 			}
 			res.path_costs.push_back(pc);
 		}
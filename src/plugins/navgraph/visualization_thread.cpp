@@ -46,6 +46,7 @@ NavGraphVisualizationThread::NavGraphVisualizationThread()
 : fawkes::Thread("NavGraphVisualizationThread", Thread::OPMODE_WAITFORWAKEUP),
   fawkes::BlockedTimingAspect(fawkes::BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE)
 {
+	set_blocked_timing_criticality(CRITICALITY_LOW);
 	graph_ = NULL;
 	crepo_ = NULL;
 }
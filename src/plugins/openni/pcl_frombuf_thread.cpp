@@ -61,8 +61,14 @@ OpenNiPclOnlyThread::init()
 	width_  = pcl_buf_->width();
 	height_ = pcl_buf_->height();
 
+	cfg_compact_ = false;
+	try {
+		cfg_compact_ = config->get_bool("/plugins/openni-pcl-frombuf/compact");
+	} catch (Exception &e) {
+	}
+
 	pcl_           = new pcl::PointCloud<pcl::PointXYZ>();
-	pcl_->is_dense = false;
+	pcl_->is_dense = cfg_compact_;
 	pcl_->width    = width_;
 	pcl_->height   = height_;
 	pcl_->points.resize((size_t)width_ * (size_t)height_);
@@ -95,13 +101,28 @@ OpenNiPclOnlyThread::loop()
 			pcl.header.seq += 1;
 			pcl_utils::set_time(pcl_, capture_time);
 
-			unsigned int idx = 0;
-			for (unsigned int h = 0; h < height_; ++h) {
-				for (unsigned int w = 0; w < width_; ++w, ++idx, ++pclbuf) {
-					// Fill in XYZ
-					pcl.points[idx].x = pclbuf->x;
-					pcl.points[idx].y = pclbuf->y;
-					pcl.points[idx].z = pclbuf->z;
+			const unsigned int num_pixels = width_ * height_;
+			if (cfg_compact_) {
+				// invalid measurements have been stored as all zero,
+				// valid ones always have a positive distance
+				pcl.points.resize(num_pixels);
+				unsigned int num_points = 0;
+				for (unsigned int i = 0; i < num_pixels; ++i, ++pclbuf) {
+					if (pclbuf->x != 0.f) {
+						pcl::PointXYZ &p = pcl.points[num_points++];
+						p.x              = pclbuf->x;
+						p.y              = pclbuf->y;
+						p.z              = pclbuf->z;
+					}
+				}
+				pcl.points.resize(num_points);
+				pcl.width  = num_points;
+				pcl.height = 1;
+			} else {
+				for (unsigned int i = 0; i < num_pixels; ++i, ++pclbuf) {
+					pcl.points[i].x = pclbuf->x;
+					pcl.points[i].y = pclbuf->y;
+					pcl.points[i].z = pclbuf->z;
 				}
 			}
 		}
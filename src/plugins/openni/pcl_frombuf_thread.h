@@ -73,6 +73,7 @@ private:
 	fawkes::Time last_capture_time_;
 	unsigned int width_;
 	unsigned int height_;
+	bool         cfg_compact_;
 };
 
 #endif
@@ -29,6 +29,7 @@
 #include <fvutils/base/types.h>
 #include <fvutils/color/colorspaces.h>
 #include <fvutils/color/rgb.h>
+#include <fvutils/color/simd.h>
 #include <fvutils/ipc/shm_image.h>
 #ifdef HAVE_PCL
 #	include <pcl_utils/utils.h>
@@ -144,9 +145,19 @@ OpenNiPointCloudThread::init()
 	} else {
 		focal_length_ = ((float)zpd / pixel_size) * scale;
 	}
-	foc_const_ = 0.001 / focal_length_;
-	center_x_  = (width_ / 2.) - .5f;
-	center_y_  = (height_ / 2.) - .5f;
+	center_x_ = (width_ / 2.) - .5f;
+	center_y_ = (height_ / 2.) - .5f;
+
+	// view ray through each pixel, Y depends only on the column and Z
+	// only on the line of the pixel
+	ray_y_.resize(width_);
+	for (unsigned int w = 0; w < width_; ++w) {
+		ray_y_[w] = -(w - center_x_) / focal_length_;
+	}
+	ray_z_.resize(height_);
+	for (unsigned int h = 0; h < height_; ++h) {
+		ray_z_[h] = -(h - center_y_) / focal_length_;
+	}
 
 	image_gen_->StartGenerating();
 	depth_gen_->StartGenerating();
@@ -192,16 +203,26 @@ OpenNiPointCloudThread::init()
 	} catch (Exception &e) {
 	}
 
+	cfg_compact_ = false;
+	try {
+		cfg_compact_ = config->get_bool("/plugins/openni-pointcloud/compact");
+	} catch (Exception &e) {
+	}
+
 	if (cfg_generate_pcl_) {
+		if (cfg_compact_) {
+			compact_indices_.resize((size_t)width_ * (size_t)height_);
+		}
+
 		pcl_xyz_           = new pcl::PointCloud<pcl::PointXYZ>();
-		pcl_xyz_->is_dense = false;
+		pcl_xyz_->is_dense = cfg_compact_;
 		pcl_xyz_->width    = width_;
 		pcl_xyz_->height   = height_;
 		pcl_xyz_->points.resize((size_t)width_ * (size_t)height_);
 		pcl_xyz_->header.frame_id = cfg_register_depth_image_ ? cfg_frame_image_ : cfg_frame_depth_;
 
 		pcl_xyzrgb_           = new pcl::PointCloud<pcl::PointXYZRGB>();
-		pcl_xyzrgb_->is_dense = false;
+		pcl_xyzrgb_->is_dense = cfg_compact_;
 		pcl_xyzrgb_->width    = width_;
 		pcl_xyzrgb_->height   = height_;
 		pcl_xyzrgb_->points.resize((size_t)width_ * (size_t)height_);
@@ -233,30 +254,61 @@ OpenNiPointCloudThread::finalize()
 	delete capture_start_;
 }
 
-void
-OpenNiPointCloudThread::fill_xyz_no_pcl(fawkes::Time &ts, const XnDepthPixel *const depth_data)
+/** Convert depth image to points.
+ * The view ray of each pixel is given by the precomputed factors of its
+ * column and line, the points are computed from the depth along these
+ * rays without any division.
+ * @param depth_data depth image
+ * @param points receives the X, Y, and Z coordinates as consecutive
+ * floats for each point, further fields are not touched
+ * @param point_step bytes from one point to the next in @p points
+ * @param compact false to write one point per pixel with all coordinates
+ * of invalid measurements zero, true to skip invalid measurements and
+ * record the pixel of each point in compact_indices_
+ * @return number of points written
+ */
+unsigned int
+OpenNiPointCloudThread::convert_depth(const XnDepthPixel *const depth_data,
+                                      float *                   points,
+                                      unsigned int              point_step,
+                                      bool                      compact)
 {
-	pcl_xyz_buf_->lock_for_write();
-	pcl_xyz_buf_->set_capture_time(&ts);
+	// values beyond 16 bit cannot occur in the image
+	uint16_t no_sample = (no_sample_value_ <= 0xFFFF) ? no_sample_value_ : 0;
+	uint16_t shadow    = (shadow_value_ <= 0xFFFF) ? shadow_value_ : 0;
 
-	pcl_point_t *pclbuf = (pcl_point_t *)pcl_xyz_buf_->buffer();
-
-	unsigned int idx = 0;
+	unsigned char *p     = (unsigned char *)points;
+	unsigned int   count = 0;
 	for (unsigned int h = 0; h < height_; ++h) {
-		for (unsigned int w = 0; w < width_; ++w, ++idx, ++pclbuf) {
-			// Check for invalid measurements
-			if (depth_data[idx] == 0 || depth_data[idx] == no_sample_value_
-			    || depth_data[idx] == shadow_value_) {
-				// invalid
-				pclbuf->x = pclbuf->y = pclbuf->z = 0.f;
-			} else {
-				// Fill in XYZ
-				pclbuf->x = depth_data[idx] * 0.001f;
-				pclbuf->y = -(w - center_x_) * depth_data[idx] * foc_const_;
-				pclbuf->z = -(h - center_y_) * depth_data[idx] * foc_const_;
+		unsigned int first = count;
+		count += depth_to_points_simd(depth_data + (size_t)h * width_,
+		                              width_,
+		                              &ray_y_[0],
+		                              ray_z_[h],
+		                              0.001f,
+		                              no_sample,
+		                              shadow,
+		                              (float *)(p + (size_t)first * point_step),
+		                              point_step,
+		                              compact,
+		                              compact ? &compact_indices_[first] : NULL);
+		if (compact) {
+			// indices are relative to the line
+			for (unsigned int i = first; i < count; ++i) {
+				compact_indices_[i] += h * width_;
 			}
 		}
 	}
+	return count;
+}
+
+void
+OpenNiPointCloudThread::fill_xyz_no_pcl(fawkes::Time &ts, const XnDepthPixel *const depth_data)
+{
+	pcl_xyz_buf_->lock_for_write();
+	pcl_xyz_buf_->set_capture_time(&ts);
+
+	convert_depth(depth_data, (float *)pcl_xyz_buf_->buffer(), sizeof(pcl_point_t));
 
 	pcl_xyz_buf_->unlock();
 }
@@ -267,24 +319,7 @@ OpenNiPointCloudThread::fill_xyzrgb_no_pcl(fawkes::Time &ts, const XnDepthPixel
 	pcl_xyzrgb_buf_->lock_for_write();
 	pcl_xyzrgb_buf_->set_capture_time(&ts);
 
-	pcl_point_xyzrgb_t *pclbuf_rgb = (pcl_point_xyzrgb_t *)pcl_xyzrgb_buf_->buffer();
-
-	unsigned int idx = 0;
-	for (unsigned int h = 0; h < height_; ++h) {
-		for (unsigned int w = 0; w < width_; ++w, ++idx, ++pclbuf_rgb) {
-			// Check for invalid measurements
-			if (depth_data[idx] == 0 || depth_data[idx] == no_sample_value_
-			    || depth_data[idx] == shadow_value_) {
-				// invalid
-				pclbuf_rgb->x = pclbuf_rgb->y = pclbuf_rgb->z = 0.f;
-			} else {
-				// Fill in XYZ
-				pclbuf_rgb->x = depth_data[idx] * 0.001f;
-				pclbuf_rgb->y = -(w - center_x_) * depth_data[idx] * foc_const_;
-				pclbuf_rgb->z = -(h - center_y_) * depth_data[idx] * foc_const_;
-			}
-		}
-	}
+	convert_depth(depth_data, (float *)pcl_xyzrgb_buf_->buffer(), sizeof(pcl_point_xyzrgb_t));
 
 	fill_rgb_no_pcl();
 
@@ -301,26 +336,8 @@ OpenNiPointCloudThread::fill_xyz_xyzrgb_no_pcl(fawkes::Time &            ts,
 	pcl_xyzrgb_buf_->lock_for_write();
 	pcl_xyzrgb_buf_->set_capture_time(&ts);
 
-	pcl_point_xyzrgb_t *pclbuf_rgb = (pcl_point_xyzrgb_t *)pcl_xyzrgb_buf_->buffer();
-	pcl_point_t *       pclbuf_xyz = (pcl_point_t *)pcl_xyz_buf_->buffer();
-
-	unsigned int idx = 0;
-	for (unsigned int h = 0; h < height_; ++h) {
-		for (unsigned int w = 0; w < width_; ++w, ++idx, ++pclbuf_rgb, ++pclbuf_xyz) {
-			// Check for invalid measurements
-			if (depth_data[idx] == 0 || depth_data[idx] == no_sample_value_
-			    || depth_data[idx] == shadow_value_) {
-				// invalid
-				pclbuf_rgb->x = pclbuf_rgb->y = pclbuf_rgb->z = 0.f;
-				pclbuf_xyz->x = pclbuf_xyz->y = pclbuf_xyz->z = 0.f;
-			} else {
-				// Fill in XYZ
-				pclbuf_rgb->x = pclbuf_xyz->x = depth_data[idx] * 0.001f;
-				pclbuf_rgb->y = pclbuf_xyz->y = -(w - center_x_) * depth_data[idx] * foc_const_;
-				pclbuf_rgb->z = pclbuf_xyz->z = -(h - center_y_) * depth_data[idx] * foc_const_;
-			}
-		}
-	}
+	convert_depth(depth_data, (float *)pcl_xyz_buf_->buffer(), sizeof(pcl_point_t));
+	convert_depth(depth_data, (float *)pcl_xyzrgb_buf_->buffer(), sizeof(pcl_point_xyzrgb_t));
 
 	fill_rgb_no_pcl();
 
@@ -345,7 +362,7 @@ OpenNiPointCloudThread::fill_rgb_no_pcl()
 	pcl_point_xyzrgb_t *pclbuf_rgb = (pcl_point_xyzrgb_t *)pcl_xyzrgb_buf_->buffer();
 	RGB_t *             imagebuf   = (RGB_t *)image_rgb_buf_->buffer();
 
-	for (unsigned int i = 0; i < width_ * height_; ++i) {
+	for (unsigned int i = 0; i < width_ * height_; ++i, ++pclbuf_rgb) {
 		pclbuf_rgb->r = imagebuf[i].R;
 		pclbuf_rgb->g = imagebuf[i].G;
 		pclbuf_rgb->b = imagebuf[i].B;
@@ -353,6 +370,29 @@ OpenNiPointCloudThread::fill_rgb_no_pcl()
 }
 
 #ifdef HAVE_PCL
+/** Fill point cloud from depth image.
+ * The cloud is organized, or in compact mode contains only the valid
+ * measurements and compact_indices_ the pixel of each point. The points
+ * are written directly into the memory of the cloud, which is only
+ * allocated once.
+ * @param pcl point cloud to fill
+ * @param depth_data depth image
+ */
+template <typename PointT>
+void
+OpenNiPointCloudThread::fill_pcl(pcl::PointCloud<PointT> &pcl, const XnDepthPixel *const depth_data)
+{
+	if (cfg_compact_) {
+		pcl.points.resize((size_t)width_ * (size_t)height_);
+		unsigned int num_points = convert_depth(depth_data, &pcl.points[0].x, sizeof(PointT), true);
+		pcl.points.resize(num_points);
+		pcl.width  = num_points;
+		pcl.height = 1;
+	} else {
+		convert_depth(depth_data, &pcl.points[0].x, sizeof(PointT));
+	}
+}
+
 void
 OpenNiPointCloudThread::fill_xyz(fawkes::Time &ts, const XnDepthPixel *const depth_data)
 {
@@ -363,25 +403,8 @@ OpenNiPointCloudThread::fill_xyz(fawkes::Time &ts, const XnDepthPixel *const dep
 	pcl_xyz_buf_->lock_for_write();
 	pcl_xyz_buf_->set_capture_time(&ts);
 
-	pcl_point_t *pclbuf = (pcl_point_t *)pcl_xyz_buf_->buffer();
-
-	unsigned int idx = 0;
-	for (unsigned int h = 0; h < height_; ++h) {
-		for (unsigned int w = 0; w < width_; ++w, ++idx, ++pclbuf) {
-			// Check for invalid measurements
-			if (depth_data[idx] == 0 || depth_data[idx] == no_sample_value_
-			    || depth_data[idx] == shadow_value_) {
-				// invalid
-				pclbuf->x = pclbuf->y = pclbuf->z = 0.f;
-				pcl.points[idx].x = pcl.points[idx].y = pcl.points[idx].z = 0.f;
-			} else {
-				// Fill in XYZ
-				pclbuf->x = pcl.points[idx].x = depth_data[idx] * 0.001f;
-				pclbuf->y = pcl.points[idx].y = -(w - center_x_) * depth_data[idx] * foc_const_;
-				pclbuf->z = pcl.points[idx].z = -(h - center_y_) * depth_data[idx] * foc_const_;
-			}
-		}
-	}
+	convert_depth(depth_data, (float *)pcl_xyz_buf_->buffer(), sizeof(pcl_point_t));
+	fill_pcl(pcl, depth_data);
 
 	pcl_xyz_buf_->unlock();
 }
@@ -396,25 +419,8 @@ OpenNiPointCloudThread::fill_xyzrgb(fawkes::Time &ts, const XnDepthPixel *const
 	pcl_xyzrgb_buf_->lock_for_write();
 	pcl_xyzrgb_buf_->set_capture_time(&ts);
 
-	pcl_point_xyzrgb_t *pclbuf_rgb = (pcl_point_xyzrgb_t *)pcl_xyzrgb_buf_->buffer();
-
-	unsigned int idx = 0;
-	for (unsigned int h = 0; h < height_; ++h) {
-		for (unsigned int w = 0; w < width_; ++w, ++idx, ++pclbuf_rgb) {
-			// Check for invalid measurements
-			if (depth_data[idx] == 0 || depth_data[idx] == no_sample_value_
-			    || depth_data[idx] == shadow_value_) {
-				// invalid
-				pclbuf_rgb->x = pclbuf_rgb->y = pclbuf_rgb->z = 0.f;
-				pcl_rgb.points[idx].x = pcl_rgb.points[idx].y = pcl_rgb.points[idx].z = 0.f;
-			} else {
-				// Fill in XYZ
-				pclbuf_rgb->x = pcl_rgb.points[idx].x = depth_data[idx] * 0.001f;
-				pclbuf_rgb->y = pcl_rgb.points[idx].y = -(w - center_x_) * depth_data[idx] * foc_const_;
-				pclbuf_rgb->z = pcl_rgb.points[idx].z = -(h - center_y_) * depth_data[idx] * foc_const_;
-			}
-		}
-	}
+	convert_depth(depth_data, (float *)pcl_xyzrgb_buf_->buffer(), sizeof(pcl_point_xyzrgb_t));
+	fill_pcl(pcl_rgb, depth_data);
 
 	fill_rgb(pcl_rgb);
 
@@ -438,32 +444,11 @@ OpenNiPointCloudThread::fill_xyz_xyzrgb(fawkes::Time &ts, const XnDepthPixel *co
 	pcl_xyzrgb_buf_->lock_for_write();
 	pcl_xyzrgb_buf_->set_capture_time(&ts);
 
-	pcl_point_xyzrgb_t *pclbuf_rgb = (pcl_point_xyzrgb_t *)pcl_xyzrgb_buf_->buffer();
-	pcl_point_t *       pclbuf_xyz = (pcl_point_t *)pcl_xyz_buf_->buffer();
-
-	unsigned int idx = 0;
-	for (unsigned int h = 0; h < height_; ++h) {
-		for (unsigned int w = 0; w < width_; ++w, ++idx, ++pclbuf_rgb, ++pclbuf_xyz) {
-			// Check for invalid measurements
-			if (depth_data[idx] == 0 || depth_data[idx] == no_sample_value_
-			    || depth_data[idx] == shadow_value_) {
-				// invalid
-				pclbuf_rgb->x = pclbuf_rgb->y = pclbuf_rgb->z = 0.f;
-				pcl_rgb.points[idx].x = pcl_rgb.points[idx].y = pcl_rgb.points[idx].z = 0.f;
-
-				pclbuf_xyz->x = pclbuf_xyz->y = pclbuf_xyz->z = 0.f;
-				pcl_xyz.points[idx].x = pcl_xyz.points[idx].y = pcl_xyz.points[idx].z = 0.f;
-			} else {
-				// Fill in XYZ
-				pclbuf_rgb->x = pcl_rgb.points[idx].x = pclbuf_xyz->x = pcl_xyz.points[idx].x =
-				  depth_data[idx] * 0.001f;
-				pclbuf_rgb->y = pcl_rgb.points[idx].y = pclbuf_xyz->y = pcl_xyz.points[idx].y =
-				  -(w - center_x_) * depth_data[idx] * foc_const_;
-				pclbuf_rgb->z = pcl_rgb.points[idx].z = pclbuf_xyz->z = pcl_xyz.points[idx].z =
-				  -(h - center_y_) * depth_data[idx] * foc_const_;
-			}
-		}
-	}
+	convert_depth(depth_data, (float *)pcl_xyz_buf_->buffer(), sizeof(pcl_point_t));
+	convert_depth(depth_data, (float *)pcl_xyzrgb_buf_->buffer(), sizeof(pcl_point_xyzrgb_t));
+	fill_pcl(pcl_xyz, depth_data);
+	// last, compact indices are used for the colors
+	fill_pcl(pcl_rgb, depth_data);
 
 	fill_rgb(pcl_rgb);
 
@@ -488,10 +473,17 @@ OpenNiPointCloudThread::fill_rgb(pcl::PointCloud<pcl::PointXYZRGB> &pcl_rgb)
 	pcl_point_xyzrgb_t *pclbuf_rgb = (pcl_point_xyzrgb_t *)pcl_xyzrgb_buf_->buffer();
 	RGB_t *             imagebuf   = (RGB_t *)image_rgb_buf_->buffer();
 
-	for (unsigned int i = 0; i < width_ * height_; ++i) {
-		pclbuf_rgb->r = pcl_rgb.points[i].r = imagebuf[i].R;
-		pclbuf_rgb->g = pcl_rgb.points[i].g = imagebuf[i].G;
-		pclbuf_rgb->b = pcl_rgb.points[i].b = imagebuf[i].B;
+	for (unsigned int i = 0; i < width_ * height_; ++i, ++pclbuf_rgb) {
+		pclbuf_rgb->r = imagebuf[i].R;
+		pclbuf_rgb->g = imagebuf[i].G;
+		pclbuf_rgb->b = imagebuf[i].B;
+	}
+
+	for (unsigned int i = 0; i < pcl_rgb.points.size(); ++i) {
+		const RGB_t &c      = imagebuf[cfg_compact_ ? compact_indices_[i] : i];
+		pcl_rgb.points[i].r = c.R;
+		pcl_rgb.points[i].g = c.G;
+		pcl_rgb.points[i].b = c.B;
 	}
 }
 
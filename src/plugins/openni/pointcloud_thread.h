@@ -46,6 +46,7 @@
 #endif
 #include <XnCppWrapper.h>
 #include <map>
+#include <vector>
 
 namespace fawkes {
 class Time;
@@ -89,7 +90,15 @@ private:
 	void fill_xyz_xyzrgb_no_pcl(fawkes::Time &ts, const XnDepthPixel *const data);
 	void fill_rgb_no_pcl();
 
+	unsigned int convert_depth(const XnDepthPixel *const depth_data,
+	                           float *                   points,
+	                           unsigned int              point_step,
+	                           bool                      compact = false);
+
 #ifdef HAVE_PCL
+	template <typename PointT>
+	void fill_pcl(pcl::PointCloud<PointT> &pcl, const XnDepthPixel *const depth_data);
+
 	void fill_xyz(fawkes::Time &ts, const XnDepthPixel *const depth_data);
 	void fill_xyzrgb(fawkes::Time &ts, const XnDepthPixel *const depth_data);
 	void fill_xyz_xyzrgb(fawkes::Time &ts, const XnDepthPixel *const depth_data);
@@ -111,12 +120,16 @@ private:
 	firevision::SharedMemoryImageBuffer *image_rgb_buf_;
 
 	float        focal_length_;
-	float        foc_const_; // focal length constant used in conversion
 	float        center_x_;
 	float        center_y_;
 	unsigned int width_;
 	unsigned int height_;
 
+	// view ray factors per column and line, see convert_depth()
+	std::vector<float>        ray_y_;
+	std::vector<float>        ray_z_;
+	std::vector<unsigned int> compact_indices_;
+
 	XnUInt64 no_sample_value_;
 	XnUInt64 shadow_value_;
 
@@ -127,6 +140,7 @@ private:
 
 #ifdef HAVE_PCL
 	bool cfg_generate_pcl_;
+	bool cfg_compact_;
 
 	fawkes::RefPtr<pcl::PointCloud<pcl::PointXYZ>>    pcl_xyz_;
 	fawkes::RefPtr<pcl::PointCloud<pcl::PointXYZRGB>> pcl_xyzrgb_;
@@ -20,8 +20,8 @@
 
 // this must come first due to a define of enqueue in OpenPRS' slistPack_f.h
 #include <config/netconf.h>
+#include <navgraph/binary_navgraph.h>
 #include <navgraph/navgraph.h>
-#include <navgraph/yaml_navgraph.h>
 #include <netcomm/fawkes/client.h>
 #include <plugins/openprs/mod_utils.h>
 
@@ -48,7 +48,7 @@ action_navgraph_load(TermList terms)
 			graph_file = std::string(CONFDIR) + "/" + graph_file;
 		}
 
-		g_navgraph = load_yaml_navgraph(graph_file);
+		g_navgraph = load_navgraph(graph_file);
 
 		const std::vector<NavGraphNode> &nodes = g_navgraph->nodes();
 		const std::vector<NavGraphEdge> &edges = g_navgraph->edges();
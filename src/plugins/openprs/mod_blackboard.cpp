@@ -30,17 +30,44 @@
 #include <oprs_f-pub.h>
 #include <slistPack_f.h>
 
+#include <cstring>
+#include <vector>
+
 using namespace fawkes;
 
 extern "C" void finalize();
 
+/// @cond INTERNALS
+/** Pre-resolved fields and last posted data of an interface. */
+typedef struct
+{
+	std::map<std::string, InterfaceFieldIterator> fields;
+	std::vector<char>                             last_data;
+} InterfaceState;
+/// @endcond
+
 // Global variables
-BlackBoard *                       g_blackboard = NULL;
-std::map<std::string, Interface *> g_interfaces_read;
-std::map<std::string, Interface *> g_interfaces_write;
-Symbol                             g_bb_read_sym;
-Symbol                             g_bb_write_sym;
-Symbol                             g_bb_data_sym;
+BlackBoard *                          g_blackboard = NULL;
+std::map<std::string, Interface *>    g_interfaces_read;
+std::map<std::string, Interface *>    g_interfaces_write;
+std::map<std::string, InterfaceState> g_interface_states;
+Symbol                                g_bb_read_sym;
+Symbol                                g_bb_write_sym;
+Symbol                                g_bb_data_sym;
+Symbol                                g_bb_changed_sym;
+
+static InterfaceState &
+interface_state(const std::string &uid, Interface *i)
+{
+	InterfaceState &s = g_interface_states[uid];
+	if (s.fields.empty()) {
+		InterfaceFieldIterator f, f_end = i->fields_end();
+		for (f = i->fields(); f != f_end; ++f) {
+			s.fields.insert(std::make_pair(std::string(f.get_name()), f));
+		}
+	}
+	return s;
+}
 
 extern "C" Term *
 action_blackboard_open(TermList terms)
@@ -147,6 +174,7 @@ action_blackboard_close(TermList terms)
 	if (g_interfaces_read.find(uid) != g_interfaces_read.end()) {
 		try {
 			printf("Closing reading interface %s::%s\n", type->u.string, id->u.string);
+			g_interface_states.erase(uid);
 			g_blackboard->close(g_interfaces_read[uid]);
 			g_interfaces_read.erase(uid);
 		} catch (Exception &e) {
@@ -160,6 +188,7 @@ action_blackboard_close(TermList terms)
 	} else if (g_interfaces_write.find(uid) != g_interfaces_write.end()) {
 		try {
 			printf("Closing writing interface %s::%s\n", type->u.string, id->u.string);
+			g_interface_states.erase(uid);
 			g_blackboard->close(g_interfaces_write[uid]);
 			g_interfaces_write.erase(uid);
 		} catch (Exception &e) {
@@ -258,66 +287,77 @@ action_blackboard_print(TermList terms)
 	ACTION_FINAL();
 }
 
-#define ADD_ARRAY(src_type, target_type, array_type)                                            \
+#define ARRAY_TERM(src_type, target_type, array_type)                                          \
 	do {                                                                                          \
 		target_type * array     = (target_type *)OPRS_MALLOC(sizeof(target_type) * f.get_length()); \
 		src_type##_t *src_array = f.get_##src_type##s();                                            \
 		for (unsigned int j = 0; j < f.get_length(); ++j)                                           \
 			array[j] = src_array[j];                                                                  \
-		data = l_add_to_tail(data, make_##array_type##_array_from_array(f.get_length(), array));    \
+		return make_##array_type##_array_from_array(f.get_length(), array);                         \
 	} while (0);
 
 #define BUILD_FUNC(singular_type) build_##singular_type
 #define GET_FUNC(src_type) get_##src_type
 
-#define ADD_NUM_DATA(src_type, target_type, array_type, singular_type)               \
-	do {                                                                               \
-		if (f.get_length() > 1) {                                                        \
-			ADD_ARRAY(src_type, target_type, array_type);                                  \
-		} else {                                                                         \
-			data = l_add_to_tail(data, BUILD_FUNC(singular_type)(f.GET_FUNC(src_type)())); \
-		}                                                                                \
+#define NUM_TERM(src_type, target_type, array_type, singular_type) \
+	do {                                                             \
+		if (f.get_length() > 1) {                                      \
+			ARRAY_TERM(src_type, target_type, array_type);               \
+		} else {                                                       \
+			return BUILD_FUNC(singular_type)(f.GET_FUNC(src_type)());    \
+		}                                                              \
 	} while (0);
 
+static Term *
+field_term(InterfaceFieldIterator &f)
+{
+	switch (f.get_type()) {
+	case IFT_BOOL: return build_id(f.get_bool() ? lisp_t_sym : nil_sym);
+	case IFT_INT8: NUM_TERM(int8, int, int, integer);
+	case IFT_UINT8: NUM_TERM(uint8, int, int, integer);
+	case IFT_INT16: NUM_TERM(int16, int, int, integer);
+	case IFT_UINT16: NUM_TERM(uint16, int, int, integer);
+	case IFT_INT32: NUM_TERM(int32, int, int, integer);
+	case IFT_UINT32: NUM_TERM(uint32, double, float, long_long);
+	case IFT_INT64: NUM_TERM(int64, double, float, long_long);
+	case IFT_UINT64: NUM_TERM(uint64, double, float, long_long);
+	case IFT_FLOAT: NUM_TERM(float, double, float, float);
+	case IFT_DOUBLE: NUM_TERM(double, double, float, float);
+	case IFT_STRING: return build_string(f.get_value_string());
+	case IFT_BYTE: NUM_TERM(uint8, int, int, integer);
+	case IFT_ENUM: return build_string(f.get_value_string());
+	}
+	return build_nil();
+}
+
+static TermList
+interface_header(Interface *i)
+{
+	const Time *t = i->timestamp();
+
+	TermList tl = sl_make_slist();
+	tl          = build_term_list(tl, build_string("type"));
+	tl          = build_term_list(tl, build_string(i->type()));
+	tl          = build_term_list(tl, build_string("id"));
+	tl          = build_term_list(tl, build_string(i->id()));
+	tl          = build_term_list(tl, build_string("time"));
+	tl          = build_term_list(tl, build_long_long(t->get_sec()));
+	tl          = build_term_list(tl, build_long_long(t->get_usec()));
+	return tl;
+}
+
 static void
 post_interface(Interface *i)
 {
 	i->read();
 	if (i->refreshed()) {
-		const Time *t = i->timestamp();
-
-		TermList tl = sl_make_slist();
-		tl          = build_term_list(tl, build_string("type"));
-		tl          = build_term_list(tl, build_string(i->type()));
-		tl          = build_term_list(tl, build_string("id"));
-		tl          = build_term_list(tl, build_string(i->id()));
-		tl          = build_term_list(tl, build_string("time"));
-		tl          = build_term_list(tl, build_long_long(t->get_sec()));
-		tl          = build_term_list(tl, build_long_long(t->get_usec()));
+		TermList tl = interface_header(i);
 
 		L_List                 data = l_nil;
 		InterfaceFieldIterator f, f_end = i->fields_end();
 		for (f = i->fields(); f != f_end; ++f) {
 			data = l_add_to_tail(data, build_string(f.get_name()));
-
-			switch (f.get_type()) {
-			case IFT_BOOL:
-				data = l_add_to_tail(data, build_id(f.get_bool() ? lisp_t_sym : nil_sym));
-				break;
-			case IFT_INT8: ADD_NUM_DATA(int8, int, int, integer); break;
-			case IFT_UINT8: ADD_NUM_DATA(uint8, int, int, integer); break;
-			case IFT_INT16: ADD_NUM_DATA(int16, int, int, integer); break;
-			case IFT_UINT16: ADD_NUM_DATA(uint16, int, int, integer); break;
-			case IFT_INT32: ADD_NUM_DATA(int32, int, int, integer); break;
-			case IFT_UINT32: ADD_NUM_DATA(uint32, double, float, long_long); break;
-			case IFT_INT64: ADD_NUM_DATA(int64, double, float, long_long); break;
-			case IFT_UINT64: ADD_NUM_DATA(uint64, double, float, long_long); break;
-			case IFT_FLOAT: ADD_NUM_DATA(float, double, float, float); break;
-			case IFT_DOUBLE: ADD_NUM_DATA(double, double, float, float); break;
-			case IFT_STRING: data = l_add_to_tail(data, build_string(f.get_value_string())); break;
-			case IFT_BYTE: ADD_NUM_DATA(uint8, int, int, integer); break;
-			case IFT_ENUM: data = l_add_to_tail(data, build_string(f.get_value_string())); break;
-			}
+			data = l_add_to_tail(data, field_term(f));
 		}
 
 		tl = build_term_list(tl, build_l_list(data));
@@ -325,6 +365,41 @@ post_interface(Interface *i)
 	}
 }
 
+/** Post fields which changed since the last call as bb-changed fact.
+ * Reading only copies the interface if it has been written, see
+ * Interface::read_if_changed(). The first call posts all fields. Nothing
+ * is posted if no field has been modified.
+ */
+static void
+post_interface_changes(const std::string &uid, Interface *i)
+{
+	InterfaceState &s = interface_state(uid, i);
+
+	i->read();
+	const char *data_now = (const char *)i->datachunk();
+	if (s.last_data.size() == i->datasize()
+	    && memcmp(&s.last_data[0], data_now, s.last_data.size()) == 0) {
+		return;
+	}
+
+	const char *data_last = s.last_data.empty() ? NULL : &s.last_data[0];
+	L_List      data      = l_nil;
+	for (auto &f : s.fields) {
+		size_t offset = (const char *)f.second.get_value() - data_now;
+		if (data_last
+		    && memcmp(data_last + offset, data_now + offset, f.second.get_data_size()) == 0) {
+			continue;
+		}
+		data = l_add_to_tail(data, build_string(f.second.get_name()));
+		data = l_add_to_tail(data, field_term(f.second));
+	}
+	s.last_data.assign(data_now, data_now + i->datasize());
+
+	TermList tl = interface_header(i);
+	tl          = build_term_list(tl, build_l_list(data));
+	add_external_fact((char *)"bb-changed", tl);
+}
+
 extern "C" Term *
 action_blackboard_read_all(TermList terms)
 {
@@ -391,6 +466,65 @@ action_blackboard_read(TermList terms)
 	ACTION_FINAL();
 }
 
+extern "C" Term *
+action_blackboard_read_changed(TermList terms)
+{
+	try {
+		for (auto &if_entry : g_interfaces_read) {
+			post_interface_changes(if_entry.first, if_entry.second);
+		}
+	} catch (Exception &e) {
+		fprintf(stderr, "Error[bb-read-changed]: read failed: %s\n", e.what_no_backtrace());
+		ACTION_FAIL();
+	}
+	ACTION_FINAL();
+}
+
+/** Get the current value of a field of an opened interface.
+ * Fields are resolved once per interface, the value is taken from the
+ * data of the last read, no fact is posted. Returns nil if the field
+ * does not exist. */
+extern "C" Term *
+func_blackboard_get(TermList terms)
+{
+	int terms_len = sl_slist_length(terms);
+	if (terms_len != 3) {
+		fprintf(stderr,
+		        "Error[bb-get]: invalid number of "
+		        "arguments: req 3, got %i\n",
+		        terms_len);
+		return build_nil();
+	}
+
+	Term *type  = (Term *)get_list_pos(terms, 1);
+	Term *id    = (Term *)get_list_pos(terms, 2);
+	Term *field = (Term *)get_list_pos(terms, 3);
+	if (type->type != STRING || id->type != STRING || field->type != STRING) {
+		fprintf(stderr, "Error[bb-get]: interface type, ID, and field must be STRINGs\n");
+		return build_nil();
+	}
+
+	std::string uid = std::string(type->u.string) + "::" + id->u.string;
+
+	Interface *i = NULL;
+	if (g_interfaces_read.find(uid) != g_interfaces_read.end()) {
+		i = g_interfaces_read[uid];
+	} else if (g_interfaces_write.find(uid) != g_interfaces_write.end()) {
+		i = g_interfaces_write[uid];
+	} else {
+		fprintf(stderr, "Error[bb-get]: interface %s has not been opened\n", uid.c_str());
+		return build_nil();
+	}
+
+	InterfaceState &s = interface_state(uid, i);
+	auto            f = s.fields.find(field->u.string);
+	if (f == s.fields.end()) {
+		fprintf(stderr, "Error[bb-get]: interface %s has no field %s\n", uid.c_str(), field->u.string);
+		return build_nil();
+	}
+	return field_term(f->second);
+}
+
 /** Searches for a given entry in the bb-date object
  *  specified by String. Returns nil if entry not present */
 extern "C" Term *
@@ -459,13 +593,17 @@ init()
 
 	g_bb_read_sym  = declare_atom("BB-READ");
 	g_bb_write_sym = declare_atom("BB-WRITE");
-	g_bb_data_sym  = declare_atom("bb-data");
+	g_bb_data_sym    = declare_atom("bb-data");
+	g_bb_changed_sym = declare_atom("bb-changed");
 	declare_pred_from_symbol(g_bb_data_sym);
+	declare_pred_from_symbol(g_bb_changed_sym);
 	make_and_declare_eval_funct("bb-value", func_blackboard_value, 2);
+	make_and_declare_eval_funct("bb-get", func_blackboard_get, 3);
 	make_and_declare_action("bb-open", action_blackboard_open, 3);
 	make_and_declare_action("bb-close", action_blackboard_close, 2);
 	make_and_declare_action("bb-read", action_blackboard_read, 2);
 	make_and_declare_action("bb-read-all", action_blackboard_read_all, 0);
+	make_and_declare_action("bb-read-changed", action_blackboard_read_changed, 0);
 	make_and_declare_action("bb-print", action_blackboard_print, 2);
 	add_user_end_kernel_hook(finalize);
 }
@@ -475,6 +613,7 @@ extern "C" void
 finalize()
 {
 	printf("*** DESTROYING mod_skiller\n");
+	g_interface_states.clear();
 	for (auto &iface : g_interfaces_read) {
 		g_blackboard->close(iface.second);
 	}
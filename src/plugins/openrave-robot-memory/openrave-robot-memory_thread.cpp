@@ -24,15 +24,24 @@
 #include <algorithm>
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/json.hpp>
+#include <cmath>
+#include <set>
 
 using namespace fawkes;
 using namespace bsoncxx;
 
 /** @class OpenraveRobotMemoryThread 'openrave-robot-memory_thread.h' 
- * Creates an OpenRave Scene for motion planning from data in the robot memory
+ * Creates an OpenRave Scene for motion planning from data in the robot memory.
+ * The scene is updated incrementally, only objects which have been added,
+ * moved, or removed since the last construction are sent to OpenRAVE.
  * @author Frederik Zwilling
  */
 
+/// @cond INTERNALS
+/** Tolerance below which an object is not considered moved. */
+static const double POSE_TOLERANCE = 1e-4;
+/// @endcond
+
 /** Constructor. */
 OpenraveRobotMemoryThread::OpenraveRobotMemoryThread()
 : Thread("OpenraveRobotMemoryThread", Thread::OPMODE_WAITFORWAKEUP),
@@ -73,6 +82,9 @@ OpenraveRobotMemoryThread::construct_scene()
 {
 	logger->log_info(name(), "Constructing Scene");
 
+	std::set<std::string> seen_objects;
+	unsigned int          num_updated = 0;
+
 	// add all object types by iterating over config paths
 	std::string prefix = "plugins/openrave-robot-memory/object-types/";
 	std::unique_ptr<Configuration::ValueIterator> object_types(config->search(prefix.c_str()));
@@ -102,35 +114,72 @@ OpenraveRobotMemoryThread::construct_scene()
 			//logger->log_info(name(), "Adding: %s", cfg_prefix.c_str(), to_json(block).c_str());
 			std::string block_name =
 			  block[config->get_string(cfg_prefix + "name-key")].get_utf8().value.to_string();
-			if (std::find(added_objects_.begin(), added_objects_.end(), block_name)
-			    == added_objects_.end()) {
+			seen_objects.insert(block_name);
+
+			array::view           translation = block["translation"].get_array();
+			array::view           rotation    = block["rotation"].get_array();
+			std::array<double, 7> pose;
+			for (size_t i = 0; i < 3; ++i)
+				pose[i] = translation[i].get_double();
+			for (size_t i = 0; i < 4; ++i)
+				pose[3 + i] = rotation[i].get_double();
+
+			auto o = objects_.find(block_name);
+			if (o == objects_.end()) {
 				//add new object
 				logger->log_info(name(), "adding %s", block_name.c_str());
 				OpenRaveInterface::AddObjectMessage add_msg;
 				add_msg.set_name(block_name.c_str());
 				add_msg.set_path(config->get_string(cfg_prefix + "model-path").c_str());
 				openrave_if_->msgq_enqueue_copy(&add_msg);
-				added_objects_.push_back(block_name);
+			} else {
+				bool moved = false;
+				for (size_t i = 0; i < pose.size(); ++i) {
+					if (std::fabs(pose[i] - o->second[i]) > POSE_TOLERANCE) {
+						moved = true;
+						break;
+					}
+				}
+				if (!moved)
+					continue;
 			}
+			objects_[block_name] = pose;
+			num_updated += 1;
+
 			//move object to right position
 			OpenRaveInterface::MoveObjectMessage move_msg;
 			move_msg.set_name(block_name.c_str());
-			array::view translation = block["translation"].get_array();
-			move_msg.set_x(translation[0].get_double());
-			move_msg.set_y(translation[1].get_double());
-			move_msg.set_z(translation[2].get_double());
+			move_msg.set_x(pose[0]);
+			move_msg.set_y(pose[1]);
+			move_msg.set_z(pose[2]);
 			openrave_if_->msgq_enqueue_copy(&move_msg);
 			//rotate object
 			OpenRaveInterface::RotateObjectQuatMessage rotate_msg;
 			rotate_msg.set_name(block_name.c_str());
-			array::view rotation = block["rotation"].get_array();
-			rotate_msg.set_x(rotation[0].get_double());
-			rotate_msg.set_y(rotation[1].get_double());
-			rotate_msg.set_z(rotation[2].get_double());
-			rotate_msg.set_w(rotation[3].get_double());
+			rotate_msg.set_x(pose[3]);
+			rotate_msg.set_y(pose[4]);
+			rotate_msg.set_z(pose[5]);
+			rotate_msg.set_w(pose[6]);
 			openrave_if_->msgq_enqueue_copy(&rotate_msg);
 		}
 	}
 	added_object_types_.clear();
-	logger->log_info(name(), "Finished Constructing Scene");
+
+	// remove objects which are no longer in the robot memory
+	for (auto o = objects_.begin(); o != objects_.end();) {
+		if (seen_objects.find(o->first) == seen_objects.end()) {
+			logger->log_info(name(), "removing %s", o->first.c_str());
+			OpenRaveInterface::DeleteObjectMessage del_msg;
+			del_msg.set_name(o->first.c_str());
+			openrave_if_->msgq_enqueue_copy(&del_msg);
+			o = objects_.erase(o);
+			num_updated += 1;
+		} else {
+			++o;
+		}
+	}
+	logger->log_info(name(),
+	                 "Finished Constructing Scene (%u changes, %zu objects)",
+	                 num_updated,
+	                 objects_.size());
 }
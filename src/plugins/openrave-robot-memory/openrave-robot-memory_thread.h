@@ -32,7 +32,9 @@
 #include <plugins/robot-memory/aspect/robot_memory_aspect.h>
 
 #include <algorithm>
+#include <array>
 #include <list>
+#include <map>
 
 namespace fawkes {
 // add forward declarations here, e.g., interfaces
@@ -63,9 +65,11 @@ protected:
 private:
 	fawkes::OpenRaveInterface *           openrave_if_;
 	fawkes::OpenraveRobotMemoryInterface *or_rm_if_;
-	std::list<std::string>                added_objects_;
 	std::list<std::string>                added_object_types_;
 
+	/// pose (translation, rotation quaternion) of objects in the scene by name
+	std::map<std::string, std::array<double, 7>> objects_;
+
 	void construct_scene();
 };
 
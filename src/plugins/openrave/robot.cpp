@@ -30,9 +30,26 @@
 
 #include <openrave-core.h>
 
+#include <cmath>
+#include <sstream>
+
 using namespace OpenRAVE;
 namespace fawkes {
 
+/// @cond INTERNALS
+/** Maximum number of IK results kept in the cache. */
+static const size_t IK_CACHE_SIZE = 256;
+
+/** Append values rounded to 1/10 mm (or rad) to a cache key. */
+static void
+append_key_values(std::ostringstream &key, const std::vector<dReal> &values)
+{
+	for (size_t i = 0; i < values.size(); ++i) {
+		key << ' ' << llround(values[i] * 1e4);
+	}
+}
+/// @endcond
+
 /** @class OpenRaveRobot <plugins/openrave/robot.h>
 * Class handling interaction with the OpenRAVE::RobotBase class.
 * This class mainly handles robot specific tasks, like setting a
@@ -79,7 +96,10 @@ OpenRaveRobot::OpenRaveRobot(const std::string &             filename,
  */
 OpenRaveRobot::OpenRaveRobot(const OpenRaveRobot &                 src,
                              const fawkes::OpenRaveEnvironmentPtr &new_env)
-: logger_(src.logger_), name_(src.name_), find_best_ik_(src.find_best_ik_)
+: logger_(src.logger_),
+  name_(src.name_),
+  find_best_ik_(src.find_best_ik_),
+  ik_cache_enabled_(src.ik_cache_enabled_)
 {
 	build_name_str();
 	traj_ = new std::vector<std::vector<dReal>>();
@@ -177,6 +197,8 @@ OpenRaveRobot::init()
 	trans_offset_y_ = 0.f;
 	trans_offset_z_ = 0.f;
 
+	ik_cache_enabled_ = true;
+
 	build_name_str();
 }
 
@@ -345,6 +367,20 @@ OpenRaveRobot::enable_ik_comparison(bool enable)
 	find_best_ik_ = enable;
 }
 
+/** Enable/Disable caching of IK solutions.
+ * If enabled, the result of an IK query is remembered and re-used if the
+ * same target is requested again while the robot's joints and all other
+ * bodies in the environment have not moved, e.g. for recurring poses.
+ * @param enable Sets the state of the cache. Enabled by default.
+ */
+void
+OpenRaveRobot::enable_ik_cache(bool enable)
+{
+	ik_cache_enabled_ = enable;
+	if (!enable)
+		ik_cache_.clear();
+}
+
 /** Set target, given relative transition.
  * This is the prefered method to set a target for straight manipulator movement.
  * @param trans_x x-transition
@@ -1057,23 +1093,45 @@ OpenRaveRobot::get_5dof_ikparam(OpenRAVE::Transform &trans)
 bool
 OpenRaveRobot::solve_ik(IkFilterOptions filter)
 {
+	std::string key;
+	if (ik_cache_enabled_) {
+		key = ik_cache_key(filter);
+
+		std::map<std::string, ik_cache_entry_t>::iterator c = ik_cache_.find(key);
+		if (c != ik_cache_.end()) {
+			target_.solvable = c->second.solvable;
+			if (!find_best_ik_ || !c->second.solution.empty())
+				target_.manip->set_angles(c->second.solution);
+			return target_.solvable;
+		}
+		if (ik_cache_.size() >= IK_CACHE_SIZE)
+			ik_cache_.clear();
+	}
+
 	if (!find_best_ik_) {
 		std::vector<dReal> solution;
 		target_.solvable = arm_->FindIKSolution(target_.ikparam, solution, filter);
 		target_.manip->set_angles(solution);
 
+		if (ik_cache_enabled_)
+			ik_cache_[key] = {target_.solvable, solution};
+
 	} else {
 		std::vector<std::vector<dReal>> solutions;
 
 		// get all IK solutions
 		target_.solvable = arm_->FindIKSolutions(target_.ikparam, solutions, filter);
-		if (!target_.solvable)
+		if (!target_.solvable) {
+			if (ik_cache_enabled_)
+				ik_cache_[key] = {false, std::vector<dReal>()};
 			return false;
+		}
 
 		// pick closest solution to current configuration
 		std::vector<std::vector<dReal>>::iterator sol;
 		std::vector<dReal>                        cur;
 		std::vector<dReal>                        diff;
+		std::vector<dReal>                        best;
 		float                                     dist = 100.f;
 		arm_->GetArmDOFValues(cur);
 
@@ -1092,12 +1150,61 @@ OpenRaveRobot::solve_ik(IkFilterOptions filter)
 			if (sol_dist < dist) {
 				// found a solution that is closer
 				dist = sol_dist;
-				target_.manip->set_angles(*sol);
+				best = *sol;
 			}
 		}
+		if (!best.empty())
+			target_.manip->set_angles(best);
+
+		if (ik_cache_enabled_)
+			ik_cache_[key] = {true, best};
 	}
 
 	return target_.solvable;
 }
 
+/** Get key for the IK cache.
+ * Besides the IK parameterization and filter options the result of an IK
+ * query depends on the current joint values, which serve as seed when
+ * looking for the closest solution, on the robot's pose, and on all
+ * bodies the arm might collide with. The key therefore covers the active
+ * manipulator and all of these. The environment must be locked.
+ * @param filter IK filter options
+ * @return key for the current target
+ */
+std::string
+OpenRaveRobot::ik_cache_key(IkFilterOptions filter) const
+{
+	std::ostringstream key;
+	key << arm_->GetName() << ' ' << (int)filter << ' ' << find_best_ik_ << ' '
+	    << (int)target_.ikparam.GetType();
+
+	std::vector<dReal> values(target_.ikparam.GetNumberOfValues());
+	target_.ikparam.GetValues(values.begin());
+	append_key_values(key, values);
+
+	robot_->GetDOFValues(values);
+	append_key_values(key, values);
+
+	std::vector<KinBodyPtr> bodies;
+	robot_->GetEnv()->GetBodies(bodies);
+	for (std::vector<KinBodyPtr>::iterator b = bodies.begin(); b != bodies.end(); ++b) {
+		std::vector<Transform> transforms;
+		if (*b == robot_) {
+			// joints are covered above, only the robot's pose is needed
+			transforms.push_back(robot_->GetTransform());
+		} else {
+			(*b)->GetLinkTransformations(transforms);
+		}
+		key << '|' << (*b)->GetName() << ' ' << (*b)->IsEnabled();
+		for (std::vector<Transform>::iterator t = transforms.begin(); t != transforms.end(); ++t) {
+			dReal v[] = {t->trans.x, t->trans.y, t->trans.z, t->rot.x, t->rot.y, t->rot.z, t->rot.w};
+			values.assign(v, v + 7);
+			append_key_values(key, values);
+		}
+	}
+
+	return key.str();
+}
+
 } // end of namespace fawkes
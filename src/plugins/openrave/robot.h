@@ -27,6 +27,8 @@
 
 #include <openrave/openrave.h>
 
+#include <map>
+#include <string>
 #include <vector>
 
 namespace fawkes {
@@ -110,6 +112,7 @@ public:
 	virtual void set_target_angles(std::vector<float> &angles);
 
 	virtual void enable_ik_comparison(bool enable);
+	virtual void enable_ik_cache(bool enable);
 
 	virtual OpenRAVE::RobotBasePtr                      get_robot_ptr() const;
 	virtual target_t                                    get_target() const;
@@ -137,6 +140,7 @@ private:
 	                                              bool                      no_offset = false);
 	OpenRAVE::IkParameterization get_5dof_ikparam(OpenRAVE::Transform &trans);
 	bool                         solve_ik(OpenRAVE::IkFilterOptions filter);
+	std::string                  ik_cache_key(OpenRAVE::IkFilterOptions filter) const;
 
 	fawkes::Logger *logger_;
 
@@ -158,6 +162,16 @@ private:
 
 	bool display_planned_movements_;
 	bool find_best_ik_;
+
+	/// @cond INTERNALS
+	typedef struct
+	{
+		bool                         solvable;
+		std::vector<OpenRAVE::dReal> solution;
+	} ik_cache_entry_t;
+	/// @endcond
+	bool                                    ik_cache_enabled_;
+	std::map<std::string, ik_cache_entry_t> ik_cache_;
 };
 
 } // end of namespace fawkes
@@ -64,6 +64,12 @@ PddlPlannerThread::init()
 	cfg_fd_options_   = config->get_string(cfg_prefix + "fd-search-opts");
 	cfg_collection_   = config->get_string(cfg_prefix + "collection");
 
+	cfg_plan_cache_size_ = 16;
+	try {
+		cfg_plan_cache_size_ = config->get_uint(cfg_prefix + "plan-cache-size");
+	} catch (Exception &e) {
+	} // ignored, use default
+
 	//set configured planner
 	std::string planner_string = config->get_string((cfg_prefix + "planner").c_str());
 	if (planner_string == "ff") {
@@ -109,8 +115,26 @@ PddlPlannerThread::loop()
 {
 	logger->log_info(name(), "Starting PDDL Planning...");
 
-	//writes plan into action_list_
-	planner_();
+	std::string cache_key;
+	if (cfg_plan_cache_size_ > 0) {
+		cache_key = plan_cache_key();
+	}
+
+	auto cached = plan_cache_.find(cache_key);
+	if (!cache_key.empty() && cached != plan_cache_.end()) {
+		logger->log_info(name(), "Problem has been solved before, re-using plan");
+		action_list_ = cached->second;
+	} else {
+		//writes plan into action_list_
+		planner_();
+
+		if (!cache_key.empty() && !action_list_.empty()) {
+			if (plan_cache_.size() >= cfg_plan_cache_size_) {
+				plan_cache_.clear();
+			}
+			plan_cache_[cache_key] = action_list_;
+		}
+	}
 
 	if (!action_list_.empty()) {
 		auto plan = BSONFromActionList();
@@ -416,6 +440,26 @@ PddlPlannerThread::run_planner(std::string command)
 	return result;
 }
 
+/** Get key to look up plan in cache.
+ * Planning is deterministic given the domain, the problem, and the
+ * planner, hence the key is composed of the files' contents.
+ * @return key for the current domain and problem, empty if the files
+ * could not be read
+ */
+std::string
+PddlPlannerThread::plan_cache_key()
+{
+	std::ostringstream key;
+	key << plan_if_->active_planner() << '\0';
+	std::ifstream domain(cfg_domain_path_);
+	std::ifstream problem(cfg_problem_path_);
+	if (!domain || !problem) {
+		return "";
+	}
+	key << domain.rdbuf() << '\0' << problem.rdbuf();
+	return key.fail() ? "" : key.str();
+}
+
 bool
 PddlPlannerThread::bb_interface_message_received(Interface *      interface,
                                                  fawkes::Message *message) noexcept
@@ -34,6 +34,7 @@
 #include <plugins/robot-memory/aspect/robot_memory_aspect.h>
 
 #include <bsoncxx/document/value.hpp>
+#include <map>
 
 class PddlPlannerThread : public fawkes::Thread,
                           public fawkes::LoggingAspect,
@@ -70,9 +71,12 @@ private:
 	std::string                   cfg_problem_path_;
 	std::string                   cfg_fd_options_;
 	std::string                   cfg_collection_;
+	unsigned int                  cfg_plan_cache_size_;
 
 	std::vector<action> action_list_;
 
+	std::map<std::string, std::vector<action>> plan_cache_;
+
 	std::function<void()> planner_;
 
 	void                     ff_planner();
@@ -83,6 +87,7 @@ private:
 	static size_t            find_nth_space(const std::string &s, size_t nth);
 	void                     print_action_list();
 	std::string              run_planner(std::string command);
+	std::string              plan_cache_key();
 	virtual bool             bb_interface_message_received(fawkes::Interface *interface,
 	                                                       fawkes::Message *  message) noexcept;
 };
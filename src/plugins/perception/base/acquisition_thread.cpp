@@ -47,6 +47,9 @@
 #include <cstring>
 #include <string>
 
+/** Number of image slots of the shared memory buffers. */
+#define FVBASE_SHM_SLOTS 6
+
 using namespace fawkes;
 using namespace firevision;
 
@@ -82,8 +85,9 @@ FvAcquisitionThread::FvAcquisitionThread(const char *id,
 	enabled_mutex_    = new Mutex(Mutex::RECURSIVE);
 	enabled_waitcond_ = new WaitCondition(enabled_mutex_);
 
-	camera_     = camera;
-	width_      = camera_->pixel_width();
+	camera_        = camera;
+	zero_copy_shm_ = NULL;
+	width_         = camera_->pixel_width();
 	height_     = camera_->pixel_height();
 	colorspace_ = camera_->colorspace();
 
@@ -147,6 +151,13 @@ FvAcquisitionThread::finalize()
  * where the image is copied to (or a conversion result is posted to).
  * The returned instance has to bee freed using delete when done with it.
  *
+ * Shared memory buffers hold a ring of images. New images are written to
+ * a slot no vision thread is using and then published, hence vision
+ * threads can process an image while the next one is acquired. If the
+ * requested colorspace is the one of the camera, the camera is asked to
+ * capture directly into the slots, see Camera::set_capture_buffer().
+ * Images are then neither copied nor converted.
+ *
  * You can decide whether you want to get access to the raw camera image
  * that has not been modified in any way or to the YUV422_PLANAR image buffer
  * (a conversion is done if needed). Use the raw parameter to decide whether
@@ -191,8 +202,13 @@ FvAcquisitionThread::camera_instance(colorspace_t cspace, bool deep_copy)
 			if (asprintf(&tmp, "%s.%zu", image_id_, shm_.size()) == -1) {
 				throw OutOfMemoryException("FvAcqThread::camera_instance(): Could not create image ID");
 			}
-			img_id       = tmp;
-			shm_[cspace] = new SharedMemoryImageBuffer(img_id, cspace, width_, height_);
+			img_id = tmp;
+			if (cspace == colorspace_) {
+				shm_[cspace] = zero_copy_buffer(img_id);
+			} else {
+				shm_[cspace] =
+				  new SharedMemoryImageBuffer(img_id, cspace, width_, height_, FVBASE_SHM_SLOTS);
+			}
 		} else {
 			img_id = shm_[cspace]->image_id();
 		}
@@ -205,6 +221,57 @@ FvAcquisitionThread::camera_instance(colorspace_t cspace, bool deep_copy)
 	}
 }
 
+/** Create a shared memory buffer the camera captures into.
+ * @param img_id image ID of the buffer
+ * @return shared memory buffer, if the camera cannot capture into it
+ * images are copied
+ */
+SharedMemoryImageBuffer *
+FvAcquisitionThread::zero_copy_buffer(const char *img_id)
+{
+	// the camera must not capture while its buffers are exchanged
+	MutexLocker lock(enabled_mutex_);
+
+	SharedMemoryImageBuffer *shm =
+	  new SharedMemoryImageBuffer(img_id, colorspace_, width_, height_, FVBASE_SHM_SLOTS);
+	try {
+		camera_->set_capture_buffer(shm);
+		zero_copy_shm_ = shm;
+		logger->log_debug(name(), "Camera captures directly into %s", img_id);
+	} catch (Exception &e) {
+		logger->log_debug(name(), "Camera cannot capture into %s, copying images", img_id);
+		logger->log_debug(name(), e);
+	}
+	return shm;
+}
+
+/** Fill a slot with the captured image.
+ * Converts the image into a slot no vision thread is using. If the camera
+ * captured into the buffer, the slot holding the image is determined.
+ * The slot must then be published.
+ * @param shm shared memory buffer to fill
+ * @param cspace colorspace of the buffer
+ * @return index of the slot holding the image
+ */
+unsigned int
+FvAcquisitionThread::fill_slot(SharedMemoryImageBuffer *shm, colorspace_t cspace)
+{
+	unsigned char *image = camera_->buffer();
+
+	if (shm != zero_copy_shm_) {
+		unsigned int slot = shm->free_slot();
+		convert(colorspace_, cspace, image, shm->slot_buffer(slot), width_, height_);
+		return slot;
+	}
+
+	for (unsigned int i = 0; i < shm->num_slots(); ++i) {
+		if (shm->slot_buffer(i) == image) {
+			return i;
+		}
+	}
+	throw Exception("Captured image is not in a slot of %s", shm->image_id());
+}
+
 /** Get the Camera of this acquisition thread.
  * This is just used for the camera controls, if you want to access the camera,
  * use camera_instance()
@@ -321,20 +388,21 @@ FvAcquisitionThread::loop()
 			tt_->ping_end(ttc_capture_);
 
 			for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
-				if (shmit_->first == CS_UNKNOWN)
+				// no image if the camera dropped the frame
+				if ((shmit_->first == CS_UNKNOWN) || (camera_->buffer() == NULL))
 					continue;
-				tt_->ping_start(ttc_lock_);
-				shmit_->second->lock_for_write();
-				tt_->ping_end(ttc_lock_);
 				tt_->ping_start(ttc_convert_);
-				convert(
-				  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
+				unsigned int slot = fill_slot(shmit_->second, shmit_->first);
 				try {
-					shmit_->second->set_capture_time(camera_->capture_time());
+					shmit_->second->set_slot_capture_time(slot, camera_->capture_time());
 				} catch (NotImplementedException &e) {
 					// ignored
 				}
 				tt_->ping_end(ttc_convert_);
+				tt_->ping_start(ttc_lock_);
+				shmit_->second->lock_for_write();
+				tt_->ping_end(ttc_lock_);
+				shmit_->second->publish_slot(slot);
 				tt_->ping_start(ttc_unlock_);
 				shmit_->second->unlock();
 				tt_->ping_end(ttc_unlock_);
@@ -359,16 +427,17 @@ FvAcquisitionThread::loop()
 		if (enabled_) {
 			camera_->capture();
 			for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
-				if (shmit_->first == CS_UNKNOWN)
+				// no image if the camera dropped the frame
+				if ((shmit_->first == CS_UNKNOWN) || (camera_->buffer() == NULL))
 					continue;
-				shmit_->second->lock_for_write();
-				convert(
-				  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
+				unsigned int slot = fill_slot(shmit_->second, shmit_->first);
 				try {
-					shmit_->second->set_capture_time(camera_->capture_time());
+					shmit_->second->set_slot_capture_time(slot, camera_->capture_time());
 				} catch (NotImplementedException &e) {
 					// ignored
 				}
+				shmit_->second->lock_for_write();
+				shmit_->second->publish_slot(slot);
 				shmit_->second->unlock();
 			}
 		}
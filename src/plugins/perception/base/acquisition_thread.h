@@ -101,6 +101,10 @@ private:
 	virtual bool bb_interface_message_received(fawkes::Interface *interface,
 	                                           fawkes::Message *  message) noexcept;
 
+	firevision::SharedMemoryImageBuffer *zero_copy_buffer(const char *img_id);
+
+	unsigned int fill_slot(firevision::SharedMemoryImageBuffer *shm, firevision::colorspace_t cspace);
+
 private:
 	bool                   enabled_;
 	fawkes::Mutex *        enabled_mutex_;
@@ -118,6 +122,8 @@ private:
 	std::map<firevision::colorspace_t, firevision::SharedMemoryImageBuffer *>           shm_;
 	std::map<firevision::colorspace_t, firevision::SharedMemoryImageBuffer *>::iterator shmit_;
 
+	firevision::SharedMemoryImageBuffer *zero_copy_shm_;
+
 	fawkes::SwitchInterface *enabled_if_;
 
 #ifdef FVBASE_TIMETRACKER
@@ -123,6 +123,11 @@ public:
 		cfg_icp_transformation_eps_ = config->get_float(CFG_PREFIX_MERGE "icp/transformation-epsilon");
 		cfg_icp_euclidean_fitness_eps_ =
 		  config->get_float(CFG_PREFIX_MERGE "icp/euclidean-fitness-epsilon");
+		try {
+			cfg_retrieve_leaf_size_ = config->get_float(CFG_PREFIX_MERGE "retrieve-leaf-size");
+		} catch (fawkes::Exception &e) {
+			cfg_retrieve_leaf_size_ = 0.;
+		}
 
 		this->logger_->log_info(this->name_,
 		                        "Age Tolerance: %li  "
@@ -202,8 +207,8 @@ public:
 
 		TIMETRACK_START(ttc_retrieval_);
 
-		pcls =
-		  PointCloudDBPipeline<PointType>::retrieve_clouds(times, actual_times, database, collection);
+		pcls = PointCloudDBPipeline<PointType>::retrieve_clouds(
+		  times, actual_times, database, collection, cfg_retrieve_leaf_size_);
 		if (pcls.empty()) {
 			this->logger_->log_warn(this->name_, "No point clouds found for desired timestamps");
 			TIMETRACK_ABORT(ttc_retrieval_);
@@ -304,9 +309,9 @@ public:
 
 			*aligned_downsampled[0] = *non_aligned_downsampled[0];
 			for (unsigned int i = 1; i < num_clouds; ++i) {
-				pcl::transformPointCloud(*non_aligned_downsampled[i],
-				                         *aligned_downsampled[i],
-				                         transforms[i - 1]);
+				fawkes::pcl_utils::transform_pointcloud(*non_aligned_downsampled[i],
+				                                        *aligned_downsampled[i],
+				                                        Eigen::Affine3f(transforms[i - 1]));
 			}
 
 			TIMETRACK_INTER(ttc_transform_1_, ttc_remove_planes_);
@@ -333,9 +338,9 @@ public:
 
 				align_icp(source, target, transform);
 
-				typename PointCloudDBPipeline<PointType>::Cloud tmp;
-				pcl::transformPointCloud(*aligned_downsampled_remplane[i], tmp, transform);
-				*aligned_downsampled_remplane[i] = tmp;
+				fawkes::pcl_utils::transform_pointcloud(*aligned_downsampled_remplane[i],
+				                                        *aligned_downsampled_remplane[i],
+				                                        Eigen::Affine3f(transform));
 
 				transforms[i - 1] *= transform;
 			}
@@ -343,9 +348,7 @@ public:
 			TIMETRACK_INTER(ttc_align_2_, ttc_transform_final_);
 
 			for (unsigned int i = 1; i < num_clouds; ++i) {
-				typename PointCloudDBPipeline<PointType>::Cloud tmp;
-				pcl::transformPointCloud(*pcls[i], tmp, transforms[i - 1]);
-				*pcls[i] = tmp;
+				fawkes::pcl_utils::transform_pointcloud(*pcls[i], *pcls[i], Eigen::Affine3f(transforms[i - 1]));
 			}
 
 			TIMETRACK_END(ttc_transform_final_);
@@ -622,6 +625,7 @@ private: // members
 	std::string  cfg_passthrough_filter_axis_;
 	float        cfg_passthrough_filter_limits_[2];
 	float        cfg_downsample_leaf_size_;
+	float        cfg_retrieve_leaf_size_;
 	float        cfg_plane_rem_max_iter_;
 	float        cfg_plane_rem_dist_thresh_;
 	unsigned int cfg_icp_ransac_iterations_;
@@ -262,13 +262,17 @@ protected: // methods
    * clouds retrieved based on the desired @p times.
    * @param database name of the database to retrieve data from
    * @param collection_name name of the collection to retrieve data from.
+   * @param leaf_size if larger than zero, the coarsest stored downsampled
+   * version of each point cloud with a leaf size of at most @p leaf_size
+   * is retrieved instead of the raw point cloud, if available.
    * @return vector of shared pointers to retrieved point clouds
    */
 	std::vector<CloudPtr>
 	retrieve_clouds(std::vector<long> &times,
 	                std::vector<long> &actual_times,
 	                std::string &      database,
-	                std::string &      collection_name)
+	                std::string &      collection_name,
+	                float              leaf_size = 0.)
 	{
 		using namespace bsoncxx::builder;
 		auto collection = mongodb_client_->database(database)[collection_name];
@@ -307,9 +311,34 @@ protected: // methods
 				lpcl->width           = pcldoc["width"].get_int64();
 				lpcl->height          = pcldoc["height"].get_int64();
 				fawkes::pcl_utils::set_time(lpcl, actual_time);
-				lpcl->points.resize(pcldoc["num_points"].get_int64());
 
-				read_gridfs_file(&lpcl->points[0], database, pcldoc["data"]["id"].get_value());
+				// pick the coarsest sufficient level, levels are sorted by leaf size
+				bsoncxx::document::view    datadoc        = pcldoc["data"].get_document().view();
+				int64_t                    num_points     = pcldoc["num_points"].get_int64();
+				double                     used_leaf_size = 0.;
+				bsoncxx::document::element levels         = pcldoc["levels"];
+				if (leaf_size > 0. && levels && levels.type() == bsoncxx::type::k_array) {
+					for (auto l : levels.get_array().value) {
+						bsoncxx::document::view level = l.get_document().view();
+						if (level["leaf_size"].get_double() <= leaf_size) {
+							used_leaf_size = level["leaf_size"].get_double();
+							num_points     = level["num_points"].get_int64();
+							datadoc        = level["data"].get_document().view();
+						}
+					}
+				}
+				if (used_leaf_size > 0.) {
+					logger_->log_info(name_, "Using level with leaf size %f", used_leaf_size);
+					// downsampled levels are unorganized and contain no invalid points
+					lpcl->width    = num_points;
+					lpcl->height   = 1;
+					lpcl->is_dense = true;
+				}
+				lpcl->points.resize(num_points);
+
+				if (num_points > 0) {
+					read_gridfs_file(&lpcl->points[0], database, datadoc["id"].get_value());
+				}
 			} else {
 				logger_->log_warn(name_, "Cannot retrieve document for time %li", times[i]);
 				return std::vector<CloudPtr>();
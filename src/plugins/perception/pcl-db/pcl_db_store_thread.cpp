@@ -23,6 +23,7 @@
 
 #include <blackboard/utils/on_message_waker.h>
 #include <interfaces/PclDatabaseStoreInterface.h>
+#include <pcl/PCLPointField.h>
 #include <pcl_utils/pcl_adapter.h>
 
 // from MongoDB
@@ -32,6 +33,12 @@
 #include <mongocxx/gridfs/bucket.hpp>
 #include <mongocxx/gridfs/uploader.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_set>
+
 #define CFG_PREFIX "/perception/pcl-db/"
 
 using namespace fawkes;
@@ -39,6 +46,13 @@ using namespace mongocxx;
 
 /** @class PointCloudDBStoreThread "pcl_db_store_thread.h"
  * Thread to store point clouds from database on request.
+ *
+ * Besides the raw point cloud, downsampled versions of the cloud can be
+ * stored as separate files, one per configured voxel leaf size. Each
+ * keeps one original point per voxel, hence they have the same point
+ * type as the raw cloud. Together with the bounding box of the cloud,
+ * which is stored alongside, this allows to retrieve only as much data
+ * as a consumer needs.
  * @author Tim Niemueller
  */
 
@@ -61,6 +75,16 @@ PointCloudDBStoreThread::init()
 	msg_waker_ = NULL;
 
 	cfg_database_ = config->get_string(CFG_PREFIX "database-name");
+	try {
+		cfg_levels_ = config->get_floats(CFG_PREFIX "store/levels");
+	} catch (Exception &e) {
+		cfg_levels_.clear();
+	}
+	cfg_levels_.erase(std::remove_if(cfg_levels_.begin(),
+	                                 cfg_levels_.end(),
+	                                 [](float leaf_size) { return leaf_size <= 0.; }),
+	                  cfg_levels_.end());
+	std::sort(cfg_levels_.begin(), cfg_levels_.end());
 
 	adapter_ = new PointCloudAdapter(pcl_manager, logger);
 
@@ -161,7 +185,61 @@ PointCloudDBStoreThread::store_pointcloud(std::string  pcl_id,
 	auto uploader = gridfs.open_upload_stream(name.str());
 	uploader.write(static_cast<uint8_t *>(point_data), data_size);
 	auto result = uploader.close();
+
+	// bounding box and downsampled levels require float coordinates
+	size_t       xyz_offsets[3];
+	unsigned int xyz_found = 0;
+	for (const PointCloudAdapter::PointFieldInfo &fi : fieldinfo) {
+		if (fi.datatype != pcl::PCLPointField::FLOAT32 || fi.count != 1)
+			continue;
+		for (unsigned int i = 0; i < 3; ++i) {
+			if (fi.name == std::string(1, 'x' + i)) {
+				xyz_offsets[i] = fi.offset;
+				xyz_found |= 1 << i;
+			}
+		}
+	}
+	bool have_xyz = (xyz_found == 7);
+
+	float bbox_min[3], bbox_max[3];
+	if (have_xyz) {
+		compute_bbox(
+		  static_cast<uint8_t *>(point_data), point_size, num_points, xyz_offsets, bbox_min, bbox_max);
+	}
+
 	using namespace bsoncxx::builder;
+	basic::array levels;
+	if (have_xyz) {
+		std::vector<uint8_t> level_data;
+		for (float leaf_size : cfg_levels_) {
+			decimate(static_cast<uint8_t *>(point_data),
+			         point_size,
+			         num_points,
+			         xyz_offsets,
+			         leaf_size,
+			         level_data);
+
+			std::stringstream level_name;
+			level_name << name.str() << "_" << (unsigned int)roundf(leaf_size * 1000.f) << "mm";
+			auto level_uploader = gridfs.open_upload_stream(level_name.str());
+			level_uploader.write(level_data.data(), level_data.size());
+			auto level_result = level_uploader.close();
+
+			basic::document level;
+			level.append(basic::kvp("leaf_size", static_cast<double>(leaf_size)));
+			level.append(basic::kvp("num_points", static_cast<int64_t>(level_data.size() / point_size)));
+			level.append(basic::kvp("data", [&](basic::sub_document datadoc) {
+				datadoc.append(basic::kvp("id", level_result.id()));
+				datadoc.append(basic::kvp("filename", level_name.str()));
+			}));
+			levels.append(level.extract());
+		}
+	} else if (!cfg_levels_.empty()) {
+		logger->log_warn(this->name(),
+		                 "Point cloud %s has no float coordinates, storing raw data only",
+		                 pcl_id.c_str());
+	}
+
 	basic::document document;
 	document.append(basic::kvp("timestamp", static_cast<int64_t>(time.in_msec())));
 	document.append(basic::kvp("pointcloud", [&](basic::sub_document subdoc) {
@@ -175,6 +253,19 @@ PointCloudDBStoreThread::store_pointcloud(std::string  pcl_id,
 			datadoc.append(basic::kvp("id", result.id()));
 			datadoc.append(basic::kvp("filename", name.str()));
 		}));
+		if (have_xyz) {
+			subdoc.append(basic::kvp("bbox", [&](basic::sub_document bboxdoc) {
+				bboxdoc.append(basic::kvp("min", [&](basic::sub_array a) {
+					for (unsigned int i = 0; i < 3; ++i)
+						a.append(static_cast<double>(bbox_min[i]));
+				}));
+				bboxdoc.append(basic::kvp("max", [&](basic::sub_array a) {
+					for (unsigned int i = 0; i < 3; ++i)
+						a.append(static_cast<double>(bbox_max[i]));
+				}));
+			}));
+			subdoc.append(basic::kvp("levels", levels.extract()));
+		}
 		subdoc.append(basic::kvp("field_info", [fieldinfo](basic::sub_array fi_array) {
 			for (auto fi : fieldinfo) {
 				basic::document fi_doc;
@@ -196,3 +287,87 @@ PointCloudDBStoreThread::store_pointcloud(std::string  pcl_id,
 
 	return true;
 }
+
+/** Compute bounding box of a point cloud.
+ * Points with non-finite coordinates are ignored.
+ * @param data point data
+ * @param point_size size in bytes of a single point
+ * @param num_points number of points in @p data
+ * @param xyz_offsets offsets of the float X, Y, and Z coordinates in a point
+ * @param min upon return contains the minimum coordinates
+ * @param max upon return contains the maximum coordinates, smaller than
+ * @p min if the cloud contains no valid point
+ */
+void
+PointCloudDBStoreThread::compute_bbox(const uint8_t *data,
+                                      size_t         point_size,
+                                      size_t         num_points,
+                                      const size_t   xyz_offsets[3],
+                                      float          min[3],
+                                      float          max[3])
+{
+	for (unsigned int i = 0; i < 3; ++i) {
+		min[i] = std::numeric_limits<float>::max();
+		max[i] = -std::numeric_limits<float>::max();
+	}
+
+	for (size_t p = 0; p < num_points; ++p) {
+		const uint8_t *point = data + p * point_size;
+		float          xyz[3];
+		for (unsigned int i = 0; i < 3; ++i) {
+			memcpy(&xyz[i], point + xyz_offsets[i], sizeof(float));
+		}
+		if (!std::isfinite(xyz[0]) || !std::isfinite(xyz[1]) || !std::isfinite(xyz[2]))
+			continue;
+		for (unsigned int i = 0; i < 3; ++i) {
+			min[i] = std::min(min[i], xyz[i]);
+			max[i] = std::max(max[i], xyz[i]);
+		}
+	}
+}
+
+/** Downsample a point cloud on a voxel grid.
+ * Keeps the first point which falls into a voxel. Unlike a voxel grid
+ * filter, this does not average points, hence it works for any point
+ * type and the result can be restored like the raw cloud. Points with
+ * non-finite coordinates are dropped.
+ * @param data point data
+ * @param point_size size in bytes of a single point
+ * @param num_points number of points in @p data
+ * @param xyz_offsets offsets of the float X, Y, and Z coordinates in a point
+ * @param leaf_size voxel edge length
+ * @param out upon return contains the data of the remaining points
+ */
+void
+PointCloudDBStoreThread::decimate(const uint8_t *       data,
+                                  size_t                point_size,
+                                  size_t                num_points,
+                                  const size_t          xyz_offsets[3],
+                                  float                 leaf_size,
+                                  std::vector<uint8_t> &out)
+{
+	out.clear();
+	std::unordered_set<uint64_t> voxels;
+	voxels.reserve(num_points / 4);
+
+	const float inv_leaf_size = 1.f / leaf_size;
+	for (size_t p = 0; p < num_points; ++p) {
+		const uint8_t *point = data + p * point_size;
+		uint64_t       key   = 0;
+		bool           valid = true;
+		for (unsigned int i = 0; i < 3; ++i) {
+			float c;
+			memcpy(&c, point + xyz_offsets[i], sizeof(float));
+			if (!std::isfinite(c)) {
+				valid = false;
+				break;
+			}
+			// 21 bits per axis, wraps only for clouds larger than 2^21 voxels
+			int64_t v = (int64_t)floorf(c * inv_leaf_size);
+			key       = (key << 21) | ((uint64_t)v & 0x1FFFFF);
+		}
+		if (valid && voxels.insert(key).second) {
+			out.insert(out.end(), point, point + point_size);
+		}
+	}
+}
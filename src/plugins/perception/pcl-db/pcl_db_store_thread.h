@@ -32,6 +32,8 @@
 #include <pcl/point_types.h>
 #include <plugins/mongodb/aspect/mongodb.h>
 
+#include <vector>
+
 namespace fawkes {
 class PclDatabaseStoreInterface;
 class BlackBoardOnMessageWaker;
@@ -59,6 +61,18 @@ private:
 	                      std::string  database,
 	                      std::string  collection,
 	                      std::string &errmsg);
+	void compute_bbox(const uint8_t *data,
+	                  size_t         point_size,
+	                  size_t         num_points,
+	                  const size_t   xyz_offsets[3],
+	                  float          min[3],
+	                  float          max[3]);
+	void decimate(const uint8_t *       data,
+	              size_t                point_size,
+	              size_t                num_points,
+	              const size_t          xyz_offsets[3],
+	              float                 leaf_size,
+	              std::vector<uint8_t> &out);
 
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
@@ -75,6 +89,8 @@ private: // members
 
 	std::string cfg_input_id_;
 	std::string cfg_database_;
+
+	std::vector<float> cfg_levels_;
 };
 
 #endif
@@ -26,7 +26,7 @@
 #include <fvmodels/color/lookuptable.h>
 #include <fvutils/ipc/shm_image.h>
 #include <fvutils/writers/jpeg.h>
-#include <fvutils/writers/seq_writer.h>
+#include <fvutils/writers/async_seq_writer.h>
 #include <utils/time/tracker.h>
 
 #include <cstdlib>
@@ -120,8 +120,20 @@ FvRetrieverThread::init()
 	try {
 		if (config->get_bool("/firevision/retriever/save_images")) {
 			logger->log_info(name(), "Writing images to disk");
-			Writer *writer = new JpegWriter();
-			seq_writer     = new SeqWriter(writer);
+			// encode and write in background threads to not block the capture loop
+			unsigned int save_threads      = 1;
+			unsigned int save_queue_length = 8;
+			try {
+				save_threads = config->get_uint("/firevision/retriever/save_threads");
+			} catch (Exception &e) { /* use default */
+			}
+			try {
+				save_queue_length = config->get_uint("/firevision/retriever/save_queue_length");
+			} catch (Exception &e) { /* use default */
+			}
+			seq_writer = new AsyncSeqWriter([]() -> Writer * { return new JpegWriter(); },
+			                                save_threads,
+			                                save_queue_length);
 			std::string save_path;
 			try {
 				save_path = config->get_string("/firevision/retriever/save_path");
@@ -178,6 +190,14 @@ FvRetrieverThread::finalize()
 	vision_master->unregister_thread(this);
 	delete cam;
 	delete shm;
+	if (seq_writer) {
+		seq_writer->flush();
+		logger->log_info(name(),
+		                 "Wrote %u images, dropped %u, failed %u",
+		                 seq_writer->num_written(),
+		                 seq_writer->num_dropped(),
+		                 seq_writer->num_failed());
+	}
 	delete seq_writer;
 	delete tt_;
 	delete cm_;
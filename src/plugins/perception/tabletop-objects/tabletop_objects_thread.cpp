@@ -27,6 +27,7 @@
 #endif
 
 #include <pcl_utils/comparisons.h>
+#include <pcl_utils/transforms.h>
 #include <pcl_utils/utils.h>
 #include <utils/math/angle.h>
 #include <utils/time/wait.h>
@@ -52,6 +53,7 @@
 #include <pcl/registration/distances.h>
 #include <pcl/sample_consensus/method_types.h>
 #include <pcl/sample_consensus/model_types.h>
+#include <pcl/sample_consensus/sac_model_plane.h>
 #include <pcl/segmentation/extract_clusters.h>
 #include <pcl/surface/convex_hull.h>
 #include <utils/hungarian_method/hungarian.h>
@@ -59,6 +61,9 @@
 
 #include <algorithm>
 #include <iostream>
+#ifdef _OPENMP
+#	include <omp.h>
+#endif
 using namespace std;
 
 #define CFG_PREFIX "/perception/tabletop-objects/"
@@ -124,8 +129,32 @@ TabletopObjectsThread::init()
 	} catch (const Exception &e) {
 		cfg_verbose_cylinder_fitting_ = false;
 	}
+	try {
+		cfg_segm_reuse_plane_ = config->get_bool(CFG_PREFIX "table_segmentation_reuse_plane");
+	} catch (const Exception &e) {
+		cfg_segm_reuse_plane_ = true;
+	}
+	have_previous_plane_ = false;
+
+#ifdef _OPENMP
+	cluster_workspaces_.resize(omp_get_max_threads());
+#else
+	cluster_workspaces_.resize(1);
+#endif
+	for (ClusterWorkspace &ws : cluster_workspaces_) {
+		ws.obj_in_base_frame.reset(new ColorCloud());
+		ws.cylinder_inliers.reset(new ColorCloud());
+		ws.normals.reset(new pcl::PointCloud<pcl::Normal>());
+		ws.kdtree.reset(new pcl::search::KdTree<ColorPointType>());
+		ws.inliers.reset(new pcl::PointIndices());
+		ws.coefficients.reset(new pcl::ModelCoefficients());
+	}
 
-	if (pcl_manager->exists_pointcloud<PointType>(cfg_input_pointcloud_.c_str())) {
+	if (pcl_manager->exists_pointcloud_buffer<PointType>(cfg_input_pointcloud_.c_str())) {
+		finput_buffer_ = pcl_manager->get_pointcloud_buffer<PointType>(cfg_input_pointcloud_.c_str());
+		finput_        = finput_buffer_->snapshot(input_generation_);
+		input_         = pcl_utils::cloudptr_from_refptr(finput_);
+	} else if (pcl_manager->exists_pointcloud<PointType>(cfg_input_pointcloud_.c_str())) {
 		finput_ = pcl_manager->get_pointcloud<PointType>(cfg_input_pointcloud_.c_str());
 		input_  = pcl_utils::cloudptr_from_refptr(finput_);
 	} else if (pcl_manager->exists_pointcloud<ColorPointType>(cfg_input_pointcloud_.c_str())) {
@@ -310,6 +339,7 @@ TabletopObjectsThread::finalize()
 	pos_ifs_.clear();
 
 	finput_.reset();
+	finput_buffer_.reset();
 	fclusters_.reset();
 	ftable_model_.reset();
 	fsimplified_polygon_.reset();
@@ -388,6 +418,14 @@ TabletopObjectsThread::loop()
 
 	TIMETRACK_END(ttc_msgproc_);
 
+	if (finput_buffer_) {
+		// keep a snapshot of the newest cloud for this loop, the producer
+		// meanwhile fills another buffer
+		if (finput_buffer_->snapshot_if_newer(input_generation_, finput_, input_generation_)) {
+			input_ = pcl_utils::cloudptr_from_refptr(finput_);
+		}
+	}
+
 	fawkes::Time pcl_time;
 	if (colored_input_) {
 		pcl_utils::get_time(colored_input_, pcl_time);
@@ -445,6 +483,11 @@ TabletopObjectsThread::loop()
 	// Planes found along the way not satisfying any of the criteria are removed,
 	// the first plane either satisfying all criteria, or violating the first
 	// one end the loop
+	// If the table of the previous loop still fits well, it is only
+	// refined, the full RANSAC search is performed otherwise.
+	bool try_previous_plane = cfg_segm_reuse_plane_ && have_previous_plane_;
+	have_previous_plane_    = false;
+
 	bool happy_with_plane = false;
 	while (!happy_with_plane) {
 		happy_with_plane = true;
@@ -460,8 +503,11 @@ TabletopObjectsThread::loop()
 			return;
 		}
 
-		seg_.setInputCloud(temp_cloud);
-		seg_.segment(*inliers, *coeff);
+		if (!try_previous_plane || !refine_previous_plane(temp_cloud, *inliers, *coeff)) {
+			seg_.setInputCloud(temp_cloud);
+			seg_.segment(*inliers, *coeff);
+		}
+		try_previous_plane = false;
 
 		// 1. check for a minimum number of expected inliers
 		if ((double)inliers->indices.size()
@@ -559,6 +605,10 @@ TabletopObjectsThread::loop()
 	// Do NOT set it here, we will still try to determine the rotation as well
 	// set_position(table_pos_if_, true, table_centroid);
 
+	previous_plane_coeff_ = coeff->values;
+	previous_plane_quota_ = (float)inliers->indices.size() / temp_cloud->points.size();
+	have_previous_plane_  = true;
+
 	TIMETRACK_INTER(ttc_plane_, ttc_extract_plane_)
 
 	extract_.setNegative(false);
@@ -683,7 +733,7 @@ TabletopObjectsThread::loop()
 
 		// Transform polygon cloud into base_link frame
 		CloudPtr baserel_polygon_cloud(new Cloud());
-		pcl::transformPointCloud(*cloud_hull_, *baserel_polygon_cloud, affine_cloud);
+		pcl_utils::transform_pointcloud(*cloud_hull_, *baserel_polygon_cloud, affine_cloud);
 
 		// Setup plane normals for left, right, and lower frustrum
 		// planes for line segment verification
@@ -979,7 +1029,7 @@ TabletopObjectsThread::loop()
 			CloudPtr table_model = generate_table_model(cfg_table_model_length_,
 			                                            cfg_table_model_width_,
 			                                            cfg_table_model_step_);
-			pcl::transformPointCloud(*table_model, *table_model_, affine.matrix());
+			pcl_utils::transform_pointcloud(*table_model, *table_model_, affine);
 			//*table_model_ = *model_cloud_hull_;
 			//*table_model_ = *table_model;
 			table_model_->header.frame_id = input_->header.frame_id;
@@ -1259,62 +1309,39 @@ TabletopObjectsThread::cluster_objects(CloudConstPtr               input_cloud,
 	CentroidMap tmp_centroids;
 
 	if (num_points > 0) {
-		std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f>> new_centroids(
-		  MAX_CENTROIDS);
-
-		unsigned int centroid_i = 0;
-
-		std::vector<double> init_likelihoods;
-		init_likelihoods.resize(NUM_KNOWN_OBJS_ + 1, 0.0);
-		for (uint i = 0; i < MAX_CENTROIDS; i++)
-			obj_likelihoods_[i] = init_likelihoods;
-
-		for (it = cluster_indices.begin(); it != cluster_indices.end() && centroid_i < MAX_CENTROIDS;
-		     ++it, ++centroid_i) {
-			logger->log_debug(name(),
-			                  "********************Processing obj_%u********************",
-			                  centroid_i);
-
-			//Centroids in cam frame:
-			//pcl::compute3DCentroid(*cloud_objs_, it->indices, centroids[centroid_i]);
-
-			// TODO fix this; we only want to copy the cluster, the color is incorrect
-			ColorCloudPtr single_cluster =
-			  colorize_cluster(input_cloud, it->indices, cluster_colors[centroid_i]);
-			single_cluster->header.frame_id = input_cloud->header.frame_id;
-			single_cluster->width           = it->indices.size();
-			single_cluster->height          = 1;
-
-			ColorCloudPtr obj_in_base_frame(new ColorCloud());
-			obj_in_base_frame->header.frame_id = cfg_base_frame_;
-			obj_in_base_frame->width           = it->indices.size();
-			obj_in_base_frame->height          = 1;
-			obj_in_base_frame->points.resize(it->indices.size());
-
-			// don't add cluster here since the id is wrong
-			//*obj_clusters_[obj_i++] = *single_cluster;
-
-			pcl_utils::transform_pointcloud(cfg_base_frame_,
-			                                *single_cluster,
-			                                *obj_in_base_frame,
-			                                *tf_listener);
-
-			pcl::compute3DCentroid(*obj_in_base_frame, new_centroids[centroid_i]);
-
-			if (cfg_cylinder_fitting_) {
-				new_centroids[centroid_i] =
-				  fit_cylinder(obj_in_base_frame, new_centroids[centroid_i], centroid_i);
+		object_count = std::min<size_t>(cluster_indices.size(), MAX_CENTROIDS);
+
+		// all clusters are transformed with the same, latest transform
+		tf::StampedTransform to_base;
+		tf_listener->lookup_transform(cfg_base_frame_,
+		                              input_cloud->header.frame_id,
+		                              fawkes::Time(0, 0),
+		                              to_base);
+
+		// clusters are independent of each other, process them in parallel,
+		// each worker thread uses its own workspace
+		cluster_results_.resize(object_count);
+#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < (int)object_count; ++i) {
+#ifdef _OPENMP
+			ClusterWorkspace &ws = cluster_workspaces_[omp_get_thread_num()];
+#else
+			ClusterWorkspace &ws = cluster_workspaces_[0];
+#endif
+			try {
+				process_cluster(input_cloud, cluster_indices[i].indices, to_base, ws, cluster_results_[i]);
+			} catch (std::exception &e) {
+				// must not leave the parallel region
+				logger->log_warn(name(), "Processing object %i failed: %s", i, e.what());
 			}
 		}
-		object_count = centroid_i;
-		new_centroids.resize(object_count);
-
-		// save cylinder fitting variables
-		// to temporary variables to be able to reassign IDs
-		CentroidMap                         cylinder_params(cylinder_params_);
-		std::map<uint, signed int>          best_obj_guess(best_obj_guess_);
-		std::map<uint, double>              obj_shape_confidence(obj_shape_confidence_);
-		std::map<uint, std::vector<double>> obj_likelihoods(obj_likelihoods_);
+
+		std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f>> new_centroids(
+		  object_count);
+		for (unsigned int i = 0; i < object_count; ++i) {
+			new_centroids[i] = cluster_results_[i].centroid;
+		}
+
 		cylinder_params_.clear();
 		best_obj_guess_.clear();
 		obj_shape_confidence_.clear();
@@ -1342,10 +1369,10 @@ TabletopObjectsThread::cluster_objects(CloudConstPtr               input_cloud,
 			if (assigned_id == -1)
 				continue;
 			tmp_centroids[assigned_id]         = new_centroids[i];
-			cylinder_params_[assigned_id]      = cylinder_params[i];
-			obj_shape_confidence_[assigned_id] = obj_shape_confidence[i];
-			best_obj_guess_[assigned_id]       = best_obj_guess[i];
-			obj_likelihoods_[assigned_id]      = obj_likelihoods[i];
+			cylinder_params_[assigned_id]      = cluster_results_[i].cylinder_params;
+			obj_shape_confidence_[assigned_id] = cluster_results_[i].shape_confidence;
+			best_obj_guess_[assigned_id]       = cluster_results_[i].best_obj_guess;
+			obj_likelihoods_[assigned_id]      = cluster_results_[i].likelihoods;
 			ColorCloudPtr colorized_cluster =
 			  colorize_cluster(input_cloud,
 			                   cluster_indices[i].indices,
@@ -1370,6 +1397,96 @@ TabletopObjectsThread::cluster_objects(CloudConstPtr               input_cloud,
 	return object_count;
 }
 
+/** Process a single object cluster.
+ * Determines the centroid of the cluster in the base frame and, if
+ * enabled, fits a cylinder and guesses the object. This only accesses
+ * the given workspace and result and may run in parallel for
+ * different clusters.
+ * @param input_cloud cloud the cluster was extracted from
+ * @param indices indices of the cluster points in @p input_cloud
+ * @param to_base transform from the input cloud to the base frame
+ * @param ws workspace of the calling worker thread
+ * @param result upon return contains the result for the cluster
+ */
+void
+TabletopObjectsThread::process_cluster(CloudConstPtr               input_cloud,
+                                       const std::vector<int> &    indices,
+                                       const tf::StampedTransform &to_base,
+                                       ClusterWorkspace &          ws,
+                                       ClusterResult &             result)
+{
+	result.centroid.setZero();
+	result.cylinder_params.setZero();
+	result.shape_confidence = 0.;
+	result.best_obj_guess   = -1;
+	result.likelihoods.assign(NUM_KNOWN_OBJS_ + 1, 0.0);
+
+	// reuse the memory of the workspace cloud, only the coordinates are
+	// copied, the color does not matter here
+	ColorCloud &obj = *ws.obj_in_base_frame;
+	obj.points.resize(indices.size());
+	for (size_t i = 0; i < indices.size(); ++i) {
+		const PointType &p = input_cloud->points[indices[i]];
+		obj.points[i].x    = p.x;
+		obj.points[i].y    = p.y;
+		obj.points[i].z    = p.z;
+	}
+	obj.width           = indices.size();
+	obj.height          = 1;
+	obj.is_dense        = false;
+	obj.header.frame_id = cfg_base_frame_;
+	pcl_utils::transform_pointcloud(obj, to_base);
+
+	pcl::compute3DCentroid(obj, result.centroid);
+
+	if (cfg_cylinder_fitting_) {
+		fit_cylinder(ws, result);
+	}
+}
+
+/** Refine the table plane of the previous loop.
+ * If the camera and the table did not move, the previous plane still
+ * holds most of the points. In that case, the plane is only refined by
+ * a least squares fit to its inliers instead of searching for it from
+ * scratch with RANSAC.
+ * @param cloud cloud to find the plane in
+ * @param inliers upon success contains the inliers of the refined plane
+ * @param coeff upon success contains the refined plane coefficients
+ * @return true if the previous plane has been refined, false if it does
+ * not match the cloud anymore
+ */
+bool
+TabletopObjectsThread::refine_previous_plane(CloudConstPtr           cloud,
+                                             pcl::PointIndices &     inliers,
+                                             pcl::ModelCoefficients &coeff)
+{
+	pcl::SampleConsensusModelPlane<PointType> model(cloud);
+
+	Eigen::VectorXf previous(4);
+	for (unsigned int i = 0; i < 4; ++i) {
+		previous[i] = previous_plane_coeff_[i];
+	}
+	model.selectWithinDistance(previous, cfg_segm_distance_threshold_, inliers.indices);
+
+	// tolerate some noise, but if a significant part of the table is
+	// missing, something moved and the plane must be searched again
+	float quota = (float)inliers.indices.size() / cloud->points.size();
+	if ((quota < cfg_segm_inlier_quota_) || (quota < 0.9 * previous_plane_quota_)) {
+		return false;
+	}
+
+	Eigen::VectorXf refined;
+	model.optimizeModelCoefficients(inliers.indices, previous, refined);
+	model.selectWithinDistance(refined, cfg_segm_distance_threshold_, inliers.indices);
+
+	coeff.values.resize(4);
+	for (unsigned int i = 0; i < 4; ++i) {
+		coeff.values[i] = refined[i];
+	}
+	coeff.header = cloud->header;
+	return true;
+}
+
 TabletopObjectsThread::ColorCloudPtr
 TabletopObjectsThread::colorize_cluster(CloudConstPtr           input_cloud,
                                         const std::vector<int> &cluster,
@@ -1710,12 +1827,11 @@ TabletopObjectsThread::remove_high_centroids(Eigen::Vector4f table_centroid, Cen
 	}
 }
 
-Eigen::Vector4f
-TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
-                                    Eigen::Vector4f const &centroid,
-                                    uint const &           centroid_i)
+void
+TabletopObjectsThread::fit_cylinder(ClusterWorkspace &ws, ClusterResult &result)
 {
-	Eigen::Vector4f                                                         new_centroid(centroid);
+	ColorCloudConstPtr obj_in_base_frame = ws.obj_in_base_frame;
+
 	ColorPointType                                                          pnt_min, pnt_max;
 	Eigen::Vector3f                                                         obj_dim;
 	std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f>> obj_size_scores;
@@ -1735,7 +1851,7 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 		                  obj_size_scores[os][0],
 		                  obj_size_scores[os][1],
 		                  obj_size_scores[os][2]);
-		obj_likelihoods_[centroid_i][os] =
+		result.likelihoods[os] =
 		  (double)obj_size_scores[os][0] * obj_size_scores[os][1] * obj_size_scores[os][2];
 	}
 
@@ -1744,10 +1860,10 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 	pcl::SACSegmentationFromNormals<ColorPointType, pcl::Normal> seg;
 	pcl::ExtractIndices<ColorPointType>                          extract;
 	pcl::ExtractIndices<pcl::Normal>                             extract_normals;
-	pcl::PointCloud<pcl::Normal>::Ptr        obj_normals(new pcl::PointCloud<pcl::Normal>);
-	pcl::search::KdTree<ColorPointType>::Ptr tree_cyl(new pcl::search::KdTree<ColorPointType>());
-	pcl::ModelCoefficients::Ptr              coefficients_cylinder(new pcl::ModelCoefficients);
-	pcl::PointIndices::Ptr                   inliers_cylinder(new pcl::PointIndices);
+	pcl::PointCloud<pcl::Normal>::Ptr        obj_normals           = ws.normals;
+	pcl::search::KdTree<ColorPointType>::Ptr tree_cyl              = ws.kdtree;
+	pcl::ModelCoefficients::Ptr              coefficients_cylinder = ws.coefficients;
+	pcl::PointIndices::Ptr                   inliers_cylinder      = ws.inliers;
 
 	// Estimate point normals
 	ne.setSearchMethod(tree_cyl);
@@ -1776,27 +1892,26 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 	extract.setInputCloud(obj_in_base_frame);
 	extract.setIndices(inliers_cylinder);
 	extract.setNegative(false);
-	pcl::PointCloud<ColorPointType>::Ptr cloud_cylinder_baserel(
-	  new pcl::PointCloud<ColorPointType>());
+	pcl::PointCloud<ColorPointType>::Ptr cloud_cylinder_baserel = ws.cylinder_inliers;
 	extract.filter(*cloud_cylinder_baserel);
 
-	cylinder_params_[centroid_i][0] = 0;
-	cylinder_params_[centroid_i][1] = 0;
+	result.cylinder_params[0] = 0;
+	result.cylinder_params[1] = 0;
 	if (cloud_cylinder_baserel->points.empty()) {
 		logger->log_debug(name(), "No cylinder inliers!!");
-		obj_shape_confidence_[centroid_i] = 0.0;
+		result.shape_confidence = 0.0;
 	} else {
 		if (!tf_listener->frame_exists(cloud_cylinder_baserel->header.frame_id)) {
-			return centroid;
+			return;
 		}
 
-		obj_shape_confidence_[centroid_i] =
+		result.shape_confidence =
 		  (double)(cloud_cylinder_baserel->points.size()) / (obj_in_base_frame->points.size() * 1.0);
 		logger->log_debug(name(),
 		                  "Cylinder fit confidence = %zu/%zu = %f",
 		                  cloud_cylinder_baserel->points.size(),
 		                  obj_in_base_frame->points.size(),
-		                  obj_shape_confidence_[centroid_i]);
+		                  result.shape_confidence);
 
 		ColorPointType pnt_min;
 		ColorPointType pnt_max;
@@ -1812,35 +1927,35 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 			logger->log_debug(name(), "Cylinder radius according to bounding box y: %f", obj_dim[1] / 2);
 		}
 		//Cylinder radius:
-		//cylinder_params_[centroid_i][0] = (*coefficients_cylinder).values[6];
-		cylinder_params_[centroid_i][0] = obj_dim[1] / 2;
+		//result.cylinder_params[0] = (*coefficients_cylinder).values[6];
+		result.cylinder_params[0] = obj_dim[1] / 2;
 		//Cylinder height:
-		//cylinder_params_[centroid_i][1] = (pnt_max->z - pnt_min->z);
-		cylinder_params_[centroid_i][1] = obj_dim[2];
+		//result.cylinder_params[1] = (pnt_max->z - pnt_min->z);
+		result.cylinder_params[1] = obj_dim[2];
 
-		//cylinder_params_[centroid_i][2] = table_inclination_;
+		//result.cylinder_params[2] = table_inclination_;
 
 		//Overriding computed centroids with estimated cylinder center:
-		new_centroid[0] = pnt_min.x + 0.5 * (pnt_max.x - pnt_min.x);
-		new_centroid[1] = pnt_min.y + 0.5 * (pnt_max.y - pnt_min.y);
-		new_centroid[2] = pnt_min.z + 0.5 * (pnt_max.z - pnt_min.z);
+		result.centroid[0] = pnt_min.x + 0.5 * (pnt_max.x - pnt_min.x);
+		result.centroid[1] = pnt_min.y + 0.5 * (pnt_max.y - pnt_min.y);
+		result.centroid[2] = pnt_min.z + 0.5 * (pnt_max.z - pnt_min.z);
 	}
 
 	signed int detected_obj_id = -1;
 	double     best_confidence = 0.0;
 	if (cfg_verbose_cylinder_fitting_) {
-		logger->log_debug(name(), "Shape similarity = %f", obj_shape_confidence_[centroid_i]);
+		logger->log_debug(name(), "Shape similarity = %f", result.shape_confidence);
 	}
 	for (int os = 0; os < NUM_KNOWN_OBJS_; os++) {
 		if (cfg_verbose_cylinder_fitting_) {
 			logger->log_debug(name(), "** Similarity to known cup %i:", os);
-			logger->log_debug(name(), "Size similarity  = %f", obj_likelihoods_[centroid_i][os]);
-			obj_likelihoods_[centroid_i][os] =
-			  (0.6 * obj_likelihoods_[centroid_i][os]) + (0.4 * obj_shape_confidence_[centroid_i]);
-			logger->log_debug(name(), "Overall similarity = %f", obj_likelihoods_[centroid_i][os]);
+			logger->log_debug(name(), "Size similarity  = %f", result.likelihoods[os]);
+			result.likelihoods[os] =
+			  (0.6 * result.likelihoods[os]) + (0.4 * result.shape_confidence);
+			logger->log_debug(name(), "Overall similarity = %f", result.likelihoods[os]);
 		}
-		if (obj_likelihoods_[centroid_i][os] > best_confidence) {
-			best_confidence = obj_likelihoods_[centroid_i][os];
+		if (result.likelihoods[os] > best_confidence) {
+			best_confidence = result.likelihoods[os];
 			detected_obj_id = os;
 		}
 	}
@@ -1848,7 +1963,7 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 		logger->log_debug(name(), "********************Object Result********************");
 	}
 	if (best_confidence > 0.6) {
-		best_obj_guess_[centroid_i] = detected_obj_id;
+		result.best_obj_guess = detected_obj_id;
 
 		if (cfg_verbose_cylinder_fitting_) {
 			logger->log_debug(name(),
@@ -1856,7 +1971,7 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 			                  detected_obj_id);
 		}
 	} else {
-		best_obj_guess_[centroid_i] = -1;
+		result.best_obj_guess = -1;
 		if (cfg_verbose_cylinder_fitting_) {
 			logger->log_debug(name(), "No match found.");
 		}
@@ -1864,8 +1979,6 @@ TabletopObjectsThread::fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
 	if (cfg_verbose_cylinder_fitting_) {
 		logger->log_debug(name(), "*****************************************************");
 	}
-
-	return new_centroid;
 }
 
 /**
@@ -40,6 +40,7 @@
 #include <pcl/point_types.h>
 #include <pcl/sample_consensus/method_types.h>
 #include <pcl/sample_consensus/model_types.h>
+#include <pcl/search/kdtree.h>
 #include <pcl/segmentation/sac_segmentation.h>
 
 #include <Eigen/StdVector>
@@ -183,6 +184,29 @@ private:
 	typedef std::list<OldCentroid, Eigen::aligned_allocator<OldCentroid>> OldCentroidVector;
 	typedef std::vector<fawkes::Position3DInterface *>                    PosIfsVector;
 
+	/// @cond INTERNAL
+	struct ClusterResult
+	{
+		Eigen::Vector4f     centroid;
+		Eigen::Vector4f     cylinder_params;
+		double              shape_confidence;
+		signed int          best_obj_guess;
+		std::vector<double> likelihoods;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	struct ClusterWorkspace
+	{
+		ColorCloudPtr                            obj_in_base_frame;
+		ColorCloudPtr                            cylinder_inliers;
+		pcl::PointCloud<pcl::Normal>::Ptr        normals;
+		pcl::search::KdTree<ColorPointType>::Ptr kdtree;
+		pcl::PointIndices::Ptr                   inliers;
+		pcl::ModelCoefficients::Ptr              coefficients;
+	};
+	/// @endcond
+
 private:
 	void set_position(fawkes::Position3DInterface *iface,
 	                  bool                         is_visible,
@@ -219,15 +243,21 @@ private:
 	unsigned int cluster_objects(CloudConstPtr               input,
 	                             ColorCloudPtr               tmp_clusters,
 	                             std::vector<ColorCloudPtr> &tmp_obj_clusters);
+	void         process_cluster(CloudConstPtr               input_cloud,
+	                             const std::vector<int> &    indices,
+	                             const tf::StampedTransform &to_base,
+	                             ClusterWorkspace &          ws,
+	                             ClusterResult &             result);
+	bool         refine_previous_plane(CloudConstPtr           cloud,
+	                                   pcl::PointIndices &     inliers,
+	                                   pcl::ModelCoefficients &coeff);
 
 	int  next_id();
 	void delete_old_centroids(OldCentroidVector centroids, unsigned int age);
 	void
 	delete_near_centroids(CentroidMap reference, OldCentroidVector centroids, float min_distance);
-	void            remove_high_centroids(Eigen::Vector4f table_centroid, CentroidMap centroids);
-	Eigen::Vector4f fit_cylinder(ColorCloudConstPtr     obj_in_base_frame,
-	                             Eigen::Vector4f const &centroid,
-	                             uint const &           centroid_i);
+	void remove_high_centroids(Eigen::Vector4f table_centroid, CentroidMap centroids);
+	void fit_cylinder(ClusterWorkspace &ws, ClusterResult &result);
 	std::map<unsigned int, int> track_objects(
 	  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f>> new_centroids);
 
@@ -248,6 +278,9 @@ private:
 	CloudConstPtr                                         input_;
 	pcl::PointCloud<ColorPointType>::Ptr                  clusters_;
 
+	fawkes::RefPtr<fawkes::pcl_utils::PointCloudBuffer<PointType>> finput_buffer_;
+	unsigned int                                                    input_generation_;
+
 	std::vector<fawkes::RefPtr<pcl::PointCloud<ColorPointType>>> f_obj_clusters_;
 	std::vector<pcl::PointCloud<ColorPointType>::Ptr>            obj_clusters_;
 	std::map<unsigned int, double>                               obj_shape_confidence_;
@@ -263,6 +296,10 @@ private:
 	pcl::VoxelGrid<PointType>       grid_;
 	pcl::SACSegmentation<PointType> seg_;
 
+	std::vector<float> previous_plane_coeff_;
+	float              previous_plane_quota_;
+	bool               have_previous_plane_;
+
 	PosIfsVector                 pos_ifs_;
 	fawkes::Position3DInterface *table_pos_if_;
 
@@ -280,6 +317,7 @@ private:
 	unsigned int cfg_segm_max_iterations_;
 	float        cfg_segm_distance_threshold_;
 	float        cfg_segm_inlier_quota_;
+	bool         cfg_segm_reuse_plane_;
 	float        cfg_max_z_angle_deviation_;
 	float        cfg_table_min_cluster_quota_;
 	float        cfg_table_downsample_leaf_size_;
@@ -320,6 +358,9 @@ private:
 
 	std::map<uint, std::vector<double>> obj_likelihoods_;
 
+	std::vector<ClusterResult, Eigen::aligned_allocator<ClusterResult>> cluster_results_;
+	std::vector<ClusterWorkspace>                                       cluster_workspaces_;
+
 #ifdef USE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
 	unsigned int         tt_loopcount_;
@@ -27,8 +27,8 @@
 #include <config/netconf.h>
 #include <core/threading/mutex_locker.h>
 #include <logging/console.h>
+#include <navgraph/binary_navgraph.h>
 #include <navgraph/navgraph.h>
-#include <navgraph/yaml_navgraph.h>
 #include <netcomm/fawkes/client.h>
 #include <utils/system/fam.h>
 #include <utils/time/clock.h>
@@ -116,7 +116,7 @@ FawkesRemotePlexilAdapter::initialize()
 	p                      = fs::absolute(p);
 	cfg_navgraph_filename_ = p.string();
 	logger_->log_info("FawkesRemote", "Loading navgraph file %s", cfg_navgraph_filename_.c_str());
-	navgraph_ = load_yaml_navgraph(cfg_navgraph_filename_, cfg_navgraph_allow_multi);
+	navgraph_ = load_navgraph(cfg_navgraph_filename_, cfg_navgraph_allow_multi);
 
 	fs::create_directories(p.parent_path());
 	navgraph_fam_ = std::make_unique<fawkes::FileAlterationMonitor>();
@@ -164,7 +164,7 @@ FawkesRemotePlexilAdapter::fam_event(const char *filename, unsigned int mask)
 
 		try {
 			fawkes::LockPtr<fawkes::NavGraph> new_graph =
-			  fawkes::LockPtr<fawkes::NavGraph>(fawkes::load_yaml_navgraph(cfg_navgraph_filename_),
+			  fawkes::LockPtr<fawkes::NavGraph>(fawkes::load_navgraph(cfg_navgraph_filename_),
 			                                    /* recursive mutex */ true);
 
 			// disable notifications to not trigger them while navgraph is locked
@@ -25,6 +25,9 @@
 
 #include <interfaces/SwitchInterface.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace fawkes;
 
 /** @class Realsense2Thread 'realsense2_thread.h'
@@ -56,6 +59,41 @@ Realsense2Thread::init()
 
 	cfg_use_switch_ = config->get_bool_or_default((cfg_prefix + "use_switch").c_str(), true);
 
+	cfg_publish_full_ = config->get_bool_or_default((cfg_prefix + "publish_full").c_str(), true);
+
+	const std::string reduced_prefix = cfg_prefix + "reduced/";
+	cfg_reduced_    = config->get_bool_or_default((reduced_prefix + "enable").c_str(), false);
+	reduced_pcl_id_ = config->get_string_or_default((reduced_prefix + "pcl_id").c_str(),
+	                                                "/camera/depth/points_reduced");
+
+	cfg_reduced_decimation_ =
+	  config->get_uint_or_default((reduced_prefix + "decimation").c_str(), 1);
+	cfg_reduced_frame_divisor_ =
+	  config->get_uint_or_default((reduced_prefix + "frame_divisor").c_str(), 1);
+
+	cfg_reduced_min_depth_ =
+	  config->get_float_or_default((reduced_prefix + "min_depth").c_str(), 0.);
+	cfg_reduced_max_depth_ =
+	  config->get_float_or_default((reduced_prefix + "max_depth").c_str(), 0.);
+
+	cfg_reduced_roi_x_ = config->get_uint_or_default((reduced_prefix + "roi/x").c_str(), 0);
+	cfg_reduced_roi_y_ = config->get_uint_or_default((reduced_prefix + "roi/y").c_str(), 0);
+	cfg_reduced_roi_width_ =
+	  config->get_uint_or_default((reduced_prefix + "roi/width").c_str(), 0);
+	cfg_reduced_roi_height_ =
+	  config->get_uint_or_default((reduced_prefix + "roi/height").c_str(), 0);
+
+	if (cfg_reduced_decimation_ < 1 || cfg_reduced_decimation_ > 8) {
+		throw Exception("Invalid decimation %u, must be in the range 1 to 8",
+		                cfg_reduced_decimation_);
+	}
+	if (cfg_reduced_frame_divisor_ < 1) {
+		cfg_reduced_frame_divisor_ = 1;
+	}
+	if (!cfg_publish_full_ && !cfg_reduced_) {
+		throw Exception("Neither the full nor the reduced point cloud is enabled");
+	}
+
 	if (cfg_use_switch_) {
 		logger->log_info(name(), "Switch enabled");
 	} else {
@@ -67,14 +105,23 @@ Realsense2Thread::init()
 	switch_if_->write();
 
 	camera_scale_ = 1;
-	// initalize pointcloud
-	realsense_depth_refptr_           = new Cloud();
-	realsense_depth_                  = pcl_utils::cloudptr_from_refptr(realsense_depth_refptr_);
-	realsense_depth_->header.frame_id = frame_id_;
-	realsense_depth_->width           = 0;
-	realsense_depth_->height          = 0;
-	realsense_depth_->resize(0);
-	pcl_manager->add_pointcloud(pcl_id_.c_str(), realsense_depth_refptr_);
+	// initalize pointclouds
+	if (cfg_publish_full_) {
+		realsense_depth_ = pcl_manager->add_pointcloud_buffer<PointType>(pcl_id_.c_str());
+		publish_empty(realsense_depth_);
+	}
+	if (cfg_reduced_) {
+		reduced_depth_ = pcl_manager->add_pointcloud_buffer<PointType>(reduced_pcl_id_.c_str());
+		publish_empty(reduced_depth_);
+		if (cfg_reduced_decimation_ > 1) {
+			decimation_filter_.set_option(RS2_OPTION_FILTER_MAGNITUDE, cfg_reduced_decimation_);
+		}
+		reduced_frame_count_ = 0;
+		logger->log_info(name(),
+		                 "Reduced point cloud: decimation %u, every %u. frame",
+		                 cfg_reduced_decimation_,
+		                 cfg_reduced_frame_divisor_);
+	}
 
 	rs_pipe_    = new rs2::pipeline();
 	rs_context_ = new rs2::context();
@@ -104,22 +151,14 @@ Realsense2Thread::loop()
 	if (rs_pipe_->poll_for_frames(&rs_data_)) {
 		rs2::frame depth_frame = rs_data_.first(RS2_STREAM_DEPTH);
 		error_counter_         = 0;
-		const uint16_t *image  = reinterpret_cast<const uint16_t *>(depth_frame.get_data());
-		Cloud::iterator it     = realsense_depth_->begin();
-		for (int y = 0; y < intrinsics_.height; y++) {
-			for (int x = 0; x < intrinsics_.width; x++) {
-				float scaled_depth = camera_scale_ * (static_cast<float>(*image));
-				float depth_point[3];
-				float depth_pixel[2] = {static_cast<float>(x), static_cast<float>(y)};
-				rs2_deproject_pixel_to_point(depth_point, &intrinsics_, depth_pixel, scaled_depth);
-				it->x = depth_point[0];
-				it->y = depth_point[1];
-				it->z = depth_point[2];
-				++image;
-				++it;
-			}
+		fawkes::Time now(clock);
+		if (cfg_publish_full_) {
+			publish_full_cloud(depth_frame, now);
+		}
+		if (cfg_reduced_ && ++reduced_frame_count_ >= cfg_reduced_frame_divisor_) {
+			reduced_frame_count_ = 0;
+			publish_reduced_cloud(depth_frame, now);
 		}
-		pcl_utils::set_time(realsense_depth_refptr_, fawkes::Time(clock));
 	} else {
 		error_counter_++;
 		logger->log_warn(name(), "Poll for frames not successful ()");
@@ -138,11 +177,139 @@ Realsense2Thread::finalize()
 	stop_camera();
 	delete rs_pipe_;
 	delete rs_context_;
-	realsense_depth_refptr_.reset();
-	pcl_manager->remove_pointcloud(pcl_id_.c_str());
+	if (cfg_publish_full_) {
+		realsense_depth_.reset();
+		pcl_manager->remove_pointcloud(pcl_id_.c_str());
+	}
+	if (cfg_reduced_) {
+		reduced_depth_.reset();
+		pcl_manager->remove_pointcloud(reduced_pcl_id_.c_str());
+	}
 	blackboard->close(switch_if_);
 }
 
+/* Publish an empty cloud, such that readers find a valid cloud before
+ * the first frame has been received.
+ * @param buffer point cloud buffer to publish to
+ */
+void
+Realsense2Thread::publish_empty(fawkes::RefPtr<CloudBuffer> &buffer)
+{
+	fawkes::RefPtr<Cloud> cloud = buffer->back();
+	cloud->header.frame_id      = frame_id_;
+	cloud->width                = 0;
+	cloud->height               = 0;
+	cloud->resize(0);
+	buffer->publish();
+}
+
+/* Convert a depth frame to an organized cloud of the full resolution.
+ * @param depth_frame depth frame to convert
+ * @param time time to stamp the cloud with
+ */
+void
+Realsense2Thread::publish_full_cloud(const rs2::frame &depth_frame, const fawkes::Time &time)
+{
+	const uint16_t *image = reinterpret_cast<const uint16_t *>(depth_frame.get_data());
+	// fill the back buffer, readers keep the previous cloud meanwhile
+	fawkes::RefPtr<Cloud> cloud = realsense_depth_->back();
+	cloud->header.frame_id      = frame_id_;
+	cloud->width                = intrinsics_.width;
+	cloud->height               = intrinsics_.height;
+	cloud->resize(intrinsics_.width * intrinsics_.height);
+	Cloud::iterator it = cloud->begin();
+	for (int y = 0; y < intrinsics_.height; y++) {
+		for (int x = 0; x < intrinsics_.width; x++) {
+			float scaled_depth = camera_scale_ * (static_cast<float>(*image));
+			float depth_point[3];
+			float depth_pixel[2] = {static_cast<float>(x), static_cast<float>(y)};
+			rs2_deproject_pixel_to_point(depth_point, &intrinsics_, depth_pixel, scaled_depth);
+			it->x = depth_point[0];
+			it->y = depth_point[1];
+			it->z = depth_point[2];
+			++image;
+			++it;
+		}
+	}
+	pcl_utils::set_time(cloud, time);
+	cloud.reset();
+	realsense_depth_->publish();
+}
+
+/* Convert a depth frame to the reduced cloud.
+ * The frame is decimated by the librealsense decimation filter before
+ * conversion. Only pixels within the region of interest and with a
+ * valid depth within the configured range are converted, the result is
+ * an unorganized, dense cloud.
+ * @param depth_frame depth frame to convert
+ * @param time time to stamp the cloud with
+ */
+void
+Realsense2Thread::publish_reduced_cloud(const rs2::frame &depth_frame, const fawkes::Time &time)
+{
+	rs2::frame frame = depth_frame;
+	if (cfg_reduced_decimation_ > 1) {
+		frame = decimation_filter_.process(frame);
+	}
+	// the decimation filter updates the intrinsics of its output
+	rs2_intrinsics intrinsics = frame.get_profile().as<rs2::video_stream_profile>().get_intrinsics();
+
+	// region of interest is given in pixels of the full resolution
+	float        sx     = (float)intrinsics.width / intrinsics_.width;
+	float        sy     = (float)intrinsics.height / intrinsics_.height;
+	unsigned int width  = intrinsics.width;
+	unsigned int height = intrinsics.height;
+	unsigned int x_min  = std::min<unsigned int>(cfg_reduced_roi_x_ * sx, width);
+	unsigned int y_min  = std::min<unsigned int>(cfg_reduced_roi_y_ * sy, height);
+	unsigned int x_max  = width;
+	unsigned int y_max  = height;
+	if (cfg_reduced_roi_width_ > 0) {
+		x_max = std::min<unsigned int>((cfg_reduced_roi_x_ + cfg_reduced_roi_width_) * sx, width);
+	}
+	if (cfg_reduced_roi_height_ > 0) {
+		y_max = std::min<unsigned int>((cfg_reduced_roi_y_ + cfg_reduced_roi_height_) * sy, height);
+	}
+
+	// depth range in raw units, zero is no measurement
+	uint16_t min_depth = std::max(1.f, std::ceil(cfg_reduced_min_depth_ / camera_scale_));
+	uint16_t max_depth = 0xFFFF;
+	if (cfg_reduced_max_depth_ > 0.) {
+		max_depth = std::min(65535.f, std::floor(cfg_reduced_max_depth_ / camera_scale_));
+	}
+
+	const uint16_t *image = reinterpret_cast<const uint16_t *>(frame.get_data());
+
+	fawkes::RefPtr<Cloud> cloud = reduced_depth_->back();
+	cloud->header.frame_id      = frame_id_;
+	cloud->resize((size_t)(x_max - x_min) * (y_max - y_min));
+	size_t num_points = 0;
+	for (unsigned int y = y_min; y < y_max; ++y) {
+		const uint16_t *line = image + (size_t)y * width;
+		for (unsigned int x = x_min; x < x_max; ++x) {
+			if (line[x] < min_depth || line[x] > max_depth) {
+				continue;
+			}
+			float depth_point[3];
+			float depth_pixel[2] = {static_cast<float>(x), static_cast<float>(y)};
+			rs2_deproject_pixel_to_point(depth_point,
+			                             &intrinsics,
+			                             depth_pixel,
+			                             camera_scale_ * line[x]);
+			PointType &p = cloud->points[num_points++];
+			p.x          = depth_point[0];
+			p.y          = depth_point[1];
+			p.z          = depth_point[2];
+		}
+	}
+	cloud->resize(num_points);
+	cloud->width    = num_points;
+	cloud->height   = 1;
+	cloud->is_dense = true;
+	pcl_utils::set_time(cloud, time);
+	cloud.reset();
+	reduced_depth_->publish();
+}
+
 /* Create RS context and start the depth stream
  * @return true when succesfull
  */
@@ -164,9 +331,6 @@ Realsense2Thread::start_camera()
 		auto                  depth_stream =
 		  rs_pipeline_profile_.get_stream(RS2_STREAM_DEPTH).as<rs2::video_stream_profile>();
 		intrinsics_              = depth_stream.get_intrinsics();
-		realsense_depth_->width  = intrinsics_.width;
-		realsense_depth_->height = intrinsics_.height;
-		realsense_depth_->resize(intrinsics_.width * intrinsics_.height);
 		rs2::depth_sensor sensor = rs_device_.first<rs2::depth_sensor>();
 		camera_scale_            = sensor.get_depth_scale();
 		logger->log_info(name(),
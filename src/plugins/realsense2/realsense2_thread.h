@@ -34,6 +34,7 @@
 #include <librealsense2/rsutil.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
+#include <pcl_utils/pointcloud_buffer.h>
 
 #include <librealsense2/rs.hpp>
 #include <librealsense2/rs_advanced_mode.hpp>
@@ -42,6 +43,7 @@
 
 namespace fawkes {
 class SwitchInterface;
+class Time;
 }
 
 class Realsense2Thread : public fawkes::Thread,
@@ -60,11 +62,21 @@ public:
 	virtual void loop();
 
 private:
+	typedef pcl::PointXYZ              PointType;
+	typedef pcl::PointCloud<PointType> Cloud;
+
+	typedef Cloud::Ptr                                      CloudPtr;
+	typedef Cloud::ConstPtr                                 CloudConstPtr;
+	typedef fawkes::pcl_utils::PointCloudBuffer<PointType> CloudBuffer;
+
 	bool start_camera();
 	bool get_camera(rs2::device &dev);
 	void enable_depth_stream();
 	void disable_depth_stream();
 	void stop_camera();
+	void publish_empty(fawkes::RefPtr<CloudBuffer> &buffer);
+	void publish_full_cloud(const rs2::frame &depth_frame, const fawkes::Time &time);
+	void publish_reduced_cloud(const rs2::frame &depth_frame, const fawkes::Time &time);
 
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
@@ -81,14 +93,9 @@ private:
 	fawkes::SwitchInterface *switch_if_;
 	bool                     cfg_use_switch_;
 
-	typedef pcl::PointXYZ              PointType;
-	typedef pcl::PointCloud<PointType> Cloud;
-
-	typedef Cloud::Ptr      CloudPtr;
-	typedef Cloud::ConstPtr CloudConstPtr;
-
-	fawkes::RefPtr<Cloud> realsense_depth_refptr_;
-	CloudPtr              realsense_depth_;
+	fawkes::RefPtr<CloudBuffer> realsense_depth_;
+	fawkes::RefPtr<CloudBuffer> reduced_depth_;
+	rs2::decimation_filter      decimation_filter_;
 
 	rs2::pipeline *rs_pipe_;
 	rs2::context * rs_context_;
@@ -107,6 +114,19 @@ private:
 	bool        depth_enabled_  = false;
 	uint        restart_after_num_errors_;
 	uint        error_counter_ = 0;
+
+	bool        cfg_publish_full_;
+	bool        cfg_reduced_;
+	std::string reduced_pcl_id_;
+	uint        cfg_reduced_decimation_;
+	uint        cfg_reduced_frame_divisor_;
+	float       cfg_reduced_min_depth_;
+	float       cfg_reduced_max_depth_;
+	uint        cfg_reduced_roi_x_;
+	uint        cfg_reduced_roi_y_;
+	uint        cfg_reduced_roi_width_;
+	uint        cfg_reduced_roi_height_;
+	uint        reduced_frame_count_;
 };
 
 #endif
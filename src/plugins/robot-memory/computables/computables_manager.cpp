@@ -28,8 +28,12 @@
 #include <plugins/robot-memory/robot_memory.h>
 #include <utils/time/tracker_macros.h>
 
+#include <algorithm>
+#include <bsoncxx/builder/basic/document.hpp>
 #include <chrono>
 #include <mongocxx/exception/operation_exception.hpp>
+#include <set>
+#include <vector>
 
 /** @class ComputablesManager  computables_manager.h
  *  This class manages registering computables and can check
@@ -41,6 +45,91 @@ using namespace fawkes;
 using namespace mongocxx;
 using namespace bsoncxx;
 
+/// @cond INTERNAL
+template <typename Builder>
+static void append_canonical_array(Builder &builder, const array::view &arr);
+
+// append document with keys sorted recursively, arrays keep their order
+template <typename Builder>
+static void
+append_canonical(Builder &builder, const document::view &doc)
+{
+	using namespace bsoncxx::builder;
+	std::vector<document::element> elements(doc.begin(), doc.end());
+	auto by_key = [](const document::element &a, const document::element &b) {
+		return a.key() < b.key();
+	};
+	std::sort(elements.begin(), elements.end(), by_key);
+	for (const document::element &e : elements) {
+		if (e.type() == type::k_document) {
+			builder.append(basic::kvp(e.key(), [&e](basic::sub_document subdoc) {
+				append_canonical(subdoc, e.get_document().view());
+			}));
+		} else if (e.type() == type::k_array) {
+			builder.append(basic::kvp(e.key(), [&e](basic::sub_array subarray) {
+				append_canonical_array(subarray, e.get_array().value);
+			}));
+		} else {
+			builder.append(basic::kvp(e.key(), e.get_value()));
+		}
+	}
+}
+
+template <typename Builder>
+static void
+append_canonical_array(Builder &builder, const array::view &arr)
+{
+	using namespace bsoncxx::builder;
+	for (const array::element &e : arr) {
+		if (e.type() == type::k_document) {
+			builder.append(
+			  [&e](basic::sub_document subdoc) { append_canonical(subdoc, e.get_document().view()); });
+		} else if (e.type() == type::k_array) {
+			builder.append(
+			  [&e](basic::sub_array subarray) { append_canonical_array(subarray, e.get_array().value); });
+		} else {
+			builder.append(e.get_value());
+		}
+	}
+}
+
+// JSON of the query with keys sorted, equal for equivalent queries
+static std::string
+canonical_query(const document::view &query)
+{
+	bsoncxx::builder::basic::document doc;
+	append_canonical(doc, query);
+	return to_json(doc.view());
+}
+
+// first path component of a field which must exist in any document
+// matching the query, empty if there is none
+static std::string
+identifying_field(const document::view &query)
+{
+	for (const document::element &e : query) {
+		std::string key = e.key().to_string();
+		if (key.empty() || key[0] == '$') {
+			continue;
+		}
+		bool required = (e.type() != type::k_null);
+		if (e.type() == type::k_document) {
+			document::view value = e.get_document().view();
+			std::string    op    = value.empty() ? "" : value.begin()->key().to_string();
+			if (!op.empty() && op[0] == '$') {
+				auto exists = value.find("$exists");
+				required    = exists != value.end() && exists->type() == type::k_bool
+				           && exists->get_bool().value;
+			}
+		}
+		if (required) {
+			return key.substr(0, key.find('.'));
+		}
+	}
+	return "";
+}
+/// @endcond
+
 /**
  * Constructor for class managing computables with refereces to plugin objects
  * @param config Configuration
@@ -94,6 +183,9 @@ ComputablesManager::~ComputablesManager()
 void
 ComputablesManager::remove_computable(Computable *computable)
 {
+	for (auto &i : computables_index_) {
+		i.second.remove(computable);
+	}
 	for (std::list<Computable *>::iterator it = computables.begin(); it != computables.end(); ++it) {
 		if ((*it) == computable) {
 			Computable *comp = *it;
@@ -104,6 +196,18 @@ ComputablesManager::remove_computable(Computable *computable)
 	}
 }
 
+/**
+ * Add computable to the index of computables by collection and identifying field.
+ * @param computable The computable to index
+ */
+void
+ComputablesManager::index_computable(Computable *computable)
+{
+	bsoncxx::document::value query = computable->get_query();
+	computables_index_[std::make_tuple(computable->get_collection(), identifying_field(query))]
+	  .push_back(computable);
+}
+
 /**
  * Checks if computable knowledge is queried and calls the compute functions in this case
  * @param query The query that might ask for computable knowledge
@@ -113,17 +217,29 @@ ComputablesManager::remove_computable(Computable *computable)
 bool
 ComputablesManager::check_and_compute(const document::view &query, std::string collection)
 {
+	if (collection.find(matching_test_collection_) != std::string::npos)
+		return false; //not necessary for matching test itself
 	//check if computation result of the query is already cached
-	for (std::map<std::tuple<std::string, std::string>, long long>::iterator it =
-	       cached_querries_.begin();
-	     it != cached_querries_.end();
-	     ++it) {
-		if (collection == std::get<0>(it->first) && to_json(query) == std::get<1>(it->first)) {
-			return false;
+	std::string canonical = canonical_query(query);
+	auto        cached    = cached_querries_.find(collection);
+	if (cached != cached_querries_.end() && cached->second.find(canonical) != cached->second.end()) {
+		return false;
+	}
+	//only computables with an identifying field present in the query can match
+	std::set<Computable *> candidates;
+	auto add_candidates = [this, &collection, &candidates](const std::string &field) {
+		auto c = computables_index_.find(std::make_tuple(collection, field));
+		if (c != computables_index_.end()) {
+			candidates.insert(c->second.begin(), c->second.end());
 		}
+	};
+	add_candidates("");
+	for (const document::element &e : query) {
+		std::string key = e.key().to_string();
+		add_candidates(key.substr(0, key.find('.')));
 	}
-	if (collection.find(matching_test_collection_) != std::string::npos)
-		return false; //not necessary for matching test itself
+	if (candidates.empty())
+		return false;
 	bool added_computed_docs = false;
 	//check if the query is matched by the computable identifyer
 	//to do that we just insert the query as if it would be a document and query for it with the computable identifiers
@@ -136,8 +252,10 @@ ComputablesManager::check_and_compute(const document::view &query, std::string c
 		return false;
 	}
 	for (std::list<Computable *>::iterator it = computables.begin(); it != computables.end(); ++it) {
+		if (candidates.find(*it) == candidates.end())
+			continue;
 		auto cursor = robot_memory_->query((*it)->get_query(), current_test_collection);
-		if (collection == (*it)->get_collection() && cursor.begin() != cursor.end()) {
+		if (cursor.begin() != cursor.end()) {
 			std::list<document::value> computed_docs_list = (*it)->compute(query);
 			if (!computed_docs_list.empty()) {
 				//move list into vector
@@ -147,8 +265,7 @@ ComputablesManager::check_and_compute(const document::view &query, std::string c
 				//remember how long a query is cached:
 				long long cached_until =
 				  computed_docs_vector[0]["_robmem_info"]["cached_until"].get_int64();
-				cached_querries_[std::make_tuple(collection, to_json(query))] = cached_until;
-				//TODO: fix minor problem: equivalent queries in different order jield unequal strings
+				cached_querries_[collection][canonical] = cached_until;
 				robot_memory_->insert(computed_docs_vector, (*it)->get_collection());
 				added_computed_docs = true;
 			}
@@ -167,25 +284,26 @@ ComputablesManager::cleanup_computed_docs()
 	TIMETRACK_START(ttc_cleanup_);
 	long long current_time_ms =
 	  std::chrono::system_clock::now().time_since_epoch() / std::chrono::milliseconds(1);
-	for (std::map<std::tuple<std::string, std::string>, long long>::iterator it =
-	       cached_querries_.begin();
-	     it != cached_querries_.end();
-	     ++it) {
-		TIMETRACK_START(ttc_cleanup_inner_loop_);
-		if (current_time_ms > it->second) {
-			using namespace bsoncxx::builder;
-			basic::document doc;
-			doc.append(basic::kvp("_robmem_info.computed", true));
-			doc.append(
-			  basic::kvp("_robmem_info.cached_until", [current_time_ms](basic::sub_document subdoc) {
-				  subdoc.append(basic::kvp("$lt", static_cast<std::int64_t>(current_time_ms)));
-			  }));
-			TIMETRACK_START(ttc_cleanup_remove_query_);
-			robot_memory_->remove(doc, std::get<0>(it->first));
-			TIMETRACK_END(ttc_cleanup_remove_query_);
-			cached_querries_.erase(it->first);
+	for (auto &c : cached_querries_) {
+		for (auto it = c.second.begin(); it != c.second.end();) {
+			TIMETRACK_START(ttc_cleanup_inner_loop_);
+			if (current_time_ms > it->second) {
+				using namespace bsoncxx::builder;
+				basic::document doc;
+				doc.append(basic::kvp("_robmem_info.computed", true));
+				doc.append(
+				  basic::kvp("_robmem_info.cached_until", [current_time_ms](basic::sub_document subdoc) {
+					  subdoc.append(basic::kvp("$lt", static_cast<std::int64_t>(current_time_ms)));
+				  }));
+				TIMETRACK_START(ttc_cleanup_remove_query_);
+				robot_memory_->remove(doc, c.first);
+				TIMETRACK_END(ttc_cleanup_remove_query_);
+				it = c.second.erase(it);
+			} else {
+				++it;
+			}
+			TIMETRACK_END(ttc_cleanup_inner_loop_);
 		}
-		TIMETRACK_END(ttc_cleanup_inner_loop_);
 	}
 	TIMETRACK_END(ttc_cleanup_);
 #ifdef USE_TIMETRACKER
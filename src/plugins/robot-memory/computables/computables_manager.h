@@ -32,6 +32,7 @@
 #include <map>
 #include <mongocxx/client.hpp>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 
 //forward declaration
@@ -82,11 +83,13 @@ public:
 		while (pos != computables.end() && priority < (*pos)->get_priority())
 			pos++;
 		computables.insert(pos, comp);
+		index_computable(comp);
 		return comp;
 	}
 
 private:
 	ComputablesManager(const ComputablesManager &other);
+	void index_computable(Computable *computable);
 
 private:
 	std::string            name = "RobotMemory ComputablesManager";
@@ -95,8 +98,10 @@ private:
 
 	std::list<Computable *> computables;
 	std::string             matching_test_collection_;
-	//cached querries as ((collection, querry), cached_until)
-	std::map<std::tuple<std::string, std::string>, long long> cached_querries_;
+	//computables by (collection, identifying field), empty field if none
+	std::map<std::tuple<std::string, std::string>, std::list<Computable *>> computables_index_;
+	//cached querries as collection -> (canonical querry -> cached_until)
+	std::map<std::string, std::unordered_map<std::string, long long>> cached_querries_;
 #ifdef USE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
 	unsigned int         tt_loopcount_;
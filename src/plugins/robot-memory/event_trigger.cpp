@@ -31,17 +31,16 @@
  */
 
 /** Constructor.
- * @param change_stream The change stream for the collection, already moved to the end
- * @param filter_query The query to use for filtering the change stream
+ * @param filter_query The query changed documents have to match, must be
+ * supported by QueryMatcher
  * @param ns namespace of the trigger, format db.collection
  * @param callback Reference to callback function
  */
-EventTrigger::EventTrigger(mongocxx::change_stream &&                            change_stream,
-                           const bsoncxx::document::view &                       filter_query,
+EventTrigger::EventTrigger(const bsoncxx::document::view &                       filter_query,
                            const std::string &                                   ns,
                            const boost::function<void(bsoncxx::document::view)> &callback)
-: change_stream(std::move(change_stream)),
-  filter_query(filter_query),
+: filter_query(filter_query),
+  matcher(filter_query),
   ns(ns),
   ns_db(EventTriggerManager::get_db_name(ns)),
   callback(callback)
@@ -49,6 +48,9 @@ EventTrigger::EventTrigger(mongocxx::change_stream &&
 	if (ns_db == "") {
 		throw fawkes::Exception("Invalid namespace, does not reference database");
 	}
+	if (!matcher.supported()) {
+		throw fawkes::Exception("Trigger queries may only contain equality and range conditions");
+	}
 }
 
 EventTrigger::~EventTrigger()
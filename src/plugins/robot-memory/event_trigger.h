@@ -22,6 +22,8 @@
 #ifndef FAWKES_SRC_PLUGINS_ROBOT_MEMORY_EVENT_TRIGGER_H_
 #define FAWKES_SRC_PLUGINS_ROBOT_MEMORY_EVENT_TRIGGER_H_
 
+#include "query_matcher.h"
+
 #include <boost/function.hpp>
 #include <mongocxx/client.hpp>
 
@@ -34,15 +36,14 @@ class EventTrigger
 	friend class EventTriggerManager;
 
 public:
-	EventTrigger(mongocxx::change_stream &&                            change_stream,
-	             const bsoncxx::document::view &                       oplog_query,
+	EventTrigger(const bsoncxx::document::view &                       filter_query,
 	             const std::string &                                   ns,
 	             const boost::function<void(bsoncxx::document::view)> &callback);
 	virtual ~EventTrigger();
 
 private:
-	mongocxx::change_stream                        change_stream;
 	bsoncxx::document::value                       filter_query;
+	QueryMatcher                                   matcher;
 	std::string                                    ns;
 	std::string                                    ns_db;
 	boost::function<void(bsoncxx::document::view)> callback;
@@ -28,15 +28,21 @@
 #include <utils/time/tracker_macros.h>
 
 #include <boost/bind/bind.hpp>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/json.hpp>
+#include <mongocxx/exception/exception.hpp>
 #include <mongocxx/exception/operation_exception.hpp>
-#include <mongocxx/exception/query_exception.hpp>
+#include <mongocxx/pipeline.hpp>
 
 using namespace fawkes;
 using namespace mongocxx;
 
 /** @class EventTriggerManager  event_trigger_manager.h
- * Manager to realize triggers on events in the robot memory
+ * Manager to realize triggers on events in the robot memory.
+ * All triggers on a collection share a single change stream. Its $match
+ * stage selects the union of the trigger queries on the server, events
+ * are then dispatched to the matching triggers by their compiled query.
  * @author Frederik Zwilling
  */
 
@@ -83,8 +89,14 @@ EventTriggerManager::EventTriggerManager(Logger *            logger,
 
 EventTriggerManager::~EventTriggerManager()
 {
-	for (EventTrigger *trigger : triggers) {
-		delete trigger;
+	for (auto &s : streams_) {
+		for (EventTrigger *trigger : s.second->triggers) {
+			delete trigger;
+		}
+		for (EventTrigger *trigger : s.second->pending) {
+			delete trigger;
+		}
+		delete s.second;
 	}
 	mongo_connection_manager_->delete_client(con_local_);
 	mongo_connection_manager_->delete_client(con_replica_);
@@ -94,6 +106,70 @@ EventTriggerManager::~EventTriggerManager()
 #endif
 }
 
+/**
+ * Register a trigger to be notified when the robot memory is updated and the updated document matches the query
+ * @param query Query the updated document has to match, only equality and
+ * range conditions are supported
+ * @param dbcollection db.collection to use
+ * @param callback Callback function called with the change stream event
+ * @return Trigger object pointer, save it to remove the trigger later
+ */
+EventTrigger *
+EventTriggerManager::register_trigger(
+  const bsoncxx::document::view &                       query,
+  const std::string &                                   dbcollection,
+  const boost::function<void(bsoncxx::document::view)> &callback)
+{
+	//lock to be thread safe (e.g. registration during checking)
+	MutexLocker lock(mutex_);
+
+	EventTrigger *trigger = new EventTrigger(query, dbcollection, callback);
+
+	auto s = streams_.find(dbcollection);
+	if (s == streams_.end()) {
+		Stream *stream = new Stream(dbcollection);
+		stream->triggers.push_back(trigger);
+		try {
+			open_change_stream(stream);
+		} catch (...) {
+			delete stream;
+			delete trigger;
+			throw;
+		}
+		streams_[dbcollection] = stream;
+	} else {
+		// only receives events from the next check on, the stream is
+		// reopened then if the trigger is not covered by its $match
+		s->second->pending.push_back(trigger);
+		s->second->outdated = (union_match(s->second).view() != s->second->match.view());
+	}
+	return trigger;
+}
+
+/**
+ * Remove a previously registered trigger
+ * @param trigger Pointer to the trigger to remove
+ */
+void
+EventTriggerManager::remove_trigger(EventTrigger *trigger)
+{
+	MutexLocker lock(mutex_);
+
+	auto s = streams_.find(trigger->ns);
+	if (s != streams_.end()) {
+		Stream *stream = s->second;
+		stream->triggers.remove(trigger);
+		stream->pending.remove(trigger);
+		if (stream->triggers.empty() && stream->pending.empty()) {
+			delete stream;
+			streams_.erase(s);
+		} else {
+			stream->outdated = (union_match(stream).view() != stream->match.view());
+		}
+	}
+	delete trigger;
+}
+
 void
 EventTriggerManager::check_events()
 {
@@ -101,52 +177,53 @@ EventTriggerManager::check_events()
 	MutexLocker lock(mutex_);
 
 	TIMETRACK_START(ttc_trigger_loop_);
-	for (EventTrigger *trigger : triggers) {
-		bool ok = true;
+	for (auto &s : streams_) {
+		Stream *stream = s.second;
+		bool    ok     = true;
 		try {
-			auto next = trigger->change_stream.begin();
+			auto next = stream->change_stream->begin();
 			TIMETRACK_START(ttc_callback_loop_);
-			while (next != trigger->change_stream.end()) {
-				//logger_->log_warn(name.c_str(), "Triggering: %s", bsoncxx::to_json(*next).c_str());
-				//actually call the callback function
-				TIMETRACK_START(ttc_callback_);
-				trigger->callback(*next);
+			while (next != stream->change_stream->end()) {
+				bsoncxx::document::element id = (*next)["_id"];
+				if (id && id.type() == bsoncxx::type::k_document) {
+					stream->resume_token = bsoncxx::document::value(id.get_document().view());
+				}
+				dispatch(stream, *next);
 				next++;
-				TIMETRACK_END(ttc_callback_);
 			}
 			TIMETRACK_END(ttc_callback_loop_);
 		} catch (operation_exception &e) {
 			logger_->log_error(name.c_str(), "Error while reading the change stream");
 			ok = false;
 		}
-		// TODO Do we still need to check whether the cursor is dead?
-		// (with old driver: (!ok || trigger->oplog_cursor->isDead()))
-		if (!ok) {
+
+		// triggers registered since the last check start receiving events now
+		stream->triggers.splice(stream->triggers.end(), stream->pending);
+
+		if (!ok || stream->outdated) {
 			TIMETRACK_START(ttc_reinit_);
-			if (cfg_debug_)
-				logger_->log_debug(name.c_str(), "Tailable Cursor is dead, requerying");
-			//check if collection is local or replicated
-			client *con;
-			if (std::find(dbnames_distributed_.begin(),
-			              dbnames_distributed_.end(),
-			              get_db_name(trigger->ns_db))
-			    != dbnames_distributed_.end()) {
-				con = con_replica_;
-			} else {
-				con = con_local_;
+			if (!ok && stream->failed) {
+				// resuming failed before, start over at the current end
+				stream->resume_token = bsoncxx::document::value(bsoncxx::document::view());
+			}
+			if (cfg_debug_) {
+				logger_->log_debug(name.c_str(),
+				                   "Reopening change stream for %s (%s)",
+				                   stream->ns.c_str(),
+				                   ok ? "triggers changed" : "read error");
 			}
-			auto db_coll_pair = split_db_collection_string(trigger->ns);
-			auto collection   = con->database(db_coll_pair.first)[db_coll_pair.second];
 			try {
-				trigger->change_stream = create_change_stream(collection, trigger->filter_query.view());
-			} catch (mongocxx::query_exception &e) {
+				open_change_stream(stream);
+			} catch (mongocxx::exception &e) {
 				logger_->log_error(name.c_str(),
-				                   "Failed to create change stream, broken trigger for collection %s: %s",
-				                   trigger->ns.c_str(),
+				                   "Failed to create change stream, broken triggers for collection %s: %s",
+				                   stream->ns.c_str(),
 				                   e.what());
+				ok = false;
 			}
 			TIMETRACK_END(ttc_reinit_);
 		}
+		stream->failed = !ok;
 	}
 	TIMETRACK_END(ttc_trigger_loop_);
 #ifdef USE_TIMETRACKER
@@ -156,36 +233,111 @@ EventTriggerManager::check_events()
 #endif
 }
 
-/**
- * Remove a previously registered trigger
- * @param trigger Pointer to the trigger to remove
+/** Pass a change stream event to all triggers it matches.
+ * Events without a full document, e.g. deletions, only reach triggers
+ * with an empty query. Documents the compiled queries cannot decide on,
+ * i.e. with arrays on the path of a condition, have already passed the
+ * $match stage and are passed on.
+ * @param stream stream the event was read from
+ * @param change change stream event
  */
 void
-EventTriggerManager::remove_trigger(EventTrigger *trigger)
+EventTriggerManager::dispatch(Stream *stream, const bsoncxx::document::view &change)
 {
-	triggers.remove(trigger);
-	delete trigger;
+	bsoncxx::document::element full     = change["fullDocument"];
+	bool                       has_full = full && (full.type() == bsoncxx::type::k_document);
+	for (EventTrigger *trigger : stream->triggers) {
+		if (!trigger->matcher.empty()
+		    && (!has_full
+		        || trigger->matcher.match(full.get_document().view()) == QueryMatcher::MATCH_NO)) {
+			continue;
+		}
+		//actually call the callback function
+		TIMETRACK_START(ttc_callback_);
+		trigger->callback(change);
+		TIMETRACK_END(ttc_callback_);
+	}
+}
+
+/** Build the $match stage for all triggers of a stream.
+ * @param stream stream to build the stage for
+ * @return disjunction of the trigger queries applied to the full
+ * document, empty if any trigger wants all events
+ */
+bsoncxx::document::value
+EventTriggerManager::union_match(const Stream *stream)
+{
+	using namespace bsoncxx::builder;
+
+	basic::array queries;
+	size_t       num_queries = 0;
+	for (const std::list<EventTrigger *> *l : {&stream->triggers, &stream->pending}) {
+		for (const EventTrigger *trigger : *l) {
+			if (trigger->matcher.empty()) {
+				return bsoncxx::document::value(bsoncxx::document::view());
+			}
+			basic::document query;
+			for (const bsoncxx::document::element &e : trigger->filter_query.view()) {
+				query.append(basic::kvp("fullDocument." + e.key().to_string(), e.get_value()));
+			}
+			queries.append(query.extract());
+			++num_queries;
+		}
+	}
+	if (num_queries == 1) {
+		return bsoncxx::document::value(queries.view()[0].get_document().view());
+	}
+	return basic::make_document(basic::kvp("$or", queries.extract()));
 }
 
-change_stream
-EventTriggerManager::create_change_stream(mongocxx::collection &coll, bsoncxx::document::view query)
+/** Open the change stream of a collection for the current triggers.
+ * Resumes after the last event read if there was any, otherwise the
+ * stream starts at the current end.
+ * @param stream stream to (re)open
+ */
+void
+EventTriggerManager::open_change_stream(Stream *stream)
 {
-	// TODO Allow non-empty pipelines
-	// @body We used to have a regular mongodb query as input to the oplog, but
-	// now this needs to be a pipeline. Adapt the change stream creation and the
-	// robot-memory API so we also accept a non-empty pipeline.
-	if (!query.empty()) {
-		throw fawkes::Exception("Non-empty queries are not implemented!");
+	auto db_coll_pair = split_db_collection_string(stream->ns);
+	auto collection   = get_client(stream->ns)->database(db_coll_pair.first)[db_coll_pair.second];
+
+	bsoncxx::document::value match = union_match(stream);
+	mongocxx::pipeline       pipeline;
+	if (!match.view().empty()) {
+		pipeline.match(match.view());
 	}
 	mongocxx::options::change_stream opts;
 	opts.full_document("updateLookup");
 	opts.max_await_time(std::chrono::milliseconds(1));
-	auto res = coll.watch(opts);
-	// Go to end of change stream to get new updates from then on.
-	auto it = res.begin();
-	while (std::next(it) != res.end()) {}
 
-	return res;
+	if (!stream->resume_token.view().empty()) {
+		opts.resume_after(stream->resume_token.view());
+		stream->change_stream.reset(new mongocxx::change_stream(collection.watch(pipeline, opts)));
+	} else {
+		auto res = collection.watch(pipeline, opts);
+		// Go to end of change stream to get new updates from then on.
+		auto it = res.begin();
+		while (std::next(it) != res.end()) {}
+		stream->change_stream.reset(new mongocxx::change_stream(std::move(res)));
+	}
+	stream->match    = std::move(match);
+	stream->outdated = false;
+}
+
+/** Get the client to watch a collection with.
+ * @param ns namespace, format db.collection
+ * @return connection to the replica set for distributed databases, to
+ * the local mongod otherwise
+ */
+client *
+EventTriggerManager::get_client(const std::string &ns)
+{
+	if (std::find(dbnames_distributed_.begin(), dbnames_distributed_.end(), get_db_name(ns))
+	    != dbnames_distributed_.end()) {
+		return con_replica_;
+	} else {
+		return con_local_;
+	}
 }
 
 /** Split database name from namespace.
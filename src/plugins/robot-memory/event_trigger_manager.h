@@ -33,8 +33,11 @@
 #include <plugins/mongodb/utils.h>
 
 #include <boost/bind/bind.hpp>
+#include <boost/function.hpp>
 #include <bsoncxx/builder/basic/document.hpp>
 #include <list>
+#include <map>
+#include <memory>
 
 namespace fawkes {
 #ifdef USE_TIMETRACKER
@@ -57,7 +60,7 @@ public:
 
 	/**
      * Register a trigger to be notified when the robot memory is updated and the updated document matches the query
-     * @param query Query the updated document has to match
+     * @param query Query the updated document has to match, equality and range conditions only
      * @param dbcollection db.collection to use
      * @param callback Callback function (e.g. &Class::callback)
      * @param obj Pointer to class the callback is a function of (usaually this)
@@ -70,42 +73,44 @@ public:
 	                 void (T::*callback)(const bsoncxx::document::view &),
 	                 T *obj)
 	{
-		//logger_->log_warn("RM|EventTriggerManager", "Registering trigger on %s", dbcollection.c_str());
-		//lock to be thread safe (e.g. registration during checking)
-		fawkes::MutexLocker lock(mutex_);
-
-		if (!query.empty()) {
-			throw fawkes::Exception("Non-empty queries are not implemented!");
-		}
-
-		//check if dbcollection is local or replicated
-		mongocxx::client *con;
-		if (std::find(dbnames_distributed_.begin(),
-		              dbnames_distributed_.end(),
-		              get_db_name(dbcollection))
-		    != dbnames_distributed_.end()) {
-			con = con_replica_;
-		} else {
-			con = con_local_;
-		}
-		auto          db_coll_pair = split_db_collection_string(dbcollection);
-		auto          collection   = con->database(db_coll_pair.first)[db_coll_pair.second];
-		EventTrigger *trigger      = new EventTrigger(create_change_stream(collection, query),
-                                             query,
-                                             dbcollection,
-                                             boost::bind(callback, obj, _1));
-		triggers.push_back(trigger);
-		return trigger;
+		return register_trigger(query, dbcollection, boost::bind(callback, obj, _1));
 	}
 
+	EventTrigger *register_trigger(const bsoncxx::document::view &                       query,
+	                               const std::string &                                   dbcollection,
+	                               const boost::function<void(bsoncxx::document::view)> &callback);
+
 	void remove_trigger(EventTrigger *trigger);
 
 	static std::string get_db_name(const std::string &ns);
 
 private:
-	void                    check_events();
-	mongocxx::change_stream create_change_stream(mongocxx::collection &  collection,
-	                                             bsoncxx::document::view query);
+	/** Change stream of a collection shared by all triggers on it. */
+	struct Stream
+	{
+		/** Constructor.
+		 * @param ns namespace of the collection, format db.collection
+		 */
+		Stream(const std::string &ns)
+		: ns(ns), match(bsoncxx::document::view()), resume_token(bsoncxx::document::view())
+		{
+		}
+
+		std::string                              ns;              /**< watched collection */
+		std::unique_ptr<mongocxx::change_stream> change_stream;   /**< open change stream */
+		std::list<EventTrigger *>                triggers;        /**< triggers receiving events */
+		std::list<EventTrigger *>                pending;         /**< triggers added since last check */
+		bsoncxx::document::value                 match;           /**< $match stage, empty for none */
+		bsoncxx::document::value                 resume_token;    /**< ID of last event, empty if none */
+		bool                                     outdated = false; /**< match differs from triggers */
+		bool                                     failed   = false; /**< reading failed on last check */
+	};
+
+	void                     check_events();
+	void                     dispatch(Stream *stream, const bsoncxx::document::view &change);
+	bsoncxx::document::value union_match(const Stream *stream);
+	void                     open_change_stream(Stream *stream);
+	mongocxx::client *       get_client(const std::string &ns);
 
 	std::string            name = "RobotMemory EventTriggerManager";
 	fawkes::Logger *       logger_;
@@ -121,7 +126,7 @@ private:
 	std::vector<std::string> dbnames_local_;
 	bool                     cfg_debug_;
 
-	std::list<EventTrigger *> triggers;
+	std::map<std::string, Stream *> streams_;
 
 #ifdef USE_TIMETRACKER
 	fawkes::TimeTracker *tt_;
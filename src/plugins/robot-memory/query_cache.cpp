@@ -0,0 +1,272 @@
+/***************************************************************************
+ *  query_cache.cpp - In-memory cache of robot memory collections
+ *
+ *  Created: Thu Oct 15 05:58:48 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "query_cache.h"
+
+#include "query_matcher.h"
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/json.hpp>
+
+using namespace fawkes;
+using namespace bsoncxx;
+
+/// @cond INTERNAL
+static std::string
+id_key(const document::element &id)
+{
+	using namespace bsoncxx::builder;
+	return to_json(basic::make_document(basic::kvp("_id", id.get_value())));
+}
+/// @endcond
+
+/** @class QueryCache "query_cache.h"
+ * In-memory cache of robot memory collections.
+ * Keeps a copy of all documents of the configured collections and
+ * answers queries consisting only of equality and range conditions on
+ * numbers, strings, booleans and object IDs. Other queries, and queries
+ * touching array fields, are left to the database.
+ *
+ * A collection is loaded on the first query after it was invalidated.
+ * Writes through the robot memory invalidate the collection right away,
+ * changes by other clients are applied as they arrive on the change
+ * stream of the collection, see changed().
+ * @author agent
+ */
+
+/** Constructor.
+ * @param collections collections to cache, in the form <dbname>.<collname>
+ */
+QueryCache::QueryCache(const std::vector<std::string> &collections)
+{
+	mutex_  = new Mutex();
+	hits_   = 0;
+	misses_ = 0;
+	loads_  = 0;
+	for (const std::string &c : collections) {
+		Collection &coll = collections_[c];
+		coll.valid       = false;
+		coll.generation  = 0;
+	}
+}
+
+/** Destructor. */
+QueryCache::~QueryCache()
+{
+	delete mutex_;
+}
+
+/** Check if a collection is cached.
+ * @param collection collection in the form <dbname>.<collname>
+ * @return true if the collection is cached
+ */
+bool
+QueryCache::caches(const std::string &collection) const
+{
+	return collections_.find(collection) != collections_.end();
+}
+
+/** Check if the cached documents of a collection are up to date.
+ * @param collection collection in the form <dbname>.<collname>
+ * @return true if the collection has been loaded and not been invalidated since
+ */
+bool
+QueryCache::valid(const std::string &collection) const
+{
+	MutexLocker lock(mutex_);
+	auto        c = collections_.find(collection);
+	return (c != collections_.end()) && c->second.valid;
+}
+
+/** Get generation of a collection.
+ * Read the generation before querying the documents to load.
+ * @param collection collection in the form <dbname>.<collname>
+ * @return number of invalidations of the collection
+ */
+unsigned long long
+QueryCache::generation(const std::string &collection) const
+{
+	MutexLocker lock(mutex_);
+	auto        c = collections_.find(collection);
+	return (c != collections_.end()) ? c->second.generation : 0;
+}
+
+/** Load documents of a collection.
+ * The collection only becomes valid if it has not been invalidated
+ * since @p generation was read, otherwise the documents might miss a
+ * change.
+ * @param collection collection in the form <dbname>.<collname>
+ * @param generation generation of the collection read before the query
+ * @param cursor cursor over all documents of the collection
+ */
+void
+QueryCache::load(const std::string &collection,
+                 unsigned long long generation,
+                 mongocxx::cursor & cursor)
+{
+	std::map<std::string, document::value> documents;
+	for (const document::view &doc : cursor) {
+		document::element id = doc["_id"];
+		if (id) {
+			documents.emplace(id_key(id), document::value(doc));
+		}
+	}
+
+	MutexLocker lock(mutex_);
+	auto        c = collections_.find(collection);
+	if ((c != collections_.end()) && (c->second.generation == generation)) {
+		c->second.documents.swap(documents);
+		c->second.valid = true;
+		++loads_;
+	}
+}
+
+/** Invalidate a collection.
+ * @param collection collection in the form <dbname>.<collname>
+ */
+void
+QueryCache::invalidate(const std::string &collection)
+{
+	MutexLocker lock(mutex_);
+	auto        c = collections_.find(collection);
+	if (c != collections_.end()) {
+		c->second.valid = false;
+		c->second.generation += 1;
+		c->second.documents.clear();
+	}
+}
+
+/** Invalidate all collections. */
+void
+QueryCache::invalidate_all()
+{
+	MutexLocker lock(mutex_);
+	for (auto &c : collections_) {
+		c.second.valid = false;
+		c.second.generation += 1;
+		c.second.documents.clear();
+	}
+}
+
+/** Answer a query from the cache.
+ * @param query query the returned documents have to match
+ * @param collection collection in the form <dbname>.<collname>
+ * @param result upon successful return contains the matching documents
+ * @return true if the query was answered, false if the collection is
+ * not loaded or the query is not supported and the database must be
+ * queried instead
+ */
+bool
+QueryCache::query(const document::view &        query,
+                  const std::string &           collection,
+                  std::vector<document::value> &result)
+{
+	MutexLocker lock(mutex_);
+	auto         c = collections_.find(collection);
+	QueryMatcher matcher(query);
+	if ((c == collections_.end()) || !c->second.valid || !matcher.supported()) {
+		++misses_;
+		return false;
+	}
+
+	std::vector<document::value> matches;
+	for (const auto &d : c->second.documents) {
+		switch (matcher.match(d.second.view())) {
+		case QueryMatcher::MATCH_YES: matches.push_back(d.second); break;
+		case QueryMatcher::MATCH_NO: break;
+		case QueryMatcher::MATCH_UNSUPPORTED: ++misses_; return false;
+		}
+	}
+	result.swap(matches);
+	++hits_;
+	return true;
+}
+
+/** Apply a change stream event.
+ * Inserted, updated and replaced documents are stored from the full
+ * document of the event, deleted documents are removed. For any other
+ * event the collection is invalidated.
+ * @param change change stream event of a cached collection
+ */
+void
+QueryCache::changed(const document::view &change)
+{
+	document::element ns = change["ns"];
+	if (!ns || (ns.type() != type::k_document)) {
+		invalidate_all();
+		return;
+	}
+	std::string collection = ns["db"].get_utf8().value.to_string() + "."
+	                         + ns["coll"].get_utf8().value.to_string();
+
+	std::string       op  = change["operationType"].get_utf8().value.to_string();
+	document::element key = change["documentKey"];
+	document::element id  = key ? key["_id"] : document::element();
+	if (!id || ((op != "insert") && (op != "update") && (op != "replace") && (op != "delete"))) {
+		invalidate(collection);
+		return;
+	}
+
+	MutexLocker lock(mutex_);
+	auto        c = collections_.find(collection);
+	if ((c == collections_.end()) || !c->second.valid) {
+		return;
+	}
+	document::element full = change["fullDocument"];
+	c->second.documents.erase(id_key(id));
+	if ((op != "delete") && full && (full.type() == type::k_document)) {
+		c->second.documents.emplace(id_key(id), document::value(full.get_document().view()));
+	}
+}
+
+/** Get number of cache hits.
+ * @return number of queries answered from the cache
+ */
+unsigned int
+QueryCache::hits() const
+{
+	MutexLocker lock(mutex_);
+	return hits_;
+}
+
+/** Get number of cache misses.
+ * @return number of queries on cached collections which had to be
+ * passed to the database
+ */
+unsigned int
+QueryCache::misses() const
+{
+	MutexLocker lock(mutex_);
+	return misses_;
+}
+
+/** Get number of loads.
+ * @return number of times a collection was loaded into the cache
+ */
+unsigned int
+QueryCache::loads() const
+{
+	MutexLocker lock(mutex_);
+	return loads_;
+}
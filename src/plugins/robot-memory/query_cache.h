@@ -0,0 +1,79 @@
+/***************************************************************************
+ *  query_cache.h - In-memory cache of robot memory collections
+ *
+ *  Created: Thu Oct 15 05:58:48 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef FAWKES_SRC_PLUGINS_ROBOT_MEMORY_QUERY_CACHE_H_
+#define FAWKES_SRC_PLUGINS_ROBOT_MEMORY_QUERY_CACHE_H_
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <map>
+#include <mongocxx/cursor.hpp>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Mutex;
+}
+
+class QueryCache
+{
+public:
+	QueryCache(const std::vector<std::string> &collections);
+	virtual ~QueryCache();
+
+	bool               caches(const std::string &collection) const;
+	bool               valid(const std::string &collection) const;
+	unsigned long long generation(const std::string &collection) const;
+	void               load(const std::string &collection,
+	                        unsigned long long generation,
+	                        mongocxx::cursor & cursor);
+	void               invalidate(const std::string &collection);
+	void               invalidate_all();
+
+	bool query(const bsoncxx::document::view &        query,
+	           const std::string &                    collection,
+	           std::vector<bsoncxx::document::value> &result);
+
+	void changed(const bsoncxx::document::view &change);
+
+	unsigned int hits() const;
+	unsigned int misses() const;
+	unsigned int loads() const;
+
+private:
+	/** Cached documents of a collection. */
+	struct Collection
+	{
+		bool               valid;      /**< true if the documents are up to date */
+		unsigned long long generation; /**< increased on each invalidation */
+		/** documents by JSON of their _id */
+		std::map<std::string, bsoncxx::document::value> documents;
+	};
+
+private:
+	fawkes::Mutex *                   mutex_;
+	std::map<std::string, Collection> collections_;
+	unsigned int                      hits_;
+	unsigned int                      misses_;
+	unsigned int                      loads_;
+};
+
+#endif /* FAWKES_SRC_PLUGINS_ROBOT_MEMORY_QUERY_CACHE_H_ */
@@ -0,0 +1,214 @@
+/***************************************************************************
+ *  query_matcher.cpp - Match documents against robot memory queries locally
+ *
+ *  Created: Thu Oct 15 06:27:14 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "query_matcher.h"
+
+using namespace bsoncxx;
+
+/// @cond INTERNAL
+static bool
+is_number(type t)
+{
+	return (t == type::k_double) || (t == type::k_int32) || (t == type::k_int64);
+}
+
+static double
+number_value(const document::element &e)
+{
+	switch (e.type()) {
+	case type::k_int32: return e.get_int32().value;
+	case type::k_int64: return e.get_int64().value;
+	default: return e.get_double().value;
+	}
+}
+/// @endcond
+
+/** @class QueryMatcher "query_matcher.h"
+ * Match documents against robot memory queries without the database.
+ * The query is compiled once on construction, afterwards documents can
+ * be matched against it cheaply. Only queries consisting of equality
+ * and range conditions on numbers, strings, booleans and object IDs are
+ * supported, ranges only on numbers and strings. Documents which reach
+ * into arrays on the path of a condition cannot be matched locally.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param query query to compile, check supported() before matching
+ */
+QueryMatcher::QueryMatcher(const document::view &query) : supported_(true)
+{
+	for (const document::element &e : query) {
+		std::string key = e.key().to_string();
+		if (key.empty() || key[0] == '$') {
+			supported_ = false;
+		} else if (e.type() == type::k_document) {
+			document::view ops = e.get_document().view();
+			if (ops.empty()) {
+				supported_ = false;
+			}
+			for (const document::element &op : ops) {
+				std::string name = op.key().to_string();
+				if (name == "$eq") {
+					supported_ = supported_ && compile(key, OP_EQ, op);
+				} else if (name == "$gt") {
+					supported_ = supported_ && compile(key, OP_GT, op);
+				} else if (name == "$gte") {
+					supported_ = supported_ && compile(key, OP_GTE, op);
+				} else if (name == "$lt") {
+					supported_ = supported_ && compile(key, OP_LT, op);
+				} else if (name == "$lte") {
+					supported_ = supported_ && compile(key, OP_LTE, op);
+				} else {
+					supported_ = false;
+				}
+			}
+		} else {
+			supported_ = supported_ && compile(key, OP_EQ, e);
+		}
+		if (!supported_) {
+			conditions_.clear();
+			return;
+		}
+	}
+}
+
+bool
+QueryMatcher::compile(const std::string &path, Operator op, const document::element &operand)
+{
+	Condition c;
+	c.op     = op;
+	c.number = 0.;
+	if (is_number(operand.type())) {
+		c.type   = type::k_double;
+		c.number = number_value(operand);
+	} else if (operand.type() == type::k_utf8) {
+		c.type  = type::k_utf8;
+		c.bytes = operand.get_utf8().value.to_string();
+	} else if (op != OP_EQ) {
+		return false;
+	} else if (operand.type() == type::k_bool) {
+		c.type   = type::k_bool;
+		c.number = operand.get_bool().value ? 1. : 0.;
+	} else if (operand.type() == type::k_oid) {
+		c.type  = type::k_oid;
+		c.bytes = std::string(operand.get_oid().value.bytes(), operand.get_oid().value.size());
+	} else {
+		return false;
+	}
+
+	size_t start = 0;
+	while (true) {
+		size_t dot = path.find('.', start);
+		c.path.push_back(path.substr(start, (dot == std::string::npos) ? dot : dot - start));
+		if (dot == std::string::npos) {
+			break;
+		}
+		start = dot + 1;
+	}
+	conditions_.push_back(c);
+	return true;
+}
+
+/** Check if the query could be compiled.
+ * @return true if documents can be matched against the query
+ */
+bool
+QueryMatcher::supported() const
+{
+	return supported_;
+}
+
+/** Check if the query has no conditions.
+ * @return true if the query matches any document
+ */
+bool
+QueryMatcher::empty() const
+{
+	return supported_ && conditions_.empty();
+}
+
+bool
+QueryMatcher::test(const Condition &c, const document::element &value) const
+{
+	int cmp;
+	if (c.type == type::k_double) {
+		// MongoDB only compares values of the same type class
+		if (!is_number(value.type()))
+			return false;
+		double v = number_value(value);
+		cmp      = (v < c.number) ? -1 : ((v > c.number) ? 1 : 0);
+	} else if (value.type() != c.type) {
+		return false;
+	} else if (c.type == type::k_utf8) {
+		cmp = value.get_utf8().value.compare(c.bytes);
+	} else if (c.type == type::k_bool) {
+		cmp = (value.get_bool().value == (c.number != 0.)) ? 0 : 1;
+	} else {
+		oid id = value.get_oid().value;
+		cmp    = (std::string(id.bytes(), id.size()) == c.bytes) ? 0 : 1;
+	}
+
+	switch (c.op) {
+	case OP_EQ: return cmp == 0;
+	case OP_GT: return cmp > 0;
+	case OP_GTE: return cmp >= 0;
+	case OP_LT: return cmp < 0;
+	default: return cmp <= 0;
+	}
+}
+
+/** Match a document against the query.
+ * @param doc document to match
+ * @return MATCH_YES or MATCH_NO, MATCH_UNSUPPORTED if the query is not
+ * supported or a condition reaches into an array of @p doc
+ */
+QueryMatcher::Result
+QueryMatcher::match(const document::view &doc) const
+{
+	if (!supported_) {
+		return MATCH_UNSUPPORTED;
+	}
+	for (const Condition &c : conditions_) {
+		document::view    cur = doc;
+		document::element field;
+		for (size_t i = 0; i < c.path.size(); ++i) {
+			field = cur[c.path[i]];
+			if (!field) {
+				return MATCH_NO;
+			}
+			if (field.type() == type::k_array) {
+				// arrays have additional semantics
+				return MATCH_UNSUPPORTED;
+			}
+			if (i + 1 < c.path.size()) {
+				if (field.type() != type::k_document) {
+					return MATCH_NO;
+				}
+				cur = field.get_document().view();
+			}
+		}
+		if (!test(c, field)) {
+			return MATCH_NO;
+		}
+	}
+	return MATCH_YES;
+}
@@ -0,0 +1,68 @@
+/***************************************************************************
+ *  query_matcher.h - Match documents against robot memory queries locally
+ *
+ *  Created: Thu Oct 15 06:27:14 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef FAWKES_SRC_PLUGINS_ROBOT_MEMORY_QUERY_MATCHER_H_
+#define FAWKES_SRC_PLUGINS_ROBOT_MEMORY_QUERY_MATCHER_H_
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types.hpp>
+#include <string>
+#include <vector>
+
+class QueryMatcher
+{
+public:
+	/** Result of matching a document. */
+	typedef enum {
+		MATCH_NO,         /**< document does not match */
+		MATCH_YES,        /**< document matches */
+		MATCH_UNSUPPORTED /**< document cannot be matched locally */
+	} Result;
+
+	QueryMatcher(const bsoncxx::document::view &query);
+
+	bool   supported() const;
+	bool   empty() const;
+	Result match(const bsoncxx::document::view &doc) const;
+
+private:
+	/** Comparison operator of a condition. */
+	typedef enum { OP_EQ, OP_GT, OP_GTE, OP_LT, OP_LTE } Operator;
+
+	/** Single condition on a field. */
+	struct Condition
+	{
+		std::vector<std::string> path;   /**< keys of the dotted field path */
+		Operator                 op;     /**< comparison operator */
+		bsoncxx::type            type;   /**< type of the operand */
+		double                   number; /**< operand if numeric or boolean */
+		std::string              bytes;  /**< operand if string or object ID */
+	};
+
+	bool compile(const std::string &path, Operator op, const bsoncxx::document::element &operand);
+	bool test(const Condition &c, const bsoncxx::document::element &value) const;
+
+private:
+	bool                   supported_;
+	std::vector<Condition> conditions_;
+};
+
+#endif /* FAWKES_SRC_PLUGINS_ROBOT_MEMORY_QUERY_MATCHER_H_ */
@@ -35,6 +35,7 @@
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <chrono>
+#include <mongocxx/bulk_write.hpp>
 #include <mongocxx/client.hpp>
 #include <mongocxx/exception/operation_exception.hpp>
 #include <mongocxx/read_preference.hpp>
@@ -78,10 +79,20 @@ RobotMemory::RobotMemory(fawkes::Configuration *     config,
 	mongodb_client_local_       = nullptr;
 	mongodb_client_distributed_ = nullptr;
 	debug_                      = false;
+	query_cache_                = nullptr;
 }
 
 RobotMemory::~RobotMemory()
 {
+	if (query_cache_) {
+		log_deb(std::string("Query cache: " + std::to_string(query_cache_->hits()) + " hits, "
+		                    + std::to_string(query_cache_->misses()) + " misses, "
+		                    + std::to_string(query_cache_->loads()) + " loads"));
+		for (EventTrigger *trigger : cache_triggers_) {
+			trigger_manager_->remove_trigger(trigger);
+		}
+		delete query_cache_;
+	}
 	mongo_connection_manager_->delete_client(mongodb_client_local_);
 	mongo_connection_manager_->delete_client(mongodb_client_distributed_);
 	delete trigger_manager_;
@@ -141,6 +152,27 @@ RobotMemory::init()
 	trigger_manager_     = new EventTriggerManager(logger_, config_, mongo_connection_manager_);
 	computables_manager_ = new ComputablesManager(config_, this);
 
+	//Setup cache of selected collections, kept up to date by change streams
+	std::vector<std::string> cached_collections =
+	  config_->get_strings_or_defaults("/plugins/robot-memory/cache/collections", {});
+	if (!cached_collections.empty()) {
+		query_cache_ = new QueryCache(cached_collections);
+		try {
+			for (const std::string &c : cached_collections) {
+				cache_triggers_.push_back(trigger_manager_->register_trigger(
+				  bsoncxx::document::view(), c, &QueryCache::changed, query_cache_));
+			}
+		} catch (std::exception &e) {
+			log(std::string("Cannot watch cached collections, disabling cache: ") + e.what(), "warn");
+			for (EventTrigger *trigger : cache_triggers_) {
+				trigger_manager_->remove_trigger(trigger);
+			}
+			cache_triggers_.clear();
+			delete query_cache_;
+			query_cache_ = nullptr;
+		}
+	}
+
 	log_deb("Initialized RobotMemory");
 
 #ifdef USE_TIMETRACKER
@@ -199,6 +231,45 @@ RobotMemory::query(document::view          query,
 	}
 }
 
+/**
+ * Query information from the in-memory cache of the robot memory.
+ * Only collections configured for caching are answered, and only
+ * queries with equality and range conditions on plain fields. Use
+ * query() if the query cannot be answered from the cache.
+ * @param query The query returned documents have to match
+ * @param collection_name The database and collection to query as string (e.g. robmem.worldmodel)
+ * @param result upon successful return contains the matching documents
+ * @return true if the query was answered from the cache, false otherwise
+ */
+bool
+RobotMemory::query_cached(document::view                query,
+                          const std::string &           collection_name,
+                          std::vector<document::value> &result)
+{
+	if (!query_cache_ || !query_cache_->caches(collection_name)) {
+		return false;
+	}
+
+	//computables may add documents, which invalidates the cache
+	computables_manager_->check_and_compute(query, collection_name);
+
+	if (!query_cache_->valid(collection_name)) {
+		log_deb(std::string("Loading collection " + collection_name + " into cache"));
+		unsigned long long generation = query_cache_->generation(collection_name);
+		MutexLocker        lock(mutex_);
+		try {
+			collection collection = get_collection(collection_name);
+			cursor     cursor     = collection.find(document::view());
+			query_cache_->load(collection_name, generation, cursor);
+		} catch (mongocxx::operation_exception &e) {
+			log(std::string("Failed to load " + collection_name + " into cache: " + e.what()), "warn");
+			return false;
+		}
+	}
+
+	return query_cache_->query(query, collection_name, result);
+}
+
 /**
  * Inserts a document into the robot memory
  * @param doc A view of the document to insert
@@ -210,6 +281,9 @@ RobotMemory::insert(bsoncxx::document::view doc, const std::string &collection_n
 {
 	collection collection = get_collection(collection_name);
 	log_deb(std::string("Inserting " + to_json(doc) + " into collection " + collection_name));
+	if (query_cache_) {
+		query_cache_->invalidate(collection_name);
+	}
 	//lock (mongo_client not thread safe)
 	MutexLocker lock(mutex_);
 	//actually execute insert
@@ -274,6 +348,9 @@ RobotMemory::insert(std::vector<bsoncxx::document::view> docs, const std::string
 	log_deb(std::string("Inserting vector of documents " + insert_string + " into collection "
 	                    + collection_name));
 
+	if (query_cache_) {
+		query_cache_->invalidate(collection_name);
+	}
 	//lock (mongo_client not thread safe)
 	MutexLocker lock(mutex_);
 
@@ -319,6 +396,9 @@ RobotMemory::update(const bsoncxx::document::view &query,
 	log_deb(std::string("Executing Update " + to_json(update) + " for query " + to_json(query)
 	                    + " on collection " + collection_name));
 
+	if (query_cache_) {
+		query_cache_->invalidate(collection_name);
+	}
 	//lock (mongo_client not thread safe)
 	MutexLocker lock(mutex_);
 
@@ -376,6 +456,9 @@ RobotMemory::find_one_and_update(const document::view &filter,
 	log_deb(std::string("Executing findOneAndUpdate " + to_json(update) + " for filter "
 	                    + to_json(filter) + " on collection " + collection_name));
 
+	if (query_cache_) {
+		query_cache_->invalidate(collection_name);
+	}
 	MutexLocker lock(mutex_);
 
 	try {
@@ -414,6 +497,9 @@ RobotMemory::remove(const bsoncxx::document::view &query, const std::string &col
 	MutexLocker lock(mutex_);
 	collection  collection = get_collection(collection_name);
 	log_deb(std::string("Executing Remove " + to_json(query) + " on collection " + collection_name));
+	if (query_cache_) {
+		query_cache_->invalidate(collection_name);
+	}
 	//actually execute remove
 	try {
 		collection.delete_many(query);
@@ -426,6 +512,51 @@ RobotMemory::remove(const bsoncxx::document::view &query, const std::string &col
 	return 1;
 }
 
+/**
+ * Execute a batch of writes in a single round trip to the database.
+ * @param writes Inserts, updates, replacements and deletions to execute,
+ * update documents are passed to the database as they are
+ * @param collection_name The database and collection to use as string (e.g. robmem.worldmodel)
+ * @param ordered If true, execute the writes in order and stop at the first
+ * error, otherwise the database may reorder them and continues after errors
+ * @return 1: Success 0: Error, some writes may have been executed nonetheless
+ */
+int
+RobotMemory::bulk_write(const std::vector<mongocxx::model::write> &writes,
+                        const std::string &                         collection_name,
+                        bool                                        ordered)
+{
+	if (writes.empty()) {
+		return 1;
+	}
+	collection collection = get_collection(collection_name);
+	log_deb(std::string("Executing bulk write of " + std::to_string(writes.size())
+	                    + " operations on collection " + collection_name));
+
+	if (query_cache_) {
+		query_cache_->invalidate(collection_name);
+	}
+	//lock (mongo_client not thread safe)
+	MutexLocker lock(mutex_);
+
+	//actually execute writes
+	try {
+		mongocxx::bulk_write bulk = collection.create_bulk_write(options::bulk_write().ordered(ordered));
+		for (const mongocxx::model::write &w : writes) {
+			bulk.append(w);
+		}
+		bulk.execute();
+	} catch (operation_exception &e) {
+		log_deb(std::string("Error for bulk write of " + std::to_string(writes.size())
+		                    + " operations on collection " + collection_name
+		                    + "\n Exception: " + e.what()),
+		        "error");
+		return 0;
+	}
+	//return success
+	return 1;
+}
+
 /**
  * Performs a MapReduce operation on the robot memory (https://docs.mongodb.com/manual/core/map-reduce/)
  * @param query Which documents to use for the map step
@@ -486,6 +617,9 @@ RobotMemory::drop_collection(const std::string &collection_name)
 	MutexLocker lock(mutex_);
 	collection  collection = get_collection(collection_name);
 	log_deb("Dropping collection " + collection_name);
+	if (query_cache_) {
+		query_cache_->invalidate(collection_name);
+	}
 	collection.drop();
 	return 1;
 }
@@ -501,6 +635,9 @@ RobotMemory::clear_memory()
 	MutexLocker lock(mutex_);
 
 	log_deb("Clearing whole robot memory");
+	if (query_cache_) {
+		query_cache_->invalidate_all();
+	}
 	mongodb_client_local_->database(database_name_).drop();
 	return 1;
 }
@@ -561,6 +698,9 @@ RobotMemory::restore_collection(const std::string &dbcollection,
 		log_deb(output_string, "error");
 		return 0;
 	}
+	if (query_cache_) {
+		query_cache_->invalidate(target_dbcollection);
+	}
 	return 1;
 }
 
@@ -23,6 +23,7 @@
 
 #include "computables/computables_manager.h"
 #include "event_trigger_manager.h"
+#include "query_cache.h"
 
 #include <aspect/blackboard.h>
 #include <aspect/clock.h>
@@ -33,6 +34,7 @@
 
 #include <bsoncxx/json.hpp>
 #include <memory>
+#include <mongocxx/model/write.hpp>
 #include <utility>
 #include <vector>
 
@@ -60,6 +62,9 @@ public:
 	mongocxx::cursor query(bsoncxx::document::view query,
 	                       const std::string &     collection_name = "",
 	                       mongocxx::options::find query_options   = mongocxx::options::find());
+	bool             query_cached(bsoncxx::document::view                query,
+	                              const std::string &                    collection_name,
+	                              std::vector<bsoncxx::document::value> &result);
 	// TODO fix int return codes, should be booleans
 	int insert(bsoncxx::document::view, const std::string &collection = "");
 	int insert(std::vector<bsoncxx::document::view> v_obj, const std::string &collection = "");
@@ -78,6 +83,9 @@ public:
 	                                             bool                           upsert     = false,
 	                                             bool                           return_new = true);
 	int remove(const bsoncxx::document::view &query, const std::string &collection = "");
+	int bulk_write(const std::vector<mongocxx::model::write> &writes,
+	               const std::string &                         collection = "",
+	               bool                                        ordered    = true);
 	bsoncxx::document::value mapreduce(const bsoncxx::document::view &query,
 	                                   const std::string &            collection,
 	                                   const std::string &            js_map_fun,
@@ -108,7 +116,7 @@ public:
 
 	/**
      * Register a trigger to be notified when the robot memory is updated and the updated document matches the query
-     * @param query Query the updated document has to match
+     * @param query Query the updated document has to match, equality and range conditions only
      * @param collection db.collection to use
      * @param callback Callback function (e.g. &Class::callback)
      * @param _obj Pointer to class the callback is a function of (usaually this)
@@ -186,6 +194,8 @@ private:
 	fawkes::RobotMemoryInterface *rm_if_;
 	EventTriggerManager *         trigger_manager_;
 	ComputablesManager *          computables_manager_;
+	QueryCache *                  query_cache_;
+	std::vector<EventTrigger *>   cache_triggers_;
 	std::vector<std::string>      distributed_dbs_;
 
 	std::string cfg_coord_database_;
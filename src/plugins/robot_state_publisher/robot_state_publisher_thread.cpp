@@ -55,6 +55,7 @@
 
 #include "robot_state_publisher_thread.h"
 
+#include <core/threading/mutex_locker.h>
 #include <kdl_parser/kdl_parser.h>
 
 #include <fstream>
@@ -67,7 +68,13 @@ using namespace fawkes;
 using namespace std;
 
 /** @class RobotStatePublisherThread "robot_state_publisher_thread.h"
- * Thread to publish the robot's transforms
+ * Thread to publish the robot's transforms.
+ * Transforms of fixed segments are published once as static
+ * transforms. Joint positions received in between are collected and
+ * the transforms of all moving segments are published at once in each
+ * loop. Only segments whose joint interface has been written are
+ * published, and the segment transform is only recomputed if the
+ * joint position changed.
  * @author Till Hofmann
  */
 
@@ -139,6 +146,8 @@ RobotStatePublisherThread::init()
 	// register to blackboard
 	blackboard->register_listener(this);
 	blackboard->register_observer(this);
+
+	publish_fixed_transforms();
 }
 
 void
@@ -154,7 +163,7 @@ RobotStatePublisherThread::finalize()
 void
 RobotStatePublisherThread::loop()
 {
-	publish_fixed_transforms();
+	publish_joint_transforms();
 }
 
 // add children to correct maps
@@ -202,11 +211,43 @@ RobotStatePublisherThread::publish_fixed_transforms()
 		tf_transform.child_frame_id = seg->second.tip;
 		tf_transforms.push_back(tf_transform);
 	}
-	for (std::vector<tf::StampedTransform>::const_iterator it = tf_transforms.begin();
-	     it != tf_transforms.end();
-	     ++it) {
-		tf_publisher->send_transform(*it);
+	tf_publisher->send_transforms(tf_transforms, /* is_static */ true);
+}
+
+// publish transforms of moving segments with updated joint positions
+void
+RobotStatePublisherThread::publish_joint_transforms()
+{
+	std::map<std::string, float> joint_positions;
+	{
+		MutexLocker lock(&joint_positions_mutex_);
+		joint_positions.swap(joint_positions_);
+	}
+	if (joint_positions.empty())
+		return;
+
+	std::vector<tf::StampedTransform> tf_transforms;
+	tf::StampedTransform              tf_transform;
+	tf_transform.stamp = fawkes::Time(clock);
+
+	for (const auto &jp : joint_positions) {
+		std::map<std::string, SegmentPair>::iterator seg = segments_.find(jp.first);
+		if (seg == segments_.end())
+			continue;
+		SegmentPair &sp = seg->second;
+		// only evaluate the kinematic chain if the joint moved, but
+		// republish to keep the transform valid for the current time
+		if (!sp.cached || sp.cached_position != jp.second) {
+			transform_kdl_to_tf(sp.segment.pose(jp.second), sp.cached_transform);
+			sp.cached_position = jp.second;
+			sp.cached          = true;
+		}
+		tf_transform.set_data(sp.cached_transform);
+		tf_transform.frame_id       = sp.root;
+		tf_transform.child_frame_id = sp.tip;
+		tf_transforms.push_back(tf_transform);
 	}
+	tf_publisher->send_transforms(tf_transforms);
 }
 
 void
@@ -313,13 +354,9 @@ RobotStatePublisherThread::bb_interface_data_refreshed(fawkes::Interface *interf
 	if (!jiface)
 		return;
 	jiface->read();
-	std::map<std::string, SegmentPair>::const_iterator seg = segments_.find(jiface->id());
-	if (seg == segments_.end())
+	if (!joint_is_in_model(jiface->id()))
 		return;
-	tf::StampedTransform transform;
-	transform.stamp          = fawkes::Time(clock);
-	transform.frame_id       = seg->second.root;
-	transform.child_frame_id = seg->second.tip;
-	transform_kdl_to_tf(seg->second.segment.pose(jiface->position()), transform);
-	tf_publisher->send_transform(transform);
+	// published in the next loop together with all other joints
+	MutexLocker lock(&joint_positions_mutex_);
+	joint_positions_[jiface->id()] = jiface->position();
 }
@@ -65,6 +65,7 @@
 #include <aspect/tf.h>
 #include <blackboard/interface_listener.h>
 #include <blackboard/interface_observer.h>
+#include <core/threading/mutex.h>
 #include <core/threading/thread.h>
 #include <interfaces/JointInterface.h>
 
@@ -87,7 +88,7 @@ public:
    * @param p_tip The name of the child joint
    */
 	SegmentPair(const KDL::Segment &p_segment, const std::string &p_root, const std::string &p_tip)
-	: segment(p_segment), root(p_root), tip(p_tip)
+	: segment(p_segment), root(p_root), tip(p_tip), cached(false), cached_position(0.f)
 	{
 	}
 
@@ -97,6 +98,12 @@ public:
 	std::string root;
 	/** The name of the child joint */
 	std::string tip;
+	/** True if cached_transform is valid */
+	bool cached;
+	/** Joint position cached_transform has been computed for */
+	float cached_position;
+	/** Transform of the segment at cached_position */
+	fawkes::tf::Transform cached_transform;
 };
 
 class RobotStatePublisherThread : public fawkes::Thread,
@@ -128,6 +135,7 @@ public:
 
 private:
 	void publish_fixed_transforms();
+	void publish_joint_transforms();
 
 	void add_children(const KDL::SegmentMap::const_iterator segment);
 	void transform_kdl_to_tf(const KDL::Frame &k, fawkes::tf::Transform &t);
@@ -141,6 +149,9 @@ private:
 	float                              cfg_postdate_to_future_;
 
 	std::list<fawkes::JointInterface *> ifs_;
+
+	fawkes::Mutex                joint_positions_mutex_;
+	std::map<std::string, float> joint_positions_;
 };
 
 #endif
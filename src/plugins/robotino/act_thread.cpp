@@ -30,13 +30,16 @@
 #include <interfaces/IMUInterface.h>
 #include <interfaces/MotorInterface.h>
 #include <utils/math/angle.h>
+#include <utils/time/latency_trace.h>
 
 using namespace fawkes;
 
 /** @class RobotinoActThread "act_thread.h"
  * Robotino act hook integration thread.
  * This thread integrates into the Fawkes main loop at the ACT hook and
- * executes motion commands.
+ * executes motion commands. It is the sink of latency traces carried by
+ * motion commands, the latency is recorded when the velocity is passed to
+ * the base.
  * @author Tim Niemueller
  */
 
@@ -58,6 +61,7 @@ RobotinoActThread::init()
 {
 	last_seqnum_   = 0;
 	last_msg_time_ = clock->now();
+	latency_sink_  = LatencyTrace::sink(name());
 
 	//get config values
 	cfg_deadman_threshold_    = config->get_float("/hardware/robotino/deadman_time_threshold");
@@ -164,8 +168,9 @@ RobotinoActThread::loop()
 		return;
 	}
 
-	bool reset_odometry = false;
-	bool set_des_vel    = false;
+	bool            reset_odometry = false;
+	bool            set_des_vel    = false;
+	latency_trace_t transrot_trace = {0, 0, 0, 0};
 	while (!motor_if_->msgq_empty()) {
 		if (MotorInterface::SetMotorStateMessage *msg = motor_if_->msgq_first_safe(msg)) {
 			logger->log_info(name(),
@@ -183,6 +188,7 @@ RobotinoActThread::loop()
 			des_vy_    = msg->vy();
 			des_omega_ = msg->omega();
 
+			transrot_trace = msg->latency_trace();
 			last_msg_time_ = clock->now();
 			msg_received_  = true;
 
@@ -256,8 +262,10 @@ RobotinoActThread::loop()
 
 	if (reset_odometry)
 		com_->reset_odometry();
-	if (set_des_vel)
+	if (set_des_vel) {
 		com_->set_desired_vel(des_vx_, des_vy_, des_omega_);
+		LatencyTrace::record(latency_sink_, transrot_trace);
+	}
 
 	publish_odometry();
 
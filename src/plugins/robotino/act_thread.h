@@ -126,6 +126,8 @@ private:
 	float       des_vy_;
 	float       des_omega_;
 	std::string last_transrot_sender_;
+
+	unsigned int latency_sink_;
 };
 
 #endif
@@ -110,11 +110,13 @@ DirectRobotinoComMessage::DirectRobotinoComMessage(const DirectRobotinoComMessag
 	cur_cmd_  = other.cur_cmd_;
 
 	if (other.escaped_data_) {
-		escaped_data_size_ = other.escaped_data_size_;
-		escaped_data_      = (unsigned char *)malloc(escaped_data_size_);
+		escaped_data_size_     = other.escaped_data_size_;
+		escaped_data_capacity_ = escaped_data_size_;
+		escaped_data_          = (unsigned char *)malloc(escaped_data_size_);
 		memcpy(escaped_data_, other.escaped_data_, escaped_data_size_);
 	} else {
-		escaped_data_ = NULL;
+		escaped_data_          = NULL;
+		escaped_data_capacity_ = 0;
 	}
 }
 
@@ -138,25 +140,7 @@ DirectRobotinoComMessage::DirectRobotinoComMessage(command_id_t cmdid)
 DirectRobotinoComMessage::DirectRobotinoComMessage(const unsigned char *msg, size_t msg_size)
 {
 	ctor();
-
-	mode_ = READ;
-
-	escaped_data_ = (unsigned char *)malloc(msg_size);
-	memcpy(escaped_data_, msg, msg_size);
-	escaped_data_size_      = msg_size;
-	size_t escaped_consumed = unescape_data();
-
-	if (escaped_consumed < msg_size) {
-		unsigned char *old_data = escaped_data_;
-		escaped_data_           = (unsigned char *)realloc(escaped_data_, escaped_consumed);
-		if (!escaped_data_) {
-			free(old_data);
-			throw Exception("Failed to allocate more memory");
-		}
-		escaped_data_size_ = escaped_consumed;
-	}
-
-	check_checksum();
+	parse(msg, msg_size);
 }
 
 void
@@ -171,7 +155,8 @@ DirectRobotinoComMessage::ctor()
 	cur_data_ = data_ + 3;
 	cur_cmd_  = NULL;
 
-	escaped_data_ = NULL;
+	escaped_data_          = NULL;
+	escaped_data_capacity_ = 0;
 
 	mode_ = WRITE;
 }
@@ -211,16 +196,54 @@ DirectRobotinoComMessage::operator=(const DirectRobotinoComMessage &other)
 	cur_cmd_  = other.cur_cmd_;
 
 	if (other.escaped_data_) {
-		escaped_data_size_ = other.escaped_data_size_;
-		escaped_data_      = (unsigned char *)malloc(escaped_data_size_);
+		escaped_data_size_     = other.escaped_data_size_;
+		escaped_data_capacity_ = escaped_data_size_;
+		escaped_data_          = (unsigned char *)malloc(escaped_data_size_);
 		memcpy(escaped_data_, other.escaped_data_, escaped_data_size_);
 	} else {
-		escaped_data_ = NULL;
+		escaped_data_          = NULL;
+		escaped_data_capacity_ = 0;
 	}
 
 	return *this;
 }
 
+/** Parse incoming message.
+ * Turns the message into a reading message for the given buffer. The
+ * internal buffers are kept and only grown if necessary, hence a single
+ * message can be re-used to parse a stream of incoming messages without
+ * allocating memory for each of them.
+ * @param msg the message of \p msg_size is expected to be escaped and to range from
+ * the including 0xAA head byte to the checksum. It may contain further data after
+ * the message, use escaped_data_size() to determine the number of consumed bytes.
+ * @param msg_size size of \p msg buffer
+ * @throw ChecksumError thrown if the message checksum does not match
+ */
+void
+DirectRobotinoComMessage::parse(const unsigned char *msg, size_t msg_size)
+{
+	mode_ = READ;
+
+	if (escaped_data_capacity_ < msg_size) {
+		unsigned char *old_data = escaped_data_;
+		escaped_data_           = (unsigned char *)realloc(escaped_data_, msg_size);
+		if (!escaped_data_) {
+			free(old_data);
+			escaped_data_capacity_ = 0;
+			throw Exception("Failed to allocate more memory");
+		}
+		escaped_data_capacity_ = msg_size;
+	}
+	memcpy(escaped_data_, msg, msg_size);
+	escaped_data_size_ = msg_size;
+	escaped_data_size_ = unescape_data();
+
+	cur_data_ = data_ + 3;
+	cur_cmd_  = NULL;
+
+	check_checksum();
+}
+
 /** Assert a given message mode.
  * @param mode mode
  * @throw Exception on mode mismatch
@@ -765,8 +788,9 @@ DirectRobotinoComMessage::escape()
 	}
 	if (escaped_data_)
 		::free(escaped_data_);
-	escaped_data_size_ = payload_size_ + MSG_METADATA_SIZE + to_escape;
-	escaped_data_      = (unsigned char *)malloc(escaped_data_size_);
+	escaped_data_size_     = payload_size_ + MSG_METADATA_SIZE + to_escape;
+	escaped_data_capacity_ = escaped_data_size_;
+	escaped_data_          = (unsigned char *)malloc(escaped_data_size_);
 
 	if (to_escape > 0) {
 		escaped_data_[0] = MSG_HEAD;
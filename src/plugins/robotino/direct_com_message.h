@@ -158,6 +158,8 @@ public:
 
 	DirectRobotinoComMessage &operator=(const DirectRobotinoComMessage &other);
 
+	void parse(const unsigned char *msg, size_t msg_size);
+
 	void add_command(command_id_t cmdid);
 	void add_int8(int8_t value);
 	void add_uint8(uint8_t value);
@@ -225,6 +227,7 @@ private:
 	unsigned short payload_size_;
 	unsigned char *escaped_data_;
 	unsigned short escaped_data_size_;
+	size_t         escaped_data_capacity_;
 
 	unsigned char *cur_cmd_;
 	unsigned char *cur_data_;
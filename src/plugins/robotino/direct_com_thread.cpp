@@ -102,6 +102,7 @@ DirectRobotinoComThread::init()
 
 	request_timer_.expires_from_now(boost::posix_time::milliseconds(-1));
 	drive_timer_.expires_at(boost::posix_time::pos_infin);
+	drive_pending_ = false;
 
 	digital_outputs_ = 0;
 
@@ -157,9 +158,9 @@ DirectRobotinoComThread::loop()
 
 	if (opened_) {
 		try {
-			DirectRobotinoComMessage::pointer m = read_packet();
-			checksum_errors_                    = 0;
-			process_message(m);
+			read_packet(rx_msg_);
+			checksum_errors_ = 0;
+			process_message(rx_msg_);
 			update_nodata_timer();
 		} catch (DirectRobotinoComMessage::ChecksumError &ce) {
 			input_buffer_.consume(input_buffer_.size());
@@ -222,58 +223,58 @@ DirectRobotinoComThread::loop()
 }
 
 void
-DirectRobotinoComThread::process_message(DirectRobotinoComMessage::pointer m)
+DirectRobotinoComThread::process_message(DirectRobotinoComMessage &m)
 {
 	bool new_data = false;
 
 	DirectRobotinoComMessage::command_id_t msgid;
-	while ((msgid = m->next_command()) != DirectRobotinoComMessage::CMDID_NONE) {
-		//logger->log_info(name(), "Command length: %u", m->command_length());
+	while ((msgid = m.next_command()) != DirectRobotinoComMessage::CMDID_NONE) {
+		//logger->log_info(name(), "Command length: %u", m.command_length());
 
 		if (msgid == DirectRobotinoComMessage::CMDID_ALL_MOTOR_READINGS) {
 			// there are four motors, one of which might be a gripper, therefore skips
 
 			for (int i = 0; i < 3; ++i)
-				data_.mot_velocity[i] = m->get_int16();
-			m->skip_int16();
+				data_.mot_velocity[i] = m.get_int16();
+			m.skip_int16();
 
 			for (int i = 0; i < 3; ++i)
-				data_.mot_position[i] = m->get_int32();
-			m->skip_int32();
+				data_.mot_position[i] = m.get_int32();
+			m.skip_int32();
 
 			for (int i = 0; i < 3; ++i)
-				data_.mot_current[i] = m->get_float();
+				data_.mot_current[i] = m.get_float();
 			new_data = true;
 
 		} else if (msgid == DirectRobotinoComMessage::CMDID_DISTANCE_SENSOR_READINGS) {
 			for (int i = 0; i < 9; ++i)
-				data_.ir_voltages[i] = m->get_float();
+				data_.ir_voltages[i] = m.get_float();
 			new_data = true;
 
 		} else if (msgid == DirectRobotinoComMessage::CMDID_ALL_ANALOG_INPUTS) {
 			for (int i = 0; i < 8; ++i)
-				data_.analog_in[i] = m->get_float();
+				data_.analog_in[i] = m.get_float();
 			new_data = true;
 
 		} else if (msgid == DirectRobotinoComMessage::CMDID_ALL_DIGITAL_INPUTS) {
-			uint8_t value = m->get_uint8();
+			uint8_t value = m.get_uint8();
 			for (int i = 0; i < 8; ++i)
 				data_.digital_in[i] = (value & (1 << i)) ? true : false;
 			new_data = true;
 
 		} else if (msgid == DirectRobotinoComMessage::CMDID_BUMPER) {
-			data_.bumper = (m->get_uint8() != 0) ? true : false;
+			data_.bumper = (m.get_uint8() != 0) ? true : false;
 			new_data     = true;
 
 		} else if (msgid == DirectRobotinoComMessage::CMDID_ODOMETRY) {
-			data_.odo_x   = m->get_float();
-			data_.odo_y   = m->get_float();
-			data_.odo_phi = m->get_float();
+			data_.odo_x   = m.get_float();
+			data_.odo_y   = m.get_float();
+			data_.odo_phi = m.get_float();
 			new_data      = true;
 
 		} else if (msgid == DirectRobotinoComMessage::CMDID_POWER_SOURCE_READINGS) {
-			float voltage = m->get_float();
-			float current = m->get_float();
+			float voltage = m.get_float();
+			float current = m.get_float();
 
 			data_.bat_voltage = voltage * 1000.; // V -> mV
 			data_.bat_current = current * 1000.; // A -> mA
@@ -286,9 +287,9 @@ DirectRobotinoComThread::process_message(DirectRobotinoComMessage::pointer m)
 			new_data = true;
 
 		} else if (msgid == DirectRobotinoComMessage::CMDID_CHARGER_ERROR) {
-			uint8_t     id    = m->get_uint8();
-			uint32_t    mtime = m->get_uint32();
-			std::string error = m->get_string();
+			uint8_t     id    = m.get_uint8();
+			uint32_t    mtime = m.get_uint32();
+			std::string error = m.get_string();
 			logger->log_warn(name(), "Charger error (ID %u, Time: %u): %s", id, mtime, error.c_str());
 		}
 	}
@@ -719,7 +720,8 @@ DirectRobotinoComThread::send_and_recv(DirectRobotinoComMessage &msg)
 			close_device();
 			throw Exception("RobotinoDirect: write failed (%s)", ec.message().c_str());
 		}
-		std::shared_ptr<DirectRobotinoComMessage> m = read_packet();
+		DirectRobotinoComMessage::pointer m = std::make_shared<DirectRobotinoComMessage>();
+		read_packet(*m);
 		return m;
 	} else {
 		throw Exception("RobotinoDirect: serial device not opened");
@@ -763,8 +765,8 @@ struct is_match_condition<match_unescaped_length> : public boost::true_type
 } // namespace boost
 /// @endcond
 
-DirectRobotinoComMessage::pointer
-DirectRobotinoComThread::read_packet()
+void
+DirectRobotinoComThread::read_packet(DirectRobotinoComMessage &msg)
 {
 	boost::system::error_code ec         = boost::asio::error::would_block;
 	size_t                    bytes_read = 0;
@@ -850,12 +852,10 @@ DirectRobotinoComThread::read_packet()
 
 	deadline_.expires_at(boost::posix_time::pos_infin);
 
-	DirectRobotinoComMessage::pointer m = std::make_shared<DirectRobotinoComMessage>(
-	  boost::asio::buffer_cast<const unsigned char *>(input_buffer_.data()), input_buffer_.size());
-
-	input_buffer_.consume(m->escaped_data_size());
+	msg.parse(boost::asio::buffer_cast<const unsigned char *>(input_buffer_.data()),
+	          input_buffer_.size());
 
-	return m;
+	input_buffer_.consume(msg.escaped_data_size());
 }
 
 /** Check whether the deadline has passed.
@@ -931,15 +931,23 @@ void
 DirectRobotinoComThread::set_desired_vel(float vx, float vy, float omega)
 {
 	RobotinoComThread::set_desired_vel(vx, vy, omega);
-	drive();
+	// the drive timer is only touched from within the IO loop
+	io_service_.post(boost::bind(&DirectRobotinoComThread::drive, this));
 }
 
+/** Schedule velocity update.
+ * If an update is already pending, it will pick up the latest desired
+ * velocity. Restarting the timer instead would postpone the update on
+ * each new command, and starve it if commands arrive faster than the
+ * drive update interval.
+ */
 void
 DirectRobotinoComThread::drive()
 {
-	if (finalize_prepared)
+	if (finalize_prepared || drive_pending_)
 		return;
 
+	drive_pending_ = true;
 	drive_timer_.expires_from_now(boost::posix_time::milliseconds(cfg_drive_update_interval_));
 	drive_timer_.async_wait(
 	  boost::bind(&DirectRobotinoComThread::handle_drive, this, boost::asio::placeholders::error));
@@ -948,6 +956,7 @@ DirectRobotinoComThread::drive()
 void
 DirectRobotinoComThread::handle_drive(const boost::system::error_code &ec)
 {
+	drive_pending_ = false;
 	if (!ec) {
 		if (update_velocities())
 			drive();
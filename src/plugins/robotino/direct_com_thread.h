@@ -96,10 +96,10 @@ private:
 	void drive();
 	void handle_drive(const boost::system::error_code &ec);
 
-	DirectRobotinoComMessage::pointer read_packet();
+	void                              read_packet(DirectRobotinoComMessage &msg);
 	void                              send_message(DirectRobotinoComMessage &msg);
 	DirectRobotinoComMessage::pointer send_and_recv(DirectRobotinoComMessage &msg);
-	void                              process_message(DirectRobotinoComMessage::pointer m);
+	void                              process_message(DirectRobotinoComMessage &m);
 
 private:
 	std::string  cfg_device_;
@@ -131,6 +131,9 @@ private:
 	boost::asio::deadline_timer request_timer_;
 	boost::asio::deadline_timer nodata_timer_;
 	boost::asio::deadline_timer drive_timer_;
+	bool                        drive_pending_;
+
+	DirectRobotinoComMessage rx_msg_;
 };
 
 #endif
@@ -26,14 +26,68 @@
 #include <fvutils/ipc/shm_image.h>
 #include <sensor_msgs/image_encodings.h>
 
+#include <cstring>
+
 using namespace fawkes;
 using namespace firevision;
 
 /** @class RosImagesThread "image_thread.h"
  * Thread to export Fawkes images to ROS.
+ * Images in a colorspace which has a ROS encoding are copied as is,
+ * others are converted to RGB. Messages are published as shared pointers,
+ * so subscribers within the same process, e.g. nodelets, receive them
+ * without serialization. A message is reused for the next image unless a
+ * subscriber still holds a reference to it.
+ *
+ * Subscribers on the same host can avoid the copy altogether by reading
+ * the shared memory image buffer directly. Its ID is stored in the
+ * shm_image_id parameter below the image topic.
  * @author Tim Niemueller
  */
 
+/// @cond INTERNALS
+/** Get ROS encoding of a colorspace.
+ * @param cs colorspace of the shared memory image
+ * @return ROS encoding or NULL if the image must be converted
+ */
+static const char *
+ros_encoding(colorspace_t cs)
+{
+	switch (cs) {
+	case RGB: return sensor_msgs::image_encodings::RGB8.c_str();
+	case BGR: return sensor_msgs::image_encodings::BGR8.c_str();
+	case RGB_WITH_ALPHA: return sensor_msgs::image_encodings::RGBA8.c_str();
+	case BGR_WITH_ALPHA: return sensor_msgs::image_encodings::BGRA8.c_str();
+	case GRAY8:
+	case MONO8: return sensor_msgs::image_encodings::MONO8.c_str();
+	case MONO16: return sensor_msgs::image_encodings::MONO16.c_str();
+	case YUV422_PACKED: return sensor_msgs::image_encodings::YUV422.c_str();
+	case BAYER_MOSAIC_RGGB: return sensor_msgs::image_encodings::BAYER_RGGB8.c_str();
+	case BAYER_MOSAIC_GBRG: return sensor_msgs::image_encodings::BAYER_GBRG8.c_str();
+	case BAYER_MOSAIC_GRBG: return sensor_msgs::image_encodings::BAYER_GRBG8.c_str();
+	case BAYER_MOSAIC_BGGR: return sensor_msgs::image_encodings::BAYER_BGGR8.c_str();
+	default: return NULL;
+	}
+}
+
+/** Create image message with the same layout as another.
+ * @param proto message to copy header and layout from
+ * @return new message with data of proper size
+ */
+static sensor_msgs::ImagePtr
+new_image_msg(const sensor_msgs::Image &proto)
+{
+	sensor_msgs::ImagePtr msg(new sensor_msgs::Image());
+	msg->header   = proto.header;
+	msg->height   = proto.height;
+	msg->width    = proto.width;
+	msg->encoding = proto.encoding;
+	msg->step     = proto.step;
+	msg->data.resize(proto.data.size());
+	return msg;
+}
+/// @endcond
+
 /** Constructor. */
 RosImagesThread::RosImagesThread()
 : Thread("RosImagesThread", Thread::OPMODE_WAITFORWAKEUP),
@@ -65,8 +119,7 @@ RosImagesThread::finalize()
 	std::map<std::string, PublisherInfo>::iterator p;
 	for (p = pubs_.begin(); p != pubs_.end(); ++p) {
 		logger->log_info(name(), "Closing image %s", p->first.c_str());
-		p->second.pub.shutdown();
-		delete p->second.img;
+		shutdown_publisher(p->second);
 	}
 	pubs_.clear();
 }
@@ -89,16 +142,24 @@ RosImagesThread::loop()
 			pubinfo.last_sent = cap_time;
 
 			//logger->log_debug(name(), "Need to send %s", p->first.c_str());
-			pubinfo.msg.header.seq += 1;
-			pubinfo.msg.header.stamp = ros::Time(cap_time.get_sec(), cap_time.get_usec() * 1000);
-			convert(pubinfo.img->colorspace(),
-			        RGB,
-			        pubinfo.img->buffer(),
-			        &pubinfo.msg.data[0],
-			        pubinfo.msg.width,
-			        pubinfo.msg.height);
-
-			pubinfo.pub.publish(pubinfo.msg);
+			if (!pubinfo.msg.unique()) {
+				pubinfo.msg = new_image_msg(*pubinfo.msg);
+			}
+			sensor_msgs::Image &msg = *pubinfo.msg;
+			msg.header.seq += 1;
+			msg.header.stamp = ros::Time(cap_time.get_sec(), cap_time.get_usec() * 1000);
+			if (pubinfo.convert) {
+				convert(pubinfo.img->colorspace(),
+				        RGB,
+				        pubinfo.img->buffer(),
+				        &msg.data[0],
+				        msg.width,
+				        msg.height);
+			} else {
+				memcpy(&msg.data[0], pubinfo.img->buffer(), msg.data.size());
+			}
+
+			pubinfo.pub.publish(sensor_msgs::ImageConstPtr(pubinfo.msg));
 		}
 	}
 }
@@ -116,9 +177,7 @@ RosImagesThread::update_images()
 			logger->log_info(name(),
 			                 "Shutting down publisher for no longer available image %s",
 			                 i->c_str());
-			PublisherInfo &pubinfo = pubs_[*i];
-			pubinfo.pub.shutdown();
-			delete pubinfo.img;
+			shutdown_publisher(pubs_[*i]);
 			pubs_.erase(*i);
 		}
 	}
@@ -141,18 +200,39 @@ RosImagesThread::update_images()
 			pubinfo.pub = it_->advertise(topic_name, 1);
 			pubinfo.img = new SharedMemoryImageBuffer(i->c_str());
 
-			pubinfo.msg.header.frame_id = pubinfo.img->frame_id();
-			pubinfo.msg.height          = pubinfo.img->height();
-			pubinfo.msg.width           = pubinfo.img->width();
-			pubinfo.msg.encoding        = sensor_msgs::image_encodings::RGB8;
-			pubinfo.msg.step            = pubinfo.msg.width * 3; // for RGB
-			pubinfo.msg.data.resize(colorspace_buffer_size(RGB, pubinfo.msg.width, pubinfo.msg.height));
+			colorspace_t cs       = pubinfo.img->colorspace();
+			const char * encoding = ros_encoding(cs);
+			pubinfo.convert       = (encoding == NULL);
+			if (pubinfo.convert) {
+				cs       = RGB;
+				encoding = sensor_msgs::image_encodings::RGB8.c_str();
+			}
+
+			pubinfo.msg             = sensor_msgs::ImagePtr(new sensor_msgs::Image());
+			sensor_msgs::Image &msg = *pubinfo.msg;
+			msg.header.frame_id     = pubinfo.img->frame_id();
+			msg.height              = pubinfo.img->height();
+			msg.width               = pubinfo.img->width();
+			msg.encoding            = encoding;
+			msg.data.resize(colorspace_buffer_size(cs, msg.width, msg.height));
+			msg.step = msg.height > 0 ? msg.data.size() / msg.height : 0;
+
+			// allow consumers on this host to attach to the image directly
+			rosnode->setParam(pubinfo.pub.getTopic() + "/shm_image_id", *i);
 
 			pubs_[*i] = pubinfo;
 		}
 	}
 }
 
+void
+RosImagesThread::shutdown_publisher(PublisherInfo &pubinfo)
+{
+	rosnode->deleteParam(pubinfo.pub.getTopic() + "/shm_image_id");
+	pubinfo.pub.shutdown();
+	delete pubinfo.img;
+}
+
 void
 RosImagesThread::get_sets(std::set<std::string> &missing_images,
                           std::set<std::string> &unbacked_images)
@@ -66,13 +66,15 @@ protected:
 private:
 	void update_images();
 	void get_sets(std::set<std::string> &missing_images, std::set<std::string> &unbacked_images);
+	void shutdown_publisher(PublisherInfo &pubinfo);
 
 private:
 	/// @cond INTERNALS
 	typedef struct
 	{
 		image_transport::Publisher           pub;
-		sensor_msgs::Image                   msg;
+		sensor_msgs::ImagePtr                msg;
+		bool                                 convert;
 		fawkes::Time                         last_sent;
 		firevision::SharedMemoryImageBuffer *img;
 	} PublisherInfo;
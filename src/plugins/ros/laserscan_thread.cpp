@@ -67,6 +67,92 @@ RosLaserScanThread::topic_name(const char *if_id, const char *suffix)
 	return topic_name;
 }
 
+/** Create laser scan message.
+ * @param num_rays number of rays covering the full circle
+ * @return new message with angles and ranges set up
+ */
+static sensor_msgs::LaserScanPtr
+new_scan_msg(unsigned int num_rays)
+{
+	sensor_msgs::LaserScanPtr msg(new sensor_msgs::LaserScan());
+	msg->angle_min       = 0;
+	msg->angle_max       = 2 * M_PI;
+	msg->angle_increment = 2 * M_PI / num_rays;
+	msg->range_min       = 0.;
+	msg->range_max       = 1000.;
+	msg->ranges.resize(num_rays);
+	return msg;
+}
+
+/** Advertise topic for a laser interface.
+ * @param interface laser interface to publish
+ * @param frame coordinate frame of the laser
+ * @param num_rays number of rays of the interface
+ */
+void
+RosLaserScanThread::add_publisher(Interface *interface, const char *frame, unsigned int num_rays)
+{
+	std::string topname = topic_name(interface->id(), std::to_string(num_rays).c_str());
+
+	PublisherInfo pi;
+	pi.pub = rosnode->advertise<sensor_msgs::LaserScan>(topname, 1);
+
+	logger->log_info(name(),
+	                 "Publishing laser scan %s at %s, frame %s",
+	                 interface->uid(),
+	                 topname.c_str(),
+	                 frame);
+
+	pi.msg                  = new_scan_msg(num_rays);
+	pi.msg->header.frame_id = frame;
+
+	pubs_[interface->uid()] = pi;
+}
+
+/** Publish laser interface data.
+ * Nothing is published if there is no subscriber or if the interface has
+ * not been written since the last scan was published. The message is
+ * published as shared pointer, so subscribers within the same process,
+ * e.g. nodelets, receive it without serialization. It is reused for the
+ * next scan unless a subscriber still holds a reference to it.
+ * @param interface laser interface to publish
+ * @param frame coordinate frame of the laser
+ * @param distances distances of the interface
+ * @param num_rays number of rays of the interface
+ */
+void
+RosLaserScanThread::publish_scan(Interface *  interface,
+                                 const char * frame,
+                                 const float *distances,
+                                 unsigned int num_rays)
+{
+	PublisherInfo &pi = pubs_[interface->uid()];
+	if (pi.pub.getNumSubscribers() == 0) {
+		return;
+	}
+
+	interface->read();
+	const Time *time = interface->timestamp();
+	if (*time == pi.last_stamp) {
+		return;
+	}
+	pi.last_stamp = *time;
+
+	if (!pi.msg || !pi.msg.unique()) {
+		pi.msg = new_scan_msg(num_rays);
+	}
+
+	sensor_msgs::LaserScan &msg = *pi.msg;
+	seq_num_mutex_->lock();
+	msg.header.seq = ++seq_num_;
+	seq_num_mutex_->unlock();
+	msg.header.stamp    = ros::Time(time->get_sec(), time->get_nsec());
+	msg.header.frame_id = frame;
+	memcpy(&msg.ranges[0], distances, num_rays * sizeof(float));
+
+	pi.pub.publish(sensor_msgs::LaserScanConstPtr(pi.msg));
+}
+
 void
 RosLaserScanThread::init()
 {
@@ -89,20 +175,7 @@ RosLaserScanThread::init()
 		bbil_add_reader_interface(*i360);
 		bbil_add_writer_interface(*i360);
 
-		std::string topname = topic_name((*i360)->id(), "360");
-
-		PublisherInfo pi;
-		pi.pub = rosnode->advertise<sensor_msgs::LaserScan>(topname, 1);
-
-		logger->log_info(name(), "Publishing laser scan %s at %s", (*i360)->uid(), topname.c_str());
-
-		pi.msg.header.frame_id = (*i360)->frame();
-		pi.msg.angle_min       = 0;
-		pi.msg.angle_max       = 2 * M_PI;
-		pi.msg.angle_increment = deg2rad(1);
-		pi.msg.ranges.resize(360);
-
-		pubs_[(*i360)->uid()] = pi;
+		add_publisher(*i360, (*i360)->frame(), 360);
 	}
 
 	std::list<Laser720Interface *>::iterator i720;
@@ -112,20 +185,7 @@ RosLaserScanThread::init()
 		bbil_add_reader_interface(*i720);
 		bbil_add_writer_interface(*i720);
 
-		std::string topname = topic_name((*i720)->id(), "720");
-
-		PublisherInfo pi;
-		pi.pub = rosnode->advertise<sensor_msgs::LaserScan>(topname, 1);
-
-		logger->log_info(name(), "Publishing laser scan %s at %s", (*i720)->uid(), topname.c_str());
-
-		pi.msg.header.frame_id = (*i720)->frame();
-		pi.msg.angle_min       = 0;
-		pi.msg.angle_max       = 2 * M_PI;
-		pi.msg.angle_increment = deg2rad(0.5);
-		pi.msg.ranges.resize(720);
-
-		pubs_[(*i720)->uid()] = pi;
+		add_publisher(*i720, (*i720)->frame(), 720);
 	}
 
 	std::list<Laser1080Interface *>::iterator i1080;
@@ -135,24 +195,7 @@ RosLaserScanThread::init()
 		bbil_add_reader_interface(*i1080);
 		bbil_add_writer_interface(*i1080);
 
-		std::string topname = topic_name((*i1080)->id(), "1080");
-
-		PublisherInfo pi;
-		pi.pub = rosnode->advertise<sensor_msgs::LaserScan>(topname, 1);
-
-		logger->log_info(name(),
-		                 "Publishing laser scan %s at %s, frame %s",
-		                 (*i1080)->uid(),
-		                 topname.c_str(),
-		                 (*i1080)->frame());
-
-		pi.msg.header.frame_id = (*i1080)->frame();
-		pi.msg.angle_min       = 0;
-		pi.msg.angle_max       = 2 * M_PI;
-		pi.msg.angle_increment = deg2rad(1. / 3.);
-		pi.msg.ranges.resize(1080);
-
-		pubs_[(*i1080)->uid()] = pi;
+		add_publisher(*i1080, (*i1080)->frame(), 1080);
 	}
 
 	blackboard->register_listener(this);
@@ -215,38 +258,48 @@ RosLaserScanThread::loop()
 			                 "Received laser scan from ROS without caller ID,"
 			                 "ignoring");
 		} else {
-			bool have_interface = true;
-			if (ls360_wifs_.find(callerid) == ls360_wifs_.end()) {
+			Laser360Interface *ls360if = NULL;
+			auto               w       = ls360_wifs_.find(callerid);
+			if (w != ls360_wifs_.end()) {
+				ls360if = w->second;
+			} else {
 				try {
-					std::string        id      = std::string("ROS Laser ") + callerid;
-					Laser360Interface *ls360if = blackboard->open_for_writing<Laser360Interface>(id.c_str());
-					ls360_wifs_[callerid]      = ls360if;
+					std::string id        = std::string("ROS Laser ") + callerid;
+					ls360if               = blackboard->open_for_writing<Laser360Interface>(id.c_str());
+					ls360_wifs_[callerid] = ls360if;
 				} catch (Exception &e) {
 					logger->log_warn(name(),
 					                 "Failed to open ROS laser interface for "
 					                 "message from node %s, exception follows",
 					                 callerid.c_str());
 					logger->log_warn(name(), e);
-					have_interface = false;
 				}
 			}
 
-			if (have_interface) {
+			if (ls360if) {
 				// update interface with laser data
-				Laser360Interface *ls360if = ls360_wifs_[callerid];
 				ls360if->set_frame(msg->header.frame_id.c_str());
-				float distances[360];
-				for (unsigned int a = 0; a < 360; ++a) {
-					float a_rad = deg2rad(a);
-					if ((a_rad < msg->angle_min) || (a_rad > msg->angle_max)) {
-						distances[a] = 0.;
-					} else {
-						// get closest ray from message
-						int idx      = (int)roundf((a_rad - msg->angle_min) / msg->angle_increment);
-						distances[a] = msg->ranges[idx];
+				const float  step  = deg2rad(1);
+				const size_t nrays = msg->ranges.size();
+				if (nrays == 360 && msg->angle_min == 0.f && fabsf(msg->angle_increment - step) < 1e-6) {
+					// scan already matches the interface layout
+					ls360if->set_distances(&msg->ranges[0]);
+				} else {
+					float       distances[360];
+					const float inv_inc = 1.f / msg->angle_increment;
+					for (unsigned int a = 0; a < 360; ++a) {
+						float a_rad = a * step;
+						int   idx   = (int)roundf((a_rad - msg->angle_min) * inv_inc);
+						if ((a_rad < msg->angle_min) || (a_rad > msg->angle_max) || idx < 0
+						    || (size_t)idx >= nrays) {
+							distances[a] = 0.;
+						} else {
+							// closest ray from message
+							distances[a] = msg->ranges[idx];
+						}
 					}
+					ls360if->set_distances(distances);
 				}
-				ls360if->set_distances(distances);
 				ls360if->write();
 			}
 		}
@@ -262,71 +315,12 @@ RosLaserScanThread::bb_interface_data_refreshed(fawkes::Interface *interface) no
 	Laser720Interface * ls720if  = dynamic_cast<Laser720Interface *>(interface);
 	Laser1080Interface *ls1080if = dynamic_cast<Laser1080Interface *>(interface);
 
-	PublisherInfo &         pi  = pubs_[interface->uid()];
-	sensor_msgs::LaserScan &msg = pi.msg;
-
 	if (ls360if) {
-		ls360if->read();
-
-		const Time *time = ls360if->timestamp();
-
-		seq_num_mutex_->lock();
-		msg.header.seq = ++seq_num_;
-		seq_num_mutex_->unlock();
-		msg.header.stamp    = ros::Time(time->get_sec(), time->get_nsec());
-		msg.header.frame_id = ls360if->frame();
-
-		msg.angle_min       = 0;
-		msg.angle_max       = 2 * M_PI;
-		msg.angle_increment = deg2rad(1);
-		msg.range_min       = 0.;
-		msg.range_max       = 1000.;
-		msg.ranges.resize(360);
-		memcpy(&msg.ranges[0], ls360if->distances(), 360 * sizeof(float));
-
-		pi.pub.publish(pi.msg);
-
+		publish_scan(ls360if, ls360if->frame(), ls360if->distances(), 360);
 	} else if (ls720if) {
-		ls720if->read();
-
-		const Time *time = ls720if->timestamp();
-
-		seq_num_mutex_->lock();
-		msg.header.seq = ++seq_num_;
-		seq_num_mutex_->unlock();
-		msg.header.stamp    = ros::Time(time->get_sec(), time->get_nsec());
-		msg.header.frame_id = ls720if->frame();
-
-		msg.angle_min       = 0;
-		msg.angle_max       = 2 * M_PI;
-		msg.angle_increment = deg2rad(1. / 2.);
-		msg.range_min       = 0.;
-		msg.range_max       = 1000.;
-		msg.ranges.resize(720);
-		memcpy(&msg.ranges[0], ls720if->distances(), 720 * sizeof(float));
-
-		pi.pub.publish(pi.msg);
-
+		publish_scan(ls720if, ls720if->frame(), ls720if->distances(), 720);
 	} else if (ls1080if) {
-		ls1080if->read();
-
-		const Time *time = ls1080if->timestamp();
-
-		seq_num_mutex_->lock();
-		msg.header.seq = ++seq_num_;
-		seq_num_mutex_->unlock();
-		msg.header.stamp    = ros::Time(time->get_sec(), time->get_nsec());
-		msg.header.frame_id = ls1080if->frame();
-
-		msg.angle_min       = 0;
-		msg.angle_max       = 2 * M_PI;
-		msg.angle_increment = deg2rad(1. / 3.);
-		msg.range_min       = 0.;
-		msg.range_max       = 1000.;
-		msg.ranges.resize(1080);
-		memcpy(&msg.ranges[0], ls1080if->distances(), 1080 * sizeof(float));
-
-		pi.pub.publish(pi.msg);
+		publish_scan(ls1080if, ls1080if->frame(), ls1080if->distances(), 1080);
 	}
 }
 
@@ -353,20 +347,7 @@ RosLaserScanThread::bb_interface_created(const char *type, const char *id) noexc
 			bbil_add_reader_interface(ls360if);
 			bbil_add_writer_interface(ls360if);
 
-			std::string topname = topic_name(ls360if->id(), "360");
-
-			PublisherInfo pi;
-			pi.pub = rosnode->advertise<sensor_msgs::LaserScan>(topname, 1);
-
-			logger->log_info(name(), "Publishing laser scan %s at %s", ls360if->uid(), topname.c_str());
-
-			pi.msg.header.frame_id = ls360if->frame();
-			pi.msg.angle_min       = 0;
-			pi.msg.angle_max       = 2 * M_PI;
-			pi.msg.angle_increment = deg2rad(1);
-			pi.msg.ranges.resize(360);
-
-			pubs_[ls360if->uid()] = pi;
+			add_publisher(ls360if, ls360if->frame(), 360);
 
 			blackboard->update_listener(this);
 			ls360_ifs_.push_back(ls360if);
@@ -392,20 +373,7 @@ RosLaserScanThread::bb_interface_created(const char *type, const char *id) noexc
 			bbil_add_reader_interface(ls720if);
 			bbil_add_writer_interface(ls720if);
 
-			std::string topname = topic_name(ls720if->id(), "720");
-
-			PublisherInfo pi;
-			pi.pub = rosnode->advertise<sensor_msgs::LaserScan>(topname, 1);
-
-			logger->log_info(name(), "Publishing laser scan %s at %s", ls720if->uid(), topname.c_str());
-
-			pi.msg.header.frame_id = ls720if->frame();
-			pi.msg.angle_min       = 0;
-			pi.msg.angle_max       = 2 * M_PI;
-			pi.msg.angle_increment = deg2rad(0.5);
-			pi.msg.ranges.resize(720);
-
-			pubs_[ls720if->uid()] = pi;
+			add_publisher(ls720if, ls720if->frame(), 720);
 
 			blackboard->update_listener(this);
 			ls720_ifs_.push_back(ls720if);
@@ -431,23 +399,7 @@ RosLaserScanThread::bb_interface_created(const char *type, const char *id) noexc
 			bbil_add_reader_interface(ls1080if);
 			bbil_add_writer_interface(ls1080if);
 
-			std::string topname = topic_name(ls1080if->id(), "1080");
-
-			PublisherInfo pi;
-			pi.pub = rosnode->advertise<sensor_msgs::LaserScan>(topname, 1);
-
-			logger->log_info(name(),
-			                 "Publishing 1080 laser scan %s at %s",
-			                 ls1080if->uid(),
-			                 topname.c_str());
-
-			pi.msg.header.frame_id = ls1080if->frame();
-			pi.msg.angle_min       = 0;
-			pi.msg.angle_max       = 2 * M_PI;
-			pi.msg.angle_increment = deg2rad(0.5);
-			pi.msg.ranges.resize(1080);
-
-			pubs_[ls1080if->uid()] = pi;
+			add_publisher(ls1080if, ls1080if->frame(), 1080);
 
 			blackboard->update_listener(this);
 			ls1080_ifs_.push_back(ls1080if);
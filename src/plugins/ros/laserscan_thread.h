@@ -72,6 +72,11 @@ private:
 	void        laser_scan_message_cb(const ros::MessageEvent<sensor_msgs::LaserScan const> &msg_evt);
 	void        conditional_close(fawkes::Interface *interface) noexcept;
 	std::string topic_name(const char *if_id, const char *suffix);
+	void        add_publisher(fawkes::Interface *interface, const char *frame, unsigned int num_rays);
+	void        publish_scan(fawkes::Interface *interface,
+	                         const char *       frame,
+	                         const float *      distances,
+	                         unsigned int       num_rays);
 
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
@@ -91,8 +96,9 @@ private:
 	/// @cond INTERNALS
 	typedef struct
 	{
-		ros::Publisher         pub;
-		sensor_msgs::LaserScan msg;
+		ros::Publisher            pub;
+		sensor_msgs::LaserScanPtr msg;
+		fawkes::Time              last_stamp;
 	} PublisherInfo;
 	/// @endcond
 	std::map<std::string, PublisherInfo> pubs_;
@@ -23,6 +23,9 @@
 
 #include <core/threading/mutex_locker.h>
 #include <ros/this_node.h>
+#include <utils/misc/string_split.h>
+
+#include <algorithm>
 
 using namespace fawkes;
 
@@ -31,9 +34,26 @@ using namespace fawkes;
  * This threads connects to Fawkes and ROS to read and write transforms.
  * Transforms received on one end are republished to the other side. To
  * Fawkes new frames are published during the sensor hook.
+ *
+ * Transforms are exchanged in batches once per loop. All Fawkes
+ * transform updates of a cycle are sent to ROS in a single message, and
+ * all transforms received from ROS are written to Fawkes through a
+ * single TransformPublisher in as few TransformBatchInterface writes
+ * as possible.
  * @author Tim Niemueller
  */
 
+/// @cond INTERNALS
+/** ID of the transform publisher for transforms from ROS. */
+#define BRIDGE_PUBLISHER_ID "ros-bridge"
+
+static bool
+stamp_less(const fawkes::tf::StampedTransform &a, const fawkes::tf::StampedTransform &b)
+{
+	return a.stamp < b.stamp;
+}
+/// @endcond
+
 /** Constructor. */
 RosTfThread::RosTfThread()
 : Thread("RosTfThread", Thread::OPMODE_WAITFORWAKEUP),
@@ -43,6 +63,7 @@ RosTfThread::RosTfThread()
 {
 	tf_msg_queue_mutex_ = new Mutex();
 	seq_num_mutex_      = new Mutex();
+	pending_mutex_      = new Mutex();
 	last_update_        = new Time();
 }
 
@@ -51,14 +72,16 @@ RosTfThread::~RosTfThread()
 {
 	delete tf_msg_queue_mutex_;
 	delete seq_num_mutex_;
+	delete pending_mutex_;
 	delete last_update_;
 }
 
 void
 RosTfThread::init()
 {
-	active_queue_ = 0;
-	seq_num_      = 0;
+	active_queue_   = 0;
+	seq_num_        = 0;
+	pending_static_ = false;
 	last_update_->set_clock(clock);
 	last_update_->set_time(0, 0);
 
@@ -85,18 +108,41 @@ RosTfThread::init()
 		pub_tf_ = rosnode->advertise<::tf::tfMessage>("tf", 100);
 	}
 
+	tf_add_publisher(BRIDGE_PUBLISHER_ID);
+	bridge_id_ = std::string("/tf/") + BRIDGE_PUBLISHER_ID;
+
 	tfifs_ = blackboard->open_multiple_for_reading<TransformInterface>("/tf*");
-	std::list<TransformInterface *>::iterator i;
-	for (i = tfifs_.begin(); i != tfifs_.end(); ++i) {
-		bbil_add_data_interface(*i);
-		bbil_add_reader_interface(*i);
-		bbil_add_writer_interface(*i);
+	for (auto i = tfifs_.begin(); i != tfifs_.end();) {
+		if (is_own_interface((*i)->id())) {
+			blackboard->close(*i);
+			i = tfifs_.erase(i);
+		} else {
+			bbil_add_data_interface(*i);
+			bbil_add_reader_interface(*i);
+			bbil_add_writer_interface(*i);
+			++i;
+		}
+	}
+	batchifs_ = blackboard->open_multiple_for_reading<TransformBatchInterface>("/tf*");
+	for (auto b = batchifs_.begin(); b != batchifs_.end();) {
+		if (is_own_interface((*b)->id())) {
+			blackboard->close(*b);
+			b = batchifs_.erase(b);
+		} else {
+			++b;
+		}
+	}
+	for (TransformBatchInterface *batchif : batchifs_) {
+		bbil_add_data_interface(batchif);
+		bbil_add_reader_interface(batchif);
+		bbil_add_writer_interface(batchif);
 	}
 	blackboard->register_listener(this);
 
 	publish_static_transforms_to_ros();
 
 	bbio_add_observed_create("TransformInterface", "/tf*");
+	bbio_add_observed_create("TransformBatchInterface", "/tf*");
 	blackboard->register_observer(this);
 }
 
@@ -114,6 +160,10 @@ RosTfThread::finalize()
 		blackboard->close(*i);
 	}
 	tfifs_.clear();
+	for (TransformBatchInterface *batchif : batchifs_) {
+		blackboard->close(batchif);
+	}
+	batchifs_.clear();
 }
 
 void
@@ -124,14 +174,19 @@ RosTfThread::loop()
 	active_queue_      = 1 - active_queue_;
 	tf_msg_queue_mutex_->unlock();
 
+	std::vector<fawkes::tf::StampedTransform> transforms;
+	std::vector<fawkes::tf::StampedTransform> static_transforms;
+
 	if (cfg_use_tf2_) {
 #ifdef HAVE_TF2_MSGS
 		while (!tf2_msg_queues_[queue].empty()) {
 			const std::pair<bool, tf2_msgs::TFMessage::ConstPtr> &q     = tf2_msg_queues_[queue].front();
 			const tf2_msgs::TFMessage::ConstPtr &                 msg   = q.second;
 			const size_t                                          tsize = msg->transforms.size();
+
+			std::vector<fawkes::tf::StampedTransform> &batch = q.first ? static_transforms : transforms;
 			for (size_t i = 0; i < tsize; ++i) {
-				publish_transform_to_fawkes(msg->transforms[i], q.first);
+				batch.push_back(convert_transform(msg->transforms[i]));
 			}
 			tf2_msg_queues_[queue].pop();
 		}
@@ -148,11 +203,18 @@ RosTfThread::loop()
 				if (!ts.child_frame_id.empty() && ts.child_frame_id[0] == '/') {
 					ts.child_frame_id = ts.child_frame_id.substr(1);
 				}
-				publish_transform_to_fawkes(ts);
+				transforms.push_back(convert_transform(ts));
 			}
 			tf_msg_queues_[queue].pop();
 		}
+	}
+
+	publish_transforms_to_fawkes(transforms, false);
+	publish_transforms_to_fawkes(static_transforms, true);
 
+	publish_pending_transforms_to_ros();
+
+	if (!cfg_use_tf2_) {
 		fawkes::Time now(clock);
 		if ((now - last_update_) > cfg_update_interval_) {
 			last_update_->stamp();
@@ -165,49 +227,65 @@ RosTfThread::loop()
 void
 RosTfThread::bb_interface_data_refreshed(fawkes::Interface *interface) noexcept
 {
-	TransformInterface *tfif = dynamic_cast<TransformInterface *>(interface);
-	if (!tfif)
+	TransformInterface *     tfif    = dynamic_cast<TransformInterface *>(interface);
+	TransformBatchInterface *batchif = dynamic_cast<TransformBatchInterface *>(interface);
+	if (!tfif && !batchif)
 		return;
 
-	tfif->read();
+	interface->read();
+	bool is_static = tfif ? tfif->is_static_transform() : batchif->is_static_transform();
 
-	if (cfg_use_tf2_ && tfif->is_static_transform()) {
-		publish_static_transforms_to_ros();
-	} else {
-		if (cfg_use_tf2_) {
-#ifdef HAVE_TF2_MSGS
-			tf2_msgs::TFMessage tmsg;
-			tmsg.transforms.push_back(create_transform_stamped(tfif));
-			pub_tf_.publish(tmsg);
-#endif
+	MutexLocker lock(pending_mutex_);
+	if (cfg_use_tf2_ && is_static) {
+		pending_static_ = true;
+	} else if (is_static) {
+		// date time stamps slightly into the future so they are valid
+		// for longer and need less frequent updates.
+		fawkes::Time timestamp = fawkes::Time(clock) + (cfg_update_interval_ * 1.1);
+		if (tfif) {
+			pending_tfs_.push_back(create_transform_stamped(tfif, &timestamp));
 		} else {
-			::tf::tfMessage tmsg;
-			if (tfif->is_static_transform()) {
-				// date time stamps slightly into the future so they are valid
-				// for longer and need less frequent updates.
-				fawkes::Time timestamp = fawkes::Time(clock) + (cfg_update_interval_ * 1.1);
-
-				tmsg.transforms.push_back(create_transform_stamped(tfif, &timestamp));
-			} else {
-				tmsg.transforms.push_back(create_transform_stamped(tfif));
-			}
-			pub_tf_.publish(tmsg);
+			create_transforms_stamped(batchif, pending_tfs_, &timestamp);
 		}
+	} else if (tfif) {
+		pending_tfs_.push_back(create_transform_stamped(tfif));
+	} else {
+		create_transforms_stamped(batchif, pending_tfs_);
 	}
 }
 
 void
 RosTfThread::bb_interface_created(const char *type, const char *id) noexcept
 {
-	if (strncmp(type, "TransformInterface", INTERFACE_TYPE_SIZE_) != 0)
+	// ignore interfaces that we publish ourself
+	if (is_own_interface(id))
 		return;
 
-	for (const auto &f : ros_frames_) {
-		// ignore interfaces that we publish ourself
-		if (f == id)
+	if (strncmp(type, "TransformBatchInterface", INTERFACE_TYPE_SIZE_) == 0) {
+		TransformBatchInterface *batchif;
+		try {
+			batchif = blackboard->open_for_reading<TransformBatchInterface>(id);
+		} catch (Exception &e) {
+			logger->log_warn(name(), "Failed to open %s:%s: %s", type, id, e.what());
 			return;
+		}
+
+		try {
+			bbil_add_data_interface(batchif);
+			bbil_add_reader_interface(batchif);
+			bbil_add_writer_interface(batchif);
+			blackboard->update_listener(this);
+			batchifs_.push_back(batchif);
+		} catch (Exception &e) {
+			blackboard->close(batchif);
+			logger->log_warn(name(), "Failed to register for %s:%s: %s", type, id, e.what());
+		}
+		return;
 	}
 
+	if (strncmp(type, "TransformInterface", INTERFACE_TYPE_SIZE_) != 0)
+		return;
+
 	TransformInterface *tfif;
 	try {
 		//logger->log_info(name(), "Opening %s:%s", type, id);
@@ -248,6 +326,26 @@ RosTfThread::bb_interface_reader_removed(fawkes::Interface *interface,
 void
 RosTfThread::conditional_close(Interface *interface) noexcept
 {
+	TransformBatchInterface *batchif = dynamic_cast<TransformBatchInterface *>(interface);
+	if (batchif) {
+		std::list<TransformBatchInterface *>::iterator b;
+		for (b = batchifs_.begin(); b != batchifs_.end(); ++b) {
+			if (*interface == **b) {
+				if (!interface->has_writer() && (interface->num_readers() == 1)) {
+					logger->log_info(name(), "Last on %s, closing", interface->uid());
+					bbil_remove_data_interface(*b);
+					bbil_remove_reader_interface(*b);
+					bbil_remove_writer_interface(*b);
+					blackboard->update_listener(this);
+					blackboard->close(*b);
+					batchifs_.erase(b);
+				}
+				break;
+			}
+		}
+		return;
+	}
+
 	// Verify it's a TransformInterface
 	TransformInterface *tfif = dynamic_cast<TransformInterface *>(interface);
 	if (!tfif)
@@ -304,6 +402,44 @@ RosTfThread::create_transform_stamped(TransformInterface *tfif, const Time *time
 	return ts;
 }
 
+void
+RosTfThread::create_transforms_stamped(TransformBatchInterface *                     batchif,
+                                       std::vector<geometry_msgs::TransformStamped> &transforms,
+                                       const Time *                                  time)
+{
+	double *   translation = batchif->translation();
+	double *   rotation    = batchif->rotation();
+	uint16_t * frame       = batchif->frame();
+	uint16_t * child_frame = batchif->child_frame();
+	if (!time)
+		time = batchif->timestamp();
+
+	const std::vector<std::string> frames = str_split(batchif->frames(), ' ');
+	const unsigned int             num_transforms =
+	  std::min<unsigned int>(batchif->num_transforms(), batchif->maxlenof_child_frame());
+
+	for (unsigned int i = 0; i < num_transforms; ++i) {
+		if (frame[i] >= frames.size() || child_frame[i] >= frames.size())
+			continue;
+
+		geometry_msgs::TransformStamped ts;
+		seq_num_mutex_->lock();
+		ts.header.seq = ++seq_num_;
+		seq_num_mutex_->unlock();
+		ts.header.stamp            = ros::Time(time->get_sec(), time->get_nsec());
+		ts.header.frame_id         = frames[frame[i]];
+		ts.child_frame_id          = frames[child_frame[i]];
+		ts.transform.translation.x = translation[3 * i];
+		ts.transform.translation.y = translation[3 * i + 1];
+		ts.transform.translation.z = translation[3 * i + 2];
+		ts.transform.rotation.x    = rotation[4 * i];
+		ts.transform.rotation.y    = rotation[4 * i + 1];
+		ts.transform.rotation.z    = rotation[4 * i + 2];
+		ts.transform.rotation.w    = rotation[4 * i + 3];
+		transforms.push_back(ts);
+	}
+}
+
 void
 RosTfThread::publish_static_transforms_to_ros()
 {
@@ -320,6 +456,12 @@ RosTfThread::publish_static_transforms_to_ros()
 				tmsg.transforms.push_back(create_transform_stamped(tfif, &now));
 			}
 		}
+		for (TransformBatchInterface *batchif : batchifs_) {
+			batchif->read();
+			if (batchif->is_static_transform()) {
+				create_transforms_stamped(batchif, tmsg.transforms, &now);
+			}
+		}
 		pub_static_tf_.publish(tmsg);
 #endif
 	} else {
@@ -335,36 +477,100 @@ RosTfThread::publish_static_transforms_to_ros()
 				tmsg.transforms.push_back(create_transform_stamped(tfif, &timestamp));
 			}
 		}
+		for (TransformBatchInterface *batchif : batchifs_) {
+			batchif->read();
+			if (batchif->is_static_transform()) {
+				create_transforms_stamped(batchif, tmsg.transforms, &timestamp);
+			}
+		}
 		pub_tf_.publish(tmsg);
 	}
 }
 
+/** Check if an interface is written by this thread.
+ * @param id interface ID
+ * @return true if the interface belongs to the publisher of transforms
+ * from ROS, false otherwise
+ */
+bool
+RosTfThread::is_own_interface(const char *id) const
+{
+	return (strncmp(id, bridge_id_.c_str(), bridge_id_.size()) == 0)
+	       && (id[bridge_id_.size()] == 0 || id[bridge_id_.size()] == '/');
+}
+
+/** Publish transform updates collected since the last loop to ROS.
+ * All transforms are sent in a single message.
+ */
 void
-RosTfThread::publish_transform_to_fawkes(const geometry_msgs::TransformStamped &ts, bool static_tf)
+RosTfThread::publish_pending_transforms_to_ros()
+{
+	std::vector<geometry_msgs::TransformStamped> transforms;
+	bool                                         publish_static;
+	{
+		MutexLocker lock(pending_mutex_);
+		transforms.swap(pending_tfs_);
+		publish_static  = pending_static_;
+		pending_static_ = false;
+	}
+
+	if (publish_static) {
+		publish_static_transforms_to_ros();
+	}
+
+	if (transforms.empty())
+		return;
+
+	if (cfg_use_tf2_) {
+#ifdef HAVE_TF2_MSGS
+		tf2_msgs::TFMessage tmsg;
+		tmsg.transforms.swap(transforms);
+		pub_tf_.publish(tmsg);
+#endif
+	} else {
+		::tf::tfMessage tmsg;
+		tmsg.transforms.swap(transforms);
+		pub_tf_.publish(tmsg);
+	}
+}
+
+/** Convert ROS transform to Fawkes transform.
+ * @param ts ROS transform
+ * @return Fawkes transform
+ */
+fawkes::tf::StampedTransform
+RosTfThread::convert_transform(const geometry_msgs::TransformStamped &ts)
 {
 	const geometry_msgs::Vector3 &   t = ts.transform.translation;
 	const geometry_msgs::Quaternion &r = ts.transform.rotation;
 
 	fawkes::Time time(ts.header.stamp.sec, ts.header.stamp.nsec / 1000);
 
-	fawkes::tf::Transform        tr(fawkes::tf::Quaternion(r.x, r.y, r.z, r.w),
-                           fawkes::tf::Vector3(t.x, t.y, t.z));
-	fawkes::tf::StampedTransform st(tr, time, ts.header.frame_id, ts.child_frame_id);
+	fawkes::tf::Transform tr(fawkes::tf::Quaternion(r.x, r.y, r.z, r.w),
+	                         fawkes::tf::Vector3(t.x, t.y, t.z));
+	return fawkes::tf::StampedTransform(tr, time, ts.header.frame_id, ts.child_frame_id);
+}
 
-	if (tf_publishers.find(ts.child_frame_id) == tf_publishers.end()) {
-		try {
-			ros_frames_.push_back(std::string("/tf/") + ts.child_frame_id);
-			tf_add_publisher("%s", ts.child_frame_id.c_str());
-			tf_publishers[ts.child_frame_id]->send_transform(st, static_tf);
-		} catch (Exception &e) {
-			ros_frames_.pop_back();
-			logger->log_warn(name(),
-			                 "Failed to create Fawkes transform publisher for frame %s from ROS",
-			                 ts.child_frame_id.c_str());
-			logger->log_warn(name(), e);
-		}
-	} else {
-		tf_publishers[ts.child_frame_id]->send_transform(st, static_tf);
+/** Publish transforms received from ROS to Fawkes.
+ * The transforms are sorted by time and then sent as batch, such that
+ * all transforms with the same time stamp require a single write.
+ * @param transforms transforms to publish, sorted in place
+ * @param static_tf true if the transforms are static, false otherwise
+ */
+void
+RosTfThread::publish_transforms_to_fawkes(std::vector<fawkes::tf::StampedTransform> &transforms,
+                                          bool                                       static_tf)
+{
+	if (transforms.empty())
+		return;
+
+	std::stable_sort(transforms.begin(), transforms.end(), stamp_less);
+
+	try {
+		tf_publishers[BRIDGE_PUBLISHER_ID]->send_transforms(transforms, static_tf);
+	} catch (Exception &e) {
+		logger->log_warn(name(), "Failed to publish %zu transforms from ROS", transforms.size());
+		logger->log_warn(name(), e);
 	}
 }
 
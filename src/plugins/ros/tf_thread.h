@@ -32,11 +32,13 @@
 #include <blackboard/interface_observer.h>
 #include <core/threading/mutex.h>
 #include <core/threading/thread.h>
+#include <interfaces/TransformBatchInterface.h>
 #include <interfaces/TransformInterface.h>
 #include <plugins/ros/aspect/ros.h>
 
 #include <list>
 #include <queue>
+#include <vector>
 
 // from ROS
 #include <ros/common.h>
@@ -84,11 +86,17 @@ private:
 #endif
 
 	void conditional_close(fawkes::Interface *interface) noexcept;
+	bool is_own_interface(const char *id) const;
 	void publish_static_transforms_to_ros();
-	void publish_transform_to_fawkes(const geometry_msgs::TransformStamped &ts,
-	                                 bool                                   static_tf = false);
+	void publish_pending_transforms_to_ros();
+	void publish_transforms_to_fawkes(std::vector<fawkes::tf::StampedTransform> &transforms,
+	                                  bool                                       static_tf);
+	fawkes::tf::StampedTransform convert_transform(const geometry_msgs::TransformStamped &ts);
 	geometry_msgs::TransformStamped create_transform_stamped(fawkes::TransformInterface *tfif,
 	                                                         const fawkes::Time *        time = NULL);
+	void create_transforms_stamped(fawkes::TransformBatchInterface *              batchif,
+	                               std::vector<geometry_msgs::TransformStamped> &transforms,
+	                               const fawkes::Time *                          time = NULL);
 
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
@@ -102,8 +110,9 @@ private:
 	bool  cfg_use_tf2_;
 	float cfg_update_interval_;
 
-	std::list<std::string>                  ros_frames_;
-	std::list<fawkes::TransformInterface *> tfifs_;
+	std::string                                  bridge_id_;
+	std::list<fawkes::TransformInterface *>      tfifs_;
+	std::list<fawkes::TransformBatchInterface *> batchifs_;
 
 	ros::Subscriber sub_tf_;
 	ros::Subscriber sub_static_tf_;
@@ -120,6 +129,10 @@ private:
 	fawkes::Mutex *seq_num_mutex_;
 	unsigned int   seq_num_;
 
+	fawkes::Mutex *                              pending_mutex_;
+	std::vector<geometry_msgs::TransformStamped> pending_tfs_;
+	bool                                         pending_static_;
+
 	fawkes::Time *last_update_;
 };
 
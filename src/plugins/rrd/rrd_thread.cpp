@@ -23,6 +23,7 @@
 #include "rrd_thread.h"
 
 #include <core/exceptions/system.h>
+#include <core/threading/mutex_locker.h>
 #include <core/threading/scoped_rwlock.h>
 #include <utils/misc/string_conversions.h>
 #include <utils/system/file.h>
@@ -35,12 +36,46 @@
 
 using namespace fawkes;
 
+/// @cond INTERNALS
+/** Renders graphs outside of the RRD main thread.
+ * Rendering many graphs may take seconds, doing it in a separate thread
+ * keeps the periodic flush of buffered updates on time.
+ */
+class RRDGraphRenderThread : public Thread
+{
+public:
+	RRDGraphRenderThread(RRDThread *rrd_thread)
+	: Thread("RRDGraphRenderThread", Thread::OPMODE_WAITFORWAKEUP), rrd_thread_(rrd_thread)
+	{
+	}
+
+	virtual void
+	loop()
+	{
+		// do not get cancelled while holding the graph and librrd locks
+		CancelState old_state;
+		set_cancel_state(CANCEL_DISABLED, &old_state);
+		rrd_thread_->generate_graphs();
+		set_cancel_state(old_state);
+	}
+
+private:
+	RRDThread *rrd_thread_;
+};
+/// @endcond
+
 /** @class RRDThread "rrd_thread.h"
  * RRD Thread.
  * This thread maintains an active connection to RRD and provides an
  * aspect to access RRD to make it convenient for other threads to use
  * RRD.
  *
+ * Data added with add_data() is buffered and written periodically with
+ * one update per RRD, callers never wait for disk I/O. Graphs are rendered
+ * in a separate thread, and only if their RRD received new data since
+ * they have last been rendered. Optionally, updates and graphs are passed
+ * through rrdcached to further reduce the I/O load.
+ *
  * @author Tim Niemueller
  */
 
@@ -48,7 +83,10 @@ using namespace fawkes;
 RRDThread::RRDThread()
 : Thread("RRDThread", Thread::OPMODE_CONTINUOUS),
   AspectProviderAspect(&rrd_aspect_inifin_),
-  rrd_aspect_inifin_(this)
+  rrd_aspect_inifin_(this),
+  render_thread_(NULL),
+  time_wait_(NULL),
+  last_graph_time_((long int)0, (long int)0)
 {
 	set_prepfin_conc_loop(true);
 }
@@ -66,13 +104,36 @@ RRDThread::init()
 		cfg_graph_interval_ = config->get_float("/plugins/rrd/graph_interval");
 	} catch (Exception &e) {
 	}
+	cfg_flush_interval_ = 5.;
+	try {
+		cfg_flush_interval_ = config->get_float("/plugins/rrd/flush_interval");
+	} catch (Exception &e) {
+	}
+	if (cfg_flush_interval_ > cfg_graph_interval_) {
+		cfg_flush_interval_ = cfg_graph_interval_;
+	}
+	cfg_rrdcached_address_ = "";
+	try {
+		cfg_rrdcached_address_ = config->get_string("/plugins/rrd/rrdcached_address");
+	} catch (Exception &e) {
+	}
+	if (!cfg_rrdcached_address_.empty()) {
+		logger->log_info(name(), "Using rrdcached at %s", cfg_rrdcached_address_.c_str());
+	}
+
+	time_wait_ = new TimeWait(clock, time_sec_to_usec(cfg_flush_interval_));
 
-	time_wait_ = new TimeWait(clock, time_sec_to_usec(cfg_graph_interval_));
+	render_thread_ = new RRDGraphRenderThread(this);
+	render_thread_->start();
 }
 
 void
 RRDThread::finalize()
 {
+	flush_updates();
+	render_thread_->cancel();
+	render_thread_->join();
+	delete render_thread_;
 	delete time_wait_;
 }
 
@@ -80,35 +141,111 @@ void
 RRDThread::loop()
 {
 	time_wait_->mark_start();
-	generate_graphs();
+	flush_updates();
+
+	Time now(clock);
+	if (now - &last_graph_time_ >= cfg_graph_interval_) {
+		last_graph_time_ = now;
+		render_thread_->wakeup();
+	}
 	time_wait_->wait_systime();
 }
 
-/** Generate all graphs. */
+/** Write buffered data to the RRDs.
+ * All values added since the last flush are written with a single update
+ * call per RRD. Failures are logged, the values are discarded.
+ */
+void
+RRDThread::flush_updates()
+{
+	std::map<std::string, PendingUpdates> updates;
+	pending_mutex_.lock();
+	updates.swap(pending_updates_);
+	pending_mutex_.unlock();
+
+	std::set<std::string> updated;
+	for (const auto &u : updates) {
+		// update [--daemon ADDRESS] filename data...
+		std::vector<const char *> rrd_argv;
+		rrd_argv.push_back("update");
+		if (!cfg_rrdcached_address_.empty()) {
+			rrd_argv.push_back("--daemon");
+			rrd_argv.push_back(cfg_rrdcached_address_.c_str());
+		}
+		rrd_argv.push_back(u.second.filename.c_str());
+		for (const auto &v : u.second.values) {
+			rrd_argv.push_back(v.c_str());
+		}
+
+		MutexLocker lock(&rrd_mutex_);
+		rrd_clear_error();
+		if (rrd_update(rrd_argv.size(), (char **)&rrd_argv[0]) == -1) {
+			logger->log_warn(name(),
+			                 "Failed to update RRD %s with %zu values: %s",
+			                 u.first.c_str(),
+			                 u.second.values.size(),
+			                 rrd_get_error());
+		} else {
+			updated.insert(u.first);
+		}
+	}
+
+	if (!updated.empty()) {
+		MutexLocker lock(&pending_mutex_);
+		updated_rrds_.insert(updated.begin(), updated.end());
+	}
+}
+
+/** Generate graphs.
+ * Only graphs for RRDs which have been updated since the last call are
+ * rendered. Failures are logged and do not prevent rendering the other
+ * graphs.
+ */
 void
 RRDThread::generate_graphs()
 {
+	std::set<std::string> updated;
+	pending_mutex_.lock();
+	updated.swap(updated_rrds_);
+	pending_mutex_.unlock();
+
+	if (updated.empty())
+		return;
+
 	ScopedRWLock lock(graphs_.rwlock(), ScopedRWLock::LOCK_READ);
 
 	std::vector<fawkes::RRDGraphDefinition *>::iterator g;
 	for (g = graphs_.begin(); g != graphs_.end(); ++g) {
+		if (updated.find((*g)->get_rrd_def()->get_name()) == updated.end())
+			continue;
+
 		size_t       argc = 0;
 		const char **argv = (*g)->get_argv(argc);
 
+		// graph filename [--daemon ADDRESS] options...
+		std::vector<const char *> graph_argv(argv, argv + argc);
+		if (!cfg_rrdcached_address_.empty() && argc >= 2) {
+			graph_argv.insert(graph_argv.begin() + 2, cfg_rrdcached_address_.c_str());
+			graph_argv.insert(graph_argv.begin() + 2, "--daemon");
+		}
+
 		//logger->log_debug(name(), "rrd_graph arguments:");
-		//for (size_t j = 0; j < argc; ++j) {
-		//  logger->log_debug(name(), "  %zu: %s", j, argv[j]);
+		//for (size_t j = 0; j < graph_argv.size(); ++j) {
+		//  logger->log_debug(name(), "  %zu: %s", j, graph_argv[j]);
 		//}
 
+		MutexLocker rrd_lock(&rrd_mutex_);
 		rrd_clear_error();
-		rrd_info_t *i = rrd_graph_v(argc, (char **)argv);
+		rrd_info_t *i = rrd_graph_v(graph_argv.size(), (char **)&graph_argv[0]);
 		if (i == NULL) {
-			throw Exception("Creating graph %s (for RRD %s) failed: %s",
-			                (*g)->get_name(),
-			                (*g)->get_rrd_def()->get_name(),
-			                rrd_get_error());
+			logger->log_warn(name(),
+			                 "Creating graph %s (for RRD %s) failed: %s",
+			                 (*g)->get_name(),
+			                 (*g)->get_rrd_def()->get_name(),
+			                 rrd_get_error());
+		} else {
+			rrd_info_free(i);
 		}
-		rrd_info_free(i);
 	}
 }
 
@@ -154,6 +291,7 @@ RRDThread::add_rrd(RRDDefinition *rrd_def)
 		//}
 
 		// Create RRD file
+		MutexLocker rrd_lock(&rrd_mutex_);
 		rrd_clear_error();
 		if (rrd_create(i, (char **)rrd_argv) == -1) {
 			throw Exception("Creating RRD %s failed: %s", rrd_def->get_name(), rrd_get_error());
@@ -175,6 +313,13 @@ RRDThread::add_rrd(RRDDefinition *rrd_def)
 void
 RRDThread::remove_rrd(RRDDefinition *rrd_def)
 {
+	flush_updates();
+	pending_mutex_.lock();
+	pending_updates_.erase(rrd_def->get_name());
+	last_update_time_.erase(rrd_def->get_name());
+	updated_rrds_.erase(rrd_def->get_name());
+	pending_mutex_.unlock();
+
 	ScopedRWLock                                    rrds_lock(rrds_.rwlock());
 	RWLockVector<fawkes::RRDDefinition *>::iterator r;
 	for (r = rrds_.begin(); r != rrds_.end(); ++r) {
@@ -239,26 +384,33 @@ RRDThread::add_data(const char *rrd_name, const char *format, ...)
 			}
 			va_end(arg);
 
-			// filename data
-			size_t      rrd_argc = 3;
-			const char *rrd_argv[rrd_argc];
-			size_t      i = 0;
-			rrd_argv[i++] = "update";
-			rrd_argv[i++] = rrd_def->get_filename();
-			rrd_argv[i++] = data;
-
-			//logger->log_debug(name(), "rrd_update arguments:");
-			//for (size_t j = 0; j < i; ++j) {
-			//  logger->log_debug(name(), "  %zu: %s", j, rrd_argv[j]);
-			//}
-
-			rrd_clear_error();
-			if (rrd_update(i, (char **)rrd_argv) == -1) {
-				free(data);
-				throw Exception("Failed to update RRD %s: %s", rrd_name, rrd_get_error());
+			// resolve "N" now, the update is written later
+			std::string value(data);
+			free(data);
+			time_t timestamp;
+			if (value.compare(0, 2, "N:") == 0) {
+				timestamp = time(NULL);
+				value     = StringConversions::to_string((long int)timestamp) + value.substr(1);
+			} else {
+				timestamp = (time_t)strtol(value.c_str(), NULL, 10);
 			}
 
-			free(data);
+			MutexLocker     lock(&pending_mutex_);
+			PendingUpdates &p = pending_updates_[rrd_name];
+			if (p.filename.empty()) {
+				p.filename = rrd_def->get_filename();
+			}
+			time_t &last = last_update_time_[rrd_name];
+			if (timestamp == last && !p.values.empty()) {
+				// at most one update per second, latest value wins
+				p.values.back() = value;
+			} else if (timestamp <= last) {
+				// RRD rejects updates not newer than the last one
+				return;
+			} else {
+				p.values.push_back(value);
+				last = timestamp;
+			}
 			return;
 		}
 	}
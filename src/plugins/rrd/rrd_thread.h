@@ -27,12 +27,22 @@
 #include <aspect/clock.h>
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
+#include <core/threading/mutex.h>
 #include <core/threading/thread.h>
 #include <core/utils/rwlock_vector.h>
 #include <plugins/rrd/aspect/rrd_inifin.h>
 #include <plugins/rrd/aspect/rrd_manager.h>
+#include <utils/time/time.h>
 #include <utils/time/wait.h>
 
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class RRDGraphRenderThread;
+
 class RRDThread : public fawkes::Thread,
                   public fawkes::LoggingAspect,
                   public fawkes::ConfigurableAspect,
@@ -59,6 +69,7 @@ public:
 	virtual const fawkes::RWLockVector<fawkes::RRDGraphDefinition *> &get_graphs() const;
 
 	void generate_graphs();
+	void flush_updates();
 
 	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
 protected:
@@ -74,8 +85,26 @@ private:
 	fawkes::RWLockVector<fawkes::RRDDefinition *>      rrds_;
 	fawkes::RWLockVector<fawkes::RRDGraphDefinition *> graphs_;
 
-	fawkes::TimeWait *time_wait_;
-	float             cfg_graph_interval_;
+	/// @cond INTERNALS
+	typedef struct
+	{
+		std::string              filename;
+		std::vector<std::string> values;
+	} PendingUpdates;
+	/// @endcond
+
+	fawkes::Mutex                         rrd_mutex_;
+	fawkes::Mutex                         pending_mutex_;
+	std::map<std::string, PendingUpdates> pending_updates_;
+	std::map<std::string, time_t>         last_update_time_;
+	std::set<std::string>                 updated_rrds_;
+
+	RRDGraphRenderThread *render_thread_;
+	fawkes::TimeWait *    time_wait_;
+	fawkes::Time          last_graph_time_;
+	float                 cfg_graph_interval_;
+	float                 cfg_flush_interval_;
+	std::string           cfg_rrdcached_address_;
 };
 
 #endif
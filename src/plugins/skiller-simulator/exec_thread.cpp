@@ -180,8 +180,7 @@ SkillerSimulatorExecutionThread::finalize()
 float
 SkillerSimulatorExecutionThread::get_skill_runtime(const std::string &skill) const
 {
-	auto provider = execution_time_estimator_manager_->get_provider(skill);
-	return provider->get_execution_time(skill);
+	return execution_time_estimator_manager_->get_execution_time(skill);
 }
 
 std::pair<fawkes::SkillerInterface::SkillStatusEnum, std::string>
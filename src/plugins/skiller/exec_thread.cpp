@@ -32,6 +32,7 @@
 #	include <utils/time/tracker.h>
 #endif
 
+#include <interfaces/LuaGCInterface.h>
 #include <interfaces/SkillerDebugInterface.h>
 #include <interfaces/SkillerInterface.h>
 #include <lua/context.h>
@@ -76,17 +77,29 @@ SkillerExecutionThread::init()
 		throw;
 	}
 
+	std::string cfg_gc_mode = config->get_string_or_default("/skiller/lua-gc/mode", "incremental");
+
+	unsigned int cfg_gc_pause   = config->get_uint_or_default("/skiller/lua-gc/pause", 0);
+	unsigned int cfg_gc_stepmul = config->get_uint_or_default("/skiller/lua-gc/stepmul", 0);
+	cfg_gc_step_kb_             = config->get_uint_or_default("/skiller/lua-gc/step-kb", 0);
+
 	logger->log_debug("SkillerExecutionThread", "Skill space: %s", cfg_skillspace_.c_str());
 	clog_ = new ComponentLogger(logger, "SkillerLua");
 
 	lua_        = NULL;
 	bbo_        = NULL;
 	skiller_if_ = NULL;
+	gc_if_      = NULL;
 
 	try {
 		skiller_if_ = blackboard->open_for_reading<SkillerInterface>("Skiller");
+		gc_if_      = blackboard->open_for_writing<LuaGCInterface>("Skiller Lua GC");
 
 		lua_ = new LuaContext();
+		lua_->set_gc_mode((cfg_gc_mode == "generational") ? LuaContext::GC_GENERATIONAL
+		                                                  : LuaContext::GC_INCREMENTAL,
+		                  cfg_gc_pause,
+		                  cfg_gc_stepmul);
 		if (cfg_watch_files_) {
 			lua_->setup_fam(/* auto restart */ true, /* conc thread */ false);
 		}
@@ -133,6 +146,7 @@ SkillerExecutionThread::init()
 
 	} catch (Exception &e) {
 		blackboard->close(skiller_if_);
+		blackboard->close(gc_if_);
 		delete lua_;
 		delete bbo_;
 		delete clog_;
@@ -151,6 +165,7 @@ SkillerExecutionThread::finalize()
 
 	blackboard->unregister_listener(this);
 	blackboard->close(skiller_if_);
+	blackboard->close(gc_if_);
 
 	std::list<SkillerFeature *>::iterator f;
 	for (f = features_.begin(); f != features_.end(); ++f) {
@@ -229,4 +244,17 @@ SkillerExecutionThread::loop()
 	skiller_if_removed_readers_.unlock();
 
 	lua_->do_string("skillenv.loop()");
+
+	if (cfg_gc_step_kb_ > 0) {
+		lua_->gc_step(cfg_gc_step_kb_);
+
+		LuaContext::GCStats stats = lua_->gc_stats();
+		gc_if_->set_memory_kb(stats.memory_kb);
+		gc_if_->set_steps(stats.steps);
+		gc_if_->set_cycles(stats.cycles);
+		gc_if_->set_last_step_ms(stats.last_step_ms);
+		gc_if_->set_max_step_ms(stats.max_step_ms);
+		gc_if_->set_total_step_ms(stats.total_step_ms);
+		gc_if_->write();
+	}
 }
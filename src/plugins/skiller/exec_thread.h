@@ -49,6 +49,7 @@ class LuaContext;
 class Interface;
 class SkillerInterface;
 class SkillerDebugInterface;
+class LuaGCInterface;
 #ifdef SKILLER_TIMETRACKING
 class TimeTracker;
 #endif
@@ -97,12 +98,14 @@ private: /* members */
 	fawkes::BlackBoardWithOwnership *bbo_;
 
 	// config values
-	std::string cfg_skillspace_;
-	bool        cfg_watch_files_;
+	std::string  cfg_skillspace_;
+	bool         cfg_watch_files_;
+	unsigned int cfg_gc_step_kb_;
 
 	fawkes::LockQueue<fawkes::Uuid> skiller_if_removed_readers_;
 
 	fawkes::SkillerInterface *skiller_if_;
+	fawkes::LuaGCInterface *  gc_if_;
 
 	fawkes::LuaContext *lua_;
 
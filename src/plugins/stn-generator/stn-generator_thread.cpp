@@ -134,7 +134,9 @@ StnGeneratorThread::loop()
 	using namespace bsoncxx::builder;
 	if (cfg_publish_to_robot_memory_) {
 		//TODO reset actions in robot-memory
-		for (auto &action : stn_->get_bson()) {
+		// only publish the actions which have been added since the last run
+		std::vector<bsoncxx::document::value> new_actions = stn_->get_bson(num_published_actions_);
+		for (auto &action : new_actions) {
 			basic::document rm_action;
 			rm_action.append(basic::kvp("relation", "proposed-stn-action"));
 			rm_action.append(bsoncxx::builder::concatenate(action.view()));
@@ -142,7 +144,7 @@ StnGeneratorThread::loop()
 		}
 		// ensure all actions are written to RM before acknowledment
 		std::this_thread::sleep_for(std::chrono::milliseconds(500));
-		num_published_actions_ += stn_->get_bson().size();
+		num_published_actions_ += new_actions.size();
 		basic::document rm_final;
 		rm_final.append(basic::kvp("relation", "stn-sync"));
 		rm_final.append(basic::kvp("state", "synced"));
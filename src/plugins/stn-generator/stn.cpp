@@ -207,14 +207,20 @@ Stn::build_breakup_list(pddl_parser::Expression e, std::vector<std::string> *bre
 	}
 }
 
-/** Regenerate the STN. */
+/** Update the STN.
+ * Plan actions are only ever appended, and the conditions and edges of an
+ * action only depend on the actions before it. Therefore only the plan
+ * actions added since the last call are processed, the STN built so far
+ * remains unchanged.
+ */
 void
 Stn::generate()
 {
-	stn_actions_.clear();
 	//stn_actions_.push_back(initial_state_);
 
-	for (plan_action pa : plan_actions_) {
+	const size_t first_new = stn_actions_.size();
+	for (size_t i = first_new; i < plan_actions_.size(); ++i) {
+		const plan_action &                 pa = plan_actions_[i];
 		std::vector<DomainAction>::iterator it = domain_actions_.begin();
 		for (; it != domain_actions_.end(); ++it) {
 			if (it->getName() == pa.name) {
@@ -227,9 +233,10 @@ Stn::generate()
 
 		stn_actions_.push_back(da.generateStnAction(pa.name, pa.params));
 	}
-	std::cout << "Imported " << stn_actions_.size() << " actions into STN" << std::endl;
+	std::cout << "Imported " << stn_actions_.size() - first_new << " new actions into STN"
+	          << std::endl;
 
-	for (int i = stn_actions_.size() - 1; i >= 0; i--) {
+	for (int i = stn_actions_.size() - 1; i >= (int)first_new; i--) {
 		std::vector<StnAction> candidate_actions =
 		  std::vector<StnAction>(stn_actions_.begin(), stn_actions_.begin() + i);
 		try {
@@ -239,8 +246,9 @@ Stn::generate()
 		}
 	}
 
-	std::vector<Predicate> predicates;
-	for (std::vector<StnAction>::iterator it = stn_actions_.begin(); it != stn_actions_.end(); ++it) {
+	for (std::vector<StnAction>::iterator it = stn_actions_.begin() + first_new;
+	     it != stn_actions_.end();
+	     ++it) {
 		// add conditional edges
 		for (auto const &cond_action : it->condActionIds()) {
 			std::pair<StnAction, StnAction> edge(findActionById(cond_action), findActionById(it->id()));
@@ -248,7 +256,7 @@ Stn::generate()
 		}
 		// add temporal edges
 		bool break_edge = false;
-		for (Predicate p : predicates) {
+		for (Predicate p : predicates_) {
 			if (it->checkForBreakup(EdgeType::TEMPORAL, p)) {
 				break_edge = true;
 				break;
@@ -262,19 +270,19 @@ Stn::generate()
 		// handle predicates
 		for (Predicate p : it->effects()) {
 			if (p.condition()) {
-				std::vector<Predicate>::iterator it = std::find(predicates.begin(), predicates.end(), p);
-				if (it == predicates.end()) {
-					predicates.push_back(p);
+				std::vector<Predicate>::iterator it = std::find(predicates_.begin(), predicates_.end(), p);
+				if (it == predicates_.end()) {
+					predicates_.push_back(p);
 					//std::cout << "Added " << p;
 				}
 			} else {
 				//std::cout << "Check for erase: " << p;
 				Predicate                        neg_pred(p.name(), true, p.attrs());
 				std::vector<Predicate>::iterator it =
-				  std::find(predicates.begin(), predicates.end(), neg_pred);
-				if (it != predicates.end()) {
+				  std::find(predicates_.begin(), predicates_.end(), neg_pred);
+				if (it != predicates_.end()) {
 					//std::cout << "Erased " << (*it);
-					predicates.erase(it);
+					predicates_.erase(it);
 				}
 			}
 		}
@@ -358,13 +366,16 @@ Stn::drawGraph()
 }
 
 /** Get a BSON representation of the STN.
+ * @param first index of the first action to include, e.g., the number of
+ * actions already exported to only get the ones added since
  * @return A vector of BSON objects, each element is an action.
  */
 std::vector<bsoncxx::document::value>
-Stn::get_bson()
+Stn::get_bson(size_t first)
 {
 	std::vector<bsoncxx::document::value> stn;
-	for (auto &action : stn_actions_) {
+	for (size_t i = first; i < stn_actions_.size(); ++i) {
+		const StnAction &action = stn_actions_[i];
 		using namespace bsoncxx::builder;
 		basic::document bson_action;
 		bson_action.append(basic::kvp("id", static_cast<int64_t>(action.id())));
@@ -52,7 +52,7 @@ public:
 	void set_pddl_domain(const std::string &pddl_domain_string);
 	void generate();
 	void drawGraph();
-	std::vector<bsoncxx::document::value> get_bson();
+	std::vector<bsoncxx::document::value> get_bson(size_t first = 0);
 
 private:
 	struct plan_action
@@ -69,6 +69,7 @@ private:
 	std::vector<DomainAction> domain_actions_;
 	std::vector<plan_action>  plan_actions_;
 	std::vector<StnAction>    stn_actions_;
+	std::vector<Predicate>    predicates_;
 
 	std::vector<std::pair<StnAction, StnAction>> cond_edges_;
 	std::vector<std::pair<StnAction, StnAction>> temp_edges_;
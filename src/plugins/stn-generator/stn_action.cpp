@@ -218,25 +218,25 @@ StnAction::genTemporalEdgeLabel() const
 }
 
 /** Generate the conditional actions of this StnAction.
- * @param candidate_actions The actions to be considered as conditional actions.
+ * @param candidates The actions to be considered as conditional actions.
  */
 void
-StnAction::genConditionalActions(const std::vector<StnAction> candidate_actions)
+StnAction::genConditionalActions(const std::vector<StnAction> &candidates)
 {
 	std::vector<Predicate> check_preds = preconds_;
 	// iterate backwards to resolve conditions in the correct order
-	for (int i = candidate_actions.size() - 1; i >= 0; i--) {
+	for (int i = candidates.size() - 1; i >= 0; i--) {
 		try {
-			for (Predicate candidate_pred : candidate_actions.at(i).effects_) {
+			for (Predicate candidate_pred : candidates.at(i).effects_) {
 				for (auto pred_it = check_preds.begin(); pred_it != check_preds.end();) {
 					if (!checkForBreakup(EdgeType::CONDITIONAL, (*pred_it)) && (*pred_it) == candidate_pred) {
 						std::map<size_t, std::pair<std::string, std::vector<Predicate>>>::iterator it =
-						  cond_actions_.find(candidate_actions.at(i).id_);
+						  cond_actions_.find(candidates.at(i).id_);
 						if (it == cond_actions_.end()) {
 							cond_actions_.insert(
 							  std::map<size_t, std::pair<std::string, std::vector<Predicate>>>::value_type(
-							    candidate_actions.at(i).id_,
-							    std::make_pair(candidate_actions.at(i).name_,
+							    candidates.at(i).id_,
+							    std::make_pair(candidates.at(i).name_,
 							                   std::vector<Predicate>{(*pred_it)})));
 						} else {
 							it->second.second.push_back((*pred_it));
@@ -59,7 +59,7 @@ public:
 	std::string                   genGraphNodeName() const;
 	std::string                   genConditionEdgeLabel(size_t cond_action) const;
 	std::string                   genTemporalEdgeLabel() const;
-	void                          genConditionalActions(std::vector<StnAction> candidate_actions);
+	void                          genConditionalActions(const std::vector<StnAction> &candidates);
 	const std::vector<Predicate> &effects() const;
 	std::string                   name() const;
 	size_t                        duration() const;
@@ -0,0 +1,45 @@
+
+/***************************************************************************
+ *  tracing_plugin.cpp - Main loop trace recording plugin
+ *
+ *  Created: Thu Oct 15 07:32:26 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "tracing_thread.h"
+
+#include <core/plugin.h>
+
+using namespace fawkes;
+
+/** Plugin to record a timeline trace of the main loop.
+ * @author agent
+ */
+class TracingPlugin : public fawkes::Plugin
+{
+public:
+	/** Constructor.
+   * @param config Fawkes configuration
+   */
+	explicit TracingPlugin(Configuration *config) : Plugin(config)
+	{
+		thread_list.push_back(new TracingThread());
+	}
+};
+
+PLUGIN_DESCRIPTION("Records main loop traces for chrome://tracing")
+EXPORT_PLUGIN(TracingPlugin)
@@ -0,0 +1,144 @@
+
+/***************************************************************************
+ *  tracing_thread.cpp - Main loop trace recording thread
+ *
+ *  Created: Thu Oct 15 07:32:26 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "tracing_thread.h"
+
+#include <interfaces/SwitchInterface.h>
+#include <utils/time/trace_recorder.h>
+
+using namespace fawkes;
+
+#define CFG_PREFIX "/plugins/tracing/"
+
+/** @class TracingThread "tracing_thread.h"
+ * Thread to control main loop trace recording.
+ * Provides the "Tracing" SwitchInterface. Enabling the switch starts
+ * recording, disabling it stops recording and writes the trace to the
+ * configured file in the Chrome trace event format. While recording, the
+ * thread collects the events of all threads after each main loop
+ * iteration.
+ * @author agent
+ */
+
+/** Constructor. */
+TracingThread::TracingThread()
+: Thread("TracingThread", Thread::OPMODE_WAITFORWAKEUP),
+  BlockedTimingAspect(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP)
+{
+}
+
+/** Destructor. */
+TracingThread::~TracingThread()
+{
+}
+
+void
+TracingThread::init()
+{
+	cfg_file_ = "/tmp/fawkes-trace.json";
+	try {
+		cfg_file_ = config->get_string(CFG_PREFIX "file");
+	} catch (Exception &e) {
+	}
+	try {
+		TraceRecorder::set_history_size(config->get_uint(CFG_PREFIX "history_size"));
+	} catch (Exception &e) {
+	}
+	bool auto_enable = false;
+	try {
+		auto_enable = config->get_bool(CFG_PREFIX "auto_enable");
+	} catch (Exception &e) {
+	}
+
+	switch_if_ = blackboard->open_for_writing<SwitchInterface>("Tracing");
+	if (auto_enable) {
+		start_tracing();
+	} else {
+		switch_if_->set_enabled(false);
+		switch_if_->write();
+	}
+}
+
+void
+TracingThread::finalize()
+{
+	if (TraceRecorder::enabled()) {
+		stop_tracing();
+	}
+	blackboard->close(switch_if_);
+}
+
+void
+TracingThread::loop()
+{
+	while (!switch_if_->msgq_empty()) {
+		if (SwitchInterface::EnableSwitchMessage *msg = switch_if_->msgq_first_safe(msg)) {
+			if (!TraceRecorder::enabled()) {
+				start_tracing();
+			}
+		} else if (SwitchInterface::DisableSwitchMessage *msg = switch_if_->msgq_first_safe(msg)) {
+			if (TraceRecorder::enabled()) {
+				stop_tracing();
+			}
+		}
+		switch_if_->msgq_pop();
+	}
+
+	if (TraceRecorder::enabled()) {
+		TraceRecorder::collect();
+	}
+}
+
+void
+TracingThread::start_tracing()
+{
+	// discard events buffered by a previous recording
+	TraceRecorder::collect();
+	TraceRecorder::clear();
+	TraceRecorder::set_enabled(true);
+	logger->log_info(name(), "Started recording trace");
+
+	switch_if_->set_enabled(true);
+	switch_if_->write();
+}
+
+void
+TracingThread::stop_tracing()
+{
+	TraceRecorder::set_enabled(false);
+	TraceRecorder::collect();
+	try {
+		TraceRecorder::write_chrome_trace(cfg_file_.c_str());
+		logger->log_info(name(),
+		                 "Wrote %zu events to %s (%llu dropped)",
+		                 TraceRecorder::num_events(),
+		                 cfg_file_.c_str(),
+		                 (unsigned long long)TraceRecorder::dropped());
+	} catch (Exception &e) {
+		logger->log_error(name(), "Failed to write trace");
+		logger->log_error(name(), e);
+	}
+	TraceRecorder::clear();
+
+	switch_if_->set_enabled(false);
+	switch_if_->write();
+}
@@ -0,0 +1,70 @@
+
+/***************************************************************************
+ *  tracing_thread.h - Main loop trace recording thread
+ *
+ *  Created: Thu Oct 15 07:32:26 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_TRACING_TRACING_THREAD_H_
+#define _PLUGINS_TRACING_TRACING_THREAD_H_
+
+#include <aspect/blackboard.h>
+#include <aspect/blocked_timing.h>
+#include <aspect/configurable.h>
+#include <aspect/logging.h>
+#include <core/threading/thread.h>
+
+#include <string>
+
+namespace fawkes {
+class SwitchInterface;
+}
+
+class TracingThread : public fawkes::Thread,
+                      public fawkes::BlockedTimingAspect,
+                      public fawkes::LoggingAspect,
+                      public fawkes::ConfigurableAspect,
+                      public fawkes::BlackBoardAspect
+{
+public:
+	TracingThread();
+	virtual ~TracingThread();
+
+	virtual void init();
+	virtual void loop();
+	virtual void finalize();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	void start_tracing();
+	void stop_tracing();
+
+private:
+	fawkes::SwitchInterface *switch_if_;
+
+	std::string cfg_file_;
+};
+
+#endif
@@ -0,0 +1,155 @@
+
+/***************************************************************************
+ *  blackboard-event-stream.cpp - Push blackboard data to webview clients
+ *
+ *  Created: Thu Oct 15 07:00:44 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "blackboard-event-stream.h"
+
+#include <blackboard/blackboard.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <interface/interface.h>
+#include <interface/json.h>
+#include <utils/time/time.h>
+
+#include <string>
+
+using namespace fawkes;
+
+/** @class BlackboardEventStream "blackboard-event-stream.h"
+ * Stream of blackboard data events.
+ * Opens the requested interfaces for reading and sends an event with
+ * the interface data whenever it has been written and differs from the
+ * data sent last. Writes in between two batches are coalesced, such
+ * that a client receives each interface at most once per minimum
+ * interval. Initially, the current data of all interfaces is sent.
+ * @author agent
+ */
+
+/** Constructor.
+ * @param blackboard blackboard to open interfaces from
+ * @param uids UIDs of interfaces to subscribe to
+ * @param min_interval_msec minimum time between two events for the
+ * same client in milliseconds
+ */
+BlackboardEventStream::BlackboardEventStream(BlackBoard *                    blackboard,
+                                             const std::vector<std::string> &uids,
+                                             unsigned int                    min_interval_msec)
+: WebviewEventStream(min_interval_msec),
+  BlackBoardInterfaceListener("BlackboardEventStream"),
+  blackboard_(blackboard)
+{
+	ifaces_mutex_ = new Mutex();
+	dirty_mutex_  = new Mutex();
+
+	try {
+		for (const std::string &uid : uids) {
+			std::string type, id;
+			Interface::parse_uid(uid.c_str(), type, id);
+			Interface *iface = blackboard_->open_for_reading(type.c_str(), id.c_str());
+			interfaces_.push_back(iface);
+			bbil_add_data_interface(iface);
+			dirty_.insert(iface);
+		}
+	} catch (Exception &e) {
+		for (Interface *iface : interfaces_) {
+			blackboard_->close(iface);
+		}
+		delete ifaces_mutex_;
+		delete dirty_mutex_;
+		throw;
+	}
+
+	blackboard_->register_listener(this, BlackBoard::BBIL_FLAG_DATA);
+	notify();
+}
+
+/** Destructor. */
+BlackboardEventStream::~BlackboardEventStream()
+{
+	shutdown();
+	delete ifaces_mutex_;
+	delete dirty_mutex_;
+}
+
+/** Unsubscribe and close all interfaces.
+ * Closes the stream. Must be called before the blackboard becomes
+ * unavailable, the destructor may run much later once the client has
+ * disconnected.
+ */
+void
+BlackboardEventStream::shutdown()
+{
+	MutexLocker lock(ifaces_mutex_);
+	if (interfaces_.empty())
+		return;
+
+	blackboard_->unregister_listener(this);
+	for (Interface *iface : interfaces_) {
+		blackboard_->close(iface);
+	}
+	interfaces_.clear();
+	close();
+}
+
+void
+BlackboardEventStream::bb_interface_data_refreshed(Interface *interface) noexcept
+{
+	MutexLocker lock(dirty_mutex_);
+	dirty_.insert(interface);
+	lock.unlock();
+	notify();
+}
+
+void
+BlackboardEventStream::collect_events(std::string &buffer)
+{
+	MutexLocker lock(dirty_mutex_);
+	std::set<Interface *> dirty;
+	dirty.swap(dirty_);
+	lock.unlock();
+
+	MutexLocker ifaces_lock(ifaces_mutex_);
+	if (interfaces_.empty())
+		return;
+
+	for (Interface *iface : dirty) {
+		iface->read();
+
+		std::string data;
+		iface->to_json(data);
+		std::string &last = last_data_[iface->uid()];
+		if (data == last)
+			continue;
+		last = data;
+
+		std::string event;
+		event.reserve(data.size() + 128);
+		event += '{';
+		json_append_key(event, "uid", true);
+		json_append_string(event, iface->uid(), std::string::npos);
+		json_append_key(event, "timestamp");
+		json_append_string(event, iface->timestamp()->str(), std::string::npos);
+		json_append_key(event, "data");
+		event += data;
+		event += '}';
+		append_event(buffer, "data", event);
+	}
+}
@@ -0,0 +1,65 @@
+
+/***************************************************************************
+ *  blackboard-event-stream.h - Push blackboard data to webview clients
+ *
+ *  Created: Thu Oct 15 07:00:44 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#pragma once
+
+#include <blackboard/interface_listener.h>
+#include <webview/event_stream.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class BlackBoard;
+class Interface;
+class Mutex;
+} // namespace fawkes
+
+class BlackboardEventStream : public fawkes::WebviewEventStream,
+                              public fawkes::BlackBoardInterfaceListener
+{
+public:
+	BlackboardEventStream(fawkes::BlackBoard *             blackboard,
+	                      const std::vector<std::string> &uids,
+	                      unsigned int                    min_interval_msec);
+	virtual ~BlackboardEventStream();
+
+	void shutdown();
+
+	virtual void bb_interface_data_refreshed(fawkes::Interface *interface) noexcept;
+
+protected:
+	virtual void collect_events(std::string &buffer);
+
+private:
+	fawkes::BlackBoard *blackboard_;
+
+	fawkes::Mutex *                  ifaces_mutex_;
+	std::vector<fawkes::Interface *> interfaces_;
+
+	fawkes::Mutex *               dirty_mutex_;
+	std::set<fawkes::Interface *> dirty_;
+
+	std::map<std::string, std::string> last_data_;
+};
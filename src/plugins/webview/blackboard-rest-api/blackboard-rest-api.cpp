@@ -21,6 +21,9 @@
 
 #include "blackboard-rest-api.h"
 
+#include "blackboard-event-stream.h"
+
+#include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
 #include <interface/message.h>
@@ -28,6 +31,7 @@
 #include <utils/time/wait.h>
 #include <webview/rest_api_manager.h>
 
+#include <algorithm>
 #include <set>
 
 using namespace fawkes;
@@ -66,6 +70,10 @@ BlackboardRestApi::init()
 	rest_api_->add_handler<BlackboardGraph>(WebRequest::METHOD_GET,
 	                                        "/graph",
 	                                        std::bind(&BlackboardRestApi::cb_get_graph, this));
+	rest_api_->add_handler(WebRequest::METHOD_GET,
+	                       "/events",
+	                       std::bind(&BlackboardRestApi::cb_events, this, std::placeholders::_1));
+	event_streams_mutex_ = new Mutex();
 	webview_rest_api_manager->register_api(rest_api_);
 }
 
@@ -74,6 +82,18 @@ BlackboardRestApi::finalize()
 {
 	webview_rest_api_manager->unregister_api(rest_api_);
 	delete rest_api_;
+
+	// streams may outlive us while the web server still sends them
+	MutexLocker lock(event_streams_mutex_);
+	for (auto &s : event_streams_) {
+		std::shared_ptr<BlackboardEventStream> stream = s.lock();
+		if (stream) {
+			stream->shutdown();
+		}
+	}
+	event_streams_.clear();
+	lock.unlock();
+	delete event_streams_mutex_;
 }
 
 void
@@ -146,77 +166,6 @@ BlackboardRestApi::gen_interface_info(const fawkes::InterfaceInfo &ii)
 	return info;
 }
 
-#define FIELD_ARRAY_CASE(TYPE, type, ctype)                          \
-	case IFT_##TYPE: {                                                 \
-		const ctype *values = i.get_##type##s();                         \
-		for (unsigned int j = 0; j < i.get_length(); ++j) {              \
-			value.PushBack(rapidjson::Value{values[j]}.Move(), allocator); \
-		}                                                                \
-		break;                                                           \
-	}
-
-static rapidjson::Value
-gen_field_value(fawkes::InterfaceFieldIterator &    i,
-                fawkes::Interface *                 iface,
-                rapidjson::Document::AllocatorType &allocator)
-{
-	rapidjson::Value value;
-
-	if (i.get_length() > 1) {
-		if (i.get_type() == IFT_STRING) {
-			value.SetString(std::string(i.get_string()), allocator);
-		} else {
-			value.SetArray();
-			value.Reserve(i.get_length(), allocator);
-
-			switch (i.get_type()) {
-				FIELD_ARRAY_CASE(BOOL, bool, bool);
-				FIELD_ARRAY_CASE(INT8, int8, int8_t);
-				FIELD_ARRAY_CASE(UINT8, uint8, uint8_t);
-				FIELD_ARRAY_CASE(INT16, int16, int16_t);
-				FIELD_ARRAY_CASE(UINT16, uint16, uint16_t);
-				FIELD_ARRAY_CASE(INT32, int32, int32_t);
-				FIELD_ARRAY_CASE(UINT32, uint32, uint32_t);
-				FIELD_ARRAY_CASE(INT64, int64, int64_t);
-				FIELD_ARRAY_CASE(UINT64, uint64, uint64_t);
-				FIELD_ARRAY_CASE(FLOAT, float, float);
-				FIELD_ARRAY_CASE(DOUBLE, double, double);
-				FIELD_ARRAY_CASE(BYTE, byte, uint8_t);
-
-			case IFT_ENUM: {
-				const int32_t *values = i.get_enums();
-				for (unsigned int j = 0; j < i.get_length(); ++j) {
-					value.PushBack(
-					  rapidjson::Value{iface->enum_tostring(i.get_typename(), values[j]), allocator}.Move(),
-					  allocator);
-				}
-				break;
-			}
-
-			case IFT_STRING: break; // handled above
-			}
-		}
-	} else {
-		switch (i.get_type()) {
-		case IFT_BOOL: value.SetBool(i.get_bool()); break;
-		case IFT_INT8: value.SetInt(i.get_int8()); break;
-		case IFT_UINT8: value.SetUint(i.get_uint8()); break;
-		case IFT_INT16: value.SetInt(i.get_int16()); break;
-		case IFT_UINT16: value.SetUint(i.get_uint16()); break;
-		case IFT_INT32: value.SetInt(i.get_int32()); break;
-		case IFT_UINT32: value.SetUint(i.get_uint32()); break;
-		case IFT_INT64: value.SetInt64(i.get_int64()); break;
-		case IFT_UINT64: value.SetUint64(i.get_uint64()); break;
-		case IFT_FLOAT: value.SetFloat(i.get_float()); break;
-		case IFT_DOUBLE: value.SetDouble(i.get_double()); break;
-		case IFT_BYTE: value.SetUint(i.get_byte()); break;
-		case IFT_STRING: [[fallthrough]];
-		case IFT_ENUM: value.SetString(std::string(i.get_value_string()), allocator);
-		}
-	}
-	return value;
-}
-
 InterfaceData
 BlackboardRestApi::gen_interface_data(Interface *iface, bool pretty)
 {
@@ -232,15 +181,12 @@ BlackboardRestApi::gen_interface_data(Interface *iface, bool pretty)
 	data.set_readers(std::vector<std::string>{std::begin(readers), std::end(readers)});
 	data.set_timestamp(iface->timestamp()->str());
 
-	// Generate data as JSON document
-	std::shared_ptr<rapidjson::Document> d         = std::make_shared<rapidjson::Document>();
-	rapidjson::Document::AllocatorType & allocator = d->GetAllocator();
-	d->SetObject();
-
-	for (auto i = iface->fields(); i != iface->fields_end(); ++i) {
-		rapidjson::Value name(i.get_name(), allocator);
-		d->AddMember(name.Move(), gen_field_value(i, iface, allocator).Move(), allocator);
-	}
+	// Generate data as JSON document, the interface serializes itself
+	std::string json;
+	json.reserve(iface->datasize() * 2);
+	iface->to_json(json);
+	std::shared_ptr<rapidjson::Document> d = std::make_shared<rapidjson::Document>();
+	d->Parse(json.c_str(), json.size());
 	data.set_data(d);
 
 	return data;
@@ -304,6 +250,14 @@ BlackboardRestApi::cb_get_interface_data(WebviewRestParams &params)
 		                           params.path_arg("id").c_str());
 	}
 
+	// The interface timestamp changes on every write, it identifies the data
+	const fawkes::InterfaceInfo &ii   = ifls->front();
+	std::string                  etag = std::to_string(ii.serial()) + "-"
+	                   + std::to_string(ii.timestamp()->in_usec()) + (pretty ? "-p" : "");
+	if (params.set_etag(etag)) {
+		throw WebviewRestException(WebReply::HTTP_NOT_MODIFIED, "%s", "");
+	}
+
 	Interface *iface = nullptr;
 	try {
 		iface =
@@ -331,6 +285,46 @@ BlackboardRestApi::cb_get_interface_data(WebviewRestParams &params)
 	}
 }
 
+std::unique_ptr<WebReply>
+BlackboardRestApi::cb_events(WebviewRestParams &params)
+{
+	std::vector<std::string> uids = str_split(params.query_arg("uid"), ',');
+	if (uids.empty()) {
+		throw WebviewRestException(WebReply::HTTP_BAD_REQUEST,
+		                           "No interfaces given, pass UIDs as uid=Type::id,...");
+	}
+	for (const std::string &uid : uids) {
+		if (uid.find_first_of("*?") != std::string::npos) {
+			throw WebviewRestException(WebReply::HTTP_BAD_REQUEST, "UID may not contain any of [*?].");
+		}
+	}
+
+	unsigned int min_interval = 100;
+	if (params.has_query_arg("interval")) {
+		try {
+			min_interval = std::max(10, std::stoi(params.query_arg("interval")));
+		} catch (std::logic_error &e) {
+			throw WebviewRestException(WebReply::HTTP_BAD_REQUEST, "Invalid interval given");
+		}
+	}
+
+	std::shared_ptr<BlackboardEventStream> stream;
+	try {
+		stream = std::make_shared<BlackboardEventStream>(blackboard, uids, min_interval);
+	} catch (Exception &e) {
+		throw WebviewRestException(WebReply::HTTP_NOT_FOUND,
+		                           "Failed to open interfaces: %s",
+		                           e.what_no_backtrace());
+	}
+
+	MutexLocker lock(event_streams_mutex_);
+	event_streams_.remove_if(
+	  [](const std::weak_ptr<BlackboardEventStream> &s) { return s.expired(); });
+	event_streams_.push_back(stream);
+
+	return WebviewEventStream::create_reply(stream);
+}
+
 std::string
 BlackboardRestApi::generate_graph(const std::string &for_owner)
 {
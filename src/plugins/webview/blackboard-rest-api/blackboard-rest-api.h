@@ -35,10 +35,17 @@
 #include <webview/rest_api.h>
 #include <webview/rest_array.h>
 
+#include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 
+namespace fawkes {
+class Mutex;
+}
+class BlackboardEventStream;
+
 class BlackboardRestApi : public fawkes::Thread,
                           public fawkes::ClockAspect,
                           public fawkes::LoggingAspect,
@@ -62,6 +69,8 @@ private:
 
 	BlackboardGraph cb_get_graph();
 
+	std::unique_ptr<fawkes::WebReply> cb_events(fawkes::WebviewRestParams &params);
+
 	std::vector<std::shared_ptr<InterfaceFieldType>> gen_fields(fawkes::InterfaceFieldIterator begin,
 	                                                            fawkes::InterfaceFieldIterator end);
 
@@ -77,4 +86,7 @@ private:
 	         std::pair<std::vector<std::shared_ptr<InterfaceFieldType>>,
 	                   std::vector<std::shared_ptr<InterfaceMessageType>>>>
 	  type_info_cache_;
+
+	fawkes::Mutex *                                   event_streams_mutex_;
+	std::list<std::weak_ptr<BlackboardEventStream>> event_streams_;
 };
@@ -24,6 +24,7 @@
 #include "jpeg_stream_producer.h"
 #include "mjpeg_reply.h"
 
+#include <core/threading/mutex_locker.h>
 #include <fvutils/ipc/shm_image.h>
 #include <webview/rest_api_manager.h>
 
@@ -32,6 +33,7 @@ using namespace firevision;
 
 /** @class ImageRestApi "skiller-rest-api.h"
  * REST API backend for the image.
+ * Requests are processed concurrently, streams are shared among them.
  * @author Tim Niemueller
  */
 
@@ -49,6 +51,7 @@ void
 ImageRestApi::init()
 {
 	rest_api_ = new WebviewRestApi("images", logger);
+	rest_api_->set_concurrent(true);
 	rest_api_->add_handler<WebviewRestArray<ImageInfo>>(
 	  WebRequest::METHOD_GET, "/?", std::bind(&ImageRestApi::cb_list_images, this));
 	rest_api_->add_handler(WebRequest::METHOD_GET,
@@ -62,6 +65,7 @@ ImageRestApi::finalize()
 {
 	webview_rest_api_manager->unregister_api(rest_api_);
 	delete rest_api_;
+	MutexLocker lock(&streams_mutex_);
 	for (auto &s : streams_) {
 		thread_collector->remove(&*s.second);
 	}
@@ -99,6 +103,8 @@ ImageRestApi::cb_list_images()
 std::shared_ptr<fawkes::WebviewJpegStreamProducer>
 ImageRestApi::get_stream(const std::string &image_id)
 {
+	// several requests may open the same stream at once
+	MutexLocker lock(&streams_mutex_);
 	if (streams_.find(image_id) == streams_.end()) {
 		try {
 			std::string  cfg_prefix = "/webview/images/" + image_id + "/";
@@ -29,6 +29,7 @@
 #include <aspect/logging.h>
 #include <aspect/thread_producer.h>
 #include <aspect/webview.h>
+#include <core/threading/mutex.h>
 #include <core/threading/thread.h>
 #include <webview/rest_api.h>
 #include <webview/rest_array.h>
@@ -67,4 +68,5 @@ private:
 private:
 	fawkes::WebviewRestApi *                                                  rest_api_;
 	std::map<std::string, std::shared_ptr<fawkes::WebviewJpegStreamProducer>> streams_;
+	fawkes::Mutex                                                             streams_mutex_;
 };
@@ -72,6 +72,8 @@ WebviewJpegStreamProducer::Subscriber::~Subscriber()
  * This class takes an image ID and some parameters and then creates a stream
  * of JPEG buffers that is either passed to subscribers or can be queried
  * using the wait_for_next_frame() method.
+ * Each image is encoded only once. If the writer did not publish a new
+ * image since the last loop, the last JPEG buffer is passed on again.
  * @author Tim Niemueller
  */
 
@@ -159,6 +161,7 @@ WebviewJpegStreamProducer::init()
 
 	in_buffer_ = malloc_buffer(YUV422_PLANAR, cam_->pixel_width(), cam_->pixel_height());
 	jpeg_->set_image_buffer(YUV422_PLANAR, in_buffer_);
+	last_sequence_ = 0;
 
 	long int loop_time = (long int)roundf((1. / fps_) * 1000000.);
 	timewait_          = new TimeWait(clock, loop_time);
@@ -173,23 +176,45 @@ WebviewJpegStreamProducer::loop()
 
 	timewait_->mark_start();
 
-	size_t         size   = jpeg_->recommended_compressed_buffer_size();
-	unsigned char *buffer = (unsigned char *)malloc(size);
-	jpeg_->set_destination_buffer(buffer, size);
-
-	cam_->lock_for_read();
+	// the captured slot of a ring buffer is pinned until dispose_buffer(),
+	// no need to block the writer while encoding
+	bool ring = (cam_->shared_memory_image_buffer()->num_slots() > 1);
+	if (!ring)
+		cam_->lock_for_read();
 	cam_->capture();
-	firevision::convert(cam_->colorspace(),
-	                    YUV422_PLANAR,
-	                    cam_->buffer(),
-	                    in_buffer_,
-	                    cam_->pixel_width(),
-	                    cam_->pixel_height());
-	jpeg_->compress();
+
+	std::shared_ptr<Buffer> shared_buf;
+	uint64_t                sequence = cam_->sequence();
+	if ((sequence != 0) && (sequence == last_sequence_) && last_frame_) {
+		// no new image since the last loop, do not encode it again
+		shared_buf = last_frame_;
+	} else {
+		size_t         size   = jpeg_->recommended_compressed_buffer_size();
+		unsigned char *buffer = (unsigned char *)malloc(size);
+		jpeg_->set_destination_buffer(buffer, size);
+
+		if (cam_->colorspace() == YUV422_PLANAR) {
+			jpeg_->set_image_buffer(YUV422_PLANAR, cam_->buffer());
+		} else {
+			firevision::convert(cam_->colorspace(),
+			                    YUV422_PLANAR,
+			                    cam_->buffer(),
+			                    in_buffer_,
+			                    cam_->pixel_width(),
+			                    cam_->pixel_height());
+			jpeg_->set_image_buffer(YUV422_PLANAR, in_buffer_);
+		}
+		jpeg_->compress();
+
+		shared_buf     = std::make_shared<Buffer>(buffer, jpeg_->compressed_size());
+		last_frame_    = shared_buf;
+		last_sequence_ = sequence;
+	}
+
 	cam_->dispose_buffer();
-	cam_->unlock();
+	if (!ring)
+		cam_->unlock();
 
-	std::shared_ptr<Buffer> shared_buf = std::make_shared<Buffer>(buffer, jpeg_->compressed_size());
 	subs_.lock();
 #if (__GNUC__ * 10000 + __GNUC_MINOR__ * 100) > 40600
 	for (auto &s : subs_) {
@@ -221,6 +246,7 @@ WebviewJpegStreamProducer::finalize()
 	delete cam_;
 	delete timewait_;
 	free(in_buffer_);
+	last_frame_.reset();
 }
 
 } // end namespace fawkes
@@ -26,6 +26,7 @@
 #include <core/threading/thread.h>
 #include <core/utils/lock_list.h>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -108,6 +109,9 @@ private:
 	std::shared_ptr<Buffer> last_buf_;
 	fawkes::Mutex *         last_buf_mutex_;
 	fawkes::WaitCondition * last_buf_waitcond_;
+
+	std::shared_ptr<Buffer> last_frame_;
+	uint64_t                last_sequence_;
 };
 
 } // end namespace fawkes
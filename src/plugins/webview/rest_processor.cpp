@@ -22,6 +22,8 @@
 #include "rest_processor.h"
 
 #include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <logging/logger.h>
 #include <utils/misc/string_split.h>
 #include <webview/error_reply.h>
@@ -53,6 +55,7 @@ WebviewRESTRequestProcessor::WebviewRESTRequestProcessor(fawkes::WebUrlManager *
 : url_mgr_(url_manager),
   api_mgr_(api_mgr),
   logger_(logger),
+  serial_mutex_(new Mutex()),
   methods_{WebRequest::METHOD_GET,
            WebRequest::METHOD_POST,
            WebRequest::METHOD_PUT,
@@ -64,7 +67,9 @@ WebviewRESTRequestProcessor::WebviewRESTRequestProcessor(fawkes::WebUrlManager *
 		                      "/api/{rest_url*}",
 		                      std::bind(&WebviewRESTRequestProcessor::process_request,
 		                                this,
-		                                std::placeholders::_1));
+		                                std::placeholders::_1),
+		                      0,
+		                      /* concurrent, APIs are serialized below */ true);
 	}
 }
 
@@ -74,6 +79,7 @@ WebviewRESTRequestProcessor::~WebviewRESTRequestProcessor()
 	for (const auto &method : methods_) {
 		url_mgr_->remove_handler(method, "/api/{rest_url*}");
 	}
+	delete serial_mutex_;
 }
 
 WebReply *
@@ -95,7 +101,8 @@ WebviewRESTRequestProcessor::process_request(const fawkes::WebRequest *request)
 	}
 
 	try {
-		WebReply *reply = api->process_request(request, rest_path);
+		MutexLocker lock(serial_mutex_, !api->concurrent());
+		WebReply *  reply = api->process_request(request, rest_path);
 		if (!reply) {
 			return new StaticWebReply(WebReply::HTTP_NOT_FOUND,
 			                          "REST API '" + rest_api + "' has no endpoint '" + rest_path
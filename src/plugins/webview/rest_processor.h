@@ -28,6 +28,7 @@
 #include <vector>
 
 namespace fawkes {
+class Mutex;
 class WebUrlManager;
 class WebviewRestApiManager;
 class Logger;
@@ -49,6 +50,7 @@ private:
 	fawkes::WebUrlManager *        url_mgr_;
 	fawkes::WebviewRestApiManager *api_mgr_;
 	fawkes::Logger *               logger_;
+	fawkes::Mutex *                serial_mutex_;
 
 	std::vector<fawkes::WebRequest::Method> methods_;
 };
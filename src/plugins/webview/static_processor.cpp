@@ -25,6 +25,8 @@
 #include <core/exception.h>
 #include <core/exceptions/software.h>
 #include <core/exceptions/system.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <logging/logger.h>
 #include <webview/error_reply.h>
 #include <webview/file_reply.h>
@@ -35,16 +37,29 @@
 #include <climits>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <functional>
 #include <regex>
+#include <sstream>
 #include <string>
+#include <sys/stat.h>
 #include <unistd.h>
+#ifdef HAVE_ZLIB
+#	include <zlib.h>
+#endif
 
 using namespace fawkes;
 
 /** @class WebviewStaticRequestProcessor "static_processor.h"
  * Static file web processor.
  * This processor provides access to static files.
+ *
+ * Files are tagged with an ETag derived from their size and modification
+ * time. Clients are asked to revalidate on each use and receive an empty
+ * 304 reply if they still have the current version. Text-based files are
+ * compressed with gzip for clients which accept it, the compressed version
+ * is kept in memory as long as the file does not change. All other files
+ * are sent directly from the file descriptor.
  * @author Tim Niemueller
  */
 
@@ -54,6 +69,8 @@ using namespace fawkes;
  * @param htdocs_dirs directories in the file system where to look for static files
  * @param catchall_file file to be served if a non-existent path is requested.
  * @param mime_file file with MIME types to read
+ * @param max_cache_size maximum size in bytes of compressed files to keep
+ * in memory, zero disables compression
  * @param logger logger
  */
 WebviewStaticRequestProcessor::WebviewStaticRequestProcessor(fawkes::WebUrlManager *   url_manager,
@@ -61,9 +78,17 @@ WebviewStaticRequestProcessor::WebviewStaticRequestProcessor(fawkes::WebUrlManag
                                                              std::vector<std::string> &htdocs_dirs,
                                                              const std::string &catchall_file,
                                                              const std::string &mime_file,
+                                                             size_t             max_cache_size,
                                                              fawkes::Logger *   logger)
-: logger_(logger), url_manager_(url_manager), base_url_(base_url), catchall_file_(catchall_file)
+: logger_(logger),
+  url_manager_(url_manager),
+  base_url_(base_url),
+  catchall_file_(catchall_file),
+  cache_size_(0),
+  max_cache_size_(max_cache_size)
 {
+	cache_mutex_ = new Mutex();
+
 	if (htdocs_dirs.empty()) {
 		throw Exception(errno, "htdocs_dirs is empty");
 	}
@@ -85,7 +110,8 @@ WebviewStaticRequestProcessor::WebviewStaticRequestProcessor(fawkes::WebUrlManag
 	                          std::bind(&WebviewStaticRequestProcessor::process_request,
 	                                    this,
 	                                    std::placeholders::_1),
-	                          10040);
+	                          10040,
+	                          /* concurrent */ true);
 
 	if (catchall_file_ != "") {
 		url_manager_->add_handler(WebRequest::METHOD_GET,
@@ -93,7 +119,8 @@ WebviewStaticRequestProcessor::WebviewStaticRequestProcessor(fawkes::WebUrlManag
 		                          std::bind(&WebviewStaticRequestProcessor::process_request,
 		                                    this,
 		                                    std::placeholders::_1),
-		                          10050);
+		                          10050,
+		                          /* concurrent */ true);
 	}
 }
 
@@ -104,6 +131,7 @@ WebviewStaticRequestProcessor::~WebviewStaticRequestProcessor()
 	if (catchall_file_ != "") {
 		url_manager_->remove_handler(WebRequest::METHOD_GET, base_url_ + "?");
 	}
+	delete cache_mutex_;
 }
 
 void
@@ -181,14 +209,136 @@ WebviewStaticRequestProcessor::find_file(const std::string &filename)
 	throw CouldNotOpenFileException(filename.c_str(), 0);
 }
 
+bool
+WebviewStaticRequestProcessor::is_compressible(const std::string &mime_type)
+{
+	return (mime_type.compare(0, 5, "text/") == 0 || mime_type.find("javascript") != std::string::npos
+	        || mime_type.find("json") != std::string::npos
+	        || mime_type.find("xml") != std::string::npos);
+}
+
+std::string
+WebviewStaticRequestProcessor::compressed_body(const std::string &filename,
+                                               time_t             mtime,
+                                               off_t              size)
+{
+	{
+		MutexLocker lock(cache_mutex_);
+		const auto &c = cache_.find(filename);
+		if (c != cache_.end()) {
+			if (c->second.mtime == mtime && c->second.size == size) {
+				return c->second.body;
+			}
+			cache_size_ -= c->second.body.size();
+			cache_.erase(c);
+		}
+	}
+
+	std::string body;
+#ifdef HAVE_ZLIB
+	std::ifstream     f(filename, std::ios::binary);
+	std::stringstream ss;
+	ss << f.rdbuf();
+	std::string data = ss.str();
+	if (!f || (off_t)data.size() != size) {
+		// file changed while reading, do not cache
+		return "";
+	}
+
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		return "";
+	}
+	body.resize(deflateBound(&zs, data.size()) + 32);
+	zs.next_in   = (Bytef *)data.data();
+	zs.avail_in  = data.size();
+	zs.next_out  = (Bytef *)&body[0];
+	zs.avail_out = body.size();
+	int rv       = deflate(&zs, Z_FINISH);
+	body.resize(zs.total_out);
+	deflateEnd(&zs);
+	// an empty body marks files which do not benefit from compression
+	if (rv != Z_STREAM_END || body.size() >= data.size()) {
+		body.clear();
+	}
+#endif
+
+	MutexLocker lock(cache_mutex_);
+	if (cache_size_ + body.size() > max_cache_size_) {
+		cache_.clear();
+		cache_size_ = 0;
+	}
+	if (body.size() <= max_cache_size_) {
+		cache_[filename] = CompressedFile{mtime, size, body};
+		cache_size_ += body.size();
+	}
+	return body;
+}
+
+WebReply *
+WebviewStaticRequestProcessor::file_reply(const WebRequest *request, const std::string &filename)
+{
+	struct stat st;
+	if (stat(filename.c_str(), &st) != 0) {
+		throw CouldNotOpenFileException(filename.c_str(), errno);
+	}
+	const std::string &mime_type = get_mime_type(filename);
+
+	bool        accepts_gzip = false;
+	std::string if_none_match;
+	for (const auto &h : request->headers()) {
+		if (strcasecmp(h.first.c_str(), "Accept-Encoding") == 0) {
+			accepts_gzip = (h.second.find("gzip") != std::string::npos);
+		} else if (strcasecmp(h.first.c_str(), "If-None-Match") == 0) {
+			if_none_match = h.second;
+		}
+	}
+
+	bool        compressible =
+	  max_cache_size_ > 0 && is_compressible(mime_type) && (size_t)st.st_size <= max_cache_size_;
+	std::string body;
+	if (compressible && accepts_gzip) {
+		body = compressed_body(filename, st.st_mtime, st.st_size);
+	}
+
+	char etag[64];
+	snprintf(etag,
+	         sizeof(etag),
+	         "\"%llx-%llx%s\"",
+	         (unsigned long long)st.st_size,
+	         (unsigned long long)st.st_mtime,
+	         body.empty() ? "" : "-gz");
+
+	WebReply *reply;
+	if (!if_none_match.empty()
+	    && (if_none_match == "*" || if_none_match.find(etag) != std::string::npos)) {
+		reply = new StaticWebReply(WebReply::HTTP_NOT_MODIFIED);
+	} else if (!body.empty()) {
+		reply = new StaticWebReply(WebReply::HTTP_OK, body);
+		reply->add_header("Content-Encoding", "gzip");
+		if (!mime_type.empty()) {
+			reply->add_header("Content-type", mime_type);
+		}
+	} else {
+		reply = new DynamicFileWebReply(filename, mime_type);
+	}
+	// allow the client to keep the file, but revalidate on every use
+	reply->add_header("Cache-Control", "no-cache");
+	reply->add_header("ETag", etag);
+	if (compressible) {
+		reply->add_header("Vary", "Accept-Encoding");
+	}
+	return reply;
+}
+
 WebReply *
 WebviewStaticRequestProcessor::process_request(const fawkes::WebRequest *request)
 {
 	try {
 		std::string filename = find_file("/" + request->path_arg("file"));
 		try {
-			DynamicFileWebReply *freply = new DynamicFileWebReply(filename, get_mime_type(filename));
-			return freply;
+			return file_reply(request, filename);
 		} catch (fawkes::Exception &e) {
 			logger_->log_error("WebStaticReqProc",
 			                   "Cannot fulfill request for file %s: %s",
@@ -225,9 +375,7 @@ WebviewStaticRequestProcessor::process_request(const fawkes::WebRequest *request
 			}
 		} else {
 			try {
-				DynamicFileWebReply *freply =
-				  new DynamicFileWebReply(catchall_file, get_mime_type(catchall_file));
-				return freply;
+				return file_reply(request, catchall_file);
 			} catch (Exception &e) {
 				logger_->log_error("WebStaticReqProc",
 				                   "Failed to serve catchall file: %s",
@@ -23,12 +23,15 @@
 #ifndef _PLUGINS_WEBVIEW_STATIC_PROCESSOR_H_
 #define _PLUGINS_WEBVIEW_STATIC_PROCESSOR_H_
 
+#include <ctime>
 #include <map>
 #include <string>
+#include <sys/types.h>
 #include <vector>
 
 namespace fawkes {
 class Logger;
+class Mutex;
 class WebUrlManager;
 class WebReply;
 class WebRequest;
@@ -42,6 +45,7 @@ public:
 	                              std::vector<std::string> &htdocs_dir,
 	                              const std::string &       catchall_file,
 	                              const std::string &       mime_file,
+	                              size_t                    max_cache_size,
 	                              fawkes::Logger *          logger);
 	~WebviewStaticRequestProcessor();
 
@@ -50,6 +54,18 @@ private:
 	std::string        find_file(const std::string &filename);
 	void               read_mime_database(const std::string &mime_file);
 	const std::string &get_mime_type(const std::string &file_name);
+	fawkes::WebReply * file_reply(const fawkes::WebRequest *request, const std::string &filename);
+	bool               is_compressible(const std::string &mime_type);
+	std::string        compressed_body(const std::string &filename, time_t mtime, off_t size);
+
+	/// @cond INTERNALS
+	typedef struct
+	{
+		time_t      mtime;
+		off_t       size;
+		std::string body;
+	} CompressedFile;
+	/// @endcond
 
 private:
 	std::vector<std::string> htdocs_dirs_;
@@ -61,6 +77,11 @@ private:
 
 	std::string base_url_;
 	std::string catchall_file_;
+
+	fawkes::Mutex *                       cache_mutex_;
+	std::map<std::string, CompressedFile> cache_;
+	size_t                                cache_size_;
+	size_t                                max_cache_size_;
 };
 
 #endif
@@ -37,6 +37,8 @@
 #include <webview/server.h>
 #include <webview/url_manager.h>
 
+#include <cinttypes>
+
 using namespace fawkes;
 
 /** @class WebviewThread "webview_thread.h"
@@ -167,6 +169,22 @@ WebviewThread::init()
 	} catch (Exception &e) {
 	}
 
+	unsigned int cfg_worker_threads = 0;
+	try {
+		cfg_worker_threads = config->get_uint("/webview/worker-pool/num-threads");
+	} catch (Exception &e) {
+	}
+	unsigned int cfg_worker_max_queue_length = 32;
+	try {
+		cfg_worker_max_queue_length = config->get_uint("/webview/worker-pool/max-queue-length");
+	} catch (Exception &e) {
+	}
+	std::vector<std::string> cfg_worker_heavy_paths;
+	try {
+		cfg_worker_heavy_paths = config->get_strings("/webview/worker-pool/heavy-paths");
+	} catch (Exception &e) {
+	}
+
 	webview_service_ =
 	  new NetworkService(nnresolver, "Fawkes Webview on %h", "_http._tcp", cfg_port_);
 	webview_service_->add_txt("fawkesver=%u.%u.%u",
@@ -182,7 +200,10 @@ WebviewThread::init()
 
 		(*webserver_)
 		  .setup_ipv(cfg_use_ipv4_, cfg_use_ipv6_)
-		  .setup_cors(cfg_cors_allow_all, std::move(cfg_cors_origins), cfg_cors_max_age);
+		  .setup_cors(cfg_cors_allow_all, std::move(cfg_cors_origins), cfg_cors_max_age)
+		  .setup_worker_pool(cfg_worker_threads,
+		                     cfg_worker_max_queue_length,
+		                     std::move(cfg_worker_heavy_paths));
 
 		if (cfg_use_tls_) {
 			webserver_->setup_tls(cfg_tls_key_.c_str(),
@@ -217,11 +238,21 @@ WebviewThread::init()
 		catchall_file = config->get_string("/webview/htdocs/catchall-file");
 	} catch (Exception &e) {
 	};
-	std::string mime_file       = config->get_string("/webview/htdocs/mime-file");
+	std::string  mime_file     = config->get_string("/webview/htdocs/mime-file");
+	unsigned int cache_size_kb = 4096;
+	try {
+		cache_size_kb = config->get_uint("/webview/htdocs/compressed-cache-size");
+	} catch (Exception &e) {
+	} // ignored, use default
 	static_dirs                 = StringConversions::resolve_paths(static_dirs);
 	std::string static_base_url = catchall_file.empty() ? "/static/" : "/";
-	static_processor_           = new WebviewStaticRequestProcessor(
-    webview_url_manager, static_base_url, static_dirs, catchall_file, mime_file, logger);
+	static_processor_           = new WebviewStaticRequestProcessor(webview_url_manager,
+                                                        static_base_url,
+                                                        static_dirs,
+                                                        catchall_file,
+                                                        mime_file,
+                                                        cache_size_kb * 1024,
+                                                        logger);
 	rest_processor_ =
 	  new WebviewRESTRequestProcessor(webview_url_manager, webview_rest_api_manager, logger);
 
@@ -231,7 +262,8 @@ WebviewThread::init()
 			webview_url_manager->add_handler(WebRequest::METHOD_GET,
 			                                 u,
 			                                 std::bind(&WebviewThread::produce_404, this),
-			                                 10000);
+			                                 10000,
+			                                 /* concurrent */ true);
 		}
 	} catch (Exception &e) {
 	} // ignored, no explicit 404
@@ -271,6 +303,20 @@ WebviewThread::finalize()
 		webview_url_manager->remove_handler(WebRequest::METHOD_GET, u);
 	}
 
+	WebRequestWorkerPool::Stats stats;
+	if (webserver_->worker_pool_stats(stats) && stats.num_processed > 0) {
+		logger->log_info(name(),
+		                 "Worker pool processed %" PRIu64 " requests (%" PRIu64 " rejected), "
+		                 "wait avg %.3f max %.3f sec, exec avg %.3f max %.3f sec, max queue %u",
+		                 stats.num_processed,
+		                 stats.num_rejected,
+		                 stats.total_wait_sec / stats.num_processed,
+		                 stats.max_wait_sec,
+		                 stats.total_exec_sec / stats.num_processed,
+		                 stats.max_exec_sec,
+		                 stats.max_queue_length);
+	}
+
 	delete webserver_;
 
 	delete webview_service_;
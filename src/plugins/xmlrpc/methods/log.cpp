@@ -94,15 +94,14 @@ void
 XmlRpcLogMethods::log_entries::execute(xmlrpc_c::paramList const &params,
                                        xmlrpc_c::value *const     result)
 {
-	// No reference, copy!
-	cache_logger_->lock();
-	std::list<CacheLogger::CacheEntry> messages = cache_logger_->get_messages();
-	cache_logger_->unlock();
-	std::list<CacheLogger::CacheEntry>::iterator i;
+	std::vector<CacheLogger::CacheEntry> messages;
+	cache_logger_->get_messages_since(0, messages);
+	std::vector<CacheLogger::CacheEntry>::reverse_iterator i;
 
 	std::vector<xmlrpc_c::value> array;
 
-	for (i = messages.begin(); i != messages.end(); ++i) {
+	// newest first
+	for (i = messages.rbegin(); i != messages.rend(); ++i) {
 		std::map<std::string, xmlrpc_c::value> elem;
 		elem.insert(std::make_pair("component", xmlrpc_c::value_string(i->component)));
 		elem.insert(std::make_pair("time", xmlrpc_c::value_datetime(i->time)));
@@ -0,0 +1,134 @@
+
+/***************************************************************************
+ *  bb_ifstats.cpp - Fawkes BlackBoard interface usage statistics
+ *
+ *  Created: Thu Oct 15 07:23:35 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <blackboard/bbconfig.h>
+#include <blackboard/exceptions.h>
+#include <blackboard/internal/interface_mem_header.h>
+#include <blackboard/internal/memory_manager.h>
+#include <config/sqlite.h>
+#include <interface/stats.h>
+#include <utils/system/console_colors.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using namespace fawkes;
+
+int
+main(int argc, char **argv)
+{
+	SQLiteConfiguration config(CONFDIR);
+	config.load();
+
+	std::string token = "";
+	try {
+		token = config.get_string("/fawkes/mainapp/blackboard_magic_token");
+	} catch (Exception &e) {
+		cout << "Could not read shared memory token for blackboard." << endl;
+		cout << "BlackBoard is probably running without shared memory." << endl;
+		return -1;
+	}
+
+	BlackBoardMemoryManager *memmgr;
+	try {
+		memmgr = new BlackBoardMemoryManager(config.get_uint("/fawkes/mainapp/blackboard_size"),
+		                                     BLACKBOARD_VERSION,
+		                                     /* master? */ false,
+		                                     token.c_str());
+	} catch (BBMemMgrCannotOpenException &e) {
+		cout << "No BlackBoard shared memory segment found!" << endl;
+		return 1;
+	}
+
+	cout << endl
+	     << cblue << "Fawkes BlackBoard Interface Statistics" << cnormal << endl
+	     << "========================================================================" << endl;
+
+	bool stats_enabled = false;
+	try {
+		stats_enabled = config.get_bool("/fawkes/mainapp/blackboard_stats");
+	} catch (Exception &e) {
+	}
+	if (!stats_enabled) {
+		cout << "Statistics are disabled, set /fawkes/mainapp/blackboard_stats to enable." << endl;
+	}
+
+	memmgr->lock();
+
+	if (memmgr->begin() == memmgr->end()) {
+		cout << "No interfaces allocated." << endl;
+	} else {
+		printf("%sType::ID%48s   Reads  Copies  Locked    Writes    Msgs%s\n"
+		       "%s%s\n",
+		       cdarkgray.c_str(),
+		       "",
+		       cnormal.c_str(),
+		       "------------------------------------------------------------------------",
+		       "----------------------------------");
+
+		uint64_t                               total_read_wait  = 0;
+		uint64_t                               total_write_wait = 0;
+		BlackBoardMemoryManager::ChunkIterator cit;
+		for (cit = memmgr->begin(); cit != memmgr->end(); ++cit) {
+			interface_header_t *ih = (interface_header_t *)*cit;
+			char                type[INTERFACE_TYPE_SIZE_ + 1];
+			char                id[INTERFACE_ID_SIZE_ + 1];
+			// ensure NULL-termination
+			type[INTERFACE_TYPE_SIZE_] = 0;
+			id[INTERFACE_ID_SIZE_]     = 0;
+			strncpy(type, ih->type, INTERFACE_TYPE_SIZE_);
+			strncpy(id, ih->id, INTERFACE_ID_SIZE_);
+			std::string uid = std::string(type) + "::" + id;
+
+			interface_stats_t stats;
+			interface_stats_copy(&ih->stats, stats);
+			total_read_wait += stats.read_lock_wait_nsec;
+			total_write_wait += stats.write_lock_wait_nsec;
+
+			printf("%-56s %7" PRIu64 " %7" PRIu64 " %7" PRIu64 " %9" PRIu64 " %7" PRIu64 "\n"
+			       "%56s %slock wait%s read %.3f ms  write %.3f ms\n",
+			       uid.c_str(),
+			       stats.num_reads,
+			       stats.num_read_copies,
+			       stats.num_read_locked,
+			       stats.num_writes,
+			       stats.num_messages,
+			       "",
+			       clightgray.c_str(),
+			       cnormal.c_str(),
+			       stats.read_lock_wait_nsec / 1000000.,
+			       stats.write_lock_wait_nsec / 1000000.);
+		}
+
+		printf("\nTotal lock wait: read %.3f ms  write %.3f ms\n",
+		       total_read_wait / 1000000.,
+		       total_write_wait / 1000000.);
+	}
+
+	memmgr->unlock();
+
+	delete memmgr;
+	return 0;
+}
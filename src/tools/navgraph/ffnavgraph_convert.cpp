@@ -0,0 +1,124 @@
+
+/***************************************************************************
+ *  ffnavgraph_convert.cpp - convert navgraphs between YAML and binary format
+ *
+ *  Created: Thu Oct 15 09:18:10 2026
+ *  Copyright  2026  agent
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <navgraph/binary_navgraph.h>
+#include <navgraph/navgraph.h>
+#include <navgraph/yaml_navgraph.h>
+#include <utils/system/argparser.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <unistd.h>
+
+using namespace fawkes;
+
+void
+print_usage(const char *program_name)
+{
+	printf("Usage: %s [-h] [-m] [-f yaml|binary] <input> [output]\n"
+	       " -h              This help message\n"
+	       " -m              Allow multiple disconnected graph segments\n"
+	       " -f FORMAT       Output format, defaults to binary for YAML input\n"
+	       "                 and to yaml for binary input\n"
+	       "<input>          Navgraph to read, the format is detected from the content\n"
+	       "[output]         File to write, if omitted only prints graph information\n",
+	       program_name);
+}
+
+/** Make path absolute.
+ * The navgraph functions resolve relative paths in the configuration
+ * directory, on the command line they are relative to the working directory.
+ * @param path path to resolve
+ * @return absolute path
+ */
+std::string
+absolute_path(const char *path)
+{
+	if (path[0] == '/') {
+		return path;
+	}
+	char cwd[4096];
+	if (!getcwd(cwd, sizeof(cwd))) {
+		throw Exception(errno, "Failed to get working directory");
+	}
+	return std::string(cwd) + "/" + path;
+}
+
+/** Convert tool main.
+ * @param argc argument count
+ * @param argv arguments
+ */
+int
+main(int argc, char **argv)
+{
+	ArgumentParser argp(argc, argv, "hmf:");
+
+	if (argp.has_arg("h") || argp.num_items() < 1 || argp.num_items() > 2) {
+		print_usage(argv[0]);
+		return argp.has_arg("h") ? 0 : 1;
+	}
+
+	try {
+		std::string input        = absolute_path(argp.items()[0]);
+		bool        input_binary = BinaryNavGraph::is_binary_navgraph(input);
+		bool        allow_multi  = argp.has_arg("m");
+
+		std::unique_ptr<NavGraph> graph(input_binary ? load_binary_navgraph(input, allow_multi)
+		                                             : load_yaml_navgraph(input, allow_multi));
+
+		printf("%s graph '%s': %zu nodes, %zu edges\n",
+		       input_binary ? "Binary" : "YAML",
+		       graph->name().c_str(),
+		       graph->nodes().size(),
+		       graph->edges().size());
+
+		if (argp.num_items() == 2) {
+			std::string output        = absolute_path(argp.items()[1]);
+			bool        output_binary = !input_binary;
+			if (argp.has_arg("f")) {
+				if (strcmp(argp.arg("f"), "binary") == 0) {
+					output_binary = true;
+				} else if (strcmp(argp.arg("f"), "yaml") == 0) {
+					output_binary = false;
+				} else {
+					printf("Unknown output format '%s'\n", argp.arg("f"));
+					return 1;
+				}
+			}
+
+			if (output_binary) {
+				save_binary_navgraph(output, graph.get());
+			} else {
+				save_yaml_navgraph(output, graph.get());
+			}
+			printf("Wrote %s graph to %s\n", output_binary ? "binary" : "YAML", output.c_str());
+		}
+	} catch (Exception &e) {
+		printf("Conversion failed: %s\n", e.what_no_backtrace());
+		return 2;
+	}
+
+	return 0;
+}
@@ -24,6 +24,7 @@
 #	include <fvcams/bumblebee2.h>
 #endif
 #include <fvutils/rectification/rectfile.h>
+#include <fvutils/rectification/rectinfo_bilinear_block.h>
 #include <fvutils/rectification/rectinfo_block.h>
 #include <fvutils/rectification/rectinfo_lut_block.h>
 #include <fvutils/system/camargp.h>
@@ -49,6 +50,8 @@ print_usage(ArgumentParser *argp)
 	printf("You have to give at least one of -r/-v/-i and a file name\n"
 	       "  -r   retrieve rectification lut from live camera,\n"
 	       "       uses first found Bumblebee2 camera\n"
+	       "  -b   with -r, store unrectified positions with subpixel\n"
+	       "       precision for bilinear interpolation\n"
 	       "  -v   verify rectification lut, compares the identification\n"
 	       "       info stored in the file with the first currently\n"
 	       "       attached camera\n"
@@ -83,7 +86,7 @@ retrieve(ArgumentParser *argp)
 	bb2->open();
 
 	TriclopsStereoProcessor *triclops = new TriclopsStereoProcessor(bb2);
-	triclops->generate_rectification_lut(lut_file);
+	triclops->generate_rectification_lut(lut_file, argp->has_arg("b"));
 	delete triclops;
 
 	bb2->close();
@@ -276,6 +279,18 @@ print_info(ArgumentParser *argp)
 						       rlib->pixel_height());
 					}
 				} break;
+				case FIREVISION_RECTINFO_TYPE_LUT_BILINEAR: {
+					RectificationBilinearInfoBlock *rbib =
+					  dynamic_cast<RectificationBilinearInfoBlock *>(rib);
+					if (rbib == NULL) {
+						printf("** Failure to access bilinear LUT\n");
+					} else {
+						printf("LUT width:  %hu\n"
+						       "LUT height: %hu\n",
+						       rbib->pixel_width(),
+						       rbib->pixel_height());
+					}
+				} break;
 				default: printf("** No additional information available for this info type\n"); break;
 				}
 			}
@@ -293,7 +308,7 @@ print_info(ArgumentParser *argp)
 int
 main(int argc, char **argv)
 {
-	ArgumentParser argp(argc, argv, "rvid");
+	ArgumentParser argp(argc, argv, "rbvid");
 
 	if (argp.num_items() == 0) {
 		print_usage(&argp);